@@ -703,7 +703,7 @@ void ReversePolyPtLinks(OutPt *pp)
 }
 //------------------------------------------------------------------------------
 
-void DisposeOutPts(OutPt*& pp)
+void DisposeOutPts(OutPt*& pp, NodePool<OutPt> &pool)
 {
   if (pp == 0) return;
     pp->Prev->Next = 0;
@@ -711,7 +711,7 @@ void DisposeOutPts(OutPt*& pp)
   {
     OutPt *tmpPp = pp;
     pp = pp->Next;
-    delete tmpPp;
+    pool.Release(tmpPp);
   }
 }
 //------------------------------------------------------------------------------
@@ -880,6 +880,32 @@ bool HorzSegmentsOverlap(cInt seg1a, cInt seg1b, cInt seg2a, cInt seg2b)
 // ClipperBase class methods ...
 //------------------------------------------------------------------------------
 
+template <typename T>
+NodePool<T>::~NodePool()
+{
+  for (size_t i = 0; i < m_Blocks.size(); ++i)
+    delete [] m_Blocks[i];
+}
+//------------------------------------------------------------------------------
+
+template <typename T>
+T* NodePool<T>::Acquire()
+{
+  if (m_Free.empty())
+  {
+    const size_t blockSize = 256;
+    T* block = new T[blockSize];
+    m_Blocks.push_back(block);
+    m_Free.reserve(m_Blocks.size() * blockSize);
+    for (size_t i = blockSize; i > 0; --i)
+      m_Free.push_back(block + i - 1);
+  }
+  T* node = m_Free.back();
+  m_Free.pop_back();
+  return node;
+}
+//------------------------------------------------------------------------------
+
 ClipperBase::ClipperBase() //constructor
 {
   m_CurrentLM = m_MinimaList.begin(); //begin() == end() here
@@ -1358,8 +1384,8 @@ void ClipperBase::DisposeAllOutRecs(){
 void ClipperBase::DisposeOutRec(PolyOutList::size_type index)
 {
   OutRec *outRec = m_PolyOuts[index];
-  if (outRec->Pts) DisposeOutPts(outRec->Pts);
-  delete outRec;
+  if (outRec->Pts) DisposeOutPts(outRec->Pts, m_OutPtPool);
+  m_OutRecPool.Release(outRec);
   m_PolyOuts[index] = 0;
 }
 //------------------------------------------------------------------------------
@@ -1379,7 +1405,7 @@ void ClipperBase::DeleteFromAEL(TEdge *e)
 
 OutRec* ClipperBase::CreateOutRec()
 {
-  OutRec* result = new OutRec;
+  OutRec* result = m_OutRecPool.Acquire();
   result->IsHole = false;
   result->IsOpen = false;
   result->FirstLeft = 0;
@@ -1941,7 +1967,7 @@ void Clipper::CopyAELToSEL()
 
 void Clipper::AddJoin(OutPt *op1, OutPt *op2, const IntPoint OffPt)
 {
-  Join* j = new Join;
+  Join* j = m_JoinPool.Acquire();
   j->OutPt1 = op1;
   j->OutPt2 = op2;
   j->OffPt = OffPt;
@@ -1952,7 +1978,7 @@ void Clipper::AddJoin(OutPt *op1, OutPt *op2, const IntPoint OffPt)
 void Clipper::ClearJoins()
 {
   for (JoinList::size_type i = 0; i < m_Joins.size(); i++)
-    delete m_Joins[i];
+    m_JoinPool.Release(m_Joins[i]);
   m_Joins.resize(0);
 }
 //------------------------------------------------------------------------------
@@ -1960,14 +1986,14 @@ void Clipper::ClearJoins()
 void Clipper::ClearGhostJoins()
 {
   for (JoinList::size_type i = 0; i < m_GhostJoins.size(); i++)
-    delete m_GhostJoins[i];
+    m_JoinPool.Release(m_GhostJoins[i]);
   m_GhostJoins.resize(0);
 }
 //------------------------------------------------------------------------------
 
 void Clipper::AddGhostJoin(OutPt *op, const IntPoint OffPt)
 {
-  Join* j = new Join;
+  Join* j = m_JoinPool.Acquire();
   j->OutPt1 = op;
   j->OutPt2 = 0;
   j->OffPt = OffPt;
@@ -2466,7 +2492,7 @@ OutPt* Clipper::AddOutPt(TEdge *e, const IntPoint &pt)
   {
     OutRec *outRec = CreateOutRec();
     outRec->IsOpen = (e->WindDelta == 0);
-    OutPt* newOp = new OutPt;
+    OutPt* newOp = m_OutPtPool.Acquire();
     outRec->Pts = newOp;
     newOp->Idx = outRec->Idx;
     newOp->Pt = pt;
@@ -2486,7 +2512,7 @@ OutPt* Clipper::AddOutPt(TEdge *e, const IntPoint &pt)
 	if (ToFront && (pt == op->Pt)) return op;
     else if (!ToFront && (pt == op->Prev->Pt)) return op->Prev;
 
-    OutPt* newOp = new OutPt;
+    OutPt* newOp = m_OutPtPool.Acquire();
     newOp->Idx = outRec->Idx;
     newOp->Pt = pt;
     newOp->Next = op;
@@ -2844,7 +2870,7 @@ bool Clipper::ProcessIntersections(const cInt topY)
 void Clipper::DisposeIntersectNodes()
 {
   for (size_t i = 0; i < m_IntersectList.size(); ++i )
-    delete m_IntersectList[i];
+    m_IntersectPool.Release(m_IntersectList[i]);
   m_IntersectList.clear();
 }
 //------------------------------------------------------------------------------
@@ -2878,7 +2904,7 @@ void Clipper::BuildIntersectList(const cInt topY)
       {
         IntersectPoint(*e, *eNext, Pt);
         if (Pt.Y < topY) Pt = IntPoint(TopX(*e, topY), topY);
-        IntersectNode * newNode = new IntersectNode;
+        IntersectNode * newNode = m_IntersectPool.Acquire();
         newNode->Edge1 = e;
         newNode->Edge2 = eNext;
         newNode->Pt = Pt;
@@ -2908,7 +2934,7 @@ void Clipper::ProcessIntersectList()
       IntersectEdges( iNode->Edge1, iNode->Edge2, iNode->Pt);
       SwapPositionsInAEL( iNode->Edge1 , iNode->Edge2 );
     }
-    delete iNode;
+    m_IntersectPool.Release(iNode);
   }
   m_IntersectList.clear();
 }
@@ -3119,14 +3145,14 @@ void Clipper::FixupOutPolyline(OutRec &outrec)
       OutPt *tmpPP = pp->Prev;
       tmpPP->Next = pp->Next;
       pp->Next->Prev = tmpPP;
-      delete pp;
+      m_OutPtPool.Release(pp);
       pp = tmpPP;
     }
   }
 
   if (pp == pp->Prev)
   {
-    DisposeOutPts(pp);
+    DisposeOutPts(pp, m_OutPtPool);
     outrec.Pts = 0;
     return;
   }
@@ -3146,7 +3172,7 @@ void Clipper::FixupOutPolygon(OutRec &outrec)
     {
         if (pp->Prev == pp || pp->Prev == pp->Next)
         {
-            DisposeOutPts(pp);
+            DisposeOutPts(pp, m_OutPtPool);
             outrec.Pts = 0;
             return;
         }
@@ -3161,7 +3187,7 @@ void Clipper::FixupOutPolygon(OutRec &outrec)
             pp->Prev->Next = pp->Next;
             pp->Next->Prev = pp->Prev;
             pp = pp->Prev;
-            delete tmp;
+            m_OutPtPool.Release(tmp);
         }
         else if (pp == lastOK) break;
         else
@@ -3338,9 +3364,9 @@ void Clipper::InsertEdgeIntoAEL(TEdge *edge, TEdge* startEdge)
 }
 //----------------------------------------------------------------------
 
-OutPt* DupOutPt(OutPt* outPt, bool InsertAfter)
+OutPt* DupOutPt(OutPt* outPt, bool InsertAfter, NodePool<OutPt> &pool)
 {
-  OutPt* result = new OutPt;
+  OutPt* result = pool.Acquire();
   result->Pt = outPt->Pt;
   result->Idx = outPt->Idx;
   if (InsertAfter)
@@ -3362,7 +3388,7 @@ OutPt* DupOutPt(OutPt* outPt, bool InsertAfter)
 //------------------------------------------------------------------------------
 
 bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
-  const IntPoint Pt, bool DiscardLeft)
+  const IntPoint Pt, bool DiscardLeft, NodePool<OutPt> &pool)
 {
   Direction Dir1 = (op1->Pt.X > op1b->Pt.X ? dRightToLeft : dLeftToRight);
   Direction Dir2 = (op2->Pt.X > op2b->Pt.X ? dRightToLeft : dLeftToRight);
@@ -3379,12 +3405,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op1->Next->Pt.X >= op1->Pt.X && op1->Next->Pt.Y == Pt.Y)  
         op1 = op1->Next;
     if (DiscardLeft && (op1->Pt.X != Pt.X)) op1 = op1->Next;
-    op1b = DupOutPt(op1, !DiscardLeft);
+    op1b = DupOutPt(op1, !DiscardLeft, pool);
     if (op1b->Pt != Pt) 
     {
       op1 = op1b;
       op1->Pt = Pt;
-      op1b = DupOutPt(op1, !DiscardLeft);
+      op1b = DupOutPt(op1, !DiscardLeft, pool);
     }
   } 
   else
@@ -3393,12 +3419,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op1->Next->Pt.X <= op1->Pt.X && op1->Next->Pt.Y == Pt.Y) 
         op1 = op1->Next;
     if (!DiscardLeft && (op1->Pt.X != Pt.X)) op1 = op1->Next;
-    op1b = DupOutPt(op1, DiscardLeft);
+    op1b = DupOutPt(op1, DiscardLeft, pool);
     if (op1b->Pt != Pt)
     {
       op1 = op1b;
       op1->Pt = Pt;
-      op1b = DupOutPt(op1, DiscardLeft);
+      op1b = DupOutPt(op1, DiscardLeft, pool);
     }
   }
 
@@ -3408,12 +3434,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op2->Next->Pt.X >= op2->Pt.X && op2->Next->Pt.Y == Pt.Y)
         op2 = op2->Next;
     if (DiscardLeft && (op2->Pt.X != Pt.X)) op2 = op2->Next;
-    op2b = DupOutPt(op2, !DiscardLeft);
+    op2b = DupOutPt(op2, !DiscardLeft, pool);
     if (op2b->Pt != Pt)
     {
       op2 = op2b;
       op2->Pt = Pt;
-      op2b = DupOutPt(op2, !DiscardLeft);
+      op2b = DupOutPt(op2, !DiscardLeft, pool);
     };
   } else
   {
@@ -3421,12 +3447,12 @@ bool JoinHorz(OutPt* op1, OutPt* op1b, OutPt* op2, OutPt* op2b,
       op2->Next->Pt.X <= op2->Pt.X && op2->Next->Pt.Y == Pt.Y) 
         op2 = op2->Next;
     if (!DiscardLeft && (op2->Pt.X != Pt.X)) op2 = op2->Next;
-    op2b = DupOutPt(op2, DiscardLeft);
+    op2b = DupOutPt(op2, DiscardLeft, pool);
     if (op2b->Pt != Pt)
     {
       op2 = op2b;
       op2->Pt = Pt;
-      op2b = DupOutPt(op2, DiscardLeft);
+      op2b = DupOutPt(op2, DiscardLeft, pool);
     };
   };
 
@@ -3478,8 +3504,8 @@ bool Clipper::JoinPoints(Join *j, OutRec* outRec1, OutRec* outRec2)
     if (reverse1 == reverse2) return false;
     if (reverse1)
     {
-      op1b = DupOutPt(op1, false);
-      op2b = DupOutPt(op2, true);
+      op1b = DupOutPt(op1, false, m_OutPtPool);
+      op2b = DupOutPt(op2, true, m_OutPtPool);
       op1->Prev = op2;
       op2->Next = op1;
       op1b->Next = op2b;
@@ -3489,8 +3515,8 @@ bool Clipper::JoinPoints(Join *j, OutRec* outRec1, OutRec* outRec2)
       return true;
     } else
     {
-      op1b = DupOutPt(op1, true);
-      op2b = DupOutPt(op2, false);
+      op1b = DupOutPt(op1, true, m_OutPtPool);
+      op2b = DupOutPt(op2, false, m_OutPtPool);
       op1->Next = op2;
       op2->Prev = op1;
       op1b->Prev = op2b;
@@ -3546,7 +3572,7 @@ bool Clipper::JoinPoints(Join *j, OutRec* outRec1, OutRec* outRec2)
       Pt = op2b->Pt; DiscardLeftSide = (op2b->Pt.X > op2->Pt.X);
     }
     j->OutPt1 = op1; j->OutPt2 = op2;
-    return JoinHorz(op1, op1b, op2, op2b, Pt, DiscardLeftSide);
+    return JoinHorz(op1, op1b, op2, op2b, Pt, DiscardLeftSide, m_OutPtPool);
   } else
   {
     //nb: For non-horizontal joins ...
@@ -3582,8 +3608,8 @@ bool Clipper::JoinPoints(Join *j, OutRec* outRec1, OutRec* outRec2)
 
     if (Reverse1)
     {
-      op1b = DupOutPt(op1, false);
-      op2b = DupOutPt(op2, true);
+      op1b = DupOutPt(op1, false, m_OutPtPool);
+      op2b = DupOutPt(op2, true, m_OutPtPool);
       op1->Prev = op2;
       op2->Next = op1;
       op1b->Next = op2b;
@@ -3593,8 +3619,8 @@ bool Clipper::JoinPoints(Join *j, OutRec* outRec1, OutRec* outRec2)
       return true;
     } else
     {
-      op1b = DupOutPt(op1, true);
-      op2b = DupOutPt(op2, false);
+      op1b = DupOutPt(op1, true, m_OutPtPool);
+      op2b = DupOutPt(op2, false, m_OutPtPool);
       op1->Next = op2;
       op2->Prev = op1;
       op1b->Prev = op2b;
@@ -210,6 +210,24 @@ typedef std::vector < TEdge* > EdgeList;
 typedef std::vector < Join* > JoinList;
 typedef std::vector < IntersectNode* > IntersectList;
 
+//Qt: recycles the nodes an execution allocates one by one, so that a Clipper
+//instance reused across executions keeps its memory instead of going back to
+//the heap for every output point, output polygon, join and intersection ...
+template <typename T>
+class NodePool
+{
+public:
+  NodePool() {}
+  ~NodePool();
+  T* Acquire();
+  void Release(T *node) { m_Free.push_back(node); }
+private:
+  NodePool(const NodePool &);
+  NodePool &operator=(const NodePool &);
+  std::vector < T* > m_Blocks;
+  std::vector < T* > m_Free;
+};
+
 //------------------------------------------------------------------------------
 
 //ClipperBase is the ancestor to the Clipper class. It should not be
@@ -255,6 +273,11 @@ protected:
 
   typedef std::priority_queue<cInt> ScanbeamList;
   ScanbeamList     m_Scanbeam;
+
+  NodePool<OutPt>         m_OutPtPool;
+  NodePool<OutRec>        m_OutRecPool;
+  NodePool<Join>          m_JoinPool;
+  NodePool<IntersectNode> m_IntersectPool;
 };
 //------------------------------------------------------------------------------
 
@@ -70,7 +70,10 @@
 #include <QtLocation/private/qdeclarativesearchresultmodel_p.h>
 #include <QtLocation/private/qdeclarativesearchsuggestionmodel_p.h>
 
+#include "qplaceiconimageprovider.h"
+
 #include <QtQml/qqmlextensionplugin.h>
+#include <QtQml/QQmlEngine>
 
 #include <QtCore/QDebug>
 
@@ -207,10 +210,16 @@ public:
                                         QStringLiteral("GeoMapItemBase is not intended instantiable by developer."));
 
             minor = 15;
+            qmlRegisterType<QDeclarativeGeoMap, 15>(uri, major, minor, "Map");
+            qmlRegisterType<QDeclarativeGeoRoute, 15>(uri, major, minor, "Route");
             qmlRegisterType<QDeclarativePolylineMapItem,  15>(uri, major, minor, "MapPolyline");
             qmlRegisterType<QDeclarativePolygonMapItem,   15>(uri, major, minor, "MapPolygon");
             qmlRegisterType<QDeclarativeRectangleMapItem, 15>(uri, major, minor, "MapRectangle");
             qmlRegisterType<QDeclarativeCircleMapItem,    15>(uri, major, minor, "MapCircle");
+            qmlRegisterType<QDeclarativeGeoMapItemView,   15>(uri, major, minor, "MapItemView");
+            qmlRegisterType<QDeclarativeSearchSuggestionModel, 15>(uri, major, minor, "PlaceSearchSuggestionModel");
+            qmlRegisterType<QDeclarativeSearchResultModel, 15>(uri, major, minor, "PlaceSearchModel");
+            qmlRegisterType<QDeclarativePlaceIcon, 15>(uri, major, minor, "Icon");
             qmlRegisterUncreatableType<QDeclarativeGeoMapItemBase, 15>(uri, major, minor, "GeoMapItemBase",
                                         QStringLiteral("GeoMapItemBase is not intended instantiable by developer."));
 
@@ -230,6 +239,14 @@ public:
             qDebug() << "Unsupported URI given to load location QML plugin: " << QLatin1String(uri);
         }
     }
+
+    void initializeEngine(QQmlEngine *engine, const char *uri) override
+    {
+        Q_UNUSED(uri);
+        // the id is the one of the URLs made by Icon::cachedUrl()
+        if (!engine->imageProvider(QStringLiteral("placeicons")))
+            engine->addImageProvider(QStringLiteral("placeicons"), new QPlaceIconImageProvider);
+    }
 };
 
 QT_END_NAMESPACE
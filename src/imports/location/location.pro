@@ -1,7 +1,11 @@
 QT += quick-private network positioning-private positioningquick-private location-private qml-private core-private gui-private
 
+HEADERS += \
+           qplaceiconimageprovider.h
+
 SOURCES += \
-           location.cpp
+           location.cpp \
+           qplaceiconimageprovider.cpp
 
 load(qml_plugin)
 
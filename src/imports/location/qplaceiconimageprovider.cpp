@@ -0,0 +1,218 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplaceiconimageprovider.h"
+
+#include <QtLocation/private/qabstractgeotilecache_p.h>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QTimer>
+
+QT_BEGIN_NAMESPACE
+
+static const int MemoryCacheSize = 4096; // kilobytes of decoded images
+static const qint64 DiskCacheSize = 20 * 1024 * 1024;
+static const int DownloadTimeout = 30000;
+
+static QThreadStorage<QNetworkAccessManager *> networkManagers;
+
+/*
+    Removes the least recently written icons of \a directory until they fit
+    the disk cache size.
+*/
+static void pruneDiskCache(const QString &directory)
+{
+    const QFileInfoList files = QDir(directory).entryInfoList(QDir::Files, QDir::Time);
+    qint64 total = 0;
+    for (const QFileInfo &file : files) {
+        total += file.size();
+        if (total > DiskCacheSize)
+            QFile::remove(file.absoluteFilePath());
+    }
+}
+
+static void storeIcon(const QString &fileName, const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+
+    QSaveFile file(fileName);
+    if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit())
+        pruneDiskCache(QFileInfo(fileName).path());
+}
+
+/*
+    Serves the icons of places and categories under image://placeicons/, the
+    id being the provider's icon URL encoded by Icon::cachedUrl(). Icons are
+    kept decoded in memory for each requested size, and as downloaded on
+    disk, so that lists showing the same category icons fetch them once.
+
+    Images are loaded from the image loading thread of Qt Quick. Requests
+    from the GUI thread, as made by MapIconObject, are not kept waiting for
+    the network: they get the cached icon only, while the icon is downloaded
+    for later requests.
+*/
+QPlaceIconImageProvider::QPlaceIconImageProvider()
+:   QQuickImageProvider(QQuickImageProvider::Image,
+                        QQmlImageProviderBase::ForceAsynchronousImageLoading),
+    m_images(MemoryCacheSize),
+    m_directory(QAbstractGeoTileCache::baseCacheDirectory()
+                + QLatin1String("QtLocation/placeicons/"))
+{
+    QDir().mkpath(m_directory);
+    pruneDiskCache(m_directory);
+}
+
+QPlaceIconImageProvider::~QPlaceIconImageProvider()
+{
+}
+
+QImage QPlaceIconImageProvider::requestImage(const QString &id, QSize *size,
+                                             const QSize &requestedSize)
+{
+    const QUrl url(QString::fromUtf8(QByteArray::fromBase64(
+            id.toLatin1(), QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals)));
+    const QString key = url.toString() + QLatin1Char('@')
+            + QString::number(requestedSize.width()) + QLatin1Char('x')
+            + QString::number(requestedSize.height());
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const QImage *image = m_images.object(key)) {
+            *size = image->size();
+            return *image;
+        }
+    }
+
+    QImage image;
+    image.loadFromData(load(url));
+    if (image.isNull()) {
+        *size = QSize();
+        return image;
+    }
+
+    if (requestedSize.width() > 0 && requestedSize.height() > 0)
+        image = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    else if (requestedSize.width() > 0)
+        image = image.scaledToWidth(requestedSize.width(), Qt::SmoothTransformation);
+    else if (requestedSize.height() > 0)
+        image = image.scaledToHeight(requestedSize.height(), Qt::SmoothTransformation);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_images.insert(key, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+    }
+    *size = image.size();
+    return image;
+}
+
+/*
+    Returns the data of the icon at \a url, from the disk cache if it has it.
+*/
+QByteArray QPlaceIconImageProvider::load(const QUrl &url)
+{
+    if (url.scheme() == QLatin1String("qrc") || url.isLocalFile()) {
+        QFile file(url.isLocalFile() ? url.toLocalFile() : QLatin1Char(':') + url.path());
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+    if (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https"))
+        return QByteArray();
+
+    const QString fileName = cacheFile(url);
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly))
+        return file.readAll();
+
+    QNetworkReply *reply = download(url);
+    const QCoreApplication *application = QCoreApplication::instance();
+    if (application && QThread::currentThread() == application->thread()) {
+        QObject::connect(reply, &QNetworkReply::finished, reply, [reply, fileName]() {
+            if (reply->error() == QNetworkReply::NoError)
+                storeIcon(fileName, reply->readAll());
+            reply->deleteLater();
+        });
+        return QByteArray();
+    }
+
+    QEventLoop loop;
+    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    QTimer::singleShot(DownloadTimeout, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    QByteArray data;
+    if (reply->isFinished() && reply->error() == QNetworkReply::NoError) {
+        data = reply->readAll();
+        storeIcon(fileName, data);
+    }
+    reply->abort();
+    reply->deleteLater();
+    return data;
+}
+
+/*
+    Starts downloading \a url with the network access manager of the calling
+    thread.
+*/
+QNetworkReply *QPlaceIconImageProvider::download(const QUrl &url)
+{
+    if (!networkManagers.hasLocalData())
+        networkManagers.setLocalData(new QNetworkAccessManager);
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                         QNetworkRequest::NoLessSafeRedirectPolicy);
+    return networkManagers.localData()->get(request);
+}
+
+QString QPlaceIconImageProvider::cacheFile(const QUrl &url) const
+{
+    return m_directory + QString::fromLatin1(
+            QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex());
+}
+
+QT_END_NAMESPACE
@@ -35,11 +35,15 @@
 ****************************************************************************/
 
 #include <QtLocation/private/qmapiconobject_p.h>
+#include <QtLocation/private/qmapheatmapobject_p.h>
 #include <QtLocation/private/qmapobjectview_p.h>
 #include <QtLocation/private/qmaprouteobject_p.h>
 #include <QtLocation/private/qmapcircleobject_p.h>
 #include <QtLocation/private/qmappolygonobject_p.h>
 #include <QtLocation/private/qmappolylineobject_p.h>
+#include <QtLocation/private/qdeclarativegeomapmarkerlayer_p.h>
+#include <QtLocation/private/qdeclarativegeomappositionindicator_p.h>
+#include <QtLocation/private/qgeojsonviewportmodel_p.h>
 #include <QtLocation/private/qdeclarativenavigator_p.h>
 #include <QtLocation/private/qdeclarativenavigator_p_p.h>
 #include <QtLocation/private/qnavigationmanagerengine_p.h>
@@ -82,6 +86,10 @@ public:
             qmlRegisterType<QMapCircleObject>(uri, major, minor, "MapCircleObject");
             qmlRegisterType<QMapPolygonObject>(uri, major, minor, "MapPolygonObject");
             qmlRegisterType<QMapPolylineObject>(uri, major, minor, "MapPolylineObject");
+            qmlRegisterType<QMapHeatmapObject>(uri, major, minor, "MapHeatmapObject");
+            qmlRegisterType<QDeclarativeGeoMapMarkerLayer>(uri, major, minor, "MapMarkerLayer");
+            qmlRegisterType<QDeclarativeGeoMapPositionIndicator>(uri, major, minor, "MapPositionIndicator");
+            qmlRegisterType<QGeoJsonViewportModel>(uri, major, minor, "GeoJsonViewportModel");
             qmlRegisterAnonymousType<QDeclarativeNavigationBasicDirections>(uri, major);
             qmlRegisterType<QDeclarativeNavigator>(uri, major, minor, "Navigator");
             qmlRegisterAnonymousType<QAbstractNavigator>(uri, major);
@@ -619,6 +619,9 @@ public:
             minor = 14;
             qmlRegisterType<QDeclarativePluginParameter >(uri, major, minor, "PluginParameter");
 
+            minor = 15;
+            qmlRegisterType<QDeclarativePositionSource, 15>(uri, major, minor, "PositionSource");
+
             // Register the latest Qt version as QML type version
             qmlRegisterModule(uri, QT_VERSION_MAJOR, QT_VERSION_MINOR);
         } else {
@@ -25,7 +25,12 @@ PRIVATE_HEADERS += \
         declarativemaps/qdeclarativepolylinemapitem_p.h \
         declarativemaps/qdeclarativerectanglemapitem_p.h \
         declarativemaps/qdeclarativeroutemapitem_p.h \
+        declarativemaps/qgeomapitembatchlayer_p.h \
         declarativemaps/qgeomapitemgeometry_p.h \
+        declarativemaps/qgeomaptriangulationcache_p.h \
+        declarativemaps/qgeomapspatialindex_p.h \
+        declarativemaps/qgeomappathculler_p.h \
+        declarativemaps/qgeomapframebudget_p.h \
         declarativemaps/qgeomapobject_p.h \
         declarativemaps/qgeomapobject_p_p.h \
         declarativemaps/qparameterizableobject_p.h \
@@ -60,6 +65,11 @@ SOURCES += \
         declarativemaps/qdeclarativecirclemapitem.cpp \
         declarativemaps/qdeclarativerectanglemapitem.cpp \
         declarativemaps/qdeclarativeroutemapitem.cpp \
+        declarativemaps/qgeomapitembatchlayer.cpp \
+        declarativemaps/qgeomaptriangulationcache.cpp \
+        declarativemaps/qgeomapspatialindex.cpp \
+        declarativemaps/qgeomappathculler.cpp \
+        declarativemaps/qgeomapframebudget.cpp \
         declarativemaps/qgeomapitemgeometry.cpp \
         declarativemaps/qgeomapobject.cpp \
         declarativemaps/qdeclarativegeomapitemutils.cpp \
@@ -67,6 +77,10 @@ SOURCES += \
         declarativemaps/qgeosimplify.cpp \
         declarativemaps/qquickgeomapgesturearea.cpp
 
+qtConfig(opengl) {
+    PRIVATE_HEADERS += declarativemaps/qgeomapsnapshotrenderer_p.h
+    SOURCES += declarativemaps/qgeomapsnapshotrenderer.cpp
+}
+
 load(qt_build_paths)
 LIBS_PRIVATE += -L$$MODULE_BASE_OUTDIR/lib -lqt_poly2tri$$qtPlatformTargetSuffix() -lqt_clip2tri$$qtPlatformTargetSuffix()
-
@@ -40,6 +40,11 @@
 #include <private/qqmlengine_p.h>
 #include <private/qv4scopedvalue_p.h>
 #include <private/qv4arrayobject_p.h>
+#include <private/qv4arraybuffer_p.h>
+#include <private/qv4typedarray_p.h>
+#include <private/qjsvalue_p.h>
+
+#include <cstring>
 
 
 QGeoCoordinate parseCoordinate(const QJSValue &value, bool *ok)
@@ -150,6 +155,30 @@ QGeoCircle parseCircle(const QJSValue &value, bool *ok)
     return c;
 }
 
+/*
+    Finds the bytes of a Float64Array, or of an ArrayBuffer holding doubles.
+*/
+static bool coordinateBuffer(const QJSValue &value, const char **data, quint32 *size)
+{
+    QV4::Value *v = QJSValuePrivate::getValue(&value);
+    if (!v)
+        return false;
+
+    if (QV4::TypedArray *array = v->as<QV4::TypedArray>()) {
+        if (array->arrayType() != QV4::Heap::TypedArray::Float64Array)
+            return false;
+        *data = array->arrayData()->data() + array->d()->byteOffset;
+        *size = array->byteLength();
+        return true;
+    }
+    if (QV4::ArrayBuffer *buffer = v->as<QV4::ArrayBuffer>()) {
+        *data = buffer->constData();
+        *size = buffer->byteLength();
+        return true;
+    }
+    return false;
+}
+
 QJSValue fromList(const QObject *object, const QList<QGeoCoordinate> &list)
 {
     QQmlContext *context = QQmlEngine::contextForObject(object);
@@ -158,27 +187,84 @@ QJSValue fromList(const QObject *object, const QList<QGeoCoordinate> &list)
 
     QV4::Scope scope(v4);
     QV4::Scoped<QV4::ArrayObject> pathArray(scope, v4->newArrayObject(list.length()));
+    QV4::ScopedValue cv(scope);
     int i = 0;
     for (const auto &val : list) {
-        QV4::ScopedValue cv(scope, v4->fromVariant(QVariant::fromValue(val)));
+        cv = v4->fromVariant(QVariant::fromValue(val));
         pathArray->put(i++, cv);
     }
 
     return QJSValue(v4, pathArray.asReturnedValue());
 }
 
-QList<QGeoCoordinate> toList(const QObject *object, const QJSValue &value)
+QJSValue QDeclarativePathValueCache::value(const QObject *object, const QList<QGeoCoordinate> &path) const
+{
+    if (m_value.isUndefined() || !m_path.isSharedWith(path)) {
+        m_value = fromList(object, path);
+        m_path = path;
+        // Handed out to every reader: a script changing it would change it for all of them.
+        QQmlEngine *engine = QQmlEngine::contextForObject(object)->engine();
+        engine->globalObject().property(QStringLiteral("Object"))
+                .property(QStringLiteral("freeze")).call(QJSValueList() << m_value);
+    }
+    return m_value;
+}
+
+/*
+    Returns whether value is a path toList() can convert: an array of
+    coordinates, or a Float64Array or ArrayBuffer of latitude and longitude
+    pairs.
+*/
+bool isPathValue(const QJSValue &value)
+{
+    const char *data;
+    quint32 size;
+    return value.isArray() || coordinateBuffer(value, &data, &size);
+}
+
+QList<QGeoCoordinate> toList(const QObject *object, const QJSValue &value, bool *ok)
 {
+    if (ok)
+        *ok = false;
+
+    const char *data;
+    quint32 size;
+    if (coordinateBuffer(value, &data, &size)) {
+        // read straight from the buffer rather than through an element lookup each
+        double latLon[2];
+        if (size % sizeof(latLon)) {
+            qmlWarning(object) << "Unsupported path type";
+            return {};
+        }
+
+        QList<QGeoCoordinate> pathList;
+        const quint32 count = size / sizeof(latLon);
+        pathList.reserve(int(count));
+        for (quint32 i = 0; i < count; ++i) {
+            std::memcpy(latLon, data + i * sizeof(latLon), sizeof(latLon));
+            const QGeoCoordinate c(latLon[0], latLon[1]);
+            if (!c.isValid()) {
+                qmlWarning(object) << "Unsupported path type";
+                return {};
+            }
+            pathList.append(c);
+        }
+        if (ok)
+            *ok = true;
+        return pathList;
+    }
+
     if (!value.isArray())
         return {};
 
     QList<QGeoCoordinate> pathList;
     quint32 length = value.property(QStringLiteral("length")).toUInt();
+    pathList.reserve(int(length));
     for (quint32 i = 0; i < length; ++i) {
-        bool ok;
-        QGeoCoordinate c = parseCoordinate(value.property(i), &ok);
+        bool parsed;
+        QGeoCoordinate c = parseCoordinate(value.property(i), &parsed);
 
-        if (!ok || !c.isValid()) {
+        if (!parsed || !c.isValid()) {
             qmlWarning(object) << "Unsupported path type";
             return {};
         }
@@ -186,5 +272,7 @@ QList<QGeoCoordinate> toList(const QObject *object, const QJSValue &value)
         pathList.append(c);
     }
 
+    if (ok)
+        *ok = true;
     return pathList;
 }
@@ -60,5 +60,24 @@ QGeoCoordinate Q_LOCATION_PRIVATE_EXPORT parseCoordinate(const QVariant &value,
 QGeoRectangle Q_LOCATION_PRIVATE_EXPORT parseRectangle(const QJSValue &value, bool *ok);
 QGeoCircle Q_LOCATION_PRIVATE_EXPORT parseCircle(const QJSValue &value, bool *ok);
 QJSValue Q_LOCATION_PRIVATE_EXPORT fromList(const QObject *object, const QList<QGeoCoordinate> &list);
-QList<QGeoCoordinate> Q_LOCATION_PRIVATE_EXPORT toList(const QObject *object, const QJSValue &value);
+bool Q_LOCATION_PRIVATE_EXPORT isPathValue(const QJSValue &value);
+QList<QGeoCoordinate> Q_LOCATION_PRIVATE_EXPORT toList(const QObject *object, const QJSValue &value,
+                                                       bool *ok = nullptr);
+
+/*
+    The JS array fromList() converts a path to, kept to be returned again by
+    the path properties while the path is not modified. The path is tracked by
+    its list data: a list changed after value() detaches from the copy kept
+    here, and is converted again. The array is frozen, being shared by all
+    the readers.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QDeclarativePathValueCache
+{
+public:
+    QJSValue value(const QObject *object, const QList<QGeoCoordinate> &path) const;
+
+private:
+    mutable QList<QGeoCoordinate> m_path;
+    mutable QJSValue m_value;
+};
 #endif
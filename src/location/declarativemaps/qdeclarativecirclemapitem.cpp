@@ -39,6 +39,7 @@
 
 #include "qwebmercator_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
 
 #include <qmath.h>
 #include <algorithm>
@@ -189,7 +190,7 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
     for (const QDoubleVector2D &c: circlePath)
         hole << p.wrapMapProjection(c);
 
-    c2t::clip2tri clipper;
+    c2t::clip2tri &clipper = QDeclarativeGeoMapItemUtils::threadClipper();
     clipper.addSubjectPath(QClipperUtils::qListToPath(fill), true);
     clipper.addClipPolygon(QClipperUtils::qListToPath(hole));
     Paths difference = clipper.execute(c2t::clip2tri::Difference, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
@@ -230,10 +231,12 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
     QDoubleVector2D origin = p.wrappedMapProjectionToItemPosition(lb);
 
     QPainterPath ppi;
+    QVector<double> positions;
     for (const QList<QDoubleVector2D> &path: clippedPaths) {
         QDoubleVector2D lastAddedPoint;
+        QDeclarativeGeoMapItemUtils::projectPath(path, p, positions);
         for (int i = 0; i < path.size(); ++i) {
-            QDoubleVector2D point = p.wrappedMapProjectionToItemPosition(path.at(i));
+            QDoubleVector2D point(positions.at(2 * i), positions.at(2 * i + 1));
             //point = point - origin; // Do this using ppi.translate()
 
             if (i == 0) {
@@ -303,6 +306,7 @@ QDeclarativeCircleMapItem::QDeclarativeCircleMapItem(QQuickItem *parent)
     // so the line is commented out until fixed
     //geometry_.setAssumeSimple(true);
     setBackend(mapCircleBackendSelector->backend);
+    m_backendExplicit = false;
 }
 
 QDeclarativeCircleMapItem::~QDeclarativeCircleMapItem()
@@ -339,6 +343,16 @@ void QDeclarativeCircleMapItem::onLinePropertiesChanged()
 void QDeclarativeCircleMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
 {
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
+    // Unless set explicitly, the backend follows the preference of the map,
+    // and returns to the default one when the item leaves it
+    if (!m_backendExplicit) {
+        const Backend fallback = mapCircleBackendSelector->backend;
+        const Backend backend = (fallback == Software && mapPrefersOpenGLItems()) ? OpenGL : fallback;
+        if (backend != m_backend) {
+            setBackend(backend);
+            m_backendExplicit = false;
+        }
+    }
     if (map)
         m_d->onMapSet();
 }
@@ -355,7 +369,6 @@ void QDeclarativeCircleMapItem::setCenter(const QGeoCoordinate &center)
     if (m_circle.center() == center)
         return;
 
-    possiblySwitchBackend(m_circle.center(), m_circle.radius(), center, m_circle.radius());
     m_circle.setCenter(center);
     m_d->onGeoGeometryChanged();
     emit centerChanged(center);
@@ -399,7 +412,6 @@ void QDeclarativeCircleMapItem::setRadius(qreal radius)
     if (m_circle.radius() == radius)
         return;
 
-    possiblySwitchBackend(m_circle.center(), m_circle.radius(), m_circle.center(), radius);
     m_circle.setRadius(radius);
     m_d->onGeoGeometryChanged();
     emit radiusChanged(radius);
@@ -433,34 +445,12 @@ QSGNode *QDeclarativeCircleMapItem::updateMapItemPaintNode(QSGNode *oldNode, Upd
 */
 void QDeclarativeCircleMapItem::updatePolish()
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::ItemPolish);
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     m_d->updatePolish();
 }
 
-/*!
-    \internal
-
-    The OpenGL backend doesn't do circles crossing poles yet.
-    So if that backend is selected and the circle crosses the poles, use the CPU backend instead.
-*/
-void QDeclarativeCircleMapItem::possiblySwitchBackend(const QGeoCoordinate &oldCenter, qreal oldRadius, const QGeoCoordinate &newCenter, qreal newRadius)
-{
-    if (m_backend != QDeclarativeCircleMapItem::OpenGL)
-        return;
-
-    // if old does not cross and new crosses, move to CPU.
-    if (!QDeclarativeCircleMapItemPrivate::crossEarthPole(oldCenter, oldRadius)
-            && !QDeclarativeCircleMapItemPrivate::crossEarthPole(newCenter, newRadius)) {
-        QScopedPointer<QDeclarativeCircleMapItemPrivate> d(static_cast<QDeclarativeCircleMapItemPrivate *>(new QDeclarativeCircleMapItemPrivateCPU(*this)));
-        m_d.swap(d);
-    } else if (QDeclarativeCircleMapItemPrivate::crossEarthPole(oldCenter, oldRadius)
-               && !QDeclarativeCircleMapItemPrivate::crossEarthPole(newCenter, newRadius)) { // else if old crosses and new does not cross, move back to OpenGL
-        QScopedPointer<QDeclarativeCircleMapItemPrivate> d(static_cast<QDeclarativeCircleMapItemPrivate *>(new QDeclarativeCircleMapItemPrivateOpenGL(*this)));
-        m_d.swap(d);
-    }
-}
-
 /*!
     \internal
 */
@@ -494,7 +484,6 @@ void QDeclarativeCircleMapItem::setGeoShape(const QGeoShape &shape)
     const QGeoCircle circle(shape); // if shape isn't a circle, circle will be created as a default-constructed circle
     const bool centerHasChanged = circle.center() != m_circle.center();
     const bool radiusHasChanged = circle.radius() != m_circle.radius();
-    possiblySwitchBackend(m_circle.center(), m_circle.radius(), circle.center(), circle.radius());
     m_circle = circle;
 
     m_d->onGeoGeometryChanged();
@@ -509,7 +498,9 @@ void QDeclarativeCircleMapItem::setGeoShape(const QGeoShape &shape)
 
     This property holds which backend is in use to render the map item.
     Valid values are \b MapCircle.Software and \b{MapCircle.OpenGL}.
-    The default value is \b{MapCircle.Software}.
+    The default value is \b{MapCircle.Software}, unless the map plugin prefers
+    the OpenGL backends, as the \l{Qt Location Items Overlay Plugin}{itemsoverlay}
+    plugin does.
 
     \note \b{The release of this API with Qt 5.15 is a Technology Preview}.
     Ideally, as the OpenGL backends for map items mature, there will be
@@ -531,6 +522,7 @@ QDeclarativeCircleMapItem::Backend QDeclarativeCircleMapItem::backend() const
 
 void QDeclarativeCircleMapItem::setBackend(QDeclarativeCircleMapItem::Backend b)
 {
+    m_backendExplicit = true;
     if (b == m_backend)
         return;
     m_backend = b;
@@ -667,6 +659,93 @@ bool QDeclarativeCircleMapItemPrivate::crossEarthPole(const QGeoCoordinate &cent
     return false;
 }
 
+/*
+ * Builds the outlines used by the OpenGL backend for a circle containing one or both poles.
+ * The result is in unwrapped map projection coordinates and spans two world widths starting
+ * at bounds.left(), so that any viewport can be covered by translating it by whole worlds.
+ *
+ * A circle around one pole is unrolled into an open strip that is closed along the pole edge
+ * of the map. A circle around both poles leaves a hole instead, which is cut into a rectangle.
+ * Returns whether the border is a closed loop.
+ */
+bool QDeclarativeCircleMapItemPrivate::calculatePolarPaths(const QList<QDoubleVector2D> &circlePath,
+                                                          const QGeoCoordinate &center,
+                                                          qreal distance,
+                                                          QList<QList<QDoubleVector2D>> &fill,
+                                                          QList<QDoubleVector2D> &border,
+                                                          QRectF &bounds)
+{
+    fill.clear();
+    border.clear();
+    if (circlePath.size() < 3)
+        return true;
+
+    // Unwrap the perimeter so that x never jumps by more than half a world
+    QList<QDoubleVector2D> path;
+    path.reserve(circlePath.size() + 1);
+    path << circlePath.first();
+    for (int i = 1; i <= circlePath.size(); ++i) {
+        QDoubleVector2D point = circlePath.at(i % circlePath.size());
+        const double dx = point.x() - path.last().x();
+        point.setX(point.x() - std::floor(dx + 0.5));
+        path << point;
+    }
+
+    double minY = path.first().y();
+    double maxY = minY;
+    for (const QDoubleVector2D &point : qAsConst(path)) {
+        minY = qMin(minY, point.y());
+        maxY = qMax(maxY, point.y());
+    }
+
+    const double drift = path.last().x() - path.first().x();
+    if (qAbs(drift) > 0.5) {
+        // One pole: the perimeter goes once around the world
+        if (drift < 0)
+            std::reverse(path.begin(), path.end());
+        const double shift = -std::floor(path.first().x());
+        for (QDoubleVector2D &point : path)
+            point.setX(point.x() + shift);
+        for (int i = 1; i < circlePath.size() + 1; ++i)
+            path << path.at(i) + QDoubleVector2D(1.0, 0.0);
+
+        const bool north = center.distanceTo(QGeoCoordinate(90, 0)) < distance;
+        const double poleY = north ? qMin(0.0, minY) : qMax(1.0, maxY);
+        border = path;
+        QList<QDoubleVector2D> outline = path;
+        outline << QDoubleVector2D(path.last().x(), poleY)
+                << QDoubleVector2D(path.first().x(), poleY);
+        fill << outline;
+        bounds = QRectF(QPointF(path.first().x(), qMin(minY, poleY)),
+                        QPointF(path.last().x(), qMax(maxY, poleY)));
+        return false;
+    }
+
+    // Both poles: the perimeter is a hole in a band covering the whole world
+    path.removeLast();
+    double minX = path.first().x();
+    double maxX = minX;
+    for (const QDoubleVector2D &point : qAsConst(path)) {
+        minX = qMin(minX, point.x());
+        maxX = qMax(maxX, point.x());
+    }
+    const double cx = (minX + maxX) * 0.5;
+    const double x0 = (cx + 0.5) - std::floor(cx + 0.5);
+    const double shift = x0 + 0.5 - cx;
+    for (QDoubleVector2D &point : path)
+        point.setX(point.x() + shift);
+
+    bounds = QRectF(QPointF(x0, qMin(0.0, minY)), QPointF(x0 + 2.0, qMax(1.0, maxY)));
+    fill << QDeclarativeGeoMapItemUtils::rectanglePath(bounds);
+    QList<QDoubleVector2D> nextHole;
+    nextHole.reserve(path.size());
+    for (const QDoubleVector2D &point : qAsConst(path))
+        nextHole << point + QDoubleVector2D(1.0, 0.0);
+    fill << path << nextHole;
+    border = path;
+    return true;
+}
+
 void QDeclarativeCircleMapItemPrivate::calculatePeripheralPoints(QList<QGeoCoordinate> &path,
                                       const QGeoCoordinate &center,
                                       qreal distance,
@@ -108,7 +108,6 @@ Q_SIGNALS:
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void updatePolish() override;
-    void possiblySwitchBackend(const QGeoCoordinate &oldCenter, qreal oldRadius, const QGeoCoordinate &newCenter, qreal newRadius);
 
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
@@ -125,6 +124,7 @@ private:
     bool m_dirtyMaterial;
     bool m_updatingGeometry;
     Backend m_backend = Software;
+    bool m_backendExplicit = false;
 
     QScopedPointer<QDeclarativeCircleMapItemPrivate> m_d;
 
@@ -109,6 +109,9 @@ public:
 
     static void calculatePeripheralPoints(QList<QGeoCoordinate> &path, const QGeoCoordinate &center,
                                    qreal distance, int steps, QGeoCoordinate &leftBound);
+    static bool calculatePolarPaths(const QList<QDoubleVector2D> &circlePath, const QGeoCoordinate &center,
+                                    qreal distance, QList<QList<QDoubleVector2D>> &fill,
+                                    QList<QDoubleVector2D> &border, QRectF &bounds);
 
     QDeclarativeCircleMapItem &m_circle;
     QList<QDoubleVector2D> m_circlePath;
@@ -304,6 +307,14 @@ public:
     virtual void markSourceDirtyAndUpdate() override
     {
         updateCirclePath();
+        m_crossesPole = crossEarthPole(m_circle.m_circle.center(), m_circle.m_circle.radius());
+        if (m_crossesPole) {
+            // Computed once here, panning and zooming only move the wrap offset
+            m_borderClosed = calculatePolarPaths(m_circlePath, m_circle.m_circle.center(), m_circle.m_circle.radius(),
+                                                 m_polarFill, m_polarBorder, m_polarBounds);
+        } else {
+            m_borderClosed = true;
+        }
         preserveGeometry();
         m_geometry.markSourceDirty();
         m_borderGeometry.markSourceDirty();
@@ -339,6 +350,8 @@ public:
             m_borderGeometry.clear();
             m_circle.setWidth(0);
             m_circle.setHeight(0);
+            if (QGeoMapItemBatchLayer *layer = QGeoMapItemBatchLayer::layerFor(&m_circle))
+                layer->removeItem(&m_circle);
             return;
         }
 
@@ -348,7 +361,10 @@ public:
         const QColor &lineColor = m_circle.m_border.color();
         const QColor &fillColor = m_circle.color();
         if (fillColor.alpha() != 0) {
-            m_geometry.updateSourcePoints(*m_circle.map(), m_circlePath);
+            if (m_crossesPole)
+                m_geometry.updateSourcePoints(*m_circle.map(), m_polarFill, m_polarBounds);
+            else
+                m_geometry.updateSourcePoints(*m_circle.map(), m_circlePath);
             m_geometry.markScreenDirty();
             m_geometry.updateScreenPoints(*m_circle.map(), lineWidth, lineColor);
         } else {
@@ -358,7 +374,10 @@ public:
         QGeoMapItemGeometry * geom = &m_geometry;
         m_borderGeometry.clearScreen();
         if (lineColor.alpha() != 0 && lineWidth > 0) {
-            m_borderGeometry.updateSourcePoints(*m_circle.map(), m_circle.m_circle);
+            if (m_crossesPole)
+                m_borderGeometry.updateSourcePoints(*m_circle.map(), m_polarBorder, m_polarBounds);
+            else
+                m_borderGeometry.updateSourcePoints(*m_circle.map(), m_circle.m_circle);
             m_borderGeometry.markScreenDirty();
             m_borderGeometry.updateScreenPoints(*m_circle.map(), lineWidth);
             geom = &m_borderGeometry;
@@ -366,12 +385,31 @@ public:
         m_circle.setWidth(geom->sourceBoundingBox().width());
         m_circle.setHeight(geom->sourceBoundingBox().height());
         m_circle.setPosition(1.0 * geom->firstPointOffset() - QPointF(lineWidth * 0.5,lineWidth * 0.5));
+
+        m_batched = false;
+        if (QGeoMapItemBatchLayer *layer = QGeoMapItemBatchLayer::layerFor(&m_circle)) {
+            layer->updateShape(&m_circle, fillColor, m_geometry, lineColor, float(lineWidth), m_borderGeometry,
+                               m_borderClosed);
+            m_batched = true;
+        }
     }
 
     virtual QSGNode * updateMapItemPaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *data) override
     {
         Q_UNUSED(data);
 
+        if (m_batched) { // drawn by the batch layer of the map
+            delete oldNode;
+            m_rootNode = nullptr;
+            m_node = nullptr;
+            m_polylinenode = nullptr;
+            m_geometry.setPreserveGeometry(false);
+            m_geometry.markClean();
+            m_borderGeometry.setPreserveGeometry(false);
+            m_borderGeometry.markClean();
+            return nullptr;
+        }
+
         if (!m_rootNode || !oldNode) {
             m_rootNode = new QDeclarativePolygonMapItemPrivateOpenGL::RootNode();
             m_node = new MapPolygonNodeGL();
@@ -397,7 +435,7 @@ public:
                                    combinedMatrix,
                                    cameraCenter,
                                    Qt::SquareCap,
-                                   true,
+                                   m_borderClosed,
                                    30); // No LOD for circles
             m_borderGeometry.setPreserveGeometry(false);
             m_borderGeometry.markClean();
@@ -442,6 +480,12 @@ public:
     QDeclarativePolygonMapItemPrivateOpenGL::RootNode *m_rootNode = nullptr;
     MapPolygonNodeGL *m_node = nullptr;
     MapPolylineNodeOpenGLExtruded *m_polylinenode = nullptr;
+    bool m_batched = false;
+    bool m_crossesPole = false;
+    bool m_borderClosed = true;
+    QList<QList<QDoubleVector2D>> m_polarFill;
+    QList<QDoubleVector2D> m_polarBorder;
+    QRectF m_polarBounds;
 };
 
 QT_END_NAMESPACE
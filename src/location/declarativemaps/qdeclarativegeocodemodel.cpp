@@ -39,6 +39,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtQml/QQmlInfo>
+#include <QtPositioning/QGeoAddress>
 #include <QtPositioning/QGeoCircle>
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/QGeoCodingManager>
@@ -75,6 +76,32 @@ QT_BEGIN_NAMESPACE
     objects, as a list with the role name "locationData". See the documentation
     for \l [QML] {Location} for further details on its structure and contents.
 
+    The Location objects are only created when "locationData" or \l get() is
+    used. Delegates needing only the position or the address of the results
+    can use the roles below instead, which are read from the results as they
+    are:
+
+    \table
+    \header
+        \li Role
+        \li Type
+        \li Description
+    \row
+        \li coordinate
+        \li \l {coordinate}
+        \li The coordinate of the location. Since Qt 5.15.
+    \row
+        \li boundingBox
+        \li \l {georectangle}
+        \li The bounding box of the location. Since Qt 5.15.
+    \row
+        \li address
+        \li object
+        \li The \l [QML] {Address} properties of the location, as values: \c text,
+            \c country, \c countryCode, \c state, \c county, \c city,
+            \c district, \c street and \c postalCode. Since Qt 5.15.
+    \endtable
+
     \section2 Example Usage
 
     The following snippet is two-part, showing firstly the declaration of
@@ -234,7 +261,7 @@ void QDeclarativeGeocodeModel::queryContentChanged()
 int QDeclarativeGeocodeModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return declarativeLocations_.count();
+    return locations_.count();
 }
 
 /*!
@@ -244,13 +271,34 @@ QVariant QDeclarativeGeocodeModel::data(const QModelIndex &index, int role) cons
 {
     if (!index.isValid())
         return QVariant();
-    if (index.row() >= declarativeLocations_.count())
+    if (index.row() >= locations_.count())
         return QVariant();
-    if (role == QDeclarativeGeocodeModel::LocationRole) {
-        QObject *locationObject = declarativeLocations_.at(index.row());
+    const QGeoLocation &location = locations_.at(index.row());
+    switch (role) {
+    case QDeclarativeGeocodeModel::LocationRole: {
+        QObject *locationObject = declarativeLocation(index.row());
         Q_ASSERT(locationObject);
         return QVariant::fromValue(locationObject);
     }
+    case QDeclarativeGeocodeModel::CoordinateRole:
+        return QVariant::fromValue(location.coordinate());
+    case QDeclarativeGeocodeModel::BoundingBoxRole:
+        return QVariant::fromValue(location.boundingBox());
+    case QDeclarativeGeocodeModel::AddressRole: {
+        const QGeoAddress address = location.address();
+        QVariantMap map;
+        map.insert(QStringLiteral("text"), address.text());
+        map.insert(QStringLiteral("country"), address.country());
+        map.insert(QStringLiteral("countryCode"), address.countryCode());
+        map.insert(QStringLiteral("state"), address.state());
+        map.insert(QStringLiteral("county"), address.county());
+        map.insert(QStringLiteral("city"), address.city());
+        map.insert(QStringLiteral("district"), address.district());
+        map.insert(QStringLiteral("street"), address.street());
+        map.insert(QStringLiteral("postalCode"), address.postalCode());
+        return map;
+    }
+    }
     return QVariant();
 }
 
@@ -258,6 +306,9 @@ QHash<int, QByteArray> QDeclarativeGeocodeModel::roleNames() const
 {
     QHash<int, QByteArray> roleNames = QAbstractItemModel::roleNames();
     roleNames.insert(LocationRole, "locationData");
+    roleNames.insert(CoordinateRole, "coordinate");
+    roleNames.insert(BoundingBoxRole, "boundingBox");
+    roleNames.insert(AddressRole, "address");
     return roleNames;
 }
 
@@ -389,13 +440,13 @@ void QDeclarativeGeocodeModel::geocodeFinished(QGeoCodeReply *reply)
 
     reply->deleteLater();
     reply_ = 0;
-    int oldCount = declarativeLocations_.count();
+    int oldCount = locations_.count();
     // const QVariantMap &extraData = QGeoCodeReplyPrivate::get(*reply)->extraData();
     setLocations(reply->locations());
     setError(NoError, QString());
     setStatus(QDeclarativeGeocodeModel::Ready);
     emit locationsChanged();
-    if (oldCount != declarativeLocations_.count())
+    if (oldCount != locations_.count())
         emit countChanged();
 }
 
@@ -411,7 +462,7 @@ void QDeclarativeGeocodeModel::geocodeError(QGeoCodeReply *reply,
 
     reply->deleteLater();
     reply_ = 0;
-    int oldCount = declarativeLocations_.count();
+    int oldCount = locations_.count();
     if (oldCount > 0) {
         // Reset the model
         setLocations(reply->locations());
@@ -504,14 +555,24 @@ void QDeclarativeGeocodeModel::setLocations(const QList<QGeoLocation> &locations
 {
     beginResetModel();
     qDeleteAll(declarativeLocations_);
-    declarativeLocations_.clear();
-    for (int i = 0;  i < locations.count(); ++i) {
-        QDeclarativeGeoLocation *location = new QDeclarativeGeoLocation(locations.at(i), this);
-        declarativeLocations_.append(location);
-    }
+    locations_ = locations;
+    declarativeLocations_.fill(nullptr, locations.count());
     endResetModel();
 }
 
+/*!
+    \internal
+*/
+QDeclarativeGeoLocation *QDeclarativeGeocodeModel::declarativeLocation(int row) const
+{
+    QDeclarativeGeoLocation *&location = declarativeLocations_[row];
+    if (!location) {
+        location = new QDeclarativeGeoLocation(locations_.at(row),
+                                               const_cast<QDeclarativeGeocodeModel *>(this));
+    }
+    return location;
+}
+
 /*!
     \qmlproperty int QtLocation::GeocodeModel::count
 
@@ -522,7 +583,7 @@ void QDeclarativeGeocodeModel::setLocations(const QList<QGeoLocation> &locations
 
 int QDeclarativeGeocodeModel::count() const
 {
-    return declarativeLocations_.count();
+    return locations_.count();
 }
 
 /*!
@@ -537,11 +598,11 @@ int QDeclarativeGeocodeModel::count() const
 
 QDeclarativeGeoLocation *QDeclarativeGeocodeModel::get(int index)
 {
-    if (index < 0 || index >= declarativeLocations_.count()) {
+    if (index < 0 || index >= locations_.count()) {
         qmlWarning(this) << QStringLiteral("Index '%1' out of range").arg(index);
         return 0;
     }
-    return declarativeLocations_.at(index);
+    return declarativeLocation(index);
 }
 
 /*!
@@ -608,7 +669,7 @@ void QDeclarativeGeocodeModel::setOffset(int offset)
 void QDeclarativeGeocodeModel::reset()
 {
     beginResetModel();
-    if (!declarativeLocations_.isEmpty()) {
+    if (!locations_.isEmpty()) {
         setLocations(QList<QGeoLocation>());
         emit countChanged();
     }
@@ -629,7 +690,7 @@ void QDeclarativeGeocodeModel::cancel()
 {
     abortRequest();
     setError(NoError, QString());
-    setStatus(declarativeLocations_.isEmpty() ? Null : Ready);
+    setStatus(locations_.isEmpty() ? Null : Ready);
 }
 
 /*!
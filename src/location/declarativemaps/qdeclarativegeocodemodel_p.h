@@ -109,7 +109,10 @@ public:
     };
 
     enum Roles {
-        LocationRole = Qt::UserRole + 1
+        LocationRole = Qt::UserRole + 1,
+        CoordinateRole,
+        BoundingBoxRole,
+        AddressRole
     };
 
     explicit QDeclarativeGeocodeModel(QObject *parent = 0);
@@ -182,13 +185,16 @@ protected:
 
 private:
     void setLocations(const QList<QGeoLocation> &locations);
+    QDeclarativeGeoLocation *declarativeLocation(int row) const;
     void abortRequest();
     QGeoCodeReply *reply_;
 
     QDeclarativeGeoServiceProvider *plugin_;
     QGeoShape boundingArea_;
 
-    QList<QDeclarativeGeoLocation *> declarativeLocations_;
+    QList<QGeoLocation> locations_;
+    // Created by declarativeLocation() on first use, null until then
+    mutable QVector<QDeclarativeGeoLocation *> declarativeLocations_;
 
     Status status_;
     QString errorString_;
@@ -44,6 +44,9 @@
 #include "qgeomap_p.h"
 #include "qdeclarativegeomapparameter_p.h"
 #include "qgeomapobject_p.h"
+#include "qgeomapitembatchlayer_p.h"
+#include "qgeomapspatialindex_p.h"
+#include "qgeomapstatistics_p.h"
 #include <QtPositioning/QGeoCircle>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPath>
@@ -52,8 +55,13 @@
 #include <QtQuick/QSGRectangleNode>
 #include <QtQuick/private/qquickwindow_p.h>
 #include <QtQml/qqmlinfo.h>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
 #include <QtQuick/private/qquickitem_p.h>
 #include <cmath>
+#include <algorithm>
 
 #ifndef M_PI
 #define M_PI 3.141592653589793238463
@@ -62,6 +70,11 @@
 
 QT_BEGIN_NAMESPACE
 
+// Fewer map items all follow the viewport, as looking them up costs more than it saves
+static const int MinimumCulledMapItems = 64;
+// Fewer map items waiting for their geometry are not worth handing to the thread pool
+static const int MinimumParallelMapItems = 8;
+
 static qreal sanitizeBearing(qreal bearing)
 {
     bearing = std::fmod(bearing, qreal(360.0));
@@ -199,6 +212,7 @@ QDeclarativeGeoMap::QDeclarativeGeoMap(QQuickItem *parent)
     setAcceptedMouseButtons(Qt::LeftButton);
     setFlags(QQuickItem::ItemHasContents | QQuickItem::ItemClipsChildrenToShape);
     setFiltersChildMouseEvents(true); // needed for childMouseEventFilter to work.
+    QGeoMapStatistics::startMemoryReports();
 
     m_activeMapType = new QDeclarativeGeoMapType(QGeoMapType(QGeoMapType::NoMap,
                                                              tr("No Map"),
@@ -269,9 +283,12 @@ QDeclarativeGeoMap::~QDeclarativeGeoMap()
     }
 
     // remove any remaining map items associations
-    const auto mapItems = m_mapItems;
-    for (auto mi: mapItems)
-        removeMapItem_real(mi.data());
+    QList<QDeclarativeGeoMapItemBase *> mapItems;
+    for (const QPointer<QDeclarativeGeoMapItemBase> &mi : qAsConst(m_mapItems)) {
+        if (mi)
+            mapItems.append(mi.data());
+    }
+    removeMapItems_real(mapItems);
 
     if (m_copyrights.data())
         delete m_copyrights.data();
@@ -280,6 +297,8 @@ QDeclarativeGeoMap::~QDeclarativeGeoMap()
     for (auto obj: qAsConst(m_pendingMapObjects))
         obj->setMap(nullptr); // worst case: going to be setMap(nullptr)'d twice
 
+    setStatisticsEnabled(false);
+
     delete m_map; // map objects get reset here
 }
 
@@ -447,6 +466,68 @@ QQuickGeoMapGestureArea *QDeclarativeGeoMap::gesture()
     return m_gestureArea;
 }
 
+/*!
+    \internal
+    The layer drawing the batched map items, nullptr unless batching is enabled.
+*/
+QGeoMapItemBatchLayer *QDeclarativeGeoMap::itemBatchLayer() const
+{
+    return m_itemBatchLayer;
+}
+
+/*!
+    \internal
+    Runs the geometry work of the map items waiting to be polished on the global thread pool,
+    and returns once all of it is done. Called by the first of them to be polished, \a polishing,
+    so that each item's updatePolish() only applies the results. Later calls in the same polish
+    pass return right away.
+*/
+void QDeclarativeGeoMap::prepareItemGeometries(QDeclarativeGeoMapItemBase *polishing)
+{
+    if (m_itemGeometriesPrepared)
+        return;
+    m_itemGeometriesPrepared = true;
+    QMetaObject::invokeMethod(this, [this]() { m_itemGeometriesPrepared = false; }, Qt::QueuedConnection);
+
+    // updatePolish() is only called once the polish request has been taken back
+    QVector<QDeclarativeGeoMapItemBase *> pending;
+    for (const QPointer<QDeclarativeGeoMapItemBase> &item : qAsConst(m_mapItems)) {
+        if (item && (item == polishing || item->isPolishScheduled()) && item->hasPendingGeometry())
+            pending.append(item.data());
+    }
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int threads = pool->maxThreadCount();
+    if (pending.size() < MinimumParallelMapItems || threads < 2)
+        return;
+
+    // The projection updates its regions lazily, which must not happen from the workers
+    if (m_map->geoProjection().projectionType() == QGeoProjection::ProjectionWebMercator)
+        static_cast<const QGeoProjectionWebMercator &>(m_map->geoProjection()).projectableGeometry();
+
+    QAtomicInt next(0);
+    auto work = [&pending, &next]() {
+        for (int i = next.fetchAndAddRelaxed(1); i < pending.size(); i = next.fetchAndAddRelaxed(1))
+            pending.at(i)->prepareGeometry();
+    };
+
+    // Only use threads that are free right away, the rest of the work is done here
+    QSemaphore done;
+    int helpers = 0;
+    for (int i = 1; i < qMin(threads, pending.size()); ++i) {
+        QRunnable *task = QRunnable::create([&work, &done]() {
+            work();
+            done.release();
+        });
+        if (!pool->tryStart(task)) {
+            delete task;
+            break;
+        }
+        ++helpers;
+    }
+    work();
+    done.acquire(helpers);
+}
+
 /*!
     \internal
 
@@ -490,6 +571,7 @@ void QDeclarativeGeoMap::setupMapView(QDeclarativeGeoMapItemView *view)
  */
 QSGNode *QDeclarativeGeoMap::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::SceneGraph);
     if (!m_map) {
         delete oldNode;
         return 0;
@@ -627,14 +709,22 @@ void QDeclarativeGeoMap::mappingManagerInitialized()
     if (!m_map)
         return;
 
+    if (QGeoMapItemBatchLayer::isEnabled()
+            || ((m_map->capabilities() & QGeoMap::PrefersOpenGLMapItems)
+                && QQuickWindow::sceneGraphBackend().isEmpty()))
+        m_itemBatchLayer = new QGeoMapItemBatchLayer(this, m_map);
+
     // Any map items that were added before the plugin was ready
     // need to have setMap called again
+    QList<QDeclarativeGeoMapItemBase *> items;
+    items.reserve(m_mapItems.size());
     for (const QPointer<QDeclarativeGeoMapItemBase> &item : qAsConst(m_mapItems)) {
         if (item) {
             item->setMap(this, m_map);
-            m_map->addMapItem(item.data()); // m_map filters out what is not supported.
+            items.append(item.data());
         }
     }
+    m_map->addMapItems(items); // m_map filters out what is not supported.
 
     /* COPY NOTICE SETUP */
     m_copyrights = new QDeclarativeGeoMapCopyrightNotice(this);
@@ -670,6 +760,7 @@ void QDeclarativeGeoMap::mappingManagerInitialized()
                                                                      QGeoCameraCapabilities()), this);
         }
     }
+    applyOverlayMapTypes();
 
     // Update camera capabilities
     onCameraCapabilitiesChanged(m_cameraCapabilities);
@@ -708,6 +799,7 @@ void QDeclarativeGeoMap::mappingManagerInitialized()
 
 
     connect(window(), &QQuickWindow::beforeSynchronizing, this, &QDeclarativeGeoMap::updateItemToWindowTransform, Qt::DirectConnection);
+    connect(window(), &QQuickWindow::afterAnimating, m_map.data(), &QGeoMap::prepareFrame);
     connect(m_map.data(), &QGeoMap::sgNodeChanged, this, &QDeclarativeGeoMap::onSGNodeChanged);
     connect(m_map.data(), &QGeoMap::cameraCapabilitiesChanged, this, &QDeclarativeGeoMap::onCameraCapabilitiesChanged);
 
@@ -1449,10 +1541,7 @@ void QDeclarativeGeoMap::setVisibleArea(const QRectF &visibleArea)
         const QRectF newVisibleArea = QDeclarativeGeoMap::visibleArea();
         if (newVisibleArea != oldVisibleArea) {
             // polish map items
-            for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_mapItems)) {
-                if (i)
-                    i->visibleAreaChanged();
-            }
+            notifyMapItemsOfViewport(false);
         }
     } else {
         m_visibleArea = visibleArea;
@@ -1477,6 +1566,115 @@ bool QDeclarativeGeoMap::mapReady() const
     return m_initialized;
 }
 
+/*!
+    \qmlproperty bool QtLocation::Map::statisticsEnabled
+
+    This property holds whether the time spent producing map frames is
+    measured, to be read through \l statistics. The default value is false.
+
+    Measurements are made for the whole application, not for this map alone,
+    and are enabled as long as one map enables them. They are also enabled,
+    and each measurement logged, when debug output of the
+    \c qt.location.map.statistics logging category is enabled.
+
+    \sa statistics, resetStatistics
+    \since 5.15
+*/
+bool QDeclarativeGeoMap::statisticsEnabled() const
+{
+    return m_statisticsEnabled;
+}
+
+void QDeclarativeGeoMap::setStatisticsEnabled(bool enabled)
+{
+    if (enabled == m_statisticsEnabled)
+        return;
+    m_statisticsEnabled = enabled;
+    if (enabled)
+        QGeoMapStatistics::enable();
+    else
+        QGeoMapStatistics::disable();
+    emit statisticsEnabledChanged();
+}
+
+/*!
+    \qmlmethod object QtLocation::Map::statistics()
+
+    Returns the measurements made since statistics were enabled or last
+    reset. The returned object has one property for each of these phases:
+
+    \list
+    \li \c cameraTiles, computing the tiles seen by the camera
+    \li \c requestTiles, finding the tiles to fetch and the cached ones
+    \li \c tileDecode, decoding tile images, including the decodes
+         made in worker threads
+    \li \c itemPolish, updating the geometry of map items
+    \li \c itemPaintNode, updating the scene graph nodes of map items
+    \li \c sceneGraph, updating the scene graph nodes of the map
+    \endlist
+
+    Each of them holds the \c count of measurements, and their \c totalTime
+    and \c maxTime in milliseconds. The \c textureCacheHits,
+    \c memoryCacheHits, \c diskCacheHits and \c cacheMisses properties
+    count how tile lookups were served by the tile cache. The
+    \c textureCacheMinimum, \c textureCacheLimit and \c memoryCacheLimit
+    properties hold the sizes the tile cache last chose for itself, from the
+    size of the maps and the memory of the device.
+
+    \sa statisticsEnabled, resetStatistics
+    \since 5.15
+*/
+QVariantMap QDeclarativeGeoMap::statistics() const
+{
+    return QGeoMapStatistics::snapshot();
+}
+
+/*!
+    \qmlmethod void QtLocation::Map::resetStatistics()
+
+    Clears the measurements returned by \l statistics.
+
+    \since 5.15
+*/
+void QDeclarativeGeoMap::resetStatistics()
+{
+    QGeoMapStatistics::reset();
+}
+
+/*!
+    \qmlmethod object QtLocation::Map::memoryReport()
+
+    Returns how many bytes the maps and the map related objects of the
+    application hold. The returned object has one property for each of
+    these parts:
+
+    \list
+    \li \c tileMemoryCache, the tile data kept in memory by the tile caches
+    \li \c tileTextureCache, the decoded tiles
+    \li \c sceneTextures, the tile textures uploaded by the maps
+    \li \c itemGeometry, the geometry of the map items
+    \li \c triangulationCache, the triangulations kept for polygons
+    \li \c routes, the routes of the route models, estimated
+    \li \c placeResults, the results of the place search models, estimated
+    \endlist
+
+    Each of them, and the \c total of all of them, holds the \c bytes it
+    holds and the \c peakBytes it held since it was created or since
+    resetStatistics() was last called. Unlike the \l statistics, the bytes
+    are counted whether \l statisticsEnabled is set or not.
+
+    When debug output of the \c qt.location.map.memory logging category is
+    enabled, the report is also logged every
+    \c QT_LOCATION_MEMORY_REPORT_INTERVAL milliseconds, or every 10 seconds.
+
+    \sa statistics
+    \since 5.15
+*/
+QVariantMap QDeclarativeGeoMap::memoryReport() const
+{
+    return QGeoMapStatistics::memoryReport();
+}
+
 QMargins QDeclarativeGeoMap::mapMargins() const
 {
     const QRectF va = m_map->visibleArea();
@@ -1775,11 +1973,10 @@ void QDeclarativeGeoMap::onCameraDataChanged(const QGeoCameraData &cameraData)
     bool zoomHasChanged = cameraData.zoomLevel() != m_cameraData.zoomLevel();
 
     m_cameraData = cameraData;
+    if (m_itemBatchLayer)
+        m_itemBatchLayer->update();
     // polish map items
-    for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_mapItems)) {
-        if (i)
-            i->baseCameraDataChanged(m_cameraData); // Consider optimizing this further, removing the contained duplicate if conditions.
-    }
+    notifyMapItemsOfViewport(true);
 
     if (centerHasChanged)
         emit centerChanged(m_cameraData.center());
@@ -1954,6 +2151,208 @@ QList<QGeoMapObject *> QDeclarativeGeoMap::mapObjects()
         return m_map->mapObjects();
 }
 
+/*!
+    \qmlmethod list<QtObject> QtLocation::Map::mapItemsInShape(geoShape shape)
+
+    Returns the map items and map objects intersecting \a shape, sorted by the
+    distance of their center to the center of \a shape. Items are matched by
+    their bounding rectangles, so the result is exact only when \a shape is
+    a rectangle.
+
+    This is meant for selections and for listing the items in a region, and
+    does not need to iterate over all the items of the map.
+
+    \sa mapItemsInRect, mapItems
+    \since 5.15
+*/
+QList<QObject *> QDeclarativeGeoMap::mapItemsInShape(const QGeoShape &shape)
+{
+    QList<QObject *> res;
+    if (!shape.isValid())
+        return res;
+
+    ensureMapItemIndex();
+
+    const QList<QObject *> candidates = m_mapItemIndex->candidatesIn(shape.boundingGeoRectangle());
+    for (QObject *candidate: candidates) {
+        const QGeoShape itemShape = QGeoMapSpatialIndex::geoShape(candidate);
+        if (QGeoMapSpatialIndex::intersects(shape, itemShape.boundingGeoRectangle()))
+            res.append(candidate);
+    }
+    if (m_map)
+        res.append(m_map->mapObjectsIn(shape));
+
+    const QGeoCoordinate center = shape.center();
+    QVector<QPair<qreal, QObject *>> sorted;
+    sorted.reserve(res.size());
+    for (QObject *o: qAsConst(res))
+        sorted.append(qMakePair(center.distanceTo(QGeoMapSpatialIndex::geoShape(o).center()), o));
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const QPair<qreal, QObject *> &a, const QPair<qreal, QObject *> &b) {
+                         return a.first < b.first;
+                     });
+    for (int i = 0; i < sorted.size(); ++i)
+        res[i] = sorted.at(i).second;
+    return res;
+}
+
+/*!
+    \qmlmethod list<QtObject> QtLocation::Map::mapItemsInRect(rect rect)
+
+    Returns the map items and map objects intersecting the region of the map
+    shown in \a rect, in screen pixels, as \l mapItemsInShape does. Parts of
+    \a rect showing no coordinate, above the horizon of a tilted map, are
+    ignored.
+
+    \sa mapItemsInShape
+    \since 5.15
+*/
+QList<QObject *> QDeclarativeGeoMap::mapItemsInRect(const QRectF &rect)
+{
+    if (!m_map)
+        return QList<QObject *>();
+
+    // bearing and tilt turn the rectangle into any quadrilateral
+    QGeoPolygon region;
+    const QPointF corners[] = { rect.topLeft(), rect.topRight(), rect.bottomRight(), rect.bottomLeft() };
+    for (const QPointF &corner: corners) {
+        const QGeoCoordinate coordinate = toCoordinate(corner, false);
+        if (coordinate.isValid())
+            region.addCoordinate(coordinate);
+    }
+    if (region.size() < 3)
+        return QList<QObject *>();
+    return mapItemsInShape(region);
+}
+
+void QDeclarativeGeoMap::indexMapItem(QDeclarativeGeoMapItemBase *item)
+{
+    // The signals of the item types changing their geoShape
+    static const QSet<QByteArray> geometrySignals = {
+        "centerChanged", "radiusChanged", "topLeftChanged", "bottomRightChanged",
+        "pathChanged", "routeChanged", "coordinateChanged"
+    };
+    static const QMetaMethod slot =
+            staticMetaObject.method(staticMetaObject.indexOfSlot("onMapItemGeometryChanged()"));
+
+    const QMetaObject *mo = item->metaObject();
+    for (int i = QDeclarativeGeoMapItemBase::staticMetaObject.methodCount(); i < mo->methodCount(); ++i) {
+        const QMetaMethod method = mo->method(i);
+        if (method.methodType() == QMetaMethod::Signal && geometrySignals.contains(method.name()))
+            connect(item, method, this, slot);
+    }
+    m_mapItemIndex->insert(item);
+}
+
+void QDeclarativeGeoMap::onMapItemGeometryChanged()
+{
+    if (m_mapItemIndex)
+        m_mapItemIndex->markDirty(sender());
+    // it was laid out for the current camera, and may now be in view
+    if (m_viewportCulling)
+        m_viewportItems.insert(static_cast<QDeclarativeGeoMapItemBase *>(sender()));
+}
+
+void QDeclarativeGeoMap::ensureMapItemIndex()
+{
+    if (m_mapItemIndex)
+        return;
+    m_mapItemIndex.reset(new QGeoMapSpatialIndex);
+    for (const QPointer<QDeclarativeGeoMapItemBase> &item: qAsConst(m_mapItems))
+        if (item)
+            indexMapItem(item);
+}
+
+/*
+    Returns the visible region grown by its own size on every side, or an
+    invalid rectangle if all items should follow the viewport.
+*/
+QGeoRectangle QDeclarativeGeoMap::viewportUpdateRegion() const
+{
+    const QGeoRectangle visible = visibleRegion().boundingGeoRectangle();
+    if (!visible.isValid() || visible.isEmpty())
+        return QGeoRectangle();
+
+    const double width = visible.width();
+    const double height = visible.height();
+    const double top = qMin(90.0, visible.topLeft().latitude() + height);
+    const double bottom = qMax(-90.0, visible.bottomRight().latitude() - height);
+    if (width * 3 >= 360.0)
+        return QGeoRectangle(QGeoCoordinate(top, -180.0), QGeoCoordinate(bottom, 180.0));
+
+    const auto wrap = [](double longitude) {
+        return longitude > 180.0 ? longitude - 360.0
+                                 : (longitude < -180.0 ? longitude + 360.0 : longitude);
+    };
+    return QGeoRectangle(QGeoCoordinate(top, wrap(visible.topLeft().longitude() - width)),
+                         QGeoCoordinate(bottom, wrap(visible.bottomRight().longitude() + width)));
+}
+
+/*
+    Lets the map items follow a change of the camera, or of the visible area.
+
+    With many items, only those whose bounding box intersects the
+    viewportUpdateRegion() are updated. Items leaving it get one last update,
+    which moves them out of the view, and are then left alone until they
+    come back. Items sized in pixels are always updated.
+*/
+void QDeclarativeGeoMap::notifyMapItemsOfViewport(bool cameraChanged)
+{
+    const auto notify = [this, cameraChanged](QDeclarativeGeoMapItemBase *item) {
+        if (cameraChanged)
+            item->baseCameraDataChanged(m_cameraData);
+        else
+            item->visibleAreaChanged();
+    };
+
+    QGeoRectangle region;
+    if (m_mapItems.size() >= MinimumCulledMapItems)
+        region = viewportUpdateRegion();
+    if (!region.isValid()) {
+        const auto items = m_mapItems;
+        for (const QPointer<QDeclarativeGeoMapItemBase> &i: items) {
+            if (i)
+                notify(i);
+        }
+        m_viewportItems.clear();
+        m_viewportCulling = false;
+        return;
+    }
+
+    ensureMapItemIndex();
+    QSet<QDeclarativeGeoMapItemBase *> current = m_pixelSizedItems;
+    const QList<QObject *> candidates = m_mapItemIndex->candidatesIn(region);
+    current.reserve(current.size() + candidates.size());
+    for (QObject *candidate: candidates)
+        current.insert(static_cast<QDeclarativeGeoMapItemBase *>(candidate));
+
+    QList<QDeclarativeGeoMapItemBase *> leaving;
+    if (m_viewportCulling) {
+        for (QDeclarativeGeoMapItemBase *item: qAsConst(m_viewportItems)) {
+            if (!current.contains(item))
+                leaving.append(item);
+        }
+    } else {
+        // all items followed the viewport so far
+        for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_mapItems)) {
+            if (i && !current.contains(i.data()))
+                leaving.append(i.data());
+        }
+    }
+    m_viewportItems = current;
+    m_viewportCulling = true;
+
+    // notifying may add or remove items
+    for (QDeclarativeGeoMapItemBase *item: qAsConst(leaving)) {
+        if (mapItemSlot(item) >= 0)
+            notify(item);
+    }
+    for (QDeclarativeGeoMapItemBase *item: qAsConst(current)) {
+        if (mapItemSlot(item) >= 0)
+            notify(item);
+    }
+}
+
 /*!
     \qmlproperty list<MapItem> QtLocation::Map::mapItems
 
@@ -2001,19 +2400,76 @@ void QDeclarativeGeoMap::addMapItem(QDeclarativeGeoMapItemBase *item)
 
 bool QDeclarativeGeoMap::addMapItem_real(QDeclarativeGeoMapItemBase *item)
 {
-    if (!item || item->quickMap())
+    if (!attachMapItem(item))
+        return false;
+    if (m_map)
+        m_map->addMapItem(item);
+    return true;
+}
+
+/*
+    Returns the index of item in m_mapItems, or -1. The slots are keyed by
+    address, so the entry of an item destroyed without being removed may
+    refer to another slot by now and is checked.
+*/
+int QDeclarativeGeoMap::mapItemSlot(QDeclarativeGeoMapItemBase *item) const
+{
+    const int slot = m_mapItemSlots.value(item, -1);
+    if (slot < 0 || slot >= m_mapItems.size() || m_mapItems.at(slot) != item)
+        return -1;
+    return slot;
+}
+
+/*
+    Adds item to m_mapItems and gives it the map, except for telling m_map.
+*/
+bool QDeclarativeGeoMap::attachMapItem(QDeclarativeGeoMapItemBase *item)
+{
+    if (!item || item->quickMap() || mapItemSlot(item) >= 0)
         return false;
     // If the item comes from a MapItemGroup, do not reparent it.
     if (!qobject_cast<QDeclarativeGeoMapItemGroup *>(item->parentItem()))
         item->setParentItem(this);
+    m_mapItemSlots.insert(item, m_mapItems.size());
     m_mapItems.append(item);
-    if (m_map) {
+    if (qobject_cast<QDeclarativeGeoMapQuickItem *>(item))
+        m_pixelSizedItems.insert(item);
+    if (m_viewportCulling)
+        m_viewportItems.insert(item); // laid out for the current camera
+    if (m_map)
         item->setMap(this, m_map);
-        m_map->addMapItem(item);
-    }
+    if (m_mapItemIndex)
+        indexMapItem(item);
     return true;
 }
 
+/*
+    Undoes attachMapItem() for an item in m_mapItems, after m_map was told.
+    The last item takes the slot of the removed one, as mapItems is unordered.
+*/
+void QDeclarativeGeoMap::detachMapItem(QDeclarativeGeoMapItemBase *item)
+{
+    const int slot = mapItemSlot(item);
+    if (m_mapItemIndex) {
+        m_mapItemIndex->remove(item);
+        disconnect(item, nullptr, this, SLOT(onMapItemGeometryChanged()));
+    }
+    if (item->parentItem() == this)
+        item->setParentItem(0);
+    item->setMap(0, 0);
+
+    m_mapItemSlots.remove(item);
+    m_pixelSizedItems.remove(item);
+    m_viewportItems.remove(item);
+    const int last = m_mapItems.size() - 1;
+    if (slot != last) {
+        m_mapItems[slot] = m_mapItems.at(last);
+        if (QDeclarativeGeoMapItemBase *moved = m_mapItems.at(slot).data())
+            m_mapItemSlots[moved] = slot;
+    }
+    m_mapItems.removeLast();
+}
+
 /*!
     \qmlmethod void QtLocation::Map::removeMapItem(MapItem item)
 
@@ -2031,21 +2487,94 @@ void QDeclarativeGeoMap::removeMapItem(QDeclarativeGeoMapItemBase *ptr)
 
 bool QDeclarativeGeoMap::removeMapItem_real(QDeclarativeGeoMapItemBase *ptr)
 {
-    if (!ptr)
-        return false;
-    QPointer<QDeclarativeGeoMapItemBase> item(ptr);
-    if (!m_mapItems.contains(item))
+    if (!ptr || mapItemSlot(ptr) < 0)
         return false;
     if (m_map)
         m_map->removeMapItem(ptr);
-    if (item->parentItem() == this)
-        item->setParentItem(0);
-    item->setMap(0, 0);
-    // these can be optimized for perf, as we already check the 'contains' above
-    m_mapItems.removeOne(item);
+    detachMapItem(ptr);
     return true;
 }
 
+/*!
+    \qmlmethod void QtLocation::Map::addMapItems(list<MapItem> items)
+
+    Adds the given \a items to the Map, like \l addMapItem does for each of
+    them, but updates the map and emits the change of \l mapItems once. This
+    is much faster for many items. Items already on a Map are skipped.
+
+    \sa addMapItem, removeMapItems
+    \since 5.15
+*/
+void QDeclarativeGeoMap::addMapItems(const QList<QObject *> &items)
+{
+    QList<QDeclarativeGeoMapItemBase *> mapItems;
+    mapItems.reserve(items.size());
+    for (QObject *item : items) {
+        if (QDeclarativeGeoMapItemBase *mapItem = qobject_cast<QDeclarativeGeoMapItemBase *>(item))
+            mapItems.append(mapItem);
+    }
+    if (addMapItems_real(mapItems))
+        emit mapItemsChanged();
+}
+
+int QDeclarativeGeoMap::addMapItems_real(const QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    QList<QDeclarativeGeoMapItemBase *> added;
+    added.reserve(items.size());
+    for (QDeclarativeGeoMapItemBase *item : items) {
+        if (attachMapItem(item))
+            added.append(item);
+    }
+    if (m_map && !added.isEmpty())
+        m_map->addMapItems(added);
+    return added.size();
+}
+
+/*!
+    \qmlmethod void QtLocation::Map::removeMapItems(list<MapItem> items)
+
+    Removes the given \a items from the Map, like \l removeMapItem does for
+    each of them, but updates the map and emits the change of \l mapItems
+    once. Items that are not on the Map are skipped.
+
+    \sa removeMapItem, addMapItems, clearMapItems
+    \since 5.15
+*/
+void QDeclarativeGeoMap::removeMapItems(const QList<QObject *> &items)
+{
+    QList<QDeclarativeGeoMapItemBase *> mapItems;
+    mapItems.reserve(items.size());
+    for (QObject *item : items) {
+        if (QDeclarativeGeoMapItemBase *mapItem = qobject_cast<QDeclarativeGeoMapItemBase *>(item))
+            mapItems.append(mapItem);
+    }
+    if (removeMapItems_real(mapItems))
+        emit mapItemsChanged();
+}
+
+int QDeclarativeGeoMap::removeMapItems_real(const QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    QList<QDeclarativeGeoMapItemBase *> removed;
+    removed.reserve(items.size());
+    for (QDeclarativeGeoMapItemBase *item : items) {
+        if (item && mapItemSlot(item) >= 0)
+            removed.append(item);
+    }
+    if (removed.isEmpty())
+        return 0;
+
+    if (m_map)
+        m_map->removeMapItems(removed);
+    int count = 0;
+    for (QDeclarativeGeoMapItemBase *item : qAsConst(removed)) {
+        if (mapItemSlot(item) < 0)
+            continue; // listed twice
+        detachMapItem(item);
+        ++count;
+    }
+    return count;
+}
+
 /*!
     \qmlmethod void QtLocation::Map::clearMapItems()
 
@@ -2071,8 +2600,18 @@ void QDeclarativeGeoMap::clearMapItems()
         removed += removeMapItemGroup_real(i);
     }
 
-    for (auto i : qAsConst(m_mapItems))
-        removed += removeMapItem_real(i);
+    QList<QDeclarativeGeoMapItemBase *> items;
+    items.reserve(m_mapItems.size());
+    for (const QPointer<QDeclarativeGeoMapItemBase> &i : qAsConst(m_mapItems)) {
+        if (i)
+            items.append(i.data());
+    }
+    removed += removeMapItems_real(items);
+    // only the slots of items destroyed without being removed are left
+    m_mapItems.clear();
+    m_mapItemSlots.clear();
+    m_pixelSizedItems.clear();
+    m_viewportItems.clear();
 
     if (removed)
         emit mapItemsChanged();
@@ -2096,8 +2635,24 @@ void QDeclarativeGeoMap::addMapItemGroup(QDeclarativeGeoMapItemGroup *itemGroup)
 
 bool QDeclarativeGeoMap::addMapItemGroup_real(QDeclarativeGeoMapItemGroup *itemGroup)
 {
-    if (!itemGroup || itemGroup->quickMap()) // Already added to some map
+    // the items of the group and of its nested groups are added as one batch
+    QList<QDeclarativeGeoMapItemBase *> items;
+    const int count = attachMapItemGroup(itemGroup, items);
+    if (count < 0)
         return false;
+    return count + addMapItems_real(items);
+}
+
+/*
+    Gives the map to itemGroup and its nested groups, and appends their map
+    items to items. Returns the number of items added meanwhile by nested
+    views, or -1 if itemGroup can't be added.
+*/
+int QDeclarativeGeoMap::attachMapItemGroup(QDeclarativeGeoMapItemGroup *itemGroup,
+                                           QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    if (!itemGroup || itemGroup->quickMap()) // Already added to some map
+        return -1;
 
     itemGroup->setQuickMap(this);
 
@@ -2109,8 +2664,13 @@ bool QDeclarativeGeoMap::addMapItemGroup_real(QDeclarativeGeoMapItemGroup *itemG
 
     const QList<QQuickItem *> quickKids = itemGroup->childItems();
     int count = 0;
-    for (auto c: quickKids) {
-        count += addMapChild(c); // this calls addMapItemGroup recursively, if needed
+    for (QQuickItem *c : quickKids) {
+        if (QDeclarativeGeoMapItemView *view = qobject_cast<QDeclarativeGeoMapItemView *>(c))
+            count += addMapItemView_real(view);
+        else if (QDeclarativeGeoMapItemGroup *group = qobject_cast<QDeclarativeGeoMapItemGroup *>(c))
+            count += qMax(0, attachMapItemGroup(group, items));
+        else if (QDeclarativeGeoMapItemBase *item = qobject_cast<QDeclarativeGeoMapItemBase *>(c))
+            items.append(item);
     }
     return count;
 }
@@ -2132,21 +2692,48 @@ void QDeclarativeGeoMap::removeMapItemGroup(QDeclarativeGeoMapItemGroup *itemGro
 
 bool QDeclarativeGeoMap::removeMapItemGroup_real(QDeclarativeGeoMapItemGroup *itemGroup)
 {
-    if (!itemGroup || itemGroup->quickMap() != this) // cant remove an itemGroup added to another map
+    QList<QDeclarativeGeoMapItemBase *> items;
+    QList<QDeclarativeGeoMapItemGroup *> groups;
+    int count = detachMapItemGroup(itemGroup, items, groups);
+    if (count < 0)
         return false;
 
+    count += removeMapItems_real(items);
+    for (QDeclarativeGeoMapItemGroup *group : qAsConst(groups)) {
+        group->setQuickMap(nullptr);
+        if (group->parentItem() == this)
+            group->setParentItem(0);
+    }
+    return count;
+}
+
+/*
+    Undoes attachMapItemGroup(), except for removing the items, which are
+    appended to items, and taking the map from the groups, which are
+    appended to groups.
+*/
+int QDeclarativeGeoMap::detachMapItemGroup(QDeclarativeGeoMapItemGroup *itemGroup,
+                                           QList<QDeclarativeGeoMapItemBase *> &items,
+                                           QList<QDeclarativeGeoMapItemGroup *> &groups)
+{
+    if (!itemGroup || itemGroup->quickMap() != this) // cant remove an itemGroup added to another map
+        return -1;
+
     QPointer<QDeclarativeGeoMapItemGroup> g(itemGroup);
     if (!m_mapItemGroups.removeOne(g))
-        return false;
+        return -1;
+    groups.append(itemGroup);
 
     const QList<QQuickItem *> quickKids = itemGroup->childItems();
     int count = 0;
-    for (auto c: quickKids) {
-        count += removeMapChild(c);
+    for (QQuickItem *c : quickKids) {
+        if (QDeclarativeGeoMapItemView *view = qobject_cast<QDeclarativeGeoMapItemView *>(c))
+            count += removeMapItemView_real(view);
+        else if (QDeclarativeGeoMapItemGroup *group = qobject_cast<QDeclarativeGeoMapItemGroup *>(c))
+            count += qMax(0, detachMapItemGroup(group, items, groups));
+        else if (QDeclarativeGeoMapItemBase *item = qobject_cast<QDeclarativeGeoMapItemBase *>(c))
+            items.append(item);
     }
-    itemGroup->setQuickMap(nullptr);
-    if (itemGroup->parentItem() == this)
-        itemGroup->setParentItem(0);
     return count;
 }
 
@@ -2267,6 +2854,62 @@ QDeclarativeGeoMapType * QDeclarativeGeoMap::activeMapType() const
     return m_activeMapType;
 }
 
+/*!
+    \qmlproperty list<MapType> QtLocation::Map::overlayMapTypes
+
+    This property holds the \l{MapType}{map types} drawn over the
+    \l activeMapType, bottom first, such as a transit or a hillshading layer
+    over a street map. The map types must be of the \l plugin of the map, see
+    \l supportedMapTypes; the others are ignored, as is the active map type.
+
+    The tiles of the overlays are fetched along with the tiles of the active
+    map type, and drawn in the same scene. Overlays are supported by the maps
+    made of tiles only; when the map does not support them, the property has
+    no effect. The default value is an empty list.
+
+    \since 5.15
+*/
+void QDeclarativeGeoMap::setOverlayMapTypes(const QList<QObject *> &mapTypes)
+{
+    QList<QPointer<QDeclarativeGeoMapType> > types;
+    for (QObject *object : mapTypes) {
+        if (QDeclarativeGeoMapType *type = qobject_cast<QDeclarativeGeoMapType *>(object))
+            types.append(type);
+    }
+    if (types == m_overlayMapTypes)
+        return;
+
+    m_overlayMapTypes = types;
+    applyOverlayMapTypes();
+    emit overlayMapTypesChanged();
+}
+
+QList<QObject *> QDeclarativeGeoMap::overlayMapTypes() const
+{
+    QList<QObject *> types;
+    for (const QPointer<QDeclarativeGeoMapType> &type : m_overlayMapTypes) {
+        if (type)
+            types.append(type.data());
+    }
+    return types;
+}
+
+void QDeclarativeGeoMap::applyOverlayMapTypes()
+{
+    if (!m_map || !m_plugin)
+        return;
+
+    QList<QGeoMapType> types;
+    if (m_map->capabilities() & QGeoMap::SupportsOverlayMapTypes) {
+        const QByteArray pluginName = m_plugin->name().toLatin1();
+        for (const QPointer<QDeclarativeGeoMapType> &type : qAsConst(m_overlayMapTypes)) {
+            if (type && type->mapType().pluginName() == pluginName)
+                types.append(type->mapType());
+        }
+    }
+    m_map->setOverlayMapTypes(types);
+}
+
 /*!
     \internal
 */
@@ -2343,8 +2986,9 @@ void QDeclarativeGeoMap::fitViewportToMapItems(const QVariantList &items)
             if (itm)
                 itms.append(itm);
         }
-        fitViewportToMapItemsRefine(itms, true, false);
-    } else {
+        if (!fitViewportToIndexedMapItems(&itms))
+            fitViewportToMapItemsRefine(itms, true, false);
+    } else if (!fitViewportToIndexedMapItems(nullptr)) {
         fitViewportToMapItemsRefine(m_mapItems, true, false);
     }
 }
@@ -2363,6 +3007,55 @@ void QDeclarativeGeoMap::fitViewportToVisibleMapItems()
     fitViewportToMapItemsRefine(m_mapItems, true, true);
 }
 
+/*
+    Fits the viewport to the bounding box of mapItems, or of all the map items
+    if null, as kept by m_mapItemIndex. This does not lay out the items on the
+    screen, and costs a pass over mapItems only, or nothing for all the items.
+    Returns false if the screen bounds have to be used instead: with items
+    sized in pixels, whose bounding box depends on the zoom level, or with a
+    rotated or tilted camera, for which the bounding box is not what is seen.
+*/
+bool QDeclarativeGeoMap::fitViewportToIndexedMapItems(const QList<QPointer<QDeclarativeGeoMapItemBase> > *mapItems)
+{
+    if (!m_map || m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator
+            || m_cameraData.bearing() != 0.0 || m_cameraData.tilt() != 0.0)
+        return false;
+
+    QList<QObject *> objects;
+    if (mapItems) {
+        for (const QPointer<QDeclarativeGeoMapItemBase> &item: *mapItems) {
+            if (!item)
+                continue;
+            if (qobject_cast<QDeclarativeGeoMapQuickItem *>(item.data()))
+                return false;
+            objects.append(item.data());
+        }
+        if (objects.isEmpty())
+            return true;
+    } else if (!m_pixelSizedItems.isEmpty()) {
+        return false;
+    }
+
+    ensureMapItemIndex();
+    const QGeoRectangle box = mapItems ? m_mapItemIndex->boundingGeoRectangle(objects)
+                                       : m_mapItemIndex->boundingGeoRectangle();
+    if (!box.isValid())
+        return true; // nothing to fit
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_map->geoProjection());
+    const QPair<QGeoCoordinate, qreal> fitData = p.fitViewportToGeoRectangle(box, mapMargins());
+    if (!fitData.first.isValid())
+        return false;
+
+    setProperty("center", QVariant::fromValue(fitData.first));
+    if (qIsFinite(fitData.second)) {
+        // the largest integral zoom level, as with the screen bounds
+        const qreal newZoom = std::floor(qMax<qreal>(minimumZoomLevel(), fitData.second));
+        setProperty("zoomLevel", QVariant::fromValue(newZoom));
+    }
+    return true;
+}
+
 /*!
     \internal
 */
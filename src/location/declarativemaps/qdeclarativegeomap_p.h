@@ -56,8 +56,12 @@
 #include <QtLocation/private/qgeocameradata_p.h>
 #include <QtLocation/private/qgeocameracapabilities_p.h>
 #include <QtQuick/QQuickItem>
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSet>
+#include <QtCore/QVariantMap>
 #include <QtGui/QColor>
 #include <QtPositioning/qgeorectangle.h>
 #include <QtLocation/private/qgeomap_p.h>
@@ -69,6 +73,8 @@ class QDeclarativeGeoServiceProvider;
 class QDeclarativeGeoMapType;
 class QDeclarativeGeoMapCopyrightNotice;
 class QDeclarativeGeoMapParameter;
+class QGeoMapItemBatchLayer;
+class QGeoMapSpatialIndex;
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMap : public QQuickItem
 {
@@ -92,6 +98,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMap : public QQuickItem
 
     Q_PROPERTY(QDeclarativeGeoMapType *activeMapType READ activeMapType WRITE setActiveMapType NOTIFY activeMapTypeChanged)
     Q_PROPERTY(QQmlListProperty<QDeclarativeGeoMapType> supportedMapTypes READ supportedMapTypes NOTIFY supportedMapTypesChanged)
+    Q_PROPERTY(QList<QObject *> overlayMapTypes READ overlayMapTypes WRITE setOverlayMapTypes NOTIFY overlayMapTypesChanged REVISION 15)
     Q_PROPERTY(QGeoCoordinate center READ center WRITE setCenter NOTIFY centerChanged)
     Q_PROPERTY(QList<QObject *> mapItems READ mapItems NOTIFY mapItemsChanged)
     Q_PROPERTY(QList<QObject *> mapParameters READ mapParameters)
@@ -102,6 +109,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMap : public QQuickItem
     Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
     Q_PROPERTY(bool mapReady READ mapReady NOTIFY mapReadyChanged)
     Q_PROPERTY(QRectF visibleArea READ visibleArea WRITE setVisibleArea NOTIFY visibleAreaChanged  REVISION 12)
+    Q_PROPERTY(bool statisticsEnabled READ statisticsEnabled WRITE setStatisticsEnabled NOTIFY statisticsEnabledChanged REVISION 15)
     Q_INTERFACES(QQmlParserStatus)
 
 public:
@@ -115,6 +123,9 @@ public:
     void setActiveMapType(QDeclarativeGeoMapType *mapType);
     QDeclarativeGeoMapType *activeMapType() const;
 
+    void setOverlayMapTypes(const QList<QObject *> &mapTypes);
+    QList<QObject *> overlayMapTypes() const;
+
     void setMinimumZoomLevel(qreal minimumZoomLevel, bool userSet = true);
     qreal minimumZoomLevel() const;
     qreal implicitMinimumZoomLevel() const;
@@ -177,6 +188,9 @@ public:
     Q_INVOKABLE void clearMapItems();
     QList<QObject *> mapItems();
 
+    Q_REVISION(15) Q_INVOKABLE void addMapItems(const QList<QObject *> &items);
+    Q_REVISION(15) Q_INVOKABLE void removeMapItems(const QList<QObject *> &items);
+
     Q_INVOKABLE void addMapParameter(QDeclarativeGeoMapParameter *parameter);
     Q_INVOKABLE void removeMapParameter(QDeclarativeGeoMapParameter *parameter);
     Q_INVOKABLE void clearMapParameters();
@@ -187,11 +201,21 @@ public:
     void clearMapObjects();
     QList<QGeoMapObject *> mapObjects();
 
+    Q_REVISION(15) Q_INVOKABLE QList<QObject *> mapItemsInShape(const QGeoShape &shape);
+    Q_REVISION(15) Q_INVOKABLE QList<QObject *> mapItemsInRect(const QRectF &rect);
+
+    bool statisticsEnabled() const;
+    void setStatisticsEnabled(bool enabled);
+    Q_REVISION(15) Q_INVOKABLE QVariantMap statistics() const;
+    Q_REVISION(15) Q_INVOKABLE void resetStatistics();
+    Q_REVISION(15) Q_INVOKABLE QVariantMap memoryReport() const;
 
     Q_INVOKABLE QGeoCoordinate toCoordinate(const QPointF &position, bool clipToViewPort = true) const;
     Q_INVOKABLE QPointF fromCoordinate(const QGeoCoordinate &coordinate, bool clipToViewPort = true) const;
 
     QQuickGeoMapGestureArea *gesture();
+    QGeoMapItemBatchLayer *itemBatchLayer() const;
+    void prepareItemGeometries(QDeclarativeGeoMapItemBase *polishing);
 
     Q_INVOKABLE void fitViewportToMapItems(const QVariantList &items = {});
     Q_INVOKABLE void fitViewportToVisibleMapItems();
@@ -234,6 +258,8 @@ Q_SIGNALS:
     Q_REVISION(11) void mapObjectsChanged();
     void visibleAreaChanged();
     Q_REVISION(14) void visibleRegionChanged();
+    Q_REVISION(15) void statisticsEnabledChanged();
+    Q_REVISION(15) void overlayMapTypesChanged();
 
 protected:
     void mousePressEvent(QMouseEvent *event) override ;
@@ -263,8 +289,15 @@ protected:
 
     bool addMapItem_real(QDeclarativeGeoMapItemBase *item);
     bool removeMapItem_real(QDeclarativeGeoMapItemBase *item);
+    int addMapItems_real(const QList<QDeclarativeGeoMapItemBase *> &items);
+    int removeMapItems_real(const QList<QDeclarativeGeoMapItemBase *> &items);
     bool addMapItemGroup_real(QDeclarativeGeoMapItemGroup *itemGroup);
     bool removeMapItemGroup_real(QDeclarativeGeoMapItemGroup *itemGroup);
+    int attachMapItemGroup(QDeclarativeGeoMapItemGroup *itemGroup,
+                           QList<QDeclarativeGeoMapItemBase *> &items);
+    int detachMapItemGroup(QDeclarativeGeoMapItemGroup *itemGroup,
+                           QList<QDeclarativeGeoMapItemBase *> &items,
+                           QList<QDeclarativeGeoMapItemGroup *> &groups);
     bool addMapItemView_real(QDeclarativeGeoMapItemView *itemView);
     bool removeMapItemView_real(QDeclarativeGeoMapItemView *itemView);
     void updateItemToWindowTransform();
@@ -277,28 +310,46 @@ private Q_SLOTS:
     void onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities);
     void onAttachedCopyrightNoticeVisibilityChanged();
     void onCameraDataChanged(const QGeoCameraData &cameraData);
+    void onMapItemGeometryChanged();
 
 private:
     void setupMapView(QDeclarativeGeoMapItemView *view);
     void populateMap();
     void populateParameters();
+    void applyOverlayMapTypes();
     void fitViewportToMapItemsRefine(const QList<QPointer<QDeclarativeGeoMapItemBase> > &mapItems, bool refine, bool onlyVisible);
+    bool fitViewportToIndexedMapItems(const QList<QPointer<QDeclarativeGeoMapItemBase> > *mapItems);
     bool isInteractive();
     void attachCopyrightNotice(bool initialVisibility);
     void detachCopyrightNotice(bool currentVisibility);
     QMargins mapMargins() const;
+    void indexMapItem(QDeclarativeGeoMapItemBase *item);
+    int mapItemSlot(QDeclarativeGeoMapItemBase *item) const;
+    void ensureMapItemIndex();
+    QGeoRectangle viewportUpdateRegion() const;
+    void notifyMapItemsOfViewport(bool cameraChanged);
+    bool attachMapItem(QDeclarativeGeoMapItemBase *item);
+    void detachMapItem(QDeclarativeGeoMapItemBase *item);
 
 private:
     QDeclarativeGeoServiceProvider *m_plugin;
     QGeoMappingManager *m_mappingManager;
     QDeclarativeGeoMapType *m_activeMapType;
     QList<QDeclarativeGeoMapType *> m_supportedMapTypes;
+    QList<QPointer<QDeclarativeGeoMapType> > m_overlayMapTypes;
     QList<QDeclarativeGeoMapItemView *> m_mapViews;
     QQuickGeoMapGestureArea *m_gestureArea;
     QPointer<QGeoMap> m_map;
     QPointer<QDeclarativeGeoMapCopyrightNotice> m_copyrights;
+    QPointer<QGeoMapItemBatchLayer> m_itemBatchLayer;
     QList<QPointer<QDeclarativeGeoMapItemBase> > m_mapItems;
+    QHash<QDeclarativeGeoMapItemBase *, int> m_mapItemSlots; // in m_mapItems
+    // Items following the viewport, when the others are left out of its updates
+    QSet<QDeclarativeGeoMapItemBase *> m_viewportItems;
+    QSet<QDeclarativeGeoMapItemBase *> m_pixelSizedItems; // always in the viewport updates
+    bool m_viewportCulling = false;
     QList<QPointer<QDeclarativeGeoMapItemGroup> > m_mapItemGroups;
+    QScopedPointer<QGeoMapSpatialIndex> m_mapItemIndex; // over m_mapItems, built by the first spatial query
     QString m_errorString;
     QGeoServiceProvider::Error m_error;
     QGeoRectangle m_visibleRegion;
@@ -311,6 +362,8 @@ private:
     double m_minimumViewportLatitude = 0.0;
     bool m_initialized;
     bool m_sgNodeHasChanged = false;
+    bool m_itemGeometriesPrepared = false; // until the current polish pass is over
+    bool m_statisticsEnabled = false;
     QList<QDeclarativeGeoMapParameter *> m_mapParameters;
     QList<QGeoMapObject*> m_pendingMapObjects; // Used only in the initialization phase
     QGeoCameraCapabilities m_cameraCapabilities;
@@ -133,6 +133,8 @@ void QDeclarativeGeoMapCopyrightNotice::setMapSource(QDeclarativeGeoMap *map)
         m_mapSource->m_map->disconnect(this);
         if (m_copyrightsHtml)
             m_copyrightsHtml->clear();
+        m_sourceHtml.clear();
+        m_documentPending = false;
         m_copyrightsImage = QImage();
         m_mapSource = nullptr;
     }
@@ -309,6 +311,10 @@ void QDeclarativeGeoMapCopyrightNotice::setCopyrightsZ(qreal copyrightsZ)
 void QDeclarativeGeoMapCopyrightNotice::copyrightsChanged(const QImage &copyrightsImage)
 {
     Q_D(QDeclarativeGeoMapCopyrightNotice);
+    m_sourceHtml.clear();
+    m_documentPending = false;
+    if (!m_copyrightsHtml && copyrightsImage.cacheKey() == m_copyrightsImage.cacheKey())
+        return;
     delete m_copyrightsHtml;
     m_copyrightsHtml = 0;
 
@@ -333,6 +339,12 @@ void QDeclarativeGeoMapCopyrightNotice::copyrightsChanged(const QString &copyrig
         d->QQuickItemPrivate::setVisible(m_copyrightsVisible);
     }
 
+    // The maps give the copyrights again for every change of the visible
+    // tiles, mostly the same ones.
+    if (copyrightsHtml == m_sourceHtml && (m_copyrightsHtml || m_documentPending))
+        return;
+    m_sourceHtml = copyrightsHtml;
+
     // Divfy, so we can style the background. The extra <span> is a
     // workaround to QTBUG-58838 and should be removed when it gets fixed.
 #if QT_CONFIG(texthtmlparser)
@@ -340,7 +352,28 @@ void QDeclarativeGeoMapCopyrightNotice::copyrightsChanged(const QString &copyrig
 #else
     m_html = copyrightsHtml;
 #endif
+    scheduleDocumentUpdate();
+}
+
+/*
+    Lays out and draws the copyrights once control returns to the event
+    loop, so that it is not part of the camera change that found them, and
+    happens once for all the changes until then.
+*/
+void QDeclarativeGeoMapCopyrightNotice::scheduleDocumentUpdate()
+{
+    if (m_documentPending)
+        return;
+    m_documentPending = true;
+    QMetaObject::invokeMethod(this, &QDeclarativeGeoMapCopyrightNotice::updateDocument,
+                              Qt::QueuedConnection);
+}
 
+void QDeclarativeGeoMapCopyrightNotice::updateDocument()
+{
+    if (!m_documentPending)
+        return; // superseded by an image
+    m_documentPending = false;
     if (!m_copyrightsHtml)
         createCopyright();
 
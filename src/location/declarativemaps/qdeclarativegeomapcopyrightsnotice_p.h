@@ -103,9 +103,13 @@ protected:
 
 private:
     void createCopyright();
+    void scheduleDocumentUpdate();
+    void updateDocument();
 
     QTextDocument *m_copyrightsHtml;
+    QString m_sourceHtml; // as given by the map
     QString m_html;
+    bool m_documentPending = false;
     QImage m_copyrightsImage;
     QString m_activeAnchor;
     bool m_copyrightsVisible;
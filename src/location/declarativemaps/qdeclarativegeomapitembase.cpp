@@ -37,8 +37,12 @@
 #include "qdeclarativegeomapitembase_p.h"
 #include "qgeocameradata_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
+#include <QtLocation/private/qgeomapitembatchlayer_p.h>
+#include <QtLocation/private/qdeclarativegeomapitemgroup_p.h>
 #include <QtQml/QQmlInfo>
 #include <QtQuick/QSGOpacityNode>
+#include <QtQuick/QQuickWindow>
 #include <QtQuick/private/qquickmousearea_p.h>
 #include <QtQuick/private/qquickitem_p.h>
 
@@ -92,6 +96,8 @@ QDeclarativeGeoMapItemBase::~QDeclarativeGeoMapItemBase()
     disconnect(this, SLOT(afterChildrenChanged()));
     if (quickMap_)
         quickMap_->removeMapItem(this);
+    if (parentGroup_)
+        parentGroup_->m_mapItems.remove(this);
 }
 
 /*!
@@ -126,6 +132,8 @@ void QDeclarativeGeoMapItemBase::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *m
         return;
     if (quickMap && quickMap_)
         return; // don't allow association to more than one map
+    if (quickMap_ && quickMap_->itemBatchLayer())
+        quickMap_->itemBatchLayer()->removeItem(this);
 
     quickMap_ = quickMap;
     map_ = map;
@@ -299,6 +307,7 @@ QSGNode *QDeclarativeGeoMapItemBase::updatePaintNode(QSGNode *oldNode, UpdatePai
     QSGNode *oldN = opn->childCount() ? opn->firstChild() : 0;
     opn->removeAllChildNodes();
     if (opn->opacity() > 0.0) {
+        QGeoMapStatisticsTimer timer(QGeoMapStatistics::ItemPaintNode);
         QSGNode *n = this->updateMapItemPaintNode(oldN, pd);
         if (n)
             opn->appendChildNode(n);
@@ -338,11 +347,13 @@ qreal QDeclarativeGeoMapItemBase::mapItemOpacity() const
 
 void QDeclarativeGeoMapItemBase::setParentGroup(QDeclarativeGeoMapItemGroup &parentGroup)
 {
+    if (parentGroup_ == &parentGroup)
+        return;
+    if (parentGroup_)
+        parentGroup_->m_mapItems.remove(this);
+    // the group emits mapItemOpacityChanged() of its items itself
     parentGroup_ = &parentGroup;
-    if (parentGroup_) {
-        connect(parentGroup_, &QDeclarativeGeoMapItemGroup::mapItemOpacityChanged,
-                this, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged);
-    }
+    parentGroup_->m_mapItems.insert(this);
 }
 
 bool QDeclarativeGeoMapItemBase::isPolishScheduled() const
@@ -350,6 +361,26 @@ bool QDeclarativeGeoMapItemBase::isPolishScheduled() const
     return QQuickItemPrivate::get(this)->polishScheduled;
 }
 
+/*!
+    \internal
+    Returns whether the map asks for the OpenGL item backends while the item
+    still uses the default one. This only holds with the default OpenGL
+    scene graph backend, which the OpenGL item backends require.
+*/
+bool QDeclarativeGeoMapItemBase::mapPrefersOpenGLItems() const
+{
+    if (!map_ || !(map_->capabilities() & QGeoMap::PrefersOpenGLMapItems))
+        return false;
+    return QQuickWindow::sceneGraphBackend().isEmpty();
+}
+
+bool QDeclarativeGeoMapItemBase::hasPendingGeometry() const
+{
+    return false;
+}
+
+void QDeclarativeGeoMapItemBase::prepareGeometry() {}
+
 void QDeclarativeGeoMapItemBase::setMaterialDirty() {}
 
 void QDeclarativeGeoMapItemBase::polishAndUpdate()
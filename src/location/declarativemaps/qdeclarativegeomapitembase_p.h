@@ -146,6 +146,11 @@ protected:
     float zoomLevelOpacity() const;
     bool childMouseEventFilter(QQuickItem *item, QEvent *event);
     bool isPolishScheduled() const;
+    bool mapPrefersOpenGLItems() const;
+    // Geometry work ahead of updatePolish() that may run on a worker thread,
+    // see QDeclarativeGeoMap::prepareItemGeometries()
+    virtual bool hasPendingGeometry() const;
+    virtual void prepareGeometry();
     virtual void setMaterialDirty();
 
     QGeoMap::ItemType m_itemType = QGeoMap::NoItem;
@@ -168,8 +173,10 @@ private:
     int m_lodThreshold = 0;
 
     friend class QDeclarativeGeoMap;
+    friend class QDeclarativeGeoMapItemGroup;
     friend class QDeclarativeGeoMapItemView;
     friend class QDeclarativeGeoMapItemTransitionManager;
+    friend class QGeoMapItemBatchLayer;
 };
 
 QT_END_NAMESPACE
@@ -141,19 +141,41 @@ QDeclarativeGeoMapItemGroup::QDeclarativeGeoMapItemGroup(QQuickItem *parent)
 :   QQuickItem(parent), m_quickMap(nullptr)
 {
     connect(this, &QQuickItem::opacityChanged,
-            this, &QDeclarativeGeoMapItemGroup::mapItemOpacityChanged);
+            this, &QDeclarativeGeoMapItemGroup::propagateMapItemOpacity);
 }
 
 QDeclarativeGeoMapItemGroup::~QDeclarativeGeoMapItemGroup()
 {
-
+    // the children are destroyed after this
+    for (QDeclarativeGeoMapItemBase *item : qAsConst(m_mapItems))
+        item->parentGroup_ = nullptr;
+    for (QDeclarativeGeoMapItemGroup *group : qAsConst(m_childGroups))
+        group->m_parentGroup = nullptr;
+    if (m_parentGroup)
+        m_parentGroup->m_childGroups.remove(this);
 }
 
 void QDeclarativeGeoMapItemGroup::setParentGroup(QDeclarativeGeoMapItemGroup &parentGroup)
 {
+    if (m_parentGroup == &parentGroup)
+        return;
+    if (m_parentGroup)
+        m_parentGroup->m_childGroups.remove(this);
     m_parentGroup = &parentGroup;
-    connect(m_parentGroup, &QDeclarativeGeoMapItemGroup::mapItemOpacityChanged,
-            this, &QDeclarativeGeoMapItemGroup::mapItemOpacityChanged);
+    m_parentGroup->m_childGroups.insert(this);
+}
+
+/*
+    Notifies the children of a change of mapItemOpacity(), down the nested
+    groups, in place of a connection from each child to its group.
+*/
+void QDeclarativeGeoMapItemGroup::propagateMapItemOpacity()
+{
+    emit mapItemOpacityChanged();
+    for (QDeclarativeGeoMapItemBase *item : qAsConst(m_mapItems))
+        emit item->mapItemOpacityChanged();
+    for (QDeclarativeGeoMapItemGroup *group : qAsConst(m_childGroups))
+        group->propagateMapItemOpacity();
 }
 
 void QDeclarativeGeoMapItemGroup::setQuickMap(QDeclarativeGeoMap *quickMap)
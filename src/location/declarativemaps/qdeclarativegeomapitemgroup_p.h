@@ -51,10 +51,12 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativegeomapitemtransitionmanager_p.h>
 #include <QtQuick/QQuickItem>
+#include <QtCore/QSet>
 
 QT_BEGIN_NAMESPACE
 
 class QDeclarativeGeoMap;
+class QDeclarativeGeoMapItemBase;
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemGroup : public QQuickItem
 {
     Q_OBJECT
@@ -82,10 +84,17 @@ protected slots:
     void onMapSizeChanged();
 
 private:
+    void propagateMapItemOpacity();
+
     QDeclarativeGeoMap *m_quickMap;
     QDeclarativeGeoMapItemGroup *m_parentGroup = nullptr;
     QScopedPointer<QDeclarativeGeoMapItemTransitionManager> m_transitionManager;
+    // the children having this group as parent group, told of opacity changes
+    // without a connection each, and removed in constant time
+    QSet<QDeclarativeGeoMapItemBase *> m_mapItems;
+    QSet<QDeclarativeGeoMapItemGroup *> m_childGroups;
 
+    friend class QDeclarativeGeoMapItemBase;
     friend class QDeclarativeGeoMapItemView;
     friend class QDeclarativeGeoMapItemTransitionManager;
 };
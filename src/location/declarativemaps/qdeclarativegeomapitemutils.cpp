@@ -47,9 +47,21 @@
 #include <QtGui/private/qtriangulatingstroker_p.h>
 #include <QtGui/private/qtriangulator_p.h>
 #include <QtPositioning/private/qclipperutils_p.h>
+#include <QtCore/QThreadStorage>
 
 QT_BEGIN_NAMESPACE
 
+static QThreadStorage<c2t::clip2tri *> clippers;
+
+c2t::clip2tri &QDeclarativeGeoMapItemUtils::threadClipper()
+{
+    if (!clippers.hasLocalData())
+        clippers.setLocalData(new c2t::clip2tri);
+    c2t::clip2tri &clipper = *clippers.localData();
+    clipper.clearClipper();
+    return clipper;
+}
+
 void QDeclarativeGeoMapItemUtils::wrapPath(const QList<QGeoCoordinate> &perimeter,
                                            const QGeoCoordinate &geoLeftBound,
                                            const QGeoProjectionWebMercator &p,
@@ -58,9 +70,7 @@ void QDeclarativeGeoMapItemUtils::wrapPath(const QList<QGeoCoordinate> &perimete
                                            QList<QDoubleVector2D> &wrappedPathPlus1,
                                            QDoubleVector2D *leftBoundWrapped)
 {
-    QList<QDoubleVector2D> path;
-    for (const QGeoCoordinate &c : perimeter)
-        path << p.geoToMapProjection(c);
+    const QList<QDoubleVector2D> path = p.geoToMapProjection(perimeter);
     const QDoubleVector2D leftBound = p.geoToMapProjection(geoLeftBound);
     wrappedPath.clear();
     wrappedPathPlus1.clear();
@@ -96,9 +106,16 @@ void QDeclarativeGeoMapItemUtils::wrapPath(const QList<QGeoCoordinate> &perimete
                                            QList<QDoubleVector2D> &wrappedPath,
                                            QDoubleVector2D *leftBoundWrapped)
 {
-    QList<QDoubleVector2D> path;
-    for (const QGeoCoordinate &c : perimeter)
-        path << p.geoToMapProjection(c);
+    wrapPath(qPackCoordinates(perimeter), geoLeftBound, p, wrappedPath, leftBoundWrapped);
+}
+
+void QDeclarativeGeoMapItemUtils::wrapPath(QGeoCoordinateSpan perimeter,
+                                           const QGeoCoordinate &geoLeftBound,
+                                           const QGeoProjectionWebMercator &p,
+                                           QList<QDoubleVector2D> &wrappedPath,
+                                           QDoubleVector2D *leftBoundWrapped)
+{
+    const QList<QDoubleVector2D> path = p.geoToMapProjection(perimeter);
     const QDoubleVector2D leftBound = p.geoToMapProjection(geoLeftBound);
     wrapPath(path, leftBound,wrappedPath);
     if (leftBoundWrapped)
@@ -134,7 +151,7 @@ void QDeclarativeGeoMapItemUtils::clipPolygon(const QList<QDoubleVector2D> &wrap
     clippedPaths.clear();
     const QList<QDoubleVector2D> &visibleRegion = p.projectableGeometry();
     if (visibleRegion.size()) {
-        c2t::clip2tri clipper;
+        c2t::clip2tri &clipper = threadClipper();
         clipper.addSubjectPath(QClipperUtils::qListToPath(wrappedPath), closed);
         clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
         Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
@@ -164,17 +181,39 @@ void QDeclarativeGeoMapItemUtils::clipPolygon(const QList<QDoubleVector2D> &wrap
     }
 }
 
+// Item positions of the points of wrappedPath, as consecutive x and y pairs
+void QDeclarativeGeoMapItemUtils::projectPath(const QList<QDoubleVector2D> &wrappedPath, const QGeoProjectionWebMercator &p, QVector<double> &itemPositions)
+{
+    itemPositions.resize(2 * wrappedPath.size());
+    double *positions = itemPositions.data();
+    for (const QDoubleVector2D &point : wrappedPath) {
+        *positions++ = point.x();
+        *positions++ = point.y();
+    }
+    p.wrappedMapProjectionToItemPosition(itemPositions.constData(), itemPositions.data(), wrappedPath.size());
+}
+
 void QDeclarativeGeoMapItemUtils::projectBbox(const QList<QDoubleVector2D> &clippedBbox, const QGeoProjectionWebMercator &p, QPainterPath &projectedBbox)
 {
     projectedBbox = QPainterPath(); // clear() is added in 5.13..
+    QVector<double> positions;
+    projectPath(clippedBbox, p, positions);
     for (int i = 0; i < clippedBbox.size(); ++i) {
-        QDoubleVector2D point = p.wrappedMapProjectionToItemPosition(clippedBbox.at(i));
+        const QPointF point(positions.at(2 * i), positions.at(2 * i + 1));
         if (i == 0)
-            projectedBbox.moveTo(point.toPointF());
+            projectedBbox.moveTo(point);
         else
-            projectedBbox.lineTo(point.toPointF());
+            projectedBbox.lineTo(point);
     }
     projectedBbox.closeSubpath();
 }
 
+QList<QDoubleVector2D> QDeclarativeGeoMapItemUtils::rectanglePath(const QRectF &rect)
+{
+    return QList<QDoubleVector2D>() << QDoubleVector2D(rect.topLeft())
+                                    << QDoubleVector2D(rect.topRight())
+                                    << QDoubleVector2D(rect.bottomRight())
+                                    << QDoubleVector2D(rect.bottomLeft());
+}
+
 QT_END_NAMESPACE
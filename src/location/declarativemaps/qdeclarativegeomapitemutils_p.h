@@ -52,7 +52,12 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeoprojection_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QRectF>
+#include <QtCore/QVector>
 
+namespace c2t {
+class clip2tri;
+}
 
 QT_BEGIN_NAMESPACE
 
@@ -100,6 +105,13 @@ public:
                          ,QList<QDoubleVector2D> &wrappedPath
                          ,QDoubleVector2D *leftBoundWrapped = nullptr);
 
+    // The same, for the packed vertices of a QGeoPath or QGeoPolygon
+    static void wrapPath(QGeoCoordinateSpan perimeter
+                         ,const QGeoCoordinate &geoLeftBound
+                         ,const QGeoProjectionWebMercator &p
+                         ,QList<QDoubleVector2D> &wrappedPath
+                         ,QDoubleVector2D *leftBoundWrapped = nullptr);
+
     static void wrapPath(const QList<QDoubleVector2D> &path
                          , const QDoubleVector2D &geoLeftBound
                          , QList<QDoubleVector2D> &wrappedPath);
@@ -111,10 +123,19 @@ public:
                             ,QDoubleVector2D *leftBoundWrapped = nullptr
             ,const bool closed = true);
 
+    static void projectPath(const QList<QDoubleVector2D> &wrappedPath
+                            ,const QGeoProjectionWebMercator &p
+                            ,QVector<double> &itemPositions);
+
     static void projectBbox(const QList<QDoubleVector2D> &clippedBbox
                             ,const QGeoProjectionWebMercator &p
                             ,QPainterPath &projectedBbox);
 
+    // The corners of a rectangle in mercator space, clockwise from the top left
+    static QList<QDoubleVector2D> rectanglePath(const QRectF &rect);
+
+    // A cleared clipper owned by the calling thread, reused to keep its allocations
+    static c2t::clip2tri &threadClipper();
 };
 
 QT_END_NAMESPACE
@@ -39,15 +39,72 @@
 #include "qdeclarativegeomapitemview_p.h"
 #include "qdeclarativegeomap_p.h"
 #include "qdeclarativegeomapitembase_p.h"
+#include "qgeomapframebudget_p.h"
 
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QSet>
 #include <QtQml/QQmlContext>
+#include <QtQml/QQmlInfo>
 #include <QtQml/private/qqmlopenmetaobject_p.h>
 #include <QtQuick/private/qquickanimation_p.h>
+#include <private/qqmltableinstancemodel_p.h>
 #include <QtQml/QQmlListProperty>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoShape>
+#include <QtPositioning/private/qwebmercator_p.h>
+
+#include <cmath>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+// Cells per side of the grid indexing the row positions, spanning the whole mercator square.
+constexpr int cullingGridSize = 256;
+
+QGeoCoordinate cullingCoordinate(const QVariant &value)
+{
+    if (value.userType() == qMetaTypeId<QGeoCoordinate>())
+        return value.value<QGeoCoordinate>();
+    if (value.canConvert<QGeoShape>())
+        return value.value<QGeoShape>().center();
+    if (const QObject *object = value.value<QObject *>()) {
+        const QVariant coordinate = object->property("coordinate");
+        if (coordinate.userType() == qMetaTypeId<QGeoCoordinate>())
+            return coordinate.value<QGeoCoordinate>();
+    }
+    return QGeoCoordinate();
+}
+
+// How many reloads or culling updates pooled delegates survive without being reused
+constexpr int reusePoolTime = 2;
+
+QDeclarativeGeoMap *delegateMap(QQuickItem *o)
+{
+    if (QDeclarativeGeoMapItemBase *item = qobject_cast<QDeclarativeGeoMapItemBase *>(o))
+        return item->quickMap();
+    if (QDeclarativeGeoMapItemGroup *group = qobject_cast<QDeclarativeGeoMapItemGroup *>(o))
+        return group->quickMap();
+    return nullptr;
+}
+
+int cullingCell(const QDoubleVector2D &position)
+{
+    const int x = qBound(0, int(position.x() * cullingGridSize), cullingGridSize - 1);
+    const int y = qBound(0, int(position.y() * cullingGridSize), cullingGridSize - 1);
+    return y * cullingGridSize + x;
+}
+
+// region is in mercator, its right edge may exceed 1.0 when it crosses the dateline
+bool cullingRegionContains(const QRectF &region, const QDoubleVector2D &position)
+{
+    if (position.y() < region.top() || position.y() > region.bottom())
+        return false;
+    double dx = position.x() - region.left();
+    dx -= std::floor(dx);
+    return dx <= region.width();
+}
+}
+
 /*!
     \qmltype MapItemView
     \instantiates QDeclarativeGeoMapItemView
@@ -91,6 +148,82 @@ QT_BEGIN_NAMESPACE
     \since QtLocation 5.12
 */
 
+/*!
+    \qmlproperty string QtLocation::MapItemView::cullingRole
+
+    This property holds the name of the model role that positions each row on the map.
+    When set, delegates are only created for the rows positioned within the visible region
+    of the map, extended by \l cullingMargin, and released when the rows leave it.
+    The role may hold a \l coordinate, a \l geoshape, of which the center is used, or an
+    object with a \c coordinate property. Rows without a valid position are always
+    instantiated. Culling requires a QAbstractItemModel based model.
+
+    With culling, \l autoFitViewport only considers the delegates currently instantiated.
+
+    Defaults to an empty string, which instantiates a delegate for every row.
+
+    \since QtLocation 5.15
+*/
+
+/*!
+    \qmlproperty real QtLocation::MapItemView::cullingMargin
+
+    This property holds how far beyond the visible region rows keep their delegate when
+    \l cullingRole is set, as a fraction of the size of the visible region on each side.
+    A larger margin creates delegates ahead of panning, at the cost of keeping more of them.
+
+    Defaults to 0.5.
+
+    \since QtLocation 5.15
+*/
+
+/*!
+    \qmlproperty bool QtLocation::MapItemView::reuseItems
+
+    This property holds whether delegates are reused. When true, the delegates of removed
+    or culled rows are kept in a pool, and rebound to the rows that need one, instead of
+    being destroyed and created again. After a model change, the delegates of the rows
+    still present keep their place on the map. Reusing requires a QAbstractItemModel based
+    model, and the \l add and \l remove transitions are not run for reused delegates.
+
+    As with TableView, a delegate should not keep state that depends on its row other than
+    through bindings to the model data, as it may be reassigned at any time.
+
+    Defaults to false.
+
+    \since QtLocation 5.15
+*/
+
+/*!
+    \qmlproperty string QtLocation::MapItemView::identityRole
+
+    This property holds the name of a model role that identifies the rows across model
+    changes, for example the id of the vehicle a row represents. When \l reuseItems is
+    true, rows that keep their identity across a model reset, or a reordering, get the
+    delegate they had before.
+
+    Defaults to an empty string.
+
+    \since QtLocation 5.15
+*/
+
+/*!
+    \qmlproperty int QtLocation::MapItemView::incubationBudget
+
+    This property holds how many milliseconds of each frame the view spends at most
+    creating delegates. When set, the delegates of a large model, or of the rows coming
+    into view, are created over several frames instead of in one go, so that the map keeps
+    rendering meanwhile. With \l cullingRole set, the rows positioned within the visible
+    region are created first, then the ones within the \l cullingMargin.
+
+    With \l incubateDelegates, the budget covers starting the incubation of the delegates,
+    which then complete as the QML engine incubates them.
+
+    Defaults to 0, which creates all the delegates at once.
+
+    \since QtLocation 5.15
+*/
+
 QDeclarativeGeoMapItemView::QDeclarativeGeoMapItemView(QQuickItem *parent)
     : QDeclarativeGeoMapItemGroup(parent), m_componentCompleted(false), m_delegate(0),
       m_map(0), m_fitViewport(false), m_delegateModel(0)
@@ -102,6 +235,10 @@ QDeclarativeGeoMapItemView::QDeclarativeGeoMapItemView(QQuickItem *parent)
         ani->setTo(0.0);
         ani->setDuration(300.0);
         anims.append(&anims, ani);
+
+        m_frameBudget = new QGeoMapFrameBudget([this](const QDeadlineTimer &deadline) {
+            return createDelegates(deadline);
+        }, this);
 }
 
 QDeclarativeGeoMapItemView::~QDeclarativeGeoMapItemView()
@@ -117,13 +254,15 @@ void QDeclarativeGeoMapItemView::componentComplete()
 {
     QDeclarativeGeoMapItemGroup::componentComplete();
     m_componentCompleted = true;
-    if (!m_itemModel.isNull())
+    if (!m_itemModel.isNull() && !(m_reuseItems && sourceModel()))
         m_delegateModel->setModel(m_itemModel);
 
     if (m_delegate)
         m_delegateModel->setDelegate(m_delegate);
 
     m_delegateModel->componentComplete();
+    if (m_reuseItems)
+        updateReuseModel();
 }
 
 void QDeclarativeGeoMapItemView::classBegin()
@@ -166,21 +305,36 @@ void QDeclarativeGeoMapItemView::createdItem(int index, QObject * /*object*/)
         return;
     }
 
-    QQuickItem *item = qobject_cast<QQuickItem *>(m_delegateModel->object(index, m_incubationMode));
+    QQuickItem *item = qobject_cast<QQuickItem *>(instanceModel()->object(index, m_incubationMode));
     if (item)
         addDelegateToMap(item, index, true);
     else
         qWarning() << "QQmlDelegateModel:: object called in createdItem for " << index << " produced a null item";
+
+    // The row may have been culled while its delegate was incubating
+    if (isCulling())
+        scheduleCullingUpdate();
 }
 
 void QDeclarativeGeoMapItemView::modelUpdated(const QQmlChangeSet &changeSet, bool reset)
 {
     if (!m_map) // everything will be done in instantiateAllItems. Removal is done by declarativegeomap.
         return;
+    if (m_tableModel) // changes come from the source model directly, see reloadItems
+        return;
 
     // move changes are expressed as one remove + one insert, with the same moveId.
     // For simplicity, they will be treated as remove + insert.
     // Changes will be also ignored, as they represent only data changes, not layout changes
+    if (isCulling()) {
+        if (reset || !changeSet.removes().isEmpty() || !changeSet.inserts().isEmpty()) {
+            invalidateCullingIndex();
+        } else {
+            for (const QQmlChangeSet::Change &c: changeSet.changes())
+                updateCullingIndex(c.start(), c.end() - 1);
+        }
+    }
+
     if (reset) { // Assuming this means "remove everything already instantiated"
         removeInstantiatedItems();
     } else {
@@ -197,6 +351,17 @@ void QDeclarativeGeoMapItemView::modelUpdated(const QQmlChangeSet &changeSet, bo
         }
     }
 
+    if (isDeferringDelegates()) {
+        // Placeholders only, the culling update creates the delegates of the visible rows
+        for (const QQmlChangeSet::Change &c: changeSet.inserts()) {
+            for (int idx = c.start(); idx < c.end(); idx++)
+                m_instantiatedItems.insert(idx, nullptr);
+        }
+        scheduleCullingUpdate();
+        fitViewport();
+        return;
+    }
+
     QBoolBlocker createBlocker(m_creatingObject, true);
     for (const QQmlChangeSet::Change &c: changeSet.inserts()) {
         for (int idx = c.start(); idx < c.end(); idx++) {
@@ -225,8 +390,12 @@ void QDeclarativeGeoMapItemView::setModel(const QVariant &model)
         return;
 
     m_itemModel = model;
-    if (m_componentCompleted)
-        m_delegateModel->setModel(m_itemModel);
+    if (m_componentCompleted) {
+        if (m_reuseItems || m_tableModel)
+            updateReuseModel();
+        else
+            m_delegateModel->setModel(m_itemModel);
+    }
 
     emit modelChanged();
 }
@@ -249,8 +418,11 @@ void QDeclarativeGeoMapItemView::setDelegate(QQmlComponent *delegate)
         return;
 
     m_delegate = delegate;
-    if (m_componentCompleted)
+    if (m_componentCompleted) {
         m_delegateModel->setDelegate(m_delegate);
+        if (m_tableModel)
+            updateReuseModel();
+    }
 
     emit delegateChanged();
 }
@@ -298,6 +470,14 @@ void QDeclarativeGeoMapItemView::setMap(QDeclarativeGeoMap *map)
     if (!map || m_map) // changing map on the fly not supported
         return;
     m_map = map;
+    for (const QMetaObject::Connection &connection: m_cullingConnections)
+        disconnect(connection);
+    m_cullingConnections[0] = connect(m_map, &QDeclarativeGeoMap::visibleRegionChanged,
+                                      this, &QDeclarativeGeoMapItemView::scheduleCullingUpdate);
+    m_cullingConnections[1] = connect(m_map, &QQuickItem::widthChanged,
+                                      this, &QDeclarativeGeoMapItemView::scheduleCullingUpdate);
+    m_cullingConnections[2] = connect(m_map, &QQuickItem::heightChanged,
+                                      this, &QDeclarativeGeoMapItemView::scheduleCullingUpdate);
     instantiateAllItems();
 }
 
@@ -326,10 +506,19 @@ void QDeclarativeGeoMapItemView::instantiateAllItems()
     if (!m_componentCompleted || !m_map || !m_delegate || m_itemModel.isNull() || !m_instantiatedItems.isEmpty())
         return;
 
+    if (isDeferringDelegates()) {
+        for (int i = 0; i < rowCount(); i++)
+            m_instantiatedItems.append(nullptr);
+        invalidateCullingIndex();
+        updateCulling();
+        fitViewport();
+        return;
+    }
+
     // If here, m_delegateModel may contain data, but QQmlInstanceModel::object for each row hasn't been called yet.
     QBoolBlocker createBlocker(m_creatingObject, true);
-    for (int i = 0; i < m_delegateModel->count(); i++) {
-        QObject *delegateInstance = m_delegateModel->object(i, m_incubationMode);
+    for (int i = 0; i < rowCount(); i++) {
+        QObject *delegateInstance = instanceModel()->object(i, m_incubationMode);
         addDelegateToMap(qobject_cast<QQuickItem *>(delegateInstance), i);
     }
 
@@ -351,6 +540,483 @@ bool QDeclarativeGeoMapItemView::incubateDelegates() const
     return m_incubationMode == QQmlIncubator::Asynchronous;
 }
 
+QString QDeclarativeGeoMapItemView::cullingRole() const
+{
+    return m_cullingRole;
+}
+
+void QDeclarativeGeoMapItemView::setCullingRole(const QString &role)
+{
+    if (m_cullingRole == role)
+        return;
+    m_cullingRole = role;
+    invalidateCullingIndex();
+    // Also when disabling, to instantiate the rows culled so far
+    scheduleCullingUpdate();
+    emit cullingRoleChanged();
+}
+
+qreal QDeclarativeGeoMapItemView::cullingMargin() const
+{
+    return m_cullingMargin;
+}
+
+void QDeclarativeGeoMapItemView::setCullingMargin(qreal margin)
+{
+    margin = qMax<qreal>(0.0, margin);
+    if (qFuzzyCompare(m_cullingMargin, margin))
+        return;
+    m_cullingMargin = margin;
+    scheduleCullingUpdate();
+    emit cullingMarginChanged();
+}
+
+bool QDeclarativeGeoMapItemView::isCulling() const
+{
+    return !m_cullingRole.isEmpty();
+}
+
+// Whether the rows get placeholders first, their delegates created by updateCulling()
+bool QDeclarativeGeoMapItemView::isDeferringDelegates() const
+{
+    return isCulling() || m_frameBudget->budget() > 0;
+}
+
+int QDeclarativeGeoMapItemView::incubationBudget() const
+{
+    return m_frameBudget->budget();
+}
+
+void QDeclarativeGeoMapItemView::setIncubationBudget(int msecs)
+{
+    msecs = qMax(0, msecs);
+    if (m_frameBudget->budget() == msecs)
+        return;
+    m_frameBudget->setBudget(msecs);
+    // Also when removing the budget, to create the delegates still missing
+    scheduleCullingUpdate();
+    emit incubationBudgetChanged();
+}
+
+void QDeclarativeGeoMapItemView::invalidateCullingIndex()
+{
+    m_cullingIndexValid = false;
+    m_cullingPositions.clear();
+    m_cullingCells.clear();
+    m_cullingGrid.clear();
+}
+
+/*!
+    \internal
+
+    Refreshes the positions of the rows from \a first to \a last, or of all of them if
+    the index had been invalidated.
+*/
+void QDeclarativeGeoMapItemView::updateCullingIndex(int first, int last)
+{
+    QAbstractItemModel *model = sourceModel();
+    if (!m_cullingIndexValid) {
+        if (!model)
+            return;
+        m_cullingRoleId = model->roleNames().key(m_cullingRole.toUtf8(), -1);
+        if (m_cullingRoleId < 0)
+            qmlWarning(this) << "MapItemView: the model has no role named " << m_cullingRole;
+        const int count = model->rowCount();
+        m_cullingPositions.fill(QDoubleVector2D(qQNaN(), qQNaN()), count);
+        m_cullingCells.fill(-1, count);
+        m_cullingIndexValid = true;
+        first = 0;
+        last = count - 1;
+    }
+    if (!model || m_cullingRoleId < 0)
+        return;
+
+    last = qMin(last, m_cullingCells.size() - 1);
+    for (int row = qMax(0, first); row <= last; ++row) {
+        const QGeoCoordinate coordinate = cullingCoordinate(model->index(row, 0).data(m_cullingRoleId));
+        const int oldCell = m_cullingCells.at(row);
+        QDoubleVector2D position(qQNaN(), qQNaN());
+        int cell = -1;
+        if (coordinate.isValid()) {
+            position = QWebMercator::coordToMercator(coordinate);
+            cell = cullingCell(position);
+        }
+        m_cullingPositions[row] = position;
+        if (cell == oldCell)
+            continue;
+        if (oldCell >= 0) {
+            QVector<int> &rows = m_cullingGrid[oldCell];
+            rows.removeOne(row);
+            if (rows.isEmpty())
+                m_cullingGrid.remove(oldCell);
+        }
+        if (cell >= 0)
+            m_cullingGrid[cell].append(row);
+        m_cullingCells[row] = cell;
+    }
+}
+
+void QDeclarativeGeoMapItemView::scheduleCullingUpdate()
+{
+    if (m_cullingUpdatePending || !m_map)
+        return;
+    m_cullingUpdatePending = true;
+    // Coalesces the camera changes of a frame, and the delegates incubated meanwhile
+    QMetaObject::invokeMethod(this, [this]() { updateCulling(); }, Qt::QueuedConnection);
+}
+
+/*!
+    \internal
+
+    Returns, for each row, whether it should have a delegate, with the visible region
+    extended by \a margin. Empty if the culling region is not known yet.
+*/
+QVector<bool> QDeclarativeGeoMapItemView::wantedRows(qreal margin)
+{
+    const int count = m_instantiatedItems.size();
+    QVector<bool> wanted(count, true);
+    if (isCulling()) {
+        if (!m_map->mapReady() || !m_map->width() || !m_map->height())
+            return QVector<bool>();
+        if (!m_cullingIndexValid)
+            updateCullingIndex(0, count - 1);
+
+        if (m_cullingCells.size() == count) {
+            // Rows that aren't positioned are always wanted
+            for (int i = 0; i < count; ++i)
+                wanted[i] = m_cullingCells.at(i) < 0;
+
+            const QGeoRectangle visible = m_map->visibleRegion().boundingGeoRectangle();
+            if (visible.isValid()) {
+                const QDoubleVector2D topLeft = QWebMercator::coordToMercator(visible.topLeft());
+                const QDoubleVector2D bottomRight = QWebMercator::coordToMercator(visible.bottomRight());
+                double width = bottomRight.x() - topLeft.x();
+                if (width < 0 || visible.width() >= 360.0)
+                    width += 1.0;
+                const double height = bottomRight.y() - topLeft.y();
+                const double marginX = width * margin;
+                const double marginY = height * margin;
+                QRectF region(topLeft.x() - marginX, qMax(0.0, topLeft.y() - marginY), width + 2 * marginX, 0);
+                region.setBottom(qMin(1.0, bottomRight.y() + marginY));
+                if (region.width() >= 1.0)
+                    region.setRect(0.0, region.y(), 1.0, region.height());
+                region.moveLeft(region.left() - std::floor(region.left()));
+
+                const int cellLeft = int(std::floor(region.left() * cullingGridSize));
+                const int cellRight = int(std::floor(region.right() * cullingGridSize));
+                const int cellTop = qBound(0, int(region.top() * cullingGridSize), cullingGridSize - 1);
+                const int cellBottom = qBound(0, int(region.bottom() * cullingGridSize), cullingGridSize - 1);
+                const int columns = qMin(cellRight - cellLeft + 1, cullingGridSize);
+                const auto testCell = [&](const QVector<int> &rows) {
+                    for (int row : rows)
+                        wanted[row] = cullingRegionContains(region, m_cullingPositions.at(row));
+                };
+                if (qint64(columns) * (cellBottom - cellTop + 1) > m_cullingGrid.size()) {
+                    for (auto it = m_cullingGrid.cbegin(); it != m_cullingGrid.cend(); ++it)
+                        testCell(it.value());
+                } else {
+                    for (int y = cellTop; y <= cellBottom; ++y) {
+                        for (int x = 0; x < columns; ++x) {
+                            const auto it = m_cullingGrid.constFind(y * cullingGridSize + (cellLeft + x) % cullingGridSize);
+                            if (it != m_cullingGrid.cend())
+                                testCell(it.value());
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return wanted;
+}
+
+/*!
+    \internal
+
+    Releases the delegates of the rows outside of the culling region, and creates those of
+    the rows within it that don't have one, within the incubation budget of each frame.
+    Without culling, creates all the missing ones.
+*/
+void QDeclarativeGeoMapItemView::updateCulling()
+{
+    m_cullingUpdatePending = false;
+    if (!m_componentCompleted || !m_map || !m_delegate || m_itemModel.isNull())
+        return;
+    const int count = m_instantiatedItems.size();
+    if (!count)
+        return;
+    const QVector<bool> wanted = wantedRows(m_cullingMargin);
+    if (wanted.isEmpty())
+        return;
+
+    for (int i = 0; i < count; ++i) {
+        if (!wanted.at(i) && m_instantiatedItems.at(i))
+            cullDelegate(i);
+    }
+    m_frameBudget->schedule(m_map->window());
+}
+
+/*!
+    \internal
+
+    Creates the missing delegates of the rows within the culling region until \a deadline,
+    those of the rows within the visible region first when it is limited. Returns whether
+    some are left.
+*/
+bool QDeclarativeGeoMapItemView::createDelegates(const QDeadlineTimer &deadline)
+{
+    if (!m_componentCompleted || !m_map || !m_delegate || m_itemModel.isNull())
+        return false;
+    const int count = m_instantiatedItems.size();
+    const QVector<bool> wanted = wantedRows(m_cullingMargin);
+    if (wanted.size() != count)
+        return false;
+    const QVector<bool> inView = (isCulling() && !deadline.isForever()) ? wantedRows(0) : QVector<bool>();
+
+    QBoolBlocker createBlocker(m_creatingObject, true);
+    for (int pass = inView.size() == count ? 0 : 1; pass < 2; ++pass) {
+        for (int i = 0; i < count; ++i) {
+            if (!wanted.at(i) || m_instantiatedItems.at(i))
+                continue;
+            if (!inView.isEmpty() && inView.at(i) != (pass == 0))
+                continue;
+            if (deadline.hasExpired())
+                return true;
+            // Null while incubating as well, in which case the delegate model doesn't start another
+            QObject *delegateInstance = instanceModel()->object(i, m_incubationMode);
+            if (delegateInstance)
+                addDelegateToMap(qobject_cast<QQuickItem *>(delegateInstance), i, true);
+        }
+    }
+    if (m_tableModel)
+        m_tableModel->drainReusableItemsPool(reusePoolTime);
+    return false;
+}
+
+void QDeclarativeGeoMapItemView::cullDelegate(int index)
+{
+    QQuickItem *item = m_instantiatedItems.at(index);
+    m_instantiatedItems[index] = nullptr;
+    if (m_exit)
+        terminateExitTransition(item);
+    disposeDelegate(item);
+}
+
+bool QDeclarativeGeoMapItemView::reuseItems() const
+{
+    return m_reuseItems;
+}
+
+void QDeclarativeGeoMapItemView::setReuseItems(bool reuse)
+{
+    if (m_reuseItems == reuse)
+        return;
+    m_reuseItems = reuse;
+    if (m_componentCompleted)
+        updateReuseModel();
+    emit reuseItemsChanged();
+}
+
+QString QDeclarativeGeoMapItemView::identityRole() const
+{
+    return m_identityRole;
+}
+
+void QDeclarativeGeoMapItemView::setIdentityRole(const QString &role)
+{
+    if (m_identityRole == role)
+        return;
+    m_identityRole = role;
+    emit identityRoleChanged();
+}
+
+QQmlInstanceModel *QDeclarativeGeoMapItemView::instanceModel() const
+{
+    if (m_tableModel)
+        return m_tableModel;
+    return m_delegateModel;
+}
+
+int QDeclarativeGeoMapItemView::rowCount() const
+{
+    // The table model counts every cell, only the first column is used here
+    if (m_tableModel)
+        return m_tableModel->rows();
+    return m_delegateModel->count();
+}
+
+QAbstractItemModel *QDeclarativeGeoMapItemView::sourceModel() const
+{
+    return qobject_cast<QAbstractItemModel *>(m_itemModel.value<QObject *>());
+}
+
+/*!
+    \internal
+
+    Switches between the delegate model and the table instance model, depending on
+    reuseItems and the model, and instantiates the delegates again.
+*/
+void QDeclarativeGeoMapItemView::updateReuseModel()
+{
+    QAbstractItemModel *model = m_reuseItems ? sourceModel() : nullptr;
+
+    removeInstantiatedItems(false);
+    if (m_tableModel) {
+        if (const QAbstractItemModel *oldModel = m_tableModel->abstractItemModel())
+            disconnect(oldModel, nullptr, this, nullptr);
+        delete m_tableModel;
+        m_tableModel = nullptr;
+    }
+    m_identities.clear();
+    invalidateCullingIndex();
+
+    if (!model) {
+        // Emits a reset, handled in modelUpdated, if the delegate model didn't have it yet
+        m_delegateModel->setModel(m_itemModel);
+        instantiateAllItems();
+        return;
+    }
+
+    m_delegateModel->setModel(QVariant());
+    m_tableModel = new QQmlTableInstanceModel(qmlContext(this), this);
+    m_tableModel->setDelegate(m_delegate);
+    m_tableModel->setModel(m_itemModel);
+    connect(m_tableModel, &QQmlInstanceModel::createdItem, this, &QDeclarativeGeoMapItemView::createdItem);
+
+    connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &QDeclarativeGeoMapItemView::captureIdentities);
+    connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, &QDeclarativeGeoMapItemView::captureIdentities);
+    connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, &QDeclarativeGeoMapItemView::captureIdentities);
+    connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &QDeclarativeGeoMapItemView::captureIdentities);
+    connect(model, &QAbstractItemModel::rowsAboutToBeMoved, this, &QDeclarativeGeoMapItemView::captureIdentities);
+    connect(model, &QAbstractItemModel::modelReset, this, &QDeclarativeGeoMapItemView::reloadItems);
+    connect(model, &QAbstractItemModel::layoutChanged, this, &QDeclarativeGeoMapItemView::reloadItems);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &QDeclarativeGeoMapItemView::reloadItems);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &QDeclarativeGeoMapItemView::reloadItems);
+    connect(model, &QAbstractItemModel::rowsMoved, this, &QDeclarativeGeoMapItemView::reloadItems);
+    connect(model, &QAbstractItemModel::dataChanged, this, &QDeclarativeGeoMapItemView::onModelDataChanged);
+
+    instantiateAllItems();
+}
+
+/*!
+    \internal
+
+    Remembers which delegate shows which identity, while the model still has the old rows.
+*/
+void QDeclarativeGeoMapItemView::captureIdentities()
+{
+    m_identities.clear();
+    QAbstractItemModel *model = sourceModel();
+    if (m_identityRole.isEmpty() || !model)
+        return;
+    const int role = model->roleNames().key(m_identityRole.toUtf8(), -1);
+    if (role < 0)
+        return;
+    for (int row = 0; row < m_instantiatedItems.size(); ++row) {
+        if (QQuickItem *item = m_instantiatedItems.at(row))
+            m_identities.insert(model->index(row, 0).data(role).toString(), item);
+    }
+}
+
+/*!
+    \internal
+
+    Called after a structural change of the model, with the table instance model in use.
+    Like TableView does, all the delegates go back to the pool, as their model indices are
+    stale, and the rows take them back out of it. The delegates taken back by a row stay on
+    the map, only the ones left over are removed from it.
+*/
+void QDeclarativeGeoMapItemView::reloadItems()
+{
+    const QHash<QString, QQuickItem *> identities = m_identities;
+    m_identities.clear();
+    invalidateCullingIndex();
+    if (!m_map || !m_tableModel)
+        return;
+
+    const QList<QQuickItem *> previous = m_instantiatedItems;
+    m_instantiatedItems.clear();
+    for (int i = 0; i < previous.size(); ++i) {
+        if (!previous.at(i))
+            m_tableModel->cancel(i); // possibly still incubating
+    }
+
+    // The pool hands out the oldest delegate first. So rows keeping their identity are
+    // served first, in the same order their delegates are put back in the pool.
+    const int count = rowCount();
+    QVector<int> order;
+    order.reserve(count);
+    QVector<QQuickItem *> released;
+    released.reserve(previous.size());
+    QSet<QQuickItem *> matched;
+    QAbstractItemModel *model = sourceModel();
+    const int role = (identities.isEmpty() || !model) ? -1 : model->roleNames().key(m_identityRole.toUtf8(), -1);
+    if (role >= 0) {
+        QVector<int> others;
+        for (int row = 0; row < count; ++row) {
+            QQuickItem *item = identities.value(model->index(row, 0).data(role).toString());
+            if (item && !matched.contains(item)) {
+                matched.insert(item);
+                order.append(row);
+                released.append(item);
+            } else {
+                others.append(row);
+            }
+        }
+        order += others;
+        // Older pooled delegates would be handed out first otherwise
+        m_tableModel->drainReusableItemsPool(-1);
+    } else {
+        for (int row = 0; row < count; ++row)
+            order.append(row);
+    }
+    for (QQuickItem *item : previous) {
+        if (item && !matched.contains(item))
+            released.append(item);
+    }
+    for (QQuickItem *item : qAsConst(released)) {
+        disconnect(item, 0, this, 0);
+        m_tableModel->release(item, QQmlTableInstanceModel::Reusable);
+    }
+
+    for (int row = 0; row < count; ++row)
+        m_instantiatedItems.append(nullptr);
+    const QVector<bool> wanted = isCulling() ? wantedRows(m_cullingMargin) : QVector<bool>(count, true);
+    QSet<QQuickItem *> reused;
+    QBoolBlocker createBlocker(m_creatingObject, true);
+    for (int row : qAsConst(order)) {
+        if (wanted.isEmpty() || !wanted.at(row))
+            continue;
+        QQuickItem *item = qobject_cast<QQuickItem *>(m_tableModel->object(row, m_incubationMode));
+        if (!item)
+            continue;
+        if (delegateMap(item) == m_map) { // one of the previous delegates, still on the map
+            m_instantiatedItems[row] = item;
+            reused.insert(item);
+        } else {
+            addDelegateToMap(item, row, true);
+        }
+    }
+
+    for (QQuickItem *item : qAsConst(released)) {
+        if (!reused.contains(item)) {
+            removeDelegateFromMap(item);
+            item->setParentItem(nullptr);
+        }
+    }
+    m_tableModel->drainReusableItemsPool(reusePoolTime);
+    if (isCulling() && wanted.isEmpty())
+        scheduleCullingUpdate(); // the culling region isn't known yet
+    fitViewport();
+}
+
+void QDeclarativeGeoMapItemView::onModelDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (!isCulling() || topLeft.parent().isValid())
+        return;
+    updateCullingIndex(topLeft.row(), bottomRight.row());
+    scheduleCullingUpdate();
+}
+
 QList<QQuickItem *> QDeclarativeGeoMapItemView::mapItems()
 {
     return m_instantiatedItems;
@@ -362,6 +1028,8 @@ QQmlInstanceModel::ReleaseFlags QDeclarativeGeoMapItemView::disposeDelegate(QQui
     removeDelegateFromMap(item);
     item->setParentItem(nullptr);   // Needed because
     item->setParent(nullptr);       // m_delegateModel->release(item) does not destroy the item most of the times!!
+    if (m_tableModel)
+        return m_tableModel->release(item, QQmlTableInstanceModel::Reusable);
     QQmlInstanceModel::ReleaseFlags releaseStatus = m_delegateModel->release(item);
     return releaseStatus;
 }
@@ -375,11 +1043,11 @@ void QDeclarativeGeoMapItemView::removeDelegateFromMap(int index, bool transitio
             // apparently takes care of incubating elements when the model remove those indices.
             // Cancel them explicitly only when a MIV is removed from a map.
             if (!transition)
-                m_delegateModel->cancel(index);
+                instanceModel()->cancel(index);
             return;
         }
         // item can be either a QDeclarativeGeoMapItemBase or a QDeclarativeGeoMapItemGroup (subclass)
-        if (m_exit && m_map && transition) {
+        if (m_exit && m_map && transition && !m_tableModel) {
             transitionItemOut(item);
         } else {
             if (m_exit && m_map && !transition) {
@@ -488,7 +1156,7 @@ void QDeclarativeGeoMapItemView::addItemToMap(QDeclarativeGeoMapItemBase *item,
         insertInstantiatedItem(index, item, createdItem);
         item->setParentItem(this);
         m_map->addMapItem(item);
-        if (m_enter) {
+        if (m_enter && !m_tableModel) {
             if (!item->m_transitionManager) {
                 QScopedPointer<QDeclarativeGeoMapItemTransitionManager>manager(new QDeclarativeGeoMapItemTransitionManager(item));
                 item->m_transitionManager.swap(manager);
@@ -516,7 +1184,7 @@ void QDeclarativeGeoMapItemView::addItemViewToMap(QDeclarativeGeoMapItemView *it
         insertInstantiatedItem(index, item, createdItem);
         item->setParentItem(this);
         m_map->addMapItemView(item);
-        if (m_enter) {
+        if (m_enter && !m_tableModel) {
             if (!item->m_transitionManager) {
                 QScopedPointer<QDeclarativeGeoMapItemTransitionManager> manager(new QDeclarativeGeoMapItemTransitionManager(item));
                 item->m_transitionManager.swap(manager);
@@ -536,7 +1204,7 @@ void QDeclarativeGeoMapItemView::addItemGroupToMap(QDeclarativeGeoMapItemGroup *
         insertInstantiatedItem(index, item, createdItem);
         item->setParentItem(this);
         m_map->addMapItemGroup(item);
-        if (m_enter) {
+        if (m_enter && !m_tableModel) {
             if (!item->m_transitionManager) {
                 QScopedPointer<QDeclarativeGeoMapItemTransitionManager>manager(new QDeclarativeGeoMapItemTransitionManager(item));
                 item->m_transitionManager.swap(manager);
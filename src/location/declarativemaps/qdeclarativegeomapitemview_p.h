@@ -59,6 +59,8 @@
 #include <private/qqmldelegatemodel_p.h>
 #include <QtQuick/private/qquicktransition_p.h>
 #include <QtLocation/private/qdeclarativegeomapitemgroup_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QDeadlineTimer>
 
 QT_BEGIN_NAMESPACE
 
@@ -73,6 +75,8 @@ class MapItemViewDelegateIncubator;
 class QDeclarativeGeoMapItemViewItemData;
 class QDeclarativeGeoMapItemView;
 class QDeclarativeGeoMapItemGroup;
+class QQmlTableInstanceModel;
+class QGeoMapFrameBudget;
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemView : public QDeclarativeGeoMapItemGroup
 {
@@ -85,6 +89,11 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemView : public QDeclarative
     Q_PROPERTY(QQuickTransition *remove MEMBER m_exit REVISION 12)
     Q_PROPERTY(QList<QQuickItem *> mapItems READ mapItems REVISION 12)
     Q_PROPERTY(bool incubateDelegates READ incubateDelegates WRITE setIncubateDelegates NOTIFY incubateDelegatesChanged REVISION 12)
+    Q_PROPERTY(QString cullingRole READ cullingRole WRITE setCullingRole NOTIFY cullingRoleChanged REVISION 15)
+    Q_PROPERTY(qreal cullingMargin READ cullingMargin WRITE setCullingMargin NOTIFY cullingMarginChanged REVISION 15)
+    Q_PROPERTY(bool reuseItems READ reuseItems WRITE setReuseItems NOTIFY reuseItemsChanged REVISION 15)
+    Q_PROPERTY(QString identityRole READ identityRole WRITE setIdentityRole NOTIFY identityRoleChanged REVISION 15)
+    Q_PROPERTY(int incubationBudget READ incubationBudget WRITE setIncubationBudget NOTIFY incubationBudgetChanged REVISION 15)
 
 public:
     explicit QDeclarativeGeoMapItemView(QQuickItem *parent = 0);
@@ -106,6 +115,21 @@ public:
     void setIncubateDelegates(bool useIncubators);
     bool incubateDelegates() const;
 
+    QString cullingRole() const;
+    void setCullingRole(const QString &role);
+
+    qreal cullingMargin() const;
+    void setCullingMargin(qreal margin);
+
+    bool reuseItems() const;
+    void setReuseItems(bool reuse);
+
+    QString identityRole() const;
+    void setIdentityRole(const QString &role);
+
+    int incubationBudget() const;
+    void setIncubationBudget(int msecs);
+
     QList<QQuickItem *> mapItems();
 
     // From QQmlParserStatus
@@ -117,6 +141,11 @@ Q_SIGNALS:
     void delegateChanged();
     void autoFitViewportChanged();
     void incubateDelegatesChanged();
+    Q_REVISION(15) void cullingRoleChanged();
+    Q_REVISION(15) void cullingMarginChanged();
+    Q_REVISION(15) void reuseItemsChanged();
+    Q_REVISION(15) void identityRoleChanged();
+    Q_REVISION(15) void incubationBudgetChanged();
 
 private Q_SLOTS:
     void destroyingItem(QObject *object);
@@ -124,6 +153,10 @@ private Q_SLOTS:
     void createdItem(int index, QObject *object);
     void modelUpdated(const QQmlChangeSet &changeSet, bool reset);
     void exitTransitionFinished();
+    void scheduleCullingUpdate();
+    void captureIdentities();
+    void reloadItems();
+    void onModelDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
 
 private:
     void fitViewport();
@@ -139,6 +172,20 @@ private:
     void addItemGroupToMap(QDeclarativeGeoMapItemGroup *item, int index, bool createdItem);
     void addDelegateToMap(QQuickItem *object, int index, bool createdItem = false);
 
+    bool isCulling() const;
+    void invalidateCullingIndex();
+    void updateCullingIndex(int first, int last);
+    QVector<bool> wantedRows(qreal margin);
+    void updateCulling();
+    bool createDelegates(const QDeadlineTimer &deadline);
+    bool isDeferringDelegates() const;
+    void cullDelegate(int index);
+
+    QQmlInstanceModel *instanceModel() const;
+    int rowCount() const;
+    QAbstractItemModel *sourceModel() const;
+    void updateReuseModel();
+
     bool m_componentCompleted;
     QQmlIncubator::IncubationMode m_incubationMode = QQmlIncubator::Asynchronous;
     QQmlComponent *m_delegate;
@@ -151,6 +198,27 @@ private:
     QQuickTransition *m_enter = nullptr;
     QQuickTransition *m_exit = nullptr;
 
+    // Culling: delegates are only created for the rows positioned in the visible region.
+    QString m_cullingRole;
+    qreal m_cullingMargin = 0.5;
+    bool m_cullingUpdatePending = false;
+    bool m_cullingIndexValid = false;
+    int m_cullingRoleId = -1;
+    QVector<QDoubleVector2D> m_cullingPositions; // per row, mercator. NaN if not positioned
+    QVector<int> m_cullingCells;                  // per row, -1 if not positioned
+    QHash<int, QVector<int>> m_cullingGrid;       // cell -> rows
+    QMetaObject::Connection m_cullingConnections[3];
+
+    // Reuse: with a QAbstractItemModel, delegates come from a table instance model
+    // that can rebind them to other rows, instead of from the delegate model.
+    bool m_reuseItems = false;
+    QString m_identityRole;
+    QQmlTableInstanceModel *m_tableModel = nullptr;
+    QHash<QString, QQuickItem *> m_identities; // identity -> delegate, captured before the model changes
+
+    // Delegates created a frame at a time, within incubationBudget milliseconds
+    QGeoMapFrameBudget *m_frameBudget = nullptr;
+
     friend class QDeclarativeGeoMap;
     friend class QDeclarativeGeoMapItemBase;
     friend class QDeclarativeGeoMapItemTransitionManager;
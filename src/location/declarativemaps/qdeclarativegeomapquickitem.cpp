@@ -42,6 +42,7 @@
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtQuick/private/qquickmousearea_p.h>
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
 
 #include <QDebug>
 #include <cmath>
@@ -379,6 +380,7 @@ void QDeclarativeGeoMapQuickItem::setGeoShape(const QGeoShape &shape)
 */
 void QDeclarativeGeoMapQuickItem::updatePolish()
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::ItemPolish);
     if (!quickMap() && sourceItem_) {
         mapAndSourceItemSet_ = false;
         sourceItem_.data()->setParentItem(0);
@@ -42,9 +42,6 @@
 
 #include <QtQml/QQmlEngine>
 #include <QtQml/qqmlinfo.h>
-#include <QtQml/private/qqmlengine_p.h>
-#include <QtQml/private/qv4scopedvalue_p.h>
-#include <QtQml/private/qv4arrayobject_p.h>
 #include <QtPositioning/QGeoRectangle>
 
 QT_BEGIN_NAMESPACE
@@ -174,46 +171,25 @@ qreal QDeclarativeGeoRoute::distance() const
     indicates the number of objects and 'path[index starting from zero]' gives
     the actual object.
 
-    \sa QtPositioning::coordinate
+    The array is built on the first read and returned again, frozen, until
+    the path changes. To look at a few coordinates of a long route, pathLength() and
+    coordinateAt() do not build it.
+
+    \sa QtPositioning::coordinate, pathLength(), coordinateAt()
 */
 
 QJSValue QDeclarativeGeoRoute::path() const
 {
-    QQmlContext *context = QQmlEngine::contextForObject(parent());
-    QQmlEngine *engine = context->engine();
-    QV4::ExecutionEngine *v4 = QQmlEnginePrivate::getV4Engine(engine);
-
-    QV4::Scope scope(v4);
-    QV4::Scoped<QV4::ArrayObject> pathArray(scope, v4->newArrayObject(route_.path().length()));
-    for (int i = 0; i < route_.path().length(); ++i) {
-        const QGeoCoordinate &c = route_.path().at(i);
-
-        QV4::ScopedValue cv(scope, v4->fromVariant(QVariant::fromValue(c)));
-        pathArray->put(i, cv);
-    }
-
-    return QJSValue(v4, pathArray.asReturnedValue());
+    return m_pathValue.value(parent(), route_.path());
 }
 
 void QDeclarativeGeoRoute::setPath(const QJSValue &value)
 {
-    if (!value.isArray())
+    bool ok;
+    QList<QGeoCoordinate> pathList = toList(this, value, &ok);
+    if (!ok)
         return;
 
-    QList<QGeoCoordinate> pathList;
-    quint32 length = value.property(QStringLiteral("length")).toUInt();
-    for (quint32 i = 0; i < length; ++i) {
-        bool ok;
-        QGeoCoordinate c = parseCoordinate(value.property(i), &ok);
-
-        if (!ok || !c.isValid()) {
-            qmlWarning(this) << "Unsupported path type";
-            return;
-        }
-
-        pathList.append(c);
-    }
-
     if (route_.path() == pathList)
         return;
 
@@ -396,6 +372,38 @@ bool QDeclarativeGeoRoute::equals(QDeclarativeGeoRoute *other) const
     return route_ == other->route_;
 }
 
+/*!
+    \qmlmethod int QtLocation::Route::pathLength()
+
+    Returns the number of coordinates of the path of the route.
+
+    \since 5.15
+
+    \sa path, coordinateAt()
+*/
+int QDeclarativeGeoRoute::pathLength() const
+{
+    return route_.path().size();
+}
+
+/*!
+    \qmlmethod coordinate QtLocation::Route::coordinateAt(int index)
+
+    Returns the coordinate at \a index of the path of the route, or an
+    invalid coordinate if there is none.
+
+    \since 5.15
+
+    \sa path, pathLength()
+*/
+QGeoCoordinate QDeclarativeGeoRoute::coordinateAt(int index) const
+{
+    const QList<QGeoCoordinate> path = route_.path();
+    if (index < 0 || index >= path.size())
+        return QGeoCoordinate();
+    return path.at(index);
+}
+
 /*!
     \qmltype RouteLeg
     \instantiates QDeclarativeGeoRouteLeg
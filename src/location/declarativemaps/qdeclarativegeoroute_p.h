@@ -50,6 +50,7 @@
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativegeoroutesegment_p.h>
+#include <QtLocation/private/locationvaluetypehelper_p.h>
 
 #include <QtCore/QObject>
 #include <QtQml/QQmlListProperty>
@@ -95,6 +96,8 @@ public:
     QQmlPropertyMap *extendedAttributes() const;
 
     Q_INVOKABLE bool equals(QDeclarativeGeoRoute *other) const;
+    Q_REVISION(15) Q_INVOKABLE int pathLength() const;
+    Q_REVISION(15) Q_INVOKABLE QGeoCoordinate coordinateAt(int index) const;
 
 Q_SIGNALS:
     void pathChanged();
@@ -114,6 +117,7 @@ private:
     QList<QObject *> legs_;
     bool segmentsDirty_ = true;
     QQmlPropertyMap *m_extendedAttributes = nullptr;
+    QDeclarativePathValueCache m_pathValue;
 
     friend class QDeclarativeRouteMapItem;
 };
@@ -218,12 +218,14 @@ void QDeclarativeGeoRouteModel::reset()
         beginResetModel();
         qDeleteAll(routes_);
         routes_.clear();
+        updateMemoryUsage();
         emit countChanged();
         emit routesChanged();
         endResetModel();
     }
 
     emit abortRequested();
+    reply_ = nullptr;
     setError(NoError, QString());
     setStatus(QDeclarativeGeoRouteModel::Null);
 }
@@ -237,6 +239,7 @@ void QDeclarativeGeoRouteModel::reset()
 void QDeclarativeGeoRouteModel::cancel()
 {
     emit abortRequested();
+    reply_ = nullptr;
     setError(NoError, QString());
     setStatus(routes_.isEmpty() ? Null : Ready);
 }
@@ -321,11 +324,12 @@ void QDeclarativeGeoRouteModel::setPlugin(QDeclarativeGeoServiceProvider *plugin
     reset(); // reset the model
 
     if (plugin_)
-        disconnect(plugin_, SIGNAL(localesChanged()), this, SIGNAL(measurementSystemChanged()));
+        disconnect(plugin_, SIGNAL(localesChanged()), this, SLOT(pluginLocalesChanged()));
     if (plugin)
-        connect(plugin, SIGNAL(localesChanged()), this, SIGNAL(measurementSystemChanged()));
+        connect(plugin, SIGNAL(localesChanged()), this, SLOT(pluginLocalesChanged()));
 
     plugin_ = plugin;
+    measurementSystemSet_ = false;
 
     if (complete_)
         emit pluginChanged();
@@ -372,11 +376,15 @@ void QDeclarativeGeoRouteModel::pluginReady()
         setError(EngineNotSetError, tr("Plugin does not support routing."));
         return;
     }
+}
 
-    connect(routingManager, SIGNAL(finished(QGeoRouteReply*)),
-            this, SLOT(routingFinished(QGeoRouteReply*)));
-    connect(routingManager, SIGNAL(error(QGeoRouteReply*,QGeoRouteReply::Error,QString)),
-            this, SLOT(routingError(QGeoRouteReply*,QGeoRouteReply::Error,QString)));
+/*!
+    \internal
+*/
+void QDeclarativeGeoRouteModel::pluginLocalesChanged()
+{
+    measurementSystemSet_ = false;
+    emit measurementSystemChanged();
 }
 
 /*!
@@ -483,43 +491,23 @@ void QDeclarativeGeoRouteModel::setMeasurementSystem(QLocale::MeasurementSystem
     if (!plugin_)
         return;
 
-    QGeoServiceProvider *serviceProvider = plugin_->sharedGeoServiceProvider();
-    if (!serviceProvider)
-        return;
-
-    QGeoRoutingManager *routingManager = serviceProvider->routingManager();
-    if (!routingManager)
-        return;
-
-    if (routingManager->measurementSystem() == ms)
-        return;
-
-    routingManager->setMeasurementSystem(ms);
-    emit measurementSystemChanged();
+    const bool changed = ms != measurementSystem();
+    // Kept by the model, the routing manager may be shared with other models
+    measurementSystem_ = ms;
+    measurementSystemSet_ = true;
+    if (changed)
+        emit measurementSystemChanged();
 }
 
 QLocale::MeasurementSystem QDeclarativeGeoRouteModel::measurementSystem() const
 {
-    if (!plugin_)
-        return QLocale().measurementSystem();
-
-    QGeoServiceProvider *serviceProvider = plugin_->sharedGeoServiceProvider();
-    if (!serviceProvider) {
-        if (plugin_->locales().isEmpty())
-            return QLocale().measurementSystem();
-
-        return QLocale(plugin_->locales().first()).measurementSystem();
-    }
+    if (measurementSystemSet_)
+        return measurementSystem_;
 
-    QGeoRoutingManager *routingManager = serviceProvider->routingManager();
-    if (!routingManager) {
-        if (plugin_->locales().isEmpty())
-            return QLocale().measurementSystem();
-
-        return QLocale(plugin_->locales().first()).measurementSystem();
-    }
+    if (!plugin_ || plugin_->locales().isEmpty())
+        return QLocale().measurementSystem();
 
-    return routingManager->measurementSystem();
+    return QLocale(plugin_->locales().first()).measurementSystem();
 }
 
 /*!
@@ -641,10 +629,20 @@ void QDeclarativeGeoRouteModel::update()
 
     setError(NoError, QString());
 
+    // The engine reads the measurement system as it makes the request
+    routingManager->setMeasurementSystem(measurementSystem());
     QGeoRouteReply *reply = routingManager->calculateRoute(request);
+    reply_ = reply;
     setStatus(QDeclarativeGeoRouteModel::Loading);
     if (!reply->isFinished()) {
         connect(this, &QDeclarativeGeoRouteModel::abortRequested, reply, &QGeoRouteReply::abort);
+        // Only the replies of this model, not those of the models sharing the manager
+        connect(reply, &QGeoRouteReply::finished, this, [this, reply]() {
+            if (reply->error() == QGeoRouteReply::NoError)
+                routingFinished(reply);
+            else
+                routingError(reply, reply->error(), reply->errorString());
+        });
     } else {
         if (reply->error() == QGeoRouteReply::NoError) {
             routingFinished(reply);
@@ -654,6 +652,22 @@ void QDeclarativeGeoRouteModel::update()
     }
 }
 
+/*!
+    \internal
+    Estimates the memory the routes take, their paths and segments mostly: a
+    coordinate of a path is a pointer to shared data of three doubles, and a
+    segment with its maneuver takes a few hundred bytes.
+*/
+void QDeclarativeGeoRouteModel::updateMemoryUsage()
+{
+    static const qint64 coordinateBytes = sizeof(void *) + 4 * sizeof(double);
+    static const qint64 segmentBytes = 384;
+    qint64 bytes = 0;
+    for (const QDeclarativeGeoRoute *route : qAsConst(routes_))
+        bytes += route->route().path().size() * coordinateBytes + route->segmentsCount() * segmentBytes;
+    memory_.setBytes(bytes);
+}
+
 /*!
     \internal
 */
@@ -662,7 +676,7 @@ void QDeclarativeGeoRouteModel::routingFinished(QGeoRouteReply *reply)
     if (!reply)
         return;
     reply->deleteLater();
-    if (reply->error() != QGeoRouteReply::NoError)
+    if (reply != reply_ || reply->error() != QGeoRouteReply::NoError)
         return;
 
     beginResetModel();
@@ -675,6 +689,7 @@ void QDeclarativeGeoRouteModel::routingFinished(QGeoRouteReply *reply)
         QQmlEngine::setContextForObject(route, QQmlEngine::contextForObject(this));
         routes_.append(route);
     }
+    updateMemoryUsage();
     endResetModel();
 
     setError(NoError, QString());
@@ -696,6 +711,8 @@ void QDeclarativeGeoRouteModel::routingError(QGeoRouteReply *reply,
     if (!reply)
         return;
     reply->deleteLater();
+    if (reply != reply_)
+        return;
     setError(static_cast<QDeclarativeGeoRouteModel::RouteError>(error), errorString);
     setStatus(QDeclarativeGeoRouteModel::Error);
 }
@@ -50,6 +50,7 @@
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativegeoserviceprovider_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
 
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoRectangle>
@@ -62,6 +63,7 @@
 #include <QtQml/QQmlParserStatus>
 #include <QtQml/private/qv4engine_p.h>
 #include <QAbstractListModel>
+#include <QPointer>
 
 #include <QObject>
 
@@ -169,10 +171,12 @@ private Q_SLOTS:
                       const QString &errorString);
     void queryDetailsChanged();
     void pluginReady();
+    void pluginLocalesChanged();
 
 private:
     void setStatus(Status status);
     void setError(RouteError error, const QString &errorString);
+    void updateMemoryUsage();
 
     bool complete_;
 
@@ -184,6 +188,12 @@ private:
     Status status_;
     QString errorString_;
     RouteError error_;
+    QGeoMapMemoryTracker memory_ { QGeoMapStatistics::Routes };
+
+    // The routing manager may be shared with the models of identical plugins
+    QPointer<QGeoRouteReply> reply_;
+    QLocale::MeasurementSystem measurementSystem_ = QLocale::MetricSystem;
+    bool measurementSystemSet_ = false;
 };
 
 
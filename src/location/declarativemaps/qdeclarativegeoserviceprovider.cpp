@@ -37,9 +37,116 @@
 #include "qdeclarativegeoserviceprovider_p.h"
 #include <QtQml/QQmlInfo>
 #include <QtQml/QQmlEngine>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+/*
+    The providers of the Plugin elements with the same name, parameters,
+    locale and engine. They share the engines of the provider, and with them
+    its network access and tile cache, instead of each loading their own.
+*/
+struct SharedProvider
+{
+    QString name;
+    QVariantMap parameters;
+    QString locale;
+    bool experimental;
+    QQmlEngine *engine;
+    QGeoServiceProvider *provider;
+    int refs;
+};
+
+struct SharedProviderRegistry
+{
+    QMutex mutex;
+    QVector<SharedProvider> providers;
+};
+
+}
+
+Q_GLOBAL_STATIC(SharedProviderRegistry, sharedProviders)
+
+static QGeoServiceProvider *acquireProvider(const QString &name, const QVariantMap &parameters,
+                                            const QString &locale, bool experimental,
+                                            QQmlEngine *engine)
+{
+    SharedProviderRegistry *registry = sharedProviders();
+    QMutexLocker locker(&registry->mutex);
+    for (SharedProvider &shared : registry->providers) {
+        if (shared.name == name && shared.locale == locale && shared.experimental == experimental
+                && shared.engine == engine && shared.parameters == parameters) {
+            ++shared.refs;
+            return shared.provider;
+        }
+    }
+
+    QGeoServiceProvider *provider = new QGeoServiceProvider(name, parameters);
+    provider->setQmlEngine(engine);
+    provider->setLocale(locale);
+    provider->setAllowExperimental(experimental);
+    registry->providers.append({ name, parameters, locale, experimental, engine, provider, 1 });
+    return provider;
+}
+
+static void releaseProvider(QGeoServiceProvider *provider)
+{
+    if (!provider)
+        return;
+    SharedProviderRegistry *registry = sharedProviders();
+    QMutexLocker locker(&registry->mutex);
+    for (int i = 0; i < registry->providers.size(); ++i) {
+        if (registry->providers.at(i).provider == provider) {
+            if (--registry->providers[i].refs == 0) {
+                registry->providers.remove(i);
+                locker.unlock();
+                delete provider;
+            }
+            return;
+        }
+    }
+}
+
+/*
+    Applies the settings of a Plugin element to its provider. A provider no
+    other element uses is changed in place, a shared one is left to the
+    others and the element takes the one matching the new settings.
+*/
+static QGeoServiceProvider *updateProvider(QGeoServiceProvider *provider, const QVariantMap &parameters,
+                                           const QString &locale, bool experimental)
+{
+    SharedProviderRegistry *registry = sharedProviders();
+    QMutexLocker locker(&registry->mutex);
+    for (SharedProvider &shared : registry->providers) {
+        if (shared.provider != provider)
+            continue;
+        if (shared.refs > 1) {
+            --shared.refs;
+            const QString name = shared.name;
+            QQmlEngine *engine = shared.engine;
+            locker.unlock();
+            return acquireProvider(name, parameters, locale, experimental, engine);
+        }
+        if (shared.experimental != experimental) {
+            shared.experimental = experimental;
+            provider->setAllowExperimental(experimental);
+        }
+        if (shared.parameters != parameters) {
+            shared.parameters = parameters;
+            provider->setParameters(parameters);
+        }
+        if (shared.locale != locale) {
+            shared.locale = locale;
+            provider->setLocale(locale);
+        }
+        break;
+    }
+    return provider;
+}
+
 /*!
     \qmltype Plugin
     //! \instantiates QDeclarativeGeoServiceProvider
@@ -66,6 +173,11 @@ QT_BEGIN_NAMESPACE
     appropriate service plugin to attach to. Plugin objects can only be
     attached once; to use multiple plugins, create multiple Plugin objects.
 
+    Plugin objects attached to the same service plugin with the same
+    \l parameters, first locale and \l allowExperimental setting share the
+    services of the plugin, such as its network access and its tile cache.
+    Changing any of these on one of the objects leaves the others as they were.
+
     \section2 Example Usage
 
     The following snippet shows a Plugin object being created with the
@@ -95,7 +207,7 @@ QDeclarativeGeoServiceProvider::QDeclarativeGeoServiceProvider(QObject *parent)
 QDeclarativeGeoServiceProvider::~QDeclarativeGeoServiceProvider()
 {
     delete required_;
-    delete sharedProvider_;
+    releaseProvider(sharedProvider_);
 }
 
 
@@ -139,20 +251,27 @@ void QDeclarativeGeoServiceProvider::tryAttach()
     if (!parametersReady())
         return;
 
-    delete sharedProvider_;
+    releaseProvider(sharedProvider_);
     sharedProvider_ = nullptr;
 
     if (name_.isEmpty())
         return;
 
-    sharedProvider_ = new QGeoServiceProvider(name_, parameterMap());
-    sharedProvider_->setQmlEngine(qmlEngine(this));
-    sharedProvider_->setLocale(locales_.at(0));
-    sharedProvider_->setAllowExperimental(experimental_);
+    // Plugin elements with the same settings share the provider and its engines
+    sharedProvider_ = acquireProvider(name_, parameterMap(), locales_.at(0), experimental_, qmlEngine(this));
 
     emit attached();
 }
 
+/*!
+    \internal
+*/
+void QDeclarativeGeoServiceProvider::updateSharedProvider()
+{
+    if (sharedProvider_)
+        sharedProvider_ = updateProvider(sharedProvider_, parameterMap(), locales_.at(0), experimental_);
+}
+
 QString QDeclarativeGeoServiceProvider::name() const
 {
     return name_;
@@ -532,8 +651,7 @@ void QDeclarativeGeoServiceProvider::setAllowExperimental(bool allow)
         return;
 
     experimental_ = allow;
-    if (sharedProvider_)
-        sharedProvider_->setAllowExperimental(allow);
+    updateSharedProvider();
 
     emit allowExperimentalChanged(allow);
 }
@@ -591,8 +709,7 @@ void QDeclarativeGeoServiceProvider::setLocales(const QStringList &locales)
     if (locales_.isEmpty())
         locales_.append(QLocale().name());
 
-    if (sharedProvider_)
-        sharedProvider_->setLocale(locales_.at(0));
+    updateSharedProvider();
 
     emit localesChanged();
 }
@@ -620,8 +737,7 @@ void QDeclarativeGeoServiceProvider::parameter_append(QQmlListProperty<QDeclarat
 {
     QDeclarativeGeoServiceProvider *p = static_cast<QDeclarativeGeoServiceProvider *>(prop->object);
     p->parameters_.append(parameter);
-    if (p->sharedProvider_)
-        p->sharedProvider_->setParameters(p->parameterMap());
+    p->updateSharedProvider();
 }
 
 /*!
@@ -647,8 +763,7 @@ void QDeclarativeGeoServiceProvider::parameter_clear(QQmlListProperty<QDeclarati
 {
     QDeclarativeGeoServiceProvider *p = static_cast<QDeclarativeGeoServiceProvider *>(prop->object);
     p->parameters_.clear();
-    if (p->sharedProvider_)
-        p->sharedProvider_->setParameters(p->parameterMap());
+    p->updateSharedProvider();
 }
 
 /*!
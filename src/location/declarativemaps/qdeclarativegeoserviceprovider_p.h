@@ -198,6 +198,7 @@ Q_SIGNALS:
 private:
     bool parametersReady();
     void tryAttach();
+    void updateSharedProvider();
     static void parameter_append(QQmlListProperty<QDeclarativePluginParameter> *prop, QDeclarativePluginParameter *mapObject);
     static int parameter_count(QQmlListProperty<QDeclarativePluginParameter> *prop);
     static QDeclarativePluginParameter *parameter_at(QQmlListProperty<QDeclarativePluginParameter> *prop, int index);
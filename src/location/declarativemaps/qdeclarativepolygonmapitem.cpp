@@ -39,17 +39,23 @@
 #include "qdeclarativepolylinemapitem_p_p.h"
 #include "qdeclarativepolygonmapitem_p_p.h"
 #include "qdeclarativerectanglemapitem_p_p.h"
+#include "qgeomaptriangulationcache_p.h"
 #include "qlocationutils_p.h"
 #include "error_messages_p.h"
 #include "locationvaluetypehelper_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QRunnable>
 #include <QtCore/QScopedValueRollback>
+#include <QtCore/QThreadPool>
 #include <QtGui/private/qtriangulator_p.h>
 #include <QtQml/QQmlInfo>
 #include <QtQml/private/qqmlengine_p.h>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPolygonF>
 #include <qnumeric.h>
 
 #include <QtPositioning/private/qdoublevector2d_p.h>
@@ -62,8 +68,8 @@
 
 /* poly2tri triangulator includes */
 #include <clip2tri.h>
-#include <earcut.hpp>
 #include <array>
+#include <cmath>
 
 QT_BEGIN_NAMESPACE
 
@@ -154,11 +160,127 @@ QT_BEGIN_NAMESPACE
     \since 5.14
 */
 
+static QRectF boundingRect(const QList<QDoubleVector2D> &points)
+{
+    if (points.isEmpty())
+        return QRectF();
+    double minX = points.first().x(), maxX = minX;
+    double minY = points.first().y(), maxY = minY;
+    for (const QDoubleVector2D &point : points) {
+        minX = qMin(minX, point.x());
+        maxX = qMax(maxX, point.x());
+        minY = qMin(minY, point.y());
+        maxY = qMax(maxY, point.y());
+    }
+    return QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+static uint pathKey(const QList<QDoubleVector2D> &points)
+{
+    uint seed = 0;
+    for (const QDoubleVector2D &point : points)
+        seed = qHash(point.y(), qHash(point.x(), seed));
+    return seed;
+}
+
+static bool segmentsTouch(const QDoubleVector2D &a, const QDoubleVector2D &b,
+                          const QDoubleVector2D &c, const QDoubleVector2D &d)
+{
+    auto orientation = [](const QDoubleVector2D &p, const QDoubleVector2D &q, const QDoubleVector2D &r) {
+        const double cross = (q.x() - p.x()) * (r.y() - p.y()) - (q.y() - p.y()) * (r.x() - p.x());
+        return (cross > 0.0) - (cross < 0.0);
+    };
+    if (qMax(a.x(), b.x()) < qMin(c.x(), d.x()) || qMax(c.x(), d.x()) < qMin(a.x(), b.x())
+            || qMax(a.y(), b.y()) < qMin(c.y(), d.y()) || qMax(c.y(), d.y()) < qMin(a.y(), b.y()))
+        return false;
+    const int o1 = orientation(a, b, c), o2 = orientation(a, b, d);
+    const int o3 = orientation(c, d, a), o4 = orientation(c, d, b);
+    // collinear overlaps count as touching, as the bounding boxes intersect
+    return o1 * o2 <= 0 && o3 * o4 <= 0;
+}
+
+/*
+    Whether no two edges of the closed ring touch, other than neighbours in their
+    common point. The edges are sorted into a grid of about one edge per cell,
+    which keeps the test close to linear for outlines such as geofences; rings
+    needing many more comparisons are reported as not simple, which only costs
+    them the clipping path.
+*/
+static bool isSimpleRing(const QList<QDoubleVector2D> &ring)
+{
+    int n = ring.size();
+    if (n > 3 && ring.first() == ring.last())
+        --n;
+    if (n < 3)
+        return false;
+
+    const QRectF bounds = boundingRect(ring);
+    const int cells = qBound(1, int(std::sqrt(double(n))), 256);
+    const double cellWidth = bounds.width() / cells;
+    const double cellHeight = bounds.height() / cells;
+    auto column = [&](double x) {
+        return cellWidth > 0.0 ? qBound(0, int((x - bounds.left()) / cellWidth), cells - 1) : 0;
+    };
+    auto row = [&](double y) {
+        return cellHeight > 0.0 ? qBound(0, int((y - bounds.top()) / cellHeight), cells - 1) : 0;
+    };
+    auto forEachCell = [&](int i, const std::function<void(int)> &f) {
+        const QDoubleVector2D &a = ring.at(i);
+        const QDoubleVector2D &b = ring.at((i + 1) % n);
+        const int x1 = column(qMax(a.x(), b.x())), y1 = row(qMax(a.y(), b.y()));
+        for (int y = row(qMin(a.y(), b.y())); y <= y1; ++y)
+            for (int x = column(qMin(a.x(), b.x())); x <= x1; ++x)
+                f(y * cells + x);
+    };
+
+    // edges by cell, counted first and then filled in
+    const qint64 budget = 16 * qint64(n) + 64;
+    qint64 entries = 0;
+    QVector<int> offsets(cells * cells + 1, 0);
+    for (int i = 0; i < n && entries <= budget; ++i)
+        forEachCell(i, [&](int cell) { ++offsets[cell + 1]; ++entries; });
+    if (entries > budget)
+        return false;
+    for (int cell = 0; cell < cells * cells; ++cell)
+        offsets[cell + 1] += offsets[cell];
+    QVector<int> edges(offsets.last());
+    QVector<int> fill = offsets;
+    for (int i = 0; i < n; ++i)
+        forEachCell(i, [&](int cell) { edges[fill[cell]++] = i; });
+
+    qint64 comparisons = 0;
+    for (int cell = 0; cell < cells * cells; ++cell) {
+        for (int j = offsets[cell]; j < offsets[cell + 1]; ++j) {
+            const int e = edges.at(j);
+            for (int k = j + 1; k < offsets[cell + 1]; ++k) {
+                const int f = edges.at(k); // e < f, as edges were filled in order
+                if (f == e + 1 || (e == 0 && f == n - 1))
+                    continue;
+                if (++comparisons > budget)
+                    return false;
+                if (segmentsTouch(ring.at(e), ring.at((e + 1) % n), ring.at(f), ring.at((f + 1) % n)))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
 QGeoMapPolygonGeometry::QGeoMapPolygonGeometry()
 :   assumeSimple_(false)
 {
 }
 
+/*!
+    \internal
+*/
+qint64 QGeoMapPolygonGeometry::memoryUsage() const
+{
+    return QGeoMapItemGeometry::memoryUsage()
+            + qint64(srcPath_.elementCount()) * qint64(sizeof(QPainterPath::Element))
+            + arrayBytes(srcIndices_) + arrayBytes(simpleRing_.vertices) + arrayBytes(simpleRing_.indices);
+}
+
 /*!
     \internal
 */
@@ -169,6 +291,7 @@ void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
     srcPath_ = QPainterPath();
+    srcIndices_.clear();
 
     // build the actual path
     // The approach is the same as described in QGeoMapPolylineGeometry::updateSourcePoints
@@ -179,37 +302,57 @@ void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
         unwrapBelowX = leftBoundWrapped.x();
 
     QList<QDoubleVector2D> wrappedPath;
-    wrappedPath.reserve(path.size());
     QDoubleVector2D wrappedLeftBound(qInf(), qInf());
-    // 1)
-    for (int i = 0; i < path.size(); ++i) {
-        const QDoubleVector2D &coord = path.at(i);
-        QDoubleVector2D wrappedProjection = p.wrapMapProjection(coord);
-
+    const QList<QDoubleVector2D> &visibleRegion = p.projectableGeometry();
+    const QRectF viewport = boundingRect(p.visibleGeometryExpanded());
+    if (path.size() >= QGeoMapPathCuller::MinimumCulledSize && visibleRegion.size() && !viewport.isNull()) {
+        // 1) with the parts of the path beyond the expanded viewport left out, which
+        //    leaves the visible part of the polygon the same
+        if (!culler_.isBuiltFor(path))
+            culler_.build(path);
+        const bool unwrap = preserveGeometry_;
+        // 2 * wrap factor + 1 if unwrapped, which only decreases as x grows
+        auto piece = [&p, unwrap, unwrapBelowX](double x) {
+            const int wrap = p.projectionWrapFactor(QDoubleVector2D(x, 0.0));
+            return 2 * wrap + ((unwrap && x + wrap < unwrapBelowX) ? 1 : 0);
+        };
+        auto offset = [](int piece) {
+            const int unwrapped = piece & 1;
+            return double((piece - unwrapped) / 2 + unwrapped);
+        };
+        culler_.cull(path, viewport, piece, offset, wrappedPath);
+
+        for (const QDoubleVector2D &wrappedProjection : qAsConst(wrappedPath)) {
+            if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
+                return;
+            if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y()))
+                wrappedLeftBound = wrappedProjection;
+        }
+    } else {
+        // 1) unwrapping x to preserve geometry if moved to border of map.
         // We can get NaN if the map isn't set up correctly, or the projection
         // is faulty -- probably best thing to do is abort
-        if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
+        if (!p.wrapMapProjections(path, wrappedPath, preserveGeometry_, unwrapBelowX))
             return;
 
-        const bool isPointLessThanUnwrapBelowX = (wrappedProjection.x() < leftBoundWrapped.x());
-        // unwrap x to preserve geometry if moved to border of map
-        if (preserveGeometry_ && isPointLessThanUnwrapBelowX) {
-            double distance = wrappedProjection.x() - unwrapBelowX;
-            if (distance < 0.0)
-                distance += 1.0;
-            wrappedProjection.setX(unwrapBelowX + distance);
-        }
-        if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y())) {
-            wrappedLeftBound = wrappedProjection;
+        for (const QDoubleVector2D &wrappedProjection : qAsConst(wrappedPath)) {
+            if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y())) {
+                wrappedLeftBound = wrappedProjection;
+            }
         }
-        wrappedPath.append(wrappedProjection);
     }
 
     // 2)
     QList<QList<QDoubleVector2D> > clippedPaths;
-    const QList<QDoubleVector2D> &visibleRegion = p.projectableGeometry();
-    if (visibleRegion.size()) {
-        c2t::clip2tri clipper;
+    QList<QDoubleVector2D> simpleRing;
+    if (updateSimpleSourcePoints(map, path, wrappedPath, visibleRegion, simpleRing)) {
+        // 2.1) nothing to clip, so the left bound is the point with minimum X already
+        leftBoundWrapped = wrappedLeftBound;
+        srcOrigin_ = p.mapProjectionToGeo(p.unwrapMapProjection(wrappedLeftBound));
+        clippedPaths.append(simpleRing);
+        srcIndices_ = simpleRing_.indices;
+    } else if (visibleRegion.size()) {
+        c2t::clip2tri &clipper = QDeclarativeGeoMapItemUtils::threadClipper();
         clipper.addSubjectPath(QClipperUtils::qListToPath(wrappedPath), true);
         clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
         Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
@@ -237,32 +380,124 @@ void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
 
     // 3)
     QDoubleVector2D origin = p.wrappedMapProjectionToItemPosition(leftBoundWrapped);
+    QVector<double> positions;
     for (const QList<QDoubleVector2D> &path: clippedPaths) {
         QDoubleVector2D lastAddedPoint;
+        QDeclarativeGeoMapItemUtils::projectPath(path, p, positions);
         for (int i = 0; i < path.size(); ++i) {
-            QDoubleVector2D point = p.wrappedMapProjectionToItemPosition(path.at(i));
+            QDoubleVector2D point(positions.at(2 * i), positions.at(2 * i + 1));
             point = point - origin; // (0,0) if point == geoLeftBound_
 
             if (i == 0) {
                 srcPath_.moveTo(point.toPointF());
                 lastAddedPoint = point;
             } else {
-                if ((point - lastAddedPoint).manhattanLength() > 3 ||
+                // a simple ring is thinned out already, and keeps its points for srcIndices_
+                if (!srcIndices_.isEmpty() || (point - lastAddedPoint).manhattanLength() > 3 ||
                         i == path.size() - 1) {
                     srcPath_.lineTo(point.toPointF());
                     lastAddedPoint = point;
                 }
             }
         }
+        if (srcPath_.elementCount() != path.size()) // QPainterPath drops repeated points
+            srcIndices_.clear();
         srcPath_.closeSubpath();
     }
 
-    if (!assumeSimple_)
+    if (!assumeSimple_ && srcIndices_.isEmpty())
         srcPath_ = srcPath_.simplified();
 
     sourceBounds_ = srcPath_.boundingRect();
 }
 
+/*!
+    \internal
+    Takes the ring of a simple polygon lying inside the projectable region as it
+    is, without clipping it, into \a ring, and triangulates it once per integer
+    zoom level. Returns false for any other polygon.
+*/
+bool QGeoMapPolygonGeometry::updateSimpleSourcePoints(const QGeoMap &map,
+                                                      const QList<QDoubleVector2D> &path,
+                                                      const QList<QDoubleVector2D> &wrappedPath,
+                                                      const QList<QDoubleVector2D> &visibleRegion,
+                                                      QList<QDoubleVector2D> &ring)
+{
+    if (path.size() < 3 || wrappedPath.size() != path.size() || visibleRegion.size() < 3)
+        return false;
+
+    // Wrapping moves points by whole map widths, and the ring has to stay in one piece
+    const double shift = std::round(wrappedPath.first().x() - path.first().x());
+    double minX = qInf(), minY = qInf(), maxX = -qInf(), maxY = -qInf();
+    for (int i = 0; i < path.size(); ++i) {
+        const QDoubleVector2D &point = wrappedPath.at(i);
+        if (std::round(point.x() - path.at(i).x()) != shift)
+            return false;
+        minX = qMin(minX, point.x());
+        maxX = qMax(maxX, point.x());
+        minY = qMin(minY, point.y());
+        maxY = qMax(maxY, point.y());
+    }
+
+    // The projectable region is convex, so containing the bounding box is enough
+    QPolygonF region;
+    region.reserve(visibleRegion.size());
+    for (const QDoubleVector2D &point : visibleRegion)
+        region.append(point.toPointF());
+    const QPointF corners[] = { QPointF(minX, minY), QPointF(maxX, minY),
+                                QPointF(maxX, maxY), QPointF(minX, maxY) };
+    for (const QPointF &corner : corners) {
+        if (!region.containsPoint(corner, Qt::OddEvenFill))
+            return false;
+    }
+
+    const uint key = pathKey(path);
+    if (simpleRing_.pathSize != path.size() || simpleRing_.pathKey != key) {
+        simpleRing_ = SimpleRing();
+        simpleRing_.pathKey = key;
+        simpleRing_.pathSize = path.size();
+        simpleRing_.simple = assumeSimple_ || isSimpleRing(path);
+    }
+    if (!simpleRing_.simple)
+        return false;
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+    const double zoom = map.cameraData().zoomLevel();
+    const int zoomBucket = int(std::floor(zoom));
+    if (simpleRing_.zoomBucket != zoomBucket) {
+        // Leave out points closer than 3 pixels at the top of the zoom level, as updateSourcePoints does
+        const double tolerance = 3.0 / (p.mapWidth() * std::exp2(zoomBucket + 1 - zoom));
+        int size = path.size();
+        if (path.first() == path.last())
+            --size;
+        simpleRing_.vertices.clear();
+        simpleRing_.vertices.append(0);
+        for (int i = 1; i < size; ++i) {
+            if ((path.at(i) - path.at(simpleRing_.vertices.last())).manhattanLength() > tolerance)
+                simpleRing_.vertices.append(i);
+        }
+
+        // In map projection coordinates, which stay the same while panning
+        simpleRing_.indices.clear();
+        if (simpleRing_.vertices.size() >= 3) {
+            QGeoMapTriangulationCache::Polygon polygon(1);
+            polygon.front().reserve(simpleRing_.vertices.size());
+            for (int i : qAsConst(simpleRing_.vertices))
+                polygon.front().push_back({{ path.at(i).x(), path.at(i).y() }});
+            simpleRing_.indices = QGeoMapTriangulationCache::instance()->triangulate(polygon, true);
+        }
+        simpleRing_.zoomBucket = zoomBucket;
+    }
+    if (simpleRing_.indices.isEmpty())
+        return false;
+
+    ring.clear();
+    ring.reserve(simpleRing_.vertices.size());
+    for (int i : qAsConst(simpleRing_.vertices))
+        ring.append(wrappedPath.at(i));
+    return true;
+}
+
 /*!
     \internal
 */
@@ -293,7 +528,6 @@ void QGeoMapPolygonGeometry::updateScreenPoints(const QGeoMap &map, qreal stroke
     screenOutline_ = ppi;
 
     using Coord = double;
-    using N = uint32_t;
     using Point = std::array<Coord, 2>;
 
     std::vector<std::vector<Point>> polygon;
@@ -324,9 +558,13 @@ void QGeoMapPolygonGeometry::updateScreenPoints(const QGeoMap &map, qreal stroke
         screenIndices_.clear();
         for (const auto &p : poly)
             screenVertices_ << QPointF(p[0], p[1]);
-        std::vector<N> indices = qt_mapbox::earcut<N>(polygon);
-        for (const auto &i: indices)
-            screenIndices_ << quint32(i);
+        // Screen space, so only reused while the view stays the same, e.g. on style changes.
+        // The elements of a simple ring start with its vertices, triangulated in updateSourcePoints.
+        const QVector<quint32> indices = !srcIndices_.isEmpty()
+                ? srcIndices_
+                : QGeoMapTriangulationCache::instance()->triangulate(polygon, false);
+        for (quint32 i : indices)
+            screenIndices_ << i;
     }
 
     screenBounds_ = ppi.boundingRect();
@@ -337,8 +575,53 @@ void QGeoMapPolygonGeometry::updateScreenPoints(const QGeoMap &map, qreal stroke
 QGeoMapPolygonGeometryOpenGL::QGeoMapPolygonGeometryOpenGL(){
 }
 
+/*!
+    \internal
+*/
+qint64 QGeoMapPolygonGeometryOpenGL::memoryUsage() const
+{
+    return QGeoMapItemGeometry::memoryUsage() + arrayBytes(m_screenVertices) + arrayBytes(m_screenIndices);
+}
+
+struct QGeoMapPolygonGeometryOpenGL::Triangulation
+{
+    QDoubleVector2D origin;
+    QVector<QDeclarativeGeoMapItemUtils::vec2> vertices;
+    QVector<quint32> indices;
+    QAtomicInt ready;
+};
+
+void QGeoMapPolygonGeometryOpenGL::setAsynchronous(bool asynchronous, const std::function<void()> &onReady)
+{
+    m_asynchronous = asynchronous;
+    m_onTriangulated = onReady;
+    if (!asynchronous)
+        m_pendingTriangulation.reset();
+}
+
+/*!
+    \internal
+
+    Swaps in the result of the last asynchronous triangulation, if it is done.
+    Results of triangulations that have been superseded are dropped.
+*/
+bool QGeoMapPolygonGeometryOpenGL::takeTriangulation()
+{
+    if (m_pendingTriangulation.isNull() || !m_pendingTriangulation->ready.loadAcquire())
+        return false;
+    m_origin = m_pendingTriangulation->origin;
+    m_screenVertices.swap(m_pendingTriangulation->vertices);
+    m_screenIndices.swap(m_pendingTriangulation->indices);
+    m_pendingTriangulation.reset();
+    m_dataChanged = true;
+    markScreenDirty();
+    return true;
+}
+
 void QGeoMapPolygonGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const QList<QDoubleVector2D> &path)
 {
+    if (!sourceDirty_)
+        return;
     QList<QGeoCoordinate> geopath;
     for (const auto &c: path)
         geopath.append(QWebMercator::mercatorToCoord(c));
@@ -355,15 +638,8 @@ static void wrapPath(const QGeoPolygon &poly
 {
     QList<QList<QDoubleVector2D> > paths;
     for (int i = 0; i < 1+poly.holesCount(); ++i) {
-        QList<QDoubleVector2D> path;
-        if (!i) {
-            for (const QGeoCoordinate &c : poly.path())
-                path << p.geoToMapProjection(c);
-        } else {
-            for (const QGeoCoordinate &c : poly.holePath(i-1))
-                path << p.geoToMapProjection(c);
-        }
-        paths.append(path);
+        paths.append(p.geoToMapProjection(i ? QGeoPolygonPrivate::holeVertices(poly, i - 1)
+                                            : QGeoPathPrivate::vertices(poly)));
     }
 
     const QDoubleVector2D leftBound = p.geoToMapProjection(geoLeftBound);
@@ -398,11 +674,11 @@ static void wrapPath(const QGeoPolygon &poly
 }
 
 static void cutPathEars(const QList<QList<QDoubleVector2D>> &wrappedPaths,
+                        const QDoubleVector2D &origin,
                         QVector<QDeclarativeGeoMapItemUtils::vec2> &screenVertices,
                         QVector<quint32> &screenIndices)
 {
     using Coord = double;
-    using N = uint32_t;
     using Point = std::array<Coord, 2>;
     screenVertices.clear();
     screenIndices.clear();
@@ -413,25 +689,23 @@ static void cutPathEars(const QList<QList<QDoubleVector2D>> &wrappedPaths,
     for (const QList<QDoubleVector2D> &wrappedPath: wrappedPaths) {
         poly.clear();
         for (const QDoubleVector2D &v: wrappedPath) {
-            screenVertices << v;
+            screenVertices << v - origin;
             Point pt = {{ v.x(), v.y() }};
             poly.push_back( pt );
         }
         polygon.push_back(poly);
     }
 
-    std::vector<N> indices = qt_mapbox::earcut<N>(polygon);
-
-    for (const auto &i: indices)
-        screenIndices << quint32(i);
+    // Wrapped mercator rings do not depend on the viewport, so they are worth keeping across sessions
+    screenIndices = QGeoMapTriangulationCache::instance()->triangulate(polygon, true);
 }
 
 static void cutPathEars(const QList<QDoubleVector2D> &wrappedPath,
+                        const QDoubleVector2D &origin,
                         QVector<QDeclarativeGeoMapItemUtils::vec2> &screenVertices,
                         QVector<quint32> &screenIndices)
 {
     using Coord = double;
-    using N = uint32_t;
     using Point = std::array<Coord, 2>;
     screenVertices.clear();
     screenIndices.clear();
@@ -440,16 +714,35 @@ static void cutPathEars(const QList<QDoubleVector2D> &wrappedPath,
     std::vector<Point> poly;
 
     for (const QDoubleVector2D &v: wrappedPath) {
-        screenVertices << v;
+        screenVertices << v - origin;
         Point pt = {{ v.x(), v.y() }};
         poly.push_back( pt );
     }
     polygon.push_back(poly);
 
-    std::vector<N> indices = qt_mapbox::earcut<N>(polygon);
+    // Wrapped mercator rings do not depend on the viewport, so they are worth keeping across sessions
+    screenIndices = QGeoMapTriangulationCache::instance()->triangulate(polygon, true);
+}
+
+void QGeoMapPolygonGeometryOpenGL::triangulate(const QList<QList<QDoubleVector2D>> &wrappedPaths)
+{
+    if (!m_asynchronous) {
+        m_origin = m_bboxLeftBoundWrapped;
+        cutPathEars(wrappedPaths, m_origin, m_screenVertices, m_screenIndices);
+        return;
+    }
 
-    for (const auto &i: indices)
-        screenIndices << quint32(i);
+    // A newer request supersedes the one in flight, whose result is then simply dropped
+    const QSharedPointer<Triangulation> job(new Triangulation);
+    job->origin = m_bboxLeftBoundWrapped;
+    m_pendingTriangulation = job;
+    const std::function<void()> onReady = m_onTriangulated;
+    QThreadPool::globalInstance()->start(QRunnable::create([job, wrappedPaths, onReady]() {
+        cutPathEars(wrappedPaths, job->origin, job->vertices, job->indices);
+        job->ready.storeRelease(1);
+        if (onReady)
+            QMetaObject::invokeMethod(QCoreApplication::instance(), onReady, Qt::QueuedConnection);
+    }));
 }
 
 /*!
@@ -475,7 +768,7 @@ void QGeoMapPolygonGeometryOpenGL::updateSourcePoints(const QGeoMap &map,
 
     // 1.1) do the same for the bbox
     QList<QDoubleVector2D> wrappedBbox, wrappedBboxPlus1, wrappedBboxMinus1;
-    QGeoPolygon bbox(QGeoPath(perimeter).boundingGeoRectangle());
+    QGeoPolygon bbox(QGeoPathBounds::rectangle(qPackCoordinates(perimeter)));
     QDeclarativeGeoMapItemUtils::wrapPath(bbox.path(), bbox.boundingGeoRectangle().topLeft(), p,
              wrappedBbox, wrappedBboxMinus1, wrappedBboxPlus1, &m_bboxLeftBoundWrapped);
 
@@ -483,7 +776,7 @@ void QGeoMapPolygonGeometryOpenGL::updateSourcePoints(const QGeoMap &map,
     //    the triangulations can be used as they are, as they "bypass" the QtQuick display chain
     //    the bbox wraps have to be however clipped, and then projected, in order to figure out the geometry.
     //    Note that this might still cause the geometryChanged method to fail under some extreme conditions.
-    cutPathEars(wrappedPath, m_screenVertices, m_screenIndices);
+    triangulate({ wrappedPath });
 
     m_wrappedPolygons.resize(3);
     m_wrappedPolygons[0].wrappedBboxes = wrappedBboxMinus1;
@@ -518,7 +811,7 @@ void QGeoMapPolygonGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const
     //    the triangulations can be used as they are, as they "bypass" the QtQuick display chain
     //    the bbox wraps have to be however clipped, and then projected, in order to figure out the geometry.
     //    Note that this might still cause the geometryChanged method to fail under some extreme conditions.
-    cutPathEars(wrappedPath, m_screenVertices, m_screenIndices);
+    triangulate(wrappedPath);
     m_wrappedPolygons.resize(3);
     m_wrappedPolygons[0].wrappedBboxes = wrappedBboxMinus1;
     m_wrappedPolygons[1].wrappedBboxes = wrappedBbox;
@@ -533,6 +826,28 @@ void QGeoMapPolygonGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const
     updateSourcePoints(map, perimeter);
 }
 
+void QGeoMapPolygonGeometryOpenGL::updateSourcePoints(const QGeoMap &map,
+                                                      const QList<QList<QDoubleVector2D>> &paths,
+                                                      const QRectF &bounds)
+{
+    if (!sourceDirty_)
+        return;
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+
+    // The paths are not wrapped again, so the left bound has to come from them
+    srcOrigin_ = geoLeftBound_ = p.mapProjectionToGeo(QDoubleVector2D(bounds.left(), qBound(0.0, bounds.top(), 1.0)));
+    m_bboxLeftBoundWrapped = QDoubleVector2D(bounds.topLeft());
+
+    m_origin = m_bboxLeftBoundWrapped;
+    cutPathEars(paths, m_origin, m_screenVertices, m_screenIndices);
+
+    const QList<QDoubleVector2D> wrappedBbox = QDeclarativeGeoMapItemUtils::rectanglePath(bounds);
+    m_wrappedPolygons.resize(3);
+    m_wrappedPolygons[0].wrappedBboxes = QDeclarativeGeoMapItemUtils::rectanglePath(bounds.translated(-1.0, 0.0));
+    m_wrappedPolygons[1].wrappedBboxes = wrappedBbox;
+    m_wrappedPolygons[2].wrappedBboxes = QDeclarativeGeoMapItemUtils::rectanglePath(bounds.translated(1.0, 0.0));
+}
+
 /*!
     \internal
 */
@@ -635,6 +950,7 @@ QDeclarativePolygonMapItem::QDeclarativePolygonMapItem(QQuickItem *parent)
     QObject::connect(&m_border, SIGNAL(widthChanged(qreal)),
                      this, SLOT(onLinePropertiesChanged()));
     setBackend(mapPolygonBackendSelector->backend);
+    m_backendExplicit = false;
 }
 
 QDeclarativePolygonMapItem::~QDeclarativePolygonMapItem()
@@ -665,7 +981,9 @@ QDeclarativeMapLineProperties *QDeclarativePolygonMapItem::border()
 
     This property holds which backend is in use to render the map item.
     Valid values are \b MapPolygon.Software and \b{MapPolygon.OpenGL}.
-    The default value is \b{MapPolygon.Software}.
+    The default value is \b{MapPolygon.Software}, unless the map plugin prefers
+    the OpenGL backends, as the \l{Qt Location Items Overlay Plugin}{itemsoverlay}
+    plugin does.
 
     \note \b{The release of this API with Qt 5.15 is a Technology Preview}.
     Ideally, as the OpenGL backends for map items mature, there will be
@@ -686,6 +1004,7 @@ QDeclarativePolygonMapItem::Backend QDeclarativePolygonMapItem::backend() const
 
 void QDeclarativePolygonMapItem::setBackend(QDeclarativePolygonMapItem::Backend b)
 {
+    m_backendExplicit = true;
     if (b == m_backend)
         return;
     m_backend = b;
@@ -697,12 +1016,50 @@ void QDeclarativePolygonMapItem::setBackend(QDeclarativePolygonMapItem::Backend
     emit backendChanged();
 }
 
+/*!
+    \qmlproperty bool QtLocation::MapPolygon::asynchronous
+
+    This property holds whether the geometry of the polygon is triangulated
+    in a worker thread instead of while polishing the item. Until the new
+    triangulation is ready the previous one is shown, or nothing at all the
+    first time. This is useful when many detailed polygons are loaded at once.
+
+    This property only has an effect with the \b{MapPolygon.OpenGL} backend,
+    whose triangulation does not depend on the viewport.
+    The default value is \c false.
+
+    \since 5.15
+*/
+bool QDeclarativePolygonMapItem::asynchronous() const
+{
+    return m_asynchronous;
+}
+
+void QDeclarativePolygonMapItem::setAsynchronous(bool asynchronous)
+{
+    if (asynchronous == m_asynchronous)
+        return;
+    m_asynchronous = asynchronous;
+    m_d->onGeoGeometryChanged();
+    emit asynchronousChanged();
+}
+
 /*!
     \internal
 */
 void QDeclarativePolygonMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
 {
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
+    // Unless set explicitly, the backend follows the preference of the map,
+    // and returns to the default one when the item leaves it
+    if (!m_backendExplicit) {
+        const Backend fallback = mapPolygonBackendSelector->backend;
+        const Backend backend = (fallback == Software && mapPrefersOpenGLItems()) ? OpenGL : fallback;
+        if (backend != m_backend) {
+            setBackend(backend);
+            m_backendExplicit = false;
+        }
+    }
     if (map)
         m_d->onMapSet();
 }
@@ -714,16 +1071,25 @@ void QDeclarativePolygonMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *m
     define the polygon.
     Having less than 3 different coordinates in the path results in undefined behavior.
 
-    \sa addCoordinate, removeCoordinate
+    Besides a list of coordinates, a Float64Array, or an ArrayBuffer of
+    doubles, holding latitude and longitude pairs can be assigned. It is read
+    directly, which is much faster for long paths.
+
+    The array read is built once and returned again until the path changes.
+    It is frozen: to change the path, modify a copy, such as path.slice(), and
+    assign it back. pathLength() and coordinateAt() read the path without
+    building it.
+
+    \sa addCoordinate, removeCoordinate, pathLength(), coordinateAt()
 */
 QJSValue QDeclarativePolygonMapItem::path() const
 {
-    return fromList(this, m_geopoly.path());
+    return m_pathValue.value(this, m_geopoly.path());
 }
 
 void QDeclarativePolygonMapItem::setPath(const QJSValue &value)
 {
-    if (!value.isArray())
+    if (!isPathValue(value))
         return;
 
     QList<QGeoCoordinate> pathList = toList(this, value);
@@ -738,6 +1104,26 @@ void QDeclarativePolygonMapItem::setPath(const QJSValue &value)
     emit pathChanged();
 }
 
+/*!
+    \qmlmethod void MapPolygon::setPath(geopath path)
+
+    Sets the perimeter of the polygon to the coordinates of \a path. Unlike
+    assigning the \l path property, no JavaScript array is built or parsed,
+    which makes this the fastest way to hand a long path from C++ over.
+
+    \sa path
+*/
+void QDeclarativePolygonMapItem::setPath(const QGeoPath &path)
+{
+    if (m_geopoly.path() == path.path())
+        return;
+
+    m_geopoly.setPath(path.path());
+
+    m_d->onGeoGeometryChanged();
+    emit pathChanged();
+}
+
 /*!
     \qmlmethod void MapPolygon::addCoordinate(coordinate)
 
@@ -768,15 +1154,46 @@ void QDeclarativePolygonMapItem::addCoordinate(const QGeoCoordinate &coordinate)
 */
 void QDeclarativePolygonMapItem::removeCoordinate(const QGeoCoordinate &coordinate)
 {
-    int length = m_geopoly.path().length();
+    int length = m_geopoly.size();
     m_geopoly.removeCoordinate(coordinate);
-    if (m_geopoly.path().length() == length)
+    if (m_geopoly.size() == length)
         return;
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
 }
 
+/*!
+    \qmlmethod int MapPolygon::pathLength()
+
+    Returns the number of coordinates of the polygon.
+
+    \since QtLocation 5.15
+
+    \sa path
+*/
+int QDeclarativePolygonMapItem::pathLength() const
+{
+    return m_geopoly.size();
+}
+
+/*!
+    \qmlmethod coordinate MapPolygon::coordinateAt(index)
+
+    Gets the coordinate of the polygon at the given \a index.
+    If the index is outside the path's bounds then an invalid
+    coordinate is returned.
+
+    \since QtLocation 5.15
+*/
+QGeoCoordinate QDeclarativePolygonMapItem::coordinateAt(int index) const
+{
+    if (index < 0 || index >= m_geopoly.size())
+        return QGeoCoordinate();
+
+    return m_geopoly.coordinateAt(index);
+}
+
 /*!
     \qmlproperty color MapPolygon::color
 
@@ -814,11 +1231,30 @@ QSGNode *QDeclarativePolygonMapItem::updateMapItemPaintNode(QSGNode *oldNode, Up
 */
 void QDeclarativePolygonMapItem::updatePolish()
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::ItemPolish);
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     m_d->updatePolish();
 }
 
+/*!
+    \internal
+*/
+bool QDeclarativePolygonMapItem::hasPendingGeometry() const
+{
+    if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
+        return false;
+    return m_d->hasPendingGeometry();
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolygonMapItem::prepareGeometry()
+{
+    m_d->prepareGeometry();
+}
+
 void QDeclarativePolygonMapItem::setMaterialDirty()
 {
     m_dirtyMaterial = true;
@@ -1006,7 +1442,7 @@ void MapPolygonNodeGL::update(const QColor &fillColor,
     {
         fill_material_.setColor(fillColor);
         fill_material_.setGeoProjection(geoProjection);
-        fill_material_.setCenter(center);
+        fill_material_.setCenter(center - QDoubleVector3D(fillShape->m_origin));
         fill_material_.setWrapOffset(fillShape->m_wrapOffset - 1);
         setMaterial(&fill_material_);
         markDirty(DirtyMaterial);
@@ -65,6 +65,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolygonMapItem : public QDeclarative
     Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
     Q_PROPERTY(QDeclarativeMapLineProperties *border READ border CONSTANT)
     Q_PROPERTY(Backend backend READ backend WRITE setBackend NOTIFY backendChanged REVISION 15)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged REVISION 15)
 
 public:
     enum Backend {
@@ -81,9 +82,12 @@ public:
 
     Q_INVOKABLE void addCoordinate(const QGeoCoordinate &coordinate);
     Q_INVOKABLE void removeCoordinate(const QGeoCoordinate &coordinate);
+    Q_REVISION(15) Q_INVOKABLE int pathLength() const;
+    Q_REVISION(15) Q_INVOKABLE QGeoCoordinate coordinateAt(int index) const;
 
     QJSValue path() const;
     void setPath(const QJSValue &value);
+    Q_INVOKABLE void setPath(const QGeoPath &path);
 
     QColor color() const;
     void setColor(const QColor &color);
@@ -93,6 +97,9 @@ public:
     Backend backend() const;
     void setBackend(Backend b);
 
+    bool asynchronous() const;
+    void setAsynchronous(bool asynchronous);
+
     bool contains(const QPointF &point) const override;
     const QGeoShape &geoShape() const override;
     void setGeoShape(const QGeoShape &shape) override;
@@ -101,6 +108,7 @@ Q_SIGNALS:
     void pathChanged();
     void colorChanged(const QColor &color);
     void backendChanged();
+    void asynchronousChanged();
 
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
@@ -110,15 +118,20 @@ protected Q_SLOTS:
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void updatePolish() override;
+    bool hasPendingGeometry() const override;
+    void prepareGeometry() override;
     void setMaterialDirty() override;
 
 #ifdef QT_LOCATION_DEBUG
 public:
 #endif
     QGeoPolygon m_geopoly;
+    QDeclarativePathValueCache m_pathValue;
     QDeclarativeMapLineProperties m_border;
     QColor m_color;
     Backend m_backend = Software;
+    bool m_backendExplicit = false;
+    bool m_asynchronous = false;
     bool m_dirtyMaterial;
 //    bool m_dirtyGeometry = false;
     bool m_updatingGeometry;
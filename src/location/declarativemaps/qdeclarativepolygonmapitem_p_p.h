@@ -54,21 +54,27 @@
 #include <QtLocation/private/qdeclarativegeomapitembase_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 #include <QtLocation/private/qdeclarativegeomapitemutils_p.h>
+#include <QtLocation/private/qgeomappathculler_p.h>
 #include <QtLocation/private/qdeclarativepolygonmapitem_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+#include <QtLocation/private/qgeomapitembatchlayer_p.h>
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
 #include <QtPositioning/QGeoPath>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPolygon>
 #include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qgeopolygon_p.h>
 #include <QSGFlatColorMaterial>
 #include <QSGSimpleMaterial>
 #include <QtGui/QMatrix4x4>
 #include <QColor>
 #include <QList>
 #include <QVector>
+#include <QtCore/QPointer>
 #include <QtCore/QScopedValueRollback>
+#include <QtCore/QSharedPointer>
+#include <functional>
 
 QT_BEGIN_NAMESPACE
 
@@ -84,9 +90,33 @@ public:
 
     void updateScreenPoints(const QGeoMap &map, qreal strokeWidth = 0.0);
 
+    // To be called when the path given to updateSourcePoints() changes
+    inline void markPathChanged() { culler_.clear(); }
+
+    qint64 memoryUsage() const override;
+
 protected:
+    bool updateSimpleSourcePoints(const QGeoMap &map, const QList<QDoubleVector2D> &path,
+                                  const QList<QDoubleVector2D> &wrappedPath,
+                                  const QList<QDoubleVector2D> &visibleRegion,
+                                  QList<QDoubleVector2D> &ring);
+
     QPainterPath srcPath_;
     bool assumeSimple_;
+    QGeoMapPathCuller culler_; // over the path of large polygons, kept while only the viewport changes
+
+    // For simple rings lying inside the projectable region, which need no clipping:
+    // the ring thinned out for one integer zoom level, and its triangulation
+    struct SimpleRing {
+        uint pathKey = 0;
+        int pathSize = -1;
+        bool simple = false;
+        int zoomBucket = -1;
+        QVector<int> vertices; // into the path
+        QVector<quint32> indices;
+    };
+    SimpleRing simpleRing_;
+    QVector<quint32> srcIndices_; // triangles over the elements of srcPath_, if known already
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoMapPolygonGeometryOpenGL : public QGeoMapItemGeometry
@@ -111,9 +141,27 @@ public:
     void updateSourcePoints(const QGeoMap &map,
                             const QGeoRectangle &rect);
 
+    // Mercator paths used as they are, the first one being the outline and the others holes.
+    // bounds is their mercator bounding box, its left edge being the left bound of the geometry.
+    void updateSourcePoints(const QGeoMap &map,
+                            const QList<QList<QDoubleVector2D>> &paths,
+                            const QRectF &bounds);
+
     void updateScreenPoints(const QGeoMap &map, qreal strokeWidth = 0.0, const QColor &strokeColor = Qt::transparent);
     void updateQuickGeometry(const QGeoProjectionWebMercator &p, qreal strokeWidth = 0.0);
 
+    // With asynchronous triangulation updateSourcePoints() still wraps the paths right away, but
+    // leaves the triangulation to a worker thread. The previous one is kept until
+    // takeTriangulation() swaps in the result. onReady is called on the GUI thread once a result
+    // can be taken.
+    void setAsynchronous(bool asynchronous, const std::function<void()> &onReady = std::function<void()>());
+    bool isAsynchronous() const { return m_asynchronous; }
+    bool isTriangulationPending() const { return !m_pendingTriangulation.isNull(); }
+    bool takeTriangulation();
+    void discardTriangulation() { m_pendingTriangulation.reset(); }
+
+    qint64 memoryUsage() const override;
+
     void allocateAndFillPolygon(QSGGeometry *geom) const
     {
 
@@ -137,11 +185,23 @@ public:
             pts[i].set(vx[i].x, vx[i].y);
     }
 
+    // The vertices are relative to m_origin, the mercator top left of the bounding box, so that
+    // their float precision depends on the extent of the polygon and not on where it is.
+    // The nodes subtract the camera center minus the origin, computed in double, in the shader.
+    QDoubleVector2D m_origin;
     QVector<QDeclarativeGeoMapItemUtils::vec2> m_screenVertices;
     QVector<quint32> m_screenIndices;
     QDoubleVector2D m_bboxLeftBoundWrapped;
     QVector<WrappedPolygon> m_wrappedPolygons;
     int m_wrapOffset;
+
+protected:
+    void triangulate(const QList<QList<QDoubleVector2D>> &wrappedPaths);
+
+    struct Triangulation;
+    QSharedPointer<Triangulation> m_pendingTriangulation;
+    std::function<void()> m_onTriangulated;
+    bool m_asynchronous = false;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT MapPolygonShader : public QSGMaterialShader
@@ -304,6 +364,8 @@ public:
     virtual void onGeoGeometryUpdated() = 0;
     virtual void onItemGeometryChanged() = 0;
     virtual void updatePolish() = 0;
+    virtual bool hasPendingGeometry() const { return false; }
+    virtual void prepareGeometry() {}
     virtual void afterViewportChanged() = 0;
     virtual QSGNode * updateMapItemPaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *data) = 0;
     virtual bool contains(const QPointF &point) const = 0;
@@ -334,24 +396,15 @@ public:
         // preserveGeometry is cleared in updateMapItemPaintNode
         m_geometry.markSourceDirty();
         m_borderGeometry.markSourceDirty();
+        m_sourcePrepared = false;
         m_poly.polishAndUpdate();
     }
-    void regenerateCache()
+    // The projection is shared with the copies of the shape, and kept by it across appends
+    QList<QDoubleVector2D> projectedPath() const
     {
         if (!m_poly.map() || m_poly.map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-            return;
-        const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_poly.map()->geoProjection());
-        m_geopathProjected.clear();
-        m_geopathProjected.reserve(m_poly.m_geopoly.size());
-        for (const QGeoCoordinate &c : m_poly.m_geopoly.path())
-            m_geopathProjected << p.geoToMapProjection(c);
-    }
-    void updateCache()
-    {
-        if (!m_poly.map() || m_poly.map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-            return;
-        const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_poly.map()->geoProjection());
-        m_geopathProjected << p.geoToMapProjection(m_poly.m_geopoly.path().last());
+            return QList<QDoubleVector2D>();
+        return QGeoPathPrivate::mercatorVertices(m_poly.m_geopoly);
     }
     void preserveGeometry()
     {
@@ -366,18 +419,18 @@ public:
     }
     void onMapSet() override
     {
-        regenerateCache();
+        m_geometry.markPathChanged();
         markSourceDirtyAndUpdate();
     }
     void onGeoGeometryChanged() override
     {
-        regenerateCache();
+        m_geometry.markPathChanged();
         preserveGeometry();
         markSourceDirtyAndUpdate();
     }
     void onGeoGeometryUpdated() override
     {
-        updateCache();
+        m_geometry.markPathChanged();
         preserveGeometry();
         markSourceDirtyAndUpdate();
     }
@@ -387,7 +440,7 @@ public:
     }
     void updatePolish() override
     {
-        if (m_poly.m_geopoly.path().length() == 0) { // Possibly cleared
+        if (m_poly.m_geopoly.size() == 0) { // Possibly cleared
             m_geometry.clear();
             m_borderGeometry.clear();
             m_poly.setWidth(0);
@@ -400,28 +453,30 @@ public:
         QScopedValueRollback<bool> rollback(m_poly.m_updatingGeometry);
         m_poly.m_updatingGeometry = true;
 
-        m_geometry.updateSourcePoints(*map, m_geopathProjected);
+        if (QDeclarativeGeoMap *quickMap = m_poly.quickMap())
+            quickMap->prepareItemGeometries(&m_poly);
+        const bool prepared = m_sourcePrepared;
+        m_sourcePrepared = false;
+        QList<QList<QDoubleVector2D> > clippedBorderPaths;
+        clippedBorderPaths.swap(m_preparedBorderPaths);
+
+        if (!prepared)
+            m_geometry.updateSourcePoints(*map, projectedPath());
         m_geometry.updateScreenPoints(*map, borderWidth);
 
         QList<QGeoMapItemGeometry *> geoms;
         geoms << &m_geometry;
         m_borderGeometry.clear();
 
-        if (m_poly.m_border.color().alpha() != 0 && borderWidth > 0) {
-            QList<QDoubleVector2D> closedPath = m_geopathProjected;
-            closedPath << closedPath.first();
-
-            m_borderGeometry.setPreserveGeometry(true, m_poly.m_geopoly.boundingGeoRectangle().topLeft());
-
+        if (hasBorder()) {
             const QGeoCoordinate &geometryOrigin = m_geometry.origin();
 
             m_borderGeometry.srcPoints_.clear();
             m_borderGeometry.srcPointTypes_.clear();
 
-            QDoubleVector2D borderLeftBoundWrapped;
-            QList<QList<QDoubleVector2D > > clippedPaths = m_borderGeometry.clipPath(*map, closedPath, borderLeftBoundWrapped);
+            const QList<QList<QDoubleVector2D > > &clippedPaths = prepared ? clippedBorderPaths : clipBorder(*map);
             if (clippedPaths.size()) {
-                borderLeftBoundWrapped = p.geoToWrappedMapProjection(geometryOrigin);
+                const QDoubleVector2D borderLeftBoundWrapped = p.geoToWrappedMapProjection(geometryOrigin);
                 m_borderGeometry.pathToScreen(*map, clippedPaths, borderLeftBoundWrapped);
                 m_borderGeometry.updateScreenPoints(*map, borderWidth);
 
@@ -473,10 +528,37 @@ public:
         return (m_geometry.contains(point) || m_borderGeometry.contains(point));
     }
 
-    QList<QDoubleVector2D> m_geopathProjected;
+    bool hasBorder() const
+    {
+        return m_poly.m_border.color().alpha() != 0 && m_poly.m_border.width() > 0;
+    }
+    QList<QList<QDoubleVector2D> > clipBorder(const QGeoMap &map)
+    {
+        QList<QDoubleVector2D> closedPath = projectedPath();
+        closedPath << closedPath.first();
+        m_borderGeometry.setPreserveGeometry(true, m_poly.m_geopoly.boundingGeoRectangle().topLeft());
+        QDoubleVector2D borderLeftBoundWrapped;
+        return m_borderGeometry.clipPath(map, closedPath, borderLeftBoundWrapped);
+    }
+    bool hasPendingGeometry() const override
+    {
+        return !m_sourcePrepared && m_geometry.isSourceDirty() && m_poly.m_geopoly.size() > 0;
+    }
+    void prepareGeometry() override
+    {
+        // Only touches this item's source geometries, which updatePolish() then leaves alone
+        const QGeoMap &map = *m_poly.map();
+        m_geometry.updateSourcePoints(map, projectedPath());
+        if (hasBorder())
+            m_preparedBorderPaths = clipBorder(map);
+        m_sourcePrepared = true;
+    }
+
     QGeoMapPolygonGeometry m_geometry;
     QGeoMapPolylineGeometry m_borderGeometry;
     MapPolygonNode *m_node = nullptr;
+    bool m_sourcePrepared = false; // by prepareGeometry(), for the next updatePolish()
+    QList<QList<QDoubleVector2D> > m_preparedBorderPaths;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolygonMapItemPrivateOpenGL: public QDeclarativePolygonMapItemPrivate
@@ -518,6 +600,7 @@ public:
     void markSourceDirtyAndUpdate() override
     {
         // preserveGeometry is cleared in updateMapItemPaintNode
+        m_sourceChanged = true;
         m_geometry.markSourceDirty();
         m_borderGeometry.markSourceDirty();
         m_poly.polishAndUpdate();
@@ -553,11 +636,14 @@ public:
     }
     void updatePolish() override
     {
-        if (m_poly.m_geopoly.path().length() == 0) { // Possibly cleared
+        if (m_poly.m_geopoly.size() == 0) { // Possibly cleared
             m_geometry.clear();
+            m_geometry.discardTriangulation();
             m_borderGeometry.clear();
             m_poly.setWidth(0);
             m_poly.setHeight(0);
+            if (QGeoMapItemBatchLayer *layer = QGeoMapItemBatchLayer::layerFor(&m_poly))
+                layer->removeItem(&m_poly);
             return;
         }
 
@@ -567,7 +653,18 @@ public:
         const QColor &lineColor = m_poly.m_border.color();
         const QColor &fillColor = m_poly.color();
         if (fillColor.alpha() != 0) {
-            m_geometry.updateSourcePoints(*m_poly.map(), m_poly.m_geopoly);
+            if (m_geometry.isAsynchronous() != m_poly.m_asynchronous) {
+                QPointer<QDeclarativePolygonMapItem> item(&m_poly);
+                m_geometry.setAsynchronous(m_poly.m_asynchronous, [item]() {
+                    if (item)
+                        item->polishAndUpdate();
+                });
+            }
+            // The polish requested by a finished triangulation must not start another one
+            if (!m_geometry.isAsynchronous() || m_sourceChanged)
+                m_geometry.updateSourcePoints(*m_poly.map(), m_poly.m_geopoly);
+            m_sourceChanged = false;
+            m_geometry.takeTriangulation();
             m_geometry.markScreenDirty();
             m_geometry.updateScreenPoints(*m_poly.map(), lineWidth, lineColor);
         } else {
@@ -585,11 +682,29 @@ public:
         m_poly.setWidth(geom->sourceBoundingBox().width());
         m_poly.setHeight(geom->sourceBoundingBox().height());
         m_poly.setPosition(1.0 * geom->firstPointOffset() - QPointF(lineWidth * 0.5,lineWidth * 0.5));
+
+        m_batched = false;
+        if (QGeoMapItemBatchLayer *layer = QGeoMapItemBatchLayer::layerFor(&m_poly)) {
+            layer->updateShape(&m_poly, fillColor, m_geometry, lineColor, float(lineWidth), m_borderGeometry);
+            m_batched = true;
+        }
     }
     QSGNode * updateMapItemPaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *data) override
     {
         Q_UNUSED(data);
 
+        if (m_batched) { // drawn by the batch layer of the map
+            delete oldNode;
+            m_rootNode = nullptr;
+            m_node = nullptr;
+            m_polylinenode = nullptr;
+            m_geometry.setPreserveGeometry(false);
+            m_geometry.markClean();
+            m_borderGeometry.setPreserveGeometry(false);
+            m_borderGeometry.markClean();
+            return nullptr;
+        }
+
         if (!m_rootNode || !oldNode) {
             m_rootNode = new RootNode();
             m_node = new MapPolygonNodeGL();
@@ -661,6 +776,8 @@ public:
     RootNode *m_rootNode = nullptr;
     MapPolygonNodeGL *m_node = nullptr;
     MapPolylineNodeOpenGLExtruded *m_polylinenode = nullptr;
+    bool m_batched = false;
+    bool m_sourceChanged = true;
 };
 
 QT_END_NAMESPACE
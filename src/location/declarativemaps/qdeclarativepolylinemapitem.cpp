@@ -44,6 +44,8 @@
 #include "locationvaluetypehelper_p.h"
 #include "qdoublevector2d_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
+#include <QtLocation/private/qgeomapitembatchlayer_p.h>
 #include <QtPositioning/private/qwebmercator_p.h>
 
 #include <QtCore/QScopedValueRollback>
@@ -62,6 +64,7 @@
 #include <QtPositioning/private/qgeopath_p.h>
 #include <QtQuick/private/qsgmaterialshader_p.h>
 #include <array>
+#include <climits>
 #include <QThreadPool>
 #include <QRunnable>
 #include <QtLocation/private/qgeomapparameter_p.h>
@@ -386,6 +389,14 @@ QGeoMapPolylineGeometry::QGeoMapPolylineGeometry()
 {
 }
 
+/*!
+    \internal
+*/
+qint64 QGeoMapPolylineGeometry::memoryUsage() const
+{
+    return QGeoMapItemGeometry::memoryUsage() + arrayBytes(srcPoints_) + arrayBytes(srcPointTypes_);
+}
+
 QList<QList<QDoubleVector2D> > QGeoMapPolylineGeometry::clipPath(const QGeoMap &map,
                                                            const QList<QDoubleVector2D> &path,
                                                            QDoubleVector2D &leftBoundWrapped)
@@ -406,30 +417,17 @@ QList<QList<QDoubleVector2D> > QGeoMapPolylineGeometry::clipPath(const QGeoMap &
         unwrapBelowX = leftBoundWrapped.x();
 
     QList<QDoubleVector2D> wrappedPath;
-    wrappedPath.reserve(path.size());
     QDoubleVector2D wrappedLeftBound(qInf(), qInf());
-    // 1)
-    for (int i = 0; i < path.size(); ++i) {
-        const QDoubleVector2D &coord = path.at(i);
-        QDoubleVector2D wrappedProjection = p.wrapMapProjection(coord);
-
-        // We can get NaN if the map isn't set up correctly, or the projection
-        // is faulty -- probably best thing to do is abort
-        if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
-            return QList<QList<QDoubleVector2D> >();
+    // 1) unwrapping x to preserve geometry if moved to border of map.
+    // We can get NaN if the map isn't set up correctly, or the projection
+    // is faulty -- probably best thing to do is abort
+    if (!p.wrapMapProjections(path, wrappedPath, preserveGeometry_, unwrapBelowX))
+        return QList<QList<QDoubleVector2D> >();
 
-        const bool isPointLessThanUnwrapBelowX = (wrappedProjection.x() < leftBoundWrapped.x());
-        // unwrap x to preserve geometry if moved to border of map
-        if (preserveGeometry_ && isPointLessThanUnwrapBelowX) {
-            double distance = wrappedProjection.x() - unwrapBelowX;
-            if (distance < 0.0)
-                distance += 1.0;
-            wrappedProjection.setX(unwrapBelowX + distance);
-        }
+    for (const QDoubleVector2D &wrappedProjection : qAsConst(wrappedPath)) {
         if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y())) {
             wrappedLeftBound = wrappedProjection;
         }
-        wrappedPath.append(wrappedProjection);
     }
 
 #ifdef QT_LOCATION_DEBUG
@@ -485,10 +483,12 @@ void QGeoMapPolylineGeometry::pathToScreen(const QGeoMap &map,
     double maxY = -qInf();
     srcOrigin_ = p.mapProjectionToGeo(p.unwrapMapProjection(leftBoundWrapped));
     QDoubleVector2D origin = p.wrappedMapProjectionToItemPosition(leftBoundWrapped);
+    QVector<double> positions;
     for (const QList<QDoubleVector2D> &path: clippedPaths) {
         QDoubleVector2D lastAddedPoint;
+        QDeclarativeGeoMapItemUtils::projectPath(path, p, positions);
         for (int i = 0; i < path.size(); ++i) {
-            QDoubleVector2D point = p.wrappedMapProjectionToItemPosition(path.at(i));
+            QDoubleVector2D point(positions.at(2 * i), positions.at(2 * i + 1));
             point = point - origin; // (0,0) if point == geoLeftBound_
 
             minX = qMin(point.x(), minX);
@@ -774,12 +774,18 @@ void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const
     if (!sourceDirty_)
         return;
     QGeoPath p(poly.path());
-    if (poly.path().size() && poly.path().last() != poly.path().first())
-        p.addCoordinate(poly.path().first());
+    const QGeoCoordinateSpan perimeter = QGeoPathPrivate::vertices(poly);
+    if (perimeter.size() && perimeter.last() != perimeter.first())
+        p.addCoordinate(perimeter.first().toCoordinate());
     updateSourcePoints(map, p);
 }
 
 void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const QGeoPath &poly)
+{
+    updateSourcePoints(map, QGeoPathSlice(poly));
+}
+
+void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const QGeoPathSlice &slice)
 {
     if (!sourceDirty_)
         return;
@@ -789,14 +795,48 @@ void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const
     // The approach is the same as described in QGeoMapPolylineGeometry::updateSourcePoints
 
 
-    QDoubleVector2D leftBoundWrapped;
     // 1) pre-compute 3 sets of "wrapped" coordinates: one w regular mercator, one w regular mercator +- 1.0
+    // The projection is that of the shape, kept across appends and changes of its tail
     QList<QDoubleVector2D> wrappedPath;
-    QDeclarativeGeoMapItemUtils::wrapPath(poly.path(), geoLeftBound_, p,
-             wrappedPath, &leftBoundWrapped);
+    QDeclarativeGeoMapItemUtils::wrapPath(slice.mercatorVertices(), p.geoToMapProjection(geoLeftBound_),
+                                          wrappedPath);
 
-    const QGeoRectangle &boundingRectangle = poly.boundingGeoRectangle();
-    updateSourcePoints(p, wrappedPath, boundingRectangle);
+    updateSourcePoints(p, wrappedPath, slice.boundingGeoRectangle());
+    // wrapPath stops at the first unprojectable coordinate, such a path can't be appended to.
+    // Neither can a part of a path, appendSourcePoints() being given the whole of it.
+    if (slice.isWholeShape() && wrappedPath.size() == slice.size())
+        m_sourcePathLength = wrappedPath.size();
+}
+
+bool QGeoMapPolylineGeometryOpenGL::appendSourcePoints(const QGeoMap &map, const QGeoPath &path)
+{
+    const QGeoCoordinateSpan coordinates = QGeoPathPrivate::vertices(path);
+    if (m_sourcePathLength < 1 || coordinates.size() <= m_sourcePathLength)
+        return false;
+    // The existing points are wrapped around srcOrigin_. If the left bound moved, all of them have to.
+    if (geoLeftBound_.longitude() != srcOrigin_.longitude())
+        return false;
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+    const QDoubleVector2D leftBound = p.geoToMapProjection(srcOrigin_);
+    const QList<QDoubleVector2D> projected = p.geoToMapProjection(coordinates.mid(m_sourcePathLength));
+    QVector<QDeclarativeGeoMapItemUtils::vec2> tail;
+    tail.reserve(projected.size());
+    for (QDoubleVector2D coord : projected) {
+        if (!qIsFinite(coord.x()) || !qIsFinite(coord.y()))
+            return false;
+        if (coord.x() < leftBound.x())
+            coord.setX(coord.x() + 1.0);
+        tail.append(coord - m_origin);
+    }
+    if (!appendVertices(tail))
+        return false;
+
+    updateWrappedBoundingBoxes(p, path.boundingGeoRectangle());
+    srcOrigin_ = geoLeftBound_;
+    m_sourcePathLength = coordinates.size();
+    m_appendedSinceFill += tail.size();
+    return true;
 }
 
 void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoProjectionWebMercator &p,
@@ -804,6 +844,22 @@ void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoProjectionWebMe
                                                        const QGeoRectangle &boundingRectangle) {
     if (!sourceDirty_)
         return;
+    updateWrappedBoundingBoxes(p, boundingRectangle);
+
+    // New pointers, some old LOD task might still be running and operating on the old pointers.
+    resetLOD();
+
+    m_origin = m_bboxLeftBoundWrapped;
+    for (const auto &v: qAsConst(wrappedPath)) m_screenVertices->append(v - m_origin);
+
+    srcOrigin_ = geoLeftBound_;
+    m_sourcePathLength = -1;
+    m_appendedSinceFill = 0;
+}
+
+void QGeoMapPolylineGeometryOpenGL::updateWrappedBoundingBoxes(const QGeoProjectionWebMercator &p,
+                                                               const QGeoRectangle &boundingRectangle)
+{
     // 1.1) do the same for the bbox
     // Beware: vertical lines (or horizontal lines) might have an "empty" bbox. Check for that
 
@@ -823,20 +879,16 @@ void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoProjectionWebMe
     QDeclarativeGeoMapItemUtils::wrapPath(bbox.path(), bbox.boundingGeoRectangle().topLeft(), p,
              wrappedBbox, wrappedBboxMinus1, wrappedBboxPlus1, &m_bboxLeftBoundWrapped);
 
-    // New pointers, some old LOD task might still be running and operating on the old pointers.
-    resetLOD();
-
-    for (const auto &v: qAsConst(wrappedPath)) m_screenVertices->append(v);
-
     m_wrappedPolygons.resize(3);
     m_wrappedPolygons[0].wrappedBboxes = wrappedBboxMinus1;
     m_wrappedPolygons[1].wrappedBboxes = wrappedBbox;
     m_wrappedPolygons[2].wrappedBboxes = wrappedBboxPlus1;
-    srcOrigin_ = geoLeftBound_;
 }
 
 void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const QGeoRectangle &rect)
 {
+    if (!sourceDirty_)
+        return;
     const QGeoPath path(QDeclarativeRectangleMapItemPrivateCPU::perimeter(rect));
     updateSourcePoints(map, path);
 }
@@ -860,6 +912,30 @@ void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const
     updateSourcePoints(p, wrappedPath, boundingRectangle);
 }
 
+void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoMap &map,
+                                                       const QList<QDoubleVector2D> &path,
+                                                       const QRectF &bounds)
+{
+    if (!sourceDirty_)
+        return;
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+
+    // New pointers, some old LOD task might still be running and operating on the old pointers.
+    resetLOD();
+    m_origin = QDoubleVector2D(bounds.topLeft());
+    for (const QDoubleVector2D &v: path)
+        m_screenVertices->append(v - m_origin);
+
+    m_bboxLeftBoundWrapped = QDoubleVector2D(bounds.topLeft());
+    m_wrappedPolygons.resize(3);
+    m_wrappedPolygons[0].wrappedBboxes = QDeclarativeGeoMapItemUtils::rectanglePath(bounds.translated(-1.0, 0.0));
+    m_wrappedPolygons[1].wrappedBboxes = QDeclarativeGeoMapItemUtils::rectanglePath(bounds);
+    m_wrappedPolygons[2].wrappedBboxes = QDeclarativeGeoMapItemUtils::rectanglePath(bounds.translated(1.0, 0.0));
+    srcOrigin_ = geoLeftBound_ = p.mapProjectionToGeo(QDoubleVector2D(bounds.left(), qBound(0.0, bounds.top(), 1.0)));
+    m_sourcePathLength = -1;
+    m_appendedSinceFill = 0;
+}
+
 void QGeoMapPolylineGeometryOpenGL::updateScreenPoints(const QGeoMap &map, qreal strokeWidth, bool /*adjustTranslation*/)
 {
     if (map.viewportWidth() == 0 || map.viewportHeight() == 0) {
@@ -922,6 +998,38 @@ void QGeoMapPolylineGeometryOpenGL::updateQuickGeometry(const QGeoProjectionWebM
     sourceBounds_.setHeight(brect.height() + strokeWidth);
 }
 
+bool MapPolylineVertexStyle::assign(QVector<MapPolylineVertexStyle> &styles, int first, int count,
+                                    const QColor &color, qreal width)
+{
+    MapPolylineVertexStyle style;
+    if (width > 0.0) {
+        const QRgb rgba = color.rgba();
+        style.color[0] = quint8(qRed(rgba));
+        style.color[1] = quint8(qGreen(rgba));
+        style.color[2] = quint8(qBlue(rgba));
+        style.color[3] = quint8(qAlpha(rgba));
+        style.width = float(width);
+    } else if (first >= styles.size()) {
+        return false; // unstyled already
+    }
+
+    if (styles.size() < first + count)
+        styles.resize(first + count);
+    bool changed = false;
+    for (int i = first; i < first + count; ++i) {
+        if (!(styles.at(i) == style)) {
+            styles[i] = style;
+            changed = true;
+        }
+    }
+    // trailing unstyled vertices need no entry
+    int size = styles.size();
+    while (size > 0 && !styles.at(size - 1).isStyled())
+        --size;
+    styles.resize(size);
+    return changed;
+}
+
 /*
  * QDeclarativePolygonMapItem Private Implementations
  */
@@ -935,6 +1043,24 @@ QDeclarativePolylineMapItemPrivateOpenGLLineStrip::~QDeclarativePolylineMapItemP
 
 QDeclarativePolylineMapItemPrivateOpenGLExtruded::~QDeclarativePolylineMapItemPrivateOpenGLExtruded() {}
 
+void QDeclarativePolylineMapItemPrivateOpenGLExtruded::updatePolish()
+{
+    QDeclarativePolylineMapItemPrivateOpenGLLineStrip::updatePolish();
+
+    m_batched = false;
+    QGeoMapItemBatchLayer *layer = QGeoMapItemBatchLayer::layerFor(&m_poly);
+    if (!layer)
+        return;
+    if (m_poly.m_geopath.size() == 0) {
+        layer->removeItem(&m_poly);
+        return;
+    }
+    const QGeoMap *map = m_poly.map();
+    layer->updateStroke(&m_poly, m_poly.m_line.color(), float(m_poly.m_line.width()), m_penCapStyle,
+                        m_geometry, false, m_poly.zoomForLOD(int(map->cameraData().zoomLevel())));
+    m_batched = true;
+}
+
 /*
  * QDeclarativePolygonMapItem Implementation
  */
@@ -965,6 +1091,7 @@ QDeclarativePolylineMapItem::QDeclarativePolylineMapItem(QQuickItem *parent)
     QObject::connect(&m_line, SIGNAL(widthChanged(qreal)),
                      this, SLOT(updateAfterLinePropertiesChanged()));
     setBackend(mapPolylineBackendSelector->backend);
+    m_backendExplicit = false;
 }
 
 QDeclarativePolylineMapItem::~QDeclarativePolylineMapItem()
@@ -985,6 +1112,16 @@ void QDeclarativePolylineMapItem::updateAfterLinePropertiesChanged()
 void QDeclarativePolylineMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
 {
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
+    // Unless set explicitly, the backend follows the preference of the map,
+    // and returns to the default one when the item leaves it
+    if (!m_backendExplicit) {
+        const Backend fallback = mapPolylineBackendSelector->backend;
+        const Backend backend = (fallback == Software && mapPrefersOpenGLItems()) ? OpenGLExtruded : fallback;
+        if (backend != m_backend) {
+            setBackend(backend);
+            m_backendExplicit = false;
+        }
+    }
     if (map)
         m_d->onMapSet();
 }
@@ -994,16 +1131,29 @@ void QDeclarativePolylineMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *
 
     This property holds the ordered list of coordinates which
     define the polyline.
+
+    Besides a list of coordinates, a Float64Array, or an ArrayBuffer of
+    doubles, holding latitude and longitude pairs can be assigned. It is read
+    directly, which is much faster for long paths:
+
+    \code
+    polyline.path = new Float64Array([59.91, 10.75, 59.92, 10.76])
+    \endcode
+
+    The array read is built once and returned again until the path changes.
+    It is frozen: to change the path, modify a copy, such as path.slice(), and
+    assign it back. pathLength() and coordinateAt() read the path without
+    building it.
 */
 
 QJSValue QDeclarativePolylineMapItem::path() const
 {
-    return fromList(this, m_geopath.path());
+    return m_pathValue.value(this, m_geopath.path());
 }
 
 void QDeclarativePolylineMapItem::setPath(const QJSValue &value)
 {
-    if (!value.isArray())
+    if (!isPathValue(value))
         return;
 
     setPathFromGeoList(toList(this, value));
@@ -1024,6 +1174,7 @@ void QDeclarativePolylineMapItem::setPath(const QGeoPath &path)
         return;
 
     m_geopath = QGeoPathEager(path);
+    m_simplifier.reset();
     m_d->onGeoGeometryChanged();
     emit pathChanged();
 }
@@ -1036,7 +1187,9 @@ void QDeclarativePolylineMapItem::setPathFromGeoList(const QList<QGeoCoordinate>
     if (m_geopath.path() == path)
         return;
 
-    m_geopath.setPath(path);
+    // A route recalculated from a point of it projects only the new part again
+    QGeoPathPrivate::setPathSharingPrefix(m_geopath, path);
+    m_simplifier.reset();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -1053,7 +1206,7 @@ void QDeclarativePolylineMapItem::setPathFromGeoList(const QList<QGeoCoordinate>
 */
 int QDeclarativePolylineMapItem::pathLength() const
 {
-    return m_geopath.path().length();
+    return m_geopath.size();
 }
 
 /*!
@@ -1061,6 +1214,9 @@ int QDeclarativePolylineMapItem::pathLength() const
 
     Adds the specified \a coordinate to the end of the path.
 
+    With a \l simplificationTolerance, the coordinate may replace the last
+    coordinate added instead.
+
     \sa insertCoordinate, removeCoordinate, path
 */
 void QDeclarativePolylineMapItem::addCoordinate(const QGeoCoordinate &coordinate)
@@ -1068,6 +1224,18 @@ void QDeclarativePolylineMapItem::addCoordinate(const QGeoCoordinate &coordinate
     if (!coordinate.isValid())
         return;
 
+    if (m_simplifier.tolerance() > 0) {
+        // Continues from the last vertex after the other changes of the path
+        if (m_simplifier.isEmpty() && m_geopath.size())
+            m_simplifier.reset(m_geopath.coordinateAt(m_geopath.size() - 1));
+        if (m_simplifier.add(coordinate)) {
+            m_geopath.replaceCoordinate(m_geopath.size() - 1, coordinate);
+            m_d->onGeoGeometryChanged();
+            emit pathChanged();
+            return;
+        }
+    }
+
     m_geopath.addCoordinate(coordinate);
 
     m_d->onGeoGeometryUpdated();
@@ -1085,10 +1253,11 @@ void QDeclarativePolylineMapItem::addCoordinate(const QGeoCoordinate &coordinate
 */
 void QDeclarativePolylineMapItem::insertCoordinate(int index, const QGeoCoordinate &coordinate)
 {
-    if (index < 0 || index > m_geopath.path().length())
+    if (index < 0 || index > m_geopath.size())
         return;
 
     m_geopath.insertCoordinate(index, coordinate);
+    m_simplifier.reset();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -1106,10 +1275,11 @@ void QDeclarativePolylineMapItem::insertCoordinate(int index, const QGeoCoordina
 */
 void QDeclarativePolylineMapItem::replaceCoordinate(int index, const QGeoCoordinate &coordinate)
 {
-    if (index < 0 || index >= m_geopath.path().length())
+    if (index < 0 || index >= m_geopath.size())
         return;
 
     m_geopath.replaceCoordinate(index, coordinate);
+    m_simplifier.reset();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -1126,7 +1296,7 @@ void QDeclarativePolylineMapItem::replaceCoordinate(int index, const QGeoCoordin
 */
 QGeoCoordinate QDeclarativePolylineMapItem::coordinateAt(int index) const
 {
-    if (index < 0 || index >= m_geopath.path().length())
+    if (index < 0 || index >= m_geopath.size())
         return QGeoCoordinate();
 
     return m_geopath.coordinateAt(index);
@@ -1156,10 +1326,11 @@ bool QDeclarativePolylineMapItem::containsCoordinate(const QGeoCoordinate &coord
 */
 void QDeclarativePolylineMapItem::removeCoordinate(const QGeoCoordinate &coordinate)
 {
-    int length = m_geopath.path().length();
+    int length = m_geopath.size();
     m_geopath.removeCoordinate(coordinate);
-    if (m_geopath.path().length() == length)
+    if (m_geopath.size() == length)
         return;
+    m_simplifier.reset();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -1178,15 +1349,58 @@ void QDeclarativePolylineMapItem::removeCoordinate(const QGeoCoordinate &coordin
 */
 void QDeclarativePolylineMapItem::removeCoordinate(int index)
 {
-    if (index < 0 || index >= m_geopath.path().length())
+    if (index < 0 || index >= m_geopath.size())
         return;
 
     m_geopath.removeCoordinate(index);
+    m_simplifier.reset();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
 }
 
+/*!
+    \qmlmethod void MapPolyline::setSegmentStyle(int first, int count, color color, real width)
+
+    Draws the \a count segments starting at the coordinate at index \a first
+    with \a color, and \a width times the width of \l line, instead of the
+    \l line style. A \a width of 0 gives them back the \l line style.
+    The styles stay with the indices of the coordinates they were set for.
+
+    Many differently colored stretches of a line, such as traffic along a
+    route, can so be drawn by a single item.
+
+    \note Only the \b{MapPolyline.OpenGLExtruded} backend draws segment styles.
+
+    \sa clearSegmentStyles(), backend
+    \since 5.15
+*/
+void QDeclarativePolylineMapItem::setSegmentStyle(int first, int count, const QColor &color, qreal width)
+{
+    first = qMax(first, 0);
+    count = qMin(count, m_geopath.size() - first);
+    if (count <= 0 || !MapPolylineVertexStyle::assign(m_segmentStyles, first, count, color, width))
+        return;
+    m_d->onSegmentStylesChanged(first, count);
+}
+
+/*!
+    \qmlmethod void MapPolyline::clearSegmentStyles()
+
+    Draws all the segments with the \l line style again.
+
+    \sa setSegmentStyle()
+    \since 5.15
+*/
+void QDeclarativePolylineMapItem::clearSegmentStyles()
+{
+    if (m_segmentStyles.isEmpty())
+        return;
+    const int count = m_segmentStyles.size();
+    m_segmentStyles.clear();
+    m_d->onSegmentStylesChanged(0, count);
+}
+
 /*!
     \qmlpropertygroup Location::MapPolyline::line
     \qmlproperty int MapPolyline::line.width
@@ -1212,7 +1426,9 @@ QDeclarativeMapLineProperties *QDeclarativePolylineMapItem::line()
     This property holds which backend is in use to render the map item.
     Valid values are \b MapPolyline.Software and \b{MapPolyline.OpenGLLineStrip}
     and \b{MapPolyline.OpenGLExtruded}.
-    The default value is \b{MapPolyline.Software}.
+    The default value is \b{MapPolyline.Software}, unless the map plugin prefers
+    the OpenGL backends, as the \l{Qt Location Items Overlay Plugin}{itemsoverlay}
+    plugin does.
 
     \note \b{The release of this API with Qt 5.15 is a Technology Preview}.
     Ideally, as the OpenGL backends for map items mature, there will be
@@ -1233,6 +1449,7 @@ QDeclarativePolylineMapItem::Backend QDeclarativePolylineMapItem::backend() cons
 
 void QDeclarativePolylineMapItem::setBackend(QDeclarativePolylineMapItem::Backend b)
 {
+    m_backendExplicit = true;
     if (b == m_backend)
         return;
     m_backend = b;
@@ -1246,6 +1463,34 @@ void QDeclarativePolylineMapItem::setBackend(QDeclarativePolylineMapItem::Backen
     emit backendChanged();
 }
 
+/*!
+    \qmlproperty real QtLocation::MapPolyline::simplificationTolerance
+
+    This property holds how far, in meters, the coordinates added with
+    \l addCoordinate can be from the line drawn for them. When a coordinate
+    continues the line within that distance, it replaces the last coordinate
+    added instead of following it, so that a breadcrumb of the positions
+    received grows with the turns taken rather than with the time driven.
+
+    The other changes of the path are not simplified. The default value is
+    0, keeping every coordinate added.
+
+    \since 5.15
+*/
+qreal QDeclarativePolylineMapItem::simplificationTolerance() const
+{
+    return m_simplifier.tolerance();
+}
+
+void QDeclarativePolylineMapItem::setSimplificationTolerance(qreal tolerance)
+{
+    tolerance = qMax<qreal>(tolerance, 0);
+    if (tolerance == m_simplifier.tolerance())
+        return;
+    m_simplifier.setTolerance(tolerance);
+    emit simplificationToleranceChanged();
+}
+
 /*!
     \internal
 */
@@ -1266,6 +1511,7 @@ void QDeclarativePolylineMapItem::geometryChanged(const QRectF &newGeometry, con
         return;
 
     m_geopath.translate(offsetLati, offsetLongi);
+    m_simplifier.reset();
     m_d->onGeoGeometryChanged();
     emit pathChanged();
 
@@ -1289,11 +1535,30 @@ void QDeclarativePolylineMapItem::afterViewportChanged(const QGeoMapViewportChan
 */
 void QDeclarativePolylineMapItem::updatePolish()
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::ItemPolish);
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     m_d->updatePolish();
 }
 
+/*!
+    \internal
+*/
+bool QDeclarativePolylineMapItem::hasPendingGeometry() const
+{
+    if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
+        return false;
+    return m_d->hasPendingGeometry();
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolylineMapItem::prepareGeometry()
+{
+    m_d->prepareGeometry();
+}
+
 void QDeclarativePolylineMapItem::updateLineStyleParameter(QGeoMapParameter *p,
                                                            const char *propertyName,
                                                            bool update)
@@ -1505,7 +1770,7 @@ void MapPolylineNodeOpenGLLineStrip::update(const QColor &fillColor,
     }
 
     QSGGeometry *fill = QSGGeometryNode::geometry();
-    if (shape->m_dataChanged) {
+    if (shape->m_dataChanged || shape->m_appendedSinceFill) {
         shape->allocateAndFillLineStrip(fill);
         markDirty(DirtyGeometry);
         shape->m_dataChanged = false;
@@ -1518,7 +1783,7 @@ void MapPolylineNodeOpenGLLineStrip::update(const QColor &fillColor,
         fill_material_.setWrapOffset(shape->m_wrapOffset - 1);
         fill_material_.setColor(fillColor);
         fill_material_.setGeoProjection(geoProjection);
-        fill_material_.setCenter(center);
+        fill_material_.setCenter(center - QDoubleVector3D(shape->m_origin));
         setMaterial(&fill_material_);
         markDirty(DirtyMaterial);
     }
@@ -1599,45 +1864,70 @@ MapPolylineNodeOpenGLExtruded::MapPolylineNodeOpenGLExtruded()
             0 /* vtx cnt */, 0 /* index cnt */, QSGGeometry::UnsignedIntType /* index type */)
 {
     m_geometryTriangulating.setDrawingMode(QSGGeometry::DrawTriangles);
+    // Rewritten on data changes only, the camera being applied by the shader
+    m_geometryTriangulating.setVertexDataPattern(QSGGeometry::StaticPattern);
     QSGGeometryNode::setMaterial(&fill_material_);
     QSGGeometryNode::setGeometry(&m_geometryTriangulating);
 }
 
 MapPolylineNodeOpenGLExtruded::~MapPolylineNodeOpenGLExtruded()
 {
+    dropFilledGeometries();
+    if (QSGGeometryNode::geometry() != &m_geometryTriangulating)
+        delete QSGGeometryNode::geometry();
+}
 
+void MapPolylineNodeOpenGLExtruded::dropFilledGeometries()
+{
+    for (const FilledGeometry &filled : qAsConst(m_filledGeometries)) {
+        if (filled.geometry != &m_geometryTriangulating)
+            delete filled.geometry;
+    }
+    m_filledGeometries.clear();
 }
 
-bool QGeoMapPolylineGeometryOpenGL::allocateAndFillEntries(QSGGeometry *geom,
-                                                           bool closed,
-                                                           unsigned int zoom) const
+// The most recently left levels come last, the oldest ones past the limit are dropped
+void MapPolylineNodeOpenGLExtruded::keepFilledGeometry(const FilledGeometry &filled)
 {
-    // Select LOD. Generate if not present. Assign it to m_screenVertices;
-    if (m_dataChanged) {
-        // it means that the data really changed.
-        // So synchronously produce LOD 1, and enqueue the requested one if != 0 or 1.
-        // Select 0 if 0 is requested, or 1 in all other cases.
-        selectLODOnDataChanged(zoom, m_bboxLeftBoundWrapped.x());
-    } else {
-        // Data has not changed, but active LOD != requested LOD.
-        // So, if there are no active tasks, try to change to the correct one.
-        if (!selectLODOnLODMismatch(zoom, m_bboxLeftBoundWrapped.x(), closed))
-            return false;
+    m_filledGeometries.append(filled);
+    while (m_filledGeometries.size() > MaxFilledGeometries) {
+        QSGGeometry *geometry = m_filledGeometries.takeFirst().geometry;
+        if (geometry != &m_geometryTriangulating)
+            delete geometry;
     }
+}
 
-    const QVector<QDeclarativeGeoMapItemUtils::vec2> &v = *m_screenVertices;
-    if (v.size() < 2) {
-        geom->allocate(0, 0);
-        return true;
+QSGGeometry *MapPolylineNodeOpenGLExtruded::takeFilledGeometry(
+        const QVector<QDeclarativeGeoMapItemUtils::vec2> *lod, int *segments)
+{
+    for (int i = 0; i < m_filledGeometries.size(); ++i) {
+        if (m_filledGeometries.at(i).lod == lod) {
+            *segments = m_filledGeometries.at(i).segments;
+            return m_filledGeometries.takeAt(i).geometry;
+        }
     }
-    const int numSegments = (v.size() - 1);
+    return nullptr;
+}
 
-    const int numIndices = numSegments * 6; // six vertices per line segment
-    geom->allocate(numIndices);
-    MapPolylineNodeOpenGLExtruded::MapPolylineEntry *vertices =
-            static_cast<MapPolylineNodeOpenGLExtruded::MapPolylineEntry *>(geom->vertexData());
+QSGGeometry *MapPolylineNodeOpenGLExtruded::freeGeometry()
+{
+    bool inUse = QSGGeometryNode::geometry() == &m_geometryTriangulating;
+    for (int i = 0; !inUse && i < m_filledGeometries.size(); ++i)
+        inUse = m_filledGeometries.at(i).geometry == &m_geometryTriangulating;
+    if (!inUse)
+        return &m_geometryTriangulating;
+
+    QSGGeometry *geometry = new QSGGeometry(attributesMapPolylineTriangulated(), 0, 0, QSGGeometry::UnsignedIntType);
+    geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+    geometry->setVertexDataPattern(QSGGeometry::StaticPattern);
+    return geometry;
+}
 
-    for (int i = 0; i < numSegments; ++i) {
+static void fillSegmentEntries(MapPolylineNodeOpenGLExtruded::MapPolylineEntry *vertices,
+                               const QVector<QDeclarativeGeoMapItemUtils::vec2> &v,
+                               int first, int numSegments, bool closed)
+{
+    for (int i = first; i < numSegments; ++i) {
         MapPolylineNodeOpenGLExtruded::MapPolylineEntry e;
         const QDeclarativeGeoMapItemUtils::vec2 &cur = v[i];
         const QDeclarativeGeoMapItemUtils::vec2 &next = v[i+1];
@@ -1683,9 +1973,200 @@ bool QGeoMapPolylineGeometryOpenGL::allocateAndFillEntries(QSGGeometry *geom,
             }
         }
     }
+}
+
+// Styles the segments from first on, each by the source vertex it starts at
+static void styleSegmentEntries(MapPolylineNodeOpenGLExtruded::MapPolylineEntry *vertices,
+                                const QVector<MapPolylineVertexStyle> &styles,
+                                const QVector<int> &sources,
+                                int first, int numSegments, int dirtyFirst = 0, int dirtyLast = INT_MAX)
+{
+    for (int i = first; i < numSegments; ++i) {
+        const int source = sources.isEmpty() ? -1 : sources.at(i);
+        if (!sources.isEmpty() && (source < dirtyFirst || source > dirtyLast))
+            continue;
+        const MapPolylineVertexStyle style = (source >= 0 && source < styles.size())
+                ? styles.at(source) : MapPolylineVertexStyle();
+        for (int j = i * 6; j < i * 6 + 6; ++j)
+            vertices[j].style = style;
+    }
+}
+
+void QGeoMapPolylineGeometryOpenGL::setVertexStyles(const QVector<MapPolylineVertexStyle> &styles,
+                                                    int first, int count)
+{
+    if (m_vertexStyles.isEmpty() && styles.isEmpty())
+        return;
+    const int last = (count < 0) ? qMax(m_vertexStyles.size(), styles.size()) - 1 : first + count - 1;
+    m_vertexStyles = styles;
+    if (last < first)
+        return;
+    if (!stylesChanged()) {
+        m_stylesDirtyFirst = first;
+        m_stylesDirtyLast = last;
+    } else {
+        m_stylesDirtyFirst = qMin(m_stylesDirtyFirst, first);
+        m_stylesDirtyLast = qMax(m_stylesDirtyLast, last);
+    }
+}
+
+/*!
+    \internal
+    The levels of detail computed so far, with the significance of the vertices.
+    The simplified levels are left out while simplification tasks write them.
+*/
+qint64 QGeoMapPolylineGeometryOpenGL::memoryUsage() const
+{
+    qint64 bytes = QGeoMapItemGeometry::memoryUsage() + arrayBytes(m_vertexStyles);
+    const bool simplifying = m_tasksInFlight->loadAcquire() > 0;
+    for (unsigned int i = 0; i < m_verticesLOD.size(); ++i) {
+        if (m_verticesLOD[i] && (i == 0 || !simplifying))
+            bytes += arrayBytes(*m_verticesLOD[i]);
+    }
+    if (m_significance)
+        bytes += arrayBytes(*m_significance);
+    return bytes;
+}
+
+QVector<int> QGeoMapPolylineGeometryOpenGL::screenVertexSources() const
+{
+    const QVector<QDeclarativeGeoMapItemUtils::vec2> &v = *m_screenVertices;
+    unsigned int lod = 0;
+    while (lod < m_verticesLOD.size() && m_verticesLOD.at(lod).data() != m_screenVertices)
+        ++lod;
+
+    QVector<int> sources;
+    sources.reserve(v.size());
+    if (lod == 0) {
+        for (int i = 0; i < v.size(); ++i)
+            sources.append(i);
+        return sources;
+    }
+    if (!m_verticesLOD.front())
+        return QVector<int>();
+    const QVector<QDeclarativeGeoMapItemUtils::vec2> &full = *m_verticesLOD.front();
+    auto same = [&](int screen, int source) {
+        return full.at(source).x == v.at(screen).x && full.at(source).y == v.at(screen).y;
+    };
+
+    // Every other level of detail keeps the vertices of level 0 significant at its zoom level,
+    // see selectLOD()
+    if (lod < m_verticesLOD.size() && !m_significance.isNull() && m_significance->size() == full.size()) {
+        const int zoom = int(zoomForLOD(lod * 3));
+        const QVector<quint8> &significance = *m_significance;
+        for (int i = 0; i < significance.size() && sources.size() < v.size(); ++i) {
+            if (int(significance.at(i)) > zoom)
+                continue;
+            if (!same(sources.size(), i))
+                break;
+            sources.append(i);
+        }
+        if (sources.size() == v.size())
+            return sources;
+        sources.clear(); // simplified with an older significance
+    }
+
+    // Otherwise the vertices are found in level 0, in the same order, as they are copies of them
+    int j = 0;
+    for (int i = 0; i < v.size(); ++i, ++j) {
+        while (j < full.size() && !same(i, j))
+            ++j;
+        if (j == full.size())
+            return QVector<int>();
+        sources.append(j);
+    }
+    return sources;
+}
+
+bool QGeoMapPolylineGeometryOpenGL::allocateAndFillEntries(QSGGeometry *geom,
+                                                           bool closed,
+                                                           unsigned int zoom,
+                                                           bool incremental) const
+{
+    // Vertices were only appended to the LOD this geometry was filled with: if the spare room
+    // left by the last fill is enough, rewrite from the old last segment on and leave the rest.
+    if (incremental && !m_dataChanged && !closed && m_appendedSinceFill
+            && m_filledLOD == m_screenVertices && isLODActive(zoom)
+            && m_filledSegments > 0 && m_screenVertices->size() - 1 <= geom->vertexCount() / 6) {
+        const int numSegments = m_screenVertices->size() - 1;
+        MapPolylineNodeOpenGLExtruded::MapPolylineEntry *vertices =
+                static_cast<MapPolylineNodeOpenGLExtruded::MapPolylineEntry *>(geom->vertexData());
+        fillSegmentEntries(vertices, *m_screenVertices, m_filledSegments - 1, numSegments, closed);
+        if (!m_vertexStyles.isEmpty())
+            styleSegmentEntries(vertices, m_vertexStyles, screenVertexSources(), m_filledSegments - 1, numSegments);
+        // The spare room is collapsed onto the last vertex, producing no fragments.
+        for (int i = numSegments * 6; i < geom->vertexCount(); ++i)
+            vertices[i] = vertices[numSegments * 6 - 1];
+        m_filledSegments = numSegments;
+        m_appendedSinceFill = 0;
+        if (!stylesChanged())
+            return true;
+    }
+
+    // Only styles changed since the last fill: rewrite the entries of the restyled segments.
+    if (incremental && !m_dataChanged && !m_appendedSinceFill && stylesChanged()
+            && m_filledLOD == m_screenVertices && isLODActive(zoom)
+            && m_filledSegments == m_screenVertices->size() - 1 && m_filledSegments <= geom->vertexCount() / 6) {
+        const QVector<int> sources = screenVertexSources();
+        MapPolylineNodeOpenGLExtruded::MapPolylineEntry *vertices =
+                static_cast<MapPolylineNodeOpenGLExtruded::MapPolylineEntry *>(geom->vertexData());
+        styleSegmentEntries(vertices, m_vertexStyles, sources, 0, m_filledSegments,
+                            m_stylesDirtyFirst, m_stylesDirtyLast); // unstyled if sources are unknown
+        m_stylesDirtyLast = -1;
+        return true;
+    }
+
+    if (!selectFillLOD(closed, zoom))
+        return false;
+    fillEntries(geom, closed, incremental);
     return true;
 }
 
+bool QGeoMapPolylineGeometryOpenGL::selectFillLOD(bool closed, unsigned int zoom) const
+{
+    // Select LOD. Generate if not present. Assign it to m_screenVertices;
+    if (m_dataChanged) {
+        // it means that the data really changed.
+        // So synchronously produce LOD 1, and enqueue the requested one if != 0 or 1.
+        // Select 0 if 0 is requested, or 1 in all other cases.
+        selectLODOnDataChanged(zoom, m_bboxLeftBoundWrapped.x());
+        return true;
+    }
+    // Data has not changed, but active LOD != requested LOD.
+    // So, if there are no active tasks, try to change to the correct one.
+    return selectLODOnLODMismatch(zoom, m_bboxLeftBoundWrapped.x(), closed);
+}
+
+void QGeoMapPolylineGeometryOpenGL::fillEntries(QSGGeometry *geom, bool closed, bool incremental) const
+{
+    const QVector<QDeclarativeGeoMapItemUtils::vec2> &v = *m_screenVertices;
+    m_appendedSinceFill = 0;
+    m_filledLOD = nullptr;
+    if (v.size() < 2) {
+        geom->allocate(0, 0);
+        return;
+    }
+    const int numSegments = (v.size() - 1);
+
+    // six vertices per line segment. Lines that are being appended to get room to grow.
+    int numAllocated = numSegments;
+    if (incremental && !closed && m_unsimplifiedTail > 0)
+        numAllocated += qMax(16, numSegments / 2);
+    geom->allocate(numAllocated * 6);
+    MapPolylineNodeOpenGLExtruded::MapPolylineEntry *vertices =
+            static_cast<MapPolylineNodeOpenGLExtruded::MapPolylineEntry *>(geom->vertexData());
+    fillSegmentEntries(vertices, v, 0, numSegments, closed);
+    if (!m_vertexStyles.isEmpty())
+        styleSegmentEntries(vertices, m_vertexStyles, screenVertexSources(), 0, numSegments);
+    m_stylesDirtyLast = -1;
+    for (int i = numSegments * 6; i < numAllocated * 6; ++i)
+        vertices[i] = vertices[numSegments * 6 - 1];
+    if (incremental) {
+        m_filledLOD = &v;
+        m_filledSegments = numSegments;
+    }
+}
+
 void QGeoMapPolylineGeometryOpenGL::allocateAndFillLineStrip(QSGGeometry *geom,
                                                              int lod) const
 {
@@ -1693,6 +2174,7 @@ void QGeoMapPolylineGeometryOpenGL::allocateAndFillLineStrip(QSGGeometry *geom,
     Q_UNUSED(lod)
 
     const QVector<QDeclarativeGeoMapItemUtils::vec2> &vx = *m_screenVertices;
+    m_appendedSinceFill = 0;
     geom->allocate(vx.size());
 
     QSGGeometry::Point2D *pts = geom->vertexDataAsPoint2D();
@@ -1711,7 +2193,7 @@ void MapPolylineNodeOpenGLExtruded::update(const QColor &fillColor,
 {
     // shape->size() == number of triangles
     if (shape->m_screenVertices->size() < 2
-            || lineWidth < 0.5 || fillColor.alpha() == 0) { // number of points
+            || ((lineWidth < 0.5 || fillColor.alpha() == 0) && shape->m_vertexStyles.isEmpty())) { // number of points
         setSubtreeBlocked(true);
         return;
     } else {
@@ -1719,11 +2201,34 @@ void MapPolylineNodeOpenGLExtruded::update(const QColor &fillColor,
     }
 
     QSGGeometry *fill = QSGGeometryNode::geometry();
-    if (shape->m_dataChanged || !shape->isLODActive(zoom) || !fill->vertexCount()) { // fill->vertexCount for when node gets destroyed by MapItemBase bcoz of opacity, then recreated.
-        if (shape->allocateAndFillEntries(fill, closed, zoom)) {
+    if (shape->m_dataChanged || shape->m_appendedSinceFill || shape->stylesChanged()
+            || !fill->vertexCount()) { // fill->vertexCount for when node gets destroyed by MapItemBase bcoz of opacity, then recreated.
+        dropFilledGeometries(); // filled with the data or the styles before the change
+        if (shape->allocateAndFillEntries(fill, closed, zoom, true)) {
             markDirty(DirtyGeometry);
             shape->m_dataChanged = false;
         }
+    } else if (!shape->isLODActive(zoom) && shape->selectFillLOD(closed, zoom)
+               && shape->m_screenVertices != shape->m_filledLOD) {
+        // Only the camera changed the level of detail. Keep the geometry filled with the previous
+        // one, and switch to the one filled with the new one before if any, so that zooming back
+        // and forth never extrudes the same vertices twice.
+        const bool keepFill = shape->m_filledLOD != nullptr;
+        if (keepFill)
+            keepFilledGeometry({ shape->m_filledLOD, shape->m_filledSegments, fill });
+        int segments = 0;
+        QSGGeometry *lodGeometry = takeFilledGeometry(shape->m_screenVertices, &segments);
+        if (lodGeometry) {
+            if (!keepFill && fill != &m_geometryTriangulating)
+                delete fill;
+            shape->m_filledLOD = shape->m_screenVertices;
+            shape->m_filledSegments = segments;
+        } else {
+            lodGeometry = keepFill ? freeGeometry() : fill;
+            shape->fillEntries(lodGeometry, closed, true);
+        }
+        QSGGeometryNode::setGeometry(lodGeometry);
+        markDirty(DirtyGeometry);
     }
 
     // Update this
@@ -1732,7 +2237,8 @@ void MapPolylineNodeOpenGLExtruded::update(const QColor &fillColor,
         fill_material_.setWrapOffset(shape->m_wrapOffset - 1);
         fill_material_.setColor(fillColor);
         fill_material_.setGeoProjection(geoProjection);
-        fill_material_.setCenter(center);
+        fill_material_.setCenter(center - QDoubleVector3D(shape->m_origin));
+        fill_material_.setOrigin(shape->m_origin);
         fill_material_.setLineWidth(lineWidth);
         fill_material_.setMiter(capStyle != Qt::FlatCap);
         setMaterial(&fill_material_);
@@ -1767,6 +2273,8 @@ void MapPolylineShaderExtruded::updateState(const QSGMaterialShader::RenderState
                     opacity);
         program()->setUniformValue(m_color_id, v);
     }
+    if (oldMaterial == nullptr || state.isOpacityDirty())
+        program()->setUniformValue(m_opacity_id, state.opacity());
 
     if (state.isMatrixDirty())
     {
@@ -1778,6 +2286,7 @@ void MapPolylineShaderExtruded::updateState(const QSGMaterialShader::RenderState
 
     program()->setUniformValue(m_center_id, vecCenter);
     program()->setUniformValue(m_center_lowpart_id, vecCenter_lowpart);
+    program()->setUniformValue(m_origin_id, QVector3D(float(newMaterial->origin().x()), float(newMaterial->origin().y()), 0.0f));
     program()->setUniformValue(m_miter_id, newMaterial->miter());
     program()->setUniformValue(m_lineWidth_id, newMaterial->lineWidth());
     program()->setUniformValue(m_wrapOffset_id, float(newMaterial->wrapOffset()));
@@ -1806,7 +2315,7 @@ QSGMaterialType *MapPolylineMaterialExtruded::type() const
 int MapPolylineMaterialExtruded::compare(const QSGMaterial *other) const
 {
     const MapPolylineMaterialExtruded &o = *static_cast<const MapPolylineMaterialExtruded *>(other);
-    if (o.m_miter == m_miter)
+    if (o.m_miter == m_miter && o.m_origin == m_origin)
         return MapPolylineMaterial::compare(other);
     return -1;
 }
@@ -1820,23 +2329,33 @@ const char *MapPolylineShaderExtruded::vertexShaderMiteredSegments() const
     "attribute lowp float direction;\n"
     "attribute lowp float triangletype;\n"
     "attribute lowp float vertextype;\n" // -1.0 if it is the "left" end of the segment, 1.0 if it is the "right" end.
+    "attribute lowp vec4 stylecolor;\n"
+    "attribute lowp float stylewidth;\n" // factor of lineWidth, 0.0 for the style of the line
     "\n"
     "uniform highp mat4 qt_Matrix;\n"
     "uniform highp mat4 mapProjection;\n"
     "uniform highp vec3 center;\n"
     "uniform highp vec3 center_lowpart;\n"
+    "uniform highp vec3 origin;\n" // of the vertices, center + origin being the camera center
     "uniform lowp float lineWidth;\n"
     "uniform lowp float aspect;\n"
     "uniform lowp int miter;\n" // currently unused
     "uniform lowp vec4 color;\n"
+    "uniform lowp float opacity;\n"
     "uniform lowp float wrapOffset;\n"
     "\n"
     "varying vec4 primitivecolor;\n"
+    "varying lowp float edge;\n" // -1.0 and 1.0 on the outline, 0.0 on the path
+    "varying mediump float halfWidth;\n" // in pixels, with the antialiasing fringe
     "\n"
     "  \n"
     "vec4 wrapped(in vec4 v) { return vec4(v.x + wrapOffset, v.y, 0.0, 1.0); }\n"
     "void main() {\n" // ln 22
-    "  primitivecolor = color;\n"
+    "  bool styled = stylewidth > 0.0;\n"
+    "  primitivecolor = styled ? vec4(stylecolor.rgb * stylecolor.a, stylecolor.a) * opacity : color;\n"
+    "  float segmentWidth = (styled ? lineWidth * stylewidth : lineWidth) + 1.0;\n" // 0.5 pixel fringe on each side
+    "  edge = direction;\n"
+    "  halfWidth = segmentWidth * 0.5;\n"
     "  vec2 aspectVec = vec2(aspect, 1.0);\n"
     "  mat4 projViewModel = qt_Matrix * mapProjection;\n"
     "  vec4 cur = wrapped(vertex) - vec4(center, 0.0);\n"
@@ -1846,7 +2365,7 @@ const char *MapPolylineShaderExtruded::vertexShaderMiteredSegments() const
     "  vec4 nex = wrapped(next) - vec4(center, 0.0);\n"
     "  nex = nex - vec4(center_lowpart, 0.0);\n"
     "\n"
-    "  vec4 centerProjected = projViewModel * vec4(center, 1.0);\n"
+    "  vec4 centerProjected = projViewModel * vec4(center + origin, 1.0);\n"
     "  vec4 previousProjected = projViewModel * prev;\n"
     "  vec4 currentProjected = projViewModel * cur;\n"
     "  vec4 nextProjected = projViewModel * nex;\n"
@@ -1855,7 +2374,7 @@ const char *MapPolylineShaderExtruded::vertexShaderMiteredSegments() const
     "  vec2 currentScreen = (currentProjected.xy / currentProjected.w) * aspectVec;\n"
     "  vec2 previousScreen = (previousProjected.xy / previousProjected.w) * aspectVec;\n"
     "  vec2 nextScreen = (nextProjected.xy / nextProjected.w) * aspectVec;\n"
-    "  float len = (lineWidth);\n"
+    "  float len = (segmentWidth);\n"
     "  float orientation = direction;\n"
     "  bool clipped = false;\n"
     "  bool otherEndBelowFrustum = false;\n"
@@ -1890,16 +2409,16 @@ const char *MapPolylineShaderExtruded::vertexShaderMiteredSegments() const
     "    vec2 tangent = normalize(dirA + dirB);\n"
     "    vec2 perp = vec2(-dirA.y, dirA.x);\n"
     "    vec2 vmiter = vec2(-tangent.y, tangent.x);\n"
-    "    len = lineWidth / dot(vmiter, perp);\n"
+    "    len = segmentWidth / dot(vmiter, perp);\n"
     // The following is an attempt to have a segment-length based miter threshold.
     // A mediocre workaround until better mitering will be added.
     "    float lenTreshold = clamp( min(length((currentProjected.xy - previousProjected.xy) / aspectVec),"
     "                            length((nextProjected.xy - currentProjected.xy) / aspectVec)), 3.0, 6.0 ) * 0.5;\n"
-    "    if (len < lineWidth * lenTreshold && len > -lineWidth * lenTreshold \n"
+    "    if (len < segmentWidth * lenTreshold && len > -segmentWidth * lenTreshold \n"
     "    ) {\n"
     "       dir = tangent;\n"
     "    } else {\n"
-    "       len = lineWidth;\n"
+    "       len = segmentWidth;\n"
     "    }\n"
     "  }\n"
     "  vec4 offset;\n"
@@ -1911,6 +2430,7 @@ const char *MapPolylineShaderExtruded::vertexShaderMiteredSegments() const
     "    offset = vec4(normal * orientation * scaleFactor * (centerProjected.w / (-2.0 / qt_Matrix[1][1])), 0.0, 0.0);\n" // ToDo: figure out why (-2.0 / qt_Matrix[1][1]), that is empirically what works
     "    gl_Position = currentProjected + offset;\n"
     "  } else {\n"
+    "     edge = 0.0;\n"
     "     if (otherEndBelowFrustum) offset = vec4((dir * 1.0) / aspectVec, 0.0, 0.0);\n"  // the if is necessary otherwise it seems the direction vector still flips in some obscure cases.
     "     else offset = vec4((dir * 500000000000.0) / aspectVec, 0.0, 0.0);\n" // Hack alert: just 1 triangle, long enough to look like a rectangle.
     "     if (vertextype < 0.0) gl_Position = nextProjected - offset; else gl_Position = previousProjected + offset;\n"
@@ -1938,6 +2458,49 @@ QVector<QDeclarativeGeoMapItemUtils::vec2> QGeoMapItemLODGeometry::getSimplified
     return simple;
 }
 
+QVector<QDeclarativeGeoMapItemUtils::vec2> QGeoMapItemLODGeometry::getSimplified(
+        const QVector<QDeclarativeGeoMapItemUtils::vec2> &wrappedPath,
+                                                  const QVector<quint8> &significance,
+                                                  unsigned int zoom)
+{
+    return QGeoSimplify::filterByZoomLevel(wrappedPath, significance, int(zoom));
+}
+
+QSharedPointer<const QVector<quint8>> QGeoMapItemLODGeometry::significance(double leftBound) const
+{
+    if (m_significance.isNull() || m_significanceLeftBound != leftBound) {
+        QList<QDoubleVector2D> data;
+        data.reserve(m_verticesLOD.at(0)->size());
+        for (const auto &e: qAsConst(*m_verticesLOD.at(0)))
+            data << e.toDoubleVector2D() + m_origin;
+        m_significance = QSharedPointer<QVector<quint8>>(
+                    new QVector<quint8>(QGeoSimplify::zoomLevelSignificance(data, leftBound)));
+        m_significanceLeftBound = leftBound;
+    }
+    return m_significance;
+}
+
+
+bool QGeoMapItemLODGeometry::appendVertices(const QVector<QDeclarativeGeoMapItemUtils::vec2> &tail)
+{
+    // Tasks read LOD 0 and write their LOD, neither can be touched until they are done.
+    if (tail.isEmpty() || m_verticesLOD.at(0)->isEmpty() || m_tasksInFlight->loadAcquire() > 0)
+        return false;
+    // Past this, the simplified LODs are too far from what they should be: rebuild them.
+    if (m_unsimplifiedTail + tail.size() > qMax(64, m_verticesLOD.at(0)->size() / 8))
+        return false;
+
+    // The tail goes unsimplified into every LOD. The old last vertex, which was an end point,
+    // stays in all of them, so the simplified lines remain connected to the new vertices.
+    for (const auto &lod: m_verticesLOD) {
+        if (!lod.isNull())
+            *lod << tail;
+    }
+    if (!m_significance.isNull())
+        m_significance->resize(m_significance->size() + tail.size()); // zero-initialized, kept at every zoom
+    m_unsimplifiedTail += tail.size();
+    return true;
+}
 
 bool QGeoMapItemLODGeometry::isLODActive(unsigned int lod) const
 {
@@ -1949,17 +2512,21 @@ class PolylineSimplifyTask : public QRunnable
 public:
     PolylineSimplifyTask(const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &input, // reference as it gets copied in the nested call
                          const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &output,
-                         double leftBound,
+                         const QSharedPointer<const QVector<quint8>> &significance,
                          unsigned int zoom,
-                         QSharedPointer<unsigned int> &working)
+                         QSharedPointer<unsigned int> &working,
+                         const QSharedPointer<QAtomicInt> &tasksInFlight)
         : m_zoom(zoom)
-        , m_leftBound(leftBound)
         , m_input(input)
         , m_output(output)
+        , m_significance(significance)
         , m_working(working)
+        , m_tasksInFlight(tasksInFlight)
     {
         Q_ASSERT(!input.isNull());
         Q_ASSERT(!output.isNull());
+        Q_ASSERT(!significance.isNull());
+        m_tasksInFlight->ref();
     }
 
     ~PolylineSimplifyTask() override;
@@ -1971,31 +2538,35 @@ public:
         *m_working = QGeoMapPolylineGeometryOpenGL::zoomToLOD(m_zoom);
         const QVector<QDeclarativeGeoMapItemUtils::vec2> res =
                 QGeoMapPolylineGeometryOpenGL::getSimplified( *m_input,
-                                   m_leftBound,
+                                   *m_significance,
                                    QGeoMapPolylineGeometryOpenGL::zoomForLOD(m_zoom));
         *m_output = res;
         *m_working = 0;
+        m_tasksInFlight->deref();
     }
 
     unsigned int m_zoom;
-    double m_leftBound;
     QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > m_input, m_output;
+    QSharedPointer<const QVector<quint8>> m_significance;
     QSharedPointer<unsigned int> m_working;
+    QSharedPointer<QAtomicInt> m_tasksInFlight;
 };
 
 void QGeoMapItemLODGeometry::enqueueSimplificationTask(const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &input,
                                                   const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &output,
-                                                  double leftBound,
+                                                  const QSharedPointer<const QVector<quint8>> &significance,
                                                   unsigned int zoom,
-                                                  QSharedPointer<unsigned int> &working)
+                                                  QSharedPointer<unsigned int> &working,
+                                                  const QSharedPointer<QAtomicInt> &tasksInFlight)
 {
     Q_ASSERT(!input.isNull());
     Q_ASSERT(!output.isNull());
     PolylineSimplifyTask *task = new PolylineSimplifyTask(input,
                                                           output,
-                                                          leftBound,
+                                                          significance,
                                                           zoom,
-                                                          working);
+                                                          working,
+                                                          tasksInFlight);
     threadPool->start(task);
 }
 
@@ -2022,7 +2593,7 @@ void QGeoMapItemLODGeometry::selectLOD(unsigned int zoom, double leftBound, bool
                 m_verticesLOD[1] = QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2>>(
                                     new QVector<QDeclarativeGeoMapItemUtils::vec2>);
                 *m_verticesLOD[1] = getSimplified( *m_verticesLOD[0],
-                                                   leftBound,
+                                                   *significance(leftBound),
                                                    zoomForLOD(0));
                 if (requestedLod == 1)
                     return;
@@ -2031,9 +2602,10 @@ void QGeoMapItemLODGeometry::selectLOD(unsigned int zoom, double leftBound, bool
 
         enqueueSimplificationTask(  m_verticesLOD.at(0),
                                     m_verticesLOD[requestedLod],
-                                    leftBound,
+                                    significance(leftBound),
                                     zoom,
-                                    m_working);
+                                    m_working,
+                                    m_tasksInFlight);
 
     }
 }
@@ -2047,7 +2619,7 @@ void QGeoMapItemLODGeometry::selectLODOnDataChanged(unsigned int zoom, double le
         m_verticesLOD[1] = QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2>>(
                                 new QVector<QDeclarativeGeoMapItemUtils::vec2>);
         *m_verticesLOD[1] = getSimplified( *m_verticesLOD[0],
-                leftBound,
+                *significance(leftBound),
                 zoomForLOD(0));
     }
     if (lod > 1) {
@@ -2056,9 +2628,10 @@ void QGeoMapItemLODGeometry::selectLODOnDataChanged(unsigned int zoom, double le
                                     new QVector<QDeclarativeGeoMapItemUtils::vec2>);
         enqueueSimplificationTask(  m_verticesLOD.at(0),
                                     m_verticesLOD[lod],
-                leftBound,
+                significance(leftBound),
                 zoom,
-                m_working);
+                m_working,
+                m_tasksInFlight);
     }
     m_screenVertices = m_verticesLOD[qMin<unsigned int>(lod, 1)].data(); // return only 0,1 synchronously
 }
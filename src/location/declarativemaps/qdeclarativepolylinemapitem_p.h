@@ -51,11 +51,15 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativegeomapitembase_p.h>
 #include <QtLocation/private/qgeomapitemgeometry_p.h>
+#include <QtLocation/private/locationvaluetypehelper_p.h>
 
 #include <QtPositioning/QGeoPath>
 #include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qgeostreamsimplifier_p.h>
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
+#include <QtCore/QVector>
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
@@ -84,6 +88,29 @@ private:
     QColor color_;
 };
 
+/*
+    The color and width of the segment starting at a vertex of a line, as
+    drawn by the OpenGLExtruded backend. The width is a factor of the width
+    of the line, a width of 0 leaving the segment to the style of the line.
+    Laid out as the vertex attributes the style is uploaded in.
+*/
+struct Q_LOCATION_PRIVATE_EXPORT MapPolylineVertexStyle
+{
+    quint8 color[4] = { 0, 0, 0, 0 }; // rgba, not premultiplied
+    float width = 0.0f;
+
+    bool isStyled() const { return width > 0.0f; }
+    bool operator==(const MapPolylineVertexStyle &other) const
+    {
+        return width == other.width && std::equal(color, color + 4, other.color);
+    }
+
+    // Styles the count vertices from first, or clears their style if width is not positive.
+    // Returns false if nothing changed.
+    static bool assign(QVector<MapPolylineVertexStyle> &styles, int first, int count,
+                       const QColor &color, qreal width);
+};
+
 class QDeclarativePolylineMapItemPrivate;
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItem : public QDeclarativeGeoMapItemBase
 {
@@ -93,6 +120,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItem : public QDeclarativ
     Q_PROPERTY(QJSValue path READ path WRITE setPath NOTIFY pathChanged)
     Q_PROPERTY(QDeclarativeMapLineProperties *line READ line CONSTANT)
     Q_PROPERTY(Backend backend READ backend WRITE setBackend NOTIFY backendChanged REVISION 15)
+    Q_PROPERTY(qreal simplificationTolerance READ simplificationTolerance WRITE setSimplificationTolerance NOTIFY simplificationToleranceChanged REVISION 15)
 
 public:
     enum Backend {
@@ -120,6 +148,9 @@ public:
     QJSValue path() const;
     virtual void setPath(const QJSValue &value);
     Q_INVOKABLE void setPath(const QGeoPath &path);
+    Q_REVISION(15) Q_INVOKABLE void setSegmentStyle(int first, int count, const QColor &color, qreal width = 1.0);
+    Q_REVISION(15) Q_INVOKABLE void clearSegmentStyles();
+    const QVector<MapPolylineVertexStyle> &segmentStyles() const { return m_segmentStyles; }
 
     bool contains(const QPointF &point) const override;
     const QGeoShape &geoShape() const override;
@@ -130,9 +161,13 @@ public:
     Backend backend() const;
     void setBackend(Backend b);
 
+    qreal simplificationTolerance() const;
+    void setSimplificationTolerance(qreal tolerance);
+
 Q_SIGNALS:
     void pathChanged();
     void backendChanged();
+    Q_REVISION(15) void simplificationToleranceChanged();
 
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
@@ -143,6 +178,8 @@ protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void setPathFromGeoList(const QList<QGeoCoordinate> &path);
     void updatePolish() override;
+    bool hasPendingGeometry() const override;
+    void prepareGeometry() override;
     void componentComplete() override;
     void updateLineStyleParameter(QGeoMapParameter *p, const char *propertyName);
     void updateLineStyleParameter(QGeoMapParameter *p, const char *propertyName, bool update);
@@ -151,9 +188,13 @@ protected:
 public:
 #endif
     QGeoPath m_geopath;
+    QDeclarativePathValueCache m_pathValue;
     QDeclarativeMapLineProperties m_line;
+    QVector<MapPolylineVertexStyle> m_segmentStyles; // per vertex of m_geopath
+    QGeoStreamSimplifier m_simplifier; // of addCoordinate(), reset by the other changes of m_geopath
 
     Backend m_backend = Software;
+    bool m_backendExplicit = false;
     bool m_dirtyMaterial;
     bool m_updatingGeometry;
 
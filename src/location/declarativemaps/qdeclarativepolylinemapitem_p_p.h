@@ -61,7 +61,9 @@
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoCircle>
 #include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qgeopath_p.h>
 #include <QtCore/QScopedValueRollback>
+#include <QtCore/QAtomicInt>
 #include <QSharedPointer>
 #include <array>
 
@@ -83,6 +85,7 @@ public:
     void clearSource();
 
     bool contains(const QPointF &point) const override;
+    qint64 memoryUsage() const override;
 
     QList<QList<QDoubleVector2D> > clipPath(const QGeoMap &map,
                     const QList<QDoubleVector2D> &path,
@@ -219,9 +222,21 @@ public:
     mutable std::array<QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2>>, 7> m_verticesLOD; // fix it to 7,
                                                                              // do not allow simplifications beyond ZL 20. This could actually be limited even further
     mutable QVector<QDeclarativeGeoMapItemUtils::vec2> *m_screenVertices;
+    // The vertices of every LOD are relative to this mercator point, set with LOD 0, so that
+    // their float precision depends on the extent of the line and not on where it is.
+    QDoubleVector2D m_origin;
     mutable QSharedPointer<unsigned int> m_working;
+    // Per vertex of LOD 0, the zoom level from which it is kept. Computed once per source update,
+    // so that switching LOD is a filter rather than a new simplification.
+    mutable QSharedPointer<QVector<quint8>> m_significance;
+    mutable double m_significanceLeftBound = 0.0;
+    // Simplification tasks queued or running on the current LOD pointers.
+    QSharedPointer<QAtomicInt> m_tasksInFlight;
+    // Vertices appended to every LOD without simplification since the last resetLOD().
+    int m_unsimplifiedTail = 0;
 
     QGeoMapItemLODGeometry()
+        : m_tasksInFlight(new QAtomicInt(0))
     {
         resetLOD();
     }
@@ -234,8 +249,13 @@ public:
         for (unsigned int i = 1; i < m_verticesLOD.size(); ++i)
             m_verticesLOD[i] = nullptr; // allocate on first use
         m_screenVertices = m_verticesLOD.front().data(); // resetting pointer to data to be LOD 0
+        m_significance.reset();
+        m_tasksInFlight = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+        m_unsimplifiedTail = 0;
     }
 
+    bool appendVertices(const QVector<QDeclarativeGeoMapItemUtils::vec2> &tail);
+
     static unsigned int zoomToLOD(unsigned int zoom);
 
     static unsigned int zoomForLOD(unsigned int zoom);
@@ -249,11 +269,19 @@ public:
                               double leftBoundWrapped,
                               unsigned int zoom);
 
+    static QVector<QDeclarativeGeoMapItemUtils::vec2> getSimplified (
+            const QVector<QDeclarativeGeoMapItemUtils::vec2> &wrappedPath,
+                              const QVector<quint8> &significance,
+                              unsigned int zoom);
+
+    QSharedPointer<const QVector<quint8>> significance(double leftBound) const;
+
     static void enqueueSimplificationTask(const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &input, // reference as it gets copied in the nested call
                               const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &output,
-                              double leftBound,
+                              const QSharedPointer<const QVector<quint8>> &significance,
                               unsigned int zoom,
-                              QSharedPointer<unsigned int> &working);
+                              QSharedPointer<unsigned int> &working,
+                              const QSharedPointer<QAtomicInt> &tasksInFlight);
 
     void selectLODOnDataChanged(unsigned int zoom, double leftBound) const;
 
@@ -287,16 +315,30 @@ public:
     void updateSourcePoints(const QGeoMap &map,
                             const QGeoPath &poly);
 
+    // Only the given range of a path, without copying it
+    void updateSourcePoints(const QGeoMap &map,
+                            const QGeoPathSlice &slice);
+
     void updateSourcePoints(const QGeoProjectionWebMercator &p,
                             const QList<QDoubleVector2D> &wrappedPath,
                             const QGeoRectangle &boundingRectangle);
 
+    // Extends the source points with the coordinates added to the end of path since the last
+    // update, leaving the rest untouched. Returns false if a full update is needed instead.
+    bool appendSourcePoints(const QGeoMap &map,
+                            const QGeoPath &path);
+
     void updateSourcePoints(const QGeoMap &map,
                             const QGeoRectangle &rect);
 
     void updateSourcePoints(const QGeoMap &map,
                             const QGeoCircle &circle);
 
+    // A mercator path used as it is, with bounds being its mercator bounding box
+    void updateSourcePoints(const QGeoMap &map,
+                            const QList<QDoubleVector2D> &path,
+                            const QRectF &bounds);
+
     void updateScreenPoints(const QGeoMap &map,
                             qreal strokeWidth,
                             bool adjustTranslation = true);
@@ -305,15 +347,28 @@ public:
 
     bool allocateAndFillEntries(QSGGeometry *geom,
                                 bool closed = false,
-                                unsigned int zoom = 0) const;
+                                unsigned int zoom = 0,
+                                bool incremental = false) const;
+    // The two steps of a full allocateAndFillEntries(): selecting the level of detail into
+    // m_screenVertices, false if it is not ready yet, and extruding it into geom.
+    bool selectFillLOD(bool closed, unsigned int zoom) const;
+    void fillEntries(QSGGeometry *geom, bool closed, bool incremental) const;
     void allocateAndFillLineStrip(QSGGeometry *geom,
                                   int lod = 0) const;
 
+    // Takes the styles of the vertices of the source path, count of them from first changed
+    void setVertexStyles(const QVector<MapPolylineVertexStyle> &styles, int first = 0, int count = -1);
+    bool stylesChanged() const { return m_stylesDirtyLast >= 0; }
+    // The vertex of the source path each vertex of m_screenVertices was selected from by the
+    // level of detail, empty only if it is not one of the vertices of level 0.
+    QVector<int> screenVertexSources() const;
+
     bool contains(const QPointF &point) const override
     {
         Q_UNUSED(point)
         return false;
     }
+    qint64 memoryUsage() const override;
 
     static double distanceTo(const QDoubleVector2D &a, const QDoubleVector2D &b, const QDoubleVector2D &p)
     {
@@ -335,16 +390,16 @@ public:
         const QDoubleVector2D pt(point);
         QDoubleVector2D a;
         if (m_screenVertices->size())
-            a = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(m_screenVertices->first().toDoubleVector2D()));
+            a = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(m_screenVertices->first().toDoubleVector2D() + m_origin));
         QDoubleVector2D b;
         for (int i = 1; i < m_screenVertices->size(); ++i)
         {
             if (!a.isFinite()) {
-                a = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(m_screenVertices->at(i).toDoubleVector2D()));
+                a = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(m_screenVertices->at(i).toDoubleVector2D() + m_origin));
                 continue;
             }
 
-            b = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(m_screenVertices->at(i).toDoubleVector2D()));
+            b = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(m_screenVertices->at(i).toDoubleVector2D() + m_origin));
             if (!b.isFinite()) {
                 a = b;
                 continue;
@@ -367,6 +422,22 @@ public:
     QDoubleVector2D m_bboxLeftBoundWrapped;
     QVector<WrappedPolyline> m_wrappedPolygons;
     int m_wrapOffset;
+    // Vertices appended by appendSourcePoints() that no node has been filled with yet.
+    mutable int m_appendedSinceFill = 0;
+    // Length of the path the source points were built from, -1 if they can't be appended to.
+    int m_sourcePathLength = -1;
+    // What the last incremental-capable fill used, to extend it in place.
+    mutable const QVector<QDeclarativeGeoMapItemUtils::vec2> *m_filledLOD = nullptr;
+    mutable int m_filledSegments = 0;
+    // Per vertex of the source path, for the segment starting at it
+    QVector<MapPolylineVertexStyle> m_vertexStyles;
+    // The source vertices restyled since the last fill
+    mutable int m_stylesDirtyFirst = 0;
+    mutable int m_stylesDirtyLast = -1;
+
+protected:
+    void updateWrappedBoundingBoxes(const QGeoProjectionWebMercator &p,
+                                    const QGeoRectangle &boundingRectangle);
 
     friend class QDeclarativeCircleMapItem;
     friend class QDeclarativePolygonMapItem;
@@ -439,10 +510,14 @@ public:
 
     const char *fragmentShader() const override
     {
+        // Coverage fades out over the last pixel on each side of the line
         return
         "varying vec4 primitivecolor;           \n"
+        "varying lowp float edge;               \n"
+        "varying mediump float halfWidth;       \n"
         "void main() {                          \n"
-        "    gl_FragColor = primitivecolor;     \n"
+        "    float coverage = clamp((1.0 - abs(edge)) * halfWidth, 0.0, 1.0); \n"
+        "    gl_FragColor = primitivecolor * coverage; \n"
         "}";
     }
 
@@ -457,16 +532,20 @@ protected:
         m_mapProjection_id = program()->uniformLocation("mapProjection");
         m_center_id = program()->uniformLocation("center");
         m_center_lowpart_id = program()->uniformLocation("center_lowpart");
+        m_origin_id = program()->uniformLocation("origin");
         m_lineWidth_id = program()->uniformLocation("lineWidth");
         m_aspect_id = program()->uniformLocation("aspect");
         m_miter_id = program()->uniformLocation("miter");
         m_wrapOffset_id = program()->uniformLocation("wrapOffset");
+        m_opacity_id = program()->uniformLocation("opacity");
     }
     int m_center_id;
     int m_center_lowpart_id;
+    int m_origin_id;
     int m_mapProjection_id;
     int m_matrix_id;
     int m_color_id;
+    int m_opacity_id;
     int m_lineWidth_id;
     int m_aspect_id;
     int m_miter_id;
@@ -510,10 +589,22 @@ public:
         return m_miter;
     }
 
+    // The center is relative to the origin of the geometry, which gives the camera center back
+    void setOrigin(const QDoubleVector2D &origin)
+    {
+        m_origin = origin;
+    }
+
+    const QDoubleVector2D &origin() const
+    {
+        return m_origin;
+    }
+
     QSGMaterialType *type() const override;
     int compare(const QSGMaterial *other) const override;
 
     int m_miter = 0;
+    QDoubleVector2D m_origin;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT MapPolylineNodeOpenGLExtruded : public MapItemGeometryNode
@@ -527,10 +618,12 @@ public:
          float direction;
          float triangletype; // es2 does not support int attribs
          float vertextype;
+         MapPolylineVertexStyle style; // of the segment
 
          static const char * const *attributeNames()
          {
-             static char const *const attr[] = { "vertex", "previous", "next", "direction", "triangletype", "vertextype", nullptr };
+             static char const *const attr[] = { "vertex", "previous", "next", "direction", "triangletype", "vertextype",
+                                                 "stylecolor", "stylewidth", nullptr };
              return attr;
          }
          static const QSGGeometry::AttributeSet &attributes()
@@ -542,8 +635,10 @@ public:
                  ,QSGGeometry::Attribute::createWithAttributeType(3, 1, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // direction
                  ,QSGGeometry::Attribute::createWithAttributeType(4, 1, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // triangletype
                  ,QSGGeometry::Attribute::createWithAttributeType(5, 1, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // vertextype
+                 ,QSGGeometry::Attribute::createWithAttributeType(6, 4, QSGGeometry::UnsignedByteType, QSGGeometry::ColorAttribute)  // style.color
+                 ,QSGGeometry::Attribute::createWithAttributeType(7, 1, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // style.width
              };
-             static const QSGGeometry::AttributeSet attrsTri = { 6, sizeof(MapPolylineNodeOpenGLExtruded::MapPolylineEntry), dataTri };
+             static const QSGGeometry::AttributeSet attrsTri = { 8, sizeof(MapPolylineNodeOpenGLExtruded::MapPolylineEntry), dataTri };
              return attrsTri;
          }
     } MapPolylineEntry;
@@ -563,8 +658,23 @@ public:
     static const QSGGeometry::AttributeSet &attributesMapPolylineTriangulated();
 
 protected:
+    struct FilledGeometry {
+        const QVector<QDeclarativeGeoMapItemUtils::vec2> *lod;
+        int segments;
+        QSGGeometry *geometry;
+    };
+    // enough to zoom back and forth across a level boundary, each one holding a whole extrusion
+    enum { MaxFilledGeometries = 2 };
+    void dropFilledGeometries();
+    void keepFilledGeometry(const FilledGeometry &filled);
+    QSGGeometry *takeFilledGeometry(const QVector<QDeclarativeGeoMapItemUtils::vec2> *lod, int *segments);
+    QSGGeometry *freeGeometry();
+
     MapPolylineMaterialExtruded fill_material_;
     QSGGeometry m_geometryTriangulating;
+    // Filled with the other levels of detail of the current data, to switch back to without
+    // extruding again, at most MaxFilledGeometries of them. Owned, apart from m_geometryTriangulating.
+    QVector<FilledGeometry> m_filledGeometries;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItemPrivate
@@ -586,7 +696,10 @@ public:
     virtual void onGeoGeometryUpdated() = 0;
     virtual void onItemGeometryChanged() = 0;
     virtual void updatePolish() = 0;
+    virtual bool hasPendingGeometry() const { return false; }
+    virtual void prepareGeometry() {}
     virtual void afterViewportChanged() = 0;
+    virtual void onSegmentStylesChanged(int /*first*/, int /*count*/) {} // drawn by OpenGLExtruded only
     virtual QSGNode * updateMapItemPaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *data) = 0;
     virtual bool contains(const QPointF &point) const = 0;
 
@@ -616,24 +729,15 @@ public:
     void markSourceDirtyAndUpdate() override
     {
         m_geometry.markSourceDirty();
+        m_sourcePrepared = false;
         m_poly.polishAndUpdate();
     }
-    void regenerateCache()
+    // The projection is shared with the copies of the shape, and kept by it across appends
+    QList<QDoubleVector2D> projectedPath() const
     {
         if (!m_poly.map() || m_poly.map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-            return;
-        const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_poly.map()->geoProjection());
-        m_geopathProjected.clear();
-        m_geopathProjected.reserve(m_poly.m_geopath.size());
-        for (const QGeoCoordinate &c : m_poly.m_geopath.path())
-            m_geopathProjected << p.geoToMapProjection(c);
-    }
-    void updateCache()
-    {
-        if (!m_poly.map() || m_poly.map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-            return;
-        const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_poly.map()->geoProjection());
-        m_geopathProjected << p.geoToMapProjection(m_poly.m_geopath.path().last());
+            return QList<QDoubleVector2D>();
+        return QGeoPathPrivate::mercatorVertices(m_poly.m_geopath);
     }
     void preserveGeometry()
     {
@@ -647,18 +751,15 @@ public:
     }
     void onMapSet() override
     {
-        regenerateCache();
         markSourceDirtyAndUpdate();
     }
     void onGeoGeometryChanged() override
     {
-        regenerateCache();
         preserveGeometry();
         markSourceDirtyAndUpdate();
     }
     void onGeoGeometryUpdated() override
     {
-        updateCache();
         preserveGeometry();
         markSourceDirtyAndUpdate();
     }
@@ -668,7 +769,7 @@ public:
     }
     void updatePolish() override
     {
-        if (m_poly.m_geopath.path().length() < 2) { // Possibly cleared
+        if (m_poly.m_geopath.size() < 2) { // Possibly cleared
             m_geometry.clear();
             m_poly.setWidth(0);
             m_poly.setHeight(0);
@@ -680,7 +781,11 @@ public:
         const QGeoMap *map = m_poly.map();
         const qreal borderWidth = m_poly.m_line.width();
 
-        m_geometry.updateSourcePoints(*map, m_geopathProjected, m_poly.m_geopath.boundingGeoRectangle().topLeft());
+        if (QDeclarativeGeoMap *quickMap = m_poly.quickMap())
+            quickMap->prepareItemGeometries(&m_poly);
+        if (!m_sourcePrepared)
+            m_geometry.updateSourcePoints(*map, projectedPath(), m_poly.m_geopath.boundingGeoRectangle().topLeft());
+        m_sourcePrepared = false;
         m_geometry.updateScreenPoints(*map, borderWidth);
 
         m_poly.setWidth(m_geometry.sourceBoundingBox().width() + borderWidth);
@@ -715,9 +820,20 @@ public:
         return m_geometry.contains(point);
     }
 
-    QList<QDoubleVector2D> m_geopathProjected;
+    bool hasPendingGeometry() const override
+    {
+        return !m_sourcePrepared && m_geometry.isSourceDirty() && m_poly.m_geopath.size() >= 2;
+    }
+    void prepareGeometry() override
+    {
+        // Only touches this item's source geometry, which updatePolish() then leaves alone
+        m_geometry.updateSourcePoints(*m_poly.map(), projectedPath(), m_poly.m_geopath.boundingGeoRectangle().topLeft());
+        m_sourcePrepared = true;
+    }
+
     QGeoMapPolylineGeometry m_geometry;
     MapPolylineNode *m_node = nullptr;
+    bool m_sourcePrepared = false; // by prepareGeometry(), for the next updatePolish()
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItemPrivateOpenGLLineStrip: public QDeclarativePolylineMapItemPrivate
@@ -758,8 +874,10 @@ public:
     }
     void onGeoGeometryUpdated() override
     {
+        // Coordinates were only appended: try to extend the geometry in updatePolish.
+        m_appended = true;
         preserveGeometry();
-        markSourceDirtyAndUpdate();
+        m_poly.polishAndUpdate();
     }
     void onItemGeometryChanged() override
     {
@@ -778,7 +896,7 @@ public:
     }
     void updatePolish() override
     {
-        if (m_poly.m_geopath.path().length() == 0) { // Possibly cleared
+        if (m_poly.m_geopath.size() == 0) { // Possibly cleared
             m_geometry.clear();
             m_geometry.clear();
             m_poly.setWidth(0);
@@ -789,6 +907,11 @@ public:
         QScopedValueRollback<bool> rollback(m_poly.m_updatingGeometry);
         m_poly.m_updatingGeometry = true;
         const qreal lineWidth = m_poly.m_line.width();
+        if (m_appended && !m_geometry.isSourceDirty()
+                && !m_geometry.appendSourcePoints(*m_poly.map(), m_poly.m_geopath)) {
+            m_geometry.markSourceDirty();
+        }
+        m_appended = false;
         m_geometry.updateSourcePoints(*m_poly.map(), m_poly.m_geopath);
         m_geometry.markScreenDirty();
         m_geometry.updateScreenPoints(*m_poly.map(), lineWidth);
@@ -827,6 +950,7 @@ public:
 
     QGeoMapPolylineGeometryOpenGL m_geometry;
     MapPolylineNodeOpenGLLineStrip *m_node = nullptr;
+    bool m_appended = false;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItemPrivateOpenGLExtruded: public QDeclarativePolylineMapItemPrivateOpenGLLineStrip
@@ -836,18 +960,35 @@ public:
     QDeclarativePolylineMapItemPrivateOpenGLExtruded(QDeclarativePolylineMapItem &poly)
     : QDeclarativePolylineMapItemPrivateOpenGLLineStrip(poly)
     {
+        m_geometry.setVertexStyles(m_poly.m_segmentStyles);
     }
 
     QDeclarativePolylineMapItemPrivateOpenGLExtruded(QDeclarativePolylineMapItemPrivate &other)
     : QDeclarativePolylineMapItemPrivateOpenGLLineStrip(other)
     {
+        m_geometry.setVertexStyles(m_poly.m_segmentStyles);
     }
 
     ~QDeclarativePolylineMapItemPrivateOpenGLExtruded() override;
 
+    void updatePolish() override;
+    void onSegmentStylesChanged(int first, int count) override
+    {
+        m_geometry.setVertexStyles(m_poly.m_segmentStyles, first, count);
+        m_poly.m_dirtyMaterial = true; // to reach updateMapItemPaintNode(), the source being unchanged
+        m_poly.polishAndUpdate();
+    }
     QSGNode * updateMapItemPaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *data) override
     {
         Q_UNUSED(data);
+        if (m_batched) { // drawn by the batch layer of the map
+            delete oldNode;
+            m_nodeTri = nullptr;
+            m_geometry.setPreserveGeometry(false);
+            m_geometry.markClean();
+            m_poly.m_dirtyMaterial = false;
+            return nullptr;
+        }
         const QGeoMap *map = m_poly.map();
         const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map->geoProjection());
         const QMatrix4x4 &combinedMatrix = p.qsgTransform();
@@ -883,6 +1024,7 @@ public:
     }
 
     MapPolylineNodeOpenGLExtruded *m_nodeTri = nullptr;
+    bool m_batched = false;
 };
 
 QT_END_NAMESPACE
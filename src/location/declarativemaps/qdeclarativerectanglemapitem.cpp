@@ -44,6 +44,7 @@
 #include <QPointF>
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtCore/QScopedValueRollback>
 
@@ -150,6 +151,7 @@ QDeclarativeRectangleMapItem::QDeclarativeRectangleMapItem(QQuickItem *parent)
     QObject::connect(&m_border, SIGNAL(widthChanged(qreal)),
                      this, SLOT(onLinePropertiesChanged()));
     setBackend(mapRectangleBackendSelector->backend);
+    m_backendExplicit = false;
 }
 
 QDeclarativeRectangleMapItem::~QDeclarativeRectangleMapItem()
@@ -161,7 +163,9 @@ QDeclarativeRectangleMapItem::~QDeclarativeRectangleMapItem()
 
     This property holds which backend is in use to render the map item.
     Valid values are \b MapRectangle.Software and \b{MapRectangle.OpenGL}.
-    The default value is \b{MapRectangle.Software}.
+    The default value is \b{MapRectangle.Software}, unless the map plugin prefers
+    the OpenGL backends, as the \l{Qt Location Items Overlay Plugin}{itemsoverlay}
+    plugin does.
 
     \note \b{The release of this API with Qt 5.15 is a Technology Preview}.
     Ideally, as the OpenGL backends for map items mature, there will be
@@ -182,6 +186,7 @@ QDeclarativeRectangleMapItem::Backend QDeclarativeRectangleMapItem::backend() co
 
 void QDeclarativeRectangleMapItem::setBackend(QDeclarativeRectangleMapItem::Backend b)
 {
+    m_backendExplicit = true;
     if (b == m_backend)
         return;
     m_backend = b;
@@ -199,6 +204,16 @@ void QDeclarativeRectangleMapItem::setBackend(QDeclarativeRectangleMapItem::Back
 void QDeclarativeRectangleMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
 {
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
+    // Unless set explicitly, the backend follows the preference of the map,
+    // and returns to the default one when the item leaves it
+    if (!m_backendExplicit) {
+        const Backend fallback = mapRectangleBackendSelector->backend;
+        const Backend backend = (fallback == Software && mapPrefersOpenGLItems()) ? OpenGL : fallback;
+        if (backend != m_backend) {
+            setBackend(backend);
+            m_backendExplicit = false;
+        }
+    }
     if (!map)
         return;
     m_d->onMapSet();
@@ -320,6 +335,7 @@ QSGNode *QDeclarativeRectangleMapItem::updateMapItemPaintNode(QSGNode *oldNode,
 */
 void QDeclarativeRectangleMapItem::updatePolish()
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::ItemPolish);
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     m_d->updatePolish();
@@ -126,6 +126,7 @@ private:
 
     bool m_updatingGeometry;
     Backend m_backend = Software;
+    bool m_backendExplicit = false;
 
     QScopedPointer<QDeclarativeRectangleMapItemPrivate> m_d;
 
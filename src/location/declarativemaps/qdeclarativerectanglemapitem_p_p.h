@@ -306,6 +306,8 @@ public:
             m_borderGeometry.clear();
             m_rect.setWidth(0);
             m_rect.setHeight(0);
+            if (QGeoMapItemBatchLayer *layer = QGeoMapItemBatchLayer::layerFor(&m_rect))
+                layer->removeItem(&m_rect);
             return;
         }
 
@@ -333,12 +335,30 @@ public:
         m_rect.setWidth(geom->sourceBoundingBox().width());
         m_rect.setHeight(geom->sourceBoundingBox().height());
         m_rect.setPosition(1.0 * geom->firstPointOffset() - QPointF(lineWidth * 0.5,lineWidth * 0.5));
+
+        m_batched = false;
+        if (QGeoMapItemBatchLayer *layer = QGeoMapItemBatchLayer::layerFor(&m_rect)) {
+            layer->updateShape(&m_rect, fillColor, m_geometry, lineColor, float(lineWidth), m_borderGeometry);
+            m_batched = true;
+        }
     }
 
     virtual QSGNode * updateMapItemPaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *data) override
     {
         Q_UNUSED(data);
 
+        if (m_batched) { // drawn by the batch layer of the map
+            delete oldNode;
+            m_rootNode = nullptr;
+            m_node = nullptr;
+            m_polylinenode = nullptr;
+            m_geometry.setPreserveGeometry(false);
+            m_geometry.markClean();
+            m_borderGeometry.setPreserveGeometry(false);
+            m_borderGeometry.markClean();
+            return nullptr;
+        }
+
         if (!m_rootNode || !oldNode) {
             m_rootNode = new QDeclarativePolygonMapItemPrivateOpenGL::RootNode();
             m_node = new MapPolygonNodeGL();
@@ -409,6 +429,7 @@ public:
     QDeclarativePolygonMapItemPrivateOpenGL::RootNode *m_rootNode = nullptr;
     MapPolygonNodeGL *m_node = nullptr;
     MapPolylineNodeOpenGLExtruded *m_polylinenode = nullptr;
+    bool m_batched = false;
 };
 
 QT_END_NAMESPACE
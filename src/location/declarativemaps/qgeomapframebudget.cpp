@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeomapframebudget_p.h"
+#include <QtQuick/QQuickWindow>
+
+QT_BEGIN_NAMESPACE
+
+QGeoMapFrameBudget::QGeoMapFrameBudget(const Work &work, QObject *parent)
+    : QObject(parent), m_work(work)
+{
+}
+
+int QGeoMapFrameBudget::budget() const
+{
+    return m_budget;
+}
+
+// 0 for no budget, the work left is done at the next schedule()
+void QGeoMapFrameBudget::setBudget(int msecs)
+{
+    m_budget = qMax(0, msecs);
+}
+
+void QGeoMapFrameBudget::schedule(QQuickWindow *window)
+{
+    if (m_budget <= 0 || !window) {
+        cancel();
+        m_work(QDeadlineTimer(QDeadlineTimer::Forever));
+        return;
+    }
+    if (m_frameConnection && m_window == window)
+        return;
+    cancel();
+    m_window = window;
+    m_frameConnection = connect(window, &QQuickWindow::afterAnimating, this, &QGeoMapFrameBudget::runFrame);
+    window->update();
+}
+
+void QGeoMapFrameBudget::cancel()
+{
+    disconnect(m_frameConnection);
+    m_frameConnection = QMetaObject::Connection();
+    m_window.clear();
+}
+
+void QGeoMapFrameBudget::runFrame()
+{
+    if (m_work(QDeadlineTimer(m_budget))) {
+        if (m_window)
+            m_window->update();
+    } else {
+        cancel();
+    }
+}
+
+QT_END_NAMESPACE
@@ -1,6 +1,6 @@
 /****************************************************************************
 **
-** Copyright (C) 2019 The Qt Company Ltd.
+** Copyright (C) 2020 The Qt Company Ltd.
 ** Contact: https://www.qt.io/licensing/
 **
 ** This file is part of the QtLocation module of the Qt Toolkit.
@@ -37,8 +37,9 @@
 **
 ****************************************************************************/
 
-#ifndef QIOPIPE_P_H
-#define QIOPIPE_P_H
+
+#ifndef QGEOMAPFRAMEBUDGET_P_H
+#define QGEOMAPFRAMEBUDGET_P_H
 
 //
 //  W A R N I N G
@@ -51,63 +52,47 @@
 // We mean it.
 //
 
-#include <QtCore/qiodevice.h>
-#include <QtCore/qbytearray.h>
-#include <QtCore/private/qiodevice_p.h>
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <functional>
 
 QT_BEGIN_NAMESPACE
 
-class QObject;
-class QIOPipePrivate;
-
-class QIOPipe : public QIODevice
+class QQuickWindow;
+
+/*
+    Spreads the creation of the delegates of a map view over the frames of
+    its window, spending at most budget() milliseconds of each frame on it.
+    The work runs after the animations of each frame, and returns whether
+    there is any left for the next one, in which case another frame is
+    requested. With no budget, or no window, the work runs right away with
+    no deadline.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapFrameBudget : public QObject
 {
     Q_OBJECT
-
 public:
-    enum Mode {
-        EndPipe = 0x0000,
-        ProxyPipe = 0x0001
-    };
+    typedef std::function<bool(const QDeadlineTimer &deadline)> Work;
 
-     explicit QIOPipe(QIODevice *parent, Mode mode = EndPipe);
-    ~QIOPipe() override;
+    explicit QGeoMapFrameBudget(const Work &work, QObject *parent = nullptr);
 
-    bool open(OpenMode openMode) override;
-    bool isSequential() const override;
-    void setReadChannelCount(int count);
-    void addChildPipe(QIOPipe *childPipe);
+    int budget() const;
+    void setBudget(int msecs);
 
-protected:
-    qint64 readData(char *data, qint64 maxlen) override;
-    qint64 writeData(const char *data, qint64 len) override;
+    void schedule(QQuickWindow *window);
+    void cancel();
 
 private:
-    Q_DECLARE_PRIVATE(QIOPipe)
-    Q_DISABLE_COPY(QIOPipe)
-};
-
-class QIOPipePrivate : public QIODevicePrivate
-{
-    Q_DECLARE_PUBLIC(QIOPipe)
+    void runFrame();
 
-public:
-    explicit QIOPipePrivate(QIODevice *iodevice, bool proxying);
-    ~QIOPipePrivate() override;
-
-    void initialize();
-    bool readAvailableData();
-    void pumpData(const QByteArray &ba);
-    void pushData(const QByteArray &ba);
-    void _q_onReadyRead();
-    void addChildPipe(QIOPipe *childPipe);
-    void removeChildPipe(QIOPipe *childPipe);
-
-    bool m_proxying = false;
-    QPointer<QIODevice> source;
-    QVector<QPointer<QIOPipe>> childPipes;
+    Work m_work;
+    int m_budget = 0;
+    QPointer<QQuickWindow> m_window;
+    QMetaObject::Connection m_frameConnection;
 };
 
-#endif // QIOPIPE_P_H
-
 QT_END_NAMESPACE
+
+#endif // QGEOMAPFRAMEBUDGET_P_H
@@ -0,0 +1,446 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapitembatchlayer_p.h"
+#include "qdeclarativegeomap_p.h"
+#include "qdeclarativegeomapitembase_p.h"
+#include "qdeclarativepolygonmapitem_p_p.h"
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtQuick/qsgnode.h>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+struct BatchLayerSelector
+{
+    BatchLayerSelector()
+    {
+        enabled = qgetenv("QTLOCATION_BATCHED_ITEMS").toInt();
+    }
+    bool enabled = false;
+};
+
+Q_GLOBAL_STATIC(BatchLayerSelector, mapItemBatchLayerSelector)
+
+QGeoMapItemBatchLayer::QGeoMapItemBatchLayer(QDeclarativeGeoMap *quickMap, QGeoMap *map)
+:   QQuickItem(quickMap), m_map(map),
+    m_strokeEntries(MapPolylineNodeOpenGLExtruded::attributesMapPolylineTriangulated(), 0)
+{
+    setFlag(ItemHasContents);
+    // below the map items, which are painted in the order they were added
+    const QList<QQuickItem *> siblings = quickMap->childItems();
+    if (siblings.first() != this)
+        stackBefore(siblings.first());
+}
+
+QGeoMapItemBatchLayer::~QGeoMapItemBatchLayer()
+{
+}
+
+bool QGeoMapItemBatchLayer::isEnabled()
+{
+    return mapItemBatchLayerSelector->enabled;
+}
+
+QGeoMapItemBatchLayer *QGeoMapItemBatchLayer::layerFor(const QDeclarativeGeoMapItemBase *item)
+{
+    const QDeclarativeGeoMap *quickMap = item->quickMap();
+    const QGeoMap *map = item->map();
+    if (!quickMap || !map || map->supportedMapItemTypes() & item->itemType())
+        return nullptr; // the latter draws the item itself
+    return quickMap->itemBatchLayer();
+}
+
+// opacity is not inherited from the item, as the nodes live in this layer
+qreal QGeoMapItemBatchLayer::effectiveOpacity(const QDeclarativeGeoMapItemBase *item) const
+{
+    return item->opacity() * item->zoomLevelOpacity() * item->mapItemOpacity();
+}
+
+QColor QGeoMapItemBatchLayer::effectiveColor(const QDeclarativeGeoMapItemBase *item,
+                                             const QColor &color) const
+{
+    QColor c = color;
+    c.setAlphaF(c.alphaF() * effectiveOpacity(item));
+    return c;
+}
+
+int QGeoMapItemBatchLayer::fillBatch(const QColor &color)
+{
+    for (int i = 0; i < m_fills.size(); ++i) {
+        if (m_fills.at(i).color == color)
+            return i;
+    }
+    FillBatch batch;
+    batch.color = color;
+    m_fills.append(batch);
+    m_rebuildNodes = true;
+    return m_fills.size() - 1;
+}
+
+int QGeoMapItemBatchLayer::strokeBatch(const QColor &color, float width, bool miter)
+{
+    for (int i = 0; i < m_strokes.size(); ++i) {
+        const StrokeBatch &b = m_strokes.at(i);
+        if (b.color == color && b.width == width && b.miter == miter)
+            return i;
+    }
+    StrokeBatch batch;
+    batch.color = color;
+    batch.width = width;
+    batch.miter = miter;
+    m_strokes.append(batch);
+    m_rebuildNodes = true;
+    return m_strokes.size() - 1;
+}
+
+void QGeoMapItemBatchLayer::eraseFill(RangeTable::iterator range)
+{
+    const Range r = *range;
+    m_fillRanges.erase(range);
+
+    FillBatch &batch = m_fills[r.batch];
+    batch.vertices.remove(r.vertexOffset, r.vertexCount);
+    batch.indices.remove(r.indexOffset, r.indexCount);
+    for (int i = r.indexOffset; i < batch.indices.size(); ++i)
+        batch.indices[i] -= quint32(r.vertexCount);
+    for (Range &other : m_fillRanges) {
+        if (other.batch == r.batch && other.vertexOffset > r.vertexOffset) {
+            other.vertexOffset -= r.vertexCount;
+            other.indexOffset -= r.indexCount;
+        }
+    }
+    batch.dirty = true;
+}
+
+void QGeoMapItemBatchLayer::eraseStroke(RangeTable::iterator range)
+{
+    const Range r = *range;
+    m_strokeRanges.erase(range);
+
+    StrokeBatch &batch = m_strokes[r.batch];
+    batch.vertices.remove(r.vertexOffset, r.vertexCount);
+    for (Range &other : m_strokeRanges) {
+        if (other.batch == r.batch && other.vertexOffset > r.vertexOffset)
+            other.vertexOffset -= r.vertexCount;
+    }
+    batch.dirty = true;
+}
+
+static void qgeomapitembatchlayer_connect(QDeclarativeGeoMapItemBase *item)
+{
+    // batched items are not drawn by the scene graph, so have to be polished
+    // again whenever what the layer inherits from them changes
+    QObject::connect(item, &QQuickItem::visibleChanged, item, &QQuickItem::polish, Qt::UniqueConnection);
+    QObject::connect(item, &QQuickItem::opacityChanged, item, &QQuickItem::polish, Qt::UniqueConnection);
+    QObject::connect(item, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged, item, &QQuickItem::polish,
+                     Qt::UniqueConnection);
+}
+
+void QGeoMapItemBatchLayer::updateFill(QDeclarativeGeoMapItemBase *item, const QColor &color,
+                                       const QGeoMapPolygonGeometryOpenGL &geometry)
+{
+    const QColor c = effectiveColor(item, color);
+    if (!item->isVisible() || c.alpha() == 0 || geometry.m_screenIndices.size() < 3) {
+        removeFill(item);
+        return;
+    }
+    qgeomapitembatchlayer_connect(item);
+    update(); // the camera uniforms change with every polish
+
+    const QVector<QDeclarativeGeoMapItemUtils::vec2> &vertices = geometry.m_screenVertices;
+    const QVector<quint32> &indices = geometry.m_screenIndices;
+    const int wrapOffset = geometry.m_wrapOffset - 1;
+    const int batchIndex = fillBatch(c);
+    const bool dataChanged = geometry.m_dataChanged;
+    geometry.m_dataChanged = false;
+
+    RangeTable::iterator range = m_fillRanges.find(item);
+    if (range != m_fillRanges.end() && range->batch == batchIndex && !dataChanged) {
+        if (range->wrapOffset != wrapOffset) {
+            FillBatch &batch = m_fills[batchIndex];
+            const float shift = float(wrapOffset - range->wrapOffset);
+            for (int i = range->vertexOffset; i < range->vertexOffset + range->vertexCount; ++i)
+                batch.vertices[i].x += shift;
+            range->wrapOffset = wrapOffset;
+            batch.dirty = true;
+        }
+        return;
+    }
+
+    if (range != m_fillRanges.end() && (range->batch != batchIndex
+                                        || range->vertexCount != vertices.size()
+                                        || range->indexCount != indices.size())) {
+        eraseFill(range);
+        range = m_fillRanges.end();
+    }
+    FillBatch &batch = m_fills[batchIndex];
+    if (batch.vertices.isEmpty())
+        batch.origin = geometry.m_origin;
+    if (range == m_fillRanges.end()) {
+        const Range r = { batchIndex, batch.vertices.size(), vertices.size(),
+                          batch.indices.size(), indices.size(), wrapOffset, 1.0 };
+        range = m_fillRanges.insert(item, r);
+        batch.vertices.resize(batch.vertices.size() + vertices.size());
+        batch.indices.resize(batch.indices.size() + indices.size());
+    }
+
+    range->wrapOffset = wrapOffset;
+    // From the origin of the item to the one of the batch, in double before it is added
+    const float dx = float(geometry.m_origin.x() - batch.origin.x() + wrapOffset);
+    const float dy = float(geometry.m_origin.y() - batch.origin.y());
+    QDeclarativeGeoMapItemUtils::vec2 *v = batch.vertices.data() + range->vertexOffset;
+    for (int i = 0; i < vertices.size(); ++i) {
+        v[i].x = vertices.at(i).x + dx;
+        v[i].y = vertices.at(i).y + dy;
+    }
+    quint32 *ix = batch.indices.data() + range->indexOffset;
+    for (int i = 0; i < indices.size(); ++i)
+        ix[i] = indices.at(i) + quint32(range->vertexOffset);
+    batch.dirty = true;
+}
+
+void QGeoMapItemBatchLayer::updateStroke(QDeclarativeGeoMapItemBase *item, const QColor &color,
+                                         float width, Qt::PenCapStyle capStyle,
+                                         const QGeoMapPolylineGeometryOpenGL &geometry,
+                                         bool closed, unsigned int zoom)
+{
+    const QColor c = effectiveColor(item, color);
+    if (!item->isVisible() || ((c.alpha() == 0 || width < 0.5f) && geometry.m_vertexStyles.isEmpty())
+            || geometry.m_screenVertices->size() < 2) {
+        removeStroke(item);
+        return;
+    }
+    qgeomapitembatchlayer_connect(item);
+    update();
+
+    const int wrapOffset = geometry.m_wrapOffset - 1;
+    const int batchIndex = strokeBatch(c, width, capStyle != Qt::FlatCap);
+    const qreal opacity = effectiveOpacity(item); // of the segment styles, baked into their color
+    RangeTable::iterator range = m_strokeRanges.find(item);
+
+    // same conditions as MapPolylineNodeOpenGLExtruded::update()
+    bool refill = geometry.m_dataChanged || geometry.m_appendedSinceFill || geometry.stylesChanged()
+            || !geometry.isLODActive(zoom)
+            || range == m_strokeRanges.end() || range->batch != batchIndex
+            || (!geometry.m_vertexStyles.isEmpty() && range->opacity != opacity);
+    if (refill) {
+        if (geometry.allocateAndFillEntries(&m_strokeEntries, closed, zoom))
+            geometry.m_dataChanged = false;
+        else if (range != m_strokeRanges.end() && range->batch == batchIndex)
+            refill = false; // keep the current level of detail until the new one is ready
+        else
+            return;
+    }
+
+    if (!refill) {
+        if (range->wrapOffset != wrapOffset) {
+            StrokeBatch &batch = m_strokes[batchIndex];
+            const float shift = float(wrapOffset - range->wrapOffset);
+            for (int i = range->vertexOffset; i < range->vertexOffset + range->vertexCount; ++i) {
+                StrokeVertex &e = batch.vertices[i];
+                e.pos.x += shift;
+                e.prev.x += shift;
+                e.next.x += shift;
+            }
+            range->wrapOffset = wrapOffset;
+            batch.dirty = true;
+        }
+        return;
+    }
+
+    const int count = m_strokeEntries.vertexCount();
+    if (range != m_strokeRanges.end() && (range->batch != batchIndex || range->vertexCount != count)) {
+        eraseStroke(range);
+        range = m_strokeRanges.end();
+    }
+    StrokeBatch &batch = m_strokes[batchIndex];
+    if (batch.vertices.isEmpty())
+        batch.origin = geometry.m_origin;
+    if (range == m_strokeRanges.end()) {
+        const Range r = { batchIndex, batch.vertices.size(), count, 0, 0, wrapOffset, opacity };
+        range = m_strokeRanges.insert(item, r);
+        batch.vertices.resize(batch.vertices.size() + count);
+    }
+
+    range->wrapOffset = wrapOffset;
+    range->opacity = opacity;
+    const StrokeVertex *src = static_cast<const StrokeVertex *>(m_strokeEntries.vertexData());
+    StrokeVertex *dst = batch.vertices.data() + range->vertexOffset;
+    const float dx = float(geometry.m_origin.x() - batch.origin.x() + wrapOffset);
+    const float dy = float(geometry.m_origin.y() - batch.origin.y());
+    for (int i = 0; i < count; ++i) {
+        dst[i] = src[i];
+        dst[i].pos.x += dx;
+        dst[i].pos.y += dy;
+        dst[i].prev.x += dx;
+        dst[i].prev.y += dy;
+        dst[i].next.x += dx;
+        dst[i].next.y += dy;
+        if (opacity < 1.0)
+            dst[i].style.color[3] = quint8(qRound(dst[i].style.color[3] * opacity));
+    }
+    batch.dirty = true;
+}
+
+void QGeoMapItemBatchLayer::updateShape(QDeclarativeGeoMapItemBase *item,
+                                        const QColor &fillColor, const QGeoMapPolygonGeometryOpenGL &fill,
+                                        const QColor &borderColor, float borderWidth,
+                                        const QGeoMapPolylineGeometryOpenGL &border, bool closedBorder)
+{
+    updateFill(item, fillColor, fill);
+    if (borderColor.alpha() != 0 && borderWidth > 0)
+        updateStroke(item, borderColor, borderWidth, Qt::SquareCap, border, closedBorder, 30); // no LOD for shapes
+    else
+        removeStroke(item);
+}
+
+void QGeoMapItemBatchLayer::removeFill(const QDeclarativeGeoMapItemBase *item)
+{
+    RangeTable::iterator range = m_fillRanges.find(item);
+    if (range == m_fillRanges.end())
+        return;
+    eraseFill(range);
+    update();
+}
+
+void QGeoMapItemBatchLayer::removeStroke(const QDeclarativeGeoMapItemBase *item)
+{
+    RangeTable::iterator range = m_strokeRanges.find(item);
+    if (range == m_strokeRanges.end())
+        return;
+    eraseStroke(range);
+    update();
+}
+
+void QGeoMapItemBatchLayer::removeItem(const QDeclarativeGeoMapItemBase *item)
+{
+    removeFill(item);
+    removeStroke(item);
+}
+
+QSGNode *QGeoMapItemBatchLayer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    if (!m_map) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    // two children, holding one geometry node per fill and per stroke batch
+    QSGNode *root = oldNode;
+    if (!root || m_rebuildNodes) {
+        delete root;
+        root = new QSGNode;
+        root->appendChildNode(new QSGNode);
+        root->appendChildNode(new QSGNode);
+        for (FillBatch &batch : m_fills) {
+            QSGGeometryNode *node = new QSGGeometryNode;
+            QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0, 0,
+                                                    QSGGeometry::UnsignedIntType);
+            geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+            node->setGeometry(geometry);
+            node->setMaterial(new MapPolygonMaterial);
+            node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+            root->firstChild()->appendChildNode(node);
+            batch.dirty = true;
+        }
+        for (StrokeBatch &batch : m_strokes) {
+            QSGGeometryNode *node = new QSGGeometryNode;
+            QSGGeometry *geometry = new QSGGeometry(MapPolylineNodeOpenGLExtruded::attributesMapPolylineTriangulated(), 0);
+            geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+            node->setGeometry(geometry);
+            node->setMaterial(new MapPolylineMaterialExtruded);
+            node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+            root->lastChild()->appendChildNode(node);
+            batch.dirty = true;
+        }
+        m_rebuildNodes = false;
+    }
+
+    const QGeoProjection &projection = m_map->geoProjection();
+    const QMatrix4x4 &combinedMatrix = projection.qsgTransform();
+    const QDoubleVector3D &cameraCenter = projection.centerMercator();
+
+    QSGNode *fillNodes = root->firstChild();
+    for (int i = 0; i < m_fills.size(); ++i) {
+        FillBatch &batch = m_fills[i];
+        QSGGeometryNode *node = static_cast<QSGGeometryNode *>(fillNodes->childAtIndex(i));
+        if (batch.dirty) {
+            QSGGeometry *geometry = node->geometry();
+            geometry->allocate(batch.vertices.size(), batch.indices.size());
+            std::memcpy(geometry->vertexData(), batch.vertices.constData(),
+                        size_t(batch.vertices.size()) * sizeof(QDeclarativeGeoMapItemUtils::vec2));
+            std::memcpy(geometry->indexDataAsUInt(), batch.indices.constData(),
+                        size_t(batch.indices.size()) * sizeof(quint32));
+            node->markDirty(QSGNode::DirtyGeometry);
+            batch.dirty = false;
+        }
+        MapPolygonMaterial *material = static_cast<MapPolygonMaterial *>(node->material());
+        material->setColor(batch.color);
+        material->setGeoProjection(combinedMatrix);
+        material->setCenter(cameraCenter - QDoubleVector3D(batch.origin));
+        material->setWrapOffset(0);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    QSGNode *strokeNodes = root->lastChild();
+    for (int i = 0; i < m_strokes.size(); ++i) {
+        StrokeBatch &batch = m_strokes[i];
+        QSGGeometryNode *node = static_cast<QSGGeometryNode *>(strokeNodes->childAtIndex(i));
+        if (batch.dirty) {
+            QSGGeometry *geometry = node->geometry();
+            geometry->allocate(batch.vertices.size());
+            std::memcpy(geometry->vertexData(), batch.vertices.constData(),
+                        size_t(batch.vertices.size()) * sizeof(StrokeVertex));
+            node->markDirty(QSGNode::DirtyGeometry);
+            batch.dirty = false;
+        }
+        MapPolylineMaterialExtruded *material = static_cast<MapPolylineMaterialExtruded *>(node->material());
+        material->setColor(batch.color);
+        material->setLineWidth(batch.width);
+        material->setMiter(batch.miter);
+        material->setGeoProjection(combinedMatrix);
+        material->setCenter(cameraCenter - QDoubleVector3D(batch.origin));
+        material->setOrigin(batch.origin);
+        material->setWrapOffset(0);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+    return root;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOMAPITEMBATCHLAYER_P_H
+#define QGEOMAPITEMBATCHLAYER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qdeclarativegeomapitemutils_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QSGGeometry>
+#include <QtGui/QColor>
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QDeclarativeGeoMap;
+class QDeclarativeGeoMapItemBase;
+class QGeoMap;
+class QGeoMapPolygonGeometryOpenGL;
+
+/*
+    Draws the OpenGL backends of many map items through a few shared nodes
+    instead of one node per item. Items are grouped by style: fill color for
+    the fills, color, width and cap for the strokes. Each group keeps the
+    vertices of all its items in one buffer, with a range per item that is
+    rewritten in place while its size stays the same. The wrap offset of each
+    item is added to its vertices, so the only uniforms left are the ones
+    shared by the whole map.
+
+    Enabled with QTLOCATION_BATCHED_ITEMS=1, for items using the OpenGL
+    backends. Batched items are drawn above the map and below the other map
+    items, fills before strokes.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapItemBatchLayer : public QQuickItem
+{
+    Q_OBJECT
+public:
+    QGeoMapItemBatchLayer(QDeclarativeGeoMap *quickMap, QGeoMap *map);
+    ~QGeoMapItemBatchLayer() override;
+
+    static bool isEnabled();
+    // the layer drawing item, nullptr if item draws its own nodes
+    static QGeoMapItemBatchLayer *layerFor(const QDeclarativeGeoMapItemBase *item);
+
+    // to be called from updatePolish(), once the geometries are up to date
+    void updateFill(QDeclarativeGeoMapItemBase *item, const QColor &color,
+                    const QGeoMapPolygonGeometryOpenGL &geometry);
+    void updateStroke(QDeclarativeGeoMapItemBase *item, const QColor &color, float width,
+                      Qt::PenCapStyle capStyle, const QGeoMapPolylineGeometryOpenGL &geometry,
+                      bool closed, unsigned int zoom);
+    // fill plus closed border, as drawn by polygons, rectangles and circles
+    void updateShape(QDeclarativeGeoMapItemBase *item,
+                     const QColor &fillColor, const QGeoMapPolygonGeometryOpenGL &fill,
+                     const QColor &borderColor, float borderWidth,
+                     const QGeoMapPolylineGeometryOpenGL &border, bool closedBorder = true);
+    void removeFill(const QDeclarativeGeoMapItemBase *item);
+    void removeStroke(const QDeclarativeGeoMapItemBase *item);
+    void removeItem(const QDeclarativeGeoMapItemBase *item);
+
+    typedef MapPolylineNodeOpenGLExtruded::MapPolylineEntry StrokeVertex;
+
+    // where the vertices of an item are in its batch
+    struct Range
+    {
+        int batch;
+        int vertexOffset;
+        int vertexCount;
+        int indexOffset;
+        int indexCount;
+        int wrapOffset;
+        qreal opacity; // of the item, when its vertices were copied
+    };
+    typedef QHash<const QDeclarativeGeoMapItemBase *, Range> RangeTable;
+
+    struct FillBatch
+    {
+        QColor color;
+        QDoubleVector2D origin;     // of the vertices, the one of the first item put in the batch
+        QVector<QDeclarativeGeoMapItemUtils::vec2> vertices;
+        QVector<quint32> indices;   // into vertices of the whole batch
+        bool dirty = true;
+    };
+
+    struct StrokeBatch
+    {
+        QColor color;
+        float width;
+        bool miter;
+        QDoubleVector2D origin;     // as for the fills
+        QVector<StrokeVertex> vertices;
+        bool dirty = true;
+    };
+
+    // the batches and where the items are in them, as drawn by the next update
+    const QVector<FillBatch> &fillBatches() const { return m_fills; }
+    const QVector<StrokeBatch> &strokeBatches() const { return m_strokes; }
+    const RangeTable &fillRanges() const { return m_fillRanges; }
+    const RangeTable &strokeRanges() const { return m_strokeRanges; }
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+private:
+    qreal effectiveOpacity(const QDeclarativeGeoMapItemBase *item) const;
+    QColor effectiveColor(const QDeclarativeGeoMapItemBase *item, const QColor &color) const;
+    int fillBatch(const QColor &color);
+    int strokeBatch(const QColor &color, float width, bool miter);
+    void eraseFill(RangeTable::iterator range);
+    void eraseStroke(RangeTable::iterator range);
+
+    QPointer<QGeoMap> m_map;
+    QVector<FillBatch> m_fills;
+    QVector<StrokeBatch> m_strokes;
+    RangeTable m_fillRanges;
+    RangeTable m_strokeRanges;
+    QSGGeometry m_strokeEntries; // filled by the polyline geometry, then copied to its range
+    bool m_rebuildNodes = true;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPITEMBATCHLAYER_P_H
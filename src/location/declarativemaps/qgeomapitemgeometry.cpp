@@ -94,6 +94,15 @@ void QGeoMapItemGeometry::allocateAndFill(QSGGeometry *geom) const
         pts[i].set(vx[i].x(), vx[i].y());
 }
 
+/*!
+    \internal
+*/
+qint64 QGeoMapItemGeometry::memoryUsage() const
+{
+    return arrayBytes(screenVertices_) + arrayBytes(screenIndices_)
+            + qint64(screenOutline_.elementCount()) * qint64(sizeof(QPainterPath::Element));
+}
+
 /*!
     \internal
 */
@@ -49,6 +49,7 @@
 //
 
 #include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
 
 #include <QPainterPath>
 #include <QPointF>
@@ -74,7 +75,8 @@ public:
     inline void markSourceDirty() { sourceDirty_ = true; screenDirty_ = true; }
     inline void markScreenDirty() { screenDirty_ = true; clipToViewport_ = true; }
     inline void markFullScreenDirty() { screenDirty_ = true; clipToViewport_ = false;}
-    inline void markClean() { screenDirty_ = (sourceDirty_ = false); clipToViewport_ = true;}
+    inline void markClean() { screenDirty_ = (sourceDirty_ = false); clipToViewport_ = true;
+                              memory_.setBytes(memoryUsage()); }
     inline void clearScreen() { screenDirty_ = false; }
 
     inline void setPreserveGeometry(bool value, const QGeoCoordinate &geoLeftBound = QGeoCoordinate())
@@ -131,6 +133,9 @@ public:
 
     static QRectF translateToCommonOrigin(const QList<QGeoMapItemGeometry *> &geoms);
 
+    // The bytes held by the arrays of the geometry, accounted each time it is updated
+    virtual qint64 memoryUsage() const;
+
     mutable bool m_dataChanged = false;
 
 private:
@@ -138,6 +143,9 @@ private:
     QGeoMapItemGeometry &operator= (const QGeoMapItemGeometry & other); // Or else it may crash on copy
 
 protected:
+    template <typename T>
+    static qint64 arrayBytes(const QVector<T> &array) { return qint64(array.capacity()) * qint64(sizeof(T)); }
+
     bool sourceDirty_;
     bool screenDirty_;
     bool clipToViewport_;
@@ -155,6 +163,9 @@ protected:
 
     QVector<QPointF> screenVertices_;
     QVector<quint32> screenIndices_;
+
+private:
+    QGeoMapMemoryTracker memory_ { QGeoMapStatistics::ItemGeometry };
 };
 
 QT_END_NAMESPACE
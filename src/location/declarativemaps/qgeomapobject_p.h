@@ -84,6 +84,7 @@ public:
         PolylineType = 5,
         PolygonType = 6,
         IconType = 7,
+        HeatmapType = 8,
         UserType = 0x0100
     };
 
@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeomappathculler_p.h"
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Points per leaf, and children per inner node
+constexpr int leafSize = 64;
+constexpr int fanout = 8;
+
+enum Side {
+    Left = 0x1,
+    Right = 0x2,
+    Top = 0x4,
+    Bottom = 0x8
+};
+
+// Appends points in ring order, collapsing runs whose points share a side they are beyond
+class RunCollapser
+{
+public:
+    explicit RunCollapser(QList<QDoubleVector2D> &points) : m_points(points) {}
+
+    void addInside(const QDoubleVector2D &point)
+    {
+        flush();
+        m_points.append(point);
+    }
+    void addOutside(int sides, const QDoubleVector2D &first, const QDoubleVector2D &last)
+    {
+        if (m_sides & sides) {
+            m_sides &= sides;
+            m_last = last;
+            return;
+        }
+        flush();
+        m_sides = sides;
+        m_first = first;
+        m_last = last;
+    }
+    void flush()
+    {
+        if (!m_sides)
+            return;
+        m_points.append(m_first);
+        if (m_last != m_first)
+            m_points.append(m_last);
+        m_sides = 0;
+    }
+
+private:
+    QList<QDoubleVector2D> &m_points;
+    int m_sides = 0;
+    QDoubleVector2D m_first;
+    QDoubleVector2D m_last;
+};
+
+} // namespace
+
+struct QGeoMapPathCuller::CullState
+{
+    const QList<QDoubleVector2D> &path;
+    const QRectF &clipRect;
+    const std::function<int(double)> &piece;
+    const std::function<double(int)> &offset;
+    RunCollapser runs;
+
+    int sidesOf(const QDoubleVector2D &point) const
+    {
+        return (point.x() < clipRect.left() ? Left : 0)
+                | (point.x() > clipRect.right() ? Right : 0)
+                | (point.y() < clipRect.top() ? Top : 0)
+                | (point.y() > clipRect.bottom() ? Bottom : 0);
+    }
+};
+
+void QGeoMapPathCuller::build(const QList<QDoubleVector2D> &path)
+{
+    clear();
+    m_size = path.size();
+    if (!m_size)
+        return;
+
+    std::vector<Box> leaves((m_size + leafSize - 1) / leafSize);
+    for (int i = 0; i < int(leaves.size()); ++i) {
+        const int first = i * leafSize;
+        const int last = std::min(first + leafSize, m_size);
+        Box box { path.at(first).x(), path.at(first).y(), path.at(first).x(), path.at(first).y() };
+        for (int j = first + 1; j < last; ++j) {
+            const QDoubleVector2D &point = path.at(j);
+            box.minX = std::min(box.minX, point.x());
+            box.minY = std::min(box.minY, point.y());
+            box.maxX = std::max(box.maxX, point.x());
+            box.maxY = std::max(box.maxY, point.y());
+        }
+        leaves[i] = box;
+    }
+    m_levels.push_back(std::move(leaves));
+
+    while (m_levels.back().size() > 1) {
+        const std::vector<Box> &below = m_levels.back();
+        std::vector<Box> above((below.size() + fanout - 1) / fanout);
+        for (int i = 0; i < int(above.size()); ++i) {
+            const int first = i * fanout;
+            const int last = std::min(first + fanout, int(below.size()));
+            Box box = below.at(first);
+            for (int j = first + 1; j < last; ++j) {
+                box.minX = std::min(box.minX, below.at(j).minX);
+                box.minY = std::min(box.minY, below.at(j).minY);
+                box.maxX = std::max(box.maxX, below.at(j).maxX);
+                box.maxY = std::max(box.maxY, below.at(j).maxY);
+            }
+            above[i] = box;
+        }
+        m_levels.push_back(std::move(above));
+    }
+}
+
+void QGeoMapPathCuller::clear()
+{
+    m_levels.clear();
+    m_size = 0;
+}
+
+void QGeoMapPathCuller::cull(const QList<QDoubleVector2D> &path, const QRectF &clipRect,
+                             const std::function<int(double)> &piece,
+                             const std::function<double(int)> &offset,
+                             QList<QDoubleVector2D> &culled) const
+{
+    culled.clear();
+    if (!isBuiltFor(path))
+        return;
+
+    CullState state { path, clipRect, piece, offset, RunCollapser(culled) };
+    const int root = int(m_levels.size()) - 1;
+    int span = leafSize;
+    for (int level = 0; level < root; ++level)
+        span *= fanout;
+    cullNode(root, 0, span, state);
+    state.runs.flush();
+}
+
+/*
+    Hands the points under the node to the collapser, span being the number
+    of points under a full node of its level.
+*/
+void QGeoMapPathCuller::cullNode(int level, int index, int span, CullState &state) const
+{
+    const Box &box = m_levels.at(level).at(index);
+    const int first = index * span;
+    const int last = std::min(first + span, m_size) - 1;
+    const QRectF &clip = state.clipRect;
+
+    // The points of a node within one piece all move by the same offset
+    const int piece = state.piece(box.minX);
+    if (piece == state.piece(box.maxX)) {
+        const QDoubleVector2D shift(state.offset(piece), 0.0);
+        const int sides = (box.maxX + shift.x() < clip.left() ? Left : 0)
+                | (box.minX + shift.x() > clip.right() ? Right : 0)
+                | (box.maxY < clip.top() ? Top : 0)
+                | (box.minY > clip.bottom() ? Bottom : 0);
+        if (sides) {
+            state.runs.addOutside(sides, state.path.at(first) + shift, state.path.at(last) + shift);
+            return;
+        }
+        if (box.minX + shift.x() >= clip.left() && box.maxX + shift.x() <= clip.right()
+                && box.minY >= clip.top() && box.maxY <= clip.bottom()) {
+            for (int i = first; i <= last; ++i)
+                state.runs.addInside(state.path.at(i) + shift);
+            return;
+        }
+    }
+
+    if (level == 0) {
+        for (int i = first; i <= last; ++i) {
+            const QDoubleVector2D &point = state.path.at(i);
+            const QDoubleVector2D wrapped = point + QDoubleVector2D(state.offset(state.piece(point.x())), 0.0);
+            const int sides = state.sidesOf(wrapped);
+            if (sides)
+                state.runs.addOutside(sides, wrapped, wrapped);
+            else
+                state.runs.addInside(wrapped);
+        }
+        return;
+    }
+
+    const int childSpan = span / fanout;
+    const int firstChild = index * fanout;
+    const int lastChild = std::min(firstChild + fanout, int(m_levels.at(level - 1).size()));
+    for (int child = firstChild; child < lastChild; ++child)
+        cullNode(level - 1, child, childSpan, state);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOMAPPATHCULLER_P_H
+#define QGEOMAPPATHCULLER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QList>
+#include <QtCore/QRectF>
+#include <functional>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Bounding box tree over a closed ring in mercator space, used to drop the
+    parts of a huge polygon that lie outside the viewport before clipping it.
+    Consecutive points that are all beyond the same side of the clip
+    rectangle are collapsed to the first and the last of them, which leaves
+    the intersection of the ring with the rectangle unchanged. Whole subtrees
+    are collapsed or copied at once, so most of the ring is never visited.
+
+    The tree is built on the unwrapped path and stays valid as long as
+    the path does, so it is reused across viewport changes. While culling,
+    wrapping is described by piece(x), which has to be a monotonic step
+    function of the unwrapped x, and offset(piece), the x offset added to
+    the points of each piece.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapPathCuller
+{
+public:
+    // below this many points Clipper copes well enough on its own
+    enum { MinimumCulledSize = 4096 };
+
+    void build(const QList<QDoubleVector2D> &path);
+    void clear();
+    bool isBuiltFor(const QList<QDoubleVector2D> &path) const
+    {
+        return !m_levels.empty() && m_size == path.size();
+    }
+
+    void cull(const QList<QDoubleVector2D> &path, const QRectF &clipRect,
+              const std::function<int(double)> &piece,
+              const std::function<double(int)> &offset,
+              QList<QDoubleVector2D> &culled) const;
+
+private:
+    struct CullState;
+    void cullNode(int level, int index, int span, CullState &state) const;
+
+    struct Box {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+    };
+
+    std::vector<std::vector<Box> > m_levels; // leaves first, the root last
+    int m_size = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPPATHCULLER_P_H
@@ -0,0 +1,256 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeomapsnapshotrenderer_p.h"
+#include "qdeclarativegeomap_p.h"
+#include "qdeclarativegeomapitembase_p.h"
+#include "qdeclarativegeoserviceprovider_p.h"
+
+#include <QtLocation/private/qgeotiledmap_p.h>
+#include <QtLocation/private/qgeotilerequestmanager_p.h>
+#include <QtCore/QTimerEvent>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtQuick/QQuickRenderControl>
+#include <QtQuick/QQuickWindow>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QGeoMapSnapshotRenderer renders a map into an image without a visible
+    window, e.g. to make thumbnails on a server. It holds a Map item in an
+    offscreen window driven by a QQuickRenderControl with its own OpenGL
+    context, so several renderers can work side by side in the same thread.
+
+    The renderers, and the maps of the application, using the same \a plugin
+    share its mapping engine and thereby its tile cache. The renderer can be
+    used for any number of renders, one at a time.
+*/
+QGeoMapSnapshotRenderer::QGeoMapSnapshotRenderer(QDeclarativeGeoServiceProvider *plugin,
+                                                 QObject *parent)
+    : QObject(parent),
+      m_renderControl(new QQuickRenderControl(this)),
+      m_window(new QQuickWindow(m_renderControl)),
+      m_context(new QOpenGLContext(this)),
+      m_surface(new QOffscreenSurface),
+      m_map(new QDeclarativeGeoMap(m_window->contentItem()))
+{
+    m_context->setFormat(QSurfaceFormat::defaultFormat());
+    m_context->setShareContext(QOpenGLContext::globalShareContext());
+    m_context->create();
+    m_surface->setFormat(m_context->format());
+    m_surface->create();
+
+    m_context->makeCurrent(m_surface);
+    m_renderControl->initialize(m_context);
+    m_context->doneCurrent();
+
+    connect(m_renderControl, &QQuickRenderControl::renderRequested,
+            this, &QGeoMapSnapshotRenderer::scheduleCheck);
+    connect(m_renderControl, &QQuickRenderControl::sceneChanged,
+            this, &QGeoMapSnapshotRenderer::scheduleCheck);
+    connect(m_map, &QDeclarativeGeoMap::mapReadyChanged, this, [this]() {
+        // Only the tiles of the snapshot are waited for
+        if (QGeoTiledMap *tiledMap = qobject_cast<QGeoTiledMap *>(m_map->map()))
+            tiledMap->setPrefetchStyle(QGeoTiledMap::NoPrefetching);
+        scheduleCheck();
+    });
+
+    QQmlParserStatus *status = m_map;
+    status->classBegin();
+    m_map->setPlugin(plugin);
+    status->componentComplete();
+}
+
+QGeoMapSnapshotRenderer::~QGeoMapSnapshotRenderer()
+{
+    m_context->makeCurrent(m_surface);
+    delete m_map;
+    delete m_window;
+    delete m_renderControl;
+    delete m_fbo;
+    m_context->doneCurrent();
+    delete m_surface;
+}
+
+/*
+    Returns the map item rendered, e.g. to set its map type or parameters.
+*/
+QDeclarativeGeoMap *QGeoMapSnapshotRenderer::map() const
+{
+    return m_map;
+}
+
+/*
+    Sets the time in milliseconds a render waits for the tiles of the map
+    before rendering the tiles it got.
+*/
+void QGeoMapSnapshotRenderer::setTimeout(int msecs)
+{
+    m_timeout = qMax(0, msecs);
+}
+
+int QGeoMapSnapshotRenderer::timeout() const
+{
+    return m_timeout;
+}
+
+bool QGeoMapSnapshotRenderer::isBusy() const
+{
+    return m_busy;
+}
+
+/*
+    Starts rendering the map for \a camera into an image of \a size, with the
+    map \a items on it, which are removed from the map again once done. Emits
+    finished() once all tiles are there or the timeout passed, with \c complete
+    telling which one. Returns false if a render is already in progress or no
+    image can be made of \a size.
+*/
+bool QGeoMapSnapshotRenderer::render(const QGeoCameraData &camera, const QSize &size,
+                                     const QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    if (m_busy || !ensureTarget(size))
+        return false;
+
+    m_busy = true;
+    m_window->resize(size);
+    m_window->contentItem()->setSize(size);
+    m_map->setSize(size);
+
+    m_map->setFieldOfView(camera.fieldOfView());
+    m_map->setZoomLevel(camera.zoomLevel());
+    m_map->setCenter(camera.center());
+    m_map->setBearing(camera.bearing());
+    m_map->setTilt(camera.tilt());
+
+    for (QDeclarativeGeoMapItemBase *item : items) {
+        m_map->addMapItem(item);
+        m_items.append(item);
+    }
+
+    m_timeoutTimer.start(m_timeout, this);
+    scheduleCheck();
+    return true;
+}
+
+void QGeoMapSnapshotRenderer::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timeoutTimer.timerId())
+        return QObject::timerEvent(event);
+
+    if (m_busy)
+        finish(false);
+}
+
+void QGeoMapSnapshotRenderer::scheduleCheck()
+{
+    if (!m_busy || m_checkPending)
+        return;
+    m_checkPending = true;
+    QMetaObject::invokeMethod(this, &QGeoMapSnapshotRenderer::check, Qt::QueuedConnection);
+}
+
+/*
+    Brings the scene up to date, which requests the tiles it needs, and
+    renders it once no tiles are pending anymore.
+*/
+void QGeoMapSnapshotRenderer::check()
+{
+    m_checkPending = false;
+    if (!m_busy || !m_map->mapReady())
+        return;
+
+    m_context->makeCurrent(m_surface);
+    m_renderControl->polishItems();
+    m_renderControl->sync();
+    m_context->doneCurrent();
+
+    if (pendingTileCount() == 0)
+        finish(true);
+}
+
+bool QGeoMapSnapshotRenderer::ensureTarget(const QSize &size)
+{
+    if (size.isEmpty())
+        return false;
+    if (m_fbo && m_fbo->size() == size)
+        return true;
+
+    if (!m_context->makeCurrent(m_surface))
+        return false;
+    delete m_fbo;
+    m_fbo = new QOpenGLFramebufferObject(size, QOpenGLFramebufferObject::CombinedDepthStencil);
+    m_window->setRenderTarget(m_fbo);
+    m_context->doneCurrent();
+    return m_fbo->isValid();
+}
+
+int QGeoMapSnapshotRenderer::pendingTileCount() const
+{
+    QGeoTiledMap *tiledMap = qobject_cast<QGeoTiledMap *>(m_map->map());
+    if (!tiledMap || !tiledMap->requestManager())
+        return 0;
+    return tiledMap->requestManager()->pendingTileCount();
+}
+
+void QGeoMapSnapshotRenderer::finish(bool complete)
+{
+    m_timeoutTimer.stop();
+
+    m_context->makeCurrent(m_surface);
+    m_renderControl->polishItems();
+    m_renderControl->sync();
+    m_renderControl->render();
+    const QImage image = m_fbo->toImage();
+    m_context->doneCurrent();
+
+    for (const QPointer<QDeclarativeGeoMapItemBase> &item : qAsConst(m_items)) {
+        if (item)
+            m_map->removeMapItem(item);
+    }
+    m_items.clear();
+    m_busy = false;
+
+    emit finished(image, complete);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOMAPSNAPSHOTRENDERER_P_H
+#define QGEOMAPSNAPSHOTRENDERER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtCore/QBasicTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSize>
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+class QDeclarativeGeoMap;
+class QDeclarativeGeoMapItemBase;
+class QDeclarativeGeoServiceProvider;
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+class QQuickRenderControl;
+class QQuickWindow;
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapSnapshotRenderer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QGeoMapSnapshotRenderer(QDeclarativeGeoServiceProvider *plugin, QObject *parent = nullptr);
+    ~QGeoMapSnapshotRenderer();
+
+    QDeclarativeGeoMap *map() const;
+
+    void setTimeout(int msecs);
+    int timeout() const;
+
+    bool isBusy() const;
+    bool render(const QGeoCameraData &camera, const QSize &size,
+                const QList<QDeclarativeGeoMapItemBase *> &items = QList<QDeclarativeGeoMapItemBase *>());
+
+Q_SIGNALS:
+    void finished(const QImage &image, bool complete);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private Q_SLOTS:
+    void scheduleCheck();
+    void check();
+
+private:
+    bool ensureTarget(const QSize &size);
+    int pendingTileCount() const;
+    void finish(bool complete);
+
+    QQuickRenderControl *m_renderControl;
+    QQuickWindow *m_window;
+    QOpenGLContext *m_context;
+    QOffscreenSurface *m_surface;
+    QOpenGLFramebufferObject *m_fbo = nullptr;
+    QDeclarativeGeoMap *m_map;
+
+    QList<QPointer<QDeclarativeGeoMapItemBase>> m_items;
+    QBasicTimer m_timeoutTimer;
+    int m_timeout = 10000;
+    bool m_busy = false;
+    bool m_checkPending = false;
+
+    Q_DISABLE_COPY(QGeoMapSnapshotRenderer)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPSNAPSHOTRENDERER_P_H
@@ -0,0 +1,321 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapspatialindex_p.h"
+#include <QtLocation/private/qgeomapobject_p.h>
+#include <QtLocation/private/qdeclarativegeomapitembase_p.h>
+#include <QtCore/qmath.h>
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const double cellWidth = 360.0 / QGeoMapSpatialIndex::GridSize;
+const double cellHeight = 180.0 / QGeoMapSpatialIndex::GridSize;
+const double metersPerDegree = 111319.49; // along a meridian
+const int maxQueryCells = 1024; // beyond this, testing every object is cheaper
+
+int cellColumn(double longitude)
+{
+    return qBound(0, int(std::floor((longitude + 180.0) / cellWidth)),
+                  int(QGeoMapSpatialIndex::GridSize) - 1);
+}
+
+int cellRow(double latitude)
+{
+    return qBound(0, int(std::floor((90.0 - latitude) / cellHeight)),
+                  int(QGeoMapSpatialIndex::GridSize) - 1);
+}
+
+// column may lie outside the grid, when wrapping around the antimeridian
+int cellKey(int column, int row)
+{
+    const int gridSize = QGeoMapSpatialIndex::GridSize;
+    return row * gridSize + ((column % gridSize) + gridSize) % gridSize;
+}
+
+} // anonymous namespace
+
+void QGeoMapSpatialIndex::insert(QObject *obj, qreal lineWidth)
+{
+    noteLineWidth(lineWidth);
+    if (m_entries.contains(obj))
+        return;
+    Entry entry;
+    entry.serial = ++m_serial;
+    if (!m_freeSlots.isEmpty()) {
+        entry.slot = m_freeSlots.takeLast();
+    } else {
+        entry.slot = m_usedSlots++;
+        if (m_usedSlots > m_slots) {
+            // Twice the leaves, the old nodes are rebuilt from them
+            const QVector<QGeoRectangle> old = m_boxTree;
+            const int oldSlots = m_slots;
+            m_slots = qMax(16, m_slots * 2);
+            m_boxTree = QVector<QGeoRectangle>(2 * m_slots);
+            for (int i = 0; i < oldSlots; ++i)
+                m_boxTree[m_slots + i] = old.at(oldSlots + i);
+            for (int i = m_slots - 1; i >= 1; --i)
+                m_boxTree[i] = united(m_boxTree.at(2 * i), m_boxTree.at(2 * i + 1));
+        }
+    }
+    m_entries.insert(obj, entry);
+    m_pending.insert(obj);
+}
+
+void QGeoMapSpatialIndex::remove(QObject *obj)
+{
+    auto it = m_entries.find(obj);
+    if (it == m_entries.end())
+        return;
+    unfileEntry(obj, *it);
+    setSlotBox(it->slot, QGeoRectangle());
+    m_freeSlots.append(it->slot);
+    m_entries.erase(it);
+    m_pending.remove(obj);
+}
+
+void QGeoMapSpatialIndex::markDirty(QObject *obj)
+{
+    if (m_entries.contains(obj))
+        m_pending.insert(obj);
+}
+
+void QGeoMapSpatialIndex::noteLineWidth(qreal width)
+{
+    // The widest line only grows, so that widening queries stays conservative
+    m_maxLineWidth = qMax(m_maxLineWidth, width);
+}
+
+void QGeoMapSpatialIndex::clear()
+{
+    m_entries.clear();
+    m_cells.clear();
+    m_oversized.clear();
+    m_pending.clear();
+    m_boxTree.clear();
+    m_slots = 0;
+    m_usedSlots = 0;
+    m_freeSlots.clear();
+    m_maxLineWidth = 0;
+}
+
+QList<QObject *> QGeoMapSpatialIndex::candidatesAt(const QGeoCoordinate &coordinate,
+                                                   qreal metersPerPixel) const
+{
+    if (!coordinate.isValid())
+        return QList<QObject *>();
+
+    const double radius = qMax(m_maxLineWidth * 0.5 * metersPerPixel, 0.2); // min line radius in QGeoPath
+    const double deltaLatitude = radius / metersPerDegree;
+    const double cosLatitude = std::cos(qDegreesToRadians(coordinate.latitude()));
+    const double deltaLongitude = (cosLatitude > 1e-6) ? deltaLatitude / cosLatitude : 360.0;
+
+    int left = 0;
+    int right = GridSize - 1;
+    if (deltaLongitude < 180.0) {
+        left = int(std::floor((coordinate.longitude() - deltaLongitude + 180.0) / cellWidth));
+        right = int(std::floor((coordinate.longitude() + deltaLongitude + 180.0) / cellWidth));
+    }
+    return collect(left, right,
+                   cellRow(qMin(coordinate.latitude() + deltaLatitude, 90.0)),
+                   cellRow(qMax(coordinate.latitude() - deltaLatitude, -90.0)));
+}
+
+QList<QObject *> QGeoMapSpatialIndex::candidatesIn(const QGeoRectangle &box) const
+{
+    if (!box.isValid())
+        return QList<QObject *>();
+
+    int right = cellColumn(box.bottomRight().longitude());
+    if (box.topLeft().longitude() > box.bottomRight().longitude())
+        right += GridSize; // across the antimeridian
+    return collect(cellColumn(box.topLeft().longitude()), right,
+                   cellRow(box.topLeft().latitude()), cellRow(box.bottomRight().latitude()));
+}
+
+QGeoRectangle QGeoMapSpatialIndex::boundingGeoRectangle() const
+{
+    updatePending();
+    return m_boxTree.size() > 1 ? m_boxTree.at(1) : QGeoRectangle();
+}
+
+QGeoRectangle QGeoMapSpatialIndex::boundingGeoRectangle(const QList<QObject *> &objects) const
+{
+    updatePending();
+    QGeoRectangle res;
+    for (QObject *obj: objects) {
+        const auto entry = m_entries.constFind(obj);
+        if (entry != m_entries.cend())
+            res = united(res, entry->box);
+    }
+    return res;
+}
+
+QGeoShape QGeoMapSpatialIndex::geoShape(const QObject *obj)
+{
+    if (const QGeoMapObject *mapObject = qobject_cast<const QGeoMapObject *>(obj))
+        return mapObject->geoShape();
+    if (const QDeclarativeGeoMapItemBase *item = qobject_cast<const QDeclarativeGeoMapItemBase *>(obj))
+        return item->geoShape();
+    return QGeoShape();
+}
+
+bool QGeoMapSpatialIndex::intersects(const QGeoShape &region, const QGeoRectangle &box)
+{
+    if (!box.isValid() || !region.boundingGeoRectangle().intersects(box))
+        return false;
+    if (region.type() == QGeoShape::RectangleType)
+        return true;
+    if (box.contains(region.center()) || region.contains(box.center()))
+        return true;
+    return region.contains(box.topLeft()) || region.contains(box.topRight())
+            || region.contains(box.bottomLeft()) || region.contains(box.bottomRight());
+}
+
+QList<QObject *> QGeoMapSpatialIndex::collect(int left, int right, int top, int bottom) const
+{
+    updatePending();
+
+    QVector<QPair<quint64, QObject *>> found;
+    auto append = [this, &found](const QVector<QObject *> &objects) {
+        for (QObject *obj: objects)
+            found.append(qMakePair(m_entries.value(obj).serial, obj));
+    };
+
+    if ((right - left + 1) * (bottom - top + 1) > maxQueryCells) {
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+            found.append(qMakePair(it.value().serial, it.key()));
+    } else {
+        append(m_oversized);
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                const auto cell = m_cells.constFind(cellKey(column, row));
+                if (cell != m_cells.cend())
+                    append(*cell);
+            }
+        }
+    }
+
+    // Objects spanning several cells are found once per cell
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    QList<QObject *> res;
+    res.reserve(found.size());
+    for (const auto &candidate: qAsConst(found))
+        res.append(candidate.second);
+    return res;
+}
+
+void QGeoMapSpatialIndex::updatePending() const
+{
+    for (QObject *obj: qAsConst(m_pending)) {
+        Entry &entry = m_entries[obj];
+        unfileEntry(obj, entry);
+        fileEntry(obj, entry);
+    }
+    m_pending.clear();
+}
+
+void QGeoMapSpatialIndex::fileEntry(QObject *obj, Entry &entry) const
+{
+    const QGeoRectangle box = geoShape(obj).boundingGeoRectangle();
+    entry.box = box;
+    setSlotBox(entry.slot, box);
+    if (!box.isValid())
+        return;
+
+    entry.left = cellColumn(box.topLeft().longitude());
+    entry.right = cellColumn(box.bottomRight().longitude());
+    if (box.topLeft().longitude() > box.bottomRight().longitude())
+        entry.right += GridSize; // across the antimeridian
+    entry.top = cellRow(box.topLeft().latitude());
+    entry.bottom = cellRow(box.bottomRight().latitude());
+
+    if ((entry.right - entry.left + 1) * (entry.bottom - entry.top + 1) > MaxObjectCells) {
+        entry.oversized = true;
+        m_oversized.append(obj);
+        return;
+    }
+
+    for (int row = entry.top; row <= entry.bottom; ++row)
+        for (int column = entry.left; column <= entry.right; ++column)
+            m_cells[cellKey(column, row)].append(obj);
+}
+
+void QGeoMapSpatialIndex::unfileEntry(QObject *obj, Entry &entry) const
+{
+    if (entry.oversized) {
+        m_oversized.removeOne(obj);
+    } else {
+        for (int row = entry.top; row <= entry.bottom; ++row) {
+            for (int column = entry.left; column <= entry.right; ++column) {
+                auto cell = m_cells.find(cellKey(column, row));
+                if (cell == m_cells.end())
+                    continue;
+                cell->removeOne(obj);
+                if (cell->isEmpty())
+                    m_cells.erase(cell);
+            }
+        }
+    }
+    entry.left = 0;
+    entry.right = -1;
+    entry.top = 0;
+    entry.bottom = -1;
+    entry.oversized = false;
+}
+
+void QGeoMapSpatialIndex::setSlotBox(int slot, const QGeoRectangle &box) const
+{
+    int node = m_slots + slot;
+    m_boxTree[node] = box;
+    for (node /= 2; node >= 1; node /= 2)
+        m_boxTree[node] = united(m_boxTree.at(2 * node), m_boxTree.at(2 * node + 1));
+}
+
+QGeoRectangle QGeoMapSpatialIndex::united(const QGeoRectangle &a, const QGeoRectangle &b)
+{
+    if (!a.isValid())
+        return b;
+    if (!b.isValid())
+        return a;
+    return a.united(b);
+}
+
+QT_END_NAMESPACE
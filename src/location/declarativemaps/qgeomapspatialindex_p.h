@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOMAPSPATIALINDEX_P_H
+#define QGEOMAPSPATIALINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoRectangle>
+#include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QObject;
+
+/*
+    Uniform grid over the bounding boxes of map items or map objects, in
+    degrees, used to find the ones possibly containing a coordinate or
+    intersecting a region without testing each of them.
+
+    Insertions and geometry changes only queue the object, the bounding
+    boxes are computed and filed on the next query. Objects spanning too
+    many cells are kept in a separate list returned by every query.
+
+    Lines are hit within half their width, in pixels, of the path, so point
+    queries are widened by the widest line seen so far.
+
+    The bounding boxes are also kept in a binary tree of their unions, so
+    that the bounding box of all the objects costs a logarithmic update per
+    changed object instead of a pass over them.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapSpatialIndex
+{
+public:
+    enum { GridSize = 256, MaxObjectCells = 64 };
+
+    // obj is a QGeoMapObject or a QDeclarativeGeoMapItemBase
+    void insert(QObject *obj, qreal lineWidth = 0);
+    void remove(QObject *obj);
+    void markDirty(QObject *obj);
+    void clear();
+    bool isEmpty() const { return m_entries.isEmpty(); }
+
+    // Line widths change without moving the bounding boxes
+    void noteLineWidth(qreal width);
+
+    // Objects whose bounding box, widened by the line widths at
+    // metersPerPixel, may contain coordinate, in insertion order.
+    QList<QObject *> candidatesAt(const QGeoCoordinate &coordinate, qreal metersPerPixel) const;
+    // Objects whose bounding box may intersect box, in insertion order.
+    QList<QObject *> candidatesIn(const QGeoRectangle &box) const;
+
+    // The union of the bounding boxes of all the objects, or of some of them
+    // from the boxes already computed. Invalid if there are none.
+    QGeoRectangle boundingGeoRectangle() const;
+    QGeoRectangle boundingGeoRectangle(const QList<QObject *> &objects) const;
+
+    static QGeoShape geoShape(const QObject *obj);
+    // Approximate test of a region against a bounding box, exact for rectangles
+    static bool intersects(const QGeoShape &region, const QGeoRectangle &box);
+
+private:
+    struct Entry
+    {
+        quint64 serial = 0;
+        int slot = -1;      // leaf in m_boxTree
+        QGeoRectangle box;
+        int left = 0;       // cell columns, right may exceed GridSize across the antimeridian
+        int right = -1;
+        int top = 0;
+        int bottom = -1;
+        bool oversized = false;
+    };
+
+    void updatePending() const;
+    void fileEntry(QObject *obj, Entry &entry) const;
+    void unfileEntry(QObject *obj, Entry &entry) const;
+    QList<QObject *> collect(int left, int right, int top, int bottom) const;
+    void setSlotBox(int slot, const QGeoRectangle &box) const;
+    static QGeoRectangle united(const QGeoRectangle &a, const QGeoRectangle &b);
+
+    mutable QHash<QObject *, Entry> m_entries;
+    mutable QHash<int, QVector<QObject *>> m_cells;
+    mutable QVector<QObject *> m_oversized;
+    mutable QSet<QObject *> m_pending;
+    // Node 1 is the root, node i has the children 2i and 2i + 1, slot s is the node m_slots + s
+    mutable QVector<QGeoRectangle> m_boxTree;
+    int m_slots = 0;
+    int m_usedSlots = 0;
+    QVector<int> m_freeSlots;
+    qreal m_maxLineWidth = 0;
+    quint64 m_serial = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPSPATIALINDEX_P_H
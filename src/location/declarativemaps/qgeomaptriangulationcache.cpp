@@ -0,0 +1,187 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomaptriangulationcache_p.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <earcut.hpp>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Smaller polygons triangulate faster than their file could be opened
+constexpr quint32 minPersistentVertexCount = 512;
+constexpr int defaultMaxCost = 4 * 1024 * 1024; // indices, that is 16MB
+constexpr quint32 fileMagic = 0x51545249; // "QTRI"
+constexpr quint32 fileVersion = 1;
+
+struct TriangulationCacheHolder
+{
+    TriangulationCacheHolder()
+    {
+        cache.setDirectory(QString::fromLocal8Bit(qgetenv("QTLOCATION_TRIANGULATION_CACHE_DIR")));
+    }
+    QGeoMapTriangulationCache cache;
+};
+
+} // namespace
+
+Q_GLOBAL_STATIC(TriangulationCacheHolder, triangulationCache)
+
+QGeoMapTriangulationCache::QGeoMapTriangulationCache()
+{
+    m_entries.setMaxCost(defaultMaxCost);
+}
+
+QGeoMapTriangulationCache *QGeoMapTriangulationCache::instance()
+{
+    return &triangulationCache->cache;
+}
+
+QVector<quint32> QGeoMapTriangulationCache::triangulate(const Polygon &polygon, bool persistent)
+{
+    quint32 vertexCount = 0;
+    for (const auto &ring : polygon)
+        vertexCount += quint32(ring.size());
+
+    const QByteArray key = contentKey(polygon);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const Entry *e = m_entries.object(key)) {
+            if (e->vertexCount == vertexCount)
+                return e->indices;
+        }
+    }
+
+    persistent = persistent && vertexCount >= minPersistentVertexCount && !directory().isEmpty();
+    QVector<quint32> indices;
+    if (!persistent || !readEntry(key, vertexCount, indices)) {
+        const std::vector<quint32> res = qt_mapbox::earcut<quint32>(polygon);
+        indices = QVector<quint32>(res.begin(), res.end());
+        if (persistent)
+            writeEntry(key, vertexCount, indices);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(key, new Entry { vertexCount, indices }, qMax(1, indices.size()));
+    updateMemoryUsage();
+    return indices;
+}
+
+void QGeoMapTriangulationCache::setDirectory(const QString &directory)
+{
+    QMutexLocker locker(&m_mutex);
+    m_directory = directory;
+    if (!m_directory.isEmpty())
+        QDir().mkpath(m_directory);
+}
+
+QString QGeoMapTriangulationCache::directory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_directory;
+}
+
+void QGeoMapTriangulationCache::setMaxCost(int indices)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.setMaxCost(indices);
+    updateMemoryUsage();
+}
+
+void QGeoMapTriangulationCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    updateMemoryUsage();
+}
+
+// With m_mutex locked, the indices of the entries, which make most of them
+void QGeoMapTriangulationCache::updateMemoryUsage()
+{
+    m_memory.setBytes(qint64(m_entries.totalCost()) * qint64(sizeof(quint32)));
+}
+
+QByteArray QGeoMapTriangulationCache::contentKey(const Polygon &polygon)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const auto &ring : polygon) {
+        const quint32 size = quint32(ring.size());
+        hash.addData(reinterpret_cast<const char *>(&size), sizeof(size));
+        hash.addData(reinterpret_cast<const char *>(ring.data()), int(ring.size() * sizeof(Point)));
+    }
+    return hash.result();
+}
+
+bool QGeoMapTriangulationCache::readEntry(const QByteArray &key, quint32 vertexCount, QVector<quint32> &indices) const
+{
+    QFile file(QDir(directory()).filePath(QString::fromLatin1(key.toHex()) + QLatin1String(".tri")));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic, version, storedVertexCount;
+    in >> magic >> version >> storedVertexCount >> indices;
+    if (in.status() != QDataStream::Ok || magic != fileMagic || version != fileVersion
+            || storedVertexCount != vertexCount || indices.size() % 3) {
+        indices.clear();
+        return false;
+    }
+    for (quint32 i : qAsConst(indices)) {
+        if (i >= vertexCount) { // damaged file
+            indices.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void QGeoMapTriangulationCache::writeEntry(const QByteArray &key, quint32 vertexCount, const QVector<quint32> &indices) const
+{
+    QSaveFile file(QDir(directory()).filePath(QString::fromLatin1(key.toHex()) + QLatin1String(".tri")));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream out(&file);
+    out << fileMagic << fileVersion << vertexCount << indices;
+    file.commit();
+}
+
+QT_END_NAMESPACE
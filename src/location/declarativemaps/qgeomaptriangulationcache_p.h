@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOMAPTRIANGULATIONCACHE_P_H
+#define QGEOMAPTRIANGULATIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <array>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Remembers earcut triangulations by the content of the rings they were
+    computed from, so that identical polygons, including ones loaded again
+    later, cost a hash instead of a triangulation. Triangulations are kept in
+    memory, and optionally in files under the directory given by
+    QTLOCATION_TRIANGULATION_CACHE_DIR for rings that are persistent, that is
+    not depending on the viewport. Safe to use from several threads.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapTriangulationCache
+{
+public:
+    using Point = std::array<double, 2>;
+    using Polygon = std::vector<std::vector<Point>>; // outline first, then holes
+
+    QGeoMapTriangulationCache();
+
+    static QGeoMapTriangulationCache *instance();
+
+    // The indices into the vertices of all rings, in order, three per triangle
+    QVector<quint32> triangulate(const Polygon &polygon, bool persistent);
+
+    void setDirectory(const QString &directory);
+    QString directory() const;
+    void setMaxCost(int indices);
+    void clear();
+
+protected:
+    static QByteArray contentKey(const Polygon &polygon);
+    bool readEntry(const QByteArray &key, quint32 vertexCount, QVector<quint32> &indices) const;
+    void writeEntry(const QByteArray &key, quint32 vertexCount, const QVector<quint32> &indices) const;
+    void updateMemoryUsage();
+
+    struct Entry {
+        quint32 vertexCount;
+        QVector<quint32> indices;
+    };
+
+    mutable QMutex m_mutex;
+    QCache<QByteArray, Entry> m_entries; // cost is the number of indices
+    QString m_directory;
+    QGeoMapMemoryTracker m_memory { QGeoMapStatistics::TriangulationCache };
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPTRIANGULATIONCACHE_P_H
@@ -41,9 +41,118 @@
 
 #include "qgeosimplify_p.h"
 #include <QtPositioning/private/qlocationutils_p.h>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+#include <cmath>
 
 QT_BEGIN_NAMESPACE
 
+constexpr quint8 QGeoSimplify::significanceNever;
+
+namespace {
+
+// Ranges are only compared with their own endpoints, so any two of them can be split independently
+struct SimplifyRange {
+    int first;
+    int last;
+};
+
+// Below this many points a range is not worth handing to another thread
+constexpr int minParallelRangeSize = 1 << 14;
+
+/*
+    Marks in kept the points Ramer-Douglas-Peucker keeps strictly between first and last.
+    split(first, last) returns the index to split the range at, or 0 to stop, and has to be
+    safe to call from several threads at once. Walks the ranges with an explicit stack, farming
+    out independent sub-ranges of large inputs to the global thread pool.
+*/
+template <typename Split>
+void markKeptPoints(int first, int last, const Split &split, QVector<char> &kept)
+{
+    char *keep = kept.data();
+    auto run = [&split, keep](QVector<SimplifyRange> &stack) {
+        while (!stack.isEmpty()) {
+            const SimplifyRange r = stack.takeLast();
+            const int index = split(r.first, r.last);
+            if (index <= 0)
+                continue;
+            keep[index] = 1;
+            if (index - r.first > 1)
+                stack.append({ r.first, index });
+            if (r.last - index > 1)
+                stack.append({ index, r.last });
+        }
+    };
+
+    QVector<SimplifyRange> ranges { { first, last } };
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int threads = pool->maxThreadCount();
+    if (last - first < 2 * minParallelRangeSize || threads < 2) {
+        run(ranges);
+        return;
+    }
+
+    // Split breadth first on this thread until there is enough independent work
+    QVector<SimplifyRange> small;
+    int head = 0;
+    while (head < ranges.size() && ranges.size() - head < 4 * threads) {
+        const SimplifyRange r = ranges.at(head++);
+        if (r.last - r.first < minParallelRangeSize) {
+            small.append(r);
+            continue;
+        }
+        const int index = split(r.first, r.last);
+        if (index <= 0)
+            continue;
+        keep[index] = 1;
+        if (index - r.first > 1)
+            ranges.append({ r.first, index });
+        if (r.last - index > 1)
+            ranges.append({ index, r.last });
+    }
+    ranges.remove(0, head);
+    ranges += small;
+
+    QAtomicInt next(0);
+    auto work = [&ranges, &next, &run]() {
+        QVector<SimplifyRange> stack;
+        for (int i = next.fetchAndAddRelaxed(1); i < ranges.size(); i = next.fetchAndAddRelaxed(1)) {
+            stack.append(ranges.at(i));
+            run(stack);
+        }
+    };
+
+    // Only use threads that are free right away, this may itself run on a pool thread
+    QSemaphore done;
+    int helpers = 0;
+    for (int i = 1; i < qMin(threads, ranges.size()); ++i) {
+        QRunnable *task = QRunnable::create([&work, &done]() {
+            work();
+            done.release();
+        });
+        if (!pool->tryStart(task)) {
+            delete task;
+            break;
+        }
+        ++helpers;
+    }
+    work();
+    done.acquire(helpers);
+}
+
+template <typename T>
+void appendKeptPoints(const QList<T> &points, int first, int last, const QVector<char> &kept, QList<T> &simplified)
+{
+    for (int i = first + 1; i < last; ++i) {
+        if (kept.at(i))
+            simplified.append(points.at(i));
+    }
+}
+
+} // namespace
+
 double QGeoSimplify::getDist(const QGeoCoordinate &p1, const QGeoCoordinate &p2)
 {
     return p1.distanceTo(p2);
@@ -100,38 +209,35 @@ double QGeoSimplify::getSegDist(const QDoubleVector2D &p, const QDoubleVector2D
 
 void QGeoSimplify::simplifyDPStep(const QList<QGeoCoordinate> &points, const double &leftBound, int first, int last, double offsetTolerance, QList<QGeoCoordinate> &simplified)
 {
-    double maxDistanceFound = offsetTolerance;
-    int index = 0;
-
-    for (int i = first + 1; i < last; i++) {
-        const double distance = getSegDist(points.at(i),
-                                           points.at(first),
-                                           points.at(last),
-                                           leftBound);
-
-        if (distance > maxDistanceFound) {
-            index = i;
-            maxDistanceFound = distance;
-        }
+    // Same as getSegDist, with the mercator projection of every point done once up front
+    QVector<QDoubleVector2D> mercator(last + 1);
+    for (int i = first; i <= last; ++i) {
+        QDoubleVector2D p = QWebMercator::coordToMercator(points.at(i));
+        if (p.x() < leftBound)
+            p.setX(p.x() + leftBound); // unwrap X
+        mercator[i] = p;
     }
+    const QDoubleVector2D *m = mercator.constData();
+
+    auto split = [&points, m, leftBound, offsetTolerance](int first, int last) {
+        double maxDistanceFound = offsetTolerance;
+        int index = 0;
+        for (int i = first + 1; i < last; i++) {
+            QDoubleVector2D intersection = closestPoint(m[i], m[first], m[last]);
+            if (intersection.x() > 1.0)
+                intersection.setX(intersection.x() - leftBound); // wrap X
+            const double distance = points.at(i).distanceTo(QWebMercator::mercatorToCoord(intersection));
+            if (distance > maxDistanceFound) {
+                index = i;
+                maxDistanceFound = distance;
+            }
+        }
+        return index;
+    };
 
-    if (index > 0) {
-        if (index - first > 1)
-            simplifyDPStep(points,
-                           leftBound,
-                           first,
-                           index,
-                           offsetTolerance,
-                           simplified);
-        simplified.append(points.at(index));
-        if (last - index > 1)
-            simplifyDPStep(points,
-                           leftBound,
-                           index,
-                           last,
-                           offsetTolerance,
-                           simplified);
-    }
+    QVector<char> kept(last + 1, 0);
+    markKeptPoints(first, last, split, kept);
+    appendKeptPoints(points, first, last, kept, simplified);
 }
 
 double QGeoSimplify::getDist(QDoubleVector2D a, QDoubleVector2D b, const double &leftBound)
@@ -151,43 +257,30 @@ void QGeoSimplify::simplifyDPStep(const QList<QDoubleVector2D> &points,
                                   double offsetTolerance,
                                   QList<QDoubleVector2D> &simplified)
 {
-    double maxDistanceFound = offsetTolerance;
-    int index = 0;
-
-    for (int i = first + 1; i < last; i++) {
-        const double distance = getSegDist(points.at(i),
-                                           points.at(first),
-                                           points.at(last),
-                                           leftBound);
-
-        if (distance > maxDistanceFound) {
-            index = i;
-            maxDistanceFound = distance;
+    const QVector<QDoubleVector2D> buffer = points.toVector(); // contiguous, unlike QList
+    const QDoubleVector2D *p = buffer.constData();
+
+    auto split = [p, leftBound, offsetTolerance](int first, int last) {
+        double maxDistanceFound = offsetTolerance;
+        int index = 0;
+        for (int i = first + 1; i < last; i++) {
+            const double distance = getSegDist(p[i], p[first], p[last], leftBound);
+            if (distance > maxDistanceFound) {
+                index = i;
+                maxDistanceFound = distance;
+            }
         }
-    }
+        return index;
+    };
 
-    if (index > 0) {
-        if (index - first > 1)
-            simplifyDPStep(points,
-                           leftBound,
-                           first,
-                           index,
-                           offsetTolerance,
-                           simplified);
-        simplified.append(points.at(index));
-        if (last - index > 1)
-            simplifyDPStep(points,
-                           leftBound,
-                           index,
-                           last,
-                           offsetTolerance,
-                           simplified);
-    }
+    QVector<char> kept(points.size(), 0);
+    markKeptPoints(first, last, split, kept);
+    appendKeptPoints(points, first, last, kept, simplified);
 }
 
 static double pixelDistanceAtZoomAndLatitude(int zoom, double latitude)
 {
-    const double den = double((1 << (zoom + 8)));
+    const double den = std::ldexp(1.0, zoom + 8);
     const double pixelDist = (QLocationUtils::earthMeanCircumference() *
                                 std::cos(QLocationUtils::radians(latitude))) / den;
     return pixelDist;
@@ -207,41 +300,28 @@ void QGeoSimplify::simplifyDPStepZL(const QList<QDoubleVector2D> &points,
                                   int zoomLevel,
                                   QList<QDoubleVector2D> &simplified)
 {
-    const QGeoCoordinate firstC = unwrappedToGeo(points.at(first), leftBound);
-    const QGeoCoordinate lastC = unwrappedToGeo(points.at(last), leftBound);
-    double maxDistanceFound = (pixelDistanceAtZoomAndLatitude(zoomLevel, firstC.latitude())
-                        + pixelDistanceAtZoomAndLatitude(zoomLevel, lastC.latitude())) * 0.5;
-    int index = 0;
-
-    for (int i = first + 1; i < last; i++) {
-        const double distance = getSegDist(points.at(i),
-                                           points.at(first),
-                                           points.at(last),
-                                           leftBound);
-
-        if (distance > maxDistanceFound) {
-            index = i;
-            maxDistanceFound = distance;
+    const QVector<QDoubleVector2D> buffer = points.toVector(); // contiguous, unlike QList
+    const QDoubleVector2D *p = buffer.constData();
+
+    auto split = [p, leftBound, zoomLevel](int first, int last) {
+        const QGeoCoordinate firstC = unwrappedToGeo(p[first], leftBound);
+        const QGeoCoordinate lastC = unwrappedToGeo(p[last], leftBound);
+        double maxDistanceFound = (pixelDistanceAtZoomAndLatitude(zoomLevel, firstC.latitude())
+                            + pixelDistanceAtZoomAndLatitude(zoomLevel, lastC.latitude())) * 0.5;
+        int index = 0;
+        for (int i = first + 1; i < last; i++) {
+            const double distance = getSegDist(p[i], p[first], p[last], leftBound);
+            if (distance > maxDistanceFound) {
+                index = i;
+                maxDistanceFound = distance;
+            }
         }
-    }
+        return index;
+    };
 
-    if (index > 0) {
-        if (index - first > 1)
-            simplifyDPStepZL(points,
-                           leftBound,
-                           first,
-                           index,
-                           zoomLevel,
-                           simplified);
-        simplified.append(points.at(index));
-        if (last - index > 1)
-            simplifyDPStepZL(points,
-                           leftBound,
-                           index,
-                           last,
-                           zoomLevel,
-                           simplified);
-    }
+    QVector<char> kept(points.size(), 0);
+    markKeptPoints(first, last, split, kept);
+    appendKeptPoints(points, first, last, kept, simplified);
 }
 
 QList<QGeoCoordinate> QGeoSimplify::simplifyDouglasPeucker(const QList<QGeoCoordinate> &points,
@@ -308,6 +388,71 @@ QList<QDoubleVector2D> QGeoSimplify::geoSimplifyZL(const QList<QDoubleVector2D>
                                   zoomLevel);
 }
 
+QVector<quint8> QGeoSimplify::zoomLevelSignificance(const QList<QDoubleVector2D> &points,
+                                                 const double &leftBound)
+{
+    // simplifyDPStepZL splits a range at the farthest point whenever that distance exceeds the
+    // tolerance of the range at the given zoom level. The farthest point does not depend on the
+    // zoom level, so one pass with no tolerance visits every split that any zoom level would do,
+    // and each split only has to record the first zoom level at which it happens.
+    QVector<quint8> significance(points.size(), significanceNever);
+    if (points.isEmpty())
+        return significance;
+    significance.first() = 0;
+    significance.last() = 0;
+
+    struct Range {
+        int first;
+        int last;
+        int minZoom; // zoom level at which the range has been created
+    };
+    QVector<Range> stack { { 0, points.size() - 1, 0 } };
+    while (!stack.isEmpty()) {
+        const Range r = stack.takeLast();
+        if (r.last - r.first < 2)
+            continue;
+
+        double maxDistanceFound = 0.0;
+        int index = 0;
+        for (int i = r.first + 1; i < r.last; i++) {
+            const double distance = getSegDist(points.at(i),
+                                               points.at(r.first),
+                                               points.at(r.last),
+                                               leftBound);
+            if (distance > maxDistanceFound) {
+                index = i;
+                maxDistanceFound = distance;
+            }
+        }
+        if (index == 0)
+            continue;
+
+        const double firstLat = unwrappedToGeo(points.at(r.first), leftBound).latitude();
+        const double lastLat = unwrappedToGeo(points.at(r.last), leftBound).latitude();
+        auto tolerance = [firstLat, lastLat](int zoom) {
+            return (pixelDistanceAtZoomAndLatitude(zoom, firstLat)
+                    + pixelDistanceAtZoomAndLatitude(zoom, lastLat)) * 0.5;
+        };
+
+        // Tolerance halves with every zoom level, so start from the closed form and fix up rounding
+        const double ratio = tolerance(0) / maxDistanceFound;
+        int zoom = r.minZoom;
+        if (ratio > 0.0)
+            zoom = qBound(r.minZoom, int(std::floor(std::log2(ratio))) + 1, int(significanceNever));
+        while (zoom > r.minZoom && maxDistanceFound > tolerance(zoom - 1))
+            --zoom;
+        while (zoom < significanceNever && maxDistanceFound <= tolerance(zoom))
+            ++zoom;
+        if (zoom >= significanceNever)
+            continue;
+
+        significance[index] = quint8(zoom);
+        stack.append({ r.first, index, zoom });
+        stack.append({ index, r.last, zoom });
+    }
+    return significance;
+}
+
 
 QT_END_NAMESPACE
 
@@ -51,13 +51,15 @@
 // We mean it.
 //
 
+#include <QtLocation/private/qlocationglobal_p.h>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
-class QGeoSimplify {
+class Q_LOCATION_PRIVATE_EXPORT QGeoSimplify {
 protected:
     // Distance between two points in metres
     static double getDist(const QGeoCoordinate &p1, const QGeoCoordinate &p2);
@@ -140,6 +142,28 @@ public:
     static QList<QDoubleVector2D> geoSimplifyZL(const QList<QDoubleVector2D> &points,
                                    const double &leftBound,
                                    int zoomLevel); // in meters
+
+    // Minimum zoom level at which geoSimplifyZL keeps each point, computed in a single pass.
+    // The endpoints get 0, points that are never kept get significanceNever.
+    static QVector<quint8> zoomLevelSignificance(const QList<QDoubleVector2D> &points,
+                                   const double &leftBound);
+
+    // Same result as geoSimplifyZL, taken from precomputed significance in O(n)
+    template <typename T>
+    static QVector<T> filterByZoomLevel(const QVector<T> &points,
+                                   const QVector<quint8> &significance,
+                                   int zoomLevel)
+    {
+        Q_ASSERT(points.size() == significance.size());
+        QVector<T> res;
+        for (int i = 0; i < points.size(); ++i) {
+            if (int(significance.at(i)) <= zoomLevel)
+                res.append(points.at(i));
+        }
+        return res;
+    }
+
+    static constexpr quint8 significanceNever = 255;
 };
 
 QT_END_NAMESPACE
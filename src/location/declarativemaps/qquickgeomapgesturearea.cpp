@@ -1073,21 +1073,36 @@ void QQuickGeoMapGestureArea::setTouchPointState(const QQuickGeoMapGestureArea::
 void QQuickGeoMapGestureArea::setFlickState(const QQuickGeoMapGestureArea::FlickState state)
 {
     m_flickState = state;
+    updateFramePacing();
 }
 
 void QQuickGeoMapGestureArea::setTiltState(const QQuickGeoMapGestureArea::TiltState state)
 {
     m_tiltState = state;
+    updateFramePacing();
 }
 
 void QQuickGeoMapGestureArea::setRotationState(const QQuickGeoMapGestureArea::RotationState state)
 {
     m_rotationState = state;
+    updateFramePacing();
 }
 
 void QQuickGeoMapGestureArea::setPinchState(const QQuickGeoMapGestureArea::PinchState state)
 {
     m_pinchState = state;
+    updateFramePacing();
+}
+
+/*!
+    \internal
+    While a gesture moves the camera, the map catches up with it once per
+    frame, however many touch events or flick animation steps land in it.
+*/
+void QQuickGeoMapGestureArea::updateFramePacing()
+{
+    if (m_map)
+        m_map->setFramePacing(isActive());
 }
 
 /*!
@@ -1847,6 +1862,10 @@ void QQuickGeoMapGestureArea::startFlick(int dx, int dy, int timeMs)
     m_flick.m_animation->setFrom(animationStartCoordinate);
     m_flick.m_animation->setTo(animationEndCoordinate);
     m_flick.m_animation->start();
+
+    QGeoCameraData target = m_map->cameraData();
+    target.setCenter(animationEndCoordinate);
+    m_map->prefetchTrajectory(target);
 }
 
 void QQuickGeoMapGestureArea::stopPan()
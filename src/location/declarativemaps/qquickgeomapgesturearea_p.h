@@ -391,6 +391,7 @@ private:
     inline void setTiltState(const TiltState state);
     inline void setRotationState(const RotationState state);
     inline void setPinchState(const PinchState state);
+    void updateFramePacing();
 };
 
 QT_END_NAMESPACE
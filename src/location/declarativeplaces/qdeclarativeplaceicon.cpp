@@ -146,6 +146,40 @@ QUrl QDeclarativePlaceIcon::url(const QSize &size) const
     return icon().url(size);
 }
 
+/*!
+    \qmlmethod url Icon::cachedUrl(size size)
+    \since QtLocation 5.15
+
+    Returns the URL of the icon image that most closely matches the given
+    \a size, served from a cache shared by all icons of the application.
+
+    Remote icons are downloaded once and then kept on disk, and decoded for
+    each size they are shown at, so that lists repeating the same category
+    icons do not fetch them again. Icons that are not remote are returned as
+    by \l url().
+
+    \code
+    Image {
+        source: model.icon ? model.icon.cachedUrl(Qt.size(32, 32)) : ""
+        sourceSize: Qt.size(32, 32)
+    }
+    \endcode
+*/
+QUrl QDeclarativePlaceIcon::cachedUrl(const QSize &size) const
+{
+    const QUrl iconUrl = url(size);
+    if (iconUrl.scheme() != QLatin1String("http") && iconUrl.scheme() != QLatin1String("https"))
+        return iconUrl;
+
+    // served by the image provider of the QtLocation QML plugin
+    QUrl cached;
+    cached.setScheme(QStringLiteral("image"));
+    cached.setHost(QStringLiteral("placeicons"));
+    cached.setPath(QLatin1Char('/') + QString::fromLatin1(iconUrl.toEncoded().toBase64(
+            QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals)));
+    return cached;
+}
+
 /*!
     \qmlproperty Object Icon::parameters
 
@@ -78,6 +78,7 @@ public:
     void setIcon(const QPlaceIcon &src);
 
     Q_INVOKABLE QUrl url(const QSize &size = QSize()) const;
+    Q_REVISION(15) Q_INVOKABLE QUrl cachedUrl(const QSize &size = QSize()) const;
 
     QQmlPropertyMap *parameters() const;
 
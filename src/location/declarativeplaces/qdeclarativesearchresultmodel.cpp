@@ -43,6 +43,7 @@
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/QPlaceSearchReply>
 #include <QtLocation/QPlaceManager>
+#include <QtLocation/QPlaceDetailsReply>
 #include <QtLocation/QPlaceMatchRequest>
 #include <QtLocation/QPlaceMatchReply>
 #include <QtLocation/QPlaceResult>
@@ -271,6 +272,28 @@ QT_BEGIN_NAMESPACE
     \since QtLocation 5.12
 */
 
+/*!
+    \qmlproperty bool PlaceSearchModel::prefetch
+
+    This property controls whether the next page of search results is requested
+    when a view showing the model reaches its end.  It only has an effect when
+    \l incremental is true, as the results of the new page are then appended to
+    the model.
+    Default is false.
+
+    \since QtLocation 5.15
+*/
+
+/*!
+    \qmlproperty int PlaceSearchModel::maximumDetailsRequests
+
+    This property holds the number of place detail requests made by
+    \l fetchDetails() that can run at the same time.  Further requests are
+    queued until one of them finishes.
+    Default is 4.
+
+    \since QtLocation 5.15
+*/
 
 /*!
     \qmlmethod void PlaceSearchModel::update()
@@ -353,7 +376,7 @@ QT_BEGIN_NAMESPACE
 */
 
 QDeclarativeSearchResultModel::QDeclarativeSearchResultModel(QObject *parent)
-    :   QDeclarativeSearchModelBase(parent), m_favoritesPlugin(0)
+    :   QDeclarativeSearchModelBase(parent), m_favoritesPlugin(0), m_detailsCache(256)
 {
 }
 
@@ -594,6 +617,22 @@ void QDeclarativeSearchResultModel::setFavoritesMatchParameters(const QVariantMa
     emit favoritesMatchParametersChanged();
 }
 
+int QDeclarativeSearchResultModel::maximumDetailsRequests() const
+{
+    return m_maximumDetailsRequests;
+}
+
+void QDeclarativeSearchResultModel::setMaximumDetailsRequests(int maximum)
+{
+    maximum = qMax(1, maximum);
+    if (m_maximumDetailsRequests == maximum)
+        return;
+
+    m_maximumDetailsRequests = maximum;
+    emit maximumDetailsRequestsChanged();
+    startDetailsRequests();
+}
+
 /*!
     \internal
 */
@@ -604,16 +643,38 @@ int QDeclarativeSearchResultModel::rowCount(const QModelIndex &parent) const
     return m_results.count();
 }
 
+/*!
+    \internal
+    Asked by the views when they reach the last row.
+*/
+bool QDeclarativeSearchResultModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_prefetch && m_incremental && !m_reply && nextPagesAvailable();
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeSearchResultModel::fetchMore(const QModelIndex &parent)
+{
+    if (canFetchMore(parent))
+        nextPage();
+}
+
 void QDeclarativeSearchResultModel::clearData(bool suppressSignal)
 {
     QDeclarativeSearchModelBase::clearData(suppressSignal);
 
+    abortDetailsRequests();
     qDeleteAll(m_places);
     m_places.clear();
+    m_placeRows.clear();
     qDeleteAll(m_icons);
     m_icons.clear();
+    m_favoritePlaces.clear();
     if (!m_results.isEmpty()) {
         m_results.clear();
+        updateMemoryUsage();
 
         if (!suppressSignal)
             emit rowCountChanged();
@@ -622,7 +683,7 @@ void QDeclarativeSearchResultModel::clearData(bool suppressSignal)
 
 QVariant QDeclarativeSearchResultModel::data(const QModelIndex &index, int role) const
 {
-    if (index.row() > m_results.count())
+    if (index.row() < 0 || index.row() >= m_results.count())
         return QVariant();
 
     const QPlaceSearchResult &result = m_results.at(index.row());
@@ -634,7 +695,7 @@ QVariant QDeclarativeSearchResultModel::data(const QModelIndex &index, int role)
     case TitleRole:
         return result.title();
     case IconRole:
-        return QVariant::fromValue(static_cast<QObject *>(m_icons.at(index.row())));
+        return QVariant::fromValue(static_cast<QObject *>(iconAt(index.row())));
     case DistanceRole:
         if (result.type() == QPlaceSearchResult::PlaceResult) {
             QPlaceResult placeResult = result;
@@ -643,7 +704,7 @@ QVariant QDeclarativeSearchResultModel::data(const QModelIndex &index, int role)
         break;
     case PlaceRole:
         if (result.type() == QPlaceSearchResult::PlaceResult)
-            return QVariant::fromValue(static_cast<QObject *>(m_places.at(index.row())));
+            return QVariant::fromValue(static_cast<QObject *>(placeAt(index.row())));
         break;
     case SponsoredRole:
         if (result.type() == QPlaceSearchResult::PlaceResult) {
@@ -697,6 +758,84 @@ void QDeclarativeSearchResultModel::updateWith(int proposedSearchIndex)
     update();
 }
 
+/*!
+    \qmlmethod void PlaceSearchModel::fetchDetails(int index)
+
+    Fetches the details of the place at \a index, as \l {Place::getDetails()}{getDetails()}
+    would.  At most \l maximumDetailsRequests places are fetched at the same time, the others
+    wait for their turn.  The fetched details are kept, so that the place of a later search
+    result for the same place has them right away.
+
+    This method is meant to be called by the delegates of a view as they are created, with
+    \l cancelDetails() called as they are destroyed, so that only the places in view are
+    fetched:
+
+    \code
+    ListView {
+        model: searchModel
+        delegate: Text {
+            text: title
+            Component.onCompleted: searchModel.fetchDetails(index)
+            Component.onDestruction: searchModel.cancelDetails(index)
+        }
+    }
+    \endcode
+
+    If \a index does not reference a PlaceResult, or its details were fetched already, this
+    method does nothing.
+
+    \since QtLocation 5.15
+*/
+void QDeclarativeSearchResultModel::fetchDetails(int index)
+{
+    if (index < 0 || index >= m_results.count())
+        return;
+
+    QDeclarativePlace *place = placeAt(index);
+    if (!place || place->detailsFetched() || place->placeId().isEmpty())
+        return;
+
+    if (const QPlace *cached = m_detailsCache.object(place->placeId())) {
+        place->setPlace(*cached);
+        return;
+    }
+
+    const QString placeId = place->placeId();
+    if (m_detailsQueue.contains(placeId) || m_detailsReplies.key(placeId))
+        return;
+
+    m_detailsQueue.append(placeId);
+    startDetailsRequests();
+}
+
+/*!
+    \qmlmethod void PlaceSearchModel::cancelDetails(int index)
+
+    Cancels the fetching of the details of the place at \a index started with
+    \l fetchDetails(), whether it is waiting for its turn or being fetched.
+
+    \since QtLocation 5.15
+*/
+void QDeclarativeSearchResultModel::cancelDetails(int index)
+{
+    if (index < 0 || index >= m_results.count()
+            || m_results.at(index).type() != QPlaceSearchResult::PlaceResult) {
+        return;
+    }
+
+    const QString placeId = QPlaceResult(m_results.at(index)).place().placeId();
+    if (m_detailsQueue.removeAll(placeId))
+        return;
+
+    if (QPlaceReply *reply = m_detailsReplies.key(placeId)) {
+        m_detailsReplies.remove(reply);
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+        startDetailsRequests();
+    }
+}
+
 QPlaceReply *QDeclarativeSearchResultModel::sendQuery(QPlaceManager *manager,
                                                       const QPlaceSearchRequest &request)
 {
@@ -722,6 +861,10 @@ void QDeclarativeSearchResultModel::initializePlugin(QDeclarativeGeoServiceProvi
         }
     }
 
+    // the requests and the places fetched belong to the old plugin
+    abortDetailsRequests();
+    m_detailsCache.clear();
+
     //connect to the manager of the new plugin.
     if (plugin) {
         QGeoServiceProvider *serviceProvider = plugin->sharedGeoServiceProvider();
@@ -899,27 +1042,24 @@ void QDeclarativeSearchResultModel::updateLayout(const QList<QPlace> &favoritePl
     }
 
     m_resultsBuffer.clear();
+    // The favorites were matched for the results added by this update only
+    const bool matchedFavorites = favoritePlaces.count() == m_results.count() - start;
     for (int i = start; i < m_results.count(); ++i) {
         const QPlaceSearchResult &result = m_results.at(i);
 
         if (result.type() == QPlaceSearchResult::PlaceResult) {
-            QPlaceResult placeResult = result;
-            QDeclarativePlace *place = new QDeclarativePlace(placeResult.place(), plugin(), this);
-            m_places.append(place);
-
-            if ((favoritePlaces.count() == m_results.count()) && favoritePlaces.at(i) != QPlace())
-                m_places[i]->setFavorite(new QDeclarativePlace(favoritePlaces.at(i),
-                                                               m_favoritesPlugin, m_places[i]));
-        } else if (result.type() == QPlaceSearchResult::ProposedSearchResult) {
-            m_places.append(0);
+            const QString placeId = QPlaceResult(result).place().placeId();
+            if (!placeId.isEmpty() && !m_placeRows.contains(placeId))
+                m_placeRows.insert(placeId, i);
         }
 
-        QDeclarativePlaceIcon *icon = 0;
-        if (!result.icon().isEmpty())
-            icon = new QDeclarativePlaceIcon(result.icon(), plugin(), this);
-        m_icons.append(icon);
+        m_places.append(0);
+        m_icons.append(0);
+        m_favoritePlaces.append(matchedFavorites ? favoritePlaces.at(i - start) : QPlace());
     }
 
+    updateMemoryUsage();
+
     if (m_incremental)
         endInsertRows();
     else
@@ -928,17 +1068,38 @@ void QDeclarativeSearchResultModel::updateLayout(const QList<QPlace> &favoritePl
         emit rowCountChanged();
 }
 
+/*!
+    \internal
+    Estimates the memory the results take, from their texts and the shared
+    data of a result and of its place, of a few hundred bytes.
+*/
+void QDeclarativeSearchResultModel::updateMemoryUsage()
+{
+    static const qint64 resultBytes = 256;
+    qint64 bytes = 0;
+    for (const QPlaceSearchResult &result : qAsConst(m_results)) {
+        qint64 chars = result.title().size();
+        if (result.type() == QPlaceSearchResult::PlaceResult) {
+            const QPlace place = QPlaceResult(result).place();
+            chars += place.name().size() + place.placeId().size() + place.attribution().size();
+        }
+        bytes += resultBytes + chars * qint64(sizeof(QChar));
+    }
+    m_memory.setBytes(bytes);
+}
+
 /*!
     \internal
 */
 void QDeclarativeSearchResultModel::placeUpdated(const QString &placeId)
 {
-    int row = getRow(placeId);
-    if (row < 0 || row > m_places.count())
-        return;
+    // the rows whose place is not made yet get the new details when it is
+    m_detailsCache.remove(placeId);
 
-    if (m_places.at(row))
-        m_places.at(row)->getDetails();
+    for (int row = getRow(placeId); row >= 0 && row < m_places.count(); ++row) {
+        if (m_places.at(row) && m_places.at(row)->placeId() == placeId)
+            m_places.at(row)->getDetails();
+    }
 }
 
 /*!
@@ -947,19 +1108,63 @@ void QDeclarativeSearchResultModel::placeUpdated(const QString &placeId)
 void QDeclarativeSearchResultModel::placeRemoved(const QString &placeId)
 {
     int row = getRow(placeId);
-    if (row < 0 || row > m_places.count())
+    if (row < 0 || row >= m_places.count())
         return;
 
     beginRemoveRows(QModelIndex(), row, row);
     delete m_places.at(row);
     m_places.removeAt(row);
+    delete m_icons.at(row);
+    m_icons.removeAt(row);
+    m_favoritePlaces.removeAt(row);
     m_results.removeAt(row);
     removePageRow(row);
+    updateMemoryUsage();
+
+    m_placeRows.remove(placeId);
+    for (auto i = m_placeRows.begin(), end = m_placeRows.end(); i != end; ++i) {
+        if (i.value() > row)
+            --i.value();
+    }
+    // a later result may have the same place
+    for (int i = row; i < m_results.count(); ++i) {
+        if (m_results.at(i).type() == QPlaceSearchResult::PlaceResult
+                && QPlaceResult(m_results.at(i)).place().placeId() == placeId) {
+            m_placeRows.insert(placeId, i);
+            break;
+        }
+    }
     endRemoveRows();
 
+    m_detailsCache.remove(placeId);
     emit rowCountChanged();
 }
 
+/*!
+    \internal
+*/
+void QDeclarativeSearchResultModel::detailsFinished()
+{
+    QPlaceDetailsReply *reply = qobject_cast<QPlaceDetailsReply *>(sender());
+    if (!reply || !m_detailsReplies.contains(reply))
+        return;
+
+    const QString placeId = m_detailsReplies.take(reply);
+    reply->deleteLater();
+
+    if (reply->error() == QPlaceReply::NoError) {
+        m_detailsCache.insert(placeId, new QPlace(reply->place()));
+
+        // the place can be in several rows, from the first one on
+        for (int row = getRow(placeId); row >= 0 && row < m_places.count(); ++row) {
+            if (m_places.at(row) && m_places.at(row)->placeId() == placeId)
+                m_places.at(row)->setPlace(reply->place());
+        }
+    }
+
+    startDetailsRequests();
+}
+
 QList<QPlaceSearchResult> QDeclarativeSearchResultModel::resultsFromPages() const
 {
     QList<QPlaceSearchResult> res;
@@ -983,17 +1188,88 @@ void QDeclarativeSearchResultModel::removePageRow(int row)
 
 /*!
     \internal
+    Sends the queued detail requests, as many as the requests running allow.
 */
-int QDeclarativeSearchResultModel::getRow(const QString &placeId) const
+void QDeclarativeSearchResultModel::startDetailsRequests()
 {
-    for (int i = 0; i < m_places.count(); ++i) {
-        if (!m_places.at(i))
+    if (m_detailsQueue.isEmpty() || !plugin())
+        return;
+
+    QGeoServiceProvider *serviceProvider = plugin()->sharedGeoServiceProvider();
+    QPlaceManager *placeManager = serviceProvider ? serviceProvider->placeManager() : nullptr;
+    if (!placeManager)
+        return;
+
+    while (!m_detailsQueue.isEmpty() && m_detailsReplies.count() < m_maximumDetailsRequests) {
+        const QString placeId = m_detailsQueue.takeFirst();
+        QPlaceDetailsReply *reply = placeManager->getPlaceDetails(placeId);
+        if (!reply)
             continue;
-        else if (m_places.at(i)->placeId() == placeId)
-            return i;
+
+        reply->setParent(this);
+        m_detailsReplies.insert(reply, placeId);
+        connect(reply, SIGNAL(finished()), this, SLOT(detailsFinished()));
     }
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeSearchResultModel::abortDetailsRequests()
+{
+    m_detailsQueue.clear();
+    for (auto i = m_detailsReplies.cbegin(), end = m_detailsReplies.cend(); i != end; ++i) {
+        QPlaceReply *reply = i.key();
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+    m_detailsReplies.clear();
+}
+
+/*!
+    \internal
+*/
+int QDeclarativeSearchResultModel::getRow(const QString &placeId) const
+{
+    return m_placeRows.value(placeId, -1);
+}
+
+/*!
+    \internal
+    Returns the place of the result at \a row, making it on first use as most
+    results of a page are never shown.
+*/
+QDeclarativePlace *QDeclarativeSearchResultModel::placeAt(int row) const
+{
+    const QPlaceSearchResult &result = m_results.at(row);
+    if (m_places.at(row) || result.type() != QPlaceSearchResult::PlaceResult)
+        return m_places.at(row);
+
+    QDeclarativeSearchResultModel *self = const_cast<QDeclarativeSearchResultModel *>(this);
+    const QPlace resultPlace = QPlaceResult(result).place();
+    const QPlace *cached = m_detailsCache.object(resultPlace.placeId());
+    QDeclarativePlace *place = new QDeclarativePlace(cached ? *cached : resultPlace, plugin(), self);
+    if (m_favoritePlaces.at(row) != QPlace()) {
+        place->setFavorite(new QDeclarativePlace(m_favoritePlaces.at(row), m_favoritesPlugin,
+                                                 place));
+    }
+    m_places[row] = place;
+    return place;
+}
+
+/*!
+    \internal
+*/
+QDeclarativePlaceIcon *QDeclarativeSearchResultModel::iconAt(int row) const
+{
+    const QPlaceSearchResult &result = m_results.at(row);
+    if (m_icons.at(row) || result.icon().isEmpty())
+        return m_icons.at(row);
 
-    return -1;
+    QDeclarativeSearchResultModel *self = const_cast<QDeclarativeSearchResultModel *>(this);
+    m_icons[row] = new QDeclarativePlaceIcon(result.icon(), plugin(), self);
+    return m_icons.at(row);
 }
 
 /*!
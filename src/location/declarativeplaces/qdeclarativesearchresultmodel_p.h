@@ -53,6 +53,9 @@
 #include <QtLocation/private/qdeclarativecategory_p.h>
 #include <QtLocation/private/qdeclarativeplace_p.h>
 #include <QtLocation/private/qdeclarativeplaceicon_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
+
+#include <QtCore/QCache>
 
 QT_BEGIN_NAMESPACE
 
@@ -73,6 +76,8 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeSearchResultModel : public QDeclarat
     Q_PROPERTY(QVariantMap favoritesMatchParameters READ favoritesMatchParameters WRITE setFavoritesMatchParameters NOTIFY favoritesMatchParametersChanged)
 
     Q_PROPERTY(bool incremental MEMBER m_incremental NOTIFY incrementalChanged REVISION 12)
+    Q_PROPERTY(bool prefetch MEMBER m_prefetch NOTIFY prefetchChanged REVISION 15)
+    Q_PROPERTY(int maximumDetailsRequests READ maximumDetailsRequests WRITE setMaximumDetailsRequests NOTIFY maximumDetailsRequestsChanged REVISION 15)
 
     Q_ENUMS(SearchResultType RelevanceHint)
 
@@ -117,7 +122,12 @@ public:
     QVariantMap favoritesMatchParameters() const;
     void setFavoritesMatchParameters(const QVariantMap &parameters);
 
+    int maximumDetailsRequests() const;
+    void setMaximumDetailsRequests(int maximum);
+
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
     virtual void clearData(bool suppressSignal = false) override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -125,6 +135,8 @@ public:
     QHash<int, QByteArray> roleNames() const override;
 
     Q_INVOKABLE void updateWith(int proposedSearchIndex);
+    Q_REVISION(15) Q_INVOKABLE void fetchDetails(int index);
+    Q_REVISION(15) Q_INVOKABLE void cancelDetails(int index);
 
     void updateSearchRequest();
 
@@ -140,6 +152,8 @@ Q_SIGNALS:
     void favoritesMatchParametersChanged();
     void dataChanged();
     void incrementalChanged();
+    Q_REVISION(15) void prefetchChanged();
+    Q_REVISION(15) void maximumDetailsRequestsChanged();
 
 protected:
     QPlaceReply *sendQuery(QPlaceManager *manager, const QPlaceSearchRequest &request) override;
@@ -154,6 +168,7 @@ private Q_SLOTS:
 
     void placeUpdated(const QString &placeId);
     void placeRemoved(const QString &placeId);
+    void detailsFinished();
 
 private:
     enum Roles {
@@ -166,8 +181,13 @@ private:
     };
 
     int getRow(const QString &placeId) const;
+    QDeclarativePlace *placeAt(int row) const;
+    QDeclarativePlaceIcon *iconAt(int row) const;
     QList<QPlaceSearchResult> resultsFromPages() const;
     void removePageRow(int row);
+    void startDetailsRequests();
+    void abortDetailsRequests();
+    void updateMemoryUsage();
 
     QList<QDeclarativeCategory *> m_categories;
     QLocation::VisibilityScope m_visibilityScope;
@@ -175,12 +195,24 @@ private:
     QMap<int, QList<QPlaceSearchResult>> m_pages;
     QList<QPlaceSearchResult> m_results;
     QList<QPlaceSearchResult> m_resultsBuffer;
-    QList<QDeclarativePlace *> m_places;
-    QList<QDeclarativePlaceIcon *> m_icons;
+    // the place and icon objects of a row are made when first asked for
+    mutable QList<QDeclarativePlace *> m_places;
+    mutable QList<QDeclarativePlaceIcon *> m_icons;
+    QList<QPlace> m_favoritePlaces;
+    QHash<QString, int> m_placeRows; // first row of each place id in m_results
 
     QDeclarativeGeoServiceProvider *m_favoritesPlugin;
     QVariantMap m_matchParameters;
     bool m_incremental = false;
+    bool m_prefetch = false;
+
+    // the detail requests of the rows asked for, at most m_maximumDetailsRequests
+    // at a time, and the fetched places kept for when a row is shown again
+    QStringList m_detailsQueue;
+    QHash<QPlaceReply *, QString> m_detailsReplies;
+    QCache<QString, QPlace> m_detailsCache;
+    int m_maximumDetailsRequests = 4;
+    QGeoMapMemoryTracker m_memory { QGeoMapStatistics::PlaceResults };
 };
 
 QT_END_NAMESPACE
@@ -42,9 +42,30 @@
 
 #include <qplacemanager.h>
 #include <qplacesearchrequest.h>
+#include <qplacesearchsuggestionreply.h>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+const int cachedTerms = 32;
+
+// Answers a query from the suggestions cached by the model
+class QPlaceSearchSuggestionReplyCached : public QPlaceSearchSuggestionReply
+{
+public:
+    QPlaceSearchSuggestionReplyCached(const QStringList &suggestions, QObject *parent)
+    :   QPlaceSearchSuggestionReply(parent)
+    {
+        setSuggestions(suggestions);
+        setFinished(true);
+        // the model connects to the reply after receiving it
+        QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+    }
+};
+
+} // namespace
+
 /*!
     \qmltype PlaceSearchSuggestionModel
     \instantiates QDeclarativeSearchSuggestionModel
@@ -91,6 +112,16 @@ QT_BEGIN_NAMESPACE
     \codeline
     \snippet declarative/places.qml SearchSuggestionModel
 
+    When \l autoUpdate is set, the model updates itself once the \l searchTerm has not changed for
+    \l updateDelay milliseconds, so that typing a word sends a single query rather than one for
+    each keystroke. Changing the \l searchTerm always cancels a query still in progress for the
+    previous term.
+
+    The suggestions received for the recent search terms are kept by the model, and a query for
+    one of these terms is answered without contacting the \l plugin. When the plugin returned
+    fewer suggestions than the \l limit for a term, and all of them started with that term, the
+    suggestions for a longer term starting with it are also taken from these.
+
     \sa PlaceSearchModel, {QPlaceManager}
 */
 
@@ -219,8 +250,11 @@ QT_BEGIN_NAMESPACE
 */
 
 QDeclarativeSearchSuggestionModel::QDeclarativeSearchSuggestionModel(QObject *parent)
-:   QDeclarativeSearchModelBase(parent)
+:   QDeclarativeSearchModelBase(parent), m_cache(cachedTerms)
 {
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(300);
+    connect(&m_updateTimer, &QTimer::timeout, this, &QDeclarativeSearchModelBase::update);
 }
 
 QDeclarativeSearchSuggestionModel::~QDeclarativeSearchSuggestionModel()
@@ -244,6 +278,60 @@ void QDeclarativeSearchSuggestionModel::setSearchTerm(const QString &searchTerm)
 
     m_request.setSearchTerm(searchTerm);
     emit searchTermChanged();
+
+    // the suggestions for the previous term are of no use any more
+    if (m_reply)
+        cancel();
+    if (m_autoUpdate)
+        m_updateTimer.start();
+}
+
+/*!
+    \qmlproperty bool PlaceSearchSuggestionModel::autoUpdate
+
+    This property holds whether the model updates itself when the \l searchTerm changes. The
+    update is made once the term has not changed for \l updateDelay milliseconds. The default
+    value is false.
+
+    \since QtLocation 5.15
+*/
+bool QDeclarativeSearchSuggestionModel::autoUpdate() const
+{
+    return m_autoUpdate;
+}
+
+void QDeclarativeSearchSuggestionModel::setAutoUpdate(bool autoUpdate)
+{
+    if (m_autoUpdate == autoUpdate)
+        return;
+
+    m_autoUpdate = autoUpdate;
+    if (!m_autoUpdate)
+        m_updateTimer.stop();
+    emit autoUpdateChanged();
+}
+
+/*!
+    \qmlproperty int PlaceSearchSuggestionModel::updateDelay
+
+    This property holds the time in milliseconds the \l searchTerm has to stay unchanged before
+    the model updates itself, when \l autoUpdate is set. The default value is 300.
+
+    \since QtLocation 5.15
+*/
+int QDeclarativeSearchSuggestionModel::updateDelay() const
+{
+    return m_updateTimer.interval();
+}
+
+void QDeclarativeSearchSuggestionModel::setUpdateDelay(int delay)
+{
+    delay = qMax(0, delay);
+    if (m_updateTimer.interval() == delay)
+        return;
+
+    m_updateTimer.setInterval(delay);
+    emit updateDelayChanged();
 }
 
 /*!
@@ -327,6 +415,15 @@ void QDeclarativeSearchSuggestionModel::queryFinished()
     QPlaceSearchSuggestionReply *suggestionReply = qobject_cast<QPlaceSearchSuggestionReply *>(reply);
     m_suggestions = suggestionReply->suggestions();
 
+    if (suggestionReply->error() == QPlaceReply::NoError) {
+        const QString &searchTerm = m_replyRequest.searchTerm();
+        const int limit = m_replyRequest.limit();
+        bool complete = limit > 0 && m_suggestions.count() < limit;
+        for (int i = 0; complete && i < m_suggestions.count(); ++i)
+            complete = m_suggestions.at(i).startsWith(searchTerm, Qt::CaseInsensitive);
+        cacheSuggestions(searchTerm, m_suggestions, complete);
+    }
+
     if (initialCount != m_suggestions.count())
         emit suggestionsChanged();
 
@@ -347,7 +444,65 @@ void QDeclarativeSearchSuggestionModel::queryFinished()
 QPlaceReply *QDeclarativeSearchSuggestionModel::sendQuery(QPlaceManager *manager,
                                                         const QPlaceSearchRequest &request)
 {
+    // suggestions are cached for the terms of otherwise identical requests
+    QPlaceSearchRequest cacheRequest = request;
+    cacheRequest.setSearchTerm(QString());
+    if (manager != m_cacheManager || !(cacheRequest == m_cacheRequest)) {
+        m_cache.clear();
+        m_cacheRequest = cacheRequest;
+        m_cacheManager = manager;
+    }
+
+    m_replyRequest = request;
+
+    QStringList suggestions;
+    if (cachedSuggestions(request.searchTerm(), &suggestions))
+        return new QPlaceSearchSuggestionReplyCached(suggestions, this);
+
     return manager->searchSuggestions(request);
 }
 
+/*!
+    \internal
+
+    Looks up the suggestions for \a searchTerm, either cached for the term itself or filtered
+    from the complete suggestions of a prefix of it.
+*/
+bool QDeclarativeSearchSuggestionModel::cachedSuggestions(const QString &searchTerm,
+                                                          QStringList *suggestions) const
+{
+    if (const CacheEntry *entry = m_cache.object(searchTerm)) {
+        *suggestions = entry->suggestions;
+        return true;
+    }
+
+    for (int length = searchTerm.length() - 1; length > 0; --length) {
+        const CacheEntry *entry = m_cache.object(searchTerm.left(length));
+        if (!entry || !entry->complete)
+            continue;
+
+        suggestions->clear();
+        for (const QString &suggestion : entry->suggestions) {
+            if (suggestion.startsWith(searchTerm, Qt::CaseInsensitive))
+                suggestions->append(suggestion);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeSearchSuggestionModel::cacheSuggestions(const QString &searchTerm,
+                                                         const QStringList &suggestions,
+                                                         bool complete)
+{
+    CacheEntry *entry = new CacheEntry;
+    entry->suggestions = suggestions;
+    entry->complete = complete;
+    m_cache.insert(searchTerm, entry);
+}
+
 QT_END_NAMESPACE
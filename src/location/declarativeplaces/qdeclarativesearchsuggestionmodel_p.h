@@ -51,12 +51,16 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativesearchmodelbase_p.h>
 
+#include <QtCore/QCache>
+#include <QtCore/QPointer>
 #include <QtCore/QStringList>
+#include <QtCore/QTimer>
 
 QT_BEGIN_NAMESPACE
 
 class QDeclarativeGeoServiceProvider;
 class QGeoServiceProvider;
+class QPlaceManager;
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeSearchSuggestionModel : public QDeclarativeSearchModelBase
 {
@@ -64,6 +68,8 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeSearchSuggestionModel : public QDecl
 
     Q_PROPERTY(QString searchTerm READ searchTerm WRITE setSearchTerm NOTIFY searchTermChanged)
     Q_PROPERTY(QStringList suggestions READ suggestions NOTIFY suggestionsChanged)
+    Q_PROPERTY(bool autoUpdate READ autoUpdate WRITE setAutoUpdate NOTIFY autoUpdateChanged REVISION 15)
+    Q_PROPERTY(int updateDelay READ updateDelay WRITE setUpdateDelay NOTIFY updateDelayChanged REVISION 15)
 
 public:
     explicit QDeclarativeSearchSuggestionModel(QObject *parent = 0);
@@ -74,6 +80,12 @@ public:
 
     QStringList suggestions() const;
 
+    bool autoUpdate() const;
+    void setAutoUpdate(bool autoUpdate);
+
+    int updateDelay() const;
+    void setUpdateDelay(int delay);
+
     void clearData(bool suppressSignal = false);
 
     // From QAbstractListModel
@@ -91,12 +103,30 @@ protected Q_SLOTS:
 Q_SIGNALS:
     void searchTermChanged();
     void suggestionsChanged();
+    Q_REVISION(15) void autoUpdateChanged();
+    Q_REVISION(15) void updateDelayChanged();
 
 protected:
     QPlaceReply *sendQuery(QPlaceManager *manager, const QPlaceSearchRequest &request);
 
 private:
+    struct CacheEntry
+    {
+        QStringList suggestions;
+        bool complete = false; // holds every suggestion starting with the term
+    };
+
+    bool cachedSuggestions(const QString &searchTerm, QStringList *suggestions) const;
+    void cacheSuggestions(const QString &searchTerm, const QStringList &suggestions, bool complete);
+
     QStringList m_suggestions;
+    bool m_autoUpdate = false;
+    QTimer m_updateTimer;
+
+    QCache<QString, CacheEntry> m_cache;
+    QPlaceSearchRequest m_cacheRequest; // the request of the cached terms, without its term
+    QPointer<QPlaceManager> m_cacheManager;
+    QPlaceSearchRequest m_replyRequest;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,1356 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qdeclarativegeomapmarkerlayer_p.h"
+#include <QtLocation/private/qdeclarativegeomap_p.h>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtQml/QQmlFile>
+#include <QtQml/QQmlInfo>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGMaterial>
+#include <QtQuick/QSGTexture>
+#include <QtQuick/private/qsgmaterialshader_p.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype MapMarkerLayer
+    \instantiates QDeclarativeGeoMapMarkerLayer
+    \inqmlmodule Qt.labs.location
+    \ingroup qml-QtLocation5-maps
+    \inherits QtQuick::Item
+
+    \brief The MapMarkerLayer type displays a large number of icons on a Map.
+
+    The MapMarkerLayer draws one icon for each row of a \l model, at the
+    coordinate found in its \l coordinateRole. Unlike a MapQuickItem per
+    marker, all the markers are drawn through a single geometry node, and are
+    projected by the GPU: moving the camera changes only the projection uniforms,
+    while the markers are uploaded again only when the model changes. Rows that
+    change through the \c dataChanged signal of the model are rewritten in place.
+
+    The icons are taken from a single image, \l iconSource, where they are laid
+    out side by side as squares as high as the image. The \l iconRole of a row
+    selects its icon, starting with 0 for the leftmost one.
+
+    The layer requires the OpenGL scene graph backend.
+
+    \section2 Clustering
+
+    When \l clusterRadius is set, the markers are grouped in square cells of
+    about this size on the screen, and the markers of a cell are drawn as a
+    single icon, \l clusterIcon, at their center. The clusters are computed once for each integer zoom level, up to
+    zoom level 20, on a worker thread, and the clusters of a level are merges of
+    those of the level above it: zooming in splits a cluster in place into
+    parts of it. Beyond zoom level 20 all the markers are drawn. Until the
+    clusters of a model are ready, the layer keeps drawing the previous ones,
+    or the markers.
+
+    \section2 Tracking
+
+    Moving markers, such as vehicles, are better given as fixes with addFix()
+    than by changing their coordinates in the model. The layer then moves all
+    of them on their trajectories once per frame, in a single pass, instead of
+    animating each marker through the model.
+
+    \section2 Example Usage
+
+    \code
+    Map {
+        MapMarkerLayer {
+            id: vehicles
+            model: vehicleModel
+            iconSource: "vehicles.png"
+            anchorPoint: Qt.point(iconSize.width / 2, iconSize.height)
+
+            MouseArea {
+                anchors.fill: parent
+                onClicked: console.log("vehicle", vehicles.markerAt(Qt.point(mouse.x, mouse.y)))
+            }
+        }
+    }
+    \endcode
+
+    Mouse presses are only delivered to the children of the layer when they
+    land on a marker.
+*/
+
+namespace {
+
+const double MaxTrackBlendTime = 1000; // milliseconds
+
+// Interleaves the bits of the cell column and row, so that the cells of a
+// zoom level share the key of its finest cells shifted by two bits a level.
+quint64 cellKey(quint32 column, quint32 row)
+{
+    auto spread = [](quint64 v) {
+        v = (v | (v << 16)) & Q_UINT64_C(0x0000ffff0000ffff);
+        v = (v | (v << 8)) & Q_UINT64_C(0x00ff00ff00ff00ff);
+        v = (v | (v << 4)) & Q_UINT64_C(0x0f0f0f0f0f0f0f0f);
+        v = (v | (v << 2)) & Q_UINT64_C(0x3333333333333333);
+        v = (v | (v << 1)) & Q_UINT64_C(0x5555555555555555);
+        return v;
+    };
+    return spread(column) | (spread(row) << 1);
+}
+
+struct MarkerVertex
+{
+    float x, y, xLow, yLow; // mercator position, split in two floats
+    float cornerX, cornerY;
+    float u, v;
+};
+
+const QSGGeometry::AttributeSet &markerAttributes()
+{
+    static const QSGGeometry::Attribute data[] = {
+        QSGGeometry::Attribute::createWithAttributeType(0, 4, QSGGeometry::FloatType, QSGGeometry::PositionAttribute),
+        QSGGeometry::Attribute::createWithAttributeType(1, 2, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute),
+        QSGGeometry::Attribute::createWithAttributeType(2, 2, QSGGeometry::FloatType, QSGGeometry::TexCoordAttribute)
+    };
+    static const QSGGeometry::AttributeSet attrs = { 3, sizeof(MarkerVertex), data };
+    return attrs;
+}
+
+class MapMarkerMaterial : public QSGMaterial
+{
+public:
+    MapMarkerMaterial()
+    {
+        setFlag(Blending);
+    }
+    ~MapMarkerMaterial() override
+    {
+        delete m_texture;
+    }
+
+    QSGMaterialShader *createShader() const override;
+    QSGMaterialType *type() const override
+    {
+        static QSGMaterialType type;
+        return &type;
+    }
+    int compare(const QSGMaterial *other) const override
+    {
+        const MapMarkerMaterial *o = static_cast<const MapMarkerMaterial *>(other);
+        if (o->m_texture == m_texture)
+            return 0;
+        return m_texture < o->m_texture ? -1 : 1;
+    }
+
+    void setTexture(QSGTexture *texture)
+    {
+        delete m_texture;
+        m_texture = texture;
+    }
+
+    QSGTexture *m_texture = nullptr;
+    QMatrix4x4 m_geoProjection;
+    QDoubleVector3D m_center;
+    QVector2D m_iconSize;
+    QVector2D m_anchor;
+};
+
+// Expands every marker to a screen aligned quad, as an instanced draw would,
+// after projecting its position with the map transformation.
+class MapMarkerShader : public QSGMaterialShader
+{
+public:
+    MapMarkerShader() : QSGMaterialShader(*new QSGMaterialShaderPrivate) { }
+
+    const char *vertexShader() const override {
+        return
+        "attribute highp vec4 vertex;               \n"
+        "attribute highp vec2 corner;               \n"
+        "attribute highp vec2 texCoord;             \n"
+        "uniform highp mat4 qt_Matrix;              \n"
+        "uniform highp mat4 mapProjection;          \n"
+        "uniform highp vec3 center;                 \n"
+        "uniform highp vec3 center_lowpart;         \n"
+        "uniform highp vec2 iconSize;               \n"
+        "uniform highp vec2 anchor;                 \n"
+        "varying highp vec2 uv;                     \n"
+        "void main() {                              \n"
+        "    vec2 d = (vertex.xy - center.xy) + (vertex.zw - center_lowpart.xy);\n"
+        "    d.x = d.x - floor(d.x + 0.5);          \n" // the copy of the world closest to the center
+        "    vec4 p = mapProjection * vec4(d, 0.0, 1.0);\n"
+        "    uv = texCoord;                         \n"
+        "    if (p.w <= 0.0) {                      \n" // behind the camera
+        "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+        "        return;                            \n"
+        "    }                                      \n"
+        "    vec2 pos = p.xy / p.w + corner * iconSize - anchor;\n"
+        "    gl_Position = qt_Matrix * vec4(pos, 0.0, 1.0);\n"
+        "}";
+    }
+
+    const char *fragmentShader() const override {
+        return
+        "uniform sampler2D icons;                   \n"
+        "uniform lowp float opacity;                \n"
+        "varying highp vec2 uv;                     \n"
+        "void main() {                              \n"
+        "    gl_FragColor = texture2D(icons, uv) * opacity;\n"
+        "}";
+    }
+
+    char const *const *attributeNames() const override
+    {
+        static char const *const attr[] = { "vertex", "corner", "texCoord", nullptr };
+        return attr;
+    }
+
+    void updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *) override
+    {
+        MapMarkerMaterial *material = static_cast<MapMarkerMaterial *>(newEffect);
+
+        if (state.isMatrixDirty())
+            program()->setUniformValue(m_matrix_id, state.projectionMatrix());
+        if (state.isOpacityDirty())
+            program()->setUniformValue(m_opacity_id, state.opacity());
+
+        QVector3D vecCenter, vecCenter_lowpart;
+        for (int i = 0; i < 3; i++)
+            QLocationUtils::split_double(material->m_center.get(i), &vecCenter[i], &vecCenter_lowpart[i]);
+        program()->setUniformValue(m_mapProjection_id, material->m_geoProjection);
+        program()->setUniformValue(m_center_id, vecCenter);
+        program()->setUniformValue(m_center_lowpart_id, vecCenter_lowpart);
+        program()->setUniformValue(m_iconSize_id, material->m_iconSize);
+        program()->setUniformValue(m_anchor_id, material->m_anchor);
+
+        if (material->m_texture)
+            material->m_texture->bind();
+    }
+
+private:
+    void initialize() override
+    {
+        m_matrix_id = program()->uniformLocation("qt_Matrix");
+        m_opacity_id = program()->uniformLocation("opacity");
+        m_mapProjection_id = program()->uniformLocation("mapProjection");
+        m_center_id = program()->uniformLocation("center");
+        m_center_lowpart_id = program()->uniformLocation("center_lowpart");
+        m_iconSize_id = program()->uniformLocation("iconSize");
+        m_anchor_id = program()->uniformLocation("anchor");
+        program()->setUniformValue(program()->uniformLocation("icons"), 0);
+    }
+
+    int m_matrix_id;
+    int m_opacity_id;
+    int m_mapProjection_id;
+    int m_center_id;
+    int m_center_lowpart_id;
+    int m_iconSize_id;
+    int m_anchor_id;
+};
+
+QSGMaterialShader *MapMarkerMaterial::createShader() const
+{
+    return new MapMarkerShader();
+}
+
+} // namespace
+
+struct QDeclarativeGeoMapMarkerLayer::ClusterIndex
+{
+    qreal radius;
+    QVector<QVector<ClusterNode>> levels; // zoom levels 0 to MaxClusterZoom, then the markers
+};
+
+QDeclarativeGeoMapMarkerLayer::QDeclarativeGeoMapMarkerLayer(QQuickItem *parent)
+:   QDeclarativeGeoMapItemBase(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+QDeclarativeGeoMapMarkerLayer::~QDeclarativeGeoMapMarkerLayer()
+{
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapMarkerLayer::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
+{
+    QDeclarativeGeoMapItemBase::setMap(quickMap, map);
+    if (map) {
+        updateSize();
+        updateClusterLevel();
+    }
+}
+
+/*!
+    \qmlproperty model MapMarkerLayer::model
+
+    This property holds the model providing the markers, one per row.
+*/
+QAbstractItemModel *QDeclarativeGeoMapMarkerLayer::model() const
+{
+    return m_model;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setModel(QAbstractItemModel *model)
+{
+    if (m_model == model)
+        return;
+    if (m_model)
+        m_model->disconnect(this);
+
+    m_model = model;
+    if (m_model) {
+        connect(m_model.data(), &QAbstractItemModel::modelReset, this, &QDeclarativeGeoMapMarkerLayer::resetMarkers);
+        connect(m_model.data(), &QAbstractItemModel::layoutChanged, this, &QDeclarativeGeoMapMarkerLayer::resetMarkers);
+        connect(m_model.data(), &QAbstractItemModel::rowsInserted, this, &QDeclarativeGeoMapMarkerLayer::onRowsInserted);
+        connect(m_model.data(), &QAbstractItemModel::rowsRemoved, this, &QDeclarativeGeoMapMarkerLayer::onRowsRemoved);
+        connect(m_model.data(), &QAbstractItemModel::rowsMoved, this, &QDeclarativeGeoMapMarkerLayer::onRowsMoved);
+        connect(m_model.data(), &QAbstractItemModel::dataChanged, this, &QDeclarativeGeoMapMarkerLayer::onDataChanged);
+        connect(m_model.data(), &QObject::destroyed, this, &QDeclarativeGeoMapMarkerLayer::resetMarkers);
+    }
+    resetMarkers();
+    emit modelChanged();
+}
+
+/*!
+    \qmlproperty string MapMarkerLayer::coordinateRole
+
+    This property holds the name of the model role holding the coordinate of
+    the markers. The default is \c coordinate.
+*/
+QString QDeclarativeGeoMapMarkerLayer::coordinateRole() const
+{
+    return m_coordinateRole;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setCoordinateRole(const QString &role)
+{
+    if (m_coordinateRole == role)
+        return;
+    m_coordinateRole = role;
+    reloadMarkers();
+    emit coordinateRoleChanged();
+}
+
+/*!
+    \qmlproperty string MapMarkerLayer::iconRole
+
+    This property holds the name of the model role holding the index of the
+    icon of the markers. The default is \c icon. Markers use the first icon
+    when the model has no such role.
+*/
+QString QDeclarativeGeoMapMarkerLayer::iconRole() const
+{
+    return m_iconRole;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setIconRole(const QString &role)
+{
+    if (m_iconRole == role)
+        return;
+    m_iconRole = role;
+    reloadMarkers();
+    emit iconRoleChanged();
+}
+
+/*!
+    \qmlproperty url MapMarkerLayer::iconSource
+
+    This property holds the image containing the icons, a local file or a
+    resource.
+*/
+QUrl QDeclarativeGeoMapMarkerLayer::iconSource() const
+{
+    return m_iconSource;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setIconSource(const QUrl &source)
+{
+    if (m_iconSource == source)
+        return;
+    m_iconSource = source;
+    m_icons = QImage();
+    if (!source.isEmpty()) {
+        m_icons = QImage(QQmlFile::urlToLocalFileOrQrc(source));
+        if (m_icons.isNull())
+            qmlWarning(this) << "Cannot load icons from " << source.toString();
+    }
+    m_iconsDirty = true;
+    m_indexDirty = true; // when unset, the icon size follows the image
+    update();
+    emit iconSourceChanged();
+    if (!m_iconSize.isValid())
+        emit iconSizeChanged();
+}
+
+/*!
+    \qmlproperty size MapMarkerLayer::iconSize
+
+    This property holds the size of the markers on the screen, in pixels. By
+    default it is the size of an icon in \l iconSource.
+*/
+QSizeF QDeclarativeGeoMapMarkerLayer::iconSize() const
+{
+    return m_iconSize.isValid() ? m_iconSize : cellSize();
+}
+
+void QDeclarativeGeoMapMarkerLayer::setIconSize(const QSizeF &size)
+{
+    if (m_iconSize == size)
+        return;
+    m_iconSize = size;
+    update();
+    emit iconSizeChanged();
+}
+
+/*!
+    \qmlproperty point MapMarkerLayer::anchorPoint
+
+    This property holds the point of the icons, in pixels from their top left
+    corner, that is placed at the coordinate of the markers.
+*/
+QPointF QDeclarativeGeoMapMarkerLayer::anchorPoint() const
+{
+    return m_anchorPoint;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setAnchorPoint(const QPointF &anchorPoint)
+{
+    if (m_anchorPoint == anchorPoint)
+        return;
+    m_anchorPoint = anchorPoint;
+    update();
+    emit anchorPointChanged();
+}
+
+/*!
+    \qmlproperty int MapMarkerLayer::count
+
+    This property holds the number of markers.
+*/
+int QDeclarativeGeoMapMarkerLayer::count() const
+{
+    return m_markers.size();
+}
+
+/*!
+    \qmlproperty real MapMarkerLayer::clusterRadius
+
+    This property holds the size on the screen, in pixels, of the cells in
+    which markers are merged into clusters. The default is 0, which disables
+    clustering.
+
+    \sa clusterMarkers()
+*/
+qreal QDeclarativeGeoMapMarkerLayer::clusterRadius() const
+{
+    return m_clusterRadius;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setClusterRadius(qreal radius)
+{
+    radius = qMax(qreal(0), radius);
+    if (m_clusterRadius == radius)
+        return;
+    m_clusterRadius = radius;
+    m_clusters.reset(); // computed for another radius
+    scheduleClustering();
+    updateClusterLevel();
+    emit clusterRadiusChanged();
+}
+
+/*!
+    \qmlproperty int MapMarkerLayer::clusterIcon
+
+    This property holds the index of the icon in \l iconSource drawn for
+    clusters of several markers. The default is -1, which draws the icon of
+    the first marker of the cluster.
+*/
+int QDeclarativeGeoMapMarkerLayer::clusterIcon() const
+{
+    return m_clusterIcon;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setClusterIcon(int icon)
+{
+    if (m_clusterIcon == icon)
+        return;
+    m_clusterIcon = icon;
+    if (m_clusterLevel >= 0)
+        showClusterLevel(m_clusterLevel);
+    emit clusterIconChanged();
+}
+
+/*!
+    \qmlproperty int MapMarkerLayer::clusterCount
+
+    This property holds the number of clusters drawn at the current zoom level,
+    including the ones out of view. It is the same as \l count when the markers
+    are not clustered.
+*/
+int QDeclarativeGeoMapMarkerLayer::clusterCount() const
+{
+    return shownMarkers().size();
+}
+
+/*!
+    \qmlmethod list<int> MapMarkerLayer::clusterMarkers(int row)
+
+    Returns the rows of the markers in the cluster drawn at the current zoom
+    level for the marker at \a row, as returned by markerAt(). It is only
+    \a row when that marker is not clustered, and empty if \a row stands for
+    no cluster.
+*/
+QList<int> QDeclarativeGeoMapMarkerLayer::clusterMarkers(int row) const
+{
+    QList<int> rows;
+    if (m_clusterLevel < 0) {
+        if (row >= 0 && row < m_markers.size())
+            rows.append(row);
+        return rows;
+    }
+
+    const QVector<QVector<ClusterNode>> &levels = m_clusters->levels;
+    const QVector<ClusterNode> &shown = levels.at(m_clusterLevel);
+    auto it = std::find_if(shown.cbegin(), shown.cend(),
+                           [row](const ClusterNode &c) { return c.row == row; });
+    if (it == shown.cend())
+        return rows;
+
+    // descend to the markers, the children of a cluster are contiguous
+    int first = int(it - shown.cbegin());
+    int last = first;
+    for (int level = m_clusterLevel; level < levels.size() - 1; ++level) {
+        const int childFirst = levels.at(level).at(first).childFirst;
+        last = levels.at(level).at(last).childLast;
+        first = childFirst;
+    }
+    const QVector<ClusterNode> &markers = levels.last();
+    for (int i = first; i <= last; ++i) {
+        if (markers.at(i).row < m_markers.size()) // the clusters may predate a reload
+            rows.append(markers.at(i).row);
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+/*!
+    \qmlproperty int MapMarkerLayer::interpolationDelay
+
+    This property holds how long, in milliseconds, the markers tracked with
+    addFix() are drawn in the past. With a delay about as long as the time
+    between two fixes, the markers move between fixes they already have
+    instead of extrapolating. The default is 0.
+*/
+int QDeclarativeGeoMapMarkerLayer::interpolationDelay() const
+{
+    return m_interpolationDelay;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setInterpolationDelay(int msec)
+{
+    msec = qMax(0, msec);
+    if (m_interpolationDelay == msec)
+        return;
+    m_interpolationDelay = msec;
+    for (Track &t : m_tracks)
+        t.moving = !qIsNaN(t.time);
+    startTracking();
+    emit interpolationDelayChanged();
+}
+
+/*!
+    \qmlproperty int MapMarkerLayer::extrapolationTime
+
+    This property holds how long, in milliseconds, a marker tracked with
+    addFix() keeps moving at its last velocity after its last fix, before
+    stopping until the next one. The default is 2000.
+*/
+int QDeclarativeGeoMapMarkerLayer::extrapolationTime() const
+{
+    return m_extrapolationTime;
+}
+
+void QDeclarativeGeoMapMarkerLayer::setExtrapolationTime(int msec)
+{
+    msec = qMax(0, msec);
+    if (m_extrapolationTime == msec)
+        return;
+    m_extrapolationTime = msec;
+    for (Track &t : m_tracks)
+        t.moving = !qIsNaN(t.time);
+    startTracking();
+    emit extrapolationTimeChanged();
+}
+
+/*!
+    \qmlmethod void MapMarkerLayer::addFix(int row, coordinate coordinate, date timestamp)
+
+    Adds a fix at \a coordinate, taken at \a timestamp, to the trajectory of
+    the marker at \a row. Without a \a timestamp, the fix is taken now.
+
+    From then on the marker is drawn on its trajectory instead of at the
+    coordinate of its row: it moves along the line through its last two fixes,
+    at the velocity between them, up to \l extrapolationTime after the last one.
+    When a fix comes, the marker moves from where it is drawn back onto the new
+    trajectory within the time between the fixes, or a second, instead of
+    jumping. Fixes older than the last one of the marker are ignored.
+
+    All the tracked markers are advanced together once per frame, and only
+    the moving ones are uploaded again. The fixes move with their rows when
+    rows are inserted, removed or moved, and are dropped when the model is
+    reset or its layout changes.
+
+    \sa clearFixes(), interpolationDelay
+*/
+void QDeclarativeGeoMapMarkerLayer::addFix(int row, const QGeoCoordinate &coordinate,
+                                           const QDateTime &timestamp)
+{
+    if (row < 0 || row >= m_markers.size() || !coordinate.isValid())
+        return;
+    if (m_tracks.size() != m_markers.size())
+        m_tracks.resize(m_markers.size());
+
+    const double time = timestamp.isValid() ? double(timestamp.toMSecsSinceEpoch())
+                                            : double(QDateTime::currentMSecsSinceEpoch());
+    const QDoubleVector2D p = QWebMercator::coordToMercator(coordinate);
+    Track &t = m_tracks[row];
+    if (qIsNaN(t.time)) {
+        t = Track();
+        t.x = p.x();
+        t.y = p.y();
+        t.time = time;
+        t.moving = true;
+    } else {
+        if (time <= t.time)
+            return;
+        const double now = displayTime();
+        const QDoubleVector2D shown = trackPosition(t, now);
+        double dx = p.x() - t.x;
+        dx -= std::floor(dx + 0.5); // the short way across the antimeridian
+        t.span = time - t.time;
+        t.vx = dx / t.span;
+        t.vy = (p.y() - t.y) / t.span;
+        t.x = p.x();
+        t.y = p.y();
+        t.time = time;
+        t.offsetX = t.offsetY = 0;
+        const QDoubleVector2D target = trackPosition(t, now);
+        t.offsetX = shown.x() - target.x();
+        t.offsetX -= std::floor(t.offsetX + 0.5);
+        t.offsetY = shown.y() - target.y();
+        t.offsetTime = now;
+        t.moving = true;
+    }
+    m_fixesChanged = true;
+    startTracking();
+}
+
+/*!
+    \qmlmethod void MapMarkerLayer::clearFixes()
+
+    Drops the fixes given with addFix(), the markers are drawn at the
+    coordinates of their rows again.
+*/
+void QDeclarativeGeoMapMarkerLayer::clearFixes()
+{
+    if (m_tracks.isEmpty())
+        return;
+    resetMarkers();
+}
+
+/*!
+    \qmlmethod int MapMarkerLayer::markerAt(point position)
+
+    Returns the row of the topmost marker whose icon covers \a position, in
+    the coordinates of the layer, or -1 if there is none. For clusters, it is
+    the row of their first marker.
+
+    The candidates are looked up in a spatial index of the markers, which is
+    rebuilt only after the model changes.
+*/
+int QDeclarativeGeoMapMarkerLayer::markerAt(const QPointF &position) const
+{
+    const QVector<Marker> &markers = shownMarkers();
+    if (!map() || markers.isEmpty())
+        return -1;
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator &>(map()->geoProjection());
+    const QSizeF size = iconSize();
+    const QRectF hitArea(position + m_anchorPoint - QPointF(size.width(), size.height()), size);
+    const double centerX = p.centerMercator().x();
+
+    int result = -1;
+    auto test = [&](int i) {
+        const Marker &m = markers.at(i);
+        if (i <= result || qIsNaN(m.mercator.x()))
+            return;
+        double dx = m.mercator.x() - centerX;
+        dx -= std::floor(dx + 0.5); // same copy of the world as the shader
+        const QDoubleVector2D wrapped(centerX + dx, m.mercator.y());
+        if (!p.isProjectable(wrapped))
+            return;
+        if (hitArea.contains(p.wrappedMapProjectionToItemPosition(wrapped).toPointF()))
+            result = i;
+    };
+
+    // mercator bounds of the area where the markers hit by position are
+    double minX = qInf(), minY = qInf(), maxX = -qInf(), maxY = -qInf();
+    const QPointF corners[] = { hitArea.topLeft(), hitArea.topRight(),
+                                hitArea.bottomLeft(), hitArea.bottomRight() };
+    for (const QPointF &corner : corners) {
+        const QDoubleVector2D wrapped = p.itemPositionToWrappedMapProjection(QDoubleVector2D(corner));
+        if (!p.isProjectable(wrapped)) {
+            // near the horizon, test them all
+            for (int i = markers.size() - 1; i >= 0 && result < 0; --i)
+                test(i);
+            return shownRow(result);
+        }
+        minX = qMin(minX, wrapped.x());
+        maxX = qMax(maxX, wrapped.x());
+        minY = qMin(minY, wrapped.y());
+        maxY = qMax(maxY, wrapped.y());
+    }
+
+    updateIndex();
+    if (m_gridSize == 0)
+        return -1;
+    if (maxY < m_gridMin.y() || minY > m_gridMax.y())
+        return -1;
+    const double cellWidth = (m_gridMax.x() - m_gridMin.x()) / m_gridSize;
+    const double cellHeight = (m_gridMax.y() - m_gridMin.y()) / m_gridSize;
+    const int top = qBound(0, int((minY - m_gridMin.y()) / cellHeight), m_gridSize - 1);
+    const int bottom = qBound(0, int((maxY - m_gridMin.y()) / cellHeight), m_gridSize - 1);
+
+    // the wrapped x of the area can be off by whole worlds from the markers
+    for (int k = int(std::floor(m_gridMin.x() - maxX)); k <= int(std::ceil(m_gridMax.x() - minX)); ++k) {
+        const double x0 = minX + k;
+        const double x1 = maxX + k;
+        if (x1 < m_gridMin.x() || x0 > m_gridMax.x())
+            continue;
+        const int left = qBound(0, int((x0 - m_gridMin.x()) / cellWidth), m_gridSize - 1);
+        const int right = qBound(0, int((x1 - m_gridMin.x()) / cellWidth), m_gridSize - 1);
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                const int cell = row * m_gridSize + column;
+                for (int j = m_cellStart.at(cell); j < m_cellStart.at(cell + 1); ++j)
+                    test(m_cellMarkers.at(j));
+            }
+        }
+    }
+    return shownRow(result);
+}
+
+/*!
+    \internal
+    Only the markers are part of the layer, so that the mouse areas inside it
+    get only the events landing on them.
+*/
+bool QDeclarativeGeoMapMarkerLayer::contains(const QPointF &point) const
+{
+    return markerAt(point) >= 0;
+}
+
+/*!
+    \internal
+    The bounding rectangle of the markers.
+*/
+const QGeoShape &QDeclarativeGeoMapMarkerLayer::geoShape() const
+{
+    if (m_geoShapeDirty) {
+        m_geoShapeDirty = false;
+        double minX = qInf(), minY = qInf(), maxX = -qInf(), maxY = -qInf();
+        for (const Marker &m : m_markers) {
+            if (qIsNaN(m.mercator.x()))
+                continue;
+            minX = qMin(minX, m.mercator.x());
+            maxX = qMax(maxX, m.mercator.x());
+            minY = qMin(minY, m.mercator.y());
+            maxY = qMax(maxY, m.mercator.y());
+        }
+        if (minX > maxX) {
+            m_geoShape = QGeoRectangle();
+        } else {
+            m_geoShape = QGeoRectangle(QWebMercator::mercatorToCoord(QDoubleVector2D(minX, minY)),
+                                       QWebMercator::mercatorToCoord(QDoubleVector2D(maxX, maxY)));
+        }
+    }
+    return m_geoShape;
+}
+
+/*!
+    \internal
+    The markers come from the model, so the shape can't be set.
+*/
+void QDeclarativeGeoMapMarkerLayer::setGeoShape(const QGeoShape &shape)
+{
+    Q_UNUSED(shape);
+    qmlWarning(this) << "The geoShape of a MapMarkerLayer is given by its model";
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapMarkerLayer::afterViewportChanged(const QGeoMapViewportChangeEvent &event)
+{
+    // The markers are projected in the shader, nothing to compute here
+    if (event.mapSizeChanged)
+        updateSize();
+    if (event.zoomLevelChanged)
+        updateClusterLevel();
+    update();
+}
+
+/*!
+    \internal
+*/
+QSGNode *QDeclarativeGeoMapMarkerLayer::updateMapItemPaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    const QVector<Marker> &markers = shownMarkers();
+    if (m_icons.isNull() || markers.isEmpty()) {
+        delete oldNode;
+        m_reloaded = true;
+        m_iconsDirty = true;
+        return nullptr;
+    }
+
+    QSGGeometryNode *node = static_cast<QSGGeometryNode *>(oldNode);
+    if (!node) {
+        node = new QSGGeometryNode;
+        QSGGeometry *geometry = new QSGGeometry(markerAttributes(), 0, 0, QSGGeometry::UnsignedIntType);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setMaterial(new MapMarkerMaterial);
+        node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+        m_reloaded = true;
+        m_iconsDirty = true;
+    }
+    MapMarkerMaterial *material = static_cast<MapMarkerMaterial *>(node->material());
+
+    if (m_iconsDirty) {
+        material->setTexture(window()->createTextureFromImage(m_icons));
+        m_iconsDirty = false;
+        m_reloaded = true; // texture coordinates depend on the image
+    }
+
+    QSGGeometry *geometry = node->geometry();
+    int first = m_dirtyFirst;
+    int last = m_dirtyLast;
+    if (m_reloaded) {
+        geometry->allocate(markers.size() * 4, markers.size() * 6);
+        quint32 *indices = geometry->indexDataAsUInt();
+        for (int i = 0; i < markers.size(); ++i) {
+            const quint32 v = quint32(i) * 4;
+            const quint32 quad[] = { v, v + 1, v + 2, v + 2, v + 1, v + 3 };
+            std::copy(quad, quad + 6, indices + i * 6);
+        }
+        first = 0;
+        last = markers.size() - 1;
+    }
+
+    if (first >= 0) {
+        const QSizeF cell = cellSize();
+        const int icons = qMax(1, int(m_icons.width() / cell.width()));
+        const float cellU = float(cell.width() / m_icons.width());
+        MarkerVertex *vertices = static_cast<MarkerVertex *>(geometry->vertexData());
+        for (int i = first; i <= last; ++i) {
+            const Marker &m = markers.at(i);
+            MarkerVertex *quad = vertices + i * 4;
+            if (qIsNaN(m.mercator.x())) {
+                std::fill(quad, quad + 4, MarkerVertex());
+                continue;
+            }
+            MarkerVertex v;
+            QLocationUtils::split_double(m.mercator.x(), &v.x, &v.xLow);
+            QLocationUtils::split_double(m.mercator.y(), &v.y, &v.yLow);
+            const float u0 = qBound(0, m.icon, icons - 1) * cellU;
+            for (int c = 0; c < 4; ++c) {
+                v.cornerX = c & 1;
+                v.cornerY = c >> 1;
+                v.u = u0 + v.cornerX * cellU;
+                v.v = v.cornerY;
+                quad[c] = v;
+            }
+        }
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+    m_reloaded = false;
+    m_dirtyFirst = m_dirtyLast = -1;
+
+    const QGeoProjection &projection = map()->geoProjection();
+    const QSizeF size = iconSize();
+    material->m_geoProjection = projection.qsgTransform();
+    material->m_center = projection.centerMercator();
+    material->m_iconSize = QVector2D(float(size.width()), float(size.height()));
+    material->m_anchor = QVector2D(float(m_anchorPoint.x()), float(m_anchorPoint.y()));
+    node->markDirty(QSGNode::DirtyMaterial);
+    return node;
+}
+
+/*!
+    \internal
+    Follows the frames of the window the layer is shown in with the tracks.
+*/
+void QDeclarativeGeoMapMarkerLayer::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    if (change == ItemSceneChange) {
+        disconnect(m_frameConnection);
+        m_frameConnection = QMetaObject::Connection();
+        if (value.window)
+            startTracking();
+    }
+    QDeclarativeGeoMapItemBase::itemChange(change, value);
+}
+
+void QDeclarativeGeoMapMarkerLayer::reloadMarkers()
+{
+    const int oldCount = m_markers.size();
+    updateRoles();
+    const int rows = m_model ? m_model->rowCount() : 0;
+    if (!m_tracks.isEmpty() && m_tracks.size() != rows)
+        m_tracks.clear(); // out of step with the rows
+    m_markers.resize(rows);
+    for (int row = 0; row < rows; ++row)
+        readMarker(row, m_markers[row]);
+
+    m_reloaded = true;
+    m_indexDirty = true;
+    m_geoShapeDirty = true;
+    if (!rows) {
+        m_clusters.reset();
+        updateClusterLevel();
+    }
+    scheduleClustering();
+    update();
+    if (oldCount != rows) {
+        emit countChanged();
+        if (m_clusterLevel < 0)
+            emit clusterCountChanged();
+    }
+}
+
+void QDeclarativeGeoMapMarkerLayer::resetMarkers()
+{
+    m_tracks.clear();
+    reloadMarkers();
+}
+
+void QDeclarativeGeoMapMarkerLayer::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (!parent.isValid() && !m_tracks.isEmpty() && first <= m_tracks.size())
+        m_tracks.insert(first, last - first + 1, Track());
+    reloadMarkers();
+}
+
+void QDeclarativeGeoMapMarkerLayer::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (!parent.isValid() && !m_tracks.isEmpty() && last < m_tracks.size())
+        m_tracks.remove(first, last - first + 1);
+    reloadMarkers();
+}
+
+void QDeclarativeGeoMapMarkerLayer::onRowsMoved(const QModelIndex &parent, int start, int end,
+                                                const QModelIndex &destination, int row)
+{
+    if (!parent.isValid() && !destination.isValid() && end < m_tracks.size()
+            && row <= m_tracks.size()) {
+        const auto begin = m_tracks.begin();
+        if (row > end)
+            std::rotate(begin + start, begin + end + 1, begin + row);
+        else if (row < start)
+            std::rotate(begin + row, begin + start, begin + end + 1);
+    }
+    reloadMarkers();
+}
+
+void QDeclarativeGeoMapMarkerLayer::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    const int first = qMax(0, topLeft.row());
+    const int last = qMin(m_markers.size() - 1, bottomRight.row());
+    if (first > last)
+        return;
+
+    // only the changed markers are uploaded again
+    for (int row = first; row <= last; ++row)
+        readMarker(row, m_markers[row]);
+    m_geoShapeDirty = true;
+    scheduleClustering();
+    if (m_clusterLevel < 0) {
+        m_dirtyFirst = m_dirtyFirst < 0 ? first : qMin(m_dirtyFirst, first);
+        m_dirtyLast = qMax(m_dirtyLast, last);
+        m_indexDirty = true;
+        update();
+    }
+}
+
+void QDeclarativeGeoMapMarkerLayer::readMarker(int row, Marker &marker) const
+{
+    const QModelIndex index = m_model->index(row, 0);
+    const QGeoCoordinate coordinate = index.data(m_coordinateRoleId).value<QGeoCoordinate>();
+    marker.mercator = coordinate.isValid() ? QWebMercator::coordToMercator(coordinate)
+                                           : QDoubleVector2D(qQNaN(), qQNaN());
+    marker.icon = m_iconRoleId < 0 ? 0 : index.data(m_iconRoleId).toInt();
+    if (row < m_tracks.size() && !qIsNaN(m_tracks.at(row).time))
+        marker.mercator = trackPosition(m_tracks.at(row), displayTime());
+}
+
+// The position on the trajectory of track at time, moving from where the
+// marker was shown when the last fix came. The marker is settled once it
+// no longer moves until the next fix.
+QDoubleVector2D QDeclarativeGeoMapMarkerLayer::trackPosition(const Track &track, double time,
+                                                             bool *settled) const
+{
+    const double dt = qBound(-track.span, time - track.time, double(m_extrapolationTime));
+    double x = track.x + track.vx * dt;
+    double y = track.y + track.vy * dt;
+    const double blendTime = qMin(track.span, MaxTrackBlendTime);
+    const double blend = blendTime > 0 ? qBound(0.0, 1 - (time - track.offsetTime) / blendTime, 1.0)
+                                       : 0.0;
+    x += track.offsetX * blend;
+    y += track.offsetY * blend;
+    if (settled)
+        *settled = blend == 0 && time - track.time >= m_extrapolationTime;
+    return QDoubleVector2D(x - std::floor(x), qBound(0.0, y, 1.0));
+}
+
+double QDeclarativeGeoMapMarkerLayer::displayTime() const
+{
+    return double(QDateTime::currentMSecsSinceEpoch() - m_interpolationDelay);
+}
+
+void QDeclarativeGeoMapMarkerLayer::startTracking()
+{
+    if (m_frameConnection || !window())
+        return;
+    m_frameConnection = connect(window(), &QQuickWindow::afterAnimating,
+                                this, &QDeclarativeGeoMapMarkerLayer::advanceTracks);
+    update(); // for the first frame
+}
+
+// Moves all the tracked markers to where they are at this frame, in one
+// pass over the tracks, and stops following the frames once none moves.
+void QDeclarativeGeoMapMarkerLayer::advanceTracks()
+{
+    const double now = displayTime();
+    const int count = qMin(m_tracks.size(), m_markers.size());
+    Track *tracks = m_tracks.data();
+    Marker *markers = m_markers.data();
+    int first = -1;
+    int last = -1;
+    for (int i = 0; i < count; ++i) {
+        Track &t = tracks[i];
+        if (!t.moving)
+            continue;
+        bool settled;
+        markers[i].mercator = trackPosition(t, now, &settled);
+        t.moving = !settled;
+        if (first < 0)
+            first = i;
+        last = i;
+    }
+
+    if (m_fixesChanged) {
+        m_fixesChanged = false;
+        scheduleClustering();
+    }
+    if (first < 0) {
+        disconnect(m_frameConnection);
+        m_frameConnection = QMetaObject::Connection();
+        return;
+    }
+    m_geoShapeDirty = true;
+    if (m_clusterLevel < 0) {
+        m_dirtyFirst = m_dirtyFirst < 0 ? first : qMin(m_dirtyFirst, first);
+        m_dirtyLast = qMax(m_dirtyLast, last);
+        m_indexDirty = true;
+    }
+    update(); // for the next frame
+}
+
+void QDeclarativeGeoMapMarkerLayer::updateRoles()
+{
+    m_coordinateRoleId = -1;
+    m_iconRoleId = -1;
+    if (!m_model)
+        return;
+    const QHash<int, QByteArray> roles = m_model->roleNames();
+    for (auto it = roles.cbegin(); it != roles.cend(); ++it) {
+        if (it.value() == m_coordinateRole.toUtf8())
+            m_coordinateRoleId = it.key();
+        else if (it.value() == m_iconRole.toUtf8())
+            m_iconRoleId = it.key();
+    }
+}
+
+void QDeclarativeGeoMapMarkerLayer::updateSize()
+{
+    // covering the whole map, the markers are placed by the shader
+    if (!quickMap())
+        return;
+    setPosition(QPointF(0, 0));
+    setSize(QSizeF(quickMap()->width(), quickMap()->height()));
+}
+
+// Clusters every level on a grid of cells as large as the radius, starting
+// from the markers. The cells halve from a level to the next, so ordering the
+// markers once along the Z-order curve of the finest cells keeps every
+// cluster, at every level, a contiguous range of the level above it.
+QVector<QVector<QDeclarativeGeoMapMarkerLayer::ClusterNode>>
+QDeclarativeGeoMapMarkerLayer::buildClusters(const QVector<Marker> &markers, qreal radius)
+{
+    // size of the finest cells in mercator units, for 256 pixel tiles; radii
+    // below an eighth of a pixel would not fit the columns in 31 bits
+    const double fineSize = qMax(radius, 0.125) / (256.0 * double(1 << MaxClusterZoom));
+    const qint64 columns = qint64(std::ceil(1.0 / fineSize));
+
+    QVector<QPair<quint64, int>> cells; // key, row of the marker
+    cells.reserve(markers.size());
+    for (int row = 0; row < markers.size(); ++row) {
+        const QDoubleVector2D &p = markers.at(row).mercator;
+        if (qIsNaN(p.x()))
+            continue;
+        const qint64 column = qBound<qint64>(0, qint64(p.x() / fineSize), columns - 1);
+        const qint64 cellRow = qBound<qint64>(0, qint64(p.y() / fineSize), columns - 1);
+        cells.append(qMakePair(cellKey(quint32(column), quint32(cellRow)), row));
+    }
+    std::sort(cells.begin(), cells.end());
+
+    QVector<QVector<ClusterNode>> levels(MaxClusterZoom + 2);
+    QVector<ClusterNode> &leaves = levels.last();
+    leaves.reserve(cells.size());
+    QVector<quint64> keys; // of the nodes of the level above, in the finest cells
+    keys.reserve(cells.size());
+    for (const auto &cell : qAsConst(cells)) {
+        const Marker &m = markers.at(cell.second);
+        leaves.append({ m.mercator, 1, cell.second, m.icon, -1, -1 });
+        keys.append(cell.first);
+    }
+
+    QVector<quint64> levelKeys;
+    for (int zoom = MaxClusterZoom; zoom >= 0; --zoom) {
+        const QVector<ClusterNode> &above = levels.at(zoom + 1);
+        const int shift = 2 * (MaxClusterZoom - zoom);
+        QVector<ClusterNode> &level = levels[zoom];
+        levelKeys.clear();
+        for (int first = 0; first < above.size(); ) {
+            const quint64 key = keys.at(first) >> shift;
+            int last = first;
+            while (last + 1 < above.size() && keys.at(last + 1) >> shift == key)
+                ++last;
+            ClusterNode cluster = { QDoubleVector2D(0, 0), 0, std::numeric_limits<int>::max(), 0, first, last };
+            for (int i = first; i <= last; ++i) {
+                const ClusterNode &child = above.at(i);
+                cluster.mercator += child.mercator * child.count;
+                cluster.count += child.count;
+                if (child.row < cluster.row) {
+                    cluster.row = child.row;
+                    cluster.icon = child.icon;
+                }
+            }
+            cluster.mercator /= cluster.count;
+            level.append(cluster);
+            levelKeys.append(keys.at(first));
+            first = last + 1;
+        }
+        keys.swap(levelKeys);
+    }
+    return levels;
+}
+
+void QDeclarativeGeoMapMarkerLayer::scheduleClustering()
+{
+    if (m_clusterRadius <= 0 || m_markers.isEmpty()) {
+        m_pendingClusters.reset();
+        m_clusteringDirty = false;
+        return;
+    }
+    if (m_pendingClusters) {
+        // started again once the one in flight is done
+        m_clusteringDirty = true;
+        return;
+    }
+
+    const QSharedPointer<ClusterIndex> index(new ClusterIndex);
+    index->radius = m_clusterRadius;
+    m_pendingClusters = index;
+    const QVector<Marker> markers = m_markers;
+    const QPointer<QDeclarativeGeoMapMarkerLayer> layer(this);
+    QThreadPool::globalInstance()->start(QRunnable::create([index, markers, layer]() {
+        index->levels = buildClusters(markers, index->radius);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [index, layer]() {
+            if (layer)
+                layer->adoptClusters(index);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void QDeclarativeGeoMapMarkerLayer::adoptClusters(const QSharedPointer<ClusterIndex> &index)
+{
+    if (index != m_pendingClusters)
+        return; // dropped meanwhile
+    m_pendingClusters.reset();
+    if (index->radius == m_clusterRadius) {
+        m_clusters = index;
+        showClusterLevel(clusterLevel());
+    }
+    if (m_clusteringDirty) {
+        m_clusteringDirty = false;
+        scheduleClustering();
+    }
+}
+
+int QDeclarativeGeoMapMarkerLayer::clusterLevel() const
+{
+    if (!m_clusters || m_clusterRadius <= 0 || !map())
+        return -1;
+    const int zoom = int(std::floor(map()->cameraData().zoomLevel()));
+    return zoom > MaxClusterZoom ? -1 : qMax(0, zoom);
+}
+
+void QDeclarativeGeoMapMarkerLayer::updateClusterLevel()
+{
+    const int level = clusterLevel();
+    if (level != m_clusterLevel)
+        showClusterLevel(level);
+}
+
+void QDeclarativeGeoMapMarkerLayer::showClusterLevel(int level)
+{
+    const int oldCount = clusterCount();
+    m_clusterLevel = level;
+    m_clusterMarkers.clear();
+    if (level >= 0) {
+        const QVector<ClusterNode> &clusters = m_clusters->levels.at(level);
+        m_clusterMarkers.reserve(clusters.size());
+        for (const ClusterNode &c : clusters)
+            m_clusterMarkers.append({ c.mercator, c.count > 1 && m_clusterIcon >= 0 ? m_clusterIcon : c.icon });
+    }
+
+    m_reloaded = true;
+    m_dirtyFirst = m_dirtyLast = -1;
+    m_indexDirty = true;
+    update();
+    if (clusterCount() != oldCount)
+        emit clusterCountChanged();
+}
+
+const QVector<QDeclarativeGeoMapMarkerLayer::Marker> &QDeclarativeGeoMapMarkerLayer::shownMarkers() const
+{
+    return m_clusterLevel >= 0 ? m_clusterMarkers : m_markers;
+}
+
+// The row of the marker drawn at position shown, the first one of a cluster
+int QDeclarativeGeoMapMarkerLayer::shownRow(int shown) const
+{
+    if (shown < 0 || m_clusterLevel < 0)
+        return shown;
+    const int row = m_clusters->levels.at(m_clusterLevel).at(shown).row;
+    return row < m_markers.size() ? row : -1;
+}
+
+QSizeF QDeclarativeGeoMapMarkerLayer::cellSize() const
+{
+    return QSizeF(m_icons.height(), m_icons.height());
+}
+
+// Builds the grid over the mercator bounds of the markers, with about two
+// markers per cell, as a list of markers sorted by cell.
+void QDeclarativeGeoMapMarkerLayer::updateIndex() const
+{
+    if (!m_indexDirty)
+        return;
+    m_indexDirty = false;
+
+    const QVector<Marker> &markers = shownMarkers();
+    double minX = qInf(), minY = qInf(), maxX = -qInf(), maxY = -qInf();
+    int valid = 0;
+    for (const Marker &m : markers) {
+        if (qIsNaN(m.mercator.x()))
+            continue;
+        minX = qMin(minX, m.mercator.x());
+        maxX = qMax(maxX, m.mercator.x());
+        minY = qMin(minY, m.mercator.y());
+        maxY = qMax(maxY, m.mercator.y());
+        ++valid;
+    }
+    m_cellStart.clear();
+    m_cellMarkers.clear();
+    m_gridSize = 0;
+    if (!valid)
+        return;
+
+    m_gridSize = qBound(1, int(std::ceil(std::sqrt(valid / 2.0))), 512);
+    const double epsilon = 1e-9; // keeps the maximum inside the last cell
+    m_gridMin = QDoubleVector2D(minX, minY);
+    m_gridMax = QDoubleVector2D(maxX + epsilon, maxY + epsilon);
+    const double cellWidth = (m_gridMax.x() - m_gridMin.x()) / m_gridSize;
+    const double cellHeight = (m_gridMax.y() - m_gridMin.y()) / m_gridSize;
+
+    QVector<int> cells(markers.size(), -1);
+    m_cellStart.fill(0, m_gridSize * m_gridSize + 1);
+    for (int i = 0; i < markers.size(); ++i) {
+        const Marker &m = markers.at(i);
+        if (qIsNaN(m.mercator.x()))
+            continue;
+        const int column = qMin(m_gridSize - 1, int((m.mercator.x() - minX) / cellWidth));
+        const int row = qMin(m_gridSize - 1, int((m.mercator.y() - minY) / cellHeight));
+        cells[i] = row * m_gridSize + column;
+        ++m_cellStart[cells[i] + 1];
+    }
+    for (int c = 0; c < m_gridSize * m_gridSize; ++c)
+        m_cellStart[c + 1] += m_cellStart[c];
+
+    QVector<int> fill = m_cellStart;
+    m_cellMarkers.resize(valid);
+    for (int i = 0; i < markers.size(); ++i) {
+        if (cells.at(i) >= 0)
+            m_cellMarkers[fill[cells.at(i)]++] = i;
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,265 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDECLARATIVEGEOMAPMARKERLAYER_P_H
+#define QDECLARATIVEGEOMAPMARKERLAYER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qdeclarativegeomapitembase_p.h>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QDateTime>
+#include <QtCore/QModelIndex>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractItemModel;
+
+class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapMarkerLayer : public QDeclarativeGeoMapItemBase
+{
+    Q_OBJECT
+    Q_PROPERTY(QAbstractItemModel *model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QString coordinateRole READ coordinateRole WRITE setCoordinateRole NOTIFY coordinateRoleChanged)
+    Q_PROPERTY(QString iconRole READ iconRole WRITE setIconRole NOTIFY iconRoleChanged)
+    Q_PROPERTY(QUrl iconSource READ iconSource WRITE setIconSource NOTIFY iconSourceChanged)
+    Q_PROPERTY(QSizeF iconSize READ iconSize WRITE setIconSize NOTIFY iconSizeChanged)
+    Q_PROPERTY(QPointF anchorPoint READ anchorPoint WRITE setAnchorPoint NOTIFY anchorPointChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(qreal clusterRadius READ clusterRadius WRITE setClusterRadius NOTIFY clusterRadiusChanged)
+    Q_PROPERTY(int clusterIcon READ clusterIcon WRITE setClusterIcon NOTIFY clusterIconChanged)
+    Q_PROPERTY(int clusterCount READ clusterCount NOTIFY clusterCountChanged)
+    Q_PROPERTY(int interpolationDelay READ interpolationDelay WRITE setInterpolationDelay NOTIFY interpolationDelayChanged)
+    Q_PROPERTY(int extrapolationTime READ extrapolationTime WRITE setExtrapolationTime NOTIFY extrapolationTimeChanged)
+
+public:
+    explicit QDeclarativeGeoMapMarkerLayer(QQuickItem *parent = nullptr);
+    ~QDeclarativeGeoMapMarkerLayer() override;
+
+    void setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map) override;
+
+    QAbstractItemModel *model() const;
+    void setModel(QAbstractItemModel *model);
+
+    QString coordinateRole() const;
+    void setCoordinateRole(const QString &role);
+
+    QString iconRole() const;
+    void setIconRole(const QString &role);
+
+    QUrl iconSource() const;
+    void setIconSource(const QUrl &source);
+
+    QSizeF iconSize() const;
+    void setIconSize(const QSizeF &size);
+
+    QPointF anchorPoint() const;
+    void setAnchorPoint(const QPointF &anchorPoint);
+
+    int count() const;
+
+    qreal clusterRadius() const;
+    void setClusterRadius(qreal radius);
+
+    int clusterIcon() const;
+    void setClusterIcon(int icon);
+
+    int clusterCount() const;
+
+    int interpolationDelay() const;
+    void setInterpolationDelay(int msec);
+
+    int extrapolationTime() const;
+    void setExtrapolationTime(int msec);
+
+    Q_INVOKABLE void addFix(int row, const QGeoCoordinate &coordinate,
+                            const QDateTime &timestamp = QDateTime());
+    Q_INVOKABLE void clearFixes();
+    Q_INVOKABLE int markerAt(const QPointF &position) const;
+    Q_INVOKABLE QList<int> clusterMarkers(int row) const;
+    bool contains(const QPointF &point) const override;
+
+    const QGeoShape &geoShape() const override;
+    void setGeoShape(const QGeoShape &shape) override;
+
+Q_SIGNALS:
+    void modelChanged();
+    void coordinateRoleChanged();
+    void iconRoleChanged();
+    void iconSourceChanged();
+    void iconSizeChanged();
+    void anchorPointChanged();
+    void countChanged();
+    void clusterRadiusChanged();
+    void clusterIconChanged();
+    void clusterCountChanged();
+    void interpolationDelayChanged();
+    void extrapolationTimeChanged();
+
+protected:
+    QSGNode *updateMapItemPaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+
+protected Q_SLOTS:
+    void afterViewportChanged(const QGeoMapViewportChangeEvent &event) override;
+
+private Q_SLOTS:
+    void reloadMarkers();
+    void resetMarkers();
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsMoved(const QModelIndex &parent, int start, int end,
+                     const QModelIndex &destination, int row);
+    void advanceTracks();
+
+private:
+    struct Marker
+    {
+        QDoubleVector2D mercator; // NaN for invalid coordinates
+        int icon;
+    };
+
+    // A cluster of one zoom level, merging a range of clusters of the level
+    // above it; the markers themselves form the last level.
+    struct ClusterNode
+    {
+        QDoubleVector2D mercator;
+        int count;
+        int row; // of the first marker, which represents the cluster
+        int icon;
+        int childFirst;
+        int childLast;
+    };
+    struct ClusterIndex;
+
+    // The trajectory of a marker from its last two fixes, in mercator units
+    // and milliseconds since the epoch.
+    struct Track
+    {
+        double x = 0; // of the last fix
+        double y = 0;
+        double vx = 0; // from the fix before it, per millisecond
+        double vy = 0;
+        double time = qQNaN(); // of the last fix, NaN for markers not tracked
+        double span = 0; // between the last two fixes
+        double offsetX = 0; // from the trajectory to the shown position when the fix came
+        double offsetY = 0;
+        double offsetTime = 0;
+        bool moving = false;
+    };
+    static const int MaxClusterZoom = 20;
+
+    static QVector<QVector<ClusterNode>> buildClusters(const QVector<Marker> &markers, qreal radius);
+    void scheduleClustering();
+    void adoptClusters(const QSharedPointer<ClusterIndex> &index);
+    void updateClusterLevel();
+    void showClusterLevel(int level);
+    int clusterLevel() const;
+    const QVector<Marker> &shownMarkers() const;
+    int shownRow(int shown) const;
+
+    void readMarker(int row, Marker &marker) const;
+    QDoubleVector2D trackPosition(const Track &track, double time, bool *settled = nullptr) const;
+    double displayTime() const;
+    void startTracking();
+    void updateRoles();
+    void updateSize();
+    QSizeF cellSize() const;
+    void updateIndex() const;
+
+    QPointer<QAbstractItemModel> m_model;
+    QString m_coordinateRole = QStringLiteral("coordinate");
+    QString m_iconRole = QStringLiteral("icon");
+    int m_coordinateRoleId = -1;
+    int m_iconRoleId = -1;
+    QUrl m_iconSource;
+    QImage m_icons;
+    QSizeF m_iconSize;
+    QPointF m_anchorPoint;
+
+    QVector<Marker> m_markers;
+    mutable QGeoRectangle m_geoShape;
+    mutable bool m_geoShapeDirty = true;
+    int m_dirtyFirst = -1; // range of markers to upload, all of them after a reload
+    int m_dirtyLast = -1;
+    bool m_reloaded = true;
+    bool m_iconsDirty = true;
+
+    // uniform grid over the mercator square, each cell listing its markers
+    mutable int m_gridSize = 0;
+    mutable QDoubleVector2D m_gridMin;
+    mutable QDoubleVector2D m_gridMax;
+    mutable QVector<int> m_cellStart;
+    mutable QVector<int> m_cellMarkers;
+    mutable bool m_indexDirty = true;
+
+    qreal m_clusterRadius = 0;
+    int m_clusterIcon = -1;
+    QSharedPointer<ClusterIndex> m_clusters;
+    QSharedPointer<ClusterIndex> m_pendingClusters; // being built on a worker thread
+    bool m_clusteringDirty = false; // the markers changed since m_pendingClusters started
+    int m_clusterLevel = -1; // shown level of m_clusters, -1 to show the markers
+    QVector<Marker> m_clusterMarkers;
+
+    QVector<Track> m_tracks; // one per marker once there are fixes
+    int m_interpolationDelay = 0;
+    int m_extrapolationTime = 2000;
+    bool m_fixesChanged = false; // since the clusters were scheduled
+    QMetaObject::Connection m_frameConnection; // to the frames of the window while tracks move
+};
+
+QT_END_NAMESPACE
+
+QML_DECLARE_TYPE(QDeclarativeGeoMapMarkerLayer)
+
+#endif // QDECLARATIVEGEOMAPMARKERLAYER_P_H
@@ -0,0 +1,711 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qdeclarativegeomappositionindicator_p.h"
+#include <QtLocation/private/qdeclarativegeomap_p.h>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qdoublevector3d_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioningQuick/private/qdeclarativeposition_p.h>
+#include <QtPositioningQuick/private/qdeclarativepositionsource_p.h>
+#include <QtCore/QThread>
+#include <QtQml/QQmlInfo>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGMaterial>
+#include <QtQuick/private/qsgmaterialshader_p.h>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype MapPositionIndicator
+    \instantiates QDeclarativeGeoMapPositionIndicator
+    \inqmlmodule Qt.labs.location
+    \ingroup qml-QtLocation5-maps
+    \inherits QtQuick::Item
+
+    \brief The MapPositionIndicator type displays the current position on a Map.
+
+    The MapPositionIndicator draws a dot at the latest position of its
+    \l positionSource, or of the fixes given with addFix(), with a pointer
+    toward the heading of the fix when it has one.
+
+    Unlike a MapQuickItem whose coordinate is bound to the position of a
+    PositionSource, the fixes do not go through bindings nor move an item:
+    each fix is handed to the render thread through a single slot, that the
+    render thread reads when it draws a frame, and the indicator is then moved
+    on its trajectory by the GPU. While it moves, the indicator asks the render
+    thread for the next frames itself, so that it keeps moving at the rate of
+    the display even when the GUI thread is busy.
+
+    Between fixes the indicator moves along the line through its last two
+    fixes, at the velocity between them, up to \l extrapolationTime after the
+    last one. When a fix comes, the indicator moves from where it is drawn
+    back onto the new trajectory, and turns to the new heading, within the
+    time between the fixes, or a second, instead of jumping.
+
+    The indicator requires the OpenGL scene graph backend.
+
+    \section2 Example Usage
+
+    \code
+    PositionSource {
+        id: positionSource
+        active: true
+    }
+
+    Map {
+        MapPositionIndicator {
+            positionSource: positionSource
+        }
+    }
+    \endcode
+*/
+
+namespace {
+
+const double MaxBlendTime = 1000; // milliseconds
+
+class PositionIndicatorMaterial : public QSGMaterial
+{
+public:
+    PositionIndicatorMaterial()
+    {
+        setFlag(Blending);
+    }
+
+    QSGMaterialShader *createShader() const override;
+    QSGMaterialType *type() const override
+    {
+        static QSGMaterialType type;
+        return &type;
+    }
+    int compare(const QSGMaterial *other) const override
+    {
+        return other == this ? 0 : (this < other ? -1 : 1);
+    }
+
+    QMatrix4x4 m_geoProjection;
+    QVector2D m_fixPosition; // from the center of the map, in mercator units
+    QVector2D m_velocity; // per millisecond
+    QVector2D m_offset; // from the trajectory to the shown position when the fix came
+    QVector4D m_times; // since the fix, since the offset, between the fixes, blend time
+    float m_extrapolationTime = 0;
+    float m_radius = 0; // 0 to hide the indicator
+    QVector2D m_heading; // on the screen, and its offset when the fix came, in degrees
+    float m_headingValid = 0;
+    QVector4D m_color; // premultiplied
+};
+
+// Moves the indicator along its trajectory on the GPU, from the time since
+// the last fix, and draws it as a dot with a pointer toward the heading.
+class PositionIndicatorShader : public QSGMaterialShader
+{
+public:
+    PositionIndicatorShader() : QSGMaterialShader(*new QSGMaterialShaderPrivate) { }
+
+    const char *vertexShader() const override {
+        return
+        "attribute highp vec2 corner;               \n"
+        "uniform highp mat4 qt_Matrix;              \n"
+        "uniform highp mat4 mapProjection;          \n"
+        "uniform highp vec2 fixPosition;            \n"
+        "uniform highp vec2 velocity;               \n"
+        "uniform highp vec2 offset;                 \n"
+        "uniform highp vec4 times;                  \n"
+        "uniform highp float extrapolationTime;     \n"
+        "uniform highp float radius;                \n"
+        "varying highp vec2 uv;                     \n"
+        "varying highp float blend;                 \n"
+        "void main() {                              \n"
+        "    float dt = clamp(times.x, -times.z, extrapolationTime);\n"
+        "    blend = times.w > 0.0 ? clamp(1.0 - times.y / times.w, 0.0, 1.0) : 0.0;\n"
+        "    vec2 d = fixPosition + velocity * dt + offset * blend;\n"
+        "    d.x = d.x - floor(d.x + 0.5);          \n" // the copy of the world closest to the center
+        "    vec4 p = mapProjection * vec4(d, 0.0, 1.0);\n"
+        "    uv = corner;                           \n"
+        "    if (p.w <= 0.0) {                      \n" // behind the camera
+        "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+        "        return;                            \n"
+        "    }                                      \n"
+        "    vec2 pos = p.xy / p.w + corner * radius;\n"
+        "    gl_Position = qt_Matrix * vec4(pos, 0.0, 1.0);\n"
+        "}";
+    }
+
+    const char *fragmentShader() const override {
+        return
+        "uniform lowp vec4 color;                   \n"
+        "uniform lowp float opacity;                \n"
+        "uniform highp vec2 heading;                \n"
+        "uniform lowp float headingValid;           \n"
+        "uniform highp float pixel;                 \n"
+        "varying highp vec2 uv;                     \n"
+        "varying highp float blend;                 \n"
+        "void main() {                              \n"
+        "    float r = length(uv);                  \n"
+        "    float disc = 1.0 - smoothstep(0.55 - pixel, 0.55, r);\n"
+        "    vec4 c = mix(color, vec4(1.0), smoothstep(0.42 - pixel, 0.42, r)) * disc;\n" // with a white rim
+        "    float angle = radians(heading.x + heading.y * blend);\n"
+        "    vec2 forward = vec2(sin(angle), -cos(angle));\n"
+        "    vec2 q = vec2(dot(uv, vec2(-forward.y, forward.x)), -dot(uv, forward));\n" // tip at (0, -1)
+        "    float pointer = headingValid * step(-1.0, q.y) * step(q.y, -0.5)\n"
+        "                  * step(abs(q.x), (q.y + 1.0) * 0.6);\n"
+        "    gl_FragColor = (c + color * pointer * (1.0 - disc)) * opacity;\n"
+        "}";
+    }
+
+    char const *const *attributeNames() const override
+    {
+        static char const *const attr[] = { "corner", nullptr };
+        return attr;
+    }
+
+    void updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *) override
+    {
+        PositionIndicatorMaterial *material = static_cast<PositionIndicatorMaterial *>(newEffect);
+
+        if (state.isMatrixDirty())
+            program()->setUniformValue(m_matrix_id, state.projectionMatrix());
+        if (state.isOpacityDirty())
+            program()->setUniformValue(m_opacity_id, state.opacity());
+
+        program()->setUniformValue(m_mapProjection_id, material->m_geoProjection);
+        program()->setUniformValue(m_fixPosition_id, material->m_fixPosition);
+        program()->setUniformValue(m_velocity_id, material->m_velocity);
+        program()->setUniformValue(m_offset_id, material->m_offset);
+        program()->setUniformValue(m_times_id, material->m_times);
+        program()->setUniformValue(m_extrapolationTime_id, material->m_extrapolationTime);
+        program()->setUniformValue(m_radius_id, material->m_radius);
+        program()->setUniformValue(m_pixel_id, material->m_radius > 0 ? 1.0f / material->m_radius : 1.0f);
+        program()->setUniformValue(m_heading_id, material->m_heading);
+        program()->setUniformValue(m_headingValid_id, material->m_headingValid);
+        program()->setUniformValue(m_color_id, material->m_color);
+    }
+
+private:
+    void initialize() override
+    {
+        m_matrix_id = program()->uniformLocation("qt_Matrix");
+        m_opacity_id = program()->uniformLocation("opacity");
+        m_mapProjection_id = program()->uniformLocation("mapProjection");
+        m_fixPosition_id = program()->uniformLocation("fixPosition");
+        m_velocity_id = program()->uniformLocation("velocity");
+        m_offset_id = program()->uniformLocation("offset");
+        m_times_id = program()->uniformLocation("times");
+        m_extrapolationTime_id = program()->uniformLocation("extrapolationTime");
+        m_radius_id = program()->uniformLocation("radius");
+        m_pixel_id = program()->uniformLocation("pixel");
+        m_heading_id = program()->uniformLocation("heading");
+        m_headingValid_id = program()->uniformLocation("headingValid");
+        m_color_id = program()->uniformLocation("color");
+    }
+
+    int m_matrix_id;
+    int m_opacity_id;
+    int m_mapProjection_id;
+    int m_fixPosition_id;
+    int m_velocity_id;
+    int m_offset_id;
+    int m_times_id;
+    int m_extrapolationTime_id;
+    int m_radius_id;
+    int m_pixel_id;
+    int m_heading_id;
+    int m_headingValid_id;
+    int m_color_id;
+};
+
+QSGMaterialShader *PositionIndicatorMaterial::createShader() const
+{
+    return new PositionIndicatorShader();
+}
+
+double wrappedDegrees(double degrees)
+{
+    return degrees - 360.0 * std::floor(degrees / 360.0 + 0.5);
+}
+
+// Takes the fixes on the render thread, when a frame is drawn, be it after
+// a sync with the item or not.
+class PositionIndicatorNode : public QSGGeometryNode
+{
+public:
+    typedef QDeclarativeGeoMapPositionIndicator::Fix Fix;
+
+    explicit PositionIndicatorNode(const QSharedPointer<QGeoLatestValueMailbox<Fix>> &mailbox)
+        : m_mailbox(mailbox)
+        , m_geometry(QSGGeometry::defaultAttributes_Point2D(), 4)
+    {
+        m_geometry.setDrawingMode(QSGGeometry::DrawTriangleStrip);
+        QSGGeometry::Point2D *corners = m_geometry.vertexDataAsPoint2D();
+        corners[0].set(-1, -1);
+        corners[1].set(1, -1);
+        corners[2].set(-1, 1);
+        corners[3].set(1, 1);
+        setGeometry(&m_geometry);
+        setMaterial(&m_material);
+        setFlag(UsePreprocess);
+    }
+
+    void preprocess() override
+    {
+        advance();
+    }
+
+    void advance();
+
+    // Set from the item at sync time
+    QQuickWindow *window = nullptr;
+    QMatrix4x4 geoProjection;
+    QDoubleVector2D center;
+    double bearing = 0;
+    QColor color;
+    float radius = 0;
+    int interpolationDelay = 0;
+    int extrapolationTime = 0;
+
+private:
+    struct Track
+    {
+        double x = 0; // of the last fix
+        double y = 0;
+        double vx = 0; // from the fix before it, per millisecond
+        double vy = 0;
+        double time = qQNaN(); // of the last fix, NaN without fixes
+        double span = 0; // between the last two fixes
+        double offsetX = 0; // from the trajectory to the shown position when the fix came
+        double offsetY = 0;
+        double offsetTime = 0;
+        double heading = qQNaN(); // of the last fix
+        double headingOffset = 0;
+    };
+
+    void addFix(const Fix &fix, double now);
+    double blendAt(double now) const;
+    QDoubleVector2D positionAt(double now) const;
+    double headingAt(double now) const;
+
+    QSharedPointer<QGeoLatestValueMailbox<Fix>> m_mailbox;
+    QSGGeometry m_geometry;
+    PositionIndicatorMaterial m_material;
+    Track m_track;
+};
+
+double PositionIndicatorNode::blendAt(double now) const
+{
+    const double blendTime = qMin(m_track.span, MaxBlendTime);
+    return blendTime > 0 ? qBound(0.0, 1 - (now - m_track.offsetTime) / blendTime, 1.0) : 0.0;
+}
+
+// The same as the vertex shader, in double precision
+QDoubleVector2D PositionIndicatorNode::positionAt(double now) const
+{
+    const double dt = qBound(-m_track.span, now - m_track.time, double(extrapolationTime));
+    const double blend = blendAt(now);
+    return QDoubleVector2D(m_track.x + m_track.vx * dt + m_track.offsetX * blend,
+                           m_track.y + m_track.vy * dt + m_track.offsetY * blend);
+}
+
+double PositionIndicatorNode::headingAt(double now) const
+{
+    return m_track.heading + m_track.headingOffset * blendAt(now);
+}
+
+void PositionIndicatorNode::addFix(const Fix &fix, double now)
+{
+    if (qIsNaN(fix.x)) {
+        m_track = Track();
+        return;
+    }
+    if (qIsNaN(m_track.time)) {
+        m_track = Track();
+        m_track.x = fix.x;
+        m_track.y = fix.y;
+        m_track.time = fix.time;
+        m_track.heading = fix.heading;
+        return;
+    }
+    if (fix.time <= m_track.time)
+        return;
+
+    const QDoubleVector2D shown = positionAt(now);
+    const double shownHeading = headingAt(now);
+    double dx = fix.x - m_track.x;
+    dx -= std::floor(dx + 0.5); // the short way across the antimeridian
+    m_track.span = fix.time - m_track.time;
+    m_track.vx = dx / m_track.span;
+    m_track.vy = (fix.y - m_track.y) / m_track.span;
+    m_track.x = fix.x;
+    m_track.y = fix.y;
+    m_track.time = fix.time;
+    m_track.offsetX = m_track.offsetY = 0;
+    const QDoubleVector2D target = positionAt(now);
+    m_track.offsetX = shown.x() - target.x();
+    m_track.offsetX -= std::floor(m_track.offsetX + 0.5);
+    m_track.offsetY = shown.y() - target.y();
+    m_track.offsetTime = now;
+    m_track.heading = fix.heading;
+    m_track.headingOffset = qIsNaN(shownHeading) || qIsNaN(fix.heading)
+            ? 0.0 : wrappedDegrees(shownHeading - fix.heading);
+}
+
+// Takes the latest fix, if any, and updates the uniforms for this frame.
+// Keeps the frames coming from the render thread while the indicator moves,
+// and lets the next fix wake it up otherwise.
+void PositionIndicatorNode::advance()
+{
+    const double now = double(QDateTime::currentMSecsSinceEpoch() - interpolationDelay);
+    Fix fix;
+    if (m_mailbox->take(&fix))
+        addFix(fix, now);
+
+    bool moving = false;
+    m_material.m_geoProjection = geoProjection;
+    if (qIsNaN(m_track.time)) {
+        m_material.m_radius = 0;
+    } else {
+        double dx = m_track.x - center.x();
+        dx -= std::floor(dx + 0.5);
+        const double sinceFix = now - m_track.time;
+        const double sinceOffset = now - m_track.offsetTime;
+        const double blendTime = qMin(m_track.span, MaxBlendTime);
+        m_material.m_fixPosition = QVector2D(float(dx), float(m_track.y - center.y()));
+        m_material.m_velocity = QVector2D(float(m_track.vx), float(m_track.vy));
+        m_material.m_offset = QVector2D(float(m_track.offsetX), float(m_track.offsetY));
+        m_material.m_times = QVector4D(float(qMin(sinceFix, double(extrapolationTime))),
+                                       float(qMin(sinceOffset, blendTime)),
+                                       float(m_track.span), float(blendTime));
+        m_material.m_extrapolationTime = float(extrapolationTime);
+        m_material.m_radius = radius;
+        m_material.m_headingValid = qIsNaN(m_track.heading) ? 0.0f : 1.0f;
+        m_material.m_heading = QVector2D(qIsNaN(m_track.heading) ? 0.0f : float(m_track.heading - bearing),
+                                         float(m_track.headingOffset));
+        moving = (sinceFix < extrapolationTime && (m_track.vx != 0 || m_track.vy != 0))
+                || sinceOffset < blendTime;
+    }
+    const float alpha = float(color.alphaF());
+    m_material.m_color = QVector4D(float(color.redF()) * alpha, float(color.greenF()) * alpha,
+                                   float(color.blueF()) * alpha, alpha);
+    markDirty(DirtyMaterial);
+
+    bool nextFrame = moving;
+    if (moving)
+        m_mailbox->setAwake(true);
+    else
+        nextFrame = m_mailbox->setAwake(false); // unless a fix came meanwhile
+    if (nextFrame && window)
+        window->update(); // from the render thread, without syncing with the item
+}
+
+} // namespace
+
+QDeclarativeGeoMapPositionIndicator::QDeclarativeGeoMapPositionIndicator(QQuickItem *parent)
+:   QDeclarativeGeoMapItemBase(parent), m_mailbox(new QGeoLatestValueMailbox<Fix>)
+{
+    setFlag(ItemHasContents, true);
+}
+
+QDeclarativeGeoMapPositionIndicator::~QDeclarativeGeoMapPositionIndicator()
+{
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapPositionIndicator::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
+{
+    QDeclarativeGeoMapItemBase::setMap(quickMap, map);
+    if (map)
+        updateSize();
+}
+
+/*!
+    \qmlproperty PositionSource MapPositionIndicator::positionSource
+
+    This property holds the position source whose positions are shown. Each
+    position update of the source gives a fix, with the heading of the
+    position when it has a valid direction.
+*/
+QDeclarativePositionSource *QDeclarativeGeoMapPositionIndicator::positionSource() const
+{
+    return m_positionSource;
+}
+
+void QDeclarativeGeoMapPositionIndicator::setPositionSource(QDeclarativePositionSource *source)
+{
+    if (m_positionSource == source)
+        return;
+    if (m_positionSource)
+        m_positionSource->disconnect(this);
+    m_positionSource = source;
+    if (m_positionSource) {
+        connect(m_positionSource, &QDeclarativePositionSource::positionChanged,
+                this, &QDeclarativeGeoMapPositionIndicator::onPositionChanged);
+        onPositionChanged();
+    }
+    emit positionSourceChanged();
+}
+
+/*!
+    \qmlproperty color MapPositionIndicator::color
+
+    This property holds the color of the dot and of the heading pointer.
+*/
+QColor QDeclarativeGeoMapPositionIndicator::color() const
+{
+    return m_color;
+}
+
+void QDeclarativeGeoMapPositionIndicator::setColor(const QColor &color)
+{
+    if (m_color == color)
+        return;
+    m_color = color;
+    update();
+    emit colorChanged();
+}
+
+/*!
+    \qmlproperty real MapPositionIndicator::radius
+
+    This property holds the distance, in pixels, from the position to the tip
+    of the heading pointer. The dot is about half as large. The default is 16.
+*/
+qreal QDeclarativeGeoMapPositionIndicator::radius() const
+{
+    return m_radius;
+}
+
+void QDeclarativeGeoMapPositionIndicator::setRadius(qreal radius)
+{
+    radius = qMax(qreal(0), radius);
+    if (m_radius == radius)
+        return;
+    m_radius = radius;
+    update();
+    emit radiusChanged();
+}
+
+/*!
+    \qmlproperty int MapPositionIndicator::interpolationDelay
+
+    This property holds how long, in milliseconds, the indicator is drawn
+    behind the time of the frame. With a delay as long as the time between
+    the fixes, the indicator moves between known fixes instead of ahead of
+    the last one, at the price of this latency. The default is 0.
+*/
+int QDeclarativeGeoMapPositionIndicator::interpolationDelay() const
+{
+    return m_interpolationDelay;
+}
+
+void QDeclarativeGeoMapPositionIndicator::setInterpolationDelay(int msec)
+{
+    msec = qMax(0, msec);
+    if (m_interpolationDelay == msec)
+        return;
+    m_interpolationDelay = msec;
+    update();
+    emit interpolationDelayChanged();
+}
+
+/*!
+    \qmlproperty int MapPositionIndicator::extrapolationTime
+
+    This property holds how long, in milliseconds, the indicator keeps moving
+    at its last velocity after its last fix, before stopping until the next
+    one. The default is 2000.
+*/
+int QDeclarativeGeoMapPositionIndicator::extrapolationTime() const
+{
+    return m_extrapolationTime;
+}
+
+void QDeclarativeGeoMapPositionIndicator::setExtrapolationTime(int msec)
+{
+    msec = qMax(0, msec);
+    if (m_extrapolationTime == msec)
+        return;
+    m_extrapolationTime = msec;
+    update();
+    emit extrapolationTimeChanged();
+}
+
+/*!
+    \qmlmethod void MapPositionIndicator::addFix(coordinate coordinate, real heading, date timestamp)
+
+    Adds a fix at \a coordinate, with the \a heading in degrees from the
+    north, taken at \a timestamp. Without a \a heading, no pointer is drawn.
+    Without a \a timestamp, the fix is taken now. Fixes older than the last
+    one are ignored.
+
+    \sa clearFixes()
+*/
+void QDeclarativeGeoMapPositionIndicator::addFix(const QGeoCoordinate &coordinate, qreal heading,
+                                                 const QDateTime &timestamp)
+{
+    if (!coordinate.isValid())
+        return;
+    QGeoPositionInfo info(coordinate, timestamp);
+    if (!qIsNaN(heading))
+        info.setAttribute(QGeoPositionInfo::Direction, heading);
+    m_geoShape = QGeoRectangle(coordinate, coordinate);
+    publish(info);
+}
+
+/*!
+    \qmlmethod void MapPositionIndicator::clearFixes()
+
+    Hides the indicator until the next fix.
+*/
+void QDeclarativeGeoMapPositionIndicator::clearFixes()
+{
+    m_geoShape = QGeoRectangle();
+    publishFix(Fix());
+}
+
+/*!
+    \internal
+    Hands the fix to the render thread. Unlike addFix(), it may be called
+    from the thread the position updates come from, to bypass the GUI thread
+    altogether, as long as the fixes come from one thread at a time.
+*/
+void QDeclarativeGeoMapPositionIndicator::publish(const QGeoPositionInfo &info)
+{
+    if (!info.coordinate().isValid())
+        return;
+    const QDoubleVector2D p = QWebMercator::coordToMercator(info.coordinate());
+    Fix fix;
+    fix.x = p.x();
+    fix.y = p.y();
+    if (info.hasAttribute(QGeoPositionInfo::Direction))
+        fix.heading = info.attribute(QGeoPositionInfo::Direction);
+    fix.time = info.timestamp().isValid() ? double(info.timestamp().toMSecsSinceEpoch())
+                                          : double(QDateTime::currentMSecsSinceEpoch());
+    publishFix(fix);
+}
+
+void QDeclarativeGeoMapPositionIndicator::publishFix(const Fix &fix)
+{
+    if (m_mailbox->publish(fix))
+        return; // the render thread takes it with its next frame
+
+    // The render thread is idle, a frame of the window is needed for the fix
+    if (QThread::currentThread() == thread())
+        update();
+    else
+        QMetaObject::invokeMethod(this, [this]() { update(); }, Qt::QueuedConnection);
+}
+
+void QDeclarativeGeoMapPositionIndicator::onPositionChanged()
+{
+    const QDeclarativePosition *position = m_positionSource ? m_positionSource->position() : nullptr;
+    if (!position || !position->position().coordinate().isValid())
+        return;
+    const QGeoCoordinate coordinate = position->position().coordinate();
+    m_geoShape = QGeoRectangle(coordinate, coordinate);
+    publish(position->position());
+}
+
+/*!
+    \internal
+    The last position given on the GUI thread.
+*/
+const QGeoShape &QDeclarativeGeoMapPositionIndicator::geoShape() const
+{
+    return m_geoShape;
+}
+
+/*!
+    \internal
+    The position comes from the fixes, so the shape can't be set.
+*/
+void QDeclarativeGeoMapPositionIndicator::setGeoShape(const QGeoShape &shape)
+{
+    Q_UNUSED(shape);
+    qmlWarning(this) << "The geoShape of a MapPositionIndicator is given by its fixes";
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapPositionIndicator::afterViewportChanged(const QGeoMapViewportChangeEvent &event)
+{
+    // The indicator is projected in the shader, nothing to compute here
+    if (event.mapSizeChanged)
+        updateSize();
+    update();
+}
+
+/*!
+    \internal
+*/
+QSGNode *QDeclarativeGeoMapPositionIndicator::updateMapItemPaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    PositionIndicatorNode *node = static_cast<PositionIndicatorNode *>(oldNode);
+    if (!node)
+        node = new PositionIndicatorNode(m_mailbox);
+
+    const QGeoProjection &projection = map()->geoProjection();
+    const QDoubleVector3D center = projection.centerMercator();
+    node->window = window();
+    node->geoProjection = projection.qsgTransform();
+    node->center = QDoubleVector2D(center.x(), center.y());
+    node->bearing = map()->cameraData().bearing();
+    node->color = m_color;
+    node->radius = float(m_radius);
+    node->interpolationDelay = m_interpolationDelay;
+    node->extrapolationTime = m_extrapolationTime;
+    node->advance(); // takes the fix at sync time already
+    return node;
+}
+
+void QDeclarativeGeoMapPositionIndicator::updateSize()
+{
+    // covering the whole map, the indicator is placed by the shader
+    if (!quickMap())
+        return;
+    setPosition(QPointF(0, 0));
+    setSize(QSizeF(quickMap()->width(), quickMap()->height()));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,197 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDECLARATIVEGEOMAPPOSITIONINDICATOR_P_H
+#define QDECLARATIVEGEOMAPPOSITIONINDICATOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qdeclarativegeomapitembase_p.h>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QGeoRectangle>
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QDateTime>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QColor>
+
+QT_BEGIN_NAMESPACE
+
+class QDeclarativePositionSource;
+
+/*
+    A single slot holding the latest of the values written to it, as a triple
+    buffer: the writer and the reader each own a slot, and swap it atomically
+    with the third one to publish or take a value, so neither ever waits for
+    the other. Values written before the reader took them are overwritten.
+    One writer thread and one reader thread at a time.
+*/
+template <typename T>
+class QGeoLatestValueMailbox
+{
+public:
+    // Returns false when the reader was asleep, and needs to be woken up
+    // to take the value.
+    bool publish(const T &value)
+    {
+        m_slots[m_back] = value;
+        m_back = m_middle.fetchAndStoreOrdered(m_back | Fresh) & IndexMask;
+        // A read-modify-write, so that it cannot be ordered before the store
+        // above, as setAwake() reads the slot after storing the flag
+        return m_awake.fetchAndAddOrdered(0) != 0;
+    }
+
+    bool take(T *value)
+    {
+        if (!(m_middle.loadAcquire() & Fresh))
+            return false;
+        m_front = m_middle.fetchAndStoreOrdered(m_front) & IndexMask;
+        *value = m_slots[m_front];
+        return true;
+    }
+
+    // Returns true when a value came while going to sleep, after which the
+    // reader stays awake.
+    bool setAwake(bool awake)
+    {
+        m_awake.fetchAndStoreOrdered(awake);
+        // A read-modify-write, see publish()
+        if (awake || !(m_middle.fetchAndAddOrdered(0) & Fresh))
+            return false;
+        m_awake.storeRelease(true);
+        return true;
+    }
+
+private:
+    enum { IndexMask = 3, Fresh = 4 };
+    T m_slots[3];
+    QAtomicInt m_middle { 1 };
+    QAtomicInt m_awake { 0 };
+    int m_back = 0; // of the writer
+    int m_front = 2; // of the reader
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapPositionIndicator : public QDeclarativeGeoMapItemBase
+{
+    Q_OBJECT
+    Q_PROPERTY(QDeclarativePositionSource *positionSource READ positionSource WRITE setPositionSource NOTIFY positionSourceChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(qreal radius READ radius WRITE setRadius NOTIFY radiusChanged)
+    Q_PROPERTY(int interpolationDelay READ interpolationDelay WRITE setInterpolationDelay NOTIFY interpolationDelayChanged)
+    Q_PROPERTY(int extrapolationTime READ extrapolationTime WRITE setExtrapolationTime NOTIFY extrapolationTimeChanged)
+
+public:
+    struct Fix
+    {
+        double x = qQNaN(); // mercator, NaN to hide the indicator
+        double y = qQNaN();
+        double heading = qQNaN(); // degrees from the north, NaN when unknown
+        double time = 0; // milliseconds since the epoch
+    };
+
+    explicit QDeclarativeGeoMapPositionIndicator(QQuickItem *parent = nullptr);
+    ~QDeclarativeGeoMapPositionIndicator() override;
+
+    void setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map) override;
+
+    QDeclarativePositionSource *positionSource() const;
+    void setPositionSource(QDeclarativePositionSource *source);
+
+    QColor color() const;
+    void setColor(const QColor &color);
+
+    qreal radius() const;
+    void setRadius(qreal radius);
+
+    int interpolationDelay() const;
+    void setInterpolationDelay(int msec);
+
+    int extrapolationTime() const;
+    void setExtrapolationTime(int msec);
+
+    Q_INVOKABLE void addFix(const QGeoCoordinate &coordinate, qreal heading = qQNaN(),
+                            const QDateTime &timestamp = QDateTime());
+    Q_INVOKABLE void clearFixes();
+
+    // Can be called from any thread, one at a time
+    void publish(const QGeoPositionInfo &info);
+
+    const QGeoShape &geoShape() const override;
+    void setGeoShape(const QGeoShape &shape) override;
+
+Q_SIGNALS:
+    void positionSourceChanged();
+    void colorChanged();
+    void radiusChanged();
+    void interpolationDelayChanged();
+    void extrapolationTimeChanged();
+
+protected:
+    QSGNode *updateMapItemPaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+protected Q_SLOTS:
+    void afterViewportChanged(const QGeoMapViewportChangeEvent &event) override;
+
+private Q_SLOTS:
+    void onPositionChanged();
+
+private:
+    void publishFix(const Fix &fix);
+    void updateSize();
+
+    QSharedPointer<QGeoLatestValueMailbox<Fix>> m_mailbox;
+    QPointer<QDeclarativePositionSource> m_positionSource;
+    QColor m_color = QColor(0x20, 0x7c, 0xe8);
+    qreal m_radius = 16;
+    int m_interpolationDelay = 0;
+    int m_extrapolationTime = 2000;
+    QGeoRectangle m_geoShape; // of the last fix given on the GUI thread
+};
+
+QT_END_NAMESPACE
+
+#endif // QDECLARATIVEGEOMAPPOSITIONINDICATOR_P_H
@@ -34,15 +34,22 @@
 #include <QtLocation/private/qnavigationmanager_p.h>
 #include <QtLocation/private/qnavigationmanagerengine_p.h>
 #include <QtLocation/private/qgeomapparameter_p.h>
+#include <QtLocation/private/qgeomap_p.h>
 #include <QtLocation/private/qdeclarativegeoroute_p.h>
 #include <QtLocation/private/qdeclarativegeoroutemodel_p.h>
 #include <QtLocation/private/qdeclarativegeoroutesegment_p.h>
+#include <QtLocation/qgeoroutesegment.h>
 #include <QtLocation/qgeoserviceprovider.h>
 #include <QtPositioningQuick/private/qdeclarativepositionsource_p.h>
 #include <QtQml/qqmlinfo.h>
 
 QT_BEGIN_NAMESPACE
 
+// While navigating, the map prefetches the tiles within that many meters of
+// the next kilometers of the route
+static const double CorridorRadius = 250.0;
+static const double CorridorLength = 20000.0;
+
 /*!
     \qmlmodule Qt.labs.location 1.0
     \title Qt Labs Location QML Types
@@ -95,6 +102,10 @@ QT_BEGIN_NAMESPACE
     This is a write-once property. Once the Navigator has a Map associated with
     it, any attempted modifications of the map property will be ignored.
 
+    While navigating, the map tiles along the remaining route are fetched in
+    the background, so that the map can still be shown where the network is
+    not available.
+
     \sa Map
 */
 
@@ -517,8 +528,13 @@ bool QDeclarativeNavigator::ensureEngine()
 
     connect(d_ptr->m_navigator.get(), &QAbstractNavigator::activeChanged, this, [this](bool active){
         d_ptr->m_active = active;
+        updateCorridorPrefetch();
         emit activeChanged(active);
     });
+    connect(d_ptr->m_navigator.get(), &QAbstractNavigator::currentRouteChanged,
+            this, &QDeclarativeNavigator::updateCorridorPrefetch);
+    connect(d_ptr->m_navigator.get(), &QAbstractNavigator::currentSegmentChanged,
+            this, &QDeclarativeNavigator::updateCorridorPrefetch);
     connect(this, &QDeclarativeNavigator::trackPositionSourceChanged, d_ptr->m_navigator.get(), &QAbstractNavigator::setTrackPosition);
 
     // read-only progress info updates
@@ -545,6 +561,29 @@ bool QDeclarativeNavigator::ensureEngine()
     return true;
 }
 
+// Follows the segments rather than every position update, as the corridor
+// only needs to move ahead of the map.
+void QDeclarativeNavigator::updateCorridorPrefetch()
+{
+    QDeclarativeGeoMap *declarativeMap = d_ptr->m_params->m_map;
+    QGeoMap *map = declarativeMap ? declarativeMap->map() : nullptr;
+    if (!map)
+        return;
+
+    QList<QGeoCoordinate> path;
+    if (d_ptr->m_navigator && d_ptr->m_navigator->active()) {
+        QGeoRouteSegment segment = d_ptr->m_navigator->currentRoute().firstRouteSegment();
+        for (int i = d_ptr->m_navigator->currentSegment(); i > 0 && segment.isValid(); --i)
+            segment = segment.nextRouteSegment();
+        double length = 0.0;
+        for (; segment.isValid() && length < CorridorLength; segment = segment.nextRouteSegment()) {
+            path.append(segment.path());
+            length += segment.distance();
+        }
+    }
+    map->prefetchCorridor(path, CorridorRadius);
+}
+
 void QDeclarativeNavigator::updateReadyState() {
     const bool oldReady = d_ptr->m_ready;
     if (!d_ptr->m_navigator)
@@ -168,6 +168,7 @@ protected:
     void pluginReady();
     bool ensureEngine();
     void updateReadyState();
+    void updateCorridorPrefetch();
     void setError(NavigationError error, const QString &errorString);
 
 private:
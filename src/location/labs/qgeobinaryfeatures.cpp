@@ -0,0 +1,840 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeobinaryfeatures_p.h"
+#include <QtCore/qdatastream.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qvector.h>
+#include <QtPositioning/qgeocircle.h>
+#include <QtPositioning/qgeopath.h>
+#include <QtPositioning/qgeopolygon.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+QT_BEGIN_NAMESPACE
+
+/*! \class QGeoBinaryFeatures
+    \inmodule QtLocation
+    \since 5.15
+
+    QGeoBinaryFeatures stores GeoJSON features in a compact binary format
+    that is much cheaper to load than GeoJSON text, and that can be queried
+    by bounding box without decoding the features outside of it.
+
+    The format starts with a packed R-tree of the feature bounding boxes,
+    sorted along a Hilbert curve, with 16 entries per node. It is followed
+    by a table with the offset of each feature, and by the features
+    themselves. A file opened with open() is memory mapped, and only the
+    features returned by feature(), features() or a viewport query are
+    decoded into QGeoShape objects.
+
+    Documents are converted from the QVariantList used by QGeoJson with
+    fromGeoJson(), written with encode(), and converted back with
+    toGeoJson(). The parts of a GeometryCollection are stored as a flat list
+    of shapes, like QGeoJsonReader returns them, so collections nested in a
+    collection are not kept.
+
+    WARNING! This private class is part of Qt labs, thus not stable API, it is
+    part of the experimental components of QtLocation. Until it is promoted to
+    public API, it may be subject to source and binary-breaking changes.
+
+    \sa QGeoJson, QGeoJsonReader
+*/
+
+namespace {
+
+const quint32 Magic = 0x42464751; // "QGFB"
+const quint32 Version = 1;
+
+enum {
+    NodeSize = 16,
+    HeaderSize = 48,     // magic, version, feature and level counts, extent
+    LevelSize = 8,       // first node and node count
+    NodeRecordSize = 36, // bounding box, then first child or feature index
+    OffsetSize = 8
+};
+
+// A bounding box in degrees, empty when min > max. Boxes crossing the
+// antimeridian span all longitudes.
+struct Box
+{
+    double minLongitude = std::numeric_limits<double>::infinity();
+    double minLatitude = std::numeric_limits<double>::infinity();
+    double maxLongitude = -std::numeric_limits<double>::infinity();
+    double maxLatitude = -std::numeric_limits<double>::infinity();
+
+    bool isEmpty() const
+    {
+        return minLongitude > maxLongitude || minLatitude > maxLatitude;
+    }
+
+    void unite(const Box &other)
+    {
+        minLongitude = qMin(minLongitude, other.minLongitude);
+        minLatitude = qMin(minLatitude, other.minLatitude);
+        maxLongitude = qMax(maxLongitude, other.maxLongitude);
+        maxLatitude = qMax(maxLatitude, other.maxLatitude);
+    }
+
+    bool intersects(const Box &other) const
+    {
+        return minLongitude <= other.maxLongitude && other.minLongitude <= maxLongitude
+                && minLatitude <= other.maxLatitude && other.minLatitude <= maxLatitude;
+    }
+};
+
+Box boxFor(const QGeoRectangle &rectangle)
+{
+    Box box;
+    if (!rectangle.isValid())
+        return box;
+    box.minLatitude = rectangle.bottomRight().latitude();
+    box.maxLatitude = rectangle.topLeft().latitude();
+    box.minLongitude = rectangle.topLeft().longitude();
+    box.maxLongitude = rectangle.bottomRight().longitude();
+    if (box.minLongitude > box.maxLongitude) {
+        box.minLongitude = -180.0;
+        box.maxLongitude = 180.0;
+    }
+    return box;
+}
+
+Box boxFor(const QGeoBinaryFeatures::Feature &feature)
+{
+    Box box;
+    for (const QGeoShape &shape : feature.shapes)
+        box.unite(boxFor(shape.boundingGeoRectangle()));
+    return box;
+}
+
+// Position of the box center on a Hilbert curve over the extent
+quint32 hilbertIndex(const Box &box, const Box &extent)
+{
+    if (box.isEmpty())
+        return std::numeric_limits<quint32>::max();
+
+    const quint32 n = 1u << 16;
+    const double width = qMax(extent.maxLongitude - extent.minLongitude, 1e-9);
+    const double height = qMax(extent.maxLatitude - extent.minLatitude, 1e-9);
+    quint32 x = quint32(qBound(0.0, ((box.minLongitude + box.maxLongitude) / 2 - extent.minLongitude) / width, 1.0) * (n - 1));
+    quint32 y = quint32(qBound(0.0, ((box.minLatitude + box.maxLatitude) / 2 - extent.minLatitude) / height, 1.0) * (n - 1));
+
+    quint32 index = 0;
+    for (quint32 s = n / 2; s > 0; s /= 2) {
+        const quint32 rx = (x & s) ? 1 : 0;
+        const quint32 ry = (y & s) ? 1 : 0;
+        index += s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+void configure(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+void writeBox(QDataStream &stream, const Box &box)
+{
+    stream << box.minLongitude << box.minLatitude << box.maxLongitude << box.maxLatitude;
+}
+
+void writeCoordinates(QDataStream &stream, const QList<QGeoCoordinate> &coordinates)
+{
+    stream << quint32(coordinates.size());
+    for (const QGeoCoordinate &coordinate : coordinates)
+        stream << coordinate;
+}
+
+void writeFeature(QDataStream &stream, const QGeoBinaryFeatures::Feature &feature)
+{
+    stream << feature.type << feature.id << feature.properties << quint32(feature.shapes.size());
+    for (const QGeoShape &shape : feature.shapes) {
+        stream << quint8(shape.type());
+        switch (shape.type()) {
+        case QGeoShape::RectangleType: {
+            const QGeoRectangle rectangle(shape);
+            stream << rectangle.topLeft() << rectangle.bottomRight();
+            break;
+        }
+        case QGeoShape::CircleType: {
+            const QGeoCircle circle(shape);
+            stream << circle.center() << double(circle.radius());
+            break;
+        }
+        case QGeoShape::PathType: {
+            const QGeoPath path(shape);
+            stream << double(path.width());
+            writeCoordinates(stream, path.path());
+            break;
+        }
+        case QGeoShape::PolygonType: {
+            const QGeoPolygon polygon(shape);
+            stream << quint32(1 + polygon.holesCount());
+            writeCoordinates(stream, polygon.path());
+            for (int i = 0; i < polygon.holesCount(); ++i)
+                writeCoordinates(stream, polygon.holePath(i));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+bool readCoordinates(QDataStream &stream, QList<QGeoCoordinate> *coordinates)
+{
+    quint32 count;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QGeoCoordinate coordinate;
+        stream >> coordinate;
+        coordinates->append(coordinate);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool readFeature(QDataStream &stream, QGeoBinaryFeatures::Feature *feature)
+{
+    quint32 count;
+    stream >> feature->type >> feature->id >> feature->properties >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        quint8 type;
+        stream >> type;
+        switch (type) {
+        case QGeoShape::RectangleType: {
+            QGeoCoordinate topLeft;
+            QGeoCoordinate bottomRight;
+            stream >> topLeft >> bottomRight;
+            feature->shapes.append(QGeoRectangle(topLeft, bottomRight));
+            break;
+        }
+        case QGeoShape::CircleType: {
+            QGeoCoordinate center;
+            double radius;
+            stream >> center >> radius;
+            feature->shapes.append(QGeoCircle(center, radius));
+            break;
+        }
+        case QGeoShape::PathType: {
+            double width;
+            QList<QGeoCoordinate> path;
+            stream >> width;
+            if (!readCoordinates(stream, &path))
+                return false;
+            feature->shapes.append(QGeoPath(path, width));
+            break;
+        }
+        case QGeoShape::PolygonType: {
+            quint32 rings;
+            stream >> rings;
+            QGeoPolygon polygon;
+            for (quint32 j = 0; j < rings && stream.status() == QDataStream::Ok; ++j) {
+                QList<QGeoCoordinate> ring;
+                if (!readCoordinates(stream, &ring))
+                    return false;
+                if (j == 0)
+                    polygon.setPath(ring);
+                else
+                    polygon.addHole(ring);
+            }
+            feature->shapes.append(polygon);
+            break;
+        }
+        default:
+            feature->shapes.append(QGeoShape());
+            break;
+        }
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+inline quint32 readUInt32(const uchar *data)
+{
+    return qFromLittleEndian<quint32>(data);
+}
+
+inline double readDouble(const uchar *data)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(data);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+Box readBox(const uchar *data)
+{
+    Box box;
+    box.minLongitude = readDouble(data);
+    box.minLatitude = readDouble(data + 8);
+    box.maxLongitude = readDouble(data + 16);
+    box.maxLatitude = readDouble(data + 24);
+    return box;
+}
+
+void appendShapes(const QVariantMap &geometry, QList<QGeoShape> *shapes)
+{
+    const QVariant data = geometry.value(QStringLiteral("data"));
+    if (data.type() == QVariant::List) {
+        const QVariantList parts = data.toList();
+        for (const QVariant &part : parts)
+            appendShapes(part.toMap(), shapes);
+    } else if (data.isValid()) {
+        shapes->append(data.value<QGeoShape>());
+    }
+}
+
+QGeoBinaryFeatures::Feature featureFromGeoJson(const QVariantMap &map)
+{
+    QGeoBinaryFeatures::Feature feature;
+    feature.type = map.value(QStringLiteral("type")).toString();
+    appendShapes(map, &feature.shapes);
+    feature.properties = map.value(QStringLiteral("properties")).toMap();
+    feature.id = map.value(QStringLiteral("id"));
+    return feature;
+}
+
+QVariantMap geometryToGeoJson(const QGeoShape &shape)
+{
+    QVariantMap geometry;
+    switch (shape.type()) {
+    case QGeoShape::CircleType:
+        geometry.insert(QStringLiteral("type"), QStringLiteral("Point"));
+        geometry.insert(QStringLiteral("data"), QVariant::fromValue(QGeoCircle(shape)));
+        break;
+    case QGeoShape::PathType:
+        geometry.insert(QStringLiteral("type"), QStringLiteral("LineString"));
+        geometry.insert(QStringLiteral("data"), QVariant::fromValue(QGeoPath(shape)));
+        break;
+    case QGeoShape::PolygonType:
+        geometry.insert(QStringLiteral("type"), QStringLiteral("Polygon"));
+        geometry.insert(QStringLiteral("data"), QVariant::fromValue(QGeoPolygon(shape)));
+        break;
+    default:
+        break;
+    }
+    return geometry;
+}
+
+QVariantMap featureToGeoJson(const QGeoBinaryFeatures::Feature &feature)
+{
+    QVariantMap map;
+    if (feature.type == QLatin1String("MultiPoint") || feature.type == QLatin1String("MultiLineString")
+            || feature.type == QLatin1String("MultiPolygon")
+            || feature.type == QLatin1String("GeometryCollection")) {
+        QVariantList parts;
+        for (const QGeoShape &shape : feature.shapes)
+            parts.append(geometryToGeoJson(shape));
+        map.insert(QStringLiteral("type"), feature.type);
+        map.insert(QStringLiteral("data"), parts);
+    } else if (!feature.shapes.isEmpty()) {
+        map = geometryToGeoJson(feature.shapes.first());
+    }
+    map.insert(QStringLiteral("properties"), feature.properties);
+    if (feature.id.isValid())
+        map.insert(QStringLiteral("id"), feature.id);
+    return map;
+}
+
+} // namespace
+
+class QGeoBinaryFeaturesPrivate
+{
+public:
+    bool load(const uchar *data, qint64 size);
+    void unload();
+    QGeoBinaryFeatures::Feature decode(int index) const;
+
+    QFile file;
+    uchar *mapped = nullptr;
+    QByteArray bytes;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+
+    int featureCount = 0;
+    Box extent;
+    QVector<int> levelStarts;
+    QVector<int> levelCounts;
+    qint64 offsetsPosition = 0;
+    QString errorString;
+};
+
+bool QGeoBinaryFeaturesPrivate::load(const uchar *data, qint64 size)
+{
+    if (size < HeaderSize || readUInt32(data) != Magic) {
+        errorString = QStringLiteral("Not a binary feature file");
+        return false;
+    }
+    if (readUInt32(data + 4) != Version) {
+        errorString = QStringLiteral("Unsupported binary feature file version");
+        return false;
+    }
+
+    const quint32 count = readUInt32(data + 8);
+    const quint32 levels = readUInt32(data + 12);
+    qint64 nodes = 0;
+    qint64 position = HeaderSize + qint64(levels) * LevelSize;
+    if (count > quint32(std::numeric_limits<int>::max()) || levels > 32 || position > size) {
+        errorString = QStringLiteral("Corrupted binary feature file");
+        return false;
+    }
+
+    levelStarts.clear();
+    levelCounts.clear();
+    for (quint32 i = 0; i < levels; ++i) {
+        const uchar *level = data + HeaderSize + i * LevelSize;
+        const quint32 start = readUInt32(level);
+        const quint32 levelCount = readUInt32(level + 4);
+        if (start != nodes || levelCount > count) {
+            errorString = QStringLiteral("Corrupted binary feature file");
+            return false;
+        }
+        levelStarts.append(int(start));
+        levelCounts.append(int(levelCount));
+        nodes += levelCount;
+    }
+    if ((count > 0) != (levels > 0) || (levels > 0 && quint32(levelCounts.last()) != count)) {
+        errorString = QStringLiteral("Corrupted binary feature file");
+        return false;
+    }
+
+    position += nodes * NodeRecordSize;
+    offsetsPosition = position;
+    position += qint64(count) * OffsetSize;
+    if (position > size) {
+        errorString = QStringLiteral("Corrupted binary feature file");
+        return false;
+    }
+
+    this->data = data;
+    this->size = size;
+    featureCount = int(count);
+    extent = readBox(data + 16);
+    errorString.clear();
+    return true;
+}
+
+void QGeoBinaryFeaturesPrivate::unload()
+{
+    data = nullptr;
+    size = 0;
+    featureCount = 0;
+    extent = Box();
+    levelStarts.clear();
+    levelCounts.clear();
+    bytes.clear();
+    if (mapped) {
+        file.unmap(mapped);
+        mapped = nullptr;
+    }
+    file.close();
+}
+
+QGeoBinaryFeatures::Feature QGeoBinaryFeaturesPrivate::decode(int index) const
+{
+    QGeoBinaryFeatures::Feature feature;
+    if (index < 0 || index >= featureCount)
+        return feature;
+
+    const uchar *offsets = data + offsetsPosition;
+    const quint64 begin = qFromLittleEndian<quint64>(offsets + qint64(index) * OffsetSize);
+    const quint64 end = index + 1 < featureCount
+            ? qFromLittleEndian<quint64>(offsets + qint64(index + 1) * OffsetSize) : quint64(size);
+    if (begin > end || end > quint64(size) || end - begin > quint64(std::numeric_limits<int>::max()))
+        return feature;
+
+    const QByteArray record = QByteArray::fromRawData(reinterpret_cast<const char *>(data + begin), int(end - begin));
+    QDataStream stream(record);
+    configure(stream);
+    if (!readFeature(stream, &feature))
+        return QGeoBinaryFeatures::Feature();
+    return feature;
+}
+
+/*!
+    Constructs an object without features.
+*/
+QGeoBinaryFeatures::QGeoBinaryFeatures()
+    : d_ptr(new QGeoBinaryFeaturesPrivate)
+{
+}
+
+QGeoBinaryFeatures::~QGeoBinaryFeatures()
+{
+    close();
+}
+
+/*!
+    Opens and memory maps the binary feature file \a fileName. Returns
+    \c false if the file cannot be mapped or is not valid.
+
+    \sa errorString()
+*/
+bool QGeoBinaryFeatures::open(const QString &fileName)
+{
+    Q_D(QGeoBinaryFeatures);
+    close();
+
+    d->file.setFileName(fileName);
+    if (!d->file.open(QIODevice::ReadOnly)) {
+        d->errorString = d->file.errorString();
+        return false;
+    }
+    d->mapped = d->file.map(0, d->file.size());
+    if (!d->mapped) {
+        d->errorString = d->file.errorString();
+        close();
+        return false;
+    }
+    if (!d->load(d->mapped, d->file.size())) {
+        const QString error = d->errorString;
+        close();
+        d->errorString = error;
+        return false;
+    }
+    return true;
+}
+
+/*!
+    Uses the features encoded in \a data, see encode(). Returns \c false if
+    the data is not valid.
+*/
+bool QGeoBinaryFeatures::setData(const QByteArray &data)
+{
+    Q_D(QGeoBinaryFeatures);
+    close();
+    d->bytes = data;
+    if (!d->load(reinterpret_cast<const uchar *>(d->bytes.constData()), d->bytes.size())) {
+        d->bytes.clear();
+        return false;
+    }
+    return true;
+}
+
+/*!
+    Releases the file or the data in use.
+*/
+void QGeoBinaryFeatures::close()
+{
+    Q_D(QGeoBinaryFeatures);
+    d->unload();
+}
+
+/*!
+    Returns \c true if a file or data has been loaded.
+*/
+bool QGeoBinaryFeatures::isOpen() const
+{
+    Q_D(const QGeoBinaryFeatures);
+    return d->data;
+}
+
+/*!
+    Returns the description of the last error of open() or setData().
+*/
+QString QGeoBinaryFeatures::errorString() const
+{
+    Q_D(const QGeoBinaryFeatures);
+    return d->errorString;
+}
+
+/*!
+    Returns the number of features.
+*/
+int QGeoBinaryFeatures::featureCount() const
+{
+    Q_D(const QGeoBinaryFeatures);
+    return d->featureCount;
+}
+
+/*!
+    Returns the rectangle enclosing all the features.
+*/
+QGeoRectangle QGeoBinaryFeatures::boundingGeoRectangle() const
+{
+    Q_D(const QGeoBinaryFeatures);
+    if (d->extent.isEmpty())
+        return QGeoRectangle();
+    return QGeoRectangle(QGeoCoordinate(d->extent.maxLatitude, d->extent.minLongitude),
+                         QGeoCoordinate(d->extent.minLatitude, d->extent.maxLongitude));
+}
+
+/*!
+    Decodes and returns the feature at \a index, in document order.
+*/
+QGeoBinaryFeatures::Feature QGeoBinaryFeatures::feature(int index) const
+{
+    Q_D(const QGeoBinaryFeatures);
+    return d->decode(index);
+}
+
+/*!
+    Decodes and returns all the features, in document order.
+*/
+QList<QGeoBinaryFeatures::Feature> QGeoBinaryFeatures::features() const
+{
+    Q_D(const QGeoBinaryFeatures);
+    QList<Feature> features;
+    features.reserve(d->featureCount);
+    for (int i = 0; i < d->featureCount; ++i)
+        features.append(d->decode(i));
+    return features;
+}
+
+/*!
+    Decodes and returns the features whose bounding box intersects
+    \a viewport, in document order.
+
+    \sa query()
+*/
+QList<QGeoBinaryFeatures::Feature> QGeoBinaryFeatures::features(const QGeoRectangle &viewport) const
+{
+    Q_D(const QGeoBinaryFeatures);
+    QList<Feature> features;
+    const QVector<int> indexes = query(viewport);
+    features.reserve(indexes.size());
+    for (int index : indexes)
+        features.append(d->decode(index));
+    return features;
+}
+
+/*!
+    Returns the indexes of the features whose bounding box intersects
+    \a viewport, in document order, without decoding any feature. The
+    viewport may cross the antimeridian.
+*/
+QVector<int> QGeoBinaryFeatures::query(const QGeoRectangle &viewport) const
+{
+    Q_D(const QGeoBinaryFeatures);
+    QVector<int> indexes;
+    if (!viewport.isValid() || d->featureCount == 0)
+        return indexes;
+
+    QVector<Box> ranges;
+    Box box;
+    box.minLatitude = viewport.bottomRight().latitude();
+    box.maxLatitude = viewport.topLeft().latitude();
+    box.minLongitude = viewport.topLeft().longitude();
+    box.maxLongitude = viewport.bottomRight().longitude();
+    if (box.minLongitude > box.maxLongitude) {
+        Box east = box;
+        east.maxLongitude = 180.0;
+        box.minLongitude = -180.0;
+        ranges.append(east);
+    }
+    ranges.append(box);
+
+    struct Range
+    {
+        int level;
+        int first;
+        int last;
+    };
+    const int leafLevel = d->levelCounts.size() - 1;
+    const uchar *nodes = d->data + HeaderSize + d->levelCounts.size() * LevelSize;
+    QVector<Range> stack;
+    stack.append({ 0, 0, d->levelCounts.first() });
+    while (!stack.isEmpty()) {
+        const Range range = stack.takeLast();
+        for (int node = range.first; node < range.last; ++node) {
+            const uchar *record = nodes + qint64(node) * NodeRecordSize;
+            const Box nodeBox = readBox(record);
+            if (!std::any_of(ranges.cbegin(), ranges.cend(), [&nodeBox](const Box &bounds) {
+                    return bounds.intersects(nodeBox); })) {
+                continue;
+            }
+
+            const int value = int(readUInt32(record + 32));
+            if (range.level == leafLevel) {
+                if (value >= 0 && value < d->featureCount)
+                    indexes.append(value);
+                continue;
+            }
+            const int level = range.level + 1;
+            const int levelEnd = d->levelStarts.at(level) + d->levelCounts.at(level);
+            if (value >= d->levelStarts.at(level) && value < levelEnd)
+                stack.append({ level, value, qMin(value + int(NodeSize), levelEnd) });
+        }
+    }
+    std::sort(indexes.begin(), indexes.end());
+    return indexes;
+}
+
+/*!
+    Encodes \a features into the binary format, ready to be written to a
+    file or passed to setData().
+*/
+QByteArray QGeoBinaryFeatures::encode(const QList<Feature> &features)
+{
+    const int count = features.size();
+
+    // The records come last, their offsets are fixed once the index size is known
+    QByteArray records;
+    QDataStream recordStream(&records, QIODevice::WriteOnly);
+    configure(recordStream);
+    QVector<quint64> offsets;
+    QVector<Box> boxes;
+    Box extent;
+    offsets.reserve(count);
+    boxes.reserve(count);
+    for (const Feature &feature : features) {
+        offsets.append(quint64(records.size()));
+        writeFeature(recordStream, feature);
+        boxes.append(boxFor(feature));
+        extent.unite(boxes.last());
+    }
+
+    QVector<quint32> hilbert(count);
+    for (int i = 0; i < count; ++i)
+        hilbert[i] = hilbertIndex(boxes.at(i), extent);
+    QVector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&hilbert](int a, int b) {
+        return hilbert.at(a) < hilbert.at(b);
+    });
+
+    // Levels are stored from the root to the leaves
+    QVector<int> levelCounts;
+    if (count > 0) {
+        levelCounts.prepend(count);
+        while (levelCounts.first() > 1)
+            levelCounts.prepend((levelCounts.first() + NodeSize - 1) / NodeSize);
+    }
+    QVector<int> levelStarts;
+    int nodeCount = 0;
+    for (int levelCount : qAsConst(levelCounts)) {
+        levelStarts.append(nodeCount);
+        nodeCount += levelCount;
+    }
+
+    QVector<Box> nodeBoxes(nodeCount);
+    QVector<quint32> nodeValues(nodeCount);
+    if (count > 0) {
+        const int leaves = levelStarts.last();
+        for (int i = 0; i < count; ++i) {
+            nodeBoxes[leaves + i] = boxes.at(order.at(i));
+            nodeValues[leaves + i] = quint32(order.at(i));
+        }
+    }
+    for (int level = levelCounts.size() - 2; level >= 0; --level) {
+        const int childLevelEnd = levelStarts.at(level + 1) + levelCounts.at(level + 1);
+        for (int i = 0; i < levelCounts.at(level); ++i) {
+            const int node = levelStarts.at(level) + i;
+            const int firstChild = levelStarts.at(level + 1) + i * NodeSize;
+            for (int child = firstChild; child < qMin(firstChild + int(NodeSize), childLevelEnd); ++child)
+                nodeBoxes[node].unite(nodeBoxes.at(child));
+            nodeValues[node] = quint32(firstChild);
+        }
+    }
+
+    const quint64 recordsPosition = HeaderSize + quint64(levelCounts.size()) * LevelSize
+            + quint64(nodeCount) * NodeRecordSize + quint64(count) * OffsetSize;
+
+    QByteArray data;
+    data.reserve(int(recordsPosition) + records.size());
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    configure(stream);
+    stream << Magic << Version << quint32(count) << quint32(levelCounts.size());
+    writeBox(stream, extent);
+    for (int i = 0; i < levelCounts.size(); ++i)
+        stream << quint32(levelStarts.at(i)) << quint32(levelCounts.at(i));
+    for (int i = 0; i < nodeCount; ++i) {
+        writeBox(stream, nodeBoxes.at(i));
+        stream << nodeValues.at(i);
+    }
+    for (quint64 offset : qAsConst(offsets))
+        stream << quint64(recordsPosition + offset);
+    stream.writeRawData(records.constData(), records.size());
+    return data;
+}
+
+/*!
+    Converts \a geoJson, structured like the QVariantList returned by
+    QGeoJson::importGeoJson(), into a list of features. The features of a
+    FeatureCollection are returned in order, any other document is returned
+    as a single feature.
+*/
+QList<QGeoBinaryFeatures::Feature> QGeoBinaryFeatures::fromGeoJson(const QVariantList &geoJson)
+{
+    QList<Feature> features;
+    for (const QVariant &item : geoJson) {
+        const QVariantMap map = item.toMap();
+        if (map.value(QStringLiteral("type")).toString() != QLatin1String("FeatureCollection")) {
+            features.append(featureFromGeoJson(map));
+            continue;
+        }
+        const QVariantList collection = map.value(QStringLiteral("data")).toList();
+        for (const QVariant &feature : collection)
+            features.append(featureFromGeoJson(feature.toMap()));
+    }
+    return features;
+}
+
+/*!
+    Converts \a features into a FeatureCollection structured like the
+    QVariantList returned by QGeoJson::importGeoJson(), which
+    QGeoJson::exportGeoJson() can turn back into GeoJSON.
+*/
+QVariantList QGeoBinaryFeatures::toGeoJson(const QList<Feature> &features)
+{
+    QVariantList collection;
+    collection.reserve(features.size());
+    for (const Feature &feature : features)
+        collection.append(featureToGeoJson(feature));
+
+    QVariantMap map;
+    map.insert(QStringLiteral("type"), QStringLiteral("FeatureCollection"));
+    map.insert(QStringLiteral("data"), collection);
+    return QVariantList() << map;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOBINARYFEATURES_P_H
+#define QGEOBINARYFEATURES_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qscopedpointer.h>
+#include <QtPositioning/qgeorectangle.h>
+#include <QtLocation/private/qgeojsonreader_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoBinaryFeaturesPrivate;
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoBinaryFeatures
+{
+public:
+    typedef QGeoJsonReader::Feature Feature;
+
+    QGeoBinaryFeatures();
+    ~QGeoBinaryFeatures();
+
+    bool open(const QString &fileName);
+    bool setData(const QByteArray &data);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    int featureCount() const;
+    QGeoRectangle boundingGeoRectangle() const;
+
+    Feature feature(int index) const;
+    QList<Feature> features() const;
+    QList<Feature> features(const QGeoRectangle &viewport) const;
+    QVector<int> query(const QGeoRectangle &viewport) const;
+
+    static QByteArray encode(const QList<Feature> &features);
+
+    // Conversion from and to the QVariantList used by QGeoJson
+    static QList<Feature> fromGeoJson(const QVariantList &geoJson);
+    static QVariantList toGeoJson(const QList<Feature> &features);
+
+private:
+    QScopedPointer<QGeoBinaryFeaturesPrivate> d_ptr;
+    Q_DECLARE_PRIVATE(QGeoBinaryFeatures)
+    Q_DISABLE_COPY(QGeoBinaryFeatures)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOBINARYFEATURES_P_H
@@ -84,6 +84,9 @@ QT_BEGIN_NAMESPACE
     is distinguishable from the corresponding geometry, by looking for a \c
     properties member.
 
+    For large documents, QGeoJsonReader reads the features incrementally
+    from a QIODevice, without building a QJsonDocument or the QVariant tree.
+
     \section3 Structure of the data node
 
     For the single type geometry objects (\c Point, \c LineString, and \c
@@ -1090,7 +1093,10 @@ the data converted to GeoJSON.
 
 \note This method performs no validation on the input.
 
-\sa importGeoJson
+\note The whole document is built in memory. QGeoJsonWriter writes the same
+document straight to a QIODevice instead.
+
+\sa importGeoJson, QGeoJsonWriter
 */
 QJsonDocument QGeoJson::exportGeoJson(const QVariantList &geoData)
 {
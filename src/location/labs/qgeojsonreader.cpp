@@ -0,0 +1,1032 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeojsonreader_p.h"
+#include <QtCore/qatomic.h>
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qvector.h>
+#include <QtPositioning/qgeocircle.h>
+#include <QtPositioning/qgeopath.h>
+#include <QtPositioning/qgeopolygon.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*! \class QGeoJsonReader
+    \inmodule QtLocation
+    \since 5.15
+
+    QGeoJsonReader reads GeoJSON data incrementally, one feature at a time,
+    from a QIODevice or a byte array. Unlike QGeoJson::importGeoJson(), it
+    does not need a QJsonDocument, and the geometry of each feature is
+    converted straight into QGeoShape objects. A FeatureCollection is read
+    while its features array is being parsed, so the first features are
+    available long before the end of a large document is reached, and only
+    the feature being parsed is kept in memory.
+
+    When the device is a QFile (or another QFileDevice) that can be memory
+    mapped, the data is parsed from the mapping instead of being copied.
+    Other devices are read in chunks; for sequential devices the reader
+    blocks in waitForReadyRead() until more data arrives. The device has to
+    be open and must outlive the reader.
+
+    Each call to readNext() makes the next feature available through
+    feature(). A root Feature is returned as the only feature, and so is a
+    root geometry, with empty properties. The \c type of a feature is the
+    GeoJSON type of its geometry; multipart geometries and geometry
+    collections are returned as the list of their parts, the same shapes
+    importGeoJson() puts in the nested \c data lists. Property values are
+    converted like QJsonValue::toVariant() does.
+
+    readFeatures() returns batches of features instead, decoding the members
+    of a FeatureCollection in parallel on the global QThreadPool.
+
+    WARNING! This private class is part of Qt labs, thus not stable API, it is
+    part of the experimental components of QtLocation. Until it is promoted to
+    public API, it may be subject to source and binary-breaking changes.
+
+    \sa QGeoJson
+*/
+
+namespace {
+
+enum {
+    ChunkSize = 64 * 1024,
+    MinFeaturesPerThread = 16
+};
+
+// The positions of a "coordinates" member. depth is the number of nested
+// arrays, from 1 for a Point to 4 for a MultiPolygon; shallower geometries
+// only use the first element of each outer level.
+struct Coordinates
+{
+    int depth = 0;
+    QList<QList<QList<QGeoCoordinate>>> polygons;
+};
+
+struct Geometry
+{
+    QString type;
+    Coordinates coordinates;
+    QList<QGeoShape> geometries;
+};
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isNumberChar(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+QGeoPolygon makePolygon(const QList<QList<QGeoCoordinate>> &rings)
+{
+    QGeoPolygon polygon;
+    for (int i = 0; i < rings.size(); ++i) {
+        if (i == 0)
+            polygon.setPath(rings.at(i)); // External perimeter
+        else
+            polygon.addHole(rings.at(i)); // Inner perimeters
+    }
+    return polygon;
+}
+
+} // namespace
+
+class QGeoJsonReaderPrivate
+{
+public:
+    enum State {
+        Start,
+        Root,
+        Features,
+        End,
+        Error
+    };
+
+    enum Next {
+        NoFeature,
+        ArrayFeature,
+        RootFeature
+    };
+
+    ~QGeoJsonReaderPrivate() { reset(); }
+
+    void reset();
+    Next advance();
+    bool readNext();
+    bool frameObject(QByteArray *object);
+    QList<QGeoJsonReader::Feature> readFeatures(int count);
+
+    bool readChunk();
+    bool fill(int count);
+    char peek(int offset = 0);
+    void skipWhitespace();
+    char next();
+    bool expect(char c);
+    bool setError(const QString &message);
+
+    bool readMemberName(bool *first, QString *name);
+    bool readElementStart(bool *first);
+    bool readString(QString *string);
+    bool readNumber(double *number);
+    bool readLiteral(const char *literal);
+    bool readValue(QVariant *value);
+
+    bool readPosition(QGeoCoordinate *position);
+    bool readPositions(QList<QGeoCoordinate> *positions);
+    bool readRings(QList<QList<QGeoCoordinate>> *rings);
+    bool readCoordinates(Coordinates *coordinates);
+    bool readGeometryMember(const QString &name, Geometry *geometry);
+    bool readGeometry(QString *type, QList<QGeoShape> *shapes);
+    bool finishGeometry(const Geometry &geometry, QString *type, QList<QGeoShape> *shapes);
+    bool readFeature(QGeoJsonReader::Feature *feature);
+    bool finishRoot();
+
+    QIODevice *device = nullptr;
+    uchar *mapped = nullptr;
+    QByteArray buffer;
+    int pos = 0;
+    qint64 discarded = 0;
+
+    State state = Start;
+    bool firstRootMember = true;
+    bool firstFeature = true;
+    Geometry rootGeometry;
+    QGeoJsonReader::Feature rootFeature;
+    QGeoJsonReader::Feature feature;
+    int featuresRead = 0;
+    QString errorString;
+};
+
+void QGeoJsonReaderPrivate::reset()
+{
+    buffer.clear();
+    if (mapped) {
+        static_cast<QFileDevice *>(device)->unmap(mapped);
+        mapped = nullptr;
+    }
+    device = nullptr;
+    pos = 0;
+    discarded = 0;
+    state = Start;
+    firstRootMember = true;
+    firstFeature = true;
+    rootGeometry = Geometry();
+    rootFeature = QGeoJsonReader::Feature();
+    feature = QGeoJsonReader::Feature();
+    featuresRead = 0;
+    errorString.clear();
+}
+
+// Appends the next chunk of the device to the buffer, dropping the bytes
+// already parsed. Positions are kept relative to pos, so this is safe to call
+// in the middle of a token.
+bool QGeoJsonReaderPrivate::readChunk()
+{
+    if (!device || mapped)
+        return false;
+
+    if (pos > ChunkSize) {
+        buffer.remove(0, pos);
+        discarded += pos;
+        pos = 0;
+    }
+
+    const int size = buffer.size();
+    for (;;) {
+        buffer.resize(size + ChunkSize);
+        const qint64 count = device->read(buffer.data() + size, ChunkSize);
+        buffer.resize(size + int(qMax<qint64>(count, 0)));
+        if (count > 0)
+            return true;
+        if (count < 0 || !device->isSequential() || !device->waitForReadyRead(-1))
+            return false;
+    }
+}
+
+bool QGeoJsonReaderPrivate::fill(int count)
+{
+    while (buffer.size() - pos < count) {
+        if (!readChunk())
+            return false;
+    }
+    return true;
+}
+
+char QGeoJsonReaderPrivate::peek(int offset)
+{
+    return fill(offset + 1) ? buffer.at(pos + offset) : '\0';
+}
+
+void QGeoJsonReaderPrivate::skipWhitespace()
+{
+    while (isSpace(peek()))
+        ++pos;
+}
+
+char QGeoJsonReaderPrivate::next()
+{
+    skipWhitespace();
+    return peek();
+}
+
+bool QGeoJsonReaderPrivate::expect(char c)
+{
+    if (next() != c)
+        return setError(QStringLiteral("Expected '%1'").arg(QLatin1Char(c)));
+    ++pos;
+    return true;
+}
+
+bool QGeoJsonReaderPrivate::setError(const QString &message)
+{
+    if (state != Error) {
+        errorString = QStringLiteral("%1 at offset %2").arg(message).arg(discarded + pos);
+        state = Error;
+    }
+    return false;
+}
+
+// Reads the name of the next member of an object whose opening brace has
+// been consumed. Returns false at the closing brace and on errors.
+bool QGeoJsonReaderPrivate::readMemberName(bool *first, QString *name)
+{
+    const char c = next();
+    if (c == '}') {
+        ++pos;
+        return false;
+    }
+    if (!*first) {
+        if (c != ',')
+            return setError(QStringLiteral("Expected ',' or '}'"));
+        ++pos;
+    }
+    *first = false;
+    return readString(name) && expect(':');
+}
+
+// Moves to the next element of an array whose opening bracket has been
+// consumed. Returns false at the closing bracket and on errors.
+bool QGeoJsonReaderPrivate::readElementStart(bool *first)
+{
+    const char c = next();
+    if (c == ']') {
+        ++pos;
+        return false;
+    }
+    if (!*first) {
+        if (c != ',')
+            return setError(QStringLiteral("Expected ',' or ']'"));
+        ++pos;
+    }
+    *first = false;
+    return true;
+}
+
+bool QGeoJsonReaderPrivate::readString(QString *string)
+{
+    if (!expect('"'))
+        return false;
+
+    string->clear();
+    QByteArray utf8;
+    for (;;) {
+        int end = pos;
+        const int size = buffer.size();
+        const char *data = buffer.constData();
+        while (end < size && data[end] != '"' && data[end] != '\\')
+            ++end;
+        utf8.append(data + pos, end - pos);
+        pos = end;
+        if (pos == size) {
+            if (!readChunk())
+                return setError(QStringLiteral("Unterminated string"));
+            continue;
+        }
+
+        const char c = buffer.at(pos++);
+        if (c == '"')
+            break;
+        if (!fill(1))
+            return setError(QStringLiteral("Unterminated string"));
+
+        const char escaped = buffer.at(pos++);
+        switch (escaped) {
+        case '"':
+        case '\\':
+        case '/':
+            utf8.append(escaped);
+            break;
+        case 'b':
+            utf8.append('\b');
+            break;
+        case 'f':
+            utf8.append('\f');
+            break;
+        case 'n':
+            utf8.append('\n');
+            break;
+        case 'r':
+            utf8.append('\r');
+            break;
+        case 't':
+            utf8.append('\t');
+            break;
+        case 'u': {
+            bool ok = false;
+            const ushort unit = fill(4) ? buffer.mid(pos, 4).toUShort(&ok, 16) : 0;
+            if (!ok)
+                return setError(QStringLiteral("Invalid escape sequence"));
+            pos += 4;
+            // Surrogate pairs arrive as two escapes and combine in the QString
+            string->append(QString::fromUtf8(utf8));
+            string->append(QChar(unit));
+            utf8.clear();
+            break;
+        }
+        default:
+            return setError(QStringLiteral("Invalid escape sequence"));
+        }
+    }
+    string->append(QString::fromUtf8(utf8));
+    return true;
+}
+
+bool QGeoJsonReaderPrivate::readNumber(double *number)
+{
+    skipWhitespace();
+    int length = 0;
+    while (isNumberChar(peek(length)))
+        ++length;
+
+    bool ok = false;
+    if (length > 0)
+        *number = buffer.mid(pos, length).toDouble(&ok);
+    if (!ok)
+        return setError(QStringLiteral("Invalid number"));
+    pos += length;
+    return true;
+}
+
+bool QGeoJsonReaderPrivate::readLiteral(const char *literal)
+{
+    skipWhitespace();
+    const int length = int(qstrlen(literal));
+    if (!fill(length) || qstrncmp(buffer.constData() + pos, literal, uint(length)) != 0)
+        return setError(QStringLiteral("Invalid value"));
+    pos += length;
+    return true;
+}
+
+bool QGeoJsonReaderPrivate::readValue(QVariant *value)
+{
+    switch (next()) {
+    case '{': {
+        ++pos;
+        QVariantMap map;
+        QString name;
+        bool first = true;
+        while (readMemberName(&first, &name)) {
+            QVariant member;
+            if (!readValue(&member))
+                return false;
+            map.insert(name, member);
+        }
+        *value = map;
+        return state != Error;
+    }
+    case '[': {
+        ++pos;
+        QVariantList list;
+        bool first = true;
+        while (readElementStart(&first)) {
+            QVariant element;
+            if (!readValue(&element))
+                return false;
+            list.append(element);
+        }
+        *value = list;
+        return state != Error;
+    }
+    case '"': {
+        QString string;
+        if (!readString(&string))
+            return false;
+        *value = string;
+        return true;
+    }
+    case 't':
+        *value = true;
+        return readLiteral("true");
+    case 'f':
+        *value = false;
+        return readLiteral("false");
+    case 'n':
+        *value = QVariant::fromValue(nullptr);
+        return readLiteral("null");
+    default: {
+        double number;
+        if (!readNumber(&number))
+            return false;
+        *value = number;
+        return true;
+    }
+    }
+}
+
+bool QGeoJsonReaderPrivate::readPosition(QGeoCoordinate *position)
+{
+    if (!expect('['))
+        return false;
+
+    bool first = true;
+    for (int i = 0; readElementStart(&first); ++i) {
+        double value;
+        if (!readNumber(&value))
+            return false;
+        switch (i) {
+        case 0:
+            position->setLongitude(value);
+            break;
+        case 1:
+            position->setLatitude(value);
+            break;
+        case 2:
+            position->setAltitude(value);
+            break;
+        default:
+            break;
+        }
+    }
+    return state != Error;
+}
+
+bool QGeoJsonReaderPrivate::readPositions(QList<QGeoCoordinate> *positions)
+{
+    if (!expect('['))
+        return false;
+
+    bool first = true;
+    while (readElementStart(&first)) {
+        QGeoCoordinate position;
+        if (!readPosition(&position))
+            return false;
+        positions->append(position);
+    }
+    return state != Error;
+}
+
+bool QGeoJsonReaderPrivate::readRings(QList<QList<QGeoCoordinate>> *rings)
+{
+    if (!expect('['))
+        return false;
+
+    bool first = true;
+    while (readElementStart(&first)) {
+        QList<QGeoCoordinate> ring;
+        if (!readPositions(&ring))
+            return false;
+        rings->append(ring);
+    }
+    return state != Error;
+}
+
+bool QGeoJsonReaderPrivate::readCoordinates(Coordinates *coordinates)
+{
+    // The nesting depth is known from the leading brackets, before the
+    // geometry type, which may come later in the object.
+    skipWhitespace();
+    int depth = 0;
+    for (int i = 0;; ++i) {
+        const char c = peek(i);
+        if (c == '[')
+            ++depth;
+        else if (!isSpace(c))
+            break;
+    }
+
+    coordinates->depth = depth;
+    coordinates->polygons.clear();
+    switch (depth) {
+    case 1: {
+        QGeoCoordinate position;
+        if (!readPosition(&position))
+            return false;
+        coordinates->polygons.append(QList<QList<QGeoCoordinate>>{QList<QGeoCoordinate>{position}});
+        return true;
+    }
+    case 2: {
+        QList<QGeoCoordinate> positions;
+        if (!readPositions(&positions))
+            return false;
+        coordinates->polygons.append(QList<QList<QGeoCoordinate>>{positions});
+        return true;
+    }
+    case 3: {
+        QList<QList<QGeoCoordinate>> rings;
+        if (!readRings(&rings))
+            return false;
+        coordinates->polygons.append(rings);
+        return true;
+    }
+    case 4: {
+        if (!expect('['))
+            return false;
+        bool first = true;
+        while (readElementStart(&first)) {
+            QList<QList<QGeoCoordinate>> rings;
+            if (!readRings(&rings))
+                return false;
+            coordinates->polygons.append(rings);
+        }
+        return state != Error;
+    }
+    default:
+        return setError(QStringLiteral("Invalid coordinates"));
+    }
+}
+
+bool QGeoJsonReaderPrivate::readGeometryMember(const QString &name, Geometry *geometry)
+{
+    if (name == QLatin1String("type"))
+        return readString(&geometry->type);
+    if (name == QLatin1String("coordinates"))
+        return readCoordinates(&geometry->coordinates);
+    if (name == QLatin1String("geometries")) {
+        if (!expect('['))
+            return false;
+        bool first = true;
+        while (readElementStart(&first)) {
+            QString type;
+            if (!readGeometry(&type, &geometry->geometries))
+                return false;
+        }
+        return state != Error;
+    }
+    QVariant ignored;
+    return readValue(&ignored);
+}
+
+// Reads a geometry object, or null, and appends its shapes.
+bool QGeoJsonReaderPrivate::readGeometry(QString *type, QList<QGeoShape> *shapes)
+{
+    if (next() == 'n')
+        return readLiteral("null");
+    if (!expect('{'))
+        return false;
+
+    Geometry geometry;
+    QString name;
+    bool first = true;
+    while (readMemberName(&first, &name)) {
+        if (!readGeometryMember(name, &geometry))
+            return false;
+    }
+    return state != Error && finishGeometry(geometry, type, shapes);
+}
+
+bool QGeoJsonReaderPrivate::finishGeometry(const Geometry &geometry, QString *type, QList<QGeoShape> *shapes)
+{
+    *type = geometry.type;
+    if (geometry.type == QLatin1String("GeometryCollection")) {
+        shapes->append(geometry.geometries);
+        return true;
+    }
+
+    const Coordinates &coordinates = geometry.coordinates;
+    if (geometry.type == QLatin1String("Point") && coordinates.depth == 1) {
+        shapes->append(QGeoCircle(coordinates.polygons.at(0).at(0).at(0)));
+    } else if (geometry.type == QLatin1String("MultiPoint") && coordinates.depth == 2) {
+        for (const QGeoCoordinate &position : coordinates.polygons.at(0).at(0))
+            shapes->append(QGeoCircle(position));
+    } else if (geometry.type == QLatin1String("LineString") && coordinates.depth == 2) {
+        shapes->append(QGeoPath(coordinates.polygons.at(0).at(0)));
+    } else if (geometry.type == QLatin1String("MultiLineString") && coordinates.depth == 3) {
+        for (const QList<QGeoCoordinate> &path : coordinates.polygons.at(0))
+            shapes->append(QGeoPath(path));
+    } else if (geometry.type == QLatin1String("Polygon") && coordinates.depth == 3) {
+        shapes->append(makePolygon(coordinates.polygons.at(0)));
+    } else if (geometry.type == QLatin1String("MultiPolygon") && coordinates.depth == 4) {
+        for (const QList<QList<QGeoCoordinate>> &rings : coordinates.polygons)
+            shapes->append(makePolygon(rings));
+    } else {
+        return setError(QStringLiteral("Invalid %1 geometry").arg(geometry.type));
+    }
+    return true;
+}
+
+bool QGeoJsonReaderPrivate::readFeature(QGeoJsonReader::Feature *feature)
+{
+    *feature = QGeoJsonReader::Feature();
+    if (!expect('{'))
+        return false;
+
+    QString name;
+    bool first = true;
+    while (readMemberName(&first, &name)) {
+        bool ok;
+        if (name == QLatin1String("geometry")) {
+            ok = readGeometry(&feature->type, &feature->shapes);
+        } else if (name == QLatin1String("id")) {
+            ok = readValue(&feature->id);
+        } else {
+            QVariant value;
+            ok = readValue(&value);
+            if (ok && name == QLatin1String("properties"))
+                feature->properties = value.toMap();
+        }
+        if (!ok)
+            return false;
+    }
+    return state != Error;
+}
+
+// Called at the end of the root object, returns whether it was a feature or
+// a geometry, which is then the only feature of the document.
+bool QGeoJsonReaderPrivate::finishRoot()
+{
+    state = End;
+    if (rootGeometry.type == QLatin1String("FeatureCollection"))
+        return false;
+
+    if (rootGeometry.type == QLatin1String("Feature")) {
+        feature = rootFeature;
+    } else {
+        feature = QGeoJsonReader::Feature();
+        if (!finishGeometry(rootGeometry, &feature.type, &feature.shapes))
+            return false;
+    }
+    ++featuresRead;
+    return true;
+}
+
+// Parses the root object up to the next feature. Returns ArrayFeature when
+// positioned at an element of the features array, and RootFeature when the
+// root object itself was the feature.
+QGeoJsonReaderPrivate::Next QGeoJsonReaderPrivate::advance()
+{
+    if (state == Start) {
+        // Skip a UTF-8 byte order mark
+        if (fill(3) && buffer.startsWith("\xEF\xBB\xBF"))
+            pos += 3;
+        if (!expect('{'))
+            return NoFeature;
+        state = Root;
+    }
+
+    for (;;) {
+        if (state == Features) {
+            if (readElementStart(&firstFeature))
+                return ArrayFeature;
+            if (state == Error)
+                return NoFeature;
+            // Back to the remaining members of the root object
+            state = Root;
+        }
+        if (state != Root)
+            return NoFeature;
+
+        QString name;
+        if (!readMemberName(&firstRootMember, &name))
+            return state != Error && finishRoot() ? RootFeature : NoFeature;
+
+        bool ok;
+        if (name == QLatin1String("features")) {
+            ok = expect('[');
+            if (ok)
+                state = Features;
+        } else if (name == QLatin1String("geometry")) {
+            ok = readGeometry(&rootFeature.type, &rootFeature.shapes);
+        } else if (name == QLatin1String("id")) {
+            ok = readValue(&rootFeature.id);
+        } else if (name == QLatin1String("properties")) {
+            QVariant value;
+            ok = readValue(&value);
+            rootFeature.properties = value.toMap();
+        } else {
+            ok = readGeometryMember(name, &rootGeometry);
+        }
+        if (!ok)
+            return NoFeature;
+    }
+}
+
+bool QGeoJsonReaderPrivate::readNext()
+{
+    switch (advance()) {
+    case ArrayFeature:
+        if (!readFeature(&feature))
+            return false;
+        ++featuresRead;
+        return true;
+    case RootFeature:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Returns the bytes of the object at pos without decoding them, for another
+// reader to decode.
+bool QGeoJsonReaderPrivate::frameObject(QByteArray *object)
+{
+    if (next() != '{')
+        return setError(QStringLiteral("Expected '{'"));
+
+    int depth = 0;
+    bool inString = false;
+    int length = 0;
+    for (;; ++length) {
+        if (!fill(length + 1))
+            return setError(QStringLiteral("Unexpected end of data"));
+        const char c = buffer.at(pos + length);
+        if (inString) {
+            if (c == '\\')
+                ++length;
+            else if (c == '"')
+                inString = false;
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if ((c == '}' || c == ']') && --depth == 0) {
+            ++length;
+            break;
+        }
+    }
+
+    // Without a device the buffer is never compacted, so it can be shared
+    if (!device || mapped)
+        *object = QByteArray::fromRawData(buffer.constData() + pos, length);
+    else
+        *object = buffer.mid(pos, length);
+    pos += length;
+    return true;
+}
+
+QList<QGeoJsonReader::Feature> QGeoJsonReaderPrivate::readFeatures(int count)
+{
+    QVector<QByteArray> objects;
+    while (count <= 0 || objects.size() < count) {
+        const Next found = advance();
+        if (found == RootFeature && objects.isEmpty())
+            return { feature };
+        if (found != ArrayFeature)
+            break;
+        QByteArray object;
+        if (!frameObject(&object))
+            break;
+        objects.append(object);
+    }
+
+    QVector<QGeoJsonReader::Feature> decoded(objects.size());
+    QVector<QString> errors(objects.size());
+    QAtomicInt nextObject(0);
+    auto work = [&objects, &decoded, &errors, &nextObject]() {
+        for (int i = nextObject.fetchAndAddRelaxed(1); i < objects.size(); i = nextObject.fetchAndAddRelaxed(1)) {
+            QGeoJsonReaderPrivate reader;
+            reader.buffer = objects.at(i);
+            if (!reader.readFeature(&decoded[i]))
+                errors[i] = reader.errorString;
+        }
+    };
+
+    // Only use threads that are free right away, this may itself run on a pool thread
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    int helpers = 0;
+    for (int i = 1; i < qMin(pool->maxThreadCount(), objects.size() / MinFeaturesPerThread); ++i) {
+        QRunnable *task = QRunnable::create([&work, &done]() {
+            work();
+            done.release();
+        });
+        if (!pool->tryStart(task)) {
+            delete task;
+            break;
+        }
+        ++helpers;
+    }
+    work();
+    done.acquire(helpers);
+
+    QList<QGeoJsonReader::Feature> features;
+    features.reserve(decoded.size());
+    for (int i = 0; i < decoded.size(); ++i) {
+        if (!errors.at(i).isEmpty()) {
+            errorString = QStringLiteral("%1 in feature %2").arg(errors.at(i)).arg(featuresRead);
+            state = Error;
+            break;
+        }
+        features.append(decoded.at(i));
+        ++featuresRead;
+    }
+    if (!features.isEmpty())
+        feature = features.last();
+    return features;
+}
+
+/*!
+    Constructs a reader without data.
+
+    \sa setDevice(), setData()
+*/
+QGeoJsonReader::QGeoJsonReader()
+    : d_ptr(new QGeoJsonReaderPrivate)
+{
+}
+
+/*!
+    Constructs a reader that reads from \a device.
+*/
+QGeoJsonReader::QGeoJsonReader(QIODevice *device)
+    : d_ptr(new QGeoJsonReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Constructs a reader that reads from \a data.
+*/
+QGeoJsonReader::QGeoJsonReader(const QByteArray &data)
+    : d_ptr(new QGeoJsonReaderPrivate)
+{
+    setData(data);
+}
+
+QGeoJsonReader::~QGeoJsonReader()
+{
+}
+
+/*!
+    Restarts the reader on \a device, which has to be open for reading. The
+    data is read from the current position of the device.
+
+    If the device is a QFileDevice that can be memory mapped, the remaining
+    content is mapped and parsed in place.
+*/
+void QGeoJsonReader::setDevice(QIODevice *device)
+{
+    Q_D(QGeoJsonReader);
+    d->reset();
+    d->device = device;
+
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if (!file || file->isSequential() || !file->isReadable())
+        return;
+
+    const qint64 offset = file->pos();
+    const qint64 size = file->size() - offset;
+    if (size <= 0 || size > std::numeric_limits<int>::max())
+        return;
+
+    d->mapped = file->map(offset, size);
+    if (d->mapped)
+        d->buffer = QByteArray::fromRawData(reinterpret_cast<const char *>(d->mapped), int(size));
+}
+
+/*!
+    Returns the device the reader reads from, or \c nullptr.
+*/
+QIODevice *QGeoJsonReader::device() const
+{
+    Q_D(const QGeoJsonReader);
+    return d->device;
+}
+
+/*!
+    Restarts the reader on the complete GeoJSON document in \a data.
+*/
+void QGeoJsonReader::setData(const QByteArray &data)
+{
+    Q_D(QGeoJsonReader);
+    d->reset();
+    d->buffer = data;
+}
+
+/*!
+    Reads the next feature. Returns \c true when a feature was read, and
+    \c false at the end of the document or on errors.
+
+    \sa feature(), hasError()
+*/
+bool QGeoJsonReader::readNext()
+{
+    Q_D(QGeoJsonReader);
+    if (d->state == QGeoJsonReaderPrivate::End || d->state == QGeoJsonReaderPrivate::Error)
+        return false;
+    return d->readNext();
+}
+
+/*!
+    Reads up to \a count features, or all the remaining ones when \a count
+    is 0, and returns them in document order.
+
+    The features are first framed, which only finds where each one ends, and
+    then decoded on the threads of the global QThreadPool that are free. This
+    is much faster than readNext() for large feature collections on multicore
+    machines, while the memory used stays bounded by \a count.
+
+    On errors, the features before the invalid one are returned and
+    hasError() returns \c true.
+
+    \sa readNext()
+*/
+QList<QGeoJsonReader::Feature> QGeoJsonReader::readFeatures(int count)
+{
+    Q_D(QGeoJsonReader);
+    if (d->state == QGeoJsonReaderPrivate::End || d->state == QGeoJsonReaderPrivate::Error)
+        return QList<Feature>();
+    return d->readFeatures(count);
+}
+
+/*!
+    Returns the feature read by the last successful call to readNext().
+*/
+const QGeoJsonReader::Feature &QGeoJsonReader::feature() const
+{
+    Q_D(const QGeoJsonReader);
+    return d->feature;
+}
+
+/*!
+    Returns the number of features read so far.
+*/
+int QGeoJsonReader::featuresRead() const
+{
+    Q_D(const QGeoJsonReader);
+    return d->featuresRead;
+}
+
+/*!
+    Returns \c true when the whole document has been read, or reading
+    stopped on an error.
+*/
+bool QGeoJsonReader::atEnd() const
+{
+    Q_D(const QGeoJsonReader);
+    return d->state == QGeoJsonReaderPrivate::End || d->state == QGeoJsonReaderPrivate::Error;
+}
+
+/*!
+    Returns \c true if the data is not valid GeoJSON, or ended prematurely.
+*/
+bool QGeoJsonReader::hasError() const
+{
+    Q_D(const QGeoJsonReader);
+    return d->state == QGeoJsonReaderPrivate::Error;
+}
+
+/*!
+    Returns a description of the error, including the offset in the data
+    where it was found.
+*/
+QString QGeoJsonReader::errorString() const
+{
+    Q_D(const QGeoJsonReader);
+    return d->errorString;
+}
+
+QT_END_NAMESPACE
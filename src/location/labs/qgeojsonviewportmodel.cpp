@@ -0,0 +1,570 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeojsonviewportmodel_p.h"
+#include <QtLocation/private/qgeojsonreader_p.h>
+#include <QtLocation/private/qgeosimplify_p.h>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QPointer>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtQml/QJSValue>
+#include <QtQml/QQmlFile>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype GeoJsonViewportModel
+    \instantiates QGeoJsonViewportModel
+    \inqmlmodule Qt.labs.location
+    \ingroup qml-QtLocation5-maps
+
+    \brief The GeoJsonViewportModel type provides the GeoJSON features
+    intersecting the visible region of a Map.
+
+    Binding the output of \c importGeoJson() to a MapItemView or a
+    MapObjectView creates a delegate for every feature up front. A
+    GeoJsonViewportModel instead keeps the features in a spatial index, see
+    QGeoBinaryFeatures, and its rows are only the features whose bounding box
+    intersects \l visibleRegion. Features are decoded into shapes when they
+    enter the region, and their rows are removed when they leave it.
+
+    The region used for the query is the visible region grown by \l margin on
+    each side. It is only queried again when the visible region is no longer
+    inside of it, or when it is much smaller than it after zooming in, so
+    small pans do not change the rows.
+
+    Polygons also get a minimum zoom level: the first level at which the
+    zoom-level-aware simplification used to draw polygons keeps enough
+    vertices of their outline to draw more than a line. Features are not
+    shown below their minimum zoom level, so that zoomed-out views of a
+    continent do not instantiate delegates for the smallest islands. The zoom
+    threshold only changes a quarter of a level past an integer zoom level.
+
+    The features are read either from \l geoJson, or from the file at
+    \l source. The file can contain GeoJSON, read by QGeoJsonReader, or the
+    binary format of QGeoBinaryFeatures, which is memory mapped. Files are
+    loaded, and the index is built, on a worker thread; \l status is
+    \c GeoJsonViewportModel.Loading meanwhile.
+
+    The roles of the model are \c type, the GeoJSON geometry type of the
+    feature, \c shape, its first QGeoShape, \c shapes, the list of all its
+    shapes, \c properties and \c featureId.
+
+    \section2 Example Usage
+
+    \code
+    Map {
+        id: map
+        MapItemView {
+            model: GeoJsonViewportModel {
+                source: "file:///data/boundaries.json"
+                visibleRegion: map.visibleRegion
+                zoomLevel: map.zoomLevel
+            }
+            delegate: MapPolygon {
+                geoShape: model.shape
+                color: "#4000ff00"
+            }
+        }
+    }
+    \endcode
+*/
+
+struct QGeoJsonViewportModel::Load
+{
+    // Input
+    QList<QGeoBinaryFeatures::Feature> features;
+    QString fileName;
+
+    // Output, either encoded features or the name of a binary feature file
+    QByteArray encoded;
+    QString binaryFileName;
+    QVector<quint8> minimumZoomLevels;
+    QString errorString;
+};
+
+namespace {
+
+// An outline is worth drawing once the simplification keeps two vertices
+// besides its endpoints, or one when the ring is not closed.
+quint8 minimumZoomLevel(const QGeoBinaryFeatures::Feature &feature)
+{
+    quint8 level = QGeoSimplify::significanceNever;
+    for (const QGeoShape &shape : feature.shapes) {
+        if (shape.type() != QGeoShape::PolygonType)
+            return 0;
+
+        const QList<QGeoCoordinate> perimeter = QGeoPolygon(shape).path();
+        const int needed = (perimeter.size() > 1 && perimeter.first() == perimeter.last()) ? 2 : 1;
+        if (perimeter.size() < 2 + needed)
+            return 0;
+
+        QList<QDoubleVector2D> points;
+        points.reserve(perimeter.size());
+        for (const QGeoCoordinate &coordinate : perimeter)
+            points.append(QWebMercator::coordToMercator(coordinate));
+        QVector<quint8> significance = QGeoSimplify::zoomLevelSignificance(points, 0.0);
+        std::nth_element(significance.begin() + 1, significance.begin() + needed, significance.end() - 1);
+        level = qMin(level, significance.at(needed));
+    }
+    return feature.shapes.isEmpty() ? 0 : level;
+}
+
+void indexFeatures(QGeoJsonViewportModel::Load *load)
+{
+    load->minimumZoomLevels.reserve(load->features.size());
+    for (const QGeoBinaryFeatures::Feature &feature : qAsConst(load->features))
+        load->minimumZoomLevels.append(minimumZoomLevel(feature));
+    load->encoded = QGeoBinaryFeatures::encode(load->features);
+    load->features.clear();
+}
+
+void readFile(QGeoJsonViewportModel::Load *load)
+{
+    QFile file(load->fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        load->errorString = file.errorString();
+        return;
+    }
+
+    if (file.peek(4) == QByteArrayLiteral("QGFB")) {
+        QGeoBinaryFeatures binary;
+        if (!binary.open(load->fileName)) {
+            load->errorString = binary.errorString();
+            return;
+        }
+        load->minimumZoomLevels.reserve(binary.featureCount());
+        for (int i = 0; i < binary.featureCount(); ++i)
+            load->minimumZoomLevels.append(minimumZoomLevel(binary.feature(i)));
+        load->binaryFileName = load->fileName;
+        return;
+    }
+
+    QGeoJsonReader reader(&file);
+    for (;;) {
+        const QList<QGeoJsonReader::Feature> features = reader.readFeatures(4096);
+        if (features.isEmpty())
+            break;
+        load->features += features;
+    }
+    if (reader.hasError()) {
+        load->errorString = reader.errorString();
+        load->features.clear();
+        return;
+    }
+    indexFeatures(load);
+}
+
+QGeoRectangle grown(const QGeoRectangle &rectangle, qreal margin)
+{
+    const double width = rectangle.width() * (1.0 + 2.0 * margin);
+    const double north = qMin(rectangle.topLeft().latitude() + rectangle.height() * margin, 90.0);
+    const double south = qMax(rectangle.bottomRight().latitude() - rectangle.height() * margin, -90.0);
+    if (width >= 360.0)
+        return QGeoRectangle(QGeoCoordinate(north, -180.0), QGeoCoordinate(south, 180.0));
+
+    const double west = QLocationUtils::wrapLong(rectangle.topLeft().longitude() - rectangle.width() * margin);
+    const double east = QLocationUtils::wrapLong(west + width);
+    return QGeoRectangle(QGeoCoordinate(north, west), QGeoCoordinate(south, east));
+}
+
+} // namespace
+
+QGeoJsonViewportModel::QGeoJsonViewportModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+QGeoJsonViewportModel::~QGeoJsonViewportModel()
+{
+}
+
+/*!
+    \qmlproperty variant QtLocation::GeoJsonViewportModel::geoJson
+
+    The features, structured like the list returned by \c importGeoJson().
+*/
+QVariant QGeoJsonViewportModel::geoJson() const
+{
+    return m_geoJson;
+}
+
+void QGeoJsonViewportModel::setGeoJson(const QVariant &geoJson)
+{
+    if (geoJson == m_geoJson)
+        return;
+    m_geoJson = geoJson;
+    emit geoJsonChanged();
+
+    QSharedPointer<Load> load(new Load);
+    QVariant list = geoJson;
+    if (list.userType() == qMetaTypeId<QJSValue>())
+        list = list.value<QJSValue>().toVariant();
+    load->features = QGeoBinaryFeatures::fromGeoJson(list.toList());
+    startLoad(load);
+}
+
+/*!
+    \qmlproperty url QtLocation::GeoJsonViewportModel::source
+
+    A local file containing GeoJSON, or features in the binary format of
+    QGeoBinaryFeatures.
+*/
+QUrl QGeoJsonViewportModel::source() const
+{
+    return m_source;
+}
+
+void QGeoJsonViewportModel::setSource(const QUrl &source)
+{
+    if (source == m_source)
+        return;
+    m_source = source;
+    emit sourceChanged();
+
+    QSharedPointer<Load> load(new Load);
+    load->fileName = QQmlFile::urlToLocalFileOrQrc(source);
+    startLoad(load);
+}
+
+/*!
+    \qmlproperty geoshape QtLocation::GeoJsonViewportModel::visibleRegion
+
+    The region in which features are shown, usually bound to the
+    \l {Map::visibleRegion} {visibleRegion} of the Map.
+*/
+QGeoShape QGeoJsonViewportModel::visibleRegion() const
+{
+    return m_visibleRegion;
+}
+
+void QGeoJsonViewportModel::setVisibleRegion(const QGeoShape &region)
+{
+    const QGeoRectangle rectangle = region.boundingGeoRectangle();
+    if (rectangle == m_visibleRegion)
+        return;
+    m_visibleRegion = rectangle;
+    emit visibleRegionChanged();
+    updateRows();
+}
+
+/*!
+    \qmlproperty real QtLocation::GeoJsonViewportModel::zoomLevel
+
+    The zoom level used to compare against the minimum zoom level of the
+    features, usually bound to the \l {Map::zoomLevel} {zoomLevel} of the Map.
+*/
+qreal QGeoJsonViewportModel::zoomLevel() const
+{
+    return m_zoomLevel;
+}
+
+void QGeoJsonViewportModel::setZoomLevel(qreal zoomLevel)
+{
+    if (zoomLevel == m_zoomLevel)
+        return;
+    m_zoomLevel = zoomLevel;
+    emit zoomLevelChanged();
+    if (updateZoomThreshold())
+        updateRows(true);
+}
+
+/*!
+    \qmlproperty real QtLocation::GeoJsonViewportModel::margin
+
+    The fraction of the width and height of the visible region by which the
+    queried region extends past each side of it. The default is 0.5.
+*/
+qreal QGeoJsonViewportModel::margin() const
+{
+    return m_margin;
+}
+
+void QGeoJsonViewportModel::setMargin(qreal margin)
+{
+    margin = qMax<qreal>(margin, 0.0);
+    if (margin == m_margin)
+        return;
+    m_margin = margin;
+    emit marginChanged();
+    updateRows(true);
+}
+
+/*!
+    \qmlproperty int QtLocation::GeoJsonViewportModel::featureCount
+
+    The number of features loaded, shown or not.
+*/
+int QGeoJsonViewportModel::featureCount() const
+{
+    return m_features.featureCount();
+}
+
+/*!
+    \qmlproperty enumeration QtLocation::GeoJsonViewportModel::status
+
+    \list
+    \li GeoJsonViewportModel.Null - No features have been set.
+    \li GeoJsonViewportModel.Loading - The features are being loaded.
+    \li GeoJsonViewportModel.Ready - The features are loaded.
+    \li GeoJsonViewportModel.Error - The features could not be loaded, see
+        \l errorString.
+    \endlist
+*/
+QGeoJsonViewportModel::Status QGeoJsonViewportModel::status() const
+{
+    return m_status;
+}
+
+/*!
+    \qmlproperty string QtLocation::GeoJsonViewportModel::errorString
+
+    The reason why the features could not be loaded.
+*/
+QString QGeoJsonViewportModel::errorString() const
+{
+    return m_errorString;
+}
+
+int QGeoJsonViewportModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant QGeoJsonViewportModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_shown.size())
+        return QVariant();
+
+    const QGeoBinaryFeatures::Feature &feature = m_shown.at(index.row());
+    switch (role) {
+    case TypeRole:
+        return feature.type;
+    case ShapeRole:
+        return feature.shapes.isEmpty() ? QVariant() : QVariant::fromValue(feature.shapes.first());
+    case ShapesRole: {
+        QVariantList shapes;
+        for (const QGeoShape &shape : feature.shapes)
+            shapes.append(QVariant::fromValue(shape));
+        return shapes;
+    }
+    case PropertiesRole:
+        return feature.properties;
+    case FeatureIdRole:
+        return feature.id;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> QGeoJsonViewportModel::roleNames() const
+{
+    return {
+        { TypeRole, "type" },
+        { ShapeRole, "shape" },
+        { ShapesRole, "shapes" },
+        { PropertiesRole, "properties" },
+        { FeatureIdRole, "featureId" }
+    };
+}
+
+/*!
+    \qmlmethod int QtLocation::GeoJsonViewportModel::featureIndex(int row)
+
+    Returns the position of the feature shown in \a row among all the
+    features, or -1.
+*/
+int QGeoJsonViewportModel::featureIndex(int row) const
+{
+    return row >= 0 && row < m_rows.size() ? m_rows.at(row) : -1;
+}
+
+void QGeoJsonViewportModel::startLoad(const QSharedPointer<Load> &load)
+{
+    // A newer load supersedes the one in flight, whose result is then simply dropped
+    m_pendingLoad = load;
+    setStatus(Loading);
+    const QPointer<QGeoJsonViewportModel> model(this);
+    QThreadPool::globalInstance()->start(QRunnable::create([load, model]() {
+        if (load->fileName.isEmpty())
+            indexFeatures(load.data());
+        else
+            readFile(load.data());
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [load, model]() {
+            if (model)
+                model->adoptLoad(load);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void QGeoJsonViewportModel::adoptLoad(const QSharedPointer<Load> &load)
+{
+    if (load != m_pendingLoad)
+        return; // dropped meanwhile
+    m_pendingLoad.reset();
+
+    beginResetModel();
+    m_rows.clear();
+    m_shown.clear();
+    m_loadedRegion = QGeoRectangle();
+    bool ok = load->errorString.isEmpty();
+    if (ok) {
+        ok = load->binaryFileName.isEmpty() ? m_features.setData(load->encoded)
+                                            : m_features.open(load->binaryFileName);
+    } else {
+        m_features.close();
+    }
+    m_minimumZoomLevels = ok ? load->minimumZoomLevels : QVector<quint8>();
+    if (m_minimumZoomLevels.size() != m_features.featureCount())
+        m_minimumZoomLevels.fill(0, m_features.featureCount());
+    endResetModel();
+
+    emit featureCountChanged();
+    if (ok)
+        setStatus(Ready);
+    else
+        setStatus(Error, load->errorString.isEmpty() ? m_features.errorString() : load->errorString);
+    updateZoomThreshold();
+    updateRows(true);
+}
+
+void QGeoJsonViewportModel::setStatus(Status status, const QString &errorString)
+{
+    if (status == m_status && errorString == m_errorString)
+        return;
+    m_status = status;
+    m_errorString = errorString;
+    emit statusChanged();
+}
+
+// Returns whether the zoom threshold changed
+bool QGeoJsonViewportModel::updateZoomThreshold()
+{
+    static const qreal hysteresis = 0.25;
+    int threshold = m_zoomThreshold;
+    if (threshold < 0)
+        threshold = int(std::floor(m_zoomLevel));
+    else if (m_zoomLevel >= threshold + 1 + hysteresis)
+        threshold = int(std::floor(m_zoomLevel - hysteresis));
+    else if (m_zoomLevel < threshold - hysteresis)
+        threshold = int(std::floor(m_zoomLevel + hysteresis));
+    threshold = qMax(threshold, 0);
+
+    if (threshold == m_zoomThreshold)
+        return false;
+    m_zoomThreshold = threshold;
+    return true;
+}
+
+void QGeoJsonViewportModel::updateRows(bool force)
+{
+    if (!m_features.isOpen() || !m_visibleRegion.isValid())
+        return;
+
+    // Only query again once the visible region leaves the loaded one, or got
+    // much smaller than it
+    if (!force && m_loadedRegion.isValid() && m_loadedRegion.contains(m_visibleRegion)
+            && m_visibleRegion.width() * (1.0 + 2.0 * m_margin) * 2.0 >= m_loadedRegion.width()) {
+        return;
+    }
+
+    m_loadedRegion = grown(m_visibleRegion, m_margin);
+    QVector<int> indexes = m_features.query(m_loadedRegion);
+    indexes.erase(std::remove_if(indexes.begin(), indexes.end(), [this](int index) {
+        return m_minimumZoomLevels.at(index) > m_zoomThreshold;
+    }), indexes.end());
+    applyRows(indexes);
+}
+
+// Moves from the current rows to the features in indexes, sorted in
+// increasing order, with one removal or insertion per contiguous range.
+void QGeoJsonViewportModel::applyRows(const QVector<int> &indexes)
+{
+    auto wanted = [&indexes](int index) {
+        return std::binary_search(indexes.cbegin(), indexes.cend(), index);
+    };
+    for (int last = m_rows.size() - 1; last >= 0; --last) {
+        if (wanted(m_rows.at(last)))
+            continue;
+        int first = last;
+        while (first > 0 && !wanted(m_rows.at(first - 1)))
+            --first;
+        beginRemoveRows(QModelIndex(), first, last);
+        m_rows.remove(first, last - first + 1);
+        m_shown.remove(first, last - first + 1);
+        endRemoveRows();
+        last = first;
+    }
+
+    int row = 0;
+    for (int i = 0; i < indexes.size();) {
+        while (row < m_rows.size() && m_rows.at(row) < indexes.at(i))
+            ++row;
+        if (row < m_rows.size() && m_rows.at(row) == indexes.at(i)) {
+            ++i;
+            continue;
+        }
+
+        // The run of new features before the next row that stays
+        const int next = row < m_rows.size() ? m_rows.at(row) : std::numeric_limits<int>::max();
+        int end = i;
+        while (end < indexes.size() && indexes.at(end) < next)
+            ++end;
+        beginInsertRows(QModelIndex(), row, row + end - i - 1);
+        for (int j = i; j < end; ++j) {
+            m_rows.insert(row + j - i, indexes.at(j));
+            m_shown.insert(row + j - i, m_features.feature(indexes.at(j)));
+        }
+        endInsertRows();
+        row += end - i;
+        i = end;
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOJSONVIEWPORTMODEL_P_H
+#define QGEOJSONVIEWPORTMODEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeobinaryfeatures_p.h>
+#include <QtPositioning/QGeoRectangle>
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoJsonViewportModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariant geoJson READ geoJson WRITE setGeoJson NOTIFY geoJsonChanged)
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QGeoShape visibleRegion READ visibleRegion WRITE setVisibleRegion NOTIFY visibleRegionChanged)
+    Q_PROPERTY(qreal zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY zoomLevelChanged)
+    Q_PROPERTY(qreal margin READ margin WRITE setMargin NOTIFY marginChanged)
+    Q_PROPERTY(int featureCount READ featureCount NOTIFY featureCountChanged)
+    Q_PROPERTY(Status status READ status NOTIFY statusChanged)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY statusChanged)
+
+public:
+    enum Status {
+        Null,
+        Loading,
+        Ready,
+        Error
+    };
+    Q_ENUM(Status)
+
+    enum Roles {
+        TypeRole = Qt::UserRole + 1,
+        ShapeRole,
+        ShapesRole,
+        PropertiesRole,
+        FeatureIdRole
+    };
+
+    explicit QGeoJsonViewportModel(QObject *parent = nullptr);
+    ~QGeoJsonViewportModel() override;
+
+    QVariant geoJson() const;
+    void setGeoJson(const QVariant &geoJson);
+
+    QUrl source() const;
+    void setSource(const QUrl &source);
+
+    QGeoShape visibleRegion() const;
+    void setVisibleRegion(const QGeoShape &region);
+
+    qreal zoomLevel() const;
+    void setZoomLevel(qreal zoomLevel);
+
+    qreal margin() const;
+    void setMargin(qreal margin);
+
+    int featureCount() const;
+    Status status() const;
+    QString errorString() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE int featureIndex(int row) const;
+
+Q_SIGNALS:
+    void geoJsonChanged();
+    void sourceChanged();
+    void visibleRegionChanged();
+    void zoomLevelChanged();
+    void marginChanged();
+    void featureCountChanged();
+    void statusChanged();
+
+private:
+    struct Load;
+
+    void startLoad(const QSharedPointer<Load> &load);
+    void adoptLoad(const QSharedPointer<Load> &load);
+    void setStatus(Status status, const QString &errorString = QString());
+    bool updateZoomThreshold();
+    void updateRows(bool force = false);
+    void applyRows(const QVector<int> &indexes);
+
+    QVariant m_geoJson;
+    QUrl m_source;
+    QGeoRectangle m_visibleRegion;
+    qreal m_zoomLevel = 0.0;
+    qreal m_margin = 0.5;
+    Status m_status = Null;
+    QString m_errorString;
+
+    QGeoBinaryFeatures m_features;
+    QVector<quint8> m_minimumZoomLevels; // per feature, from the simplification of its outline
+    QSharedPointer<Load> m_pendingLoad;
+    QGeoRectangle m_loadedRegion; // the visible region grown by the margin
+    int m_zoomThreshold = -1;
+
+    QVector<int> m_rows; // feature indexes, in increasing order
+    QVector<QGeoBinaryFeatures::Feature> m_shown;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOJSONVIEWPORTMODEL_P_H
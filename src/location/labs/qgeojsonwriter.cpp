@@ -0,0 +1,716 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeojsonwriter_p.h"
+#include <QtCore/qiodevice.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qlocale.h>
+#include <QtPositioning/qgeocircle.h>
+#include <QtPositioning/qgeopath.h>
+#include <QtPositioning/qgeopolygon.h>
+
+QT_BEGIN_NAMESPACE
+
+/*! \class QGeoJsonWriter
+    \inmodule QtLocation
+    \since 5.15
+
+    QGeoJsonWriter writes GeoJSON data to a QIODevice as it goes, one
+    feature at a time. Unlike QGeoJson::exportGeoJson(), it does not build a
+    QJsonDocument first, the coordinates and properties are serialized
+    straight into a buffer that is written to the device every few tens of
+    kilobytes. The memory used therefore does not grow with the size of the
+    output.
+
+    writeGeoJson() writes a whole QVariantList structured like
+    QGeoJson::importGeoJson() returns it, producing the same document
+    exportGeoJson() would. Features can also be written one by one between
+    writeStartFeatureCollection() and writeEndFeatureCollection(), either as
+    maps in the same layout or as the features returned by QGeoJsonReader.
+
+    The output is compact JSON. By default numbers are written with the
+    fewest digits that read back to the same value; setPrecision() limits
+    the coordinates to a number of decimals instead, 6 being about 10 cm.
+
+    WARNING! This private class is part of Qt labs, thus not stable API, it is
+    part of the experimental components of QtLocation. Until it is promoted to
+    public API, it may be subject to source and binary-breaking changes.
+
+    \sa QGeoJson, QGeoJsonReader
+*/
+
+namespace {
+
+enum {
+    ChunkSize = 64 * 1024
+};
+
+QByteArray formatNumber(double value, int precision)
+{
+    if (!qIsFinite(value))
+        return QByteArrayLiteral("null"); // as QJsonDocument does, JSON has no infinity nor NaN
+    if (precision < 0)
+        return QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+
+    QByteArray number = QByteArray::number(value, 'f', precision);
+    if (number.contains('.')) {
+        int end = number.size();
+        while (number.at(end - 1) == '0')
+            --end;
+        if (number.at(end - 1) == '.')
+            --end;
+        number.truncate(end);
+    }
+    if (number == "-0")
+        number = "0";
+    return number;
+}
+
+} // namespace
+
+class QGeoJsonWriterPrivate
+{
+public:
+    void append(const char *data) { buffer += data; }
+    void append(char c) { buffer += c; }
+    void appendString(const QString &string);
+    void appendValue(const QVariant &value);
+
+    void appendPosition(const QGeoCoordinate &position);
+    void appendPositions(const QList<QGeoCoordinate> &positions);
+    void appendRings(const QGeoPolygon &polygon);
+    void appendShapeCoordinates(const QGeoShape &shape);
+    void appendShapeGeometry(const QGeoShape &shape);
+    void appendGeometry(const QVariantMap &geometry, bool boundingBox = false);
+    void appendGeometry(const QString &type, const QList<QGeoShape> &shapes);
+    void appendFeature(const QVariantMap &feature, bool boundingBox = false);
+    void appendBoundingBox(const QVariantMap &map);
+
+    bool startFeature();
+    void finishFeature();
+    bool write(bool all = false);
+    bool setError(const QString &message);
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    int precision = -1;
+
+    bool inCollection = false;
+    bool firstFeature = true;
+    bool finished = false; // a whole document was written
+    int featuresWritten = 0;
+    bool error = false;
+    QString errorString;
+};
+
+bool QGeoJsonWriterPrivate::setError(const QString &message)
+{
+    if (!error) {
+        errorString = message;
+        error = true;
+    }
+    buffer.clear();
+    return false;
+}
+
+// Writes the buffer to the device once it holds a chunk, or whatever it holds if all is set
+bool QGeoJsonWriterPrivate::write(bool all)
+{
+    if (error)
+        return false;
+    if (buffer.isEmpty() || (!all && buffer.size() < ChunkSize))
+        return true;
+    if (!device || !device->isWritable())
+        return setError(QStringLiteral("Device not open for writing"));
+
+    if (device->write(buffer) != buffer.size())
+        return setError(device->errorString());
+    buffer.clear();
+    return true;
+}
+
+void QGeoJsonWriterPrivate::appendString(const QString &string)
+{
+    static const char hex[] = "0123456789abcdef";
+    const QByteArray utf8 = string.toUtf8();
+    buffer += '"';
+    for (char c : utf8) {
+        switch (c) {
+        case '"':
+            buffer += "\\\"";
+            break;
+        case '\\':
+            buffer += "\\\\";
+            break;
+        case '\b':
+            buffer += "\\b";
+            break;
+        case '\f':
+            buffer += "\\f";
+            break;
+        case '\n':
+            buffer += "\\n";
+            break;
+        case '\r':
+            buffer += "\\r";
+            break;
+        case '\t':
+            buffer += "\\t";
+            break;
+        default:
+            if (uchar(c) < 0x20) {
+                buffer += "\\u00";
+                buffer += hex[uchar(c) >> 4];
+                buffer += hex[uchar(c) & 0xf];
+            } else {
+                buffer += c;
+            }
+            break;
+        }
+    }
+    buffer += '"';
+}
+
+// Converts like QVariant::toJsonValue() does, without going through it
+void QGeoJsonWriterPrivate::appendValue(const QVariant &value)
+{
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+    case QMetaType::Nullptr:
+        append("null");
+        break;
+    case QMetaType::Bool:
+        append(value.toBool() ? "true" : "false");
+        break;
+    case QMetaType::Int:
+    case QMetaType::Short:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        buffer += QByteArray::number(value.toLongLong());
+        break;
+    case QMetaType::UInt:
+    case QMetaType::UShort:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        buffer += QByteArray::number(value.toULongLong());
+        break;
+    case QMetaType::Float:
+    case QMetaType::Double:
+        buffer += formatNumber(value.toDouble(), -1);
+        break;
+    case QMetaType::QVariantMap:
+    case QMetaType::QVariantHash:
+    case QMetaType::QJsonObject: {
+        const QVariantMap map = value.userType() == QMetaType::QJsonObject
+                ? value.toJsonObject().toVariantMap() : value.toMap();
+        append('{');
+        for (auto it = map.cbegin(), end = map.cend(); it != end; ++it) {
+            if (it != map.cbegin())
+                append(',');
+            appendString(it.key());
+            append(':');
+            appendValue(it.value());
+        }
+        append('}');
+        break;
+    }
+    case QMetaType::QVariantList:
+    case QMetaType::QStringList:
+    case QMetaType::QJsonArray: {
+        const QVariantList list = value.userType() == QMetaType::QJsonArray
+                ? value.toJsonArray().toVariantList() : value.toList();
+        append('[');
+        for (int i = 0; i < list.size(); ++i) {
+            if (i)
+                append(',');
+            appendValue(list.at(i));
+        }
+        append(']');
+        break;
+    }
+    case QMetaType::QJsonValue:
+        appendValue(value.toJsonValue().toVariant());
+        break;
+    default:
+        if (value.canConvert<QString>())
+            appendString(value.toString());
+        else
+            append("null");
+        break;
+    }
+}
+
+void QGeoJsonWriterPrivate::appendPosition(const QGeoCoordinate &position)
+{
+    append('[');
+    buffer += formatNumber(position.longitude(), precision);
+    append(',');
+    buffer += formatNumber(position.latitude(), precision);
+    if (!qIsNaN(position.altitude())) {
+        append(',');
+        buffer += formatNumber(position.altitude(), precision);
+    }
+    append(']');
+}
+
+void QGeoJsonWriterPrivate::appendPositions(const QList<QGeoCoordinate> &positions)
+{
+    append('[');
+    for (int i = 0; i < positions.size(); ++i) {
+        if (i)
+            append(',');
+        appendPosition(positions.at(i));
+        // a long track is written as it is serialized, not once whole
+        if (!write())
+            return;
+    }
+    append(']');
+}
+
+void QGeoJsonWriterPrivate::appendRings(const QGeoPolygon &polygon)
+{
+    append('[');
+    appendPositions(polygon.path()); // External perimeter
+    for (int i = 0; i < polygon.holesCount(); ++i) {
+        append(',');
+        appendPositions(polygon.holePath(i)); // Inner perimeters
+    }
+    append(']');
+}
+
+// The coordinates of a Point, LineString or Polygon, from its shape
+void QGeoJsonWriterPrivate::appendShapeCoordinates(const QGeoShape &shape)
+{
+    switch (shape.type()) {
+    case QGeoShape::CircleType:
+        appendPosition(QGeoCircle(shape).center());
+        break;
+    case QGeoShape::PathType:
+        appendPositions(QGeoPath(shape).path());
+        break;
+    case QGeoShape::PolygonType:
+        appendRings(QGeoPolygon(shape));
+        break;
+    default:
+        append("[]");
+        break;
+    }
+}
+
+void QGeoJsonWriterPrivate::appendShapeGeometry(const QGeoShape &shape)
+{
+    append("{\"type\":");
+    switch (shape.type()) {
+    case QGeoShape::CircleType:
+        append("\"Point\"");
+        break;
+    case QGeoShape::PathType:
+        append("\"LineString\"");
+        break;
+    default:
+        append("\"Polygon\"");
+        break;
+    }
+    append(",\"coordinates\":");
+    appendShapeCoordinates(shape);
+    append('}');
+}
+
+// A geometry in the layout of QGeoJson::importGeoJson(), written like exportGeoJson() does
+void QGeoJsonWriterPrivate::appendGeometry(const QVariantMap &geometry, bool boundingBox)
+{
+    const QString type = geometry.value(QStringLiteral("type")).toString();
+    const QVariant data = geometry.value(QStringLiteral("data"));
+    const bool single = type == QLatin1String("Point") || type == QLatin1String("LineString")
+            || type == QLatin1String("Polygon");
+    const bool multi = type == QLatin1String("MultiPoint") || type == QLatin1String("MultiLineString")
+            || type == QLatin1String("MultiPolygon");
+    const bool collection = type == QLatin1String("GeometryCollection");
+    if (!single && !multi && !collection) {
+        append("{}");
+        return;
+    }
+
+    append("{\"type\":");
+    appendString(type);
+    if (single) {
+        append(",\"coordinates\":");
+        appendShapeCoordinates(data.value<QGeoShape>());
+    } else {
+        // the parts are geometry maps of their own
+        const QVariantList parts = data.toList();
+        append(multi ? ",\"coordinates\":[" : ",\"geometries\":[");
+        for (int i = 0; i < parts.size(); ++i) {
+            if (i)
+                append(',');
+            const QVariantMap part = parts.at(i).toMap();
+            if (multi)
+                appendShapeCoordinates(part.value(QStringLiteral("data")).value<QGeoShape>());
+            else
+                appendGeometry(part);
+        }
+        append(']');
+    }
+    if (boundingBox)
+        appendBoundingBox(geometry);
+    append('}');
+}
+
+// A geometry as QGeoJsonReader returns it
+void QGeoJsonWriterPrivate::appendGeometry(const QString &type, const QList<QGeoShape> &shapes)
+{
+    if (type.isEmpty()) {
+        append("null");
+        return;
+    }
+
+    append("{\"type\":");
+    appendString(type);
+    if (type == QLatin1String("GeometryCollection")) {
+        append(",\"geometries\":[");
+        for (int i = 0; i < shapes.size(); ++i) {
+            if (i)
+                append(',');
+            appendShapeGeometry(shapes.at(i));
+        }
+        append(']');
+    } else if (type.startsWith(QLatin1String("Multi"))) {
+        append(",\"coordinates\":[");
+        for (int i = 0; i < shapes.size(); ++i) {
+            if (i)
+                append(',');
+            appendShapeCoordinates(shapes.at(i));
+        }
+        append(']');
+    } else {
+        append(",\"coordinates\":");
+        appendShapeCoordinates(shapes.value(0));
+    }
+    append('}');
+}
+
+void QGeoJsonWriterPrivate::appendFeature(const QVariantMap &feature, bool boundingBox)
+{
+    append("{\"type\":\"Feature\",\"geometry\":");
+    appendGeometry(feature);
+    append(",\"properties\":");
+    appendValue(feature.value(QStringLiteral("properties")));
+    append(",\"id\":");
+    appendValue(feature.value(QStringLiteral("id")));
+    if (boundingBox)
+        appendBoundingBox(feature);
+    append('}');
+}
+
+void QGeoJsonWriterPrivate::appendBoundingBox(const QVariantMap &map)
+{
+    if (!map.contains(QStringLiteral("bbox")))
+        return;
+
+    const QVariantList bbox = map.value(QStringLiteral("bbox")).toList();
+    append(",\"bbox\":[");
+    for (int i = 0; i < bbox.size(); ++i) {
+        if (i)
+            append(',');
+        buffer += formatNumber(bbox.at(i).toDouble(), precision);
+    }
+    append(']');
+}
+
+// Separates the features of a collection; outside of one, only a single feature can be written
+bool QGeoJsonWriterPrivate::startFeature()
+{
+    if (error)
+        return false;
+    if (!inCollection && finished)
+        return setError(QStringLiteral("Only one feature can be written outside of a FeatureCollection"));
+
+    if (inCollection && !firstFeature)
+        append(',');
+    firstFeature = false;
+    return true;
+}
+
+void QGeoJsonWriterPrivate::finishFeature()
+{
+    ++featuresWritten;
+    if (!inCollection) {
+        finished = true;
+        write(true);
+    } else {
+        write();
+    }
+}
+
+/*!
+    Constructs a writer without a device.
+
+    \sa setDevice()
+*/
+QGeoJsonWriter::QGeoJsonWriter()
+    : d_ptr(new QGeoJsonWriterPrivate)
+{
+}
+
+/*!
+    Constructs a writer that writes to \a device.
+*/
+QGeoJsonWriter::QGeoJsonWriter(QIODevice *device)
+    : d_ptr(new QGeoJsonWriterPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Destroys the writer, after writing what is left in its buffer.
+*/
+QGeoJsonWriter::~QGeoJsonWriter()
+{
+    flush();
+}
+
+/*!
+    Restarts the writer on \a device, which has to be open for writing. The
+    data is written from the current position of the device. What was left
+    in the buffer is written to the previous device first.
+*/
+void QGeoJsonWriter::setDevice(QIODevice *device)
+{
+    Q_D(QGeoJsonWriter);
+    flush();
+    const int precision = d->precision;
+    d_ptr.reset(new QGeoJsonWriterPrivate);
+    d_ptr->device = device;
+    d_ptr->precision = precision;
+}
+
+/*!
+    Returns the device the writer writes to, or \c nullptr.
+*/
+QIODevice *QGeoJsonWriter::device() const
+{
+    Q_D(const QGeoJsonWriter);
+    return d->device;
+}
+
+/*!
+    Sets the number of \a decimals the coordinates and bounding boxes are
+    written with, trailing zeros left out. A negative value, the default,
+    writes them with as many digits as needed to read back the same values.
+*/
+void QGeoJsonWriter::setPrecision(int decimals)
+{
+    Q_D(QGeoJsonWriter);
+    d->precision = qMin(decimals, 17);
+}
+
+/*!
+    Returns the number of decimals the coordinates are written with, or -1.
+*/
+int QGeoJsonWriter::precision() const
+{
+    Q_D(const QGeoJsonWriter);
+    return d->precision < 0 ? -1 : d->precision;
+}
+
+/*!
+    Writes \a geoData, expected to be structured like QGeoJson::importGeoJson()
+    returns it, as a complete GeoJSON document, the same exportGeoJson() would
+    make. The features of a FeatureCollection are written to the device as
+    they are serialized.
+
+    Returns \c true on success.
+
+    \note Like QGeoJson::exportGeoJson(), this method performs no validation
+    on the input.
+*/
+bool QGeoJsonWriter::writeGeoJson(const QVariantList &geoData)
+{
+    Q_D(QGeoJsonWriter);
+    if (geoData.isEmpty())
+        return !d->error;
+
+    const QVariantMap root = geoData.first().toMap();
+    if (root.contains(QStringLiteral("properties"))) {
+        if (d->startFeature()) {
+            d->appendFeature(root, true);
+            d->finishFeature();
+        }
+    } else if (root.value(QStringLiteral("type")) == QStringLiteral("FeatureCollection")) {
+        writeStartFeatureCollection();
+        const QVariantList features = root.value(QStringLiteral("data")).toList();
+        for (const QVariant &feature : features)
+            writeFeature(feature.toMap());
+        if (d->inCollection) {
+            // the bounding box is a member of the collection
+            d->append(']');
+            d->appendBoundingBox(root);
+            d->append('}');
+            d->inCollection = false;
+            d->finished = true;
+        }
+    } else if (d->startFeature()) {
+        d->appendGeometry(root, true);
+        d->finishFeature();
+    }
+    return flush();
+}
+
+/*!
+    Starts a FeatureCollection, whose features are then written with
+    writeFeature() until writeEndFeatureCollection() is called.
+*/
+void QGeoJsonWriter::writeStartFeatureCollection()
+{
+    Q_D(QGeoJsonWriter);
+    if (d->error)
+        return;
+    if (d->inCollection || d->finished) {
+        d->setError(QStringLiteral("A FeatureCollection can only be written as the root object"));
+        return;
+    }
+
+    d->append("{\"type\":\"FeatureCollection\",\"features\":[");
+    d->inCollection = true;
+    d->firstFeature = true;
+}
+
+/*!
+    Writes \a feature, a map structured like the features QGeoJson::importGeoJson()
+    returns, with the \c type and \c data of its geometry, its \c properties
+    and its \c id. Outside of a FeatureCollection, the feature is the whole
+    document.
+*/
+void QGeoJsonWriter::writeFeature(const QVariantMap &feature)
+{
+    Q_D(QGeoJsonWriter);
+    if (!d->startFeature())
+        return;
+    d->appendFeature(feature);
+    d->finishFeature();
+}
+
+/*!
+    \overload
+
+    Writes \a feature, as read by QGeoJsonReader. A feature without a
+    geometry type is written with a null geometry.
+*/
+void QGeoJsonWriter::writeFeature(const QGeoJsonReader::Feature &feature)
+{
+    Q_D(QGeoJsonWriter);
+    if (!d->startFeature())
+        return;
+
+    d->append("{\"type\":\"Feature\",\"geometry\":");
+    d->appendGeometry(feature.type, feature.shapes);
+    d->append(",\"properties\":");
+    d->appendValue(feature.properties);
+    d->append(",\"id\":");
+    d->appendValue(feature.id);
+    d->append('}');
+    d->finishFeature();
+}
+
+/*!
+    Ends the FeatureCollection started with writeStartFeatureCollection(),
+    and writes what is left in the buffer to the device.
+*/
+void QGeoJsonWriter::writeEndFeatureCollection()
+{
+    Q_D(QGeoJsonWriter);
+    if (d->error)
+        return;
+    if (!d->inCollection) {
+        d->setError(QStringLiteral("No FeatureCollection was started"));
+        return;
+    }
+
+    d->append("]}");
+    d->inCollection = false;
+    d->finished = true;
+    flush();
+}
+
+/*!
+    Writes the buffered data to the device. Returns \c false on errors.
+
+    The buffer is written whenever it holds enough data, and at the end of
+    the document, so this is only needed to see the partial output of a
+    FeatureCollection being written.
+*/
+bool QGeoJsonWriter::flush()
+{
+    Q_D(QGeoJsonWriter);
+    return d->write(true);
+}
+
+/*!
+    Returns the number of features written so far. A root geometry counts as
+    one feature.
+*/
+int QGeoJsonWriter::featuresWritten() const
+{
+    Q_D(const QGeoJsonWriter);
+    return d->featuresWritten;
+}
+
+/*!
+    Returns \c true if writing to the device failed, or the calls did not
+    make a valid document.
+*/
+bool QGeoJsonWriter::hasError() const
+{
+    Q_D(const QGeoJsonWriter);
+    return d->error;
+}
+
+/*!
+    Returns a description of the error.
+*/
+QString QGeoJsonWriter::errorString() const
+{
+    Q_D(const QGeoJsonWriter);
+    return d->errorString;
+}
+
+QT_END_NAMESPACE
@@ -60,6 +60,7 @@ public:
     virtual QList<QGeoMapObject *> mapObjects() const override;
     void removeMapObject(QGeoMapObject *obj);
     QList<QObject *>mapObjectsAt(const QGeoCoordinate &coordinate) const;
+    QList<QObject *>mapObjectsIn(const QGeoShape &region) const;
 
     void updateMapObjects(QSGNode *root, QQuickWindow *window);
     void updateObjectsGeometry();
@@ -100,29 +101,18 @@ void QGeoTiledMapLabsPrivate::removeMapObject(QGeoMapObject *obj)
 
 QList<QObject *> QGeoTiledMapLabsPrivate::mapObjectsAt(const QGeoCoordinate &coordinate) const
 {
-    // ToDo: use a space partitioning strategy
+    const qreal mpp = QLocationUtils::metersPerPixel(m_cameraData.zoomLevel(), coordinate);
     QList<QObject *> res;
-    for (const auto o: mapObjects()) {
-        // explicitly handle lines
-        bool contains = false;
-        if (o->type() == QGeoMapObject::PolylineType ) {
-            QMapPolylineObject *mpo = static_cast<QMapPolylineObject *>(o);
-            qreal mpp = QLocationUtils::metersPerPixel(m_cameraData.zoomLevel(), coordinate);
-            QGeoPath path = o->geoShape();
-            path.setWidth(mpp * mpo->border()->width());
-            contains = path.contains(coordinate);
-        } else if (o->type() == QGeoMapObject::RouteType) {
-            qreal mpp = QLocationUtils::metersPerPixel(m_cameraData.zoomLevel(), coordinate);
-            QGeoPath path = o->geoShape();
-            path.setWidth(mpp * 4); // MapRouteObjectQSG has a hardcoded 4 pixels width;
-            contains = path.contains(coordinate);
-        } else {
-            contains = o->geoShape().contains(coordinate);
-        }
-
-        if (contains)
-            res.append(o);
-    }
+    for (QGeoMapObject *o: m_qsgSupport.mapObjectsAt(coordinate, mpp))
+        res.append(o);
+    return res;
+}
+
+QList<QObject *> QGeoTiledMapLabsPrivate::mapObjectsIn(const QGeoShape &region) const
+{
+    QList<QObject *> res;
+    for (QGeoMapObject *o: m_qsgSupport.mapObjectsIn(region))
+        res.append(o);
     return res;
 }
 
@@ -198,6 +188,12 @@ QList<QObject *> QGeoTiledMapLabs::mapObjectsAt(const QGeoCoordinate &coordinate
     return d->mapObjectsAt(coordinate);
 }
 
+QList<QObject *> QGeoTiledMapLabs::mapObjectsIn(const QGeoShape &region) const
+{
+    Q_D(const QGeoTiledMapLabs);
+    return d->mapObjectsIn(region);
+}
+
 QGeoTiledMapLabs::QGeoTiledMapLabs(QGeoTiledMapLabsPrivate &dd, QGeoTiledMappingManagerEngine *engine, QObject *parent)
     : QGeoTiledMap(dd, engine, parent)
 {
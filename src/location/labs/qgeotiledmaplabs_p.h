@@ -73,6 +73,7 @@ public:
     bool createMapObjectImplementation(QGeoMapObject *obj) override;
     void removeMapObject(QGeoMapObject *obj) override;
     QList<QObject *> mapObjectsAt(const QGeoCoordinate &coordinate) const override;
+    QList<QObject *> mapObjectsIn(const QGeoShape &region) const override;
 
 protected:
     QSGNode *updateSceneGraph(QSGNode *node, QQuickWindow *window) override;
@@ -0,0 +1,431 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmapheatmapobject_p.h"
+#include "qmapheatmapobject_p_p.h"
+#include <QExplicitlySharedDataPointer>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtGui/QColor>
+#include <QtQml/QJSValue>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype MapHeatmapObject
+    \instantiates QMapHeatmapObject
+    \inqmlmodule Qt.labs.location
+    \ingroup qml-QtLocation5-maps
+    \inherits QGeoMapObject
+
+    \brief The MapHeatmapObject displays the density of a large number of points on a Map.
+
+    The MapHeatmapObject draws a blurred disc of \l radius pixels for each of
+    its \l points, and colors the sum of the discs along \l colors. The points
+    are uploaded to the GPU once, in mercator coordinates, and moving the
+    camera draws them again with the new projection, so that hundreds of
+    thousands of points stay interactive where as many MapCircle items would
+    not.
+
+    The densities are summed in a floating point render target where the
+    OpenGL implementation supports it, and in an 8 bit one otherwise, where
+    small densities lose precision. The object requires the OpenGL scene graph
+    backend.
+
+    The MapHeatmapObject type only makes sense when contained in a Map or in a \l MapObjectView.
+
+    \section2 Example Usage
+
+    \code
+    MapHeatmapObject {
+        points: fixes.buffer // a Float64Array of latitudes and longitudes
+        radius: 24
+        maximumDensity: 20
+    }
+    \endcode
+*/
+
+// As QWebMercator::coordToMercator, without building a QGeoCoordinate for each point
+static inline QDoubleVector2D toMercator(double latitude, double longitude)
+{
+    const double x = longitude / 360.0 + 0.5;
+    double y = 0.5 - (std::log(std::tan((M_PI / 4.0) + (M_PI / 2.0) * latitude / 180.0)) / M_PI) / 2.0;
+    y = qBound(0.0, y, 1.0);
+    return QDoubleVector2D(x, y);
+}
+
+namespace {
+struct PointCollector
+{
+    QVector<QDoubleVector2D> points;
+    double top = -90.0;
+    double bottom = 90.0;
+    double left = 180.0;
+    double right = -180.0;
+
+    void add(double latitude, double longitude)
+    {
+        if (!qIsFinite(latitude) || !qIsFinite(longitude)
+                || qAbs(latitude) > 90.0 || qAbs(longitude) > 180.0) {
+            return;
+        }
+        points.append(toMercator(latitude, longitude));
+        top = qMax(top, latitude);
+        bottom = qMin(bottom, latitude);
+        left = qMin(left, longitude);
+        right = qMax(right, longitude);
+    }
+
+    void add(const QVariant &value)
+    {
+        const int type = value.userType();
+        if (type == qMetaTypeId<QGeoCoordinate>()) {
+            const QGeoCoordinate c = value.value<QGeoCoordinate>();
+            add(c.latitude(), c.longitude());
+        } else if (type == qMetaTypeId<QGeoCircle>()) { // GeoJSON points
+            const QGeoCoordinate c = value.value<QGeoCircle>().center();
+            add(c.latitude(), c.longitude());
+        } else if (type == qMetaTypeId<QGeoPath>()) {
+            const QList<QGeoCoordinate> path = value.value<QGeoPath>().path();
+            for (const QGeoCoordinate &c : path)
+                add(c.latitude(), c.longitude());
+        } else if (type == QMetaType::QByteArray) { // latitude and longitude pairs of doubles
+            const QByteArray data = value.toByteArray();
+            const int count = data.size() / int(2 * sizeof(double));
+            points.reserve(points.size() + count);
+            for (int i = 0; i < count; ++i) {
+                double pair[2];
+                memcpy(pair, data.constData() + i * sizeof(pair), sizeof(pair));
+                add(pair[0], pair[1]);
+            }
+        } else if (type == QMetaType::QVariantList) {
+            const QVariantList list = value.toList();
+            points.reserve(points.size() + list.size());
+            for (const QVariant &item : list)
+                add(item);
+        } else if (type == QMetaType::QVariantMap) { // GeoJSON, as imported by QGeoJson
+            add(value.toMap().value(QStringLiteral("data")));
+        } else if (type == qMetaTypeId<QJSValue>()) {
+            add(value.value<QJSValue>().toVariant());
+        }
+    }
+};
+} // namespace
+
+QMapHeatmapObjectPrivate::QMapHeatmapObjectPrivate(QGeoMapObject *q) : QGeoMapObjectPrivate(q)
+{
+
+}
+
+QMapHeatmapObjectPrivate::~QMapHeatmapObjectPrivate()
+{
+
+}
+
+QGeoMapObject::Type QMapHeatmapObjectPrivate::type() const
+{
+    return QGeoMapObject::HeatmapType;
+}
+
+bool QMapHeatmapObjectPrivate::equals(const QGeoMapObjectPrivate &other) const
+{
+    if (other.type() != type()) // This check might be unnecessary, depending on how equals gets used
+        return false;
+
+    const QMapHeatmapObjectPrivate &o = static_cast<const QMapHeatmapObjectPrivate &>(other);
+    return (QGeoMapObjectPrivate::equals(o)
+            && points() == o.points()
+            && radius() == o.radius()
+            && maximumDensity() == o.maximumDensity()
+            && colors() == o.colors());
+}
+
+//
+// QMapHeatmapObjectPrivate default implementation
+//
+
+QMapHeatmapObjectPrivateDefault::QMapHeatmapObjectPrivateDefault(QGeoMapObject *q) : QMapHeatmapObjectPrivate(q)
+{
+
+}
+
+QMapHeatmapObjectPrivateDefault::QMapHeatmapObjectPrivateDefault(const QMapHeatmapObjectPrivate &other)
+    : QMapHeatmapObjectPrivate(other.q)
+{
+    m_points = other.points();
+    m_mercatorPoints = other.mercatorPoints();
+    m_bounds = other.geoShape().boundingGeoRectangle();
+    m_radius = other.radius();
+    m_maximumDensity = other.maximumDensity();
+    m_colors = other.colors();
+}
+
+QMapHeatmapObjectPrivateDefault::~QMapHeatmapObjectPrivateDefault()
+{
+
+}
+
+/*
+    Collects the points of \a points, and their bounding rectangle in \a
+    bounds. See QMapHeatmapObject::points for the accepted values.
+*/
+QVector<QDoubleVector2D> QMapHeatmapObjectPrivateDefault::toMercator(const QVariant &points, QGeoRectangle *bounds)
+{
+    PointCollector collector;
+    collector.add(points);
+    if (bounds) {
+        *bounds = collector.points.isEmpty()
+                ? QGeoRectangle()
+                : QGeoRectangle(QGeoCoordinate(collector.top, collector.left),
+                                QGeoCoordinate(collector.bottom, collector.right));
+    }
+    return collector.points;
+}
+
+QVariantList QMapHeatmapObjectPrivateDefault::defaultColors()
+{
+    return QVariantList { QColor(0, 0, 255, 0), QColor(Qt::blue), QColor(Qt::cyan),
+                          QColor(Qt::green), QColor(Qt::yellow), QColor(Qt::red) };
+}
+
+QVariant QMapHeatmapObjectPrivateDefault::points() const
+{
+    return m_points;
+}
+
+void QMapHeatmapObjectPrivateDefault::setPoints(const QVariant &points)
+{
+    m_points = points;
+    m_mercatorPoints = toMercator(points, &m_bounds);
+}
+
+QVector<QDoubleVector2D> QMapHeatmapObjectPrivateDefault::mercatorPoints() const
+{
+    return m_mercatorPoints;
+}
+
+qreal QMapHeatmapObjectPrivateDefault::radius() const
+{
+    return m_radius;
+}
+
+void QMapHeatmapObjectPrivateDefault::setRadius(qreal radius)
+{
+    m_radius = radius;
+}
+
+qreal QMapHeatmapObjectPrivateDefault::maximumDensity() const
+{
+    return m_maximumDensity;
+}
+
+void QMapHeatmapObjectPrivateDefault::setMaximumDensity(qreal density)
+{
+    m_maximumDensity = density;
+}
+
+QVariantList QMapHeatmapObjectPrivateDefault::colors() const
+{
+    return m_colors;
+}
+
+void QMapHeatmapObjectPrivateDefault::setColors(const QVariantList &colors)
+{
+    m_colors = colors;
+}
+
+QGeoMapObjectPrivate *QMapHeatmapObjectPrivateDefault::clone()
+{
+    return new QMapHeatmapObjectPrivateDefault(static_cast<QMapHeatmapObjectPrivate &>(*this));
+}
+
+QGeoShape QMapHeatmapObjectPrivateDefault::geoShape() const
+{
+    return m_bounds;
+}
+
+void QMapHeatmapObjectPrivateDefault::setGeoShape(const QGeoShape &shape)
+{
+    Q_UNUSED(shape); // the shape follows the points, moving them all would be meaningless
+}
+
+
+/*
+
+    QMapHeatmapObject
+
+*/
+
+
+QMapHeatmapObject::QMapHeatmapObject(QObject *parent)
+    : QGeoMapObject(QExplicitlySharedDataPointer<QGeoMapObjectPrivate>(new QMapHeatmapObjectPrivateDefault(this)), parent)
+{}
+
+QMapHeatmapObject::~QMapHeatmapObject()
+{
+
+}
+
+/*!
+    \qmlproperty Variant Qt.labs.location::MapHeatmapObject::points
+
+    This property holds the points the density of which is drawn. It accepts:
+
+    \list
+    \li a list of coordinates, or a \l geopath, each vertex of which is a point;
+    \li an \c ArrayBuffer, such as the buffer of a \c Float64Array, holding
+        the latitude and the longitude of each point, one after the other;
+    \li GeoJSON data, as imported by QGeoJson::importGeoJson() and given
+        from C++, where each \c Point is a point.
+    \endlist
+
+    Points of invalid coordinates are ignored. The default value is undefined.
+
+    \sa pointCount
+*/
+QVariant QMapHeatmapObject::points() const
+{
+    const QMapHeatmapObjectPrivate *d = static_cast<const QMapHeatmapObjectPrivate *>(d_ptr.data());
+    return d->points();
+}
+
+void QMapHeatmapObject::setPoints(const QVariant &points)
+{
+    QMapHeatmapObjectPrivate *d = static_cast<QMapHeatmapObjectPrivate *>(d_ptr.data());
+    d->setPoints(points);
+    emit pointsChanged();
+}
+
+/*!
+    \qmlproperty int Qt.labs.location::MapHeatmapObject::pointCount
+
+    This read-only property holds the number of valid points in \l points.
+*/
+int QMapHeatmapObject::pointCount() const
+{
+    const QMapHeatmapObjectPrivate *d = static_cast<const QMapHeatmapObjectPrivate *>(d_ptr.data());
+    return d->mercatorPoints().size();
+}
+
+/*!
+    \qmlproperty real Qt.labs.location::MapHeatmapObject::radius
+
+    This property holds the radius, in pixels, of the disc drawn for each
+    point. The density of a point falls off from its center to this radius.
+    The largest radius is bounded by the OpenGL implementation, to at least 32
+    pixels. The default value is 20.
+*/
+qreal QMapHeatmapObject::radius() const
+{
+    const QMapHeatmapObjectPrivate *d = static_cast<const QMapHeatmapObjectPrivate *>(d_ptr.data());
+    return d->radius();
+}
+
+void QMapHeatmapObject::setRadius(qreal radius)
+{
+    QMapHeatmapObjectPrivate *d = static_cast<QMapHeatmapObjectPrivate *>(d_ptr.data());
+    if (d->radius() == radius)
+        return;
+
+    d->setRadius(radius);
+    emit radiusChanged();
+}
+
+/*!
+    \qmlproperty real Qt.labs.location::MapHeatmapObject::maximumDensity
+
+    This property holds the density drawn with the last of \l colors, as the
+    number of point centers on top of each other. Higher densities are drawn
+    with the same color. The default value is 10.
+*/
+qreal QMapHeatmapObject::maximumDensity() const
+{
+    const QMapHeatmapObjectPrivate *d = static_cast<const QMapHeatmapObjectPrivate *>(d_ptr.data());
+    return d->maximumDensity();
+}
+
+void QMapHeatmapObject::setMaximumDensity(qreal density)
+{
+    QMapHeatmapObjectPrivate *d = static_cast<QMapHeatmapObjectPrivate *>(d_ptr.data());
+    if (d->maximumDensity() == density || !(density > 0))
+        return;
+
+    d->setMaximumDensity(density);
+    emit maximumDensityChanged();
+}
+
+/*!
+    \qmlproperty list<color> Qt.labs.location::MapHeatmapObject::colors
+
+    This property holds the colors the densities are drawn with, evenly
+    spread from no density, for the first, to \l maximumDensity, for the
+    last. The default colors go from a transparent blue through blue, cyan,
+    green and yellow to red.
+*/
+QVariantList QMapHeatmapObject::colors() const
+{
+    const QMapHeatmapObjectPrivate *d = static_cast<const QMapHeatmapObjectPrivate *>(d_ptr.data());
+    return d->colors();
+}
+
+void QMapHeatmapObject::setColors(const QVariantList &colors)
+{
+    QMapHeatmapObjectPrivate *d = static_cast<QMapHeatmapObjectPrivate *>(d_ptr.data());
+    if (d->colors() == colors)
+        return;
+
+    d->setColors(colors);
+    emit colorsChanged();
+}
+
+void QMapHeatmapObject::setMap(QGeoMap *map)
+{
+    QMapHeatmapObjectPrivate *d = static_cast<QMapHeatmapObjectPrivate *>(d_ptr.data());
+    if (d->m_map == map)
+        return;
+
+    QGeoMapObject::setMap(map); // This is where the specialized pimpl gets created and injected
+
+    if (!map) {
+        // Map was set, now it has ben re-set to NULL, but not inside d_ptr.
+        // so m_map inside d_ptr can still be used to remove itself, inside the destructor.
+        d_ptr = new QMapHeatmapObjectPrivateDefault(*d);
+        // Old pimpl deleted implicitly by QExplicitlySharedDataPointer
+    }
+}
+
+QT_END_NAMESPACE
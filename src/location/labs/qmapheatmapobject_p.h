@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMAPHEATMAPOBJECT_P_H
+#define QMAPHEATMAPOBJECT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeomapobject_p.h>
+#include <QtCore/QVariant>
+
+QT_BEGIN_NAMESPACE
+
+class Q_LOCATION_PRIVATE_EXPORT QMapHeatmapObject : public QGeoMapObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariant points READ points WRITE setPoints NOTIFY pointsChanged)
+    Q_PROPERTY(int pointCount READ pointCount NOTIFY pointsChanged)
+    Q_PROPERTY(qreal radius READ radius WRITE setRadius NOTIFY radiusChanged)
+    Q_PROPERTY(qreal maximumDensity READ maximumDensity WRITE setMaximumDensity NOTIFY maximumDensityChanged)
+    Q_PROPERTY(QVariantList colors READ colors WRITE setColors NOTIFY colorsChanged)
+
+public:
+    QMapHeatmapObject(QObject *parent = nullptr);
+    ~QMapHeatmapObject() override;
+
+    QVariant points() const;
+    int pointCount() const;
+    qreal radius() const;
+    qreal maximumDensity() const;
+    QVariantList colors() const;
+
+    void setPoints(const QVariant &points);
+    void setRadius(qreal radius);
+    void setMaximumDensity(qreal density);
+    void setColors(const QVariantList &colors);
+
+    void setMap(QGeoMap *map) override;
+
+signals:
+    void pointsChanged();
+    void radiusChanged();
+    void maximumDensityChanged();
+    void colorsChanged();
+};
+
+QT_END_NAMESPACE
+
+#endif // QMAPHEATMAPOBJECT_P_H
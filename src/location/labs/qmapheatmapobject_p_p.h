@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMAPHEATMAPOBJECT_P_P_H
+#define QMAPHEATMAPOBJECT_P_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeomapobject_p_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/QGeoRectangle>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class Q_LOCATION_PRIVATE_EXPORT QMapHeatmapObjectPrivate : public QGeoMapObjectPrivate
+{
+public:
+    QMapHeatmapObjectPrivate(QGeoMapObject *q);
+    ~QMapHeatmapObjectPrivate() override;
+
+    virtual QGeoMapObject::Type type() const override final;
+
+    virtual QVariant points() const = 0;
+    virtual void setPoints(const QVariant &points) = 0;
+    // The points in mercator coordinates, in [0, 1] on both axes
+    virtual QVector<QDoubleVector2D> mercatorPoints() const = 0;
+    virtual qreal radius() const = 0;
+    virtual void setRadius(qreal radius) = 0;
+    virtual qreal maximumDensity() const = 0;
+    virtual void setMaximumDensity(qreal density) = 0;
+    virtual QVariantList colors() const = 0;
+    virtual void setColors(const QVariantList &colors) = 0;
+
+    // QGeoMapObjectPrivate interface
+    bool equals(const QGeoMapObjectPrivate &other) const override;
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QMapHeatmapObjectPrivateDefault : public QMapHeatmapObjectPrivate
+{
+public:
+    QMapHeatmapObjectPrivateDefault(QGeoMapObject *q);
+    QMapHeatmapObjectPrivateDefault(const QMapHeatmapObjectPrivate &other);
+    ~QMapHeatmapObjectPrivateDefault() override;
+
+    static QVector<QDoubleVector2D> toMercator(const QVariant &points, QGeoRectangle *bounds);
+    static QVariantList defaultColors();
+
+    // QMapHeatmapObjectPrivate interface
+    QVariant points() const override;
+    void setPoints(const QVariant &points) override;
+    QVector<QDoubleVector2D> mercatorPoints() const override;
+    qreal radius() const override;
+    void setRadius(qreal radius) override;
+    qreal maximumDensity() const override;
+    void setMaximumDensity(qreal density) override;
+    QVariantList colors() const override;
+    void setColors(const QVariantList &colors) override;
+
+    // QGeoMapObjectPrivate interface
+    QGeoMapObjectPrivate *clone() override;
+    QGeoShape geoShape() const override;
+    void setGeoShape(const QGeoShape &shape) override;
+
+public:
+    QVariant m_points;
+    QVector<QDoubleVector2D> m_mercatorPoints;
+    QGeoRectangle m_bounds;
+    qreal m_radius = 20.0;
+    qreal m_maximumDensity = 10.0;
+    QVariantList m_colors = defaultColors();
+
+private:
+    QMapHeatmapObjectPrivateDefault(const QMapHeatmapObjectPrivateDefault &other) = delete;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMAPHEATMAPOBJECT_P_P_H
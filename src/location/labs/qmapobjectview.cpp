@@ -38,6 +38,8 @@
 #include "qmapobjectview_p_p.h"
 #include <private/qqmldelegatemodel_p.h>
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomapframebudget_p.h>
+#include <QtQuick/QQuickItem>
 
 QT_BEGIN_NAMESPACE
 
@@ -169,7 +171,9 @@ void QMapObjectViewPrivateDefault::setGeoShape(const QGeoShape &/*shape*/)
 QMapObjectView::QMapObjectView(QObject *parent)
     : QGeoMapObject(QExplicitlySharedDataPointer<QGeoMapObjectPrivate>(new QMapObjectViewPrivateDefault(this)), parent)
 {
-
+    m_frameBudget = new QGeoMapFrameBudget([this](const QDeadlineTimer &deadline) {
+        return createMapObjects(deadline);
+    }, this);
 }
 
 QMapObjectView::~QMapObjectView()
@@ -270,6 +274,32 @@ void QMapObjectView::setDelegate(QQmlComponent *delegate)
     emit delegateChanged(delegate);
 }
 
+/*!
+    \qmlproperty int Qt.labs.location::MapObjectView::incubationBudget
+
+    This property holds how many milliseconds of each frame the view spends at most
+    starting the incubation of the delegates of new model rows. When set, the delegates
+    of a large model are requested over several frames, in the order of the model, so
+    that the map keeps rendering meanwhile.
+
+    Defaults to 0, which requests all the delegates at once.
+*/
+int QMapObjectView::incubationBudget() const
+{
+    return m_frameBudget->budget();
+}
+
+void QMapObjectView::setIncubationBudget(int msecs)
+{
+    msecs = qMax(0, msecs);
+    if (m_frameBudget->budget() == msecs)
+        return;
+    m_frameBudget->setBudget(msecs);
+    if (d_ptr->m_componentCompleted)
+        m_frameBudget->schedule(window()); // without a budget, requests the remaining ones
+    emit incubationBudgetChanged();
+}
+
 /*!
     \qmlmethod void Qt.labs.location::MapObjectView::addMapObject(MapObject object)
 
@@ -334,6 +364,17 @@ void QMapObjectView::modelUpdated(const QQmlChangeSet &changeSet, bool reset)
         }
     }
 
+    if (m_frameBudget->budget() > 0) {
+        // Placeholders only, createMapObjects() requests the delegates
+        for (const QQmlChangeSet::Change &c: changeSet.inserts()) {
+            for (int idx = c.start(); idx < c.end(); idx++)
+                m_instantiatedMapObjects.insert(idx, nullptr);
+        }
+        if (!changeSet.inserts().isEmpty())
+            m_frameBudget->schedule(window());
+        return;
+    }
+
     QBoolBlocker createBlocker(m_creatingObject, true);
     for (const QQmlChangeSet::Change &c: changeSet.inserts()) {
         for (int idx = c.start(); idx < c.end(); idx++) {
@@ -406,6 +447,35 @@ void QMapObjectView::createdItem(int index, QObject * /*object*/)
 }
 
 
+/*
+    Requests the delegates of the rows without a map object until deadline,
+    and returns whether some are left. The rows still incubating are asked
+    again, which doesn't start another incubation.
+*/
+bool QMapObjectView::createMapObjects(const QDeadlineTimer &deadline)
+{
+    QBoolBlocker createBlocker(m_creatingObject, true);
+    for (int idx = 0; idx < m_instantiatedMapObjects.size(); ++idx) {
+        if (m_instantiatedMapObjects.at(idx))
+            continue;
+        if (deadline.hasExpired())
+            return true;
+        QGeoMapObject *mo = qobject_cast<QGeoMapObject *>(m_delegateModel->object(idx, incubationMode));
+        if (mo) {
+            mo->setParent(this);
+            addMapObjectToMap(mo, idx);
+        }
+    }
+    return false;
+}
+
+// The window of the Map the view is on, which creates the map
+QQuickWindow *QMapObjectView::window() const
+{
+    const QQuickItem *quickMap = map() ? qobject_cast<const QQuickItem *>(map()->parent()) : nullptr;
+    return quickMap ? quickMap->window() : nullptr;
+}
+
 void QMapObjectView::flushDelegateModel()
 {
     // Backward as removeItemFromMap modifies m_instantiatedItems
@@ -52,17 +52,21 @@
 #include <QtLocation/private/qgeomapobject_p.h>
 #include <QQmlComponent>
 #include <QVector>
+#include <QDeadlineTimer>
 
 QT_BEGIN_NAMESPACE
 
 class QQmlDelegateModel;
 class QMapObjectViewPrivate;
 class QQmlChangeSet;
+class QGeoMapFrameBudget;
+class QQuickWindow;
 class Q_LOCATION_PRIVATE_EXPORT QMapObjectView : public QGeoMapObject
 {
     Q_OBJECT
     Q_PROPERTY(QVariant model READ model WRITE setModel NOTIFY modelChanged)
     Q_PROPERTY(QQmlComponent *delegate READ delegate WRITE setDelegate NOTIFY delegateChanged)
+    Q_PROPERTY(int incubationBudget READ incubationBudget WRITE setIncubationBudget NOTIFY incubationBudgetChanged)
     Q_INTERFACES(QQmlParserStatus)
 public:
     QMapObjectView(QObject *parent = nullptr);
@@ -82,6 +86,9 @@ public:
     QQmlComponent *delegate() const;
     void setDelegate(QQmlComponent * delegate);
 
+    int incubationBudget() const;
+    void setIncubationBudget(int msecs);
+
 public Q_SLOTS:
     // The dynamic API that matches Map.add/remove MapItem
     void addMapObject(QGeoMapObject *object);
@@ -90,6 +97,7 @@ public Q_SLOTS:
 signals:
     void modelChanged(QVariant model);
     void delegateChanged(QQmlComponent * delegate);
+    void incubationBudgetChanged();
 
 protected Q_SLOTS:
     void destroyingItem(QObject *object);
@@ -102,12 +110,15 @@ protected:
     void removeMapObjectFromMap(int index);
     void flushDelegateModel();
     void flushUserAddedMapObjects();
+    bool createMapObjects(const QDeadlineTimer &deadline);
+    QQuickWindow *window() const;
 
     QQmlDelegateModel *m_delegateModel = nullptr;
     QVector<QPointer<QGeoMapObject>> m_instantiatedMapObjects;
     QVector<QPointer<QGeoMapObject>> m_pendingMapObjects; // for items instantiated before the map is set
     QVector<QPointer<QGeoMapObject>> m_userAddedMapObjects; // A third list containing the objects dynamically added through addMapObject
     bool m_creatingObject = false;
+    QGeoMapFrameBudget *m_frameBudget = nullptr; // map objects created a frame at a time
 };
 
 QT_END_NAMESPACE
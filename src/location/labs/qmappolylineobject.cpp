@@ -79,6 +79,7 @@ QMapPolylineObjectPrivateDefault::QMapPolylineObjectPrivateDefault(const QMapPol
     m_path.setPath(other.path());
     m_color = other.color();
     m_width = other.width();
+    m_segmentStyles = other.segmentStyles();
 }
 
 QMapPolylineObjectPrivateDefault::~QMapPolylineObjectPrivateDefault()
@@ -116,6 +117,19 @@ void QMapPolylineObjectPrivateDefault::setWidth(qreal width)
     m_width = width;
 }
 
+QVector<MapPolylineVertexStyle> QMapPolylineObjectPrivateDefault::segmentStyles() const
+{
+    return m_segmentStyles;
+}
+
+void QMapPolylineObjectPrivateDefault::setSegmentStyles(const QVector<MapPolylineVertexStyle> &styles,
+                                                        int first, int count)
+{
+    Q_UNUSED(first);
+    Q_UNUSED(count);
+    m_segmentStyles = styles;
+}
+
 bool QMapPolylineObjectPrivate::equals(const QGeoMapObjectPrivate &other) const
 {
     if (other.type() != type()) // This check might be unnecessary, depending on how equals gets used
@@ -218,6 +232,39 @@ void QMapPolylineObject::setPath(const QVariantList &path)
     }
 }
 
+/*!
+    \qmlmethod void Qt.labs.location::MapPolylineObject::setSegmentStyle(int first, int count, color color, real width)
+
+    Draws the \a count segments starting at the coordinate at index \a first
+    with \a color, and \a width times the width of \l line, instead of the
+    \l line style. A \a width of 0 gives them back the \l line style.
+
+    \sa clearSegmentStyles()
+*/
+void QMapPolylineObject::setSegmentStyle(int first, int count, const QColor &color, qreal width)
+{
+    auto pimpl = static_cast<QMapPolylineObjectPrivate *>(d_ptr.data());
+    first = qMax(first, 0);
+    count = qMin(count, pimpl->path().size() - first);
+    QVector<MapPolylineVertexStyle> styles = pimpl->segmentStyles();
+    if (count > 0 && MapPolylineVertexStyle::assign(styles, first, count, color, width))
+        pimpl->setSegmentStyles(styles, first, count);
+}
+
+/*!
+    \qmlmethod void Qt.labs.location::MapPolylineObject::clearSegmentStyles()
+
+    Draws all the segments with the \l line style again.
+
+    \sa setSegmentStyle()
+*/
+void QMapPolylineObject::clearSegmentStyles()
+{
+    auto pimpl = static_cast<QMapPolylineObjectPrivate *>(d_ptr.data());
+    if (!pimpl->segmentStyles().isEmpty())
+        pimpl->setSegmentStyles(QVector<MapPolylineVertexStyle>(), 0, -1);
+}
+
 void QMapPolylineObject::setMap(QGeoMap *map)
 {
     QMapPolylineObjectPrivate *d = static_cast<QMapPolylineObjectPrivate *>(d_ptr.data());
@@ -73,6 +73,9 @@ public:
     QDeclarativeMapLineProperties *border();
     void setMap(QGeoMap *map) override;
 
+    Q_INVOKABLE void setSegmentStyle(int first, int count, const QColor &color, qreal width = 1.0);
+    Q_INVOKABLE void clearSegmentStyles();
+
 signals:
     void pathChanged();
 
@@ -50,6 +50,7 @@
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeomapobject_p_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 #include <QGeoCoordinate>
 #include <QGeoPath>
 #include <QColor>
@@ -70,6 +71,9 @@ public:
     virtual void setColor(const QColor &color) = 0;
     virtual qreal width() const = 0;
     virtual void setWidth(qreal width) = 0;
+    virtual QVector<MapPolylineVertexStyle> segmentStyles() const = 0;
+    // count styles from first changed, -1 for all of them
+    virtual void setSegmentStyles(const QVector<MapPolylineVertexStyle> &styles, int first, int count) = 0;
 
     // QGeoMapObjectPrivate interface
     bool equals(const QGeoMapObjectPrivate &other) const override;
@@ -91,6 +95,8 @@ public:
     void setColor(const QColor &color) override;
     qreal width() const override;
     void setWidth(qreal width) override;
+    QVector<MapPolylineVertexStyle> segmentStyles() const override;
+    void setSegmentStyles(const QVector<MapPolylineVertexStyle> &styles, int first, int count) override;
 
     // QGeoMapObjectPrivate interface
     QGeoMapObjectPrivate *clone() override;
@@ -99,6 +105,7 @@ public:
     QGeoPath m_path; // small overhead compared to plain QList<QGeoCoordinate>
     QColor m_color;
     qreal m_width = 0;
+    QVector<MapPolylineVertexStyle> m_segmentStyles; // per vertex of m_path
 
 private:
     QMapPolylineObjectPrivateDefault(const QMapPolylineObjectPrivateDefault &other) = delete;
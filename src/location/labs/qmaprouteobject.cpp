@@ -103,6 +103,18 @@ void QMapRouteObjectPrivate::setRoute(const QDeclarativeGeoRoute *route)
     Q_UNUSED(route);
 }
 
+QVector<MapPolylineVertexStyle> QMapRouteObjectPrivate::segmentStyles() const
+{
+    const QMapRouteObject *r = static_cast<QMapRouteObject *>(q);
+    return r->m_segmentStyles;
+}
+
+void QMapRouteObjectPrivate::setSegmentStyles(int first, int count)
+{
+    Q_UNUSED(first);
+    Q_UNUSED(count);
+}
+
 bool QMapRouteObjectPrivate::equals(const QGeoMapObjectPrivate &other) const
 {
     if (other.type() != type()) // This check might be unnecessary, depending on how equals gets used
@@ -166,11 +178,49 @@ void QMapRouteObject::setRoute(QDeclarativeGeoRoute *route)
 //        return;
 
     m_route = route;
+    m_segmentStyles.clear(); // indexed by the vertices of the previous route
     QMapRouteObjectPrivate *d = static_cast<QMapRouteObjectPrivate *>(d_ptr.data());
     d->setRoute(route);
     emit routeChanged(route);
 }
 
+/*!
+    \qmlmethod void Qt.labs.location::MapRouteObject::setSegmentStyle(int first, int count, color color, real width)
+
+    Draws the \a count segments of the route path starting at the coordinate
+    at index \a first with \a color, and \a width times the width of the
+    route line, like the congested legs of a route. A \a width of 0 gives
+    them back the route line style. Setting a new \l route clears the
+    segment styles.
+
+    \sa clearSegmentStyles()
+*/
+void QMapRouteObject::setSegmentStyle(int first, int count, const QColor &color, qreal width)
+{
+    first = qMax(first, 0);
+    count = qMin(count, geoRoute().path().size() - first);
+    if (count > 0 && MapPolylineVertexStyle::assign(m_segmentStyles, first, count, color, width)) {
+        QMapRouteObjectPrivate *d = static_cast<QMapRouteObjectPrivate *>(d_ptr.data());
+        d->setSegmentStyles(first, count);
+    }
+}
+
+/*!
+    \qmlmethod void Qt.labs.location::MapRouteObject::clearSegmentStyles()
+
+    Draws the whole route with the route line style again.
+
+    \sa setSegmentStyle()
+*/
+void QMapRouteObject::clearSegmentStyles()
+{
+    if (m_segmentStyles.isEmpty())
+        return;
+    m_segmentStyles.clear();
+    QMapRouteObjectPrivate *d = static_cast<QMapRouteObjectPrivate *>(d_ptr.data());
+    d->setSegmentStyles(0, -1);
+}
+
 void QMapRouteObject::setMap(QGeoMap *map)
 {
     QMapRouteObjectPrivate *d = static_cast<QMapRouteObjectPrivate *>(d_ptr.data());
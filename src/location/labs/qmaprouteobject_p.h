@@ -53,6 +53,7 @@
 
 #include <QtLocation/private/qgeomapobject_p.h>
 #include <QtLocation/private/qparameterizableobject_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -74,11 +75,15 @@ public:
     void setMap(QGeoMap *map) override;
     void setRoute(QDeclarativeGeoRoute * route);
 
+    Q_INVOKABLE void setSegmentStyle(int first, int count, const QColor &color, qreal width = 1.0);
+    Q_INVOKABLE void clearSegmentStyles();
+
 signals:
     void routeChanged(QDeclarativeGeoRoute * route);
 
 protected:
     QDeclarativeGeoRoute *m_route = nullptr;
+    QVector<MapPolylineVertexStyle> m_segmentStyles; // per vertex of the route path
 
     friend class QMapRouteObjectPrivate;
 };
@@ -68,6 +68,8 @@ public:
 
     virtual QGeoRoute route() const;
     virtual void setRoute(const QDeclarativeGeoRoute *route);
+    QVector<MapPolylineVertexStyle> segmentStyles() const;
+    virtual void setSegmentStyles(int first, int count);
 
     // QGeoMapObjectPrivate interface
     bool equals(const QGeoMapObjectPrivate &other) const override;
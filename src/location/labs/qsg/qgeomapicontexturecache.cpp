@@ -0,0 +1,175 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapicontexturecache_p.h"
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGTexture>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const int MaxUnusedTextures = 64;
+const int MaxImageCacheCost = 16 * 1024; // in kilobytes
+
+struct WindowCaches
+{
+    QMutex mutex;
+    QHash<QQuickWindow *, QWeakPointer<QGeoMapIconTextureCache>> caches;
+};
+
+} // namespace
+
+Q_GLOBAL_STATIC(WindowCaches, windowCaches)
+
+typedef QCache<QString, QImage> ImageCache;
+Q_GLOBAL_STATIC_WITH_ARGS(ImageCache, imageCache, (MaxImageCacheCost))
+
+QGeoMapIconTextureCache::QGeoMapIconTextureCache(QQuickWindow *window)
+    : m_window(window)
+{
+}
+
+QGeoMapIconTextureCache::~QGeoMapIconTextureCache()
+{
+    invalidate();
+}
+
+/*!
+    \internal
+    Returns the cache of \a window, created when none of the icons of the
+    window hold it anymore.
+*/
+QSharedPointer<QGeoMapIconTextureCache> QGeoMapIconTextureCache::forWindow(QQuickWindow *window)
+{
+    WindowCaches *w = windowCaches();
+    QMutexLocker locker(&w->mutex);
+    QSharedPointer<QGeoMapIconTextureCache> cache = w->caches.value(window).toStrongRef();
+    if (cache)
+        return cache;
+
+    for (auto it = w->caches.begin(); it != w->caches.end(); ) {
+        if (it.value().isNull())
+            it = w->caches.erase(it);
+        else
+            ++it;
+    }
+    cache.reset(new QGeoMapIconTextureCache(window));
+    w->caches.insert(window, cache);
+
+    // The textures go with the graphics context, while the nodes holding them
+    // are deleted before.
+    const QWeakPointer<QGeoMapIconTextureCache> weak = cache;
+    QObject::connect(window, &QQuickWindow::sceneGraphInvalidated, window, [weak]() {
+        if (QSharedPointer<QGeoMapIconTextureCache> cache = weak.toStrongRef())
+            cache->invalidate();
+    }, Qt::DirectConnection);
+    return cache;
+}
+
+/*!
+    \internal
+    Returns the image in \a fileName, decoded only once for all the icons
+    showing it while it stays in the cache.
+*/
+QImage QGeoMapIconTextureCache::loadImage(const QString &fileName)
+{
+    if (const QImage *image = imageCache->object(fileName))
+        return *image;
+    const QImage image(fileName);
+    if (!image.isNull())
+        imageCache->insert(fileName, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+    return image;
+}
+
+/*!
+    \internal
+    Returns the texture of \a image, shared with the other images with the same
+    cache key. It is kept until released as many times as it was acquired.
+*/
+QSGTexture *QGeoMapIconTextureCache::acquire(const QImage &image)
+{
+    if (image.isNull())
+        return nullptr;
+
+    auto it = m_entries.find(image.cacheKey());
+    if (it == m_entries.end()) {
+        QSGTexture *texture = m_window->createTextureFromImage(image, QQuickWindow::TextureCanUseAtlas);
+        if (!texture)
+            return nullptr;
+        it = m_entries.insert(image.cacheKey(), { texture, 0 });
+        m_keys.insert(texture, image.cacheKey());
+    } else if (it->refs == 0) {
+        m_unused.removeOne(it.key());
+    }
+    ++it->refs;
+    return it->texture;
+}
+
+/*!
+    \internal
+    Releases \a texture, which stays in the cache until it is among the least
+    recently used ones once released.
+*/
+void QGeoMapIconTextureCache::release(QSGTexture *texture)
+{
+    const auto key = m_keys.constFind(texture);
+    if (key == m_keys.cend())
+        return; // deleted by invalidate()
+    Entry &entry = m_entries[key.value()];
+    if (--entry.refs > 0)
+        return;
+
+    m_unused.append(key.value());
+    while (m_unused.size() > MaxUnusedTextures) {
+        const Entry evicted = m_entries.take(m_unused.takeFirst());
+        m_keys.remove(evicted.texture);
+        delete evicted.texture;
+    }
+}
+
+void QGeoMapIconTextureCache::invalidate()
+{
+    for (const Entry &entry : qAsConst(m_entries))
+        delete entry.texture;
+    m_entries.clear();
+    m_keys.clear();
+    m_unused.clear();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOMAPICONTEXTURECACHE_P_H
+#define QGEOMAPICONTEXTURECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickWindow;
+class QSGTexture;
+
+// Textures of the map icons of a window, shared by the icons showing the same
+// image, and allocated in the atlas of the scene graph when they fit so that
+// the renderer batches the icons. Used in the render thread, but for
+// loadImage() which is used in the GUI thread.
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapIconTextureCache
+{
+public:
+    ~QGeoMapIconTextureCache();
+
+    static QSharedPointer<QGeoMapIconTextureCache> forWindow(QQuickWindow *window);
+    static QImage loadImage(const QString &fileName);
+
+    QSGTexture *acquire(const QImage &image);
+    void release(QSGTexture *texture);
+
+private:
+    explicit QGeoMapIconTextureCache(QQuickWindow *window);
+    void invalidate();
+
+    struct Entry
+    {
+        QSGTexture *texture;
+        int refs;
+    };
+
+    QQuickWindow *m_window;
+    QHash<qint64, Entry> m_entries; // by QImage::cacheKey()
+    QHash<QSGTexture *, qint64> m_keys;
+    QList<qint64> m_unused; // released textures, least recently used first
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPICONTEXTURECACHE_P_H
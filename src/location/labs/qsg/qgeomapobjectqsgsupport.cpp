@@ -36,6 +36,13 @@
 
 #include "qgeomapobjectqsgsupport_p.h"
 #include <QtLocation/private/qgeomap_p_p.h>
+#include <QtLocation/private/qmappolylineobject_p.h>
+#include <QtLocation/private/qmappolygonobject_p.h>
+#include <QtLocation/private/qmapcircleobject_p.h>
+#include <QtLocation/private/qmaprouteobject_p.h>
+#include <QtLocation/private/qmapiconobject_p.h>
+#include <QtLocation/private/qmapheatmapobject_p.h>
+#include <QtPositioning/QGeoPath>
 
 QT_BEGIN_NAMESPACE
 
@@ -49,6 +56,19 @@ static int findMapObject(QGeoMapObject *o, const QList<MapObject> &list)
     return -1;
 }
 
+// Width in pixels of polylines and routes, 0 for the other objects
+static qreal lineWidth(QGeoMapObject *o)
+{
+    switch (o->type()) {
+    case QGeoMapObject::PolylineType:
+        return static_cast<QMapPolylineObject *>(o)->border()->width();
+    case QGeoMapObject::RouteType:
+        return 4; // as hardcoded in QMapRouteObjectPrivateQSG
+    default:
+        return 0;
+    }
+}
+
 bool QGeoMapObjectQSGSupport::createMapObjectImplementation(QGeoMapObject *obj, QGeoMapPrivate *d)
 {
     QExplicitlySharedDataPointer<QGeoMapObjectPrivate> pimpl =
@@ -109,6 +129,14 @@ QGeoMapObjectPrivate *QGeoMapObjectQSGSupport::createMapObjectImplementationPriv
             res = pimpl;
             break;
         }
+        case QGeoMapObject::HeatmapType: {
+            QMapHeatmapObjectPrivate &oldImpl = static_cast<QMapHeatmapObjectPrivate &>(*obj->implementation());
+            QMapHeatmapObjectPrivateQSG *pimpl =
+                    new QMapHeatmapObjectPrivateQSG(oldImpl);
+            sgo = pimpl;
+            res = pimpl;
+            break;
+        }
         default:
             // Use the following warning only for debugging purposes.
             // qWarning() << "QGeoMapObjectQSGSupport::createMapObjectImplementationPrivate: not instantiating pimpl for unsupported object type " << obj->type();
@@ -116,6 +144,7 @@ QGeoMapObjectPrivate *QGeoMapObjectQSGSupport::createMapObjectImplementationPriv
         }
 
         if (res) {
+            sgo->m_support = this;
             QPointer<QGeoMapObject> p(obj);
             MapObject mo(p, sgo);
             m_pendingMapObjects << mo;
@@ -139,6 +168,11 @@ void QGeoMapObjectQSGSupport::removeMapObject(QGeoMapObject *obj)
     if (idx >= 0) {
         const MapObject &mo = m_mapObjects.takeAt(idx);
         obj->disconnect(m_map);
+        m_spatialIndex.remove(obj);
+        m_dirtyMapObjects.removeAll(mo.sgObject);
+        m_mapObjectIndices.remove(mo.sgObject);
+        for (int i = idx; i < m_mapObjects.size(); ++i)
+            m_mapObjectIndices[m_mapObjects.at(i).sgObject] = i;
         m_removedMapObjects << mo;
         emit m_map->sgNodeChanged();
     } else {
@@ -162,7 +196,7 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
         root->appendChildNode(m_mapObjectsRootNode);
     }
 
-    m_mapObjectsRootNode->removeAllChildNodes();
+    // Deleting the nodes detaches them from m_mapObjectsRootNode
     for (int i = 0; i < m_removedMapObjects.size(); ++i) {
         MapObject mo = m_removedMapObjects[i];
         if (mo.qsgNode)  {
@@ -174,24 +208,16 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
     }
     m_removedMapObjects.clear();
 
-    for (int i = 0; i < m_mapObjects.size(); ++i) {
-        // already added as node
-        if (Q_UNLIKELY(!m_mapObjects.at(i).object)) {
-            qWarning() << "unexpected NULL pointer in m_mapObjects at "<<i;
+    // Only the objects that changed are visited, the other nodes stay untouched
+    for (QQSGMapObject *sgo: qAsConst(m_dirtyMapObjects)) {
+        const int idx = m_mapObjectIndices.value(sgo, -1);
+        if (Q_UNLIKELY(idx < 0 || !m_mapObjects.at(idx).object)) {
+            qWarning() << "unexpected dirty object not in m_mapObjects";
             continue;
         }
-
-        MapObject &mo = m_mapObjects[i];
-        QQSGMapObject *sgo = mo.sgObject;
-        QSGNode *oldNode = mo.qsgNode;
-        mo.qsgNode = sgo->updateMapObjectNode(oldNode, &mo.visibleNode, m_mapObjectsRootNode, window);
-        if (Q_UNLIKELY(!mo.qsgNode)) {
-            qWarning() << "updateMapObjectNode for "<<mo.object->type() << " returned NULL";
-        } else if (mo.visibleNode && (mo.visibleNode->visible() != mo.object->visible())) {
-            mo.visibleNode->setVisible(mo.object->visible());
-            mo.qsgNode->markDirty(QSGNode::DirtySubtreeBlocked);
-        }
+        updateMapObjectNode(m_mapObjects[idx], window);
     }
+    m_dirtyMapObjects.clear();
 
     QList<int> toRemove;
     for (int i = 0; i < m_pendingMapObjects.size(); ++i) {
@@ -206,9 +232,15 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
                 mo.visibleNode->setVisible(mo.object->visible());
                 mo.qsgNode->markDirty(QSGNode::DirtySubtreeBlocked);
             }
+            sgo->m_nodeDirty = false;
+            m_mapObjectIndices.insert(sgo, m_mapObjects.size());
             m_mapObjects << mo;
             toRemove.push_front(i);
-            QObject::connect(mo.object, SIGNAL(visibleChanged()), m_map, SIGNAL(sgNodeChanged()));
+            QObject::connect(mo.object, &QGeoMapObject::visibleChanged, m_map, [this, sgo]() {
+                sgo->markNodeDirty();
+                emit m_map->sgNodeChanged();
+            });
+            indexMapObject(mo.object);
         } else {
             // leave it to be processed, don't spit warnings
         }
@@ -219,6 +251,30 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
     m_mapObjectsRootNode->setSubtreeBlocked(false);
 }
 
+// called in the render thread
+void QGeoMapObjectQSGSupport::updateMapObjectNode(MapObject &mo, QQuickWindow *window)
+{
+    QQSGMapObject *sgo = mo.sgObject;
+    QSGNode *oldNode = mo.qsgNode;
+    // where to put the node back, if it gets replaced
+    QSGNode *next = (oldNode && oldNode->parent()) ? oldNode->nextSibling() : nullptr;
+    mo.qsgNode = sgo->updateMapObjectNode(oldNode, &mo.visibleNode, m_mapObjectsRootNode, window);
+    sgo->m_nodeDirty = false;
+
+    if (Q_UNLIKELY(!mo.qsgNode)) { // oldNode got deleted
+        qWarning() << "updateMapObjectNode for "<<mo.object->type() << " returned NULL";
+        return;
+    }
+    if (mo.qsgNode != oldNode && next) {
+        m_mapObjectsRootNode->removeChildNode(mo.qsgNode);
+        m_mapObjectsRootNode->insertChildNodeBefore(mo.qsgNode, next);
+    }
+    if (mo.visibleNode && (mo.visibleNode->visible() != mo.object->visible())) {
+        mo.visibleNode->setVisible(mo.object->visible());
+        mo.qsgNode->markDirty(QSGNode::DirtySubtreeBlocked);
+    }
+}
+
 // called in GUI thread
 void QGeoMapObjectQSGSupport::updateObjectsGeometry()
 {
@@ -235,4 +291,87 @@ void QGeoMapObjectQSGSupport::updateObjectsGeometry()
     emit m_map->sgNodeChanged();
 }
 
+// Connections are made with m_map as context, so that removeMapObject() drops them
+void QGeoMapObjectQSGSupport::indexMapObject(QGeoMapObject *obj)
+{
+    m_spatialIndex.insert(obj, lineWidth(obj));
+    auto markDirty = [this, obj]() { m_spatialIndex.markDirty(obj); };
+    switch (obj->type()) {
+    case QGeoMapObject::PolylineType: {
+        QMapPolylineObject *polyline = static_cast<QMapPolylineObject *>(obj);
+        QObject::connect(polyline, &QMapPolylineObject::pathChanged, m_map, markDirty);
+        // Not captured, the border may outlive the entry
+        QObject::connect(polyline->border(), &QDeclarativeMapLineProperties::widthChanged, m_map,
+                         [this](qreal width) { m_spatialIndex.noteLineWidth(width); });
+        break;
+    }
+    case QGeoMapObject::PolygonType:
+        QObject::connect(static_cast<QMapPolygonObject *>(obj), &QMapPolygonObject::pathChanged,
+                         m_map, markDirty);
+        break;
+    case QGeoMapObject::CircleType:
+        QObject::connect(static_cast<QMapCircleObject *>(obj), &QMapCircleObject::centerChanged,
+                         m_map, markDirty);
+        QObject::connect(static_cast<QMapCircleObject *>(obj), &QMapCircleObject::radiusChanged,
+                         m_map, markDirty);
+        break;
+    case QGeoMapObject::RouteType:
+        QObject::connect(static_cast<QMapRouteObject *>(obj), &QMapRouteObject::routeChanged,
+                         m_map, markDirty);
+        break;
+    case QGeoMapObject::IconType:
+        QObject::connect(static_cast<QMapIconObject *>(obj), &QMapIconObject::coordinateChanged,
+                         m_map, markDirty);
+        QObject::connect(static_cast<QMapIconObject *>(obj), &QMapIconObject::iconSizeChanged,
+                         m_map, markDirty);
+        break;
+    case QGeoMapObject::HeatmapType:
+        QObject::connect(static_cast<QMapHeatmapObject *>(obj), &QMapHeatmapObject::pointsChanged,
+                         m_map, markDirty);
+        break;
+    default:
+        break;
+    }
+}
+
+// called in GUI thread
+QList<QGeoMapObject *> QGeoMapObjectQSGSupport::mapObjectsAt(const QGeoCoordinate &coordinate,
+                                                             qreal metersPerPixel) const
+{
+    QList<QGeoMapObject *> res;
+    const QList<QObject *> candidates = m_spatialIndex.candidatesAt(coordinate, metersPerPixel);
+    for (QObject *candidate: candidates) {
+        QGeoMapObject *o = static_cast<QGeoMapObject *>(candidate);
+        bool contains = false;
+        if (o->type() == QGeoMapObject::PolylineType || o->type() == QGeoMapObject::RouteType) {
+            // Lines are hit within half their on-screen width. Measuring the distance to the
+            // closest point keeps the path shared, where QGeoPath::setWidth() would detach it.
+            const QGeoPath path(o->geoShape());
+            const QGeoCoordinate closest = path.closestPoint(coordinate);
+            const qreal radius = qMax(metersPerPixel * lineWidth(o) * 0.5,
+                                      0.2); // minimum radius of QGeoPath::contains()
+            contains = closest.isValid() && closest.distanceTo(coordinate) <= radius;
+        } else {
+            contains = o->geoShape().contains(coordinate);
+        }
+
+        if (contains)
+            res.append(o);
+    }
+    return res;
+}
+
+// called in GUI thread
+QList<QGeoMapObject *> QGeoMapObjectQSGSupport::mapObjectsIn(const QGeoShape &region) const
+{
+    QList<QGeoMapObject *> res;
+    const QList<QObject *> candidates = m_spatialIndex.candidatesIn(region.boundingGeoRectangle());
+    for (QObject *candidate: candidates) {
+        QGeoMapObject *o = static_cast<QGeoMapObject *>(candidate);
+        if (QGeoMapSpatialIndex::intersects(region, o->geoShape().boundingGeoRectangle()))
+            res.append(o);
+    }
+    return res;
+}
+
 QT_END_NAMESPACE
@@ -56,9 +56,13 @@
 #include <QtLocation/private/qmapcircleobjectqsg_p_p.h>
 #include <QtLocation/private/qmaprouteobjectqsg_p_p.h>
 #include <QtLocation/private/qmapiconobjectqsg_p_p.h>
+#include <QtLocation/private/qmapheatmapobjectqsg_p_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 #include <QtLocation/private/qdeclarativepolygonmapitem_p_p.h>
+#include <QtLocation/private/qgeomapspatialindex_p.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 struct Q_LOCATION_PRIVATE_EXPORT MapObject {
@@ -79,11 +83,18 @@ public:
     QList<QGeoMapObject *> mapObjects() const;
     void removeMapObject(QGeoMapObject *obj);
     void updateMapObjects(QSGNode *root, QQuickWindow *window);
+    void updateMapObjectNode(MapObject &mo, QQuickWindow *window);
     void updateObjectsGeometry();
+    void indexMapObject(QGeoMapObject *obj);
+    QList<QGeoMapObject *> mapObjectsAt(const QGeoCoordinate &coordinate, qreal metersPerPixel) const;
+    QList<QGeoMapObject *> mapObjectsIn(const QGeoShape &region) const;
 
     QList<MapObject> m_mapObjects;
     QList<MapObject> m_pendingMapObjects;
     QList<MapObject> m_removedMapObjects;
+    QVector<QQSGMapObject *> m_dirtyMapObjects; // queued by QQSGMapObject::markNodeDirty()
+    QHash<QQSGMapObject *, int> m_mapObjectIndices; // into m_mapObjects
+    QGeoMapSpatialIndex m_spatialIndex; // over m_mapObjects
     QGeoMap *m_map = nullptr;
     QDeclarativePolygonMapItemPrivateOpenGL::RootNode *m_mapObjectsRootNode = nullptr;
 };
@@ -67,6 +67,7 @@ QMapCircleObjectPrivateQSG::~QMapCircleObjectPrivateQSG()
 
 void QMapCircleObjectPrivateQSG::updateGeometry()
 {
+    markNodeDirty();
     if (!m_dataGL.isNull())
         updateGeometryGL();
     else
@@ -77,9 +78,7 @@ void QMapCircleObjectPrivateQSG::CircleDataCPU::updateCirclePath(const QGeoCoord
 {
     QList<QGeoCoordinate> path;
     QDeclarativeCircleMapItemPrivateCPU::calculatePeripheralPoints(path, center, radius, CircleSamples, m_leftBound);
-    m_circlePath.clear();
-    for (const QGeoCoordinate &c : path)
-        m_circlePath << p.geoToMapProjection(c);
+    m_circlePath = p.geoToMapProjection(path);
 }
 
 void QMapCircleObjectPrivateQSG::updateGeometryCPU()
@@ -242,7 +241,9 @@ QSGNode *QMapCircleObjectPrivateQSG::updateMapObjectNodeCPU(QSGNode *oldNode,
     }
 
     if (!m_dataCPU->m_geometry.size() && !m_dataCPU->m_borderGeometry.size()) {
-        visibleNode = nullptr;
+        delete m_dataCPU->m_node;
+        m_dataCPU->m_node = nullptr;
+        *visibleNode = nullptr;
         return nullptr;
     }
 
@@ -257,11 +258,12 @@ QSGNode *QMapCircleObjectPrivateQSG::updateMapObjectNodeCPU(QSGNode *oldNode,
     }
 
     if (m_dataCPU->m_geometry.size() || m_dataCPU->m_borderGeometry.size()) {
-        root->appendChildNode(m_dataCPU->m_node);
+        if (!m_dataCPU->m_node->parent()) // nodes already attached keep their stacking order
+            root->appendChildNode(m_dataCPU->m_node);
     } else {
         delete m_dataCPU->m_node;
         m_dataCPU->m_node = nullptr;
-        visibleNode = nullptr;
+        *visibleNode = nullptr;
         return nullptr;
     }
     return m_dataCPU->m_node;
@@ -312,7 +314,8 @@ QSGNode *QMapCircleObjectPrivateQSG::updateMapObjectNodeGL(QSGNode *oldNode,
 
     if (!m_dataGL->m_polylinenode->isSubtreeBlocked() || !m_dataGL->m_node->isSubtreeBlocked()) {
         m_dataGL->m_rootNode->setSubtreeBlocked(false);
-        root->appendChildNode(m_dataGL->m_rootNode);
+        if (!m_dataGL->m_rootNode->parent()) // nodes already attached keep their stacking order
+            root->appendChildNode(m_dataGL->m_rootNode);
         return m_dataGL->m_rootNode;
     } else {
         delete m_dataGL->m_rootNode;
@@ -361,6 +364,7 @@ void QMapCircleObjectPrivateQSG::setColor(const QColor &color)
     QMapCircleObjectPrivateDefault::setColor(color);
     if (!m_dataCPU.isNull())
         updateGeometry();
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
@@ -370,6 +374,7 @@ void QMapCircleObjectPrivateQSG::setBorderColor(const QColor &color)
     QMapCircleObjectPrivateDefault::setBorderColor(color);
     if (!m_dataCPU.isNull())
         updateGeometry();
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
@@ -379,6 +384,7 @@ void QMapCircleObjectPrivateQSG::setBorderWidth(qreal width)
     QMapCircleObjectPrivateDefault::setBorderWidth(width);
     if (!m_dataCPU.isNull())
         updateGeometry();
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
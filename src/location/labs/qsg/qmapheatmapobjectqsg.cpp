@@ -0,0 +1,511 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmapheatmapobjectqsg_p_p.h"
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtGui/QLinearGradient>
+#include <QtGui/QOpenGLBuffer>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOpenGLShaderProgram>
+#include <QtGui/QOpenGLTexture>
+#include <QtGui/QPainter>
+#include <QtQuick/QSGRenderNode>
+#include <QtCore/qmath.h>
+#include <cmath>
+
+#ifndef GL_RGBA16F
+#define GL_RGBA16F 0x881A
+#endif
+#ifndef GL_VERTEX_PROGRAM_POINT_SIZE
+#define GL_VERTEX_PROGRAM_POINT_SIZE 0x8642
+#endif
+#ifndef GL_POINT_SPRITE
+#define GL_POINT_SPRITE 0x8861
+#endif
+#ifndef GL_ALIASED_POINT_SIZE_RANGE
+#define GL_ALIASED_POINT_SIZE_RANGE 0x846E
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const int ColorMapSize = 256;
+
+// Adds up a disc for each point, falling off from 1 at its center
+const char *const splatVertexShader =
+    "attribute highp vec4 vertex;               \n"
+    "uniform highp mat4 mapProjection;          \n"
+    "uniform highp vec3 center;                 \n"
+    "uniform highp vec3 center_lowpart;         \n"
+    "uniform highp vec2 offset;                 \n"
+    "uniform highp vec2 target;                 \n"
+    "uniform highp float pointSize;             \n"
+    "void main() {                              \n"
+    "    vec2 d = (vertex.xy - center.xy) + (vertex.zw - center_lowpart.xy);\n"
+    "    d.x = d.x - floor(d.x + 0.5);          \n" // the copy of the world closest to the center
+    "    vec4 p = mapProjection * vec4(d, 0.0, 1.0);\n"
+    "    gl_PointSize = pointSize;              \n"
+    "    if (p.w <= 0.0) {                      \n" // behind the camera
+    "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+    "        return;                            \n"
+    "    }                                      \n"
+    "    vec2 pos = (p.xy / p.w + offset) / target;\n"
+    "    gl_Position = vec4(pos.x * 2.0 - 1.0, 1.0 - pos.y * 2.0, 0.0, 1.0);\n"
+    "}";
+
+const char *const splatFragmentShader =
+    "uniform highp float weight;                \n"
+    "void main() {                              \n"
+    "    highp vec2 d = gl_PointCoord * 2.0 - 1.0;\n"
+    "    highp float k = max(1.0 - dot(d, d), 0.0);\n"
+    "    gl_FragColor = vec4(k * k * weight);   \n"
+    "}";
+
+// Colors the summed densities over the viewport
+const char *const colorVertexShader =
+    "attribute highp vec2 vertex;               \n"
+    "uniform highp mat4 qt_Matrix;              \n"
+    "uniform highp vec2 offset;                 \n"
+    "uniform highp vec2 target;                 \n"
+    "varying highp vec2 uv;                     \n"
+    "void main() {                              \n"
+    "    vec2 pos = (vertex + offset) / target; \n"
+    "    uv = vec2(pos.x, 1.0 - pos.y);         \n"
+    "    gl_Position = qt_Matrix * vec4(vertex, 0.0, 1.0);\n"
+    "}";
+
+const char *const colorFragmentShader =
+    "uniform sampler2D density;                 \n"
+    "uniform sampler2D colors;                  \n"
+    "uniform lowp float opacity;                \n"
+    "varying highp vec2 uv;                     \n"
+    "void main() {                              \n"
+    "    highp float v = texture2D(density, uv).r;\n"
+    "    if (v < 1.0 / 512.0)                   \n"
+    "        discard;                           \n"
+    "    highp float t = clamp(v, 0.0, 1.0) * (255.0 / 256.0) + 0.5 / 256.0;\n"
+    "    gl_FragColor = texture2D(colors, vec2(t, 0.5)) * opacity;\n"
+    "}";
+
+bool hasHalfFloatTargets(QOpenGLContext *context)
+{
+    const QSurfaceFormat format = context->format();
+    if (context->isOpenGLES()) {
+        return format.majorVersion() >= 3
+                && (context->hasExtension("GL_EXT_color_buffer_half_float")
+                    || context->hasExtension("GL_EXT_color_buffer_float"));
+    }
+    return format.majorVersion() >= 3 || context->hasExtension("GL_ARB_texture_float");
+}
+
+/*
+    Draws the heatmap in two passes: the points are drawn as discs, adding up
+    in an offscreen target larger than the viewport by half a disc on each
+    side, so that the points just outside of it still count, then the sums are
+    colored over the viewport. Only the projection changes with the camera.
+*/
+class HeatmapNode : public QSGRenderNode, public VisibleNode
+{
+public:
+    ~HeatmapNode() override
+    {
+        releaseResources();
+    }
+
+    bool isSubtreeBlocked() const override
+    {
+        return subtreeBlocked();
+    }
+
+    StateFlags changedStates() const override
+    {
+        return DepthState | StencilState | ScissorState | BlendState | ViewportState | RenderTargetState;
+    }
+
+    RenderingFlags flags() const override
+    {
+        return BoundedRectRendering;
+    }
+
+    QRectF rect() const override
+    {
+        return QRectF(QPointF(), m_size);
+    }
+
+    void render(const RenderState *state) override;
+    void releaseResources() override;
+
+    // Set while synchronizing, with the GUI thread blocked
+    QVector<QDoubleVector2D> m_points;
+    bool m_pointsDirty = false;
+    QImage m_colorMap;
+    bool m_colorMapDirty = false;
+    QMatrix4x4 m_geoProjection;
+    QDoubleVector3D m_center;
+    QSizeF m_size;
+    float m_radius = 0;
+    float m_weight = 0;
+
+private:
+    bool initialize(QOpenGLContext *context);
+
+    QOpenGLShaderProgram *m_splatProgram = nullptr;
+    QOpenGLShaderProgram *m_colorProgram = nullptr;
+    QOpenGLBuffer *m_pointBuffer = nullptr;
+    QOpenGLBuffer *m_quadBuffer = nullptr;
+    QOpenGLFramebufferObject *m_target = nullptr;
+    QOpenGLTexture *m_colorTexture = nullptr;
+    int m_pointCount = 0;
+    float m_maxPointSize = 1;
+    QSize m_quadSize;
+};
+
+bool HeatmapNode::initialize(QOpenGLContext *context)
+{
+    // gl_PointCoord comes with GLSL 1.20 on desktop OpenGL
+    const QByteArray version = context->isOpenGLES() ? QByteArray() : QByteArrayLiteral("#version 120\n");
+    m_splatProgram = new QOpenGLShaderProgram;
+    m_splatProgram->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, version + splatVertexShader);
+    m_splatProgram->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, version + splatFragmentShader);
+    m_splatProgram->bindAttributeLocation("vertex", 0);
+    m_colorProgram = new QOpenGLShaderProgram;
+    m_colorProgram->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, colorVertexShader);
+    m_colorProgram->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, colorFragmentShader);
+    m_colorProgram->bindAttributeLocation("vertex", 0);
+    if (!m_splatProgram->link() || !m_colorProgram->link()) {
+        qWarning() << "MapHeatmapObject: the shaders failed to link" << m_splatProgram->log() << m_colorProgram->log();
+        return false;
+    }
+    m_colorProgram->bind();
+    m_colorProgram->setUniformValue("density", 0);
+    m_colorProgram->setUniformValue("colors", 1);
+
+    m_pointBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    m_pointBuffer->create();
+    m_quadBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    m_quadBuffer->create();
+
+    GLfloat range[2] = { 1, 1 };
+    context->functions()->glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, range);
+    m_maxPointSize = qMax(range[1], 1.0f);
+    return true;
+}
+
+void HeatmapNode::render(const RenderState *state)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context || m_size.isEmpty())
+        return;
+    if (!m_splatProgram && !initialize(context))
+        return;
+    if (!m_splatProgram->isLinked())
+        return;
+
+    QOpenGLFunctions *f = context->functions();
+
+    if (m_pointsDirty) {
+        m_pointsDirty = false;
+        // the positions are split in two floats, for the precision of doubles at high zoom levels
+        QVector<float> vertices(m_points.size() * 4);
+        for (int i = 0; i < m_points.size(); ++i) {
+            QLocationUtils::split_double(m_points.at(i).x(), &vertices[i * 4], &vertices[i * 4 + 2]);
+            QLocationUtils::split_double(m_points.at(i).y(), &vertices[i * 4 + 1], &vertices[i * 4 + 3]);
+        }
+        m_pointBuffer->bind();
+        m_pointBuffer->allocate(vertices.constData(), vertices.size() * int(sizeof(float)));
+        m_pointBuffer->release();
+        m_pointCount = m_points.size();
+        m_points = QVector<QDoubleVector2D>(); // uploaded
+    }
+    if (m_colorMapDirty) {
+        m_colorMapDirty = false;
+        delete m_colorTexture;
+        m_colorTexture = new QOpenGLTexture(m_colorMap, QOpenGLTexture::DontGenerateMipMaps);
+        m_colorTexture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
+        m_colorTexture->setWrapMode(QOpenGLTexture::ClampToEdge);
+    }
+    if (!m_pointCount || !m_colorTexture)
+        return;
+
+    const float pointSize = qBound(1.0f, m_radius * 2.0f, m_maxPointSize);
+    const int margin = int(std::ceil(pointSize / 2));
+    const QSize size(qCeil(m_size.width()), qCeil(m_size.height()));
+    const QSize targetSize = size + QSize(margin * 2, margin * 2);
+    if (!m_target || m_target->size() != targetSize) {
+        delete m_target;
+        m_target = new QOpenGLFramebufferObject(targetSize, QOpenGLFramebufferObject::NoAttachment,
+                                                GL_TEXTURE_2D,
+                                                hasHalfFloatTargets(context) ? GL_RGBA16F : GL_RGBA);
+    }
+    if (size != m_quadSize) {
+        m_quadSize = size;
+        const GLfloat quad[] = { 0, 0, GLfloat(size.width()), 0,
+                                 0, GLfloat(size.height()), GLfloat(size.width()), GLfloat(size.height()) };
+        m_quadBuffer->bind();
+        m_quadBuffer->allocate(quad, sizeof(quad));
+        m_quadBuffer->release();
+    }
+
+    GLint renderTarget = 0;
+    GLint viewport[4];
+    f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &renderTarget);
+    f->glGetIntegerv(GL_VIEWPORT, viewport);
+
+    const QVector2D offset(margin, margin);
+    const QVector2D target(targetSize.width(), targetSize.height());
+
+    // Sums the discs
+    m_target->bind();
+    f->glViewport(0, 0, targetSize.width(), targetSize.height());
+    f->glDisable(GL_DEPTH_TEST);
+    f->glDisable(GL_STENCIL_TEST);
+    f->glDisable(GL_SCISSOR_TEST);
+    f->glClearColor(0, 0, 0, 0);
+    f->glClear(GL_COLOR_BUFFER_BIT);
+    f->glEnable(GL_BLEND);
+    f->glBlendEquation(GL_FUNC_ADD);
+    f->glBlendFunc(GL_ONE, GL_ONE);
+    if (!context->isOpenGLES()) {
+        f->glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+        f->glEnable(GL_POINT_SPRITE);
+    }
+
+    QVector3D center, centerLowpart;
+    for (int i = 0; i < 3; i++)
+        QLocationUtils::split_double(m_center.get(i), &center[i], &centerLowpart[i]);
+    m_splatProgram->bind();
+    m_splatProgram->setUniformValue("mapProjection", m_geoProjection);
+    m_splatProgram->setUniformValue("center", center);
+    m_splatProgram->setUniformValue("center_lowpart", centerLowpart);
+    m_splatProgram->setUniformValue("offset", offset);
+    m_splatProgram->setUniformValue("target", target);
+    m_splatProgram->setUniformValue("pointSize", pointSize);
+    m_splatProgram->setUniformValue("weight", m_weight);
+    m_pointBuffer->bind();
+    m_splatProgram->enableAttributeArray(0);
+    m_splatProgram->setAttributeBuffer(0, GL_FLOAT, 0, 4);
+    f->glDrawArrays(GL_POINTS, 0, m_pointCount);
+    m_splatProgram->disableAttributeArray(0);
+    m_pointBuffer->release();
+    if (!context->isOpenGLES()) {
+        f->glDisable(GL_POINT_SPRITE);
+        f->glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+    }
+
+    // Colors them, within the clip of the item
+    f->glBindFramebuffer(GL_FRAMEBUFFER, renderTarget);
+    f->glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (state->scissorEnabled()) {
+        const QRect scissor = state->scissorRect();
+        f->glEnable(GL_SCISSOR_TEST);
+        f->glScissor(scissor.x(), scissor.y(), scissor.width(), scissor.height());
+    }
+    if (state->stencilEnabled()) {
+        f->glEnable(GL_STENCIL_TEST);
+        f->glStencilFunc(GL_EQUAL, state->stencilValue(), 0xff);
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    }
+    f->glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_colorProgram->bind();
+    m_colorProgram->setUniformValue("qt_Matrix", *state->projectionMatrix() * *matrix());
+    m_colorProgram->setUniformValue("offset", offset);
+    m_colorProgram->setUniformValue("target", target);
+    m_colorProgram->setUniformValue("opacity", float(inheritedOpacity()));
+    f->glActiveTexture(GL_TEXTURE1);
+    m_colorTexture->bind();
+    f->glActiveTexture(GL_TEXTURE0);
+    f->glBindTexture(GL_TEXTURE_2D, m_target->texture());
+    m_quadBuffer->bind();
+    m_colorProgram->enableAttributeArray(0);
+    m_colorProgram->setAttributeBuffer(0, GL_FLOAT, 0, 2);
+    f->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    m_colorProgram->disableAttributeArray(0);
+    m_quadBuffer->release();
+}
+
+void HeatmapNode::releaseResources()
+{
+    delete m_splatProgram;
+    m_splatProgram = nullptr;
+    delete m_colorProgram;
+    m_colorProgram = nullptr;
+    delete m_pointBuffer;
+    m_pointBuffer = nullptr;
+    delete m_quadBuffer;
+    m_quadBuffer = nullptr;
+    delete m_target;
+    m_target = nullptr;
+    delete m_colorTexture;
+    m_colorTexture = nullptr;
+    m_quadSize = QSize();
+    m_pointCount = 0;
+}
+
+} // namespace
+
+QMapHeatmapObjectPrivateQSG::QMapHeatmapObjectPrivateQSG(QGeoMapObject *q)
+    : QMapHeatmapObjectPrivateDefault(q)
+{
+    updateColorMap();
+}
+
+QMapHeatmapObjectPrivateQSG::QMapHeatmapObjectPrivateQSG(const QMapHeatmapObjectPrivate &other)
+    : QMapHeatmapObjectPrivateDefault(other)
+{
+    // Data already cloned by the *Default copy constructor, but necessary
+    // update operations triggered only by setters overrides
+    updateColorMap();
+    updateGeometry();
+    if (m_map)
+        emit m_map->sgNodeChanged();
+}
+
+QMapHeatmapObjectPrivateQSG::~QMapHeatmapObjectPrivateQSG()
+{
+    if (m_map)
+        m_map->removeMapObject(q);
+}
+
+void QMapHeatmapObjectPrivateQSG::updateColorMap()
+{
+    QLinearGradient gradient(0, 0, ColorMapSize, 0);
+    const int count = m_colors.size();
+    for (int i = 0; i < count; ++i)
+        gradient.setColorAt(count > 1 ? qreal(i) / (count - 1) : 0.0, m_colors.at(i).value<QColor>());
+
+    QImage colorMap(ColorMapSize, 1, QImage::Format_ARGB32_Premultiplied);
+    colorMap.fill(Qt::transparent);
+    if (count) {
+        QPainter painter(&colorMap);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(colorMap.rect(), gradient);
+    }
+    m_colorMap = colorMap.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+    m_colorMapDirty = true;
+}
+
+void QMapHeatmapObjectPrivateQSG::updateGeometry()
+{
+    // The projection is taken when the node is updated
+    markNodeDirty();
+}
+
+QSGNode *QMapHeatmapObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
+                                                          VisibleNode **visibleNode,
+                                                          QSGNode *root,
+                                                          QQuickWindow */*window*/)
+{
+    HeatmapNode *node = static_cast<HeatmapNode *>(oldNode);
+    if (!node) {
+        node = new HeatmapNode();
+        *visibleNode = static_cast<VisibleNode *>(node);
+        m_pointsDirty = m_colorMapDirty = true;
+    }
+
+    if (m_pointsDirty) {
+        m_pointsDirty = false;
+        node->m_points = m_mercatorPoints; // shared until uploaded
+        node->m_pointsDirty = true;
+    }
+    if (m_colorMapDirty) {
+        m_colorMapDirty = false;
+        node->m_colorMap = m_colorMap;
+        node->m_colorMapDirty = true;
+    }
+
+    if (m_map && m_map->geoProjection().projectionType() == QGeoProjection::ProjectionWebMercator) {
+        const QGeoProjection &p = m_map->geoProjection();
+        node->m_geoProjection = p.qsgTransform();
+        node->m_center = p.centerMercator();
+        node->m_size = QSizeF(m_map->viewportWidth(), m_map->viewportHeight());
+    }
+    node->m_radius = float(radius());
+    node->m_weight = float(1.0 / maximumDensity());
+    node->setSubtreeBlocked(m_mercatorPoints.isEmpty());
+    node->markDirty(QSGNode::DirtyMaterial);
+
+    if (!node->parent()) // nodes already attached keep their stacking order
+        root->appendChildNode(node);
+
+    return node;
+}
+
+void QMapHeatmapObjectPrivateQSG::setPoints(const QVariant &points)
+{
+    QMapHeatmapObjectPrivateDefault::setPoints(points);
+    m_pointsDirty = true;
+    markNodeDirty();
+    if (m_map)
+        emit m_map->sgNodeChanged();
+}
+
+void QMapHeatmapObjectPrivateQSG::setRadius(qreal radius)
+{
+    QMapHeatmapObjectPrivateDefault::setRadius(radius);
+    markNodeDirty();
+    if (m_map)
+        emit m_map->sgNodeChanged();
+}
+
+void QMapHeatmapObjectPrivateQSG::setMaximumDensity(qreal density)
+{
+    QMapHeatmapObjectPrivateDefault::setMaximumDensity(density);
+    markNodeDirty();
+    if (m_map)
+        emit m_map->sgNodeChanged();
+}
+
+void QMapHeatmapObjectPrivateQSG::setColors(const QVariantList &colors)
+{
+    QMapHeatmapObjectPrivateDefault::setColors(colors);
+    updateColorMap();
+    markNodeDirty();
+    if (m_map)
+        emit m_map->sgNodeChanged();
+}
+
+QGeoMapObjectPrivate *QMapHeatmapObjectPrivateQSG::clone()
+{
+    return new QMapHeatmapObjectPrivateQSG(static_cast<QMapHeatmapObjectPrivate &>(*this));
+}
+
+QT_END_NAMESPACE
@@ -35,6 +35,7 @@
 ****************************************************************************/
 
 #include "qmapiconobjectqsg_p_p.h"
+#include "qgeomapicontexturecache_p.h"
 #include <QtQuick/qsgimagenode.h>
 #include <QtQuick/qsgnode.h>
 #include <QtQuick/private/qquickimage_p.h>
@@ -50,12 +51,23 @@ QT_BEGIN_NAMESPACE
 class RootNode : public QSGTransformNode, public VisibleNode
 {
 public:
-    RootNode() { }
+    explicit RootNode(QQuickWindow *window)
+        : m_textureCache(QGeoMapIconTextureCache::forWindow(window))
+    {
+    }
+
+    ~RootNode() override
+    {
+        m_textureCache->release(m_texture);
+    }
 
     bool isSubtreeBlocked() const override
     {
         return subtreeBlocked();
     }
+
+    QSharedPointer<QGeoMapIconTextureCache> m_textureCache;
+    QSGTexture *m_texture = nullptr; // owned by m_textureCache
 };
 
 QMapIconObjectPrivateQSG::QMapIconObjectPrivateQSG(QGeoMapObject *q)
@@ -81,6 +93,7 @@ QMapIconObjectPrivateQSG::~QMapIconObjectPrivateQSG()
 
 void QMapIconObjectPrivateQSG::updateGeometry()
 {
+    markNodeDirty();
     if (!m_map)
         return;
 
@@ -104,19 +117,25 @@ QSGNode *QMapIconObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
     Q_UNUSED(visibleNode);
     RootNode *node = static_cast<RootNode *>(oldNode);
     if (!node) {
-        node = new RootNode();
+        node = new RootNode(window);
         m_imageNode = window->createImageNode();
-        m_imageNode->setOwnsTexture(true);
         node->appendChildNode(m_imageNode);
         *visibleNode = static_cast<VisibleNode *>(node);
     }
 
     if (m_imageDirty) {
         m_imageDirty = false;
-        m_imageNode->setTexture(window->createTextureFromImage(m_image));
-        QRect rect = m_image.rect();
-        m_imageNode->setSourceRect(rect);
-        m_imageNode->setRect(QRectF(QPointF(0,0), iconSize()));
+        // icons showing the same image share its texture, and get batched
+        QSGTexture *texture = node->m_textureCache->acquire(m_image);
+        if (texture) {
+            m_imageNode->setTexture(texture);
+            m_imageNode->setSourceRect(m_image.rect());
+            m_imageNode->setRect(QRectF(QPointF(0,0), iconSize()));
+            node->m_textureCache->release(node->m_texture);
+            node->m_texture = texture;
+        } else {
+            m_imageNode->setRect(QRectF()); // the previous texture stays set, unseen
+        }
     }
 
     if (m_geometryDirty) {
@@ -129,7 +148,8 @@ QSGNode *QMapIconObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
         }
     }
 
-    root->appendChildNode(node);
+    if (!node->parent()) // nodes already attached keep their stacking order
+        root->appendChildNode(node);
 
     return node;
 }
@@ -138,6 +158,8 @@ void QMapIconObjectPrivateQSG::setCoordinate(const QGeoCoordinate &coordinate)
 {
     QMapIconObjectPrivateDefault::setCoordinate(coordinate);
     updateGeometry();
+    if (m_map)
+        emit m_map->sgNodeChanged();
 }
 
 template<typename T>
@@ -176,11 +198,11 @@ void QMapIconObjectPrivateQSG::setContent(const QVariant &content)
             // Supporting only image providers for now
             const QUrl url = content.toUrl();
             if (!url.isValid()) {
-                m_image = QImage(content.toString());
+                m_image = QGeoMapIconTextureCache::loadImage(content.toString());
                 m_imageDirty = true;
                 updateGeometry();
             } else if (url.scheme().isEmpty() || url.scheme() == QLatin1String("file")) {
-                m_image = QImage(url.toString(QUrl::RemoveScheme));
+                m_image = QGeoMapIconTextureCache::loadImage(url.toString(QUrl::RemoveScheme));
                 m_imageDirty = true;
                 updateGeometry();
             } else if (url.scheme() == QLatin1String("image")) {
@@ -206,14 +228,19 @@ void QMapIconObjectPrivateQSG::setContent(const QVariant &content)
             break;
     }
 
-    if (m_map && m_imageDirty)
-        emit m_map->sgNodeChanged();
+    if (m_imageDirty) {
+        markNodeDirty();
+        if (m_map)
+            emit m_map->sgNodeChanged();
+    }
 }
 
 void QMapIconObjectPrivateQSG::setIconSize(const QSizeF &size)
 {
     QMapIconObjectPrivateDefault::setIconSize(size);
     updateGeometry();
+    if (m_map)
+        emit m_map->sgNodeChanged();
 }
 
 QGeoMapObjectPrivate *QMapIconObjectPrivateQSG::clone()
@@ -81,6 +81,7 @@ void QMapPolygonObjectPrivateQSG::setFillColor(const QColor &color)
 {
     QMapPolygonObjectPrivateDefault::setFillColor(color);
 
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
@@ -89,6 +90,7 @@ void QMapPolygonObjectPrivateQSG::setBorderColor(const QColor &color)
 {
     QMapPolygonObjectPrivateDefault::setBorderColor(color);
 
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
@@ -97,6 +99,7 @@ void QMapPolygonObjectPrivateQSG::setBorderWidth(qreal width)
 {
     QMapPolygonObjectPrivateDefault::setBorderWidth(width);
 
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
@@ -123,10 +126,11 @@ void QMapPolygonObjectPrivateQSG::setGeoShape(const QGeoShape &shape)
 // so handle both cases (sourceDirty, !sourceDirty)
 void QMapPolygonObjectPrivateQSG::updateGeometry()
 {
+    markNodeDirty();
     if (!m_map || m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
 
-    if (m_path.path().length() == 0) { // Possibly cleared
+    if (m_path.size() == 0) { // Possibly cleared
         m_geometry.clear();
         m_borderGeometry.clear();
         return;
@@ -197,7 +201,8 @@ QSGNode *QMapPolygonObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
 
     if (!m_polylinenode->isSubtreeBlocked() || !m_node->isSubtreeBlocked()) {
         m_rootNode->setSubtreeBlocked(false);
-        root->appendChildNode(m_rootNode);
+        if (!m_rootNode->parent()) // nodes already attached keep their stacking order
+            root->appendChildNode(m_rootNode);
         return m_rootNode;
     } else {
         m_rootNode->setSubtreeBlocked(true);
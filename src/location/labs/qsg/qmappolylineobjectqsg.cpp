@@ -37,6 +37,7 @@
 #include "qmappolylineobjectqsg_p_p.h"
 #include <QtQuick/qsgnode.h>
 #include <QtQuick/qsgsimplerectnode.h>
+#include <QtPositioning/private/qgeopath_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,6 +56,7 @@ QMapPolylineObjectPrivateQSG::QMapPolylineObjectPrivateQSG(const QMapPolylineObj
 {
     // rest of the data already cloned by the *Default copy constructor, but necessary
     // update operations triggered only by setters overrides
+    m_borderGeometry.setVertexStyles(m_segmentStyles);
     markSourceDirty();
     updateGeometry();
     if (m_map)
@@ -69,24 +71,19 @@ QMapPolylineObjectPrivateQSG::~QMapPolylineObjectPrivateQSG()
 
 QList<QDoubleVector2D> QMapPolylineObjectPrivateQSG::projectPath()
 {
-    QList<QDoubleVector2D> geopathProjected_;
     if (!m_map || m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-        return geopathProjected_;
-
-    const QGeoProjectionWebMercator &p =
-            static_cast<const QGeoProjectionWebMercator&>(m_map->geoProjection());
-    geopathProjected_.reserve(m_path.path().size());
-    for (const QGeoCoordinate &c : m_path.path())
-        geopathProjected_ << p.geoToMapProjection(c);
-    return geopathProjected_;
+        return QList<QDoubleVector2D>();
+
+    return QGeoPathPrivate::mercatorVertices(m_path);
 }
 
 void QMapPolylineObjectPrivateQSG::updateGeometry()
 {
+    markNodeDirty();
     if (!m_map || m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
 
-    if (m_path.path().length() == 0) { // Possibly cleared
+    if (m_path.size() == 0) { // Possibly cleared
         m_borderGeometry.clear();
         return;
     }
@@ -147,7 +144,8 @@ QSGNode *QMapPolylineObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
 
     if (!m_polylinenode->isSubtreeBlocked() ) {
         m_polylinenode->setSubtreeBlocked(false);
-        root->appendChildNode(m_polylinenode);
+        if (!m_polylinenode->parent()) // nodes already attached keep their stacking order
+            root->appendChildNode(m_polylinenode);
         return m_polylinenode;
     } else {
         delete m_polylinenode;
@@ -164,7 +162,8 @@ QList<QGeoCoordinate> QMapPolylineObjectPrivateQSG::path() const
 
 void QMapPolylineObjectPrivateQSG::setPath(const QList<QGeoCoordinate> &path)
 {
-    m_path.setPath(path);
+    // keeps the projection of the vertices the old path starts with
+    QGeoPathPrivate::setPathSharingPrefix(m_path, path);
     markSourceDirty();
     updateGeometry();
     if (m_map)
@@ -175,6 +174,7 @@ void QMapPolylineObjectPrivateQSG::setColor(const QColor &color)
 {
     QMapPolylineObjectPrivateDefault::setColor(color);
 
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
@@ -183,6 +183,19 @@ void QMapPolylineObjectPrivateQSG::setWidth(qreal width)
 {
     QMapPolylineObjectPrivateDefault::setWidth(width);
 
+    markNodeDirty();
+    if (m_map)
+        emit m_map->sgNodeChanged();
+}
+
+void QMapPolylineObjectPrivateQSG::setSegmentStyles(const QVector<MapPolylineVertexStyle> &styles,
+                                                    int first, int count)
+{
+    QMapPolylineObjectPrivateDefault::setSegmentStyles(styles, first, count);
+    m_borderGeometry.setVertexStyles(styles, first, count);
+
+    m_borderGeometry.markScreenDirty(); // refilled by updateMapObjectNode()
+    markNodeDirty();
     if (m_map)
         emit m_map->sgNodeChanged();
 }
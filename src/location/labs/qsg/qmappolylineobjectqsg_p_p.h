@@ -80,6 +80,7 @@ public:
     void setPath(const QList<QGeoCoordinate> &path) override;
     void setColor(const QColor &color) override;
     void setWidth(qreal width) override;
+    void setSegmentStyles(const QVector<MapPolylineVertexStyle> &styles, int first, int count) override;
 
     // QGeoMapObjectPrivate
     QGeoMapObjectPrivate *clone() override;
@@ -63,6 +63,7 @@ QMapRouteObjectPrivateQSG::~QMapRouteObjectPrivateQSG()
 
 void QMapRouteObjectPrivateQSG::updateGeometry()
 {
+    markNodeDirty();
     m_polyline->updateGeometry();
 }
 
@@ -80,6 +81,14 @@ void QMapRouteObjectPrivateQSG::setRoute(const QDeclarativeGeoRoute *route)
     m_polyline->setColor(QColor("deepskyblue")); // ToDo: support MapParameters for this
     m_polyline->setWidth(4);
     m_polyline->setPath(path); // SGNodeChanged emitted by m_polyline
+    m_polyline->setSegmentStyles(segmentStyles(), 0, -1);
+    markNodeDirty();
+}
+
+void QMapRouteObjectPrivateQSG::setSegmentStyles(int first, int count)
+{
+    m_polyline->setSegmentStyles(segmentStyles(), first, count); // SGNodeChanged emitted by m_polyline
+    markNodeDirty();
 }
 
 QGeoMapObjectPrivate *QMapRouteObjectPrivateQSG::clone()
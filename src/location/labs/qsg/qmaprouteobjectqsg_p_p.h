@@ -75,6 +75,7 @@ public:
 
     // QMapRouteObjectPrivate interface
     void setRoute(const QDeclarativeGeoRoute *route) override;
+    void setSegmentStyles(int first, int count) override;
 
     // QGeoMapObjectPrivate interface
     QGeoMapObjectPrivate *clone() override;
@@ -35,6 +35,7 @@
 ****************************************************************************/
 
 #include "qqsgmapobject_p.h"
+#include "qgeomapobjectqsgsupport_p.h"
 #include <QDebug>
 
 QT_BEGIN_NAMESPACE
@@ -63,6 +64,15 @@ void QQSGMapObject::updateGeometry()
 
 }
 
+void QQSGMapObject::markNodeDirty()
+{
+    if (m_nodeDirty)
+        return;
+    m_nodeDirty = true;
+    if (m_support)
+        m_support->m_dirtyMapObjects.append(this);
+}
+
 QT_END_NAMESPACE
 
 
@@ -56,17 +56,26 @@
 QT_BEGIN_NAMESPACE
 
 class QQuickWindow;
+class QGeoMapObjectQSGSupport;
 class Q_LOCATION_PRIVATE_EXPORT QQSGMapObject
 {
 public:
     QQSGMapObject();
     virtual ~QQSGMapObject();
 
+    // Appends the node to root, unless it is already attached. Returning
+    // nullptr, oldNode must be deleted.
     virtual QSGNode *updateMapObjectNode(QSGNode *oldNode,
                                          VisibleNode **visibleNode,
                                          QSGNode *root,
                                          QQuickWindow *window);
     virtual void updateGeometry();
+
+    // Queues the node for the next QGeoMapObjectQSGSupport::updateMapObjects()
+    void markNodeDirty();
+
+    QGeoMapObjectQSGSupport *m_support = nullptr;
+    bool m_nodeDirty = true; // new objects are updated anyway
 };
 
 QT_END_NAMESPACE
@@ -4,11 +4,13 @@ INCLUDEPATH += maps
 QT += gui quick
 
 PUBLIC_HEADERS += \
+                    maps/qgeocodebatchreply.h \
                     maps/qgeocodereply.h \
                     maps/qgeocodingmanagerengine.h \
                     maps/qgeocodingmanager.h \
                     maps/qgeomaneuver.h \
                     maps/qgeoroute.h \
+                    maps/qgeoroutematrixreply.h \
                     maps/qgeoroutereply.h \
                     maps/qgeorouterequest.h \
                     maps/qgeoroutesegment.h \
@@ -21,13 +23,17 @@ PRIVATE_HEADERS += \
                     maps/qgeomapparameter_p.h \
                     maps/qgeocameracapabilities_p.h \
                     maps/qgeocameradata_p.h \
+                    maps/qgeoasyncparse_p.h \
                     maps/qgeocameratiles_p.h \
+                    maps/qgeocodebatchreply_p.h \
                     maps/qgeocodereply_p.h \
                     maps/qgeocodingmanagerengine_p.h \
                     maps/qgeocodingmanager_p.h \
                     maps/qgeomaneuver_p.h \
                     maps/qgeotiledmapscene_p.h \
                     maps/qgeotilerequestmanager_p.h \
+                    maps/qgeomapstatistics_p.h \
+                    maps/qgeomemorypressuremonitor_p.h \
                     maps/qgeomap_p.h \
                     maps/qgeomap_p_p.h \
                     maps/qgeotiledmap_p.h \
@@ -40,9 +46,12 @@ PRIVATE_HEADERS += \
                     maps/qgeomappingmanagerengine_p_p.h \
                     maps/qgeotiledmappingmanagerengine_p.h \
                     maps/qgeotiledmappingmanagerengine_p_p.h \
+                    maps/qgeotiledownloadjob_p.h \
                     maps/qgeomaptype_p.h \
                     maps/qgeomaptype_p_p.h \
                     maps/qgeoroute_p.h \
+                    maps/qgeorouteencoding_p.h \
+                    maps/qgeoroutematrixreply_p.h \
                     maps/qgeoroutereply_p.h \
                     maps/qgeorouterequest_p.h \
                     maps/qgeoroutesegment_p.h \
@@ -51,14 +60,16 @@ PRIVATE_HEADERS += \
                     maps/qgeoserviceprovider_p.h \
                     maps/qabstractgeotilecache_p.h \
                     maps/qgeofiletilecache_p.h \
+                    maps/qgeopackedtilecache_p.h \
                     maps/qgeotiledmapreply_p.h \
                     maps/qgeotiledmapreply_p_p.h \
                     maps/qgeotilespec_p.h \
-                    maps/qgeotilespec_p_p.h \
+                    maps/qgeorequestscheduler_p.h \
                     maps/qgeorouteparser_p.h \
                     maps/qgeorouteparser_p_p.h \
                     maps/qgeorouteparserosrmv5_p.h \
                     maps/qgeorouteparserosrmv4_p.h \
+                    maps/qgeoroutetracker_p.h \
                     maps/qgeoprojection_p.h \
                     maps/qnavigationmanagerengine_p.h \
                     maps/qnavigationmanager_p.h \
@@ -70,18 +81,24 @@ SOURCES += \
             maps/qgeocameracapabilities.cpp \
             maps/qgeocameradata.cpp \
             maps/qgeocameratiles.cpp \
+            maps/qgeocodebatchreply.cpp \
             maps/qgeocodereply.cpp \
             maps/qgeocodingmanager.cpp \
             maps/qgeocodingmanagerengine.cpp \
             maps/qgeomaneuver.cpp \
             maps/qgeotilerequestmanager.cpp \
+            maps/qgeomapstatistics.cpp \
+            maps/qgeomemorypressuremonitor.cpp \
             maps/qgeomap.cpp \
             maps/qgeomappingmanager.cpp \
             maps/qgeomappingmanagerengine.cpp \
             maps/qgeotiledmappingmanagerengine.cpp \
+            maps/qgeotiledownloadjob.cpp \
             maps/qgeotilefetcher.cpp \
             maps/qgeomaptype.cpp \
             maps/qgeoroute.cpp \
+            maps/qgeorouteencoding.cpp \
+            maps/qgeoroutematrixreply.cpp \
             maps/qgeoroutereply.cpp \
             maps/qgeorouterequest.cpp \
             maps/qgeoroutesegment.cpp \
@@ -91,13 +108,16 @@ SOURCES += \
             maps/qgeoserviceproviderfactory.cpp \
             maps/qabstractgeotilecache.cpp \
             maps/qgeofiletilecache.cpp \
+            maps/qgeopackedtilecache.cpp \
             maps/qgeotiledmapreply.cpp \
             maps/qgeotilespec.cpp \
             maps/qgeotiledmap.cpp \
             maps/qgeotiledmapscene.cpp \
+            maps/qgeorequestscheduler.cpp \
             maps/qgeorouteparser.cpp \
             maps/qgeorouteparserosrmv5.cpp \
             maps/qgeorouteparserosrmv4.cpp \
+            maps/qgeoroutetracker.cpp \
             maps/qgeomapparameter.cpp \
             maps/qnavigationmanagerengine.cpp \
             maps/qnavigationmanager.cpp \
@@ -44,6 +44,7 @@
 #include <QMetaType>
 #include <QPixmap>
 #include <QDebug>
+#include <limits>
 
 Q_DECLARE_METATYPE(QList<QGeoTileSpec>)
 Q_DECLARE_METATYPE(QSet<QGeoTileSpec>)
@@ -51,14 +52,26 @@ Q_DECLARE_METATYPE(QSet<QGeoTileSpec>)
 QT_BEGIN_NAMESPACE
 
 QGeoTileTexture::QGeoTileTexture()
-    : textureBound(false) {}
+    : textureBound(false), pending(false) {}
 
 QGeoTileTexture::~QGeoTileTexture()
 {
 }
 
+bool QGeoTileTexture::isNull() const
+{
+    return image.isNull() && !compressed.isValid();
+}
+
+qsizetype QGeoTileTexture::byteSize() const
+{
+    if (compressed.isValid())
+        return compressed.dataLength();
+    return qsizetype(image.width()) * image.height() * image.depth() / 8;
+}
+
 QAbstractGeoTileCache::QAbstractGeoTileCache(QObject *parent)
-    : QObject(parent)
+    : QObject(parent), memoryPressure_(NoMemoryPressure)
 {
     qRegisterMetaType<QGeoTileSpec>();
     qRegisterMetaType<QList<QGeoTileSpec> >();
@@ -78,6 +91,95 @@ void QAbstractGeoTileCache::handleError(const QGeoTileSpec &, const QString &err
     qWarning() << "tile request error " << error;
 }
 
+void QAbstractGeoTileCache::cancelDecoding(const QSet<QGeoTileSpec> &tiles)
+{
+    Q_UNUSED(tiles);
+}
+
+/*
+    Stores the HTTP \a validators of the cached tile \a spec, after it was
+    fetched or revalidated. Caches supporting revalidation emit tileExpired()
+    when an expired tile is read, for the fetcher to send a conditional
+    request. The default implementation does nothing.
+*/
+void QAbstractGeoTileCache::setTileValidators(const QGeoTileSpec &spec, const QGeoTileValidators &validators)
+{
+    Q_UNUSED(spec);
+    Q_UNUSED(validators);
+}
+
+/*
+    Called when the server could not be asked whether the expired tile \a spec
+    changed. The default implementation does nothing.
+*/
+void QAbstractGeoTileCache::revalidationFailed(const QGeoTileSpec &spec)
+{
+    Q_UNUSED(spec);
+}
+
+/*
+    Returns the hit, miss and eviction counters of the cache tier \a area
+    since the cache was created. The default implementation returns zero
+    counters, for caches not tracking them.
+*/
+QCache3QStatistics QAbstractGeoTileCache::statistics(CacheArea area) const
+{
+    Q_UNUSED(area);
+    return QCache3QStatistics();
+}
+
+/*
+    Returns whether the cache tier \a area holds the tile \a spec, without
+    reading it. The default implementation returns false.
+*/
+bool QAbstractGeoTileCache::contains(const QGeoTileSpec &spec, CacheArea area) const
+{
+    Q_UNUSED(spec);
+    Q_UNUSED(area);
+    return false;
+}
+
+/*
+    Tells the cache how short the system is on memory. Caches release
+    decoded tiles and memory tiers accordingly, and maps stop prefetching
+    tiles while there is any \a pressure. The default implementation only
+    stores the level.
+*/
+void QAbstractGeoTileCache::setMemoryPressure(MemoryPressure pressure)
+{
+    memoryPressure_ = pressure;
+}
+
+QAbstractGeoTileCache::MemoryPressure QAbstractGeoTileCache::memoryPressure() const
+{
+    return memoryPressure_;
+}
+
+/*
+    Replaces the share \a previous of the minimum texture usage a map keeps
+    for its tiles with \a usage. The shares of all the maps are summed in 64
+    bits, and setMinTextureUsage() is given the sum capped to the range of
+    the costs, so that many large maps neither overflow it nor lose their
+    shares.
+*/
+void QAbstractGeoTileCache::reserveMinTextureUsage(qint64 previous, qint64 usage)
+{
+    reservedTextureUsage_ = qMax<qint64>(0, reservedTextureUsage_ - previous + usage);
+    setMinTextureUsage(int(qMin<qint64>(reservedTextureUsage_, std::numeric_limits<int>::max())));
+}
+
+/*
+    Returns the texture of \a spec if it is already decoded, without reading
+    the disk nor decoding anything, or a null pointer otherwise. Used to find
+    stand-ins for missing tiles. The default implementation returns a null
+    pointer.
+*/
+QSharedPointer<QGeoTileTexture> QAbstractGeoTileCache::getDecoded(const QGeoTileSpec &spec)
+{
+    Q_UNUSED(spec);
+    return QSharedPointer<QGeoTileTexture>();
+}
+
 void QAbstractGeoTileCache::setMaxDiskUsage(int diskUsage)
 {
     Q_UNUSED(diskUsage);
@@ -57,8 +57,11 @@
 #include <QTimer>
 
 #include "qgeotilespec_p.h"
+#include "qgeotiledmapreply_p.h"
+#include "qgeomapstatistics_p.h"
 
 #include <QImage>
+#include <QtGui/private/qtexturefiledata_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -78,9 +81,15 @@ public:
     QGeoTileTexture();
     ~QGeoTileTexture();
 
+    bool isNull() const;
+    qsizetype byteSize() const;
+
     QGeoTileSpec spec;
     QImage image;
+    QTextureFileData compressed; // instead of image, for tiles in a GPU compressed format
     bool textureBound;
+    bool pending; // image is still being decoded, see QAbstractGeoTileCache::tileDecoded()
+    QGeoMapMemoryTracker memory { QGeoMapStatistics::TileTextureCache }; // of the decoded tile
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QAbstractGeoTileCache : public QObject
@@ -95,10 +104,18 @@ public:
     enum CacheArea {
         DiskCache = 0x01,
         MemoryCache = 0x02,
+        TextureCache = 0x04, // decoded tiles, only used by statistics()
         AllCaches = 0xFF
     };
     Q_DECLARE_FLAGS(CacheAreas, CacheArea)
 
+    enum MemoryPressure {
+        NoMemoryPressure,
+        ModerateMemoryPressure, // the decoded tiles not in view are released
+        CriticalMemoryPressure  // the memory cache is released too
+    };
+    Q_ENUM(MemoryPressure)
+
     virtual ~QAbstractGeoTileCache();
 
     virtual void setMaxDiskUsage(int diskUsage);
@@ -114,6 +131,7 @@ public:
     virtual int maxTextureUsage() const = 0;
     virtual int minTextureUsage() const = 0;
     virtual int textureUsage() const = 0;
+    void reserveMinTextureUsage(qint64 previous, qint64 usage);
     virtual void clearAll() = 0;
     virtual void setCostStrategyDisk(CostStrategy costStrategy) = 0;
     virtual CostStrategy costStrategyDisk() const = 0;
@@ -123,21 +141,36 @@ public:
     virtual CostStrategy costStrategyTexture() const = 0;
 
     virtual QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) = 0;
+    virtual QSharedPointer<QGeoTileTexture> getDecoded(const QGeoTileSpec &spec);
 
     virtual void insert(const QGeoTileSpec &spec,
                 const QByteArray &bytes,
                 const QString &format,
                 QAbstractGeoTileCache::CacheAreas areas = QAbstractGeoTileCache::AllCaches) = 0;
     virtual void handleError(const QGeoTileSpec &spec, const QString &errorString);
+    virtual void cancelDecoding(const QSet<QGeoTileSpec> &tiles);
+    virtual void setTileValidators(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+    virtual void revalidationFailed(const QGeoTileSpec &spec);
+    virtual QCache3QStatistics statistics(CacheArea area) const;
+    virtual bool contains(const QGeoTileSpec &spec, CacheArea area) const;
+    virtual void setMemoryPressure(MemoryPressure pressure);
+    MemoryPressure memoryPressure() const;
     virtual void init() = 0;
 
     static QString baseCacheDirectory();
     static QString baseLocationCacheDirectory();
 
+Q_SIGNALS:
+    void tileDecoded(const QGeoTileSpec &spec, bool success);
+    void tileExpired(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+
 protected:
     QAbstractGeoTileCache(QObject *parent = 0);
     virtual void printStats() = 0;
 
+    MemoryPressure memoryPressure_;
+    qint64 reservedTextureUsage_ = 0; // the sum of the shares of the maps, see reserveMinTextureUsage()
+
     friend class QGeoTiledMappingManagerEngine;
 };
 
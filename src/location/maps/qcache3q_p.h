@@ -51,10 +51,100 @@
 #include <QtCore/qhash.h>
 #include <QtCore/qcache.h>
 #include <QtCore/qsharedpointer.h>
+#include <QtCore/qvector.h>
 #include <QDebug>
 
 QT_BEGIN_NAMESPACE
 
+/*
+ * Counters of a QCache3Q, per queue: 0 = newbies, 1 = regulars, 2 = hobos.
+ * A request for a key on the ghost list counts as a miss and as a ghost hit.
+ */
+struct QCache3QStatistics
+{
+    quint64 hits[3] = {};
+    quint64 evictions[3] = {};
+    int size[3] = {};
+    int cost[3] = {};
+    quint64 misses = 0;
+    quint64 ghostHits = 0;
+    quint64 rejected = 0;       // inserts refused by the admission filter
+
+    quint64 hitCount() const { return hits[0] + hits[1] + hits[2]; }
+    quint64 evictionCount() const { return evictions[0] + evictions[1] + evictions[2]; }
+};
+
+/*
+ * QCache3QFrequencySketch
+ *
+ * Approximate access counts of recently requested keys, in a count-min
+ * sketch of four rows of 4-bit counters. All counters are halved once
+ * ten times as many accesses as there are counters per row were recorded,
+ * so that keys popular a long time ago fade out.
+ */
+class QCache3QFrequencySketch
+{
+public:
+    inline void ensureCapacity(int entries)
+    {
+        if (entries <= width_)
+            return;
+        width_ = 64;
+        while (width_ < entries)
+            width_ *= 2;
+        counters_.fill(0, width_ * 4);
+        additions_ = 0;
+    }
+
+    inline void clear()
+    {
+        counters_.fill(0);
+        additions_ = 0;
+    }
+
+    inline void increment(uint hash)
+    {
+        if (counters_.isEmpty())
+            ensureCapacity(64);
+        bool added = false;
+        for (int row = 0; row < 4; ++row) {
+            quint8 &counter = counters_[index(hash, row)];
+            if (counter < 15) {
+                ++counter;
+                added = true;
+            }
+        }
+        if (added && ++additions_ >= 10 * width_) {
+            for (quint8 &counter : counters_)
+                counter >>= 1;
+            additions_ /= 2;
+        }
+    }
+
+    inline int frequency(uint hash) const
+    {
+        if (counters_.isEmpty())
+            return 0;
+        int result = 15;
+        for (int row = 0; row < 4; ++row)
+            result = qMin(result, int(counters_.at(index(hash, row))));
+        return result;
+    }
+
+private:
+    inline int index(uint hash, int row) const
+    {
+        static const uint seeds[4] = { 0x9e3779b1u, 0x85ebca77u, 0xc2b2ae3du, 0x27d4eb2fu };
+        uint h = hash * seeds[row];
+        h ^= h >> 16;
+        return row * width_ + int(h & uint(width_ - 1));
+    }
+
+    QVector<quint8> counters_;
+    int width_ = 0;
+    int additions_ = 0;
+};
+
 template <class Key, class T>
 class QCache3QDefaultEvictionPolicy
 {
@@ -106,6 +196,14 @@ void QCache3QDefaultEvictionPolicy<Key,T>::aboutToBeRemoved(const Key &key, QSha
  *                    from it takes place
  *  * promoteAt = minimum popularity necessary to promote a node from
  *                "newbie" to "regular"
+ *  * admissionFilter = when the cache is full, only insert a new key if it
+ *                      was requested more often than the node it would evict,
+ *                      according to a QCache3QFrequencySketch of all requests.
+ *                      Keeps a single sweep over many keys from flushing the
+ *                      popular ones. Off by default.
+ *
+ * Removed nodes are kept on a free list and reused by later inserts, until
+ * clear() releases them.
  */
 template <class Key, class T, class EvPolicy = QCache3QDefaultEvictionPolicy<Key,T> >
 class QCache3Q : public EvPolicy
@@ -143,6 +241,7 @@ private:
     Queue *q3_;          // "hobos": evicted from q2 but were very popular (above mean)
     Queue *q1_evicted_;  // ghosts of recently evicted newbies and regulars
     QHash<Key, Node *> lookup_;
+    Node *free_;         // unused nodes, chained through n
 
 public:
     explicit QCache3Q(int maxCost = 0, int minRecent = -1, int maxOldPopular = -1);
@@ -156,16 +255,24 @@ public:
 
     inline int totalCost() const { return q1_->cost + q2_->cost + q3_->cost; }
 
+    inline bool admissionFilter() const { return admissionFilter_; }
+    void setAdmissionFilter(bool enabled);
+
+    QCache3QStatistics statistics() const;
+    void resetStatistics();
+
     void clear();
-    bool insert(const Key &key, QSharedPointer<T> object, int cost = 1);
+    bool insert(const Key &key, QSharedPointer<T> object, int cost = 1, bool force = false);
     QSharedPointer<T> object(const Key &key) const;
     QSharedPointer<T> operator[](const Key &key) const;
+    bool contains(const Key &key) const;
 
     void remove(const Key &key, bool force = false);
     QList<Key> keys() const;
     void printStats();
 
-    // Copy data directly into a queue. Designed for single use after construction
+    // Copy data directly into a queue, skipping keys already in the cache.
+    // Does not rebalance, call setMaxCost() afterwards to enforce the cost limit
     void deserializeQueue(int queueNumber, const QList<Key> &keys,
                           const QList<QSharedPointer<T> > &values, const QList<int> &costs);
     // Copy data from specific queue into list
@@ -173,11 +280,17 @@ public:
 
 private:
     int maxCost_, minRecent_, maxOldPopular_;
-    int hitCount_, missCount_, promote_;
+    int promote_;
+    bool admissionFilter_;
+    QCache3QStatistics stats_;
+    QCache3QFrequencySketch sketch_;
 
     void rebalance();
+    Node *victim() const;
     void unlink(Node *n);
     void link_front(Node *n, Queue *q);
+    Node *allocNode();
+    void freeNode(Node *n);
 
 private:
     // make these private so they can't be used
@@ -189,10 +302,12 @@ template <class Key, class T, class EvPolicy>
 void QCache3Q<Key,T,EvPolicy>::printStats()
 {
     qDebug("\n=== cache %p ===", this);
-    qDebug("hits: %d (%.2f%%)\tmisses: %d\tfill: %.2f%%", hitCount_,
-           100.0 * float(hitCount_) / (float(hitCount_ + missCount_)),
-           missCount_,
+    qDebug("hits: %llu (%.2f%%)\tmisses: %llu\tfill: %.2f%%", stats_.hitCount(),
+           100.0 * float(stats_.hitCount()) / (float(stats_.hitCount() + stats_.misses)),
+           stats_.misses,
            100.0 * float(totalCost()) / float(maxCost()));
+    qDebug("ghost hits: %llu\tevictions: %llu\trejected: %llu", stats_.ghostHits,
+           stats_.evictionCount(), stats_.rejected);
     qDebug("q1g: size=%d, pop=%llu", q1_evicted_->size, q1_evicted_->pop);
     qDebug("q1:  cost=%d, size=%d, pop=%llu", q1_->cost, q1_->size, q1_->pop);
     qDebug("q2:  cost=%d, size=%d, pop=%llu", q2_->cost, q2_->size, q2_->pop);
@@ -202,8 +317,8 @@ void QCache3Q<Key,T,EvPolicy>::printStats()
 template <class Key, class T, class EvPolicy>
 QCache3Q<Key,T,EvPolicy>::QCache3Q(int maxCost, int minRecent, int maxOldPopular)
     : q1_(new Queue), q2_(new Queue), q3_(new Queue), q1_evicted_(new Queue),
-      maxCost_(maxCost), minRecent_(minRecent), maxOldPopular_(maxOldPopular),
-      hitCount_(0), missCount_(0), promote_(0)
+      free_(0), maxCost_(maxCost), minRecent_(minRecent), maxOldPopular_(maxOldPopular),
+      promote_(0), admissionFilter_(false)
 {
     if (minRecent_ < 0)
         minRecent_ = maxCost_ / 3;
@@ -231,13 +346,14 @@ void QCache3Q<Key,T,EvPolicy>::deserializeQueue(int queueNumber, const QList<Key
     int bufferSize = keys.size();
     if (bufferSize == 0)
         return;
-    clear();
     Queue *queue = queueNumber == 1 ? q1_ :
                    queueNumber == 2 ? q2_ :
                    queueNumber == 3 ? q3_ :
                                       q1_evicted_;
     for (int i = 0; i<bufferSize; ++i) {
-        Node *node = new Node;
+        if (lookup_.contains(keys[i]))
+            continue;
+        Node *node = allocNode();
         node->v = values[i];
         node->k = keys[i];
         node->cost = costs[i];
@@ -261,7 +377,33 @@ inline void QCache3Q<Key,T,EvPolicy>::setMaxCost(int maxCost, int minRecent, int
 }
 
 template <class Key, class T, class EvPolicy>
-bool QCache3Q<Key,T,EvPolicy>::insert(const Key &key, QSharedPointer<T> object, int cost)
+void QCache3Q<Key,T,EvPolicy>::setAdmissionFilter(bool enabled)
+{
+    admissionFilter_ = enabled;
+    if (!enabled)
+        sketch_ = QCache3QFrequencySketch();
+}
+
+template <class Key, class T, class EvPolicy>
+QCache3QStatistics QCache3Q<Key,T,EvPolicy>::statistics() const
+{
+    QCache3QStatistics stats = stats_;
+    const Queue *queues[3] = { q1_, q2_, q3_ };
+    for (int i = 0; i < 3; ++i) {
+        stats.size[i] = queues[i]->size;
+        stats.cost[i] = queues[i]->cost;
+    }
+    return stats;
+}
+
+template <class Key, class T, class EvPolicy>
+void QCache3Q<Key,T,EvPolicy>::resetStatistics()
+{
+    stats_ = QCache3QStatistics();
+}
+
+template <class Key, class T, class EvPolicy>
+bool QCache3Q<Key,T,EvPolicy>::insert(const Key &key, QSharedPointer<T> object, int cost, bool force)
 {
     if (cost > maxCost_) {
         return false;
@@ -290,7 +432,15 @@ bool QCache3Q<Key,T,EvPolicy>::insert(const Key &key, QSharedPointer<T> object,
         return true;
     }
 
-    Node *n = new Node;
+    if (admissionFilter_ && !force && totalCost() + cost > maxCost_) {
+        const Node *v = victim();
+        if (v && sketch_.frequency(qHash(key)) <= sketch_.frequency(qHash(v->k))) {
+            stats_.rejected++;
+            return false;
+        }
+    }
+
+    Node *n = allocNode();
     n->v = object;
     n->k = key;
     n->cost = cost;
@@ -332,7 +482,48 @@ void QCache3Q<Key,T,EvPolicy>::clear()
         delete n;
     }
 
+    while (free_) {
+        Node *n = free_;
+        free_ = n->n;
+        delete n;
+    }
+
     lookup_.clear();
+    sketch_.clear();
+}
+
+template <class Key, class T, class EvPolicy>
+typename QCache3Q<Key,T,EvPolicy>::Node *QCache3Q<Key,T,EvPolicy>::allocNode()
+{
+    if (!free_)
+        return new Node;
+    Node *n = free_;
+    free_ = n->n;
+    n->n = 0;
+    return n;
+}
+
+template <class Key, class T, class EvPolicy>
+void QCache3Q<Key,T,EvPolicy>::freeNode(Node *n)
+{
+    n->k = Key();
+    n->v.clear();
+    n->pop = 0;
+    n->cost = 0;
+    n->p = 0;
+    n->n = free_;
+    free_ = n;
+}
+
+// The node rebalance() would evict first, for the admission filter
+template <class Key, class T, class EvPolicy>
+typename QCache3Q<Key,T,EvPolicy>::Node *QCache3Q<Key,T,EvPolicy>::victim() const
+{
+    if (q3_->cost > maxOldPopular_)
+        return q3_->l;
+    if (q1_->cost > minRecent_ || !q2_->l)
+        return q1_->l;
+    return q2_->l;
 }
 
 template <class Key, class T, class EvPolicy>
@@ -378,19 +569,21 @@ void QCache3Q<Key,T,EvPolicy>::rebalance()
         Node *n = q1_evicted_->l;
         unlink(n);
         lookup_.remove(n->k);
-        delete n;
+        freeNode(n);
     }
 
     while ((q1_->cost + q2_->cost + q3_->cost) > maxCost_) {
         if (q3_->cost > maxOldPopular_) {
             Node *n = q3_->l;
             unlink(n);
+            stats_.evictions[2]++;
             EvPolicy::aboutToBeEvicted(n->k, n->v);
             lookup_.remove(n->k);
-            delete n;
+            freeNode(n);
         } else if (q1_->cost > minRecent_) {
             Node *n = q1_->l;
             unlink(n);
+            stats_.evictions[0]++;
             EvPolicy::aboutToBeEvicted(n->k, n->v);
             n->v.clear();
             n->cost = 0;
@@ -401,6 +594,7 @@ void QCache3Q<Key,T,EvPolicy>::rebalance()
             if (q2_->size && n->pop > (q2_->pop / q2_->size)) {
                 link_front(n, q3_);
             } else {
+                stats_.evictions[1]++;
                 EvPolicy::aboutToBeEvicted(n->k, n->v);
                 n->v.clear();
                 n->cost = 0;
@@ -421,7 +615,7 @@ void QCache3Q<Key,T,EvPolicy>::remove(const Key &key, bool force)
     if (n->q != q1_evicted_ && !force)
         EvPolicy::aboutToBeRemoved(n->k, n->v);
     lookup_.remove(key);
-    delete n;
+    freeNode(n);
 }
 
 template <class Key, class T, class EvPolicy>
@@ -433,19 +627,23 @@ QList<Key> QCache3Q<Key,T,EvPolicy>::keys() const
 template <class Key, class T, class EvPolicy>
 QSharedPointer<T> QCache3Q<Key,T,EvPolicy>::object(const Key &key) const
 {
+    QCache3Q<Key,T,EvPolicy> *me = const_cast<QCache3Q<Key,T,EvPolicy> *>(this);
+    if (admissionFilter_) {
+        me->sketch_.ensureCapacity(lookup_.size());
+        me->sketch_.increment(qHash(key));
+    }
+
     if (!lookup_.contains(key)) {
-        const_cast<QCache3Q<Key,T,EvPolicy> *>(this)->missCount_++;
+        me->stats_.misses++;
         return QSharedPointer<T>(0);
     }
 
-    QCache3Q<Key,T,EvPolicy> *me = const_cast<QCache3Q<Key,T,EvPolicy> *>(this);
-
     Node *n = me->lookup_[key];
     n->pop++;
     n->q->pop++;
 
     if (n->q == q1_) {
-        me->hitCount_++;
+        me->stats_.hits[0]++;
 
         if (n->pop > (quint64)promote_) {
             me->unlink(n);
@@ -453,14 +651,15 @@ QSharedPointer<T> QCache3Q<Key,T,EvPolicy>::object(const Key &key) const
             me->rebalance();
         }
     } else if (n->q != q1_evicted_) {
-        me->hitCount_++;
+        me->stats_.hits[n->q == q2_ ? 1 : 2]++;
 
         Queue *q = n->q;
         me->unlink(n);
         me->link_front(n, q);
         me->rebalance();
     } else {
-        me->missCount_++;
+        me->stats_.misses++;
+        me->stats_.ghostHits++;
     }
 
     return n->v;
@@ -472,6 +671,14 @@ inline QSharedPointer<T> QCache3Q<Key,T,EvPolicy>::operator[](const Key &key) co
     return object(key);
 }
 
+// Unlike object(), neither counts as a request nor moves the node
+template <class Key, class T, class EvPolicy>
+bool QCache3Q<Key,T,EvPolicy>::contains(const Key &key) const
+{
+    const Node *n = lookup_.value(key, 0);
+    return n && n->q != q1_evicted_;
+}
+
 QT_END_NAMESPACE
 
 #endif // QCACHE3Q_H
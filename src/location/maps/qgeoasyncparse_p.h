@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOASYNCPARSE_P_H
+#define QGEOASYNCPARSE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
+#include <type_traits>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Shared between a reply and the parse of its payload. Cancelled when the
+    reply is aborted or destroyed, which a long parse may poll to stop early.
+*/
+class QGeoParseCancellation
+{
+public:
+    QGeoParseCancellation() : m_cancelled(QSharedPointer<QAtomicInt>::create(0)) {}
+
+    void cancel() const { m_cancelled->storeRelease(1); }
+    bool isCancelled() const { return m_cancelled->loadAcquire() != 0; }
+
+private:
+    QSharedPointer<QAtomicInt> m_cancelled;
+};
+
+/*
+    Emitted from the thread of a parse, parsed() reaches the connections made
+    with a reply as context queued to the thread of the reply, and not at all
+    once the reply is destroyed.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoParseNotifier : public QObject
+{
+    Q_OBJECT
+Q_SIGNALS:
+    void parsed();
+};
+
+/*
+    Calls \a parse with the cancellation of \a reply on the global thread
+    pool, and then \a done with what \a parse returned in the thread of
+    \a reply.
+
+    \a parse runs while the reply lives on, so it must not touch the reply:
+    it gets the payload, and any settings it needs, by value. Once the reply
+    is aborted or destroyed, \a parse is skipped if it did not start yet and
+    \a done is not called. Reply is a QGeoCodeReply, a QGeoRouteReply or a
+    QPlaceReply, anything with an aborted() signal.
+*/
+template <typename Reply, typename Parse, typename Done>
+QGeoParseCancellation qParseReplyAsync(Reply *reply, Parse parse, Done done)
+{
+    typedef typename std::decay<decltype(parse(std::declval<const QGeoParseCancellation &>()))>::type Result;
+
+    const QGeoParseCancellation cancellation;
+    QObject::connect(reply, &Reply::aborted, [cancellation]() { cancellation.cancel(); });
+    QObject::connect(reply, &QObject::destroyed, [cancellation]() { cancellation.cancel(); });
+
+    // Set by the parse before it emits parsed()
+    const QSharedPointer<QScopedPointer<Result>> result(new QScopedPointer<Result>);
+    const QSharedPointer<QGeoParseNotifier> notifier(new QGeoParseNotifier);
+    QObject::connect(notifier.data(), &QGeoParseNotifier::parsed, reply, [cancellation, result, done]() {
+        if (!cancellation.isCancelled())
+            done(*result->data());
+    });
+
+    QThreadPool::globalInstance()->start(QRunnable::create([cancellation, notifier, result, parse]() {
+        if (cancellation.isCancelled())
+            return;
+        result->reset(new Result(parse(cancellation)));
+        if (cancellation.isCancelled())
+            return;
+        emit notifier->parsed();
+    }));
+    return cancellation;
+}
+
+QT_END_NAMESPACE
+
+#endif // QGEOASYNCPARSE_P_H
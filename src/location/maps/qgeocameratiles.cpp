@@ -38,6 +38,7 @@
 #include "qgeocameradata_p.h"
 #include "qgeotilespec_p.h"
 #include "qgeomaptype_p.h"
+#include "qgeomapstatistics_p.h"
 
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
@@ -45,6 +46,7 @@
 #include <QtPositioning/private/qlocationutils_p.h>
 #include <QtGui/QMatrix4x4>
 #include <QVector>
+#include <QHash>
 #include <QMap>
 #include <QPair>
 #include <QSet>
@@ -76,6 +78,12 @@ void QGeoCameraTiles::setCameraData(const QGeoCameraData &camera)
     if (d_ptr->m_camera == camera)
         return;
 
+    // The footprint only moves along when panning at a fixed zoom, bearing and tilt
+    QGeoCameraData moved = camera;
+    moved.setCenter(d_ptr->m_camera.center());
+    if (!(moved == d_ptr->m_camera))
+        d_ptr->m_dirtyFootprint = true;
+
     d_ptr->m_dirtyGeometry = true;
     d_ptr->m_camera = camera;
     d_ptr->m_intZoomLevel = static_cast<int>(std::floor(d_ptr->m_camera.zoomLevel()));
@@ -94,6 +102,7 @@ void QGeoCameraTiles::setVisibleArea(const QRectF &visibleArea)
 
     d_ptr->m_visibleArea = visibleArea;
     d_ptr->m_dirtyGeometry = true;
+    d_ptr->m_dirtyFootprint = true;
 }
 
 void QGeoCameraTiles::setScreenSize(const QSize &size)
@@ -102,6 +111,7 @@ void QGeoCameraTiles::setScreenSize(const QSize &size)
         return;
 
     d_ptr->m_dirtyGeometry = true;
+    d_ptr->m_dirtyFootprint = true;
     d_ptr->m_screenSize = size;
 }
 
@@ -137,17 +147,36 @@ void QGeoCameraTiles::setMapVersion(int mapVersion)
     d_ptr->m_mapVersion = mapVersion;
 }
 
+/*
+    With \a enabled, the tiles that the camera sees from at least twice as far
+    as the center of the map are taken from the zoom levels below, one level
+    less each time the distance doubles, so that a tilted camera fetches and
+    draws a few larger tiles near the horizon instead of many tiny ones. The
+    tiles of different zoom levels never overlap.
+*/
+void QGeoCameraTiles::setDistanceLOD(bool enabled)
+{
+    if (d_ptr->m_distanceLOD == enabled)
+        return;
+
+    d_ptr->m_distanceLOD = enabled;
+    d_ptr->m_dirtyGeometry = true;
+}
+
 void QGeoCameraTiles::setTileSize(int tileSize)
 {
     if (d_ptr->m_tileSize == tileSize)
         return;
 
     d_ptr->m_dirtyGeometry = true;
+    d_ptr->m_dirtyFootprint = true;
     d_ptr->m_tileSize = tileSize;
 }
 
 void QGeoCameraTiles::setViewExpansion(double viewExpansion)
 {
+    if (d_ptr->m_viewExpansion != viewExpansion)
+        d_ptr->m_dirtyFootprint = true;
     d_ptr->m_viewExpansion = viewExpansion;
     d_ptr->m_dirtyGeometry = true;
 }
@@ -159,6 +188,10 @@ int QGeoCameraTiles::tileSize() const
 
 const QSet<QGeoTileSpec>& QGeoCameraTiles::createTiles()
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::CameraTiles);
+    const QSet<QGeoTileSpec> previous = d_ptr->m_tiles; // shared, not copied
+    const bool dirty = d_ptr->m_dirtyGeometry || d_ptr->m_dirtyMetadata;
+
     if (d_ptr->m_dirtyGeometry) {
         d_ptr->m_tiles.clear();
         d_ptr->updateGeometry();
@@ -170,6 +203,31 @@ const QSet<QGeoTileSpec>& QGeoCameraTiles::createTiles()
         d_ptr->m_dirtyMetadata = false;
     }
 
+    if (dirty && d_ptr->m_trackChanges)
+        d_ptr->recordChanges(previous);
+
+    return d_ptr->m_tiles;
+}
+
+/*
+    Same as createTiles(), additionally reporting in \a added and \a removed
+    how the tile set changed since the previous call to this overload.
+    The first call reports all tiles as added.
+*/
+const QSet<QGeoTileSpec>& QGeoCameraTiles::createTiles(QSet<QGeoTileSpec> *added, QSet<QGeoTileSpec> *removed)
+{
+    if (!d_ptr->m_trackChanges) {
+        d_ptr->m_trackChanges = true;
+        d_ptr->m_tilesAdded = createTiles();
+        d_ptr->m_tilesRemoved.clear();
+    } else {
+        createTiles();
+    }
+
+    added->swap(d_ptr->m_tilesAdded);
+    removed->swap(d_ptr->m_tilesRemoved);
+    d_ptr->m_tilesAdded.clear();
+    d_ptr->m_tilesRemoved.clear();
     return d_ptr->m_tiles;
 }
 
@@ -180,7 +238,10 @@ QGeoCameraTilesPrivate::QGeoCameraTilesPrivate()
     m_sideLength(0),
     m_dirtyGeometry(false),
     m_dirtyMetadata(false),
-    m_viewExpansion(1.0)
+    m_dirtyFootprint(true),
+    m_viewExpansion(1.0),
+    m_distanceLOD(false),
+    m_trackChanges(false)
 {
 }
 
@@ -203,17 +264,49 @@ void QGeoCameraTilesPrivate::updateMetadata()
     m_tiles = newTiles;
 }
 
+// Folds the difference between previous and m_tiles into the pending changes
+void QGeoCameraTilesPrivate::recordChanges(const QSet<QGeoTileSpec> &previous)
+{
+    if (previous == m_tiles)
+        return;
+
+    for (const QGeoTileSpec &tile : qAsConst(m_tiles)) {
+        if (!previous.contains(tile) && !m_tilesRemoved.remove(tile))
+            m_tilesAdded.insert(tile);
+    }
+    for (const QGeoTileSpec &tile : previous) {
+        if (!m_tiles.contains(tile) && !m_tilesAdded.remove(tile))
+            m_tilesRemoved.insert(tile);
+    }
+}
+
 void QGeoCameraTilesPrivate::updateGeometry()
 {
-    // Find the frustum from the camera / screen / viewport information
-    // The larger frustum when stationary is a form of prefetching
-    Frustum f = createFrustum(m_viewExpansion);
+    const QDoubleVector3D center = m_sideLength * QWebMercator::coordToMercator(m_camera.center());
+    PolygonVector footprint;
+
+    if (m_dirtyFootprint) {
+        // Find the frustum from the camera / screen / viewport information
+        // The larger frustum when stationary is a form of prefetching
+        Frustum f = createFrustum(m_viewExpansion);
 #ifdef QT_LOCATION_DEBUG
-    m_frustum = f;
+        m_frustum = f;
 #endif
 
-    // Find the polygon where the frustum intersects the plane of the map
-    PolygonVector footprint = frustumFootprint(f);
+        // Find the polygon where the frustum intersects the plane of the map
+        footprint = frustumFootprint(f);
+
+        m_footprint = footprint;
+        for (QDoubleVector3D &p : m_footprint)
+            p -= center;
+        m_eye = f.apex - center;
+        m_dirtyFootprint = false;
+    } else {
+        // Panning only: translate the previous footprint
+        footprint = m_footprint;
+        for (QDoubleVector3D &p : footprint)
+            p += center;
+    }
 #ifdef QT_LOCATION_DEBUG
     m_frustumFootprint = footprint;
 #endif
@@ -239,6 +332,66 @@ void QGeoCameraTilesPrivate::updateGeometry()
         QSet<QGeoTileSpec> tilesRight = tilesFromPolygon(polygons.mid);
         m_tiles.unite(tilesRight);
     }
+
+    if (m_distanceLOD && m_camera.tilt() > 0.0)
+        m_tiles = tilesAtDistanceLOD(m_tiles, m_eye + center);
+}
+
+// Replaces each tile of the current zoom level with the ancestor of the lowest zoom level its
+// distance from the eye allows, as long as all the tiles it covers agree, so that the result
+// covers the same area without overlaps.
+QSet<QGeoTileSpec> QGeoCameraTilesPrivate::tilesAtDistanceLOD(const QSet<QGeoTileSpec> &tiles,
+                                                               const QDoubleVector3D &eye) const
+{
+    static const int maxReduction = 4;
+    const int levels = qMin(maxReduction, m_intZoomLevel);
+    const double eyeDistance = (eye - m_sideLength * QWebMercator::coordToMercator(m_camera.center())).length();
+    if (levels < 1 || eyeDistance <= 0.0)
+        return tiles;
+
+    // The levels each tile could go down by, and for each ancestor the least of its tiles
+    const auto key = [](int reduction, int x, int y) {
+        return (quint64(reduction) << 58) | (quint64(quint32(x)) << 29) | quint64(quint32(y));
+    };
+    QHash<QGeoTileSpec, int> reductions;
+    QHash<quint64, int> ancestorReductions;
+    reductions.reserve(tiles.size());
+    for (const QGeoTileSpec &tile : tiles) {
+        // nearest point of the tile, the eye possibly being on the other side of the dateline
+        double dx = std::numeric_limits<double>::max();
+        for (int wrap = -1; wrap <= 1; ++wrap) {
+            const double x = tile.x() + wrap * m_sideLength;
+            dx = qMin(dx, qMax(qMax(x - eye.x(), eye.x() - (x + 1.0)), 0.0));
+        }
+        const double dy = qMax(qMax(tile.y() - eye.y(), eye.y() - (tile.y() + 1.0)), 0.0);
+        const double scale = std::sqrt(dx * dx + dy * dy + eye.z() * eye.z()) / eyeDistance;
+        int reduction = 0;
+        while (reduction < levels && scale >= double(2 << reduction))
+            ++reduction;
+        reductions.insert(tile, reduction);
+        for (int r = 1; r <= levels; ++r) {
+            const quint64 k = key(r, tile.x() >> r, tile.y() >> r);
+            const auto it = ancestorReductions.find(k);
+            if (it == ancestorReductions.end())
+                ancestorReductions.insert(k, reduction);
+            else
+                *it = qMin(*it, reduction);
+        }
+    }
+
+    QSet<QGeoTileSpec> results;
+    results.reserve(tiles.size());
+    for (auto it = reductions.cbegin(); it != reductions.cend(); ++it) {
+        const QGeoTileSpec &tile = it.key();
+        int reduction = it.value();
+        while (reduction > 0
+               && ancestorReductions.value(key(reduction, tile.x() >> reduction, tile.y() >> reduction)) < reduction) {
+            --reduction;
+        }
+        results.insert(QGeoTileSpec(m_pluginString, m_mapType.mapId(), m_intZoomLevel - reduction,
+                                    tile.x() >> reduction, tile.y() >> reduction, m_mapVersion));
+    }
+    return results;
 }
 
 Frustum QGeoCameraTilesPrivate::createFrustum(double viewExpansion) const
@@ -75,7 +75,9 @@ public:
     void setMapType(const QGeoMapType &mapType);
     QGeoMapType activeMapType() const;
     void setMapVersion(int mapVersion);
+    void setDistanceLOD(bool enabled);
     const QSet<QGeoTileSpec>& createTiles();
+    const QSet<QGeoTileSpec>& createTiles(QSet<QGeoTileSpec> *added, QSet<QGeoTileSpec> *removed);
 
 protected:
     QScopedPointer<QGeoCameraTilesPrivate> d_ptr;
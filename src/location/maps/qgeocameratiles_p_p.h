@@ -105,6 +105,7 @@ public:
 
     void updateMetadata();
     void updateGeometry();
+    void recordChanges(const QSet<QGeoTileSpec> &previous);
 
     Frustum createFrustum(double viewExpansion) const;
     PolygonVector frustumFootprint(const Frustum &frustum) const;
@@ -114,6 +115,7 @@ public:
 
     QList<QPair<double, int> > tileIntersections(double p1, int t1, double p2, int t2) const;
     QSet<QGeoTileSpec> tilesFromPolygon(const PolygonVector &polygon) const;
+    QSet<QGeoTileSpec> tilesAtDistanceLOD(const QSet<QGeoTileSpec> &tiles, const QDoubleVector3D &eye) const;
 
     static QGeoCameraTilesPrivate *get(QGeoCameraTiles *o) {
         return o->d_ptr.data();
@@ -133,8 +135,21 @@ public:
     int m_sideLength;
     bool m_dirtyGeometry;
     bool m_dirtyMetadata;
+    bool m_dirtyFootprint;
     double m_viewExpansion;
 
+    // Footprint relative to the camera center, reused while only the center changes
+    PolygonVector m_footprint;
+    QDoubleVector3D m_eye; // relative to the camera center as well
+
+    // Tiles farther from the eye than the center are taken from lower zoom levels
+    bool m_distanceLOD;
+
+    // Changes since the last createTiles(added, removed) call
+    bool m_trackChanges;
+    QSet<QGeoTileSpec> m_tilesAdded;
+    QSet<QGeoTileSpec> m_tilesRemoved;
+
 #ifdef QT_LOCATION_DEBUG
     // updateGeometry
     ClippedFootprint m_clippedFootprint;
@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeocodebatchreply.h"
+#include "qgeocodebatchreply_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QGeoCodeBatchReply
+    \inmodule QtLocation
+    \ingroup QtLocation-geocoding
+    \since 5.15
+
+    \brief The QGeoCodeBatchReply class manages the reverse geocoding of a
+    list of coordinates.
+
+    A QGeoCodeBatchReply is returned by the QGeoCodingManager::reverseGeocode()
+    overload taking a list of coordinates. It keeps a result for each of the
+    coordinates() which can be retrieved with itemLocations(), itemError() and
+    itemErrorString() once isItemFinished() returns true. The itemFinished()
+    signal is emitted as the result of each coordinate arrives, in no
+    particular order.
+
+    The reply finishes when every coordinate has a result. The locations()
+    of the reply hold the locations of all coordinates, in the order of the
+    coordinates. A coordinate which failed does not fail the reply; only if
+    all of them failed does the reply report the error of the last one.
+*/
+
+/*!
+    Constructs a reply for the reverse geocoding of \a coordinates, with the
+    specified \a parent.
+*/
+QGeoCodeBatchReply::QGeoCodeBatchReply(const QList<QGeoCoordinate> &coordinates, QObject *parent)
+    : QGeoCodeReply(*new QGeoCodeBatchReplyPrivate(coordinates), parent)
+{
+}
+
+/*!
+    Destroys this reply object.
+*/
+QGeoCodeBatchReply::~QGeoCodeBatchReply()
+{
+}
+
+/*!
+    Returns the coordinates being reverse geocoded.
+*/
+QList<QGeoCoordinate> QGeoCodeBatchReply::coordinates() const
+{
+    return static_cast<const QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this))->coordinates;
+}
+
+/*!
+    Returns the number of coordinates being reverse geocoded.
+*/
+int QGeoCodeBatchReply::count() const
+{
+    return static_cast<const QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this))->items.size();
+}
+
+/*!
+    Returns the number of coordinates which have a result.
+*/
+int QGeoCodeBatchReply::finishedCount() const
+{
+    return static_cast<const QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this))->finishedCount;
+}
+
+/*!
+    Returns true if the coordinate at \a index has a result.
+*/
+bool QGeoCodeBatchReply::isItemFinished(int index) const
+{
+    const QGeoCodeBatchReplyPrivate *d = static_cast<const QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this));
+    return index >= 0 && index < d->items.size() && d->items.at(index).finished;
+}
+
+/*!
+    Returns the error state of the coordinate at \a index.
+*/
+QGeoCodeReply::Error QGeoCodeBatchReply::itemError(int index) const
+{
+    const QGeoCodeBatchReplyPrivate *d = static_cast<const QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this));
+    if (index < 0 || index >= d->items.size())
+        return QGeoCodeReply::UnknownError;
+    return d->items.at(index).error;
+}
+
+/*!
+    Returns the textual representation of the error state of the coordinate
+    at \a index.
+*/
+QString QGeoCodeBatchReply::itemErrorString(int index) const
+{
+    const QGeoCodeBatchReplyPrivate *d = static_cast<const QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this));
+    if (index < 0 || index >= d->items.size())
+        return QString();
+    return d->items.at(index).errorString;
+}
+
+/*!
+    Returns the locations found for the coordinate at \a index.
+*/
+QList<QGeoLocation> QGeoCodeBatchReply::itemLocations(int index) const
+{
+    const QGeoCodeBatchReplyPrivate *d = static_cast<const QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this));
+    if (index < 0 || index >= d->items.size())
+        return QList<QGeoLocation>();
+    return d->items.at(index).locations;
+}
+
+/*!
+    Sets the \a locations found for the coordinate at \a index and marks it
+    as finished, emitting itemFinished(). The reply finishes with the last
+    coordinate.
+
+    This does nothing if the coordinate already has a result.
+*/
+void QGeoCodeBatchReply::setItemLocations(int index, const QList<QGeoLocation> &locations)
+{
+    QGeoCodeBatchReplyPrivate *d = static_cast<QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this));
+    if (index < 0 || index >= d->items.size() || d->items.at(index).finished)
+        return;
+    d->items[index].locations = locations;
+    finishItem(index);
+}
+
+/*!
+    Sets the \a error and \a errorString of the coordinate at \a index and
+    marks it as finished, emitting itemFinished(). The reply finishes with the
+    last coordinate.
+
+    This does nothing if the coordinate already has a result.
+*/
+void QGeoCodeBatchReply::setItemError(int index, QGeoCodeReply::Error error, const QString &errorString)
+{
+    QGeoCodeBatchReplyPrivate *d = static_cast<QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this));
+    if (index < 0 || index >= d->items.size() || d->items.at(index).finished)
+        return;
+    d->items[index].error = error;
+    d->items[index].errorString = errorString;
+    finishItem(index);
+}
+
+void QGeoCodeBatchReply::finishItem(int index)
+{
+    QGeoCodeBatchReplyPrivate *d = static_cast<QGeoCodeBatchReplyPrivate *>(QGeoCodeReplyPrivate::get(*this));
+    d->items[index].finished = true;
+    ++d->finishedCount;
+    emit itemFinished(index);
+
+    if (d->finishedCount < d->items.size() || isFinished())
+        return;
+
+    QList<QGeoLocation> locations;
+    const QGeoCodeBatchReplyPrivate::Item *failed = nullptr;
+    bool succeeded = false;
+    for (const QGeoCodeBatchReplyPrivate::Item &item : qAsConst(d->items)) {
+        locations.append(item.locations);
+        if (item.error == QGeoCodeReply::NoError)
+            succeeded = true;
+        else
+            failed = &item;
+    }
+    setLocations(locations);
+    if (!succeeded && failed)
+        setError(failed->error, failed->errorString);
+    else
+        setFinished(true);
+}
+
+/*!
+    \fn void QGeoCodeBatchReply::itemFinished(int index)
+
+    This signal is emitted when the coordinate at \a index has a result,
+    successful or not.
+*/
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoCodeBatchReplyPrivate::QGeoCodeBatchReplyPrivate(const QList<QGeoCoordinate> &coordinates)
+    : coordinates(coordinates), items(coordinates.size())
+{
+}
+
+QGeoCodeBatchReplyPrivate::~QGeoCodeBatchReplyPrivate()
+{
+}
+
+QT_END_NAMESPACE
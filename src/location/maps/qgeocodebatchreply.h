@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOCODEBATCHREPLY_H
+#define QGEOCODEBATCHREPLY_H
+
+#include <QtLocation/QGeoCodeReply>
+#include <QtPositioning/QGeoCoordinate>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoCodeBatchReplyPrivate;
+
+class Q_LOCATION_EXPORT QGeoCodeBatchReply : public QGeoCodeReply
+{
+    Q_OBJECT
+
+public:
+    ~QGeoCodeBatchReply();
+
+    QList<QGeoCoordinate> coordinates() const;
+    int count() const;
+    int finishedCount() const;
+
+    bool isItemFinished(int index) const;
+    QGeoCodeReply::Error itemError(int index) const;
+    QString itemErrorString(int index) const;
+    QList<QGeoLocation> itemLocations(int index) const;
+
+Q_SIGNALS:
+    void itemFinished(int index);
+
+protected:
+    explicit QGeoCodeBatchReply(const QList<QGeoCoordinate> &coordinates, QObject *parent = nullptr);
+
+    void setItemLocations(int index, const QList<QGeoLocation> &locations);
+    void setItemError(int index, QGeoCodeReply::Error error, const QString &errorString);
+
+private:
+    void finishItem(int index);
+
+    Q_DISABLE_COPY(QGeoCodeBatchReply)
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -42,9 +42,185 @@
 #include "qgeocircle.h"
 
 #include <QLocale>
+#include <QtCore/QDataStream>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtPositioning/QGeoAddress>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+// Replies completed from the cache, synchronously, or from the reply of an
+// identical request in flight.
+class QGeoCodeReplyShared : public QGeoCodeReply
+{
+public:
+    explicit QGeoCodeReplyShared(QObject *parent)
+        : QGeoCodeReply(parent)
+    {
+    }
+
+    void complete(const QList<QGeoLocation> &locations, const QGeoShape &viewport)
+    {
+        setLocations(locations);
+        setViewport(viewport);
+        setFinished(true);
+    }
+
+    void complete(const QGeoCodingManagerPrivate::SharedResult &result)
+    {
+        setLimit(result.limit);
+        setOffset(result.offset);
+        if (result.error != QGeoCodeReply::NoError)
+            setError(result.error, result.errorString);
+        else
+            complete(result.locations, result.viewport);
+    }
+
+    void fail(QGeoCodeReply::Error error, const QString &errorString)
+    {
+        setError(error, errorString);
+    }
+};
+
+// Reverse geocodes a coordinate list one coordinate at a time through the
+// manager, at most concurrency requests at once and starting them at least
+// interval milliseconds apart.
+class QGeoCodeBatchReplyQueued : public QGeoCodeBatchReply
+{
+public:
+    QGeoCodeBatchReplyQueued(const QList<QGeoCoordinate> &coordinates, const QGeoShape &bounds,
+                             int concurrency, int interval, QGeoCodingManager *manager,
+                             QObject *parent)
+        : QGeoCodeBatchReply(coordinates, parent), m_manager(manager), m_bounds(bounds),
+          m_concurrency(concurrency), m_interval(interval)
+    {
+        m_timer.setSingleShot(true);
+        QObject::connect(&m_timer, &QTimer::timeout, this, [this]() { startNext(); });
+
+        if (coordinates.isEmpty())
+            setFinished(true);
+        else // Results may be synchronous, let the caller connect first
+            QMetaObject::invokeMethod(this, [this]() { startNext(); }, Qt::QueuedConnection);
+    }
+
+    ~QGeoCodeBatchReplyQueued()
+    {
+        abortRunning();
+    }
+
+    void abort() override
+    {
+        m_timer.stop();
+        abortRunning();
+        QGeoCodeBatchReply::abort();
+    }
+
+private:
+    void startNext()
+    {
+        if (m_starting)
+            return;
+        m_starting = true;
+        while (!isFinished() && m_manager && m_running.size() < m_concurrency
+               && m_next < count()) {
+            if (m_interval > 0 && m_lastStart.isValid()) {
+                const qint64 wait = m_interval - m_lastStart.elapsed();
+                if (wait > 0) {
+                    m_timer.start(int(wait));
+                    break;
+                }
+            }
+
+            const int index = m_next++;
+            QGeoCodeReply *reply = m_manager->reverseGeocode(coordinates().at(index), m_bounds);
+            m_lastStart.start();
+            if (reply->isFinished()) {
+                take(index, reply);
+                continue;
+            }
+            m_running.append(reply);
+            QObject::connect(reply, &QGeoCodeReply::finished, this, [this, index, reply]() {
+                if (!m_running.removeOne(reply))
+                    return;
+                take(index, reply);
+                startNext();
+            });
+        }
+        m_starting = false;
+    }
+
+    void take(int index, QGeoCodeReply *reply)
+    {
+        if (reply->error() != QGeoCodeReply::NoError)
+            setItemError(index, reply->error(), reply->errorString());
+        else
+            setItemLocations(index, reply->locations());
+        reply->deleteLater();
+    }
+
+    void abortRunning()
+    {
+        const QList<QPointer<QGeoCodeReply>> running(m_running.cbegin(), m_running.cend());
+        m_running.clear();
+        for (const QPointer<QGeoCodeReply> &reply : running) {
+            if (reply) {
+                reply->abort();
+                reply->deleteLater();
+            }
+        }
+    }
+
+    QPointer<QGeoCodingManager> m_manager;
+    QGeoShape m_bounds;
+    int m_concurrency;
+    int m_interval;
+    int m_next = 0;
+    bool m_starting = false;
+    QList<QGeoCodeReply *> m_running;
+    QTimer m_timer;
+    QElapsedTimer m_lastStart;
+};
+
+QString normalized(const QString &text)
+{
+    return text.simplified().toCaseFolded();
+}
+
+QByteArray geohash(const QGeoCoordinate &coordinate, int precision)
+{
+    static const char base32[] = "0123456789bcdefghjkmnpqrstuvwxyz";
+    double latitude[2] = { -90.0, 90.0 };
+    double longitude[2] = { -180.0, 180.0 };
+    QByteArray hash;
+    bool even = true;
+    int bits = 0;
+    int ch = 0;
+    while (hash.size() < precision) {
+        double *range = even ? longitude : latitude;
+        const double value = even ? coordinate.longitude() : coordinate.latitude();
+        const double mid = (range[0] + range[1]) / 2;
+        ch <<= 1;
+        if (value >= mid) {
+            ch |= 1;
+            range[0] = mid;
+        } else {
+            range[1] = mid;
+        }
+        even = !even;
+        if (++bits == 5) {
+            hash.append(base32[ch]);
+            bits = 0;
+            ch = 0;
+        }
+    }
+    return hash;
+}
+
+}
+
 /*!
     \class QGeoCodingManager
     \inmodule QtLocation
@@ -65,6 +241,16 @@ QT_BEGIN_NAMESPACE
     geocoding operation, if the string provided can be interpreted as
     an address it can be geocoded to coordinate information.
 
+    If the service provider was created with a \c{<provider>.geocoding.cache.size}
+    parameter greater than zero, up to that many results are kept. A request
+    matching one of them returns a reply which is already finished, and
+    identical requests made while one is in progress share its result.
+    Addresses match regardless of case and whitespace, and reverse geocoding
+    requests match when their coordinates fall in the same cell of a geohash
+    of \c{<provider>.geocoding.cache.precision} characters, 8 by default, or
+    about 38 by 19 meters. Results expire after
+    \c{<provider>.geocoding.cache.ttl} seconds, 300 by default.
+
     Instances of QGeoCodingManager can be accessed with
     QGeoServiceProvider::geocodingManager().
 */
@@ -170,7 +356,13 @@ int QGeoCodingManager::managerVersion() const
 */
 QGeoCodeReply *QGeoCodingManager::geocode(const QGeoAddress &address, const QGeoShape &bounds)
 {
-    return d_ptr->engine->geocode(address, bounds);
+    if (d_ptr->cache.maxCost() <= 0)
+        return d_ptr->engine->geocode(address, bounds);
+
+    const QByteArray key = d_ptr->geocodeKey(address, bounds);
+    if (QGeoCodeReply *reply = d_ptr->sharedReply(key))
+        return reply;
+    return d_ptr->trackReply(key, d_ptr->engine->geocode(address, bounds), this);
 }
 
 
@@ -212,7 +404,55 @@ QGeoCodeReply *QGeoCodingManager::geocode(const QGeoAddress &address, const QGeo
 */
 QGeoCodeReply *QGeoCodingManager::reverseGeocode(const QGeoCoordinate &coordinate, const QGeoShape &bounds)
 {
-    return d_ptr->engine->reverseGeocode(coordinate, bounds);
+    if (d_ptr->cache.maxCost() <= 0 || !coordinate.isValid())
+        return d_ptr->engine->reverseGeocode(coordinate, bounds);
+
+    const QByteArray key = d_ptr->reverseGeocodeKey(coordinate, bounds);
+    if (QGeoCodeReply *reply = d_ptr->sharedReply(key))
+        return reply;
+    return d_ptr->trackReply(key, d_ptr->engine->reverseGeocode(coordinate, bounds), this);
+}
+
+/*!
+    \since 5.15
+
+    Begins the reverse geocoding of each of \a coordinates.
+
+    A QGeoCodeBatchReply object will be returned, which holds the result of
+    each coordinate as it arrives and finishes when all of them have one. The
+    meaning of the results and of \a bounds is that of the reverseGeocode()
+    overload taking a single coordinate.
+
+    If the service provider has a batch request for reverse geocoding, it is
+    used. Otherwise the coordinates are reverse geocoded one by one, with at
+    most \c{<provider>.geocoding.batch.concurrency} requests in progress, 2 by
+    default, and, if \c{<provider>.geocoding.batch.interval} is set, that many
+    milliseconds between the start of two requests. Those requests go through
+    the result cache and are reported by the finished() and error() signals
+    of this manager as well.
+
+    The user is responsible for deleting the returned reply object, although
+    this can be done in the slot connected to QGeoCodingManager::finished(),
+    QGeoCodingManager::error(), QGeoCodeReply::finished() or
+    QGeoCodeReply::error() with deleteLater().
+*/
+QGeoCodeBatchReply *QGeoCodingManager::reverseGeocode(const QList<QGeoCoordinate> &coordinates,
+                                                      const QGeoShape &bounds)
+{
+    if (!coordinates.isEmpty()) {
+        if (QGeoCodeBatchReply *reply = d_ptr->engineBatchReply(coordinates, bounds))
+            return reply;
+    }
+
+    QGeoCodeBatchReplyQueued *reply
+            = new QGeoCodeBatchReplyQueued(coordinates, bounds, d_ptr->batchConcurrency,
+                                           d_ptr->batchInterval, this, d_ptr->engine);
+    connect(reply, &QGeoCodeReply::finished, this, [this, reply]() {
+        if (reply->error() != QGeoCodeReply::NoError)
+            emit error(reply, reply->error(), reply->errorString());
+        emit finished(reply);
+    });
+    return reply;
 }
 
 /*!
@@ -249,11 +489,18 @@ QGeoCodeReply *QGeoCodingManager::geocode(const QString &address,
         int offset,
         const QGeoShape &bounds)
 {
-    QGeoCodeReply *reply = d_ptr->engine->geocode(address,
-                             limit,
-                             offset,
-                             bounds);
-    return reply;
+    if (d_ptr->cache.maxCost() <= 0) {
+        QGeoCodeReply *reply = d_ptr->engine->geocode(address,
+                                 limit,
+                                 offset,
+                                 bounds);
+        return reply;
+    }
+
+    const QByteArray key = d_ptr->geocodeKey(address, limit, offset, bounds);
+    if (QGeoCodeReply *reply = d_ptr->sharedReply(key))
+        return reply;
+    return d_ptr->trackReply(key, d_ptr->engine->geocode(address, limit, offset, bounds), this);
 }
 
 /*!
@@ -312,13 +559,203 @@ QLocale QGeoCodingManager::locale() const
 *******************************************************************************/
 
 QGeoCodingManagerPrivate::QGeoCodingManagerPrivate()
-    : engine(0) {}
+    : engine(0)
+{
+    cache.setMaxCost(0);
+}
 
 QGeoCodingManagerPrivate::~QGeoCodingManagerPrivate()
 {
     delete engine;
 }
 
+void QGeoCodingManagerPrivate::setCacheSize(int size)
+{
+    cache.setMaxCost(qMax(size, 0));
+    if (size > 0 && !cacheClock.isValid())
+        cacheClock.start();
+}
+
+/*
+    The address fields are compared without case and with whitespace
+    simplified. The locale is part of the keys as it changes the results.
+*/
+QByteArray QGeoCodingManagerPrivate::geocodeKey(const QGeoAddress &address, const QGeoShape &bounds) const
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << quint8('a')
+           << (address.isTextGenerated() ? QString() : normalized(address.text()))
+           << normalized(address.country()) << normalized(address.countryCode())
+           << normalized(address.state()) << normalized(address.county())
+           << normalized(address.city()) << normalized(address.district())
+           << normalized(address.postalCode()) << normalized(address.street())
+           << bounds << engine->locale().name();
+    return key;
+}
+
+QByteArray QGeoCodingManagerPrivate::geocodeKey(const QString &address, int limit, int offset,
+                                                const QGeoShape &bounds) const
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << quint8('s') << normalized(address) << limit << offset
+           << bounds << engine->locale().name();
+    return key;
+}
+
+/*
+    Coordinates in the same geohash cell share the key.
+*/
+QByteArray QGeoCodingManagerPrivate::reverseGeocodeKey(const QGeoCoordinate &coordinate,
+                                                       const QGeoShape &bounds) const
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << quint8('r') << geohash(coordinate, geohashPrecision)
+           << bounds << engine->locale().name();
+    return key;
+}
+
+/*
+    Calls the invokable reverseGeocodeBatch() of engines that have one, see
+    QGeoCodingManagerEngine. It is looked up, instead of being a virtual, to
+    keep the engine binary compatible.
+*/
+QGeoCodeBatchReply *QGeoCodingManagerPrivate::engineBatchReply(const QList<QGeoCoordinate> &coordinates,
+                                                               const QGeoShape &bounds) const
+{
+    static const char signature[] = "reverseGeocodeBatch(QList<QGeoCoordinate>,QGeoShape)";
+    if (engine->metaObject()->indexOfMethod(signature) < 0)
+        return nullptr;
+
+    QGeoCodeBatchReply *reply = nullptr;
+    QMetaObject::invokeMethod(engine, "reverseGeocodeBatch", Qt::DirectConnection,
+                              Q_RETURN_ARG(QGeoCodeBatchReply *, reply),
+                              Q_ARG(QList<QGeoCoordinate>, coordinates),
+                              Q_ARG(QGeoShape, bounds));
+    return reply;
+}
+
+/*
+    Returns a reply completed from the cache, or completing with the reply of
+    an identical request in flight, or null.
+*/
+QGeoCodeReply *QGeoCodingManagerPrivate::sharedReply(const QByteArray &key)
+{
+    if (CachedLocations *entry = cache.object(key)) {
+        if (entry->expiry >= cacheClock.elapsed()) {
+            QGeoCodeReplyShared *reply = new QGeoCodeReplyShared(engine);
+            reply->complete(entry->locations, entry->viewport);
+            return reply;
+        }
+        cache.remove(key);
+    }
+
+    const auto request = inFlight.find(key);
+    if (request == inFlight.end())
+        return nullptr;
+
+    QGeoCodeReplyShared *reply = new QGeoCodeReplyShared(engine);
+    request->followers.append(reply);
+    return reply;
+}
+
+/*
+    Caches the result of \a reply once it succeeds, and shares it with the
+    identical requests made in the meantime.
+
+    QGeoCodeReply::abort() emits finished() before aborted(), so the result
+    is only used once both had a chance to arrive. An aborted reply is not
+    cached, and its followers fail.
+*/
+QGeoCodeReply *QGeoCodingManagerPrivate::trackReply(const QByteArray &key, QGeoCodeReply *reply,
+                                                    QGeoCodingManager *manager)
+{
+    if (reply->isFinished()) {
+        if (reply->error() == QGeoCodeReply::NoError)
+            store(key, reply->locations(), reply->viewport());
+        return reply;
+    }
+
+    inFlight.insert(key, SharedRequest{reply, false, false, SharedResult(), {}});
+
+    auto settleLater = [this, key, reply, manager]() {
+        QMetaObject::invokeMethod(manager, [this, key, reply, manager]() {
+            settle(key, reply, manager);
+        }, Qt::QueuedConnection);
+    };
+    QObject::connect(reply, &QGeoCodeReply::finished, manager, [this, key, reply, settleLater]() {
+        const auto request = inFlight.find(key);
+        if (request == inFlight.end() || request->reply != reply || request->finished)
+            return;
+        request->finished = true;
+        request->result.error = reply->error();
+        request->result.errorString = reply->errorString();
+        request->result.locations = reply->locations();
+        request->result.viewport = reply->viewport();
+        request->result.limit = reply->limit();
+        request->result.offset = reply->offset();
+        settleLater();
+    });
+    QObject::connect(reply, &QGeoCodeReply::aborted, manager, [this, key, reply, settleLater]() {
+        const auto request = inFlight.find(key);
+        if (request == inFlight.end() || request->reply != reply)
+            return;
+        request->aborted = true;
+        settleLater();
+    });
+    QObject::connect(reply, &QObject::destroyed, manager, [this, key, reply, manager]() {
+        const auto request = inFlight.find(key);
+        if (request == inFlight.end() || request->reply != reply)
+            return;
+        if (!request->finished)
+            request->aborted = true;
+        settle(key, reply, manager);
+    });
+    return reply;
+}
+
+/*
+    Ends the request \a reply made for \a key: caches its result if it
+    succeeded, and completes the replies sharing it.
+*/
+void QGeoCodingManagerPrivate::settle(const QByteArray &key, QGeoCodeReply *reply,
+                                      QGeoCodingManager *manager)
+{
+    const auto it = inFlight.find(key);
+    if (it == inFlight.end() || it->reply != reply)
+        return;
+    SharedRequest request = it.value();
+    inFlight.erase(it);
+
+    if (request.aborted) {
+        request.result.error = QGeoCodeReply::CommunicationError;
+        request.result.errorString = QStringLiteral("The shared request was aborted");
+    } else if (request.result.error == QGeoCodeReply::NoError) {
+        store(key, request.result.locations, request.result.viewport);
+    }
+
+    for (const QPointer<QGeoCodeReply> &follower : qAsConst(request.followers)) {
+        if (!follower || follower->isFinished())
+            continue;
+        QGeoCodeReplyShared *shared = static_cast<QGeoCodeReplyShared *>(follower.data());
+        shared->complete(request.result);
+        if (shared->error() != QGeoCodeReply::NoError)
+            emit manager->error(shared, shared->error(), shared->errorString());
+        emit manager->finished(shared);
+    }
+}
+
+void QGeoCodingManagerPrivate::store(const QByteArray &key, const QList<QGeoLocation> &locations,
+                                     const QGeoShape &viewport)
+{
+    if (cache.maxCost() <= 0)
+        return;
+    cache.insert(key, new CachedLocations{locations, viewport,
+                                          cacheClock.elapsed() + qint64(cacheTtl) * 1000});
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
@@ -38,6 +38,7 @@
 #define QGEOCODINGMANAGER_H
 
 #include <QtLocation/QGeoCodeReply>
+#include <QtLocation/QGeoCodeBatchReply>
 #include <QtPositioning/QGeoRectangle>
 
 #include <QtCore/QObject>
@@ -69,6 +70,8 @@ public:
 
     QGeoCodeReply *reverseGeocode(const QGeoCoordinate &coordinate,
                                   const QGeoShape &bounds = QGeoShape());
+    QGeoCodeBatchReply *reverseGeocode(const QList<QGeoCoordinate> &coordinates,
+                                       const QGeoShape &bounds = QGeoShape());
 
     void setLocale(const QLocale &locale);
     QLocale locale() const;
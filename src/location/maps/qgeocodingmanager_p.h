@@ -53,10 +53,20 @@
 #include "qgeocodereply.h"
 
 #include <QList>
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+#include <QtPositioning/QGeoLocation>
+#include <QtPositioning/QGeoShape>
 
 QT_BEGIN_NAMESPACE
 
 class QGeoCodingManagerEngine;
+class QGeoAddress;
+class QGeoCoordinate;
 
 class QGeoCodingManagerPrivate
 {
@@ -64,8 +74,57 @@ public:
     QGeoCodingManagerPrivate();
     ~QGeoCodingManagerPrivate();
 
+    void setCacheSize(int size);
+    QByteArray geocodeKey(const QGeoAddress &address, const QGeoShape &bounds) const;
+    QByteArray geocodeKey(const QString &address, int limit, int offset, const QGeoShape &bounds) const;
+    QByteArray reverseGeocodeKey(const QGeoCoordinate &coordinate, const QGeoShape &bounds) const;
+    QGeoCodeBatchReply *engineBatchReply(const QList<QGeoCoordinate> &coordinates,
+                                         const QGeoShape &bounds) const;
+    QGeoCodeReply *sharedReply(const QByteArray &key);
+    QGeoCodeReply *trackReply(const QByteArray &key, QGeoCodeReply *reply, QGeoCodingManager *manager);
+    void settle(const QByteArray &key, QGeoCodeReply *reply, QGeoCodingManager *manager);
+    void store(const QByteArray &key, const QList<QGeoLocation> &locations, const QGeoShape &viewport);
+
     QGeoCodingManagerEngine *engine;
 
+    struct CachedLocations
+    {
+        QList<QGeoLocation> locations;
+        QGeoShape viewport;
+        qint64 expiry;
+    };
+
+    // Least recently used results, every entry has a cost of 1
+    QCache<QByteArray, CachedLocations> cache;
+    struct SharedResult
+    {
+        QGeoCodeReply::Error error = QGeoCodeReply::NoError;
+        QString errorString;
+        QList<QGeoLocation> locations;
+        QGeoShape viewport;
+        int limit = -1;
+        int offset = 0;
+    };
+
+    struct SharedRequest
+    {
+        QGeoCodeReply *reply;
+        bool finished;
+        bool aborted;
+        SharedResult result; // taken when the reply finished
+        QVector<QPointer<QGeoCodeReply>> followers;
+    };
+
+    // Engine replies still running, shared by identical requests
+    QHash<QByteArray, SharedRequest> inFlight;
+    int cacheTtl = 300; // seconds
+    int geohashPrecision = 8; // cells of about 38 by 19 meters
+    QElapsedTimer cacheClock;
+
+    // Reverse geocoding of coordinate lists the engine has no batch request for
+    int batchConcurrency = 2; // requests in flight
+    int batchInterval = 0; // milliseconds between the start of two requests
+
 private:
     Q_DISABLE_COPY(QGeoCodingManagerPrivate)
 };
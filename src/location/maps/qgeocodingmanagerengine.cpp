@@ -72,6 +72,15 @@ QT_BEGIN_NAMESPACE
     data (such as a QNetworkReply object for network-based services) to the
     QGeoCodeReply instances used by the engine.
 
+    Since Qt 5.15, if the service can reverse geocode many coordinates in one
+    request, the subclass may declare the invokable method
+    \c{QGeoCodeBatchReply *reverseGeocodeBatch(const QList<QGeoCoordinate> &coordinates, const QGeoShape &bounds)}.
+    QGeoCodingManager::reverseGeocode() calls it for coordinate lists, and
+    reverse geocodes the coordinates one at a time with reverseGeocode() if
+    it is missing or returns \nullptr, for example for lists the batch request
+    cannot take. The returned QGeoCodeBatchReply holds the result of each
+    coordinate.
+
     \sa QGeoCodingManager
 */
 
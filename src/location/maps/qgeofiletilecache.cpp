@@ -38,12 +38,30 @@
 #include "qgeotilespec_p.h"
 
 #include "qgeomappingmanager_p.h"
+#include "qgeomapstatistics_p.h"
+#include "qgeomemorypressuremonitor_p.h"
 
+#include <QtGui/private/qtexturefilereader_p.h>
+
+#include <QBuffer>
+#include <QImageReader>
 #include <QDir>
 #include <QStandardPaths>
 #include <QMetaType>
 #include <QPixmap>
 #include <QDebug>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QThread>
+#include <QSaveFile>
+#include <QLockFile>
+#include <QFileSystemWatcher>
+#include <QRandomGenerator>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <limits>
 
 Q_DECLARE_METATYPE(QList<QGeoTileSpec>)
 Q_DECLARE_METATYPE(QSet<QGeoTileSpec>)
@@ -63,6 +81,63 @@ public:
     QGeoFileTileCache *cache;
     QByteArray bytes;
     QString format;
+    QGeoMapMemoryTracker memory { QGeoMapStatistics::TileMemoryCache };
+};
+
+/* A tile waiting to be decoded off the GUI thread. The texture is the pending
+ * handle returned by get() until the decoded image lands in the texture cache. */
+class QGeoTileDecodeTask
+{
+public:
+    QGeoTileSpec spec;
+    QString filename; // empty if bytes come from the memory cache
+    QByteArray bytes;
+    QString format;
+    QImage::Format opaqueFormat;
+    QSharedPointer<QGeoTileTexture> texture;
+    QAtomicInt canceled;
+};
+
+class QGeoTileDecodeRunnable : public QRunnable
+{
+public:
+    QGeoTileDecodeRunnable(QGeoFileTileCache *cache, const QSharedPointer<QGeoTileDecodeTask> &task)
+        : m_cache(cache), m_task(task)
+    {
+    }
+
+    void run() override
+    {
+        // Cancelled while queued: don't touch the disk nor the decoder
+        if (m_task->canceled.loadAcquire())
+            return;
+
+        QByteArray bytes = m_task->bytes;
+        if (!m_task->filename.isEmpty()) {
+            QFile file(m_task->filename);
+            if (file.open(QIODevice::ReadOnly))
+                bytes = file.readAll();
+        }
+
+        QImage image;
+        QTextureFileData compressed;
+        const bool bogus = m_cache->isTileBogus(bytes);
+        const bool decoded = bogus
+                || QGeoFileTileCache::decodeTileImage(bytes, &image, &compressed, m_task->opaqueFormat,
+                                                    m_task->format);
+        if (m_task->canceled.loadAcquire())
+            return;
+
+        QGeoFileTileCache *cache = m_cache;
+        QSharedPointer<QGeoTileDecodeTask> task = m_task;
+        QMetaObject::invokeMethod(cache, [cache, task, bytes, image, compressed, decoded, bogus]() {
+            cache->decodeFinished(task, bytes, image, compressed, decoded, bogus);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QGeoFileTileCache *m_cache;
+    QSharedPointer<QGeoTileDecodeTask> m_task;
 };
 
 void QCache3QTileEvictionPolicy::aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<QGeoCachedTileDisk> obj)
@@ -79,6 +154,11 @@ void QCache3QTileEvictionPolicy::aboutToBeEvicted(const QGeoTileSpec &key, QShar
     // leave the pointer set if it's a real eviction
 }
 
+QGeoCachedTileDisk::QGeoCachedTileDisk()
+    : cache(0), size(0), lastModified(0), revalidating(false), validated(false)
+{
+}
+
 QGeoCachedTileDisk::~QGeoCachedTileDisk()
 {
     if (cache)
@@ -86,11 +166,90 @@ QGeoCachedTileDisk::~QGeoCachedTileDisk()
 }
 
 QGeoFileTileCache::QGeoFileTileCache(const QString &directory, QObject *parent)
-    : QAbstractGeoTileCache(parent), directory_(directory), minTextureUsage_(0), extraTextureUsage_(0)
+    : QAbstractGeoTileCache(parent), directory_(directory)
+    ,shared_(false), indexLockDepth_(0), indexWatcher_(nullptr), indexSyncTimer_(nullptr)
+    ,decodePool_(new QThreadPool(this))
+    ,writePool_(new QThreadPool(this))
+    ,asynchronousDecoding_(false), maxPendingDecodes_(64), opaqueTextureFormat_(QImage::Format_RGB32), serveStaleTiles_(false)
+    ,warmStartTiles_(0)
+    ,minTextureUsage_(0), extraTextureUsage_(0), maxMemoryUsage_(0), textureUsageFloor_(-1), memoryUsageFloor_(0)
     ,costStrategyDisk_(ByteSize), costStrategyMemory_(ByteSize), costStrategyTexture_(ByteSize)
     ,isDiskCostSet_(false), isMemoryCostSet_(false), isTextureCostSet_(false)
 {
+    decodePool_->setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 4));
+    writePool_->setMaxThreadCount(1);
+}
 
+// Tile index layout, all integers little endian:
+//  header: quint32 magic, quint32 version, qint64 generation (random, new
+//          whenever the file is rewritten; missing in version 2)
+//  record: quint8 op, quint8 queue, quint16 name length, quint32 byte size,
+//          qint64 last modified (msecs since epoch), qint64 expiry (msecs
+//          since epoch, or -1), quint16 ETag length, quint16 Last-Modified
+//          length, latin1 file name, ETag, Last-Modified header value
+// Records are appended as tiles enter and leave the disk cache; the file is
+// rewritten from the cache queues when compacting and on destruction.
+// In a shared directory, appends and rewrites happen under tiles.index.lock.
+static const quint32 tileIndexMagic = 0x49544751; // "QGTI"
+static const quint32 tileIndexVersion = 3;
+static const int tileIndexHeaderSize = 16;
+static const int tileIndexHeaderSizeV2 = 8;
+static const int tileIndexRecordSize = 28;
+static const quint8 tileIndexInsert = 1;
+static const quint8 tileIndexRemove = 2;
+
+static const int tileIndexLockTimeout = 5000; // ms
+
+static QString tileIndexFilename(const QString &directory)
+{
+    return QDir(directory).filePath(QStringLiteral("tiles.index"));
+}
+
+static QString tileIndexLockFilename(const QString &directory)
+{
+    return QDir(directory).filePath(QStringLiteral("tiles.index.lock"));
+}
+
+// The tiles last in the texture cache, one file name per line, most recent first
+static QString warmStartFilename(const QString &directory)
+{
+    return QDir(directory).filePath(QStringLiteral("textures.warmstart"));
+}
+
+static QByteArray tileIndexRecord(quint8 op, int queue, const QByteArray &name, int size, qint64 lastModified,
+                                  const QGeoTileValidators &validators)
+{
+    // removals don't need the validators
+    const QByteArray etag = op == tileIndexInsert ? validators.entityTag.left(0xffff) : QByteArray();
+    const QByteArray modified = op == tileIndexInsert ? validators.lastModified.left(0xffff) : QByteArray();
+    QByteArray record(tileIndexRecordSize + name.size() + etag.size() + modified.size(), Qt::Uninitialized);
+    uchar *data = reinterpret_cast<uchar *>(record.data());
+    data[0] = op;
+    data[1] = quint8(queue);
+    qToLittleEndian<quint16>(quint16(name.size()), data + 2);
+    qToLittleEndian<quint32>(quint32(size), data + 4);
+    qToLittleEndian<qint64>(lastModified, data + 8);
+    qToLittleEndian<qint64>(op == tileIndexInsert ? validators.expires : -1, data + 16);
+    qToLittleEndian<quint16>(quint16(etag.size()), data + 24);
+    qToLittleEndian<quint16>(quint16(modified.size()), data + 26);
+    uchar *strings = data + tileIndexRecordSize;
+    memcpy(strings, name.constData(), name.size());
+    memcpy(strings + name.size(), etag.constData(), etag.size());
+    memcpy(strings + name.size() + etag.size(), modified.constData(), modified.size());
+    return record;
+}
+
+// For the write tasks of a shared cache, which can't use the cache's own lock
+static void appendToSharedTileIndex(const QString &directory, const QByteArray &record)
+{
+    QLockFile lock(tileIndexLockFilename(directory));
+    if (!lock.tryLock(tileIndexLockTimeout)) {
+        qWarning() << "Unable to lock tile cache index " << lock.fileName();
+        return;
+    }
+    QFile file(tileIndexFilename(directory));
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append))
+        file.write(record);
 }
 
 void QGeoFileTileCache::init()
@@ -144,58 +303,54 @@ void QGeoFileTileCache::init()
             setExtraTextureUsage(30); // byte size of texture is >> compressed image, hence unitary cost should be lower
     }
 
+    if (shared_) {
+        const QDir dir(directory_);
+        ownerLock_.reset(new QLockFile(dir.filePath(QStringLiteral("tiles.owner.lock"))));
+        // held for the lifetime of the cache, so only a dead owner makes it stale
+        ownerLock_->setStaleLockTime(0);
+        ownerLock_->tryLock(0);
+        indexLock_.reset(new QLockFile(tileIndexLockFilename(directory_)));
+    }
+
     loadTiles();
+    decodeWarmStartTiles();
+
+    if (shared_) {
+        // the other processes append to the index as they add tiles
+        indexWatcher_ = new QFileSystemWatcher(QStringList(tileIndexFilename(directory_)), this);
+        indexSyncTimer_ = new QTimer(this);
+        indexSyncTimer_->setSingleShot(true);
+        indexSyncTimer_->setInterval(100);
+        connect(indexWatcher_, &QFileSystemWatcher::fileChanged,
+                indexSyncTimer_, QOverload<>::of(&QTimer::start));
+        connect(indexSyncTimer_, &QTimer::timeout, this, &QGeoFileTileCache::syncTileIndex);
+    }
 }
 
 void QGeoFileTileCache::loadTiles()
 {
+    // 1. the tile index is the fast path: no directory listing and no stat per tile
+    QVector<QGeoTileIndexEntry> entries;
+    int recordCount = 0;
+    lockTileIndex();
+    if (readTileIndex(&entries, &recordCount, &indexPosition_)) {
+        // opened first, so that evictions caused by a lower cost limit get recorded
+        tileIndex_.setFileName(tileIndexFilename(directory_));
+        tileIndex_.open(QIODevice::WriteOnly | QIODevice::Append);
+        insertIndexedTiles(entries);
+        // compact the log once removals and re-insertions dominate it
+        if (recordCount > 2 * entries.size() + 1024 && isDiskCacheOwner())
+            writeTileIndex();
+        unlockTileIndex();
+        return;
+    }
+
+    // 2. the index is missing or corrupt: scan the directory and rebuild it
     QStringList formats;
     formats << QLatin1String("*.*");
 
     QDir dir(directory_);
     QStringList files = dir.entryList(formats, QDir::Files);
-#if 0 // workaround for QTBUG-60581
-    // Method:
-    // 1. read each queue file then, if each file exists, deserialize the data into the appropriate
-    // cache queue.
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::ReadOnly))
-            continue;
-        QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        QList<QGeoTileSpec> specs;
-        QList<int> costs;
-        while (!file.atEnd()) {
-            QByteArray line = file.readLine().trimmed();
-            QString filename = QString::fromLatin1(line.constData(), line.length());
-            if (dir.exists(filename)){
-                files.removeOne(filename);
-                QGeoTileSpec spec = filenameToTileSpec(filename);
-                if (spec.zoom() == -1)
-                    continue;
-                QSharedPointer<QGeoCachedTileDisk> tileDisk(new QGeoCachedTileDisk);
-                tileDisk->filename = dir.filePath(filename);
-                tileDisk->cache = this;
-                tileDisk->spec = spec;
-                QFileInfo fi(tileDisk->filename);
-                specs.append(spec);
-                queue.append(tileDisk);
-                if (costStrategyDisk_ == ByteSize)
-                    costs.append(fi.size());
-                else
-                    costs.append(1);
-
-            }
-        }
-
-        diskCache_.deserializeQueue(i, specs, queue, costs);
-        file.close();
-    }
-#endif
-    // 2. remaining tiles that aren't registered in a queue get pushed into cache here
-    // this is a backup, in case the queue manifest files get deleted or out of sync due to
-    // the application not closing down properly
     for (int i = 0; i < files.size(); ++i) {
         QGeoTileSpec spec = filenameToTileSpec(files.at(i));
         if (spec.zoom() == -1)
@@ -203,34 +358,402 @@ void QGeoFileTileCache::loadTiles()
         QString filename = dir.filePath(files.at(i));
         addToDiskCache(spec, filename);
     }
+    writeTileIndex();
+    unlockTileIndex();
 }
 
-QGeoFileTileCache::~QGeoFileTileCache()
+/*
+    Replays the tile index log into \a entries, in insertion order. Returns false
+    if the index is missing or corrupt, in which case the caller has to fall back
+    to scanning the cache directory.
+
+    With a \a position, only the records after it are replayed, and the files
+    they removed are added to \a removed. This fails as well if the index was
+    rewritten since. The position is then moved to the end of the index.
+*/
+bool QGeoFileTileCache::readTileIndex(QVector<QGeoTileIndexEntry> *entries, int *recordCount,
+                                      QGeoTileIndexPosition *position, QSet<QString> *removed) const
 {
-#if 0 // workaround for QTBUG-60581
-    // write disk cache queues to disk
-    QDir dir(directory_);
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::WriteOnly)){
-            qWarning() << "Unable to write tile cache file " << filename;
+    QFile file(tileIndexFilename(directory_));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 size = file.size();
+    if (size < tileIndexHeaderSizeV2 || size > std::numeric_limits<int>::max())
+        return false;
+
+    QByteArray buffer;
+    const uchar *data = file.map(0, size);
+    if (!data) {
+        buffer = file.readAll();
+        if (buffer.size() != size)
+            return false;
+        data = reinterpret_cast<const uchar *>(buffer.constData());
+    }
+
+    const quint32 version = qFromLittleEndian<quint32>(data + 4);
+    if (qFromLittleEndian<quint32>(data) != tileIndexMagic || (version != 2 && version != tileIndexVersion))
+        return false;
+    const int headerSize = version == 2 ? tileIndexHeaderSizeV2 : tileIndexHeaderSize;
+    if (size < headerSize)
+        return false;
+    const qint64 generation = version == 2 ? 0 : qFromLittleEndian<qint64>(data + 8);
+
+    QVector<QGeoTileIndexEntry> log;
+    QHash<QString, int> lookup;
+    int records = 0;
+    qint64 pos = headerSize;
+    if (position && position->offset > 0) {
+        if (generation != position->generation || position->offset < headerSize || position->offset > size)
+            return false;
+        pos = position->offset;
+    }
+    while (pos < size) {
+        if (size - pos < tileIndexRecordSize)
+            return false;
+        const uchar *record = data + pos;
+        const quint8 op = record[0];
+        const int nameLength = qFromLittleEndian<quint16>(record + 2);
+        const int etagLength = qFromLittleEndian<quint16>(record + 24);
+        const int modifiedLength = qFromLittleEndian<quint16>(record + 26);
+        if (size - pos - tileIndexRecordSize < nameLength + etagLength + modifiedLength)
+            return false;
+        const char *strings = reinterpret_cast<const char *>(record + tileIndexRecordSize);
+        const QString name = QString::fromLatin1(strings, nameLength);
+        pos += tileIndexRecordSize + nameLength + etagLength + modifiedLength;
+        ++records;
+
+        const int existing = lookup.value(name, -1);
+        if (existing >= 0) {
+            log[existing].size = -1; // superseded
+            lookup.remove(name);
+        }
+        if (op == tileIndexRemove) {
+            if (removed)
+                removed->insert(name);
             continue;
         }
+        if (op != tileIndexInsert)
+            return false;
+        if (removed)
+            removed->remove(name);
+
+        QGeoTileIndexEntry entry;
+        entry.filename = name;
+        entry.queue = qBound(1, int(record[1]), 3);
+        entry.size = int(qFromLittleEndian<quint32>(record + 4));
+        entry.lastModified = qFromLittleEndian<qint64>(record + 8);
+        entry.validators.expires = qFromLittleEndian<qint64>(record + 16);
+        entry.validators.entityTag = QByteArray(strings + nameLength, etagLength);
+        entry.validators.lastModified = QByteArray(strings + nameLength + etagLength, modifiedLength);
+        lookup.insert(name, log.size());
+        log.append(entry);
+    }
+
+    entries->clear();
+    entries->reserve(lookup.size());
+    for (const QGeoTileIndexEntry &entry : qAsConst(log)) {
+        if (entry.size >= 0)
+            entries->append(entry);
+    }
+    if (recordCount)
+        *recordCount = records;
+    if (position) {
+        position->generation = generation;
+        position->offset = size;
+    }
+    return true;
+}
+
+/*
+    Puts the tiles from the index back into the queues they were in, restricted
+    to \a mapId unless it is -1.
+*/
+void QGeoFileTileCache::insertIndexedTiles(const QVector<QGeoTileIndexEntry> &entries, int mapId)
+{
+    QDir dir(directory_);
+    QList<QGeoTileSpec> specs[3];
+    QList<QSharedPointer<QGeoCachedTileDisk> > tiles[3];
+    QList<int> costs[3];
+    for (const QGeoTileIndexEntry &entry : entries) {
+        QGeoTileSpec spec = filenameToTileSpec(entry.filename);
+        if (spec.zoom() == -1 || (mapId != -1 && spec.mapId() != mapId))
+            continue;
+
+        QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
+        td->spec = spec;
+        td->filename = dir.filePath(entry.filename);
+        td->cache = this;
+        td->size = entry.size;
+        td->lastModified = entry.lastModified;
+        td->validators = entry.validators;
+
+        const int q = entry.queue - 1;
+        specs[q].append(spec);
+        tiles[q].append(td);
+        costs[q].append(costStrategyDisk_ == ByteSize ? entry.size : 1);
+    }
+
+    for (int q = 0; q < 3; ++q)
+        diskCache_.deserializeQueue(q + 1, specs[q], tiles[q], costs[q]);
+    // evicts whatever exceeds the current limit
+    diskCache_.setMaxCost(diskCache_.maxCost());
+}
+
+/*
+    Rewrites the tile index from the current state of the disk cache and
+    reopens it for appending.
+*/
+void QGeoFileTileCache::writeTileIndex()
+{
+    if (!lockTileIndex()) {
+        unlockTileIndex();
+        return;
+    }
+    // the tiles other processes added since the last sync go into the new file too
+    if (shared_)
+        replayTileIndex(false);
+    tileIndex_.close();
+
+    QSaveFile file(tileIndexFilename(directory_));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to write tile cache index " << file.fileName();
+        unlockTileIndex();
+        return;
+    }
+
+    const qint64 generation = qint64(QRandomGenerator::global()->generate64());
+    QByteArray header(tileIndexHeaderSize, Qt::Uninitialized);
+    qToLittleEndian<quint32>(tileIndexMagic, header.data());
+    qToLittleEndian<quint32>(tileIndexVersion, header.data() + 4);
+    qToLittleEndian<qint64>(generation, header.data() + 8);
+    file.write(header);
+
+    for (int q = 1; q <= 3; ++q) {
         QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        diskCache_.serializeQueue(i, queue);
-        foreach (const QSharedPointer<QGeoCachedTileDisk> &tile, queue) {
+        diskCache_.serializeQueue(q, queue);
+        // queues are serialized front (most recent) first, replay wants the oldest first
+        for (int i = queue.size() - 1; i >= 0; --i) {
+            const QSharedPointer<QGeoCachedTileDisk> &tile = queue.at(i);
             if (tile.isNull())
                 continue;
+            const QByteArray name = QFileInfo(tile->filename).fileName().toLatin1();
+            file.write(tileIndexRecord(tileIndexInsert, q, name, tile->size, tile->lastModified, tile->validators));
+        }
+    }
+
+    const qint64 size = file.pos();
+    if (file.commit()) {
+        indexPosition_.generation = generation;
+        indexPosition_.offset = size;
+    } else {
+        qWarning() << "Unable to write tile cache index " << file.fileName();
+    }
+
+    tileIndex_.setFileName(tileIndexFilename(directory_));
+    tileIndex_.open(QIODevice::WriteOnly | QIODevice::Append);
+    unlockTileIndex();
+}
+
+void QGeoFileTileCache::appendToTileIndex(const QGeoCachedTileDisk *td, bool removal)
+{
+    if (!tileIndex_.isOpen())
+        return;
+    if (!lockTileIndex()) {
+        unlockTileIndex();
+        return;
+    }
+    // another process may have rewritten the index since it was opened
+    if (shared_) {
+        tileIndex_.close();
+        tileIndex_.open(QIODevice::WriteOnly | QIODevice::Append);
+    }
+    const QByteArray name = QFileInfo(td->filename).fileName().toLatin1();
+    tileIndex_.write(tileIndexRecord(removal ? tileIndexRemove : tileIndexInsert, 1, name,
+                                     td->size, td->lastModified, td->validators));
+    // keep the log complete if the application doesn't shut down cleanly
+    tileIndex_.flush();
+    unlockTileIndex();
+}
+
+/*
+    Takes the lock on the index of a shared directory, waiting for the other
+    processes to release it. Calls nest, and each has to be paired with a call
+    to unlockTileIndex(), also when this fails. Always succeeds without sharing.
+*/
+bool QGeoFileTileCache::lockTileIndex()
+{
+    if (!indexLock_ || indexLockDepth_ > 0) {
+        ++indexLockDepth_;
+        return true;
+    }
+    if (!indexLock_->tryLock(tileIndexLockTimeout)) {
+        qWarning() << "Unable to lock tile cache index " << indexLock_->fileName();
+        return false;
+    }
+    ++indexLockDepth_;
+    return true;
+}
+
+void QGeoFileTileCache::unlockTileIndex()
+{
+    if (indexLockDepth_ == 0)
+        return;
+    if (--indexLockDepth_ == 0 && indexLock_)
+        indexLock_->unlock();
+}
 
-            // we just want the filename here, not the full path
-            int index = tile->filename.lastIndexOf(QLatin1Char('/'));
-            QByteArray filename = tile->filename.mid(index + 1).toLatin1() + '\n';
-            file.write(filename);
+// Picks up the changes the other processes made to a shared index
+void QGeoFileTileCache::syncTileIndex()
+{
+    // a rewrite replaces the file, which drops it from the watcher
+    const QString filename = tileIndexFilename(directory_);
+    if (!indexWatcher_->files().contains(filename))
+        indexWatcher_->addPath(filename);
+
+    if (lockTileIndex()) {
+        // The owner went away. This process forgot about the tiles it evicted
+        // so far, the full replay brings them back to be deleted.
+        const bool takeOver = !ownerLock_->isLocked() && ownerLock_->tryLock(0);
+        replayTileIndex(takeOver);
+    }
+    unlockTileIndex();
+}
+
+/*
+    Brings the disk cache up to date with the records the other processes
+    appended to a shared index, or with the whole index if \a full is true or
+    the index was rewritten since. The index has to be locked.
+*/
+void QGeoFileTileCache::replayTileIndex(bool full)
+{
+    QVector<QGeoTileIndexEntry> entries;
+    QSet<QString> removed;
+    QGeoTileIndexPosition position = indexPosition_;
+    if (full || !readTileIndex(&entries, nullptr, &position, &removed)) {
+        position = QGeoTileIndexPosition();
+        removed.clear();
+        if (!readTileIndex(&entries, nullptr, &position))
+            return;
+        full = true;
+    }
+    indexPosition_ = position;
+
+    // Dropped without deleting the files, which are gone already
+    if (full) {
+        QSet<QGeoTileSpec> indexed;
+        for (const QGeoTileIndexEntry &entry : qAsConst(entries))
+            indexed.insert(filenameToTileSpec(entry.filename));
+        for (const QGeoTileSpec &spec : diskCache_.keys()) {
+            if (!indexed.contains(spec))
+                diskCache_.remove(spec);
         }
-        file.close();
     }
-#endif
+    for (const QString &name : qAsConst(removed))
+        diskCache_.remove(filenameToTileSpec(name));
+
+    QVector<QGeoTileIndexEntry> added;
+    for (const QGeoTileIndexEntry &entry : qAsConst(entries)) {
+        const QGeoTileSpec spec = filenameToTileSpec(entry.filename);
+        if (diskCache_.contains(spec))
+            continue;
+        diskCache_.remove(spec); // a ghost entry would keep the tile out
+        added.append(entry);
+    }
+    insertIndexedTiles(added);
+}
+
+QGeoFileTileCache::~QGeoFileTileCache()
+{
+    if (warmStartTiles_ > 0 && isDiskCacheOwner())
+        writeWarmStartTiles();
+
+    // Results of running decodes are posted to this object, make sure none is left behind
+    for (const QSharedPointer<QGeoTileDecodeTask> &task : qAsConst(pendingDecodes_))
+        task->canceled.storeRelease(1);
+    pendingDecodes_.clear();
+    decodePool_->clear();
+    decodePool_->waitForDone();
+    flushDiskWrites();
+
+    // store the queues, so that the cache comes back in the same state;
+    // the other processes of a shared directory keep appending to it
+    if (tileIndex_.isOpen() && isDiskCacheOwner()) {
+        writeTileIndex();
+        // the tiles the rewrite picked up from them may have evicted some
+        flushDiskWrites();
+    }
+    tileIndex_.close();
+}
+
+/*
+    Stores the file names of the tiles in the texture cache, which are the
+    tiles the maps showed and prefetched last, for decodeWarmStartTiles() to
+    decode when the cache is next created.
+*/
+void QGeoFileTileCache::writeWarmStartTiles()
+{
+    QByteArray names;
+    int count = 0;
+    for (int q = 1; q <= 3 && count < warmStartTiles_; ++q) {
+        QList<QSharedPointer<QGeoTileTexture> > queue;
+        textureCache_.serializeQueue(q, queue);
+        for (int i = 0; i < queue.size() && count < warmStartTiles_; ++i) {
+            const QSharedPointer<QGeoTileTexture> &tt = queue.at(i);
+            if (tt.isNull() || tt->pending)
+                continue;
+            // only tiles that can be read back from the disk cache
+            const QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(tt->spec);
+            if (td.isNull())
+                continue;
+            names += QFileInfo(td->filename).fileName().toLatin1();
+            names += '\n';
+            ++count;
+        }
+    }
+
+    QSaveFile file(warmStartFilename(directory_));
+    if (!file.open(QIODevice::WriteOnly) || file.write(names) != names.size() || !file.commit())
+        qWarning() << "Unable to write tile cache warm start list " << file.fileName();
+}
+
+/*
+    Starts decoding the tiles stored by writeWarmStartTiles() on the decode
+    pool, so that the first frame of the maps finds their textures in the
+    texture cache instead of waiting for the tiles to be read and decoded.
+*/
+void QGeoFileTileCache::decodeWarmStartTiles()
+{
+    if (warmStartTiles_ <= 0)
+        return;
+
+    QFile file(warmStartFilename(directory_));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    const QList<QByteArray> names = file.readAll().split('\n');
+    file.close();
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int count = 0;
+    for (const QByteArray &name : names) {
+        if (count >= warmStartTiles_)
+            break;
+        if (name.isEmpty())
+            continue;
+        const QGeoTileSpec spec = filenameToTileSpec(QString::fromLatin1(name));
+        if (spec.zoom() == -1)
+            continue;
+        const QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+        if (td.isNull())
+            continue;
+        // expired tiles go through isTileUsable() once a map asks for them
+        const QGeoTileValidators &validators = td->validators;
+        if (!serveStaleTiles_ && validators.expires >= 0 && validators.canRevalidate() && validators.expires <= now)
+            continue;
+        if (!decodeAsync(spec, QByteArray(), td->filename, QFileInfo(td->filename).suffix()))
+            break;
+        ++count;
+    }
 }
 
 void QGeoFileTileCache::printStats()
@@ -258,13 +781,14 @@ int QGeoFileTileCache::diskUsage() const
 
 void QGeoFileTileCache::setMaxMemoryUsage(int memoryUsage)
 {
-    memoryCache_.setMaxCost(memoryUsage);
+    maxMemoryUsage_ = memoryUsage;
     isMemoryCostSet_ = true;
+    applyUsageLimits();
 }
 
 int QGeoFileTileCache::maxMemoryUsage() const
 {
-    return memoryCache_.maxCost();
+    return maxMemoryUsage_;
 }
 
 int QGeoFileTileCache::memoryUsage() const
@@ -275,14 +799,14 @@ int QGeoFileTileCache::memoryUsage() const
 void QGeoFileTileCache::setExtraTextureUsage(int textureUsage)
 {
     extraTextureUsage_ = textureUsage;
-    textureCache_.setMaxCost(minTextureUsage_ + extraTextureUsage_);
     isTextureCostSet_ = true;
+    applyUsageLimits();
 }
 
 void QGeoFileTileCache::setMinTextureUsage(int textureUsage)
 {
     minTextureUsage_ = textureUsage;
-    textureCache_.setMaxCost(minTextureUsage_ + extraTextureUsage_);
+    applyUsageLimits();
 }
 
 int QGeoFileTileCache::maxTextureUsage() const
@@ -306,12 +830,18 @@ void QGeoFileTileCache::clearAll()
     textureCache_.clear();
     memoryCache_.clear();
     diskCache_.clear();
-    QDir dir(directory_);
-    dir.setNameFilters(QStringList() << QLatin1String("*-*-*-*.*"));
-    dir.setFilter(QDir::Files);
-    foreach (QString dirFile, dir.entryList()) {
-        dir.remove(dirFile);
-    }
+    pendingWrites_.clear();
+    // Queued behind the pending writes, so that files still being written go as well
+    const QString directory = directory_;
+    writePool_->start(QRunnable::create([directory]() {
+        QDir dir(directory);
+        dir.setNameFilters(QStringList() << QLatin1String("*-*-*-*.*"));
+        dir.setFilter(QDir::Files);
+        foreach (QString dirFile, dir.entryList()) {
+            dir.remove(dirFile);
+        }
+    }));
+    writeTileIndex();
 }
 
 void QGeoFileTileCache::clearMapId(const int mapId)
@@ -338,8 +868,9 @@ void QGeoFileTileCache::clearMapId(const int mapId)
         QGeoTileSpec spec = filenameToTileSpec(tileFileName);
         if (spec.mapId() != mapId)
             continue;
-        QFile::remove(dir.filePath(tileFileName));
+        queueRemoval(dir.filePath(tileFileName));
     }
+    writeTileIndex();
 }
 
 void QGeoFileTileCache::setCostStrategyDisk(QAbstractGeoTileCache::CostStrategy costStrategy)
@@ -372,6 +903,293 @@ QAbstractGeoTileCache::CostStrategy QGeoFileTileCache::costStrategyTexture() con
     return costStrategyTexture_;
 }
 
+/*
+    Enables decoding tiles read from the disk or the memory cache on a worker
+    pool. get() then returns a texture with the pending flag set, and
+    tileDecoded() is emitted once the decoded image is in the texture cache.
+*/
+void QGeoFileTileCache::setAsynchronousDecoding(bool enabled)
+{
+    asynchronousDecoding_ = enabled;
+    if (!enabled)
+        cancelDecoding(QSet<QGeoTileSpec>(pendingDecodes_.keyBegin(), pendingDecodes_.keyEnd()));
+}
+
+bool QGeoFileTileCache::asynchronousDecoding() const
+{
+    return asynchronousDecoding_;
+}
+
+/*
+    Sets the number of tiles of the texture cache stored when the cache is
+    destroyed, to be decoded on the decode pool right when the cache is next
+    initialized, before any map asks for them. 0, the default, disables it.
+    Has to be set before init() for the stored tiles to be decoded.
+*/
+void QGeoFileTileCache::setWarmStartTiles(int count)
+{
+    warmStartTiles_ = qMax(0, count);
+}
+
+int QGeoFileTileCache::warmStartTiles() const
+{
+    return warmStartTiles_;
+}
+
+/*
+    Sets the maximum number of tiles waiting to be decoded. Once reached,
+    further tiles are decoded synchronously in get().
+*/
+void QGeoFileTileCache::setMaxPendingDecodes(int count)
+{
+    maxPendingDecodes_ = qMax(1, count);
+}
+
+int QGeoFileTileCache::maxPendingDecodes() const
+{
+    return maxPendingDecodes_;
+}
+
+/*
+    Sets the format tiles without transparency are kept in by the texture
+    cache. QImage::Format_RGB16 halves their cost, and so doubles the tiles
+    the cache holds, at the price of color depth. The scene graph converts them
+    back when uploading them, so the textures themselves are not smaller.
+    Tiles with transparency, and tiles already in a GPU compressed format, are
+    not affected.
+*/
+void QGeoFileTileCache::setOpaqueTextureFormat(QImage::Format format)
+{
+    opaqueTextureFormat_ = format == QImage::Format_RGB16 ? format : QImage::Format_RGB32;
+}
+
+QImage::Format QGeoFileTileCache::opaqueTextureFormat() const
+{
+    return opaqueTextureFormat_;
+}
+
+/*
+    Sets whether expired tiles are returned while they get revalidated to
+    \a serve. By default they are not, and a map shows an expired tile once
+    the server confirmed it did not change, or sent the new one. Serving them
+    shows the map right away, even from an old cache at startup, and tiles
+    that changed are then updated in the maps through
+    QGeoTiledMappingManagerEngine::tileUpdated(). Either way, expired tiles
+    are served when the server cannot be reached.
+*/
+void QGeoFileTileCache::setServeStaleTiles(bool serve)
+{
+    serveStaleTiles_ = serve;
+}
+
+bool QGeoFileTileCache::serveStaleTiles() const
+{
+    return serveStaleTiles_;
+}
+
+/*
+    Sets whether the memory and texture caches, once full, only take tiles
+    requested more often than the ones they would evict, to \a enabled.
+    This keeps tiles seen once, while panning across a large area, from
+    pushing out the tiles of the area the map usually shows. Off by default.
+*/
+void QGeoFileTileCache::setAdmissionFilter(bool enabled)
+{
+    memoryCache_.setAdmissionFilter(enabled);
+    textureCache_.setAdmissionFilter(enabled);
+}
+
+bool QGeoFileTileCache::admissionFilter() const
+{
+    return textureCache_.admissionFilter();
+}
+
+QCache3QStatistics QGeoFileTileCache::statistics(CacheArea area) const
+{
+    switch (area) {
+    case DiskCache:
+        return diskCache_.statistics();
+    case MemoryCache:
+        return memoryCache_.statistics();
+    case TextureCache:
+        return textureCache_.statistics();
+    default:
+        return QCache3QStatistics();
+    }
+}
+
+/*
+    Under moderate memory pressure, such as while the application is hidden,
+    the texture cache is shrunk to textureUsageFloor(). Under critical
+    pressure, typically once the application is suspended, the memory cache
+    is shrunk to memoryUsageFloor() as well. The cached tiles above the
+    floors are released right away, and the configured limits come back
+    once the pressure is gone. The disk cache is never affected.
+*/
+void QGeoFileTileCache::setMemoryPressure(MemoryPressure pressure)
+{
+    if (pressure == memoryPressure_)
+        return;
+    QAbstractGeoTileCache::setMemoryPressure(pressure);
+    applyUsageLimits();
+}
+
+/*
+    Sets the texture cache size under memory pressure to \a textureUsage.
+    A negative value, the default, keeps minTextureUsage(), which is what
+    the maps need for the tiles in view.
+*/
+void QGeoFileTileCache::setTextureUsageFloor(int textureUsage)
+{
+    textureUsageFloor_ = textureUsage;
+    applyUsageLimits();
+}
+
+int QGeoFileTileCache::textureUsageFloor() const
+{
+    return textureUsageFloor_ < 0 ? minTextureUsage_ : textureUsageFloor_;
+}
+
+/*
+    Sets the memory cache size under critical memory pressure to
+    \a memoryUsage. The default is 0.
+*/
+void QGeoFileTileCache::setMemoryUsageFloor(int memoryUsage)
+{
+    memoryUsageFloor_ = qMax(0, memoryUsage);
+    applyUsageLimits();
+}
+
+int QGeoFileTileCache::memoryUsageFloor() const
+{
+    return memoryUsageFloor_;
+}
+
+/*
+    Sets whether several processes use the cache directory at the same time
+    to \a shared, before the cache is initialized. They then record their
+    tiles in one index, under a file lock, and pick up the tiles the others
+    download as soon as these are written. Only one process, the first one to
+    use the directory, deletes files, so that its disk usage limit applies;
+    the others merely forget about the tiles they evict. Once the owner quits,
+    the next process to notice a change of the index takes over.
+*/
+void QGeoFileTileCache::setShared(bool shared)
+{
+    shared_ = shared;
+}
+
+bool QGeoFileTileCache::isShared() const
+{
+    return shared_;
+}
+
+// Whether this cache deletes the files it evicts, always the case without sharing
+bool QGeoFileTileCache::isDiskCacheOwner() const
+{
+    return !shared_ || (ownerLock_ && ownerLock_->isLocked());
+}
+
+// The most the maps may reserve in the texture cache for what they show, an eighth of the device memory
+static int textureMemoryBudget()
+{
+    static const qint64 budget = QGeoMemoryPressureMonitor::physicalMemory() / 8;
+    return budget > 0 ? int(qMin<qint64>(budget, std::numeric_limits<int>::max())) : std::numeric_limits<int>::max();
+}
+
+void QGeoFileTileCache::applyUsageLimits()
+{
+    int minTextureUsage = minTextureUsage_;
+    if (costStrategyTexture_ == ByteSize)
+        minTextureUsage = qMin(minTextureUsage, textureMemoryBudget());
+    int textureUsage = int(qMin<qint64>(qint64(minTextureUsage) + extraTextureUsage_,
+                                        std::numeric_limits<int>::max()));
+    int memoryUsage = maxMemoryUsage_;
+    if (memoryPressure_ != NoMemoryPressure)
+        textureUsage = qMin(textureUsage, textureUsageFloor());
+    if (memoryPressure_ == CriticalMemoryPressure)
+        memoryUsage = qMin(memoryUsage, memoryUsageFloor_);
+
+    if (textureCache_.maxCost() != textureUsage)
+        textureCache_.setMaxCost(textureUsage);
+    if (memoryCache_.maxCost() != memoryUsage)
+        memoryCache_.setMaxCost(memoryUsage);
+
+    QGeoMapStatistics::setGauge(QGeoMapStatistics::TextureCacheMinimum, minTextureUsage);
+    QGeoMapStatistics::setGauge(QGeoMapStatistics::TextureCacheLimit, textureUsage);
+    QGeoMapStatistics::setGauge(QGeoMapStatistics::MemoryCacheLimit, memoryUsage);
+}
+
+bool QGeoFileTileCache::contains(const QGeoTileSpec &spec, CacheArea area) const
+{
+    switch (area) {
+    case DiskCache:
+        return diskCache_.contains(spec);
+    case MemoryCache:
+        return memoryCache_.contains(spec);
+    case TextureCache:
+        return textureCache_.contains(spec);
+    default:
+        return false;
+    }
+}
+
+void QGeoFileTileCache::cancelDecoding(const QSet<QGeoTileSpec> &tiles)
+{
+    for (const QGeoTileSpec &spec : tiles) {
+        QSharedPointer<QGeoTileDecodeTask> task = pendingDecodes_.take(spec);
+        if (task)
+            task->canceled.storeRelease(1);
+    }
+}
+
+/*
+    Stores \a validators with the tile on disk, persisted in the tile index.
+    Validators a "304 Not Modified" answer leaves out are kept.
+*/
+void QGeoFileTileCache::setTileValidators(const QGeoTileSpec &spec, const QGeoTileValidators &validators)
+{
+    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+    if (!td)
+        return;
+
+    if (!validators.entityTag.isEmpty())
+        td->validators.entityTag = validators.entityTag;
+    if (!validators.lastModified.isEmpty())
+        td->validators.lastModified = validators.lastModified;
+    td->validators.expires = validators.expires;
+    td->revalidating = false;
+    td->validated = true;
+    appendToTileIndex(td.data(), false);
+}
+
+void QGeoFileTileCache::revalidationFailed(const QGeoTileSpec &spec)
+{
+    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+    if (!td)
+        return;
+    td->revalidating = false;
+    td->validated = true;
+}
+
+/*
+    Emits tileExpired() the first time the expired tile \a td is read, and
+    returns whether it may be used meanwhile. Tiles without validators never
+    expire, as they could only be downloaded again.
+*/
+bool QGeoFileTileCache::isTileUsable(QGeoCachedTileDisk *td)
+{
+    if (td->validated || td->validators.expires < 0 || !td->validators.canRevalidate()
+            || td->validators.expires > QDateTime::currentMSecsSinceEpoch())
+        return true;
+
+    if (!td->revalidating) {
+        td->revalidating = true;
+        emit tileExpired(td->spec, td->validators);
+    }
+    return serveStaleTiles_;
+}
+
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
 {
     QSharedPointer<QGeoTileTexture> tt = getFromMemory(spec);
@@ -380,6 +1198,11 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
     return getFromDisk(spec);
 }
 
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getDecoded(const QGeoTileSpec &spec)
+{
+    return textureCache_.object(spec);
+}
+
 void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
                            const QByteArray &bytes,
                            const QString &format,
@@ -397,6 +1220,9 @@ void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
         addToMemoryCache(spec, bytes, format);
     }
 
+    // a revalidated tile that changed
+    textureCache_.remove(spec);
+
     /* inserts do not hit the texture cache -- this actually reduces overall
      * cache hit rates because many tiles come too late to be useful
      * and act as a poison */
@@ -469,6 +1295,15 @@ QGeoTileSpec QGeoFileTileCache::filenameToTileSpecDefault(const QString &filenam
 
 void QGeoFileTileCache::evictFromDiskCache(QGeoCachedTileDisk *td)
 {
+    if (td->cache) {
+        td->cache->pendingWrites_.remove(td->filename);
+        // the other processes sharing the directory may still use it
+        if (!td->cache->isDiskCacheOwner())
+            return;
+        td->cache->appendToTileIndex(td, true);
+        td->cache->queueRemoval(td->filename);
+        return;
+    }
     QFile::remove(td->filename);
 }
 
@@ -483,11 +1318,17 @@ QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoT
     td->filename = filename;
     td->cache = this;
 
+    // on its way out, the file is only still there because the removal is queued
+    if (pendingRemovals_.contains(filename))
+        return QSharedPointer<QGeoCachedTileDisk>();
+
+    QFileInfo fi(filename);
+    td->size = fi.size();
+    td->lastModified = fi.lastModified().toMSecsSinceEpoch();
+
     int cost = 1;
-    if (costStrategyDisk_ == ByteSize) {
-        QFileInfo fi(filename);
-        cost = fi.size();
-    }
+    if (costStrategyDisk_ == ByteSize)
+        cost = td->size;
     diskCache_.insert(spec, td, cost);
     return td;
 }
@@ -498,21 +1339,85 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
     td->spec = spec;
     td->filename = filename;
     td->cache = this;
+    td->size = bytes.size();
+    td->lastModified = QDateTime::currentMSecsSinceEpoch();
 
     int cost = 1;
     if (costStrategyDisk_ == ByteSize)
         cost = bytes.size();
 
     if (diskCache_.insert(spec, td, cost)) {
-        QFile file(filename);
-        file.open(QIODevice::WriteOnly);
-        file.write(bytes);
-        file.close();
+        // an eviction of the same file may still be collected, it must not run after the write
+        pendingRemovals_.remove(filename);
+        // Written by writePool_, reads are served from pendingWrites_ meanwhile.
+        // bytes is shared with the network reply and the memory cache, not copied.
+        pendingWrites_.insert(filename, bytes);
+        // The other processes sharing the directory learn about the tile from
+        // the index, so the record goes in once the file can be read
+        const QString directory = directory_;
+        QByteArray record;
+        if (shared_ && tileIndex_.isOpen()) {
+            record = tileIndexRecord(tileIndexInsert, 1, QFileInfo(filename).fileName().toLatin1(),
+                                     td->size, td->lastModified, td->validators);
+        }
+        // the destructor waits for the writes, replies posted after it are dropped
+        QGeoFileTileCache *cache = this;
+        writePool_->start(QRunnable::create([cache, filename, bytes, directory, record]() {
+            QFile file(filename);
+            if (file.open(QIODevice::WriteOnly))
+                file.write(bytes);
+            file.close();
+            if (!record.isEmpty())
+                appendToSharedTileIndex(directory, record);
+            QMetaObject::invokeMethod(cache, [cache, filename, bytes]() {
+                cache->writeFinished(filename, bytes);
+            }, Qt::QueuedConnection);
+        }));
+        if (!shared_)
+            appendToTileIndex(td.data(), false);
         return true;
     }
     return false;
 }
 
+void QGeoFileTileCache::writeFinished(const QString &filename, const QByteArray &bytes)
+{
+    // unless the tile was written again or evicted since
+    auto it = pendingWrites_.find(filename);
+    if (it != pendingWrites_.end() && it->constData() == bytes.constData())
+        pendingWrites_.erase(it);
+}
+
+// Removals are collected while the event loop is busy, and unlinked by a single
+// writePool_ task. The task lands behind every write queued so far, so a file
+// evicted before its write completed is still removed.
+void QGeoFileTileCache::queueRemoval(const QString &filename)
+{
+    if (pendingRemovals_.isEmpty())
+        QMetaObject::invokeMethod(this, &QGeoFileTileCache::flushRemovals, Qt::QueuedConnection);
+    pendingRemovals_.insert(filename);
+}
+
+void QGeoFileTileCache::flushRemovals()
+{
+    if (pendingRemovals_.isEmpty())
+        return;
+    const QSet<QString> filenames = std::move(pendingRemovals_);
+    pendingRemovals_.clear();
+    writePool_->start(QRunnable::create([filenames]() {
+        for (const QString &filename : filenames)
+            QFile::remove(filename);
+    }));
+}
+
+// Completes the writes and removals still queued, for an orderly shutdown
+void QGeoFileTileCache::flushDiskWrites()
+{
+    flushRemovals();
+    writePool_->waitForDone();
+    pendingWrites_.clear();
+}
+
 void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format)
 {
     if (isTileBogus(bytes))
@@ -523,6 +1428,7 @@ void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteAr
     tm->cache = this;
     tm->bytes = bytes;
     tm->format = format;
+    tm->memory.setBytes(bytes.size());
 
     int cost = 1;
     if (costStrategyMemory_ == ByteSize)
@@ -530,16 +1436,32 @@ void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteAr
     memoryCache_.insert(spec, tm, cost);
 }
 
-QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image)
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image, bool force)
 {
     QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
     tt->spec = spec;
     tt->image = image;
+    tt->memory.setBytes(tt->byteSize());
+
+    int cost = 1;
+    if (costStrategyTexture_ == ByteSize)
+        cost = int(tt->byteSize());
+    textureCache_.insert(spec, tt, cost, force);
+
+    return tt;
+}
+
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QTextureFileData &compressed, bool force)
+{
+    QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+    tt->spec = spec;
+    tt->compressed = compressed;
+    tt->memory.setBytes(tt->byteSize());
 
     int cost = 1;
     if (costStrategyTexture_ == ByteSize)
-        cost = image.width() * image.height() * image.depth() / 8;
-    textureCache_.insert(spec, tt, cost);
+        cost = int(tt->byteSize());
+    textureCache_.insert(spec, tt, cost, force);
 
     return tt;
 }
@@ -547,17 +1469,32 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoT
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileSpec &spec)
 {
     QSharedPointer<QGeoTileTexture> tt = textureCache_.object(spec);
-    if (tt)
+    if (tt) {
+        QGeoMapStatistics::count(QGeoMapStatistics::TextureCacheHit);
         return tt;
+    }
 
     QSharedPointer<QGeoCachedTileMemory> tm = memoryCache_.object(spec);
     if (tm) {
+        // the expiry is kept with the tile on disk
+        QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+        if (td && !isTileUsable(td.data()))
+            return QSharedPointer<QGeoTileTexture>();
+        QGeoMapStatistics::count(QGeoMapStatistics::MemoryCacheHit);
+        if (asynchronousDecoding_) {
+            QSharedPointer<QGeoTileTexture> pending = decodeAsync(spec, tm->bytes, QString(), tm->format);
+            if (pending)
+                return pending;
+        }
+
         QImage image;
-        if (!image.loadFromData(tm->bytes)) {
+        QTextureFileData compressed;
+        if (!decodeTileImage(tm->bytes, &image, &compressed, opaqueTextureFormat_, tm->format)) {
             handleError(spec, QLatin1String("Problem with tile image"));
             return QSharedPointer<QGeoTileTexture>(0);
         }
-        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(spec, image);
+        QSharedPointer<QGeoTileTexture> tt = compressed.isValid() ? addToTextureCache(spec, compressed)
+                                                                  : addToTextureCache(spec, image);
         if (tt)
             return tt;
     }
@@ -567,12 +1504,31 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileS
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpec &spec)
 {
     QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+    QByteArray bytes = td ? pendingWrites_.value(td->filename) : QByteArray();
+    // deleted by the owner of a shared directory, the removal record is on its way
+    if (td && shared_ && bytes.isEmpty() && !QFileInfo::exists(td->filename)) {
+        diskCache_.remove(spec);
+        td.reset();
+    }
     if (td) {
+        if (!isTileUsable(td.data()))
+            return QSharedPointer<QGeoTileTexture>();
+        QGeoMapStatistics::count(QGeoMapStatistics::DiskCacheHit);
         const QString format = QFileInfo(td->filename).suffix();
-        QFile file(td->filename);
-        file.open(QIODevice::ReadOnly);
-        QByteArray bytes = file.readAll();
-        file.close();
+        if (asynchronousDecoding_) {
+            QSharedPointer<QGeoTileTexture> pending = bytes.isEmpty()
+                    ? decodeAsync(spec, QByteArray(), td->filename, format)
+                    : decodeAsync(spec, bytes, QString(), format);
+            if (pending)
+                return pending;
+        }
+
+        if (bytes.isEmpty()) {
+            QFile file(td->filename);
+            file.open(QIODevice::ReadOnly);
+            bytes = file.readAll();
+            file.close();
+        }
 
         QImage image;
         // Some tiles from the servers could be valid images but the tile fetcher
@@ -586,24 +1542,122 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
         }
 
         // This is a truly invalid image. The fetcher should try again.
-        if (!image.loadFromData(bytes)) {
+        QTextureFileData compressed;
+        if (!decodeTileImage(bytes, &image, &compressed, opaqueTextureFormat_, format)) {
             handleError(spec, QLatin1String("Problem with tile image"));
             return QSharedPointer<QGeoTileTexture>(0);
         }
 
-        // Converting it here, instead of in each QSGTexture::bind()
-        if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
-            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-
         addToMemoryCache(spec, bytes, format);
-        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(td->spec, image);
+        QSharedPointer<QGeoTileTexture> tt = compressed.isValid() ? addToTextureCache(td->spec, compressed)
+                                                                  : addToTextureCache(td->spec, image);
         if (tt)
             return tt;
     }
 
+    QGeoMapStatistics::count(QGeoMapStatistics::CacheMiss);
     return QSharedPointer<QGeoTileTexture>();
 }
 
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::decodeAsync(const QGeoTileSpec &spec, const QByteArray &bytes,
+                                                               const QString &filename, const QString &format)
+{
+    QSharedPointer<QGeoTileDecodeTask> task = pendingDecodes_.value(spec);
+    if (task)
+        return task->texture;
+
+    // Bounded: past this point the caller decodes synchronously
+    if (pendingDecodes_.size() >= maxPendingDecodes_)
+        return QSharedPointer<QGeoTileTexture>();
+
+    task = QSharedPointer<QGeoTileDecodeTask>(new QGeoTileDecodeTask);
+    task->spec = spec;
+    task->filename = filename;
+    task->bytes = bytes;
+    task->format = format;
+    task->opaqueFormat = opaqueTextureFormat_;
+    task->texture = QSharedPointer<QGeoTileTexture>(new QGeoTileTexture);
+    task->texture->spec = spec;
+    task->texture->pending = true;
+    pendingDecodes_.insert(spec, task);
+
+    decodePool_->start(new QGeoTileDecodeRunnable(this, task));
+    return task->texture;
+}
+
+void QGeoFileTileCache::decodeFinished(const QSharedPointer<QGeoTileDecodeTask> &task, const QByteArray &bytes,
+                                       const QImage &image, const QTextureFileData &compressed,
+                                       bool decoded, bool bogus)
+{
+    // Cancelled while the decode was running
+    if (pendingDecodes_.value(task->spec) != task)
+        return;
+    pendingDecodes_.remove(task->spec);
+
+    if (!decoded) {
+        // This is a truly invalid image. The fetcher should try again.
+        handleError(task->spec, QLatin1String("Problem with tile image"));
+        emit tileDecoded(task->spec, false);
+        return;
+    }
+
+    if (bogus) {
+        // Keep the empty texture around, otherwise the next get() would just decode it again
+        QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+        tt->spec = task->spec;
+        textureCache_.insert(task->spec, tt, 1, true);
+    } else {
+        if (!task->filename.isEmpty())
+            addToMemoryCache(task->spec, bytes, task->format);
+        // the maps fetch the texture from the cache once notified, it has to be there
+        if (compressed.isValid())
+            addToTextureCache(task->spec, compressed, true);
+        else
+            addToTextureCache(task->spec, image, true);
+    }
+    emit tileDecoded(task->spec, true);
+}
+
+/*
+    Decodes \a bytes into \a image, already converted to the format the scene
+    graph uploads without further conversion, or to \a opaqueFormat for tiles
+    without transparency. Tiles in a texture file format, such as KTX files of
+    ETC2 or ASTC data, are instead read into \a compressed when given, to be
+    uploaded as they are. \a format, the suffix the tile is stored with, picks
+    the decoder without probing the data first; the data is only probed when
+    it turns out not to be in that format. Safe to call from any thread.
+*/
+bool QGeoFileTileCache::decodeTileImage(const QByteArray &bytes, QImage *image, QTextureFileData *compressed,
+                                        QImage::Format opaqueFormat, const QString &format)
+{
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::TileDecode);
+    const QByteArray imageFormat = format.toLatin1().toLower();
+    const bool textureFile = imageFormat.isEmpty() || imageFormat == "ktx" || imageFormat == "pkm"
+            || imageFormat == "astc";
+    QBuffer buffer;
+    buffer.setData(bytes);
+    buffer.open(QIODevice::ReadOnly);
+    if (compressed && textureFile) {
+        QTextureFileReader reader(&buffer);
+        if (reader.canRead()) {
+            *compressed = reader.read();
+            return compressed->isValid();
+        }
+        buffer.seek(0);
+    }
+
+    QImageReader reader(&buffer, textureFile ? QByteArray() : imageFormat);
+    if (!reader.read(image))
+        return false;
+
+    // Converting it here, instead of in each QSGTexture::bind()
+    if (opaqueFormat != QImage::Format_RGB32 && !image->hasAlphaChannel())
+        *image = image->convertToFormat(opaqueFormat);
+    else if (image->format() != QImage::Format_RGB32 && image->format() != QImage::Format_ARGB32_Premultiplied)
+        *image = image->convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    return true;
+}
+
 bool QGeoFileTileCache::isTileBogus(const QByteArray &bytes) const
 {
     if (bytes.size() == 7 && bytes == QByteArrayLiteral("NoRetry"))
@@ -55,6 +55,8 @@
 #include <QSet>
 #include <QMutex>
 #include <QTimer>
+#include <QFile>
+#include <QScopedPointer>
 
 #include "qgeotilespec_p.h"
 #include "qgeotiledmappingmanagerengine_p.h"
@@ -69,21 +71,52 @@ class QGeoMappingManager;
 class QGeoTile;
 class QGeoCachedTileMemory;
 class QGeoFileTileCache;
+class QGeoTileDecodeTask;
 
 class QPixmap;
 class QThread;
+class QThreadPool;
+class QLockFile;
+class QFileSystemWatcher;
 
 /* This would be internal to qgeofiletilecache.cpp except that the eviction
  * policy can't be defined without it being concrete here */
 class QGeoCachedTileDisk
 {
 public:
+    QGeoCachedTileDisk();
     ~QGeoCachedTileDisk();
 
     QGeoTileSpec spec;
     QString filename;
     QString format;
     QGeoFileTileCache *cache;
+    int size;
+    qint64 lastModified; // msecs since epoch
+    QGeoTileValidators validators;
+    bool revalidating; // tileExpired() was emitted, waiting for setTileValidators()
+    bool validated;    // revalidated, or failed to, during this session
+};
+
+/* One live entry of the persistent tile index, see QGeoFileTileCache::readTileIndex() */
+class QGeoTileIndexEntry
+{
+public:
+    QString filename; // relative to the cache directory
+    int size;
+    int queue;        // QCache3Q queue the tile was in, 1 to 3
+    qint64 lastModified;
+    QGeoTileValidators validators;
+};
+
+/* How far the tile index has been replayed, see QGeoFileTileCache::syncTileIndex() */
+class QGeoTileIndexPosition
+{
+public:
+    QGeoTileIndexPosition() : generation(0), offset(0) {}
+
+    qint64 generation; // changes whenever the index is rewritten
+    qint64 offset;     // 0 to replay from the start
 };
 
 /* Custom eviction policy for the disk cache, to avoid deleting all the files
@@ -124,8 +157,34 @@ public:
     void setCostStrategyTexture(CostStrategy costStrategy) override;
     CostStrategy costStrategyTexture() const override;
 
+    void setAsynchronousDecoding(bool enabled);
+    bool asynchronousDecoding() const;
+    void setMaxPendingDecodes(int count);
+    int maxPendingDecodes() const;
+    void setOpaqueTextureFormat(QImage::Format format);
+    QImage::Format opaqueTextureFormat() const;
+    void cancelDecoding(const QSet<QGeoTileSpec> &tiles) override;
+    void setServeStaleTiles(bool serve);
+    bool serveStaleTiles() const;
+    void setAdmissionFilter(bool enabled);
+    bool admissionFilter() const;
+    void setWarmStartTiles(int count);
+    int warmStartTiles() const;
+    QCache3QStatistics statistics(CacheArea area) const override;
+    bool contains(const QGeoTileSpec &spec, CacheArea area) const override;
+    void setMemoryPressure(MemoryPressure pressure) override;
+    void setTextureUsageFloor(int textureUsage);
+    int textureUsageFloor() const;
+    void setMemoryUsageFloor(int memoryUsage);
+    int memoryUsageFloor() const;
+    void setShared(bool shared);
+    bool isShared() const;
+    bool isDiskCacheOwner() const;
+    void setTileValidators(const QGeoTileSpec &spec, const QGeoTileValidators &validators) override;
+    void revalidationFailed(const QGeoTileSpec &spec) override;
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+    QSharedPointer<QGeoTileTexture> getDecoded(const QGeoTileSpec &spec) override;
 
     // can be called without a specific tileCache pointer
     static void evictFromDiskCache(QGeoCachedTileDisk *td);
@@ -146,12 +205,39 @@ protected:
 
     QString directory() const;
 
+    bool readTileIndex(QVector<QGeoTileIndexEntry> *entries, int *recordCount = nullptr,
+                       QGeoTileIndexPosition *position = nullptr, QSet<QString> *removed = nullptr) const;
+    void insertIndexedTiles(const QVector<QGeoTileIndexEntry> &entries, int mapId = -1);
+    void writeTileIndex();
+    void applyUsageLimits();
+    void appendToTileIndex(const QGeoCachedTileDisk *td, bool removal);
+    bool lockTileIndex();
+    void unlockTileIndex();
+    void syncTileIndex();
+    void replayTileIndex(bool full);
+    void writeWarmStartTiles();
+    void decodeWarmStartTiles();
+
     QSharedPointer<QGeoCachedTileDisk> addToDiskCache(const QGeoTileSpec &spec, const QString &filename);
     bool addToDiskCache(const QGeoTileSpec &spec, const QString &filename, const QByteArray &bytes);
+    void writeFinished(const QString &filename, const QByteArray &bytes);
+    void queueRemoval(const QString &filename);
+    void flushRemovals();
+    void flushDiskWrites();
     void addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
-    QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image);
+    QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image, bool force = false);
+    QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QTextureFileData &compressed,
+                                                      bool force = false);
     QSharedPointer<QGeoTileTexture> getFromMemory(const QGeoTileSpec &spec);
     QSharedPointer<QGeoTileTexture> getFromDisk(const QGeoTileSpec &spec);
+    bool isTileUsable(QGeoCachedTileDisk *td);
+    QSharedPointer<QGeoTileTexture> decodeAsync(const QGeoTileSpec &spec, const QByteArray &bytes,
+                                                const QString &filename, const QString &format);
+    void decodeFinished(const QSharedPointer<QGeoTileDecodeTask> &task, const QByteArray &bytes,
+                        const QImage &image, const QTextureFileData &compressed, bool decoded, bool bogus);
+    static bool decodeTileImage(const QByteArray &bytes, QImage *image, QTextureFileData *compressed = nullptr,
+                                QImage::Format opaqueFormat = QImage::Format_RGB32,
+                                const QString &format = QString());
 
     virtual bool isTileBogus(const QByteArray &bytes) const;
     virtual QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const;
@@ -162,15 +248,41 @@ protected:
     QCache3Q<QGeoTileSpec, QGeoTileTexture > textureCache_;
 
     QString directory_;
+    QFile tileIndex_;
+    QGeoTileIndexPosition indexPosition_;
+
+    // Shared directory, see setShared()
+    bool shared_;
+    QScopedPointer<QLockFile> ownerLock_; // held by the process that deletes files
+    QScopedPointer<QLockFile> indexLock_; // held while appending to or rewriting the index
+    int indexLockDepth_;
+    QFileSystemWatcher *indexWatcher_;
+    QTimer *indexSyncTimer_;
+
+    QThreadPool *decodePool_;
+    QThreadPool *writePool_; // one thread, so that writes and removals happen in order
+    QHash<QString, QByteArray> pendingWrites_; // by file name, shared with the write tasks
+    QSet<QString> pendingRemovals_; // unlinked together by the next flushRemovals()
+    QHash<QGeoTileSpec, QSharedPointer<QGeoTileDecodeTask> > pendingDecodes_;
+    bool asynchronousDecoding_;
+    int maxPendingDecodes_;
+    QImage::Format opaqueTextureFormat_;
+    bool serveStaleTiles_;
+    int warmStartTiles_;
 
     int minTextureUsage_;
     int extraTextureUsage_;
+    int maxMemoryUsage_;
+    int textureUsageFloor_; // limits under memory pressure, see setMemoryPressure()
+    int memoryUsageFloor_;
     CostStrategy costStrategyDisk_;
     CostStrategy costStrategyMemory_;
     CostStrategy costStrategyTexture_;
     bool isDiskCostSet_;
     bool isMemoryCostSet_;
     bool isTextureCostSet_;
+
+    friend class QGeoTileDecodeRunnable;
 };
 
 QT_END_NAMESPACE
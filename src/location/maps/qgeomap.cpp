@@ -44,6 +44,7 @@
 #include <QtQuick/private/qquickitem_p.h>
 #include <QDebug>
 #include <QRectF>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -171,6 +172,27 @@ const QGeoMapType QGeoMap::activeMapType() const
     return d->m_activeMapType;
 }
 
+/*
+    Sets the map types drawn over the active map type, in order, to
+    \a mapTypes. Only maps with the SupportsOverlayMapTypes capability draw
+    them; their tiles are expected to be partly transparent, and of the same
+    plugin and tile size as the active map type.
+*/
+void QGeoMap::setOverlayMapTypes(const QList<QGeoMapType> &mapTypes)
+{
+    Q_D(QGeoMap);
+    if (mapTypes == d->m_overlayMapTypes)
+        return;
+    d->m_overlayMapTypes = mapTypes;
+    d->changeOverlayMapTypes(mapTypes);
+}
+
+QList<QGeoMapType> QGeoMap::overlayMapTypes() const
+{
+    Q_D(const QGeoMap);
+    return d->m_overlayMapTypes;
+}
+
 double QGeoMap::minimumZoom() const
 {
     Q_D(const QGeoMap);
@@ -223,6 +245,47 @@ void QGeoMap::prefetchData()
 
 }
 
+/*
+    Hints that the camera is being animated towards \a target, for example by
+    a kinetic flick. Maps may use it to prefetch data along the way.
+*/
+void QGeoMap::prefetchTrajectory(const QGeoCameraData &target)
+{
+    Q_UNUSED(target)
+}
+
+/*
+    Hints that the camera is being moved continuously, for example by a
+    gesture, if \a paced is true. Maps may then defer the work following
+    camera changes to prepareFrame(), so that it is done once per frame.
+    Turning it off catches up with the changes right away.
+*/
+void QGeoMap::setFramePacing(bool paced)
+{
+    Q_UNUSED(paced)
+}
+
+/*
+    Called once per frame of the window showing the map, before the frame is
+    synchronized with the scene graph. Maps deferring work in setFramePacing()
+    do it here; the default implementation does nothing.
+*/
+void QGeoMap::prepareFrame()
+{
+}
+
+/*
+    Hints that the camera is going to follow \a path, for example a route
+    being navigated, starting at the current position. Maps may use it to
+    prefetch data within \a radius meters of the path. An empty path clears
+    the hint.
+*/
+void QGeoMap::prefetchCorridor(const QList<QGeoCoordinate> &path, double radius)
+{
+    Q_UNUSED(path)
+    Q_UNUSED(radius)
+}
+
 void QGeoMap::clearData()
 {
 
@@ -263,7 +326,8 @@ QGeoMap::ItemTypes QGeoMap::supportedMapItemTypes() const
 void QGeoMap::addMapItem(QDeclarativeGeoMapItemBase *item)
 {
     Q_D(QGeoMap);
-    if (item && !d->m_mapItems.contains(item) && d->supportedMapItemTypes() & item->itemType()) {
+    if (item && !d->m_mapItemIndices.contains(item) && d->supportedMapItemTypes() & item->itemType()) {
+        d->m_mapItemIndices.insert(item, d->m_mapItems.size());
         d->m_mapItems.append(item);
         d->addMapItem(item);
     }
@@ -272,18 +336,72 @@ void QGeoMap::addMapItem(QDeclarativeGeoMapItemBase *item)
 void QGeoMap::removeMapItem(QDeclarativeGeoMapItemBase *item)
 {
     Q_D(QGeoMap);
-    if (item && d->m_mapItems.contains(item)) {
-        d->removeMapItem(item);
-        d->m_mapItems.removeOne(item);
+    const auto it = d->m_mapItemIndices.constFind(item);
+    if (!item || it == d->m_mapItemIndices.constEnd())
+        return;
+
+    d->removeMapItem(item);
+    d->m_mapItems[it.value()] = nullptr;
+    d->m_mapItemIndices.erase(it);
+    ++d->m_removedMapItems;
+    d->compactMapItems();
+}
+
+/*
+    Adds the supported items of \a items, notifying the implementation once.
+*/
+void QGeoMap::addMapItems(const QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    Q_D(QGeoMap);
+    QList<QDeclarativeGeoMapItemBase *> added;
+    added.reserve(items.size());
+    const ItemTypes supported = d->supportedMapItemTypes();
+    for (QDeclarativeGeoMapItemBase *item : items) {
+        if (!item || !(supported & item->itemType()) || d->m_mapItemIndices.contains(item))
+            continue;
+        d->m_mapItemIndices.insert(item, d->m_mapItems.size());
+        d->m_mapItems.append(item);
+        added.append(item);
     }
+    if (!added.isEmpty())
+        d->addMapItems(added);
+}
+
+void QGeoMap::removeMapItems(const QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    Q_D(QGeoMap);
+    QList<QDeclarativeGeoMapItemBase *> removed;
+    QVector<int> indices;
+    removed.reserve(items.size());
+    indices.reserve(items.size());
+    for (QDeclarativeGeoMapItemBase *item : items) {
+        const auto it = d->m_mapItemIndices.constFind(item);
+        if (!item || it == d->m_mapItemIndices.constEnd())
+            continue;
+        removed.append(item);
+        indices.append(it.value());
+        d->m_mapItemIndices.erase(it);
+    }
+    if (removed.isEmpty())
+        return;
+
+    d->removeMapItems(removed);
+    for (int index : qAsConst(indices))
+        d->m_mapItems[index] = nullptr;
+    d->m_removedMapItems += indices.size();
+    d->compactMapItems();
 }
 
 void QGeoMap::clearMapItems()
 {
     Q_D(QGeoMap);
-    for (QDeclarativeGeoMapItemBase *p : d->m_mapItems)
-        d->removeMapItem(p);
+    for (QDeclarativeGeoMapItemBase *p : qAsConst(d->m_mapItems)) {
+        if (p)
+            d->removeMapItem(p);
+    }
     d->m_mapItems.clear();
+    d->m_mapItemIndices.clear();
+    d->m_removedMapItems = 0;
 }
 
 /*!
@@ -311,6 +429,11 @@ QList<QObject *> QGeoMap::mapObjectsAt(const QGeoCoordinate &/*coordinate*/) con
     return QList<QObject *>();
 }
 
+QList<QObject *> QGeoMap::mapObjectsIn(const QGeoShape &/*region*/) const
+{
+    return QList<QObject *>();
+}
+
 void QGeoMap::setItemToWindowTransform(const QTransform &itemToWindowTransform)
 {
     Q_D(QGeoMap);
@@ -423,6 +546,33 @@ void QGeoMapPrivate::removeMapItem(QDeclarativeGeoMapItemBase *item)
     Q_UNUSED(item);
 }
 
+void QGeoMapPrivate::addMapItems(const QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    for (QDeclarativeGeoMapItemBase *item : items)
+        addMapItem(item);
+}
+
+void QGeoMapPrivate::removeMapItems(const QList<QDeclarativeGeoMapItemBase *> &items)
+{
+    for (QDeclarativeGeoMapItemBase *item : items)
+        removeMapItem(item);
+}
+
+/*
+    Drops the slots of removed items once they are the majority, so that
+    removing items keeps taking constant time on average.
+*/
+void QGeoMapPrivate::compactMapItems()
+{
+    if (m_removedMapItems < 16 || m_removedMapItems * 2 < m_mapItems.size())
+        return;
+
+    m_mapItems.removeAll(nullptr);
+    for (int i = 0; i < m_mapItems.size(); ++i)
+        m_mapItemIndices[m_mapItems.at(i)] = i;
+    m_removedMapItems = 0;
+}
+
 QGeoMapObjectPrivate *QGeoMapPrivate::createMapObjectImplementation(QGeoMapObject *obj)
 {
     Q_UNUSED(obj);
@@ -448,6 +598,11 @@ double QGeoMapPrivate::mapHeight() const
     return 0; // override this for maps supporting other projections
 }
 
+void QGeoMapPrivate::changeOverlayMapTypes(const QList<QGeoMapType> &/*mapTypes*/)
+{
+    // overlays are only drawn by maps with QGeoMap::SupportsOverlayMapTypes
+}
+
 void QGeoMapPrivate::setCopyrightVisible(bool visible)
 {
     m_copyrightVisible = visible;
@@ -97,6 +97,8 @@ public:
         SupportsAnchoringCoordinate = 0x0004,
         SupportsFittingViewportToGeoRectangle = 0x0008,
         SupportsVisibleArea = 0x0010,
+        PrefersOpenGLMapItems = 0x0020,
+        SupportsOverlayMapTypes = 0x0040,
     };
 
     Q_DECLARE_FLAGS(Capabilities, Capability)
@@ -116,6 +118,8 @@ public:
 
     void setActiveMapType(const QGeoMapType mapType);
     const QGeoMapType activeMapType() const;
+    void setOverlayMapTypes(const QList<QGeoMapType> &mapTypes);
+    QList<QGeoMapType> overlayMapTypes() const;
 
     // returns the minimum zoom at the current viewport size
     double minimumZoom() const;
@@ -129,7 +133,11 @@ public:
     const QGeoProjection &geoProjection() const;
 
     virtual void prefetchData();
+    virtual void prefetchTrajectory(const QGeoCameraData &target);
+    virtual void prefetchCorridor(const QList<QGeoCoordinate> &path, double radius);
     virtual void clearData();
+    virtual void setFramePacing(bool paced);
+    virtual void prepareFrame();
 
     void addParameter(QGeoMapParameter *param);
     void removeParameter(QGeoMapParameter *param);
@@ -139,6 +147,8 @@ public:
 
     void addMapItem(QDeclarativeGeoMapItemBase *item);
     void removeMapItem(QDeclarativeGeoMapItemBase *item);
+    void addMapItems(const QList<QDeclarativeGeoMapItemBase *> &items);
+    void removeMapItems(const QList<QDeclarativeGeoMapItemBase *> &items);
     void clearMapItems();
 
     virtual bool createMapObjectImplementation(QGeoMapObject *obj);
@@ -157,6 +167,7 @@ public:
     virtual void setCopyrightVisible(bool visible);
     virtual void removeMapObject(QGeoMapObject *obj);
     virtual QList<QObject *> mapObjectsAt(const QGeoCoordinate &coordinate) const;
+    virtual QList<QObject *> mapObjectsIn(const QGeoShape &region) const;
     virtual void setItemToWindowTransform(const QTransform &itemToWindowTransform);
 
     void setVisibleArea(const QRectF &visibleArea);
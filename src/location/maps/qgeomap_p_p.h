@@ -55,6 +55,7 @@
 #include <QtLocation/private/qgeocameracapabilities_p.h>
 #include <QtCore/private/qobject_p.h>
 #include <QtCore/QSize>
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include "qgeomap_p.h"
 
@@ -90,12 +91,16 @@ protected:
     virtual QGeoMap::ItemTypes supportedMapItemTypes() const;
     virtual void addMapItem(QDeclarativeGeoMapItemBase *item);
     virtual void removeMapItem(QDeclarativeGeoMapItemBase *item);
+    // Called by QGeoMap::addMapItems() and removeMapItems(), once per batch
+    virtual void addMapItems(const QList<QDeclarativeGeoMapItemBase *> &items);
+    virtual void removeMapItems(const QList<QDeclarativeGeoMapItemBase *> &items);
 
     virtual QList<QGeoMapObject *> mapObjects() const;
 
     virtual void changeViewportSize(const QSize &size) = 0; // called by QGeoMap::setSize()
     virtual void changeCameraData(const QGeoCameraData &oldCameraData) = 0; // called by QGeoMap::setCameraData()
     virtual void changeActiveMapType(const QGeoMapType mapType) = 0; // called by QGeoMap::setActiveMapType()
+    virtual void changeOverlayMapTypes(const QList<QGeoMapType> &mapTypes); // called by QGeoMap::setOverlayMapTypes()
 
     virtual double mapWidth() const;
     virtual double mapHeight() const;
@@ -109,6 +114,7 @@ protected:
     virtual QRectF visibleArea() const;
 
     QRectF clampVisibleArea(const QRectF &visibleArea) const;
+    void compactMapItems();
 
 #ifdef QT_LOCATION_DEBUG
 public:
@@ -120,8 +126,11 @@ protected:
     QPointer<QGeoMappingManagerEngine> m_engine;
     QGeoCameraData m_cameraData;
     QGeoMapType m_activeMapType;
+    QList<QGeoMapType> m_overlayMapTypes;
     QList<QGeoMapParameter *> m_mapParameters;
-    QList<QDeclarativeGeoMapItemBase *> m_mapItems;
+    QList<QDeclarativeGeoMapItemBase *> m_mapItems; // in the order added, nullptr for removed items
+    QHash<QDeclarativeGeoMapItemBase *, int> m_mapItemIndices; // in m_mapItems
+    int m_removedMapItems = 0;
     QGeoCameraCapabilities m_cameraCapabilities;
     bool m_copyrightVisible = true;
     mutable double m_maximumViewportLatitude = 0;
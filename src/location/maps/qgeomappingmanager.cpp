@@ -42,6 +42,7 @@
 
 
 #include "qgeomap_p.h"
+#include "qgeomapstatistics_p.h"
 
 #include <QTimer>
 #include <QLocale>
@@ -87,6 +88,8 @@ QGeoMappingManager::QGeoMappingManager(QGeoMappingManagerEngine *engine, QObject
             this,
             SIGNAL(supportedMapTypesChanged()),
             Qt::QueuedConnection);
+
+    QGeoMapStatistics::startMemoryReports();
 }
 
 /*!
@@ -174,6 +177,25 @@ QLocale QGeoMappingManager::locale() const
     return d_ptr->engine->locale();
 }
 
+/*!
+    Returns how many bytes the parts of the map stack hold, in the whole
+    process, as a map of the names of the parts to maps with the \c bytes
+    they hold and the \c peakBytes they held. The \c total entry sums them.
+
+    The parts are the tile memory cache, the decoded tiles, the tile textures
+    uploaded by the scenes, the geometry of the map items, the triangulation
+    cache, the routes and the place search results. The byte counts of the
+    routes and of the place results are estimates.
+
+    When debug output of the \c qt.location.map.memory logging category is
+    enabled, the report is also logged every
+    \c QT_LOCATION_MEMORY_REPORT_INTERVAL milliseconds, or every 10 seconds.
+*/
+QVariantMap QGeoMappingManager::memoryReport()
+{
+    return QGeoMapStatistics::memoryReport();
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
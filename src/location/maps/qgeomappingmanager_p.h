@@ -51,6 +51,7 @@
 #include <QObject>
 #include <QSize>
 #include <QPair>
+#include <QVariantMap>
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeomaptype_p.h>
 
@@ -85,6 +86,8 @@ public:
     void setLocale(const QLocale &locale);
     QLocale locale() const;
 
+    static QVariantMap memoryReport();
+
 Q_SIGNALS:
     void initialized();
     void supportedMapTypesChanged();
@@ -0,0 +1,267 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapstatistics_p.h"
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcMapStatistics, "qt.location.map.statistics")
+Q_LOGGING_CATEGORY(lcMapMemory, "qt.location.map.memory")
+
+/*
+    QGeoMapStatistics collects, process-wide, how long the phases of producing
+    a map frame take and how tile lookups are served by the cache tiers. It is
+    meant for telemetry, to tell where a slow frame comes from.
+
+    Nothing is measured unless statistics are enabled, either by a map asking
+    for them or by enabling debug output of the qt.location.map.statistics
+    logging category, which additionally logs every measured phase. When
+    disabled, the cost of an instrumented phase is one atomic load.
+
+    It also keeps how many bytes each part of the map stack holds, in
+    counters that the owners of the memory always update as it changes, at
+    the cost of an atomic add. The sizes of the tile caches and of the geometry
+    are exact, those of the routes and the place results are estimates.
+*/
+
+namespace {
+
+struct PhaseStatistics
+{
+    QAtomicInteger<qint64> count;
+    QAtomicInteger<qint64> totalNsecs;
+    QAtomicInteger<qint64> maxNsecs;
+};
+
+PhaseStatistics phases[QGeoMapStatistics::PhaseCount];
+QAtomicInteger<qint64> counters[QGeoMapStatistics::CounterCount];
+QAtomicInteger<qint64> gauges[QGeoMapStatistics::GaugeCount];
+
+struct MemoryStatistics
+{
+    QAtomicInteger<qint64> bytes;
+    QAtomicInteger<qint64> peakBytes;
+};
+
+MemoryStatistics memoryPools[QGeoMapStatistics::MemoryPoolCount];
+MemoryStatistics memoryTotal;
+
+const char *const phaseNames[QGeoMapStatistics::PhaseCount] = {
+    "cameraTiles",
+    "requestTiles",
+    "tileDecode",
+    "itemPolish",
+    "itemPaintNode",
+    "sceneGraph"
+};
+
+const char *const counterNames[QGeoMapStatistics::CounterCount] = {
+    "textureCacheHits",
+    "memoryCacheHits",
+    "diskCacheHits",
+    "cacheMisses"
+};
+
+const char *const gaugeNames[QGeoMapStatistics::GaugeCount] = {
+    "textureCacheMinimum",
+    "textureCacheLimit",
+    "memoryCacheLimit"
+};
+
+const char *const memoryPoolNames[QGeoMapStatistics::MemoryPoolCount] = {
+    "tileMemoryCache",
+    "tileTextureCache",
+    "sceneTextures",
+    "itemGeometry",
+    "triangulationCache",
+    "routes",
+    "placeResults"
+};
+
+void addBytes(MemoryStatistics &s, qint64 bytes)
+{
+    const qint64 now = s.bytes.fetchAndAddRelaxed(bytes) + bytes;
+    qint64 peak = s.peakBytes.loadRelaxed();
+    while (now > peak && !s.peakBytes.testAndSetRelaxed(peak, now, peak)) {}
+}
+
+QVariantMap memoryEntry(const MemoryStatistics &s)
+{
+    QVariantMap entry;
+    entry.insert(QStringLiteral("bytes"), s.bytes.loadRelaxed());
+    entry.insert(QStringLiteral("peakBytes"), s.peakBytes.loadRelaxed());
+    return entry;
+}
+
+void logMemoryReport()
+{
+    QString report = QStringLiteral("total %1 (peak %2)").arg(memoryTotal.bytes.loadRelaxed())
+                                                         .arg(memoryTotal.peakBytes.loadRelaxed());
+    for (int i = 0; i < QGeoMapStatistics::MemoryPoolCount; ++i) {
+        report += QStringLiteral(", %1 %2 (peak %3)").arg(QLatin1String(memoryPoolNames[i]))
+                                                     .arg(memoryPools[i].bytes.loadRelaxed())
+                                                     .arg(memoryPools[i].peakBytes.loadRelaxed());
+    }
+    qCDebug(lcMapMemory).noquote() << "bytes:" << report;
+}
+
+} // namespace
+
+QBasicAtomicInt QGeoMapStatistics::s_enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+// Calls are counted, statistics stay enabled until every enable() is matched
+void QGeoMapStatistics::enable()
+{
+    s_enabled.ref();
+}
+
+void QGeoMapStatistics::disable()
+{
+    s_enabled.deref();
+}
+
+// Safe to call from any thread, tiles are decoded in a thread pool
+void QGeoMapStatistics::addTime(Phase phase, qint64 nsecs)
+{
+    PhaseStatistics &s = phases[phase];
+    s.count.fetchAndAddRelaxed(1);
+    s.totalNsecs.fetchAndAddRelaxed(nsecs);
+    qint64 max = s.maxNsecs.loadRelaxed();
+    while (nsecs > max && !s.maxNsecs.testAndSetRelaxed(max, nsecs, max)) {}
+
+    qCDebug(lcMapStatistics) << phaseNames[phase] << nsecs / 1000 << "us";
+}
+
+void QGeoMapStatistics::count(Counter counter, int n)
+{
+    if (isEnabled())
+        counters[counter].fetchAndAddRelaxed(n);
+}
+
+void QGeoMapStatistics::setGauge(Gauge gauge, qint64 value)
+{
+    gauges[gauge].storeRelaxed(value);
+}
+
+// Safe to call from any thread, \a bytes is negative when memory is freed
+void QGeoMapStatistics::addMemory(MemoryPool pool, qint64 bytes)
+{
+    addBytes(memoryPools[pool], bytes);
+    addBytes(memoryTotal, bytes);
+}
+
+/*
+    Returns a map of phase names to maps of count, totalTime and maxTime, in
+    milliseconds, along with the cache counters and gauges.
+*/
+QVariantMap QGeoMapStatistics::snapshot()
+{
+    QVariantMap res;
+    for (int i = 0; i < PhaseCount; ++i) {
+        const PhaseStatistics &s = phases[i];
+        QVariantMap phase;
+        phase.insert(QStringLiteral("count"), s.count.loadRelaxed());
+        phase.insert(QStringLiteral("totalTime"), s.totalNsecs.loadRelaxed() / 1e6);
+        phase.insert(QStringLiteral("maxTime"), s.maxNsecs.loadRelaxed() / 1e6);
+        res.insert(QLatin1String(phaseNames[i]), phase);
+    }
+    for (int i = 0; i < CounterCount; ++i)
+        res.insert(QLatin1String(counterNames[i]), counters[i].loadRelaxed());
+    for (int i = 0; i < GaugeCount; ++i)
+        res.insert(QLatin1String(gaugeNames[i]), gauges[i].loadRelaxed());
+    return res;
+}
+
+/*
+    Returns a map of memory pool names to maps of bytes and peakBytes, with
+    the same for all of them as total.
+*/
+QVariantMap QGeoMapStatistics::memoryReport()
+{
+    QVariantMap res;
+    for (int i = 0; i < MemoryPoolCount; ++i)
+        res.insert(QLatin1String(memoryPoolNames[i]), memoryEntry(memoryPools[i]));
+    res.insert(QStringLiteral("total"), memoryEntry(memoryTotal));
+    return res;
+}
+
+// The peaks of the memory pools start again from the current sizes
+void QGeoMapStatistics::reset()
+{
+    for (PhaseStatistics &s : phases) {
+        s.count.storeRelaxed(0);
+        s.totalNsecs.storeRelaxed(0);
+        s.maxNsecs.storeRelaxed(0);
+    }
+    for (QAtomicInteger<qint64> &c : counters)
+        c.storeRelaxed(0);
+    for (MemoryStatistics &m : memoryPools)
+        m.peakBytes.storeRelaxed(m.bytes.loadRelaxed());
+    memoryTotal.peakBytes.storeRelaxed(memoryTotal.bytes.loadRelaxed());
+}
+
+/*
+    Logs the memory report periodically, when debug output of the
+    qt.location.map.memory logging category is enabled, every
+    QT_LOCATION_MEMORY_REPORT_INTERVAL milliseconds or every 10 seconds.
+    Called as maps are created, the reports start with the first call on
+    the thread of the application.
+*/
+void QGeoMapStatistics::startMemoryReports()
+{
+    static QBasicAtomicInt started = Q_BASIC_ATOMIC_INITIALIZER(0);
+    QCoreApplication *app = QCoreApplication::instance();
+    if (!lcMapMemory().isDebugEnabled() || !app || QThread::currentThread() != app->thread()
+            || !started.testAndSetRelaxed(0, 1)) {
+        return;
+    }
+
+    bool ok = false;
+    int interval = qEnvironmentVariableIntValue("QT_LOCATION_MEMORY_REPORT_INTERVAL", &ok);
+    if (!ok || interval <= 0)
+        interval = 10000;
+    QTimer *timer = new QTimer(app);
+    QObject::connect(timer, &QTimer::timeout, logMemoryReport);
+    timer->start(interval);
+    logMemoryReport();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOMAPSTATISTICS_P_H
+#define QGEOMAPSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QVariantMap>
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_EXPORTED_LOGGING_CATEGORY(lcMapStatistics, Q_LOCATION_PRIVATE_EXPORT)
+Q_DECLARE_EXPORTED_LOGGING_CATEGORY(lcMapMemory, Q_LOCATION_PRIVATE_EXPORT)
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapStatistics
+{
+public:
+    enum Phase {
+        CameraTiles,
+        RequestTiles,
+        TileDecode,
+        ItemPolish,
+        ItemPaintNode,
+        SceneGraph,
+        PhaseCount
+    };
+
+    enum Counter {
+        TextureCacheHit,
+        MemoryCacheHit,
+        DiskCacheHit,
+        CacheMiss,
+        CounterCount
+    };
+
+    // Current values rather than sums, recorded whether statistics are enabled or not
+    enum Gauge {
+        TextureCacheMinimum,
+        TextureCacheLimit,
+        MemoryCacheLimit,
+        GaugeCount
+    };
+
+    // Bytes held by each part of the map stack, recorded whether statistics
+    // are enabled or not
+    enum MemoryPool {
+        TileMemoryCache,
+        TileTextureCache,
+        SceneTextures,
+        ItemGeometry,
+        TriangulationCache,
+        Routes,
+        PlaceResults,
+        MemoryPoolCount
+    };
+
+    static bool isEnabled()
+    {
+        return s_enabled.loadRelaxed() > 0 || lcMapStatistics().isDebugEnabled();
+    }
+    static void enable();
+    static void disable();
+
+    static void addTime(Phase phase, qint64 nsecs);
+    static void count(Counter counter, int n = 1);
+    static void setGauge(Gauge gauge, qint64 value);
+    static void addMemory(MemoryPool pool, qint64 bytes);
+
+    static QVariantMap snapshot();
+    static QVariantMap memoryReport();
+    static void reset();
+
+    static void startMemoryReports();
+
+private:
+    static QBasicAtomicInt s_enabled;
+};
+
+// Times the enclosing scope as \a phase, when statistics are enabled
+class QGeoMapStatisticsTimer
+{
+public:
+    explicit QGeoMapStatisticsTimer(QGeoMapStatistics::Phase phase)
+        : m_phase(phase)
+    {
+        if (QGeoMapStatistics::isEnabled())
+            m_timer.start();
+    }
+    ~QGeoMapStatisticsTimer()
+    {
+        if (m_timer.isValid())
+            QGeoMapStatistics::addTime(m_phase, m_timer.nsecsElapsed());
+    }
+
+private:
+    Q_DISABLE_COPY(QGeoMapStatisticsTimer)
+    QGeoMapStatistics::Phase m_phase;
+    QElapsedTimer m_timer;
+};
+
+// The share of \a pool held by one object, given back when it is destroyed
+class QGeoMapMemoryTracker
+{
+public:
+    explicit QGeoMapMemoryTracker(QGeoMapStatistics::MemoryPool pool)
+        : m_pool(pool)
+    {
+    }
+    ~QGeoMapMemoryTracker()
+    {
+        setBytes(0);
+    }
+
+    qint64 bytes() const { return m_bytes; }
+    void setBytes(qint64 bytes)
+    {
+        if (bytes == m_bytes)
+            return;
+        QGeoMapStatistics::addMemory(m_pool, bytes - m_bytes);
+        m_bytes = bytes;
+    }
+    void addBytes(qint64 bytes)
+    {
+        setBytes(m_bytes + bytes);
+    }
+
+private:
+    Q_DISABLE_COPY(QGeoMapMemoryTracker)
+    QGeoMapStatistics::MemoryPool m_pool;
+    qint64 m_bytes = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPSTATISTICS_P_H
@@ -0,0 +1,242 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeomemorypressuremonitor_p.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QSocketNotifier>
+#include <QtGui/QGuiApplication>
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#include <fcntl.h>
+#endif
+#if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+#include <unistd.h>
+#elif defined(Q_OS_DARWIN)
+#include <sys/sysctl.h>
+#elif defined(Q_OS_WIN)
+#include <qt_windows.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+// How long memory stalls keep the pressure up after the last one
+static const int stallHoldTime = 30000;
+
+/*
+    QGeoMemoryPressureMonitor combines the signs of the system running short
+    of memory into one QAbstractGeoTileCache::MemoryPressure level, which the
+    tiled mapping engines forward to their tile caches.
+
+    \list
+    \li A hidden application is under moderate pressure, a suspended one,
+        which mobile systems kill first when they need memory, under
+        critical pressure.
+    \li On Linux, stalls on memory reported by the pressure stall
+        information of the cgroup of the process, or of the whole system,
+        raise moderate pressure for a while.
+    \li Platform code, such as an Android onTrimMemory() handler, can
+        report a level with reportMemoryPressure().
+    \endlist
+
+    The highest of these levels is the pressure.
+*/
+
+QGeoMemoryPressureMonitor::QGeoMemoryPressureMonitor(QObject *parent)
+    : QObject(parent),
+      m_pressure(QAbstractGeoTileCache::NoMemoryPressure),
+      m_applicationPressure(QAbstractGeoTileCache::NoMemoryPressure),
+      m_reportedPressure(QAbstractGeoTileCache::NoMemoryPressure),
+      m_stalled(false), m_stallFd(-1), m_stallNotifier(nullptr)
+{
+    if (QGuiApplication *app = qobject_cast<QGuiApplication *>(QCoreApplication::instance())) {
+        connect(app, &QGuiApplication::applicationStateChanged,
+                this, &QGeoMemoryPressureMonitor::applicationStateChanged);
+        applicationStateChanged(app->applicationState());
+    }
+
+    m_stallTimer.setSingleShot(true);
+    m_stallTimer.setInterval(stallHoldTime);
+    connect(&m_stallTimer, &QTimer::timeout, this, [this]() {
+        m_stalled = false;
+        update();
+    });
+    openPressureStallTrigger();
+}
+
+QGeoMemoryPressureMonitor::~QGeoMemoryPressureMonitor()
+{
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    delete m_stallNotifier;
+    if (m_stallFd >= 0)
+        ::close(m_stallFd);
+#endif
+}
+
+/*
+    Returns the monitor of the application, created on first use and owned
+    by the application object. Returns null without an application object.
+*/
+QGeoMemoryPressureMonitor *QGeoMemoryPressureMonitor::instance()
+{
+    static QGeoMemoryPressureMonitor *monitor = nullptr;
+    QCoreApplication *app = QCoreApplication::instance();
+    if (!app)
+        return nullptr;
+    if (!monitor) {
+        monitor = new QGeoMemoryPressureMonitor(app);
+        connect(monitor, &QObject::destroyed, []() { monitor = nullptr; });
+    }
+    return monitor;
+}
+
+QAbstractGeoTileCache::MemoryPressure QGeoMemoryPressureMonitor::pressure() const
+{
+    return m_pressure;
+}
+
+/*
+    Sets the pressure reported by platform code to \a pressure, until
+    reported again.
+*/
+void QGeoMemoryPressureMonitor::reportMemoryPressure(QAbstractGeoTileCache::MemoryPressure pressure)
+{
+    m_reportedPressure = pressure;
+    update();
+}
+
+/*
+    Returns the amount of physical memory of the device in bytes, or 0 when
+    it isn't known. The tile caches derive their default limits from it.
+*/
+qint64 QGeoMemoryPressureMonitor::physicalMemory()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+    const long pages = ::sysconf(_SC_PHYS_PAGES);
+    const long pageSize = ::sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0)
+        return qint64(pages) * pageSize;
+#elif defined(Q_OS_DARWIN)
+    quint64 size = 0;
+    size_t length = sizeof(size);
+    if (::sysctlbyname("hw.memsize", &size, &length, nullptr, 0) == 0)
+        return qint64(size);
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status))
+        return qint64(status.ullTotalPhys);
+#endif
+    return 0;
+}
+
+void QGeoMemoryPressureMonitor::applicationStateChanged(Qt::ApplicationState state)
+{
+    switch (state) {
+    case Qt::ApplicationSuspended:
+        m_applicationPressure = QAbstractGeoTileCache::CriticalMemoryPressure;
+        break;
+    case Qt::ApplicationHidden:
+        m_applicationPressure = QAbstractGeoTileCache::ModerateMemoryPressure;
+        break;
+    default:
+        m_applicationPressure = QAbstractGeoTileCache::NoMemoryPressure;
+        break;
+    }
+    update();
+}
+
+/*
+    Registers a pressure stall trigger: the kernel flags the file once tasks
+    of the cgroup spent 150 ms of a 2 s window waiting for memory. Windows
+    in multiples of 2 s are also allowed to unprivileged processes.
+*/
+void QGeoMemoryPressureMonitor::openPressureStallTrigger()
+{
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    QStringList candidates;
+    QFile cgroups(QStringLiteral("/proc/self/cgroup"));
+    if (cgroups.open(QIODevice::ReadOnly)) {
+        // the cgroup v2 entry reads "0::/path"
+        const QList<QByteArray> lines = cgroups.readAll().split('\n');
+        for (const QByteArray &line : lines) {
+            if (line.startsWith("0::")) {
+                candidates << QStringLiteral("/sys/fs/cgroup") + QString::fromLocal8Bit(line.mid(3))
+                              + QStringLiteral("/memory.pressure");
+            }
+        }
+    }
+    candidates << QStringLiteral("/proc/pressure/memory");
+
+    static const char trigger[] = "some 150000 2000000";
+    for (const QString &candidate : qAsConst(candidates)) {
+        const int fd = ::open(QFile::encodeName(candidate).constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        if (::write(fd, trigger, sizeof(trigger)) < 0) {
+            ::close(fd);
+            continue;
+        }
+        m_stallFd = fd;
+        m_stallNotifier = new QSocketNotifier(fd, QSocketNotifier::Exception, this);
+        connect(m_stallNotifier, &QSocketNotifier::activated,
+                this, &QGeoMemoryPressureMonitor::pressureStalled);
+        return;
+    }
+#endif
+}
+
+void QGeoMemoryPressureMonitor::pressureStalled()
+{
+    m_stalled = true;
+    m_stallTimer.start();
+    update();
+}
+
+void QGeoMemoryPressureMonitor::update()
+{
+    QAbstractGeoTileCache::MemoryPressure pressure = qMax(m_applicationPressure, m_reportedPressure);
+    if (m_stalled)
+        pressure = qMax(pressure, QAbstractGeoTileCache::ModerateMemoryPressure);
+    if (pressure == m_pressure)
+        return;
+    m_pressure = pressure;
+    emit pressureChanged(pressure);
+}
+
+QT_END_NAMESPACE
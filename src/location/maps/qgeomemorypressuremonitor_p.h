@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOMEMORYPRESSUREMONITOR_P_H
+#define QGEOMEMORYPRESSUREMONITOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qabstractgeotilecache_p.h>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+QT_BEGIN_NAMESPACE
+
+class QSocketNotifier;
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoMemoryPressureMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static QGeoMemoryPressureMonitor *instance();
+    ~QGeoMemoryPressureMonitor();
+
+    QAbstractGeoTileCache::MemoryPressure pressure() const;
+    void reportMemoryPressure(QAbstractGeoTileCache::MemoryPressure pressure);
+
+    static qint64 physicalMemory();
+
+Q_SIGNALS:
+    void pressureChanged(QAbstractGeoTileCache::MemoryPressure pressure);
+
+private:
+    explicit QGeoMemoryPressureMonitor(QObject *parent);
+
+    void applicationStateChanged(Qt::ApplicationState state);
+    void openPressureStallTrigger();
+    void pressureStalled();
+    void update();
+
+    QAbstractGeoTileCache::MemoryPressure m_pressure;
+    QAbstractGeoTileCache::MemoryPressure m_applicationPressure;
+    QAbstractGeoTileCache::MemoryPressure m_reportedPressure;
+    bool m_stalled;
+    int m_stallFd;
+    QSocketNotifier *m_stallNotifier;
+    QTimer m_stallTimer;
+
+    Q_DISABLE_COPY(QGeoMemoryPressureMonitor)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMEMORYPRESSUREMONITOR_P_H
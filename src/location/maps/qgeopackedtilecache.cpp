@@ -0,0 +1,709 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeopackedtilecache_p.h"
+#include "qgeomapstatistics_p.h"
+
+#include <QDir>
+#include <QSaveFile>
+#include <QtEndian>
+#include <QDebug>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+// Pack file layout, all integers little endian:
+//  header: quint32 magic, quint32 version, qint64 offset of the index (0 if not valid)
+//  record: quint32 record magic, quint32 data length, quint16 plugin length,
+//          quint8 format length, quint8 reserved, qint32 mapId, zoom, x, y, version,
+//          followed by the latin1 plugin name, the latin1 format and the tile data
+//  index:  quint32 index magic, quint32 count, count x qint64 record offsets,
+//          sorted by map id, zoom and Morton order of the tile coordinates
+// New records are appended to the end; the index is appended when the cache is
+// destroyed. A missing index is rebuilt by walking the records.
+static const quint32 packMagic = 0x50544751;    // "QGTP"
+static const quint32 packVersion = 1;
+static const quint32 recordMagic = 0x52544751;  // "QGTR"
+static const quint32 indexMagic = 0x58544751;   // "QGTX"
+static const int packHeaderSize = 16;
+static const int recordHeaderSize = 32;
+
+// Interleaves the bits of x and y, so that tiles close on the map are close in the pack
+static quint64 spatialKey(int x, int y)
+{
+    quint64 key = 0;
+    for (int i = 0; i < 32; ++i) {
+        key |= (quint64((quint32(x) >> i) & 1) << (2 * i))
+             | (quint64((quint32(y) >> i) & 1) << (2 * i + 1));
+    }
+    return key;
+}
+
+static bool spatialLessThan(const QSharedPointer<QGeoPackedTile> &a, const QSharedPointer<QGeoPackedTile> &b)
+{
+    if (a->spec.mapId() != b->spec.mapId())
+        return a->spec.mapId() < b->spec.mapId();
+    if (a->spec.zoom() != b->spec.zoom())
+        return a->spec.zoom() < b->spec.zoom();
+    const quint64 ka = spatialKey(a->spec.x(), a->spec.y());
+    const quint64 kb = spatialKey(b->spec.x(), b->spec.y());
+    if (ka != kb)
+        return ka < kb;
+    return a->spec.version() < b->spec.version();
+}
+
+static QByteArray packHeader(qint64 indexOffset)
+{
+    QByteArray header(packHeaderSize, Qt::Uninitialized);
+    qToLittleEndian<quint32>(packMagic, header.data());
+    qToLittleEndian<quint32>(packVersion, header.data() + 4);
+    qToLittleEndian<qint64>(indexOffset, header.data() + 8);
+    return header;
+}
+
+static QByteArray recordHeader(const QGeoTileSpec &spec, const QByteArray &plugin,
+                               const QByteArray &format, int length)
+{
+    QByteArray header(recordHeaderSize, Qt::Uninitialized);
+    uchar *data = reinterpret_cast<uchar *>(header.data());
+    qToLittleEndian<quint32>(recordMagic, data);
+    qToLittleEndian<quint32>(quint32(length), data + 4);
+    qToLittleEndian<quint16>(quint16(plugin.size()), data + 8);
+    data[10] = quint8(format.size());
+    data[11] = 0;
+    qToLittleEndian<qint32>(spec.mapId(), data + 12);
+    qToLittleEndian<qint32>(spec.zoom(), data + 16);
+    qToLittleEndian<qint32>(spec.x(), data + 20);
+    qToLittleEndian<qint32>(spec.y(), data + 24);
+    qToLittleEndian<qint32>(spec.version(), data + 28);
+    return header;
+}
+
+QGeoPackedTile::QGeoPackedTile()
+    : offset(0), dataOffset(0), length(0), cache(0)
+{
+}
+
+QGeoPackedTile::~QGeoPackedTile()
+{
+    if (cache)
+        cache->tileEvicted(this);
+}
+
+void QCache3QPackedTileEvictionPolicy::aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<QGeoPackedTile> obj)
+{
+    Q_UNUSED(key);
+    // not an eviction, the record stays in the pack
+    obj->cache = 0;
+}
+
+void QCache3QPackedTileEvictionPolicy::aboutToBeEvicted(const QGeoTileSpec &key, QSharedPointer<QGeoPackedTile> obj)
+{
+    Q_UNUSED(key);
+    Q_UNUSED(obj);
+    // leave the pointer set if it's a real eviction
+}
+
+QGeoPackedTileCache::QGeoPackedTileCache(const QString &directory, QObject *parent)
+    : QAbstractGeoTileCache(parent), directory_(directory), map_(0), mapSize_(0), liveBytes_(0),
+      indexDirty_(false), minTextureUsage_(0), extraTextureUsage_(0),
+      costStrategyDisk_(ByteSize), costStrategyTexture_(ByteSize),
+      isDiskCostSet_(false), isTextureCostSet_(false)
+{
+}
+
+QGeoPackedTileCache::~QGeoPackedTileCache()
+{
+    if (pack_.isOpen()) {
+        writeIndex();
+        if (map_)
+            pack_.unmap(map_);
+        map_ = 0;
+        pack_.close();
+    }
+}
+
+void QGeoPackedTileCache::init()
+{
+    if (directory_.isEmpty())
+        directory_ = baseLocationCacheDirectory();
+    if (!QDir::root().mkpath(directory_))
+        qWarning() << "Failed to create cache directory " << directory_;
+
+    // default values, same as QGeoFileTileCache
+    if (!isDiskCostSet_) {
+        if (costStrategyDisk_ == ByteSize)
+            setMaxDiskUsage(50 * 1024 * 1024);
+        else
+            setMaxDiskUsage(1000);
+    }
+
+    if (!isTextureCostSet_) {
+        if (costStrategyTexture_ == ByteSize)
+            setExtraTextureUsage(6 * 1024 * 1024);
+        else
+            setExtraTextureUsage(30);
+    }
+
+    if (!openPack())
+        qWarning() << "Unable to open tile pack " << packFileName();
+}
+
+QString QGeoPackedTileCache::packFileName() const
+{
+    return QDir(directory_).filePath(QStringLiteral("tiles.pack"));
+}
+
+bool QGeoPackedTileCache::openPack()
+{
+    pack_.setFileName(packFileName());
+    if (!pack_.open(QIODevice::ReadWrite))
+        return false;
+
+    qint64 indexOffset = 0;
+    bool valid = false;
+    if (pack_.size() >= packHeaderSize) {
+        const QByteArray header = pack_.read(packHeaderSize);
+        valid = qFromLittleEndian<quint32>(header.constData()) == packMagic
+                && qFromLittleEndian<quint32>(header.constData() + 4) == packVersion;
+        indexOffset = qFromLittleEndian<qint64>(header.constData() + 8);
+    }
+
+    if (!valid) {
+        pack_.resize(0);
+        pack_.seek(0);
+        pack_.write(packHeader(0));
+        pack_.flush();
+        return true;
+    }
+
+    if (pack_.size() == packHeaderSize)
+        return true;
+    if (!readIndex(indexOffset) && !recoverIndex())
+        return false;
+
+    // reclaim the space left by evictions, replaced tiles and old indexes
+    const qint64 deadBytes = pack_.size() - packHeaderSize - liveBytes_;
+    if (deadBytes > liveBytes_ && deadBytes > 1024 * 1024)
+        compact();
+    return true;
+}
+
+const uchar *QGeoPackedTileCache::mappedData(qint64 offset, qint64 length)
+{
+    if (offset + length > mapSize_) {
+        // the pack grew since it was mapped
+        pack_.flush();
+        if (map_)
+            pack_.unmap(map_);
+        mapSize_ = pack_.size();
+        map_ = mapSize_ > 0 ? pack_.map(0, mapSize_) : 0;
+        if (!map_)
+            mapSize_ = 0;
+    }
+    if (!map_ || offset + length > mapSize_)
+        return 0;
+    return map_ + offset;
+}
+
+static bool parseRecord(const uchar *data, qint64 available, QGeoTileSpec *spec, qint64 *recordLength, int *length)
+{
+    if (available < recordHeaderSize || qFromLittleEndian<quint32>(data) != recordMagic)
+        return false;
+    *length = int(qFromLittleEndian<quint32>(data + 4));
+    const int pluginLength = qFromLittleEndian<quint16>(data + 8);
+    const int formatLength = data[10];
+    *recordLength = recordHeaderSize + pluginLength + formatLength + qint64(*length);
+    if (*length < 0 || *recordLength > available)
+        return false;
+    const QString plugin = QString::fromLatin1(reinterpret_cast<const char *>(data + recordHeaderSize), pluginLength);
+    *spec = QGeoTileSpec(plugin,
+                         qFromLittleEndian<qint32>(data + 12),
+                         qFromLittleEndian<qint32>(data + 16),
+                         qFromLittleEndian<qint32>(data + 20),
+                         qFromLittleEndian<qint32>(data + 24),
+                         qFromLittleEndian<qint32>(data + 28));
+    return true;
+}
+
+bool QGeoPackedTileCache::readIndex(qint64 indexOffset)
+{
+    const qint64 size = pack_.size();
+    if (indexOffset < packHeaderSize || indexOffset + 8 > size)
+        return false;
+
+    const uchar *index = mappedData(indexOffset, 8);
+    if (!index || qFromLittleEndian<quint32>(index) != indexMagic)
+        return false;
+    const qint64 count = qFromLittleEndian<quint32>(index + 4);
+    if (indexOffset + 8 + 8 * count > size)
+        return false;
+    index = mappedData(indexOffset, 8 + 8 * count);
+    if (!index)
+        return false;
+    const uchar *data = map_;
+
+    for (qint64 i = 0; i < count; ++i) {
+        const qint64 offset = qFromLittleEndian<qint64>(index + 8 + 8 * i);
+        if (offset < packHeaderSize || offset >= indexOffset)
+            return false;
+
+        QGeoTileSpec spec;
+        qint64 recordLength = 0;
+        int length = 0;
+        if (!parseRecord(data + offset, indexOffset - offset, &spec, &recordLength, &length))
+            return false;
+
+        QSharedPointer<QGeoPackedTile> tile(new QGeoPackedTile);
+        tile->spec = spec;
+        tile->offset = offset;
+        tile->dataOffset = offset + recordLength - length;
+        tile->length = length;
+        tile->cache = this;
+        liveBytes_ += recordLength;
+        if (!diskCache_.insert(spec, tile, costStrategyDisk_ == ByteSize ? length : 1)) {
+            tile->cache = 0;
+            liveBytes_ -= recordLength;
+        }
+    }
+    return true;
+}
+
+bool QGeoPackedTileCache::recoverIndex()
+{
+    qWarning() << "Tile pack index missing, rebuilding it from " << packFileName();
+
+    diskCache_.clear();
+    liveBytes_ = 0;
+
+    const qint64 size = pack_.size();
+    const uchar *data = mappedData(0, size);
+    if (!data)
+        return false;
+
+    qint64 pos = packHeaderSize;
+    while (pos < size) {
+        if (size - pos >= 8 && qFromLittleEndian<quint32>(data + pos) == indexMagic) {
+            pos += 8 + 8 * qint64(qFromLittleEndian<quint32>(data + pos + 4));
+            continue;
+        }
+
+        QGeoTileSpec spec;
+        qint64 recordLength = 0;
+        int length = 0;
+        if (!parseRecord(data + pos, size - pos, &spec, &recordLength, &length))
+            break; // truncated by a crash, drop the tail
+
+        QSharedPointer<QGeoPackedTile> tile(new QGeoPackedTile);
+        tile->spec = spec;
+        tile->offset = pos;
+        tile->dataOffset = pos + recordLength - length;
+        tile->length = length;
+        tile->cache = this;
+        liveBytes_ += recordLength;
+        // later records replace earlier ones for the same tile
+        if (!diskCache_.insert(spec, tile, costStrategyDisk_ == ByteSize ? length : 1)) {
+            tile->cache = 0;
+            liveBytes_ -= recordLength;
+        }
+        pos += recordLength;
+    }
+
+    if (pos < size) {
+        pack_.unmap(map_);
+        map_ = 0;
+        mapSize_ = 0;
+        pack_.resize(pos);
+    }
+    indexDirty_ = true;
+    return true;
+}
+
+void QGeoPackedTileCache::writeIndex()
+{
+    if (!indexDirty_)
+        return;
+
+    QList<QSharedPointer<QGeoPackedTile> > tiles;
+    for (int q = 1; q <= 3; ++q)
+        diskCache_.serializeQueue(q, tiles);
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+                               [](const QSharedPointer<QGeoPackedTile> &t) { return t.isNull(); }),
+                tiles.end());
+    std::sort(tiles.begin(), tiles.end(), spatialLessThan);
+
+    QByteArray index(8 + 8 * tiles.size(), Qt::Uninitialized);
+    qToLittleEndian<quint32>(indexMagic, index.data());
+    qToLittleEndian<quint32>(quint32(tiles.size()), index.data() + 4);
+    for (int i = 0; i < tiles.size(); ++i)
+        qToLittleEndian<qint64>(tiles.at(i)->offset, index.data() + 8 + 8 * i);
+
+    const qint64 indexOffset = pack_.size();
+    pack_.seek(indexOffset);
+    pack_.write(index);
+    pack_.seek(0);
+    pack_.write(packHeader(indexOffset));
+    pack_.flush();
+    indexDirty_ = false;
+}
+
+/*
+    Rewrites the pack with the live tiles only, in spatial order.
+*/
+void QGeoPackedTileCache::compact()
+{
+    QList<QSharedPointer<QGeoPackedTile> > tiles;
+    for (int q = 1; q <= 3; ++q)
+        diskCache_.serializeQueue(q, tiles);
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+                               [](const QSharedPointer<QGeoPackedTile> &t) { return t.isNull(); }),
+                tiles.end());
+    std::sort(tiles.begin(), tiles.end(), spatialLessThan);
+
+    const uchar *data = mappedData(0, pack_.size());
+    if (!data)
+        return;
+
+    QSaveFile file(packFileName() + QStringLiteral(".compact"));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    file.write(packHeader(0));
+
+    QVector<qint64> offsets;
+    offsets.reserve(tiles.size());
+    qint64 pos = packHeaderSize;
+    qint64 liveBytes = 0;
+    for (const QSharedPointer<QGeoPackedTile> &tile : qAsConst(tiles)) {
+        const qint64 recordLength = tile->dataOffset - tile->offset + tile->length;
+        file.write(reinterpret_cast<const char *>(data + tile->offset), recordLength);
+        offsets.append(pos);
+        pos += recordLength;
+        liveBytes += recordLength;
+    }
+    if (!file.commit())
+        return;
+
+    pack_.unmap(map_);
+    map_ = 0;
+    mapSize_ = 0;
+    pack_.close();
+    QFile::remove(packFileName());
+    if (!QFile::rename(packFileName() + QStringLiteral(".compact"), packFileName())
+            || !pack_.open(QIODevice::ReadWrite)) {
+        qWarning() << "Unable to compact tile pack " << packFileName();
+        diskCache_.clear();
+        liveBytes_ = 0;
+        return;
+    }
+
+    for (int i = 0; i < tiles.size(); ++i) {
+        QGeoPackedTile *tile = tiles.at(i).data();
+        tile->dataOffset = offsets.at(i) + (tile->dataOffset - tile->offset);
+        tile->offset = offsets.at(i);
+    }
+    liveBytes_ = liveBytes;
+    indexDirty_ = true;
+    writeIndex();
+}
+
+QByteArray QGeoPackedTileCache::readPayload(const QGeoPackedTile &tile)
+{
+    const uchar *data = mappedData(tile.dataOffset, tile.length);
+    if (data)
+        return QByteArray(reinterpret_cast<const char *>(data), tile.length);
+
+    // platforms without file mapping
+    if (!pack_.seek(tile.dataOffset))
+        return QByteArray();
+    return pack_.read(tile.length);
+}
+
+void QGeoPackedTileCache::tileEvicted(QGeoPackedTile *tile)
+{
+    liveBytes_ -= tile->dataOffset - tile->offset + tile->length;
+    indexDirty_ = true;
+}
+
+void QGeoPackedTileCache::printStats()
+{
+    textureCache_.printStats();
+    diskCache_.printStats();
+}
+
+QCache3QStatistics QGeoPackedTileCache::statistics(CacheArea area) const
+{
+    switch (area) {
+    case DiskCache:
+        return diskCache_.statistics();
+    case TextureCache:
+        return textureCache_.statistics();
+    default:
+        return QCache3QStatistics();
+    }
+}
+
+bool QGeoPackedTileCache::contains(const QGeoTileSpec &spec, CacheArea area) const
+{
+    switch (area) {
+    case DiskCache:
+        return diskCache_.contains(spec);
+    case TextureCache:
+        return textureCache_.contains(spec);
+    default:
+        return false;
+    }
+}
+
+void QGeoPackedTileCache::setMaxDiskUsage(int diskUsage)
+{
+    diskCache_.setMaxCost(diskUsage);
+    isDiskCostSet_ = true;
+}
+
+int QGeoPackedTileCache::maxDiskUsage() const
+{
+    return diskCache_.maxCost();
+}
+
+int QGeoPackedTileCache::diskUsage() const
+{
+    return diskCache_.totalCost();
+}
+
+void QGeoPackedTileCache::setExtraTextureUsage(int textureUsage)
+{
+    extraTextureUsage_ = textureUsage;
+    textureCache_.setMaxCost(minTextureUsage_ + extraTextureUsage_);
+    isTextureCostSet_ = true;
+}
+
+void QGeoPackedTileCache::setMinTextureUsage(int textureUsage)
+{
+    minTextureUsage_ = textureUsage;
+    textureCache_.setMaxCost(minTextureUsage_ + extraTextureUsage_);
+}
+
+int QGeoPackedTileCache::maxTextureUsage() const
+{
+    return textureCache_.maxCost();
+}
+
+int QGeoPackedTileCache::minTextureUsage() const
+{
+    return minTextureUsage_;
+}
+
+int QGeoPackedTileCache::textureUsage() const
+{
+    return textureCache_.totalCost();
+}
+
+void QGeoPackedTileCache::clearAll()
+{
+    textureCache_.clear();
+    diskCache_.clear();
+    liveBytes_ = 0;
+
+    if (!pack_.isOpen())
+        return;
+    if (map_)
+        pack_.unmap(map_);
+    map_ = 0;
+    mapSize_ = 0;
+    pack_.resize(0);
+    pack_.seek(0);
+    pack_.write(packHeader(0));
+    pack_.flush();
+    indexDirty_ = true;
+}
+
+void QGeoPackedTileCache::clearMapId(int mapId)
+{
+    for (const QGeoTileSpec &k : diskCache_.keys()) {
+        if (k.mapId() != mapId)
+            continue;
+        // removed rather than evicted, so tileEvicted() does not see these
+        if (const QSharedPointer<QGeoPackedTile> tile = diskCache_.object(k))
+            liveBytes_ -= tile->dataOffset - tile->offset + tile->length;
+        diskCache_.remove(k, true);
+        indexDirty_ = true;
+    }
+    for (const QGeoTileSpec &k : textureCache_.keys())
+        if (k.mapId() == mapId)
+            textureCache_.remove(k);
+}
+
+void QGeoPackedTileCache::setCostStrategyDisk(QAbstractGeoTileCache::CostStrategy costStrategy)
+{
+    costStrategyDisk_ = costStrategy;
+}
+
+QAbstractGeoTileCache::CostStrategy QGeoPackedTileCache::costStrategyDisk() const
+{
+    return costStrategyDisk_;
+}
+
+void QGeoPackedTileCache::setCostStrategyMemory(QAbstractGeoTileCache::CostStrategy costStrategy)
+{
+    // the mapped pack file takes the role of the memory cache
+    Q_UNUSED(costStrategy);
+}
+
+QAbstractGeoTileCache::CostStrategy QGeoPackedTileCache::costStrategyMemory() const
+{
+    return ByteSize;
+}
+
+void QGeoPackedTileCache::setCostStrategyTexture(QAbstractGeoTileCache::CostStrategy costStrategy)
+{
+    costStrategyTexture_ = costStrategy;
+}
+
+QAbstractGeoTileCache::CostStrategy QGeoPackedTileCache::costStrategyTexture() const
+{
+    return costStrategyTexture_;
+}
+
+QSharedPointer<QGeoTileTexture> QGeoPackedTileCache::getDecoded(const QGeoTileSpec &spec)
+{
+    return textureCache_.object(spec);
+}
+
+QSharedPointer<QGeoTileTexture> QGeoPackedTileCache::get(const QGeoTileSpec &spec)
+{
+    QSharedPointer<QGeoTileTexture> tt = textureCache_.object(spec);
+    if (tt) {
+        QGeoMapStatistics::count(QGeoMapStatistics::TextureCacheHit);
+        return tt;
+    }
+
+    QSharedPointer<QGeoPackedTile> tile = diskCache_.object(spec);
+    if (!tile) {
+        QGeoMapStatistics::count(QGeoMapStatistics::CacheMiss);
+        return QSharedPointer<QGeoTileTexture>();
+    }
+    QGeoMapStatistics::count(QGeoMapStatistics::DiskCacheHit);
+
+    const QByteArray bytes = readPayload(*tile);
+    QImage image;
+    // See QGeoFileTileCache::getFromDisk()
+    if (isTileBogus(bytes)) {
+        tt = QSharedPointer<QGeoTileTexture>(new QGeoTileTexture);
+        tt->spec = spec;
+        return tt;
+    }
+
+    {
+        QGeoMapStatisticsTimer timer(QGeoMapStatistics::TileDecode);
+        if (!image.loadFromData(bytes)) {
+            handleError(spec, QLatin1String("Problem with tile image"));
+            return QSharedPointer<QGeoTileTexture>(0);
+        }
+
+        // Converting it here, instead of in each QSGTexture::bind()
+        if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
+            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    return addToTextureCache(spec, image);
+}
+
+void QGeoPackedTileCache::insert(const QGeoTileSpec &spec,
+                                 const QByteArray &bytes,
+                                 const QString &format,
+                                 QAbstractGeoTileCache::CacheAreas areas)
+{
+    if (bytes.isEmpty() || !(areas & QAbstractGeoTileCache::DiskCache) || !pack_.isOpen())
+        return;
+
+    const int cost = costStrategyDisk_ == ByteSize ? bytes.size() : 1;
+    if (cost > diskCache_.maxCost())
+        return;
+
+    if (!indexDirty_) {
+        // invalidate the index until the next writeIndex(), so that a crash triggers recoverIndex()
+        pack_.seek(0);
+        pack_.write(packHeader(0));
+        indexDirty_ = true;
+    }
+
+    const QByteArray plugin = spec.plugin().toLatin1();
+    const QByteArray fmt = format.toLatin1().left(255);
+    const qint64 offset = pack_.size();
+    pack_.seek(offset);
+    pack_.write(recordHeader(spec, plugin, fmt, bytes.size()));
+    pack_.write(plugin);
+    pack_.write(fmt);
+    if (pack_.write(bytes) != bytes.size()) {
+        qWarning() << "Unable to write to tile pack " << packFileName();
+        return;
+    }
+
+    QSharedPointer<QGeoPackedTile> tile(new QGeoPackedTile);
+    tile->spec = spec;
+    tile->offset = offset;
+    tile->dataOffset = offset + recordHeaderSize + plugin.size() + fmt.size();
+    tile->length = bytes.size();
+    tile->cache = this;
+    liveBytes_ += tile->dataOffset - offset + tile->length;
+    diskCache_.insert(spec, tile, cost);
+
+    /* inserts do not hit the texture cache, see QGeoFileTileCache::insert() */
+}
+
+QSharedPointer<QGeoTileTexture> QGeoPackedTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image)
+{
+    QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+    tt->spec = spec;
+    tt->image = image;
+    tt->memory.setBytes(tt->byteSize());
+
+    int cost = 1;
+    if (costStrategyTexture_ == ByteSize)
+        cost = image.width() * image.height() * image.depth() / 8;
+    textureCache_.insert(spec, tt, cost);
+
+    return tt;
+}
+
+bool QGeoPackedTileCache::isTileBogus(const QByteArray &bytes) const
+{
+    if (bytes.size() == 7 && bytes == QByteArrayLiteral("NoRetry"))
+        return true;
+    return false;
+}
+
+QT_END_NAMESPACE
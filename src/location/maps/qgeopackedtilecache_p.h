@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOPACKEDTILECACHE_P_H
+#define QGEOPACKEDTILECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QObject>
+#include <QFile>
+#include "qcache3q_p.h"
+
+#include "qgeotilespec_p.h"
+#include "qabstractgeotilecache_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QGeoPackedTileCache;
+
+/* A tile stored in the pack file: where its record starts and how big its payload is */
+class QGeoPackedTile
+{
+public:
+    QGeoPackedTile();
+    ~QGeoPackedTile();
+
+    QGeoTileSpec spec;
+    qint64 offset;      // start of the record
+    qint64 dataOffset;  // start of the tile data in the record
+    int length;         // size of the tile data
+    QGeoPackedTileCache *cache;
+};
+
+/* Evicted tiles leave a hole in the pack file, reclaimed by the next compaction */
+class Q_LOCATION_PRIVATE_EXPORT QCache3QPackedTileEvictionPolicy : public QCache3QDefaultEvictionPolicy<QGeoTileSpec, QGeoPackedTile>
+{
+protected:
+    void aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<QGeoPackedTile> obj);
+    void aboutToBeEvicted(const QGeoTileSpec &key, QSharedPointer<QGeoPackedTile> obj);
+};
+
+/*
+    Tile cache keeping all the tiles of a plugin in a single pack file. The file
+    is memory-mapped, so that serving a tile costs no system call, and carries
+    a spatially ordered index of its tiles, rewritten when the cache is destroyed.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoPackedTileCache : public QAbstractGeoTileCache
+{
+    Q_OBJECT
+public:
+    QGeoPackedTileCache(const QString &directory = QString(), QObject *parent = 0);
+    ~QGeoPackedTileCache();
+
+    void setMaxDiskUsage(int diskUsage) override;
+    int maxDiskUsage() const override;
+    int diskUsage() const override;
+
+    void setMinTextureUsage(int textureUsage) override;
+    void setExtraTextureUsage(int textureUsage) override;
+    int maxTextureUsage() const override;
+    int minTextureUsage() const override;
+    int textureUsage() const override;
+    void clearAll() override;
+    void clearMapId(int mapId);
+    void setCostStrategyDisk(CostStrategy costStrategy) override;
+    CostStrategy costStrategyDisk() const override;
+    void setCostStrategyMemory(CostStrategy costStrategy) override;
+    CostStrategy costStrategyMemory() const override;
+    void setCostStrategyTexture(CostStrategy costStrategy) override;
+    CostStrategy costStrategyTexture() const override;
+
+    QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+    QSharedPointer<QGeoTileTexture> getDecoded(const QGeoTileSpec &spec) override;
+    QCache3QStatistics statistics(CacheArea area) const override;
+    bool contains(const QGeoTileSpec &spec, CacheArea area) const override;
+
+    void insert(const QGeoTileSpec &spec,
+                const QByteArray &bytes,
+                const QString &format,
+                QAbstractGeoTileCache::CacheAreas areas = QAbstractGeoTileCache::AllCaches) override;
+
+    QString packFileName() const;
+
+protected:
+    void init() override;
+    void printStats() override;
+
+    bool openPack();
+    bool readIndex(qint64 indexOffset);
+    bool recoverIndex();
+    void writeIndex();
+    void compact();
+    const uchar *mappedData(qint64 offset, qint64 length);
+    QByteArray readPayload(const QGeoPackedTile &tile);
+    void tileEvicted(QGeoPackedTile *tile);
+    QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image);
+    virtual bool isTileBogus(const QByteArray &bytes) const;
+
+    QCache3Q<QGeoTileSpec, QGeoPackedTile, QCache3QPackedTileEvictionPolicy> diskCache_;
+    QCache3Q<QGeoTileSpec, QGeoTileTexture> textureCache_;
+
+    QString directory_;
+    QFile pack_;
+    uchar *map_;
+    qint64 mapSize_;
+    qint64 liveBytes_;
+    bool indexDirty_;
+
+    int minTextureUsage_;
+    int extraTextureUsage_;
+    CostStrategy costStrategyDisk_;
+    CostStrategy costStrategyTexture_;
+    bool isDiskCostSet_;
+    bool isTextureCostSet_;
+
+    friend class QGeoPackedTile;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOPACKEDTILECACHE_P_H
@@ -87,6 +87,61 @@ static QPointF marginsOffset(const QSizeF &screenSize, const QRectF &visibleArea
     return QPointF(-xdiffpct, -ydiffpct);
 }
 
+namespace {
+// How projectionWrapFactor() wraps the projections, which only depends on the camera
+enum WrapMode {
+    WrapNone,   // camera at 0.5, nothing wraps
+    WrapAbove,  // camera left of 0.5, what is right of it by more than 0.5 wraps to -1
+    WrapBelow   // camera right of 0.5, what is left of it by more than 0.5 wraps to +1
+};
+
+template <WrapMode Mode, bool Unwrap>
+inline QDoubleVector2D wrapProjection(const QDoubleVector2D &projection, double cameraCenterX, double unwrapBelowX)
+{
+    double x = projection.x();
+    if (Mode == WrapAbove)
+        x -= (x - cameraCenterX > 0.5) ? 1.0 : 0.0;
+    else if (Mode == WrapBelow)
+        x += (x - cameraCenterX < -0.5) ? 1.0 : 0.0;
+    if (Unwrap) {
+        // the unwrapping of the map items, which keeps their geometry across the map border
+        double distance = x - unwrapBelowX;
+        distance += (distance < 0.0) ? 1.0 : 0.0;
+        x = (x < unwrapBelowX) ? unwrapBelowX + distance : x;
+    }
+    return QDoubleVector2D(x, projection.y());
+}
+
+// The loop of wrapMapProjections(), made once for each mode so that nothing is left to branch on
+template <WrapMode Mode, bool Unwrap, typename Input, typename Output>
+bool wrapProjections(const Input &projections, int count, Output output, double cameraCenterX, double unwrapBelowX)
+{
+    double nonFinite = 0.0; // becomes NaN with the first infinite or NaN coordinate
+    for (int i = 0; i < count; ++i) {
+        const QDoubleVector2D wrapped = wrapProjection<Mode, Unwrap>(projections[i], cameraCenterX, unwrapBelowX);
+        nonFinite += (wrapped.x() - wrapped.x()) + (wrapped.y() - wrapped.y());
+        output(i, wrapped);
+    }
+    return nonFinite == 0.0;
+}
+
+template <typename Input, typename Output>
+bool dispatchWrapProjections(const Input &projections, int count, Output output, bool unwrap,
+                             double cameraCenterX, double unwrapBelowX)
+{
+    if (cameraCenterX < 0.5) {
+        return unwrap ? wrapProjections<WrapAbove, true>(projections, count, output, cameraCenterX, unwrapBelowX)
+                      : wrapProjections<WrapAbove, false>(projections, count, output, cameraCenterX, unwrapBelowX);
+    }
+    if (cameraCenterX > 0.5) {
+        return unwrap ? wrapProjections<WrapBelow, true>(projections, count, output, cameraCenterX, unwrapBelowX)
+                      : wrapProjections<WrapBelow, false>(projections, count, output, cameraCenterX, unwrapBelowX);
+    }
+    return unwrap ? wrapProjections<WrapNone, true>(projections, count, output, cameraCenterX, unwrapBelowX)
+                  : wrapProjections<WrapNone, false>(projections, count, output, cameraCenterX, unwrapBelowX);
+}
+}
+
 QT_BEGIN_NAMESPACE
 
 QGeoProjection::QGeoProjection()
@@ -306,6 +361,16 @@ QDoubleVector2D QGeoProjectionWebMercator::geoToMapProjection(const QGeoCoordina
     return QWebMercator::coordToMercator(coordinate);
 }
 
+QList<QDoubleVector2D> QGeoProjectionWebMercator::geoToMapProjection(const QList<QGeoCoordinate> &coordinates) const
+{
+    return QWebMercator::coordToMercator(coordinates);
+}
+
+QList<QDoubleVector2D> QGeoProjectionWebMercator::geoToMapProjection(QGeoCoordinateSpan coordinates) const
+{
+    return QWebMercator::coordToMercator(coordinates);
+}
+
 QGeoCoordinate QGeoProjectionWebMercator::mapProjectionToGeo(const QDoubleVector2D &projection) const
 {
     return QWebMercator::mercatorToCoord(projection);
@@ -330,6 +395,38 @@ QDoubleVector2D QGeoProjectionWebMercator::wrapMapProjection(const QDoubleVector
     return QDoubleVector2D(projection.x() + double(projectionWrapFactor(projection)), projection.y());
 }
 
+/*
+    Wraps the \a count \a projections into \a wrapped, which may be the same array, as
+    wrapMapProjection() does. If \a unwrap is set, the wrapped projections left of \a unwrapBelowX
+    are moved right by the width of the map, the way the map items keep their geometry together
+    across the map border. Returns false if a projection is not finite, in which case the
+    content of \a wrapped is undefined.
+
+    The wrap mode is picked once for all the projections, so that the loop has no branch left.
+*/
+bool QGeoProjectionWebMercator::wrapMapProjections(const QDoubleVector2D *projections, QDoubleVector2D *wrapped,
+                                                   int count, bool unwrap, double unwrapBelowX) const
+{
+    return dispatchWrapProjections(projections, count,
+                                   [wrapped](int i, const QDoubleVector2D &projection) { wrapped[i] = projection; },
+                                   unwrap, m_cameraCenterXMercator, unwrapBelowX);
+}
+
+/*
+    \overload
+
+    Appends the wrapped \a projections to \a wrapped.
+*/
+bool QGeoProjectionWebMercator::wrapMapProjections(const QList<QDoubleVector2D> &projections,
+                                                   QList<QDoubleVector2D> &wrapped,
+                                                   bool unwrap, double unwrapBelowX) const
+{
+    wrapped.reserve(wrapped.size() + projections.size());
+    return dispatchWrapProjections(projections, projections.size(),
+                                   [&wrapped](int, const QDoubleVector2D &projection) { wrapped.append(projection); },
+                                   unwrap, m_cameraCenterXMercator, unwrapBelowX);
+}
+
 QDoubleVector2D QGeoProjectionWebMercator::unwrapMapProjection(const QDoubleVector2D &wrappedProjection) const
 {
     double x = wrappedProjection.x();
@@ -345,6 +442,12 @@ QDoubleVector2D QGeoProjectionWebMercator::wrappedMapProjectionToItemPosition(co
     return (m_transformation * wrappedProjection).toVector2D();
 }
 
+// count points as consecutive x and y pairs, itemPositions may be wrappedProjections
+void QGeoProjectionWebMercator::wrappedMapProjectionToItemPosition(const double *wrappedProjections, double *itemPositions, int count) const
+{
+    m_transformation.map(wrappedProjections, itemPositions, count);
+}
+
 QDoubleVector2D QGeoProjectionWebMercator::itemPositionToWrappedMapProjection(const QDoubleVector2D &itemPosition) const
 {
     const QPointF centerOff = centerOffset(QSizeF(m_viewportWidth, m_viewportHeight), m_visibleArea);
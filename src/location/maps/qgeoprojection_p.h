@@ -51,6 +51,7 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeocameradata_p.h>
 #include <QtPositioning/private/qdoublematrix4x4_p.h>
+#include <QtPositioning/private/qgeopackedcoordinate_p.h>
 #include <QtPositioning/QGeoShape>
 #include <QMatrix4x4>
 #include <QTransform>
@@ -160,13 +161,20 @@ public:
     double mapHeight() const;
 
     QDoubleVector2D geoToMapProjection(const QGeoCoordinate &coordinate) const;
+    QList<QDoubleVector2D> geoToMapProjection(const QList<QGeoCoordinate> &coordinates) const;
+    QList<QDoubleVector2D> geoToMapProjection(QGeoCoordinateSpan coordinates) const;
     QGeoCoordinate mapProjectionToGeo(const QDoubleVector2D &projection) const;
 
     int projectionWrapFactor(const QDoubleVector2D &projection) const;
     QDoubleVector2D wrapMapProjection(const QDoubleVector2D &projection) const;
+    bool wrapMapProjections(const QDoubleVector2D *projections, QDoubleVector2D *wrapped, int count,
+                            bool unwrap = false, double unwrapBelowX = 0.0) const;
+    bool wrapMapProjections(const QList<QDoubleVector2D> &projections, QList<QDoubleVector2D> &wrapped,
+                            bool unwrap = false, double unwrapBelowX = 0.0) const;
     QDoubleVector2D unwrapMapProjection(const QDoubleVector2D &wrappedProjection) const;
 
     QDoubleVector2D wrappedMapProjectionToItemPosition(const QDoubleVector2D &wrappedProjection) const;
+    void wrappedMapProjectionToItemPosition(const double *wrappedProjections, double *itemPositions, int count) const;
     QDoubleVector2D itemPositionToWrappedMapProjection(const QDoubleVector2D &itemPosition) const;
 
     QDoubleVector2D geoToWrappedMapProjection(const QGeoCoordinate &coordinate) const;
@@ -0,0 +1,305 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeorequestscheduler_p.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QLocale>
+#include <QtCore/QPair>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QTimerEvent>
+#include <QtCore/qmath.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+static const qint64 InitialBackoff = 1000; // milliseconds
+static const qint64 MaxBackoff = 64000;
+
+// Engines are used from the thread they were created in
+static QThreadStorage<QGeoRequestScheduler *> schedulers;
+
+QGeoRequestScheduler::QGeoRequestScheduler()
+{
+    m_clock.start();
+}
+
+QGeoRequestScheduler::~QGeoRequestScheduler()
+{
+}
+
+/*
+    Returns the scheduler of the calling thread.
+*/
+QGeoRequestScheduler *QGeoRequestScheduler::instance()
+{
+    if (!schedulers.hasLocalData())
+        schedulers.setLocalData(new QGeoRequestScheduler);
+    return schedulers.localData();
+}
+
+/*
+    Lets \a host take \a rate requests per second on average, and \a burst
+    requests at once. A rate of 0 removes the limit.
+*/
+void QGeoRequestScheduler::setRateLimit(const QString &host, qreal rate, int burst)
+{
+    const bool known = m_hosts.contains(host);
+    Host &h = m_hosts[host];
+    h.rate = qMax<qreal>(0, rate);
+    h.burst = qMax(1, burst);
+    if (!known) {
+        h.tokens = h.burst;
+        h.refilled = m_clock.elapsed();
+    }
+    h.tokens = qMin<qreal>(h.tokens, h.burst);
+    dispatch();
+}
+
+/*
+    Sets the rate limit of \a host from the \c rate_limit and \c burst entries
+    of \a parameters under \a prefix, if there are any. A missing entry keeps
+    the current value.
+*/
+void QGeoRequestScheduler::configure(const QString &host, const QVariantMap &parameters,
+                                     const QString &prefix)
+{
+    const QVariant rate = parameters.value(prefix + QLatin1String("rate_limit"));
+    const QVariant burst = parameters.value(prefix + QLatin1String("burst"));
+    if (!rate.isValid() && !burst.isValid())
+        return;
+
+    const Host current = m_hosts.value(host);
+    setRateLimit(host, rate.isValid() ? rate.toDouble() : current.rate,
+                 burst.isValid() ? burst.toInt() : current.burst);
+}
+
+/*
+    Calls \a start once \a host can take another request, right away if it
+    can now. \a start returns false if it did not send anything, for instance
+    because \a request was aborted meanwhile, and the request is then not
+    counted. A request whose \a request object is destroyed, or emits an
+    aborted() signal as the replies do, before it starts is dropped.
+
+    If \a coalescingKey is not empty, a queued request with the same key is
+    dropped in favor of this one, and its \a superseded function called.
+*/
+void QGeoRequestScheduler::schedule(const QString &host, QObject *request,
+                                    const std::function<bool()> &start, Priority priority,
+                                    const QString &coalescingKey,
+                                    const std::function<void()> &superseded)
+{
+    if (!m_hosts.contains(host))
+        setRateLimit(host, 0, 1);
+    Host &h = m_hosts[host];
+
+    std::function<void()> supersededOld;
+    if (!coalescingKey.isEmpty()) {
+        for (int i = 0; i < h.queue.size(); ++i) {
+            if (h.queue.at(i).coalescingKey == coalescingKey) {
+                supersededOld = h.queue.takeAt(i).superseded;
+                break;
+            }
+        }
+    }
+
+    int position = 0;
+    while (position < h.queue.size() && h.queue.at(position).priority >= priority)
+        ++position;
+    h.queue.insert(position, Request { request, start, superseded, priority, coalescingKey });
+    if (request && request->metaObject()->indexOfSignal("aborted()") >= 0)
+        connect(request, SIGNAL(aborted()), this, SLOT(requestAborted()), Qt::UniqueConnection);
+
+    if (supersededOld)
+        supersededOld();
+    dispatch();
+}
+
+/*
+    Takes note of the HTTP status of a response from \a host. A 429 or 503
+    status pauses the host for the \a retryAfter header of the response, or
+    for a backoff doubling with every such response in a row.
+*/
+void QGeoRequestScheduler::reportResponse(const QString &host, int httpStatus,
+                                          const QByteArray &retryAfter)
+{
+    if (httpStatus == 429 || httpStatus == 503) {
+        if (!m_hosts.contains(host))
+            setRateLimit(host, 0, 1);
+        Host &h = m_hosts[host];
+        qint64 delay = parseRetryAfter(retryAfter);
+        if (delay < 0) {
+            h.backoff = h.backoff > 0 ? qMin(h.backoff * 2, MaxBackoff) : InitialBackoff;
+            delay = h.backoff;
+        }
+        h.pausedUntil = qMax(h.pausedUntil, m_clock.elapsed() + delay);
+        dispatch();
+    } else if (httpStatus >= 200 && httpStatus < 400) {
+        auto it = m_hosts.find(host);
+        if (it != m_hosts.end())
+            it->backoff = 0;
+    }
+}
+
+/*
+    Returns the number of requests queued for \a host.
+*/
+int QGeoRequestScheduler::pendingCount(const QString &host) const
+{
+    return m_hosts.value(host).queue.size();
+}
+
+/*
+    Returns the milliseconds to wait for a Retry-After header \a value, given
+    in seconds or as an HTTP date, or -1 if there is no valid value.
+*/
+qint64 QGeoRequestScheduler::parseRetryAfter(const QByteArray &value)
+{
+    const QByteArray trimmed = value.trimmed();
+    if (trimmed.isEmpty())
+        return -1;
+
+    bool ok = false;
+    const qint64 seconds = trimmed.toLongLong(&ok);
+    if (ok)
+        return qMax<qint64>(0, seconds) * 1000;
+
+    const QString text = QString::fromLatin1(trimmed);
+    QDateTime date = QDateTime::fromString(text, Qt::RFC2822Date);
+    if (!date.isValid()) {
+        date = QLocale::c().toDateTime(text, QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'"));
+        date.setTimeSpec(Qt::UTC);
+    }
+    if (!date.isValid())
+        return -1;
+    return qMax<qint64>(0, QDateTime::currentDateTimeUtc().msecsTo(date));
+}
+
+void QGeoRequestScheduler::requestAborted()
+{
+    QObject *request = sender();
+    for (Host &h : m_hosts) {
+        for (int i = h.queue.size() - 1; i >= 0; --i) {
+            if (h.queue.at(i).request == request)
+                h.queue.removeAt(i);
+        }
+    }
+}
+
+void QGeoRequestScheduler::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timer.timerId())
+        return QObject::timerEvent(event);
+
+    m_timer.stop();
+    dispatch();
+}
+
+/*
+    Starts the requests the hosts can take and waits for the next one.
+    Requests are taken out of the queues before starting them, as starting
+    one may schedule others, which are then looked at in another pass.
+*/
+void QGeoRequestScheduler::dispatch()
+{
+    if (m_dispatching) {
+        m_rescan = true;
+        return;
+    }
+    m_dispatching = true;
+
+    qint64 wait;
+    bool refunded;
+    do {
+        m_rescan = false;
+        const qint64 now = m_clock.elapsed();
+        QList<QPair<QString, Request>> ready;
+        wait = -1;
+        for (auto it = m_hosts.begin(); it != m_hosts.end(); ++it) {
+            Host &h = it.value();
+            for (int i = h.queue.size() - 1; i >= 0; --i) {
+                if (h.queue.at(i).request.isNull())
+                    h.queue.removeAt(i);
+            }
+            if (h.queue.isEmpty())
+                continue;
+
+            qint64 hostWait;
+            if (now < h.pausedUntil) {
+                hostWait = h.pausedUntil - now;
+            } else if (h.rate <= 0) {
+                while (!h.queue.isEmpty())
+                    ready.append(qMakePair(it.key(), h.queue.takeFirst()));
+                continue;
+            } else {
+                h.tokens = qMin<qreal>(h.burst, h.tokens + (now - h.refilled) * h.rate / 1000);
+                h.refilled = now;
+                while (!h.queue.isEmpty() && h.tokens >= 1) {
+                    h.tokens -= 1;
+                    ready.append(qMakePair(it.key(), h.queue.takeFirst()));
+                }
+                if (h.queue.isEmpty())
+                    continue;
+                hostWait = qMax<qint64>(1, qCeil((1 - h.tokens) * 1000 / h.rate));
+            }
+            wait = wait < 0 ? hostWait : qMin(wait, hostWait);
+        }
+
+        refunded = false;
+        for (const QPair<QString, Request> &entry : qAsConst(ready)) {
+            if (!entry.second.request.isNull() && entry.second.start())
+                continue;
+            Host &h = m_hosts[entry.first];
+            if (h.rate > 0) {
+                h.tokens = qMin<qreal>(h.burst, h.tokens + 1);
+                refunded = true;
+            }
+        }
+    } while (refunded || m_rescan);
+
+    if (wait >= 0)
+        m_timer.start(int(qMin<qint64>(wait, std::numeric_limits<int>::max())), this);
+    else
+        m_timer.stop();
+
+    m_dispatching = false;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOREQUESTSCHEDULER_P_H
+#define QGEOREQUESTSCHEDULER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QVariantMap>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Paces the requests geoservice engines send to a host with a token bucket,
+    so providers don't answer them with 429 Too Many Requests. Queued requests
+    start by priority, then in order. A request scheduled with the coalescing
+    key of one still queued supersedes it. After a 429 or 503 response the
+    host is paused for the time of its Retry-After header, or an exponential
+    backoff without one.
+
+    The scheduler knows nothing about the network: engines pass a function
+    sending the request, and report the status of the responses. There is
+    one scheduler per thread, shared by the engines of all plugins.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoRequestScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        BackgroundPriority,
+        NormalPriority,
+        InteractivePriority
+    };
+
+    ~QGeoRequestScheduler();
+
+    static QGeoRequestScheduler *instance();
+
+    void setRateLimit(const QString &host, qreal rate, int burst);
+    void configure(const QString &host, const QVariantMap &parameters, const QString &prefix);
+
+    void schedule(const QString &host, QObject *request, const std::function<bool()> &start,
+                  Priority priority = NormalPriority, const QString &coalescingKey = QString(),
+                  const std::function<void()> &superseded = std::function<void()>());
+    void reportResponse(const QString &host, int httpStatus, const QByteArray &retryAfter);
+
+    int pendingCount(const QString &host) const;
+
+    static qint64 parseRetryAfter(const QByteArray &value);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private Q_SLOTS:
+    void requestAborted();
+
+private:
+    QGeoRequestScheduler();
+
+    struct Request
+    {
+        QPointer<QObject> request;
+        std::function<bool()> start;
+        std::function<void()> superseded;
+        Priority priority;
+        QString coalescingKey;
+    };
+
+    struct Host
+    {
+        qreal rate = 0; // requests per second, 0 for no limit
+        int burst = 1;
+        qreal tokens = 1;
+        qint64 refilled = 0;
+        qint64 pausedUntil = 0;
+        qint64 backoff = 0; // milliseconds, doubled by each throttled response
+        QList<Request> queue; // by descending priority, then in order
+    };
+
+    void dispatch();
+
+    QHash<QString, Host> m_hosts;
+    QElapsedTimer m_clock;
+    QBasicTimer m_timer;
+    bool m_dispatching = false;
+    bool m_rescan = false;
+
+    Q_DISABLE_COPY(QGeoRequestScheduler)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOREQUESTSCHEDULER_P_H
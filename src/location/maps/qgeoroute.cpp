@@ -458,6 +458,16 @@ void QGeoRoutePrivate::setPath(const QList<QGeoCoordinate> &path)
     Q_UNUSED(path);
 }
 
+/*
+    Sets the path of the leg to the \a count coordinates of \a path starting
+    at \a first. Implementations may keep a reference to \a path, the path of
+    the overall route, instead of a copy of the slice.
+*/
+void QGeoRoutePrivate::setPathSlice(const QList<QGeoCoordinate> &path, int first, int count)
+{
+    setPath(path.mid(first, count));
+}
+
 QList<QGeoCoordinate> QGeoRoutePrivate::path() const
 {
     return QList<QGeoCoordinate>();
@@ -478,6 +488,11 @@ const QGeoRoutePrivate *QGeoRoutePrivate::routePrivateData(const QGeoRoute &rout
     return route.d_ptr.data();
 }
 
+QGeoRoutePrivate *QGeoRoutePrivate::get(QGeoRoute &route)
+{
+    return route.d_ptr.data();
+}
+
 QVariantMap QGeoRoutePrivate::metadata() const
 {
     return QVariantMap();
@@ -543,6 +558,8 @@ QGeoRoutePrivateDefault::QGeoRoutePrivateDefault(const QGeoRoutePrivateDefault &
       m_distance(other.m_distance),
       m_travelMode(other.m_travelMode),
       m_path(other.m_path),
+      m_pathFirst(other.m_pathFirst),
+      m_pathCount(other.m_pathCount),
       m_legs(other.m_legs),
       m_firstSegment(other.m_firstSegment),
       m_numSegments(other.m_numSegments),
@@ -619,11 +636,22 @@ QGeoRouteRequest::TravelMode QGeoRoutePrivateDefault::travelMode() const
 void QGeoRoutePrivateDefault::setPath(const QList<QGeoCoordinate> &path)
 {
     m_path = path;
+    m_pathFirst = 0;
+    m_pathCount = -1;
+}
+
+void QGeoRoutePrivateDefault::setPathSlice(const QList<QGeoCoordinate> &path, int first, int count)
+{
+    m_path = path;
+    m_pathFirst = first;
+    m_pathCount = count;
 }
 
 QList<QGeoCoordinate> QGeoRoutePrivateDefault::path() const
 {
-    return m_path;
+    if (m_pathCount < 0)
+        return m_path;
+    return m_path.mid(m_pathFirst, m_pathCount);
 }
 
 void QGeoRoutePrivateDefault::setFirstSegment(const QGeoRouteSegment &firstSegment)
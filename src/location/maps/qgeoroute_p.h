@@ -91,6 +91,7 @@ public:
     virtual QGeoRouteRequest::TravelMode travelMode() const;
 
     virtual void setPath(const QList<QGeoCoordinate> &path);
+    virtual void setPathSlice(const QList<QGeoCoordinate> &path, int first, int count);
     virtual QList<QGeoCoordinate> path() const;
 
     virtual void setFirstSegment(const QGeoRouteSegment &firstSegment);
@@ -114,6 +115,7 @@ public:
     virtual QGeoRoute containingRoute() const;
 
     static const QGeoRoutePrivate *routePrivateData(const QGeoRoute &route);
+    static QGeoRoutePrivate *get(QGeoRoute &route);
 
 protected:
     virtual bool equals(const QGeoRoutePrivate &other) const;
@@ -146,6 +148,7 @@ public:
     virtual QGeoRouteRequest::TravelMode travelMode() const override;
 
     virtual void setPath(const QList<QGeoCoordinate> &path) override;
+    virtual void setPathSlice(const QList<QGeoCoordinate> &path, int first, int count) override;
     virtual QList<QGeoCoordinate> path() const override;
 
     virtual void setFirstSegment(const QGeoRouteSegment &firstSegment) override;
@@ -177,7 +180,9 @@ public:
 
     QGeoRouteRequest::TravelMode m_travelMode;
 
-    QList<QGeoCoordinate> m_path;
+    QList<QGeoCoordinate> m_path; // the whole route path when m_pathCount >= 0
+    int m_pathFirst = 0;
+    int m_pathCount = -1;
     QList<QGeoRouteLeg> m_legs;
     QGeoRouteSegment m_firstSegment;
     mutable int m_numSegments;
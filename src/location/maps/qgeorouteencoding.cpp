@@ -0,0 +1,395 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeorouteencoding_p.h"
+#include "qgeoroute.h"
+#include "qgeoroutesegment.h"
+#include "qgeomaneuver.h"
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qnumeric.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+enum RouteFlag {
+    HasAltitude = 0x1,
+    HasExtendedAttributes = 0x2
+};
+
+enum ManeuverFlag {
+    ManeuverValid = 0x1,
+    HasPosition = 0x2,
+    HasWaypoint = 0x4,
+    HasManeuverAttributes = 0x8
+};
+
+const int StreamVersion = QDataStream::Qt_5_15;
+
+struct Writer
+{
+    QByteArray &out;
+    int precision;
+    bool altitude;
+    QGeoShapeEncoding::Delta delta;
+
+    void varint(quint64 value) { QGeoShapeEncoding::encodeVarint(value, out); }
+    void integer(qint64 value) { varint((quint64(value) << 1) ^ quint64(value >> 63)); }
+    void real(double value) { QGeoShapeEncoding::encodeDouble(value, out); }
+
+    void string(const QString &string)
+    {
+        const QByteArray utf8 = string.toUtf8();
+        varint(quint64(utf8.size()));
+        out.append(utf8);
+    }
+
+    void attributes(const QVariantMap &attributes)
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(StreamVersion);
+        stream << attributes;
+        varint(quint64(data.size()));
+        out.append(data);
+    }
+
+    void coordinate(const QGeoCoordinate &coordinate)
+    {
+        const QGeoPackedCoordinate c = QGeoPackedCoordinate::fromCoordinate(coordinate);
+        QGeoShapeEncoding::encodeCoordinates(QGeoCoordinateSpan(&c, 1), precision, altitude,
+                                             &delta, out);
+    }
+
+    void path(const QList<QGeoCoordinate> &path)
+    {
+        const QGeoPackedCoordinates packed = qPackCoordinates(path);
+        varint(quint64(packed.size()));
+        QGeoShapeEncoding::encodeCoordinates(packed, precision, altitude, &delta, out);
+    }
+};
+
+struct Reader
+{
+    const char *it;
+    const char *end;
+    int precision;
+    bool altitude;
+    QGeoShapeEncoding::Delta delta;
+
+    bool varint(quint64 *value) { return QGeoShapeEncoding::decodeVarint(it, end, value); }
+    bool real(double *value) { return QGeoShapeEncoding::decodeDouble(it, end, value); }
+
+    bool integer(int *value)
+    {
+        quint64 encoded;
+        if (!varint(&encoded))
+            return false;
+        const qint64 decoded = qint64(encoded >> 1) ^ -qint64(encoded & 1);
+        if (decoded < std::numeric_limits<int>::min() || decoded > std::numeric_limits<int>::max())
+            return false;
+        *value = int(decoded);
+        return true;
+    }
+
+    bool bytes(QByteArray *bytes)
+    {
+        int size;
+        if (!QGeoShapeEncoding::decodeCount(it, end, 1, &size))
+            return false;
+        *bytes = QByteArray(it, size);
+        it += size;
+        return true;
+    }
+
+    bool string(QString *string)
+    {
+        QByteArray utf8;
+        if (!bytes(&utf8))
+            return false;
+        *string = QString::fromUtf8(utf8);
+        return true;
+    }
+
+    bool attributes(QVariantMap *attributes)
+    {
+        QByteArray data;
+        if (!bytes(&data))
+            return false;
+        QDataStream stream(data);
+        stream.setVersion(StreamVersion);
+        stream >> *attributes;
+        return stream.status() == QDataStream::Ok;
+    }
+
+    bool coordinate(QGeoCoordinate *coordinate)
+    {
+        QGeoPackedCoordinate c;
+        if (!QGeoShapeEncoding::decodeCoordinates(it, end, 1, precision, altitude, &delta, &c))
+            return false;
+        *coordinate = c.toCoordinate();
+        return true;
+    }
+
+    // the public route API takes lists, so the vertices are converted once here
+    bool path(QList<QGeoCoordinate> *path)
+    {
+        int count;
+        if (!QGeoShapeEncoding::decodeCount(it, end, altitude ? 3 : 2, &count))
+            return false;
+        QGeoPackedCoordinates packed(count);
+        if (!QGeoShapeEncoding::decodeCoordinates(it, end, count, precision, altitude, &delta,
+                                                  packed.data())) {
+            return false;
+        }
+        *path = qUnpackCoordinates(packed);
+        return true;
+    }
+};
+
+bool hasAltitude(const QList<QGeoCoordinate> &coordinates)
+{
+    for (const QGeoCoordinate &c : coordinates) {
+        if (!qIsNaN(c.altitude()))
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void QGeoRouteEncoding::encode(const QGeoRoute &route, QByteArray &out, int precision)
+{
+    precision = qBound(0, precision, int(QGeoShapeEncoding::MaximumPrecision));
+
+    QVector<QGeoRouteSegment> segments;
+    for (QGeoRouteSegment s = route.firstRouteSegment(); s.isValid(); s = s.nextRouteSegment())
+        segments.append(s);
+
+    bool altitude = hasAltitude(route.path());
+    for (int i = 0; i < segments.size() && !altitude; ++i) {
+        const QGeoManeuver maneuver = segments.at(i).maneuver();
+        altitude = hasAltitude(segments.at(i).path())
+                || (maneuver.isValid() && (!qIsNaN(maneuver.position().altitude())
+                                           || !qIsNaN(maneuver.waypoint().altitude())));
+    }
+    const QVariantMap attributes = route.extendedAttributes();
+
+    uchar flags = 0;
+    if (altitude)
+        flags |= HasAltitude;
+    if (!attributes.isEmpty())
+        flags |= HasExtendedAttributes;
+    out.append(char(Version));
+    out.append(char(flags));
+    out.append(char(precision));
+
+    Writer writer = { out, precision, altitude, {} };
+    writer.string(route.routeId());
+    writer.varint(quint64(route.travelMode()));
+    writer.integer(route.travelTime());
+    writer.real(route.distance());
+    QGeoShapeEncoding::encode(route.bounds(), out, precision);
+    writer.path(route.path());
+    if (!attributes.isEmpty())
+        writer.attributes(attributes);
+
+    writer.varint(quint64(segments.size()));
+    for (const QGeoRouteSegment &segment : qAsConst(segments)) {
+        writer.integer(segment.travelTime());
+        writer.real(segment.distance());
+        writer.path(segment.path());
+
+        const QGeoManeuver maneuver = segment.maneuver();
+        uchar maneuverFlags = 0;
+        if (maneuver.isValid()) {
+            maneuverFlags |= ManeuverValid;
+            if (maneuver.position().isValid())
+                maneuverFlags |= HasPosition;
+            if (maneuver.waypoint().isValid())
+                maneuverFlags |= HasWaypoint;
+            if (!maneuver.extendedAttributes().isEmpty())
+                maneuverFlags |= HasManeuverAttributes;
+        }
+        out.append(char(maneuverFlags));
+        if (!maneuver.isValid())
+            continue;
+        writer.string(maneuver.instructionText());
+        writer.varint(quint64(maneuver.direction()));
+        writer.integer(maneuver.timeToNextInstruction());
+        writer.real(maneuver.distanceToNextInstruction());
+        if (maneuverFlags & HasPosition)
+            writer.coordinate(maneuver.position());
+        if (maneuverFlags & HasWaypoint)
+            writer.coordinate(maneuver.waypoint());
+        if (maneuverFlags & HasManeuverAttributes)
+            writer.attributes(maneuver.extendedAttributes());
+    }
+}
+
+QByteArray QGeoRouteEncoding::encode(const QGeoRoute &route, int precision)
+{
+    QByteArray out;
+    encode(route, out, precision);
+    return out;
+}
+
+bool QGeoRouteEncoding::decode(const char *data, qint64 size, QGeoRoute *route, qint64 *consumed)
+{
+    if (size < 3)
+        return false;
+    const int version = uchar(data[0]);
+    const uchar flags = uchar(data[1]);
+    const int precision = uchar(data[2]);
+    if (version < 1 || version > Version || precision > QGeoShapeEncoding::MaximumPrecision)
+        return false;
+
+    Reader reader = { data + 3, data + size, precision, bool(flags & HasAltitude), {} };
+    QGeoRoute result;
+    QString id;
+    quint64 travelMode;
+    int travelTime;
+    double distance;
+    if (!reader.string(&id) || !reader.varint(&travelMode) || !reader.integer(&travelTime)
+            || !reader.real(&distance)) {
+        return false;
+    }
+    result.setRouteId(id);
+    result.setTravelMode(QGeoRouteRequest::TravelMode(travelMode));
+    result.setTravelTime(travelTime);
+    result.setDistance(distance);
+
+    QGeoShape bounds;
+    qint64 boundsSize;
+    if (!QGeoShapeEncoding::decode(reader.it, reader.end - reader.it, &bounds, &boundsSize)
+            || bounds.type() != QGeoShape::RectangleType) {
+        return false;
+    }
+    reader.it += boundsSize;
+    result.setBounds(bounds);
+
+    QList<QGeoCoordinate> path;
+    if (!reader.path(&path))
+        return false;
+    result.setPath(path);
+    if (flags & HasExtendedAttributes) {
+        QVariantMap attributes;
+        if (!reader.attributes(&attributes))
+            return false;
+        result.setExtendedAttributes(attributes);
+    }
+
+    int count;
+    // a segment takes at least its time, distance, vertex count and maneuver flags
+    if (!QGeoShapeEncoding::decodeCount(reader.it, reader.end, 11, &count))
+        return false;
+    QGeoRouteSegment previous;
+    for (int i = 0; i < count; ++i) {
+        QGeoRouteSegment segment;
+        int segmentTime;
+        double segmentDistance;
+        QList<QGeoCoordinate> segmentPath;
+        if (!reader.integer(&segmentTime) || !reader.real(&segmentDistance)
+                || !reader.path(&segmentPath) || reader.it == reader.end) {
+            return false;
+        }
+        segment.setTravelTime(segmentTime);
+        segment.setDistance(segmentDistance);
+        segment.setPath(segmentPath);
+
+        const uchar maneuverFlags = uchar(*reader.it++);
+        if (maneuverFlags & ManeuverValid) {
+            QGeoManeuver maneuver;
+            QString instruction;
+            quint64 direction;
+            int timeToNext;
+            double distanceToNext;
+            if (!reader.string(&instruction) || !reader.varint(&direction)
+                    || !reader.integer(&timeToNext) || !reader.real(&distanceToNext)) {
+                return false;
+            }
+            maneuver.setInstructionText(instruction);
+            maneuver.setDirection(QGeoManeuver::InstructionDirection(direction));
+            maneuver.setTimeToNextInstruction(timeToNext);
+            maneuver.setDistanceToNextInstruction(distanceToNext);
+            QGeoCoordinate coordinate;
+            if (maneuverFlags & HasPosition) {
+                if (!reader.coordinate(&coordinate))
+                    return false;
+                maneuver.setPosition(coordinate);
+            }
+            if (maneuverFlags & HasWaypoint) {
+                if (!reader.coordinate(&coordinate))
+                    return false;
+                maneuver.setWaypoint(coordinate);
+            }
+            if (maneuverFlags & HasManeuverAttributes) {
+                QVariantMap attributes;
+                if (!reader.attributes(&attributes))
+                    return false;
+                maneuver.setExtendedAttributes(attributes);
+            }
+            segment.setManeuver(maneuver);
+        }
+
+        if (i == 0)
+            result.setFirstRouteSegment(segment);
+        else
+            previous.setNextRouteSegment(segment);
+        previous = segment;
+    }
+
+    *route = result;
+    if (consumed)
+        *consumed = reader.it - data;
+    return true;
+}
+
+bool QGeoRouteEncoding::decode(const QByteArray &data, QGeoRoute *route)
+{
+    qint64 consumed;
+    return decode(data.constData(), data.size(), route, &consumed) && consumed == data.size();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEENCODING_P_H
+#define QGEOROUTEENCODING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qgeoshapeencoding_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRoute;
+
+/*
+    A compact, versioned binary encoding of routes, using the coordinate
+    encoding of QGeoShapeEncoding for the route path, its bounds and the
+    paths and maneuver positions of its segments. The deltas run through all
+    of them in order, so a segment path continuing the previous one costs
+    about as much as a polyline6 string.
+
+    Kept are the id, travel mode, time and distance, the extended attributes
+    of the route and its maneuvers, and the segments. The request and the
+    legs, which refer to their own overall route, are not.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoRouteEncoding
+{
+public:
+    enum { Version = 1 };
+
+    static void encode(const QGeoRoute &route, QByteArray &out,
+                       int precision = QGeoShapeEncoding::DefaultPrecision);
+    static QByteArray encode(const QGeoRoute &route,
+                             int precision = QGeoShapeEncoding::DefaultPrecision);
+    // Decodes one route from the start of data. Returns false for malformed
+    // data or a newer version, otherwise consumed is set to the bytes read.
+    static bool decode(const char *data, qint64 size, QGeoRoute *route, qint64 *consumed = nullptr);
+    static bool decode(const QByteArray &data, QGeoRoute *route);
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOROUTEENCODING_P_H
@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutematrixreply.h"
+#include "qgeoroutematrixreply_p.h"
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QGeoRouteMatrixReply
+    \inmodule QtLocation
+    \ingroup QtLocation-routing
+    \since 5.15
+
+    \brief The QGeoRouteMatrixReply class manages the calculation of the
+    travel times and distances between sets of coordinates.
+
+    A QGeoRouteMatrixReply is returned by
+    QGeoRoutingManager::calculateRouteMatrix(). Once it has finished without
+    error, durations() and distances() hold a value for each pair of one of
+    the origins() and one of the destinations(), without the routes they were
+    computed from.
+
+    The values are stored by origin, then destination: the value from origin
+    \c i to destination \c j is at index \c{i * destinations().size() + j},
+    which duration() and distance() look up. A pair the service found no
+    route for has a value of NaN.
+
+    The routes() of the reply are always empty.
+*/
+
+/*!
+    Constructs a route matrix reply with a given \a error and \a errorString
+    and the specified \a parent.
+*/
+QGeoRouteMatrixReply::QGeoRouteMatrixReply(Error error, const QString &errorString, QObject *parent)
+    : QGeoRouteReply(error, errorString, parent),
+      d_ptr(new QGeoRouteMatrixReplyPrivate(QList<QGeoCoordinate>(), QList<QGeoCoordinate>()))
+{
+}
+
+/*!
+    Constructs a reply for the travel times and distances from each of
+    \a origins to each of \a destinations, with the travel options of
+    \a request and the specified \a parent.
+*/
+QGeoRouteMatrixReply::QGeoRouteMatrixReply(const QList<QGeoCoordinate> &origins,
+                                           const QList<QGeoCoordinate> &destinations,
+                                           const QGeoRouteRequest &request, QObject *parent)
+    : QGeoRouteReply(request, parent),
+      d_ptr(new QGeoRouteMatrixReplyPrivate(origins, destinations))
+{
+}
+
+/*!
+    Destroys this reply object.
+*/
+QGeoRouteMatrixReply::~QGeoRouteMatrixReply()
+{
+    delete d_ptr;
+}
+
+/*!
+    Returns the coordinates the travel times and distances are from.
+*/
+QList<QGeoCoordinate> QGeoRouteMatrixReply::origins() const
+{
+    return d_ptr->origins;
+}
+
+/*!
+    Returns the coordinates the travel times and distances are to.
+*/
+QList<QGeoCoordinate> QGeoRouteMatrixReply::destinations() const
+{
+    return d_ptr->destinations;
+}
+
+/*!
+    Returns the travel times in seconds, by origin then destination.
+*/
+QVector<double> QGeoRouteMatrixReply::durations() const
+{
+    return d_ptr->durations;
+}
+
+/*!
+    Returns the distances in meters, by origin then destination.
+*/
+QVector<double> QGeoRouteMatrixReply::distances() const
+{
+    return d_ptr->distances;
+}
+
+/*!
+    Returns the travel time in seconds from the origin at index \a origin to
+    the destination at index \a destination, or NaN if it is not known.
+*/
+double QGeoRouteMatrixReply::duration(int origin, int destination) const
+{
+    const int i = d_ptr->index(origin, destination);
+    return i < 0 ? std::numeric_limits<double>::quiet_NaN() : d_ptr->durations.at(i);
+}
+
+/*!
+    Returns the distance in meters from the origin at index \a origin to the
+    destination at index \a destination, or NaN if it is not known.
+*/
+double QGeoRouteMatrixReply::distance(int origin, int destination) const
+{
+    const int i = d_ptr->index(origin, destination);
+    return i < 0 ? std::numeric_limits<double>::quiet_NaN() : d_ptr->distances.at(i);
+}
+
+/*!
+    Sets the travel times and distances from the \a originCount origins
+    starting at index \a firstOrigin to the destinations starting at index
+    \a firstDestination, as many as \a durations holds for each origin.
+
+    \a durations and \a distances are stored by origin then destination, like
+    durations(). Either may be empty if the service does not return it, and
+    values outside of the matrix are ignored. The reply is not finished by
+    this function.
+*/
+void QGeoRouteMatrixReply::setBlock(int firstOrigin, int firstDestination, int originCount,
+                                    const QVector<double> &durations,
+                                    const QVector<double> &distances)
+{
+    if (originCount <= 0)
+        return;
+    const int destinationCount = qMax(durations.size(), distances.size()) / originCount;
+    for (int i = 0; i < originCount; ++i) {
+        for (int j = 0; j < destinationCount; ++j) {
+            const int index = d_ptr->index(firstOrigin + i, firstDestination + j);
+            if (index < 0)
+                continue;
+            const int block = i * destinationCount + j;
+            if (block < durations.size())
+                d_ptr->durations[index] = durations.at(block);
+            if (block < distances.size())
+                d_ptr->distances[index] = distances.at(block);
+        }
+    }
+}
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoRouteMatrixReplyPrivate::QGeoRouteMatrixReplyPrivate(const QList<QGeoCoordinate> &origins,
+                                                         const QList<QGeoCoordinate> &destinations)
+    : origins(origins), destinations(destinations),
+      durations(origins.size() * destinations.size(), std::numeric_limits<double>::quiet_NaN()),
+      distances(origins.size() * destinations.size(), std::numeric_limits<double>::quiet_NaN())
+{
+}
+
+QT_END_NAMESPACE
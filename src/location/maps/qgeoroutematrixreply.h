@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEMATRIXREPLY_H
+#define QGEOROUTEMATRIXREPLY_H
+
+#include <QtLocation/QGeoRouteReply>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRouteMatrixReplyPrivate;
+
+class Q_LOCATION_EXPORT QGeoRouteMatrixReply : public QGeoRouteReply
+{
+    Q_OBJECT
+
+public:
+    explicit QGeoRouteMatrixReply(Error error, const QString &errorString, QObject *parent = nullptr);
+    ~QGeoRouteMatrixReply();
+
+    QList<QGeoCoordinate> origins() const;
+    QList<QGeoCoordinate> destinations() const;
+
+    QVector<double> durations() const;
+    QVector<double> distances() const;
+    double duration(int origin, int destination) const;
+    double distance(int origin, int destination) const;
+
+protected:
+    QGeoRouteMatrixReply(const QList<QGeoCoordinate> &origins,
+                         const QList<QGeoCoordinate> &destinations,
+                         const QGeoRouteRequest &request, QObject *parent = nullptr);
+
+    void setBlock(int firstOrigin, int firstDestination, int originCount,
+                  const QVector<double> &durations, const QVector<double> &distances);
+
+private:
+    QGeoRouteMatrixReplyPrivate *d_ptr;
+    Q_DISABLE_COPY(QGeoRouteMatrixReply)
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -38,11 +38,14 @@
 #include "qgeorouteparser_p_p.h"
 #include "qgeoroutesegment.h"
 #include "qgeomaneuver.h"
+#include "qgeoasyncparse_p.h"
 
 #include <QtCore/private/qobject_p.h>
+#include <QtCore/QCoreApplication>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
+#include <QtCore/QSharedPointer>
 #include <QtPositioning/private/qlocationutils_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -65,7 +68,11 @@ QGeoRouteParserPrivate::~QGeoRouteParserPrivate()
 
 QGeoRouteParser::~QGeoRouteParser()
 {
-
+    // The private, which does the parsing, is deleted only after this
+    Q_D(QGeoRouteParser);
+    QMutexLocker locker(&d->parsingMutex);
+    while (d->parsing > 0)
+        d->parsingDone.wait(&d->parsingMutex);
 }
 
 QGeoRouteParser::QGeoRouteParser(QGeoRouteParserPrivate &dd, QObject *parent) : QObject(dd, parent)
@@ -79,6 +86,42 @@ QGeoRouteReply::Error QGeoRouteParser::parseReply(QList<QGeoRoute> &routes, QStr
     return d->parseReply(routes, errorString, reply);
 }
 
+/*
+    Parses the reply on the global thread pool, and calls back with the result
+    in the thread of routeReply, through qParseReplyAsync(): once routeReply is aborted
+    or destroyed, the parse is skipped if it did not start yet and callback is
+    not called. The parser settings must not change while parsing is in flight.
+*/
+void QGeoRouteParser::parseReplyAsync(const QByteArray &reply, QGeoRouteReply *routeReply,
+                                      const ParseCallback &callback) const
+{
+    Q_D(const QGeoRouteParser);
+    {
+        QMutexLocker locker(&d->parsingMutex);
+        ++d->parsing;
+    }
+    // Released with the parse, whether it ran or was skipped, for the destructor to go on
+    const QSharedPointer<const QGeoRouteParserPrivate> parser(d, [](const QGeoRouteParserPrivate *d) {
+        QMutexLocker locker(&d->parsingMutex);
+        if (--d->parsing == 0)
+            d->parsingDone.wakeAll();
+    });
+
+    struct Parsed
+    {
+        QGeoRouteReply::Error error;
+        QString errorString;
+        QList<QGeoRoute> routes;
+    };
+    qParseReplyAsync(routeReply, [parser, reply](const QGeoParseCancellation &) {
+        Parsed parsed;
+        parsed.error = parser->parseReply(parsed.routes, parsed.errorString, reply);
+        return parsed;
+    }, [callback](const Parsed &parsed) {
+        callback(parsed.error, parsed.errorString, parsed.routes);
+    });
+}
+
 QUrl QGeoRouteParser::requestUrl(const QGeoRouteRequest &request, const QString &prefix) const
 {
     Q_D(const QGeoRouteParser);
@@ -54,6 +54,8 @@
 #include <QtCore/QByteArray>
 #include <QtCore/QUrl>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 
 class QGeoRouteParserPrivate;
@@ -68,8 +70,13 @@ public:
         RightHandTraffic,
         LeftHandTraffic
     };
+    typedef std::function<void(QGeoRouteReply::Error error, const QString &errorString,
+                               const QList<QGeoRoute> &routes)> ParseCallback;
+
     virtual ~QGeoRouteParser();
     QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const;
+    void parseReplyAsync(const QByteArray &reply, QGeoRouteReply *routeReply,
+                         const ParseCallback &callback) const;
     QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const;
 
     TrafficSide trafficSide() const;
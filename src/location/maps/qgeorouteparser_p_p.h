@@ -49,7 +49,9 @@
 //
 
 #include <QtCore/private/qobject_p.h>
+#include <QtCore/QMutex>
 #include <QtCore/QUrl>
+#include <QtCore/QWaitCondition>
 #include <QtLocation/qgeoroutereply.h>
 #include <QtLocation/qgeorouterequest.h>
 
@@ -66,6 +68,11 @@ public:
     virtual QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const = 0;
 
     QGeoRouteParser::TrafficSide trafficSide;
+
+    // parseReplyAsync() calls in flight, which the destructor waits for
+    mutable QMutex parsingMutex;
+    mutable QWaitCondition parsingDone;
+    mutable int parsing = 0;
 };
 
 QT_END_NAMESPACE
@@ -48,53 +48,72 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QUrlQuery>
 #include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qgeopath_p.h>
 #include <QtPositioning/qgeopath.h>
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
-static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
+// Decodes one value of a polyline and adds it to sum. Returns false when the
+// string ends in the middle of the value.
+static inline bool decodePolylineValue(const QChar *&it, const QChar *end, qint64 &sum)
 {
-    QList<QGeoCoordinate> path;
-    if (polylineString.isEmpty())
-        return path;
-
-    QByteArray data = polylineString.toLatin1();
-
-    bool parsingLatitude = true;
-
+    quint64 value = 0;
     int shift = 0;
-    int value = 0;
-
-    QGeoCoordinate coord(0, 0);
-
-    for (int i = 0; i < data.length(); ++i) {
-        unsigned char c = data.at(i) - 63;
+    while (it != end && shift < 64) {
+        const uint c = it->unicode() - 63u;
+        ++it;
 
-        value |= (c & 0x1f) << shift;
+        value |= quint64(c & 0x1f) << shift;
         shift += 5;
 
         // another chunk
         if (c & 0x20)
             continue;
 
-        int diff = (value & 1) ? ~(value >> 1) : (value >> 1);
+        sum += (value & 1) ? ~qint64(value >> 1) : qint64(value >> 1);
+        return true;
+    }
+    return false;
+}
 
-        if (parsingLatitude) {
-            coord.setLatitude(coord.latitude() + (double)diff/1e6);
-        } else {
-            coord.setLongitude(coord.longitude() + (double)diff/1e6);
-            path.append(coord);
-        }
+// Reads the characters of the string in place, and keeps the running sums in
+// integer micro degrees like the encoder does, so that rounding errors do not
+// build up along long routes.
+static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
+{
+    QList<QGeoCoordinate> path;
+    if (polylineString.isEmpty())
+        return path;
 
-        parsingLatitude = !parsingLatitude;
+    const QChar *it = polylineString.constData();
+    const QChar *end = it + polylineString.size();
+    path.reserve(polylineString.size() / 4); // usually 4 to 8 characters per point
 
-        value = 0;
-        shift = 0;
-    }
+    qint64 latitude = 0;
+    qint64 longitude = 0;
+    while (decodePolylineValue(it, end, latitude) && decodePolylineValue(it, end, longitude))
+        path.append(QGeoCoordinate(latitude / 1e6, longitude / 1e6));
 
     return path;
 }
 
+// The segments share their coordinates with the result, only the list is
+// allocated, once.
+static QList<QGeoCoordinate> concatenatedPath(const QList<QGeoRouteSegment> &segments)
+{
+    int size = 0;
+    for (const QGeoRouteSegment &s: segments)
+        size += s.path().size();
+
+    QList<QGeoCoordinate> path;
+    path.reserve(size);
+    for (const QGeoRouteSegment &s: segments)
+        path.append(s.path());
+    return path;
+}
+
 static QString cardinalDirection4(QLocationUtils::CardinalDirection direction)
 {
     switch (direction) {
@@ -937,6 +956,7 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
 
             QJsonArray legs = routeObject.value(QLatin1String("legs")).toArray();
             QList<QGeoRouteLeg> routeLegs;
+            QList<int> legSegmentCounts;
             QGeoRoute route;
             for (int legIndex = 0; legIndex < legs.size(); ++legIndex) {
                 const QJsonValue &l = legs.at(legIndex);
@@ -975,26 +995,36 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
 
                 QGeoRouteSegmentPrivate *segmentPrivate = QGeoRouteSegmentPrivate::get(segment);
                 segmentPrivate->setLegLastSegment(true);
-                QList<QGeoCoordinate> path;
-                for (const QGeoRouteSegment &s: qAsConst(legSegments))
-                    path.append(s.path());
                 routeLeg.setLegIndex(legIndex);
                 routeLeg.setOverallRoute(route); // QGeoRoute::d_ptr is explicitlySharedDataPointer. Modifiers below won't detach it.
                 routeLeg.setDistance(legDistance);
                 routeLeg.setTravelTime(legTravelTime);
-                if (!path.isEmpty()) {
-                    routeLeg.setPath(path);
+                if (!legSegments.isEmpty())
                     routeLeg.setFirstRouteSegment(legSegments.first());
-                }
                 routeLegs << routeLeg;
+                legSegmentCounts << legSegments.size();
 
                 segments.append(legSegments);
             }
 
             if (!error) {
-                QList<QGeoCoordinate> path;
-                foreach (const QGeoRouteSegment &s, segments)
-                    path.append(s.path());
+                const QList<QGeoCoordinate> path = concatenatedPath(segments);
+
+                // Legs and segments keep slices of the route path, so that its
+                // coordinates are stored in a single list.
+                int segmentIndex = 0;
+                int pathIndex = 0;
+                for (int legIndex = 0; legIndex < routeLegs.size(); ++legIndex) {
+                    const int legFirst = pathIndex;
+                    for (int i = 0; i < legSegmentCounts.at(legIndex); ++i, ++segmentIndex) {
+                        QGeoRouteSegmentPrivate *segmentPrivate = QGeoRouteSegmentPrivate::get(segments[segmentIndex]);
+                        const int count = segmentPrivate->path().size();
+                        segmentPrivate->setPathSlice(path, pathIndex, count);
+                        pathIndex += count;
+                    }
+                    if (pathIndex > legFirst)
+                        QGeoRoutePrivate::get(routeLegs[legIndex])->setPathSlice(path, legFirst, pathIndex - legFirst);
+                }
 
                 for (int i = segments.size() - 1; i > 0; --i)
                     segments[i-1].setNextRouteSegment(segments[i]);
@@ -1003,7 +1033,7 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
                 route.setTravelTime(travelTime);
                 if (!path.isEmpty()) {
                     route.setPath(path);
-                    route.setBounds(QGeoPath(path).boundingGeoRectangle());
+                    route.setBounds(QGeoPathBounds::rectangle(qPackCoordinates(path)));
                     route.setFirstRouteSegment(segments.first());
                 }
                 route.setRouteLegs(routeLegs);
@@ -1075,4 +1105,87 @@ void QGeoRouteParserOsrmV5::setExtension(const QGeoRouteParserOsrmV5Extension *e
         d->m_extension = extension;
 }
 
+/*
+    Returns the url of a table request from each of sources to each of
+    destinations, prefix being the service and profile, like
+    "http://router.project-osrm.org/table/v1/driving/". The extension is not
+    involved, its query items are those of routes.
+*/
+QUrl QGeoRouteParserOsrmV5::tableRequestUrl(const QList<QGeoCoordinate> &sources,
+                                            const QList<QGeoCoordinate> &destinations,
+                                            const QString &prefix) const
+{
+    QString tableUrl = prefix;
+    QString sourceIndexes;
+    QString destinationIndexes;
+    const QList<QGeoCoordinate> coordinates = sources + destinations;
+    for (int i = 0; i < coordinates.size(); ++i) {
+        const QGeoCoordinate &c = coordinates.at(i);
+        if (i > 0)
+            tableUrl.append(QLatin1Char(';'));
+        tableUrl.append(QString::number(c.longitude(), 'f', 7)).append(QLatin1Char(',')).append(QString::number(c.latitude(), 'f', 7));
+
+        QString &indexes = i < sources.size() ? sourceIndexes : destinationIndexes;
+        if (!indexes.isEmpty())
+            indexes.append(QLatin1Char(';'));
+        indexes.append(QString::number(i));
+    }
+
+    QUrl url(tableUrl);
+    QUrlQuery query;
+    query.addQueryItem(QLatin1String("sources"), sourceIndexes);
+    query.addQueryItem(QLatin1String("destinations"), destinationIndexes);
+    query.addQueryItem(QLatin1String("annotations"), QLatin1String("duration,distance"));
+    url.setQuery(query);
+    return url;
+}
+
+// Appends the rows of a table annotation, null for the pairs without a route
+static bool parseTable(QVector<double> &values, const QJsonValue &table, int columns)
+{
+    if (!table.isArray())
+        return false;
+    const QJsonArray rows = table.toArray();
+    values.reserve(rows.size() * columns);
+    for (const QJsonValue &row : rows) {
+        const QJsonArray cells = row.toArray();
+        if (cells.size() != columns)
+            return false;
+        for (const QJsonValue &cell : cells)
+            values.append(cell.isDouble() ? cell.toDouble() : std::numeric_limits<double>::quiet_NaN());
+    }
+    return true;
+}
+
+QGeoRouteReply::Error QGeoRouteParserOsrmV5::parseTableReply(QVector<double> &durations,
+                                                             QVector<double> &distances,
+                                                             QString &errorString,
+                                                             const QByteArray &reply) const
+{
+    // OSRM table service: http://project-osrm.org/docs/v5.22.0/api/#table-service
+    // Mapbox Matrix API: https://docs.mapbox.com/api/navigation/#matrix
+    const QJsonDocument document = QJsonDocument::fromJson(reply);
+    if (!document.isObject()) {
+        errorString = QLatin1String("Couldn't parse json.");
+        return QGeoRouteReply::ParseError;
+    }
+    const QJsonObject object = document.object();
+
+    const QString status = object.value(QLatin1String("code")).toString();
+    if (status != QLatin1String("Ok")) {
+        errorString = status;
+        return QGeoRouteReply::UnknownError;
+    }
+
+    const int columns = object.value(QLatin1String("destinations")).toArray().size();
+    const QJsonValue durationTable = object.value(QLatin1String("durations"));
+    const QJsonValue distanceTable = object.value(QLatin1String("distances"));
+    if ((!durationTable.isUndefined() && !parseTable(durations, durationTable, columns))
+            || (!distanceTable.isUndefined() && !parseTable(distances, distanceTable, columns))) {
+        errorString = QLatin1String("Malformed table");
+        return QGeoRouteReply::ParseError;
+    }
+    return QGeoRouteReply::NoError;
+}
+
 QT_END_NAMESPACE
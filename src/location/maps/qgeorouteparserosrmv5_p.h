@@ -50,6 +50,7 @@
 
 
 #include <QtLocation/private/qgeorouteparser_p.h>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -81,6 +82,12 @@ public:
 
     void setExtension(const QGeoRouteParserOsrmV5Extension *extension);
 
+    // The table service, durations and distances row-major by source
+    QUrl tableRequestUrl(const QList<QGeoCoordinate> &sources,
+                         const QList<QGeoCoordinate> &destinations, const QString &prefix) const;
+    QGeoRouteReply::Error parseTableReply(QVector<double> &durations, QVector<double> &distances,
+                                          QString &errorString, const QByteArray &reply) const;
+
 private:
     Q_DISABLE_COPY(QGeoRouteParserOsrmV5)
 };
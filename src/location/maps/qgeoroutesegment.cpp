@@ -341,6 +341,16 @@ void QGeoRouteSegmentPrivate::setPath(const QList<QGeoCoordinate> &path)
     Q_UNUSED(path);
 }
 
+/*
+    Sets the path of the segment to the \a count coordinates of \a path
+    starting at \a first. Implementations may keep a reference to \a path, the
+    route path, instead of a copy of the slice.
+*/
+void QGeoRouteSegmentPrivate::setPathSlice(const QList<QGeoCoordinate> &path, int first, int count)
+{
+    setPath(path.mid(first, count));
+}
+
 QGeoManeuver QGeoRouteSegmentPrivate::maneuver() const
 {
     return QGeoManeuver();
@@ -383,6 +393,8 @@ QGeoRouteSegmentPrivateDefault::QGeoRouteSegmentPrivateDefault(const QGeoRouteSe
       m_travelTime(other.m_travelTime),
       m_distance(other.m_distance),
       m_path(other.m_path),
+      m_pathFirst(other.m_pathFirst),
+      m_pathCount(other.m_pathCount),
       m_maneuver(other.m_maneuver)
 {
 
@@ -445,12 +457,23 @@ void QGeoRouteSegmentPrivateDefault::setDistance(qreal distance)
 
 QList<QGeoCoordinate> QGeoRouteSegmentPrivateDefault::path() const
 {
-    return m_path;
+    if (m_pathCount < 0)
+        return m_path;
+    return m_path.mid(m_pathFirst, m_pathCount);
 }
 
 void QGeoRouteSegmentPrivateDefault::setPath(const QList<QGeoCoordinate> &path)
 {
     m_path = path;
+    m_pathFirst = 0;
+    m_pathCount = -1;
+}
+
+void QGeoRouteSegmentPrivateDefault::setPathSlice(const QList<QGeoCoordinate> &path, int first, int count)
+{
+    m_path = path;
+    m_pathFirst = first;
+    m_pathCount = count;
 }
 
 QGeoManeuver QGeoRouteSegmentPrivateDefault::maneuver() const
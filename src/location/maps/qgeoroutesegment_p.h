@@ -85,6 +85,7 @@ public:
 
     virtual QList<QGeoCoordinate> path() const;
     virtual void setPath(const QList<QGeoCoordinate> &path);
+    virtual void setPathSlice(const QList<QGeoCoordinate> &path, int first, int count);
 
     virtual QGeoManeuver maneuver() const;
     virtual void setManeuver(const QGeoManeuver &maneuver);
@@ -125,6 +126,7 @@ public:
 
     virtual QList<QGeoCoordinate> path() const override;
     virtual void setPath(const QList<QGeoCoordinate> &path) override;
+    virtual void setPathSlice(const QList<QGeoCoordinate> &path, int first, int count) override;
 
     virtual QGeoManeuver maneuver() const override;
     virtual void setManeuver(const QGeoManeuver &maneuver) override;
@@ -134,7 +136,9 @@ public:
     bool m_legLastSegment = false;
     int m_travelTime;
     qreal m_distance;
-    QList<QGeoCoordinate> m_path;
+    QList<QGeoCoordinate> m_path; // the whole route path when m_pathCount >= 0
+    int m_pathFirst = 0;
+    int m_pathCount = -1;
     QGeoManeuver m_maneuver;
 };
 
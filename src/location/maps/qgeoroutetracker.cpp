@@ -0,0 +1,554 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeoroutetracker_p.h"
+#include "qgeoroute.h"
+#include "qgeorouterequest.h"
+#include "qgeoroutesegment.h"
+#include "qgeoroutesegment_p.h"
+#include "qgeomaneuver.h"
+
+#include <QtCore/QVector>
+#include <QtCore/qmath.h>
+#include <QtCore/qnumeric.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qgeopath_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Edges searched behind the last match, for positions jittering backwards
+const int EdgesBehind = 2;
+// The search goes at least that many edges and meters ahead of the last match
+const int EdgesAhead = 8;
+const double MetersAhead = 1000.0;
+
+struct Match
+{
+    int edge = -1;
+    double t = 0.0;
+    double squaredDistance = qInf(); // in degrees of latitude
+};
+
+}
+
+class QGeoRouteTrackerPrivate
+{
+public:
+    void build();
+    void nearest(Match &match, const QGeoCoordinate &position, int first, int last) const;
+    int edgeCount() const { return points.size() - 1; }
+
+    QGeoRoute route;
+    double offRouteThreshold = 50.0;
+
+    // Per point of the route path, at the point
+    QVector<QGeoCoordinate> points;
+    QVector<double> distances;
+    QVector<double> times;
+    // Per edge, from points[i] to points[i + 1]
+    QVector<int> edgeSegments;
+    // Per segment, at the next maneuver
+    QVector<double> maneuverDistances;
+    QVector<double> maneuverTimes;
+    QVector<int> segmentLegs;
+    // Per leg, at its end
+    QVector<double> legDistances;
+    QVector<double> legTimes;
+
+    int edge = -1;
+    bool onRoute = true;
+    double distanceFromRoute = 0.0;
+    double distance = 0.0;
+    double time = 0.0;
+    QGeoCoordinate matchedPosition;
+};
+
+void QGeoRouteTrackerPrivate::build()
+{
+    points.clear();
+    distances.clear();
+    times.clear();
+    edgeSegments.clear();
+    maneuverDistances.clear();
+    maneuverTimes.clear();
+    segmentLegs.clear();
+    legDistances.clear();
+    legTimes.clear();
+
+    QVector<double> segmentDistances;
+    QVector<double> segmentTimes;
+    QVector<bool> maneuvers;
+    double distance = 0.0;
+    double time = 0.0;
+    int leg = 0;
+    QGeoRouteSegment segment = route.firstRouteSegment();
+    while (segment.isValid()) {
+        const QList<QGeoCoordinate> path = segment.path();
+        const int segmentIndex = segmentLegs.size();
+
+        QVector<double> lengths(path.size(), 0.0);
+        for (int i = 1; i < path.size(); ++i)
+            lengths[i] = lengths[i - 1] + path.at(i - 1).distanceTo(path.at(i));
+        const double length = lengths.isEmpty() ? 0.0 : lengths.last();
+        const double segmentDistance = segment.distance() > 0 ? segment.distance() : length;
+        const double segmentTime = qMax(segment.travelTime(), 0);
+
+        for (int i = 0; i < path.size(); ++i) {
+            if (!points.isEmpty())
+                edgeSegments.append(segmentIndex);
+            const double f = length > 0 ? lengths.at(i) / length : 0.0;
+            points.append(path.at(i));
+            distances.append(distance + f * segmentDistance);
+            times.append(time + f * segmentTime);
+        }
+
+        distance += segmentDistance;
+        time += segmentTime;
+        segmentDistances.append(distance);
+        segmentTimes.append(time);
+        maneuvers.append(segment.maneuver().isValid());
+        segmentLegs.append(leg);
+        if (segment.isLegLastSegment()) {
+            legDistances.append(distance);
+            legTimes.append(time);
+            ++leg;
+        }
+        segment = segment.nextRouteSegment();
+    }
+    if (legDistances.size() < leg + 1 && segmentLegs.size() && segmentLegs.last() == leg) {
+        legDistances.append(distance);
+        legTimes.append(time);
+    }
+
+    // The maneuver of a segment is at its start, the end of the previous one
+    const int segmentCount = segmentLegs.size();
+    maneuverDistances.resize(segmentCount);
+    maneuverTimes.resize(segmentCount);
+    for (int i = segmentCount - 1; i >= 0; --i) {
+        if (i == segmentCount - 1 || maneuvers.at(i + 1)) {
+            maneuverDistances[i] = segmentDistances.at(i);
+            maneuverTimes[i] = segmentTimes.at(i);
+        } else {
+            maneuverDistances[i] = maneuverDistances.at(i + 1);
+            maneuverTimes[i] = maneuverTimes.at(i + 1);
+        }
+    }
+}
+
+// Projects the edges on a plane tangent at the position, which is exact
+// enough at the distances that matter for matching.
+void QGeoRouteTrackerPrivate::nearest(Match &match, const QGeoCoordinate &position,
+                                      int first, int last) const
+{
+    const double scale = qCos(qDegreesToRadians(position.latitude()));
+    auto x = [&](const QGeoCoordinate &c) {
+        double dLon = c.longitude() - position.longitude();
+        if (dLon > 180.0)
+            dLon -= 360.0;
+        else if (dLon < -180.0)
+            dLon += 360.0;
+        return dLon * scale;
+    };
+
+    double ax = x(points.at(first));
+    double ay = points.at(first).latitude() - position.latitude();
+    for (int i = first; i <= last; ++i) {
+        const double bx = x(points.at(i + 1));
+        const double by = points.at(i + 1).latitude() - position.latitude();
+        const double dx = bx - ax;
+        const double dy = by - ay;
+        const double length = dx * dx + dy * dy;
+        const double t = length > 0 ? qBound(0.0, -(ax * dx + ay * dy) / length, 1.0) : 0.0;
+        const double px = ax + t * dx;
+        const double py = ay + t * dy;
+        const double squaredDistance = px * px + py * py;
+        if (squaredDistance < match.squaredDistance) {
+            match.edge = i;
+            match.t = t;
+            match.squaredDistance = squaredDistance;
+        }
+        ax = bx;
+        ay = by;
+    }
+}
+
+// A copy of segment, which is explicitly shared, to be linked into another route
+static QGeoRouteSegment copySegment(const QGeoRouteSegment &segment)
+{
+    QGeoRouteSegment copy;
+    copy.setTravelTime(segment.travelTime());
+    copy.setDistance(segment.distance());
+    copy.setManeuver(segment.maneuver());
+    QGeoRouteSegmentPrivate::get(copy)->setLegLastSegment(segment.isLegLastSegment());
+    return copy;
+}
+
+QGeoRouteTracker::QGeoRouteTracker()
+    : d_ptr(new QGeoRouteTrackerPrivate)
+{
+}
+
+QGeoRouteTracker::QGeoRouteTracker(const QGeoRoute &route)
+    : d_ptr(new QGeoRouteTrackerPrivate)
+{
+    setRoute(route);
+}
+
+QGeoRouteTracker::~QGeoRouteTracker()
+{
+}
+
+/*
+    Sets the route to follow to \a route, and resets the progress.
+*/
+void QGeoRouteTracker::setRoute(const QGeoRoute &route)
+{
+    Q_D(QGeoRouteTracker);
+    d->route = route;
+    d->build();
+    reset();
+}
+
+QGeoRoute QGeoRouteTracker::route() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->route;
+}
+
+/*
+    Sets the distance from the route path, in meters, beyond which positions
+    are off route. The default is 50 meters.
+*/
+void QGeoRouteTracker::setOffRouteThreshold(double meters)
+{
+    Q_D(QGeoRouteTracker);
+    d->offRouteThreshold = meters;
+}
+
+double QGeoRouteTracker::offRouteThreshold() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->offRouteThreshold;
+}
+
+/*
+    Matches \a position to the route path and updates the progress. Returns
+    whether \a position is on route.
+*/
+bool QGeoRouteTracker::update(const QGeoCoordinate &position)
+{
+    Q_D(QGeoRouteTracker);
+    if (d->edgeCount() < 1 || !position.isValid())
+        return false;
+
+    Match match;
+    int first = 0;
+    int last = -1;
+    if (d->edge >= 0) {
+        first = qMax(d->edge - EdgesBehind, 0);
+        last = d->edge;
+        while (last + 1 < d->edgeCount()
+               && (last - d->edge < EdgesAhead || d->distances.at(last + 1) <= d->distance + MetersAhead)) {
+            ++last;
+        }
+        d->nearest(match, position, first, last);
+    }
+
+    const double metersPerDegree = qDegreesToRadians(QLocationUtils::earthMeanRadius());
+    if (qSqrt(match.squaredDistance) * metersPerDegree > d->offRouteThreshold
+            && (first > 0 || last < d->edgeCount() - 1)) {
+        d->nearest(match, position, 0, d->edgeCount() - 1);
+    }
+
+    d->distanceFromRoute = qSqrt(match.squaredDistance) * metersPerDegree;
+    d->onRoute = d->distanceFromRoute <= d->offRouteThreshold;
+    if (!d->onRoute)
+        return false;
+
+    const int i = match.edge;
+    const double t = match.t;
+    const QGeoCoordinate &a = d->points.at(i);
+    const QGeoCoordinate &b = d->points.at(i + 1);
+    double dLon = b.longitude() - a.longitude();
+    if (dLon > 180.0)
+        dLon -= 360.0;
+    else if (dLon < -180.0)
+        dLon += 360.0;
+    double longitude = a.longitude() + t * dLon;
+    if (longitude > 180.0)
+        longitude -= 360.0;
+    else if (longitude < -180.0)
+        longitude += 360.0;
+
+    d->edge = i;
+    d->distance = d->distances.at(i) + t * (d->distances.at(i + 1) - d->distances.at(i));
+    d->time = d->times.at(i) + t * (d->times.at(i + 1) - d->times.at(i));
+    d->matchedPosition = QGeoCoordinate(a.latitude() + t * (b.latitude() - a.latitude()), longitude);
+    return true;
+}
+
+/*
+    Resets the progress to the start of the route.
+*/
+void QGeoRouteTracker::reset()
+{
+    Q_D(QGeoRouteTracker);
+    d->edge = -1;
+    d->onRoute = true;
+    d->distanceFromRoute = 0.0;
+    d->distance = 0.0;
+    d->time = 0.0;
+    d->matchedPosition = d->points.isEmpty() ? QGeoCoordinate() : d->points.first();
+}
+
+/*
+    Returns whether a position was matched to the route since the last
+    reset().
+*/
+bool QGeoRouteTracker::hasMatch() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->edge >= 0;
+}
+
+/*
+    Returns whether the last position given to update() was on route. Returns
+    true before the first update.
+*/
+bool QGeoRouteTracker::isOnRoute() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->onRoute;
+}
+
+/*
+    Returns the point of the route path nearest to the last position on route.
+*/
+QGeoCoordinate QGeoRouteTracker::matchedPosition() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->matchedPosition;
+}
+
+/*
+    Returns the distance in meters between the last position given to update()
+    and the route path.
+*/
+double QGeoRouteTracker::distanceFromRoute() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->distanceFromRoute;
+}
+
+/*
+    Returns the index of the route segment of the last match, counting from
+    QGeoRoute::firstRouteSegment().
+*/
+int QGeoRouteTracker::currentSegment() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->edge >= 0 ? d->edgeSegments.at(d->edge) : 0;
+}
+
+int QGeoRouteTracker::currentLeg() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->segmentLegs.isEmpty() ? 0 : d->segmentLegs.at(currentSegment());
+}
+
+double QGeoRouteTracker::traveledDistance() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->distance;
+}
+
+int QGeoRouteTracker::traveledTime() const
+{
+    Q_D(const QGeoRouteTracker);
+    return qRound(d->time);
+}
+
+double QGeoRouteTracker::remainingTravelDistance() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->distances.isEmpty() ? 0.0 : d->distances.last() - d->distance;
+}
+
+int QGeoRouteTracker::remainingTravelTime() const
+{
+    Q_D(const QGeoRouteTracker);
+    return d->times.isEmpty() ? 0 : qRound(d->times.last() - d->time);
+}
+
+double QGeoRouteTracker::distanceToNextManeuver() const
+{
+    Q_D(const QGeoRouteTracker);
+    if (d->maneuverDistances.isEmpty())
+        return 0.0;
+    return qMax(d->maneuverDistances.at(currentSegment()) - d->distance, 0.0);
+}
+
+int QGeoRouteTracker::timeToNextManeuver() const
+{
+    Q_D(const QGeoRouteTracker);
+    if (d->maneuverTimes.isEmpty())
+        return 0;
+    return qMax(qRound(d->maneuverTimes.at(currentSegment()) - d->time), 0);
+}
+
+double QGeoRouteTracker::remainingTravelDistanceToNextWaypoint() const
+{
+    Q_D(const QGeoRouteTracker);
+    if (d->legDistances.isEmpty())
+        return 0.0;
+    return qMax(d->legDistances.at(currentLeg()) - d->distance, 0.0);
+}
+
+int QGeoRouteTracker::remainingTravelTimeToNextWaypoint() const
+{
+    Q_D(const QGeoRouteTracker);
+    if (d->legTimes.isEmpty())
+        return 0;
+    return qMax(qRound(d->legTimes.at(currentLeg()) - d->time), 0);
+}
+
+/*
+    Returns the request of the route from \a position to the waypoints of
+    the current route not reached yet, with the other settings of the
+    request of the current route.
+*/
+QGeoRouteRequest QGeoRouteTracker::rerouteRequest(const QGeoCoordinate &position) const
+{
+    Q_D(const QGeoRouteTracker);
+    QGeoRouteRequest request = d->route.request();
+    const QList<QGeoCoordinate> waypoints = request.waypoints();
+    const int next = currentLeg() + 1;
+
+    QList<QGeoCoordinate> remaining = waypoints.mid(next);
+    if (remaining.isEmpty() && !d->points.isEmpty())
+        remaining.append(d->points.last());
+    request.setWaypoints(QList<QGeoCoordinate>() << position << remaining);
+
+    const QList<QVariantMap> metadata = request.waypointsMetadata();
+    if (metadata.size() == waypoints.size())
+        request.setWaypointsMetadata(QList<QVariantMap>() << QVariantMap() << metadata.mid(next));
+    return request;
+}
+
+/*
+    Returns the current route up to the matched position, followed by
+    \a remainder, a route calculated from rerouteRequest(). The segments
+    traveled keep their indexes, the current one ending at the matched
+    position, and the path of each segment is a range of the path of the
+    spliced route. The spliced route has no legs, the segments mark where
+    they end.
+
+    Returns \a remainder if no position was matched yet.
+*/
+QGeoRoute QGeoRouteTracker::splice(const QGeoRoute &remainder) const
+{
+    Q_D(const QGeoRouteTracker);
+    if (d->edge < 0)
+        return remainder;
+
+    QList<QGeoCoordinate> path;
+    QList<QGeoRouteSegment> segments;
+    QVector<int> firsts;
+
+    // The points of the segments traveled, and the ranges they take
+    const int current = currentSegment();
+    QGeoRouteSegment segment = d->route.firstRouteSegment();
+    int pointIndex = 0;
+    for (int i = 0; i <= current && segment.isValid(); ++i) {
+        const int size = segment.path().size();
+        QGeoRouteSegment copy = copySegment(segment);
+        firsts.append(path.size());
+        if (i < current) {
+            for (int j = pointIndex; j < pointIndex + size; ++j)
+                path.append(d->points.at(j));
+        } else {
+            for (int j = pointIndex; j <= d->edge; ++j)
+                path.append(d->points.at(j));
+            path.append(d->matchedPosition);
+            const double start = pointIndex < d->distances.size() ? d->distances.at(pointIndex) : d->distance;
+            const double startTime = pointIndex < d->times.size() ? d->times.at(pointIndex) : d->time;
+            copy.setDistance(qMax(d->distance - start, 0.0));
+            copy.setTravelTime(qMax(qRound(d->time - startTime), 0));
+            QGeoRouteSegmentPrivate::get(copy)->setLegLastSegment(false);
+        }
+        segments.append(copy);
+        pointIndex += size;
+        segment = segment.nextRouteSegment();
+    }
+
+    // The remainder, with the path of its segments when it has any
+    segment = remainder.firstRouteSegment();
+    if (!segment.isValid())
+        path += remainder.path();
+    while (segment.isValid()) {
+        firsts.append(path.size());
+        path += segment.path();
+        segments.append(copySegment(segment));
+        segment = segment.nextRouteSegment();
+    }
+    firsts.append(path.size());
+
+    for (int i = 0; i < segments.size(); ++i)
+        QGeoRouteSegmentPrivate::get(segments[i])->setPathSlice(path, firsts.at(i), firsts.at(i + 1) - firsts.at(i));
+    for (int i = segments.size() - 1; i > 0; --i)
+        segments[i - 1].setNextRouteSegment(segments.at(i));
+
+    QGeoRoute route;
+    route.setRouteId(remainder.routeId());
+    route.setRequest(d->route.request());
+    route.setTravelMode(remainder.travelMode());
+    route.setExtendedAttributes(remainder.extendedAttributes());
+    route.setDistance(d->distance + remainder.distance());
+    route.setTravelTime(qRound(d->time) + remainder.travelTime());
+    route.setPath(path);
+    route.setBounds(QGeoPathBounds::rectangle(qPackCoordinates(path)));
+    if (!segments.isEmpty())
+        route.setFirstRouteSegment(segments.first());
+    return route;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOROUTETRACKER_P_H
+#define QGEOROUTETRACKER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qscopedpointer.h>
+#include <QtPositioning/qgeocoordinate.h>
+#include <QtLocation/private/qlocationglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRoute;
+class QGeoRouteRequest;
+class QGeoRouteTrackerPrivate;
+
+/*
+    Follows the progress of a position along a QGeoRoute. It is meant to be
+    used by QAbstractNavigator implementations to compute the progress
+    information of the navigator.
+
+    The cumulative distances and travel times along the route path are
+    computed once in setRoute(). Each update() searches the path edges near
+    the previous match, and falls back to a search over the whole path only
+    when the position is not close to them, so an update usually takes
+    constant time. A position farther than offRouteThreshold() meters from
+    the path is off route, isOnRoute() then returns false and the progress
+    stays at the last match, until a position is close to the path again.
+
+    Distances are those reported by the route segments, spread along their
+    paths, so that the remaining distances add up to QGeoRoute::distance().
+
+    To reroute, calculate rerouteRequest() and splice() the route it gives
+    onto the part of the route already traveled. The spliced route starts
+    with the same coordinates as the current one, which the map items
+    showing it keep instead of processing them again.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoRouteTracker
+{
+public:
+    QGeoRouteTracker();
+    explicit QGeoRouteTracker(const QGeoRoute &route);
+    ~QGeoRouteTracker();
+
+    void setRoute(const QGeoRoute &route);
+    QGeoRoute route() const;
+
+    void setOffRouteThreshold(double meters);
+    double offRouteThreshold() const;
+
+    bool update(const QGeoCoordinate &position);
+    void reset();
+
+    bool hasMatch() const;
+    bool isOnRoute() const;
+    QGeoCoordinate matchedPosition() const;
+    double distanceFromRoute() const;
+
+    int currentSegment() const;
+    int currentLeg() const;
+
+    double traveledDistance() const;
+    int traveledTime() const;
+    double remainingTravelDistance() const;
+    int remainingTravelTime() const;
+    double distanceToNextManeuver() const;
+    int timeToNextManeuver() const;
+    double remainingTravelDistanceToNextWaypoint() const;
+    int remainingTravelTimeToNextWaypoint() const;
+
+    // Rerouting from the current progress, without recalculating what was traveled
+    QGeoRouteRequest rerouteRequest(const QGeoCoordinate &position) const;
+    QGeoRoute splice(const QGeoRoute &remainder) const;
+
+private:
+    QScopedPointer<QGeoRouteTrackerPrivate> d_ptr;
+    Q_DECLARE_PRIVATE(QGeoRouteTracker)
+    Q_DISABLE_COPY(QGeoRouteTracker)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOROUTETRACKER_P_H
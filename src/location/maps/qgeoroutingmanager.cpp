@@ -39,9 +39,200 @@
 #include "qgeoroutingmanagerengine.h"
 
 #include <QLocale>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+#include <QtPositioning/QGeoRectangle>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+// Completes synchronously with routes taken from the route cache
+class QGeoRouteReplyCached : public QGeoRouteReply
+{
+public:
+    QGeoRouteReplyCached(const QGeoRouteRequest &request, const QList<QGeoRoute> &routes,
+                         QObject *parent)
+        : QGeoRouteReply(request, parent)
+    {
+        setRoutes(routes);
+        setFinished(true);
+    }
+};
+
+struct QGeoRouteMatrixBlock
+{
+    int firstOrigin;
+    int originCount;
+    int firstDestination;
+    int destinationCount;
+};
+
+// Splits a matrix into blocks within the limits of the engine, 0 meaning unlimited
+static QVector<QGeoRouteMatrixBlock> routeMatrixBlocks(int origins, int destinations,
+                                                       const QGeoRoutingManagerEngine *engine)
+{
+    int rows = origins;
+    int columns = destinations;
+    if (engine->maximumRouteMatrixOrigins() > 0)
+        rows = qMin(rows, engine->maximumRouteMatrixOrigins());
+    if (engine->maximumRouteMatrixDestinations() > 0)
+        columns = qMin(columns, engine->maximumRouteMatrixDestinations());
+    const int coordinates = engine->maximumRouteMatrixCoordinates();
+    if (coordinates > 1 && rows + columns > coordinates) {
+        // Keeps the block square, for the fewest blocks
+        const int smaller = qMin(qMin(rows, columns), coordinates / 2);
+        if (rows <= columns) {
+            rows = smaller;
+            columns = qMin(columns, coordinates - rows);
+        } else {
+            columns = smaller;
+            rows = qMin(rows, coordinates - columns);
+        }
+    }
+
+    QVector<QGeoRouteMatrixBlock> blocks;
+    for (int i = 0; i < origins; i += rows) {
+        for (int j = 0; j < destinations; j += columns)
+            blocks.append({ i, qMin(rows, origins - i), j, qMin(columns, destinations - j) });
+    }
+    return blocks;
+}
+
+// Calls the invokable calculateRouteMatrix() of engines that have one, see
+// QGeoRoutingManagerEngine. It is looked up, instead of being a virtual, to
+// keep the engine binary compatible.
+static QGeoRouteMatrixReply *engineRouteMatrix(QGeoRoutingManagerEngine *engine,
+                                               const QList<QGeoCoordinate> &origins,
+                                               const QList<QGeoCoordinate> &destinations,
+                                               const QGeoRouteRequest &request)
+{
+    static const char signature[]
+            = "calculateRouteMatrix(QList<QGeoCoordinate>,QList<QGeoCoordinate>,QGeoRouteRequest)";
+    QGeoRouteMatrixReply *reply = nullptr;
+    if (engine->metaObject()->indexOfMethod(signature) >= 0) {
+        QMetaObject::invokeMethod(engine, "calculateRouteMatrix", Qt::DirectConnection,
+                                  Q_RETURN_ARG(QGeoRouteMatrixReply *, reply),
+                                  Q_ARG(QList<QGeoCoordinate>, origins),
+                                  Q_ARG(QList<QGeoCoordinate>, destinations),
+                                  Q_ARG(QGeoRouteRequest, request));
+    }
+    if (!reply) {
+        reply = new QGeoRouteMatrixReply(QGeoRouteReply::UnsupportedOptionError,
+                                         QLatin1String("Route matrices are not supported by this service provider."),
+                                         engine);
+    }
+    return reply;
+}
+
+// Calculates a route matrix larger than the engine takes at once block by
+// block, at most concurrency blocks at once. The reply fails with the first
+// block which fails.
+class QGeoRouteMatrixReplyChunked : public QGeoRouteMatrixReply
+{
+public:
+    QGeoRouteMatrixReplyChunked(const QList<QGeoCoordinate> &origins,
+                                const QList<QGeoCoordinate> &destinations,
+                                const QGeoRouteRequest &request,
+                                const QVector<QGeoRouteMatrixBlock> &blocks, int concurrency,
+                                QGeoRoutingManagerEngine *engine)
+        : QGeoRouteMatrixReply(origins, destinations, request, engine), m_engine(engine),
+          m_blocks(blocks), m_concurrency(concurrency)
+    {
+        // Blocks may finish synchronously, let the caller connect first
+        QMetaObject::invokeMethod(this, [this]() { startNext(); }, Qt::QueuedConnection);
+    }
+
+    ~QGeoRouteMatrixReplyChunked()
+    {
+        abortRunning();
+    }
+
+    void abort() override
+    {
+        abortRunning();
+        QGeoRouteMatrixReply::abort();
+    }
+
+private:
+    void startNext()
+    {
+        if (m_starting)
+            return;
+        m_starting = true;
+        while (!isFinished() && m_engine && m_running.size() < m_concurrency
+               && m_next < m_blocks.size()) {
+            const QGeoRouteMatrixBlock block = m_blocks.at(m_next++);
+            QGeoRouteMatrixReply *reply = engineRouteMatrix(
+                        m_engine, origins().mid(block.firstOrigin, block.originCount),
+                        destinations().mid(block.firstDestination, block.destinationCount),
+                        request());
+            if (reply->isFinished()) {
+                take(block, reply);
+                continue;
+            }
+            m_running.append(reply);
+            QObject::connect(reply, &QGeoRouteReply::finished, this, [this, block, reply]() {
+                if (!m_running.removeOne(reply))
+                    return;
+                take(block, reply);
+                startNext();
+            });
+        }
+        m_starting = false;
+        if (!isFinished() && m_running.isEmpty() && m_next == m_blocks.size())
+            setFinished(true);
+    }
+
+    void take(const QGeoRouteMatrixBlock &block, QGeoRouteMatrixReply *reply)
+    {
+        reply->deleteLater();
+        if (isFinished())
+            return;
+        if (reply->error() != QGeoRouteReply::NoError) {
+            abortRunning();
+            setError(reply->error(), reply->errorString());
+            return;
+        }
+        setBlock(block.firstOrigin, block.firstDestination, block.originCount,
+                 reply->durations(), reply->distances());
+    }
+
+    void abortRunning()
+    {
+        const QList<QPointer<QGeoRouteMatrixReply>> running(m_running.cbegin(), m_running.cend());
+        m_running.clear();
+        for (const QPointer<QGeoRouteMatrixReply> &reply : running) {
+            if (reply) {
+                reply->abort();
+                reply->deleteLater();
+            }
+        }
+    }
+
+    QPointer<QGeoRoutingManagerEngine> m_engine;
+    QVector<QGeoRouteMatrixBlock> m_blocks;
+    int m_concurrency;
+    int m_next = 0;
+    bool m_starting = false;
+    QList<QGeoRouteMatrixReply *> m_running;
+};
+
+// About one meter, so that waypoints placed on the same spot share entries
+const double WaypointQuantum = 1e5;
+// Departure times within the same quarter of an hour share entries
+const qint64 DepartureTimeBucket = 15 * 60 * 1000;
+
+void writeQuantized(QDataStream &stream, const QGeoCoordinate &coordinate)
+{
+    stream << qRound64(coordinate.latitude() * WaypointQuantum)
+           << qRound64(coordinate.longitude() * WaypointQuantum);
+}
+
+}
+
 /*!
     \class QGeoRoutingManager
     \inmodule QtLocation
@@ -225,6 +416,13 @@ int QGeoRoutingManager::managerVersion() const
     reported by the methods in this manager, then a
     QGeoRouteReply::UnsupportedOptionError will occur.
 
+    If the service provider was created with a \c{<provider>.routing.cache.size}
+    parameter greater than zero, up to that many results are kept, and a
+    request matching one of them returns a reply which is already finished.
+    Waypoints match within about a meter and departure times within a quarter
+    of an hour. Results expire after \c{<provider>.routing.cache.ttl} seconds,
+    300 by default.
+
     The user is responsible for deleting the returned reply object, although
     this can be done in the slot connected to QGeoRoutingManager::finished(),
     QGeoRoutingManager::error(), QGeoRouteReply::finished() or
@@ -232,7 +430,25 @@ int QGeoRoutingManager::managerVersion() const
 */
 QGeoRouteReply *QGeoRoutingManager::calculateRoute(const QGeoRouteRequest &request)
 {
-    return d_ptr->engine->calculateRoute(request);
+    if (d_ptr->routeCache.maxCost() <= 0)
+        return d_ptr->engine->calculateRoute(request);
+
+    const QByteArray key = d_ptr->routeCacheKey(request);
+    const QList<QGeoRoute> routes = d_ptr->cachedRoutes(key);
+    if (!routes.isEmpty())
+        return new QGeoRouteReplyCached(request, routes, d_ptr->engine);
+
+    QGeoRouteReply *reply = d_ptr->engine->calculateRoute(request);
+    if (reply->isFinished()) {
+        if (reply->error() == QGeoRouteReply::NoError)
+            d_ptr->cacheRoutes(key, reply->routes());
+    } else {
+        connect(reply, &QGeoRouteReply::finished, this, [this, reply, key]() {
+            if (reply->error() == QGeoRouteReply::NoError)
+                d_ptr->cacheRoutes(key, reply->routes());
+        });
+    }
+    return reply;
 }
 
 /*!
@@ -267,6 +483,52 @@ QGeoRouteReply *QGeoRoutingManager::updateRoute(const QGeoRoute &route, const QG
     return d_ptr->engine->updateRoute(route, position);
 }
 
+/*!
+    \since 5.15
+
+    Begins the calculation of the travel times and distances from each of
+    \a origins to each of \a destinations, with the travel modes, features
+    and departure time of \a request. The waypoints of \a request are
+    ignored.
+
+    A QGeoRouteMatrixReply object will be returned, which holds a duration and
+    a distance for each pair once finished, but no routes. This is much
+    cheaper than calculating a route for each pair.
+
+    Matrices larger than the service provider takes in a single request are
+    split into blocks, with at most \c{<provider>.routing.matrix.concurrency}
+    blocks in progress, 2 by default. The reply fails if any of the blocks
+    does. These blocks are reported by the finished() and error() signals of
+    this manager as well.
+
+    If the service provider has no matrix request, a
+    QGeoRouteReply::UnsupportedOptionError will occur.
+
+    The user is responsible for deleting the returned reply object, although
+    this can be done in the slot connected to QGeoRoutingManager::finished(),
+    QGeoRoutingManager::error(), QGeoRouteReply::finished() or
+    QGeoRouteReply::error() with deleteLater().
+*/
+QGeoRouteMatrixReply *QGeoRoutingManager::calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                               const QList<QGeoCoordinate> &destinations,
+                                                               const QGeoRouteRequest &request)
+{
+    const QVector<QGeoRouteMatrixBlock> blocks
+            = routeMatrixBlocks(origins.size(), destinations.size(), d_ptr->engine);
+    if (blocks.size() == 1)
+        return engineRouteMatrix(d_ptr->engine, origins, destinations, request);
+
+    QGeoRouteMatrixReplyChunked *reply
+            = new QGeoRouteMatrixReplyChunked(origins, destinations, request, blocks,
+                                              d_ptr->matrixConcurrency, d_ptr->engine);
+    connect(reply, &QGeoRouteReply::finished, this, [this, reply]() {
+        if (reply->error() != QGeoRouteReply::NoError)
+            emit error(reply, reply->error(), reply->errorString());
+        emit finished(reply);
+    });
+    return reply;
+}
+
 /*!
     Returns the travel modes supported by this manager.
 */
@@ -401,11 +663,83 @@ Use deleteLater() instead.
 *******************************************************************************/
 
 QGeoRoutingManagerPrivate::QGeoRoutingManagerPrivate()
-    : engine(0) {}
+    : engine(0)
+{
+    routeCache.setMaxCost(0);
+}
 
 QGeoRoutingManagerPrivate::~QGeoRoutingManagerPrivate()
 {
     delete engine;
 }
 
+void QGeoRoutingManagerPrivate::setRouteCacheSize(int size)
+{
+    routeCache.setMaxCost(qMax(size, 0));
+    if (size > 0 && !routeCacheClock.isValid())
+        routeCacheClock.start();
+}
+
+/*
+    Returns the key of the route cache entry for \a request. The waypoints and
+    exclude areas are rounded to about a meter and the departure time to a
+    quarter of an hour. The locale is part of the key as it changes the
+    instruction texts.
+*/
+QByteArray QGeoRoutingManagerPrivate::routeCacheKey(const QGeoRouteRequest &request) const
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+
+    const QList<QGeoCoordinate> waypoints = request.waypoints();
+    stream << waypoints.size();
+    for (const QGeoCoordinate &waypoint : waypoints)
+        writeQuantized(stream, waypoint);
+    stream << request.waypointsMetadata();
+
+    const QList<QGeoRectangle> excludeAreas = request.excludeAreas();
+    stream << excludeAreas.size();
+    for (const QGeoRectangle &area : excludeAreas) {
+        writeQuantized(stream, area.topLeft());
+        writeQuantized(stream, area.bottomRight());
+    }
+
+    stream << int(request.travelModes())
+           << int(request.routeOptimization())
+           << int(request.segmentDetail())
+           << int(request.maneuverDetail())
+           << request.numberOfAlternativeRoutes();
+
+    const QList<QGeoRouteRequest::FeatureType> featureTypes = request.featureTypes();
+    stream << featureTypes.size();
+    for (QGeoRouteRequest::FeatureType type : featureTypes)
+        stream << int(type) << int(request.featureWeight(type));
+
+    const QDateTime departureTime = request.departureTime();
+    stream << (departureTime.isValid() ? departureTime.toMSecsSinceEpoch() / DepartureTimeBucket : -1);
+    stream << request.extraParameters();
+
+    stream << engine->locale().name() << int(engine->measurementSystem());
+    return key;
+}
+
+QList<QGeoRoute> QGeoRoutingManagerPrivate::cachedRoutes(const QByteArray &key)
+{
+    CachedRoutes *entry = routeCache.object(key);
+    if (!entry)
+        return QList<QGeoRoute>();
+    if (entry->expiry < routeCacheClock.elapsed()) {
+        routeCache.remove(key);
+        return QList<QGeoRoute>();
+    }
+    return entry->routes;
+}
+
+void QGeoRoutingManagerPrivate::cacheRoutes(const QByteArray &key, const QList<QGeoRoute> &routes)
+{
+    if (routes.isEmpty() || routeCache.maxCost() <= 0)
+        return;
+    routeCache.insert(key, new CachedRoutes{routes, routeCacheClock.elapsed() + qint64(routeCacheTtl) * 1000});
+}
+
 QT_END_NAMESPACE
@@ -41,6 +41,7 @@
 #include <QtCore/QLocale>
 #include <QtLocation/QGeoRouteRequest>
 #include <QtLocation/QGeoRouteReply>
+#include <QtLocation/QGeoRouteMatrixReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -59,6 +60,9 @@ public:
 
     QGeoRouteReply *calculateRoute(const QGeoRouteRequest &request);
     QGeoRouteReply *updateRoute(const QGeoRoute &route, const QGeoCoordinate &position);
+    QGeoRouteMatrixReply *calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                               const QList<QGeoCoordinate> &destinations,
+                                               const QGeoRouteRequest &request = QGeoRouteRequest());
 
     QGeoRouteRequest::TravelModes supportedTravelModes() const;
     QGeoRouteRequest::FeatureTypes supportedFeatureTypes() const;
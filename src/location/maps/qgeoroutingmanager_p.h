@@ -48,9 +48,17 @@
 // We mean it.
 //
 
+#include "qgeoroute.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+
 QT_BEGIN_NAMESPACE
 
 class QGeoRoutingManagerEngine;
+class QGeoRouteRequest;
 
 class QGeoRoutingManagerPrivate
 {
@@ -58,8 +66,27 @@ public:
     QGeoRoutingManagerPrivate();
     ~QGeoRoutingManagerPrivate();
 
+    void setRouteCacheSize(int size);
+    QByteArray routeCacheKey(const QGeoRouteRequest &request) const;
+    QList<QGeoRoute> cachedRoutes(const QByteArray &key);
+    void cacheRoutes(const QByteArray &key, const QList<QGeoRoute> &routes);
+
     QGeoRoutingManagerEngine *engine;
 
+    struct CachedRoutes
+    {
+        QList<QGeoRoute> routes;
+        qint64 expiry;
+    };
+
+    // Least recently used replies, by request, every entry has a cost of 1.
+    QCache<QByteArray, CachedRoutes> routeCache;
+    int routeCacheTtl = 300; // seconds
+    QElapsedTimer routeCacheClock;
+
+    // Blocks of a route matrix larger than the engine takes in flight at once
+    int matrixConcurrency = 2;
+
 private:
     Q_DISABLE_COPY(QGeoRoutingManagerPrivate)
 };
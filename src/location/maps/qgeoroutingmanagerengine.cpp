@@ -75,6 +75,16 @@ QT_BEGIN_NAMESPACE
     data (such as a QNetworkReply object for network-based services) to the
     QGeoRouteReply instances used by the engine.
 
+    Since Qt 5.15, if the service has a matrix request, which only returns
+    the duration and distance from each origin to each destination instead
+    of routes, the subclass may declare the invokable method
+    \c{QGeoRouteMatrixReply *calculateRouteMatrix(const QList<QGeoCoordinate> &origins, const QList<QGeoCoordinate> &destinations, const QGeoRouteRequest &request)}.
+    QGeoRoutingManager::calculateRouteMatrix() splits the matrices larger
+    than the limits set with setRouteMatrixLimits() into several calls, so
+    that every call fits in a single request of the service. If it is
+    missing or returns \nullptr, route matrices fail with a
+    QGeoRouteReply::UnsupportedOptionError.
+
     \sa QGeoRoutingManager
 */
 
@@ -331,6 +341,55 @@ QGeoRouteRequest::ManeuverDetails QGeoRoutingManagerEngine::supportedManeuverDet
     return d_ptr->supportedManeuverDetails;
 }
 
+/*!
+    \since 5.15
+
+    Sets the largest route matrix a single call of \c{calculateRouteMatrix()}
+    takes to \a maximumOrigins origins, \a maximumDestinations destinations
+    and \a maximumCoordinates origins and destinations together. A limit of
+    0 leaves that dimension unlimited, which is the default.
+*/
+void QGeoRoutingManagerEngine::setRouteMatrixLimits(int maximumOrigins, int maximumDestinations,
+                                                    int maximumCoordinates)
+{
+    d_ptr->maximumRouteMatrixOrigins = qMax(0, maximumOrigins);
+    d_ptr->maximumRouteMatrixDestinations = qMax(0, maximumDestinations);
+    d_ptr->maximumRouteMatrixCoordinates = qMax(0, maximumCoordinates);
+}
+
+/*!
+    \since 5.15
+
+    Returns the most origins a single call of \c{calculateRouteMatrix()} takes,
+    or 0 if unlimited.
+*/
+int QGeoRoutingManagerEngine::maximumRouteMatrixOrigins() const
+{
+    return d_ptr->maximumRouteMatrixOrigins;
+}
+
+/*!
+    \since 5.15
+
+    Returns the most destinations a single call of \c{calculateRouteMatrix()}
+    takes, or 0 if unlimited.
+*/
+int QGeoRoutingManagerEngine::maximumRouteMatrixDestinations() const
+{
+    return d_ptr->maximumRouteMatrixDestinations;
+}
+
+/*!
+    \since 5.15
+
+    Returns the most origins and destinations together a single call of
+    \c{calculateRouteMatrix()} takes, or 0 if unlimited.
+*/
+int QGeoRoutingManagerEngine::maximumRouteMatrixCoordinates() const
+{
+    return d_ptr->maximumRouteMatrixCoordinates;
+}
+
 /*!
     Sets the locale to be used by this manager to \a locale.
 
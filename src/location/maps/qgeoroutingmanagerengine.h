@@ -67,6 +67,10 @@ public:
     QGeoRouteRequest::SegmentDetails supportedSegmentDetails() const;
     QGeoRouteRequest::ManeuverDetails supportedManeuverDetails() const;
 
+    int maximumRouteMatrixOrigins() const;
+    int maximumRouteMatrixDestinations() const;
+    int maximumRouteMatrixCoordinates() const;
+
     void setLocale(const QLocale &locale);
     QLocale locale() const;
     void setMeasurementSystem(QLocale::MeasurementSystem system);
@@ -83,6 +87,7 @@ protected:
     void setSupportedRouteOptimizations(QGeoRouteRequest::RouteOptimizations optimizations);
     void setSupportedSegmentDetails(QGeoRouteRequest::SegmentDetails segmentDetails);
     void setSupportedManeuverDetails(QGeoRouteRequest::ManeuverDetails maneuverDetails);
+    void setRouteMatrixLimits(int maximumOrigins, int maximumDestinations, int maximumCoordinates = 0);
 
 private:
     void setManagerName(const QString &managerName);
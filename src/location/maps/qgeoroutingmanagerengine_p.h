@@ -71,6 +71,11 @@ public:
     QGeoRouteRequest::SegmentDetails supportedSegmentDetails;
     QGeoRouteRequest::ManeuverDetails supportedManeuverDetails;
 
+    // Of a single route matrix request, 0 if unlimited
+    int maximumRouteMatrixOrigins = 0;
+    int maximumRouteMatrixDestinations = 0;
+    int maximumRouteMatrixCoordinates = 0; // origins and destinations together
+
     QLocale locale;
     QLocale::MeasurementSystem measurementSystem;
 
@@ -39,8 +39,10 @@
 #include "qgeoserviceproviderfactory.h"
 
 #include "qgeocodingmanager.h"
+#include "qgeocodingmanager_p.h"
 #include "qgeomappingmanager_p.h"
 #include "qgeoroutingmanager.h"
+#include "qgeoroutingmanager_p.h"
 #include "qplacemanager.h"
 #include "qnavigationmanager_p.h"
 #include "qgeocodingmanagerengine.h"
@@ -60,6 +62,7 @@
 #include <QObject>
 #include <QMetaObject>
 #include <QMetaEnum>
+#include <QMutex>
 #include <QtCore/private/qfactoryloader_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -68,6 +71,19 @@ Q_GLOBAL_STATIC_WITH_ARGS(QFactoryLoader, loader,
         ("org.qt-project.qt.geoservice.serviceproviderfactory/5.0",
          QLatin1String("/geoservices")))
 
+namespace {
+// The plugin metadata, read once per process. The plugins themselves are
+// only loaded by the first manager requested from a provider.
+struct PluginRegistry
+{
+    QMutex mutex;
+    bool discovered = false;
+    QMultiHash<QString, QJsonObject> plugins;
+};
+}
+
+Q_GLOBAL_STATIC(PluginRegistry, pluginRegistry)
+
 /*!
     \class QGeoServiceProvider
     \inmodule QtLocation
@@ -399,6 +415,7 @@ Manager *QGeoServiceProviderPrivate::manager(QGeoServiceProvider::Error *_error,
             engine->setManagerVersion(
                         int(this->metaData.value(QStringLiteral("Version")).toDouble()));
             manager = new Manager(engine);
+            initManager(manager);
         } else if (error == QGeoServiceProvider::NoError) {
             error = QGeoServiceProvider::NotSupportedError;
             errorString = QLatin1String("The service provider does not support the ");
@@ -425,6 +442,43 @@ Manager *QGeoServiceProviderPrivate::manager(QGeoServiceProvider::Error *_error,
     return manager;
 }
 
+/* Sets up the route cache from the <provider>.routing.cache.size and
+ * <provider>.routing.cache.ttl parameters */
+void QGeoServiceProviderPrivate::initManager(QGeoRoutingManager *manager)
+{
+    const QString prefix = providerName + QLatin1String(".routing.cache.");
+    const QVariant ttl = parameterMap.value(prefix + QLatin1String("ttl"));
+    if (ttl.isValid())
+        manager->d_ptr->routeCacheTtl = ttl.toInt();
+    manager->d_ptr->setRouteCacheSize(parameterMap.value(prefix + QLatin1String("size")).toInt());
+
+    const QVariant concurrency = parameterMap.value(providerName + QLatin1String(".routing.matrix.concurrency"));
+    if (concurrency.isValid())
+        manager->d_ptr->matrixConcurrency = qMax(1, concurrency.toInt());
+}
+
+/* Sets up the geocoding cache from the <provider>.geocoding.cache.size, .ttl
+ * and .precision parameters */
+void QGeoServiceProviderPrivate::initManager(QGeoCodingManager *manager)
+{
+    const QString prefix = providerName + QLatin1String(".geocoding.cache.");
+    const QVariant ttl = parameterMap.value(prefix + QLatin1String("ttl"));
+    if (ttl.isValid())
+        manager->d_ptr->cacheTtl = ttl.toInt();
+    const QVariant precision = parameterMap.value(prefix + QLatin1String("precision"));
+    if (precision.isValid())
+        manager->d_ptr->geohashPrecision = qBound(1, precision.toInt(), 12);
+    manager->d_ptr->setCacheSize(parameterMap.value(prefix + QLatin1String("size")).toInt());
+
+    const QString batchPrefix = providerName + QLatin1String(".geocoding.batch.");
+    const QVariant concurrency = parameterMap.value(batchPrefix + QLatin1String("concurrency"));
+    if (concurrency.isValid())
+        manager->d_ptr->batchConcurrency = qMax(1, concurrency.toInt());
+    const QVariant interval = parameterMap.value(batchPrefix + QLatin1String("interval"));
+    if (interval.isValid())
+        manager->d_ptr->batchInterval = qMax(0, interval.toInt());
+}
+
 /*!
     Returns the QGeoCodingManager made available by the service
     provider.
@@ -898,17 +952,14 @@ void QGeoServiceProviderPrivate::loadPlugin(const QVariantMap &parameters)
 
 QMultiHash<QString, QJsonObject> QGeoServiceProviderPrivate::plugins(bool reload)
 {
-    static QMultiHash<QString, QJsonObject> plugins;
-    static bool alreadyDiscovered = false;
-
-    if (reload == true)
-        alreadyDiscovered = false;
-
-    if (!alreadyDiscovered) {
-        loadPluginMetadata(plugins);
-        alreadyDiscovered = true;
+    PluginRegistry *registry = pluginRegistry();
+    QMutexLocker locker(&registry->mutex);
+    if (reload || !registry->discovered) {
+        registry->plugins.clear();
+        loadPluginMetadata(registry->plugins);
+        registry->discovered = true;
     }
-    return plugins;
+    return registry->plugins;
 }
 
 void QGeoServiceProviderPrivate::loadPluginMetadata(QMultiHash<QString, QJsonObject> &list)
@@ -49,6 +49,7 @@
 //
 
 #include "qgeoserviceprovider.h"
+#include <QtLocation/private/qlocationglobal_p.h>
 
 #include <QHash>
 #include <QJsonObject>
@@ -66,7 +67,7 @@ class QGeoServiceProviderFactoryV2;
 class QGeoServiceProviderFactoryV3;
 class QQmlEngine;
 
-class QGeoServiceProviderPrivate
+class Q_LOCATION_PRIVATE_EXPORT QGeoServiceProviderPrivate
 {
 public:
     QGeoServiceProviderPrivate();
@@ -83,6 +84,10 @@ public:
                      QString *errorString, Manager **manager);
     template <class Flags>
     Flags features(const char *enumName);
+    template <class Manager>
+    void initManager(Manager *) {}
+    void initManager(QGeoRoutingManager *manager);
+    void initManager(QGeoCodingManager *manager);
 
     QGeoServiceProviderFactory *factory;
     QGeoServiceProviderFactoryV2 *factoryV2 = nullptr;
@@ -36,6 +36,7 @@
 #include "qgeotiledmap_p.h"
 #include "qgeotiledmap_p_p.h"
 #include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
 #include "qgeotiledmappingmanagerengine_p.h"
 #include "qabstractgeotilecache_p.h"
 #include "qgeotilespec_p.h"
@@ -46,9 +47,27 @@
 #include "qgeotiledmapscene_p.h"
 #include "qgeocameracapabilities_p.h"
 #include <cmath>
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 #define PREFETCH_FRUSTUM_SCALE 2.0
+// Number of camera positions sampled along a predicted trajectory
+#define PREFETCH_TRAJECTORY_STEPS 4
+// Cap of the corridor tiles, in multiples of the number of visible tiles
+#define PREFETCH_CORRIDOR_BUDGET 4
+// Largest corridor radius, in tiles
+#define PREFETCH_CORRIDOR_MAX_RADIUS 4
+// Priority offset separating visible, same-layer prefetch and other-layer tiles.
+// Larger than any distance (in tiles) that can occur on a single zoom level.
+#define TILE_PRIORITY_CLASS_STRIDE 16777216.0
+// Camera speed, in pixels per millisecond, above which paced frames don't
+// request the visible tiles
+#define FRAME_PACING_FAST_SPEED 1.5
+// Missing visible tiles above which progressive loading requests the ones of a
+// lower zoom level covering them, at most as many
+#define PROGRESSIVE_MAX_ANCESTORS 4
+// Screens of tiles the texture cache keeps for each map, the visible ones and those prefetched around them
+#define TEXTURE_PREFETCH_FACTOR 3
 
 static const double invLog2 = 1.0 / std::log(2.0);
 
@@ -66,10 +85,15 @@ QGeoTiledMap::QGeoTiledMap(QGeoTiledMappingManagerEngine *engine, QObject *paren
 
     QObject::connect(engine,&QGeoTiledMappingManagerEngine::tileVersionChanged,
                      this,&QGeoTiledMap::handleTileVersionChanged);
+    QObject::connect(engine, &QGeoTiledMappingManagerEngine::tileUpdated,
+                     this, &QGeoTiledMap::updateTile);
     QObject::connect(this, &QGeoMap::cameraCapabilitiesChanged,
                      [d](const QGeoCameraCapabilities &oldCameraCapabilities) {
                        d->onCameraCapabilitiesChanged(oldCameraCapabilities);
                      });
+    // emitted in the render thread
+    QObject::connect(d->m_mapScene, &QGeoTiledMapScene::tileUploadsPending,
+                     this, &QGeoMap::sgNodeChanged, Qt::QueuedConnection);
 }
 
 QGeoTiledMap::QGeoTiledMap(QGeoTiledMapPrivate &dd, QGeoTiledMappingManagerEngine *engine, QObject *parent)
@@ -81,10 +105,15 @@ QGeoTiledMap::QGeoTiledMap(QGeoTiledMapPrivate &dd, QGeoTiledMappingManagerEngin
 
     QObject::connect(engine,&QGeoTiledMappingManagerEngine::tileVersionChanged,
                      this,&QGeoTiledMap::handleTileVersionChanged);
+    QObject::connect(engine, &QGeoTiledMappingManagerEngine::tileUpdated,
+                     this, &QGeoTiledMap::updateTile);
     QObject::connect(this, &QGeoMap::cameraCapabilitiesChanged,
                      [d](const QGeoCameraCapabilities &oldCameraCapabilities) {
                        d->onCameraCapabilitiesChanged(oldCameraCapabilities);
                      });
+    // emitted in the render thread
+    QObject::connect(d->m_mapScene, &QGeoTiledMapScene::tileUploadsPending,
+                     this, &QGeoMap::sgNodeChanged, Qt::QueuedConnection);
 }
 
 QGeoTiledMap::~QGeoTiledMap()
@@ -112,10 +141,48 @@ void QGeoTiledMap::updateTile(const QGeoTileSpec &spec)
     d->updateTile(spec);
 }
 
+/*
+    Returns the fetch priority of \a spec for this map; lower values should be
+    fetched first. See QGeoTiledMapPrivate::tilePriority().
+*/
+double QGeoTiledMap::tilePriority(const QGeoTileSpec &spec) const
+{
+    Q_D(const QGeoTiledMap);
+    return d->tilePriority(spec);
+}
+
 void QGeoTiledMap::setPrefetchStyle(QGeoTiledMap::PrefetchStyle style)
 {
     Q_D(QGeoTiledMap);
     d->m_prefetchStyle = style;
+    if (style != PrefetchPredictive)
+        d->m_trajectoryTiles.clear();
+}
+
+/*
+    With \a enabled, a tilted camera takes the tiles far from it from lower
+    zoom levels. See QGeoCameraTiles::setDistanceLOD().
+*/
+void QGeoTiledMap::setDistanceLOD(bool enabled)
+{
+    Q_D(QGeoTiledMap);
+    d->m_visibleTiles->setDistanceLOD(enabled);
+    d->m_prefetchTiles->setDistanceLOD(enabled);
+}
+
+/*
+    With \a enabled, while most of the visible tiles have no texture, like at
+    start up or after a jump, the map also requests the one to four tiles of a
+    lower zoom level covering them. These are fetched first, often from the
+    cache, and drawn magnified in place of the missing tiles until these
+    arrive. See QGeoTiledMapPrivate::ancestorTiles().
+*/
+void QGeoTiledMap::setProgressiveLoading(bool enabled)
+{
+    Q_D(QGeoTiledMap);
+    d->m_progressiveLoading = enabled;
+    if (!enabled)
+        d->m_progressiveTiles.clear();
 }
 
 QAbstractGeoTileCache *QGeoTiledMap::tileCache()
@@ -136,6 +203,19 @@ void QGeoTiledMap::prefetchData()
     d->prefetchTiles();
 }
 
+void QGeoTiledMap::prefetchTrajectory(const QGeoCameraData &target)
+{
+    Q_D(QGeoTiledMap);
+    if (d->m_prefetchStyle == PrefetchPredictive)
+        d->prefetchTrajectory(target);
+}
+
+void QGeoTiledMap::prefetchCorridor(const QList<QGeoCoordinate> &path, double radius)
+{
+    Q_D(QGeoTiledMap);
+    d->prefetchCorridor(path, radius);
+}
+
 void QGeoTiledMap::clearData()
 {
     Q_D(QGeoTiledMap);
@@ -145,12 +225,25 @@ void QGeoTiledMap::clearData()
     sgNodeChanged();
 }
 
+void QGeoTiledMap::setFramePacing(bool paced)
+{
+    Q_D(QGeoTiledMap);
+    d->setFramePacing(paced);
+}
+
+void QGeoTiledMap::prepareFrame()
+{
+    Q_D(QGeoTiledMap);
+    d->prepareFrame();
+}
+
 QGeoMap::Capabilities QGeoTiledMap::capabilities() const
 {
     return Capabilities(SupportsVisibleRegion
                         | SupportsSetBearing
                         | SupportsAnchoringCoordinate
-                        | SupportsVisibleArea);
+                        | SupportsVisibleArea
+                        | SupportsOverlayMapTypes);
 }
 
 void QGeoTiledMap::setCopyrightVisible(bool visible)
@@ -167,7 +260,7 @@ void QGeoTiledMap::setCopyrightVisible(bool visible)
 void QGeoTiledMap::clearScene(int mapId)
 {
     Q_D(QGeoTiledMap);
-    if (activeMapType().mapId() == mapId)
+    if (activeMapType().mapId() == mapId || d->m_overlayMapIds.contains(mapId))
         d->clearScene();
 }
 
@@ -204,12 +297,21 @@ QGeoTiledMapPrivate::QGeoTiledMapPrivate(QGeoTiledMappingManagerEngine *engine)
     m_visibleTiles->setPluginString(pluginString);
     m_prefetchTiles->setPluginString(pluginString);
     m_mapScene->setTileSize(tileSize);
+
+    // a version known before the map was created did not reach it through tileVersionChanged
+    m_tileVersion = m_previousTileVersion = engine->tileVersion();
+    m_visibleTiles->setMapVersion(m_tileVersion);
+    m_prefetchTiles->setMapVersion(m_tileVersion);
 }
 
 QGeoTiledMapPrivate::~QGeoTiledMapPrivate()
 {
     // controller_ is a child of map_, don't need to delete it here
 
+    // the cache belongs to the engine, gone with it
+    if (!m_engine.isNull() && m_cache && m_textureUsage > 0)
+        m_cache->reserveMinTextureUsage(m_textureUsage, 0);
+
     delete m_mapScene;
     delete m_visibleTiles;
     delete m_prefetchTiles;
@@ -218,9 +320,18 @@ QGeoTiledMapPrivate::~QGeoTiledMapPrivate()
     // However: how to ensure this is done in rendering thread?
 }
 
+// Under memory pressure only the tiles in view are fetched
+bool QGeoTiledMapPrivate::isMemoryShort() const
+{
+    return m_cache && m_cache->memoryPressure() != QAbstractGeoTileCache::NoMemoryPressure;
+}
+
 void QGeoTiledMapPrivate::prefetchTiles()
 {
-    if (m_tileRequests && m_prefetchStyle != QGeoTiledMap::NoPrefetching) {
+    // The camera came to rest, the trajectory is no longer relevant
+    m_trajectoryTiles.clear();
+
+    if (m_tileRequests && m_prefetchStyle != QGeoTiledMap::NoPrefetching && !isMemoryShort()) {
 
         QSet<QGeoTileSpec> tiles;
         QGeoCameraData camera = m_visibleTiles->cameraData();
@@ -247,6 +358,7 @@ void QGeoTiledMapPrivate::prefetchTiles()
         }
             break;
 
+        case QGeoTiledMap::PrefetchPredictive: // at rest, same as the default style
         case QGeoTiledMap::PrefetchTwoNeighbourLayers: {
             // This is a simpler strategy, we just prefetch from layer above and below
             // for the layer below we only use half the size as this fills the screen
@@ -270,8 +382,193 @@ void QGeoTiledMapPrivate::prefetchTiles()
             break;
         }
 
-        m_tileRequests->requestTiles(tiles - m_mapScene->texturedTiles());
+        m_tileRequests->requestTiles((withOverlays(tiles + m_corridorTiles) + m_progressiveTiles)
+                                     - m_mapScene->texturedTiles());
+    }
+}
+
+/*
+    Tiles currently in view come first, then the prefetch ring around them on
+    the current zoom level, then tiles of neighbouring layers, then the tiles
+    of the corridor along the path being followed. Within each of these
+    classes tiles closer to the camera center, or to the start of the corridor,
+    are preferred.
+*/
+double QGeoTiledMapPrivate::tilePriority(const QGeoTileSpec &spec) const
+{
+    // standing in for the visible tiles, the few of them go first
+    if (m_progressiveTiles.contains(spec))
+        return -1.0;
+
+    const QGeoCameraData camera = m_visibleTiles->cameraData();
+    const int currentIntZoom = static_cast<int>(std::floor(camera.zoomLevel()));
+    const bool visible = m_mapScene->visibleTiles().contains(spec);
+
+    if (!visible) {
+        const auto corridor = m_corridorOrder.constFind(baseTile(spec));
+        if (corridor != m_corridorOrder.cend())
+            return 3.0 * TILE_PRIORITY_CLASS_STRIDE + corridor.value();
+    }
+
+    double tileClass = 2.0;
+    if (spec.zoom() == currentIntZoom)
+        tileClass = visible ? 0.0 : 1.0;
+
+    const double side = std::pow(2.0, spec.zoom());
+    const QDoubleVector2D center = QWebMercator::coordToMercator(camera.center()) * side;
+    double dx = qAbs(spec.x() + 0.5 - center.x());
+    const double dy = spec.y() + 0.5 - center.y();
+    dx = qMin(dx, side - dx); // tiles wrap around the dateline
+
+    const double distance = qMin(std::sqrt(dx * dx + dy * dy), TILE_PRIORITY_CLASS_STRIDE - 1.0);
+    return tileClass * TILE_PRIORITY_CLASS_STRIDE + distance;
+}
+
+/*
+    Returns the tiles of a lower zoom level covering the visible \a tiles of
+    the current zoom level that have no texture yet, when these are most of
+    them and more than PROGRESSIVE_MAX_ANCESTORS. The ancestors are taken from
+    the nearest zoom level where at most that many cover them, up to four zoom
+    levels up like the textures the request manager takes from the cache in
+    place of missing tiles.
+*/
+QSet<QGeoTileSpec> QGeoTiledMapPrivate::ancestorTiles(const QSet<QGeoTileSpec> &tiles) const
+{
+    int zoom = -1;
+    for (const QGeoTileSpec &spec : tiles)
+        zoom = qMax(zoom, spec.zoom());
+
+    const QSet<QGeoTileSpec> textured = m_mapScene->texturedTiles();
+    QSet<QGeoTileSpec> missing;
+    for (const QGeoTileSpec &spec : tiles) {
+        if (spec.zoom() == zoom && !textured.contains(spec))
+            missing.insert(spec);
+    }
+    if (missing.size() <= PROGRESSIVE_MAX_ANCESTORS || missing.size() * 2 < tiles.size())
+        return QSet<QGeoTileSpec>();
+
+    const int maxShift = qMin(4, zoom - qMax(m_minZoomLevel, 0));
+    for (int shift = 1; shift <= maxShift; ++shift) {
+        QSet<QGeoTileSpec> ancestors;
+        for (QGeoTileSpec spec : qAsConst(missing)) {
+            spec.setZoom(zoom - shift);
+            spec.setX(spec.x() >> shift);
+            spec.setY(spec.y() >> shift);
+            ancestors.insert(spec);
+            if (ancestors.size() > PROGRESSIVE_MAX_ANCESTORS)
+                break;
+        }
+        if (ancestors.size() <= PROGRESSIVE_MAX_ANCESTORS)
+            return ancestors;
+    }
+    return QSet<QGeoTileSpec>();
+}
+
+/*
+    Prefetches the tiles the camera will show while moving towards target, in
+    addition to the visible ones. Positions closest to the target come first,
+    as that is where the camera stays longest. The number of extra tiles is
+    capped to the number of visible tiles; since they are not visible, they
+    are also fetched after those (see tilePriority()).
+*/
+void QGeoTiledMapPrivate::prefetchTrajectory(const QGeoCameraData &target)
+{
+    if (!m_tileRequests || isMemoryShort())
+        return;
+
+    const QGeoCameraData camera = m_visibleTiles->cameraData();
+    double targetZoom = target.zoomLevel();
+    if (m_visibleTiles->tileSize() != 256)
+        targetZoom = zoomLevelFrom256(targetZoom, m_visibleTiles->tileSize());
+    targetZoom = qBound<double>(m_minZoomLevel, targetZoom, m_maxZoomLevel);
+
+    const QDoubleVector2D from = QWebMercator::coordToMercator(camera.center());
+    QDoubleVector2D delta = QWebMercator::coordToMercator(target.center()) - from;
+    delta.setX(delta.x() - std::round(delta.x())); // shortest way around the dateline
+
+    const QSet<QGeoTileSpec> &visible = m_mapScene->visibleTiles();
+    const int budget = qMax(1, visible.size());
+    QSet<QGeoTileSpec> tiles;
+
+    QGeoCameraData sample = camera;
+    m_prefetchTiles->setViewExpansion(1.0);
+    for (int step = PREFETCH_TRAJECTORY_STEPS; step > 0 && tiles.size() < budget; --step) {
+        const double t = double(step) / PREFETCH_TRAJECTORY_STEPS;
+        QDoubleVector2D p = from + delta * t;
+        p.setX(p.x() - std::floor(p.x()));
+        sample.setCenter(QWebMercator::mercatorToCoord(p));
+        sample.setZoomLevel(camera.zoomLevel() + (targetZoom - camera.zoomLevel()) * t);
+        m_prefetchTiles->setCameraData(sample);
+
+        const QSet<QGeoTileSpec> sampleTiles = m_prefetchTiles->createTiles();
+        for (const QGeoTileSpec &tile : sampleTiles) {
+            if (tiles.size() >= budget)
+                break;
+            if (!visible.contains(tile))
+                tiles.insert(tile);
+        }
+    }
+
+    m_trajectoryTiles = tiles;
+    updateScene();
+}
+
+/*
+    Prefetches the tiles within radius meters of path, at the zoom level of
+    the visible tiles, so that they are in the cache when the camera follows
+    the path even if the network drops on the way. Tiles are collected from
+    the start of the path, up to a few times the number of visible tiles, and
+    fetched after all the others (see tilePriority()).
+*/
+void QGeoTiledMapPrivate::prefetchCorridor(const QList<QGeoCoordinate> &path, double radius)
+{
+    m_corridorTiles.clear();
+    m_corridorOrder.clear();
+
+    const QSet<QGeoTileSpec> &visible = m_mapScene->visibleTiles();
+    if (m_tileRequests && !path.isEmpty() && !visible.isEmpty() && !isMemoryShort()) {
+        QGeoTileSpec spec = *visible.cbegin(); // for the plugin, map id and version
+        const int side = 1 << spec.zoom();
+        const int budget = visible.size() * PREFETCH_CORRIDOR_BUDGET;
+        const double metersPerTile = QLocationUtils::earthMeanCircumference() / side;
+
+        auto add = [&](const QDoubleVector2D &p, double latitude) {
+            const double r = radius / (metersPerTile * std::cos(qDegreesToRadians(latitude)));
+            const int n = qMin(static_cast<int>(std::ceil(qMax(r, 0.0))), PREFETCH_CORRIDOR_MAX_RADIUS);
+            const int cx = static_cast<int>(std::floor(p.x()));
+            const int cy = static_cast<int>(std::floor(p.y()));
+            for (int y = qMax(cy - n, 0); y <= qMin(cy + n, side - 1); ++y) {
+                for (int x = cx - n; x <= cx + n; ++x) {
+                    spec.setX(((x % side) + side) % side);
+                    spec.setY(y);
+                    if (!m_corridorOrder.contains(spec)) {
+                        m_corridorOrder.insert(spec, m_corridorOrder.size());
+                        m_corridorTiles.insert(spec);
+                    }
+                }
+            }
+            return m_corridorTiles.size() < budget;
+        };
+
+        // Samples the path every half tile
+        QDoubleVector2D from = QWebMercator::coordToMercator(path.first()) * side;
+        bool more = add(from, path.first().latitude());
+        for (int i = 1; more && i < path.size(); ++i) {
+            QDoubleVector2D to = QWebMercator::coordToMercator(path.at(i)) * side;
+            QDoubleVector2D delta = to - from;
+            delta.setX(delta.x() - std::round(delta.x() / side) * side); // shortest way around the dateline
+            const int steps = qMax(1, static_cast<int>(std::ceil(delta.length() * 2.0)));
+            for (int step = 1; more && step <= steps; ++step) {
+                const double t = double(step) / steps;
+                const double latitude = path.at(i - 1).latitude()
+                        + (path.at(i).latitude() - path.at(i - 1).latitude()) * t;
+                more = add(from + delta * t, latitude);
+            }
+            from = to;
+        }
     }
+
+    updateScene();
 }
 
 QGeoMapType QGeoTiledMapPrivate::activeMapType()
@@ -328,29 +625,149 @@ void QGeoTiledMapPrivate::changeCameraData(const QGeoCameraData &cameraData)
     m_visibleTiles->setCameraData(cam);
     m_mapScene->setCameraData(cam);
 
-    updateScene();
+    // While paced, the tiles are updated once per frame in prepareFrame()
+    if (m_framePacing)
+        m_scenePending = true;
+    else
+        updateScene(true);
     q->sgNodeChanged(); // ToDo: explain why emitting twice
 }
 
-void QGeoTiledMapPrivate::updateScene()
+void QGeoTiledMapPrivate::setFramePacing(bool paced)
+{
+    if (m_framePacing == paced)
+        return;
+    m_framePacing = paced;
+    m_frameClock.invalidate();
+    if (!paced && (m_scenePending || m_requestsDeferred)) {
+        m_scenePending = false;
+        updateScene(!m_requestsDeferred);
+    }
+}
+
+/*
+    Updates the tiles for the camera changes since the last frame. While the
+    camera moves fast, as during a flick, the visible tiles are drawn only
+    if they are decoded already, and requested once it slows down: they are
+    out of view before they could be fetched. The tiles prefetched along the
+    trajectory of the flick are requested all along.
+*/
+void QGeoTiledMapPrivate::prepareFrame()
+{
+    if (!m_scenePending)
+        return;
+    m_scenePending = false;
+
+    const QGeoCameraData camera = m_visibleTiles->cameraData();
+    const QDoubleVector2D center = QWebMercator::coordToMercator(camera.center());
+    bool fast = false;
+    if (m_frameClock.isValid()) {
+        const qint64 elapsed = qMax<qint64>(1, m_frameClock.elapsed());
+        double dx = center.x() - m_frameCenter.x();
+        dx -= std::floor(dx + 0.5);
+        const double dy = center.y() - m_frameCenter.y();
+        const double worldSize = m_visibleTiles->tileSize() * std::pow(2.0, camera.zoomLevel());
+        fast = std::sqrt(dx * dx + dy * dy) * worldSize / elapsed > FRAME_PACING_FAST_SPEED;
+    }
+    m_frameClock.start();
+    m_frameCenter = center;
+    updateScene(true, fast);
+}
+
+/*
+    With skipUnchanged, nothing is done unless the set of visible tiles changed.
+    During continuous panning this is the case for most frames. With
+    deferRequests, only the visible tiles that are decoded already are drawn,
+    and the others are requested by the next update without it.
+*/
+void QGeoTiledMapPrivate::updateScene(bool skipUnchanged, bool deferRequests)
 {
     Q_Q(QGeoTiledMap);
+    if (m_requestsDeferred && !deferRequests)
+        skipUnchanged = false;
+    m_requestsDeferred = deferRequests;
+
+    QSet<QGeoTileSpec> added;
+    QSet<QGeoTileSpec> removed;
+    const QSet<QGeoTileSpec> baseTiles = m_visibleTiles->createTiles(&added, &removed);
+    const QSet<QGeoTileSpec> tiles = withOverlays(baseTiles);
+    if (skipUnchanged && added.isEmpty() && removed.isEmpty())
+        return;
+
     // detect if new tiles introduced
-    const QSet<QGeoTileSpec>& tiles = m_visibleTiles->createTiles();
-    bool newTilesIntroduced = !m_mapScene->visibleTiles().contains(tiles);
+    bool newTilesIntroduced = !added.isEmpty() || !m_mapScene->visibleTiles().contains(tiles);
     m_mapScene->setVisibleTiles(tiles);
 
     if (newTilesIntroduced && m_copyrightVisible)
         q->evaluateCopyrights(tiles);
 
-    // don't request tiles that are already built and textured
+    // don't request tiles that are already built and textured.
+    // While the camera follows a predicted trajectory or a corridor is set,
+    // keep their tiles requested.
+    QSet<QGeoTileSpec> requested = withOverlays(m_trajectoryTiles + m_corridorTiles);
+    if (!deferRequests)
+        requested += tiles;
+    // While most of the visible tiles are missing, the few covering them
+    // from a lower zoom level are requested too, see ancestorTiles()
+    m_progressiveTiles.clear();
+    if (m_progressiveLoading && !deferRequests) {
+        m_progressiveTiles = withOverlays(ancestorTiles(baseTiles));
+        requested += m_progressiveTiles;
+    }
     QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > cachedTiles =
-            m_tileRequests->requestTiles(m_visibleTiles->createTiles() - m_mapScene->texturedTiles());
+            m_tileRequests->requestTiles(requested - m_mapScene->texturedTiles());
+
+    if (deferRequests && m_cache) {
+        const QSet<QGeoTileSpec> textured = m_mapScene->texturedTiles();
+        for (const QGeoTileSpec &spec : tiles) {
+            if (cachedTiles.contains(spec) || textured.contains(spec))
+                continue;
+            QSharedPointer<QGeoTileTexture> texture = m_cache->getDecoded(spec);
+            if (texture && !texture->isNull())
+                cachedTiles.insert(spec, texture);
+        }
+    }
 
-    for (auto it = cachedTiles.cbegin(); it != cachedTiles.cend(); ++it)
-        m_mapScene->addTile(it.key(), it.value());
+    for (auto it = cachedTiles.cbegin(); it != cachedTiles.cend(); ++it) {
+        if (tiles.contains(it.key()))
+            m_mapScene->addTile(it.key(), it.value());
+    }
+    for (const QGeoTileSpec &spec : qAsConst(m_progressiveTiles)) {
+        const auto it = cachedTiles.constFind(spec);
+        if (it != cachedTiles.cend())
+            m_mapScene->addAncestorTile(spec, it.value());
+    }
+
+    // When zooming out, draw the decoded tiles of the previous zoom level
+    // in place of the tiles that are still loading. After a map version
+    // change, draw the tiles of the previous version instead, rather than
+    // blanking the map until the new version has been downloaded.
+    bool fallbacksAdded = false;
+    const QSet<QGeoTileSpec> texturedTiles = m_mapScene->texturedTiles();
+    for (const QGeoTileSpec &spec : tiles) {
+        if (!m_cache || texturedTiles.contains(spec) || cachedTiles.contains(spec))
+            continue;
+        if (m_previousTileVersion != spec.version()) {
+            QGeoTileSpec previous = spec;
+            previous.setVersion(m_previousTileVersion);
+            QSharedPointer<QGeoTileTexture> texture = m_cache->getDecoded(previous);
+            if (texture && !texture->isNull() && m_mapScene->addFallbackTile(previous, texture)) {
+                fallbacksAdded = true;
+                continue;
+            }
+        }
+        QGeoTileSpec child = spec;
+        child.setZoom(spec.zoom() + 1);
+        for (int i = 0; i < 4; ++i) {
+            child.setX(spec.x() * 2 + (i & 1));
+            child.setY(spec.y() * 2 + (i >> 1));
+            QSharedPointer<QGeoTileTexture> texture = m_cache->getDecoded(child);
+            if (texture && !texture->isNull())
+                fallbacksAdded |= m_mapScene->addFallbackTile(child, texture);
+        }
+    }
 
-    if (!cachedTiles.isEmpty())
+    if (!cachedTiles.isEmpty() || fallbacksAdded)
         emit q->sgNodeChanged();
 }
 
@@ -386,12 +803,62 @@ void QGeoTiledMapPrivate::changeActiveMapType(const QGeoMapType mapType)
     m_mapScene->setTileSize(m_cameraCapabilities.tileSize());
     m_visibleTiles->setMapType(mapType);
     m_prefetchTiles->setMapType(mapType);
+    if (!m_overlayMapTypes.isEmpty())
+        changeOverlayMapTypes(m_overlayMapTypes); // the active map type is not drawn over itself
     changeCameraData(m_cameraData); // Updates the zoom level to the possibly new tile size
     // updateScene called in changeCameraData()
 }
 
+/*
+    The overlay map types are drawn over the active one in the same scene,
+    from the tiles of the same cameras, each in a layer of its own. Their
+    tiles are requested along with the tiles of the active map type, and
+    cancelled with them.
+*/
+void QGeoTiledMapPrivate::changeOverlayMapTypes(const QList<QGeoMapType> &mapTypes)
+{
+    const int activeMapId = m_visibleTiles->activeMapType().mapId();
+    m_overlayMapIds.clear();
+    for (const QGeoMapType &mapType : mapTypes) {
+        if (mapType.mapId() != activeMapId && !m_overlayMapIds.contains(mapType.mapId()))
+            m_overlayMapIds.append(mapType.mapId());
+    }
+    m_mapScene->setOverlayMapIds(m_overlayMapIds);
+    updateScene();
+}
+
+QSet<QGeoTileSpec> QGeoTiledMapPrivate::withOverlays(const QSet<QGeoTileSpec> &tiles) const
+{
+    if (m_overlayMapIds.isEmpty())
+        return tiles;
+
+    QSet<QGeoTileSpec> result = tiles;
+    result.reserve(tiles.size() * (m_overlayMapIds.size() + 1));
+    for (int mapId : m_overlayMapIds) {
+        for (QGeoTileSpec spec : tiles) {
+            spec.setMapId(mapId);
+            result.insert(spec);
+        }
+    }
+    return result;
+}
+
+// The tile of the active map type an overlay tile is drawn over
+QGeoTileSpec QGeoTiledMapPrivate::baseTile(const QGeoTileSpec &spec) const
+{
+    if (m_overlayMapIds.isEmpty())
+        return spec;
+    QGeoTileSpec base = spec;
+    base.setMapId(m_visibleTiles->activeMapType().mapId());
+    return base;
+}
+
 void QGeoTiledMapPrivate::changeTileVersion(int version)
 {
+    if (version != m_tileVersion) {
+        m_previousTileVersion = m_tileVersion;
+        m_tileVersion = version;
+    }
     m_visibleTiles->setMapVersion(version);
     m_prefetchTiles->setMapVersion(version);
     updateScene();
@@ -413,33 +880,53 @@ void QGeoTiledMapPrivate::changeViewportSize(const QSize& size)
     m_mapScene->setScreenSize(size);
 
 
-    if (!size.isEmpty() && m_cache) {
-        // absolute minimum size: one tile each side of display, 32-bit colour
-        int texCacheSize = (size.width() + m_visibleTiles->tileSize() * 2) *
-                (size.height() + m_visibleTiles->tileSize() * 2) * 4;
-
-        // multiply by 3 so the 'recent' list in the cache is big enough for
-        // an entire display of tiles
-        texCacheSize *= 3;
-        // TODO: move this reasoning into the tilecache
-
-        int newSize = qMax(m_cache->minTextureUsage(), texCacheSize);
-        m_cache->setMinTextureUsage(newSize);
-    }
+    if (!size.isEmpty() && m_cache)
+        updateTextureUsage(size);
 
     if (m_copyrightVisible)
         q->evaluateCopyrights(m_mapScene->visibleTiles());
     updateScene();
 }
 
+/*
+    Sizes the share of the texture cache kept for the tiles of this map: the
+    visible tiles, at least a screen of tiles with one more on each side, times
+    TEXTURE_PREFETCH_FACTOR for the tiles prefetched around them. The share
+    follows the viewport as it grows and shrinks, and the cache caps the sum of
+    the shares by the memory of the device.
+*/
+void QGeoTiledMapPrivate::updateTextureUsage(const QSize &size)
+{
+    const int tileSize = m_visibleTiles->tileSize();
+    const int columns = (size.width() + tileSize - 1) / tileSize + 2;
+    const int rows = (size.height() + tileSize - 1) / tileSize + 2;
+    // tilted cameras see more tiles than fit the screen
+    const qint64 tiles = qMax<qint64>(qint64(columns) * rows, m_visibleTiles->createTiles().size());
+
+    qint64 usage = tiles * TEXTURE_PREFETCH_FACTOR;
+    if (m_cache->costStrategyTexture() == QAbstractGeoTileCache::ByteSize)
+        usage *= qint64(tileSize) * tileSize * 4; // 32-bit colour
+    usage = qMin<qint64>(usage, std::numeric_limits<int>::max() / 2);
+
+    const int previous = m_textureUsage;
+    m_textureUsage = int(usage);
+    m_cache->reserveMinTextureUsage(previous, m_textureUsage);
+}
+
 void QGeoTiledMapPrivate::updateTile(const QGeoTileSpec &spec)
 {
      Q_Q(QGeoTiledMap);
-    // Only promote the texture up to GPU if it is visible
-    if (m_visibleTiles->createTiles().contains(spec)){
+    // Only promote the texture up to GPU if it is visible, or stands in for visible ones
+    const bool ancestor = m_progressiveTiles.contains(spec);
+    if (ancestor || m_visibleTiles->createTiles().contains(baseTile(spec))){
         QSharedPointer<QGeoTileTexture> tex = m_tileRequests->tileTexture(spec);
-        if (!tex.isNull() && !tex->image.isNull()) {
-            m_mapScene->addTile(spec, tex);
+        if (!tex.isNull() && tex->pending) {
+            m_tileRequests->tileDecodePending(spec);
+        } else if (!tex.isNull() && !tex->isNull()) {
+            if (!ancestor)
+                m_mapScene->addTile(spec, tex);
+            else if (!m_mapScene->addAncestorTile(spec, tex))
+                return;
             emit q->sgNodeChanged();
         }
     }
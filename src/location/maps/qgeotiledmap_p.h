@@ -75,17 +75,24 @@ class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMap : public QGeoMap
     Q_OBJECT
     Q_DECLARE_PRIVATE(QGeoTiledMap)
 public:
-    enum PrefetchStyle { NoPrefetching, PrefetchNeighbourLayer, PrefetchTwoNeighbourLayers };
+    enum PrefetchStyle { NoPrefetching, PrefetchNeighbourLayer, PrefetchTwoNeighbourLayers, PrefetchPredictive };
     QGeoTiledMap(QGeoTiledMappingManagerEngine *engine, QObject *parent);
     virtual ~QGeoTiledMap();
 
     QAbstractGeoTileCache *tileCache();
     QGeoTileRequestManager *requestManager();
     void updateTile(const QGeoTileSpec &spec);
+    double tilePriority(const QGeoTileSpec &spec) const;
     void setPrefetchStyle(PrefetchStyle style);
+    void setDistanceLOD(bool enabled);
+    void setProgressiveLoading(bool enabled);
 
     void prefetchData() override;
+    void prefetchTrajectory(const QGeoCameraData &target) override;
+    void prefetchCorridor(const QList<QGeoCoordinate> &path, double radius) override;
     void clearData() override;
+    void setFramePacing(bool paced) override;
+    void prepareFrame() override;
     Capabilities capabilities() const override;
 
     void setCopyrightVisible(bool visible) override;
@@ -53,7 +53,9 @@
 #include <QtLocation/private/qgeomaptype_p.h>
 #include <QtPositioning/private/qdoublevector3d_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QPointer>
+#include <QtCore/QHash>
 
 QT_BEGIN_NAMESPACE
 
@@ -79,17 +81,28 @@ public:
 
     void updateTile(const QGeoTileSpec &spec);
     void prefetchTiles();
+    void prefetchTrajectory(const QGeoCameraData &target);
+    void prefetchCorridor(const QList<QGeoCoordinate> &path, double radius);
+    bool isMemoryShort() const;
+    double tilePriority(const QGeoTileSpec &spec) const;
+    QSet<QGeoTileSpec> ancestorTiles(const QSet<QGeoTileSpec> &tiles) const;
     QGeoMapType activeMapType();
     void onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities);
 
 protected:
     void changeViewportSize(const QSize& size) override;
+    void updateTextureUsage(const QSize &size);
     void changeCameraData(const QGeoCameraData &cameraData) override;
     void changeActiveMapType(const QGeoMapType mapType) override;
+    void changeOverlayMapTypes(const QList<QGeoMapType> &mapTypes) override;
+    QSet<QGeoTileSpec> withOverlays(const QSet<QGeoTileSpec> &tiles) const;
+    QGeoTileSpec baseTile(const QGeoTileSpec &spec) const;
     void changeTileVersion(int version);
     void clearScene();
 
-    void updateScene();
+    void updateScene(bool skipUnchanged = false, bool deferRequests = false);
+    void setFramePacing(bool paced);
+    void prepareFrame();
 
     void setVisibleArea(const QRectF &visibleArea) override;
     QRectF visibleArea() const override;
@@ -108,6 +121,20 @@ protected:
     int m_maxZoomLevel;
     int m_minZoomLevel;
     QGeoTiledMap::PrefetchStyle m_prefetchStyle;
+    int m_textureUsage = 0; // the share of the minimum texture usage of the cache taken by this map
+    QSet<QGeoTileSpec> m_trajectoryTiles;
+    QSet<QGeoTileSpec> m_corridorTiles;
+    QHash<QGeoTileSpec, int> m_corridorOrder; // from the start of the corridor
+    QVector<int> m_overlayMapIds; // drawn over the active map type, bottom first
+    bool m_progressiveLoading = false;
+    QSet<QGeoTileSpec> m_progressiveTiles; // of lower zoom levels, standing in for the visible tiles
+    bool m_framePacing = false;
+    bool m_scenePending = false; // camera changed since the last frame
+    bool m_requestsDeferred = false; // visible tiles not requested while moving fast
+    int m_tileVersion = -1;
+    int m_previousTileVersion = -1; // its tiles stand in for the current ones until they arrive
+    QElapsedTimer m_frameClock;
+    QDoubleVector2D m_frameCenter; // mercator center at the last frame
     Q_DISABLE_COPY(QGeoTiledMapPrivate)
 };
 
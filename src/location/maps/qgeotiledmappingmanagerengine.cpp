@@ -43,19 +43,29 @@
 #include "qgeotilerequestmanager_p.h"
 #include "qgeofiletilecache_p.h"
 #include "qgeotilespec_p.h"
+#include "qgeotiledownloadjob_p.h"
+#include "qgeomemorypressuremonitor_p.h"
+#include "qgeocameracapabilities_p.h"
 
 #include <QTimer>
+#include <QThread>
 #include <QLocale>
 #include <QDir>
 #include <QStandardPaths>
 
+#include <cmath>
+
 QT_BEGIN_NAMESPACE
 
 QGeoTiledMappingManagerEngine::QGeoTiledMappingManagerEngine(QObject *parent)
     : QGeoMappingManagerEngine(parent),
       m_prefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers),
+      m_distanceLOD(false),
+      m_progressiveLoading(false),
       d_ptr(new QGeoTiledMappingManagerEnginePrivate)
 {
+    connect(this, &QGeoMappingManagerEngine::supportedMapTypesChanged,
+            this, &QGeoTiledMappingManagerEngine::updateFetcherCameraCapabilities);
 }
 
 /*!
@@ -63,6 +73,13 @@ QGeoTiledMappingManagerEngine::QGeoTiledMappingManagerEngine(QObject *parent)
 */
 QGeoTiledMappingManagerEngine::~QGeoTiledMappingManagerEngine()
 {
+    // the fetcher has no parent in its thread, it is deleted there before the thread ends
+    if (d_ptr->fetcherThread_) {
+        if (d_ptr->fetcher_)
+            d_ptr->fetcher_->deleteLater();
+        d_ptr->fetcherThread_->quit();
+        d_ptr->fetcherThread_->wait();
+    }
     delete d_ptr;
 }
 
@@ -75,10 +92,22 @@ void QGeoTiledMappingManagerEngine::setTileFetcher(QGeoTileFetcher *fetcher)
 
     if (d->fetcher_)
         d->fetcher_->deleteLater();
-    fetcher->setParent(this);
     d->fetcher_ = fetcher;
+    updateFetcherCameraCapabilities();
+    if (d->threadedFetching_) {
+        if (!d->fetcherThread_) {
+            d->fetcherThread_ = new QThread(this);
+            d->fetcherThread_->setObjectName(QStringLiteral("QGeoTileFetcher"));
+            d->fetcherThread_->start();
+        }
+        fetcher->setParent(nullptr);
+        fetcher->moveToThread(d->fetcherThread_);
+    } else {
+        fetcher->setParent(this);
+    }
 
     qRegisterMetaType<QGeoTileSpec>();
+    qRegisterMetaType<QGeoTileValidators>();
 
     connect(d->fetcher_,
             SIGNAL(tileFinished(QGeoTileSpec,QByteArray,QString)),
@@ -90,10 +119,42 @@ void QGeoTiledMappingManagerEngine::setTileFetcher(QGeoTileFetcher *fetcher)
             this,
             SLOT(engineTileError(QGeoTileSpec,QString)),
             Qt::QueuedConnection);
+    connect(d->fetcher_, &QGeoTileFetcher::tileNotModified,
+            this, &QGeoTiledMappingManagerEngine::engineTileNotModified, Qt::QueuedConnection);
+    connect(d->fetcher_, &QGeoTileFetcher::tileValidatorsReceived,
+            this, &QGeoTiledMappingManagerEngine::engineTileValidatorsReceived, Qt::QueuedConnection);
 
     engineInitialized();
 }
 
+/*
+    Makes the tile fetcher given to the next setTileFetcher() call run in a
+    thread of its own, along with the network replies it creates, so that
+    bursts of tile replies don't compete with the animations of the GUI
+    thread. The engine and the maps keep talking to the fetcher through queued
+    calls and queued connections only, and its results reach the tile request
+    managers of the maps through the engine, as they do without a thread.
+
+    The fetcher then must not share objects of the engine thread, such as a
+    QNetworkAccessManager, nor read the engine: it gets copies of the camera
+    capabilities of the map types, queued again when setSupportedMapTypes()
+    changes them. The default capabilities are copied when the fetcher is set,
+    setCameraCapabilities() must come before setTileFetcher(). The tile
+    cache stays in the thread of the engine, the maps query it synchronously;
+    its disk writes already go through a worker thread.
+*/
+void QGeoTiledMappingManagerEngine::setThreadedTileFetching(bool enabled)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    d->threadedFetching_ = enabled;
+}
+
+bool QGeoTiledMappingManagerEngine::threadedTileFetching() const
+{
+    Q_D(const QGeoTiledMappingManagerEngine);
+    return d->threadedFetching_;
+}
+
 QGeoTileFetcher *QGeoTiledMappingManagerEngine::tileFetcher()
 {
     Q_D(QGeoTiledMappingManagerEngine);
@@ -110,6 +171,7 @@ void QGeoTiledMappingManagerEngine::releaseMap(QGeoTiledMap *map)
     d_ptr->mapHash_.remove(map);
 
     QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > newTileHash = d_ptr->tileHash_;
+    QSet<QGeoTileSpec> cancelTiles;
     typedef QHash<QGeoTileSpec, QSet<QGeoTiledMap *> >::const_iterator h_iter;
     h_iter hi = d_ptr->tileHash_.constBegin();
     h_iter hend = d_ptr->tileHash_.constEnd();
@@ -117,13 +179,36 @@ void QGeoTiledMappingManagerEngine::releaseMap(QGeoTiledMap *map)
         QSet<QGeoTiledMap *> maps = hi.value();
         if (maps.contains(map)) {
             maps.remove(map);
-            if (maps.isEmpty())
+            if (maps.isEmpty()) {
                 newTileHash.remove(hi.key());
-            else
+                if (!d_ptr->downloadHash_.contains(hi.key()))
+                    cancelTiles.insert(hi.key());
+            } else
                 newTileHash.insert(hi.key(), maps);
         }
     }
     d_ptr->tileHash_ = newTileHash;
+
+    // Nobody else is waiting for these, don't keep them in flight
+    QGeoTileFetcher *fetcher = d_ptr->fetcher_;
+    if (!cancelTiles.isEmpty() && fetcher) {
+        QMetaObject::invokeMethod(fetcher, [fetcher, cancelTiles]() {
+            fetcher->updateTileRequests(QSet<QGeoTileSpec>(), cancelTiles);
+        }, Qt::QueuedConnection);
+    }
+
+    QSet<QGeoTileSpec> cancelDecodes;
+    for (auto it = d_ptr->decodeHash_.begin(); it != d_ptr->decodeHash_.end();) {
+        it->remove(map);
+        if (it->isEmpty()) {
+            cancelDecodes.insert(it.key());
+            it = d_ptr->decodeHash_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!cancelDecodes.isEmpty() && d_ptr->tileCache_)
+        d_ptr->tileCache_->cancelDecoding(cancelDecodes);
 }
 
 void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
@@ -180,11 +265,75 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
     }
 
     cancelTiles -= reqTiles;
+    // still downloaded for the disk cache
+    for (auto it = cancelTiles.begin(); it != cancelTiles.end();) {
+        if (d->downloadHash_.contains(*it))
+            it = cancelTiles.erase(it);
+        else
+            ++it;
+    }
+
+    // Prioritize new requests as well as the ones still pending for this map,
+    // as the camera may have moved since those were queued.
+    QHash<QGeoTileSpec, double> priorities;
+    priorities.reserve(oldTiles.size());
+    for (const QGeoTileSpec &tile : qAsConst(oldTiles)) {
+        double priority = map->tilePriority(tile);
+        const QSet<QGeoTiledMap *> mapSet = d->tileHash_.value(tile);
+        for (QGeoTiledMap *other : mapSet) {
+            if (other != map)
+                priority = qMin(priority, other->tilePriority(tile));
+        }
+        priorities.insert(tile, priority);
+    }
+
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    if (!fetcher)
+        return;
+    QMetaObject::invokeMethod(fetcher, [fetcher, reqTiles, cancelTiles, priorities]() {
+        fetcher->updateTileRequests(reqTiles, cancelTiles, priorities);
+    }, Qt::QueuedConnection);
+}
+
+/*
+    Registers interest of \a map in tiles whose cached data is being decoded
+    asynchronously by the tile cache. Decodes nobody is waiting for anymore
+    are cancelled.
+*/
+void QGeoTiledMappingManagerEngine::updateTileDecodes(QGeoTiledMap *map,
+                                                      const QSet<QGeoTileSpec> &tilesAdded,
+                                                      const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QSet<QGeoTileSpec> cancelTiles;
+    for (const QGeoTileSpec &tile : tilesRemoved) {
+        auto it = d->decodeHash_.find(tile);
+        if (it == d->decodeHash_.end())
+            continue;
+        it->remove(map);
+        if (it->isEmpty()) {
+            cancelTiles.insert(tile);
+            d->decodeHash_.erase(it);
+        }
+    }
+
+    for (const QGeoTileSpec &tile : tilesAdded) {
+        d->decodeHash_[tile].insert(map);
+        cancelTiles.remove(tile);
+    }
+
+    if (!cancelTiles.isEmpty())
+        tileCache()->cancelDecoding(cancelTiles);
+}
+
+void QGeoTiledMappingManagerEngine::engineTileDecoded(const QGeoTileSpec &spec, bool success)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
 
-    QMetaObject::invokeMethod(d->fetcher_, "updateTileRequests",
-                              Qt::QueuedConnection,
-                              Q_ARG(QSet<QGeoTileSpec>, reqTiles),
-                              Q_ARG(QSet<QGeoTileSpec>, cancelTiles));
+    const QSet<QGeoTiledMap *> maps = d->decodeHash_.take(spec);
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileDecoded(spec, success);
 }
 
 void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format)
@@ -207,19 +356,73 @@ void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec,
     }
 
     d->tileHash_.remove(spec);
-    tileCache()->insert(spec, bytes, format, d->cacheHint_);
+
+    // downloaded only for later, don't push the tiles in view out of memory
+    const QSet<QGeoTileDownloadJob *> jobs = d->downloadHash_.take(spec);
+    QAbstractGeoTileCache::CacheAreas areas = d->cacheHint_;
+    if (maps.isEmpty() && !jobs.isEmpty() && (areas & QAbstractGeoTileCache::DiskCache))
+        areas = QAbstractGeoTileCache::DiskCache;
+    tileCache()->insert(spec, bytes, format, areas);
 
     map = maps.constBegin();
     mapEnd = maps.constEnd();
     for (; map != mapEnd; ++map) {
         (*map)->requestManager()->tileFetched(spec);
     }
+    for (QGeoTileDownloadJob *job : jobs)
+        job->handleTileFinished(spec);
+
+    // the tile changed on the server, refresh the maps showing the old one
+    if (d->revalidating_.remove(spec))
+        emit tileUpdated(spec);
+}
+
+// An expired tile was read from the cache, ask the server whether it changed
+void QGeoTiledMappingManagerEngine::engineTileExpired(const QGeoTileSpec &spec, const QGeoTileValidators &validators)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    if (!d->fetcher_)
+        return;
+    d->revalidating_.insert(spec);
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    QMetaObject::invokeMethod(fetcher, [fetcher, spec, validators]() {
+        fetcher->revalidateTile(spec, validators);
+    }, Qt::QueuedConnection);
+}
+
+// The cached tile is still valid, only its expiry changes
+void QGeoTiledMappingManagerEngine::engineTileNotModified(const QGeoTileSpec &spec, const QGeoTileValidators &validators)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    d->revalidating_.remove(spec);
+    const QSet<QGeoTiledMap *> maps = d->takeTileMaps(spec);
+    tileCache()->setTileValidators(spec, validators);
+
+    // maps that asked for the tile in the meantime find it in the cache
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileFetched(spec);
+}
+
+void QGeoTiledMappingManagerEngine::engineTileValidatorsReceived(const QGeoTileSpec &spec,
+                                                                 const QGeoTileValidators &validators)
+{
+    tileCache()->setTileValidators(spec, validators);
 }
 
 void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, const QString &errorString)
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
+    // Keep using the expired tile, typically while offline
+    if (d->revalidating_.remove(spec)) {
+        tileCache()->revalidationFailed(spec);
+        const QSet<QGeoTiledMap *> maps = d->takeTileMaps(spec);
+        for (QGeoTiledMap *map : maps)
+            map->requestManager()->tileFetched(spec);
+        return;
+    }
+
     QSet<QGeoTiledMap *> maps = d->tileHash_.value(spec);
     typedef QSet<QGeoTiledMap *>::const_iterator map_iter;
     map_iter map = maps.constBegin();
@@ -238,6 +441,9 @@ void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, co
     for (map = maps.constBegin(); map != mapEnd; ++map) {
         (*map)->requestManager()->tileError(spec, errorString);
     }
+    const QSet<QGeoTileDownloadJob *> jobs = d->downloadHash_.take(spec);
+    for (QGeoTileDownloadJob *job : jobs)
+        job->handleTileError(spec, errorString);
 
     emit tileError(spec, errorString);
 }
@@ -281,6 +487,74 @@ void QGeoTiledMappingManagerEngine::setCacheHint(QAbstractGeoTileCache::CacheAre
     d->cacheHint_ = cacheHint;
 }
 
+/*
+    Creates a job downloading the tiles of the map type \a mapId covering
+    \a area, from \a minimumZoomLevel to \a maximumZoomLevel, into the disk
+    cache. The zoom levels are bounded by the camera capabilities of the map
+    type, and \a mapId 0 stands for the first supported map type. The job is
+    owned by the engine, and starts with QGeoTileDownloadJob::start().
+*/
+QGeoTileDownloadJob *QGeoTiledMappingManagerEngine::createTileDownloadJob(const QGeoShape &area,
+                                                                          int minimumZoomLevel,
+                                                                          int maximumZoomLevel,
+                                                                          int mapId)
+{
+    if (mapId == 0 && !supportedMapTypes().isEmpty())
+        mapId = supportedMapTypes().first().mapId();
+    const QGeoCameraCapabilities capabilities = cameraCapabilities(mapId);
+    if (capabilities.isValid()) {
+        minimumZoomLevel = qMax(minimumZoomLevel, int(std::ceil(capabilities.minimumZoomLevel())));
+        maximumZoomLevel = qMin(maximumZoomLevel, int(std::floor(capabilities.maximumZoomLevel())));
+    }
+    return new QGeoTileDownloadJob(this, area, minimumZoomLevel, maximumZoomLevel, mapId);
+}
+
+// Tiles maps are waiting for are not requested again, the job shares them
+void QGeoTiledMappingManagerEngine::requestTileDownloads(QGeoTileDownloadJob *job, const QSet<QGeoTileSpec> &tiles)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QSet<QGeoTileSpec> reqTiles;
+    for (const QGeoTileSpec &tile : tiles) {
+        QSet<QGeoTileDownloadJob *> &jobs = d->downloadHash_[tile];
+        if (jobs.isEmpty() && !d->tileHash_.contains(tile))
+            reqTiles.insert(tile);
+        jobs.insert(job);
+    }
+
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    if (!fetcher || reqTiles.isEmpty())
+        return;
+    QMetaObject::invokeMethod(fetcher, [fetcher, reqTiles]() {
+        fetcher->updateTileRequests(reqTiles, QSet<QGeoTileSpec>());
+    }, Qt::QueuedConnection);
+}
+
+void QGeoTiledMappingManagerEngine::cancelTileDownloads(QGeoTileDownloadJob *job, const QSet<QGeoTileSpec> &tiles)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QSet<QGeoTileSpec> cancelTiles;
+    for (const QGeoTileSpec &tile : tiles) {
+        auto it = d->downloadHash_.find(tile);
+        if (it == d->downloadHash_.end())
+            continue;
+        it->remove(job);
+        if (it->isEmpty()) {
+            d->downloadHash_.erase(it);
+            if (!d->tileHash_.contains(tile))
+                cancelTiles.insert(tile);
+        }
+    }
+
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    if (!fetcher || cancelTiles.isEmpty())
+        return;
+    QMetaObject::invokeMethod(fetcher, [fetcher, cancelTiles]() {
+        fetcher->updateTileRequests(QSet<QGeoTileSpec>(), cancelTiles);
+    }, Qt::QueuedConnection);
+}
+
 /*!
     Sets the tile cache. Takes ownership of the QObject.
 */
@@ -290,7 +564,43 @@ void QGeoTiledMappingManagerEngine::setTileCache(QAbstractGeoTileCache *cache)
     Q_ASSERT_X(!d->tileCache_, Q_FUNC_INFO, "This should be called only once");
     cache->setParent(this);
     d->tileCache_ = cache;
+    connect(d->tileCache_, &QAbstractGeoTileCache::tileDecoded,
+            this, &QGeoTiledMappingManagerEngine::engineTileDecoded);
+    connect(d->tileCache_, &QAbstractGeoTileCache::tileExpired,
+            this, &QGeoTiledMappingManagerEngine::engineTileExpired);
     d->tileCache_->init();
+    observeMemoryPressure();
+}
+
+// The cache shrinks while the system is short of memory
+void QGeoTiledMappingManagerEngine::observeMemoryPressure()
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    QGeoMemoryPressureMonitor *monitor = QGeoMemoryPressureMonitor::instance();
+    if (!monitor)
+        return;
+    QAbstractGeoTileCache *cache = d->tileCache_;
+    connect(monitor, &QGeoMemoryPressureMonitor::pressureChanged,
+            cache, &QAbstractGeoTileCache::setMemoryPressure);
+    cache->setMemoryPressure(monitor->pressure());
+}
+
+// The fetcher may run in a thread of its own: it gets copies of the camera
+// capabilities instead of reading them from the engine
+void QGeoTiledMappingManagerEngine::updateFetcherCameraCapabilities()
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    if (!d->fetcher_)
+        return;
+    const int mapTypes = supportedMapTypes().size();
+    QVector<QGeoCameraCapabilities> capabilities;
+    capabilities.reserve(mapTypes + 1);
+    for (int mapId = 0; mapId <= mapTypes; ++mapId)
+        capabilities.append(cameraCapabilities(mapId));
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    QMetaObject::invokeMethod(fetcher, [fetcher, capabilities]() {
+        fetcher->setCameraCapabilities(capabilities);
+    });
 }
 
 QAbstractGeoTileCache *QGeoTiledMappingManagerEngine::tileCache()
@@ -301,7 +611,12 @@ QAbstractGeoTileCache *QGeoTiledMappingManagerEngine::tileCache()
         if (!managerName().isEmpty())
             cacheDirectory = QAbstractGeoTileCache::baseLocationCacheDirectory() + managerName();
         d->tileCache_ = new QGeoFileTileCache(cacheDirectory);
+        connect(d->tileCache_, &QAbstractGeoTileCache::tileDecoded,
+                this, &QGeoTiledMappingManagerEngine::engineTileDecoded);
+        connect(d->tileCache_, &QAbstractGeoTileCache::tileExpired,
+                this, &QGeoTiledMappingManagerEngine::engineTileExpired);
         d->tileCache_->init();
+        observeMemoryPressure();
     }
     return d->tileCache_;
 }
@@ -318,7 +633,9 @@ QGeoTiledMappingManagerEnginePrivate::QGeoTiledMappingManagerEnginePrivate()
 :   m_tileVersion(-1),
     cacheHint_(QAbstractGeoTileCache::AllCaches),
     tileCache_(0),
-    fetcher_(0)
+    fetcher_(0),
+    threadedFetching_(false),
+    fetcherThread_(nullptr)
 {
 }
 
@@ -326,4 +643,19 @@ QGeoTiledMappingManagerEnginePrivate::~QGeoTiledMappingManagerEnginePrivate()
 {
 }
 
+// Returns the maps waiting for spec, which no longer are
+QSet<QGeoTiledMap *> QGeoTiledMappingManagerEnginePrivate::takeTileMaps(const QGeoTileSpec &spec)
+{
+    const QSet<QGeoTiledMap *> maps = tileHash_.take(spec);
+    for (QGeoTiledMap *map : maps) {
+        QSet<QGeoTileSpec> tileSet = mapHash_.value(map);
+        tileSet.remove(spec);
+        if (tileSet.isEmpty())
+            mapHash_.remove(map);
+        else
+            mapHash_.insert(map, tileSet);
+    }
+    return maps;
+}
+
 QT_END_NAMESPACE
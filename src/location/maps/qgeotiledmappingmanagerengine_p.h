@@ -65,6 +65,8 @@ class QGeoTileFetcher;
 class QGeoTileTexture;
 class QGeoTileSpec;
 class QGeoTiledMap;
+class QGeoTileDownloadJob;
+class QGeoShape;
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMappingManagerEngine : public QGeoMappingManagerEngine
 {
@@ -85,34 +87,56 @@ public:
     virtual void updateTileRequests(QGeoTiledMap *map,
                             const QSet<QGeoTileSpec> &tilesAdded,
                             const QSet<QGeoTileSpec> &tilesRemoved);
+    void updateTileDecodes(QGeoTiledMap *map,
+                           const QSet<QGeoTileSpec> &tilesAdded,
+                           const QSet<QGeoTileSpec> &tilesRemoved);
 
     QAbstractGeoTileCache *tileCache();
     virtual QSharedPointer<QGeoTileTexture> getTileTexture(const QGeoTileSpec &spec);
 
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
 
+    QGeoTileDownloadJob *createTileDownloadJob(const QGeoShape &area, int minimumZoomLevel,
+                                               int maximumZoomLevel, int mapId = 0);
+
 protected Q_SLOTS:
     virtual void engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
     virtual void engineTileError(const QGeoTileSpec &spec, const QString &errorString);
+    virtual void engineTileDecoded(const QGeoTileSpec &spec, bool success);
+    virtual void engineTileExpired(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+    virtual void engineTileNotModified(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+    virtual void engineTileValidatorsReceived(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
 
 Q_SIGNALS:
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
     void tileVersionChanged();
+    void tileUpdated(const QGeoTileSpec &spec);
 
 protected:
     void setTileFetcher(QGeoTileFetcher *fetcher);
+    void setThreadedTileFetching(bool enabled);
+    bool threadedTileFetching() const;
     void setTileSize(const QSize &tileSize);
     void setTileVersion(int version);
     void setCacheHint(QAbstractGeoTileCache::CacheAreas cacheHint);
     void setTileCache(QAbstractGeoTileCache *cache);
 
     QGeoTiledMap::PrefetchStyle m_prefetchStyle;
+    bool m_distanceLOD;
+    bool m_progressiveLoading;
     QGeoTiledMappingManagerEnginePrivate *d_ptr;
 
     Q_DECLARE_PRIVATE(QGeoTiledMappingManagerEngine)
     Q_DISABLE_COPY(QGeoTiledMappingManagerEngine)
 
+private:
+    void requestTileDownloads(QGeoTileDownloadJob *job, const QSet<QGeoTileSpec> &tiles);
+    void cancelTileDownloads(QGeoTileDownloadJob *job, const QSet<QGeoTileSpec> &tiles);
+    void observeMemoryPressure();
+    void updateFetcherCameraCapabilities();
+
     friend class QGeoTileFetcher;
+    friend class QGeoTileDownloadJob;
 };
 
 QT_END_NAMESPACE
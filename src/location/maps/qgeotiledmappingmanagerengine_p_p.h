@@ -60,6 +60,8 @@ class QGeoTiledMap;
 class QAbstractGeoTileCache;
 class QGeoTileSpec;
 class QGeoTileFetcher;
+class QGeoTileDownloadJob;
+class QThread;
 
 class QGeoTiledMappingManagerEnginePrivate
 {
@@ -71,9 +73,16 @@ public:
     int m_tileVersion;
     QHash<QGeoTiledMap *, QSet<QGeoTileSpec> > mapHash_;
     QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > tileHash_;
+    QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > decodeHash_;
+    QHash<QGeoTileSpec, QSet<QGeoTileDownloadJob *> > downloadHash_;
+    QSet<QGeoTileSpec> revalidating_;
     QAbstractGeoTileCache::CacheAreas cacheHint_;
     QAbstractGeoTileCache *tileCache_;
     QGeoTileFetcher *fetcher_;
+    bool threadedFetching_;
+    QThread *fetcherThread_; // runs the fetcher and its network replies, see setThreadedTileFetching()
+
+    QSet<QGeoTiledMap *> takeTileMaps(const QGeoTileSpec &spec);
 
 private:
     Q_DISABLE_COPY(QGeoTiledMappingManagerEnginePrivate)
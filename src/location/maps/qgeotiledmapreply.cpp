@@ -37,6 +37,7 @@
 #include "qgeotiledmapreply_p.h"
 #include "qgeotiledmapreply_p_p.h"
 
+#include <QDateTime>
 #include <qdebug.h>
 
 QT_BEGIN_NAMESPACE
@@ -193,6 +194,42 @@ void QGeoTiledMapReply::setCached(bool cached)
     d_ptr->isCached = cached;
 }
 
+/*!
+    Returns whether the server answered a conditional request with
+    "304 Not Modified", in which case there is no image data and the cached
+    tile is still valid.
+*/
+bool QGeoTiledMapReply::isNotModified() const
+{
+    return d_ptr->isNotModified;
+}
+
+/*!
+    Sets whether the server answered that the tile did not change to
+    \a notModified.
+*/
+void QGeoTiledMapReply::setNotModified(bool notModified)
+{
+    d_ptr->isNotModified = notModified;
+}
+
+/*!
+    Returns the HTTP validators the tile was served with.
+*/
+QGeoTileValidators QGeoTiledMapReply::validators() const
+{
+    return d_ptr->validators;
+}
+
+/*!
+    Sets the HTTP validators the tile was served with to \a validators, for
+    the cache to revalidate the tile once it expires.
+*/
+void QGeoTiledMapReply::setValidators(const QGeoTileValidators &validators)
+{
+    d_ptr->validators = validators;
+}
+
 /*!
     Returns the request which corresponds to this reply.
 */
@@ -297,6 +334,57 @@ void QGeoTiledMapReply::abort()
     signal. Use deleteLater() instead.
 */
 
+/*
+    Extracts the validators and the lifetime of a tile from the HTTP response
+    \a headers, as returned by QNetworkReply::rawHeaderPairs(). The lifetime
+    comes from the max-age directive of Cache-Control, or else from Expires.
+    A tile that must not be stored or reused without revalidation expires
+    right away.
+*/
+QGeoTileValidators QGeoTileValidators::fromHttpHeaders(const QList<QPair<QByteArray, QByteArray> > &headers)
+{
+    QGeoTileValidators res;
+    QByteArray cacheControl;
+    QByteArray expires;
+    for (const QPair<QByteArray, QByteArray> &header : headers) {
+        const QByteArray name = header.first.toLower();
+        if (name == "etag")
+            res.entityTag = header.second;
+        else if (name == "last-modified")
+            res.lastModified = header.second;
+        else if (name == "cache-control")
+            cacheControl = header.second.toLower();
+        else if (name == "expires")
+            expires = header.second;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    bool hasMaxAge = false;
+    const QList<QByteArray> directives = cacheControl.split(',');
+    for (const QByteArray &d : directives) {
+        const QByteArray directive = d.trimmed();
+        if (directive == "no-cache" || directive == "no-store") {
+            res.expires = now;
+            return res;
+        }
+        if (directive.startsWith("max-age=")) {
+            bool ok = false;
+            const qint64 maxAge = directive.mid(8).toLongLong(&ok);
+            if (ok) {
+                res.expires = now + qMax<qint64>(0, maxAge) * 1000;
+                hasMaxAge = true;
+            }
+        }
+    }
+
+    if (!hasMaxAge && !expires.isEmpty()) {
+        const QDateTime date = QDateTime::fromString(QString::fromLatin1(expires), Qt::RFC2822Date);
+        // An invalid date, typically "0", means already expired
+        res.expires = date.isValid() ? date.toMSecsSinceEpoch() : now;
+    }
+    return res;
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
@@ -304,13 +392,15 @@ QGeoTiledMapReplyPrivate::QGeoTiledMapReplyPrivate(const QGeoTileSpec &spec)
     : error(QGeoTiledMapReply::NoError),
       isFinished(false),
       isCached(false),
+      isNotModified(false),
       spec(spec) {}
 
 QGeoTiledMapReplyPrivate::QGeoTiledMapReplyPrivate(QGeoTiledMapReply::Error error, const QString &errorString)
     : error(error),
       errorString(errorString),
       isFinished(true),
-      isCached(false) {}
+      isCached(false),
+      isNotModified(false) {}
 
 QGeoTiledMapReplyPrivate::~QGeoTiledMapReplyPrivate() {}
 
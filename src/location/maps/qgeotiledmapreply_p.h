@@ -51,12 +51,30 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 
 #include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QPair>
 
 QT_BEGIN_NAMESPACE
 
 class QGeoTileSpec;
 class QGeoTiledMapReplyPrivate;
 
+/* HTTP validators of a tile, kept by the disk cache to revalidate the tile
+ * with a conditional request once it expired */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileValidators
+{
+public:
+    bool isNull() const { return entityTag.isEmpty() && lastModified.isEmpty() && expires < 0; }
+    bool canRevalidate() const { return !entityTag.isEmpty() || !lastModified.isEmpty(); }
+
+    static QGeoTileValidators fromHttpHeaders(const QList<QPair<QByteArray, QByteArray> > &headers);
+
+    QByteArray entityTag;    // ETag, sent back as If-None-Match
+    QByteArray lastModified; // Last-Modified, sent back as If-Modified-Since
+    qint64 expires = -1;     // msecs since epoch, -1 if the server gave no lifetime
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapReply : public QObject
 {
     Q_OBJECT
@@ -78,6 +96,8 @@ public:
     QString errorString() const;
 
     bool isCached() const;
+    bool isNotModified() const;
+    QGeoTileValidators validators() const;
 
     QGeoTileSpec tileSpec() const;
 
@@ -96,6 +116,8 @@ protected:
     void setFinished(bool finished);
 
     void setCached(bool cached);
+    void setNotModified(bool notModified);
+    void setValidators(const QGeoTileValidators &validators);
 
     void setMapImageData(const QByteArray &data);
     void setMapImageFormat(const QString &format);
@@ -107,4 +129,6 @@ private:
 
 QT_END_NAMESPACE
 
+Q_DECLARE_METATYPE(QGeoTileValidators)
+
 #endif
@@ -64,6 +64,8 @@ public:
     QString errorString;
     bool isFinished;
     bool isCached;
+    bool isNotModified;
+    QGeoTileValidators validators;
 
     QGeoTileSpec spec;
     QByteArray mapImageData;
@@ -42,13 +42,29 @@
 #include <QtPositioning/private/qdoublevector3d_p.h>
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtCore/private/qobject_p.h>
+#include <QtCore/QMutex>
 #include <QtQuick/QQuickWindow>
+#include <QtQuick/private/qsgcompressedtexture_p.h>
 #include <QtGui/QVector3D>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 #include <QtPositioning/private/qlocationutils_p.h>
 #include <QtPositioning/private/qdoublematrix4x4_p.h>
 #include <QtPositioning/private/qwebmercator_p.h>
 
+// About sixteen 256x256 tiles
+static const qsizetype maxUploadBytesPerFrame = 4 * 1024 * 1024;
+// Enough for the tiles panned in and out of view in a frame
+static const int maxRecycledTextures = 32;
+static const int maxRecycledNodes = 64;
+
+// What a texture kept for recycling holds, at four bytes per pixel
+static qint64 recycledBytes(const QSGTexture *texture)
+{
+    return qint64(texture->textureSize().width()) * texture->textureSize().height() * 4;
+}
+
 static QVector3D toVector3D(const QDoubleVector3D& in)
 {
     return QVector3D(in.x(), in.y(), in.z());
@@ -56,6 +72,113 @@ static QVector3D toVector3D(const QDoubleVector3D& in)
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+struct TexturePools
+{
+    QMutex mutex;
+    QHash<QQuickWindow *, QWeakPointer<QGeoTiledMapTexturePool>> pools;
+};
+}
+Q_GLOBAL_STATIC(TexturePools, texturePools)
+
+QGeoTiledMapTexturePool::~QGeoTiledMapTexturePool()
+{
+    for (const Entry &entry : qAsConst(m_entries))
+        delete entry.texture;
+    qDeleteAll(m_recycled);
+}
+
+/*
+    Returns the pool of \a window, shared by the root nodes of its maps. The
+    pool goes away with the last of them.
+*/
+QSharedPointer<QGeoTiledMapTexturePool> QGeoTiledMapTexturePool::forWindow(QQuickWindow *window)
+{
+    TexturePools *registry = texturePools();
+    QMutexLocker locker(&registry->mutex);
+    QSharedPointer<QGeoTiledMapTexturePool> pool = registry->pools.value(window).toStrongRef();
+    if (!pool) {
+        for (auto it = registry->pools.begin(); it != registry->pools.end();) {
+            if (it->isNull())
+                it = registry->pools.erase(it);
+            else
+                ++it;
+        }
+        pool.reset(new QGeoTiledMapTexturePool);
+        registry->pools.insert(window, pool);
+    }
+    return pool;
+}
+
+QSGTexture *QGeoTiledMapTexturePool::acquire(const QSharedPointer<QGeoTileTexture> &tile)
+{
+    const auto it = m_entries.find(tile.data());
+    if (it == m_entries.end())
+        return nullptr;
+    ++it->refs;
+    return it->texture;
+}
+
+/*
+    Uploads \a tile, into a recycled texture of the same size when there is
+    one, which saves creating and deleting a texture object in the graphics
+    API. The image is still uploaded whole: with OpenGL, the next bind()
+    specifies the storage of the texture again with glTexImage2D, at the same
+    size and format. Compressed tiles are uploaded as they are.
+*/
+QSGTexture *QGeoTiledMapTexturePool::upload(const QSharedPointer<QGeoTileTexture> &tile,
+                                            QQuickWindow *window)
+{
+    QSGTexture *texture = nullptr;
+    const qint64 bytes = tile->byteSize(); // in the graphics memory, as the tile is uploaded as it is
+    if (tile->compressed.isValid()) {
+        texture = new QSGCompressedTexture(tile->compressed);
+        m_memory.addBytes(bytes);
+    } else {
+        const QSize size = tile->image.size();
+        const auto recycled = std::find_if(m_recycled.begin(), m_recycled.end(),
+                                           [size](QSGPlainTexture *t) { return t->textureSize() == size; });
+        if (recycled != m_recycled.end()) {
+            QSGPlainTexture *plain = *recycled;
+            m_recycled.erase(recycled);
+            m_memory.addBytes(bytes - recycledBytes(plain));
+            plain->setImage(tile->image);
+            texture = plain;
+        } else {
+            texture = window->createTextureFromImage(tile->image);
+            m_memory.addBytes(bytes);
+        }
+    }
+
+    m_entries.insert(tile.data(), Entry { tile, texture, 1, bytes });
+    m_tiles.insert(texture, tile.data());
+    return texture;
+}
+
+void QGeoTiledMapTexturePool::release(QSGTexture *texture, bool deleteLater)
+{
+    const auto tile = m_tiles.constFind(texture);
+    if (tile == m_tiles.constEnd())
+        return;
+    const auto it = m_entries.find(tile.value());
+    if (--it->refs > 0)
+        return;
+
+    m_memory.addBytes(-it->bytes);
+    m_entries.erase(it);
+    m_tiles.erase(tile);
+    // Only textures from images can take another image
+    QSGPlainTexture *plain = qobject_cast<QSGPlainTexture *>(texture);
+    if (deleteLater && plain && m_recycled.size() < maxRecycledTextures) {
+        m_recycled.append(plain);
+        m_memory.addBytes(recycledBytes(plain));
+    } else if (deleteLater) {
+        texture->deleteLater();
+    } else {
+        delete texture;
+    }
+}
+
 QGeoTiledMapScene::QGeoTiledMapScene(QObject *parent)
     : QObject(*new QGeoTiledMapScenePrivate(),parent)
 {
@@ -119,12 +242,52 @@ const QSet<QGeoTileSpec> &QGeoTiledMapScene::visibleTiles() const
     return d->m_visibleTiles;
 }
 
+/*
+    Sets the map ids of the map types drawn over the active one, bottom
+    first. Their tiles are part of the visible tiles, and are drawn over the
+    tiles of the same position of the layers below.
+*/
+void QGeoTiledMapScene::setOverlayMapIds(const QVector<int> &mapIds)
+{
+    Q_D(QGeoTiledMapScene);
+    const QVector<int> previous = d->m_overlayMapIds;
+    d->m_overlayMapIds = mapIds;
+    // the tiles of the overlays changing layers get their nodes built again
+    for (auto it = d->m_textures.cbegin(); it != d->m_textures.cend(); ++it) {
+        const int mapId = it.key().mapId();
+        if (previous.indexOf(mapId) != mapIds.indexOf(mapId))
+            d->m_updatedTextures.append(it.key());
+    }
+}
+
 void QGeoTiledMapScene::addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
 {
     Q_D(QGeoTiledMapScene);
     d->addTile(spec, texture);
 }
 
+/*
+    Adds the tile \a spec, of the zoom level above the visible tiles, to be
+    drawn in the quarter it covers of its parent tile until the parent gets a
+    texture. Returns false if the parent is not visible or already textured.
+*/
+bool QGeoTiledMapScene::addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
+{
+    Q_D(QGeoTiledMapScene);
+    return d->addFallbackTile(spec, texture);
+}
+
+/*
+    Draws the tile \a spec, of a lower zoom level than the visible tiles, in
+    place of each visible tile it covers that has no texture yet, magnifying
+    the part of it that each covers. Returns false if there is none.
+*/
+bool QGeoTiledMapScene::addAncestorTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
+{
+    Q_D(QGeoTiledMapScene);
+    return d->addAncestorTile(spec, texture);
+}
+
 QSet<QGeoTileSpec> QGeoTiledMapScene::texturedTiles()
 {
     Q_D(QGeoTiledMapScene);
@@ -139,6 +302,7 @@ void QGeoTiledMapScene::clearTexturedTiles()
 {
     Q_D(QGeoTiledMapScene);
     d->m_textures.clear();
+    d->m_fallbackTiles.clear();
     d->m_dropTextures = true;
 }
 
@@ -157,6 +321,12 @@ QGeoTiledMapScenePrivate::QGeoTiledMapScenePrivate()
       m_maxTileX(-1),
       m_maxTileY(-1),
       m_tileXWrapsBelow(0),
+      m_originTileX(0),
+      m_originTileY(0),
+      m_originZoomLevel(-1),
+      m_originTileXWrapsBelow(0),
+      m_originTileSize(0),
+      m_geometryGeneration(0),
       m_linearScaling(false),
       m_dropTextures(false)
 {
@@ -166,30 +336,67 @@ QGeoTiledMapScenePrivate::~QGeoTiledMapScenePrivate()
 {
 }
 
-bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming)
+static QGeoTileSpec qgeotiledmapscene_parentTile(const QGeoTileSpec &spec)
 {
-    overzooming = false;
-    int x = spec.x();
+    QGeoTileSpec parent = spec;
+    parent.setZoom(spec.zoom() - 1);
+    parent.setX(spec.x() / 2);
+    parent.setY(spec.y() / 2);
+    return parent;
+}
+
+// Fallback tiles of the next zoom level are tested against their parent, tiles of lower
+// zoom levels, far from a tilted camera, by the first tile of the current one they cover
+bool QGeoTiledMapScenePrivate::isTileInBounds(const QGeoTileSpec &spec, int *wrappedX) const
+{
+    const int shift = spec.zoom() - m_intZoomLevel;
+    if (shift > 1)
+        return false;
+    int x = shift >= 0 ? spec.x() >> shift : spec.x() << -shift;
+    const int y = shift >= 0 ? spec.y() >> shift : spec.y() << -shift;
 
     if (x < m_tileXWrapsBelow)
         x += m_sideLength;
+    if (wrappedX)
+        *wrappedX = x;
 
-    if ((x < m_minTileX)
-            || (m_maxTileX < x)
-            || (spec.y() < m_minTileY)
-            || (m_maxTileY < spec.y())
-            || (spec.zoom() != m_intZoomLevel)) {
+    return (x >= m_minTileX)
+            && (m_maxTileX >= x)
+            && (y >= m_minTileY)
+            && (m_maxTileY >= y);
+}
+
+bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming)
+{
+    overzooming = false;
+    int x;
+    if (!isTileInBounds(spec, &x))
         return false;
-    }
 
     double edge = m_scaleFactor * m_tileSize;
 
-    double x1 = (x - m_minTileX);
+    double x1 = (x - m_originTileX);
     double x2 = x1 + 1.0;
 
-    double y1 = (m_minTileY - spec.y());
+    double y1 = (m_originTileY - spec.y());
     double y2 = y1 - 1.0;
 
+    if (spec.zoom() > m_intZoomLevel) {
+        // a quarter of the parent tile
+        x1 += (spec.x() & 1) * 0.5;
+        x2 = x1 + 0.5;
+        y1 = (m_originTileY - (spec.y() >> 1)) - (spec.y() & 1) * 0.5;
+        y2 = y1 - 0.5;
+        overzooming = true; // minified, filtered linearly
+    } else if (spec.zoom() < m_intZoomLevel) {
+        // a square of tiles of the current zoom level
+        const int span = 1 << (m_intZoomLevel - spec.zoom());
+        x2 = x1 + span;
+        y1 = m_originTileY - (spec.y() * span);
+        y2 = y1 - span;
+        overzooming = true; // magnified, filtered linearly
+    }
+
     x1 *= edge;
     x2 *= edge;
     y1 *= edge;
@@ -228,12 +435,73 @@ void QGeoTiledMapScenePrivate::addTile(const QGeoTileSpec &spec, QSharedPointer<
     if (m_textures.contains(spec))
         m_updatedTextures.append(spec);
     m_textures.insert(spec, texture);
+    removeFallbackTiles(spec);
+}
+
+// A tile of the next zoom level, or the same tile of another map version
+bool QGeoTiledMapScenePrivate::addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
+{
+    if (m_visibleTiles.isEmpty() || m_fallbackTiles.contains(spec))
+        return false;
+    QGeoTileSpec visible = spec.zoom() > m_intZoomLevel ? qgeotiledmapscene_parentTile(spec) : spec;
+    visible.setVersion(m_visibleTiles.constBegin()->version()); // all of the same version
+    if (visible == spec || !m_visibleTiles.contains(visible) || m_textures.contains(visible))
+        return false;
+
+    m_fallbackTiles.insert(spec, visible);
+    m_textures.insert(spec, texture);
+    return true;
+}
+
+bool QGeoTiledMapScenePrivate::addAncestorTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
+{
+    const int shift = m_intZoomLevel - spec.zoom();
+    if (shift <= 0)
+        return false;
+
+    bool added = false;
+    for (const QGeoTileSpec &visible : qAsConst(m_visibleTiles)) {
+        if (visible.zoom() != m_intZoomLevel || visible.mapId() != spec.mapId()
+                || (visible.x() >> shift) != spec.x() || (visible.y() >> shift) != spec.y()
+                || m_textures.contains(visible)) {
+            continue;
+        }
+        // replaced by the tile itself when it arrives, like the lower zoom
+        // level textures the request manager finds in the cache
+        m_textures.insert(visible, texture);
+        added = true;
+    }
+    return added;
+}
+
+void QGeoTiledMapScenePrivate::removeFallbackTiles(const QGeoTileSpec &visible)
+{
+    for (auto it = m_fallbackTiles.begin(); it != m_fallbackTiles.end(); ) {
+        if (it.value() == visible) {
+            m_textures.remove(it.key());
+            it = m_fallbackTiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// The tiles with a node in the scene graph, once textured
+QSet<QGeoTileSpec> QGeoTiledMapScenePrivate::sceneTiles() const
+{
+    if (m_fallbackTiles.isEmpty())
+        return m_visibleTiles;
+    QSet<QGeoTileSpec> tiles = m_visibleTiles;
+    for (auto it = m_fallbackTiles.cbegin(); it != m_fallbackTiles.cend(); ++it)
+        tiles.insert(it.key());
+    return tiles;
 }
 
 void QGeoTiledMapScenePrivate::setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles)
 {
     // work out the tile bounds for the new scene
     updateTileBounds(visibleTiles);
+    updateOrigin();
 
     // set up the gl camera for the new scene
     setupCamera();
@@ -243,6 +511,21 @@ void QGeoTiledMapScenePrivate::setVisibleTiles(const QSet<QGeoTileSpec> &visible
         removeTiles(toRemove);
 
     m_visibleTiles = visibleTiles;
+
+    for (auto it = m_fallbackTiles.begin(); it != m_fallbackTiles.end(); ) {
+        if (!m_visibleTiles.contains(it.value())) {
+            m_textures.remove(it.key());
+            it = m_fallbackTiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// 0 for the active map type, then one layer per overlay
+int QGeoTiledMapScenePrivate::tileLayer(const QGeoTileSpec &spec) const
+{
+    return m_overlayMapIds.isEmpty() ? 0 : m_overlayMapIds.indexOf(spec.mapId()) + 1;
 }
 
 void QGeoTiledMapScenePrivate::removeTiles(const QSet<QGeoTileSpec> &oldTiles)
@@ -278,18 +561,30 @@ void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
     bool hasMidLeft = false;
     bool hasMidRight = false;
 
+    // Tiles of lower zoom levels count for the columns of the current one they cover
+    const auto columns = [this](const QGeoTileSpec &tile, int *first, int *last) {
+        const int shift = m_intZoomLevel - tile.zoom();
+        if (shift < 0)
+            return false;
+        *first = tile.x() << shift;
+        *last = ((tile.x() + 1) << shift) - 1;
+        return true;
+    };
+
     for (; i != end; ++i) {
-        if ((*i).zoom() != m_intZoomLevel)
+        int first, last;
+        if (!columns(*i, &first, &last))
             continue;
-        int x = (*i).x();
-        if (x == 0)
-            hasFarLeft = true;
-        else if (x == (m_sideLength - 1))
-            hasFarRight = true;
-        else if (x == ((m_sideLength / 2) - 1)) {
-            hasMidLeft = true;
-        } else if (x == (m_sideLength / 2)) {
-            hasMidRight = true;
+        for (int x = first; x <= last; ++x) {
+            if (x == 0)
+                hasFarLeft = true;
+            else if (x == (m_sideLength - 1))
+                hasFarRight = true;
+            else if (x == ((m_sideLength / 2) - 1)) {
+                hasMidLeft = true;
+            } else if (x == (m_sideLength / 2)) {
+                hasMidRight = true;
+            }
         }
     }
 
@@ -306,35 +601,55 @@ void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
     }
 
     // finally, determine the min and max bounds
-    i = tiles.constBegin();
-
-    QGeoTileSpec tile = *i;
-
-    int x = tile.x();
-    if (tile.x() < m_tileXWrapsBelow)
-        x += m_sideLength;
-
-    m_minTileX = x;
-    m_maxTileX = x;
-    m_minTileY = tile.y();
-    m_maxTileY = tile.y();
-
-    ++i;
-
-    for (; i != end; ++i) {
-        tile = *i;
-        if (tile.zoom() != m_intZoomLevel)
+    m_minTileX = std::numeric_limits<int>::max();
+    m_maxTileX = -1;
+    m_minTileY = std::numeric_limits<int>::max();
+    m_maxTileY = -1;
+
+    for (i = tiles.constBegin(); i != end; ++i) {
+        int first, last;
+        if (!columns(*i, &first, &last))
             continue;
+        const int shift = m_intZoomLevel - (*i).zoom();
+
+        // a tile of a lower zoom level is wrapped by its first column, as isTileInBounds() does
+        const int wrap = (first < m_tileXWrapsBelow) ? m_sideLength : 0;
+        m_minTileX = qMin(m_minTileX, first + wrap);
+        m_maxTileX = qMax(m_maxTileX, last + wrap);
+        m_minTileY = qMin(m_minTileY, (*i).y() << shift);
+        m_maxTileY = qMax(m_maxTileY, (((*i).y() + 1) << shift) - 1);
+    }
 
-        int x = tile.x();
-        if (tile.x() < m_tileXWrapsBelow)
-            x += m_sideLength;
+    if (m_maxTileX < 0) { // only tiles of higher zoom levels
+        m_minTileX = -1;
+        m_minTileY = -1;
+        m_maxTileY = -1;
+    }
+}
 
-        m_minTileX = qMin(m_minTileX, x);
-        m_maxTileX = qMax(m_maxTileX, x);
-        m_minTileY = qMin(m_minTileY, tile.y());
-        m_maxTileY = qMax(m_maxTileY, tile.y());
+void QGeoTiledMapScenePrivate::updateOrigin()
+{
+    // Keeps the tile rects within a range where the floats of the vertices
+    // are accurate to a fraction of a pixel.
+    static const int maxTilesFromOrigin = 64;
+    if (m_minTileX < 0)
+        return;
+    if (m_originZoomLevel == m_intZoomLevel
+            && m_originTileXWrapsBelow == m_tileXWrapsBelow
+            && m_originTileSize == m_tileSize
+            && qAbs(m_minTileX - m_originTileX) <= maxTilesFromOrigin
+            && qAbs(m_maxTileX - m_originTileX) <= maxTilesFromOrigin
+            && qAbs(m_minTileY - m_originTileY) <= maxTilesFromOrigin
+            && qAbs(m_maxTileY - m_originTileY) <= maxTilesFromOrigin) {
+        return;
     }
+
+    m_originTileX = m_minTileX;
+    m_originTileY = m_minTileY;
+    m_originZoomLevel = m_intZoomLevel;
+    m_originTileXWrapsBelow = m_tileXWrapsBelow;
+    m_originTileSize = m_tileSize;
+    ++m_geometryGeneration;
 }
 
 void QGeoTiledMapScenePrivate::setupCamera()
@@ -362,9 +677,9 @@ void QGeoTiledMapScenePrivate::setupCamera()
     if (center.x() < m_tileXWrapsBelow)
         center.setX(center.x() + 1.0 * m_sideLength);
 
-    // work out where the camera center is w.r.t minimum tile bounds
-    center.setX(center.x() - 1.0 * m_minTileX);
-    center.setY(1.0 * m_minTileY - center.y());
+    // work out where the camera center is w.r.t the origin of the tile rects
+    center.setX(center.x() - 1.0 * m_originTileX);
+    center.setY(1.0 * m_originTileY - center.y());
 
     // apply necessary scaling to the camera center
     center *= edge;
@@ -480,6 +795,26 @@ static bool qgeotiledmapscene_isTileInViewport(const QRectF &tileRect, const QMa
     return qgeotiledmapscene_isTileInViewport_rotationTilt(tileRect, matrix);
 }
 
+QSGImageNode *QGeoTiledMapRootNode::takeImageNode(QQuickWindow *window)
+{
+    if (recycledNodes.isEmpty())
+        return window->createImageNode();
+    return recycledNodes.takeLast();
+}
+
+void QGeoTiledMapRootNode::recycleImageNode(QSGImageNode *node)
+{
+    if (!node)
+        return;
+    if (recycledNodes.size() >= maxRecycledNodes) {
+        delete node;
+        return;
+    }
+    if (QSGNode *parent = node->parent())
+        parent->removeChildNode(node);
+    recycledNodes.append(node);
+}
+
 void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
                                        QGeoTiledMapScenePrivate *d,
                                        double camAdjust,
@@ -498,13 +833,18 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
     QSet<QGeoTileSpec> tilesInSG;
     for (auto it = root->tiles.cbegin(), end = root->tiles.cend(); it != end; ++it)
         tilesInSG.insert(it.key());
-    const QSet<QGeoTileSpec> toRemove = tilesInSG - d->m_visibleTiles;
-    const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - tilesInSG;
+    const QSet<QGeoTileSpec> sceneTiles = d->sceneTiles();
+    const QSet<QGeoTileSpec> toRemove = tilesInSG - sceneTiles;
+    const QSet<QGeoTileSpec> toAdd = sceneTiles - tilesInSG;
 
     for (const QGeoTileSpec &s : toRemove)
-        delete root->tiles.take(s);
+        recycleImageNode(root->tiles.take(s));
     bool straight = !d->isTiltedOrRotated();
-    bool overzooming;
+    bool overzooming = false;
+    // the rects of the tiles already in the scene graph stay valid until the origin moves
+    const bool rebuild = root->geometryGeneration != d->m_geometryGeneration
+            || isTextureLinear != d->m_linearScaling;
+    root->geometryGeneration = d->m_geometryGeneration;
     qreal pixelRatio = window->effectiveDevicePixelRatio();
 #ifdef QT_LOCATION_DEBUG
     QList<QGeoTileSpec> droppedTiles;
@@ -512,7 +852,7 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
     for (QHash<QGeoTileSpec, QSGImageNode *>::iterator it = root->tiles.begin();
          it != root->tiles.end(); ) {
         QSGImageNode *node = it.value();
-        bool ok = d->buildGeometry(it.key(), node, overzooming)
+        bool ok = (rebuild ? d->buildGeometry(it.key(), node, overzooming) : d->isTileInBounds(it.key()))
                 && qgeotiledmapscene_isTileInViewport(node->rect(), root->matrix(), straight);
 
         QSGNode::DirtyState dirtyBits = {};
@@ -522,7 +862,7 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
             droppedTiles.append(it.key());
 #endif
             it = root->tiles.erase(it);
-            delete node;
+            recycleImageNode(node);
         } else {
             if (isTextureLinear != d->m_linearScaling) {
                 if (node->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
@@ -547,13 +887,13 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
 
     for (const QGeoTileSpec &s : toAdd) {
         QGeoTileTexture *tileTexture = d->m_textures.value(s).data();
-        if (!tileTexture || tileTexture->image.isNull()) {
+        if (!tileTexture || tileTexture->isNull() || !textures.contains(s)) { // or uploaded in a later frame
 #ifdef QT_LOCATION_DEBUG
             droppedTiles.append(s);
 #endif
             continue;
         }
-        QSGImageNode *tileNode = window->createImageNode();
+        QSGImageNode *tileNode = takeImageNode(window);
         // note: setTexture will update coordinates so do it here, before we buildGeometry
         tileNode->setTexture(textures.value(s));
         if (d->buildGeometry(s, tileNode, overzooming)
@@ -563,17 +903,18 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
                 tileNode->setMipmapFiltering(QSGTexture::Linear);
             } else {
                 tileNode->setFiltering((d->m_linearScaling || overzooming) ? QSGTexture::Linear : QSGTexture::Nearest);
+                tileNode->setMipmapFiltering(QSGTexture::None); // a recycled node may have had it
             }
 #if QT_CONFIG(opengl)
             if (ogl)
                 static_cast<QSGDefaultImageNode *>(tileNode)->setAnisotropyLevel(QSGTexture::Anisotropy16x);
 #endif
-            root->addChild(s, tileNode);
+            root->addChild(s, tileNode, d->tileLayer(s));
         } else {
 #ifdef QT_LOCATION_DEBUG
             droppedTiles.append(s);
 #endif
-            delete tileNode;
+            recycleImageNode(tileNode);
         }
     }
 
@@ -594,8 +935,10 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
 
     bool isOpenGL = (window->rendererInterface()->graphicsApi() == QSGRendererInterface::OpenGL);
     QGeoTiledMapRootNode *mapRoot = static_cast<QGeoTiledMapRootNode *>(oldNode);
-    if (!mapRoot)
+    if (!mapRoot) {
         mapRoot = new QGeoTiledMapRootNode();
+        mapRoot->texturePool = QGeoTiledMapTexturePool::forWindow(window);
+    }
 
 #ifdef QT_LOCATION_DEBUG
     mapRoot->m_droppedTiles.clear();
@@ -613,13 +956,13 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
 
     if (d->m_dropTextures) {
         for (const QGeoTileSpec &s : mapRoot->tiles->tiles.keys())
-            delete mapRoot->tiles->tiles.take(s);
+            mapRoot->recycleImageNode(mapRoot->tiles->tiles.take(s));
         for (const QGeoTileSpec &s : mapRoot->wrapLeft->tiles.keys())
-            delete mapRoot->wrapLeft->tiles.take(s);
+            mapRoot->recycleImageNode(mapRoot->wrapLeft->tiles.take(s));
         for (const QGeoTileSpec &s : mapRoot->wrapRight->tiles.keys())
-            delete mapRoot->wrapRight->tiles.take(s);
+            mapRoot->recycleImageNode(mapRoot->wrapRight->tiles.take(s));
         for (const QGeoTileSpec &spec : mapRoot->textures.keys())
-            mapRoot->textures.take(spec)->deleteLater();
+            mapRoot->releaseTexture(spec);
         d->m_dropTextures = false;
     }
 
@@ -628,16 +971,16 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
         const QVector<QGeoTileSpec> &toRemove = d->m_updatedTextures;
         for (const QGeoTileSpec &s : toRemove) {
             if (mapRoot->tiles->tiles.contains(s))
-                delete mapRoot->tiles->tiles.take(s);
+                mapRoot->recycleImageNode(mapRoot->tiles->tiles.take(s));
 
             if (mapRoot->wrapLeft->tiles.contains(s))
-                delete mapRoot->wrapLeft->tiles.take(s);
+                mapRoot->recycleImageNode(mapRoot->wrapLeft->tiles.take(s));
 
             if (mapRoot->wrapRight->tiles.contains(s))
-                delete mapRoot->wrapRight->tiles.take(s);
+                mapRoot->recycleImageNode(mapRoot->wrapRight->tiles.take(s));
 
             if (mapRoot->textures.contains(s))
-                mapRoot->textures.take(s)->deleteLater();
+                mapRoot->releaseTexture(s);
         }
         d->m_updatedTextures.clear();
     }
@@ -645,16 +988,54 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     QSet<QGeoTileSpec> textures;
     for (auto it = mapRoot->textures.cbegin(), end = mapRoot->textures.cend(); it != end; ++it)
         textures.insert(it.key());
-    const QSet<QGeoTileSpec> toRemove = textures - d->m_visibleTiles;
-    const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - textures;
+    const QSet<QGeoTileSpec> sceneTiles = d->sceneTiles();
+    const QSet<QGeoTileSpec> toRemove = textures - sceneTiles;
+    const QSet<QGeoTileSpec> toAdd = sceneTiles - textures;
 
     for (const QGeoTileSpec &spec : toRemove)
-        mapRoot->textures.take(spec)->deleteLater();
+        mapRoot->releaseTexture(spec);
+
+    QVector<QPair<double, QGeoTileSpec>> uploads;
+    qsizetype uploadBytes = 0;
     for (const QGeoTileSpec &spec : toAdd) {
-        QGeoTileTexture *tileTexture = d->m_textures.value(spec).data();
-        if (!tileTexture || tileTexture->image.isNull())
+        const QSharedPointer<QGeoTileTexture> &tileTexture = d->m_textures.value(spec);
+        if (!tileTexture || tileTexture->isNull())
             continue;
-        mapRoot->textures.insert(spec, window->createTextureFromImage(tileTexture->image));
+        // Already uploaded for another map of the window
+        if (QSGTexture *texture = mapRoot->texturePool->acquire(tileTexture)) {
+            mapRoot->textures.insert(spec, texture);
+            continue;
+        }
+        uploads.append(qMakePair(0.0, spec));
+        uploadBytes += tileTexture->byteSize();
+    }
+    if (uploadBytes > maxUploadBytesPerFrame) {
+        // Uploading the tiles of a whole new zoom level at once stalls the frame.
+        // The ones closest to the center of the camera, which cover the most of
+        // the screen when tilted, go first and the others in the next frames.
+        const QDoubleVector2D center = QWebMercator::coordToMercator(d->m_cameraData.center());
+        for (auto &upload : uploads) {
+            const QGeoTileSpec &spec = upload.second;
+            const double side = 1 << spec.zoom();
+            double dx = std::abs((spec.x() + 0.5) / side - center.x());
+            dx = qMin(dx, 1.0 - dx);
+            const double dy = (spec.y() + 0.5) / side - center.y();
+            upload.first = dx * dx + dy * dy;
+        }
+        std::sort(uploads.begin(), uploads.end(),
+                  [](const QPair<double, QGeoTileSpec> &a, const QPair<double, QGeoTileSpec> &b) {
+            return a.first < b.first;
+        });
+    }
+    qsizetype uploaded = 0;
+    for (const auto &upload : qAsConst(uploads)) {
+        const QSharedPointer<QGeoTileTexture> tileTexture = d->m_textures.value(upload.second);
+        if (uploaded > 0 && uploaded + tileTexture->byteSize() > maxUploadBytesPerFrame) {
+            emit tileUploadsPending();
+            break;
+        }
+        mapRoot->textures.insert(upload.second, mapRoot->texturePool->upload(tileTexture, window));
+        uploaded += tileTexture->byteSize();
     }
 
     double sideLength = d->m_scaleFactor * d->m_tileSize * d->m_sideLength;
@@ -76,8 +76,11 @@ public:
 
     void setVisibleTiles(const QSet<QGeoTileSpec> &tiles);
     const QSet<QGeoTileSpec> &visibleTiles() const;
+    void setOverlayMapIds(const QVector<int> &mapIds);
 
     void addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
+    bool addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
+    bool addAncestorTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
 
     QSGNode *updateSceneGraph(QSGNode *oldNode, QQuickWindow *window);
 
@@ -87,6 +90,7 @@ public:
 
 Q_SIGNALS:
     void newTilesVisible(const QSet<QGeoTileSpec> &newTiles);
+    void tileUploadsPending();
 
 private:
     void updateSceneParameters();
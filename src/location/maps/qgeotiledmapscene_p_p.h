@@ -52,21 +52,66 @@
 #include <QtPositioning/private/qdoublevector3d_p.h>
 #include <QtQuick/QSGImageNode>
 #include <QtQuick/private/qsgdefaultimagenode_p.h>
+#include <QtQuick/private/qsgtexture_p.h>
 #include <QtQuick/QQuickWindow>
 #include "qgeocameradata_p.h"
+#include "qgeomapstatistics_p.h"
 #include "qgeotilespec_p.h"
 
 QT_BEGIN_NAMESPACE
 
+class QGeoTileTexture;
+
+/*
+    The tile textures uploaded for the maps of a window, shared by the maps
+    showing the same tiles, like two views of a route at different zoom
+    levels, so that each tile is uploaded once. The textures of the tiles no
+    map shows anymore are kept, up to a few, to upload the next tiles of the
+    same size into instead of creating new texture objects. Used from the render thread
+    of the window only.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapTexturePool
+{
+public:
+    ~QGeoTiledMapTexturePool();
+
+    static QSharedPointer<QGeoTiledMapTexturePool> forWindow(QQuickWindow *window);
+
+    // Both take a reference on the texture, to be released with release()
+    QSGTexture *acquire(const QSharedPointer<QGeoTileTexture> &tile);
+    QSGTexture *upload(const QSharedPointer<QGeoTileTexture> &tile, QQuickWindow *window);
+    void release(QSGTexture *texture, bool deleteLater = true);
+
+private:
+    struct Entry {
+        QSharedPointer<QGeoTileTexture> tile; // keeps the key unique while uploaded
+        QSGTexture *texture;
+        int refs;
+        qint64 bytes;
+    };
+    QHash<const QGeoTileTexture *, Entry> m_entries;
+    QHash<QSGTexture *, const QGeoTileTexture *> m_tiles;
+    QVector<QSGPlainTexture *> m_recycled;
+    QGeoMapMemoryTracker m_memory { QGeoMapStatistics::SceneTextures }; // uploaded and recycled
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapTileContainerNode : public QSGTransformNode
 {
 public:
-    void addChild(const QGeoTileSpec &spec, QSGImageNode *node)
+    // The tiles of each layer go under a node of their own, so that overlays
+    // are drawn over the map type below them whatever order the tiles come in
+    void addChild(const QGeoTileSpec &spec, QSGImageNode *node, int layer = 0)
     {
         tiles.insert(spec, node);
-        appendChildNode(node);
+        while (layers.size() <= layer) {
+            layers.append(new QSGNode());
+            appendChildNode(layers.last());
+        }
+        layers.at(layer)->appendChildNode(node);
     }
     QHash<QGeoTileSpec, QSGImageNode *> tiles;
+    QVector<QSGNode *> layers; // owned as child nodes
+    int geometryGeneration = -1; // of QGeoTiledMapScenePrivate the tile rects were built for
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapRootNode : public QSGClipNode
@@ -90,7 +135,14 @@ public:
 
     ~QGeoTiledMapRootNode()
     {
-        qDeleteAll(textures);
+        for (QSGTexture *texture : qAsConst(textures))
+            texturePool->release(texture, false);
+        qDeleteAll(recycledNodes);
+    }
+
+    void releaseTexture(const QGeoTileSpec &spec)
+    {
+        texturePool->release(textures.take(spec));
     }
 
     void setClipRect(const QRect &rect)
@@ -103,6 +155,10 @@ public:
         }
     }
 
+    // The nodes of the tiles leaving the view are reused by the tiles entering it
+    QSGImageNode *takeImageNode(QQuickWindow *window);
+    void recycleImageNode(QSGImageNode *node);
+
     void updateTiles(QGeoTiledMapTileContainerNode *root,
                      QGeoTiledMapScenePrivate *d,
                      double camAdjust,
@@ -121,6 +177,8 @@ public:
     QGeoTiledMapTileContainerNode *wrapRight;    // When zoomed out, the tiles that wrap around on the right
 
     QHash<QGeoTileSpec, QSGTexture *> textures;
+    QSharedPointer<QGeoTiledMapTexturePool> texturePool;
+    QVector<QSGImageNode *> recycledNodes;
 
 #ifdef QT_LOCATION_DEBUG
     double m_sideLengthPixel;
@@ -136,11 +194,18 @@ public:
     ~QGeoTiledMapScenePrivate();
 
     void addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
+    bool addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
+    bool addAncestorTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
+    void removeFallbackTiles(const QGeoTileSpec &visible);
+    QSet<QGeoTileSpec> sceneTiles() const;
 
     void setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles);
     void removeTiles(const QSet<QGeoTileSpec> &oldTiles);
+    int tileLayer(const QGeoTileSpec &spec) const;
     bool buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming);
+    bool isTileInBounds(const QGeoTileSpec &spec, int *wrappedX = nullptr) const;
     void updateTileBounds(const QSet<QGeoTileSpec> &tiles);
+    void updateOrigin();
     void setupCamera();
     inline bool isTiltedOrRotated() { return (m_cameraData.tilt() > 0.0) || (m_cameraData.bearing() > 0.0); }
 
@@ -172,6 +237,11 @@ public:
 
     QHash<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > m_textures;
     QVector<QGeoTileSpec> m_updatedTextures;
+    // tiles of the next zoom level, or of the previous map version, drawn in place of
+    // the visible tiles without a texture yet, to the visible tile they stand in for
+    QHash<QGeoTileSpec, QGeoTileSpec> m_fallbackTiles;
+    // the map types drawn over the others, bottom first, see tileLayer()
+    QVector<int> m_overlayMapIds;
 
     // tilesToGrid transform
     int m_minTileX; // the minimum tile index, i.e. 0 to sideLength which is 1<< zoomLevel
@@ -179,6 +249,15 @@ public:
     int m_maxTileX;
     int m_maxTileY;
     int m_tileXWrapsBelow; // the wrap point as a tile index
+
+    // The tile rects are relative to this tile, kept while the visible tiles
+    // stay around it so that moving the camera only changes the root matrix.
+    int m_originTileX;
+    int m_originTileY;
+    int m_originZoomLevel;
+    int m_originTileXWrapsBelow;
+    int m_originTileSize;
+    int m_geometryGeneration; // bumped when the origin moves, and all the rects change
     bool m_linearScaling;
     bool m_dropTextures;
 
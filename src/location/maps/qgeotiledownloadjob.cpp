@@ -0,0 +1,390 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotiledownloadjob_p.h"
+#include "qgeotiledmappingmanagerengine_p.h"
+#include "qabstractgeotilecache_p.h"
+
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/QTimerEvent>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+// Tiles enumerated per event loop pass, most of them are skipped when resuming
+static const int enumerationBudget = 4096;
+
+/*
+    QGeoTileDownloadJob fetches the tiles covering an area over a range of
+    zoom levels into the disk cache of a QGeoTiledMappingManagerEngine, for
+    maps to show the area without a network connection later. Jobs are
+    created with QGeoTiledMappingManagerEngine::createTileDownloadJob().
+
+    Tiles are enumerated lazily, zoom level by zoom level, and requested
+    through the tile fetcher of the engine after the tiles maps are waiting
+    for. At most maximumConcurrentRequests() tiles of the job are in flight,
+    and requestsPerSecond() can limit the load on the tile server further.
+    Tiles already in the disk cache are skipped, so a job interrupted by
+    cancel() or by quitting the application is resumed by running the same
+    job again. The disk cache has to be large enough for the area, otherwise
+    the first tiles are evicted by the last ones.
+*/
+
+QGeoTileDownloadJob::QGeoTileDownloadJob(QGeoTiledMappingManagerEngine *engine, const QGeoShape &area,
+                                         int minZoom, int maxZoom, int mapId)
+    : QObject(engine), m_engine(engine), m_area(area),
+      m_plugin(engine->managerName() + QLatin1Char('_') + QString::number(engine->managerVersion())),
+      m_version(engine->tileVersion()), m_minZoom(minZoom), m_maxZoom(maxZoom), m_mapId(mapId),
+      m_state(Idle), m_maxConcurrentRequests(6), m_requestsPerSecond(0),
+      m_range(0), m_index(0), m_total(0), m_fetched(0), m_skipped(0), m_failed(0), m_requested(0)
+{
+    for (int zoom = m_minZoom; zoom <= m_maxZoom; ++zoom) {
+        const TileRange range = tileRange(m_area, zoom);
+        if (range.count() == 0)
+            continue;
+        m_ranges.append(range);
+        m_total += range.count();
+    }
+}
+
+QGeoTileDownloadJob::~QGeoTileDownloadJob()
+{
+    if (m_engine && !m_pending.isEmpty())
+        m_engine->cancelTileDownloads(this, m_pending);
+}
+
+QGeoShape QGeoTileDownloadJob::area() const
+{
+    return m_area;
+}
+
+int QGeoTileDownloadJob::minimumZoomLevel() const
+{
+    return m_minZoom;
+}
+
+int QGeoTileDownloadJob::maximumZoomLevel() const
+{
+    return m_maxZoom;
+}
+
+int QGeoTileDownloadJob::mapId() const
+{
+    return m_mapId;
+}
+
+QGeoTileDownloadJob::State QGeoTileDownloadJob::state() const
+{
+    return m_state;
+}
+
+/*
+    Sets the number of tiles of this job requested at the same time to
+    \a maximum. The default is 6. The tile fetcher has its own limit, shared
+    with the maps.
+*/
+void QGeoTileDownloadJob::setMaximumConcurrentRequests(int maximum)
+{
+    m_maxConcurrentRequests = qMax(1, maximum);
+}
+
+int QGeoTileDownloadJob::maximumConcurrentRequests() const
+{
+    return m_maxConcurrentRequests;
+}
+
+/*
+    Limits the tiles this job requests to \a rate per second, on average.
+    Zero, the default, does not limit the rate.
+*/
+void QGeoTileDownloadJob::setRequestsPerSecond(qreal rate)
+{
+    m_requestsPerSecond = qMax(qreal(0), rate);
+}
+
+qreal QGeoTileDownloadJob::requestsPerSecond() const
+{
+    return m_requestsPerSecond;
+}
+
+/*
+    Returns the number of tiles in the bounding rectangle of the area, over
+    all zoom levels. processedTiles() reaches it once the job is finished.
+*/
+qint64 QGeoTileDownloadJob::totalTiles() const
+{
+    return m_total;
+}
+
+qint64 QGeoTileDownloadJob::processedTiles() const
+{
+    return m_fetched + m_skipped + m_failed;
+}
+
+qint64 QGeoTileDownloadJob::fetchedTiles() const
+{
+    return m_fetched;
+}
+
+/*
+    Returns the number of tiles not requested, because they were already in
+    the disk cache or outside of the area.
+*/
+qint64 QGeoTileDownloadJob::skippedTiles() const
+{
+    return m_skipped;
+}
+
+qint64 QGeoTileDownloadJob::failedTiles() const
+{
+    return m_failed;
+}
+
+void QGeoTileDownloadJob::start()
+{
+    if (m_state != Idle)
+        return;
+    setState(Running);
+    m_clock.start();
+    requestTiles();
+}
+
+/*
+    Stops requesting tiles and drops the ones still in flight, unless a map
+    is waiting for them too. Tiles fetched so far stay in the cache.
+*/
+void QGeoTileDownloadJob::cancel()
+{
+    if (m_state != Idle && m_state != Running)
+        return;
+    m_timer.stop();
+    if (m_engine && !m_pending.isEmpty())
+        m_engine->cancelTileDownloads(this, m_pending);
+    m_pending.clear();
+    setState(Canceled);
+}
+
+void QGeoTileDownloadJob::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+    m_timer.stop();
+    requestTiles();
+}
+
+/*
+    The columns and rows of tiles at \a zoom covering the bounding rectangle
+    of \a area.
+*/
+QGeoTileDownloadJob::TileRange QGeoTileDownloadJob::tileRange(const QGeoShape &area, int zoom)
+{
+    TileRange range = { zoom, 0, 0, 0, 0 };
+    const QGeoRectangle box = area.boundingGeoRectangle();
+    if (!box.isValid() || zoom < 0 || zoom > 30)
+        return range;
+
+    const int side = 1 << zoom;
+    const QDoubleVector2D topLeft = QWebMercator::coordToMercator(box.topLeft());
+    const QDoubleVector2D bottomRight = QWebMercator::coordToMercator(box.bottomRight());
+    const int x0 = qBound(0, int(std::floor(topLeft.x() * side)), side - 1);
+    const int x1 = qBound(0, int(std::floor(bottomRight.x() * side)), side - 1);
+    const int y0 = qBound(0, int(std::floor(topLeft.y() * side)), side - 1);
+    const int y1 = qBound(0, int(std::floor(bottomRight.y() * side)), side - 1);
+
+    range.x = x0;
+    range.y = y0;
+    range.rows = y1 - y0 + 1;
+    if (box.topLeft().longitude() > box.bottomRight().longitude()) // crosses the dateline
+        range.columns = qMin(side, x1 + side - x0 + 1);
+    else
+        range.columns = x1 - x0 + 1;
+    return range;
+}
+
+static bool tileInShape(const QGeoShape &area, int zoom, int x, int y)
+{
+    if (area.type() == QGeoShape::RectangleType)
+        return true;
+
+    const double side = double(1 << zoom);
+    for (int i = 0; i <= 2; ++i) {
+        for (int j = 0; j <= 2; ++j) {
+            // corners and center
+            if ((i == 1) != (j == 1))
+                continue;
+            const QGeoCoordinate c = QWebMercator::mercatorToCoord(
+                        QDoubleVector2D((x + 0.5 * i) / side, (y + 0.5 * j) / side));
+            if (area.contains(c))
+                return true;
+        }
+    }
+    // areas smaller than a tile
+    const QGeoRectangle tile(QWebMercator::mercatorToCoord(QDoubleVector2D(x / side, y / side)),
+                             QWebMercator::mercatorToCoord(QDoubleVector2D((x + 1) / side, (y + 1) / side)));
+    return tile.contains(area.center());
+}
+
+/*
+    Returns the tiles of \a zoom whose center or a corner lie in \a area, or
+    which contain its center. For a rectangle, all tiles it touches are
+    returned.
+*/
+QVector<QGeoTileSpec> QGeoTileDownloadJob::tilesForShape(const QGeoShape &area, int zoom, int mapId,
+                                                         const QString &plugin, int version)
+{
+    QVector<QGeoTileSpec> tiles;
+    const TileRange range = tileRange(area, zoom);
+    const int side = 1 << zoom;
+    for (int row = 0; row < range.rows; ++row) {
+        for (int column = 0; column < range.columns; ++column) {
+            const int x = (range.x + column) % side;
+            const int y = range.y + row;
+            if (tileInShape(area, zoom, x, y))
+                tiles.append(QGeoTileSpec(plugin, mapId, zoom, x, y, version));
+        }
+    }
+    return tiles;
+}
+
+/*
+    Advances the enumeration by one tile. Returns true with the tile in
+    \a spec if it has to be fetched, false if it was skipped.
+*/
+bool QGeoTileDownloadJob::nextTile(QGeoTileSpec *spec)
+{
+    const TileRange &range = m_ranges.at(m_range);
+    const int side = 1 << range.zoom;
+    const int x = (range.x + int(m_index % range.columns)) % side;
+    const int y = range.y + int(m_index / range.columns);
+    if (++m_index == range.count()) {
+        ++m_range;
+        m_index = 0;
+    }
+
+    const QGeoTileSpec tile(m_plugin, m_mapId, range.zoom, x, y, m_version);
+    if (!tileInShape(m_area, range.zoom, x, y)
+            || m_engine->tileCache()->contains(tile, QAbstractGeoTileCache::DiskCache)) {
+        ++m_skipped;
+        return false;
+    }
+    *spec = tile;
+    return true;
+}
+
+void QGeoTileDownloadJob::requestTiles()
+{
+    if (m_state != Running)
+        return;
+    if (!m_engine) {
+        cancel();
+        return;
+    }
+
+    QSet<QGeoTileSpec> tiles;
+    int budget = enumerationBudget;
+    int delay = -1;
+    while (m_range < m_ranges.size() && m_pending.size() + tiles.size() < m_maxConcurrentRequests) {
+        if (budget-- == 0) {
+            delay = 0;
+            break;
+        }
+        if (m_requestsPerSecond > 0) {
+            const qreal allowed = m_requestsPerSecond * m_clock.elapsed() / 1000.0 + 1;
+            if (m_requested >= allowed) {
+                delay = qMax(1, int(std::ceil((m_requested - allowed + 1) * 1000.0 / m_requestsPerSecond)));
+                break;
+            }
+        }
+
+        QGeoTileSpec spec;
+        if (nextTile(&spec)) {
+            tiles.insert(spec);
+            ++m_requested;
+        }
+    }
+
+    if (!tiles.isEmpty()) {
+        m_pending += tiles;
+        m_engine->requestTileDownloads(this, tiles);
+    }
+    if (delay >= 0)
+        m_timer.start(delay, this);
+
+    emit progress(processedTiles(), m_total);
+
+    if (m_range == m_ranges.size() && m_pending.isEmpty()) {
+        setState(Finished);
+        emit finished();
+    }
+}
+
+void QGeoTileDownloadJob::tileDone(const QGeoTileSpec &spec)
+{
+    m_pending.remove(spec);
+    requestTiles();
+}
+
+void QGeoTileDownloadJob::handleTileFinished(const QGeoTileSpec &spec)
+{
+    if (!m_pending.contains(spec))
+        return;
+    ++m_fetched;
+    tileDone(spec);
+}
+
+void QGeoTileDownloadJob::handleTileError(const QGeoTileSpec &spec, const QString &errorString)
+{
+    if (!m_pending.contains(spec))
+        return;
+    ++m_failed;
+    emit tileFailed(spec, errorString);
+    tileDone(spec);
+}
+
+void QGeoTileDownloadJob::setState(State state)
+{
+    if (m_state == state)
+        return;
+    m_state = state;
+    emit stateChanged(state);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOTILEDOWNLOADJOB_P_H
+#define QGEOTILEDOWNLOADJOB_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtPositioning/QGeoShape>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoTiledMappingManagerEngine;
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileDownloadJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        Idle,
+        Running,
+        Finished,
+        Canceled
+    };
+    Q_ENUM(State)
+
+    ~QGeoTileDownloadJob();
+
+    QGeoShape area() const;
+    int minimumZoomLevel() const;
+    int maximumZoomLevel() const;
+    int mapId() const;
+    State state() const;
+
+    void setMaximumConcurrentRequests(int maximum);
+    int maximumConcurrentRequests() const;
+    void setRequestsPerSecond(qreal rate);
+    qreal requestsPerSecond() const;
+
+    qint64 totalTiles() const;
+    qint64 processedTiles() const;
+    qint64 fetchedTiles() const;
+    qint64 skippedTiles() const;
+    qint64 failedTiles() const;
+
+    static QVector<QGeoTileSpec> tilesForShape(const QGeoShape &area, int zoom, int mapId,
+                                               const QString &plugin, int version = -1);
+
+public Q_SLOTS:
+    void start();
+    void cancel();
+
+Q_SIGNALS:
+    void progress(qint64 processed, qint64 total);
+    void tileFailed(const QGeoTileSpec &spec, const QString &errorString);
+    void finished();
+    void stateChanged(QGeoTileDownloadJob::State state);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    QGeoTileDownloadJob(QGeoTiledMappingManagerEngine *engine, const QGeoShape &area,
+                        int minZoom, int maxZoom, int mapId);
+
+    struct TileRange
+    {
+        int zoom;
+        int x;      // first column, may be followed by columns wrapping around the dateline
+        int y;      // first row
+        int columns;
+        int rows;
+        qint64 count() const { return qint64(columns) * rows; }
+    };
+    static TileRange tileRange(const QGeoShape &area, int zoom);
+    bool nextTile(QGeoTileSpec *spec);
+    void requestTiles();
+    void tileDone(const QGeoTileSpec &spec);
+    void handleTileFinished(const QGeoTileSpec &spec);
+    void handleTileError(const QGeoTileSpec &spec, const QString &errorString);
+    void setState(State state);
+
+    QPointer<QGeoTiledMappingManagerEngine> m_engine;
+    QGeoShape m_area;
+    QString m_plugin;
+    int m_version;
+    int m_minZoom;
+    int m_maxZoom;
+    int m_mapId;
+    State m_state;
+    int m_maxConcurrentRequests;
+    qreal m_requestsPerSecond;
+
+    QVector<TileRange> m_ranges;
+    int m_range;            // position of the enumeration
+    qint64 m_index;         // within m_ranges[m_range]
+    QSet<QGeoTileSpec> m_pending;
+    qint64 m_total;
+    qint64 m_fetched;
+    qint64 m_skipped;
+    qint64 m_failed;
+
+    QBasicTimer m_timer;
+    QElapsedTimer m_clock;  // since the first request, for the rate limit
+    qint64 m_requested;
+
+    friend class QGeoTiledMappingManagerEngine;
+    Q_DISABLE_COPY(QGeoTileDownloadJob)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEDOWNLOADJOB_P_H
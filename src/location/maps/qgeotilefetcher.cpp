@@ -43,8 +43,7 @@
 #include "qgeotilespec_p.h"
 #include "qgeotiledmap_p.h"
 
-#include <algorithm>
-#include <iterator>
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
@@ -69,8 +68,43 @@ QGeoTileFetcher::~QGeoTileFetcher()
 {
 }
 
+/*
+    Sets the number of tile replies that may be in flight at the same time to
+    \a maximum. Whenever a reply finishes, the next queued tile is requested.
+    The default is 6, matching the per-host connection limit of
+    QNetworkAccessManager for HTTP/1.1.
+*/
+void QGeoTileFetcher::setMaximumConcurrentRequests(int maximum)
+{
+    Q_D(QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    d->maxConcurrentRequests_ = qMax(1, maximum);
+    if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
+}
+
+int QGeoTileFetcher::maximumConcurrentRequests() const
+{
+    Q_D(const QGeoTileFetcher);
+    return d->maxConcurrentRequests_;
+}
+
 void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
                                                   const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    updateTileRequests(tilesAdded, tilesRemoved, QHash<QGeoTileSpec, double>());
+}
+
+/*
+    Queues \a tilesAdded and cancels \a tilesRemoved. Tiles are requested in
+    ascending order of their value in \a priorities; tiles without a priority
+    are requested after all prioritized ones, in the order they were added.
+    Already queued tiles listed in \a priorities are re-prioritized.
+*/
+void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
+                                         const QSet<QGeoTileSpec> &tilesRemoved,
+                                         const QHash<QGeoTileSpec, double> &priorities)
 {
     Q_D(QGeoTileFetcher);
 
@@ -78,12 +112,60 @@ void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
 
     cancelTileRequests(tilesRemoved);
 
-    std::copy(tilesAdded.cbegin(), tilesAdded.cend(), std::back_inserter(d->queue_));
+    for (auto it = priorities.cbegin(); it != priorities.cend(); ++it) {
+        if (d->queueKeys_.contains(it.key()))
+            d->enqueue(it.key(), it.value());
+    }
+
+    // Tiles already in flight are shared by every map that asks for them
+    const double unprioritized = std::numeric_limits<double>::max();
+    for (const QGeoTileSpec &tile : tilesAdded) {
+        if (!d->invmap_.contains(tile))
+            d->enqueue(tile, priorities.value(tile, unprioritized));
+    }
 
     if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
         d->timer_.start(0, this);
 }
 
+/*
+    Queues a conditional request for the cached tile \a spec, which expired.
+    getTileImage() implementations send \a validators, as returned by
+    tileValidators(), and a "304 Not Modified" answer is reported by
+    tileNotModified() instead of tileFinished(). Revalidations come after the
+    tiles maps are waiting for.
+*/
+void QGeoTileFetcher::revalidateTile(const QGeoTileSpec &spec, const QGeoTileValidators &validators)
+{
+    Q_D(QGeoTileFetcher);
+
+    if (!validators.canRevalidate())
+        return;
+
+    QMutexLocker ml(&d->queueMutex_);
+    if (d->invmap_.contains(spec) || d->queueKeys_.contains(spec))
+        return;
+
+    d->revalidations_.insert(spec, validators);
+    // after the unprioritized tiles too, a map asking for the tile moves it up
+    d->enqueue(spec, std::numeric_limits<double>::infinity());
+
+    if (d->enabled_ && initialized() && !d->timer_.isActive())
+        d->timer_.start(0, this);
+}
+
+/*
+    Returns the validators to send with the request for \a spec, or null
+    validators for an unconditional request. Only meant to be called from
+    getTileImage().
+*/
+QGeoTileValidators QGeoTileFetcher::tileValidators(const QGeoTileSpec &spec) const
+{
+    Q_D(const QGeoTileFetcher);
+    // queueMutex_ is held by requestNextTile()
+    return d->revalidations_.value(spec);
+}
+
 void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
 {
     Q_D(QGeoTileFetcher);
@@ -100,7 +182,8 @@ void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
             if (reply->isFinished())
                 reply->deleteLater();
         }
-        d->queue_.removeAll(*tile);
+        d->dequeue(*tile);
+        d->revalidations_.remove(*tile);
     }
 }
 
@@ -116,18 +199,22 @@ void QGeoTileFetcher::requestNextTile()
     if (d->queue_.isEmpty())
         return;
 
-    QGeoTileSpec ts = d->queue_.takeFirst();
+    QGeoTileSpec ts = d->queue_.take(d->queue_.firstKey());
+    d->queueKeys_.remove(ts);
     if (d->queue_.isEmpty())
         d->timer_.stop();
 
     // Check against min/max zoom to prevent sending requests for not existing objects
-    const QGeoCameraCapabilities & cameraCaps = d->engine_->cameraCapabilities(ts.mapId());
+    const QGeoCameraCapabilities cameraCaps = d->cameraCapabilities(ts.mapId());
     // the ZL in QGeoTileSpec is relative to the native tile size of the provider.
     // It gets denormalized in QGeoTiledMap.
-    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled())
+    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled()) {
+        d->revalidations_.remove(ts);
         return;
+    }
 
     QGeoTiledMapReply *reply = getTileImage(ts);
+    d->revalidations_.remove(ts);
     if (!reply)
         return;
 
@@ -164,6 +251,10 @@ void QGeoTileFetcher::finished()
     d->invmap_.remove(spec);
 
     handleReply(reply, spec);
+
+    // A slot in the request window became free
+    if (!d->queue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
 }
 
 void QGeoTileFetcher::timerEvent(QTimerEvent *event)
@@ -179,9 +270,18 @@ void QGeoTileFetcher::timerEvent(QTimerEvent *event)
         d->timer_.stop();
         return;
     }
-    ml.unlock();
 
-    requestNextTile();
+    // Fill the window of concurrent requests. Once it is full the timer is
+    // stopped, finished() restarts it when a reply completes.
+    while (d->enabled_ && !d->queue_.isEmpty()) {
+        if (d->invmap_.size() >= d->maxConcurrentRequests_) {
+            d->timer_.stop();
+            return;
+        }
+        ml.unlock();
+        requestNextTile();
+        ml.relock();
+    }
 }
 
 bool QGeoTileFetcher::initialized() const
@@ -204,7 +304,13 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
     }
 
     if (reply->error() == QGeoTiledMapReply::NoError) {
-        emit tileFinished(spec, reply->mapImageData(), reply->mapImageFormat());
+        if (reply->isNotModified()) {
+            emit tileNotModified(spec, reply->validators());
+        } else {
+            emit tileFinished(spec, reply->mapImageData(), reply->mapImageFormat());
+            if (!reply->validators().isNull())
+                emit tileValidatorsReceived(spec, reply->validators());
+        }
     } else {
         emit tileError(spec, reply->errorString());
     }
@@ -212,11 +318,23 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
     reply->deleteLater();
 }
 
+/*
+    Keeps copies of the camera capabilities of the engine, by map id, for
+    requestNextTile(). The engine sets them in the thread of the fetcher, which
+    may not be its own, see QGeoTiledMappingManagerEngine::setThreadedTileFetching().
+*/
+void QGeoTileFetcher::setCameraCapabilities(const QVector<QGeoCameraCapabilities> &capabilities)
+{
+    Q_D(QGeoTileFetcher);
+    d->cameraCapabilities_ = capabilities;
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
 QGeoTileFetcherPrivate::QGeoTileFetcherPrivate()
-:   QObjectPrivate(), enabled_(false), engine_(0)
+:   QObjectPrivate(), enabled_(false), queueSequence_(0), maxConcurrentRequests_(6),
+    engine_(0)
 {
 }
 
@@ -224,4 +342,38 @@ QGeoTileFetcherPrivate::~QGeoTileFetcherPrivate()
 {
 }
 
+// Inserts spec into the queue, or moves it if it is already queued.
+void QGeoTileFetcherPrivate::enqueue(const QGeoTileSpec &spec, double priority)
+{
+    auto key = queueKeys_.find(spec);
+    if (key != queueKeys_.end()) {
+        if (key->priority == priority)
+            return;
+        queue_.remove(*key);
+        *key = QGeoTileFetchKey(priority, queueSequence_++);
+    } else {
+        key = queueKeys_.insert(spec, QGeoTileFetchKey(priority, queueSequence_++));
+    }
+    queue_.insert(*key, spec);
+}
+
+// What QGeoMappingManagerEngine::cameraCapabilities() answered when the copies were made
+QGeoCameraCapabilities QGeoTileFetcherPrivate::cameraCapabilities(int mapId) const
+{
+    if (cameraCapabilities_.isEmpty()) // not set by a tiled engine, whose thread this is then
+        return engine_->cameraCapabilities(mapId);
+    if (mapId < 0 || mapId >= cameraCapabilities_.size())
+        return cameraCapabilities_.first();
+    return cameraCapabilities_.at(mapId);
+}
+
+void QGeoTileFetcherPrivate::dequeue(const QGeoTileSpec &spec)
+{
+    auto key = queueKeys_.find(spec);
+    if (key == queueKeys_.end())
+        return;
+    queue_.remove(*key);
+    queueKeys_.erase(key);
+}
+
 QT_END_NAMESPACE
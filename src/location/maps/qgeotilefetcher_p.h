@@ -49,9 +49,11 @@
 //
 
 #include <QObject>
+#include <QHash>
 #include <QtLocation/private/qlocationglobal_p.h>
 #include "qgeomaptype_p.h"
 #include "qgeotiledmappingmanagerengine_p.h"
+#include "qgeotiledmapreply_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -71,6 +73,13 @@ public:
     QGeoTileFetcher(QGeoMappingManagerEngine *parent);
     virtual ~QGeoTileFetcher();
 
+    void setMaximumConcurrentRequests(int maximum);
+    int maximumConcurrentRequests() const;
+
+    void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved,
+                            const QHash<QGeoTileSpec, double> &priorities);
+    void revalidateTile(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+
 public Q_SLOTS:
     void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved);
 
@@ -82,6 +91,8 @@ private Q_SLOTS:
 Q_SIGNALS:
     void tileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
+    void tileNotModified(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+    void tileValidatorsReceived(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
 
 protected:
     QGeoTileFetcher(QGeoTileFetcherPrivate &dd, QGeoMappingManagerEngine *parent);
@@ -90,11 +101,13 @@ protected:
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
     virtual bool initialized() const;
     virtual bool fetchingEnabled() const;
+    QGeoTileValidators tileValidators(const QGeoTileSpec &spec) const;
 
 private:
 
     virtual QGeoTiledMapReply *getTileImage(const QGeoTileSpec &spec) = 0;
     virtual void handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &spec);
+    void setCameraCapabilities(const QVector<QGeoCameraCapabilities> &capabilities);
 
     Q_DISABLE_COPY(QGeoTileFetcher)
     friend class QGeoTiledMappingManagerEngine;
@@ -59,7 +59,9 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QHash>
+#include <QVector>
 #include "qgeomaptype_p.h"
+#include "qgeotiledmapreply_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -67,6 +69,23 @@ class QGeoTileSpec;
 class QGeoTiledMapReply;
 class QGeoMappingManagerEngine;
 
+class QGeoTileFetchKey
+{
+public:
+    QGeoTileFetchKey(double priority = 0.0, quint64 sequence = 0)
+        : priority(priority), sequence(sequence) {}
+
+    bool operator<(const QGeoTileFetchKey &rhs) const
+    {
+        if (priority != rhs.priority)
+            return priority < rhs.priority;
+        return sequence < rhs.sequence;
+    }
+
+    double priority;
+    quint64 sequence; // keeps keys unique and equal priorities in FIFO order
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoTileFetcherPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QGeoTileFetcher)
@@ -77,9 +96,18 @@ public:
     bool enabled_;
     QBasicTimer timer_;
     QMutex queueMutex_;
-    QList<QGeoTileSpec> queue_;
+    void enqueue(const QGeoTileSpec &spec, double priority);
+    void dequeue(const QGeoTileSpec &spec);
+    QGeoCameraCapabilities cameraCapabilities(int mapId) const;
+
+    QMap<QGeoTileFetchKey, QGeoTileSpec> queue_;
+    QHash<QGeoTileSpec, QGeoTileFetchKey> queueKeys_;
+    quint64 queueSequence_;
     QHash<QGeoTileSpec, QGeoTiledMapReply *> invmap_;
+    QHash<QGeoTileSpec, QGeoTileValidators> revalidations_; // queued tiles to request conditionally
+    int maxConcurrentRequests_;
     QGeoMappingManagerEngine *engine_;
+    QVector<QGeoCameraCapabilities> cameraCapabilities_; // copies by map id given by the engine, 0 is the default
 
 private:
     Q_DISABLE_COPY(QGeoTileFetcherPrivate)
@@ -38,6 +38,7 @@
 #include "qgeotiledmap_p.h"
 #include "qgeotiledmappingmanagerengine_p.h"
 #include "qabstractgeotilecache_p.h"
+#include "qgeomapstatistics_p.h"
 #include <QtCore/QPointer>
 
 QT_BEGIN_NAMESPACE
@@ -59,8 +60,11 @@ public:
     QHash<QGeoTileSpec, int> m_retries;
     QHash<QGeoTileSpec, QSharedPointer<RetryFuture> > m_futures;
     QSet<QGeoTileSpec> m_requested;
+    QSet<QGeoTileSpec> m_decoding;
 
     void tileFetched(const QGeoTileSpec &spec);
+    void tileDecoded(const QGeoTileSpec &spec, bool success);
+    void tileDecodePending(const QGeoTileSpec &spec);
 };
 
 QGeoTileRequestManager::QGeoTileRequestManager(QGeoTiledMap *map, QGeoTiledMappingManagerEngine *engine)
@@ -76,6 +80,7 @@ QGeoTileRequestManager::~QGeoTileRequestManager()
 
 QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTiles(const QSet<QGeoTileSpec> &tiles)
 {
+    QGeoMapStatisticsTimer timer(QGeoMapStatistics::RequestTiles);
     return d_ptr->requestTiles(tiles);
 }
 
@@ -84,6 +89,16 @@ void QGeoTileRequestManager::tileFetched(const QGeoTileSpec &spec)
     d_ptr->tileFetched(spec);
 }
 
+void QGeoTileRequestManager::tileDecoded(const QGeoTileSpec &spec, bool success)
+{
+    d_ptr->tileDecoded(spec, success);
+}
+
+void QGeoTileRequestManager::tileDecodePending(const QGeoTileSpec &spec)
+{
+    d_ptr->tileDecodePending(spec);
+}
+
 QSharedPointer<QGeoTileTexture> QGeoTileRequestManager::tileTexture(const QGeoTileSpec &spec)
 {
     if (d_ptr->m_engine)
@@ -92,6 +107,15 @@ QSharedPointer<QGeoTileTexture> QGeoTileRequestManager::tileTexture(const QGeoTi
         return QSharedPointer<QGeoTileTexture>();
 }
 
+/*
+    Returns the number of tiles being fetched or decoded for the map, including
+    the ones waiting to be retried.
+*/
+int QGeoTileRequestManager::pendingTileCount() const
+{
+    return d_ptr->m_requested.size() + d_ptr->m_decoding.size();
+}
+
 void QGeoTileRequestManager::tileError(const QGeoTileSpec &tile, const QString &errorString)
 {
     d_ptr->tileError(tile, errorString);
@@ -110,7 +134,9 @@ QGeoTileRequestManagerPrivate::~QGeoTileRequestManagerPrivate()
 QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileSpec> &tiles)
 {
     QSet<QGeoTileSpec> cancelTiles = m_requested - tiles;
-    QSet<QGeoTileSpec> requestTiles = tiles - m_requested;
+    QSet<QGeoTileSpec> requestTiles = tiles - m_requested - m_decoding;
+    QSet<QGeoTileSpec> cancelDecodes = m_decoding - tiles;
+    QSet<QGeoTileSpec> decodeTiles;
     QSet<QGeoTileSpec> cached;
 //    int tileSize = tiles.size();
 //    int newTiles = requestTiles.size();
@@ -127,7 +153,9 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
             QGeoTileSpec tile = *i;
             QSharedPointer<QGeoTileTexture> tex = m_engine->getTileTexture(tile);
             if (tex) {
-                if (!tex->image.isNull())
+                if (tex->pending)
+                    decodeTiles.insert(tile);
+                else if (!tex->isNull())
                     cachedTex.insert(tile, tex);
                 cached.insert(tile);
             } else {
@@ -140,7 +168,7 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
                     spec.setX(tile.x() / denominator);
                     spec.setY(tile.y() / denominator);
                     QSharedPointer<QGeoTileTexture> t = m_engine->getTileTexture(spec);
-                    if (t && !t->image.isNull()) {
+                    if (t && !t->isNull()) {
                         cachedTex.insert(tile, t);
                         break;
                     }
@@ -154,6 +182,11 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
     m_requested -= cancelTiles;
     m_requested += requestTiles;
 
+    m_decoding -= cancelDecodes;
+    m_decoding += decodeTiles;
+    if ((!decodeTiles.isEmpty() || !cancelDecodes.isEmpty()) && !m_engine.isNull())
+        m_engine->updateTileDecodes(m_map, decodeTiles, cancelDecodes);
+
 //    qDebug() << "required # tiles: " << tileSize << ", new tiles: " << newTiles << ", total server requests: " << requested_.size();
 
     if (!requestTiles.isEmpty() || !cancelTiles.isEmpty()) {
@@ -183,6 +216,36 @@ void QGeoTileRequestManagerPrivate::tileFetched(const QGeoTileSpec &spec)
     m_futures.remove(spec);
 }
 
+void QGeoTileRequestManagerPrivate::tileDecoded(const QGeoTileSpec &spec, bool success)
+{
+    if (!m_decoding.remove(spec))
+        return;
+
+    if (success) {
+        m_map->updateTile(spec);
+        return;
+    }
+
+    // The cached data turned out to be unusable, fetch the tile again
+    if (!m_engine.isNull()) {
+        m_requested.insert(spec);
+        m_engine->updateTileRequests(m_map, QSet<QGeoTileSpec>() << spec, QSet<QGeoTileSpec>());
+    }
+}
+
+// The texture for spec is being decoded asynchronously, typically right after
+// it was fetched. The decode is shared with the other maps waiting for it and
+// tileDecoded() is called once it completes.
+void QGeoTileRequestManagerPrivate::tileDecodePending(const QGeoTileSpec &spec)
+{
+    if (m_decoding.contains(spec))
+        return;
+
+    m_decoding.insert(spec);
+    if (!m_engine.isNull())
+        m_engine->updateTileDecodes(m_map, QSet<QGeoTileSpec>() << spec, QSet<QGeoTileSpec>());
+}
+
 // Represents a tile that needs to be retried after a certain period of time
 class RetryFuture : public QObject
 {
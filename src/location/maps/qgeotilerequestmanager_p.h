@@ -69,7 +69,10 @@ public:
 
     void tileError(const QGeoTileSpec &tile, const QString &errorString);
     void tileFetched(const QGeoTileSpec &spec);
+    void tileDecoded(const QGeoTileSpec &spec, bool success);
+    void tileDecodePending(const QGeoTileSpec &spec);
     QSharedPointer<QGeoTileTexture> tileTexture(const QGeoTileSpec &spec);
+    int pendingTileCount() const;
 
 private:
     QScopedPointer<QGeoTileRequestManagerPrivate> d_ptr;
@@ -35,185 +35,155 @@
 ****************************************************************************/
 
 #include "qgeotilespec_p.h"
-#include "qgeotilespec_p_p.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
-QGeoTileSpec::QGeoTileSpec()
-    : d(QSharedDataPointer<QGeoTileSpecPrivate>(new QGeoTileSpecPrivate())) {}
-
-QGeoTileSpec::QGeoTileSpec(const QString &plugin, int mapId, int zoom, int x, int y, int version)
-        : d(QSharedDataPointer<QGeoTileSpecPrivate>(new QGeoTileSpecPrivate(plugin, mapId, zoom, x, y, version))) {}
+namespace {
+
+// Plugin names are few and live as long as the process, intern them once
+class QGeoTilePluginNames
+{
+public:
+    QGeoTilePluginNames()
+    {
+        names_.append(QString());
+        ids_.insert(QString(), 0);
+    }
+
+    quint32 intern(const QString &plugin)
+    {
+        {
+            QReadLocker locker(&lock_);
+            auto it = ids_.constFind(plugin);
+            if (it != ids_.constEnd())
+                return it.value();
+        }
+
+        QWriteLocker locker(&lock_);
+        auto it = ids_.constFind(plugin);
+        if (it != ids_.constEnd())
+            return it.value();
+        const quint32 id = quint32(names_.size());
+        names_.append(plugin);
+        ids_.insert(plugin, id);
+        return id;
+    }
+
+    QString name(quint32 id)
+    {
+        QReadLocker locker(&lock_);
+        return names_.value(int(id));
+    }
+
+private:
+    QReadWriteLock lock_;
+    QHash<QString, quint32> ids_;
+    QVector<QString> names_;
+};
+
+Q_GLOBAL_STATIC(QGeoTilePluginNames, pluginNames)
 
-QGeoTileSpec::QGeoTileSpec(const QGeoTileSpec &other)
-    : d(other.d) {}
-
-QGeoTileSpec::~QGeoTileSpec() {
 }
 
-QGeoTileSpec &QGeoTileSpec::operator = (const QGeoTileSpec &other)
-{
-    if (this == &other)
-        return *this;
+QGeoTileSpec::QGeoTileSpec()
+    : pluginId_(0),
+    mapId_(0),
+    zoom_(-1),
+    x_(-1),
+    y_(-1),
+    version_(-1) {}
 
-    d = other.d;
-    return *this;
+QGeoTileSpec::QGeoTileSpec(const QString &plugin, int mapId, int zoom, int x, int y, int version)
+    : pluginId_(0),
+    mapId_(mapId),
+    zoom_(zoom),
+    x_(x),
+    y_(y),
+    version_(version)
+{
+    QGeoTilePluginNames *names = pluginNames();
+    if (!plugin.isEmpty() && names)
+        pluginId_ = names->intern(plugin);
 }
 
 QString QGeoTileSpec::plugin() const
 {
-    return d->plugin_;
+    QGeoTilePluginNames *names = pluginNames();
+    if (!pluginId_ || !names)
+        return QString();
+    return names->name(pluginId_);
 }
 
 void QGeoTileSpec::setZoom(int zoom)
 {
-    d->zoom_ = zoom;
+    zoom_ = zoom;
 }
 
 int QGeoTileSpec::zoom() const
 {
-    return d->zoom_;
+    return zoom_;
 }
 
 void QGeoTileSpec::setX(int x)
 {
-    d->x_ = x;
+    x_ = x;
 }
 
 int QGeoTileSpec::x() const
 {
-    return d->x_;
+    return x_;
 }
 
 void QGeoTileSpec::setY(int y)
 {
-    d->y_ = y;
+    y_ = y;
 }
 
 int QGeoTileSpec::y() const
 {
-    return d->y_;
+    return y_;
 }
 
 void QGeoTileSpec::setMapId(int mapId)
 {
-    d->mapId_ = mapId;
+    mapId_ = mapId;
 }
 
 int QGeoTileSpec::mapId() const
 {
-    return d->mapId_;
+    return mapId_;
 }
 
 void QGeoTileSpec::setVersion(int version)
 {
-    d->version_ = version;
+    version_ = version;
 }
 
 int QGeoTileSpec::version() const
 {
-    return d->version_;
+    return version_;
 }
 
 bool QGeoTileSpec::operator == (const QGeoTileSpec &rhs) const
 {
-    return (*(d.constData()) == *(rhs.d.constData()));
+    return x_ == rhs.x_
+            && y_ == rhs.y_
+            && zoom_ == rhs.zoom_
+            && mapId_ == rhs.mapId_
+            && version_ == rhs.version_
+            && pluginId_ == rhs.pluginId_;
 }
 
 bool QGeoTileSpec::operator < (const QGeoTileSpec &rhs) const
 {
-    return (*(d.constData()) < *(rhs.d.constData()));
-}
-
-unsigned int qHash(const QGeoTileSpec &spec)
-{
-    unsigned int result = (qHash(spec.plugin()) * 13) % 31;
-    result += ((spec.mapId() * 17) % 31) << 5;
-    result += ((spec.zoom() * 19) % 31) << 10;
-    result += ((spec.x() * 23) % 31) << 15;
-    result += ((spec.y() * 29) % 31) << 20;
-    result += (spec.version() % 3) << 25;
-    return result;
-}
-
-QDebug operator<< (QDebug dbg, const QGeoTileSpec &spec)
-{
-    dbg << spec.plugin() << spec.mapId() << spec.zoom() << spec.x() << spec.y() << spec.version();
-    return dbg;
-}
-
-QGeoTileSpecPrivate::QGeoTileSpecPrivate()
-    : mapId_(0),
-    zoom_(-1),
-    x_(-1),
-    y_(-1),
-    version_(-1) {}
-
-QGeoTileSpecPrivate::QGeoTileSpecPrivate(const QGeoTileSpecPrivate &other)
-    : QSharedData(other),
-      plugin_(other.plugin_),
-      mapId_(other.mapId_),
-      zoom_(other.zoom_),
-      x_(other.x_),
-      y_(other.y_),
-      version_(other.version_) {}
-
-QGeoTileSpecPrivate::QGeoTileSpecPrivate(const QString &plugin, int mapId, int zoom, int x, int y, int version)
-    : plugin_(plugin),
-      mapId_(mapId),
-      zoom_(zoom),
-      x_(x),
-      y_(y),
-      version_(version) {}
-
-QGeoTileSpecPrivate::~QGeoTileSpecPrivate() {}
-
-QGeoTileSpecPrivate &QGeoTileSpecPrivate::operator = (const QGeoTileSpecPrivate &other)
-{
-    if (this == &other)
-        return *this;
-
-    plugin_ = other.plugin_;
-    mapId_ = other.mapId_;
-    zoom_ = other.zoom_;
-    x_ = other.x_;
-    y_ = other.y_;
-    version_ = other.version_;
-
-    return *this;
-}
-
-bool QGeoTileSpecPrivate::operator == (const QGeoTileSpecPrivate &rhs) const
-{
-    if (plugin_ != rhs.plugin_)
-        return false;
-
-    if (mapId_ != rhs.mapId_)
-        return false;
-
-    if (zoom_ != rhs.zoom_)
-        return false;
-
-    if (x_ != rhs.x_)
-        return false;
-
-    if (y_ != rhs.y_)
-        return false;
-
-    if (version_ != rhs.version_)
-        return false;
-
-    return true;
-}
-
-bool QGeoTileSpecPrivate::operator < (const QGeoTileSpecPrivate &rhs) const
-{
-    if (plugin_ < rhs.plugin_)
-        return true;
-    if (plugin_ > rhs.plugin_)
-        return false;
+    // Keep ordering by plugin name, ids only reflect the order of interning
+    if (pluginId_ != rhs.pluginId_)
+        return plugin() < rhs.plugin();
 
     if (mapId_ < rhs.mapId_)
         return true;
@@ -238,4 +208,28 @@ bool QGeoTileSpecPrivate::operator < (const QGeoTileSpecPrivate &rhs) const
     return (version_ < rhs.version_);
 }
 
+unsigned int qHash(const QGeoTileSpec &spec)
+{
+    // Pack the fields into two words and mix them (MurmurHash3 finalizer),
+    // neighbouring tiles must not collide.
+    quint64 key = quint64(quint32(spec.x_)) | (quint64(quint32(spec.y_)) << 32);
+    const quint64 meta = quint64(quint32(spec.zoom_))
+            ^ (quint64(quint32(spec.mapId_)) << 8)
+            ^ (quint64(quint32(spec.version_)) << 24)
+            ^ (quint64(spec.pluginId_) << 48);
+    key ^= meta * Q_UINT64_C(0x9e3779b97f4a7c15);
+    key ^= key >> 33;
+    key *= Q_UINT64_C(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    key *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    key ^= key >> 33;
+    return static_cast<unsigned int>(key);
+}
+
+QDebug operator<< (QDebug dbg, const QGeoTileSpec &spec)
+{
+    dbg << spec.plugin() << spec.mapId() << spec.zoom() << spec.x() << spec.y() << spec.version();
+    return dbg;
+}
+
 QT_END_NAMESPACE
@@ -52,21 +52,17 @@
 #include <QtCore/QMetaType>
 #include <QString>
 
-#include <QSharedDataPointer>
-
 QT_BEGIN_NAMESPACE
 
-class QGeoTileSpecPrivate;
-
 class Q_LOCATION_PRIVATE_EXPORT QGeoTileSpec
 {
 public:
     QGeoTileSpec();
-    QGeoTileSpec(const QGeoTileSpec &other);
+    QGeoTileSpec(const QGeoTileSpec &other) = default;
     QGeoTileSpec(const QString &plugin, int mapId, int zoom, int x, int y, int version = -1);
-    ~QGeoTileSpec();
+    ~QGeoTileSpec() = default;
 
-    QGeoTileSpec &operator = (const QGeoTileSpec &other);
+    QGeoTileSpec &operator = (const QGeoTileSpec &other) = default;
 
     QString plugin() const;
 
@@ -89,9 +85,20 @@ public:
     bool operator < (const QGeoTileSpec &rhs) const;
 
 private:
-    QSharedDataPointer<QGeoTileSpecPrivate> d;
+    // Specs are copied, hashed and compared for every tile on the render path,
+    // so they are plain values with the plugin name interned to an id.
+    quint32 pluginId_;
+    int mapId_;
+    int zoom_;
+    int x_;
+    int y_;
+    int version_;
+
+    friend Q_LOCATION_PRIVATE_EXPORT unsigned int qHash(const QGeoTileSpec &spec);
 };
 
+Q_DECLARE_TYPEINFO(QGeoTileSpec, Q_MOVABLE_TYPE);
+
 Q_LOCATION_PRIVATE_EXPORT unsigned int qHash(const QGeoTileSpec &spec);
 
 Q_LOCATION_PRIVATE_EXPORT QDebug operator<<(QDebug, const QGeoTileSpec &);
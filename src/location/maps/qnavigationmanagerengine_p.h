@@ -73,6 +73,7 @@ class QDeclarativeGeoRoute;
     This class is meant to react only on start, stop and setTrackPosition.
     Upon start(), it is supposed to fetch all info from the QDeclarativeNavigatorParams that the engine is supposed
     to inject.
+    QGeoRouteTracker can be used to compute the progress information and isOnRoute() from the position updates.
 */
 class Q_LOCATION_PRIVATE_EXPORT QAbstractNavigator: public QObject
 {
@@ -41,6 +41,7 @@ PRIVATE_HEADERS += \
     places/qplace_p.h \
     places/qplaceattribute_p.h \
     places/qplacecategory_p.h \
+    places/qplacecategorycache_p.h \
     places/qplacecontent_p.h \
     places/qplacecontactdetail_p.h \
     places/qplaceeditorial_p.h \
@@ -62,6 +63,7 @@ SOURCES += \
     places/qplace.cpp \
     places/qplaceattribute.cpp \
     places/qplacecategory.cpp \
+    places/qplacecategorycache.cpp \
     places/qplacecontactdetail.cpp \
     places/qplacecontent.cpp \
     places/qplacecontentreply.cpp \
@@ -0,0 +1,215 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplacecategorycache_p.h"
+#include "qplaceicon.h"
+#include <QtLocation/private/qabstractgeotilecache_p.h>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QLocale>
+#include <QtCore/QSaveFile>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const quint32 CacheMagic = 0x43435051; // "QPCC"
+const quint32 CacheVersion = 1;
+// Categories change rarely, refresh them once a day
+const qint64 MaximumAge = 24 * 60 * 60;
+
+}
+
+QPlaceCategoryCache::QPlaceCategoryCache(const QString &provider, const QList<QLocale> &locales)
+    : m_provider(provider),
+      m_directory(QAbstractGeoTileCache::baseCacheDirectory() + QLatin1String("QtLocation/5.8/places/"))
+{
+    QStringList names;
+    for (const QLocale &locale : locales)
+        names.append(locale.name());
+    m_key = names.join(QLatin1Char('-'));
+}
+
+void QPlaceCategoryCache::setDirectory(const QString &directory)
+{
+    m_directory = directory;
+    if (!m_directory.endsWith(QLatin1Char('/')))
+        m_directory += QLatin1Char('/');
+}
+
+QString QPlaceCategoryCache::fileName() const
+{
+    return m_directory + m_provider + QLatin1String("/categories-") + m_key;
+}
+
+/*
+    Reads the cached tree. Returns false if there is none, or if it was
+    written by another version of the format or for another key.
+*/
+bool QPlaceCategoryCache::load()
+{
+    m_categories.clear();
+    m_subcategories.clear();
+    m_timestamp = QDateTime();
+
+    QFile file(fileName());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString provider;
+    QString key;
+    QDateTime timestamp;
+    stream >> magic >> version;
+    if (magic != CacheMagic || version != CacheVersion)
+        return false;
+    stream >> provider >> key >> timestamp;
+    if (provider != m_provider || key != m_key)
+        return false;
+
+    QHash<QString, QPlaceCategory> categories;
+    QHash<QString, QStringList> subcategories;
+    qint32 parentCount = 0;
+    stream >> parentCount;
+    for (qint32 i = 0; i < parentCount && stream.status() == QDataStream::Ok; ++i) {
+        QString parentId;
+        qint32 childCount = 0;
+        stream >> parentId >> childCount;
+        QStringList &children = subcategories[parentId];
+        for (qint32 j = 0; j < childCount && stream.status() == QDataStream::Ok; ++j) {
+            QString id;
+            QString name;
+            qint32 visibility = 0;
+            QVariantMap iconParameters;
+            stream >> id >> name >> visibility >> iconParameters;
+
+            QPlaceCategory category;
+            category.setCategoryId(id);
+            category.setName(name);
+            category.setVisibility(QLocation::Visibility(visibility));
+            if (!iconParameters.isEmpty()) {
+                QPlaceIcon icon;
+                icon.setParameters(iconParameters);
+                category.setIcon(icon);
+            }
+            categories.insert(id, category);
+            children.append(id);
+        }
+    }
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    m_categories = categories;
+    m_subcategories = subcategories;
+    m_timestamp = timestamp;
+    return true;
+}
+
+/*
+    Replaces the cached tree with \a categories and \a subcategories. The file
+    is replaced atomically, so that concurrent readers do not see a partial
+    tree.
+*/
+bool QPlaceCategoryCache::save(const QHash<QString, QPlaceCategory> &categories,
+                               const QHash<QString, QStringList> &subcategories)
+{
+    if (!QDir().mkpath(m_directory + m_provider))
+        return false;
+
+    QSaveFile file(fileName());
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    const QDateTime timestamp = QDateTime::currentDateTimeUtc();
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << CacheMagic << CacheVersion << m_provider << m_key << timestamp;
+
+    stream << qint32(subcategories.size());
+    for (auto it = subcategories.cbegin(); it != subcategories.cend(); ++it) {
+        stream << it.key() << qint32(it.value().size());
+        for (const QString &id : it.value()) {
+            const QPlaceCategory category = categories.value(id);
+            stream << id << category.name() << qint32(category.visibility())
+                   << category.icon().parameters();
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+        return false;
+
+    m_categories = categories;
+    m_subcategories = subcategories;
+    m_timestamp = timestamp;
+    return true;
+}
+
+QHash<QString, QPlaceCategory> QPlaceCategoryCache::categories() const
+{
+    return m_categories;
+}
+
+QHash<QString, QStringList> QPlaceCategoryCache::subcategories() const
+{
+    return m_subcategories;
+}
+
+QDateTime QPlaceCategoryCache::timestamp() const
+{
+    return m_timestamp;
+}
+
+/*
+    Returns true if the tree was loaded or saved more than a day ago, or not
+    at all, so that the engine should fetch it again.
+*/
+bool QPlaceCategoryCache::isExpired() const
+{
+    return !m_timestamp.isValid()
+            || m_timestamp.secsTo(QDateTime::currentDateTimeUtc()) > MaximumAge;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPLACECATEGORYCACHE_P_H
+#define QPLACECATEGORYCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QStringList>
+#include <QtLocation/QPlaceCategory>
+#include <QtLocation/private/qlocationglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QLocale;
+
+/*
+    Stores the category tree of a place manager engine on disk, so that
+    initializeCategories() can complete without waiting for the network. The
+    tree is stored per provider and list of locales, like the engines keep it:
+    the categories by id, and the ids of the children by parent id, the top
+    level categories having an empty parent id.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QPlaceCategoryCache
+{
+public:
+    QPlaceCategoryCache(const QString &provider, const QList<QLocale> &locales);
+
+    void setDirectory(const QString &directory);
+    QString fileName() const;
+
+    bool load();
+    bool save(const QHash<QString, QPlaceCategory> &categories,
+              const QHash<QString, QStringList> &subcategories);
+
+    QHash<QString, QPlaceCategory> categories() const;
+    QHash<QString, QStringList> subcategories() const;
+    QDateTime timestamp() const;
+    bool isExpired() const;
+
+private:
+    QString m_provider;
+    QString m_key;
+    QString m_directory;
+    QHash<QString, QPlaceCategory> m_categories;
+    QHash<QString, QStringList> m_subcategories;
+    QDateTime m_timestamp;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPLACECATEGORYCACHE_P_H
@@ -8,6 +8,7 @@ qtConfig(location-labs-plugin): DEFINES += LOCATIONLABS
 HEADERS += \
     geocodereply_esri.h \
     geocodingmanagerengine_esri.h \
+    geofiletilecache_esri.h \
     geomapsource.h \
     georoutejsonparser_esri.h \
     georoutereply_esri.h \
@@ -24,6 +25,7 @@ HEADERS += \
 SOURCES += \
     geocodereply_esri.cpp  \
     geocodingmanagerengine_esri.cpp \
+    geofiletilecache_esri.cpp \
     geomapsource.cpp \
     georoutejsonparser_esri.cpp \
     georoutereply_esri.cpp \
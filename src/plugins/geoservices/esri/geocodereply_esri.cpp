@@ -46,6 +46,7 @@
 #include <QGeoAddress>
 #include <QGeoLocation>
 #include <QGeoRectangle>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -53,18 +54,24 @@ GeoCodeReplyEsri::GeoCodeReplyEsri(QNetworkReply *reply, OperationType operation
                                    QObject *parent) :
     QGeoCodeReply(parent), m_operationType(operationType)
 {
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
+    if (reply)
+        setNetworkReply(reply);
+
+    setLimit(1);
+    setOffset(0);
+}
+
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void GeoCodeReplyEsri::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
     connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
             this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
     connect(this, &QGeoCodeReply::aborted, reply, &QNetworkReply::abort);
     connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
-
-    setLimit(1);
-    setOffset(0);
 }
 
 GeoCodeReplyEsri::~GeoCodeReplyEsri()
@@ -87,49 +94,55 @@ void GeoCodeReplyEsri::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-
-    if (document.isObject()) {
-        QJsonObject object = document.object();
-
-        switch (operationType()) {
-        case Geocode:
-        {
-            QJsonArray candidates = object.value(QStringLiteral("candidates")).toArray();
-
-            QList<QGeoLocation> locations;
-
-            for (int i = 0; i < candidates.count(); i++) {
-                if (!candidates.at(i).isObject())
-                    continue;
+    // Parsed on a worker thread, the reply finishes once the locations are built
+    const QByteArray data = reply->readAll();
+    const OperationType type = operationType();
+    qParseReplyAsync(this, [data, type](const QGeoParseCancellation &) {
+        return parseLocations(data, type);
+    }, [this](const ParsedLocations &parsed) {
+        if (!parsed.ok) {
+            setError(QGeoCodeReply::CommunicationError, QStringLiteral("Unknown document"));
+            return;
+        }
+        setLocations(parsed.locations);
+        setFinished(true);
+    });
+}
 
-                QJsonObject candidate = candidates.at(i).toObject();
+GeoCodeReplyEsri::ParsedLocations GeoCodeReplyEsri::parseLocations(const QByteArray &data,
+                                                                   OperationType operationType)
+{
+    ParsedLocations parsed;
+    const QJsonDocument document = QJsonDocument::fromJson(data);
+    if (!document.isObject())
+        return parsed;
 
-                QGeoLocation location = parseCandidate(candidate);
-                locations.append(location);
-            }
+    QJsonObject object = document.object();
 
-            setLocations(locations);
-            setFinished(true);
-        }
-            break;
+    switch (operationType) {
+    case Geocode:
+    {
+        QJsonArray candidates = object.value(QStringLiteral("candidates")).toArray();
 
-        case ReverseGeocode:
-        {
-            QGeoLocation location = parseAddress(object);
+        for (int i = 0; i < candidates.count(); i++) {
+            if (!candidates.at(i).isObject())
+                continue;
 
-            QList<QGeoLocation> locations;
-            locations.append(location);
+            QJsonObject candidate = candidates.at(i).toObject();
 
-            setLocations(locations);
-            setFinished(true);
-        }
-            break;
+            QGeoLocation location = parseCandidate(candidate);
+            parsed.locations.append(location);
         }
+    }
+        break;
 
-    } else {
-        setError(QGeoCodeReply::CommunicationError, QStringLiteral("Unknown document"));
+    case ReverseGeocode:
+        parsed.locations.append(parseAddress(object));
+        break;
     }
+
+    parsed.ok = true;
+    return parsed;
 }
 
 QGeoLocation GeoCodeReplyEsri::parseAddress(const QJsonObject& object)
@@ -60,16 +60,26 @@ public:
     GeoCodeReplyEsri(QNetworkReply *reply, OperationType operationType, QObject *parent = nullptr);
     ~GeoCodeReplyEsri();
 
+    void setNetworkReply(QNetworkReply *reply);
+
     inline OperationType operationType() const;
 
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
 
-    QGeoLocation parseAddress(const QJsonObject &object);
-    QGeoLocation parseCandidate(const QJsonObject &candidate);
-
 private:
+    struct ParsedLocations
+    {
+        bool ok = false;
+        QList<QGeoLocation> locations;
+    };
+
+    // Run on a worker thread, do not touch the reply
+    static ParsedLocations parseLocations(const QByteArray &data, OperationType operationType);
+    static QGeoLocation parseAddress(const QJsonObject &object);
+    static QGeoLocation parseCandidate(const QJsonObject &candidate);
+
     OperationType m_operationType;
 };
 
@@ -46,10 +46,12 @@
 #include <QLocale>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
+#include <QNetworkReply>
 #include <QGeoCoordinate>
 #include <QGeoAddress>
 #include <QGeoShape>
 #include <QGeoRectangle>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -89,6 +91,16 @@ GeoCodingManagerEngineEsri::GeoCodingManagerEngineEsri(const QVariantMap &parame
     else
         m_userAgent = QByteArrayLiteral("Qt Location based application");
 
+    QGeoRequestScheduler::instance()->configure(QUrl(kUrlGeocode).host(), parameters,
+                                                kPrefixEsri + QStringLiteral("geocoding."));
+
+    // pauses the host when it answers with 429 or 503
+    connect(m_networkManager, &QNetworkAccessManager::finished, this, [](QNetworkReply *reply) {
+        QGeoRequestScheduler::instance()->reportResponse(reply->url().host(),
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                reply->rawHeader("Retry-After"));
+    });
+
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 }
@@ -127,13 +139,13 @@ QGeoCodeReply *GeoCodingManagerEngineEsri::geocode(const QString &address, int l
     url.setQuery(query);
     request.setUrl(url);
 
-    QNetworkReply *reply = m_networkManager->get(request);
-    GeoCodeReplyEsri *geocodeReply = new GeoCodeReplyEsri(reply, GeoCodeReplyEsri::Geocode, this);
+    GeoCodeReplyEsri *geocodeReply = new GeoCodeReplyEsri(nullptr, GeoCodeReplyEsri::Geocode, this);
 
     connect(geocodeReply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(geocodeReply, SIGNAL(error(QGeoCodeReply::Error,QString)),
             this, SLOT(replyError(QGeoCodeReply::Error,QString)));
 
+    sendRequest(geocodeReply, request, QGeoRequestScheduler::InteractivePriority);
     return geocodeReply;
 }
 
@@ -157,17 +169,31 @@ QGeoCodeReply *GeoCodingManagerEngineEsri::reverseGeocode(const QGeoCoordinate &
     url.setQuery(query);
     request.setUrl(url);
 
-    QNetworkReply *reply = m_networkManager->get(request);
-    GeoCodeReplyEsri *geocodeReply = new GeoCodeReplyEsri(reply, GeoCodeReplyEsri::ReverseGeocode,
+    GeoCodeReplyEsri *geocodeReply = new GeoCodeReplyEsri(nullptr, GeoCodeReplyEsri::ReverseGeocode,
                                                           this);
 
     connect(geocodeReply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(geocodeReply, SIGNAL(error(QGeoCodeReply::Error,QString)),
             this, SLOT(replyError(QGeoCodeReply::Error,QString)));
 
+    sendRequest(geocodeReply, request, QGeoRequestScheduler::BackgroundPriority);
     return geocodeReply;
 }
 
+/*
+    Sends \a request for \a reply once the server can take it.
+*/
+void GeoCodingManagerEngineEsri::sendRequest(GeoCodeReplyEsri *reply, const QNetworkRequest &request,
+                                             QGeoRequestScheduler::Priority priority)
+{
+    QGeoRequestScheduler::instance()->schedule(request.url().host(), reply, [this, reply, request]() {
+        if (reply->isFinished())
+            return false;
+        reply->setNetworkReply(m_networkManager->get(request));
+        return true;
+    }, priority);
+}
+
 void GeoCodingManagerEngineEsri::replyFinished()
 {
     QGeoCodeReply *reply = qobject_cast<QGeoCodeReply *>(sender());
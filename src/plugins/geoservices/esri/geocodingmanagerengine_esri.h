@@ -43,10 +43,13 @@
 #include <QGeoServiceProvider>
 #include <QGeoCodingManagerEngine>
 #include <QGeoCodeReply>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 QT_BEGIN_NAMESPACE
 
 class QNetworkAccessManager;
+class QNetworkRequest;
+class GeoCodeReplyEsri;
 
 class GeoCodingManagerEngineEsri : public QGeoCodingManagerEngine
 {
@@ -68,6 +71,9 @@ private Q_SLOTS:
     void replyError(QGeoCodeReply::Error errorCode, const QString &errorString);
 
 private:
+    void sendRequest(GeoCodeReplyEsri *reply, const QNetworkRequest &request,
+                     QGeoRequestScheduler::Priority priority);
+
     QNetworkAccessManager *m_networkManager;
     QByteArray m_userAgent;
 };
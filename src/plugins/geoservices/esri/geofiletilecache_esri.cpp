@@ -0,0 +1,188 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "geofiletilecache_esri.h"
+
+#include <QtLocation/private/qgeotilespec_p.h>
+
+#include <QImage>
+#include <QtEndian>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const int kBundleDimension = 128; // tiles per row and column of a bundle
+const int kBundleTiles = kBundleDimension * kBundleDimension;
+const int kMaxOpenBundles = 64;
+
+// Version 1: .bundlx with a 16 byte header and 5 byte offsets into the .bundle, column major.
+// Each tile is preceded by its 4 byte size.
+const qint64 kIndexV1Header = 16;
+const qint64 kIndexV1Record = 5;
+
+// Version 2: .bundle with a 64 byte header and 8 byte records of offset (40 bits) and size (24 bits),
+// row major, followed by the tiles.
+const quint32 kBundleV2Version = 3;
+const qint64 kBundleV2Header = 64;
+const qint64 kBundleV2Record = 8;
+
+} // namespace
+
+bool GeoFileTileCacheEsri::Bundle::open(const QString &path)
+{
+    file.setFileName(path + QLatin1String(".bundle"));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    size = file.size();
+    data = size > 0 ? file.map(0, size) : nullptr;
+    if (!data)
+        return false;
+
+    indexFile.setFileName(path + QLatin1String(".bundlx"));
+    if (indexFile.open(QIODevice::ReadOnly)) {
+        if (indexFile.size() < kIndexV1Header + kIndexV1Record * kBundleTiles)
+            return false;
+        index = indexFile.map(0, indexFile.size());
+        version = 1;
+    } else {
+        if (size < kBundleV2Header + kBundleV2Record * kBundleTiles
+                || qFromLittleEndian<quint32>(data) != kBundleV2Version)
+            return false;
+        index = data + kBundleV2Header;
+        version = 2;
+    }
+    return index != nullptr;
+}
+
+QByteArray GeoFileTileCacheEsri::Bundle::tile(int row, int column) const
+{
+    row %= kBundleDimension;
+    column %= kBundleDimension;
+    qint64 offset;
+    qint64 length;
+    if (version == 1) {
+        const uchar *record = index + kIndexV1Header + kIndexV1Record * (column * kBundleDimension + row);
+        offset = qint64(qFromLittleEndian<quint32>(record)) | (qint64(record[4]) << 32);
+        if (offset < 0 || offset + 4 > size)
+            return QByteArray();
+        length = qFromLittleEndian<quint32>(data + offset);
+        offset += 4;
+    } else {
+        const quint64 record = qFromLittleEndian<quint64>(index + kBundleV2Record * (row * kBundleDimension + column));
+        offset = qint64(record & ((Q_UINT64_C(1) << 40) - 1));
+        length = qint64(record >> 40);
+    }
+    if (length <= 0 || offset + length > size)
+        return QByteArray();
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(data + offset), int(length));
+}
+
+GeoFileTileCacheEsri::GeoFileTileCacheEsri(const QString &offlineDirectory,
+                                           const QString &directory,
+                                           QObject *parent)
+:   QGeoFileTileCache(directory, parent), m_offlineData(false), m_bundles(kMaxOpenBundles)
+{
+    if (!offlineDirectory.isEmpty()) {
+        m_offlineDirectory = QDir(offlineDirectory);
+        if (m_offlineDirectory.exists())
+            m_offlineData = true;
+    }
+}
+
+GeoFileTileCacheEsri::~GeoFileTileCacheEsri()
+{
+}
+
+QSharedPointer<QGeoTileTexture> GeoFileTileCacheEsri::get(const QGeoTileSpec &spec)
+{
+    QSharedPointer<QGeoTileTexture> tt = getFromMemory(spec);
+    if (tt)
+        return tt;
+    if ((tt = getFromBundles(spec)))
+        return tt;
+    return getFromDisk(spec);
+}
+
+const GeoFileTileCacheEsri::Bundle *GeoFileTileCacheEsri::bundle(const QGeoTileSpec &spec)
+{
+    const QString path = QStringLiteral("%1/L%2/R%3C%4")
+            .arg(spec.mapId())
+            .arg(spec.zoom(), 2, 10, QLatin1Char('0'))
+            .arg(spec.y() / kBundleDimension * kBundleDimension, 4, 16, QLatin1Char('0'))
+            .arg(spec.x() / kBundleDimension * kBundleDimension, 4, 16, QLatin1Char('0'));
+
+    Bundle *b = m_bundles.object(path);
+    if (!b) {
+        b = new Bundle;
+        if (!b->open(m_offlineDirectory.filePath(path))) {
+            // remembered as missing, to not look for the files again with each tile
+            b->file.close();
+            b->indexFile.close();
+            b->data = nullptr;
+        }
+        m_bundles.insert(path, b);
+    }
+    return b->data ? b : nullptr;
+}
+
+QSharedPointer<QGeoTileTexture> GeoFileTileCacheEsri::getFromBundles(const QGeoTileSpec &spec)
+{
+    if (!m_offlineData || spec.x() < 0 || spec.y() < 0)
+        return QSharedPointer<QGeoTileTexture>();
+
+    const Bundle *b = bundle(spec);
+    if (!b)
+        return QSharedPointer<QGeoTileTexture>();
+    const QByteArray bytes = b->tile(spec.y(), spec.x());
+    if (bytes.isEmpty())
+        return QSharedPointer<QGeoTileTexture>();
+
+    QImage image;
+    if (!image.loadFromData(bytes)) {
+        handleError(spec, QLatin1String("Problem with tile image"));
+        return QSharedPointer<QGeoTileTexture>(0);
+    }
+
+    // Not added to the memory cache, the mapped bundle already is one
+    return addToTextureCache(spec, image);
+}
+
+QT_END_NAMESPACE
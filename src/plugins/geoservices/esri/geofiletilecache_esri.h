@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef GEOFILETILECACHEESRI_H
+#define GEOFILETILECACHEESRI_H
+
+#include <QtLocation/private/qgeofiletilecache_p.h>
+
+#include <QCache>
+#include <QDir>
+#include <QFile>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    File tile cache that also serves tiles out of ESRI compact cache bundles,
+    version 1 (.bundle with a .bundlx index) and version 2 (.bundle only). The
+    offline directory holds one subdirectory per map id, with the level folders
+    (L00, L01, ...) of the cache's _alllayers folder. Bundles are memory-mapped,
+    so that a tile costs one index lookup and no system call.
+*/
+class GeoFileTileCacheEsri : public QGeoFileTileCache
+{
+    Q_OBJECT
+
+public:
+    GeoFileTileCacheEsri(const QString &offlineDirectory = QString(),
+                         const QString &directory = QString(),
+                         QObject *parent = nullptr);
+    ~GeoFileTileCacheEsri();
+
+    QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+
+protected:
+    // The 128x128 tiles of one bundle file
+    struct Bundle
+    {
+        bool open(const QString &path);
+        QByteArray tile(int row, int column) const; // raw data, valid while the bundle is open
+
+        QFile file;
+        QFile indexFile; // version 1 only
+        const uchar *data = nullptr;
+        const uchar *index = nullptr;
+        qint64 size = 0;
+        int version = 0;
+    };
+
+    QSharedPointer<QGeoTileTexture> getFromBundles(const QGeoTileSpec &spec);
+    const Bundle *bundle(const QGeoTileSpec &spec);
+
+    QDir m_offlineDirectory;
+    bool m_offlineData;
+    QCache<QString, Bundle> m_bundles; // by path, including the ones that failed to open
+};
+
+QT_END_NAMESPACE
+
+#endif // GEOFILETILECACHEESRI_H
@@ -40,7 +40,11 @@
 #include "georoutereply_esri.h"
 #include "georoutejsonparser_esri.h"
 
+#include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
+#include <QtNumeric>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -50,10 +54,16 @@ GeoRouteReplyEsri::GeoRouteReplyEsri(QNetworkReply *reply, const QGeoRouteReques
                                      QObject *parent) :
     QGeoRouteReply(request, parent)
 {
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
+    if (reply)
+        setNetworkReply(reply);
+}
+
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void GeoRouteReplyEsri::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
     connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
             this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
@@ -73,19 +83,97 @@ void GeoRouteReplyEsri::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-    GeoRouteJsonParserEsri parser(document);
+    // Parsed on a worker thread, the reply finishes once the routes are built
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return GeoRouteJsonParserEsri(QJsonDocument::fromJson(data));
+    }, [this](const GeoRouteJsonParserEsri &parser) {
+        if (parser.isValid()) {
+            setRoutes(parser.routes());
+            setFinished(true);
+        } else {
+            setError(QGeoRouteReply::ParseError, parser.errorString());
+        }
+    });
+}
+
+void GeoRouteReplyEsri::networkReplyError(QNetworkReply::NetworkError error)
+{
+    Q_UNUSED(error);
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+    setError(QGeoRouteReply::CommunicationError, reply->errorString());
+}
+
+// JSON reference: https://developers.arcgis.com/rest/network/api-reference/origin-destination-cost-matrix-synchronous-service.htm
 
-    if (parser.isValid())
-    {
-        setRoutes(parser.routes());
-        setFinished(true);
-    } else {
-        setError(QGeoRouteReply::ParseError, parser.errorString());
+GeoRouteMatrixReplyEsri::GeoRouteMatrixReplyEsri(const QList<QGeoCoordinate> &origins,
+                                                 const QList<QGeoCoordinate> &destinations,
+                                                 const QGeoRouteRequest &request, QObject *parent) :
+    QGeoRouteMatrixReply(origins, destinations, request, parent)
+{
+}
+
+void GeoRouteMatrixReplyEsri::setNetworkReply(QNetworkReply *reply)
+{
+    connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
+    connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
+            this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
+    connect(this, &QGeoRouteReply::aborted, reply, &QNetworkReply::abort);
+    connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
+}
+
+GeoRouteMatrixReplyEsri::~GeoRouteMatrixReplyEsri()
+{
+}
+
+void GeoRouteMatrixReplyEsri::networkReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError)
+        return;
+
+    const QJsonObject object = QJsonDocument::fromJson(reply->readAll()).object();
+    if (object.value(QStringLiteral("error")).isObject()) {
+        setError(QGeoRouteReply::UnknownError, object.value(QStringLiteral("error")).toObject()
+                 .value(QStringLiteral("message")).toString());
+        return;
+    }
+    if (!object.value(QStringLiteral("odCostMatrix")).isObject()) {
+        setError(QGeoRouteReply::ParseError, QStringLiteral("No cost matrix found"));
+        return;
     }
+
+    // The costs of each origin to each destination, by object id from 1, in
+    // the order of costAttributeNames
+    const QJsonObject matrix = object.value(QStringLiteral("odCostMatrix")).toObject();
+    const QJsonArray attributes = matrix.value(QStringLiteral("costAttributeNames")).toArray();
+    const int travelTime = attributes.toVariantList().indexOf(QStringLiteral("TravelTime"));
+    const int kilometers = attributes.toVariantList().indexOf(QStringLiteral("Kilometers"));
+
+    const int originCount = origins().size();
+    const int destinationCount = destinations().size();
+    QVector<double> durations(originCount * destinationCount, qQNaN());
+    QVector<double> distances(originCount * destinationCount, qQNaN());
+    for (int i = 0; i < originCount; ++i) {
+        const QJsonObject row = matrix.value(QString::number(i + 1)).toObject();
+        for (int j = 0; j < destinationCount; ++j) {
+            const QJsonArray costs = row.value(QString::number(j + 1)).toArray();
+            const QJsonValue minutes = costs.at(travelTime);
+            if (travelTime >= 0 && minutes.isDouble())
+                durations[i * destinationCount + j] = minutes.toDouble() * 60;
+            const QJsonValue length = costs.at(kilometers);
+            if (kilometers >= 0 && length.isDouble())
+                distances[i * destinationCount + j] = length.toDouble() * 1000;
+        }
+    }
+    setBlock(0, 0, originCount, durations, distances);
+    setFinished(true);
 }
 
-void GeoRouteReplyEsri::networkReplyError(QNetworkReply::NetworkError error)
+void GeoRouteMatrixReplyEsri::networkReplyError(QNetworkReply::NetworkError error)
 {
     Q_UNUSED(error);
     QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
@@ -42,6 +42,7 @@
 
 #include <QNetworkReply>
 #include <QGeoRouteReply>
+#include <QGeoRouteMatrixReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -53,6 +54,25 @@ public:
     GeoRouteReplyEsri(QNetworkReply *reply, const QGeoRouteRequest &request, QObject *parent = nullptr);
     ~GeoRouteReplyEsri();
 
+    void setNetworkReply(QNetworkReply *reply);
+
+private Q_SLOTS:
+    void networkReplyFinished();
+    void networkReplyError(QNetworkReply::NetworkError error);
+};
+
+class GeoRouteMatrixReplyEsri : public QGeoRouteMatrixReply
+{
+    Q_OBJECT
+
+public:
+    GeoRouteMatrixReplyEsri(const QList<QGeoCoordinate> &origins,
+                            const QList<QGeoCoordinate> &destinations,
+                            const QGeoRouteRequest &request, QObject *parent = nullptr);
+    ~GeoRouteMatrixReplyEsri();
+
+    void setNetworkReply(QNetworkReply *reply);
+
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
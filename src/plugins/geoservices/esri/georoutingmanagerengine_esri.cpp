@@ -41,6 +41,7 @@
 #include "georoutereply_esri.h"
 
 #include <QUrlQuery>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -49,6 +50,7 @@ static const QString kParamUserAgent(kPrefixEsri + QStringLiteral("useragent"));
 static const QString kParamToken(kPrefixEsri + QStringLiteral("token"));
 
 static const QString kUrlRouting(QStringLiteral("http://route.arcgis.com/arcgis/rest/services/World/Route/NAServer/Route_World/solve"));
+static const QString kUrlRouteMatrix(QStringLiteral("https://route.arcgis.com/arcgis/rest/services/World/OriginDestinationCostMatrix/NAServer/OriginDestinationCostMatrix_World/solveODCostMatrix"));
 
 GeoRoutingManagerEngineEsri::GeoRoutingManagerEngineEsri(const QVariantMap &parameters,
                                                          QGeoServiceProvider::Error *error,
@@ -62,6 +64,19 @@ GeoRoutingManagerEngineEsri::GeoRoutingManagerEngineEsri(const QVariantMap &para
 
     m_token = parameters.value(kParamToken).toString();
 
+    QGeoRequestScheduler::instance()->configure(QUrl(kUrlRouting).host(), parameters,
+                                                kPrefixEsri + QStringLiteral("routing."));
+
+    // pauses the host when it answers with 429 or 503
+    connect(m_networkManager, &QNetworkAccessManager::finished, this, [](QNetworkReply *reply) {
+        QGeoRequestScheduler::instance()->reportResponse(reply->url().host(),
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                reply->rawHeader("Retry-After"));
+    });
+
+    // the synchronous service takes up to 10 origins and 10 destinations
+    setRouteMatrixLimits(10, 10);
+
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 }
@@ -99,15 +114,68 @@ QGeoRouteReply *GeoRoutingManagerEngineEsri::calculateRoute(const QGeoRouteReque
     url.setQuery(query);
     networkRequest.setUrl(url);
 
-    QNetworkReply *reply = m_networkManager->get(networkRequest);
-    GeoRouteReplyEsri *routeReply = new GeoRouteReplyEsri(reply, request, this);
+    GeoRouteReplyEsri *routeReply = new GeoRouteReplyEsri(nullptr, request, this);
 
     connect(routeReply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(routeReply, SIGNAL(error(QGeoRouteReply::Error,QString)), this, SLOT(replyError(QGeoRouteReply::Error,QString)));
 
+    QGeoRequestScheduler::instance()->schedule(url.host(), routeReply, [this, routeReply, networkRequest]() {
+        if (routeReply->isFinished())
+            return false;
+        routeReply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    });
+
     return routeReply;
 }
 
+static QString coordinateList(const QList<QGeoCoordinate> &coordinates)
+{
+    QString list;
+    for (const QGeoCoordinate &coordinate : coordinates) {
+        if (!list.isEmpty())
+            list += QLatin1String("; ");
+
+        list += QString::number(coordinate.longitude()) + QLatin1Char(',') +
+                QString::number(coordinate.latitude());
+    }
+    return list;
+}
+
+QGeoRouteMatrixReply *GeoRoutingManagerEngineEsri::calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                                        const QList<QGeoCoordinate> &destinations,
+                                                                        const QGeoRouteRequest &request)
+{
+    QNetworkRequest networkRequest;
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
+
+    QUrl url(kUrlRouteMatrix);
+    QUrlQuery query;
+    query.addQueryItem(QStringLiteral("origins"), coordinateList(origins));
+    query.addQueryItem(QStringLiteral("destinations"), coordinateList(destinations));
+    query.addQueryItem(QStringLiteral("outputType"), QStringLiteral("esriNAODOutputNoLines"));
+    query.addQueryItem(QStringLiteral("returnODCostMatrix"), QStringLiteral("true"));
+    query.addQueryItem(QStringLiteral("f"), QStringLiteral("json"));
+    query.addQueryItem(QStringLiteral("token"), m_token);
+
+    url.setQuery(query);
+    networkRequest.setUrl(url);
+
+    GeoRouteMatrixReplyEsri *matrixReply = new GeoRouteMatrixReplyEsri(origins, destinations, request, this);
+
+    connect(matrixReply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    connect(matrixReply, SIGNAL(error(QGeoRouteReply::Error,QString)), this, SLOT(replyError(QGeoRouteReply::Error,QString)));
+
+    QGeoRequestScheduler::instance()->schedule(url.host(), matrixReply, [this, matrixReply, networkRequest]() {
+        if (matrixReply->isFinished())
+            return false;
+        matrixReply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    });
+
+    return matrixReply;
+}
+
 void GeoRoutingManagerEngineEsri::replyFinished()
 {
     QGeoRouteReply *reply = qobject_cast<QGeoRouteReply *>(sender());
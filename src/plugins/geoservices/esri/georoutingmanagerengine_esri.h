@@ -42,6 +42,7 @@
 
 #include <QGeoServiceProvider>
 #include <QGeoRoutingManagerEngine>
+#include <QGeoRouteMatrixReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -57,6 +58,9 @@ public:
     virtual ~GeoRoutingManagerEngineEsri();
 
     QGeoRouteReply *calculateRoute(const QGeoRouteRequest &request) override;
+    Q_INVOKABLE QGeoRouteMatrixReply *calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                           const QList<QGeoCoordinate> &destinations,
+                                                           const QGeoRouteRequest &request);
 
 private Q_SLOTS:
     void replyFinished();
@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "geotiledmappingmanagerengine_esri.h"
+#include "geofiletilecache_esri.h"
 #include "geotiledmap_esri.h"
 #include "geotilefetcher_esri.h"
 
@@ -61,6 +62,7 @@ static const QString kParamToken(kPrefixEsri + QStringLiteral("token"));
 static const QString kPrefixMapping(kPrefixEsri + QStringLiteral("mapping."));
 static const QString kParamMinimumZoomLevel(kPrefixMapping + QStringLiteral("minimumZoomLevel"));
 static const QString kParamMaximumZoomLevel(kPrefixMapping + QStringLiteral("maximumZoomLevel"));
+static const QString kParamMaxConcurrentRequests(kPrefixMapping + QStringLiteral("max_concurrent_requests"));
 
 static const QString kPropMapSources(QStringLiteral("mapSources"));
 static const QString kPropStyle(QStringLiteral("style"));
@@ -128,6 +130,9 @@ GeoTiledMappingManagerEngineEsri::GeoTiledMappingManagerEngineEsri(const QVarian
     if (parameters.contains(kParamToken))
         tileFetcher->setToken(parameters.value(kParamToken).toString());
 
+    if (parameters.contains(kParamMaxConcurrentRequests))
+        tileFetcher->setMaximumConcurrentRequests(parameters.value(kParamMaxConcurrentRequests).toInt());
+
     setTileFetcher(tileFetcher);
 
     /* TILE CACHE */
@@ -138,7 +143,10 @@ GeoTiledMappingManagerEngineEsri::GeoTiledMappingManagerEngineEsri(const QVarian
         // managerName() is not yet set, we have to hardcode the plugin name below
         cacheDirectory = QAbstractGeoTileCache::baseLocationCacheDirectory() + QLatin1String("esri");
     }
-    QGeoFileTileCache *tileCache = new QGeoFileTileCache(cacheDirectory);
+    QString offlineDirectory;
+    if (parameters.contains(QStringLiteral("esri.mapping.offline.directory")))
+        offlineDirectory = parameters.value(QStringLiteral("esri.mapping.offline.directory")).toString();
+    QGeoFileTileCache *tileCache = new GeoFileTileCacheEsri(offlineDirectory, cacheDirectory);
 
     /*
      * Disk cache setup -- defaults to ByteSize (old behavior)
@@ -206,6 +214,8 @@ GeoTiledMappingManagerEngineEsri::GeoTiledMappingManagerEngineEsri(const QVarian
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
 
     setTileCache(tileCache);
@@ -74,6 +74,14 @@ void GeoTiledMapReplyEsri::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
+    setValidators(QGeoTileValidators::fromHttpHeaders(reply->rawHeaderPairs()));
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        // answer to a conditional request, the cached tile is still valid
+        setNotModified(true);
+        setFinished(true);
+        return;
+    }
+
     QByteArray const& imageData = reply->readAll();
 
     bool validFormat = true;
@@ -69,6 +69,11 @@ QGeoTiledMapReply *GeoTileFetcherEsri::getTileImage(const QGeoTileSpec &spec)
     else
         request.setUrl(mapSource->url().arg(spec.zoom()).arg(spec.x()).arg(spec.y()));
 
+    const QGeoTileValidators validators = tileValidators(spec);
+    if (!validators.entityTag.isEmpty())
+        request.setRawHeader("If-None-Match", validators.entityTag);
+    if (!validators.lastModified.isEmpty())
+        request.setRawHeader("If-Modified-Since", validators.lastModified);
     QNetworkReply *reply = m_networkManager->get(request);
 
     return new GeoTiledMapReplyEsri(reply, spec);
@@ -46,6 +46,8 @@
 #include <QJsonArray>
 
 #include <QtCore/QUrlQuery>
+#include <QtLocation/private/qplacecategorycache_p.h>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -71,6 +73,16 @@ PlaceManagerEngineEsri::PlaceManagerEngineEsri(const QVariantMap &parameters, QG
     QPlaceManagerEngine(parameters),
     m_networkManager(new QNetworkAccessManager(this))
 {
+    QGeoRequestScheduler::instance()->configure(kUrlFindAddressCandidates.host(), parameters,
+                                                QStringLiteral("esri.places."));
+
+    // pauses the host when it answers with 429 or 503
+    connect(m_networkManager, &QNetworkAccessManager::finished, this, [](QNetworkReply *reply) {
+        QGeoRequestScheduler::instance()->reportResponse(reply->url().host(),
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                reply->rawHeader("Retry-After"));
+    });
+
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 }
@@ -145,12 +157,21 @@ QPlaceSearchReply *PlaceManagerEngineEsri::search(const QPlaceSearchRequest &req
 
     QNetworkRequest networkRequest(requestUrl);
     networkRequest.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    QNetworkReply *networkReply = m_networkManager->get(networkRequest);
 
-    PlaceSearchReplyEsri *reply = new PlaceSearchReplyEsri(request, networkReply, m_candidateFieldsLocale, m_countriesLocale, this);
+    PlaceSearchReplyEsri *reply = new PlaceSearchReplyEsri(request, nullptr, m_candidateFieldsLocale, m_countriesLocale, this);
     connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(reply, SIGNAL(error(QPlaceReply::Error,QString)), this, SLOT(replyError(QPlaceReply::Error,QString)));
 
+    // a search still waiting for the server is dropped for a newer one, as
+    // when searching while typing
+    const QString coalescingKey = QStringLiteral("esri.places.search/") + QString::number(quintptr(this), 16);
+    QGeoRequestScheduler::instance()->schedule(requestUrl.host(), reply, [this, reply, networkRequest]() {
+        if (reply->isFinished())
+            return false;
+        reply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    }, QGeoRequestScheduler::InteractivePriority, coalescingKey, [reply]() { reply->supersede(); });
+
     return reply;
 }
 
@@ -178,11 +199,10 @@ QPlaceReply *PlaceManagerEngineEsri::initializeCategories()
     connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(reply, SIGNAL(error(QPlaceReply::Error,QString)), this, SLOT(replyError(QPlaceReply::Error,QString)));
 
-    // TODO delayed finished() emission
     if (!m_categories.isEmpty())
-        reply->emitFinished();
-
-    m_pendingCategoriesReply.append(reply);
+        QMetaObject::invokeMethod(reply, [reply]() { reply->emitFinished(); }, Qt::QueuedConnection);
+    else
+        m_pendingCategoriesReply.append(reply);
     return reply;
 }
 
@@ -203,10 +223,18 @@ void PlaceManagerEngineEsri::parseCategories(const QJsonArray &jsonArray, const
         QPlaceCategory category;
         category.setCategoryId(key);
         category.setName(localeName.isEmpty() ? key : localeName); // localizedNames
-        m_categories.insert(key, category);
-        m_subcategories[parentCategoryId].append(key);
-        m_parentCategory.insert(key, parentCategoryId);
-        emit categoryAdded(category, parentCategoryId);
+
+        // The categories may have been read from the cache already
+        const auto known = m_categories.constFind(key);
+        if (known == m_categories.cend()) {
+            m_categories.insert(key, category);
+            m_subcategories[parentCategoryId].append(key);
+            m_parentCategory.insert(key, parentCategoryId);
+            emit categoryAdded(category, parentCategoryId);
+        } else if (known.value() != category) {
+            m_categories.insert(key, category);
+            emit categoryUpdated(category, parentCategoryId);
+        }
 
         if (jsonCategory.contains(kCategoriesKey))
         {
@@ -256,9 +284,20 @@ void PlaceManagerEngineEsri::errorCaterogies(const QString &error)
 
 void PlaceManagerEngineEsri::initializeGeocodeServer()
 {
-    // Only fetch categories once
+    // Only fetch categories once. Cached categories are used right away, the
+    // geocode server is still queried for the candidate fields and countries.
     if (m_categories.isEmpty() && !m_geocodeServerReply)
     {
+        QPlaceCategoryCache cache(QStringLiteral("esri"), m_locales);
+        if (cache.load()) {
+            m_categories = cache.categories();
+            m_subcategories = cache.subcategories();
+            for (auto it = m_subcategories.cbegin(); it != m_subcategories.cend(); ++it) {
+                for (const QString &id : it.value())
+                    m_parentCategory.insert(id, it.key());
+            }
+        }
+
         m_geocodeServerReply = m_networkManager->get(QNetworkRequest(kUrlGeocodeServer));
         connect(m_geocodeServerReply, SIGNAL(finished()), this, SLOT(geocodeServerReplyFinished()));
         connect(m_geocodeServerReply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)), this, SLOT(geocodeServerReplyError()));
@@ -337,6 +376,9 @@ void PlaceManagerEngineEsri::geocodeServerReplyFinished()
     {
         const QJsonArray jsonArray = jsonObject.value(kCategoriesKey).toArray();
         parseCategories(jsonArray, QString());
+
+        QPlaceCategoryCache cache(QStringLiteral("esri"), m_locales);
+        cache.save(m_categories, m_subcategories);
     }
 
     // parse candidateFields
@@ -49,6 +49,7 @@
 #include <QtLocation/QPlaceResult>
 #include <QtLocation/QPlaceSearchRequest>
 #include <QtLocation/private/qplacesearchrequest_p.h>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 static const QString kCandidatesKey(QStringLiteral("candidates"));
 static const QString kAttributesKey(QStringLiteral("attributes"));
@@ -80,18 +81,32 @@ PlaceSearchReplyEsri::PlaceSearchReplyEsri(const QPlaceSearchRequest &request, Q
     QPlaceSearchReply(parent), m_candidateFields(candidateFields), m_countries(countries)
 {
     Q_ASSERT(parent);
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
     setRequest(request);
+    if (reply)
+        setNetworkReply(reply);
+}
 
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void PlaceSearchReplyEsri::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)), this, SLOT(networkError(QNetworkReply::NetworkError)));
     connect(this, &QPlaceReply::aborted, reply, &QNetworkReply::abort);
     connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
 }
 
+/*
+    Finishes the reply with QPlaceReply::CancelError, for a search replaced by
+    a newer one of the engine before it was sent.
+*/
+void PlaceSearchReplyEsri::supersede()
+{
+    setError(QPlaceReply::CancelError, tr("Superseded by a newer search"));
+}
+
 PlaceSearchReplyEsri::~PlaceSearchReplyEsri()
 {
 }
@@ -112,33 +127,47 @@ void PlaceSearchReplyEsri::replyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
+    // Parsed on a worker thread, the reply finishes once the results are built
+    const QByteArray data = reply->readAll();
+    const QHash<QString, QString> candidateFields = m_candidateFields;
+    const QHash<QString, QString> countries = m_countries;
+    qParseReplyAsync(this, [data, candidateFields, countries](const QGeoParseCancellation &) {
+        return parseResults(data, candidateFields, countries);
+    }, [this](const ParsedResults &parsed) {
+        if (!parsed.ok) {
+            setError(ParseError, tr("Response parse error"));
+            return;
+        }
+        setResults(parsed.results);
+        setFinished(true);
+        emit finished();
+    });
+}
+
+PlaceSearchReplyEsri::ParsedResults PlaceSearchReplyEsri::parseResults(const QByteArray &data,
+                                                                       const QHash<QString, QString> &candidateFields,
+                                                                       const QHash<QString, QString> &countries)
+{
+    ParsedResults parsed;
+    QJsonDocument document = QJsonDocument::fromJson(data);
     if (!document.isObject())
-    {
-        setError(ParseError, tr("Response parse error"));
-        return;
-    }
+        return parsed;
 
     QJsonValue suggestions = document.object().value(kCandidatesKey);
     if (!suggestions.isArray())
-    {
-        setError(ParseError, tr("Response parse error"));
-        return;
-    }
+        return parsed;
 
     QJsonArray resultsArray = suggestions.toArray();
 
-    QList<QPlaceSearchResult> results;
     for (int i = 0; i < resultsArray.count(); ++i)
     {
         QJsonObject item = resultsArray.at(i).toObject();
-        QPlaceResult placeResult = parsePlaceResult(item);
-        results.append(placeResult);
+        QPlaceResult placeResult = parsePlaceResult(item, candidateFields, countries);
+        parsed.results.append(placeResult);
     }
 
-    setResults(results);
-    setFinished(true);
-    emit finished();
+    parsed.ok = true;
+    return parsed;
 }
 
 void PlaceSearchReplyEsri::networkError(QNetworkReply::NetworkError error)
@@ -149,7 +178,9 @@ void PlaceSearchReplyEsri::networkError(QNetworkReply::NetworkError error)
     setError(QPlaceReply::CommunicationError, reply->errorString());
 }
 
-QPlaceResult PlaceSearchReplyEsri::parsePlaceResult(const QJsonObject &item) const
+QPlaceResult PlaceSearchReplyEsri::parsePlaceResult(const QJsonObject &item,
+                                                   const QHash<QString, QString> &candidateFields,
+                                                   const QHash<QString, QString> &countries)
 {
     QPlace place;
     QHash<QString, QString> keys;
@@ -162,7 +193,7 @@ QPlaceResult PlaceSearchReplyEsri::parsePlaceResult(const QJsonObject &item) con
         if (!value.isEmpty())
         {
             QPlaceAttribute attribute;
-            attribute.setLabel(m_candidateFields.value(key, key)); // local name or key
+            attribute.setLabel(candidateFields.value(key, key)); // local name or key
             attribute.setText(value);
             place.setExtendedAttribute(key, attribute);
             keys.insert(key, value);
@@ -172,7 +203,7 @@ QPlaceResult PlaceSearchReplyEsri::parsePlaceResult(const QJsonObject &item) con
     if (keys.contains(kPhoneKey))
     {
         QPlaceContactDetail contactDetail;
-        contactDetail.setLabel(m_candidateFields.value(kPhoneKey, kPhoneKey)); // local name or key
+        contactDetail.setLabel(candidateFields.value(kPhoneKey, kPhoneKey)); // local name or key
         contactDetail.setValue(keys.value(kPhoneKey));
         place.appendContactDetail(QPlaceContactDetail::Phone, contactDetail);
     }
@@ -180,7 +211,7 @@ QPlaceResult PlaceSearchReplyEsri::parsePlaceResult(const QJsonObject &item) con
     // set address
     QGeoAddress geoAddress;
     geoAddress.setCity(keys.value(kCityKey));
-    geoAddress.setCountry(m_countries.value(keys.value(kCountryKey))); // mismatch code ISO2 vs ISO3
+    geoAddress.setCountry(countries.value(keys.value(kCountryKey))); // mismatch code ISO2 vs ISO3
     geoAddress.setCounty(keys.value(kRegionKey));
     geoAddress.setPostalCode(keys.value(kPostalKey));
     geoAddress.setStreet(keys.value(kStAddrKey));
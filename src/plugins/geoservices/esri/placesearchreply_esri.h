@@ -59,6 +59,9 @@ public:
                          const QHash<QString, QString> &countries, PlaceManagerEngineEsri *parent);
     ~PlaceSearchReplyEsri();
 
+    void setNetworkReply(QNetworkReply *reply);
+    void supersede();
+
     QString requestUrl;
 
 private slots:
@@ -67,7 +70,19 @@ private slots:
     void networkError(QNetworkReply::NetworkError error);
 
 private:
-    QPlaceResult parsePlaceResult(const QJsonObject &item) const;
+    struct ParsedResults
+    {
+        bool ok = false;
+        QList<QPlaceSearchResult> results;
+    };
+
+    // Run on a worker thread, do not touch the reply
+    static ParsedResults parseResults(const QByteArray &data,
+                                      const QHash<QString, QString> &candidateFields,
+                                      const QHash<QString, QString> &countries);
+    static QPlaceResult parsePlaceResult(const QJsonObject &item,
+                                         const QHash<QString, QString> &candidateFields,
+                                         const QHash<QString, QString> &countries);
 
     const QHash<QString, QString> &m_candidateFields;
     const QHash<QString, QString> &m_countries;
@@ -6,6 +6,7 @@ qtConfig(geoservices_here): SUBDIRS += nokia
 qtConfig(geoservices_mapbox): SUBDIRS += mapbox
 qtConfig(geoservices_esri): SUBDIRS += esri
 qtConfig(geoservices_itemsoverlay): SUBDIRS += itemsoverlay
+qtConfig(geoservices_localplaces): SUBDIRS += localplaces
 qtConfig(geoservices_osm): SUBDIRS += osm
 
 qtConfig(geoservices_mapboxgl) {
@@ -97,7 +97,8 @@ QGeoMap::Capabilities QGeoMapItemsOverlay::capabilities() const
 {
     return Capabilities(SupportsVisibleRegion
                         | SupportsSetBearing
-                        | SupportsAnchoringCoordinate);
+                        | SupportsAnchoringCoordinate
+                        | PrefersOpenGLMapItems);
 }
 
 bool QGeoMapItemsOverlay::createMapObjectImplementation(QGeoMapObject *obj)
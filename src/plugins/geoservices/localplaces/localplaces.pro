@@ -0,0 +1,31 @@
+TARGET = qtgeoservices_localplaces
+
+QT += location-private positioning-private
+
+QT_FOR_CONFIG += location-private
+qtConfig(location-labs-plugin): DEFINES += LOCATIONLABS
+
+HEADERS += \
+    qgeoserviceproviderpluginlocalplaces.h \
+    qlocalplacescommon.h \
+    qplacemanagerenginelocalplaces.h \
+    qplaceindexlocalplaces.h \
+    qplacereplieslocalplaces.h \
+    qgeocodingmanagerenginelocalplaces.h \
+    qgeocodeindexlocalplaces.h \
+    qgeocodereplylocalplaces.h
+
+SOURCES += \
+    qgeoserviceproviderpluginlocalplaces.cpp \
+    qlocalplacescommon.cpp \
+    qplacemanagerenginelocalplaces.cpp \
+    qplaceindexlocalplaces.cpp \
+    qgeocodingmanagerenginelocalplaces.cpp \
+    qgeocodeindexlocalplaces.cpp
+
+OTHER_FILES += \
+    localplaces_plugin.json
+
+PLUGIN_TYPE = geoservices
+PLUGIN_CLASS_NAME = QGeoServiceProviderFactoryLocalPlaces
+load(qt_plugin)
@@ -0,0 +1,597 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeocodeindexlocalplaces.h"
+#include "qlocalplacescommon.h"
+
+#include <QtPositioning/QGeoAddress>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const quint32 IndexMagic = 0x51474149; // "QGAI"
+const quint32 IndexVersion = 1;
+const int MaxRings = 1000;
+const double MetersPerDegree = 111195.0;
+
+enum Field {
+    Street,
+    HouseNumber,
+    District,
+    City,
+    PostalCode,
+    County,
+    State,
+    Country,
+    CountryCode,
+    FieldCount
+};
+
+// The index is stored in the byte order of the machine that wrote it; an
+// index of another byte order fails the magic check.
+struct Header
+{
+    quint32 magic;
+    quint32 version;
+    double cellSize;
+    quint32 addressCount;
+    quint32 addressOffset;
+    quint32 cellCount;
+    quint32 cellOffset;
+    quint32 tokenCount;
+    quint32 tokenOffset;
+    quint32 postingCount;
+    quint32 postingOffset;
+    quint32 stringsSize;
+    quint32 stringsOffset;
+};
+
+struct AddressRecord
+{
+    qint32 latitude; // in 1e-7 degrees
+    qint32 longitude;
+    quint32 fields[FieldCount]; // string offsets, 0 for none
+};
+
+// The addresses of a cell, which are consecutive.
+struct CellRecord
+{
+    qint32 row;
+    qint32 column;
+    quint32 first;
+    quint32 count;
+};
+
+// The postings of a token, ascending address indexes.
+struct TokenRecord
+{
+    quint32 text;
+    quint32 first;
+    quint32 count;
+};
+
+template <typename T>
+const T *section(const uchar *memory, quint32 offset)
+{
+    return reinterpret_cast<const T *>(memory + offset);
+}
+
+bool sectionFits(qint64 size, quint32 offset, quint32 count, size_t recordSize)
+{
+    return offset % sizeof(quint32) == 0 && offset <= size
+            && (size - offset) / qint64(recordSize) >= count;
+}
+
+int cellRow(double latitude, double cellSize)
+{
+    return qBound(0, qFloor((latitude + 90.0) / cellSize), qCeil(180.0 / cellSize) - 1);
+}
+
+int cellColumn(double longitude, double cellSize)
+{
+    const int columns = qCeil(360.0 / cellSize);
+    return ((qFloor((longitude + 180.0) / cellSize) % columns) + columns) % columns;
+}
+
+void align(QByteArray *data)
+{
+    while (data->size() % sizeof(double))
+        data->append('\0');
+}
+
+template <typename T>
+quint32 appendSection(QByteArray *data, const QVector<T> &records)
+{
+    align(data);
+    const quint32 offset = quint32(data->size());
+    data->append(reinterpret_cast<const char *>(records.constData()),
+                 int(records.size() * sizeof(T)));
+    return offset;
+}
+
+} // namespace
+
+/*
+    Addresses are bucketed into cells of \a cellSize degrees of latitude and
+    longitude for reverse lookups.
+*/
+QGeoCodeIndexLocalPlaces::Builder::Builder(double cellSize)
+:   m_cellSize(cellSize > 0 ? cellSize : 0.01)
+{
+}
+
+/*
+    Adds the address at \a coordinate described by the OpenStreetMap style
+    \a tags. Features without a street, or a place for addresses that have
+    none, are skipped.
+*/
+void QGeoCodeIndexLocalPlaces::Builder::addAddress(const QGeoCoordinate &coordinate,
+                                                   const QVariantMap &tags)
+{
+    if (!coordinate.isValid())
+        return;
+
+    QString street = QLocalPlacesCommon::tagValue(tags, "addr:street", "street");
+    if (street.isEmpty())
+        street = QLocalPlacesCommon::tagValue(tags, "addr:place");
+    if (street.isEmpty())
+        return;
+
+    Address address;
+    address.coordinate = coordinate;
+    address.fields.reserve(FieldCount);
+    address.fields << street
+                   << QLocalPlacesCommon::tagValue(tags, "addr:housenumber", "housenumber")
+                   << QLocalPlacesCommon::tagValue(tags, "addr:suburb", "addr:district")
+                   << QLocalPlacesCommon::tagValue(tags, "addr:city", "city")
+                   << QLocalPlacesCommon::tagValue(tags, "addr:postcode", "postcode")
+                   << QLocalPlacesCommon::tagValue(tags, "addr:county", "county")
+                   << QLocalPlacesCommon::tagValue(tags, "addr:state", "state")
+                   << QLocalPlacesCommon::tagValue(tags, "addr:country", "country")
+                   << QLocalPlacesCommon::tagValue(tags, "addr:country_code", "country_code");
+    m_addresses.append(address);
+}
+
+int QGeoCodeIndexLocalPlaces::Builder::count() const
+{
+    return m_addresses.size();
+}
+
+/*
+    Returns the index of the added addresses, to be written to a file or
+    passed to setData().
+*/
+QByteArray QGeoCodeIndexLocalPlaces::Builder::data() const
+{
+    struct Entry
+    {
+        int row;
+        int column;
+        int address;
+    };
+    QVector<Entry> entries;
+    entries.reserve(m_addresses.size());
+    for (int i = 0; i < m_addresses.size(); ++i) {
+        const QGeoCoordinate &coordinate = m_addresses.at(i).coordinate;
+        entries.append({ cellRow(coordinate.latitude(), m_cellSize),
+                         cellColumn(coordinate.longitude(), m_cellSize), i });
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        if (a.row != b.row)
+            return a.row < b.row;
+        if (a.column != b.column)
+            return a.column < b.column;
+        return a.address < b.address;
+    });
+
+    QByteArray strings(1, '\0');
+    QHash<QByteArray, quint32> stringOffsets;
+    const auto intern = [&strings, &stringOffsets](const QByteArray &text) -> quint32 {
+        if (text.isEmpty())
+            return 0;
+        auto it = stringOffsets.constFind(text);
+        if (it != stringOffsets.cend())
+            return *it;
+        const quint32 offset = quint32(strings.size());
+        strings.append(text).append('\0');
+        stringOffsets.insert(text, offset);
+        return offset;
+    };
+
+    QVector<AddressRecord> addresses;
+    QVector<CellRecord> cells;
+    QMap<QByteArray, QVector<quint32>> tokenPostings; // sorted bytewise, as looked up
+    addresses.reserve(entries.size());
+    for (const Entry &entry : qAsConst(entries)) {
+        const quint32 index = quint32(addresses.size());
+        const Address &address = m_addresses.at(entry.address);
+
+        AddressRecord record;
+        record.latitude = qRound(address.coordinate.latitude() * 1e7);
+        record.longitude = qRound(address.coordinate.longitude() * 1e7);
+        for (int field = 0; field < FieldCount; ++field) {
+            const QString &value = address.fields.at(field);
+            record.fields[field] = intern(value.trimmed().toUtf8());
+            for (const QString &token : QLocalPlacesCommon::tokenize(value)) {
+                QVector<quint32> &postings = tokenPostings[token.toUtf8()];
+                if (postings.isEmpty() || postings.last() != index)
+                    postings.append(index);
+            }
+        }
+        addresses.append(record);
+
+        if (cells.isEmpty() || cells.last().row != entry.row || cells.last().column != entry.column)
+            cells.append({ entry.row, entry.column, index, 0 });
+        ++cells.last().count;
+    }
+
+    QVector<TokenRecord> tokens;
+    QVector<quint32> postings;
+    tokens.reserve(tokenPostings.size());
+    for (auto it = tokenPostings.cbegin(); it != tokenPostings.cend(); ++it) {
+        tokens.append({ intern(it.key()), quint32(postings.size()), quint32(it->size()) });
+        postings += *it;
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = IndexMagic;
+    header.version = IndexVersion;
+    header.cellSize = m_cellSize;
+    header.addressCount = quint32(addresses.size());
+    header.cellCount = quint32(cells.size());
+    header.tokenCount = quint32(tokens.size());
+    header.postingCount = quint32(postings.size());
+    header.stringsSize = quint32(strings.size());
+
+    QByteArray data(int(sizeof(Header)), '\0');
+    header.addressOffset = appendSection(&data, addresses);
+    header.cellOffset = appendSection(&data, cells);
+    header.tokenOffset = appendSection(&data, tokens);
+    header.postingOffset = appendSection(&data, postings);
+    align(&data);
+    header.stringsOffset = quint32(data.size());
+    data.append(strings);
+    std::memcpy(data.data(), &header, sizeof(header));
+    return data;
+}
+
+QGeoCodeIndexLocalPlaces::QGeoCodeIndexLocalPlaces()
+{
+}
+
+QGeoCodeIndexLocalPlaces::~QGeoCodeIndexLocalPlaces()
+{
+}
+
+/*
+    Maps the index file \a fileName into memory, reading it instead where
+    files cannot be mapped.
+*/
+bool QGeoCodeIndexLocalPlaces::open(const QString &fileName, QString *errorString)
+{
+    m_memory = nullptr;
+    m_data.clear();
+    m_file.close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        *errorString = QCoreApplication::translate("QGeoCodeIndexLocalPlaces", "Cannot open %1: %2")
+                .arg(fileName, m_file.errorString());
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    const uchar *memory = m_file.map(0, size);
+    if (!memory) {
+        m_data = m_file.readAll();
+        m_file.close();
+        memory = reinterpret_cast<const uchar *>(m_data.constData());
+    }
+    return setMemory(memory, size, errorString);
+}
+
+/*
+    Uses the index \a data, as made by Builder::data().
+*/
+bool QGeoCodeIndexLocalPlaces::setData(const QByteArray &data, QString *errorString)
+{
+    m_file.close();
+    m_data = data;
+    return setMemory(reinterpret_cast<const uchar *>(m_data.constData()), m_data.size(),
+                     errorString);
+}
+
+bool QGeoCodeIndexLocalPlaces::isValid() const
+{
+    return m_memory != nullptr;
+}
+
+int QGeoCodeIndexLocalPlaces::count() const
+{
+    return m_memory ? int(section<Header>(m_memory, 0)->addressCount) : 0;
+}
+
+QGeoLocation QGeoCodeIndexLocalPlaces::location(int index) const
+{
+    const Header *header = section<Header>(m_memory, 0);
+    const AddressRecord &record = section<AddressRecord>(m_memory, header->addressOffset)[index];
+
+    QGeoAddress address;
+    QString street = string(record.fields[Street]);
+    const QString houseNumber = string(record.fields[HouseNumber]);
+    if (!houseNumber.isEmpty())
+        street += QLatin1Char(' ') + houseNumber;
+    address.setStreet(street);
+    address.setDistrict(string(record.fields[District]));
+    address.setCity(string(record.fields[City]));
+    address.setPostalCode(string(record.fields[PostalCode]));
+    address.setCounty(string(record.fields[County]));
+    address.setState(string(record.fields[State]));
+    address.setCountry(string(record.fields[Country]));
+    address.setCountryCode(string(record.fields[CountryCode]));
+
+    QGeoLocation location;
+    location.setCoordinate(QGeoCoordinate(record.latitude / 1e7, record.longitude / 1e7));
+    location.setAddress(address);
+    return location;
+}
+
+/*
+    Returns the ascending indexes of the addresses that contain every one of
+    \a tokens and lie in \a bounds if it is valid.
+*/
+QVector<int> QGeoCodeIndexLocalPlaces::find(const QStringList &tokens,
+                                            const QGeoShape &bounds) const
+{
+    if (!m_memory || tokens.isEmpty())
+        return QVector<int>();
+
+    QVector<QVector<int>> matches;
+    for (const QString &token : tokens) {
+        matches.append(postings(token.toUtf8()));
+        if (matches.last().isEmpty())
+            return QVector<int>();
+    }
+
+    // intersect starting from the rarest token
+    std::sort(matches.begin(), matches.end(), [](const QVector<int> &a, const QVector<int> &b) {
+        return a.size() < b.size();
+    });
+    QVector<int> result = matches.first();
+    for (int i = 1; i < matches.size() && !result.isEmpty(); ++i) {
+        QVector<int> intersection;
+        std::set_intersection(result.cbegin(), result.cend(),
+                              matches.at(i).cbegin(), matches.at(i).cend(),
+                              std::back_inserter(intersection));
+        result.swap(intersection);
+    }
+
+    if (bounds.isValid()) {
+        const Header *header = section<Header>(m_memory, 0);
+        const AddressRecord *records = section<AddressRecord>(m_memory, header->addressOffset);
+        result.erase(std::remove_if(result.begin(), result.end(), [records, &bounds](int index) {
+            return !bounds.contains(QGeoCoordinate(records[index].latitude / 1e7,
+                                                   records[index].longitude / 1e7));
+        }), result.end());
+    }
+    return result;
+}
+
+/*
+    Returns the index of the address nearest to \a coordinate, no farther than
+    \a maxDistance meters and in \a bounds if it is valid, or -1 if there is
+    none.
+
+    The cells around the one of \a coordinate are searched in growing rings,
+    until no address of the next ring can be nearer than the one found.
+*/
+int QGeoCodeIndexLocalPlaces::nearest(const QGeoCoordinate &coordinate, double maxDistance,
+                                      const QGeoShape &bounds) const
+{
+    if (!m_memory || !coordinate.isValid())
+        return -1;
+
+    const Header *header = section<Header>(m_memory, 0);
+    const AddressRecord *records = section<AddressRecord>(m_memory, header->addressOffset);
+    const CellRecord *cells = section<CellRecord>(m_memory, header->cellOffset);
+    const double cellSize = header->cellSize;
+    const int rows = qCeil(180.0 / cellSize);
+    const int columns = qCeil(360.0 / cellSize);
+    const int row = cellRow(coordinate.latitude(), cellSize);
+    const int column = cellColumn(coordinate.longitude(), cellSize);
+    if (maxDistance <= 0)
+        maxDistance = std::numeric_limits<double>::max();
+
+    int best = -1;
+    double bestDistance = maxDistance;
+    const auto visit = [&](int visitedRow, int visitedColumn) {
+        if (visitedRow < 0 || visitedRow >= rows)
+            return;
+        const int c = cell(visitedRow, ((visitedColumn % columns) + columns) % columns);
+        if (c < 0)
+            return;
+        for (quint32 i = cells[c].first; i < cells[c].first + cells[c].count; ++i) {
+            const QGeoCoordinate candidate(records[i].latitude / 1e7, records[i].longitude / 1e7);
+            if (bounds.isValid() && !bounds.contains(candidate))
+                continue;
+            const double distance = coordinate.distanceTo(candidate);
+            if (distance <= bestDistance && (best < 0 || distance < bestDistance)) {
+                best = int(i);
+                bestDistance = distance;
+            }
+        }
+    };
+
+    for (int ring = 0; ring <= MaxRings; ++ring) {
+        // the addresses of this ring are at least ring - 1 cells away, in
+        // degrees of latitude or of longitude, which are shorter toward the poles
+        const double latitude = qMin(90.0, qAbs(coordinate.latitude()) + ring * cellSize);
+        const double minDistance = (ring - 1) * cellSize * MetersPerDegree
+                * qMax(0.001, qCos(qDegreesToRadians(latitude)));
+        if (minDistance > bestDistance)
+            break;
+
+        if (ring == 0) {
+            visit(row, column);
+            continue;
+        }
+        for (int i = -ring; i <= ring; ++i) {
+            visit(row - ring, column + i);
+            visit(row + ring, column + i);
+        }
+        for (int i = -ring + 1; i < ring; ++i) {
+            visit(row + i, column - ring);
+            visit(row + i, column + ring);
+        }
+        if (2 * ring + 1 >= columns && row - ring <= 0 && row + ring >= rows - 1)
+            break;
+    }
+    return best;
+}
+
+bool QGeoCodeIndexLocalPlaces::setMemory(const uchar *memory, qint64 size, QString *errorString)
+{
+    m_memory = nullptr;
+
+    const auto invalid = [errorString]() {
+        *errorString = QCoreApplication::translate("QGeoCodeIndexLocalPlaces",
+                                                   "The address index is invalid");
+        return false;
+    };
+
+    if (!memory || size < qint64(sizeof(Header)))
+        return invalid();
+    const Header *header = section<Header>(memory, 0);
+    if (header->magic != IndexMagic || header->version != IndexVersion || !(header->cellSize > 0))
+        return invalid();
+    if (!sectionFits(size, header->addressOffset, header->addressCount, sizeof(AddressRecord))
+            || !sectionFits(size, header->cellOffset, header->cellCount, sizeof(CellRecord))
+            || !sectionFits(size, header->tokenOffset, header->tokenCount, sizeof(TokenRecord))
+            || !sectionFits(size, header->postingOffset, header->postingCount, sizeof(quint32))
+            || !sectionFits(size, header->stringsOffset, header->stringsSize, 1)
+            || header->stringsSize == 0
+            || memory[header->stringsOffset + header->stringsSize - 1] != '\0') {
+        return invalid();
+    }
+
+    // check every reference once, so that lookups need not
+    const AddressRecord *records = section<AddressRecord>(memory, header->addressOffset);
+    for (quint32 i = 0; i < header->addressCount; ++i) {
+        for (quint32 field : records[i].fields) {
+            if (field >= header->stringsSize)
+                return invalid();
+        }
+    }
+    const CellRecord *cells = section<CellRecord>(memory, header->cellOffset);
+    for (quint32 i = 0; i < header->cellCount; ++i) {
+        if (cells[i].first > header->addressCount
+                || cells[i].count > header->addressCount - cells[i].first) {
+            return invalid();
+        }
+    }
+    const TokenRecord *tokens = section<TokenRecord>(memory, header->tokenOffset);
+    for (quint32 i = 0; i < header->tokenCount; ++i) {
+        if (tokens[i].text >= header->stringsSize || tokens[i].first > header->postingCount
+                || tokens[i].count > header->postingCount - tokens[i].first) {
+            return invalid();
+        }
+    }
+    const quint32 *postings = section<quint32>(memory, header->postingOffset);
+    for (quint32 i = 0; i < header->postingCount; ++i) {
+        if (postings[i] >= header->addressCount)
+            return invalid();
+    }
+
+    m_memory = memory;
+    return true;
+}
+
+QVector<int> QGeoCodeIndexLocalPlaces::postings(const QByteArray &token) const
+{
+    const Header *header = section<Header>(m_memory, 0);
+    const TokenRecord *tokens = section<TokenRecord>(m_memory, header->tokenOffset);
+    const quint32 *entries = section<quint32>(m_memory, header->postingOffset);
+    const char *strings = section<char>(m_memory, header->stringsOffset);
+
+    const TokenRecord *end = tokens + header->tokenCount;
+    const TokenRecord *it = std::lower_bound(tokens, end, token,
+                                             [strings](const TokenRecord &record,
+                                                       const QByteArray &text) {
+        return std::strcmp(strings + record.text, text.constData()) < 0;
+    });
+    if (it == end || token != strings + it->text)
+        return QVector<int>();
+    return QVector<int>(entries + it->first, entries + it->first + it->count);
+}
+
+int QGeoCodeIndexLocalPlaces::cell(int row, int column) const
+{
+    const Header *header = section<Header>(m_memory, 0);
+    const CellRecord *cells = section<CellRecord>(m_memory, header->cellOffset);
+    const CellRecord *end = cells + header->cellCount;
+    const CellRecord *it = std::lower_bound(cells, end, qMakePair(row, column),
+                                            [](const CellRecord &record,
+                                               const QPair<int, int> &key) {
+        return record.row < key.first || (record.row == key.first && record.column < key.second);
+    });
+    if (it == end || it->row != row || it->column != column)
+        return -1;
+    return int(it - cells);
+}
+
+QString QGeoCodeIndexLocalPlaces::string(quint32 offset) const
+{
+    if (offset == 0)
+        return QString();
+    const Header *header = section<Header>(m_memory, 0);
+    return QString::fromUtf8(section<char>(m_memory, header->stringsOffset) + offset);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOCODEINDEXLOCALPLACES_H
+#define QGEOCODEINDEXLOCALPLACES_H
+
+#include <QtPositioning/QGeoLocation>
+#include <QtPositioning/QGeoShape>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+// A compact address index laid out as plain arrays in one block of memory,
+// so that it can be used straight from a memory mapped file: addresses
+// sorted by grid cell, the cells, the sorted address tokens with their
+// postings, and the strings.
+class QGeoCodeIndexLocalPlaces
+{
+public:
+    class Builder
+    {
+    public:
+        explicit Builder(double cellSize = 0.01);
+
+        void addAddress(const QGeoCoordinate &coordinate, const QVariantMap &tags);
+        int count() const;
+
+        QByteArray data() const;
+
+    private:
+        struct Address
+        {
+            QGeoCoordinate coordinate;
+            QStringList fields;
+        };
+
+        double m_cellSize;
+        QVector<Address> m_addresses;
+    };
+
+    QGeoCodeIndexLocalPlaces();
+    ~QGeoCodeIndexLocalPlaces();
+
+    bool open(const QString &fileName, QString *errorString);
+    bool setData(const QByteArray &data, QString *errorString);
+    bool isValid() const;
+
+    int count() const;
+    QGeoLocation location(int index) const;
+
+    QVector<int> find(const QStringList &tokens, const QGeoShape &bounds) const;
+    int nearest(const QGeoCoordinate &coordinate, double maxDistance,
+                const QGeoShape &bounds) const;
+
+private:
+    bool setMemory(const uchar *data, qint64 size, QString *errorString);
+    QVector<int> postings(const QByteArray &token) const;
+    int cell(int row, int column) const;
+    QString string(quint32 offset) const;
+
+    QFile m_file;
+    QByteArray m_data;
+    const uchar *m_memory = nullptr;
+
+    Q_DISABLE_COPY(QGeoCodeIndexLocalPlaces)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOCODEINDEXLOCALPLACES_H
@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeocodingmanagerenginelocalplaces.h"
+#include "qgeocodereplylocalplaces.h"
+#include "qlocalplacescommon.h"
+
+#include <QtPositioning/QGeoAddress>
+#include <QtCore/QFileInfo>
+#include <QtCore/QPointer>
+#include <QtCore/QSaveFile>
+
+QT_BEGIN_NAMESPACE
+
+QGeoCodingManagerEngineLocalPlaces::QGeoCodingManagerEngineLocalPlaces(
+        const QVariantMap &parameters, QGeoServiceProvider::Error *error, QString *errorString)
+:   QGeoCodingManagerEngine(parameters)
+{
+    if (parameters.contains(QStringLiteral("localplaces.geocoding.max_distance"))) {
+        m_maxDistance = parameters.value(QStringLiteral("localplaces.geocoding.max_distance"))
+                .toDouble();
+    }
+
+    const QStringList files = QLocalPlacesCommon::dataFiles(
+            parameters.value(QStringLiteral("localplaces.geocoding.files"),
+                             parameters.value(QStringLiteral("localplaces.files"))));
+    const QString indexFile = QLocalPlacesCommon::dataFiles(
+            parameters.value(QStringLiteral("localplaces.geocoding.index"))).value(0);
+    if (files.isEmpty() && indexFile.isEmpty()) {
+        *error = QGeoServiceProvider::MissingRequiredParameterError;
+        *errorString = tr("The localplaces.files or localplaces.geocoding.index parameter is "
+                          "required");
+        return;
+    }
+
+    const double cellSize =
+            parameters.value(QStringLiteral("localplaces.geocoding.cell_size"), 0.01).toDouble();
+    if (!loadIndex(files, indexFile, cellSize, errorString)) {
+        *error = QGeoServiceProvider::ConnectionError;
+        return;
+    }
+
+    *error = QGeoServiceProvider::NoError;
+    errorString->clear();
+}
+
+QGeoCodingManagerEngineLocalPlaces::~QGeoCodingManagerEngineLocalPlaces()
+{
+}
+
+QGeoCodeReply *QGeoCodingManagerEngineLocalPlaces::geocode(const QGeoAddress &address,
+                                                           const QGeoShape &bounds)
+{
+    QStringList tokens;
+    for (const QString &field : { address.street(), address.district(), address.city(),
+                                  address.postalCode(), address.county(), address.state() }) {
+        tokens += QLocalPlacesCommon::tokenize(field);
+    }
+
+    // datasets of one country often leave it out, so it only restricts the
+    // results where the index knows it
+    for (const QString &field : { address.country(), address.countryCode() }) {
+        for (const QString &token : QLocalPlacesCommon::tokenize(field)) {
+            if (!m_index.find(QStringList(token), QGeoShape()).isEmpty())
+                tokens.append(token);
+        }
+    }
+
+    if (tokens.isEmpty() && !address.isTextGenerated())
+        tokens = QLocalPlacesCommon::tokenize(address.text());
+
+    return find(tokens, -1, 0, bounds);
+}
+
+QGeoCodeReply *QGeoCodingManagerEngineLocalPlaces::geocode(const QString &address, int limit,
+                                                           int offset, const QGeoShape &bounds)
+{
+    return find(QLocalPlacesCommon::tokenize(address), limit, offset, bounds);
+}
+
+QGeoCodeReply *QGeoCodingManagerEngineLocalPlaces::reverseGeocode(const QGeoCoordinate &coordinate,
+                                                                  const QGeoShape &bounds)
+{
+    QGeoCodeReplyLocalPlaces *reply = new QGeoCodeReplyLocalPlaces(this);
+
+    QList<QGeoLocation> locations;
+    const int index = m_index.nearest(coordinate, m_maxDistance, bounds);
+    if (index >= 0)
+        locations.append(m_index.location(index));
+    reply->setLocations(locations);
+    reply->setViewport(bounds);
+
+    reply->setFinished(true);
+    finishLater(reply);
+    return reply;
+}
+
+/*
+    Uses the address index \a indexFile if it is newer than the address
+    \a files, building it from them otherwise. The built index is written to
+    \a indexFile, and mapped from there, if it is given and can be written.
+*/
+bool QGeoCodingManagerEngineLocalPlaces::loadIndex(const QStringList &files,
+                                                   const QString &indexFile, double cellSize,
+                                                   QString *errorString)
+{
+    if (!indexFile.isEmpty()) {
+        const QFileInfo indexInfo(indexFile);
+        bool current = files.isEmpty() || indexInfo.exists();
+        for (const QString &fileName : files) {
+            if (QFileInfo(fileName).lastModified() > indexInfo.lastModified())
+                current = false;
+        }
+
+        if (current) {
+            QString openError;
+            if (m_index.open(indexFile, &openError))
+                return true;
+            if (files.isEmpty()) {
+                *errorString = openError;
+                return false;
+            }
+        }
+    }
+
+    QGeoCodeIndexLocalPlaces::Builder builder(cellSize);
+    for (const QString &fileName : files) {
+        const bool ok = QLocalPlacesCommon::readFeatures(fileName,
+                [&builder](const QString &, const QGeoCoordinate &coordinate,
+                           const QVariantMap &tags) {
+                    builder.addAddress(coordinate, tags);
+                }, errorString);
+        if (!ok)
+            return false;
+    }
+
+    const QByteArray data = builder.data();
+    if (!indexFile.isEmpty()) {
+        QSaveFile file(indexFile);
+        if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit()
+                && m_index.open(indexFile, errorString)) {
+            return true;
+        }
+    }
+    return m_index.setData(data, errorString);
+}
+
+QGeoCodeReply *QGeoCodingManagerEngineLocalPlaces::find(const QStringList &tokens, int limit,
+                                                        int offset, const QGeoShape &bounds)
+{
+    QGeoCodeReplyLocalPlaces *reply = new QGeoCodeReplyLocalPlaces(this);
+    reply->setLimit(limit);
+    reply->setOffset(offset);
+
+    const QVector<int> indexes = m_index.find(tokens, bounds);
+    const int first = qMax(0, offset);
+    const int last = limit < 0 ? indexes.size() : qMin(indexes.size(), first + limit);
+
+    QList<QGeoLocation> locations;
+    for (int i = first; i < last; ++i)
+        locations.append(m_index.location(indexes.at(i)));
+    reply->setLocations(locations);
+    reply->setViewport(bounds);
+
+    reply->setFinished(true);
+    finishLater(reply);
+    return reply;
+}
+
+/*
+    Emits the signals of the finished \a reply once the caller had the chance
+    to connect to them.
+*/
+void QGeoCodingManagerEngineLocalPlaces::finishLater(QGeoCodeReplyLocalPlaces *reply)
+{
+    QPointer<QGeoCodeReplyLocalPlaces> guard(reply);
+    QMetaObject::invokeMethod(this, [this, guard]() {
+        if (!guard)
+            return;
+        if (guard->error() != QGeoCodeReply::NoError) {
+            emit guard->error(guard->error(), guard->errorString());
+            emit error(guard, guard->error(), guard->errorString());
+        }
+        emit guard->finished();
+        emit finished(guard);
+    }, Qt::QueuedConnection);
+}
+
+QT_END_NAMESPACE
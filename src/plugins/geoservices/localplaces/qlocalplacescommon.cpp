@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qlocalplacescommon.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QUrl>
+#include <QtCore/QXmlStreamReader>
+
+#ifdef LOCATIONLABS
+#include <QtLocation/private/qgeojsonreader_p.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+bool readGeoJson(QIODevice *device, const QLocalPlacesCommon::FeatureHandler &handler,
+                 QString *errorString)
+{
+#ifdef LOCATIONLABS
+    QGeoJsonReader reader(device);
+    while (reader.readNext()) {
+        const QGeoJsonReader::Feature &feature = reader.feature();
+        if (feature.shapes.isEmpty())
+            continue;
+
+        QString id = feature.id.toString();
+        if (id.isEmpty())
+            id = feature.properties.value(QStringLiteral("id")).toString();
+        if (id.isEmpty())
+            id = QStringLiteral("feature/") + QString::number(reader.featuresRead());
+
+        handler(id, feature.shapes.first().center(), feature.properties);
+    }
+
+    if (reader.hasError()) {
+        *errorString = reader.errorString();
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(device);
+    Q_UNUSED(handler);
+    *errorString = QStringLiteral("GeoJSON files are not supported by this build");
+    return false;
+#endif
+}
+
+bool readOsm(QIODevice *device, const QLocalPlacesCommon::FeatureHandler &handler,
+             QString *errorString)
+{
+    QXmlStreamReader xml(device);
+    QString id;
+    QGeoCoordinate coordinate;
+    QVariantMap tags;
+    bool inNode = false;
+
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            const QXmlStreamAttributes attributes = xml.attributes();
+            if (xml.name() == QLatin1String("node")) {
+                id = QStringLiteral("node/") + attributes.value(QLatin1String("id"));
+                coordinate = QGeoCoordinate(attributes.value(QLatin1String("lat")).toDouble(),
+                                            attributes.value(QLatin1String("lon")).toDouble());
+                tags.clear();
+                inNode = true;
+            } else if (inNode && xml.name() == QLatin1String("tag")) {
+                tags.insert(attributes.value(QLatin1String("k")).toString(),
+                            attributes.value(QLatin1String("v")).toString());
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            if (inNode && xml.name() == QLatin1String("node")) {
+                handler(id, coordinate, tags);
+                inNode = false;
+            }
+        }
+    }
+
+    if (xml.hasError()) {
+        *errorString = xml.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/*
+    Returns the file names given by the parameter \a value, either a list or a
+    string separated by semicolons. File URLs are turned into local paths.
+*/
+QStringList QLocalPlacesCommon::dataFiles(const QVariant &value)
+{
+    QStringList files = value.type() == QVariant::String
+            ? value.toString().split(QLatin1Char(';'), Qt::SkipEmptyParts)
+            : value.toStringList();
+    for (QString &file : files) {
+        file = file.trimmed();
+        if (file.startsWith(QLatin1String("file:")))
+            file = QUrl(file).toLocalFile();
+    }
+    return files;
+}
+
+/*
+    Calls \a handler for each feature of the file \a fileName, with the
+    feature id, its coordinate and its OpenStreetMap style tags.
+
+    Files with the .osm or .xml extension are read as OpenStreetMap XML
+    extracts, of which only the nodes are features. Other files are read as
+    GeoJSON, placing features at the center of their geometry.
+*/
+bool QLocalPlacesCommon::readFeatures(const QString &fileName, const FeatureHandler &handler,
+                                      QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = QCoreApplication::translate("QLocalPlacesCommon", "Cannot open %1: %2")
+                .arg(fileName, file.errorString());
+        return false;
+    }
+
+    QString readError;
+    const bool osm = fileName.endsWith(QLatin1String(".osm"), Qt::CaseInsensitive)
+            || fileName.endsWith(QLatin1String(".xml"), Qt::CaseInsensitive);
+    if (!(osm ? readOsm(&file, handler, &readError) : readGeoJson(&file, handler, &readError))) {
+        *errorString = QCoreApplication::translate("QLocalPlacesCommon", "Cannot read %1: %2")
+                .arg(fileName, readError);
+        return false;
+    }
+    return true;
+}
+
+/*
+    Splits \a text into the case folded words by which places and addresses
+    are indexed.
+*/
+QStringList QLocalPlacesCommon::tokenize(const QString &text)
+{
+    QStringList tokens;
+    const QString folded = text.toCaseFolded();
+    int start = -1;
+    for (int i = 0; i <= folded.size(); ++i) {
+        const bool inWord = i < folded.size() && folded.at(i).isLetterOrNumber();
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            tokens.append(folded.mid(start, i - start));
+            start = -1;
+        }
+    }
+    return tokens;
+}
+
+/*
+    Returns the tag \a key of \a tags, or \a alternativeKey if there is no
+    such tag.
+*/
+QString QLocalPlacesCommon::tagValue(const QVariantMap &tags, const char *key,
+                                     const char *alternativeKey)
+{
+    QString value = tags.value(QLatin1String(key)).toString();
+    if (value.isEmpty() && alternativeKey)
+        value = tags.value(QLatin1String(alternativeKey)).toString();
+    return value;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,374 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplaceindexlocalplaces.h"
+#include "qlocalplacescommon.h"
+
+#include <QtLocation/QPlaceAttribute>
+#include <QtLocation/QPlaceContactDetail>
+#include <QtPositioning/QGeoAddress>
+#include <QtPositioning/QGeoRectangle>
+#include <QtCore/QSet>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+#include <numeric>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// The OpenStreetMap keys whose values are taken as place categories
+const char *const categoryKeys[] = {
+    "amenity", "shop", "tourism", "leisure", "historic", "office", "craft", "healthcare"
+};
+
+QString categoryName(const QString &categoryId)
+{
+    QString name = categoryId;
+    name.replace(QLatin1Char('_'), QLatin1Char(' '));
+    if (!name.isEmpty())
+        name[0] = name.at(0).toUpper();
+    return name;
+}
+
+QVector<int> sortedUnique(QVector<int> indexes)
+{
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    return indexes;
+}
+
+} // namespace
+
+/*
+    Places are bucketed into cells of \a cellSize degrees of latitude and
+    longitude for spatial lookups.
+*/
+QPlaceIndexLocalPlaces::QPlaceIndexLocalPlaces(double cellSize)
+:   m_cellSize(cellSize > 0 ? cellSize : 0.05)
+{
+}
+
+/*
+    Adds the places of the file \a fileName, read as described by
+    QLocalPlacesCommon::readFeatures(). Features are taken as places when they
+    have a name.
+*/
+bool QPlaceIndexLocalPlaces::load(const QString &fileName, QString *errorString)
+{
+    const bool ok = QLocalPlacesCommon::readFeatures(fileName,
+            [this](const QString &placeId, const QGeoCoordinate &coordinate,
+                   const QVariantMap &tags) {
+                addPlace(placeId, coordinate, tags);
+            }, errorString);
+    finish();
+    return ok;
+}
+
+/*
+    Adds a place for the feature \a placeId at \a coordinate, described by the
+    OpenStreetMap style \a tags. Features without a name are skipped.
+*/
+void QPlaceIndexLocalPlaces::addPlace(const QString &placeId, const QGeoCoordinate &coordinate,
+                                      const QVariantMap &tags)
+{
+    const QString name = QLocalPlacesCommon::tagValue(tags, "name");
+    if (name.isEmpty() || !coordinate.isValid() || m_placeIds.contains(placeId))
+        return;
+
+    const int index = m_places.size();
+
+    QPlace place;
+    place.setPlaceId(placeId);
+    place.setName(name);
+
+    QGeoAddress address;
+    QString street = QLocalPlacesCommon::tagValue(tags, "addr:street", "street");
+    const QString houseNumber = QLocalPlacesCommon::tagValue(tags, "addr:housenumber",
+                                                             "housenumber");
+    if (!houseNumber.isEmpty())
+        street += QLatin1Char(' ') + houseNumber;
+    address.setStreet(street.trimmed());
+    address.setCity(QLocalPlacesCommon::tagValue(tags, "addr:city", "city"));
+    address.setPostalCode(QLocalPlacesCommon::tagValue(tags, "addr:postcode", "postcode"));
+    address.setState(QLocalPlacesCommon::tagValue(tags, "addr:state", "state"));
+    address.setCountry(QLocalPlacesCommon::tagValue(tags, "addr:country", "country"));
+
+    QGeoLocation location;
+    location.setCoordinate(coordinate);
+    location.setAddress(address);
+    place.setLocation(location);
+
+    QStringList categoryIds;
+    const QVariant category = tags.value(QStringLiteral("category"), tags.value(QStringLiteral("categories")));
+    if (category.type() == QVariant::String)
+        categoryIds = category.toString().split(QLatin1Char(','), Qt::SkipEmptyParts);
+    else
+        categoryIds = category.toStringList();
+    for (const char *key : categoryKeys) {
+        const QString value = QLocalPlacesCommon::tagValue(tags, key);
+        if (value.isEmpty())
+            continue;
+        // shop=yes and the like only tell the kind of place
+        categoryIds.append(value == QLatin1String("yes") ? QString::fromLatin1(key) : value);
+    }
+
+    QList<QPlaceCategory> categories;
+    for (QString categoryId : qAsConst(categoryIds)) {
+        categoryId = categoryId.trimmed();
+        if (categoryId.isEmpty())
+            continue;
+        QPlaceCategory &placeCategory = m_categories[categoryId];
+        if (placeCategory.categoryId().isEmpty()) {
+            placeCategory.setCategoryId(categoryId);
+            placeCategory.setName(categoryName(categoryId));
+        }
+        QVector<int> &categoryPlaces = m_categoryPlaces[categoryId];
+        if (!categoryPlaces.isEmpty() && categoryPlaces.last() == index)
+            continue;
+        categoryPlaces.append(index);
+        categories.append(placeCategory);
+    }
+    place.setCategories(categories);
+
+    const struct {
+        const char *key;
+        const QString &type;
+    } contactKeys[] = {
+        { "phone", QPlaceContactDetail::Phone },
+        { "email", QPlaceContactDetail::Email },
+        { "website", QPlaceContactDetail::Website }
+    };
+    for (const auto &contactKey : contactKeys) {
+        const QString value = QLocalPlacesCommon::tagValue(tags, contactKey.key,
+                QByteArray("contact:").append(contactKey.key).constData());
+        if (value.isEmpty())
+            continue;
+        QPlaceContactDetail detail;
+        detail.setValue(value);
+        place.appendContactDetail(contactKey.type, detail);
+    }
+
+    const QString openingHours = QLocalPlacesCommon::tagValue(tags, "opening_hours");
+    if (!openingHours.isEmpty()) {
+        QPlaceAttribute attribute;
+        attribute.setLabel(QStringLiteral("Opening hours"));
+        attribute.setText(openingHours);
+        place.setExtendedAttribute(QPlaceAttribute::OpeningHours, attribute);
+    }
+
+    place.setDetailsFetched(true);
+    m_places.append(place);
+    m_placeIds.insert(placeId, index);
+
+    for (const QString &token : QLocalPlacesCommon::tokenize(name))
+        addToken(token, index);
+
+    const int row = qFloor((coordinate.latitude() + 90.0) / m_cellSize);
+    const int column = qFloor((coordinate.longitude() + 180.0) / m_cellSize) % qCeil(360.0 / m_cellSize);
+    m_cells[cellKey(row, column)].append(index);
+}
+
+int QPlaceIndexLocalPlaces::count() const
+{
+    return m_places.size();
+}
+
+const QPlace &QPlaceIndexLocalPlaces::place(int index) const
+{
+    return m_places.at(index);
+}
+
+/*
+    Returns the index of the place \a placeId, or -1 if there is none.
+*/
+int QPlaceIndexLocalPlaces::indexOf(const QString &placeId) const
+{
+    return m_placeIds.value(placeId, -1);
+}
+
+QHash<QString, QPlaceCategory> QPlaceIndexLocalPlaces::categories() const
+{
+    return m_categories;
+}
+
+/*
+    Returns the ascending indexes of the places whose name contains every word
+    of \a searchTerm, the last one possibly as a prefix, having one of
+    \a categoryIds and lying in \a area. Empty or invalid arguments do not
+    restrict the places.
+*/
+QVector<int> QPlaceIndexLocalPlaces::find(const QString &searchTerm, const QStringList &categoryIds,
+                                          const QGeoShape &area) const
+{
+    const QStringList tokens = QLocalPlacesCommon::tokenize(searchTerm);
+    const QSet<QString> categorySet(categoryIds.cbegin(), categoryIds.cend());
+
+    // start from the most selective index available
+    QVector<int> candidates;
+    bool categoriesMatched = false;
+    if (!tokens.isEmpty()) {
+        candidates = textMatches(tokens);
+    } else if (!categorySet.isEmpty()) {
+        candidates = categoryMatches(categoryIds);
+        categoriesMatched = true;
+    } else if (area.isValid()) {
+        candidates = spatialMatches(area);
+    } else {
+        candidates.resize(m_places.size());
+        std::iota(candidates.begin(), candidates.end(), 0);
+    }
+
+    QVector<int> result;
+    for (int index : qAsConst(candidates)) {
+        const QPlace &place = m_places.at(index);
+        if (area.isValid() && !area.contains(place.location().coordinate()))
+            continue;
+        if (!categorySet.isEmpty() && !categoriesMatched) {
+            const QList<QPlaceCategory> categories = place.categories();
+            const bool hasCategory = std::any_of(categories.cbegin(), categories.cend(),
+                                                 [&categorySet](const QPlaceCategory &category) {
+                return categorySet.contains(category.categoryId());
+            });
+            if (!hasCategory)
+                continue;
+        }
+        result.append(index);
+    }
+    return result;
+}
+
+quint64 QPlaceIndexLocalPlaces::cellKey(int row, int column)
+{
+    return (quint64(quint32(row)) << 32) | quint32(column);
+}
+
+QVector<int> QPlaceIndexLocalPlaces::textMatches(const QStringList &tokens) const
+{
+    QVector<QVector<int>> matches;
+    for (int i = 0; i < tokens.size() - 1; ++i) {
+        const auto postings = m_postings.constFind(tokens.at(i));
+        if (postings == m_postings.cend())
+            return QVector<int>();
+        matches.append(*postings);
+    }
+
+    // the last word may still be typed
+    const QString &prefix = tokens.last();
+    QVector<int> prefixMatches;
+    for (auto token = std::lower_bound(m_tokens.cbegin(), m_tokens.cend(), prefix);
+         token != m_tokens.cend() && token->startsWith(prefix); ++token) {
+        prefixMatches += m_postings.value(*token);
+    }
+    if (prefixMatches.isEmpty())
+        return QVector<int>();
+    matches.append(sortedUnique(prefixMatches));
+
+    std::sort(matches.begin(), matches.end(), [](const QVector<int> &a, const QVector<int> &b) {
+        return a.size() < b.size();
+    });
+    QVector<int> result = matches.first();
+    for (int i = 1; i < matches.size() && !result.isEmpty(); ++i) {
+        QVector<int> intersection;
+        std::set_intersection(result.cbegin(), result.cend(),
+                              matches.at(i).cbegin(), matches.at(i).cend(),
+                              std::back_inserter(intersection));
+        result.swap(intersection);
+    }
+    return result;
+}
+
+QVector<int> QPlaceIndexLocalPlaces::spatialMatches(const QGeoShape &area) const
+{
+    const QGeoRectangle bounds = area.boundingGeoRectangle();
+    const int columns = qCeil(360.0 / m_cellSize);
+    const int bottom = qFloor((bounds.bottomRight().latitude() + 90.0) / m_cellSize);
+    const int top = qFloor((bounds.topLeft().latitude() + 90.0) / m_cellSize);
+    const int west = qFloor((bounds.topLeft().longitude() + 180.0) / m_cellSize);
+    int east = qFloor((bounds.bottomRight().longitude() + 180.0) / m_cellSize);
+    if (east < west) // crossing the antimeridian
+        east += columns;
+
+    QVector<int> result;
+    const qint64 cellCount = qint64(top - bottom + 1) * (east - west + 1);
+    if (cellCount > m_cells.size()) {
+        // fewer cells hold places than the area covers
+        for (auto cell = m_cells.cbegin(), end = m_cells.cend(); cell != end; ++cell) {
+            const int row = int(quint32(cell.key() >> 32));
+            const int column = int(quint32(cell.key()));
+            if (row < bottom || row > top)
+                continue;
+            if ((column >= west && column <= east) || (column + columns >= west && column + columns <= east))
+                result += cell.value();
+        }
+    } else {
+        for (int row = bottom; row <= top; ++row) {
+            for (int column = west; column <= east; ++column)
+                result += m_cells.value(cellKey(row, column % columns));
+        }
+    }
+    return sortedUnique(result);
+}
+
+QVector<int> QPlaceIndexLocalPlaces::categoryMatches(const QStringList &categoryIds) const
+{
+    QVector<int> result;
+    for (const QString &categoryId : categoryIds)
+        result += m_categoryPlaces.value(categoryId);
+    return sortedUnique(result);
+}
+
+void QPlaceIndexLocalPlaces::addToken(const QString &token, int index)
+{
+    QVector<int> &postings = m_postings[token];
+    if (postings.isEmpty() || postings.last() != index)
+        postings.append(index);
+}
+
+/*
+    Updates the sorted list of tokens once places were added.
+*/
+void QPlaceIndexLocalPlaces::finish()
+{
+    m_tokens = m_postings.keys().toVector();
+    std::sort(m_tokens.begin(), m_tokens.end());
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QPLACEINDEXLOCALPLACES_H
+#define QPLACEINDEXLOCALPLACES_H
+
+#include <QtLocation/QPlace>
+#include <QtLocation/QPlaceCategory>
+#include <QtPositioning/QGeoShape>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QPlaceIndexLocalPlaces
+{
+public:
+    explicit QPlaceIndexLocalPlaces(double cellSize = 0.05);
+
+    bool load(const QString &fileName, QString *errorString);
+
+    void addPlace(const QString &placeId, const QGeoCoordinate &coordinate,
+                  const QVariantMap &tags);
+
+    int count() const;
+    const QPlace &place(int index) const;
+    int indexOf(const QString &placeId) const;
+
+    QHash<QString, QPlaceCategory> categories() const;
+
+    QVector<int> find(const QString &searchTerm, const QStringList &categoryIds,
+                      const QGeoShape &area) const;
+
+private:
+    static quint64 cellKey(int row, int column);
+
+    QVector<int> textMatches(const QStringList &tokens) const;
+    QVector<int> spatialMatches(const QGeoShape &area) const;
+    QVector<int> categoryMatches(const QStringList &categoryIds) const;
+
+    void addToken(const QString &token, int index);
+    void finish();
+
+    double m_cellSize;
+    QVector<QPlace> m_places;
+    QHash<QString, int> m_placeIds;
+
+    QHash<QString, QVector<int>> m_postings; // place indexes by name token, ascending
+    QVector<QString> m_tokens; // sorted keys of m_postings, for prefix lookups
+    QHash<quint64, QVector<int>> m_cells; // place indexes by grid cell, ascending
+    QHash<QString, QVector<int>> m_categoryPlaces;
+    QHash<QString, QPlaceCategory> m_categories;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPLACEINDEXLOCALPLACES_H
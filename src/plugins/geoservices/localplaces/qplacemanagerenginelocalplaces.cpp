@@ -0,0 +1,277 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplacemanagerenginelocalplaces.h"
+#include "qlocalplacescommon.h"
+#include "qplacereplieslocalplaces.h"
+
+#include <QtLocation/QPlaceSearchRequest>
+#include <QtLocation/QPlaceResult>
+#include <QtLocation/private/qplacesearchrequest_p.h>
+#include <QtPositioning/QGeoCircle>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+QPlaceManagerEngineLocalPlaces::QPlaceManagerEngineLocalPlaces(const QVariantMap &parameters,
+                                                               QGeoServiceProvider::Error *error,
+                                                               QString *errorString)
+:   QPlaceManagerEngine(parameters),
+    m_index(parameters.value(QStringLiteral("localplaces.grid.cell_size"), 0.05).toDouble())
+{
+    if (parameters.contains(QStringLiteral("localplaces.page_size")))
+        m_pageSize = qMax(1, parameters.value(QStringLiteral("localplaces.page_size")).toInt());
+
+    const QStringList files =
+            QLocalPlacesCommon::dataFiles(parameters.value(QStringLiteral("localplaces.files")));
+    if (files.isEmpty()) {
+        *error = QGeoServiceProvider::MissingRequiredParameterError;
+        *errorString = tr("The localplaces.files parameter is required");
+        return;
+    }
+
+    for (const QString &fileName : files) {
+        QString loadError;
+        if (!m_index.load(fileName, &loadError)) {
+            *error = QGeoServiceProvider::ConnectionError;
+            *errorString = loadError;
+            return;
+        }
+    }
+
+    m_categories = m_index.categories();
+    m_categoryIds = m_categories.keys();
+    std::sort(m_categoryIds.begin(), m_categoryIds.end());
+
+    *error = QGeoServiceProvider::NoError;
+    errorString->clear();
+}
+
+QPlaceManagerEngineLocalPlaces::~QPlaceManagerEngineLocalPlaces()
+{
+}
+
+QPlaceDetailsReply *QPlaceManagerEngineLocalPlaces::getPlaceDetails(const QString &placeId)
+{
+    QPlaceDetailsReplyLocalPlaces *reply = new QPlaceDetailsReplyLocalPlaces(this);
+
+    const int index = m_index.indexOf(placeId);
+    if (index < 0)
+        reply->setError(QPlaceReply::PlaceDoesNotExistError, tr("Place does not exist"));
+    else
+        reply->setPlace(m_index.place(index));
+
+    reply->setFinished(true);
+    finishLater(reply);
+    return reply;
+}
+
+QPlaceSearchReply *QPlaceManagerEngineLocalPlaces::search(const QPlaceSearchRequest &request)
+{
+    QPlaceSearchReplyLocalPlaces *reply = new QPlaceSearchReplyLocalPlaces(this);
+    reply->setRequest(request);
+
+    if (!request.recommendationId().isEmpty()) {
+        reply->setError(QPlaceReply::UnsupportedError, tr("Recommendations are not supported"));
+        reply->setFinished(true);
+        finishLater(reply);
+        return reply;
+    }
+
+    QGeoCoordinate center;
+    QVector<int> indexes = find(request, &center);
+
+    // pages are counted by the request, as for the other plugins
+    const int limit = request.limit() > 0 ? request.limit() : m_pageSize;
+    const int page = qMax(0, QPlaceSearchRequestPrivate::get(request)->page);
+    const int offset = qMin(page * limit, indexes.size());
+    const int end = qMin(offset + limit, indexes.size());
+
+    // only the requested page has to be in order
+    QVector<QPair<qreal, int>> order;
+    order.reserve(indexes.size());
+    for (int index : qAsConst(indexes)) {
+        const QGeoCoordinate coordinate = m_index.place(index).location().coordinate();
+        order.append(qMakePair(center.isValid() ? center.distanceTo(coordinate) : 0.0, index));
+    }
+    std::partial_sort(order.begin(), order.begin() + end, order.end(),
+                      [this](const QPair<qreal, int> &a, const QPair<qreal, int> &b) {
+        if (a.first != b.first)
+            return a.first < b.first;
+        const int byName = m_index.place(a.second).name().compare(m_index.place(b.second).name(),
+                                                                  Qt::CaseInsensitive);
+        return byName != 0 ? byName < 0 : a.second < b.second;
+    });
+
+    QList<QPlaceSearchResult> results;
+    for (int i = offset; i < end; ++i) {
+        const QPlace &place = m_index.place(order.at(i).second);
+        QPlaceResult result;
+        result.setPlace(place);
+        result.setTitle(place.name());
+        if (center.isValid())
+            result.setDistance(order.at(i).first);
+        results.append(result);
+    }
+    reply->setResults(results);
+
+    if (page > 0) {
+        QPlaceSearchRequest previous = request;
+        QPlaceSearchRequestPrivate *previousPrivate = QPlaceSearchRequestPrivate::get(previous);
+        previousPrivate->related = true;
+        previousPrivate->page = page - 1;
+        reply->setPreviousPageRequest(previous);
+    }
+    if (end < indexes.size()) {
+        QPlaceSearchRequest next = request;
+        QPlaceSearchRequestPrivate *nextPrivate = QPlaceSearchRequestPrivate::get(next);
+        nextPrivate->related = true;
+        nextPrivate->page = page + 1;
+        reply->setNextPageRequest(next);
+    }
+
+    reply->setFinished(true);
+    finishLater(reply);
+    return reply;
+}
+
+QPlaceSearchSuggestionReply *QPlaceManagerEngineLocalPlaces::searchSuggestions(const QPlaceSearchRequest &request)
+{
+    QPlaceSearchSuggestionReplyLocalPlaces *reply = new QPlaceSearchSuggestionReplyLocalPlaces(this);
+
+    QGeoCoordinate center;
+    const QVector<int> indexes = find(request, &center);
+
+    QStringList names;
+    names.reserve(indexes.size());
+    for (int index : indexes)
+        names.append(m_index.place(index).name());
+    std::sort(names.begin(), names.end(), [](const QString &a, const QString &b) {
+        return a.compare(b, Qt::CaseInsensitive) < 0;
+    });
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    const int limit = request.limit() > 0 ? request.limit() : m_pageSize;
+    reply->setSuggestions(names.mid(0, limit));
+
+    reply->setFinished(true);
+    finishLater(reply);
+    return reply;
+}
+
+QPlaceReply *QPlaceManagerEngineLocalPlaces::initializeCategories()
+{
+    // the categories were collected with the places
+    QPlaceCategoriesReplyLocalPlaces *reply = new QPlaceCategoriesReplyLocalPlaces(this);
+    reply->setFinished(true);
+    finishLater(reply);
+    return reply;
+}
+
+QString QPlaceManagerEngineLocalPlaces::parentCategoryId(const QString &categoryId) const
+{
+    Q_UNUSED(categoryId);
+
+    // The categories are not nested.
+    return QString();
+}
+
+QStringList QPlaceManagerEngineLocalPlaces::childCategoryIds(const QString &categoryId) const
+{
+    return categoryId.isEmpty() ? m_categoryIds : QStringList();
+}
+
+QPlaceCategory QPlaceManagerEngineLocalPlaces::category(const QString &categoryId) const
+{
+    return m_categories.value(categoryId);
+}
+
+QList<QPlaceCategory> QPlaceManagerEngineLocalPlaces::childCategories(const QString &parentId) const
+{
+    QList<QPlaceCategory> categories;
+    for (const QString &categoryId : childCategoryIds(parentId))
+        categories.append(m_categories.value(categoryId));
+    return categories;
+}
+
+/*
+    Returns the places matching \a request. A circle without a radius only
+    orders the places by their distance from its center, which is returned
+    in \a center as for the other search areas.
+*/
+QVector<int> QPlaceManagerEngineLocalPlaces::find(const QPlaceSearchRequest &request,
+                                                 QGeoCoordinate *center) const
+{
+    QGeoShape area = request.searchArea();
+    if (area.type() == QGeoShape::CircleType && QGeoCircle(area).radius() < 0) {
+        *center = QGeoCircle(area).center();
+        area = QGeoShape();
+    } else if (area.isValid()) {
+        *center = area.center();
+    }
+
+    QStringList categoryIds;
+    const QList<QPlaceCategory> categories = request.categories();
+    for (const QPlaceCategory &category : categories)
+        categoryIds.append(category.categoryId());
+
+    return m_index.find(request.searchTerm(), categoryIds, area);
+}
+
+/*
+    Emits the signals of the finished \a reply from the event loop.
+*/
+void QPlaceManagerEngineLocalPlaces::finishLater(QPlaceReply *reply)
+{
+    if (reply->error() != QPlaceReply::NoError) {
+        QMetaObject::invokeMethod(reply, "error", Qt::QueuedConnection,
+                                  Q_ARG(QPlaceReply::Error, reply->error()),
+                                  Q_ARG(QString, reply->errorString()));
+        QMetaObject::invokeMethod(this, "error", Qt::QueuedConnection,
+                                  Q_ARG(QPlaceReply *, reply),
+                                  Q_ARG(QPlaceReply::Error, reply->error()),
+                                  Q_ARG(QString, reply->errorString()));
+    }
+    QMetaObject::invokeMethod(reply, "finished", Qt::QueuedConnection);
+    QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection,
+                              Q_ARG(QPlaceReply *, reply));
+}
+
+QT_END_NAMESPACE
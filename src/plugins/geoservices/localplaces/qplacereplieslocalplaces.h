@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QPLACEREPLIESLOCALPLACES_H
+#define QPLACEREPLIESLOCALPLACES_H
+
+#include <QtLocation/QPlaceDetailsReply>
+#include <QtLocation/QPlaceSearchReply>
+#include <QtLocation/QPlaceSearchSuggestionReply>
+
+QT_BEGIN_NAMESPACE
+
+// The replies are answered from the local index: the engine fills them in
+// and finishes them right away, emitting their signals once the caller had
+// the chance to connect to them.
+
+class QPlaceSearchReplyLocalPlaces : public QPlaceSearchReply
+{
+    Q_OBJECT
+
+public:
+    explicit QPlaceSearchReplyLocalPlaces(QObject *parent)
+    :   QPlaceSearchReply(parent)
+    {
+    }
+
+    using QPlaceSearchReply::setFinished;
+    using QPlaceSearchReply::setError;
+    using QPlaceSearchReply::setRequest;
+    using QPlaceSearchReply::setResults;
+    using QPlaceSearchReply::setPreviousPageRequest;
+    using QPlaceSearchReply::setNextPageRequest;
+};
+
+class QPlaceSearchSuggestionReplyLocalPlaces : public QPlaceSearchSuggestionReply
+{
+    Q_OBJECT
+
+public:
+    explicit QPlaceSearchSuggestionReplyLocalPlaces(QObject *parent)
+    :   QPlaceSearchSuggestionReply(parent)
+    {
+    }
+
+    using QPlaceSearchSuggestionReply::setFinished;
+    using QPlaceSearchSuggestionReply::setError;
+    using QPlaceSearchSuggestionReply::setSuggestions;
+};
+
+class QPlaceDetailsReplyLocalPlaces : public QPlaceDetailsReply
+{
+    Q_OBJECT
+
+public:
+    explicit QPlaceDetailsReplyLocalPlaces(QObject *parent)
+    :   QPlaceDetailsReply(parent)
+    {
+    }
+
+    using QPlaceDetailsReply::setFinished;
+    using QPlaceDetailsReply::setError;
+    using QPlaceDetailsReply::setPlace;
+};
+
+class QPlaceCategoriesReplyLocalPlaces : public QPlaceReply
+{
+    Q_OBJECT
+
+public:
+    explicit QPlaceCategoriesReplyLocalPlaces(QObject *parent)
+    :   QPlaceReply(parent)
+    {
+    }
+
+    using QPlaceReply::setFinished;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPLACEREPLIESLOCALPLACES_H
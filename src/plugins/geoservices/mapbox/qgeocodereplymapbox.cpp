@@ -47,18 +47,51 @@
 #include <QtPositioning/QGeoAddress>
 #include <QtPositioning/QGeoLocation>
 #include <QtPositioning/QGeoRectangle>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
+/*
+    Returns the locations of each feature collection of the response, which
+    is one collection, or an array of them for batches. Stops at the first
+    entry that is not a collection.
+*/
+static QList<QList<QGeoLocation>> parseFeatureCollections(const QByteArray &data)
+{
+    const QJsonDocument document = QJsonDocument::fromJson(data);
+    QJsonArray collections;
+    if (document.isArray())
+        collections = document.array();
+    else if (document.isObject())
+        collections.append(document.object());
+
+    QList<QList<QGeoLocation>> result;
+    for (const QJsonValue &collection : qAsConst(collections)) {
+        if (!collection.isObject())
+            break;
+        QList<QGeoLocation> locations;
+        const QJsonArray features = collection.toObject().value(QStringLiteral("features")).toArray();
+        for (const QJsonValue &value : features)
+            locations.append(QMapboxCommon::parseGeoLocation(value.toObject()));
+        result.append(locations);
+    }
+    return result;
+}
+
 QGeoCodeReplyMapbox::QGeoCodeReplyMapbox(QNetworkReply *reply, QObject *parent)
 :   QGeoCodeReply(parent)
 {
     Q_ASSERT(parent);
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
+    if (reply)
+        setNetworkReply(reply);
+}
 
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void QGeoCodeReplyMapbox::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, &QNetworkReply::finished, this, &QGeoCodeReplyMapbox::onNetworkReplyFinished);
     connect(reply, &QNetworkReply::errorOccurred, this, &QGeoCodeReplyMapbox::onNetworkReplyError);
 
@@ -78,20 +111,18 @@ void QGeoCodeReplyMapbox::onNetworkReplyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QList<QGeoLocation> locations;
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-    if (!document.isObject()) {
-        setError(ParseError, tr("Response parse error"));
-        return;
-    }
-
-    const QJsonArray features = document.object().value(QStringLiteral("features")).toArray();
-    for (const QJsonValue &value : features)
-        locations.append(QMapboxCommon::parseGeoLocation(value.toObject()));
-
-    setLocations(locations);
-
-    setFinished(true);
+    // Parsed on a worker thread, the reply finishes once the locations are built
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return parseFeatureCollections(data);
+    }, [this](const QList<QList<QGeoLocation>> &collections) {
+        if (collections.isEmpty()) {
+            setError(ParseError, tr("Response parse error"));
+            return;
+        }
+        setLocations(collections.first());
+        setFinished(true);
+    });
 }
 
 void QGeoCodeReplyMapbox::onNetworkReplyError(QNetworkReply::NetworkError error)
@@ -102,4 +133,64 @@ void QGeoCodeReplyMapbox::onNetworkReplyError(QNetworkReply::NetworkError error)
     setError(QGeoCodeReply::CommunicationError, reply->errorString());
 }
 
+QGeoCodeBatchReplyMapbox::QGeoCodeBatchReplyMapbox(const QList<QGeoCoordinate> &coordinates, QObject *parent)
+:   QGeoCodeBatchReply(coordinates, parent)
+{
+    Q_ASSERT(parent);
+}
+
+QGeoCodeBatchReplyMapbox::~QGeoCodeBatchReplyMapbox()
+{
+    for (QNetworkReply *reply : qAsConst(m_replies))
+        reply->deleteLater();
+}
+
+/*
+    The reply of a batch request is an array of feature collections, one for
+    each of the count coordinates starting at first.
+*/
+void QGeoCodeBatchReplyMapbox::addRequest(QNetworkReply *reply, int first, int count)
+{
+    m_replies.append(reply);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, first, count]() {
+        onNetworkReplyFinished(reply, first, count);
+    });
+}
+
+void QGeoCodeBatchReplyMapbox::abort()
+{
+    const QList<QNetworkReply *> replies = m_replies;
+    m_replies.clear();
+    for (QNetworkReply *reply : replies) {
+        reply->abort();
+        reply->deleteLater();
+    }
+    QGeoCodeBatchReply::abort();
+}
+
+void QGeoCodeBatchReplyMapbox::onNetworkReplyFinished(QNetworkReply *reply, int first, int count)
+{
+    if (!m_replies.removeOne(reply))
+        return;
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        for (int i = first; i < first + count; ++i)
+            setItemError(i, QGeoCodeReply::CommunicationError, reply->errorString());
+        return;
+    }
+
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return parseFeatureCollections(data);
+    }, [this, first, count](const QList<QList<QGeoLocation>> &collections) {
+        for (int i = 0; i < count; ++i) {
+            if (i < collections.size())
+                setItemLocations(first + i, collections.at(i));
+            else
+                setItemError(first + i, QGeoCodeReply::ParseError, tr("Response parse error"));
+        }
+    });
+}
+
 QT_END_NAMESPACE
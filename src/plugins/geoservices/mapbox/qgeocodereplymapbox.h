@@ -42,6 +42,7 @@
 
 #include <QtNetwork/QNetworkReply>
 #include <QtLocation/QGeoCodeReply>
+#include <QtLocation/QGeoCodeBatchReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -53,11 +54,30 @@ public:
     explicit QGeoCodeReplyMapbox(QNetworkReply *reply, QObject *parent = 0);
     ~QGeoCodeReplyMapbox();
 
+    void setNetworkReply(QNetworkReply *reply);
+
 private Q_SLOTS:
     void onNetworkReplyFinished();
     void onNetworkReplyError(QNetworkReply::NetworkError error);
 };
 
+class QGeoCodeBatchReplyMapbox : public QGeoCodeBatchReply
+{
+    Q_OBJECT
+
+public:
+    explicit QGeoCodeBatchReplyMapbox(const QList<QGeoCoordinate> &coordinates, QObject *parent = 0);
+    ~QGeoCodeBatchReplyMapbox();
+
+    void addRequest(QNetworkReply *reply, int first, int count);
+    void abort() override;
+
+private:
+    void onNetworkReplyFinished(QNetworkReply *reply, int first, int count);
+
+    QList<QNetworkReply *> m_replies;
+};
+
 QT_END_NAMESPACE
 
 #endif // QGEOCODEREPLYMAPBOX_H
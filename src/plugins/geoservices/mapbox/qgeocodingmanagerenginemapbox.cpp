@@ -54,11 +54,19 @@
 #include <QtPositioning/QGeoShape>
 #include <QtPositioning/QGeoCircle>
 #include <QtPositioning/QGeoRectangle>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace {
     static const QString allAddressTypes = QStringLiteral("address,district,locality,neighborhood,place,postcode,region,country");
+    // Queries a batch request of the permanent geocoding endpoint may take
+    static const int maxBatchSize = 50;
+
+    QString coordinateString(const QGeoCoordinate &coordinate)
+    {
+        return QString::number(coordinate.longitude()) + QLatin1Char(',') + QString::number(coordinate.latitude());
+    }
 }
 
 QGeoCodingManagerEngineMapbox::QGeoCodingManagerEngineMapbox(const QVariantMap &parameters,
@@ -76,6 +84,16 @@ QGeoCodingManagerEngineMapbox::QGeoCodingManagerEngineMapbox(const QVariantMap &
     m_isEnterprise = parameters.value(QStringLiteral("mapbox.enterprise")).toBool();
     m_urlPrefix = m_isEnterprise ? mapboxGeocodingEnterpriseApiPath : mapboxGeocodingApiPath;
 
+    QGeoRequestScheduler::instance()->configure(QUrl(m_urlPrefix).host(), parameters,
+                                                QStringLiteral("mapbox.geocoding."));
+
+    // pauses the host when it answers with 429 or 503
+    connect(m_networkManager, &QNetworkAccessManager::finished, this, [](QNetworkReply *reply) {
+        QGeoRequestScheduler::instance()->reportResponse(reply->url().host(),
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                reply->rawHeader("Retry-After"));
+    });
+
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 }
@@ -91,7 +109,8 @@ QGeoCodeReply *QGeoCodingManagerEngineMapbox::geocode(const QGeoAddress &address
     // If address text() is not generated: a manual setText() has been made.
     if (!address.isTextGenerated()) {
         queryItems.addQueryItem(QStringLiteral("type"), allAddressTypes);
-        return doSearch(address.text().simplified(), queryItems, bounds);
+        return doSearch(address.text().simplified(), queryItems, bounds,
+                        QGeoRequestScheduler::InteractivePriority);
     }
 
     QStringList addressString;
@@ -132,7 +151,8 @@ QGeoCodeReply *QGeoCodingManagerEngineMapbox::geocode(const QGeoAddress &address
     queryItems.addQueryItem(QStringLiteral("type"), typeString.join(QLatin1Char(',')));
     queryItems.addQueryItem(QStringLiteral("limit"), QString::number(1));
 
-    return doSearch(addressString.join(QStringLiteral(", ")), queryItems, bounds);
+    return doSearch(addressString.join(QStringLiteral(", ")), queryItems, bounds,
+                    QGeoRequestScheduler::InteractivePriority);
 }
 
 QGeoCodeReply *QGeoCodingManagerEngineMapbox::geocode(const QString &address, int limit, int offset, const QGeoShape &bounds)
@@ -143,20 +163,77 @@ QGeoCodeReply *QGeoCodingManagerEngineMapbox::geocode(const QString &address, in
     queryItems.addQueryItem(QStringLiteral("type"), allAddressTypes);
     queryItems.addQueryItem(QStringLiteral("limit"), QString::number(limit));
 
-    return doSearch(address, queryItems, bounds);
+    return doSearch(address, queryItems, bounds, QGeoRequestScheduler::InteractivePriority);
 }
 
 QGeoCodeReply *QGeoCodingManagerEngineMapbox::reverseGeocode(const QGeoCoordinate &coordinate, const QGeoShape &bounds)
 {
-    const QString coordinateString = QString::number(coordinate.longitude()) + QLatin1Char(',') + QString::number(coordinate.latitude());
-
     QUrlQuery queryItems;
     queryItems.addQueryItem(QStringLiteral("limit"), QString::number(1));
 
-    return doSearch(coordinateString, queryItems, bounds);
+    return doSearch(coordinateString(coordinate), queryItems, bounds,
+                    QGeoRequestScheduler::BackgroundPriority);
+}
+
+/*
+    Only the permanent endpoint of enterprise accounts takes batch requests,
+    of up to 50 queries separated by semicolons.
+*/
+QGeoCodeBatchReply *QGeoCodingManagerEngineMapbox::reverseGeocodeBatch(const QList<QGeoCoordinate> &coordinates,
+                                                                       const QGeoShape &bounds)
+{
+    if (!m_isEnterprise || coordinates.size() < 2)
+        return nullptr;
+
+    QGeoCodeBatchReplyMapbox *reply = new QGeoCodeBatchReplyMapbox(coordinates, this);
+    for (int first = 0; first < coordinates.size(); first += maxBatchSize) {
+        const int count = qMin(maxBatchSize, coordinates.size() - first);
+        QStringList queries;
+        for (int i = first; i < first + count; ++i)
+            queries.append(coordinateString(coordinates.at(i)));
+
+        QUrlQuery queryItems;
+        queryItems.addQueryItem(QStringLiteral("limit"), QString::number(1));
+        const QNetworkRequest networkRequest = searchRequest(queries.join(QLatin1Char(';')), queryItems, bounds);
+        QGeoRequestScheduler::instance()->schedule(networkRequest.url().host(), reply,
+                [this, reply, networkRequest, first, count]() {
+            if (reply->isFinished())
+                return false;
+            reply->addRequest(m_networkManager->get(networkRequest), first, count);
+            return true;
+        }, QGeoRequestScheduler::BackgroundPriority);
+    }
+
+    connect(reply, &QGeoCodeReply::finished, this, &QGeoCodingManagerEngineMapbox::onReplyFinished);
+    connect(reply, QOverload<QGeoCodeReply::Error, const QString &>::of(&QGeoCodeReply::error),
+            this, &QGeoCodingManagerEngineMapbox::onReplyError);
+
+    return reply;
 }
 
-QGeoCodeReply *QGeoCodingManagerEngineMapbox::doSearch(const QString &request, QUrlQuery &queryItems, const QGeoShape &bounds)
+QGeoCodeReply *QGeoCodingManagerEngineMapbox::doSearch(const QString &request, QUrlQuery &queryItems, const QGeoShape &bounds,
+                                                       QGeoRequestScheduler::Priority priority)
+{
+    const QNetworkRequest networkRequest = searchRequest(request, queryItems, bounds);
+    QGeoCodeReplyMapbox *reply = new QGeoCodeReplyMapbox(nullptr, this);
+
+    connect(reply, &QGeoCodeReplyMapbox::finished, this, &QGeoCodingManagerEngineMapbox::onReplyFinished);
+    connect(reply, QOverload<QGeoCodeReply::Error, const QString &>::of(&QGeoCodeReply::error),
+            this, &QGeoCodingManagerEngineMapbox::onReplyError);
+
+    QGeoRequestScheduler::instance()->schedule(networkRequest.url().host(), reply,
+            [this, reply, networkRequest]() {
+        if (reply->isFinished())
+            return false;
+        reply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    }, priority);
+
+    return reply;
+}
+
+QNetworkRequest QGeoCodingManagerEngineMapbox::searchRequest(const QString &request, QUrlQuery &queryItems,
+                                                             const QGeoShape &bounds) const
 {
     queryItems.addQueryItem(QStringLiteral("access_token"), m_accessToken);
 
@@ -177,15 +254,7 @@ QGeoCodeReply *QGeoCodingManagerEngineMapbox::doSearch(const QString &request, Q
 
     QNetworkRequest networkRequest(requestUrl);
     networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
-
-    QNetworkReply *networkReply = m_networkManager->get(networkRequest);
-    QGeoCodeReplyMapbox *reply = new QGeoCodeReplyMapbox(networkReply, this);
-
-    connect(reply, &QGeoCodeReplyMapbox::finished, this, &QGeoCodingManagerEngineMapbox::onReplyFinished);
-    connect(reply, QOverload<QGeoCodeReply::Error, const QString &>::of(&QGeoCodeReply::error),
-            this, &QGeoCodingManagerEngineMapbox::onReplyError);
-
-    return reply;
+    return networkRequest;
 }
 
 void QGeoCodingManagerEngineMapbox::onReplyFinished()
@@ -41,9 +41,12 @@
 #define QGEOCODINGMANAGERENGINEMAPBOX_H
 
 #include <QtCore/QUrlQuery>
+#include <QtNetwork/QNetworkRequest>
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/QGeoCodingManagerEngine>
 #include <QtLocation/QGeoCodeReply>
+#include <QtLocation/QGeoCodeBatchReply>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -63,13 +66,17 @@ public:
                            const QGeoShape &bounds) override;
     QGeoCodeReply *reverseGeocode(const QGeoCoordinate &coordinate,
                                   const QGeoShape &bounds) override;
+    Q_INVOKABLE QGeoCodeBatchReply *reverseGeocodeBatch(const QList<QGeoCoordinate> &coordinates,
+                                                        const QGeoShape &bounds);
 
 private slots:
     void onReplyFinished();
     void onReplyError(QGeoCodeReply::Error errorCode, const QString &errorString);
 
 private:
-    QGeoCodeReply *doSearch(const QString &, QUrlQuery &, const QGeoShape &bounds);
+    QGeoCodeReply *doSearch(const QString &, QUrlQuery &, const QGeoShape &bounds,
+                            QGeoRequestScheduler::Priority priority);
+    QNetworkRequest searchRequest(const QString &, QUrlQuery &, const QGeoShape &bounds) const;
 
     QNetworkAccessManager *m_networkManager;
     QByteArray m_userAgent;
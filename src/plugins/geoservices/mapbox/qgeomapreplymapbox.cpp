@@ -64,6 +64,14 @@ void QGeoMapReplyMapbox::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
+    setValidators(QGeoTileValidators::fromHttpHeaders(reply->rawHeaderPairs()));
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        // answer to a conditional request, the cached tile is still valid
+        setNotModified(true);
+        setFinished(true);
+        return;
+    }
+
     setMapImageData(reply->readAll());
     setMapImageFormat(m_format);
     setFinished(true);
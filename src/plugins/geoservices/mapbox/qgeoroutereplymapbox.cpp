@@ -41,6 +41,7 @@
 #include "qgeoroutereplymapbox.h"
 #include "qgeoroutingmanagerenginemapbox.h"
 #include <QtLocation/private/qgeorouteparser_p.h>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
 #include <QtLocation/private/qgeoroute_p.h>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -96,10 +97,16 @@ QGeoRouteReplyMapbox::QGeoRouteReplyMapbox(QNetworkReply *reply, const QGeoRoute
                                      QObject *parent)
 :   QGeoRouteReply(request, parent)
 {
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
+    if (reply)
+        setNetworkReply(reply);
+}
+
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void QGeoRouteReplyMapbox::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
     connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
             this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
@@ -122,11 +129,17 @@ void QGeoRouteReplyMapbox::networkReplyFinished()
     QGeoRoutingManagerEngineMapbox *engine = qobject_cast<QGeoRoutingManagerEngineMapbox *>(parent());
     const QGeoRouteParser *parser = engine->routeParser();
 
-    QList<QGeoRoute> routes;
-    QString errorString;
+    // Parsed on a worker thread, the reply finishes once the routes are built
+    const QByteArray routeReply = reply->readAll();
+    parser->parseReplyAsync(routeReply, this,
+                            [this, routeReply](QGeoRouteReply::Error error, const QString &errorString, const QList<QGeoRoute> &routes) {
+        routesParsed(error, errorString, routes, routeReply);
+    });
+}
 
-    QByteArray routeReply = reply->readAll();
-    QGeoRouteReply::Error error = parser->parseReply(routes, errorString, routeReply);
+void QGeoRouteReplyMapbox::routesParsed(QGeoRouteReply::Error error, const QString &errorString, QList<QGeoRoute> routes,
+                                        const QByteArray &routeReply)
+{
     // Setting the request into the result
     for (QGeoRoute &route : routes) {
         route.setRequest(request());
@@ -161,4 +174,56 @@ void QGeoRouteReplyMapbox::networkReplyError(QNetworkReply::NetworkError error)
     setError(QGeoRouteReply::CommunicationError, reply->errorString());
 }
 
+QGeoRouteMatrixReplyMapbox::QGeoRouteMatrixReplyMapbox(const QList<QGeoCoordinate> &origins,
+                                                       const QList<QGeoCoordinate> &destinations,
+                                                       const QGeoRouteRequest &request, QObject *parent)
+:   QGeoRouteMatrixReply(origins, destinations, request, parent)
+{
+}
+
+void QGeoRouteMatrixReplyMapbox::setNetworkReply(QNetworkReply *reply)
+{
+    connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
+    connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
+            this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
+    connect(this, &QGeoRouteReply::aborted, reply, &QNetworkReply::abort);
+    connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
+}
+
+QGeoRouteMatrixReplyMapbox::~QGeoRouteMatrixReplyMapbox()
+{
+}
+
+void QGeoRouteMatrixReplyMapbox::networkReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError)
+        return;
+
+    // The Matrix API answers like the table service of OSRM
+    QGeoRoutingManagerEngineMapbox *engine = qobject_cast<QGeoRoutingManagerEngineMapbox *>(parent());
+    const QGeoRouteParserOsrmV5 *parser = static_cast<const QGeoRouteParserOsrmV5 *>(engine->routeParser());
+
+    QVector<double> durations;
+    QVector<double> distances;
+    QString errorString;
+    const QGeoRouteReply::Error error = parser->parseTableReply(durations, distances, errorString, reply->readAll());
+    if (error == QGeoRouteReply::NoError) {
+        setBlock(0, 0, origins().size(), durations, distances);
+        setFinished(true);
+    } else {
+        setError(error, errorString);
+    }
+}
+
+void QGeoRouteMatrixReplyMapbox::networkReplyError(QNetworkReply::NetworkError error)
+{
+    Q_UNUSED(error);
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+    setError(QGeoRouteReply::CommunicationError, reply->errorString());
+}
+
 QT_END_NAMESPACE
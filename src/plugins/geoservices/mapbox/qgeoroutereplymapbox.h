@@ -43,6 +43,7 @@
 
 #include <QtNetwork/QNetworkReply>
 #include <QtLocation/QGeoRouteReply>
+#include <QtLocation/QGeoRouteMatrixReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,6 +56,29 @@ public:
     QGeoRouteReplyMapbox(QNetworkReply *reply, const QGeoRouteRequest &request, QObject *parent = 0);
     ~QGeoRouteReplyMapbox();
 
+    void setNetworkReply(QNetworkReply *reply);
+
+private Q_SLOTS:
+    void networkReplyFinished();
+    void networkReplyError(QNetworkReply::NetworkError error);
+
+private:
+    void routesParsed(QGeoRouteReply::Error error, const QString &errorString, QList<QGeoRoute> routes,
+                      const QByteArray &routeReply);
+};
+
+class QGeoRouteMatrixReplyMapbox : public QGeoRouteMatrixReply
+{
+    Q_OBJECT
+
+public:
+    QGeoRouteMatrixReplyMapbox(const QList<QGeoCoordinate> &origins,
+                               const QList<QGeoCoordinate> &destinations,
+                               const QGeoRouteRequest &request, QObject *parent = 0);
+    ~QGeoRouteMatrixReplyMapbox();
+
+    void setNetworkReply(QNetworkReply *reply);
+
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
@@ -42,6 +42,7 @@
 #include "qgeoroutereplymapbox.h"
 #include "qmapboxcommon.h"
 #include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 #include <QtLocation/qgeoroutesegment.h>
 #include <QtLocation/qgeomaneuver.h>
 
@@ -50,6 +51,7 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QUrlQuery>
 #include <QtCore/QDebug>
+#include <QtNetwork/QNetworkReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -215,6 +217,27 @@ void QGeoRouteParserOsrmV5ExtensionMapbox::updateSegment(QGeoRouteSegment &segme
     segment.setManeuver(m);
 }
 
+// The path of the profile for the travel modes of request, with a trailing slash
+static QString mapboxProfile(const QGeoRouteRequest &request, bool allowTraffic = true)
+{
+    QGeoRouteRequest::TravelModes travelModes = request.travelModes();
+    if (travelModes.testFlag(QGeoRouteRequest::PedestrianTravel)) {
+        return QStringLiteral("walking/");
+    } else if (travelModes.testFlag(QGeoRouteRequest::BicycleTravel)) {
+        return QStringLiteral("cycling/");
+    } else if (travelModes.testFlag(QGeoRouteRequest::CarTravel)) {
+        const QList<QGeoRouteRequest::FeatureType> &featureTypes = request.featureTypes();
+        int trafficFeatureIdx = featureTypes.indexOf(QGeoRouteRequest::TrafficFeature);
+        QGeoRouteRequest::FeatureWeight trafficWeight = request.featureWeight(QGeoRouteRequest::TrafficFeature);
+        if (allowTraffic && trafficFeatureIdx >= 0 &&
+           (trafficWeight == QGeoRouteRequest::AvoidFeatureWeight || trafficWeight == QGeoRouteRequest::DisallowFeatureWeight)) {
+            return QStringLiteral("driving-traffic/");
+        } else {
+            return QStringLiteral("driving/");
+        }
+    }
+    return QString();
+}
 
 QGeoRoutingManagerEngineMapbox::QGeoRoutingManagerEngineMapbox(const QVariantMap &parameters,
                                                          QGeoServiceProvider::Error *error,
@@ -247,6 +270,19 @@ QGeoRoutingManagerEngineMapbox::QGeoRoutingManagerEngineMapbox(const QVariantMap
     }
     m_routeParser = parser;
 
+    QGeoRequestScheduler::instance()->configure(QUrl(mapboxDirectionsApiPath).host(), parameters,
+                                                QStringLiteral("mapbox.routing."));
+
+    // pauses the host when it answers with 429 or 503
+    connect(m_networkManager, &QNetworkAccessManager::finished, this, [](QNetworkReply *reply) {
+        QGeoRequestScheduler::instance()->reportResponse(reply->url().host(),
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                reply->rawHeader("Retry-After"));
+    });
+
+    // The Matrix API takes up to 25 coordinates, 10 with the traffic profile
+    setRouteMatrixLimits(0, 0, 25);
+
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 }
@@ -260,38 +296,61 @@ QGeoRouteReply* QGeoRoutingManagerEngineMapbox::calculateRoute(const QGeoRouteRe
     QNetworkRequest networkRequest;
     networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
 
-    QString url = mapboxDirectionsApiPath;
-
-    QGeoRouteRequest::TravelModes travelModes = request.travelModes();
-    if (travelModes.testFlag(QGeoRouteRequest::PedestrianTravel)) {
-        url += QStringLiteral("walking/");
-    } else if (travelModes.testFlag(QGeoRouteRequest::BicycleTravel)) {
-        url += QStringLiteral("cycling/");
-    } else if (travelModes.testFlag(QGeoRouteRequest::CarTravel)) {
-        const QList<QGeoRouteRequest::FeatureType> &featureTypes = request.featureTypes();
-        int trafficFeatureIdx = featureTypes.indexOf(QGeoRouteRequest::TrafficFeature);
-        QGeoRouteRequest::FeatureWeight trafficWeight = request.featureWeight(QGeoRouteRequest::TrafficFeature);
-        if (trafficFeatureIdx >= 0 &&
-           (trafficWeight == QGeoRouteRequest::AvoidFeatureWeight || trafficWeight == QGeoRouteRequest::DisallowFeatureWeight)) {
-            url += QStringLiteral("driving-traffic/");
-        } else {
-            url += QStringLiteral("driving/");
-        }
-    }
+    QString url = mapboxDirectionsApiPath + mapboxProfile(request);
 
     networkRequest.setUrl(m_routeParser->requestUrl(request, url));
 
-    QNetworkReply *reply = m_networkManager->get(networkRequest);
-
-    QGeoRouteReplyMapbox *routeReply = new QGeoRouteReplyMapbox(reply, request, this);
+    QGeoRouteReplyMapbox *routeReply = new QGeoRouteReplyMapbox(nullptr, request, this);
 
     connect(routeReply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(routeReply, SIGNAL(error(QGeoRouteReply::Error,QString)),
             this, SLOT(replyError(QGeoRouteReply::Error,QString)));
 
+    QGeoRequestScheduler::instance()->schedule(networkRequest.url().host(), routeReply,
+            [this, routeReply, networkRequest]() {
+        if (routeReply->isFinished())
+            return false;
+        routeReply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    });
+
     return routeReply;
 }
 
+QGeoRouteMatrixReply *QGeoRoutingManagerEngineMapbox::calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                                           const QList<QGeoCoordinate> &destinations,
+                                                                           const QGeoRouteRequest &request)
+{
+    QNetworkRequest networkRequest;
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
+
+    // Larger blocks are taken by the profile without live traffic
+    const bool allowTraffic = origins.size() + destinations.size() <= 10;
+    QUrl url = static_cast<const QGeoRouteParserOsrmV5 *>(m_routeParser)->tableRequestUrl(
+                origins, destinations, mapboxMatrixApiPath + mapboxProfile(request, allowTraffic));
+    QUrlQuery query(url);
+    if (!m_accessToken.isEmpty())
+        query.addQueryItem(QStringLiteral("access_token"), m_accessToken);
+    url.setQuery(query);
+    networkRequest.setUrl(url);
+
+    QGeoRouteMatrixReplyMapbox *matrixReply = new QGeoRouteMatrixReplyMapbox(origins, destinations, request, this);
+
+    connect(matrixReply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    connect(matrixReply, SIGNAL(error(QGeoRouteReply::Error,QString)),
+            this, SLOT(replyError(QGeoRouteReply::Error,QString)));
+
+    QGeoRequestScheduler::instance()->schedule(networkRequest.url().host(), matrixReply,
+            [this, matrixReply, networkRequest]() {
+        if (matrixReply->isFinished())
+            return false;
+        matrixReply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    });
+
+    return matrixReply;
+}
+
 const QGeoRouteParser *QGeoRoutingManagerEngineMapbox::routeParser() const
 {
     return m_routeParser;
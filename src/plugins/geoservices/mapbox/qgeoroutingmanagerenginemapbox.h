@@ -43,6 +43,7 @@
 
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/QGeoRoutingManagerEngine>
+#include <QtLocation/QGeoRouteMatrixReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -60,6 +61,9 @@ public:
     ~QGeoRoutingManagerEngineMapbox();
 
     QGeoRouteReply *calculateRoute(const QGeoRouteRequest &request);
+    Q_INVOKABLE QGeoRouteMatrixReply *calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                           const QList<QGeoCoordinate> &destinations,
+                                                           const QGeoRouteRequest &request);
     const QGeoRouteParser *routeParser() const;
 
 private Q_SLOTS:
@@ -150,6 +150,10 @@ QGeoTiledMappingManagerEngineMapbox::QGeoTiledMappingManagerEngineMapbox(const Q
         const QString token = parameters.value(QStringLiteral("mapbox.access_token")).toString();
         tileFetcher->setAccessToken(token);
     }
+    if (parameters.contains(QStringLiteral("mapbox.mapping.max_concurrent_requests"))) {
+        const int maximum = parameters.value(QStringLiteral("mapbox.mapping.max_concurrent_requests")).toInt();
+        tileFetcher->setMaximumConcurrentRequests(maximum);
+    }
 
     setTileFetcher(tileFetcher);
 
@@ -238,6 +242,8 @@ QGeoTiledMappingManagerEngineMapbox::QGeoTiledMappingManagerEngineMapbox(const Q
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
 
     setTileCache(tileCache);
@@ -96,6 +96,11 @@ QGeoTiledMapReply *QGeoTileFetcherMapbox::getTileImage(const QGeoTileSpec &spec)
                         m_format + QLatin1Char('?') +
                         QStringLiteral("access_token=") + m_accessToken));
 
+    const QGeoTileValidators validators = tileValidators(spec);
+    if (!validators.entityTag.isEmpty())
+        request.setRawHeader("If-None-Match", validators.entityTag);
+    if (!validators.lastModified.isEmpty())
+        request.setRawHeader("If-Modified-Since", validators.lastModified);
     QNetworkReply *reply = m_networkManager->get(request);
 
     return new QGeoMapReplyMapbox(reply, spec, m_replyFormat);
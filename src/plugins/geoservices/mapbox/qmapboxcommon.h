@@ -54,6 +54,7 @@ static const QString mapboxGeocodingEnterpriseApiPath = QStringLiteral("https://
 
 // https://www.mapbox.com/api-documentation/#directions
 static const QString mapboxDirectionsApiPath = QStringLiteral("https://api.mapbox.com/directions/v5/mapbox/");
+static const QString mapboxMatrixApiPath = QStringLiteral("https://api.mapbox.com/directions-matrix/v1/mapbox/");
 
 static const QByteArray mapboxDefaultUserAgent = QByteArrayLiteral("Qt Location based application");
 
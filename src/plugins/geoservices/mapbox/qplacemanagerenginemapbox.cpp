@@ -51,6 +51,7 @@
 #include <QtNetwork/QNetworkReply>
 #include <QtPositioning/QGeoCircle>
 #include <QtLocation/private/unsupportedreplies_p.h>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 #include <QtCore/QElapsedTimer>
 
@@ -102,6 +103,16 @@ QPlaceManagerEngineMapbox::QPlaceManagerEngineMapbox(const QVariantMap &paramete
     m_isEnterprise = parameters.value(QStringLiteral("mapbox.enterprise")).toBool();
     m_urlPrefix = m_isEnterprise ? mapboxGeocodingEnterpriseApiPath : mapboxGeocodingApiPath;
 
+    QGeoRequestScheduler::instance()->configure(QUrl(m_urlPrefix).host(), parameters,
+                                                QStringLiteral("mapbox.places."));
+
+    // pauses the host when it answers with 429 or 503
+    connect(m_networkManager, &QNetworkAccessManager::finished, this, [](QNetworkReply *reply) {
+        QGeoRequestScheduler::instance()->reportResponse(reply->url().host(),
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                reply->rawHeader("Retry-After"));
+    });
+
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 }
@@ -225,17 +236,38 @@ QPlaceReply *QPlaceManagerEngineMapbox::doSearch(const QPlaceSearchRequest &requ
     QNetworkRequest networkRequest(requestUrl);
     networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
 
-    QNetworkReply *networkReply = m_networkManager->get(networkRequest);
     QPlaceReply *reply;
-    if (searchType == PlaceSearchType::CompleteSearch)
-        reply = new QPlaceSearchReplyMapbox(request, networkReply, this);
-    else
-        reply = new QPlaceSearchSuggestionReplyMapbox(networkReply, this);
+    std::function<void(QNetworkReply *)> setNetworkReply;
+    std::function<void()> superseded;
+    if (searchType == PlaceSearchType::CompleteSearch) {
+        QPlaceSearchReplyMapbox *searchReply = new QPlaceSearchReplyMapbox(request, nullptr, this);
+        setNetworkReply = [searchReply](QNetworkReply *r) { searchReply->setNetworkReply(r); };
+        superseded = [searchReply]() { searchReply->supersede(); };
+        reply = searchReply;
+    } else {
+        QPlaceSearchSuggestionReplyMapbox *suggestionReply = new QPlaceSearchSuggestionReplyMapbox(nullptr, this);
+        setNetworkReply = [suggestionReply](QNetworkReply *r) { suggestionReply->setNetworkReply(r); };
+        superseded = [suggestionReply]() { suggestionReply->supersede(); };
+        reply = suggestionReply;
+    }
 
     connect(reply, &QPlaceReply::finished, this, &QPlaceManagerEngineMapbox::onReplyFinished);
     connect(reply, QOverload<QPlaceReply::Error, const QString &>::of(&QPlaceReply::error),
             this, &QPlaceManagerEngineMapbox::onReplyError);
 
+    // a search still waiting for the server is dropped for a newer one of the
+    // same type, as when searching while typing
+    const QString coalescingKey = QStringLiteral("mapbox.places.search/")
+            + QString::number(int(searchType)) + QLatin1Char('/')
+            + QString::number(quintptr(this), 16);
+    QGeoRequestScheduler::instance()->schedule(requestUrl.host(), reply,
+            [this, reply, setNetworkReply, networkRequest]() {
+        if (reply->isFinished())
+            return false;
+        setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    }, QGeoRequestScheduler::InteractivePriority, coalescingKey, superseded);
+
     return reply;
 }
 
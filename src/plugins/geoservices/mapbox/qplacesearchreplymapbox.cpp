@@ -50,6 +50,7 @@
 #include <QtLocation/QPlaceResult>
 #include <QtLocation/QPlaceSearchRequest>
 #include <QtLocation/QPlaceContactDetail>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 #include <algorithm>
 
@@ -135,12 +136,17 @@ QPlaceSearchReplyMapbox::QPlaceSearchReplyMapbox(const QPlaceSearchRequest &requ
 :   QPlaceSearchReply(parent)
 {
     Q_ASSERT(parent);
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
     setRequest(request);
+    if (reply)
+        setNetworkReply(reply);
+}
 
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void QPlaceSearchReplyMapbox::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, &QNetworkReply::finished, this, &QPlaceSearchReplyMapbox::onReplyFinished);
     connect(reply, &QNetworkReply::errorOccurred, this, &QPlaceSearchReplyMapbox::onNetworkError);
 
@@ -148,6 +154,15 @@ QPlaceSearchReplyMapbox::QPlaceSearchReplyMapbox(const QPlaceSearchRequest &requ
     connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
 }
 
+/*
+    Finishes the reply with QPlaceReply::CancelError, for a search replaced by
+    a newer one of the engine before it was sent.
+*/
+void QPlaceSearchReplyMapbox::supersede()
+{
+    setError(QPlaceReply::CancelError, tr("Superseded by a newer search"));
+}
+
 QPlaceSearchReplyMapbox::~QPlaceSearchReplyMapbox()
 {
 }
@@ -161,27 +176,28 @@ void QPlaceSearchReplyMapbox::setError(QPlaceReply::Error errorCode, const QStri
     emit finished();
 }
 
-void QPlaceSearchReplyMapbox::onReplyFinished()
+namespace {
+struct ParsedSearch
 {
-    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
-    reply->deleteLater();
-
-    if (reply->error() != QNetworkReply::NoError)
-        return;
+    bool ok = false;
+    QList<QPlaceSearchResult> results;
+};
+}
 
-    const QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-    if (!document.isObject()) {
-        setError(ParseError, tr("Response parse error"));
-        return;
-    }
+static ParsedSearch parseSearch(const QByteArray &data, const QPlaceSearchRequest &request)
+{
+    ParsedSearch parsed;
+    const QJsonDocument document = QJsonDocument::fromJson(data);
+    if (!document.isObject())
+        return parsed;
 
     const QJsonArray features = document.object().value(QStringLiteral("features")).toArray();
     const QString attribution = document.object().value(QStringLiteral("attribution")).toString();
 
-    const QGeoCoordinate searchCenter = request().searchArea().center();
-    const QList<QPlaceCategory> categories = request().categories();
+    const QGeoCoordinate searchCenter = request.searchArea().center();
+    const QList<QPlaceCategory> categories = request.categories();
 
-    QList<QPlaceSearchResult> results;
+    QList<QPlaceSearchResult> &results = parsed.results;
     for (const QJsonValue &feature : features) {
         QPlaceResult placeResult = parsePlaceResult(feature.toObject(), attribution);
 
@@ -203,20 +219,42 @@ void QPlaceSearchReplyMapbox::onReplyFinished()
         results.append(placeResult);
     }
 
-    if (request().relevanceHint() == QPlaceSearchRequest::DistanceHint) {
+    if (request.relevanceHint() == QPlaceSearchRequest::DistanceHint) {
         std::sort(results.begin(), results.end(), [](const QPlaceResult &a, const QPlaceResult &b) -> bool {
                 return a.distance() < b.distance();
         });
-    } else if (request().relevanceHint() == QPlaceSearchRequest::LexicalPlaceNameHint) {
+    } else if (request.relevanceHint() == QPlaceSearchRequest::LexicalPlaceNameHint) {
         std::sort(results.begin(), results.end(), [](const QPlaceResult &a, const QPlaceResult &b) -> bool {
                 return a.place().name() < b.place().name();
         });
     }
 
-    setResults(results);
+    parsed.ok = true;
+    return parsed;
+}
 
-    setFinished(true);
-    emit finished();
+void QPlaceSearchReplyMapbox::onReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError)
+        return;
+
+    // Parsed on a worker thread, the reply finishes once the results are built
+    const QByteArray data = reply->readAll();
+    const QPlaceSearchRequest searchRequest = request();
+    qParseReplyAsync(this, [data, searchRequest](const QGeoParseCancellation &) {
+        return parseSearch(data, searchRequest);
+    }, [this](const ParsedSearch &parsed) {
+        if (!parsed.ok) {
+            setError(ParseError, tr("Response parse error"));
+            return;
+        }
+        setResults(parsed.results);
+        setFinished(true);
+        emit finished();
+    });
 }
 
 void QPlaceSearchReplyMapbox::onNetworkError(QNetworkReply::NetworkError error)
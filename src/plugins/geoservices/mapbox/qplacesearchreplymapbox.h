@@ -58,6 +58,9 @@ public:
                           QPlaceManagerEngineMapbox *parent);
     ~QPlaceSearchReplyMapbox();
 
+    void setNetworkReply(QNetworkReply *reply);
+    void supersede();
+
 public slots:
     void setError(QPlaceReply::Error errorCode, const QString &errorString);
 
@@ -48,6 +48,7 @@
 #include <QtPositioning/QGeoRectangle>
 #include <QtLocation/QPlaceResult>
 #include <QtLocation/QPlaceSearchRequest>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,11 +56,16 @@ QPlaceSearchSuggestionReplyMapbox::QPlaceSearchSuggestionReplyMapbox(QNetworkRep
 :   QPlaceSearchSuggestionReply(parent)
 {
     Q_ASSERT(parent);
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
+    if (reply)
+        setNetworkReply(reply);
+}
 
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void QPlaceSearchSuggestionReplyMapbox::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, &QNetworkReply::finished, this, &QPlaceSearchSuggestionReplyMapbox::onReplyFinished);
     connect(reply, &QNetworkReply::errorOccurred, this, &QPlaceSearchSuggestionReplyMapbox::onNetworkError);
 
@@ -67,6 +73,15 @@ QPlaceSearchSuggestionReplyMapbox::QPlaceSearchSuggestionReplyMapbox(QNetworkRep
     connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
 }
 
+/*
+    Finishes the reply with QPlaceReply::CancelError, for a search replaced by
+    a newer one of the engine before it was sent.
+*/
+void QPlaceSearchSuggestionReplyMapbox::supersede()
+{
+    setError(QPlaceReply::CancelError, tr("Superseded by a newer search"));
+}
+
 QPlaceSearchSuggestionReplyMapbox::~QPlaceSearchSuggestionReplyMapbox()
 {
 }
@@ -80,32 +95,51 @@ void QPlaceSearchSuggestionReplyMapbox::setError(QPlaceReply::Error errorCode, c
     emit finished();
 }
 
-void QPlaceSearchSuggestionReplyMapbox::onReplyFinished()
+namespace {
+struct ParsedSuggestions
 {
-    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
-    reply->deleteLater();
-
-    if (reply->error() != QNetworkReply::NoError)
-        return;
+    bool ok = false;
+    QStringList suggestions;
+};
+}
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-    if (!document.isObject()) {
-        setError(ParseError, tr("Response parse error"));
-        return;
-    }
+static ParsedSuggestions parseSuggestions(const QByteArray &data)
+{
+    ParsedSuggestions parsed;
+    const QJsonDocument document = QJsonDocument::fromJson(data);
+    if (!document.isObject())
+        return parsed;
 
     const QJsonArray features = document.object().value(QStringLiteral("features")).toArray();
-
-    QStringList suggestions;
     for (const QJsonValue &feature : features) {
         if (feature.isObject())
-            suggestions.append(feature.toObject().value(QStringLiteral("text")).toString());
+            parsed.suggestions.append(feature.toObject().value(QStringLiteral("text")).toString());
     }
+    parsed.ok = true;
+    return parsed;
+}
 
-    setSuggestions(suggestions);
+void QPlaceSearchSuggestionReplyMapbox::onReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
 
-    setFinished(true);
-    emit finished();
+    if (reply->error() != QNetworkReply::NoError)
+        return;
+
+    // Parsed on a worker thread, the reply finishes once the suggestions are built
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return parseSuggestions(data);
+    }, [this](const ParsedSuggestions &parsed) {
+        if (!parsed.ok) {
+            setError(ParseError, tr("Response parse error"));
+            return;
+        }
+        setSuggestions(parsed.suggestions);
+        setFinished(true);
+        emit finished();
+    });
 }
 
 void QPlaceSearchSuggestionReplyMapbox::onNetworkError(QNetworkReply::NetworkError error)
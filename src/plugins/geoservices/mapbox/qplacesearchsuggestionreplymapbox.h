@@ -57,6 +57,9 @@ public:
     QPlaceSearchSuggestionReplyMapbox(QNetworkReply *reply, QPlaceManagerEngineMapbox *parent);
     ~QPlaceSearchSuggestionReplyMapbox();
 
+    void setNetworkReply(QNetworkReply *reply);
+    void supersede();
+
 public slots:
     void setError(QPlaceReply::Error errorCode, const QString &errorString);
 
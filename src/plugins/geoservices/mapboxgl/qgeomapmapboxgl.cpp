@@ -41,7 +41,6 @@
 #include "qmapboxglstylechange_p.h"
 
 #include <QtCore/QByteArray>
-#include <QtCore/QCoreApplication>
 #include <QtGui/QOpenGLContext>
 #include <QtGui/QOpenGLFramebufferObject>
 #include <QtLocation/private/qdeclarativecirclemapitem_p.h>
@@ -124,6 +123,9 @@ QSGNode *QGeoMapMapboxGLPrivate::updateSceneGraph(QSGNode *node, QQuickWindow *w
     map = (m_useFBO) ? static_cast<QSGMapboxGLTextureNode *>(node)->map()
                      : static_cast<QSGMapboxGLRenderNode *>(node)->map();
 
+    // Renders requested from now on need another frame
+    m_renderScheduled.storeRelaxed(0);
+
     if (m_syncState & MapTypeSync) {
         m_developmentMode = m_activeMapType.name().startsWith("mapbox://")
             && m_settings.accessToken() == developmentToken;
@@ -168,8 +170,6 @@ QSGNode *QGeoMapMapboxGLPrivate::updateSceneGraph(QSGNode *node, QQuickWindow *w
         static_cast<QSGMapboxGLTextureNode *>(node)->render(window);
     }
 
-    threadedRenderingHack(window, map);
-
     m_syncState = NoSync;
 
     return node;
@@ -250,7 +250,12 @@ void QGeoMapMapboxGLPrivate::addMapItem(QDeclarativeGeoMapItemBase *item)
 
     QObject::connect(item, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged, q, &QGeoMapMapboxGL::onMapItemPropertyChanged);
 
-    m_styleChanges << QMapboxGLStyleChange::addMapItem(item, m_mapItemsBefore);
+    if (m_batchMapItems) {
+        addMapItemBatches();
+        markMapItemChanged(item, GeometryChange);
+    } else {
+        m_styleChanges << QMapboxGLStyleChange::addMapItem(item, m_mapItemsBefore);
+    }
 
     emit q->sgNodeChanged();
 }
@@ -279,8 +284,14 @@ void QGeoMapMapboxGLPrivate::removeMapItem(QDeclarativeGeoMapItemBase *item)
     }
 
     q->disconnect(item);
+    m_mapItemChanges.remove(item);
 
-    m_styleChanges << QMapboxGLStyleChange::removeMapItem(item);
+    if (m_batchMapItems) {
+        if (m_batchedFeatures.remove(item))
+            m_dirtyBatches.insert(QMapboxGLStyleChange::mapItemBatch(item));
+    } else {
+        m_styleChanges << QMapboxGLStyleChange::removeMapItem(item);
+    }
 
     emit q->sgNodeChanged();
 }
@@ -328,38 +339,80 @@ QRectF QGeoMapMapboxGLPrivate::visibleArea() const
     return m_visibleArea;
 }
 
-void QGeoMapMapboxGLPrivate::syncStyleChanges(QMapboxGL *map)
+/*
+    Adds the batch sources and layers to the style, once per style.
+*/
+void QGeoMapMapboxGLPrivate::addMapItemBatches()
 {
-    for (const auto& change : m_styleChanges) {
-        change->apply(map);
-    }
+    if (m_batchesAdded)
+        return;
 
-    m_styleChanges.clear();
+    m_styleChanges << QMapboxGLStyleChange::addMapItemBatches(m_mapItemsBefore);
+    m_batchesAdded = true;
 }
 
-void QGeoMapMapboxGLPrivate::threadedRenderingHack(QQuickWindow *window, QMapboxGL *map)
+/*
+    Updates the feature of the batched \a item, only its properties unless
+    \a geometryChanged. The source of its batch is sent once per sync.
+*/
+void QGeoMapMapboxGLPrivate::updateBatchedFeature(QDeclarativeGeoMapItemBase *item, bool geometryChanged)
 {
-    // FIXME: Optimal support for threaded rendering needs core changes
-    // in Mapbox GL Native. Meanwhile we need to set a timer to update
-    // the map until all the resources are loaded, which is not exactly
-    // battery friendly, because might trigger more paints than we need.
-    if (!m_warned) {
-        m_threadedRendering = window->openglContext()->thread() != QCoreApplication::instance()->thread();
+    auto it = m_batchedFeatures.find(item);
+    if (geometryChanged || it == m_batchedFeatures.end())
+        m_batchedFeatures.insert(item, QMapboxGLStyleChange::batchedFeature(item));
+    else
+        it->properties = QMapboxGLStyleChange::batchedFeatureProperties(item);
 
-        if (m_threadedRendering) {
-            qWarning() << "Threaded rendering is not optimal in the Mapbox GL plugin.";
-        }
+    m_dirtyBatches.insert(QMapboxGLStyleChange::mapItemBatch(item));
+}
 
-        m_warned = true;
-    }
+/*
+    Takes note of \a changes of \a item, so that several changes of an item
+    between two frames, like a path updated for every new position, cost only
+    one update of its source or properties.
+*/
+void QGeoMapMapboxGLPrivate::markMapItemChanged(QDeclarativeGeoMapItemBase *item, int changes)
+{
+    Q_Q(QGeoMapMapboxGL);
 
-    if (m_threadedRendering) {
-        if (!map->isFullyLoaded()) {
-            QMetaObject::invokeMethod(&m_refresh, "start", Qt::QueuedConnection);
-        } else {
-            QMetaObject::invokeMethod(&m_refresh, "stop", Qt::QueuedConnection);
+    m_mapItemChanges[item] |= changes;
+    emit q->sgNodeChanged();
+}
+
+void QGeoMapMapboxGLPrivate::syncStyleChanges(QMapboxGL *map)
+{
+    for (auto it = m_mapItemChanges.cbegin(), end = m_mapItemChanges.cend(); it != end; ++it) {
+        QDeclarativeGeoMapItemBase *item = it.key();
+        if (m_batchMapItems) {
+            updateBatchedFeature(item, it.value() & GeometryChange);
+            continue;
+        }
+        if (it.value() & GeometryChange)
+            m_styleChanges << QMapboxGLStyleAddSource::fromMapItem(item);
+        if (it.value() & PaintChange)
+            m_styleChanges << QMapboxGLStyleSetPaintProperty::fromMapItem(item);
+        if (it.value() & LayoutChange)
+            m_styleChanges << QMapboxGLStyleSetLayoutProperty::fromMapItem(item);
+    }
+    m_mapItemChanges.clear();
+
+    // The features are kept in the order the items were added in
+    for (const QString &batch : qAsConst(m_dirtyBatches)) {
+        QList<QMapbox::Feature> features;
+        for (QDeclarativeGeoMapItemBase *item : qAsConst(m_mapItems)) {
+            const auto it = m_batchedFeatures.constFind(item);
+            if (it != m_batchedFeatures.constEnd() && QMapboxGLStyleChange::mapItemBatch(item) == batch)
+                features.append(it.value());
         }
+        m_styleChanges << QMapboxGLStyleAddSource::fromFeatures(batch, features);
     }
+    m_dirtyBatches.clear();
+
+    for (const auto& change : m_styleChanges) {
+        change->apply(map);
+    }
+
+    m_styleChanges.clear();
 }
 
 /*
@@ -369,10 +422,6 @@ void QGeoMapMapboxGLPrivate::threadedRenderingHack(QQuickWindow *window, QMapbox
 QGeoMapMapboxGL::QGeoMapMapboxGL(QGeoMappingManagerEngineMapboxGL *engine, QObject *parent)
     :   QGeoMap(*new QGeoMapMapboxGLPrivate(engine), parent), m_engine(engine)
 {
-    Q_D(QGeoMapMapboxGL);
-
-    connect(&d->m_refresh, &QTimer::timeout, this, &QGeoMap::sgNodeChanged);
-    d->m_refresh.setInterval(250);
 }
 
 QGeoMapMapboxGL::~QGeoMapMapboxGL()
@@ -414,6 +463,12 @@ void QGeoMapMapboxGL::setMapItemsBefore(const QString &before)
     d->m_mapItemsBefore = before;
 }
 
+void QGeoMapMapboxGL::setBatchMapItems(bool batch)
+{
+    Q_D(QGeoMapMapboxGL);
+    d->m_batchMapItems = batch;
+}
+
 QGeoMap::Capabilities QGeoMapMapboxGL::capabilities() const
 {
     return Capabilities(SupportsVisibleRegion
@@ -422,6 +477,21 @@ QGeoMap::Capabilities QGeoMapMapboxGL::capabilities() const
                         | SupportsVisibleArea );
 }
 
+/*
+    Requests a frame for the QMapboxGL, which asks for one whenever a resource
+    it waits for arrives or an animation goes on. Called on the GUI thread,
+    through a queued connection when the QMapboxGL lives in the render thread
+    with the threaded render loop. The update is queued as well, since with the
+    other loops the request can come from within rendering. Several requests
+    before the next frame make only one update.
+*/
+void QGeoMapMapboxGL::scheduleRender()
+{
+    Q_D(QGeoMapMapboxGL);
+    if (d->m_renderScheduled.testAndSetRelaxed(0, 1))
+        QMetaObject::invokeMethod(this, &QGeoMap::sgNodeChanged, Qt::QueuedConnection);
+}
+
 QSGNode *QGeoMapMapboxGL::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
 {
     Q_D(QGeoMapMapboxGL);
@@ -434,12 +504,23 @@ void QGeoMapMapboxGL::onMapChanged(QMapboxGL::MapChange change)
 
     if (change == QMapboxGL::MapChangeDidFinishLoadingStyle || change == QMapboxGL::MapChangeDidFailLoadingMap) {
         d->m_styleLoaded = true;
+        if (!d->m_styleChanges.isEmpty() || !d->m_dirtyBatches.isEmpty() || !d->m_mapItemChanges.isEmpty())
+            emit sgNodeChanged();
     } else if (change == QMapboxGL::MapChangeWillStartLoadingMap) {
         d->m_styleLoaded = false;
         d->m_styleChanges.clear();
-
-        for (QDeclarativeGeoMapItemBase *item : d->m_mapItems)
-            d->m_styleChanges << QMapboxGLStyleChange::addMapItem(item, d->m_mapItemsBefore);
+        d->m_batchesAdded = false;
+
+        for (QDeclarativeGeoMapItemBase *item : d->m_mapItems) {
+            if (!item) // removed
+                continue;
+            if (d->m_batchMapItems) {
+                d->addMapItemBatches();
+                d->m_dirtyBatches.insert(QMapboxGLStyleChange::mapItemBatch(item));
+            } else {
+                d->m_styleChanges << QMapboxGLStyleChange::addMapItem(item, d->m_mapItemsBefore);
+            }
+        }
 
         for (QGeoMapParameter *param : d->m_mapParameters)
             d->m_styleChanges << QMapboxGLStyleChange::addMapParameter(param);
@@ -451,10 +532,7 @@ void QGeoMapMapboxGL::onMapItemPropertyChanged()
     Q_D(QGeoMapMapboxGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender());
-    d->m_styleChanges << QMapboxGLStyleSetPaintProperty::fromMapItem(item);
-    d->m_styleChanges << QMapboxGLStyleSetLayoutProperty::fromMapItem(item);
-
-    emit sgNodeChanged();
+    d->markMapItemChanged(item, QGeoMapMapboxGLPrivate::PaintChange | QGeoMapMapboxGLPrivate::LayoutChange);
 }
 
 void QGeoMapMapboxGL::onMapItemSubPropertyChanged()
@@ -462,9 +540,7 @@ void QGeoMapMapboxGL::onMapItemSubPropertyChanged()
     Q_D(QGeoMapMapboxGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender()->parent());
-    d->m_styleChanges << QMapboxGLStyleSetPaintProperty::fromMapItem(item);
-
-    emit sgNodeChanged();
+    d->markMapItemChanged(item, QGeoMapMapboxGLPrivate::PaintChange);
 }
 
 void QGeoMapMapboxGL::onMapItemUnsupportedPropertyChanged()
@@ -478,9 +554,7 @@ void QGeoMapMapboxGL::onMapItemGeometryChanged()
     Q_D(QGeoMapMapboxGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender());
-    d->m_styleChanges << QMapboxGLStyleAddSource::fromMapItem(item);
-
-    emit sgNodeChanged();
+    d->markMapItemChanged(item, QGeoMapMapboxGLPrivate::GeometryChange);
 }
 
 void QGeoMapMapboxGL::onParameterPropertyUpdated(QGeoMapParameter *param, const char *)
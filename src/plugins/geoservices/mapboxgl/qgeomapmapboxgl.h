@@ -57,8 +57,11 @@ public:
     void setMapboxGLSettings(const QMapboxGLSettings &, bool useChinaEndpoint);
     void setUseFBO(bool);
     void setMapItemsBefore(const QString &);
+    void setBatchMapItems(bool);
     Capabilities capabilities() const override;
 
+    void scheduleRender();
+
 private Q_SLOTS:
     // QMapboxGL
     void onMapChanged(QMapboxGL::MapChange);
@@ -41,9 +41,10 @@
 #include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QSharedPointer>
-#include <QtCore/QTimer>
+#include <QtCore/QAtomicInt>
 #include <QtCore/QVariant>
 #include <QtCore/QRectF>
+#include <QtCore/QSet>
 #include <QtLocation/private/qgeomap_p_p.h>
 #include <QtLocation/private/qgeomapparameter_p.h>
 
@@ -82,17 +83,33 @@ public:
     bool m_useFBO = true;
     bool m_developmentMode = false;
     QString m_mapItemsBefore;
+    bool m_batchMapItems = false;
 
-    QTimer m_refresh;
-    bool m_shouldRefresh = true;
-    bool m_warned = false;
-    bool m_threadedRendering = false;
+    QAtomicInt m_renderScheduled; // reset in the sync, on the render thread
     bool m_styleLoaded = false;
 
     SyncStates m_syncState = NoSync;
 
     QList<QSharedPointer<QMapboxGLStyleChange>> m_styleChanges;
 
+    // Changes of the map items, turned into style changes once per sync
+    enum MapItemChange : int {
+        PaintChange     = 1 << 0,
+        LayoutChange    = 1 << 1,
+        GeometryChange  = 1 << 2
+    };
+    QHash<QDeclarativeGeoMapItemBase *, int> m_mapItemChanges;
+
+    void markMapItemChanged(QDeclarativeGeoMapItemBase *item, int changes);
+
+    // Map items merged into shared sources, see QMapboxGLStyleChange::addMapItemBatches()
+    QHash<QDeclarativeGeoMapItemBase *, QMapbox::Feature> m_batchedFeatures;
+    QSet<QString> m_dirtyBatches;
+    bool m_batchesAdded = false;
+
+    void addMapItemBatches();
+    void updateBatchedFeature(QDeclarativeGeoMapItemBase *item, bool geometryChanged);
+
 protected:
     void changeViewportSize(const QSize &size) override;
     void changeCameraData(const QGeoCameraData &oldCameraData) override;
@@ -105,7 +122,6 @@ private:
     Q_DISABLE_COPY(QGeoMapMapboxGLPrivate);
 
     void syncStyleChanges(QMapboxGL *map);
-    void threadedRenderingHack(QQuickWindow *window, QMapboxGL *map);
 
     QRectF m_visibleArea;
 };
@@ -173,6 +173,10 @@ QGeoMappingManagerEngineMapboxGL::QGeoMappingManagerEngineMapboxGL(const QVarian
         m_mapItemsBefore = parameters.value(QStringLiteral("mapboxgl.mapping.items.insert_before")).toString();
     }
 
+    if (parameters.contains(QStringLiteral("mapboxgl.mapping.items.batched"))) {
+        m_batchMapItems = parameters.value(QStringLiteral("mapboxgl.mapping.items.batched")).toBool();
+    }
+
     engineInitialized();
 }
 
@@ -186,6 +190,7 @@ QGeoMap *QGeoMappingManagerEngineMapboxGL::createMap()
     map->setMapboxGLSettings(m_settings, m_useChinaEndpoint);
     map->setUseFBO(m_useFBO);
     map->setMapItemsBefore(m_mapItemsBefore);
+    map->setBatchMapItems(m_batchMapItems);
 
     return map;
 }
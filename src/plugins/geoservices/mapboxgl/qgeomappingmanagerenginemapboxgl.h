@@ -61,6 +61,7 @@ private:
     bool m_useFBO = true;
     bool m_useChinaEndpoint = false;
     QString m_mapItemsBefore;
+    bool m_batchMapItems = false;
 };
 
 QT_END_NAMESPACE
@@ -37,6 +37,9 @@
 #include "qmapboxglstylechange_p.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QMetaProperty>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QStringList>
@@ -180,6 +183,76 @@ QMapbox::Feature featureFromMapItem(QDeclarativeGeoMapItemBase *item)
     }
 }
 
+QString fillBatchId()
+{
+    return QStringLiteral("QtLocation-fills");
+}
+
+QString lineBatchId()
+{
+    return QStringLiteral("QtLocation-lines");
+}
+
+template <typename FillItem>
+void addFillProperties(FillItem *item, QVariantMap &properties)
+{
+    properties[QStringLiteral("color")] = item->color().name();
+    properties[QStringLiteral("opacity")] = item->color().alphaF() * item->mapItemOpacity();
+    properties[QStringLiteral("outline-color")] = item->border()->color().name();
+}
+
+QVariantList getProperty(const QString &name)
+{
+    return QVariantList { QStringLiteral("get"), name };
+}
+
+QJsonArray coordinatesToJson(const QMapbox::Coordinates &coordinates)
+{
+    QJsonArray points;
+    for (const QMapbox::Coordinate &coordinate : coordinates)
+        points.append(QJsonArray { coordinate.second, coordinate.first });
+    return points;
+}
+
+QByteArray featuresToGeoJson(const QList<QMapbox::Feature> &features)
+{
+    QJsonArray jsonFeatures;
+    for (const QMapbox::Feature &feature : features) {
+        if (feature.geometry.isEmpty() || feature.geometry.first().isEmpty())
+            continue;
+        const QMapbox::CoordinatesCollection &collection = feature.geometry.first();
+
+        QJsonObject geometry;
+        switch (feature.type) {
+        case QMapbox::Feature::LineStringType:
+            geometry[QStringLiteral("type")] = QStringLiteral("LineString");
+            geometry[QStringLiteral("coordinates")] = coordinatesToJson(collection.first());
+            break;
+        case QMapbox::Feature::PolygonType: {
+            QJsonArray rings;
+            for (const QMapbox::Coordinates &ring : collection)
+                rings.append(coordinatesToJson(ring));
+            geometry[QStringLiteral("type")] = QStringLiteral("Polygon");
+            geometry[QStringLiteral("coordinates")] = rings;
+        } break;
+        default:
+            continue;
+        }
+
+        QJsonObject json;
+        json[QStringLiteral("type")] = QStringLiteral("Feature");
+        json[QStringLiteral("id")] = feature.id.toString();
+        json[QStringLiteral("geometry")] = geometry;
+        json[QStringLiteral("properties")] = QJsonObject::fromVariantMap(feature.properties);
+        jsonFeatures.append(json);
+    }
+
+    QJsonObject collection;
+    collection[QStringLiteral("type")] = QStringLiteral("FeatureCollection");
+    collection[QStringLiteral("features")] = jsonFeatures;
+    return QJsonDocument(collection).toJson(QJsonDocument::Compact);
+}
+
 QList<QByteArray> getAllPropertyNamesList(QObject *object)
 {
     const QMetaObject *metaObject = object->metaObject();
@@ -267,6 +340,61 @@ QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleChange::removeMapItem(
     return changes;
 }
 
+QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleChange::addMapItemBatches(const QString &before)
+{
+    QList<QSharedPointer<QMapboxGLStyleChange>> changes;
+
+    for (const QString &batch : { fillBatchId(), lineBatchId() }) {
+        changes << QMapboxGLStyleAddSource::fromFeatures(batch, QList<QMapbox::Feature>());
+        changes << QMapboxGLStyleAddLayer::fromMapItemBatch(batch, before);
+        changes << QMapboxGLStyleSetPaintProperty::fromMapItemBatch(batch);
+        changes << QMapboxGLStyleSetLayoutProperty::fromMapItemBatch(batch);
+        changes << QMapboxGLStyleSetFilter::fromMapItemBatch(batch);
+    }
+
+    return changes;
+}
+
+QString QMapboxGLStyleChange::mapItemBatch(QDeclarativeGeoMapItemBase *item)
+{
+    return item->itemType() == QGeoMap::MapPolyline ? lineBatchId() : fillBatchId();
+}
+
+QMapbox::Feature QMapboxGLStyleChange::batchedFeature(QDeclarativeGeoMapItemBase *item)
+{
+    QMapbox::Feature feature = featureFromMapItem(item);
+    feature.properties = batchedFeatureProperties(item);
+    return feature;
+}
+
+QVariantMap QMapboxGLStyleChange::batchedFeatureProperties(QDeclarativeGeoMapItemBase *item)
+{
+    QVariantMap properties;
+    properties[QStringLiteral("visible")] = item->isVisible();
+
+    switch (item->itemType()) {
+    case QGeoMap::MapRectangle:
+        addFillProperties(static_cast<QDeclarativeRectangleMapItem *>(item), properties);
+        break;
+    case QGeoMap::MapCircle:
+        addFillProperties(static_cast<QDeclarativeCircleMapItem *>(item), properties);
+        break;
+    case QGeoMap::MapPolygon:
+        addFillProperties(static_cast<QDeclarativePolygonMapItem *>(item), properties);
+        break;
+    case QGeoMap::MapPolyline: {
+        QDeclarativeMapLineProperties *line = static_cast<QDeclarativePolylineMapItem *>(item)->line();
+        properties[QStringLiteral("color")] = line->color().name();
+        properties[QStringLiteral("opacity")] = line->color().alphaF() * item->mapItemOpacity();
+        properties[QStringLiteral("width")] = line->width();
+    } break;
+    default:
+        break;
+    }
+
+    return properties;
+}
+
 // QMapboxGLStyleSetLayoutProperty
 
 void QMapboxGLStyleSetLayoutProperty::apply(QMapboxGL *map)
@@ -319,6 +447,20 @@ QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleSetLayoutProperty::fro
     return changes;
 }
 
+QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleSetLayoutProperty::fromMapItemBatch(const QString &batch)
+{
+    QList<QSharedPointer<QMapboxGLStyleChange>> changes;
+    if (batch != lineBatchId())
+        return changes;
+
+    changes << QSharedPointer<QMapboxGLStyleChange>(
+        new QMapboxGLStyleSetLayoutProperty(batch, QStringLiteral("line-cap"), QStringLiteral("square")));
+    changes << QSharedPointer<QMapboxGLStyleChange>(
+        new QMapboxGLStyleSetLayoutProperty(batch, QStringLiteral("line-join"), QStringLiteral("bevel")));
+
+    return changes;
+}
+
 QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleSetLayoutProperty::fromMapItem(QDeclarativePolylineMapItem *item)
 {
     QList<QSharedPointer<QMapboxGLStyleChange>> changes;
@@ -395,6 +537,30 @@ QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleSetPaintProperty::from
     }
 }
 
+QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleSetPaintProperty::fromMapItemBatch(const QString &batch)
+{
+    QList<QSharedPointer<QMapboxGLStyleChange>> changes;
+    changes.reserve(3);
+
+    if (batch == lineBatchId()) {
+        changes << QSharedPointer<QMapboxGLStyleChange>(
+            new QMapboxGLStyleSetPaintProperty(batch, QStringLiteral("line-opacity"), getProperty(QStringLiteral("opacity"))));
+        changes << QSharedPointer<QMapboxGLStyleChange>(
+            new QMapboxGLStyleSetPaintProperty(batch, QStringLiteral("line-color"), getProperty(QStringLiteral("color"))));
+        changes << QSharedPointer<QMapboxGLStyleChange>(
+            new QMapboxGLStyleSetPaintProperty(batch, QStringLiteral("line-width"), getProperty(QStringLiteral("width"))));
+    } else {
+        changes << QSharedPointer<QMapboxGLStyleChange>(
+            new QMapboxGLStyleSetPaintProperty(batch, QStringLiteral("fill-opacity"), getProperty(QStringLiteral("opacity"))));
+        changes << QSharedPointer<QMapboxGLStyleChange>(
+            new QMapboxGLStyleSetPaintProperty(batch, QStringLiteral("fill-color"), getProperty(QStringLiteral("color"))));
+        changes << QSharedPointer<QMapboxGLStyleChange>(
+            new QMapboxGLStyleSetPaintProperty(batch, QStringLiteral("fill-outline-color"), getProperty(QStringLiteral("outline-color"))));
+    }
+
+    return changes;
+}
+
 QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLStyleSetPaintProperty::fromMapItem(QDeclarativeRectangleMapItem *item)
 {
     QList<QSharedPointer<QMapboxGLStyleChange>> changes;
@@ -528,6 +694,17 @@ QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddLayer::fromFeature(const Q
     return QSharedPointer<QMapboxGLStyleChange>(layer);
 }
 
+QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddLayer::fromMapItemBatch(const QString &batch, const QString &before)
+{
+    auto layer = new QMapboxGLStyleAddLayer();
+    layer->m_params[QStringLiteral("id")] = batch;
+    layer->m_params[QStringLiteral("source")] = batch;
+    layer->m_params[QStringLiteral("type")] = batch == lineBatchId() ? QStringLiteral("line") : QStringLiteral("fill");
+    layer->m_before = before;
+
+    return QSharedPointer<QMapboxGLStyleChange>(layer);
+}
+
 
 // QMapboxGLStyleRemoveLayer
 
@@ -600,6 +777,17 @@ QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddSource::fromFeature(const
     return QSharedPointer<QMapboxGLStyleChange>(source);
 }
 
+QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddSource::fromFeatures(const QString &id, const QList<QMapbox::Feature> &features)
+{
+    auto source = new QMapboxGLStyleAddSource();
+
+    source->m_id = id;
+    source->m_params[QStringLiteral("type")] = QStringLiteral("geojson");
+    source->m_params[QStringLiteral("data")] = featuresToGeoJson(features);
+
+    return QSharedPointer<QMapboxGLStyleChange>(source);
+}
+
 QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddSource::fromMapItem(QDeclarativeGeoMapItemBase *item)
 {
     return fromFeature(featureFromMapItem(item));
@@ -636,6 +824,15 @@ QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleSetFilter::fromMapParameter(Q
     return QSharedPointer<QMapboxGLStyleChange>(filter);
 }
 
+QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleSetFilter::fromMapItemBatch(const QString &batch)
+{
+    auto filter = new QMapboxGLStyleSetFilter();
+    filter->m_layer = batch;
+    filter->m_filter = QVariantList { QStringLiteral("=="), getProperty(QStringLiteral("visible")), true };
+
+    return QSharedPointer<QMapboxGLStyleChange>(filter);
+}
+
 
 // QMapboxGLStyleAddImage
 
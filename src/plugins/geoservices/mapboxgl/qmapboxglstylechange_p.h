@@ -61,6 +61,13 @@ public:
     static QList<QSharedPointer<QMapboxGLStyleChange>> addMapItem(QDeclarativeGeoMapItemBase *, const QString &before);
     static QList<QSharedPointer<QMapboxGLStyleChange>> removeMapItem(QDeclarativeGeoMapItemBase *);
 
+    // Map items merged into one source and layer per batch,
+    // with their paint properties in the feature properties
+    static QList<QSharedPointer<QMapboxGLStyleChange>> addMapItemBatches(const QString &before);
+    static QString mapItemBatch(QDeclarativeGeoMapItemBase *);
+    static QMapbox::Feature batchedFeature(QDeclarativeGeoMapItemBase *);
+    static QVariantMap batchedFeatureProperties(QDeclarativeGeoMapItemBase *);
+
     virtual void apply(QMapboxGL *map) = 0;
 };
 
@@ -69,6 +76,7 @@ class QMapboxGLStyleSetLayoutProperty : public QMapboxGLStyleChange
 public:
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapParameter(QGeoMapParameter *);
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItem(QDeclarativeGeoMapItemBase *);
+    static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItemBatch(const QString &batch);
 
     void apply(QMapboxGL *map) override;
 
@@ -88,6 +96,7 @@ class QMapboxGLStyleSetPaintProperty : public QMapboxGLStyleChange
 public:
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapParameter(QGeoMapParameter *);
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItem(QDeclarativeGeoMapItemBase *);
+    static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItemBatch(const QString &batch);
 
     void apply(QMapboxGL *map) override;
 
@@ -110,6 +119,7 @@ class QMapboxGLStyleAddLayer : public QMapboxGLStyleChange
 public:
     static QSharedPointer<QMapboxGLStyleChange> fromMapParameter(QGeoMapParameter *);
     static QSharedPointer<QMapboxGLStyleChange> fromFeature(const QMapbox::Feature &feature, const QString &before);
+    static QSharedPointer<QMapboxGLStyleChange> fromMapItemBatch(const QString &batch, const QString &before);
 
     void apply(QMapboxGL *map) override;
 
@@ -138,6 +148,7 @@ class QMapboxGLStyleAddSource : public QMapboxGLStyleChange
 public:
     static QSharedPointer<QMapboxGLStyleChange> fromMapParameter(QGeoMapParameter *);
     static QSharedPointer<QMapboxGLStyleChange> fromFeature(const QMapbox::Feature &feature);
+    static QSharedPointer<QMapboxGLStyleChange> fromFeatures(const QString &id, const QList<QMapbox::Feature> &features);
     static QSharedPointer<QMapboxGLStyleChange> fromMapItem(QDeclarativeGeoMapItemBase *);
 
     void apply(QMapboxGL *map) override;
@@ -166,6 +177,7 @@ class QMapboxGLStyleSetFilter : public QMapboxGLStyleChange
 {
 public:
     static QSharedPointer<QMapboxGLStyleChange> fromMapParameter(QGeoMapParameter *);
+    static QSharedPointer<QMapboxGLStyleChange> fromMapItemBatch(const QString &batch);
 
     void apply(QMapboxGL *map) override;
 
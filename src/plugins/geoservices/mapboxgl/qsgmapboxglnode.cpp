@@ -57,7 +57,8 @@ QSGMapboxGLTextureNode::QSGMapboxGLTextureNode(const QMapboxGLSettings &settings
 
     m_map.reset(new QMapboxGL(nullptr, settings, size.expandedTo(minTextureSize), pixelRatio));
 
-    QObject::connect(m_map.data(), &QMapboxGL::needsRendering, geoMap, &QGeoMap::sgNodeChanged);
+    // queued when the QMapboxGL lives in the render thread, so that none is delivered to a deleted map
+    QObject::connect(m_map.data(), &QMapboxGL::needsRendering, geoMap, &QGeoMapMapboxGL::scheduleRender);
     QObject::connect(m_map.data(), &QMapboxGL::copyrightsChanged, geoMap,
             static_cast<void (QGeoMap::*)(const QString &)>(&QGeoMapMapboxGL::copyrightsChanged));
 }
@@ -124,7 +125,7 @@ QSGMapboxGLRenderNode::QSGMapboxGLRenderNode(const QMapboxGLSettings &settings,
         : QSGRenderNode()
 {
     m_map.reset(new QMapboxGL(nullptr, settings, size, pixelRatio));
-    QObject::connect(m_map.data(), &QMapboxGL::needsRendering, geoMap, &QGeoMap::sgNodeChanged);
+    QObject::connect(m_map.data(), &QMapboxGL::needsRendering, geoMap, &QGeoMapMapboxGL::scheduleRender);
     QObject::connect(m_map.data(), &QMapboxGL::copyrightsChanged, geoMap,
             static_cast<void (QGeoMap::*)(const QString &)>(&QGeoMapMapboxGL::copyrightsChanged));
 }
@@ -42,6 +42,7 @@
 #include <QCoreApplication>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -84,7 +85,17 @@ void QPlaceContentReplyImpl::replyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
+    // Decoded on a worker thread, the results refer to the engine and are built here
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return QJsonDocument::fromJson(data);
+    }, [this](const QJsonDocument &document) {
+        documentParsed(document);
+    });
+}
+
+void QPlaceContentReplyImpl::documentParsed(const QJsonDocument &document)
+{
     if (!document.isObject()) {
         setError(ParseError, QCoreApplication::translate(NOKIA_PLUGIN_CONTEXT_NAME, PARSE_ERROR));
         return;
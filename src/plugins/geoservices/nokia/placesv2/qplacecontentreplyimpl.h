@@ -42,6 +42,7 @@
 
 QT_BEGIN_NAMESPACE
 
+class QJsonDocument;
 class QPlaceManager;
 class QPlaceManagerEngineNokiaV2;
 
@@ -60,6 +61,7 @@ private slots:
     void replyError(QNetworkReply::NetworkError error);
 
 private:
+    void documentParsed(const QJsonDocument &document);
     QPlaceManagerEngineNokiaV2 *m_engine;
 };
 
@@ -50,6 +50,7 @@
 #include <QtLocation/QPlaceEditorial>
 #include <QtLocation/QPlaceReview>
 #include <QtLocation/QPlaceUser>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -121,7 +122,17 @@ void QPlaceDetailsReplyImpl::replyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
+    // Decoded on a worker thread, the results refer to the engine and are built here
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return QJsonDocument::fromJson(data);
+    }, [this](const QJsonDocument &document) {
+        documentParsed(document);
+    });
+}
+
+void QPlaceDetailsReplyImpl::documentParsed(const QJsonDocument &document)
+{
     if (!document.isObject()) {
         setError(ParseError, QCoreApplication::translate(NOKIA_PLUGIN_CONTEXT_NAME, PARSE_ERROR));
         return;
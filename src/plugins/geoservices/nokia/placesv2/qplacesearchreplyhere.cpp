@@ -49,6 +49,7 @@
 #include <QtLocation/private/qplacesearchrequest_p.h>
 
 #include <QtCore/QDebug>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -90,7 +91,17 @@ void QPlaceSearchReplyHere::replyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
+    // Decoded on a worker thread, the results refer to the engine and are built here
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return QJsonDocument::fromJson(data);
+    }, [this](const QJsonDocument &document) {
+        documentParsed(document);
+    });
+}
+
+void QPlaceSearchReplyHere::documentParsed(const QJsonDocument &document)
+{
     if (!document.isObject()) {
         setError(ParseError, QCoreApplication::translate(NOKIA_PLUGIN_CONTEXT_NAME, PARSE_ERROR));
         return;
@@ -42,6 +42,7 @@
 
 QT_BEGIN_NAMESPACE
 
+class QJsonDocument;
 class QPlaceManagerEngineNokiaV2;
 class QPlaceResult;
 class QPlaceProposedSearchResult;
@@ -62,6 +63,7 @@ private slots:
     void replyError(QNetworkReply::NetworkError error);
 
 private:
+    void documentParsed(const QJsonDocument &document);
     QPlaceResult parsePlaceResult(const QJsonObject &item) const;
     QPlaceProposedSearchResult parseSearchResult(const QJsonObject &item) const;
 
@@ -41,6 +41,7 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -80,7 +81,17 @@ void QPlaceSearchSuggestionReplyImpl::replyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
+    // Decoded on a worker thread, the results refer to the engine and are built here
+    const QByteArray data = reply->readAll();
+    qParseReplyAsync(this, [data](const QGeoParseCancellation &) {
+        return QJsonDocument::fromJson(data);
+    }, [this](const QJsonDocument &document) {
+        documentParsed(document);
+    });
+}
+
+void QPlaceSearchSuggestionReplyImpl::documentParsed(const QJsonDocument &document)
+{
     if (!document.isObject()) {
         setError(ParseError, QCoreApplication::translate(NOKIA_PLUGIN_CONTEXT_NAME, PARSE_ERROR));
         emit error(error(), errorString());
@@ -42,6 +42,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QJsonDocument;
+
 class QPlaceSearchSuggestionReplyImpl : public QPlaceSearchSuggestionReply
 {
     Q_OBJECT
@@ -54,6 +56,9 @@ private slots:
     void setError(QPlaceReply::Error error_, const QString &errorString);
     void replyFinished();
     void replyError(QNetworkReply::NetworkError error);
+
+private:
+    void documentParsed(const QJsonDocument &document);
 };
 
 QT_END_NAMESPACE
@@ -40,10 +40,15 @@
 
 QT_BEGIN_NAMESPACE
 
+static const int kStaleTilesPerBatch = 64;
+static const int kStaleTileInterval = 100; // ms
+
 QGeoFileTileCacheNokia::QGeoFileTileCacheNokia(int ppi, const QString &directory, QObject *parent)
-    :QGeoFileTileCache(directory, parent)
+    :QGeoFileTileCache(directory, parent), m_mapVersion(-1), m_staleTilesListed(false)
 {
     m_ppi = QString::number(ppi) + QLatin1String("p");
+    m_staleTileTimer.setInterval(kStaleTileInterval);
+    connect(&m_staleTileTimer, &QTimer::timeout, this, &QGeoFileTileCacheNokia::removeStaleTiles);
 }
 
 QGeoFileTileCacheNokia::~QGeoFileTileCacheNokia()
@@ -51,6 +56,45 @@ QGeoFileTileCacheNokia::~QGeoFileTileCacheNokia()
 
 }
 
+/*
+    Tiles of other versions are only removed with \a removeStaleTiles, when the
+    map data did change, and not when the version is known from an earlier run.
+*/
+void QGeoFileTileCacheNokia::setMapVersion(int version, bool removeStaleTiles)
+{
+    if (version == m_mapVersion)
+        return;
+    m_mapVersion = version;
+    if (!removeStaleTiles)
+        return;
+    m_staleTiles.clear();
+    m_staleTilesListed = false;
+    m_staleTileTimer.start();
+}
+
+void QGeoFileTileCacheNokia::removeStaleTiles()
+{
+    if (!m_staleTilesListed) {
+        const QList<QGeoTileSpec> tiles = diskCache_.keys();
+        for (const QGeoTileSpec &spec : tiles) {
+            if (spec.version() != m_mapVersion)
+                m_staleTiles.append(spec);
+        }
+        m_staleTilesListed = true;
+    }
+
+    for (int i = 0; i < kStaleTilesPerBatch && !m_staleTiles.isEmpty(); ++i) {
+        const QGeoTileSpec spec = m_staleTiles.takeLast();
+        diskCache_.remove(spec, true);
+        memoryCache_.remove(spec);
+    }
+
+    if (m_staleTiles.isEmpty()) {
+        m_staleTileTimer.stop();
+        writeTileIndex();
+    }
+}
+
 QString QGeoFileTileCacheNokia::tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const
 {
     QString filename = spec.plugin();
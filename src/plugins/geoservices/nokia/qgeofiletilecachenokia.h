@@ -39,6 +39,8 @@
 
 #include <QtLocation/private/qgeofiletilecache_p.h>
 
+#include <QTimer>
+
 QT_BEGIN_NAMESPACE
 
 class QGeoFileTileCacheNokia : public QGeoFileTileCache
@@ -48,11 +50,21 @@ public:
     QGeoFileTileCacheNokia(int ppi, const QString &directory = QString(), QObject *parent = 0);
     ~QGeoFileTileCacheNokia();
 
+    void setMapVersion(int version, bool removeStaleTiles);
+
 protected:
+    void removeStaleTiles();
     virtual QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const override;
     virtual QGeoTileSpec filenameToTileSpec(const QString &filename) const override;
 
     QString m_ppi;
+
+    // Tiles of other map versions are removed from the disk cache a few at a time,
+    // while the texture cache keeps the recent ones as fallbacks for the map
+    int m_mapVersion;
+    bool m_staleTilesListed;
+    QList<QGeoTileSpec> m_staleTiles;
+    QTimer m_staleTileTimer;
 };
 
 QT_END_NAMESPACE
@@ -73,6 +73,14 @@ void QGeoMapReplyNokia::networkFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
+    setValidators(QGeoTileValidators::fromHttpHeaders(reply->rawHeaderPairs()));
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        // answer to a conditional request, the cached tile is still valid
+        setNotModified(true);
+        setFinished(true);
+        return;
+    }
+
     setMapImageData(reply->readAll());
     setMapImageFormat("png");
     setFinished(true);
@@ -63,48 +63,62 @@ QGeoTiledMapNokia::~QGeoTiledMapNokia() {}
 
 void QGeoTiledMapNokia::evaluateCopyrights(const QSet<QGeoTileSpec> &visibleTiles)
 {
-    const int spaceToLogo = 4;
-    const int blurRate = 1;
-    const int fontSize = 10;
-
     if (m_engine.isNull())
         return;
 
     const QString copyrightsString = m_engine->evaluateCopyrightsText(activeMapType(), cameraData().zoomLevel(), visibleTiles);
 
-    if (viewportWidth() > 0 && viewportHeight() > 0 && ((copyrightsString.isNull() && m_copyrightsSlab.isNull()) || copyrightsString != m_lastCopyrightsString)) {
-        QFont font("Sans Serif");
-        font.setPixelSize(fontSize);
-        font.setStyleHint(QFont::SansSerif);
-        font.setWeight(QFont::Bold);
-
-        QRect textBounds = QFontMetrics(font).boundingRect(0, 0, viewportWidth(), viewportHeight(), Qt::AlignBottom | Qt::AlignLeft | Qt::TextWordWrap, copyrightsString);
-
-        m_copyrightsSlab = QImage(m_logo.width() + textBounds.width() + spaceToLogo + blurRate * 2,
-                                qMax(m_logo.height(), textBounds.height() + blurRate * 2),
-                                QImage::Format_ARGB32_Premultiplied);
-        m_copyrightsSlab.fill(Qt::transparent);
-
-        QPainter painter(&m_copyrightsSlab);
-        painter.drawImage(QPoint(0, m_copyrightsSlab.height() - m_logo.height()), m_logo);
-        painter.setFont(font);
-        painter.setPen(QColor(0, 0, 0, 64));
-        painter.translate(spaceToLogo + m_logo.width(), -blurRate);
-        for (int x=-blurRate; x<=blurRate; ++x) {
-            for (int y=-blurRate; y<=blurRate; ++y) {
-                painter.drawText(x, y, textBounds.width(), m_copyrightsSlab.height(),
-                                 Qt::AlignBottom | Qt::AlignLeft | Qt::TextWordWrap,
-                                 copyrightsString);
-            }
-        }
-        painter.setPen(Qt::white);
-        painter.drawText(0, 0, textBounds.width(), m_copyrightsSlab.height(),
-                         Qt::AlignBottom | Qt::AlignLeft | Qt::TextWordWrap,
-                         copyrightsString);
-        painter.end();
+    // The text rarely changes while panning, and is drawn outside of the
+    // scene update, once for all the changes until then.
+    if (viewportWidth() <= 0 || viewportHeight() <= 0)
+        return;
+    if (copyrightsString == m_lastCopyrightsString && (!m_copyrightsSlab.isNull() || m_copyrightsRenderPending))
+        return;
+    m_lastCopyrightsString = copyrightsString;
+    if (!m_copyrightsRenderPending) {
+        m_copyrightsRenderPending = true;
+        QMetaObject::invokeMethod(this, &QGeoTiledMapNokia::renderCopyrights, Qt::QueuedConnection);
+    }
+}
 
-        m_lastCopyrightsString = copyrightsString;
+void QGeoTiledMapNokia::renderCopyrights()
+{
+    const int spaceToLogo = 4;
+    const int blurRate = 1;
+    const int fontSize = 10;
+
+    m_copyrightsRenderPending = false;
+    const QString &copyrightsString = m_lastCopyrightsString;
+
+    QFont font("Sans Serif");
+    font.setPixelSize(fontSize);
+    font.setStyleHint(QFont::SansSerif);
+    font.setWeight(QFont::Bold);
+
+    QRect textBounds = QFontMetrics(font).boundingRect(0, 0, viewportWidth(), viewportHeight(), Qt::AlignBottom | Qt::AlignLeft | Qt::TextWordWrap, copyrightsString);
+
+    m_copyrightsSlab = QImage(m_logo.width() + textBounds.width() + spaceToLogo + blurRate * 2,
+                            qMax(m_logo.height(), textBounds.height() + blurRate * 2),
+                            QImage::Format_ARGB32_Premultiplied);
+    m_copyrightsSlab.fill(Qt::transparent);
+
+    QPainter painter(&m_copyrightsSlab);
+    painter.drawImage(QPoint(0, m_copyrightsSlab.height() - m_logo.height()), m_logo);
+    painter.setFont(font);
+    painter.setPen(QColor(0, 0, 0, 64));
+    painter.translate(spaceToLogo + m_logo.width(), -blurRate);
+    for (int x=-blurRate; x<=blurRate; ++x) {
+        for (int y=-blurRate; y<=blurRate; ++y) {
+            painter.drawText(x, y, textBounds.width(), m_copyrightsSlab.height(),
+                             Qt::AlignBottom | Qt::AlignLeft | Qt::TextWordWrap,
+                             copyrightsString);
+        }
     }
+    painter.setPen(Qt::white);
+    painter.drawText(0, 0, textBounds.width(), m_copyrightsSlab.height(),
+                     Qt::AlignBottom | Qt::AlignLeft | Qt::TextWordWrap,
+                     copyrightsString);
+    painter.end();
 
     emit copyrightsChanged(m_copyrightsSlab);
 }
@@ -62,9 +62,12 @@ public:
     void evaluateCopyrights(const QSet<QGeoTileSpec> &visibleTiles);
 
 private:
+    void renderCopyrights();
+
     QImage m_logo;
     QImage m_copyrightsSlab;
     QString m_lastCopyrightsString;
+    bool m_copyrightsRenderPending = false;
     QPointer<QGeoTiledMappingManagerEngineNokia> m_engine;
 
     Q_DISABLE_COPY(QGeoTiledMapNokia)
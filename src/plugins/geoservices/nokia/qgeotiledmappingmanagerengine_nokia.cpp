@@ -53,6 +53,8 @@
 
 QT_BEGIN_NAMESPACE
 
+static const int MaxCopyrightsZoomLevel = 30;
+
 QGeoTiledMappingManagerEngineNokia::QGeoTiledMappingManagerEngineNokia(
     QGeoNetworkAccessManager *networkManager,
     const QVariantMap &parameters,
@@ -117,6 +119,8 @@ QGeoTiledMappingManagerEngineNokia::QGeoTiledMappingManagerEngineNokia(
     setSupportedMapTypes(types);
 
     QGeoTileFetcherNokia *fetcher = new QGeoTileFetcherNokia(parameters, networkManager, this, tileSize(), ppi);
+    if (parameters.contains(QStringLiteral("here.mapping.max_concurrent_requests")))
+        fetcher->setMaximumConcurrentRequests(parameters.value(QStringLiteral("here.mapping.max_concurrent_requests")).toInt());
     setTileFetcher(fetcher);
 
     /* TILE CACHE */
@@ -197,6 +201,8 @@ QGeoTiledMappingManagerEngineNokia::QGeoTiledMappingManagerEngineNokia(
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
 
     setTileCache(tileCache);
@@ -264,6 +270,7 @@ void QGeoTiledMappingManagerEngineNokia::loadCopyrightsDescriptorsFromJson(const
     QJsonObject jsonObj = doc.object();
 
     m_copyrights.clear();
+    m_copyrightsByZoom.clear();
     for (auto it = jsonObj.constBegin(), end = jsonObj.constEnd(); it != end; ++it) {
         QList<CopyrightDesc> copyrightDescList;
 
@@ -293,6 +300,19 @@ void QGeoTiledMappingManagerEngineNokia::loadCopyrightsDescriptorsFromJson(const
             copyrightDescList << copyrightDesc;
         }
         m_copyrights[it.key()] = copyrightDescList;
+
+        // the last level also takes the zoom levels above it
+        QVector<QVector<int> > byZoom(MaxCopyrightsZoomLevel + 1);
+        for (int level = 0; level <= MaxCopyrightsZoomLevel; ++level) {
+            for (int descIndex = 0; descIndex < copyrightDescList.count(); ++descIndex) {
+                const CopyrightDesc &desc = copyrightDescList.at(descIndex);
+                if (desc.maxLevel >= level
+                        && (desc.minLevel <= level + 1 || level == MaxCopyrightsZoomLevel)) {
+                    byZoom[level].append(descIndex);
+                }
+            }
+        }
+        m_copyrightsByZoom[it.key()] = byZoom;
     }
 }
 
@@ -325,6 +345,7 @@ void QGeoTiledMappingManagerEngineNokia::updateVersion(const QJsonObject &newVer
 
         saveMapVersion();
         setTileVersion(m_mapVersion.version());
+        static_cast<QGeoFileTileCacheNokia *>(tileCache())->setMapVersion(m_mapVersion.version(), true);
     }
 }
 
@@ -361,7 +382,9 @@ void QGeoTiledMappingManagerEngineNokia::loadMapVersion()
 
     m_mapVersion.setVersion(object[QStringLiteral("version")].toInt());
     m_mapVersion.setVersionData(object[QStringLiteral("data")].toObject());
+    // no map exists yet to be told, they take the version from the engine when created
     setTileVersion(m_mapVersion.version());
+    static_cast<QGeoFileTileCacheNokia *>(tileCache())->setMapVersion(m_mapVersion.version(), false);
 }
 
 QString QGeoTiledMappingManagerEngineNokia::evaluateCopyrightsText(const QGeoMapType mapType,
@@ -409,35 +432,41 @@ QString QGeoTiledMappingManagerEngineNokia::evaluateCopyrightsText(const QGeoMap
         viewport.setBottomRight(QWebMercator::mercatorToCoord(pt));
     }
 
-    // TODO: the following invalidation detection algorithm may be improved later.
-    QList<CopyrightDesc> descriptorList = m_copyrights[ getBaseScheme(mapType.mapId()) ];
-    CopyrightDesc *descriptor;
-    int descIndex, boxIndex;
-    QString copyrightsText;
-    QSet<QString> copyrightStrings;
-
-    for (descIndex = 0; descIndex < descriptorList.count(); descIndex++) {
-        if (descriptorList[descIndex].minLevel <= zoomLevel && zoomLevel <= descriptorList[descIndex].maxLevel) {
-            descriptor = &descriptorList[descIndex];
-
-            for (boxIndex = 0; boxIndex < descriptor->boxes.count(); boxIndex++) {
-                QGeoRectangle box = descriptor->boxes[boxIndex];
+    // Only the descriptors of the zoom level are looked at. The labels are
+    // kept in the order of the descriptors, so that the same labels always
+    // make the same text.
+    const QString scheme = getBaseScheme(mapType.mapId());
+    const QList<CopyrightDesc> descriptorList = m_copyrights.value(scheme);
+    const QVector<QVector<int> > byZoom = m_copyrightsByZoom.value(scheme);
+    if (byZoom.isEmpty())
+        return QString();
+    const int level = qBound(0, int(qFloor(zoomLevel)), byZoom.count() - 1);
+
+    QStringList labels;
+    for (int descIndex : byZoom.at(level)) {
+        const CopyrightDesc &descriptor = descriptorList.at(descIndex);
+        if (zoomLevel < descriptor.minLevel || zoomLevel > descriptor.maxLevel
+                || labels.contains(descriptor.label)) {
+            continue;
+        }
 
-                if (box.intersects(viewport)) {
-                    copyrightStrings.insert(descriptor->label);
-                    break;
-                }
+        bool intersects = descriptor.boxes.isEmpty();
+        for (const QGeoRectangle &box : descriptor.boxes) {
+            if (box.intersects(viewport)) {
+                intersects = true;
+                break;
             }
-            if (!descriptor->boxes.count())
-                copyrightStrings.insert(descriptor->label);
         }
+        if (intersects)
+            labels.append(descriptor.label);
     }
 
-    foreach (const QString &copyrightString, copyrightStrings) {
+    QString copyrightsText;
+    for (const QString &label : qAsConst(labels)) {
         if (copyrightsText.length())
             copyrightsText += QLatin1Char('\n');
         copyrightsText += copyrightSymbol;
-        copyrightsText += copyrightString;
+        copyrightsText += label;
     }
 
     return copyrightsText;
@@ -45,6 +45,7 @@
 #include <QGeoServiceProvider>
 
 #include <QList>
+#include <QVector>
 #include <QHash>
 #include <QSet>
 
@@ -99,6 +100,8 @@ private:
     void loadMapVersion();
 
     QHash<QString, QList<CopyrightDesc> > m_copyrights;
+    // for each scheme and integer zoom level, the descriptors that may apply
+    QHash<QString, QVector<QVector<int> > > m_copyrightsByZoom;
     QHash<int, QString> m_mapSchemes;
     QGeoMapVersion m_mapVersion;
 
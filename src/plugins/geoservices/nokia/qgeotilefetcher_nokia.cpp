@@ -115,6 +115,11 @@ QGeoTiledMapReply *QGeoTileFetcherNokia::getTileImage(const QGeoTileSpec &spec)
     QNetworkRequest netRequest((QUrl(rawRequest))); // The extra pair of parens disambiguates this from a function declaration
     netRequest.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
 
+    const QGeoTileValidators validators = tileValidators(spec);
+    if (!validators.entityTag.isEmpty())
+        netRequest.setRawHeader("If-None-Match", validators.entityTag);
+    if (!validators.lastModified.isEmpty())
+        netRequest.setRawHeader("If-Modified-Since", validators.lastModified);
     QNetworkReply *netReply = m_networkManager->get(netRequest);
 
     QGeoTiledMapReply *mapReply = new QGeoMapReplyNokia(netReply, spec);
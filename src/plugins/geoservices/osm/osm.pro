@@ -19,7 +19,8 @@ HEADERS += \
     qplacecategoriesreplyosm.h \
     qgeotiledmaposm.h \
     qgeofiletilecacheosm.h \
-    qgeotileproviderosm.h
+    qgeotileproviderosm.h \
+    qgeonetworkaccessmanagerosm.h
 
 SOURCES += \
     qgeoserviceproviderpluginosm.cpp \
@@ -35,7 +36,8 @@ SOURCES += \
     qplacecategoriesreplyosm.cpp \
     qgeotiledmaposm.cpp \
     qgeofiletilecacheosm.cpp \
-    qgeotileproviderosm.cpp
+    qgeotileproviderosm.cpp \
+    qgeonetworkaccessmanagerosm.cpp
 
 
 OTHER_FILES += \
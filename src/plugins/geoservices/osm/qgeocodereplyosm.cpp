@@ -47,23 +47,30 @@
 #include <QtPositioning/QGeoLocation>
 #include <QtPositioning/QGeoRectangle>
 #include <QtLocation/private/qgeojson_p.h>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
 QGeoCodeReplyOsm::QGeoCodeReplyOsm(QNetworkReply *reply, bool includeExtraData, QObject *parent)
 :   QGeoCodeReply(*new QGeoCodeReplyOsmPrivate, parent), m_includeExtraData(includeExtraData)
 {
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
+    if (reply)
+        setNetworkReply(reply);
+    setLimit(1);
+    setOffset(0);
+}
+
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void QGeoCodeReplyOsm::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
     connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
             this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
     connect(this, &QGeoCodeReply::aborted, reply, &QNetworkReply::abort);
     connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
-    setLimit(1);
-    setOffset(0);
 }
 
 QGeoCodeReplyOsm::~QGeoCodeReplyOsm()
@@ -124,16 +131,10 @@ static void injectExtra(QGeoLocation &location, const QJsonObject &object)
     location.setExtendedAttributes(extra);
 }
 
-void QGeoCodeReplyOsm::networkReplyFinished()
+static QList<QGeoLocation> parseLocations(const QByteArray &data, bool includeExtraData)
 {
-    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
-    reply->deleteLater();
-
-    if (reply->error() != QNetworkReply::NoError)
-        return;
-
     QList<QGeoLocation> locations;
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
+    const QJsonDocument document = QJsonDocument::fromJson(data);
 
     if (document.isObject()) {
         QJsonObject object = document.object();
@@ -147,11 +148,9 @@ void QGeoCodeReplyOsm::networkReplyFinished()
         location.setCoordinate(coordinate);
         location.setAddress(parseAddressObject(object));
 
-        if (m_includeExtraData)
+        if (includeExtraData)
             injectExtra(location, object);
         locations.append(location);
-
-        setLocations(locations);
     } else if (document.isArray()) {
         QJsonArray results = document.array();
 
@@ -182,15 +181,33 @@ void QGeoCodeReplyOsm::networkReplyFinished()
             location.setCoordinate(coordinate);
             location.setBoundingBox(rectangle);
             location.setAddress(parseAddressObject(object));
-            if (m_includeExtraData)
+            if (includeExtraData)
                 injectExtra(location, object);
             locations.append(location);
         }
 
     }
 
-    setLocations(locations);
-    setFinished(true);
+    return locations;
+}
+
+void QGeoCodeReplyOsm::networkReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError)
+        return;
+
+    // Parsed on a worker thread, the reply finishes once the locations are built
+    const QByteArray data = reply->readAll();
+    const bool includeExtraData = m_includeExtraData;
+    qParseReplyAsync(this, [data, includeExtraData](const QGeoParseCancellation &) {
+        return parseLocations(data, includeExtraData);
+    }, [this](const QList<QGeoLocation> &locations) {
+        setLocations(locations);
+        setFinished(true);
+    });
 }
 
 void QGeoCodeReplyOsm::networkReplyError(QNetworkReply::NetworkError error)
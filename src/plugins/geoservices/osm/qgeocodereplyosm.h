@@ -54,6 +54,8 @@ public:
     explicit QGeoCodeReplyOsm(QNetworkReply *reply, bool includeExtraData = false, QObject *parent = 0);
     ~QGeoCodeReplyOsm();
 
+    void setNetworkReply(QNetworkReply *reply);
+
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qgeocodingmanagerengineosm.h"
+#include "qgeonetworkaccessmanagerosm.h"
 
 #include <QtCore/QVariantMap>
 #include <QtCore/QUrl>
@@ -74,7 +75,7 @@ static QString boundingBoxToLtrb(const QGeoRectangle &rect)
 QGeoCodingManagerEngineOsm::QGeoCodingManagerEngineOsm(const QVariantMap &parameters,
                                                        QGeoServiceProvider::Error *error,
                                                        QString *errorString)
-:   QGeoCodingManagerEngine(parameters), m_networkManager(new QNetworkAccessManager(this))
+:   QGeoCodingManagerEngine(parameters), m_networkManager(QGeoNetworkAccessManagerOsm::instance(parameters))
 {
     if (parameters.contains(QStringLiteral("osm.useragent")))
         m_userAgent = parameters.value(QStringLiteral("osm.useragent")).toString().toLatin1();
@@ -86,6 +87,12 @@ QGeoCodingManagerEngineOsm::QGeoCodingManagerEngineOsm(const QVariantMap &parame
     else
         m_urlPrefix = QStringLiteral("https://nominatim.openstreetmap.org");
 
+    // the usage policy of the public Nominatim server allows a request per second
+    const QString host = QUrl(m_urlPrefix).host();
+    if (host == QLatin1String("nominatim.openstreetmap.org"))
+        QGeoRequestScheduler::instance()->setRateLimit(host, 1, 1);
+    QGeoRequestScheduler::instance()->configure(host, parameters, QStringLiteral("osm.geocoding."));
+
     if (parameters.contains(QStringLiteral("osm.geocoding.debug_query")))
         m_debugQuery = parameters.value(QStringLiteral("osm.geocoding.debug_query")).toBool();
     if (parameters.contains(QStringLiteral("osm.geocoding.include_extended_data")))
@@ -129,9 +136,7 @@ QGeoCodeReply *QGeoCodingManagerEngineOsm::geocode(const QString &address, int l
     url.setQuery(query);
     request.setUrl(url);
 
-    QNetworkReply *reply = m_networkManager->get(request);
-
-    QGeoCodeReplyOsm *geocodeReply = new QGeoCodeReplyOsm(reply, m_includeExtraData, this);
+    QGeoCodeReplyOsm *geocodeReply = new QGeoCodeReplyOsm(nullptr, m_includeExtraData, this);
     if (m_debugQuery) {
         QGeoCodeReplyOsmPrivate *replyPrivate
                 = static_cast<QGeoCodeReplyOsmPrivate *>(QGeoCodeReplyPrivate::get(*geocodeReply));
@@ -142,6 +147,7 @@ QGeoCodeReply *QGeoCodingManagerEngineOsm::geocode(const QString &address, int l
     connect(geocodeReply, SIGNAL(error(QGeoCodeReply::Error,QString)),
             this, SLOT(replyError(QGeoCodeReply::Error,QString)));
 
+    sendRequest(geocodeReply, request, QGeoRequestScheduler::InteractivePriority);
     return geocodeReply;
 }
 
@@ -165,9 +171,7 @@ QGeoCodeReply *QGeoCodingManagerEngineOsm::reverseGeocode(const QGeoCoordinate &
     url.setQuery(query);
     request.setUrl(url);
 
-    QNetworkReply *reply = m_networkManager->get(request);
-
-    QGeoCodeReplyOsm *geocodeReply = new QGeoCodeReplyOsm(reply, m_includeExtraData, this);
+    QGeoCodeReplyOsm *geocodeReply = new QGeoCodeReplyOsm(nullptr, m_includeExtraData, this);
     if (m_debugQuery) {
         QGeoCodeReplyOsmPrivate *replyPrivate
                 = static_cast<QGeoCodeReplyOsmPrivate *>(QGeoCodeReplyPrivate::get(*geocodeReply));
@@ -178,9 +182,24 @@ QGeoCodeReply *QGeoCodingManagerEngineOsm::reverseGeocode(const QGeoCoordinate &
     connect(geocodeReply, SIGNAL(error(QGeoCodeReply::Error,QString)),
             this, SLOT(replyError(QGeoCodeReply::Error,QString)));
 
+    sendRequest(geocodeReply, request, QGeoRequestScheduler::BackgroundPriority);
     return geocodeReply;
 }
 
+/*
+    Sends \a request for \a reply once the server can take it.
+*/
+void QGeoCodingManagerEngineOsm::sendRequest(QGeoCodeReplyOsm *reply, const QNetworkRequest &request,
+                                             QGeoRequestScheduler::Priority priority)
+{
+    QGeoRequestScheduler::instance()->schedule(request.url().host(), reply, [this, reply, request]() {
+        if (reply->isFinished())
+            return false;
+        reply->setNetworkReply(m_networkManager->get(request));
+        return true;
+    }, priority);
+}
+
 void QGeoCodingManagerEngineOsm::replyFinished()
 {
     QGeoCodeReply *reply = qobject_cast<QGeoCodeReply *>(sender());
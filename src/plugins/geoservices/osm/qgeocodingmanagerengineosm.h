@@ -43,10 +43,14 @@
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/QGeoCodingManagerEngine>
 #include <QtLocation/QGeoCodeReply>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
+#include <QtCore/QSharedPointer>
 
 QT_BEGIN_NAMESPACE
 
-class QNetworkAccessManager;
+class QGeoNetworkAccessManagerOsm;
+class QGeoCodeReplyOsm;
+class QNetworkRequest;
 
 class QGeoCodingManagerEngineOsm : public QGeoCodingManagerEngine
 {
@@ -68,7 +72,10 @@ private Q_SLOTS:
     void replyError(QGeoCodeReply::Error errorCode, const QString &errorString);
 
 private:
-    QNetworkAccessManager *m_networkManager;
+    void sendRequest(QGeoCodeReplyOsm *reply, const QNetworkRequest &request,
+                     QGeoRequestScheduler::Priority priority);
+
+    QSharedPointer<QGeoNetworkAccessManagerOsm> m_networkManager;
     QByteArray m_userAgent;
     QString m_urlPrefix;
     bool m_debugQuery = false;
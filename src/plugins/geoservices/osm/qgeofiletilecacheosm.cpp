@@ -38,6 +38,8 @@
 #include <QtLocation/private/qgeotilespec_p.h>
 #include <QDir>
 #include <QDirIterator>
+#include <QFileSystemWatcher>
+#include <QTimer>
 #include <QPair>
 #include <QDateTime>
 #include <QtConcurrent>
@@ -49,7 +51,8 @@ QGeoFileTileCacheOsm::QGeoFileTileCacheOsm(const QVector<QGeoTileProviderOsm *>
                                            const QString &offlineDirectory,
                                            const QString &directory,
                                            QObject *parent)
-:   QGeoFileTileCache(directory, parent), m_offlineDirectory(offlineDirectory), m_offlineData(false), m_providers(providers)
+:   QGeoFileTileCache(directory, parent), m_offlineDirectory(offlineDirectory), m_offlineData(false)
+,   m_offlineWatcher(nullptr), m_offlineIndexTimer(nullptr), m_providers(providers)
 {
     m_highDpi.resize(providers.size());
     if (!offlineDirectory.isEmpty()) {
@@ -123,23 +126,48 @@ void QGeoFileTileCacheOsm::init()
     m_maxMapIdTimestamps.resize(max+1); // initializes to invalid QDateTime
 
     // .. by finding the newest file in each tileset (tileset = mapId).
-    QDir dir(directory_);
-    QStringList formats;
-    formats << QLatin1String("*.*");
-    QStringList files = dir.entryList(formats, QDir::Files);
-
-    for (const QString &tileFileName : files) {
-        QGeoTileSpec spec = filenameToTileSpec(tileFileName);
-        if (spec.zoom() == -1)
-            continue;
-        QFileInfo fi(dir.filePath(tileFileName));
-        if (fi.lastModified() > m_maxMapIdTimestamps[spec.mapId()])
-            m_maxMapIdTimestamps[spec.mapId()] = fi.lastModified();
+    // The tile index records modification times, so only scan the directory without it.
+    QVector<QGeoTileIndexEntry> entries;
+    if (readTileIndex(&entries)) {
+        for (const QGeoTileIndexEntry &entry : qAsConst(entries)) {
+            QGeoTileSpec spec = filenameToTileSpec(entry.filename);
+            if (spec.zoom() == -1)
+                continue;
+            const QDateTime lastModified = QDateTime::fromMSecsSinceEpoch(entry.lastModified);
+            if (lastModified > m_maxMapIdTimestamps[spec.mapId()])
+                m_maxMapIdTimestamps[spec.mapId()] = lastModified;
+        }
+    } else {
+        QDir dir(directory_);
+        QStringList formats;
+        formats << QLatin1String("*.*");
+        QStringList files = dir.entryList(formats, QDir::Files);
+
+        for (const QString &tileFileName : files) {
+            QGeoTileSpec spec = filenameToTileSpec(tileFileName);
+            if (spec.zoom() == -1)
+                continue;
+            QFileInfo fi(dir.filePath(tileFileName));
+            if (fi.lastModified() > m_maxMapIdTimestamps[spec.mapId()])
+                m_maxMapIdTimestamps[spec.mapId()] = fi.lastModified();
+        }
     }
 
     // Base class ::init()
     QGeoFileTileCache::init();
 
+    // Looking the tiles up in the offline directory would scan it for every tile
+    if (m_offlineData) {
+        indexOfflineDirectory();
+        m_offlineWatcher = new QFileSystemWatcher(QStringList(m_offlineDirectory.absolutePath()), this);
+        m_offlineIndexTimer = new QTimer(this);
+        m_offlineIndexTimer->setSingleShot(true);
+        m_offlineIndexTimer->setInterval(500); // tiles are usually copied in bulk
+        connect(m_offlineWatcher, &QFileSystemWatcher::directoryChanged,
+                m_offlineIndexTimer, QOverload<>::of(&QTimer::start));
+        connect(m_offlineIndexTimer, &QTimer::timeout, this, &QGeoFileTileCacheOsm::indexOfflineDirectory);
+    }
+
     for (QGeoTileProviderOsm * p: m_providers)
         clearObsoleteTiles(p);
 }
@@ -153,25 +181,53 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(cons
     if (providerId < 0 || providerId >= m_providers.size())
         return QSharedPointer<QGeoTileTexture>();
 
-    const QString fileName = tileSpecToFilename(spec, QStringLiteral("*"), providerId);
-    QStringList validTiles = m_offlineDirectory.entryList({fileName});
-    if (!validTiles.size())
+    // the key is the file name with an empty format, see indexOfflineDirectory()
+    const QString fileName = m_offlineTiles.value(tileSpecToFilename(spec, QString(), providerId));
+    if (fileName.isEmpty())
         return QSharedPointer<QGeoTileTexture>();
 
-    QFile file(m_offlineDirectory.absoluteFilePath(validTiles.first()));
+    const QString filePath = m_offlineDirectory.absoluteFilePath(fileName);
+    const QString format = QFileInfo(fileName).suffix();
+    if (asynchronousDecoding()) {
+        QSharedPointer<QGeoTileTexture> pending = decodeAsync(spec, QByteArray(), filePath, format);
+        if (pending)
+            return pending;
+    }
+
+    QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly))
         return QSharedPointer<QGeoTileTexture>();
     QByteArray bytes = file.readAll();
     file.close();
 
     QImage image;
-    if (!image.loadFromData(bytes)) {
+    QTextureFileData compressed;
+    if (!decodeTileImage(bytes, &image, &compressed, opaqueTextureFormat(), format)) {
         handleError(spec, QLatin1String("Problem with tile image"));
         return QSharedPointer<QGeoTileTexture>(0);
     }
 
-    addToMemoryCache(spec, bytes, QString());
-    return addToTextureCache(spec, image);
+    addToMemoryCache(spec, bytes, format);
+    return compressed.isValid() ? addToTextureCache(spec, compressed) : addToTextureCache(spec, image);
+}
+
+void QGeoFileTileCacheOsm::indexOfflineDirectory()
+{
+    m_offlineTiles.clear();
+    QDirIterator it(m_offlineDirectory.absolutePath(), QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        const QString fileName = it.fileName();
+        const int dot = fileName.lastIndexOf(QLatin1Char('.'));
+        if (dot < 0)
+            continue;
+
+        // Up to and including the dot, as tileSpecToFilename() writes it for an empty format.
+        // Of the same tile in several formats, keep the first by name, as the wildcard lookup did.
+        QString &indexed = m_offlineTiles[fileName.left(dot + 1)];
+        if (indexed.isEmpty() || fileName < indexed)
+            indexed = fileName;
+    }
 }
 
 void QGeoFileTileCacheOsm::dropTiles(int mapId)
@@ -195,6 +251,12 @@ void QGeoFileTileCacheOsm::dropTiles(int mapId)
 
 void QGeoFileTileCacheOsm::loadTiles(int mapId)
 {
+    QVector<QGeoTileIndexEntry> entries;
+    if (readTileIndex(&entries)) {
+        insertIndexedTiles(entries, mapId);
+        return;
+    }
+
     QStringList formats;
     formats << QLatin1String("*.*");
 
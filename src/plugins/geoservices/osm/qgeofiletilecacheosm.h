@@ -45,6 +45,9 @@
 
 QT_BEGIN_NAMESPACE
 
+class QFileSystemWatcher;
+class QTimer;
+
 class QGeoFileTileCacheOsm : public QGeoFileTileCache
 {
     Q_OBJECT
@@ -70,6 +73,7 @@ protected:
     QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const override;
     QGeoTileSpec filenameToTileSpec(const QString &filename) const override;
     QSharedPointer<QGeoTileTexture> getFromOfflineStorage(const QGeoTileSpec &spec);
+    void indexOfflineDirectory();
     void dropTiles(int mapId);
     void loadTiles(int mapId);
 
@@ -77,6 +81,10 @@ protected:
 
     QDir m_offlineDirectory;
     bool m_offlineData;
+    // the tile file names of the offline directory, keyed by the name without the format
+    QHash<QString, QString> m_offlineTiles;
+    QFileSystemWatcher *m_offlineWatcher;
+    QTimer *m_offlineIndexTimer;
     QVector<QGeoTileProviderOsm *> m_providers;
     QVector<bool> m_highDpi;
     QVector<QDateTime> m_maxMapIdTimestamps;
@@ -71,6 +71,22 @@ void QGeoMapReplyOsm::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError) // Already handled in networkReplyError
         return;
 
+    setValidators(QGeoTileValidators::fromHttpHeaders(reply->rawHeaderPairs()));
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        // answer to a conditional request, the cached tile is still valid
+        setNotModified(true);
+        setFinished(true);
+        return;
+    }
+
+    // the server may have picked another format from the Accept header of the request;
+    // the format names the file in the cache, and tells the decoder what to expect
+    const QByteArray type = reply->header(QNetworkRequest::ContentTypeHeader).toByteArray().toLower();
+    if (type.startsWith("image/webp"))
+        setMapImageFormat(QStringLiteral("webp"));
+    else if (type.startsWith("image/avif"))
+        setMapImageFormat(QStringLiteral("avif"));
+
     QByteArray a = reply->readAll();
 
     setMapImageData(a);
@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeonetworkaccessmanagerosm.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QThreadStorage>
+#include <QtNetwork/QNetworkDiskCache>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+#include <QtLocation/private/qabstractgeotilecache_p.h>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
+
+QT_BEGIN_NAMESPACE
+
+typedef QHash<QString, QWeakPointer<QGeoNetworkAccessManagerOsm> > QGeoNetworkAccessManagers;
+// by configuration, a network access manager can't be used from other threads
+static QThreadStorage<QGeoNetworkAccessManagers> managers;
+
+QGeoNetworkAccessManagerOsm::QGeoNetworkAccessManagerOsm(bool http2)
+:   m_http2(http2)
+{
+    // pauses the hosts answering with 429 or 503 for the engines
+    connect(this, &QNetworkAccessManager::finished, this, [](QNetworkReply *reply) {
+        QGeoRequestScheduler::instance()->reportResponse(reply->url().host(),
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                reply->rawHeader("Retry-After"));
+    });
+}
+
+/*
+    Returns the manager for the network parameters in \a parameters:
+    osm.network.http2 allows HTTP/2 for the requests that don't say otherwise,
+    and a positive osm.network.cache.size gives the manager a QNetworkDiskCache
+    of that many bytes next to the tile cache.
+*/
+QSharedPointer<QGeoNetworkAccessManagerOsm> QGeoNetworkAccessManagerOsm::instance(const QVariantMap &parameters)
+{
+    const bool http2 = parameters.value(QStringLiteral("osm.network.http2")).toBool();
+    const qint64 cacheSize = parameters.value(QStringLiteral("osm.network.cache.size")).toLongLong();
+    QString cacheDirectory;
+    if (cacheSize > 0) {
+        cacheDirectory = parameters.value(QStringLiteral("osm.mapping.cache.directory"),
+                                          QAbstractGeoTileCache::baseLocationCacheDirectory()
+                                          + QLatin1String("osm")).toString()
+                + QLatin1String("/network");
+    }
+
+    const QString key = QString::number(http2) + QLatin1Char(':') + QString::number(qMax<qint64>(0, cacheSize))
+            + QLatin1Char(':') + cacheDirectory;
+    QGeoNetworkAccessManagers &local = managers.localData();
+    QSharedPointer<QGeoNetworkAccessManagerOsm> manager = local.value(key).toStrongRef();
+    if (manager)
+        return manager;
+
+    for (auto it = local.begin(); it != local.end(); ) {
+        if (it->isNull())
+            it = local.erase(it);
+        else
+            ++it;
+    }
+
+    // replies may still be delivering signals when the last engine goes away
+    manager = QSharedPointer<QGeoNetworkAccessManagerOsm>(new QGeoNetworkAccessManagerOsm(http2),
+                                                          &QObject::deleteLater);
+    if (cacheSize > 0) {
+        QNetworkDiskCache *diskCache = new QNetworkDiskCache(manager.data());
+        diskCache->setCacheDirectory(cacheDirectory);
+        diskCache->setMaximumCacheSize(cacheSize);
+        manager->setCache(diskCache);
+    }
+    local.insert(key, manager);
+    return manager;
+}
+
+bool QGeoNetworkAccessManagerOsm::isHttp2Allowed() const
+{
+    return m_http2;
+}
+
+QNetworkReply *QGeoNetworkAccessManagerOsm::createRequest(Operation op, const QNetworkRequest &request,
+                                                          QIODevice *outgoingData)
+{
+    if (!m_http2 || request.attribute(QNetworkRequest::Http2AllowedAttribute).isValid())
+        return QNetworkAccessManager::createRequest(op, request, outgoingData);
+
+    // negotiated with ALPN, servers without HTTP/2 get HTTP/1.1 as before
+    QNetworkRequest http2Request(request);
+    http2Request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    return QNetworkAccessManager::createRequest(op, http2Request, outgoingData);
+}
+
+QT_END_NAMESPACE
@@ -1,6 +1,6 @@
 /****************************************************************************
 **
-** Copyright (C) 2015 The Qt Company Ltd.
+** Copyright (C) 2020 The Qt Company Ltd.
 ** Contact: http://www.qt.io/licensing/
 **
 ** This file is part of the QtLocation module of the Qt Toolkit.
@@ -33,46 +33,41 @@
 ** $QT_END_LICENSE$
 **
 ****************************************************************************/
-#ifndef QGEOTILESPEC_P_H
-#define QGEOTILESPEC_P_H
 
-//
-//  W A R N I N G
-//  -------------
-//
-// This file is not part of the Qt API.  It exists purely as an
-// implementation detail.  This header file may change from version to
-// version without notice, or even be removed.
-//
-// We mean it.
-//
+#ifndef QGEONETWORKACCESSMANAGEROSM_H
+#define QGEONETWORKACCESSMANAGEROSM_H
 
-#include <QString>
-#include <QSharedData>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVariantMap>
 
 QT_BEGIN_NAMESPACE
 
-class QGeoTileSpecPrivate : public QSharedData
+/*
+    The network access manager shared by the tile fetcher and the geocoding,
+    routing and places engines of the plugin, so that requests to the same
+    host reuse the connections. Engines created with the same network
+    parameters in the same thread get the same instance.
+*/
+class QGeoNetworkAccessManagerOsm : public QNetworkAccessManager
 {
+    Q_OBJECT
+
 public:
-    QGeoTileSpecPrivate();
-    QGeoTileSpecPrivate(const QGeoTileSpecPrivate &other);
-    QGeoTileSpecPrivate(const QString &plugin, int mapId, int zoom, int x, int y, int version);
-    ~QGeoTileSpecPrivate();
+    static QSharedPointer<QGeoNetworkAccessManagerOsm> instance(const QVariantMap &parameters);
+
+    bool isHttp2Allowed() const;
 
-    QGeoTileSpecPrivate &operator = (const QGeoTileSpecPrivate &other);
+protected:
+    QNetworkReply *createRequest(Operation op, const QNetworkRequest &request,
+                                 QIODevice *outgoingData = nullptr) override;
 
-    bool operator == (const QGeoTileSpecPrivate &rhs) const;
-    bool operator < (const QGeoTileSpecPrivate &rhs) const;
+private:
+    explicit QGeoNetworkAccessManagerOsm(bool http2);
 
-    QString plugin_;
-    int mapId_;
-    int zoom_;
-    int x_;
-    int y_;
-    int version_;
+    bool m_http2;
 };
 
 QT_END_NAMESPACE
 
-#endif // QGEOTILESPEC_P_H
+#endif // QGEONETWORKACCESSMANAGEROSM_H
@@ -39,6 +39,7 @@
 
 #include "qgeoroutereplyosm.h"
 #include "qgeoroutingmanagerengineosm.h"
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -46,10 +47,16 @@ QGeoRouteReplyOsm::QGeoRouteReplyOsm(QNetworkReply *reply, const QGeoRouteReques
                                      QObject *parent)
 :   QGeoRouteReply(request, parent)
 {
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
+    if (reply)
+        setNetworkReply(reply);
+}
+
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void QGeoRouteReplyOsm::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
     connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
             this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
@@ -72,9 +79,15 @@ void QGeoRouteReplyOsm::networkReplyFinished()
     QGeoRoutingManagerEngineOsm *engine = qobject_cast<QGeoRoutingManagerEngineOsm *>(parent());
     const QGeoRouteParser *parser = engine->routeParser();
 
-    QList<QGeoRoute> routes;
-    QString errorString;
-    QGeoRouteReply::Error error = parser->parseReply(routes, errorString, reply->readAll());
+    // Parsed on a worker thread, the reply finishes once the routes are built
+    parser->parseReplyAsync(reply->readAll(), this,
+                            [this](QGeoRouteReply::Error error, const QString &errorString, const QList<QGeoRoute> &routes) {
+        routesParsed(error, errorString, routes);
+    });
+}
+
+void QGeoRouteReplyOsm::routesParsed(QGeoRouteReply::Error error, const QString &errorString, QList<QGeoRoute> routes)
+{
     // Setting the request into the result
     for (QGeoRoute &route : routes) {
         route.setRequest(request());
@@ -100,4 +113,55 @@ void QGeoRouteReplyOsm::networkReplyError(QNetworkReply::NetworkError error)
     setError(QGeoRouteReply::CommunicationError, reply->errorString());
 }
 
+QGeoRouteMatrixReplyOsm::QGeoRouteMatrixReplyOsm(const QList<QGeoCoordinate> &origins,
+                                                 const QList<QGeoCoordinate> &destinations,
+                                                 const QGeoRouteRequest &request, QObject *parent)
+:   QGeoRouteMatrixReply(origins, destinations, request, parent)
+{
+}
+
+void QGeoRouteMatrixReplyOsm::setNetworkReply(QNetworkReply *reply)
+{
+    connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
+    connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
+            this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
+    connect(this, &QGeoRouteReply::aborted, reply, &QNetworkReply::abort);
+    connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
+}
+
+QGeoRouteMatrixReplyOsm::~QGeoRouteMatrixReplyOsm()
+{
+}
+
+void QGeoRouteMatrixReplyOsm::networkReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError)
+        return;
+
+    QGeoRoutingManagerEngineOsm *engine = qobject_cast<QGeoRoutingManagerEngineOsm *>(parent());
+    const QGeoRouteParserOsrmV5 *parser = engine->tableParser();
+
+    QVector<double> durations;
+    QVector<double> distances;
+    QString errorString;
+    const QGeoRouteReply::Error error = parser->parseTableReply(durations, distances, errorString, reply->readAll());
+    if (error == QGeoRouteReply::NoError) {
+        setBlock(0, 0, origins().size(), durations, distances);
+        setFinished(true);
+    } else {
+        setError(error, errorString);
+    }
+}
+
+void QGeoRouteMatrixReplyOsm::networkReplyError(QNetworkReply::NetworkError error)
+{
+    Q_UNUSED(error);
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+    setError(QGeoRouteReply::CommunicationError, reply->errorString());
+}
+
 QT_END_NAMESPACE
@@ -42,6 +42,7 @@
 
 #include <QtNetwork/QNetworkReply>
 #include <QtLocation/QGeoRouteReply>
+#include <QtLocation/QGeoRouteMatrixReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -54,6 +55,28 @@ public:
     QGeoRouteReplyOsm(QNetworkReply *reply, const QGeoRouteRequest &request, QObject *parent = 0);
     ~QGeoRouteReplyOsm();
 
+    void setNetworkReply(QNetworkReply *reply);
+
+private Q_SLOTS:
+    void networkReplyFinished();
+    void networkReplyError(QNetworkReply::NetworkError error);
+
+private:
+    void routesParsed(QGeoRouteReply::Error error, const QString &errorString, QList<QGeoRoute> routes);
+};
+
+class QGeoRouteMatrixReplyOsm : public QGeoRouteMatrixReply
+{
+    Q_OBJECT
+
+public:
+    QGeoRouteMatrixReplyOsm(const QList<QGeoCoordinate> &origins,
+                            const QList<QGeoCoordinate> &destinations,
+                            const QGeoRouteRequest &request, QObject *parent = 0);
+    ~QGeoRouteMatrixReplyOsm();
+
+    void setNetworkReply(QNetworkReply *reply);
+
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
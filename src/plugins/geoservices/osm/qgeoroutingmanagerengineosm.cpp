@@ -39,8 +39,10 @@
 
 #include "qgeoroutingmanagerengineosm.h"
 #include "qgeoroutereplyosm.h"
+#include "qgeonetworkaccessmanagerosm.h"
 #include "QtLocation/private/qgeorouteparserosrmv4_p.h"
 #include "QtLocation/private/qgeorouteparserosrmv5_p.h"
+#include "QtLocation/private/qgeorequestscheduler_p.h"
 
 #include <QtCore/QUrlQuery>
 
@@ -49,7 +51,7 @@
 QGeoRoutingManagerEngineOsm::QGeoRoutingManagerEngineOsm(const QVariantMap &parameters,
                                                          QGeoServiceProvider::Error *error,
                                                          QString *errorString)
-:   QGeoRoutingManagerEngine(parameters), m_networkManager(new QNetworkAccessManager(this))
+:   QGeoRoutingManagerEngine(parameters), m_networkManager(QGeoNetworkAccessManagerOsm::instance(parameters))
 {
     if (parameters.contains(QStringLiteral("osm.useragent")))
         m_userAgent = parameters.value(QStringLiteral("osm.useragent")).toString().toLatin1();
@@ -61,6 +63,8 @@ QGeoRoutingManagerEngineOsm::QGeoRoutingManagerEngineOsm(const QVariantMap &para
     else
         m_urlPrefix = QStringLiteral("http://router.project-osrm.org/route/v1/driving/");
         // for v4 it was "http://router.project-osrm.org/viaroute"
+    QGeoRequestScheduler::instance()->configure(QUrl(m_urlPrefix).host(), parameters,
+                                                QStringLiteral("osm.routing."));
 
     if (parameters.contains(QStringLiteral("osm.routing.apiversion"))
             && (parameters.value(QStringLiteral("osm.routing.apiversion")).toString().toLatin1() == QByteArray("v4")))
@@ -75,6 +79,14 @@ QGeoRoutingManagerEngineOsm::QGeoRoutingManagerEngineOsm(const QVariantMap &para
             m_routeParser->setTrafficSide(QGeoRouteParser::LeftHandTraffic);
     }
 
+    // The table service of the same server, unless set apart
+    if (parameters.contains(QStringLiteral("osm.routing.table.host")))
+        m_tableUrlPrefix = parameters.value(QStringLiteral("osm.routing.table.host")).toString();
+    else if (m_urlPrefix.contains(QLatin1String("/route/v1/")))
+        m_tableUrlPrefix = QString(m_urlPrefix).replace(QLatin1String("/route/v1/"), QLatin1String("/table/v1/"));
+    // the demo server gives up on tables of more than 100 coordinates
+    setRouteMatrixLimits(0, 0, 100);
+
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 }
@@ -90,14 +102,20 @@ QGeoRouteReply* QGeoRoutingManagerEngineOsm::calculateRoute(const QGeoRouteReque
 
     networkRequest.setUrl(routeParser()->requestUrl(request, m_urlPrefix));
 
-    QNetworkReply *reply = m_networkManager->get(networkRequest);
-
-    QGeoRouteReplyOsm *routeReply = new QGeoRouteReplyOsm(reply, request, this);
+    QGeoRouteReplyOsm *routeReply = new QGeoRouteReplyOsm(nullptr, request, this);
 
     connect(routeReply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(routeReply, SIGNAL(error(QGeoRouteReply::Error,QString)),
             this, SLOT(replyError(QGeoRouteReply::Error,QString)));
 
+    QGeoRequestScheduler::instance()->schedule(networkRequest.url().host(), routeReply,
+                                               [this, routeReply, networkRequest]() {
+        if (routeReply->isFinished())
+            return false;
+        routeReply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    });
+
     return routeReply;
 }
 
@@ -106,6 +124,40 @@ const QGeoRouteParser *QGeoRoutingManagerEngineOsm::routeParser() const
     return m_routeParser;
 }
 
+QGeoRouteMatrixReply *QGeoRoutingManagerEngineOsm::calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                                        const QList<QGeoCoordinate> &destinations,
+                                                                        const QGeoRouteRequest &request)
+{
+    // OSRM v4 had no table service this parses, null is reported as unsupported
+    if (!tableParser() || m_tableUrlPrefix.isEmpty())
+        return nullptr;
+
+    QNetworkRequest networkRequest;
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
+    networkRequest.setUrl(tableParser()->tableRequestUrl(origins, destinations, m_tableUrlPrefix));
+
+    QGeoRouteMatrixReplyOsm *matrixReply = new QGeoRouteMatrixReplyOsm(origins, destinations, request, this);
+
+    connect(matrixReply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    connect(matrixReply, SIGNAL(error(QGeoRouteReply::Error,QString)),
+            this, SLOT(replyError(QGeoRouteReply::Error,QString)));
+
+    QGeoRequestScheduler::instance()->schedule(networkRequest.url().host(), matrixReply,
+                                               [this, matrixReply, networkRequest]() {
+        if (matrixReply->isFinished())
+            return false;
+        matrixReply->setNetworkReply(m_networkManager->get(networkRequest));
+        return true;
+    });
+
+    return matrixReply;
+}
+
+const QGeoRouteParserOsrmV5 *QGeoRoutingManagerEngineOsm::tableParser() const
+{
+    return qobject_cast<const QGeoRouteParserOsrmV5 *>(m_routeParser);
+}
+
 void QGeoRoutingManagerEngineOsm::replyFinished()
 {
     QGeoRouteReply *reply = qobject_cast<QGeoRouteReply *>(sender());
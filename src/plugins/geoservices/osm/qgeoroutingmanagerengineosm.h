@@ -42,11 +42,14 @@
 
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/QGeoRoutingManagerEngine>
+#include <QtLocation/QGeoRouteMatrixReply>
 #include <QtLocation/private/qgeorouteparser_p.h>
+#include <QtCore/QSharedPointer>
 
 QT_BEGIN_NAMESPACE
 
-class QNetworkAccessManager;
+class QGeoNetworkAccessManagerOsm;
+class QGeoRouteParserOsrmV5;
 
 class QGeoRoutingManagerEngineOsm : public QGeoRoutingManagerEngine
 {
@@ -61,15 +64,21 @@ public:
     QGeoRouteReply *calculateRoute(const QGeoRouteRequest &request);
     const QGeoRouteParser *routeParser() const;
 
+    Q_INVOKABLE QGeoRouteMatrixReply *calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                           const QList<QGeoCoordinate> &destinations,
+                                                           const QGeoRouteRequest &request);
+    const QGeoRouteParserOsrmV5 *tableParser() const;
+
 private Q_SLOTS:
     void replyFinished();
     void replyError(QGeoRouteReply::Error errorCode, const QString &errorString);
 
 private:
-    QNetworkAccessManager *m_networkManager;
+    QSharedPointer<QGeoNetworkAccessManagerOsm> m_networkManager;
     QGeoRouteParser *m_routeParser;
     QByteArray m_userAgent;
     QString m_urlPrefix;
+    QString m_tableUrlPrefix;
 };
 
 QT_END_NAMESPACE
@@ -41,11 +41,13 @@
 #include "qgeotilefetcherosm.h"
 #include "qgeotiledmaposm.h"
 #include "qgeofiletilecacheosm.h"
+#include "qgeonetworkaccessmanagerosm.h"
 
 #include <QtLocation/private/qgeocameracapabilities_p.h>
 #include <QtLocation/private/qgeomaptype_p.h>
 #include <QtLocation/private/qgeotiledmap_p.h>
 #include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeopackedtilecache_p.h>
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkDiskCache>
@@ -82,7 +84,8 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
     diskCache->setMaximumCacheSize(100000000000); // enough to prevent diskCache to fiddle with tile cache. it's anyway used only for providers.
     nmCached->setCache(diskCache);
 
-    QNetworkAccessManager *nm = new QNetworkAccessManager(); // Gets owned by QGeoTileFetcherOsm
+    // shared with the other engines of the plugin
+    const QSharedPointer<QGeoNetworkAccessManagerOsm> nm = QGeoNetworkAccessManagerOsm::instance(parameters);
     QString domain = QStringLiteral("http://maps-redirect.qt.io/osm/5.8/");
     if (parameters.contains(QStringLiteral("osm.mapping.providersrepository.address"))) {
         QString customAddress = parameters.value(QStringLiteral("osm.mapping.providersrepository.address")).toString();
@@ -233,11 +236,21 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
     if (parameters.contains(QStringLiteral("osm.mapping.providersrepository.disabled")))
         disableRedirection = parameters.value(QStringLiteral("osm.mapping.providersrepository.disabled")).toBool();
 
+    qint64 definitionLifetime = 7 * 24 * 3600;
+    if (parameters.contains(QStringLiteral("osm.mapping.providersrepository.cache_lifetime"))) {
+        bool ok = false;
+        const qint64 lifetime = parameters.value(QStringLiteral("osm.mapping.providersrepository.cache_lifetime")).toString().toLongLong(&ok);
+        if (ok)
+            definitionLifetime = lifetime;
+    }
+
     for (QGeoTileProviderOsm * provider: qAsConst(m_providers)) {
         // Providers are parented inside QGeoFileTileCacheOsm, as they are used in its destructor.
         if (disableRedirection) {
             provider->disableRedirection();
         } else {
+            // resolved on an earlier run, so that tiles can be fetched right away
+            provider->setDefinitionCache(m_cacheDirectory + QLatin1String("/resolved_providers"), definitionLifetime);
             connect(provider, &QGeoTileProviderOsm::resolutionFinished,
                     this, &QGeoTiledMappingManagerEngineOsm::onProviderResolutionFinished);
             connect(provider, &QGeoTileProviderOsm::resolutionError,
@@ -250,7 +263,15 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
     /* TILE CACHE */
     if (parameters.contains(QStringLiteral("osm.mapping.offline.directory")))
         m_offlineDirectory = parameters.value(QStringLiteral("osm.mapping.offline.directory")).toString();
-    QGeoFileTileCacheOsm *tileCache = new QGeoFileTileCacheOsm(m_providers, m_offlineDirectory, m_cacheDirectory);
+    QAbstractGeoTileCache *tileCache = 0;
+    const QString storage = parameters.value(QStringLiteral("osm.mapping.cache.storage")).toString().toLower();
+    if (storage == QLatin1String("packed")) {
+        for (QGeoTileProviderOsm *provider: qAsConst(m_providers))
+            provider->setParent(this);
+        tileCache = new QGeoPackedTileCache(m_cacheDirectory);
+    } else {
+        tileCache = new QGeoFileTileCacheOsm(m_providers, m_offlineDirectory, m_cacheDirectory);
+    }
 
     /*
      * Disk cache setup -- defaults to ByteSize (old behavior)
@@ -309,6 +330,42 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
             tileCache->setExtraTextureUsage(cacheSize);
     }
 
+    /*
+     * Tile decoding -- defaults to synchronous decoding on the calling thread
+     */
+    QGeoFileTileCache *fileTileCache = qobject_cast<QGeoFileTileCache *>(tileCache);
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.admission_filter")))
+        fileTileCache->setAdmissionFilter(parameters.value(QStringLiteral("osm.mapping.cache.admission_filter")).toBool());
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.asynchronous_decoding")))
+        fileTileCache->setAsynchronousDecoding(parameters.value(QStringLiteral("osm.mapping.cache.asynchronous_decoding")).toBool());
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.stale_while_revalidate")))
+        fileTileCache->setServeStaleTiles(parameters.value(QStringLiteral("osm.mapping.cache.stale_while_revalidate")).toBool());
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.texture.format"))) {
+        const QString format = parameters.value(QStringLiteral("osm.mapping.cache.texture.format")).toString().toLower();
+        fileTileCache->setOpaqueTextureFormat(format == QLatin1String("rgb16") ? QImage::Format_RGB16
+                                                                               : QImage::Format_RGB32);
+    }
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.memory.pressure_size"))) {
+        bool ok = false;
+        int cacheSize = parameters.value(QStringLiteral("osm.mapping.cache.memory.pressure_size")).toString().toInt(&ok);
+        if (ok)
+            fileTileCache->setMemoryUsageFloor(cacheSize);
+    }
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.texture.pressure_size"))) {
+        bool ok = false;
+        int cacheSize = parameters.value(QStringLiteral("osm.mapping.cache.texture.pressure_size")).toString().toInt(&ok);
+        if (ok)
+            fileTileCache->setTextureUsageFloor(cacheSize);
+    }
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.shared")))
+        fileTileCache->setShared(parameters.value(QStringLiteral("osm.mapping.cache.shared")).toBool());
+    if (fileTileCache && parameters.contains(QStringLiteral("osm.mapping.cache.warm_start"))) {
+        bool ok = false;
+        int count = parameters.value(QStringLiteral("osm.mapping.cache.warm_start")).toString().toInt(&ok);
+        if (ok)
+            fileTileCache->setWarmStartTiles(count);
+    }
+
 
     setTileCache(tileCache);
 
@@ -319,6 +376,15 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         const QByteArray ua = parameters.value(QStringLiteral("osm.useragent")).toString().toLatin1();
         tileFetcher->setUserAgent(ua);
     }
+    if (parameters.contains(QStringLiteral("osm.mapping.max_concurrent_requests"))) {
+        const int maximum = parameters.value(QStringLiteral("osm.mapping.max_concurrent_requests")).toInt();
+        tileFetcher->setMaximumConcurrentRequests(maximum);
+    }
+    if (parameters.value(QStringLiteral("osm.mapping.threaded_fetching")).toBool()) {
+        qRegisterMetaType<const QGeoTileProviderOsm *>();
+        tileFetcher->setNetworkParameters(parameters);
+        setThreadedTileFetching(true);
+    }
     setTileFetcher(tileFetcher);
 
     /* PREFETCHING */
@@ -330,7 +396,13 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
+    if (parameters.contains(QStringLiteral("osm.mapping.distance_lod")))
+        m_distanceLOD = parameters.value(QStringLiteral("osm.mapping.distance_lod")).toBool();
+    if (parameters.contains(QStringLiteral("osm.mapping.progressive_loading")))
+        m_progressiveLoading = parameters.value(QStringLiteral("osm.mapping.progressive_loading")).toBool();
 
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
@@ -343,9 +415,11 @@ QGeoTiledMappingManagerEngineOsm::~QGeoTiledMappingManagerEngineOsm()
 QGeoMap *QGeoTiledMappingManagerEngineOsm::createMap()
 {
     QGeoTiledMap *map = new QGeoTiledMapOsm(this);
-    connect(qobject_cast<QGeoFileTileCacheOsm *>(tileCache()), &QGeoFileTileCacheOsm::mapDataUpdated
-            , map, &QGeoTiledMap::clearScene);
+    if (QGeoFileTileCacheOsm *fileTileCache = qobject_cast<QGeoFileTileCacheOsm *>(tileCache()))
+        connect(fileTileCache, &QGeoFileTileCacheOsm::mapDataUpdated, map, &QGeoTiledMap::clearScene);
     map->setPrefetchStyle(m_prefetchStyle);
+    map->setDistanceLOD(m_distanceLOD);
+    map->setProgressiveLoading(m_progressiveLoading);
     return map;
 }
 
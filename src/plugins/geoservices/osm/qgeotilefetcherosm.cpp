@@ -39,23 +39,46 @@
 
 #include "qgeotilefetcherosm.h"
 #include "qgeomapreplyosm.h"
+#include "qgeonetworkaccessmanagerosm.h"
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkRequest>
+#include <QtCore/QThread>
+#include <QtGui/QImageReader>
 #include <QtLocation/private/qgeotilespec_p.h>
 #include <QtLocation/private/qgeotilefetcher_p_p.h>
 
 
 QT_BEGIN_NAMESPACE
 
-static bool providersResolved(const QVector<QGeoTileProviderOsm *> &providers)
+static bool providersResolved(const QVector<QGeoTileSourceOsm> &sources)
 {
-    foreach (const QGeoTileProviderOsm *provider, providers)
-        if (!provider->isResolved())
+    for (const QGeoTileSourceOsm &source : sources)
+        if (!source.resolved)
             return false;
     return true;
 }
 
+// Offers the formats smaller than PNG and JPEG the servers may have, when Qt can decode them
+static QByteArray acceptedTileFormats()
+{
+    static const QByteArray accept = [] {
+        const QList<QByteArray> types = QImageReader::supportedMimeTypes();
+        QByteArray value;
+        if (types.contains("image/avif"))
+            value += "image/avif,";
+        if (types.contains("image/webp"))
+            value += "image/webp,";
+        return value.isEmpty() ? value : value + "image/*;q=0.8";
+    }();
+    return accept;
+}
+
+static bool isImageFormat(const QString &format)
+{
+    return format == QLatin1String("png") || format == QLatin1String("jpg") || format == QLatin1String("jpeg");
+}
+
 class QGeoTileFetcherOsmPrivate : public QGeoTileFetcherPrivate
 {
     Q_DECLARE_PUBLIC(QGeoTileFetcherOsm)
@@ -77,13 +100,20 @@ QGeoTileFetcherOsmPrivate::~QGeoTileFetcherOsmPrivate()
 
 
 QGeoTileFetcherOsm::QGeoTileFetcherOsm(const QVector<QGeoTileProviderOsm *> &providers,
-                                       QNetworkAccessManager *nm,
+                                       const QSharedPointer<QGeoNetworkAccessManagerOsm> &nm,
                                        QGeoMappingManagerEngine *parent)
 :   QGeoTileFetcher(*new QGeoTileFetcherOsmPrivate(), parent), m_userAgent("Qt Location based application"),
     m_providers(providers), m_nm(nm), m_ready(true)
 {
-    m_nm->setParent(this);
+    qRegisterMetaType<QGeoTileSourceOsm>();
+    m_sources.reserve(m_providers.size());
     foreach (QGeoTileProviderOsm *provider, m_providers) {
+        // the providers change in the engine thread: the copies are queued
+        // to the fetcher when it has a thread of its own
+        const int index = m_sources.size();
+        m_sources.append(provider->tileSource());
+        connect(provider, &QGeoTileProviderOsm::tileSourceChanged, this,
+                [this, index](const QGeoTileSourceOsm &source) { m_sources[index] = source; });
         if (!provider->isResolved()) {
             m_ready = false;
             connect(provider, &QGeoTileProviderOsm::resolutionFinished,
@@ -107,16 +137,17 @@ void QGeoTileFetcherOsm::setUserAgent(const QByteArray &userAgent)
 bool QGeoTileFetcherOsm::initialized() const
 {
     if (!m_ready) {
-        foreach (QGeoTileProviderOsm *provider, m_providers)
-            if (!provider->isResolved())
-                provider->resolveProvider();
+        // the providers resolve themselves with the network access manager of the engine thread
+        for (int i = 0; i < m_sources.size(); ++i)
+            if (!m_sources.at(i).resolved)
+                QMetaObject::invokeMethod(m_providers.at(i), &QGeoTileProviderOsm::resolveProvider);
     }
     return m_ready;
 }
 
 void QGeoTileFetcherOsm::onProviderResolutionFinished(const QGeoTileProviderOsm *provider)
 {
-    if ((m_ready = providersResolved(m_providers))) {
+    if ((m_ready = providersResolved(m_sources))) {
         qWarning("QGeoTileFetcherOsm: all providers resolved");
         readyUpdated();
     }
@@ -125,7 +156,7 @@ void QGeoTileFetcherOsm::onProviderResolutionFinished(const QGeoTileProviderOsm
 
 void QGeoTileFetcherOsm::onProviderResolutionError(const QGeoTileProviderOsm *provider)
 {
-    if ((m_ready = providersResolved(m_providers))) {
+    if ((m_ready = providersResolved(m_sources))) {
         qWarning("QGeoTileFetcherOsm: all providers resolved");
         readyUpdated();
     }
@@ -143,24 +174,56 @@ void QGeoTileFetcherOsm::restartTimer()
 QGeoTiledMapReply *QGeoTileFetcherOsm::getTileImage(const QGeoTileSpec &spec)
 {
     int id = spec.mapId();
-    if (id < 1 || id > m_providers.size()) {
+    if (id < 1 || id > m_sources.size()) {
         qWarning("Unknown map id %d\n", spec.mapId());
-        if (m_providers.isEmpty())
+        if (m_sources.isEmpty())
             return nullptr;
         else
             id = 1;
     }
     id -= 1; // TODO: make OSM map ids start from 0.
 
-    if (spec.zoom() > m_providers[id]->maximumZoomLevel() || spec.zoom() < m_providers[id]->minimumZoomLevel())
+    const QGeoTileSourceOsm &source = m_sources.at(id);
+    if (spec.zoom() > source.maximumZoomLevel || spec.zoom() < source.minimumZoomLevel)
         return nullptr;
 
-    const QUrl url = m_providers[id]->tileAddress(spec.x(), spec.y(), spec.zoom());
+    const QUrl url = source.tileAddress(spec.x(), spec.y(), spec.zoom());
     QNetworkRequest request;
     request.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
     request.setUrl(url);
-    QNetworkReply *reply = m_nm->get(request);
-    return new QGeoMapReplyOsm(reply, spec, m_providers[id]->format());
+    // the tile cache keeps the tiles, a network disk cache would store them twice
+    request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    const QGeoTileValidators validators = tileValidators(spec);
+    if (!validators.entityTag.isEmpty())
+        request.setRawHeader("If-None-Match", validators.entityTag);
+    if (!validators.lastModified.isEmpty())
+        request.setRawHeader("If-Modified-Since", validators.lastModified);
+    // the reply takes the format of what the server sent, see QGeoMapReplyOsm
+    if (isImageFormat(source.format) && !acceptedTileFormats().isEmpty())
+        request.setRawHeader("Accept", acceptedTileFormats());
+    QNetworkReply *reply = networkAccessManager()->get(request);
+    return new QGeoMapReplyOsm(reply, spec, source.format);
+}
+
+/*
+    Sets the network parameters of the plugin, to create the network access
+    manager of the thread the fetcher is moved to, see
+    QGeoTiledMappingManagerEngine::setThreadedTileFetching().
+*/
+void QGeoTileFetcherOsm::setNetworkParameters(const QVariantMap &parameters)
+{
+    m_networkParameters = parameters;
+    // tiles aren't stored in the network cache, and a second QNetworkDiskCache
+    // can't share the directory of the engine thread's one
+    m_networkParameters.remove(QStringLiteral("osm.network.cache.size"));
+}
+
+// The shared manager of the thread the fetcher runs in
+QGeoNetworkAccessManagerOsm *QGeoTileFetcherOsm::networkAccessManager()
+{
+    if (m_nm->thread() != QThread::currentThread())
+        m_nm = QGeoNetworkAccessManagerOsm::instance(m_networkParameters);
+    return m_nm.data();
 }
 
 void QGeoTileFetcherOsm::readyUpdated()
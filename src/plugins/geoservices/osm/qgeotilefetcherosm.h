@@ -43,10 +43,12 @@
 #include "qgeotileproviderosm.h"
 #include <QtLocation/private/qgeotilefetcher_p.h>
 #include <QVector>
+#include <QSharedPointer>
+#include <QVariantMap>
 
 QT_BEGIN_NAMESPACE
 
-class QNetworkAccessManager;
+class QGeoNetworkAccessManagerOsm;
 class QGeoTileFetcherOsmPrivate;
 
 class QGeoTileFetcherOsm : public QGeoTileFetcher
@@ -58,10 +60,11 @@ class QGeoTileFetcherOsm : public QGeoTileFetcher
     friend class QGeoTiledMappingManagerEngineOsm;
 public:
     QGeoTileFetcherOsm(const QVector<QGeoTileProviderOsm *> &providers,
-                       QNetworkAccessManager *nm,
+                       const QSharedPointer<QGeoNetworkAccessManagerOsm> &nm,
                        QGeoMappingManagerEngine *parent);
 
     void setUserAgent(const QByteArray &userAgent);
+    void setNetworkParameters(const QVariantMap &parameters);
 
 Q_SIGNALS:
     void providerDataUpdated(const QGeoTileProviderOsm *provider);
@@ -77,10 +80,13 @@ protected Q_SLOTS:
 private:
     QGeoTiledMapReply *getTileImage(const QGeoTileSpec &spec) override;
     void readyUpdated();
+    QGeoNetworkAccessManagerOsm *networkAccessManager();
 
     QByteArray m_userAgent;
-    QVector<QGeoTileProviderOsm *> m_providers;
-    QNetworkAccessManager *m_nm;
+    QVector<QGeoTileProviderOsm *> m_providers; // live in the engine thread, see m_sources
+    QVector<QGeoTileSourceOsm> m_sources; // copies of the providers, read in the fetcher thread
+    QSharedPointer<QGeoNetworkAccessManagerOsm> m_nm;
+    QVariantMap m_networkParameters;
     bool m_ready;
 };
 
@@ -38,6 +38,11 @@
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 #include <QDebug>
 
 QT_BEGIN_NAMESPACE
@@ -88,6 +93,14 @@ QUrl QGeoTileProviderOsm::tileAddress(int x, int y, int z) const
     return m_provider->tileAddress(x, y, z);
 }
 
+// A copy of what the fetcher needs, see QGeoTileSourceOsm
+QGeoTileSourceOsm QGeoTileProviderOsm::tileSource() const
+{
+    QGeoTileSourceOsm source(m_status == Resolved ? m_provider : nullptr);
+    source.resolved = (m_status == Resolved);
+    return source;
+}
+
 QString QGeoTileProviderOsm::mapCopyRight() const
 {
     if (m_status != Resolved || !m_provider)
@@ -199,17 +212,53 @@ void QGeoTileProviderOsm::onResolutionFinished(TileProvider *provider)
     Q_UNUSED(provider);
     // provider and m_provider are the same, at this point. m_status is Resolving.
     m_status = Resolved;
+    emit tileSourceChanged(tileSource());
     emit resolutionFinished(this);
 }
 
+/*
+    Keeps the provider information resolved from the repository in
+    \a directory. Information resolved less than \a lifetime seconds ago is
+    used right away, and refreshed in the background for the next time.
+    Older information is still preferred to the hardcoded providers when the
+    repository can't be reached. A \a lifetime of 0 keeps nothing.
+*/
+void QGeoTileProviderOsm::setDefinitionCache(const QString &directory, qint64 lifetime)
+{
+    if (lifetime <= 0)
+        return;
+    for (TileProvider *p: qAsConst(m_providerList)) {
+        if (!p->m_urlRedirector.isValid())
+            continue;
+        const QByteArray name = QCryptographicHash::hash(p->m_urlRedirector.toEncoded(),
+                                                         QCryptographicHash::Md5).toHex();
+        p->setDefinitionFile(QDir(directory).filePath(QLatin1String(name) + QLatin1String(".json")), lifetime);
+    }
+
+    if (m_status != Idle || !m_provider || !m_provider->loadDefinition(false))
+        return;
+    m_status = Resolved;
+    updateCameraCapabilities();
+    m_provider->refreshDefinition();
+}
+
 void QGeoTileProviderOsm::onResolutionError(TileProvider *provider)
 {
     Q_UNUSED(provider);
     // provider and m_provider are the same at this point. m_status is Resolving.
+    // The repository can't be reached or lost the information: stale provider
+    // information beats the backups
+    if (m_provider && !m_provider->isValid() && m_provider->loadDefinition(true)) {
+        m_status = Resolved;
+        emit tileSourceChanged(tileSource());
+        emit resolutionFinished(this);
+        return;
+    }
     if (!m_provider || m_provider->isInvalid()) {
         m_provider = nullptr;
         m_status = Resolved;
         if (m_providerId >= m_providerList.size() -1) { // no hope left
+            emit tileSourceChanged(tileSource());
             emit resolutionError(this);
             return;
         }
@@ -230,10 +279,16 @@ void QGeoTileProviderOsm::onResolutionError(TileProvider *provider)
                 break;
             }
         }
-        if (!m_provider)
+        if (!m_provider) {
+            emit tileSourceChanged(tileSource());
             emit resolutionError(this);
+        } else if (m_status == Resolved) { // the next one was valid already
+            emit tileSourceChanged(tileSource());
+            emit resolutionFinished(this);
+        }
     } else if (m_provider->isValid()) {
         m_status = Resolved;
+        emit tileSourceChanged(tileSource());
         emit resolutionFinished(this);
     } else { // still not resolved. But network error is recoverable.
         m_status = Idle;
@@ -287,13 +342,14 @@ static void sort2(int &a, int &b)
     }
 }
 
-TileProvider::TileProvider() : m_status(Invalid), m_nm(nullptr), m_timestamp(defaultTs), m_highDpi(false)
+TileProvider::TileProvider() : m_status(Invalid), m_nm(nullptr), m_definitionLifetime(0), m_timestamp(defaultTs), m_highDpi(false)
 {
 
 }
 
 TileProvider::TileProvider(const QUrl &urlRedirector, bool highDpi)
-:   m_status(Idle), m_urlRedirector(urlRedirector), m_nm(nullptr), m_timestamp(defaultTs), m_highDpi(highDpi)
+:   m_status(Idle), m_urlRedirector(urlRedirector), m_nm(nullptr), m_definitionLifetime(0), m_timestamp(defaultTs),
+    m_highDpi(highDpi)
 {
     if (!m_urlRedirector.isValid())
         m_status = Invalid;
@@ -306,7 +362,7 @@ TileProvider::TileProvider(const QString &urlTemplate,
                            bool highDpi,
                            int minimumZoomLevel,
                            int maximumZoomLevel)
-:   m_status(Invalid), m_nm(nullptr), m_urlTemplate(urlTemplate),
+:   m_status(Invalid), m_nm(nullptr), m_definitionLifetime(0), m_urlTemplate(urlTemplate),
     m_format(format), m_copyRightMap(copyRightMap), m_copyRightData(copyRightData),
     m_minimumZoomLevel(minimumZoomLevel), m_maximumZoomLevel(maximumZoomLevel), m_timestamp(defaultTs), m_highDpi(highDpi)
 {
@@ -332,14 +388,99 @@ void TileProvider::resolveProvider()
         break;
     }
 
+    QNetworkReply *reply = m_nm->get(definitionRequest());
+    connect(reply, SIGNAL(finished()), this, SLOT(onNetworkReplyFinished()) );
+    connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)), this, SLOT(onNetworkReplyError(QNetworkReply::NetworkError)));
+}
+
+QNetworkRequest TileProvider::definitionRequest() const
+{
     QNetworkRequest request;
     request.setHeader(QNetworkRequest::UserAgentHeader, QByteArrayLiteral("QGeoTileFetcherOsm"));
     request.setUrl(m_urlRedirector);
     request.setAttribute(QNetworkRequest::BackgroundRequestAttribute, true);
     request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
-    QNetworkReply *reply = m_nm->get(request);
-    connect(reply, SIGNAL(finished()), this, SLOT(onNetworkReplyFinished()) );
-    connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)), this, SLOT(onNetworkReplyError(QNetworkReply::NetworkError)));
+    return request;
+}
+
+void TileProvider::setDefinitionFile(const QString &filename, qint64 lifetime)
+{
+    m_definitionFile = filename;
+    m_definitionLifetime = lifetime;
+}
+
+/*
+    Sets the provider up from the stored provider information, if resolved
+    less than the lifetime ago or \a expired is true. Returns whether the
+    provider is valid then, it is left untouched otherwise.
+*/
+bool TileProvider::loadDefinition(bool expired)
+{
+    if (m_definitionFile.isEmpty())
+        return false;
+    QFile file(m_definitionFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QJsonObject stored = QJsonDocument::fromJson(file.readAll()).object();
+    if (stored.value(QLatin1String("Url")).toString() != m_urlRedirector.toString())
+        return false;
+    const QDateTime resolved = QDateTime::fromString(stored.value(QLatin1String("Resolved")).toString(), Qt::ISODate);
+    if (!resolved.isValid())
+        return false;
+    if (!expired && resolved.addSecs(m_definitionLifetime) < QDateTime::currentDateTimeUtc())
+        return false;
+
+    const Status status = m_status;
+    m_status = Invalid;
+    parseDefinition(stored.value(QLatin1String("Definition")).toObject());
+    if (isValid())
+        return true;
+    m_status = status;
+    return false;
+}
+
+void TileProvider::storeDefinition(const QJsonObject &json) const
+{
+    if (m_definitionFile.isEmpty())
+        return;
+    QJsonObject stored;
+    stored.insert(QLatin1String("Url"), m_urlRedirector.toString());
+    stored.insert(QLatin1String("Resolved"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    stored.insert(QLatin1String("Definition"), json);
+
+    QDir().mkpath(QFileInfo(m_definitionFile).absolutePath());
+    QSaveFile file(m_definitionFile);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(stored).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+/*
+    Fetches the provider information again for the next run, without changing
+    the provider that is in use: switching tile servers while running would
+    mix their tiles in the cache.
+*/
+void TileProvider::refreshDefinition()
+{
+    if (!m_nm || m_definitionFile.isEmpty())
+        return;
+    QNetworkReply *reply = m_nm->get(definitionRequest());
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        reply->deleteLater();
+        if (reply->error() != QNetworkReply::NoError)
+            return;
+        const QJsonObject json = QJsonDocument::fromJson(reply->readAll()).object();
+        if (json.isEmpty())
+            return;
+        TileProvider definition;
+        definition.m_urlRedirector = m_urlRedirector;
+        definition.parseDefinition(json);
+        if (definition.isValid())
+            storeDefinition(json);
+        else // disabled or broken on the repository, resolve again next time
+            QFile::remove(m_definitionFile);
+    });
 }
 
 void TileProvider::handleError(QNetworkReply::NetworkError error)
@@ -450,6 +591,17 @@ void TileProvider::onNetworkReplyFinished()
         return;
     }
     const QJsonObject json = d.object();
+    parseDefinition(json);
+    if (isValid()) {
+        storeDefinition(json);
+        QObject::disconnect(errorEmitterConnection);
+        emit resolutionFinished(this);
+    }
+}
+
+// Sets the provider up from provider information, which has to be Invalid until then
+void TileProvider::parseDefinition(const QJsonObject &json)
+{
     const QJsonValue urlTemplate = json.value(QLatin1String("UrlTemplate"));
     const QJsonValue imageFormat = json.value(QLatin1String("ImageFormat"));
     const QJsonValue copyRightMap = json.value(QLatin1String("MapCopyRight"));
@@ -495,10 +647,6 @@ void TileProvider::onNetworkReplyFinished()
         m_timestamp = QDateTime::fromString(ts.toString(), Qt::ISODate);
 
     setupProvider();
-    if (isValid()) {
-        QObject::disconnect(errorEmitterConnection);
-        emit resolutionFinished(this);
-    }
 }
 
 void TileProvider::onNetworkReplyError(QNetworkReply::NetworkError error)
@@ -637,22 +785,28 @@ void TileProvider::setTimestamp(const QDateTime &timestamp)
     m_timestamp = timestamp;
 }
 
-QUrl TileProvider::tileAddress(int x, int y, int z) const
+static QUrl tileUrl(const QString &prefix, const QString sep[2], const int lut[3], const QString &suffix,
+                    int x, int y, int z)
 {
-    if (z < m_minimumZoomLevel || z > m_maximumZoomLevel)
-        return QUrl();
     int params[3] = { x, y, z};
     QString url;
-    url += m_urlPrefix;
-    url += QString::number(params[paramsLUT[0]]);
-    url += paramsSep[0];
-    url += QString::number(params[paramsLUT[1]]);
-    url += paramsSep[1];
-    url += QString::number(params[paramsLUT[2]]);
-    url += m_urlSuffix;
+    url += prefix;
+    url += QString::number(params[lut[0]]);
+    url += sep[0];
+    url += QString::number(params[lut[1]]);
+    url += sep[1];
+    url += QString::number(params[lut[2]]);
+    url += suffix;
     return QUrl(url);
 }
 
+QUrl TileProvider::tileAddress(int x, int y, int z) const
+{
+    if (z < m_minimumZoomLevel || z > m_maximumZoomLevel)
+        return QUrl();
+    return tileUrl(m_urlPrefix, paramsSep, paramsLUT, m_urlSuffix, x, y, z);
+}
+
 void TileProvider::setNetworkManager(QNetworkAccessManager *nm)
 {
     m_nm = nm;
@@ -664,4 +818,36 @@ TileProvider::Status TileProvider::status() const
 }
 
 
+/*
+    Class QGeoTileSourceOsm
+*/
+
+QGeoTileSourceOsm::QGeoTileSourceOsm()
+:   resolved(false), minimumZoomLevel(0), maximumZoomLevel(20), m_valid(false), m_paramsLUT{0, 1, 2}
+{
+}
+
+// What QGeoTileProviderOsm answers with \a provider active, or with none when null
+QGeoTileSourceOsm::QGeoTileSourceOsm(const TileProvider *provider)
+:   QGeoTileSourceOsm()
+{
+    if (!provider)
+        return;
+    format = provider->format();
+    minimumZoomLevel = provider->minimumZoomLevel();
+    maximumZoomLevel = provider->maximumZoomLevel();
+    m_valid = provider->isValid();
+    m_urlPrefix = provider->m_urlPrefix;
+    m_urlSuffix = provider->m_urlSuffix;
+    std::copy(provider->paramsLUT, provider->paramsLUT + 3, m_paramsLUT);
+    std::copy(provider->paramsSep, provider->paramsSep + 2, m_paramsSep);
+}
+
+QUrl QGeoTileSourceOsm::tileAddress(int x, int y, int z) const
+{
+    if (!resolved || !m_valid || z < minimumZoomLevel || z > maximumZoomLevel)
+        return QUrl();
+    return tileUrl(m_urlPrefix, m_paramsSep, m_paramsLUT, m_urlSuffix, x, y, z);
+}
+
 QT_END_NAMESPACE
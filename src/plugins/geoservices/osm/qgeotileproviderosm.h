@@ -75,10 +75,16 @@ public:
 
     ~TileProvider();
     void setNetworkManager(QNetworkAccessManager *nm);
+    void setDefinitionFile(const QString &filename, qint64 lifetime);
 
     void resolveProvider();
     void handleError(QNetworkReply::NetworkError error);
     void setupProvider();
+    void parseDefinition(const QJsonObject &json);
+    bool loadDefinition(bool expired);
+    void storeDefinition(const QJsonObject &json) const;
+    void refreshDefinition();
+    QNetworkRequest definitionRequest() const;
 
     inline bool isValid() const;
     inline bool isInvalid() const;
@@ -103,6 +109,8 @@ public:
     Status m_status;
     QUrl m_urlRedirector; // The URL from where to fetch the URL template in case of a provider to resolve.
     QNetworkAccessManager *m_nm;
+    QString m_definitionFile; // where the resolved provider information is kept, if anywhere
+    qint64 m_definitionLifetime; // seconds
     QString m_urlTemplate;
     QString m_format;
     QString m_copyRightMap;
@@ -127,6 +135,33 @@ public Q_SLOTS:
     void onNetworkReplyError(QNetworkReply::NetworkError error);
 
 friend class QGeoTileProviderOsm;
+friend class QGeoTileSourceOsm;
+};
+
+/*
+    What the tile fetcher reads of a QGeoTileProviderOsm. The fetcher may run
+    in a thread of its own, and gets copies of this instead of reading the
+    provider while it resolves itself in the thread of the engine.
+*/
+class QGeoTileSourceOsm
+{
+public:
+    QGeoTileSourceOsm();
+    explicit QGeoTileSourceOsm(const TileProvider *provider);
+
+    QUrl tileAddress(int x, int y, int z) const;
+
+    bool resolved;
+    QString format;
+    int minimumZoomLevel;
+    int maximumZoomLevel;
+
+private:
+    bool m_valid;
+    QString m_urlPrefix;
+    QString m_urlSuffix;
+    int m_paramsLUT[3];
+    QString m_paramsSep[2];
 };
 
 class QGeoTileProviderOsm: public QObject
@@ -160,11 +195,14 @@ public:
     bool isResolved() const;
     const QDateTime timestamp() const;
     QGeoCameraCapabilities cameraCapabilities() const;
+    QGeoTileSourceOsm tileSource() const;
+    void setDefinitionCache(const QString &directory, qint64 lifetime);
 
 Q_SIGNALS:
     void resolutionFinished(const QGeoTileProviderOsm *provider);
     void resolutionError(const QGeoTileProviderOsm *provider);
     void resolutionRequired();
+    void tileSourceChanged(const QGeoTileSourceOsm &source);
 
 public Q_SLOTS:
     void resolveProvider();
@@ -191,4 +229,8 @@ protected:
 
 QT_END_NAMESPACE
 
+// queued between the providers and a fetcher running in its own thread
+Q_DECLARE_METATYPE(const QGeoTileProviderOsm *)
+Q_DECLARE_METATYPE(QGeoTileSourceOsm)
+
 #endif // QTILEPROVIDEROSM_H
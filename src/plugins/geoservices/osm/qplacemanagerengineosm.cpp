@@ -40,6 +40,7 @@
 #include "qplacemanagerengineosm.h"
 #include "qplacesearchreplyosm.h"
 #include "qplacecategoriesreplyosm.h"
+#include "qgeonetworkaccessmanagerosm.h"
 
 #include <QtCore/QUrlQuery>
 #include <QtCore/QXmlStreamReader>
@@ -49,6 +50,8 @@
 #include <QtNetwork/QNetworkReply>
 #include <QtPositioning/QGeoCircle>
 #include <QtLocation/private/unsupportedreplies_p.h>
+#include <QtLocation/private/qplacecategorycache_p.h>
+#include <QtLocation/private/qgeorequestscheduler_p.h>
 
 #include <QtCore/QElapsedTimer>
 
@@ -95,7 +98,7 @@ QString nameForTagKey(const QString &tagKey)
 QPlaceManagerEngineOsm::QPlaceManagerEngineOsm(const QVariantMap &parameters,
                                                QGeoServiceProvider::Error *error,
                                                QString *errorString)
-:   QPlaceManagerEngine(parameters), m_networkManager(new QNetworkAccessManager(this)),
+:   QPlaceManagerEngine(parameters), m_networkManager(QGeoNetworkAccessManagerOsm::instance(parameters)),
     m_categoriesReply(0)
 {
     if (parameters.contains(QStringLiteral("osm.useragent")))
@@ -108,6 +111,11 @@ QPlaceManagerEngineOsm::QPlaceManagerEngineOsm(const QVariantMap &parameters,
     else
         m_urlPrefix = QStringLiteral("http://nominatim.openstreetmap.org/search");
 
+    // the usage policy of the public Nominatim server allows a request per second
+    const QString host = QUrl(m_urlPrefix).host();
+    if (host == QLatin1String("nominatim.openstreetmap.org"))
+        QGeoRequestScheduler::instance()->setRateLimit(host, 1, 1);
+    QGeoRequestScheduler::instance()->configure(host, parameters, QStringLiteral("osm.places."));
 
     if (parameters.contains(QStringLiteral("osm.places.debug_query")))
         m_debugQuery = parameters.value(QStringLiteral("osm.places.debug_query")).toBool();
@@ -183,9 +191,8 @@ QPlaceSearchReply *QPlaceManagerEngineOsm::search(const QPlaceSearchRequest &req
 
     QNetworkRequest rq(requestUrl);
     rq.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    QNetworkReply *networkReply = m_networkManager->get(rq);
 
-    QPlaceSearchReplyOsm *reply = new QPlaceSearchReplyOsm(request, networkReply, this);
+    QPlaceSearchReplyOsm *reply = new QPlaceSearchReplyOsm(request, nullptr, this);
     connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(reply, SIGNAL(error(QPlaceReply::Error,QString)),
             this, SLOT(replyError(QPlaceReply::Error,QString)));
@@ -193,16 +200,35 @@ QPlaceSearchReply *QPlaceManagerEngineOsm::search(const QPlaceSearchRequest &req
     if (m_debugQuery)
         reply->requestUrl = requestUrl.url(QUrl::None);
 
+    // a search still waiting for the server is dropped for a newer one, as
+    // when searching while typing
+    const QString coalescingKey = QStringLiteral("osm.places.search/") + QString::number(quintptr(this), 16);
+    QGeoRequestScheduler::instance()->schedule(requestUrl.host(), reply, [this, reply, rq]() {
+        if (reply->isFinished())
+            return false;
+        reply->setNetworkReply(m_networkManager->get(rq));
+        return true;
+    }, QGeoRequestScheduler::InteractivePriority, coalescingKey, [reply]() { reply->supersede(); });
+
     return reply;
 }
 
 QPlaceReply *QPlaceManagerEngineOsm::initializeCategories()
 {
-    // Only fetch categories once
+    // Only fetch categories once. Cached categories are used right away, and
+    // refreshed in the background when they are old.
     if (m_categories.isEmpty() && !m_categoriesReply) {
         m_categoryLocales = m_locales;
         m_categoryLocales.append(QLocale(QLocale::English));
-        fetchNextCategoryLocale();
+        m_cachedCategoryLocales = m_categoryLocales;
+
+        QPlaceCategoryCache cache(QStringLiteral("osm"), m_cachedCategoryLocales);
+        if (cache.load()) {
+            m_categories = cache.categories();
+            m_subcategories = cache.subcategories();
+        }
+        if (m_categories.isEmpty() || cache.isExpired())
+            fetchNextCategoryLocale();
     }
 
     QPlaceCategoriesReplyOsm *reply = new QPlaceCategoriesReplyOsm(this);
@@ -210,11 +236,10 @@ QPlaceReply *QPlaceManagerEngineOsm::initializeCategories()
     connect(reply, SIGNAL(error(QPlaceReply::Error,QString)),
             this, SLOT(replyError(QPlaceReply::Error,QString)));
 
-    // TODO delayed finished() emission
     if (!m_categories.isEmpty())
-        reply->emitFinished();
-
-    m_pendingCategoriesReply.append(reply);
+        QMetaObject::invokeMethod(reply, [reply]() { reply->emitFinished(); }, Qt::QueuedConnection);
+    else
+        m_pendingCategoriesReply.append(reply);
     return reply;
 }
 
@@ -259,6 +284,7 @@ void QPlaceManagerEngineOsm::categoryReplyFinished()
     QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
     reply->deleteLater();
 
+    int found = 0;
     QXmlStreamReader parser(reply);
     while (!parser.atEnd() && parser.readNextStartElement()) {
         if (parser.name() == QLatin1String("mediawiki"))
@@ -283,6 +309,7 @@ void QPlaceManagerEngineOsm::categoryReplyFinished()
                 // Only interested in any operator plural forms
                 if (op != QLatin1String("-") || plural != QLatin1String("Y"))
                     continue;
+                ++found;
 
                 if (!m_categories.contains(tagKey)) {
                     QPlaceCategory category;
@@ -308,13 +335,18 @@ void QPlaceManagerEngineOsm::categoryReplyFinished()
         parser.skipCurrentElement();
     }
 
-    if (m_categories.isEmpty() && !m_categoryLocales.isEmpty()) {
+    if (!found && !m_categoryLocales.isEmpty()) {
         fetchNextCategoryLocale();
         return;
     } else {
         m_categoryLocales.clear();
     }
 
+    if (found) {
+        QPlaceCategoryCache cache(QStringLiteral("osm"), m_cachedCategoryLocales);
+        cache.save(m_categories, m_subcategories);
+    }
+
     foreach (QPlaceCategoriesReplyOsm *reply, m_pendingCategoriesReply)
         reply->emitFinished();
     m_pendingCategoriesReply.clear();
@@ -349,7 +381,6 @@ void QPlaceManagerEngineOsm::fetchNextCategoryLocale()
 
     QLocale locale = m_categoryLocales.takeFirst();
 
-    // FIXME: Categories should be cached.
     QUrl requestUrl = QUrl(SpecialPhrasesBaseUrl + locale.name().left(2).toUpper());
 
     m_categoriesReply = m_networkManager->get(QNetworkRequest(requestUrl));
@@ -42,10 +42,11 @@
 
 #include <QtLocation/QPlaceManagerEngine>
 #include <QtLocation/QGeoServiceProvider>
+#include <QtCore/QSharedPointer>
 
 QT_BEGIN_NAMESPACE
 
-class QNetworkAccessManager;
+class QGeoNetworkAccessManagerOsm;
 class QNetworkReply;
 class QPlaceCategoriesReplyOsm;
 
@@ -79,7 +80,7 @@ private slots:
 private:
     void fetchNextCategoryLocale();
 
-    QNetworkAccessManager *m_networkManager;
+    QSharedPointer<QGeoNetworkAccessManagerOsm> m_networkManager;
     QByteArray m_userAgent;
     QString m_urlPrefix;
     QList<QLocale> m_locales;
@@ -92,6 +93,7 @@ private:
     QHash<QString, QStringList> m_subcategories;
 
     QList<QLocale> m_categoryLocales;
+    QList<QLocale> m_cachedCategoryLocales;
 };
 
 QT_END_NAMESPACE
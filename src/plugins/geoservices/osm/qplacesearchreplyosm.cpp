@@ -49,6 +49,7 @@
 #include <QtLocation/QPlaceResult>
 #include <QtLocation/QPlaceSearchRequest>
 #include <QtLocation/private/qplacesearchrequest_p.h>
+#include <QtLocation/private/qgeoasyncparse_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -57,12 +58,17 @@ QPlaceSearchReplyOsm::QPlaceSearchReplyOsm(const QPlaceSearchRequest &request,
 :   QPlaceSearchReply(parent)
 {
     Q_ASSERT(parent);
-    if (!reply) {
-        setError(UnknownError, QStringLiteral("Null reply"));
-        return;
-    }
     setRequest(request);
+    if (reply)
+        setNetworkReply(reply);
+}
 
+/*
+    Connects to the network reply \a reply. It may be set after the reply
+    was created, when the engine waits with sending the request.
+*/
+void QPlaceSearchReplyOsm::setNetworkReply(QNetworkReply *reply)
+{
     connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
     connect(reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)),
             this, SLOT(networkError(QNetworkReply::NetworkError)));
@@ -70,6 +76,15 @@ QPlaceSearchReplyOsm::QPlaceSearchReplyOsm(const QPlaceSearchRequest &request,
     connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
 }
 
+/*
+    Finishes the reply with QPlaceReply::CancelError, for a search replaced by
+    a newer one of the engine before it was sent.
+*/
+void QPlaceSearchReplyOsm::supersede()
+{
+    setError(QPlaceReply::CancelError, tr("Superseded by a newer search"));
+}
+
 QPlaceSearchReplyOsm::~QPlaceSearchReplyOsm()
 {
 }
@@ -95,33 +110,120 @@ static QGeoRectangle parseBoundingBox(const QJsonArray &coordinates)
     return QGeoRectangle(QGeoCoordinate(top, left), QGeoCoordinate(bottom, right));
 }
 
-void QPlaceSearchReplyOsm::replyFinished()
+static QPlaceResult parsePlaceResult(const QJsonObject &item, const QString &requestUrl)
 {
-    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
-    reply->deleteLater();
+    QPlace place;
 
-    if (reply->error() != QNetworkReply::NoError)
-        return;
+    QGeoCoordinate coordinate = QGeoCoordinate(item.value(QStringLiteral("lat")).toString().toDouble(),
+                                               item.value(QStringLiteral("lon")).toString().toDouble());
 
-    QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
-    if (!document.isArray()) {
-        setError(ParseError, tr("Response parse error"));
-        return;
+    //const QString placeRank = item.value(QStringLiteral("place_rank")).toString();
+    //const QString category = item.value(QStringLiteral("category")).toString();
+    const QString type = item.value(QStringLiteral("type")).toString();
+    //double importance = item.value(QStringLiteral("importance")).toDouble();
+
+    place.setAttribution(item.value(QStringLiteral("licence")).toString());
+    place.setPlaceId(QString::number(item.value(QStringLiteral("place_id")).toInt()));
+
+    QVariantMap iconParameters;
+    iconParameters.insert(QPlaceIcon::SingleUrl,
+                          QUrl(item.value(QStringLiteral("icon")).toString()));
+    QPlaceIcon icon;
+    icon.setParameters(iconParameters);
+    place.setIcon(icon);
+
+    QJsonObject addressDetails = item.value(QStringLiteral("address")).toObject();
+
+    const QString title = addressDetails.value(type).toString();
+
+    place.setName(title);
+
+    if (!requestUrl.isEmpty()) {
+        QPlaceAttribute attribute;
+        attribute.setLabel("requestUrl");
+        attribute.setText(requestUrl);
+        place.setExtendedAttribute("requestUrl", attribute);
     }
 
-    QJsonArray resultsArray = document.array();
+    QGeoAddress address;
+    address.setCity(addressDetails.value(QStringLiteral("city")).toString());
+    address.setCountry(addressDetails.value(QStringLiteral("country")).toString());
+    // FIXME: country_code is alpha-2 setCountryCode takes alpha-3
+    //address.setCountryCode(addressDetails.value(QStringLiteral("country_code")).toString());
+    address.setPostalCode(addressDetails.value(QStringLiteral("postcode")).toString());
+    address.setStreet(addressDetails.value(QStringLiteral("road")).toString());
+    address.setState(addressDetails.value(QStringLiteral("state")).toString());
+    address.setDistrict(addressDetails.value(QStringLiteral("suburb")).toString());
 
-    QGeoCoordinate searchCenter = request().searchArea().center();
+    QGeoLocation location;
+    location.setCoordinate(coordinate);
+    location.setAddress(address);
+    location.setBoundingBox(parseBoundingBox(item.value(QStringLiteral("boundingbox")).toArray()));
 
-    QStringList placeIds;
+    place.setLocation(location);
+
+    QPlaceResult result;
+    result.setIcon(icon);
+    result.setPlace(place);
+    result.setTitle(title);
+
+    return result;
+}
 
+namespace {
+struct ParsedSearch
+{
+    bool ok = false;
     QList<QPlaceSearchResult> results;
+    QStringList placeIds;
+};
+}
+
+static ParsedSearch parseSearch(const QByteArray &data, const QGeoCoordinate &searchCenter,
+                                const QString &requestUrl)
+{
+    ParsedSearch parsed;
+    const QJsonDocument document = QJsonDocument::fromJson(data);
+    if (!document.isArray())
+        return parsed;
+
+    QJsonArray resultsArray = document.array();
     for (int i = 0; i < resultsArray.count(); ++i) {
         QJsonObject item = resultsArray.at(i).toObject();
-        QPlaceResult pr = parsePlaceResult(item);
+        QPlaceResult pr = parsePlaceResult(item, requestUrl);
         pr.setDistance(searchCenter.distanceTo(pr.place().location().coordinate()));
-        placeIds.append(pr.place().placeId());
-        results.append(pr);
+        parsed.placeIds.append(pr.place().placeId());
+        parsed.results.append(pr);
+    }
+    parsed.ok = true;
+    return parsed;
+}
+
+void QPlaceSearchReplyOsm::replyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError)
+        return;
+
+    // Parsed on a worker thread, the reply finishes once the results are built
+    const QByteArray data = reply->readAll();
+    const QGeoCoordinate searchCenter = request().searchArea().center();
+    const QString url = requestUrl;
+    qParseReplyAsync(this, [data, searchCenter, url](const QGeoParseCancellation &) {
+        return parseSearch(data, searchCenter, url);
+    }, [this](const ParsedSearch &parsed) {
+        searchParsed(parsed.ok, parsed.results, parsed.placeIds);
+    });
+}
+
+void QPlaceSearchReplyOsm::searchParsed(bool ok, const QList<QPlaceSearchResult> &results,
+                                        const QStringList &placeIds)
+{
+    if (!ok) {
+        setError(ParseError, tr("Response parse error"));
+        return;
     }
 
     QVariantMap searchContext = request().searchContext().toMap();
@@ -172,64 +274,4 @@ void QPlaceSearchReplyOsm::networkError(QNetworkReply::NetworkError error)
     setError(QPlaceReply::CommunicationError, reply->errorString());
 }
 
-QPlaceResult QPlaceSearchReplyOsm::parsePlaceResult(const QJsonObject &item) const
-{
-    QPlace place;
-
-    QGeoCoordinate coordinate = QGeoCoordinate(item.value(QStringLiteral("lat")).toString().toDouble(),
-                                               item.value(QStringLiteral("lon")).toString().toDouble());
-
-    //const QString placeRank = item.value(QStringLiteral("place_rank")).toString();
-    //const QString category = item.value(QStringLiteral("category")).toString();
-    const QString type = item.value(QStringLiteral("type")).toString();
-    //double importance = item.value(QStringLiteral("importance")).toDouble();
-
-    place.setAttribution(item.value(QStringLiteral("licence")).toString());
-    place.setPlaceId(QString::number(item.value(QStringLiteral("place_id")).toInt()));
-
-    QVariantMap iconParameters;
-    iconParameters.insert(QPlaceIcon::SingleUrl,
-                          QUrl(item.value(QStringLiteral("icon")).toString()));
-    QPlaceIcon icon;
-    icon.setParameters(iconParameters);
-    place.setIcon(icon);
-
-    QJsonObject addressDetails = item.value(QStringLiteral("address")).toObject();
-
-    const QString title = addressDetails.value(type).toString();
-
-    place.setName(title);
-
-    if (!requestUrl.isEmpty()) {
-        QPlaceAttribute attribute;
-        attribute.setLabel("requestUrl");
-        attribute.setText(requestUrl);
-        place.setExtendedAttribute("requestUrl", attribute);
-    }
-
-    QGeoAddress address;
-    address.setCity(addressDetails.value(QStringLiteral("city")).toString());
-    address.setCountry(addressDetails.value(QStringLiteral("country")).toString());
-    // FIXME: country_code is alpha-2 setCountryCode takes alpha-3
-    //address.setCountryCode(addressDetails.value(QStringLiteral("country_code")).toString());
-    address.setPostalCode(addressDetails.value(QStringLiteral("postcode")).toString());
-    address.setStreet(addressDetails.value(QStringLiteral("road")).toString());
-    address.setState(addressDetails.value(QStringLiteral("state")).toString());
-    address.setDistrict(addressDetails.value(QStringLiteral("suburb")).toString());
-
-    QGeoLocation location;
-    location.setCoordinate(coordinate);
-    location.setAddress(address);
-    location.setBoundingBox(parseBoundingBox(item.value(QStringLiteral("boundingbox")).toArray()));
-
-    place.setLocation(location);
-
-    QPlaceResult result;
-    result.setIcon(icon);
-    result.setPlace(place);
-    result.setTitle(title);
-
-    return result;
-}
-
 QT_END_NAMESPACE
@@ -58,6 +58,9 @@ public:
                           QPlaceManagerEngineOsm *parent);
     ~QPlaceSearchReplyOsm();
 
+    void setNetworkReply(QNetworkReply *reply);
+    void supersede();
+
     QString requestUrl;
 
 private slots:
@@ -66,7 +69,7 @@ private slots:
     void networkError(QNetworkReply::NetworkError error);
 
 private:
-    QPlaceResult parsePlaceResult(const QJsonObject &item) const;
+    void searchParsed(bool ok, const QList<QPlaceSearchResult> &results, const QStringList &placeIds);
 };
 
 QT_END_NAMESPACE
@@ -39,12 +39,18 @@
 
 package org.qtproject.qt5.android.positioning;
 
+import android.app.PendingIntent;
+import android.content.BroadcastReceiver;
 import android.content.Context;
+import android.content.Intent;
+import android.content.IntentFilter;
 import android.location.GpsSatellite;
 import android.location.GpsStatus;
 import android.location.Location;
 import android.location.LocationListener;
 import android.location.LocationManager;
+import android.net.Uri;
+import android.os.Build;
 import android.os.Bundle;
 import android.os.Handler;
 import android.os.Looper;
@@ -63,6 +69,16 @@ public class QtPositioning implements LocationListener
     static Object m_syncObject = new Object();
     static HashMap<Integer, QtPositioning> runningListeners = new HashMap<Integer, QtPositioning>();
 
+    /*
+        The proximity alerts of the area monitors, by the key of their monitor
+        and their identifier, which also make the data of their intents.
+    */
+    private static final String PROXIMITY_SCHEME = "qtproximity";
+    private static final String PROXIMITY_ACTION = "org.qtproject.qt5.android.positioning.PROXIMITY_ALERT";
+    static Context appContext = null;
+    static HashMap<Uri, PendingIntent> proximityAlerts = new HashMap<Uri, PendingIntent>();
+    static BroadcastReceiver proximityReceiver = null;
+
     /*
         The positionInfo instance to which this
         QtPositioning instance is attached to.
@@ -103,6 +119,7 @@ public class QtPositioning implements LocationListener
     {
         try {
             locationManager = (LocationManager)context.getSystemService(Context.LOCATION_SERVICE);
+            appContext = context;
         } catch(Exception e) {
             e.printStackTrace();
         }
@@ -402,6 +419,114 @@ public class QtPositioning implements LocationListener
         }
     }
 
+    static private Uri proximityUri(int androidClassKey, String identifier)
+    {
+        return new Uri.Builder().scheme(PROXIMITY_SCHEME)
+                                .authority(Integer.toString(androidClassKey))
+                                .appendPath(identifier)
+                                .build();
+    }
+
+    static private void registerProximityReceiver()
+    {
+        if (proximityReceiver != null)
+            return;
+
+        proximityReceiver = new BroadcastReceiver() {
+            @Override
+            public void onReceive(Context context, Intent intent) {
+                Uri uri = intent.getData();
+                if (uri == null || uri.getAuthority() == null)
+                    return;
+
+                int androidClassKey;
+                try {
+                    androidClassKey = Integer.parseInt(uri.getAuthority());
+                } catch (NumberFormatException e) {
+                    return;
+                }
+                boolean entering = intent.getBooleanExtra(LocationManager.KEY_PROXIMITY_ENTERING, false);
+                Location location = null;
+                try {
+                    location = lastKnownPosition(false);
+                } catch (Exception e) {
+                    location = null;
+                }
+                proximityAlert(androidClassKey, uri.getLastPathSegment(), entering, location);
+            }
+        };
+
+        IntentFilter filter = new IntentFilter(PROXIMITY_ACTION);
+        filter.addDataScheme(PROXIMITY_SCHEME);
+        if (Build.VERSION.SDK_INT >= 33) {
+            // Context.RECEIVER_NOT_EXPORTED, the alerts come from our own pending intents
+            appContext.registerReceiver(proximityReceiver, filter, 4);
+        } else {
+            appContext.registerReceiver(proximityReceiver, filter);
+        }
+    }
+
+    /*
+        Registers a proximity alert for the circle, replacing the one with the
+        same identifier. Returns the values of QGeoAreaMonitorSource::Error.
+    */
+    static public int addProximityAlert(int androidClassKey, String identifier,
+                                        double latitude, double longitude, float radius)
+    {
+        synchronized (m_syncObject) {
+            try {
+                if (appContext == null || locationManager == null)
+                    return QT_POSITION_UNKNOWN_SOURCE_ERROR;
+
+                registerProximityReceiver();
+
+                Uri uri = proximityUri(androidClassKey, identifier);
+                PendingIntent previous = proximityAlerts.remove(uri);
+                if (previous != null) {
+                    locationManager.removeProximityAlert(previous);
+                    previous.cancel();
+                }
+
+                Intent intent = new Intent(PROXIMITY_ACTION, uri);
+                intent.setPackage(appContext.getPackageName());
+                int flags = PendingIntent.FLAG_UPDATE_CURRENT;
+                if (Build.VERSION.SDK_INT >= 31)
+                    flags |= 0x02000000; // PendingIntent.FLAG_MUTABLE, the system adds the extras
+                PendingIntent pendingIntent = PendingIntent.getBroadcast(appContext, 0, intent, flags);
+
+                try {
+                    // expiry is handled by Qt
+                    locationManager.addProximityAlert(latitude, longitude, radius, -1, pendingIntent);
+                } catch (SecurityException se) {
+                    se.printStackTrace();
+                    pendingIntent.cancel();
+                    return QT_ACCESS_ERROR;
+                }
+                proximityAlerts.put(uri, pendingIntent);
+            } catch(Exception e) {
+                e.printStackTrace();
+                return QT_POSITION_UNKNOWN_SOURCE_ERROR;
+            }
+
+            return QT_POSITION_NO_ERROR;
+        }
+    }
+
+    static public void removeProximityAlert(int androidClassKey, String identifier)
+    {
+        synchronized (m_syncObject) {
+            try {
+                PendingIntent pendingIntent = proximityAlerts.remove(proximityUri(androidClassKey, identifier));
+                if (pendingIntent != null) {
+                    locationManager.removeProximityAlert(pendingIntent);
+                    pendingIntent.cancel();
+                }
+            } catch(Exception e) {
+                e.printStackTrace();
+            }
+        }
+    }
+
     public QtPositioning()
     {
         looperThread = new PositioningLooper();
@@ -522,9 +647,11 @@ public class QtPositioning implements LocationListener
     }
 
     public static native void positionUpdated(Location update, int androidClassKey, boolean isSingleUpdate);
+    public static native void positionsUpdated(Location[] updates, int androidClassKey);
     public static native void locationProvidersDisabled(int androidClassKey);
     public static native void locationProvidersChanged(int androidClassKey);
     public static native void satelliteUpdated(GpsSatellite[] update, int androidClassKey, boolean isSingleUpdate);
+    public static native void proximityAlert(int androidClassKey, String identifier, boolean entering, Location location);
 
     @Override
     public void onLocationChanged(Location location) {
@@ -535,11 +662,40 @@ public class QtPositioning implements LocationListener
         if (isSatelliteUpdate) //we are a QGeoSatelliteInfoSource -> ignore
             return;
 
-        if (isSingleUpdate || expectedProviders < 3) {
+        if (acceptLocation(location))
             positionUpdated(location, nativeClassReference, isSingleUpdate);
+    }
+
+    /*
+        Locations batched by the system while the application is in the
+        background, delivered by Android 12 and later. The accepted ones
+        are passed on in one call.
+    */
+    public void onLocationChanged(List<Location> locations) {
+        if (locations == null || locations.isEmpty() || isSatelliteUpdate)
             return;
+
+        if (isSingleUpdate) {
+            onLocationChanged(locations.get(locations.size() - 1));
+            return;
+        }
+
+        ArrayList<Location> accepted = new ArrayList<Location>(locations.size());
+        for (Location location : locations) {
+            if (location != null && acceptLocation(location))
+                accepted.add(location);
         }
 
+        if (accepted.size() == 1)
+            positionUpdated(accepted.get(0), nativeClassReference, isSingleUpdate);
+        else if (!accepted.isEmpty())
+            positionsUpdated(accepted.toArray(new Location[accepted.size()]), nativeClassReference);
+    }
+
+    private boolean acceptLocation(Location location) {
+        if (isSingleUpdate || expectedProviders < 3)
+            return true;
+
         /*
             We can use GPS and Network, pick the better location provider.
             Generally we prefer GPS data due to their higher accurancy but we
@@ -550,25 +706,24 @@ public class QtPositioning implements LocationListener
             lastGps = location;
 
             // assumption: GPS always better -> pass it on
-            positionUpdated(location, nativeClassReference, isSingleUpdate);
+            return true;
         } else if (location.getProvider().equals(LocationManager.NETWORK_PROVIDER)) {
             lastNetwork = location;
 
-            if (lastGps == null) { //no GPS fix yet use network location
-                positionUpdated(location, nativeClassReference, isSingleUpdate);
-                return;
-            }
+            if (lastGps == null) //no GPS fix yet use network location
+                return true;
 
             long delta = location.getTime() - lastGps.getTime();
 
             // Ignore if network update is older than last GPS (delta < 0)
             // Ignore if gps update still has time to provide next location (delta < updateInterval)
             if (delta < updateIntervalTime)
-                return;
+                return false;
 
             // Use network data -> GPS has timed out on updateInterval
-            positionUpdated(location, nativeClassReference, isSingleUpdate);
+            return true;
         }
+        return false;
     }
 
     @Override
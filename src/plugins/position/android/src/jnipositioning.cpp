@@ -47,6 +47,7 @@
 #include <QGeoPositionInfo>
 #include "qgeopositioninfosource_android_p.h"
 #include "qgeosatelliteinfosource_android_p.h"
+#include "qgeoareamonitor_android_p.h"
 
 #include "jnipositioning.h"
 
@@ -59,6 +60,8 @@ static jmethodID startUpdatesMethodId;
 static jmethodID stopUpdatesMethodId;
 static jmethodID requestUpdateMethodId;
 static jmethodID startSatelliteUpdatesMethodId;
+static jmethodID addProximityAlertMethodId;
+static jmethodID removeProximityAlertMethodId;
 
 static const char logTag[] = "QtPositioning";
 static const char classErrorMsg[] = "Can't find class \"%s\"";
@@ -67,11 +70,14 @@ static const char methodErrorMsg[] = "Can't find method \"%s%s\"";
 namespace AndroidPositioning {
     typedef QMap<int, QGeoPositionInfoSourceAndroid * > PositionSourceMap;
     typedef QMap<int, QGeoSatelliteInfoSourceAndroid * > SatelliteSourceMap;
+    typedef QMap<int, QGeoAreaMonitorSourceAndroid * > AreaMonitorMap;
 
     Q_GLOBAL_STATIC(PositionSourceMap, idToPosSource)
 
     Q_GLOBAL_STATIC(SatelliteSourceMap, idToSatSource)
 
+    Q_GLOBAL_STATIC(AreaMonitorMap, idToAreaMonitor)
+
     struct AttachedJNIEnv
     {
         AttachedJNIEnv()
@@ -120,6 +126,14 @@ namespace AndroidPositioning {
             } while (idToSatSource()->contains(key));
 
             idToSatSource()->insert(key, src);
+        } else if (obj->inherits("QGeoAreaMonitorSource")) {
+            QGeoAreaMonitorSourceAndroid *src = qobject_cast<QGeoAreaMonitorSourceAndroid *>(obj);
+            Q_ASSERT(src);
+            do {
+                key = qAbs(int(QRandomGenerator::global()->generate()));
+            } while (idToAreaMonitor()->contains(key));
+
+            idToAreaMonitor()->insert(key, src);
         }
 
         return key;
@@ -129,6 +143,7 @@ namespace AndroidPositioning {
     {
         idToPosSource()->remove(key);
         idToSatSource()->remove(key);
+        idToAreaMonitor()->remove(key);
     }
 
     enum PositionProvider
@@ -476,6 +491,55 @@ namespace AndroidPositioning {
         return QGeoSatelliteInfoSource::UnknownSourceError;
     }
 
+    QGeoAreaMonitorSource::Error addProximityAlert(int androidClassKey, const QString &identifier,
+                                                  const QGeoCircle &circle)
+    {
+        AttachedJNIEnv env;
+        if (!env.jniEnv)
+            return QGeoAreaMonitorSource::UnknownSourceError;
+
+        if (!requestionPositioningPermissions(env.jniEnv))
+            return QGeoAreaMonitorSource::AccessError;
+
+        jstring jIdentifier = env.jniEnv->NewString(reinterpret_cast<const jchar *>(identifier.constData()),
+                                                    identifier.length());
+        int errorCode = env.jniEnv->CallStaticIntMethod(positioningClass, addProximityAlertMethodId,
+                                                        androidClassKey, jIdentifier,
+                                                        circle.center().latitude(),
+                                                        circle.center().longitude(),
+                                                        jfloat(circle.radius()));
+        env.jniEnv->DeleteLocalRef(jIdentifier);
+
+        //must be in sync with QtPositioning.addProximityAlert()
+        switch (errorCode) {
+        case 0:
+            return QGeoAreaMonitorSource::AccessError;
+        case 3:
+            return QGeoAreaMonitorSource::NoError;
+        default:
+            return QGeoAreaMonitorSource::UnknownSourceError;
+        }
+    }
+
+    void removeProximityAlert(int androidClassKey, const QString &identifier)
+    {
+        AttachedJNIEnv env;
+        if (!env.jniEnv)
+            return;
+
+        jstring jIdentifier = env.jniEnv->NewString(reinterpret_cast<const jchar *>(identifier.constData()),
+                                                    identifier.length());
+        env.jniEnv->CallStaticVoidMethod(positioningClass, removeProximityAlertMethodId,
+                                         androidClassKey, jIdentifier);
+        env.jniEnv->DeleteLocalRef(jIdentifier);
+    }
+
+    bool requestionPositioningPermissions()
+    {
+        AttachedJNIEnv env;
+        return env.jniEnv && requestionPositioningPermissions(env.jniEnv);
+    }
+
     bool requestionPositioningPermissions(JNIEnv *env)
     {
         using namespace QtAndroidPrivate;
@@ -518,6 +582,28 @@ static void positionUpdated(JNIEnv *env, jobject /*thiz*/, jobject location, jin
                               Q_ARG(QGeoPositionInfo, info));
 }
 
+static void positionsUpdated(JNIEnv *env, jobject /*thiz*/, jobjectArray locations, jint androidClassKey)
+{
+    const jsize count = env->GetArrayLength(locations);
+    QList<QGeoPositionInfo> infos;
+    infos.reserve(count);
+    for (jsize i = 0; i < count; ++i) {
+        jobject location = env->GetObjectArrayElement(locations, i);
+        infos.append(AndroidPositioning::positionInfoFromJavaLocation(env, location));
+        env->DeleteLocalRef(location);
+    }
+
+    QGeoPositionInfoSourceAndroid *source = AndroidPositioning::idToPosSource()->value(androidClassKey);
+    if (!source) {
+        qWarning("positionsUpdated: source == 0");
+        return;
+    }
+
+    //we need to invoke indirectly as the Looper thread is likely to be not the same thread
+    QMetaObject::invokeMethod(source, "processPositionUpdates", Qt::AutoConnection,
+                              Q_ARG(QList<QGeoPositionInfo>, infos));
+}
+
 static void locationProvidersDisabled(JNIEnv *env, jobject /*thiz*/, jint androidClassKey)
 {
     Q_UNUSED(env);
@@ -562,6 +648,33 @@ static void satelliteUpdated(JNIEnv *env, jobject /*thiz*/, jobjectArray satelli
                               Q_ARG(QList<QGeoSatelliteInfo>, inUse), Q_ARG(bool, isSingleUpdate));
 }
 
+static void proximityAlert(JNIEnv *env, jobject /*thiz*/, jint androidClassKey, jstring identifier,
+                           jboolean entering, jobject location)
+{
+    if (!identifier)
+        return;
+
+    QGeoPositionInfo info;
+    if (location)
+        info = AndroidPositioning::positionInfoFromJavaLocation(env, location);
+    else
+        info.setTimestamp(QDateTime::currentDateTimeUtc());
+
+    const jchar *chars = env->GetStringChars(identifier, nullptr);
+    const QString id(reinterpret_cast<const QChar *>(chars), env->GetStringLength(identifier));
+    env->ReleaseStringChars(identifier, chars);
+
+    QGeoAreaMonitorSourceAndroid *source = AndroidPositioning::idToAreaMonitor()->value(androidClassKey);
+    if (!source) {
+        qWarning("proximityAlert: source == 0");
+        return;
+    }
+
+    //the alerts are received on the main thread of the application
+    QMetaObject::invokeMethod(source, "processProximityAlert", Qt::AutoConnection,
+                              Q_ARG(QString, id), Q_ARG(bool, entering),
+                              Q_ARG(QGeoPositionInfo, info));
+}
 
 #define FIND_AND_CHECK_CLASS(CLASS_NAME) \
 clazz = env->FindClass(CLASS_NAME); \
@@ -579,9 +692,11 @@ if (!VAR) { \
 
 static JNINativeMethod methods[] = {
     {"positionUpdated", "(Landroid/location/Location;IZ)V", (void *)positionUpdated},
+    {"positionsUpdated", "([Landroid/location/Location;I)V", (void *)positionsUpdated},
     {"locationProvidersDisabled", "(I)V", (void *) locationProvidersDisabled},
     {"satelliteUpdated", "([Landroid/location/GpsSatellite;IZ)V", (void *)satelliteUpdated},
-    {"locationProvidersChanged", "(I)V", (void *) locationProvidersChanged}
+    {"locationProvidersChanged", "(I)V", (void *) locationProvidersChanged},
+    {"proximityAlert", "(ILjava/lang/String;ZLandroid/location/Location;)V", (void *) proximityAlert}
 };
 
 static bool registerNatives(JNIEnv *env)
@@ -601,6 +716,8 @@ static bool registerNatives(JNIEnv *env)
     GET_AND_CHECK_STATIC_METHOD(stopUpdatesMethodId, positioningClass, "stopUpdates", "(I)V");
     GET_AND_CHECK_STATIC_METHOD(requestUpdateMethodId, positioningClass, "requestUpdate", "(II)I");
     GET_AND_CHECK_STATIC_METHOD(startSatelliteUpdatesMethodId, positioningClass, "startSatelliteUpdates", "(IIZ)I");
+    GET_AND_CHECK_STATIC_METHOD(addProximityAlertMethodId, positioningClass, "addProximityAlert", "(ILjava/lang/String;DDF)I");
+    GET_AND_CHECK_STATIC_METHOD(removeProximityAlertMethodId, positioningClass, "removeProximityAlert", "(ILjava/lang/String;)V");
 
     return true;
 }
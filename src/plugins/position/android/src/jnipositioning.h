@@ -43,6 +43,8 @@
 #include <jni.h>
 #include <QGeoPositionInfoSource>
 #include <QGeoSatelliteInfoSource>
+#include <QGeoAreaMonitorSource>
+#include <QGeoCircle>
 
 namespace AndroidPositioning
 {
@@ -59,7 +61,13 @@ namespace AndroidPositioning
     QGeoSatelliteInfoSource::Error startSatelliteUpdates(int androidClassKey,
                                                          bool isSingleRequest,
                                                          int updateRequestTimeout);
+
+    QGeoAreaMonitorSource::Error addProximityAlert(int androidClassKey, const QString &identifier,
+                                                  const QGeoCircle &circle);
+    void removeProximityAlert(int androidClassKey, const QString &identifier);
+
     bool requestionPositioningPermissions(JNIEnv *env);
+    bool requestionPositioningPermissions();
 }
 
 #endif // JNIPOSITIONING_H
@@ -40,6 +40,7 @@
 #include "positionfactory_android.h"
 #include "qgeopositioninfosource_android_p.h"
 #include "qgeosatelliteinfosource_android_p.h"
+#include "qgeoareamonitor_android_p.h"
 
 QGeoPositionInfoSource *QGeoPositionInfoSourceFactoryAndroid::positionInfoSource(QObject *parent)
 {
@@ -55,6 +56,6 @@ QGeoSatelliteInfoSource *QGeoPositionInfoSourceFactoryAndroid::satelliteInfoSour
 
 QGeoAreaMonitorSource *QGeoPositionInfoSourceFactoryAndroid::areaMonitor(QObject *parent)
 {
-    Q_UNUSED(parent);
-    return 0;
+    QGeoAreaMonitorSourceAndroid *src = new QGeoAreaMonitorSourceAndroid(parent);
+    return src;
 }
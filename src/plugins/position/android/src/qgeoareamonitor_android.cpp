@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoareamonitor_android_p.h"
+#include "jnipositioning.h"
+
+#include <limits>
+
+// The geofences the system monitors for an application at most
+#define MAXIMUM_REGIONS 100
+
+QGeoAreaMonitorSourceAndroid::QGeoAreaMonitorSourceAndroid(QObject *parent)
+    : QGeoAreaMonitorRegionSource(parent)
+{
+    androidClassKey = AndroidPositioning::registerPositionInfoSource(this);
+    qRegisterMetaType<QGeoPositionInfo>();
+
+    // Proximity alerts have no maximum radius
+    setRegionLimits(MAXIMUM_REGIONS, std::numeric_limits<double>::max());
+}
+
+QGeoAreaMonitorSourceAndroid::~QGeoAreaMonitorSourceAndroid()
+{
+    stopRegions();
+    AndroidPositioning::unregisterPositionInfoSource(androidClassKey);
+}
+
+void QGeoAreaMonitorSourceAndroid::processProximityAlert(const QString &identifier, bool entering,
+                                                         const QGeoPositionInfo &update)
+{
+    regionEvent(identifier, update, entering);
+}
+
+bool QGeoAreaMonitorSourceAndroid::enableRegions()
+{
+    return AndroidPositioning::requestionPositioningPermissions();
+}
+
+QGeoPositionInfo QGeoAreaMonitorSourceAndroid::lastKnownPosition() const
+{
+    return AndroidPositioning::lastKnownPosition(false);
+}
+
+bool QGeoAreaMonitorSourceAndroid::startRegion(const QString &identifier, const QGeoCircle &circle)
+{
+    const QGeoAreaMonitorSource::Error error =
+            AndroidPositioning::addProximityAlert(androidClassKey, identifier, circle);
+    if (error == QGeoAreaMonitorSource::AccessError)
+        setError(error);
+    return error == QGeoAreaMonitorSource::NoError;
+}
+
+void QGeoAreaMonitorSourceAndroid::stopRegion(const QString &identifier)
+{
+    AndroidPositioning::removeProximityAlert(androidClassKey, identifier);
+}
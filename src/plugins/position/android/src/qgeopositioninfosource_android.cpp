@@ -41,6 +41,7 @@
 #include "jnipositioning.h"
 //#include <QDebug>
 #include <QGeoPositionInfo>
+#include <QtPositioning/private/qgeopositioninfosource_p.h>
 
 #define UPDATE_FROM_COLD_START 2*60*1000
 
@@ -50,6 +51,7 @@ QGeoPositionInfoSourceAndroid::QGeoPositionInfoSourceAndroid(QObject *parent) :
 {
     androidClassKeyForUpdate = AndroidPositioning::registerPositionInfoSource(this);
     androidClassKeyForSingleRequest = AndroidPositioning::registerPositionInfoSource(this);
+    qRegisterMetaType<QList<QGeoPositionInfo> >();
 
     //qDebug() << "androidClassKey: "  << androidClassKeyForUpdate << androidClassKeyForSingleRequest;
     //by default use all methods
@@ -191,6 +193,17 @@ void QGeoPositionInfoSourceAndroid::processPositionUpdate(const QGeoPositionInfo
     emit positionUpdated(pInfo);
 }
 
+void QGeoPositionInfoSourceAndroid::processPositionUpdates(const QList<QGeoPositionInfo> &updates)
+{
+    if (updates.isEmpty())
+        return;
+
+    if (m_requestTimer.isActive())
+        m_requestTimer.stop();
+
+    QGeoPositionInfoSourcePrivate::get(*this)->deliverPositions(this, updates);
+}
+
 // Might still be called multiple times (once for each provider)
 void QGeoPositionInfoSourceAndroid::processSinglePositionUpdate(const QGeoPositionInfo &pInfo)
 {
@@ -76,6 +76,7 @@ public Q_SLOTS:
     virtual void requestUpdate(int timeout = 0);
 
     void processPositionUpdate(const QGeoPositionInfo& pInfo);
+    void processPositionUpdates(const QList<QGeoPositionInfo> &updates);
     void processSinglePositionUpdate(const QGeoPositionInfo& pInfo);
 
     void locationProviderDisabled();
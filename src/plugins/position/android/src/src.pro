@@ -1,18 +1,20 @@
 TARGET = qtposition_android
 
-QT = core core-private positioning
+QT = core core-private positioning positioning-private
 
 HEADERS = \
     positionfactory_android.h \
     qgeopositioninfosource_android_p.h \
     jnipositioning.h \
-    qgeosatelliteinfosource_android_p.h
+    qgeosatelliteinfosource_android_p.h \
+    qgeoareamonitor_android_p.h
 
 SOURCES = \
     positionfactory_android.cpp \
     qgeopositioninfosource_android.cpp \
     jnipositioning.cpp \
-    qgeosatelliteinfosource_android.cpp
+    qgeosatelliteinfosource_android.cpp \
+    qgeoareamonitor_android.cpp
 
 OTHER_FILES = plugin.json
 
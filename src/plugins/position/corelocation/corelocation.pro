@@ -1,6 +1,6 @@
 TARGET = qtposition_cl
 
-QT = core core-private positioning
+QT = core core-private positioning positioning-private
 
 OBJECTIVE_SOURCES += \
     qgeopositioninfosource_cl.mm \
@@ -10,6 +10,11 @@ HEADERS += \
     qgeopositioninfosource_cl_p.h \
     qgeopositioninfosourcefactory_cl.h
 
+!tvos:!watchos {
+    OBJECTIVE_SOURCES += qgeoareamonitor_cl.mm
+    HEADERS += qgeoareamonitor_cl_p.h
+}
+
 OTHER_FILES += \
     plugin.json
 
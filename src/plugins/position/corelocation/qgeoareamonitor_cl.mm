@@ -0,0 +1,243 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/qglobal.h>
+
+#include "qgeoareamonitor_cl_p.h"
+
+// The regions the platform monitors for an application at most
+#define MAXIMUM_REGIONS 20
+
+// Regions of earlier runs of the application, left with the platform when it
+// quit, start with this prefix
+static NSString * const regionPrefix = @"org.qt-project.qt.areamonitor.";
+
+@interface AreaMonitorDelegate : NSObject <CLLocationManagerDelegate>
+@end
+
+@implementation AreaMonitorDelegate
+{
+    QGeoAreaMonitorSourceCL *m_monitorSource;
+}
+
+- (instancetype)initWithMonitorSource:(QGeoAreaMonitorSourceCL *)monitorSource
+{
+    if ((self = [self init])) {
+        m_monitorSource = monitorSource;
+    }
+    return self;
+}
+
+- (void)locationManager:(CLLocationManager *)manager didChangeAuthorizationStatus:(CLAuthorizationStatus)status
+{
+    Q_UNUSED(manager)
+    if (status == kCLAuthorizationStatusDenied || status == kCLAuthorizationStatusRestricted)
+        m_monitorSource->setError(QGeoAreaMonitorSource::AccessError);
+}
+
+- (void)locationManager:(CLLocationManager *)manager didEnterRegion:(CLRegion *)region
+{
+    Q_UNUSED(manager);
+    m_monitorSource->regionEvent(region, true);
+}
+
+- (void)locationManager:(CLLocationManager *)manager didExitRegion:(CLRegion *)region
+{
+    Q_UNUSED(manager);
+    m_monitorSource->regionEvent(region, false);
+}
+
+- (void)locationManager:(CLLocationManager *)manager monitoringDidFailForRegion:(CLRegion *)region withError:(NSError *)error
+{
+    Q_UNUSED(manager);
+    qWarning() << "Region monitoring failed:" << QString::fromNSString([error localizedDescription]);
+    if (region)
+        m_monitorSource->regionFailed(region);
+    else
+        m_monitorSource->setError(QGeoAreaMonitorSource::UnknownSourceError);
+}
+
+- (void)locationManager:(CLLocationManager *)manager didFailWithError:(NSError *)error
+{
+    Q_UNUSED(manager);
+    Q_UNUSED(error);
+    m_monitorSource->setError(QGeoAreaMonitorSource::AccessError);
+}
+@end
+
+QT_BEGIN_NAMESPACE
+
+QGeoAreaMonitorSourceCL::QGeoAreaMonitorSourceCL(QObject *parent)
+    : QGeoAreaMonitorRegionSource(parent)
+    , m_locationManager([[CLLocationManager alloc] init])
+{
+    static QAtomicInt serial;
+    const int id = serial.fetchAndAddRelaxed(1);
+    m_regionPrefix = QString::fromNSString(regionPrefix) + QString::number(id) + QLatin1Char('.');
+
+    // Persistent monitors are not supported, stop those the previous run
+    // of the application left
+    if (id == 0) {
+        for (CLRegion *region in [m_locationManager.monitoredRegions allObjects]) {
+            if ([region.identifier hasPrefix:regionPrefix])
+                [m_locationManager stopMonitoringForRegion:region];
+        }
+    }
+
+    // The maximum distance is negative if region monitoring is not available
+    if ([CLLocationManager isMonitoringAvailableForClass:[CLCircularRegion class]])
+        setRegionLimits(MAXIMUM_REGIONS, qMax(0.0, double(m_locationManager.maximumRegionMonitoringDistance)));
+
+    m_locationManager.delegate = [[AreaMonitorDelegate alloc] initWithMonitorSource:this];
+}
+
+QGeoAreaMonitorSourceCL::~QGeoAreaMonitorSourceCL()
+{
+    stopRegions();
+
+    id delegate = m_locationManager.delegate;
+    m_locationManager.delegate = nil;
+    [delegate release];
+    [m_locationManager release];
+}
+
+bool QGeoAreaMonitorSourceCL::regionIdentifier(CLRegion *region, QString *identifier) const
+{
+    const QString regionIdentifier = QString::fromNSString(region.identifier);
+    if (!regionIdentifier.startsWith(m_regionPrefix))
+        return false;
+
+    *identifier = regionIdentifier.mid(m_regionPrefix.size());
+    return true;
+}
+
+void QGeoAreaMonitorSourceCL::regionEvent(CLRegion *region, bool entered)
+{
+    QString identifier;
+    if (regionIdentifier(region, &identifier))
+        QGeoAreaMonitorRegionSource::regionEvent(identifier, lastKnownPosition(), entered);
+}
+
+void QGeoAreaMonitorSourceCL::regionFailed(CLRegion *region)
+{
+    QString identifier;
+    if (regionIdentifier(region, &identifier))
+        QGeoAreaMonitorRegionSource::regionFailed(identifier);
+}
+
+bool QGeoAreaMonitorSourceCL::enableRegions()
+{
+    if (![CLLocationManager locationServicesEnabled])
+        return false;
+
+    switch ([CLLocationManager authorizationStatus]) {
+    case kCLAuthorizationStatusRestricted:
+    case kCLAuthorizationStatusDenied:
+        return false;
+    case kCLAuthorizationStatusNotDetermined:
+#ifndef Q_OS_MACOS
+    {
+        // Regions are only monitored in the background with the always
+        // authorization, which needs both entries in Info.plist
+        NSDictionary<NSString *, id> *infoDict = NSBundle.mainBundle.infoDictionary;
+        const bool hasAlwaysUseUsage = !![infoDict objectForKey:@"NSLocationAlwaysAndWhenInUseUsageDescription"];
+        const bool hasWhenInUseUsage = !![infoDict objectForKey:@"NSLocationWhenInUseUsageDescription"];
+        if (hasAlwaysUseUsage && hasWhenInUseUsage)
+            [m_locationManager requestAlwaysAuthorization];
+        else if (hasWhenInUseUsage)
+            [m_locationManager requestWhenInUseAuthorization];
+    }
+#endif // !Q_OS_MACOS
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+QGeoPositionInfo QGeoAreaMonitorSourceCL::lastKnownPosition() const
+{
+    CLLocation *location = m_locationManager.location;
+    if (!location || location.horizontalAccuracy < 0)
+        return QGeoPositionInfo(QGeoCoordinate(), QDateTime::currentDateTimeUtc());
+
+    NSTimeInterval locationTimeStamp = [location.timestamp timeIntervalSince1970];
+    const QDateTime timeStamp = QDateTime::fromMSecsSinceEpoch(qRound64(locationTimeStamp * 1000), Qt::UTC);
+    QGeoPositionInfo info(QGeoCoordinate(location.coordinate.latitude,
+                                         location.coordinate.longitude,
+                                         location.altitude),
+                          timeStamp);
+    info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, location.horizontalAccuracy);
+    if (location.verticalAccuracy >= 0)
+        info.setAttribute(QGeoPositionInfo::VerticalAccuracy, location.verticalAccuracy);
+    return info;
+}
+
+bool QGeoAreaMonitorSourceCL::startRegion(const QString &identifier, const QGeoCircle &circle)
+{
+    CLCircularRegion *region = [[CLCircularRegion alloc]
+            initWithCenter:CLLocationCoordinate2DMake(circle.center().latitude(),
+                                                      circle.center().longitude())
+                    radius:circle.radius()
+                identifier:(m_regionPrefix + identifier).toNSString()];
+    region.notifyOnEntry = YES;
+    region.notifyOnExit = YES;
+    [m_locationManager startMonitoringForRegion:region];
+    [region release];
+    // Failures are reported to the delegate
+    return true;
+}
+
+void QGeoAreaMonitorSourceCL::stopRegion(const QString &identifier)
+{
+    NSString *regionIdentifier = (m_regionPrefix + identifier).toNSString();
+    for (CLRegion *region in [m_locationManager.monitoredRegions allObjects]) {
+        if ([region.identifier isEqualToString:regionIdentifier]) {
+            [m_locationManager stopMonitoringForRegion:region];
+            break;
+        }
+    }
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qgeoareamonitor_cl_p.cpp"
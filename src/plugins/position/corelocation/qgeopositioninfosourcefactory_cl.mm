@@ -38,6 +38,9 @@
 ****************************************************************************/
 
 #include "qgeopositioninfosource_cl_p.h"
+#if !defined(Q_OS_TVOS) && !defined(Q_OS_WATCHOS)
+#include "qgeoareamonitor_cl_p.h"
+#endif
 #include "qgeopositioninfosourcefactory_cl.h"
 
 QGeoPositionInfoSource *QGeoPositionInfoSourceFactoryCL::positionInfoSource(QObject *parent)
@@ -53,6 +56,11 @@ QGeoSatelliteInfoSource *QGeoPositionInfoSourceFactoryCL::satelliteInfoSource(QO
 
 QGeoAreaMonitorSource *QGeoPositionInfoSourceFactoryCL::areaMonitor(QObject *parent)
 {
+#if !defined(Q_OS_TVOS) && !defined(Q_OS_WATCHOS)
+    return new QGeoAreaMonitorSourceCL(parent);
+#else
+    // Region monitoring is not available there
     Q_UNUSED(parent);
     return 0;
+#endif
 }
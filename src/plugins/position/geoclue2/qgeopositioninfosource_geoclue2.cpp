@@ -7,6 +7,7 @@
 #include <QtCore/QSaveFile>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QTimer>
+#include <QtDBus/QDBusMessage>
 #include <QtDBus/QDBusPendingCallWatcher>
 
 // Auto-generated D-Bus files.
@@ -277,14 +278,45 @@ void QGeoPositionInfoSourceGeoclue2::startClient()
             setError(AccessError);
         } else {
             qCDebug(lcPositioningGeoclue2) << "Client successfully started";
+            readCurrentLocation();
+        }
+    });
+}
 
-            const QDBusObjectPath location = m_client->location();
-            const QString path = location.path();
-            if (path.isEmpty() || path == QLatin1String("/"))
-                return;
+/*
+    Reads the location the started client may already have, without
+    blocking on the property as the generated proxy would.
+*/
+void QGeoPositionInfoSourceGeoclue2::readCurrentLocation()
+{
+    if (!m_client)
+        return;
 
-            handleNewLocation({}, location);
+    QDBusMessage message = QDBusMessage::createMethodCall(
+                QLatin1String(GEOCLUE2_SERVICE_NAME), m_client->path(),
+                QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("Get"));
+    message << QLatin1String(OrgFreedesktopGeoClue2ClientInterface::staticInterfaceName())
+            << QStringLiteral("Location");
+    const QDBusPendingCall call = QDBusConnection::systemBus().asyncCall(message);
+    const auto watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this,
+            [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        const QDBusPendingReply<QDBusVariant> reply = *watcher;
+        if (reply.isError())
+            return;
+
+        const QDBusObjectPath location
+                = qvariant_cast<QDBusObjectPath>(reply.value().variant());
+        const QString path = location.path();
+        // a LocationUpdated signal may have been handled meanwhile, possibly
+        // with the same location, which must not be emitted twice
+        if (path.isEmpty() || path == QLatin1String("/") || !m_locationPath.isEmpty()
+                || path == m_lastLocationPath) {
+            return;
         }
+
+        handleNewLocation({}, location);
     });
 }
 
@@ -375,47 +407,67 @@ void QGeoPositionInfoSourceGeoclue2::handleNewLocation(const QDBusObjectPath &ol
     qCDebug(lcPositioningGeoclue2) << "Old location object path:" << oldPath;
     qCDebug(lcPositioningGeoclue2) << "New location object path:" << newPath;
 
-    OrgFreedesktopGeoClue2LocationInterface location(
-                QLatin1String(GEOCLUE2_SERVICE_NAME),
-                newPath,
-                QDBusConnection::systemBus(),
-                this);
-    if (!location.isValid()) {
-        const auto error = location.lastError();
-        qCCritical(lcPositioningGeoclue2) << "Unable to create the location object:"
-                                          << error.name() << error.message();
-    } else {
-        QGeoCoordinate coordinate(location.latitude(),
-                                  location.longitude());
-        const auto altitude = location.altitude();
-        if (altitude > std::numeric_limits<double>::lowest())
-            coordinate.setAltitude(altitude);
-
-        const Timestamp ts = location.timestamp();
-        if (ts.m_seconds == 0 && ts.m_microseconds == 0) {
-            const auto dt = QDateTime::currentDateTime();
-            m_lastPosition = QGeoPositionInfo(coordinate, dt);
+    // Read all the properties of the location in one round trip. Only the
+    // reply for the latest location is used, older ones may arrive after it.
+    m_locationPath = newPath;
+    m_lastLocationPath = newPath;
+    QDBusMessage message = QDBusMessage::createMethodCall(
+                QLatin1String(GEOCLUE2_SERVICE_NAME), newPath,
+                QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("GetAll"));
+    message << QLatin1String(OrgFreedesktopGeoClue2LocationInterface::staticInterfaceName());
+    const QDBusPendingCall call = QDBusConnection::systemBus().asyncCall(message);
+    const auto watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this,
+            [this, newPath](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (newPath != m_locationPath)
+            return;
+        m_locationPath.clear();
+
+        const QDBusPendingReply<QVariantMap> reply = *watcher;
+        if (reply.isError()) {
+            const auto error = reply.error();
+            qCCritical(lcPositioningGeoclue2) << "Unable to read the location object:"
+                                              << error.name() << error.message();
         } else {
-            auto dt = QDateTime::fromSecsSinceEpoch(qint64(ts.m_seconds));
-            dt = dt.addMSecs(ts.m_microseconds / 1000);
-            m_lastPosition = QGeoPositionInfo(coordinate, dt);
+            handleLocationProperties(reply.value());
         }
 
-        const auto accuracy = location.accuracy();
-        m_lastPosition.setAttribute(QGeoPositionInfo::HorizontalAccuracy, accuracy);
-
-        const auto speed = location.speed();
-        if (speed >= 0.0)
-            m_lastPosition.setAttribute(QGeoPositionInfo::GroundSpeed, speed);
-        const auto heading = location.heading();
-        if (heading >= 0.0)
-            m_lastPosition.setAttribute(QGeoPositionInfo::Direction, heading);
+        stopClient();
+    });
+}
 
-        emit positionUpdated(m_lastPosition);
-        qCDebug(lcPositioningGeoclue2) << "New position:" << m_lastPosition;
+void QGeoPositionInfoSourceGeoclue2::handleLocationProperties(const QVariantMap &properties)
+{
+    QGeoCoordinate coordinate(properties.value(QStringLiteral("Latitude")).toDouble(),
+                              properties.value(QStringLiteral("Longitude")).toDouble());
+    const auto altitude = properties.value(QStringLiteral("Altitude"),
+                                           std::numeric_limits<double>::lowest()).toDouble();
+    if (altitude > std::numeric_limits<double>::lowest())
+        coordinate.setAltitude(altitude);
+
+    const Timestamp ts = qdbus_cast<Timestamp>(properties.value(QStringLiteral("Timestamp")));
+    if (ts.m_seconds == 0 && ts.m_microseconds == 0) {
+        const auto dt = QDateTime::currentDateTime();
+        m_lastPosition = QGeoPositionInfo(coordinate, dt);
+    } else {
+        auto dt = QDateTime::fromSecsSinceEpoch(qint64(ts.m_seconds));
+        dt = dt.addMSecs(ts.m_microseconds / 1000);
+        m_lastPosition = QGeoPositionInfo(coordinate, dt);
     }
 
-    stopClient();
+    const auto accuracy = properties.value(QStringLiteral("Accuracy")).toDouble();
+    m_lastPosition.setAttribute(QGeoPositionInfo::HorizontalAccuracy, accuracy);
+
+    const auto speed = properties.value(QStringLiteral("Speed"), -1.0).toDouble();
+    if (speed >= 0.0)
+        m_lastPosition.setAttribute(QGeoPositionInfo::GroundSpeed, speed);
+    const auto heading = properties.value(QStringLiteral("Heading"), -1.0).toDouble();
+    if (heading >= 0.0)
+        m_lastPosition.setAttribute(QGeoPositionInfo::Direction, heading);
+
+    emit positionUpdated(m_lastPosition);
+    qCDebug(lcPositioningGeoclue2) << "New position:" << m_lastPosition;
 }
 
 QT_END_NAMESPACE
@@ -44,8 +44,10 @@ private:
     void startClient();
     void stopClient();
     void requestUpdateTimeout();
+    void readCurrentLocation();
     void handleNewLocation(const QDBusObjectPath &oldLocation,
                            const QDBusObjectPath &newLocation);
+    void handleLocationProperties(const QVariantMap &properties);
 
     QTimer *m_requestTimer = nullptr;
     OrgFreedesktopGeoClue2ManagerInterface m_manager;
@@ -53,6 +55,8 @@ private:
     bool m_running = false;
     QGeoPositionInfoSource::Error m_error = NoError;
     QGeoPositionInfo m_lastPosition;
+    QString m_locationPath; // of the location being read
+    QString m_lastLocationPath; // of the latest location handled
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,18 @@
+TARGET = qtposition_multiplexer
+
+QT = core positioning
+
+HEADERS += \
+    qgeopositioninfosource_multiplexer_p.h \
+    qgeopositioninfosourcefactory_multiplexer.h
+
+SOURCES += \
+    qgeopositioninfosource_multiplexer.cpp \
+    qgeopositioninfosourcefactory_multiplexer.cpp
+
+OTHER_FILES += \
+    plugin.json
+
+PLUGIN_TYPE = position
+PLUGIN_CLASS_NAME = QGeoPositionInfoSourceFactoryMultiplexer
+load(qt_plugin)
@@ -0,0 +1,490 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeopositioninfosource_multiplexer_p.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+static const auto parameterPrefix = "multiplexer.";
+// The accuracy in meters assumed for the positions which have none
+static const qreal UnknownAccuracy = 100;
+
+// Accepts a list of names or "name,name"
+static QStringList toSourceNames(const QVariant &value)
+{
+    const QStringList entries = value.type() == QVariant::String
+            ? value.toString().split(QLatin1Char(','), Qt::SkipEmptyParts)
+            : value.toStringList();
+
+    QStringList names;
+    for (const QString &entry : entries) {
+        const QString name = entry.trimmed();
+        if (!name.isEmpty() && !names.contains(name))
+            names.append(name);
+    }
+    return names;
+}
+
+static qreal horizontalAccuracy(const QGeoPositionInfo &position)
+{
+    if (!position.hasAttribute(QGeoPositionInfo::HorizontalAccuracy))
+        return UnknownAccuracy;
+    return position.attribute(QGeoPositionInfo::HorizontalAccuracy);
+}
+
+static double wrapLongitude(double longitude)
+{
+    if (longitude > 180.0)
+        return longitude - 360.0;
+    if (longitude < -180.0)
+        return longitude + 360.0;
+    return longitude;
+}
+
+QGeoPositionInfoSourceMultiplexer::QGeoPositionInfoSourceMultiplexer(const QVariantMap &parameters,
+                                                                     QObject *parent)
+    : QGeoPositionInfoSource(parent)
+{
+    init(parameters);
+
+    const QStringList names = toSourceNames(parameters.value(QLatin1String(parameterPrefix)
+                                                             + QLatin1String("sources")));
+    for (const QString &name : names) {
+        if (name == QLatin1String("multiplexer"))
+            continue;
+
+        // The parameters of all the sources are given together
+        QGeoPositionInfoSource *source = QGeoPositionInfoSource::createSource(name, parameters, this);
+        if (!source) {
+            qWarning("The multiplexed position source %s is not available", qPrintable(name));
+            continue;
+        }
+        addSource(source);
+    }
+}
+
+/*
+    Multiplexes the given sources, the primary first, which the multiplexer
+    takes over. The sources named in the parameters are ignored.
+*/
+QGeoPositionInfoSourceMultiplexer::QGeoPositionInfoSourceMultiplexer(const QList<QGeoPositionInfoSource *> &sources,
+                                                                     const QVariantMap &parameters,
+                                                                     QObject *parent)
+    : QGeoPositionInfoSource(parent)
+{
+    init(parameters);
+    for (QGeoPositionInfoSource *source : sources) {
+        source->setParent(this);
+        addSource(source);
+    }
+}
+
+void QGeoPositionInfoSourceMultiplexer::init(const QVariantMap &parameters)
+{
+    auto parameter = [&parameters](const char *name) {
+        return parameters.value(QLatin1String(parameterPrefix) + QLatin1String(name));
+    };
+
+    m_fuse = parameter("mode").toString() == QLatin1String("fuse");
+    if (parameter("power_save").isValid())
+        m_powerSave = parameter("power_save").toBool();
+    if (parameter("max_age").isValid())
+        m_maximumAge = qMax(1, parameter("max_age").toInt());
+    if (parameter("speed").isValid())
+        m_speed = qMax<qreal>(0, parameter("speed").toDouble());
+    if (parameter("healthy_accuracy").isValid())
+        m_healthyAccuracy = qMax<qreal>(0, parameter("healthy_accuracy").toDouble());
+
+    m_clock.start();
+    m_primaryTimer.setSingleShot(true);
+    connect(&m_primaryTimer, &QTimer::timeout, this, &QGeoPositionInfoSourceMultiplexer::primaryTimedOut);
+    m_requestTimer.setSingleShot(true);
+    connect(&m_requestTimer, &QTimer::timeout, this, &QGeoPositionInfoSourceMultiplexer::finishRequest);
+}
+
+void QGeoPositionInfoSourceMultiplexer::addSource(QGeoPositionInfoSource *source)
+{
+    const int index = m_sources.size();
+    m_sources.append({ source, QGeoPositionInfo(), -1, false, false, false });
+    connect(source, &QGeoPositionInfoSource::positionUpdated,
+            this, [this, index](const QGeoPositionInfo &update) { sourceUpdated(index, update); });
+    connect(source, &QGeoPositionInfoSource::updateTimeout,
+            this, [this, index]() { sourceTimedOut(index); });
+    connect(source, QOverload<QGeoPositionInfoSource::Error>::of(&QGeoPositionInfoSource::error),
+            this, [this, index](QGeoPositionInfoSource::Error error) { sourceError(index, error); });
+    connect(source, &QGeoPositionInfoSource::supportedPositioningMethodsChanged,
+            this, &QGeoPositionInfoSource::supportedPositioningMethodsChanged);
+}
+
+QGeoPositionInfoSourceMultiplexer::~QGeoPositionInfoSourceMultiplexer()
+{
+}
+
+void QGeoPositionInfoSourceMultiplexer::setUpdateInterval(int msec)
+{
+    QGeoPositionInfoSource::setUpdateInterval(msec);
+    for (const Source &source : qAsConst(m_sources))
+        source.source->setUpdateInterval(msec);
+}
+
+void QGeoPositionInfoSourceMultiplexer::setPreferredPositioningMethods(PositioningMethods methods)
+{
+    QGeoPositionInfoSource::setPreferredPositioningMethods(methods);
+    for (const Source &source : qAsConst(m_sources))
+        source.source->setPreferredPositioningMethods(methods);
+}
+
+QGeoPositionInfo QGeoPositionInfoSourceMultiplexer::lastKnownPosition(bool fromSatellitePositioningMethodsOnly) const
+{
+    // The last positions may be from before the sources were created, so
+    // their ages are taken from their timestamps
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    QGeoPositionInfo best;
+    double bestUncertainty = std::numeric_limits<double>::infinity();
+    for (const Source &source : m_sources) {
+        const QGeoPositionInfo position =
+                source.source->lastKnownPosition(fromSatellitePositioningMethodsOnly);
+        if (!position.isValid())
+            continue;
+
+        const double seconds = qMax<qint64>(0, position.timestamp().msecsTo(now)) / 1000.0;
+        const double uncertainty = horizontalAccuracy(position) + m_speed * seconds;
+        if (uncertainty < bestUncertainty) {
+            best = position;
+            bestUncertainty = uncertainty;
+        }
+    }
+    return best;
+}
+
+QGeoPositionInfoSource::PositioningMethods QGeoPositionInfoSourceMultiplexer::supportedPositioningMethods() const
+{
+    PositioningMethods methods = NoPositioningMethods;
+    for (const Source &source : m_sources)
+        methods |= source.source->supportedPositioningMethods();
+    return methods;
+}
+
+int QGeoPositionInfoSourceMultiplexer::minimumUpdateInterval() const
+{
+    int interval = std::numeric_limits<int>::max();
+    for (const Source &source : m_sources)
+        interval = qMin(interval, source.source->minimumUpdateInterval());
+    return m_sources.isEmpty() ? 0 : interval;
+}
+
+QGeoPositionInfoSource::Error QGeoPositionInfoSourceMultiplexer::error() const
+{
+    return m_error;
+}
+
+void QGeoPositionInfoSourceMultiplexer::setError(Error error)
+{
+    m_error = error;
+    emit QGeoPositionInfoSource::error(error);
+}
+
+void QGeoPositionInfoSourceMultiplexer::startUpdates()
+{
+    if (m_running)
+        return;
+
+    // the updates answer a pending request as well
+    m_requesting = false;
+    m_requestTimer.stop();
+
+    m_running = true;
+    m_error = NoError;
+    m_healthySince = -1;
+    // All the sources start, for the quickest first position, and the
+    // secondary ones are stopped once the primary is healthy
+    for (Source &source : m_sources) {
+        source.failed = false;
+        source.running = true;
+        source.source->startUpdates();
+    }
+}
+
+void QGeoPositionInfoSourceMultiplexer::stopUpdates()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_primaryTimer.stop();
+    for (Source &source : m_sources) {
+        if (source.running)
+            source.source->stopUpdates();
+        source.running = false;
+    }
+}
+
+void QGeoPositionInfoSourceMultiplexer::requestUpdate(int timeout)
+{
+    if (m_running || m_requesting)
+        return;
+
+    if (timeout < 0 || (timeout != 0 && timeout < minimumUpdateInterval())) {
+        emit updateTimeout();
+        return;
+    }
+
+    m_requesting = true;
+    for (Source &source : m_sources)
+        source.responded = false;
+    for (const Source &source : qAsConst(m_sources))
+        source.source->requestUpdate(timeout);
+    if (timeout > 0)
+        m_requestTimer.start(timeout);
+}
+
+void QGeoPositionInfoSourceMultiplexer::sourceUpdated(int index, const QGeoPositionInfo &update)
+{
+    if (!update.isValid())
+        return;
+
+    Source &source = m_sources[index];
+    source.position = update;
+    source.received = m_clock.elapsed();
+    source.failed = false;
+
+    if (m_requesting) {
+        source.responded = true;
+        // an accurate position is not worth waiting for the other sources
+        if (allResponded() || horizontalAccuracy(update) <= m_healthyAccuracy)
+            finishRequest();
+        return;
+    }
+
+    if (!m_running)
+        return;
+
+    if (index == 0 && m_powerSave) {
+        if (horizontalAccuracy(update) <= m_healthyAccuracy) {
+            if (m_healthySince < 0)
+                m_healthySince = source.received;
+            m_primaryTimer.start(m_maximumAge);
+            // only once healthy for a while, not to flip on every position
+            if (source.received - m_healthySince >= m_maximumAge)
+                setSecondariesRunning(false);
+        } else {
+            primaryTimedOut();
+        }
+    }
+
+    if (m_fuse)
+        emit positionUpdated(fused(index));
+    else if (bestSource() == index)
+        emit positionUpdated(update);
+}
+
+void QGeoPositionInfoSourceMultiplexer::sourceTimedOut(int index)
+{
+    if (m_requesting) {
+        m_sources[index].responded = true;
+        if (allResponded())
+            finishRequest();
+        return;
+    }
+
+    if (!m_running)
+        return;
+
+    if (index == 0 && m_powerSave)
+        primaryTimedOut();
+
+    // The stream only times out when no source has a recent position
+    if (bestSource() < 0)
+        emit updateTimeout();
+}
+
+void QGeoPositionInfoSourceMultiplexer::sourceError(int index, QGeoPositionInfoSource::Error error)
+{
+    Source &source = m_sources[index];
+    source.failed = true;
+
+    if (m_requesting) {
+        source.responded = true;
+        if (allResponded())
+            finishRequest();
+    } else if (index == 0 && m_running && m_powerSave) {
+        primaryTimedOut();
+    }
+
+    for (const Source &other : qAsConst(m_sources)) {
+        if (!other.failed)
+            return;
+    }
+    setError(error);
+}
+
+void QGeoPositionInfoSourceMultiplexer::primaryTimedOut()
+{
+    m_healthySince = -1;
+    m_primaryTimer.stop();
+    setSecondariesRunning(true);
+}
+
+void QGeoPositionInfoSourceMultiplexer::finishRequest()
+{
+    if (!m_requesting)
+        return;
+
+    m_requesting = false;
+    m_requestTimer.stop();
+
+    const int best = bestSource();
+    if (best < 0)
+        emit updateTimeout();
+    else
+        emit positionUpdated(m_fuse ? fused(best) : m_sources.at(best).position);
+}
+
+bool QGeoPositionInfoSourceMultiplexer::allResponded() const
+{
+    return std::all_of(m_sources.cbegin(), m_sources.cend(),
+                       [](const Source &source) { return source.responded; });
+}
+
+void QGeoPositionInfoSourceMultiplexer::setSecondariesRunning(bool running)
+{
+    if (!m_running)
+        return;
+
+    for (int i = 1; i < m_sources.size(); ++i) {
+        Source &source = m_sources[i];
+        if (source.running == running)
+            continue;
+
+        source.running = running;
+        if (running)
+            source.source->startUpdates();
+        else
+            source.source->stopUpdates();
+    }
+}
+
+double QGeoPositionInfoSourceMultiplexer::uncertainty(const QGeoPositionInfo &position,
+                                                      qint64 received) const
+{
+    const double seconds = (m_clock.elapsed() - received) / 1000.0;
+    return horizontalAccuracy(position) + m_speed * seconds;
+}
+
+bool QGeoPositionInfoSourceMultiplexer::isUsable(const Source &source) const
+{
+    return source.received >= 0 && m_clock.elapsed() - source.received <= m_maximumAge;
+}
+
+// Returns the source with the least uncertain recent position, the first of
+// them on a tie, or -1 if none has one
+int QGeoPositionInfoSourceMultiplexer::bestSource() const
+{
+    int best = -1;
+    double bestUncertainty = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < m_sources.size(); ++i) {
+        const Source &source = m_sources.at(i);
+        if (!isUsable(source))
+            continue;
+
+        const double sourceUncertainty = uncertainty(source.position, source.received);
+        if (sourceUncertainty < bestUncertainty) {
+            best = i;
+            bestUncertainty = sourceUncertainty;
+        }
+    }
+    return best;
+}
+
+/*
+    Returns the position of the source at index moved to the average of the
+    recent positions of all the sources, weighted by the inverse of their
+    squared uncertainty. The other attributes are those of the position.
+*/
+QGeoPositionInfo QGeoPositionInfoSourceMultiplexer::fused(int index) const
+{
+    const QGeoPositionInfo &position = m_sources.at(index).position;
+    const QGeoCoordinate origin = position.coordinate();
+
+    int count = 0;
+    double weights = 0;
+    double latitude = 0;
+    double longitude = 0; // from origin, not to average across the antimeridian
+    double altitudeWeights = 0;
+    double altitude = 0;
+    for (const Source &source : m_sources) {
+        if (!isUsable(source))
+            continue;
+
+        const double sigma = qMax(0.1, uncertainty(source.position, source.received));
+        const double weight = 1 / (sigma * sigma);
+        const QGeoCoordinate coordinate = source.position.coordinate();
+        latitude += weight * coordinate.latitude();
+        longitude += weight * wrapLongitude(coordinate.longitude() - origin.longitude());
+        weights += weight;
+        if (coordinate.type() == QGeoCoordinate::Coordinate3D) {
+            altitude += weight * coordinate.altitude();
+            altitudeWeights += weight;
+        }
+        ++count;
+    }
+
+    if (count < 2)
+        return position;
+
+    QGeoCoordinate coordinate(latitude / weights,
+                              wrapLongitude(origin.longitude() + longitude / weights));
+    if (altitudeWeights > 0)
+        coordinate.setAltitude(altitude / altitudeWeights);
+
+    QGeoPositionInfo result = position;
+    result.setCoordinate(coordinate);
+    result.setAttribute(QGeoPositionInfo::HorizontalAccuracy, 1 / std::sqrt(weights));
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOPOSITIONINFOSOURCE_MULTIPLEXER_P_H
+#define QGEOPOSITIONINFOSOURCE_MULTIPLEXER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/qgeopositioninfosource.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Delivers the positions of several sources of other plugins as one stream.
+    Each position is passed on as soon as it arrives if no other source has a
+    better one, or fused with the recent positions of the other sources.
+    Positions are compared by their horizontal accuracy, grown by the
+    distance the device may have moved since they arrived.
+
+    The first source is the primary one. While its positions are recent and
+    accurate enough, the other sources are stopped to save power, and they
+    are started again once it stops delivering such positions.
+*/
+class QGeoPositionInfoSourceMultiplexer : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+public:
+    QGeoPositionInfoSourceMultiplexer(const QVariantMap &parameters, QObject *parent = nullptr);
+    QGeoPositionInfoSourceMultiplexer(const QList<QGeoPositionInfoSource *> &sources,
+                                      const QVariantMap &parameters, QObject *parent = nullptr);
+    ~QGeoPositionInfoSourceMultiplexer();
+
+    int sourceCount() const { return m_sources.size(); }
+
+    void setUpdateInterval(int msec) override;
+    void setPreferredPositioningMethods(PositioningMethods methods) override;
+    QGeoPositionInfo lastKnownPosition(bool fromSatellitePositioningMethodsOnly = false) const override;
+    PositioningMethods supportedPositioningMethods() const override;
+    int minimumUpdateInterval() const override;
+    Error error() const override;
+
+public Q_SLOTS:
+    void startUpdates() override;
+    void stopUpdates() override;
+    void requestUpdate(int timeout = 0) override;
+
+private:
+    struct Source
+    {
+        QGeoPositionInfoSource *source;
+        QGeoPositionInfo position; // the last one
+        qint64 received;           // when position arrived, on m_clock
+        bool running;
+        bool failed;
+        bool responded;            // to the pending requestUpdate()
+    };
+
+    void init(const QVariantMap &parameters);
+    void addSource(QGeoPositionInfoSource *source);
+
+    void sourceUpdated(int index, const QGeoPositionInfo &update);
+    void sourceTimedOut(int index);
+    void sourceError(int index, QGeoPositionInfoSource::Error error);
+    void primaryTimedOut();
+    void finishRequest();
+    bool allResponded() const;
+
+    void setSecondariesRunning(bool running);
+    double uncertainty(const QGeoPositionInfo &position, qint64 received) const;
+    bool isUsable(const Source &source) const;
+    int bestSource() const;
+    QGeoPositionInfo fused(int index) const;
+    void setError(Error error);
+
+    QVector<Source> m_sources; // the primary first
+    QElapsedTimer m_clock;
+    QTimer m_primaryTimer; // from the last healthy position of the primary
+    QTimer m_requestTimer;
+    qint64 m_healthySince = -1; // of the primary, on m_clock
+    bool m_running = false;
+    bool m_requesting = false;
+
+    bool m_fuse = false;
+    bool m_powerSave = true;
+    int m_maximumAge = 3000;            // ms after which positions are not used
+    qreal m_speed = 10;                 // m/s the device is assumed to move at most
+    qreal m_healthyAccuracy = 25;       // m, of the positions of a healthy primary
+
+    Error m_error = NoError;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOPOSITIONINFOSOURCE_MULTIPLEXER_P_H
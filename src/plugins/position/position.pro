@@ -11,4 +11,6 @@ android:SUBDIRS += android
 qtHaveModule(serialport):SUBDIRS += serialnmea
 
 SUBDIRS += \
-    positionpoll
+    multiplexer \
+    positionpoll \
+    synthetic
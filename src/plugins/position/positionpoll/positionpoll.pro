@@ -1,6 +1,6 @@
 TARGET = qtposition_positionpoll
 
-QT = core positioning
+QT = core-private positioning-private
 
 SOURCES += \
     qgeoareamonitor_polling.cpp \
@@ -13,6 +13,11 @@ HEADERS += \
 OTHER_FILES += \
     plugin.json
 
+# the tracepoint provider is named after MODULE, qtpositionpoll
+MODULE = positionpoll
+TRACEPOINT_PROVIDER = $$PWD/qtpositionpoll.tracepoints
+CONFIG += qt_tracepoints
+
 PLUGIN_TYPE = position
 PLUGIN_CLASS_NAME = QGeoPositionInfoSourceFactoryPoll
 load(qt_plugin)
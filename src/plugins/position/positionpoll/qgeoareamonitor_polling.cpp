@@ -41,15 +41,25 @@
 #include <QtPositioning/qgeocoordinate.h>
 #include <QtPositioning/qgeorectangle.h>
 #include <QtPositioning/qgeocircle.h>
+#include <QtPositioning/qgeopolygon.h>
+#include <QtPositioning/private/qgeoshape_p.h>
+#include <qtpositionpoll_tracepoints_p.h>
 
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qmutex.h>
+#include <QtCore/qmath.h>
 
+#include <QtCore/qpoint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <mutex>
 
 #define UPDATE_INTERVAL_5S  5000
+#define UPDATE_INTERVAL_5MIN  300000
 
 typedef QHash<QString, QGeoAreaMonitorInfo> MonitorTable;
 
@@ -72,6 +82,125 @@ static QMetaMethod monitorExpiredSignal()
     return signal;
 }
 
+// Areas are tested in the thread of the position source while clients may
+// read their own copies elsewhere, so keep a snapshot not shared with them.
+static QGeoAreaMonitorInfo frozenMonitor(QGeoAreaMonitorInfo monitor)
+{
+    monitor.setArea(QGeoFrozenShape(monitor.area()).shape());
+    return monitor;
+}
+
+// Monitors are looked up in a grid of cells of this many degrees covering
+// their bounding boxes, so that a position is only tested against the areas
+// near it. Monitors covering more than MaxMonitorCells cells are tested on
+// every position instead.
+static const double MonitorCellSize = 0.01;
+static const int MaxMonitorCells = 256;
+
+// In the adaptive mode, the nearest boundary is looked for in at most this
+// many rings of cells around the position.
+static const int MaxSearchRings = 16;
+// The speed assumed for a device standing still or not reporting any, in m/s
+static const double MinimumSpeed = 2.0;
+static const double MetersPerDegree = 111195.0;
+
+// Returns the distance in meters between latitudes or longitudes of the
+// same point, with longitudes scaled at the given latitude.
+static double latitudeMeters(double degrees)
+{
+    return qAbs(degrees) * MetersPerDegree;
+}
+
+static double longitudeMeters(double degrees, double latitude)
+{
+    degrees = std::fmod(qAbs(degrees), 360.0);
+    return qMin(degrees, 360.0 - degrees) * MetersPerDegree
+            * qCos(qDegreesToRadians(qMin(qAbs(latitude), 90.0)));
+}
+
+// Returns a lower bound in meters of the distance from coordinate to bounds,
+// or 0 if it is inside.
+static double distanceToRectangle(const QGeoCoordinate &coordinate, const QGeoRectangle &bounds)
+{
+    if (!bounds.isValid() || bounds.contains(coordinate))
+        return 0;
+
+    const double top = bounds.topLeft().latitude();
+    const double bottom = bounds.bottomRight().latitude();
+    const double west = bounds.topLeft().longitude();
+    const double east = bounds.bottomRight().longitude();
+    const double latitude = coordinate.latitude();
+    const double longitude = coordinate.longitude();
+
+    const double dLat = latitude > top ? latitude - top
+                                       : (latitude < bottom ? bottom - latitude : 0);
+    double dLon = 0;
+    const bool wraps = west > east;
+    if (wraps ? (longitude < west && longitude > east) : (longitude < west || longitude > east)) {
+        const double toWest = std::fmod(west - longitude + 360.0, 360.0);
+        const double toEast = std::fmod(longitude - east + 360.0, 360.0);
+        dLon = qMin(toWest, toEast);
+    }
+
+    // scale the longitudes at the latitude of the box farthest from the equator
+    const double scaleLatitude = qMax(qAbs(latitude), qMax(qAbs(top), qAbs(bottom)));
+    return std::hypot(latitudeMeters(dLat), longitudeMeters(dLon, scaleLatitude));
+}
+
+// Returns the distance in meters from coordinate to the closest edge of
+// path, using a local planar approximation.
+static double distanceToPath(const QGeoCoordinate &coordinate, const QList<QGeoCoordinate> &path)
+{
+    double distance = std::numeric_limits<double>::max();
+    const double latitude = coordinate.latitude();
+    auto local = [&](const QGeoCoordinate &c) {
+        double dLon = std::fmod(c.longitude() - coordinate.longitude() + 540.0, 360.0) - 180.0;
+        return QPointF(dLon * MetersPerDegree * qCos(qDegreesToRadians(latitude)),
+                       (c.latitude() - latitude) * MetersPerDegree);
+    };
+    for (int i = 0; i < path.size(); ++i) {
+        const QPointF a = local(path.at(i));
+        const QPointF b = local(path.at((i + 1) % path.size()));
+        const QPointF ab = b - a;
+        const double length = QPointF::dotProduct(ab, ab);
+        const double t = length > 0 ? qBound(0.0, -QPointF::dotProduct(a, ab) / length, 1.0) : 0;
+        const QPointF closest = a + t * ab;
+        distance = qMin(distance, std::hypot(closest.x(), closest.y()));
+    }
+    return distance;
+}
+
+// Returns the distance in meters from a coordinate inside area to its boundary.
+static double distanceToBoundary(const QGeoCoordinate &coordinate, const QGeoShape &area)
+{
+    switch (area.type()) {
+    case QGeoShape::CircleType: {
+        const QGeoCircle circle(area);
+        return qMax(0.0, circle.radius() - circle.center().distanceTo(coordinate));
+    }
+    case QGeoShape::RectangleType: {
+        const QGeoRectangle rectangle(area);
+        const double dLat = qMin(rectangle.topLeft().latitude() - coordinate.latitude(),
+                                 coordinate.latitude() - rectangle.bottomRight().latitude());
+        const double toWest = std::fmod(coordinate.longitude()
+                                        - rectangle.topLeft().longitude() + 360.0, 360.0);
+        const double toEast = std::fmod(rectangle.bottomRight().longitude()
+                                        - coordinate.longitude() + 360.0, 360.0);
+        return qMin(latitudeMeters(qMax(0.0, dLat)),
+                    longitudeMeters(qMin(toWest, toEast), coordinate.latitude()));
+    }
+    case QGeoShape::PolygonType: {
+        const QGeoPolygon polygon(area);
+        double distance = distanceToPath(coordinate, polygon.path());
+        for (int i = 0; i < polygon.holesCount(); ++i)
+            distance = qMin(distance, distanceToPath(coordinate, polygon.holePath(i)));
+        return distance;
+    }
+    default:
+        return 0;
+    }
+}
+
 class QGeoAreaMonitorPollingPrivate : public QObject
 {
     Q_OBJECT
@@ -88,8 +217,7 @@ public:
     {
         const std::lock_guard<QRecursiveMutex> locker(mutex);
 
-        activeMonitorAreas.insert(monitor.identifier(), monitor);
-        singleShotTrigger.remove(monitor.identifier());
+        insertMonitor(monitor, -1);
 
         checkStartStop();
         setupNextExpiryTimeout();
@@ -99,8 +227,7 @@ public:
     {
         const std::lock_guard<QRecursiveMutex> locker(mutex);
 
-        activeMonitorAreas.insert(monitor.identifier(), monitor);
-        singleShotTrigger.insert(monitor.identifier(), signalId);
+        insertMonitor(monitor, signalId);
 
         checkStartStop();
         setupNextExpiryTimeout();
@@ -110,7 +237,7 @@ public:
     {
         const std::lock_guard<QRecursiveMutex> locker(mutex);
 
-        QGeoAreaMonitorInfo mon = activeMonitorAreas.take(monitor.identifier());
+        QGeoAreaMonitorInfo mon = removeMonitor(handles.value(monitor.identifier(), -1));
 
         checkStartStop();
         setupNextExpiryTimeout();
@@ -160,6 +287,8 @@ public:
             source->moveToThread(this->thread());
             if (source->updateInterval() == 0)
                 source->setUpdateInterval(UPDATE_INTERVAL_5S);
+            baseInterval = source->updateInterval();
+            lastPosition = QGeoPositionInfo();
             disconnect(source, 0, 0, 0); //disconnect all
             connect(source, SIGNAL(positionUpdated(QGeoPositionInfo)),
                     this, SLOT(positionUpdated(QGeoPositionInfo)));
@@ -175,11 +304,52 @@ public:
         return source;
     }
 
+    bool adaptiveUpdateInterval() const
+    {
+        const std::lock_guard<QRecursiveMutex> locker(mutex);
+        return adaptive;
+    }
+
+    void setAdaptiveUpdateInterval(bool enabled)
+    {
+        const std::lock_guard<QRecursiveMutex> locker(mutex);
+
+        if (enabled == adaptive)
+            return;
+        adaptive = enabled;
+        if (!source)
+            return;
+        if (adaptive) {
+            baseInterval = source->updateInterval();
+        } else {
+            lastPosition = QGeoPositionInfo();
+            setSourceInterval(baseInterval);
+        }
+    }
+
+    int maximumUpdateInterval() const
+    {
+        const std::lock_guard<QRecursiveMutex> locker(mutex);
+        return maxInterval;
+    }
+
+    void setMaximumUpdateInterval(int msec)
+    {
+        const std::lock_guard<QRecursiveMutex> locker(mutex);
+        maxInterval = msec;
+    }
+
     MonitorTable activeMonitors() const
     {
         const std::lock_guard<QRecursiveMutex> locker(mutex);
 
-        return activeMonitorAreas;
+        MonitorTable table;
+        table.reserve(handles.size());
+        for (const Monitor &monitor : monitors) {
+            if (monitor.active)
+                table.insert(monitor.info.identifier(), monitor.info);
+        }
+        return table;
     }
 
     void checkStartStop()
@@ -194,55 +364,307 @@ public:
             }
         }
 
-        if (signalsConnected && !activeMonitorAreas.isEmpty()) {
-            if (source)
+        if (signalsConnected && !handles.isEmpty()) {
+            if (source) {
                 source->startUpdates();
-            else
+                running = true;
+            } else {
                 //translated to InsufficientPositionInfo
                 emit positionError(QGeoPositionInfoSource::ClosedError);
+            }
         } else {
             if (source)
                 source->stopUpdates();
+            running = false;
         }
     }
 
 private:
-    void setupNextExpiryTimeout()
+    struct Monitor
     {
-        nextExpiryTimer->stop();
-        activeExpiry.first = QDateTime();
-        activeExpiry.second = QString();
+        QGeoAreaMonitorInfo info;
+        QVector<quint64> cells; // empty for the monitors tested on every position
+        int singleShotSignal = -1;
+        bool inside = false;
+        quint32 generation = 0;
+        bool active = false;
+    };
+
+    struct Expiry
+    {
+        QDateTime time;
+        int handle;
+        quint32 generation;
+    };
 
-        foreach (const QGeoAreaMonitorInfo &info, activeMonitors()) {
-            if (info.expiration().isValid()) {
-                if (!activeExpiry.first.isValid()) {
-                    activeExpiry.first = info.expiration();
-                    activeExpiry.second = info.identifier();
+    static quint64 cellKey(int row, int column)
+    {
+        return (quint64(quint32(row)) << 32) | quint32(column);
+    }
+
+    static int cellRow(double latitude)
+    {
+        return qBound(0, qFloor((latitude + 90.0) / MonitorCellSize),
+                      qCeil(180.0 / MonitorCellSize) - 1);
+    }
+
+    static int cellColumn(double longitude)
+    {
+        const int columns = qCeil(360.0 / MonitorCellSize);
+        return ((qFloor((longitude + 180.0) / MonitorCellSize) % columns) + columns) % columns;
+    }
+
+    // Returns the cells covering the bounding box of area, or none if there
+    // are too many of them.
+    static QVector<quint64> monitorCells(const QGeoShape &area)
+    {
+        const QGeoRectangle bounds = area.boundingGeoRectangle();
+        if (!bounds.isValid())
+            return QVector<quint64>();
+
+        // a margin for the rounding of the bounding boxes of circles
+        const double margin = 1e-9;
+        const int top = cellRow(bounds.topLeft().latitude() + margin);
+        const int bottom = cellRow(bounds.bottomRight().latitude() - margin);
+        const int west = cellColumn(bounds.topLeft().longitude() - margin);
+        const int east = cellColumn(bounds.bottomRight().longitude() + margin);
+        const int columns = qCeil(360.0 / MonitorCellSize);
+        const int columnCount = (east >= west ? east - west : east + columns - west) + 1;
+        if (qint64(top - bottom + 1) * columnCount > MaxMonitorCells)
+            return QVector<quint64>();
+
+        QVector<quint64> cells;
+        cells.reserve((top - bottom + 1) * columnCount);
+        for (int row = bottom; row <= top; ++row) {
+            for (int i = 0; i < columnCount; ++i)
+                cells.append(cellKey(row, (west + i) % columns));
+        }
+        return cells;
+    }
+
+    // Adds or updates monitor, keeping whether the position is inside it.
+    void insertMonitor(const QGeoAreaMonitorInfo &monitor, int singleShotSignal)
+    {
+        int handle = handles.value(monitor.identifier(), -1);
+        if (handle < 0) {
+            if (freeHandles.isEmpty()) {
+                handle = monitors.size();
+                monitors.append(Monitor());
+            } else {
+                handle = freeHandles.takeLast();
+            }
+            handles.insert(monitor.identifier(), handle);
+        } else {
+            unindexMonitor(handle);
+        }
+
+        Monitor &m = monitors[handle];
+        m.info = frozenMonitor(monitor);
+        m.singleShotSignal = singleShotSignal;
+        m.active = true;
+        ++m.generation;
+        scheduleExpiry(handle);
+        m.cells = monitorCells(m.info.area());
+        if (m.cells.isEmpty())
+            largeMonitors.append(handle);
+        for (quint64 cell : qAsConst(m.cells))
+            this->cells[cell].append(handle);
+    }
+
+    QGeoAreaMonitorInfo removeMonitor(int handle)
+    {
+        if (handle < 0 || handle >= monitors.size() || !monitors.at(handle).active)
+            return QGeoAreaMonitorInfo();
+
+        unindexMonitor(handle);
+        Monitor &m = monitors[handle];
+        if (m.inside)
+            insideMonitors.removeOne(handle);
+        handles.remove(m.info.identifier());
+        const QGeoAreaMonitorInfo info = m.info;
+        const quint32 generation = m.generation;
+        m = Monitor();
+        m.generation = generation + 1;
+        freeHandles.append(handle);
+        return info;
+    }
+
+    void unindexMonitor(int handle)
+    {
+        const Monitor &m = monitors.at(handle);
+        if (m.cells.isEmpty())
+            largeMonitors.removeOne(handle);
+        for (quint64 cell : m.cells) {
+            auto it = this->cells.find(cell);
+            if (it == this->cells.end())
+                continue;
+            it->removeOne(handle);
+            if (it->isEmpty())
+                this->cells.erase(it);
+        }
+    }
+
+    // Orders the expiry heap by the earliest expiry first
+    static bool laterExpiry(const Expiry &a, const Expiry &b)
+    {
+        return b.time < a.time;
+    }
+
+    // An expiry entry is stale once its monitor is removed or replaced.
+    bool isCurrent(const Expiry &expiry) const
+    {
+        const Monitor &m = monitors.at(expiry.handle);
+        return m.active && m.generation == expiry.generation;
+    }
+
+    void scheduleExpiry(int handle)
+    {
+        const Monitor &m = monitors.at(handle);
+        if (!m.info.expiration().isValid())
+            return;
+
+        // drop the stale entries once they make up most of the heap
+        if (expiries.size() > 64 && expiries.size() > 2 * handles.size()) {
+            auto stale = [this](const Expiry &expiry) { return !isCurrent(expiry); };
+            expiries.erase(std::remove_if(expiries.begin(), expiries.end(), stale),
+                           expiries.end());
+            std::make_heap(expiries.begin(), expiries.end(), laterExpiry);
+        }
+
+        expiries.append(Expiry { m.info.expiration(), handle, m.generation });
+        std::push_heap(expiries.begin(), expiries.end(), laterExpiry);
+    }
+
+    // Returns a lower bound in meters of the distance from coordinate to the
+    // nearest boundary of a monitored area, up to limit.
+    double distanceToNearestBoundary(const QGeoCoordinate &coordinate, double limit) const
+    {
+        double distance = limit;
+        for (int handle : insideMonitors) {
+            const QGeoShape &area = monitors.at(handle).info.area();
+            distance = qMin(distance, distanceToBoundary(coordinate, area));
+        }
+        for (int handle : largeMonitors) {
+            const Monitor &m = monitors.at(handle);
+            if (!m.inside) {
+                const QGeoRectangle bounds = m.info.area().boundingGeoRectangle();
+                distance = qMin(distance, distanceToRectangle(coordinate, bounds));
+            }
+        }
+
+        // the position may lie on the edge of its cell, so every monitor out
+        // of the rings searched so far is at least the width of one cell
+        // fewer away
+        const int row = cellRow(coordinate.latitude());
+        const int column = cellColumn(coordinate.longitude());
+        const int rows = qCeil(180.0 / MonitorCellSize);
+        const int columns = qCeil(360.0 / MonitorCellSize);
+        for (int ring = 0; ring <= MaxSearchRings; ++ring) {
+            const double farthestLatitude = qMin(90.0, qAbs(coordinate.latitude())
+                                                 + (ring + 1) * MonitorCellSize);
+            const double cellMeters = qMin(latitudeMeters(MonitorCellSize),
+                                           longitudeMeters(MonitorCellSize, farthestLatitude));
+            if (distance <= (ring - 1) * cellMeters)
+                return distance;
+
+            for (int r = row - ring; r <= row + ring; ++r) {
+                if (r < 0 || r >= rows)
                     continue;
+                const bool edgeRow = r == row - ring || r == row + ring;
+                const int step = edgeRow ? 1 : 2 * ring;
+                for (int c = column - ring; c <= column + ring; c += qMax(1, step)) {
+                    const auto it = cells.constFind(cellKey(r, (c % columns + columns) % columns));
+                    if (it == cells.constEnd())
+                        continue;
+                    for (int handle : *it) {
+                        const Monitor &m = monitors.at(handle);
+                        if (!m.inside) {
+                            distance = qMin(distance, distanceToRectangle(coordinate,
+                                                m.info.area().boundingGeoRectangle()));
+                        }
+                    }
                 }
-                if (info.expiration() < activeExpiry.first) {
-                    activeExpiry.first = info.expiration();
-                    activeExpiry.second = info.identifier();
-                }
             }
         }
 
-        if (activeExpiry.first.isValid())
-            nextExpiryTimer->start(QDateTime::currentDateTime().msecsTo(activeExpiry.first));
+        const double farthestLatitude = qMin(90.0, qAbs(coordinate.latitude())
+                                             + (MaxSearchRings + 1) * MonitorCellSize);
+        return qMin(distance, MaxSearchRings
+                    * qMin(latitudeMeters(MonitorCellSize),
+                           longitudeMeters(MonitorCellSize, farthestLatitude)));
+    }
+
+    // Sets the update interval of the source to the time the device takes,
+    // at its current speed, to cover half the distance to the nearest
+    // boundary, within the configured interval and maximumUpdateInterval.
+    void adaptUpdateInterval(const QGeoPositionInfo &info)
+    {
+        double speed = 0;
+        if (info.hasAttribute(QGeoPositionInfo::GroundSpeed))
+            speed = info.attribute(QGeoPositionInfo::GroundSpeed);
+        if (lastPosition.isValid()) {
+            const qint64 msecs = lastPosition.timestamp().msecsTo(info.timestamp());
+            if (msecs > 0) {
+                const double moved = lastPosition.coordinate().distanceTo(info.coordinate());
+                speed = qMax(speed, moved * 1000 / msecs);
+            }
+        }
+        speed = qMax(speed, MinimumSpeed);
+        lastPosition = info;
+
+        const int maximum = qMax(baseInterval, maxInterval);
+        double distance = distanceToNearestBoundary(info.coordinate(), speed * maximum / 500);
+        if (info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy))
+            distance -= info.attribute(QGeoPositionInfo::HorizontalAccuracy);
+
+        const int interval = int(qBound<double>(baseInterval, distance / speed * 500, maximum));
+        // avoid restarting the source for small changes
+        const int current = source->updateInterval();
+        if (interval < current || interval > current + current / 4)
+            setSourceInterval(interval);
+    }
+
+    // Sources are not required to apply a new interval until restarted
+    void setSourceInterval(int msec)
+    {
+        if (!source || source->updateInterval() == msec)
+            return;
+        source->setUpdateInterval(msec);
+        if (running)
+            source->startUpdates();
     }
 
+    void dropStaleExpiries()
+    {
+        while (!expiries.isEmpty() && !isCurrent(expiries.first())) {
+            std::pop_heap(expiries.begin(), expiries.end(), laterExpiry);
+            expiries.removeLast();
+        }
+    }
+
+    void setupNextExpiryTimeout()
+    {
+        dropStaleExpiries();
+        if (expiries.isEmpty()) {
+            nextExpiryTimer->stop();
+            return;
+        }
+
+        const qint64 msecs = QDateTime::currentDateTime().msecsTo(expiries.first().time);
+        nextExpiryTimer->start(int(qBound<qint64>(0, msecs, std::numeric_limits<int>::max())));
+    }
 
     //returns true if areaEntered should be emitted
-    bool processInsideArea(const QString &monitorIdent)
+    bool processInsideArea(int handle)
     {
-        if (!insideArea.contains(monitorIdent)) {
-            if (singleShotTrigger.value(monitorIdent, -1) == areaEnteredSignal().methodIndex()) {
+        Monitor &m = monitors[handle];
+        if (!m.inside) {
+            if (m.singleShotSignal == areaEnteredSignal().methodIndex()) {
                 //this is the finishing singleshot event
-                singleShotTrigger.remove(monitorIdent);
-                activeMonitorAreas.remove(monitorIdent);
-                setupNextExpiryTimeout();
+                removeMonitor(handle);
             } else {
-                insideArea.insert(monitorIdent);
+                m.inside = true;
+                insideMonitors.append(handle);
             }
             return true;
         }
@@ -251,16 +673,16 @@ private:
     }
 
     //returns true if areaExited should be emitted
-    bool processOutsideArea(const QString &monitorIdent)
+    bool processOutsideArea(int handle)
     {
-        if (insideArea.contains(monitorIdent)) {
-            if (singleShotTrigger.value(monitorIdent, -1) == areaExitedSignal().methodIndex()) {
+        Monitor &m = monitors[handle];
+        if (m.inside) {
+            if (m.singleShotSignal == areaExitedSignal().methodIndex()) {
                 //this is the finishing singleShot event
-                singleShotTrigger.remove(monitorIdent);
-                activeMonitorAreas.remove(monitorIdent);
-                setupNextExpiryTimeout();
+                removeMonitor(handle);
             } else {
-                insideArea.remove(monitorIdent);
+                m.inside = false;
+                insideMonitors.removeOne(handle);
             }
             return true;
         }
@@ -281,35 +703,82 @@ private Q_SLOTS:
          * Don't block timer firing even if monitorExpiredSignal is not connected.
          * This allows us to continue to remove the existing monitors as they expire.
          **/
-        const QGeoAreaMonitorInfo info = activeMonitorAreas.take(activeExpiry.second);
-        setupNextExpiryTimeout();
-        emit timeout(info);
+        QVector<QGeoAreaMonitorInfo> expired;
+        {
+            const std::lock_guard<QRecursiveMutex> locker(mutex);
+
+            // The timer fires early for expiries beyond its range, or after
+            // a change of the system clock, so only take the due ones
+            const QDateTime now = QDateTime::currentDateTime();
+            dropStaleExpiries();
+            while (!expiries.isEmpty() && expiries.first().time <= now) {
+                const int handle = expiries.first().handle;
+                std::pop_heap(expiries.begin(), expiries.end(), laterExpiry);
+                expiries.removeLast();
+                expired.append(removeMonitor(handle));
+                dropStaleExpiries();
+            }
+            setupNextExpiryTimeout();
+        }
 
+        for (const QGeoAreaMonitorInfo &info : qAsConst(expired))
+            emit timeout(info);
     }
 
     void positionUpdated(const QGeoPositionInfo &info)
     {
-        foreach (const QGeoAreaMonitorInfo &monInfo, activeMonitors()) {
-            const QString identifier = monInfo.identifier();
-            if (monInfo.area().contains(info.coordinate())) {
-                if (processInsideArea(identifier))
-                    emit areaEventDetected(monInfo, info, true);
-            } else {
-                if (processOutsideArea(identifier))
-                    emit areaEventDetected(monInfo, info, false);
+        const QGeoCoordinate coordinate = info.coordinate();
+        QVector<QPair<QGeoAreaMonitorInfo, bool>> events;
+        {
+            const std::lock_guard<QRecursiveMutex> locker(mutex);
+
+            // the monitors near the position, and those it may have left
+            QVector<int> candidates = insideMonitors + largeMonitors;
+            if (coordinate.isValid())
+                candidates += cells.value(cellKey(cellRow(coordinate.latitude()),
+                                                  cellColumn(coordinate.longitude())));
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+            const int monitorCount = handles.size();
+            for (int handle : qAsConst(candidates)) {
+                const QGeoAreaMonitorInfo monInfo = monitors.at(handle).info;
+                if (monInfo.area().contains(coordinate)) {
+                    if (processInsideArea(handle))
+                        events.append(qMakePair(monInfo, true));
+                } else {
+                    if (processOutsideArea(handle))
+                        events.append(qMakePair(monInfo, false));
+                }
             }
+            if (handles.size() != monitorCount)
+                setupNextExpiryTimeout();
+
+            if (adaptive && source && coordinate.isValid())
+                adaptUpdateInterval(info);
         }
+
+        for (const auto &event : qAsConst(events))
+            emit areaEventDetected(event.first, info, event.second);
     }
 
 private:
-    QPair<QDateTime, QString> activeExpiry;
-    QHash<QString, int> singleShotTrigger;
+    QVector<Expiry> expiries; // a min-heap, entries are dropped lazily
     QTimer* nextExpiryTimer;
-    QSet<QString> insideArea;
 
-    MonitorTable activeMonitorAreas;
+    QVector<Monitor> monitors; // by handle
+    QVector<int> freeHandles;
+    QHash<QString, int> handles; // by monitor identifier
+    QHash<quint64, QVector<int>> cells; // handles of the monitors covering a cell
+    QVector<int> largeMonitors;
+    QVector<int> insideMonitors;
 
     QGeoPositionInfoSource* source = nullptr;
+    bool running = false;
+    bool adaptive = false;
+    int baseInterval = UPDATE_INTERVAL_5S;
+    int maxInterval = UPDATE_INTERVAL_5MIN;
+    QGeoPositionInfo lastPosition;
     QList<QGeoAreaMonitorPolling*> registeredClients;
     mutable QRecursiveMutex mutex;
 };
@@ -343,6 +812,33 @@ void QGeoAreaMonitorPolling::setPositionInfoSource(QGeoPositionInfoSource *sourc
     d->setPositionSource(source);
 }
 
+/*
+    In the adaptive mode, the update interval of the position source is
+    lengthened while the monitored areas are farther than the device can
+    travel in it, up to maximumUpdateInterval, and shortened to the interval it
+    was created with as they come closer. The mode applies to the position
+    source shared by all polling monitors.
+*/
+bool QGeoAreaMonitorPolling::adaptiveUpdateInterval() const
+{
+    return d->adaptiveUpdateInterval();
+}
+
+void QGeoAreaMonitorPolling::setAdaptiveUpdateInterval(bool enabled)
+{
+    d->setAdaptiveUpdateInterval(enabled);
+}
+
+int QGeoAreaMonitorPolling::maximumUpdateInterval() const
+{
+    return d->maximumUpdateInterval();
+}
+
+void QGeoAreaMonitorPolling::setMaximumUpdateInterval(int msec)
+{
+    d->setMaximumUpdateInterval(msec);
+}
+
 QGeoAreaMonitorSource::Error QGeoAreaMonitorPolling::error() const
 {
     return lastError;
@@ -489,6 +985,8 @@ void QGeoAreaMonitorPolling::timeout(const QGeoAreaMonitorInfo& monitor)
 void QGeoAreaMonitorPolling::processAreaEvent(const QGeoAreaMonitorInfo &minfo,
                                               const QGeoPositionInfo &pinfo, bool isEnteredEvent)
 {
+    Q_TRACE(QGeoAreaMonitorPolling_areaEvent, minfo.identifier(),
+            pinfo.timestamp().toMSecsSinceEpoch(), isEnteredEvent);
     if (isEnteredEvent)
         emit areaEntered(minfo, pinfo);
     else
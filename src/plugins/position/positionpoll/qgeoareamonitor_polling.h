@@ -53,6 +53,9 @@ class QGeoAreaMonitorPollingPrivate;
 class QGeoAreaMonitorPolling : public QGeoAreaMonitorSource
 {
     Q_OBJECT
+    Q_PROPERTY(bool adaptiveUpdateInterval READ adaptiveUpdateInterval
+               WRITE setAdaptiveUpdateInterval)
+    Q_PROPERTY(int maximumUpdateInterval READ maximumUpdateInterval WRITE setMaximumUpdateInterval)
 public :
     explicit QGeoAreaMonitorPolling(QObject *parent = 0);
     ~QGeoAreaMonitorPolling();
@@ -60,6 +63,11 @@ public :
     void setPositionInfoSource(QGeoPositionInfoSource *source) override;
     QGeoPositionInfoSource* positionInfoSource() const override;
 
+    bool adaptiveUpdateInterval() const;
+    void setAdaptiveUpdateInterval(bool enabled);
+    int maximumUpdateInterval() const;
+    void setMaximumUpdateInterval(int msec);
+
     Error error() const override;
 
     bool startMonitoring(const QGeoAreaMonitorInfo &monitor) override;
@@ -43,7 +43,7 @@
 #include <QtSerialPort/qserialportinfo.h>
 #include <QtCore/qloggingcategory.h>
 #include <QSet>
-#include "qiopipe_p.h"
+#include "qnmeadispatcher_p.h"
 #include <QSharedPointer>
 #include "qnmeasatelliteinfosource_p.h"
 
@@ -56,13 +56,11 @@ public:
     IODeviceContainer(IODeviceContainer const&) = delete;
     void operator=(IODeviceContainer const&)  = delete;
 
-    QSharedPointer<QIOPipe> serial(const QString &portName)
+    QSharedPointer<QNmeaDispatcherDevice> serial(const QString &portName)
     {
         if (m_serialPorts.contains(portName)) {
             m_serialPorts[portName].refs++;
-            QIOPipe *endPipe = new QIOPipe(m_serialPorts[portName].proxy);
-            m_serialPorts[portName].proxy->addChildPipe(endPipe);
-            return QSharedPointer<QIOPipe>(endPipe);
+            return QSharedPointer<QNmeaDispatcherDevice>(new QNmeaDispatcherDevice(m_serialPorts[portName].dispatcher));
         }
         IODevice device;
         QSerialPort *port = new QSerialPort(portName);
@@ -74,20 +72,19 @@ public:
             return {};
         }
         qCDebug(lcSerial) << "Opened successfully";
-        device.device = port;
+        // sentences are read and parsed once by the dispatcher, for all sources on the port
+        device.dispatcher = new QNmeaDispatcher(port);
+        port->setParent(device.dispatcher);
         device.refs = 1;
-        device.proxy = new QIOPipe(port, QIOPipe::ProxyPipe);
         m_serialPorts[portName] = device;
-        QIOPipe *endPipe = new QIOPipe(device.proxy);
-        device.proxy->addChildPipe(endPipe);
-        return QSharedPointer<QIOPipe>(endPipe);
+        return QSharedPointer<QNmeaDispatcherDevice>(new QNmeaDispatcherDevice(device.dispatcher));
     }
 
-    void releaseSerial(const QString &portName, QSharedPointer<QIOPipe> &pipe) {
+    void releaseSerial(const QString &portName, QSharedPointer<QNmeaDispatcherDevice> &port) {
         if (!m_serialPorts.contains(portName))
             return;
 
-        pipe.clear(); // make sure to release the pipe returned by getSerial, or else, if there are still refs, data will be leaked through it
+        port.clear();
         IODevice &device = m_serialPorts[portName];
         if (device.refs > 1) {
             device.refs--;
@@ -95,14 +92,13 @@ public:
         }
 
         IODevice taken = m_serialPorts.take(portName);
-        taken.device->deleteLater();
+        taken.dispatcher->deleteLater();
     }
 
 private:
 
     struct IODevice {
-        QIODevice *device = nullptr;
-        QIOPipe *proxy = nullptr;  // adding client pipes as children of proxy allows to dynamically add clients to one device.
+        QNmeaDispatcher *dispatcher = nullptr; // owns the serial port
         unsigned int refs = 1;
     };
 
@@ -119,8 +115,12 @@ public:
     ~NmeaSource() override;
     bool isValid() const { return !m_port.isNull(); }
 
+protected:
+    bool parsePosInfoFromNmeaData(const char *data, int size,
+                                  QGeoPositionInfo *posInfo, bool *hasFix) override;
+
 private:
-    QSharedPointer<QIOPipe> m_port;
+    QSharedPointer<QNmeaDispatcherDevice> m_port;
     QString m_portName;
 };
 
@@ -173,6 +173,16 @@ NmeaSource::~NmeaSource()
     deviceContainer->releaseSerial(m_portName, m_port);
 }
 
+bool NmeaSource::parsePosInfoFromNmeaData(const char *data, int size,
+                                          QGeoPositionInfo *posInfo, bool *hasFix)
+{
+    // reuse what the dispatcher parsed for the other sources on the port,
+    // this includes the UBX NAV-PVT frames of u-blox receivers
+    if (QNmeaDispatcher::Sentence *sentence = m_port->lastSentence(data, size))
+        return m_port->dispatcher()->positionInfo(sentence, userEquivalentRangeError(), posInfo, hasFix);
+    return QNmeaPositionInfoSource::parsePosInfoFromNmeaData(data, size, posInfo, hasFix);
+}
+
 
 
 class NmeaSatelliteSource : public QNmeaSatelliteInfoSource
@@ -229,8 +239,33 @@ public:
 
     bool isValid() const { return !m_port.isNull(); }
 
+protected:
+    bool parseSatellitesInUseFromNmea(const char *data, int size, QList<int> &pnrsInUse) override
+    {
+        if (QNmeaDispatcher::Sentence *sentence = m_port->lastSentence(data, size))
+            return m_port->dispatcher()->satellitesInUse(sentence, pnrsInUse);
+        return QNmeaSatelliteInfoSource::parseSatellitesInUseFromNmea(data, size, pnrsInUse);
+    }
+
+    QLocationUtils::GSVParseStatus parseSatelliteInfoFromNmea(const char *data, int size,
+                                                              QList<QGeoSatelliteInfo> &infos) override
+    {
+        if (QNmeaDispatcher::Sentence *sentence = m_port->lastSentence(data, size))
+            return m_port->dispatcher()->satellitesInView(sentence, infos);
+        return QNmeaSatelliteInfoSource::parseSatelliteInfoFromNmea(data, size, infos);
+    }
+
+    bool parseSatelliteUpdate(const char *data, int size, QList<QGeoSatelliteInfo> &inView,
+                              QList<int> &inUse) override
+    {
+        // UBX NAV-SAT frames of the dispatcher
+        if (QNmeaDispatcher::Sentence *sentence = m_port->lastSentence(data, size))
+            return m_port->dispatcher()->satelliteUpdate(sentence, inView, inUse);
+        return false;
+    }
+
 private:
-    QSharedPointer<QIOPipe> m_port;
+    QSharedPointer<QNmeaDispatcherDevice> m_port;
     QString m_portName;
 };
 
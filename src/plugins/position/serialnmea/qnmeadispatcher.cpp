@@ -0,0 +1,403 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qnmeadispatcher_p.h"
+#include "qubxdecoder_p.h"
+
+#include <QtCore/QtNumeric>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// Sentences kept for consumers that are behind, about 10 s of a 5 Hz receiver
+static const int NMEA_DISPATCHER_RING_SIZE = 256;
+
+QNmeaDispatcher::QNmeaDispatcher(QIODevice *device, QObject *parent)
+    : QObject(parent), m_device(device), m_ring(NMEA_DISPATCHER_RING_SIZE)
+{
+    connect(device, &QIODevice::readyRead, this, &QNmeaDispatcher::readAvailableData);
+    connect(device, &QIODevice::readChannelFinished, this, &QNmeaDispatcher::readChannelFinished);
+}
+
+QNmeaDispatcher::~QNmeaDispatcher()
+{
+}
+
+QIODevice *QNmeaDispatcher::device() const
+{
+    return m_device;
+}
+
+quint64 QNmeaDispatcher::writeSequence() const
+{
+    return m_writeSequence;
+}
+
+quint64 QNmeaDispatcher::oldestSequence() const
+{
+    return m_writeSequence > quint64(m_ring.size()) ? m_writeSequence - m_ring.size() : 0;
+}
+
+QNmeaDispatcher::Sentence *QNmeaDispatcher::sentence(quint64 sequence)
+{
+    if (sequence >= m_writeSequence || sequence < oldestSequence())
+        return nullptr;
+    return &m_ring[int(sequence % quint64(m_ring.size()))];
+}
+
+void QNmeaDispatcher::readAvailableData()
+{
+    if (!m_device)
+        return;
+    m_buffer.append(m_device->readAll());
+
+    int pending = 0;
+    int pos = 0;
+    while (pos < m_buffer.size()) {
+        const char *data = m_buffer.constData() + pos;
+        const int size = m_buffer.size() - pos;
+        int consumed = 0;
+        if (uchar(data[0]) == QUbxDecoder::SyncChar1) {
+            const int frame = QUbxDecoder::frameSize(data, size);
+            if (frame == 0)
+                break; // incomplete
+            if (frame > 0) {
+                appendSentence(data, frame, UbxProtocol);
+                consumed = frame;
+            }
+        } else if (data[0] == '$') {
+            // A sentence ends at the line end, a binary frame or another sentence interrupts it
+            const int limit = qMin<int>(size, QLocationUtils::MaxNmeaSentenceLength);
+            int end = 1;
+            while (end < limit && data[end] != '\n' && data[end] != '$'
+                   && uchar(data[end]) != QUbxDecoder::SyncChar1) {
+                ++end;
+            }
+            if (end == limit && size < QLocationUtils::MaxNmeaSentenceLength)
+                break; // incomplete
+            if (end < limit && data[end] == '\n') {
+                appendSentence(data, end + 1, NmeaProtocol);
+                consumed = end + 1;
+            } else {
+                consumed = end;
+            }
+        }
+        if (consumed == 0) {
+            // garbage or a corrupt frame, resynchronize
+            ++pos;
+            continue;
+        }
+        pos += consumed;
+
+        // Let the consumers catch up before the ring wraps
+        if (++pending == m_ring.size() / 2) {
+            emit sentencesAvailable();
+            pending = 0;
+        }
+    }
+    m_buffer.remove(0, pos);
+    if (pending)
+        emit sentencesAvailable();
+}
+
+void QNmeaDispatcher::appendSentence(const char *data, int size, Protocol protocol)
+{
+    // Slots keep their capacity, so this does not allocate once the ring has wrapped
+    Sentence &sentence = m_ring[int(m_writeSequence % quint64(m_ring.size()))];
+    sentence.data.resize(size);
+    memcpy(sentence.data.data(), data, size_t(size));
+    sentence.protocol = protocol;
+    if (protocol == UbxProtocol) {
+        sentence.type = QLocationUtils::NmeaSentenceInvalid;
+        sentence.ubxMessage = QUbxDecoder::message(data);
+    } else {
+        sentence.type = QLocationUtils::getNmeaSentenceType(data, size);
+        sentence.ubxMessage = 0;
+    }
+    sentence.positionParsed = false;
+    sentence.satellitesParsed = false;
+    ++m_writeSequence;
+
+    if (sentence.ubxMessage == QUbxDecoder::NavPvt)
+        m_navPvtEnd = m_writeSequence;
+    else if (sentence.ubxMessage == QUbxDecoder::NavSat)
+        m_navSatEnd = m_writeSequence;
+}
+
+// Whether a frame ending at the given sequence is still in the ring
+bool QNmeaDispatcher::isRecent(quint64 end) const
+{
+    return end && end + quint64(m_ring.size()) > m_writeSequence;
+}
+
+bool QNmeaDispatcher::positionInfo(Sentence *sentence, double uere, QGeoPositionInfo *info, bool *hasFix)
+{
+    if (sentence->protocol == UbxProtocol) {
+        if (sentence->ubxMessage != QUbxDecoder::NavPvt)
+            return false;
+        if (!sentence->positionParsed) {
+            sentence->position = QGeoPositionInfo();
+            sentence->positionValid = QUbxDecoder::positionInfo(sentence->data.constData(),
+                                                                sentence->data.size(),
+                                                                &sentence->position,
+                                                                &sentence->hasFix);
+            sentence->positionParsed = true;
+        }
+    } else {
+        if (sentence->type == QLocationUtils::NmeaSentenceInvalid
+                || sentence->type == QLocationUtils::NmeaSentenceGSV
+                || isRecent(m_navPvtEnd)) {
+            return false;
+        }
+
+        // The accuracy depends on the UERE, which can differ between sources
+        const bool sameUere = sentence->positionUere == uere
+                || (qIsNaN(sentence->positionUere) && qIsNaN(uere));
+        if (!sentence->positionParsed || !sameUere) {
+            sentence->position = QGeoPositionInfo();
+            sentence->positionValid = QLocationUtils::getPosInfoFromNmea(sentence->data.constData(),
+                                                                         sentence->data.size(),
+                                                                         &sentence->position, uere,
+                                                                         &sentence->hasFix);
+            sentence->positionUere = uere;
+            sentence->positionParsed = true;
+        }
+    }
+
+    if (!sentence->positionValid)
+        return false;
+    *info = sentence->position;
+    if (hasFix)
+        *hasFix = sentence->hasFix;
+    return true;
+}
+
+// Whether QLocationUtils::getSatInfoFromNmea() clears the list for this GSV sentence
+static bool qnmeadispatcher_gsvClearsList(const QByteArray &data)
+{
+    QLocationUtils::NmeaField fields[4];
+    if (QLocationUtils::splitNmeaFields(data.constData(), data.size(), fields, 4) < 4)
+        return true;
+
+    int totalSentences;
+    int sentence;
+    int totalSats;
+    if (!QLocationUtils::getNmeaInt(fields[1], &totalSentences)
+            || !QLocationUtils::getNmeaInt(fields[2], &sentence)
+            || !QLocationUtils::getNmeaInt(fields[3], &totalSats)) {
+        return true;
+    }
+    return sentence == 1;
+}
+
+bool QNmeaDispatcher::satellitesInUse(Sentence *sentence, QList<int> &pnrsInUse)
+{
+    pnrsInUse.clear();
+    if (sentence->type != QLocationUtils::NmeaSentenceGSA || isRecent(m_navSatEnd))
+        return false;
+
+    if (!sentence->satellitesParsed) {
+        QLocationUtils::getSatInUseFromNmea(sentence->data.constData(), sentence->data.size(),
+                                            sentence->satellitesInUse);
+        sentence->satellitesParsed = true;
+    }
+    pnrsInUse = sentence->satellitesInUse;
+    return true;
+}
+
+QLocationUtils::GSVParseStatus QNmeaDispatcher::satellitesInView(Sentence *sentence,
+                                                                 QList<QGeoSatelliteInfo> &infos)
+{
+    if (sentence->type != QLocationUtils::NmeaSentenceGSV || isRecent(m_navSatEnd))
+        return QLocationUtils::GSVNotParsed;
+
+    if (!sentence->satellitesParsed) {
+        // the satellites of this sentence only, consumers append them to their own list
+        sentence->satellitesInView.clear();
+        sentence->gsvStatus = QLocationUtils::getSatInfoFromNmea(sentence->data.constData(),
+                                                                 sentence->data.size(),
+                                                                 sentence->satellitesInView);
+        sentence->satellitesClear = qnmeadispatcher_gsvClearsList(sentence->data);
+        sentence->satellitesParsed = true;
+    }
+
+    if (sentence->satellitesClear)
+        infos.clear();
+    infos.append(sentence->satellitesInView);
+    return sentence->gsvStatus;
+}
+
+bool QNmeaDispatcher::satelliteUpdate(Sentence *sentence, QList<QGeoSatelliteInfo> &inView,
+                                      QList<int> &inUse)
+{
+    if (sentence->protocol != UbxProtocol || sentence->ubxMessage != QUbxDecoder::NavSat)
+        return false;
+
+    if (!sentence->satellitesParsed) {
+        sentence->gsvStatus = QUbxDecoder::satellites(sentence->data.constData(), sentence->data.size(),
+                                                      sentence->satellitesInView,
+                                                      sentence->satellitesInUse)
+                ? QLocationUtils::GSVFullyParsed : QLocationUtils::GSVNotParsed;
+        sentence->satellitesParsed = true;
+    }
+    if (sentence->gsvStatus != QLocationUtils::GSVFullyParsed)
+        return false;
+    inView = sentence->satellitesInView;
+    inUse = sentence->satellitesInUse;
+    return true;
+}
+
+QNmeaDispatcherDevice::QNmeaDispatcherDevice(QNmeaDispatcher *dispatcher, QObject *parent)
+    : QIODevice(parent), m_dispatcher(dispatcher), m_readSequence(dispatcher->writeSequence())
+{
+    connect(dispatcher, &QNmeaDispatcher::sentencesAvailable, this, &QIODevice::readyRead);
+    connect(dispatcher, &QNmeaDispatcher::readChannelFinished, this, &QIODevice::readChannelFinished);
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+QNmeaDispatcherDevice::~QNmeaDispatcherDevice()
+{
+}
+
+bool QNmeaDispatcherDevice::isSequential() const
+{
+    return true;
+}
+
+QNmeaDispatcher *QNmeaDispatcherDevice::dispatcher() const
+{
+    return m_dispatcher;
+}
+
+void QNmeaDispatcherDevice::skipOverwritten() const
+{
+    if (m_dispatcher && m_readSequence < m_dispatcher->oldestSequence()) {
+        m_readSequence = m_dispatcher->oldestSequence();
+        m_readOffset = 0;
+    }
+}
+
+qint64 QNmeaDispatcherDevice::bytesAvailable() const
+{
+    qint64 available = QIODevice::bytesAvailable();
+    if (!m_dispatcher)
+        return available;
+
+    skipOverwritten();
+    for (quint64 sequence = m_readSequence; sequence < m_dispatcher->writeSequence(); ++sequence)
+        available += m_dispatcher->sentence(sequence)->data.size();
+    return available - m_readOffset;
+}
+
+bool QNmeaDispatcherDevice::canReadLine() const
+{
+    if (QIODevice::canReadLine())
+        return true;
+    if (!m_dispatcher)
+        return false;
+    skipOverwritten();
+    return m_readSequence < m_dispatcher->writeSequence();
+}
+
+QNmeaDispatcher::Sentence *QNmeaDispatcherDevice::lastSentence(const char *data, int size) const
+{
+    if (!m_hasLastSentence || !m_dispatcher)
+        return nullptr;
+
+    QNmeaDispatcher::Sentence *sentence = m_dispatcher->sentence(m_lastSequence);
+    if (!sentence || sentence->data.size() != size || memcmp(sentence->data.constData(), data, size_t(size)))
+        return nullptr;
+    return sentence;
+}
+
+qint64 QNmeaDispatcherDevice::readData(char *data, qint64 maxlen)
+{
+    m_hasLastSentence = false;
+    if (!m_dispatcher)
+        return -1;
+
+    skipOverwritten();
+    qint64 read = 0;
+    while (read < maxlen && m_readSequence < m_dispatcher->writeSequence()) {
+        const QByteArray &sentence = m_dispatcher->sentence(m_readSequence)->data;
+        const qint64 chunk = qMin<qint64>(maxlen - read, sentence.size() - m_readOffset);
+        memcpy(data + read, sentence.constData() + m_readOffset, size_t(chunk));
+        read += chunk;
+        m_readOffset += int(chunk);
+        if (m_readOffset == sentence.size()) {
+            ++m_readSequence;
+            m_readOffset = 0;
+        }
+    }
+    return read;
+}
+
+qint64 QNmeaDispatcherDevice::readLineData(char *data, qint64 maxlen)
+{
+    m_hasLastSentence = false;
+    if (!m_dispatcher)
+        return -1;
+
+    skipOverwritten();
+    if (m_readSequence >= m_dispatcher->writeSequence())
+        return 0;
+
+    // A sentence is one line
+    const QByteArray &sentence = m_dispatcher->sentence(m_readSequence)->data;
+    const int offset = m_readOffset;
+    const qint64 chunk = qMin<qint64>(maxlen, sentence.size() - offset);
+    memcpy(data, sentence.constData() + offset, size_t(chunk));
+    m_readOffset += int(chunk);
+    if (m_readOffset == sentence.size()) {
+        if (offset == 0) {
+            m_hasLastSentence = true;
+            m_lastSequence = m_readSequence;
+        }
+        ++m_readSequence;
+        m_readOffset = 0;
+    }
+    return chunk;
+}
+
+qint64 QNmeaDispatcherDevice::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return -1;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QNMEADISPATCHER_P_H
+#define QNMEADISPATCHER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/qgeopositioninfo.h>
+#include <QtPositioning/qgeosatelliteinfo.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Reads NMEA sentences from a device once, for any number of position and
+    satellite sources sharing it. UBX frames found between the sentences are
+    kept as ring entries of their own, see QUbxDecoder; while a receiver sends
+    the binary navigation solution, the NMEA sentences it replaces are ignored.
+    Sentences go into a ring with sequence
+    numbers, so every consumer keeps its own read position and the dispatcher
+    never waits for, or keeps track of, slow consumers: they skip what has been
+    overwritten. Parse results are cached in the ring slots and shared by all
+    consumers.
+*/
+class QNmeaDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Protocol {
+        NmeaProtocol,
+        UbxProtocol
+    };
+
+    struct Sentence
+    {
+        QByteArray data;
+        Protocol protocol = NmeaProtocol;
+        QLocationUtils::NmeaSentence type = QLocationUtils::NmeaSentenceInvalid;
+        quint16 ubxMessage = 0;
+
+        // Parse results, filled in by the first consumer asking for them
+        bool positionParsed = false;
+        bool positionValid = false;
+        bool hasFix = false;
+        double positionUere = 0.0;
+        QGeoPositionInfo position;
+
+        bool satellitesParsed = false;
+        bool satellitesClear = false;
+        QLocationUtils::GSVParseStatus gsvStatus = QLocationUtils::GSVNotParsed;
+        QList<int> satellitesInUse;
+        QList<QGeoSatelliteInfo> satellitesInView;
+    };
+
+    explicit QNmeaDispatcher(QIODevice *device, QObject *parent = nullptr);
+    ~QNmeaDispatcher() override;
+
+    QIODevice *device() const;
+
+    quint64 writeSequence() const;
+    quint64 oldestSequence() const;
+    Sentence *sentence(quint64 sequence);
+
+    bool positionInfo(Sentence *sentence, double uere, QGeoPositionInfo *info, bool *hasFix);
+    bool satellitesInUse(Sentence *sentence, QList<int> &pnrsInUse);
+    QLocationUtils::GSVParseStatus satellitesInView(Sentence *sentence, QList<QGeoSatelliteInfo> &infos);
+    bool satelliteUpdate(Sentence *sentence, QList<QGeoSatelliteInfo> &inView, QList<int> &inUse);
+
+Q_SIGNALS:
+    void sentencesAvailable();
+    void readChannelFinished();
+
+private Q_SLOTS:
+    void readAvailableData();
+
+private:
+    void appendSentence(const char *data, int size, Protocol protocol);
+    bool isRecent(quint64 end) const;
+
+    QPointer<QIODevice> m_device;
+    QByteArray m_buffer;
+    QVector<Sentence> m_ring;
+    quint64 m_writeSequence = 0;
+    // Sequence after the last NAV-PVT and NAV-SAT frame, 0 if there was none
+    quint64 m_navPvtEnd = 0;
+    quint64 m_navSatEnd = 0;
+};
+
+/*
+    The reading end of a QNmeaDispatcher for one source. Lines are read
+    straight from the ring, nothing is copied per consumer.
+*/
+class QNmeaDispatcherDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit QNmeaDispatcherDevice(QNmeaDispatcher *dispatcher, QObject *parent = nullptr);
+    ~QNmeaDispatcherDevice() override;
+
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+    bool canReadLine() const override;
+
+    QNmeaDispatcher *dispatcher() const;
+    // The sentence last returned by readLine() if it is data, for its parse results
+    QNmeaDispatcher::Sentence *lastSentence(const char *data, int size) const;
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 readLineData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    void skipOverwritten() const;
+
+    QPointer<QNmeaDispatcher> m_dispatcher;
+    mutable quint64 m_readSequence = 0;
+    mutable int m_readOffset = 0;
+    quint64 m_lastSequence = 0;
+    bool m_hasLastSentence = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QNMEADISPATCHER_P_H
@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qnmeasatelliteinfosource_p.h"
+#include "qnmeasatellitetable_p.h"
 #include <QtPositioning/private/qgeosatelliteinfo_p.h>
 #include <QtPositioning/private/qgeosatelliteinfosource_p.h>
 #include <QtPositioning/private/qlocationutils_p.h>
@@ -226,6 +227,7 @@ public:
     int m_pushDelay = 20;
     QBasicTimer *m_updateTimer = nullptr; // the timer used in startUpdates()
     QTimer *m_requestTimer = nullptr; // the timer used in requestUpdate()
+    QNmeaSatelliteTable m_satellites; // of the last emitted update
 
 protected:
     void readAvailableData();
@@ -309,6 +311,7 @@ void QNmeaSatelliteInfoSourcePrivate::startUpdates()
 void QNmeaSatelliteInfoSourcePrivate::stopUpdates()
 {
     m_invokedStart = false;
+    m_satellites.clear();
     if (m_updateTimer)
         m_updateTimer->stop();
     m_pendingUpdate.clear();
@@ -380,7 +383,17 @@ void QNmeaSatelliteInfoSourcePrivate::readAvailableData()
         char buf[1024];
         qint64 size = m_device->readLine(buf, sizeof(buf));
         QList<int> satInUse;
-        const bool satInUseParsed = QLocationUtils::getSatInUseFromNmea(buf, size, satInUse);
+        QNmeaSatelliteInfoSource *source = static_cast<QNmeaSatelliteInfoSource *>(m_source);
+        QList<QGeoSatelliteInfo> satInView;
+        if (source->parseSatelliteUpdate(buf, size, satInView, satInUse)) {
+            // a complete update, resolve the satellites in use against it
+            m_pendingUpdate.m_satellitesInUse.clear();
+            m_pendingUpdate.m_inUse = satInUse;
+            m_pendingUpdate.setSatellitesInView(satInView);
+            m_pendingUpdate.m_validInUse = true;
+            continue;
+        }
+        const bool satInUseParsed = source->parseSatellitesInUseFromNmea(buf, size, satInUse);
         if (satInUseParsed) {
             m_pendingUpdate.setSatellitesInUse(satInUse);
 #if USE_NMEA_PIMPL
@@ -393,7 +406,7 @@ void QNmeaSatelliteInfoSourcePrivate::readAvailableData()
             }
 #endif
         } else {
-            const QLocationUtils::GSVParseStatus parserStatus = QLocationUtils::getSatInfoFromNmea(buf, size, m_pendingUpdate.m_satellitesInView);
+            const QLocationUtils::GSVParseStatus parserStatus = source->parseSatelliteInfoFromNmea(buf, size, m_pendingUpdate.m_satellitesInView);
             if (parserStatus == QLocationUtils::GSVPartiallyParsed) {
                 m_pendingUpdate.m_updatingGsv = true;
 #if USE_NMEA_PIMPL
@@ -460,9 +473,10 @@ bool QNmeaSatelliteInfoSourcePrivate::emitUpdated(QNmeaSatelliteInfoSourcePrivat
         return emitted;
 
     update.consume();
-    const bool inUseUpdated = update.m_satellitesInUse != m_lastUpdate.m_satellitesInUse;
-    const bool inViewUpdated = update.m_satellitesInView != m_lastUpdate.m_satellitesInView;
-
+    const QNmeaSatelliteTable::ChangeSet &changes = m_satellites.update(update.m_satellitesInView,
+                                                                        update.m_satellitesInUse);
+    const bool inUseUpdated = changes.inUseChanged;
+    const bool inViewUpdated = changes.inViewChanged;
 
     m_lastUpdate = update;
     if (update.m_validInUse && inUseUpdated) {
@@ -473,6 +487,13 @@ bool QNmeaSatelliteInfoSourcePrivate::emitUpdated(QNmeaSatelliteInfoSourcePrivat
         emit m_source->satellitesInViewUpdated(update.m_satellitesInView);
         emitted = true;
     }
+    if (!changes.isEmpty()) {
+        QList<QGeoSatelliteInfo> updated;
+        updated.reserve(changes.updated.size());
+        for (int i : changes.updated)
+            updated.append(m_satellites.at(i).info);
+        emit static_cast<QNmeaSatelliteInfoSource *>(m_source)->satellitesChanged(updated, changes.removed);
+    }
     return emitted;
 }
 
@@ -546,6 +567,60 @@ void QNmeaSatelliteInfoSource::requestUpdate(int msec)
     d->requestUpdate(msec == 0 ? 60000 * 5 : msec); // 5min default timeout
 }
 
+/*
+    Returns whether \a info was in use in the last update. Invokable, as
+    applications only see the QGeoSatelliteInfoSource interface.
+*/
+bool QNmeaSatelliteInfoSource::isSatelliteInUse(const QGeoSatelliteInfo &info) const
+{
+    const int i = d->m_satellites.indexOf(QNmeaSatelliteTable::key(info));
+    return i >= 0 && d->m_satellites.at(i).inUse;
+}
+
+/*
+    \fn void QNmeaSatelliteInfoSource::satellitesChanged(const QList<QGeoSatelliteInfo> &updated, const QList<QGeoSatelliteInfo> &removed)
+
+    Emitted after the satellitesInViewUpdated() and satellitesInUseUpdated()
+    signals of an update, with the satellites that were added or changed, or
+    whose use changed, and those no longer in view. Models can apply these
+    instead of rebuilding from the full lists. Satellites are identified by
+    their system and number.
+*/
+
+/*
+    Parses a GSA sentence into the PRNs of the satellites in use, like
+    QLocationUtils::getSatInUseFromNmea(). Reimplemented by sources sharing
+    the parse results of other sources.
+*/
+bool QNmeaSatelliteInfoSource::parseSatellitesInUseFromNmea(const char *data, int size, QList<int> &pnrsInUse)
+{
+    return QLocationUtils::getSatInUseFromNmea(data, size, pnrsInUse);
+}
+
+/*
+    Parses a GSV sentence into \a infos, like QLocationUtils::getSatInfoFromNmea().
+*/
+QLocationUtils::GSVParseStatus QNmeaSatelliteInfoSource::parseSatelliteInfoFromNmea(const char *data, int size,
+                                                                                    QList<QGeoSatelliteInfo> &infos)
+{
+    return QLocationUtils::getSatInfoFromNmea(data, size, infos);
+}
+
+/*
+    Parses a complete satellite update, the satellites in view and the
+    numbers of those in use, from a message that is not NMEA. Returns false
+    by default; reimplemented by sources understanding binary protocols.
+*/
+bool QNmeaSatelliteInfoSource::parseSatelliteUpdate(const char *data, int size,
+                                                    QList<QGeoSatelliteInfo> &inView, QList<int> &inUse)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+    Q_UNUSED(inView);
+    Q_UNUSED(inUse);
+    return false;
+}
+
 void QNmeaSatelliteInfoSource::setError(QGeoSatelliteInfoSource::Error satelliteError)
 {
     d->m_satelliteError = satelliteError;
@@ -54,6 +54,7 @@
 //#include <QtPositioning/private/qpositioningglobal_p.h>
 #include <QtPositioning/qgeosatelliteinfosource.h>
 #include <QtPositioning/qgeosatelliteinfo.h>
+#include <QtPositioning/private/qlocationutils_p.h>
 
 #include <QObject>
 #include <QQueue>
@@ -78,12 +79,23 @@ public:
     int minimumUpdateInterval() const override;
     Error error() const override;
 
+    Q_INVOKABLE bool isSatelliteInUse(const QGeoSatelliteInfo &info) const;
+
 public Q_SLOTS:
     void startUpdates() override;
     void stopUpdates() override;
     void requestUpdate(int timeout = 0) override;
 
+Q_SIGNALS:
+    void satellitesChanged(const QList<QGeoSatelliteInfo> &updated, const QList<QGeoSatelliteInfo> &removed);
+
 protected:
+    virtual bool parseSatellitesInUseFromNmea(const char *data, int size, QList<int> &pnrsInUse);
+    virtual QLocationUtils::GSVParseStatus parseSatelliteInfoFromNmea(const char *data, int size,
+                                                                      QList<QGeoSatelliteInfo> &infos);
+    virtual bool parseSatelliteUpdate(const char *data, int size, QList<QGeoSatelliteInfo> &inView,
+                                      QList<int> &inUse);
+
     QNmeaSatelliteInfoSourcePrivate *d;
     void setError(QGeoSatelliteInfoSource::Error satelliteError);
 
@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qnmeasatellitetable_p.h"
+#include <QtPositioning/private/qgeosatelliteinfo_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+quint32 QNmeaSatelliteTable::key(const QGeoSatelliteInfo &info)
+{
+    return (quint32(info.satelliteSystem()) << 16) | quint16(info.satelliteIdentifier());
+}
+
+int QNmeaSatelliteTable::lowerBound(quint32 key) const
+{
+    const auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), key,
+                                     [](const Entry &entry, quint32 k) { return entry.key < k; });
+    return int(it - m_entries.cbegin());
+}
+
+int QNmeaSatelliteTable::indexOf(quint32 key) const
+{
+    const int i = lowerBound(key);
+    return i < m_entries.size() && m_entries.at(i).key == key ? i : -1;
+}
+
+void QNmeaSatelliteTable::clear()
+{
+    m_entries.clear();
+    m_changes = ChangeSet();
+}
+
+// Assigns the fields, QGeoSatelliteInfo::operator=() would reallocate
+static void assignSatellite(QGeoSatelliteInfo &dst, const QGeoSatelliteInfo &src)
+{
+    QGeoSatelliteInfoPrivate *dstPimpl = QGeoSatelliteInfoPrivate::get(dst);
+    const QGeoSatelliteInfoPrivate *srcPimpl = QGeoSatelliteInfoPrivate::get(src);
+    dstPimpl->signal = srcPimpl->signal;
+    dstPimpl->satId = srcPimpl->satId;
+    dstPimpl->system = srcPimpl->system;
+    dstPimpl->doubleAttribs = srcPimpl->doubleAttribs;
+}
+
+const QNmeaSatelliteTable::ChangeSet &QNmeaSatelliteTable::update(const QList<QGeoSatelliteInfo> &inView,
+                                                                  const QList<QGeoSatelliteInfo> &inUse)
+{
+    // keeps the capacity of the previous change set
+    m_changes.updated.resize(0);
+    m_changes.removed.clear();
+    m_changes.inViewChanged = false;
+    m_changes.inUseChanged = false;
+    ++m_epoch;
+
+    for (const QGeoSatelliteInfo &info : inView) {
+        const quint32 k = key(info);
+        const int i = lowerBound(k);
+        if (i < m_entries.size() && m_entries.at(i).key == k) {
+            Entry &entry = m_entries[i];
+            if (entry.epoch == m_epoch)
+                continue; // listed twice
+            entry.epoch = m_epoch;
+            entry.changed = entry.info != info;
+            if (entry.changed) {
+                assignSatellite(entry.info, info);
+                m_changes.inViewChanged = true;
+            }
+        } else {
+            const Entry entry = { k, info, false, false, true, m_epoch };
+            m_entries.insert(i, entry);
+            m_changes.inViewChanged = true;
+        }
+    }
+
+    // drops the satellites that are no longer in view
+    int kept = 0;
+    for (int i = 0; i < m_entries.size(); ++i) {
+        Entry &entry = m_entries[i];
+        if (entry.epoch != m_epoch) {
+            m_changes.removed.append(entry.info);
+            m_changes.inViewChanged = true;
+            if (entry.inUse)
+                m_changes.inUseChanged = true;
+            continue;
+        }
+        if (kept != i) {
+            Entry &dst = m_entries[kept];
+            dst.key = entry.key;
+            assignSatellite(dst.info, entry.info);
+            dst.inUse = entry.inUse;
+            dst.changed = entry.changed;
+            dst.epoch = entry.epoch;
+        }
+        ++kept;
+    }
+    m_entries.resize(kept);
+
+    // the satellites in use are a subset of those in view
+    for (Entry &entry : m_entries) {
+        entry.wasInUse = entry.inUse;
+        entry.inUse = false;
+    }
+    for (const QGeoSatelliteInfo &info : inUse) {
+        const int i = indexOf(key(info));
+        if (i >= 0)
+            m_entries[i].inUse = true;
+    }
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry &entry = m_entries.at(i);
+        if (entry.inUse != entry.wasInUse || (entry.inUse && entry.changed))
+            m_changes.inUseChanged = true;
+        if (entry.changed || entry.inUse != entry.wasInUse)
+            m_changes.updated.append(i);
+    }
+    return m_changes;
+}
+
+QT_END_NAMESPACE
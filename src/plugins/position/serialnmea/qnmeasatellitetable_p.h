@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QNMEASATELLITETABLE_P_H
+#define QNMEASATELLITETABLE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/qgeosatelliteinfo.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The satellites of the last update, keyed by (system, number) and kept
+    sorted by key. Entries are updated in place and reused between epochs, so
+    a steady constellation does not allocate. update() returns what changed.
+*/
+class QNmeaSatelliteTable
+{
+public:
+    struct Entry
+    {
+        quint32 key;
+        QGeoSatelliteInfo info;
+        bool inUse;
+        bool wasInUse; // the state of the previous update
+        bool changed; // added or changed by the last update
+        quint32 epoch;
+    };
+
+    struct ChangeSet
+    {
+        QVector<int> updated; // indexes of added or changed entries
+        QList<QGeoSatelliteInfo> removed;
+        bool inViewChanged = false;
+        bool inUseChanged = false;
+
+        bool isEmpty() const { return !inViewChanged && !inUseChanged; }
+    };
+
+    static quint32 key(const QGeoSatelliteInfo &info);
+
+    const ChangeSet &update(const QList<QGeoSatelliteInfo> &inView,
+                            const QList<QGeoSatelliteInfo> &inUse);
+
+    int count() const { return m_entries.size(); }
+    const Entry &at(int i) const { return m_entries.at(i); }
+    int indexOf(quint32 key) const;
+    void clear();
+
+private:
+    int lowerBound(quint32 key) const;
+
+    QVector<Entry> m_entries;
+    ChangeSet m_changes;
+    quint32 m_epoch = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QNMEASATELLITETABLE_P_H
@@ -0,0 +1,219 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qubxdecoder_p.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qendian.h>
+
+QT_BEGIN_NAMESPACE
+
+// Payload sizes, newer protocol versions may append fields
+static const int UBX_NAV_PVT_SIZE = 92;
+static const int UBX_NAV_SAT_HEADER_SIZE = 8;
+static const int UBX_NAV_SAT_BLOCK_SIZE = 12;
+
+template <typename T>
+static inline T qubxdecoder_read(const char *payload, int offset)
+{
+    return qFromLittleEndian<T>(payload + offset);
+}
+
+int QUbxDecoder::frameSize(const char *data, int size)
+{
+    if (size < 1)
+        return 0;
+    if (uchar(data[0]) != SyncChar1)
+        return -1;
+    if (size < 2)
+        return 0;
+    if (uchar(data[1]) != SyncChar2)
+        return -1;
+    if (size < HeaderSize)
+        return 0;
+
+    const int length = qubxdecoder_read<quint16>(data, 4);
+    const int frame = HeaderSize + length + ChecksumSize;
+    if (frame > MaxFrameSize)
+        return -1;
+    if (size < frame)
+        return 0;
+
+    uchar a = 0;
+    uchar b = 0;
+    for (int i = 2; i < HeaderSize + length; ++i) {
+        a += uchar(data[i]);
+        b += a;
+    }
+    if (uchar(data[frame - 2]) != a || uchar(data[frame - 1]) != b)
+        return -1;
+    return frame;
+}
+
+bool QUbxDecoder::isFrame(const char *data, int size)
+{
+    return frameSize(data, size) == size;
+}
+
+quint16 QUbxDecoder::message(const char *frame)
+{
+    return quint16((uchar(frame[2]) << 8) | uchar(frame[3]));
+}
+
+bool QUbxDecoder::positionInfo(const char *frame, int size, QGeoPositionInfo *info, bool *hasFix)
+{
+    if (hasFix)
+        *hasFix = false;
+    if (!isFrame(frame, size) || message(frame) != NavPvt
+            || size - HeaderSize - ChecksumSize < UBX_NAV_PVT_SIZE) {
+        return false;
+    }
+
+    const char *p = frame + HeaderSize;
+    const uchar valid = uchar(p[11]);
+    const uchar fixType = uchar(p[20]);
+    const uchar flags = uchar(p[21]);
+
+    // validDate and validTime, the date alone is not enough for merging
+    QDateTime timestamp;
+    if (valid & 0x02) {
+        const QTime time(uchar(p[8]), uchar(p[9]), uchar(p[10]));
+        // nano is the signed offset of the actual time from the rounded second,
+        // which may be on the day before or after
+        const int nanoMSecs = qRound(qubxdecoder_read<qint32>(p, 16) / 1e6);
+        const QDate date = (valid & 0x01)
+                ? QDate(qubxdecoder_read<quint16>(p, 4), uchar(p[6]), uchar(p[7]))
+                : QDate();
+        if (date.isValid())
+            timestamp = QDateTime(date, time, Qt::UTC).addMSecs(nanoMSecs);
+        else
+            timestamp = QDateTime(date, time.addMSecs(nanoMSecs), Qt::UTC);
+    }
+    if (!timestamp.time().isValid())
+        return false;
+
+    QGeoPositionInfo update;
+    update.setTimestamp(timestamp);
+
+    // 2D, 3D and GNSS + dead reckoning fixes, gnssFixOK
+    const bool fix = fixType >= 2 && fixType <= 4 && (flags & 0x01);
+    if (fix) {
+        QGeoCoordinate coordinate(qubxdecoder_read<qint32>(p, 28) * 1e-7,
+                                  qubxdecoder_read<qint32>(p, 24) * 1e-7);
+        if (fixType != 2)
+            coordinate.setAltitude(qubxdecoder_read<qint32>(p, 36) / 1000.0); // above mean sea level
+        update.setCoordinate(coordinate);
+
+        update.setAttribute(QGeoPositionInfo::HorizontalAccuracy,
+                            qubxdecoder_read<quint32>(p, 40) / 1000.0);
+        if (fixType != 2) {
+            update.setAttribute(QGeoPositionInfo::VerticalAccuracy,
+                                qubxdecoder_read<quint32>(p, 44) / 1000.0);
+            update.setAttribute(QGeoPositionInfo::VerticalSpeed,
+                                -qubxdecoder_read<qint32>(p, 56) / 1000.0); // velD points down
+        }
+        update.setAttribute(QGeoPositionInfo::GroundSpeed, qubxdecoder_read<qint32>(p, 60) / 1000.0);
+        update.setAttribute(QGeoPositionInfo::Direction, qubxdecoder_read<qint32>(p, 64) * 1e-5);
+    }
+
+    *info = update;
+    if (hasFix)
+        *hasFix = fix;
+    return true;
+}
+
+// The satellite numbers of the extended NMEA output (NMEA 4.11) of u-blox receivers
+static int qubxdecoder_satelliteNumber(int gnssId, int svId, QGeoSatelliteInfo::SatelliteSystem *system)
+{
+    *system = QGeoSatelliteInfo::Undefined;
+    switch (gnssId) {
+    case 0: // GPS
+        *system = QGeoSatelliteInfo::GPS;
+        return svId;
+    case 1: // SBAS, PRN 120-158
+        return svId - 87;
+    case 2: // Galileo
+        return 300 + svId;
+    case 3: // BeiDou
+        return 400 + svId;
+    case 5: // QZSS
+        return 192 + svId;
+    case 6: // GLONASS
+        *system = QGeoSatelliteInfo::GLONASS;
+        return 64 + svId;
+    default:
+        return -1;
+    }
+}
+
+bool QUbxDecoder::satellites(const char *frame, int size, QList<QGeoSatelliteInfo> &inView,
+                             QList<int> &inUse)
+{
+    if (!isFrame(frame, size) || message(frame) != NavSat)
+        return false;
+
+    const char *p = frame + HeaderSize;
+    const int length = size - HeaderSize - ChecksumSize;
+    if (length < UBX_NAV_SAT_HEADER_SIZE)
+        return false;
+    const int count = uchar(p[5]);
+    if (length < UBX_NAV_SAT_HEADER_SIZE + count * UBX_NAV_SAT_BLOCK_SIZE)
+        return false;
+
+    inView.clear();
+    inUse.clear();
+    for (int i = 0; i < count; ++i) {
+        const char *block = p + UBX_NAV_SAT_HEADER_SIZE + i * UBX_NAV_SAT_BLOCK_SIZE;
+        QGeoSatelliteInfo::SatelliteSystem system;
+        const int number = qubxdecoder_satelliteNumber(uchar(block[0]), uchar(block[1]), &system);
+        if (number < 0)
+            continue;
+
+        QGeoSatelliteInfo info;
+        info.setSatelliteSystem(system);
+        info.setSatelliteIdentifier(number);
+        info.setSignalStrength(uchar(block[2]));
+        info.setAttribute(QGeoSatelliteInfo::Elevation, qint8(block[3]));
+        info.setAttribute(QGeoSatelliteInfo::Azimuth, qubxdecoder_read<qint16>(block, 4));
+        inView.append(info);
+
+        // svUsed
+        if (qubxdecoder_read<quint32>(block, 8) & 0x08)
+            inUse.append(number);
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
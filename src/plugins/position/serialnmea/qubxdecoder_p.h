@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QUBXDECODER_P_H
+#define QUBXDECODER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/qgeopositioninfo.h>
+#include <QtPositioning/qgeosatelliteinfo.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Decodes frames of the u-blox binary protocol (UBX). A frame is
+
+        0xB5 0x62 class id length(LE16) payload checksum(2)
+
+    with a Fletcher checksum over class, id, length and payload. Only the
+    messages carrying a complete navigation solution are decoded: NAV-PVT
+    for positions and NAV-SAT for satellites.
+*/
+class QUbxDecoder
+{
+public:
+    enum {
+        SyncChar1 = 0xB5,
+        SyncChar2 = 0x62,
+        HeaderSize = 6,
+        ChecksumSize = 2,
+        MaxFrameSize = 1023 // what fits into the line buffers of the NMEA readers
+    };
+
+    enum Message {
+        NavPvt = 0x0107,
+        NavSat = 0x0135
+    };
+
+    /*
+        Returns the size of the valid frame at the start of data, 0 if more
+        data is needed to tell, and -1 if data does not start a valid frame.
+    */
+    static int frameSize(const char *data, int size);
+
+    static bool isFrame(const char *data, int size);
+
+    // The message, class << 8 | id, of a complete frame
+    static quint16 message(const char *frame);
+
+    /*
+        Decodes a NAV-PVT frame. The accuracies reported by the receiver are
+        used as they are, no UERE is needed.
+    */
+    static bool positionInfo(const char *frame, int size, QGeoPositionInfo *info, bool *hasFix);
+
+    /*
+        Decodes a NAV-SAT frame. Satellites are numbered like in the extended
+        NMEA output of u-blox receivers, so the numbers of all systems differ.
+    */
+    static bool satellites(const char *frame, int size, QList<QGeoSatelliteInfo> &inView,
+                           QList<int> &inUse);
+};
+
+QT_END_NAMESPACE
+
+#endif // QUBXDECODER_P_H
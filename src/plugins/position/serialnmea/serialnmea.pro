@@ -3,10 +3,12 @@ TARGET = qtposition_serialnmea
 QT = core-private positioning-private serialport
 
 HEADERS += \
-    qgeopositioninfosourcefactory_serialnmea.h qnmeasatelliteinfosource_p.h qiopipe_p.h
+    qgeopositioninfosourcefactory_serialnmea.h qnmeasatelliteinfosource_p.h qnmeadispatcher_p.h qubxdecoder_p.h \
+    qnmeasatellitetable_p.h
 
 SOURCES += \
-    qgeopositioninfosourcefactory_serialnmea.cpp qnmeasatelliteinfosource.cpp qiopipe.cpp
+    qgeopositioninfosourcefactory_serialnmea.cpp qnmeasatelliteinfosource.cpp qnmeadispatcher.cpp qubxdecoder.cpp \
+    qnmeasatellitetable.cpp
 
 OTHER_FILES += \
     plugin.json
@@ -0,0 +1,349 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeopositioninfosource_synthetic_p.h"
+
+#include <QtPositioning/qgeopath.h>
+#include <QtPositioning/private/qgeopositioninfosource_p.h>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+static const auto parameterPrefix = "synthetic.";
+// Ticks falling behind by more than this many seconds of positions skip them
+static const int MaxCatchUpSeconds = 1;
+
+static QGeoCoordinate toCoordinate(const QVariant &value)
+{
+    if (value.userType() == qMetaTypeId<QGeoCoordinate>())
+        return value.value<QGeoCoordinate>();
+
+    if (value.type() == QVariant::Map) {
+        const QVariantMap map = value.toMap();
+        QGeoCoordinate coordinate(map.value(QStringLiteral("latitude")).toDouble(),
+                                  map.value(QStringLiteral("longitude")).toDouble());
+        if (map.contains(QStringLiteral("altitude")))
+            coordinate.setAltitude(map.value(QStringLiteral("altitude")).toDouble());
+        return coordinate;
+    }
+
+    QVariantList values;
+    if (value.type() == QVariant::String) {
+        const QStringList parts = value.toString().split(QLatin1Char(','));
+        for (const QString &part : parts)
+            values.append(part.trimmed());
+    } else {
+        values = value.toList();
+    }
+    if (values.size() < 2)
+        return QGeoCoordinate();
+
+    bool latitudeOk = false;
+    bool longitudeOk = false;
+    QGeoCoordinate coordinate(values.at(0).toDouble(&latitudeOk),
+                              values.at(1).toDouble(&longitudeOk));
+    if (!latitudeOk || !longitudeOk)
+        return QGeoCoordinate();
+    if (values.size() > 2)
+        coordinate.setAltitude(values.at(2).toDouble());
+    return coordinate;
+}
+
+// Accepts a QGeoPath, a list of coordinates or "latitude,longitude;latitude,longitude"
+static QVector<QGeoCoordinate> toPath(const QVariant &value)
+{
+    QVector<QGeoCoordinate> path;
+    if (value.userType() == qMetaTypeId<QGeoPath>()) {
+        const QList<QGeoCoordinate> coordinates = value.value<QGeoPath>().path();
+        path.reserve(coordinates.size());
+        for (const QGeoCoordinate &coordinate : coordinates)
+            path.append(coordinate);
+        return path;
+    }
+
+    QVariantList entries;
+    if (value.type() == QVariant::String) {
+        const QStringList parts = value.toString().split(QLatin1Char(';'), Qt::SkipEmptyParts);
+        for (const QString &part : parts)
+            entries.append(part);
+    } else {
+        entries = value.toList();
+    }
+    for (const QVariant &entry : qAsConst(entries)) {
+        const QGeoCoordinate coordinate = toCoordinate(entry);
+        if (coordinate.isValid())
+            path.append(coordinate);
+    }
+    return path;
+}
+
+QGeoPositionInfoSourceSynthetic::QGeoPositionInfoSourceSynthetic(const QVariantMap &parameters,
+                                                                 QObject *parent)
+    : QGeoPositionInfoSource(parent)
+{
+    auto parameter = [&parameters](const char *name) {
+        return parameters.value(QLatin1String(parameterPrefix) + QLatin1String(name));
+    };
+
+    m_rate = qMax<qreal>(0, parameter("rate").toDouble());
+    if (parameter("speed").isValid())
+        m_speed = qMax<qreal>(0, parameter("speed").toDouble());
+    if (parameter("accuracy").isValid())
+        m_accuracy = qMax<qreal>(0, parameter("accuracy").toDouble());
+    if (parameter("turn_rate").isValid())
+        m_turnRate = qMax<qreal>(0, parameter("turn_rate").toDouble());
+    if (parameter("loop").isValid())
+        m_loop = parameter("loop").toBool();
+    m_batch = parameter("batch").toBool();
+
+    // devices with the same seed still move differently
+    const quint32 device = parameter("device").toUInt();
+    m_random.seed(parameter("seed").toUInt() ^ (device * 0x9e3779b9u));
+
+    m_path = toPath(parameter("path"));
+    if (m_path.size() >= 2) {
+        m_lengths.reserve(m_path.size());
+        m_lengths.append(0);
+        for (int i = 1; i < m_path.size(); ++i)
+            m_lengths.append(m_lengths.last() + m_path.at(i - 1).distanceTo(m_path.at(i)));
+
+        const double spacing = parameter("spacing").isValid()
+                ? qMax(0.0, parameter("spacing").toDouble()) : 50.0;
+        m_distance = device * spacing;
+        if (m_loop && m_lengths.last() > 0)
+            m_distance = std::fmod(m_distance, m_lengths.last());
+        moveAlongPath(0);
+    } else {
+        m_path.clear();
+        m_coordinate = toCoordinate(parameter("start"));
+        if (!m_coordinate.isValid())
+            m_coordinate = QGeoCoordinate(0, 0);
+        m_heading = m_random.generateDouble() * 360.0;
+    }
+
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &QGeoPositionInfoSourceSynthetic::tick);
+}
+
+QGeoPositionInfoSourceSynthetic::~QGeoPositionInfoSourceSynthetic()
+{
+}
+
+bool QGeoPositionInfoSourceSynthetic::hasParameters(const QVariantMap &parameters)
+{
+    for (auto it = parameters.keyBegin(); it != parameters.keyEnd(); ++it) {
+        if (it->startsWith(QLatin1String(parameterPrefix)))
+            return true;
+    }
+    return false;
+}
+
+void QGeoPositionInfoSourceSynthetic::setUpdateInterval(int msec)
+{
+    QGeoPositionInfoSource::setUpdateInterval(msec);
+    if (m_timer.isActive() && m_rate <= 0) {
+        stopUpdates();
+        startUpdates();
+    }
+}
+
+QGeoPositionInfo QGeoPositionInfoSourceSynthetic::lastKnownPosition(bool fromSatellitePositioningMethodsOnly) const
+{
+    Q_UNUSED(fromSatellitePositioningMethodsOnly);
+    return m_lastPosition;
+}
+
+QGeoPositionInfoSource::PositioningMethods QGeoPositionInfoSourceSynthetic::supportedPositioningMethods() const
+{
+    return SatellitePositioningMethods;
+}
+
+int QGeoPositionInfoSourceSynthetic::minimumUpdateInterval() const
+{
+    return 1;
+}
+
+QGeoPositionInfoSource::Error QGeoPositionInfoSourceSynthetic::error() const
+{
+    return m_error;
+}
+
+void QGeoPositionInfoSourceSynthetic::startUpdates()
+{
+    if (m_timer.isActive())
+        return;
+
+    m_due = 0;
+    m_clock.start();
+    m_timer.start(qBound(1, int(1000 / rate()), 1000));
+    // the first position is due right away
+    QMetaObject::invokeMethod(this, &QGeoPositionInfoSourceSynthetic::tick, Qt::QueuedConnection);
+}
+
+void QGeoPositionInfoSourceSynthetic::stopUpdates()
+{
+    m_timer.stop();
+    m_clock.invalidate();
+}
+
+void QGeoPositionInfoSourceSynthetic::requestUpdate(int timeout)
+{
+    Q_UNUSED(timeout);
+    if (m_timer.isActive())
+        return;
+
+    QTimer::singleShot(0, this, [this]() {
+        const QGeoPositionInfo position = nextPosition();
+        if (position.isValid())
+            emit positionUpdated(position);
+        else
+            emit updateTimeout();
+    });
+}
+
+void QGeoPositionInfoSourceSynthetic::tick()
+{
+    if (!m_clock.isValid())
+        return;
+
+    const qreal positionRate = rate();
+    const qint64 target = qint64(m_clock.elapsed() * positionRate / 1000) + 1;
+    const qint64 catchUp = qMax<qint64>(1, qint64(positionRate * MaxCatchUpSeconds));
+    if (target - m_due > catchUp)
+        m_due = target - catchUp;
+
+    QList<QGeoPositionInfo> batch;
+    for (; m_due < target; ++m_due) {
+        const QGeoPositionInfo position = nextPosition();
+        if (!position.isValid()) {
+            // the end of a path that is not looped
+            stopUpdates();
+            emit updateTimeout();
+            break;
+        }
+        if (m_batch)
+            batch.append(position);
+        else
+            emit positionUpdated(position);
+        if (!m_clock.isValid())
+            return; // stopped by a receiver
+    }
+
+    QGeoPositionInfoSourcePrivate::get(*this)->deliverPositions(this, batch);
+}
+
+qreal QGeoPositionInfoSourceSynthetic::rate() const
+{
+    if (m_rate > 0)
+        return m_rate;
+    const int interval = updateInterval();
+    return 1000.0 / (interval > 0 ? interval : 1000);
+}
+
+QGeoPositionInfo QGeoPositionInfoSourceSynthetic::nextPosition()
+{
+    const qreal positionRate = rate();
+    const double seconds = 1 / positionRate;
+    if (!m_path.isEmpty()) {
+        if (!m_loop && m_distance >= m_lengths.last() && m_generated > 0)
+            return QGeoPositionInfo();
+        if (m_generated > 0)
+            moveAlongPath(m_speed * seconds);
+    } else if (m_generated > 0) {
+        walk(m_speed * seconds, seconds);
+    }
+
+    if (!m_startTime.isValid())
+        m_startTime = QDateTime::currentDateTimeUtc();
+    const QDateTime timestamp = m_startTime.addMSecs(qRound64(m_generated * 1000 / positionRate));
+    ++m_generated;
+
+    // an error of about the accuracy in a random direction
+    QGeoCoordinate coordinate = m_coordinate;
+    if (m_accuracy > 0) {
+        const double error = (m_random.generateDouble() + m_random.generateDouble()
+                              + m_random.generateDouble() - 1.5) * m_accuracy;
+        coordinate = coordinate.atDistanceAndAzimuth(qAbs(error),
+                                                     m_random.generateDouble() * 360.0);
+        coordinate.setAltitude(m_coordinate.altitude());
+    }
+
+    QGeoPositionInfo position(coordinate, timestamp);
+    position.setAttribute(QGeoPositionInfo::GroundSpeed, m_speed);
+    position.setAttribute(QGeoPositionInfo::Direction, m_heading);
+    position.setAttribute(QGeoPositionInfo::HorizontalAccuracy, m_accuracy);
+    m_lastPosition = position;
+    return position;
+}
+
+void QGeoPositionInfoSourceSynthetic::moveAlongPath(double distance)
+{
+    const double length = m_lengths.last();
+    m_distance += distance;
+    if (m_loop && length > 0)
+        m_distance = std::fmod(m_distance, length);
+    m_distance = qBound(0.0, m_distance, length);
+
+    // the segment from m_path[i] to m_path[i + 1] containing m_distance
+    const auto next = std::upper_bound(m_lengths.constBegin(), m_lengths.constEnd(), m_distance);
+    const int i = qBound(0, int(next - m_lengths.constBegin()) - 1, m_path.size() - 2);
+    const QGeoCoordinate &from = m_path.at(i);
+    const QGeoCoordinate &to = m_path.at(i + 1);
+    m_heading = from.azimuthTo(to);
+    m_coordinate = from.atDistanceAndAzimuth(m_distance - m_lengths.at(i), m_heading);
+    const double segment = m_lengths.at(i + 1) - m_lengths.at(i);
+    if (segment > 0 && from.type() == QGeoCoordinate::Coordinate3D
+            && to.type() == QGeoCoordinate::Coordinate3D) {
+        const double fraction = (m_distance - m_lengths.at(i)) / segment;
+        m_coordinate.setAltitude(from.altitude() + fraction * (to.altitude() - from.altitude()));
+    }
+}
+
+void QGeoPositionInfoSourceSynthetic::walk(double distance, double seconds)
+{
+    const double turn = m_turnRate * seconds;
+    m_heading = std::fmod(m_heading + (m_random.generateDouble() * 2 - 1) * turn + 360.0, 360.0);
+    m_coordinate = m_coordinate.atDistanceAndAzimuth(distance, m_heading);
+}
+
+QT_END_NAMESPACE
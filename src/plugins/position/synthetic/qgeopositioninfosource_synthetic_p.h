@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOPOSITIONINFOSOURCE_SYNTHETIC_P_H
+#define QGEOPOSITIONINFOSOURCE_SYNTHETIC_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/qgeopositioninfosource.h>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Generates positions along a path or on a random walk, at rates up to
+    several thousand per second, for testing and benchmarking consumers of
+    position updates. Timer ticks emit all the positions that became due
+    since the previous tick. The positions only depend on the parameters, so
+    a run can be repeated; their timestamps are spaced exactly by the rate.
+*/
+class QGeoPositionInfoSourceSynthetic : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+public:
+    QGeoPositionInfoSourceSynthetic(const QVariantMap &parameters, QObject *parent = nullptr);
+    ~QGeoPositionInfoSourceSynthetic();
+
+    static bool hasParameters(const QVariantMap &parameters);
+
+    void setUpdateInterval(int msec) override;
+    QGeoPositionInfo lastKnownPosition(bool fromSatellitePositioningMethodsOnly = false) const override;
+    PositioningMethods supportedPositioningMethods() const override;
+    int minimumUpdateInterval() const override;
+    Error error() const override;
+
+public Q_SLOTS:
+    void startUpdates() override;
+    void stopUpdates() override;
+    void requestUpdate(int timeout = 0) override;
+
+private:
+    void tick();
+    QGeoPositionInfo nextPosition();
+    void moveAlongPath(double distance);
+    void walk(double distance, double seconds);
+    qreal rate() const;
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QRandomGenerator m_random;
+    QDateTime m_startTime;
+    qint64 m_due = 0;       // positions generated since startUpdates()
+    qint64 m_generated = 0; // positions generated since the source was created
+
+    qreal m_rate = 0;       // positions per second, 0 to follow updateInterval
+    qreal m_speed = 10;
+    qreal m_accuracy = 5;
+    qreal m_turnRate = 30;
+    bool m_loop = true;
+    bool m_batch = false;
+
+    QVector<QGeoCoordinate> m_path;
+    QVector<double> m_lengths; // cumulative, m_lengths[i] is the distance to m_path[i]
+    double m_distance = 0;     // along the path
+    QGeoCoordinate m_coordinate;
+    double m_heading = 0;
+
+    QGeoPositionInfo m_lastPosition;
+    Error m_error = NoError;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOPOSITIONINFOSOURCE_SYNTHETIC_P_H
@@ -0,0 +1,18 @@
+TARGET = qtposition_synthetic
+
+QT = core positioning positioning-private
+
+HEADERS += \
+    qgeopositioninfosource_synthetic_p.h \
+    qgeopositioninfosourcefactory_synthetic.h
+
+SOURCES += \
+    qgeopositioninfosource_synthetic.cpp \
+    qgeopositioninfosourcefactory_synthetic.cpp
+
+OTHER_FILES += \
+    plugin.json
+
+PLUGIN_TYPE = position
+PLUGIN_CLASS_NAME = QGeoPositionInfoSourceFactorySynthetic
+load(qt_plugin)
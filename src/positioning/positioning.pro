@@ -59,8 +59,18 @@ PRIVATE_HEADERS += \
                     qdoublematrix4x4_p.h \
                     qgeopath_p.h \
                     qgeopolygon_p.h \
+                    qgeopackedcoordinate_p.h \
+                    qgeocoordinatekernels_p.h \
+                    qgeosegmentindex_p.h \
+                    qgeoshapeencoding_p.h \
+                    qgeoareamonitorreplay_p.h \
+                    qgeoareamonitorregions_p.h \
+                    qgeopositionhistory_p.h \
+                    qgeostreamsimplifier_p.h \
+                    qgeodeadreckoningsource_p.h \
                     qgeocoordinateobject_p.h \
                     qgeopositioninfo_p.h \
+                    qgeoattributearray_p.h \
                     qgeosatelliteinfo_p.h \
                     qgeosatelliteinfosource_p.h \
                     qclipperutils_p.h
@@ -69,12 +79,20 @@ SOURCES += \
             qgeoaddress.cpp \
             qgeoareamonitorsource.cpp \
             qgeoareamonitorinfo.cpp \
+            qgeoareamonitorreplay.cpp \
+            qgeoareamonitorregions.cpp \
+            qgeodeadreckoningsource.cpp \
             qgeoshape.cpp \
+            qgeoshapeencoding.cpp \
             qgeorectangle.cpp \
             qgeocircle.cpp \
             qgeocoordinate.cpp \
+            qgeocoordinatekernels.cpp \
+            qgeosegmentindex.cpp \
             qgeolocation.cpp \
             qgeopositioninfo.cpp \
+            qgeopositionhistory.cpp \
+            qgeostreamsimplifier.cpp \
             qgeopositioninfosource.cpp \
             qgeosatelliteinfo.cpp \
             qgeosatelliteinfosource.cpp \
@@ -93,6 +111,9 @@ SOURCES += \
 
 HEADERS += $$PUBLIC_HEADERS $$PRIVATE_HEADERS
 
+TRACEPOINT_PROVIDER = $$PWD/qtpositioning.tracepoints
+CONFIG += qt_tracepoints
+
 load(qt_module)
 
 LIBS_PRIVATE += -L$$MODULE_BASE_OUTDIR/lib -lqt_clip2tri$$qtPlatformTargetSuffix()
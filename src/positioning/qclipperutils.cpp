@@ -39,6 +39,8 @@
 
 #include "qclipperutils_p.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 static const double kClipperScaleFactor = 281474976710656.0;  // 48 bits of precision
@@ -97,4 +99,114 @@ Paths QClipperUtils::qListToPaths(const QList<QList<QDoubleVector2D> > &lists)
     return res;
 }
 
+int QClipperPathIndex::bandOf(cInt y) const
+{
+    // monotonic in y, so an edge spanning [y0, y1] is stored in every band a point on it can map to
+    const double span = double(m_maxY - m_minY) + 1.0;
+    const int band = int(double(y - m_minY) * m_bands / span);
+    return qBound(0, band, m_bands - 1);
+}
+
+void QClipperPathIndex::build(const Path &path)
+{
+    clear();
+    const int count = int(path.size());
+    if (count < 3)
+        return;
+
+    m_minY = m_maxY = path[0].Y;
+    for (const IntPoint &ip : path) {
+        m_minY = qMin(m_minY, ip.Y);
+        m_maxY = qMax(m_maxY, ip.Y);
+    }
+
+    // Edges spanning many bands are duplicated in each of them. Halve the
+    // band count until the duplication stays reasonable, which only matters
+    // for shapes like combs with many tall edges.
+    m_bands = qBound(1, count / 4, 4096);
+    m_bandStart.assign(size_t(m_bands) + 1, 0);
+    for (;;) {
+        std::fill(m_bandStart.begin(), m_bandStart.end(), 0);
+        qint64 total = 0;
+        for (int i = 0; i < count; ++i) {
+            const IntPoint &a = path[size_t(i)];
+            const IntPoint &b = path[size_t((i + 1) % count)];
+            const int first = bandOf(qMin(a.Y, b.Y));
+            const int last = bandOf(qMax(a.Y, b.Y));
+            for (int band = first; band <= last; ++band)
+                ++m_bandStart[size_t(band) + 1];
+            total += last - first + 1;
+        }
+        if (m_bands == 1 || total <= qint64(count) * 16)
+            break;
+        m_bands /= 2;
+        m_bandStart.resize(size_t(m_bands) + 1);
+    }
+
+    for (int band = 0; band < m_bands; ++band)
+        m_bandStart[size_t(band) + 1] += m_bandStart[size_t(band)];
+    m_bandEdges.resize(size_t(m_bandStart.back()));
+    std::vector<int> fill(m_bandStart.begin(), m_bandStart.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        const IntPoint &a = path[size_t(i)];
+        const IntPoint &b = path[size_t((i + 1) % count)];
+        const int last = bandOf(qMax(a.Y, b.Y));
+        for (int band = bandOf(qMin(a.Y, b.Y)); band <= last; ++band)
+            m_bandEdges[size_t(fill[size_t(band)]++)] = i;
+    }
+}
+
+void QClipperPathIndex::clear()
+{
+    m_bands = 0;
+    m_bandStart.clear();
+    m_bandEdges.clear();
+}
+
+int QClipperPathIndex::pointInPolygon(const IntPoint &pt, const Path &path) const
+{
+    if (isEmpty())
+        return c2t::clip2tri::pointInPolygon(pt, path);
+    if (pt.Y < m_minY || pt.Y > m_maxY)
+        return 0;
+
+    // Same per edge tests as ClipperLib::PointInPolygon(), restricted to the
+    // edges of one band. Every edge that can change the result spans pt.Y.
+    const size_t count = path.size();
+    const int band = bandOf(pt.Y);
+    int result = 0;
+    for (int e = m_bandStart[size_t(band)]; e < m_bandStart[size_t(band) + 1]; ++e) {
+        const size_t i = size_t(m_bandEdges[size_t(e)]);
+        const IntPoint &ip = path[i];
+        const IntPoint &ipNext = path[(i + 1) % count];
+        if (ipNext.Y == pt.Y) {
+            if ((ipNext.X == pt.X) || (ip.Y == pt.Y
+                    && ((ipNext.X > pt.X) == (ip.X < pt.X))))
+                return -1;
+        }
+        if ((ip.Y < pt.Y) != (ipNext.Y < pt.Y)) {
+            if (ip.X >= pt.X) {
+                if (ipNext.X > pt.X) {
+                    result = 1 - result;
+                } else {
+                    const double d = double(ip.X - pt.X) * (ipNext.Y - pt.Y)
+                            - double(ipNext.X - pt.X) * (ip.Y - pt.Y);
+                    if (!d)
+                        return -1;
+                    if ((d > 0) == (ipNext.Y > ip.Y))
+                        result = 1 - result;
+                }
+            } else if (ipNext.X > pt.X) {
+                const double d = double(ip.X - pt.X) * (ipNext.Y - pt.Y)
+                        - double(ipNext.X - pt.X) * (ip.Y - pt.Y);
+                if (!d)
+                    return -1;
+                if ((d > 0) == (ipNext.Y > ip.Y))
+                    result = 1 - result;
+            }
+        }
+    }
+    return result;
+}
+
 QT_END_NAMESPACE
@@ -81,6 +81,37 @@ public:
     static Paths qListToPaths(const QList<QList<QDoubleVector2D> > &lists);
 };
 
+/*
+    Edge index over a closed Clipper path for repeated point in polygon
+    queries. The y range of the path is split into bands, each listing the
+    edges crossing it, so a query only visits the edges of one band instead
+    of the whole ring. Results are the same as c2t::clip2tri::pointInPolygon().
+    The index refers to the path by position and has to be rebuilt whenever
+    the path changes.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QClipperPathIndex
+{
+public:
+    // below this many vertices a linear scan is as fast as the lookup
+    enum { MinimumIndexedSize = 32 };
+
+    void build(const Path &path);
+    void clear();
+    bool isEmpty() const { return m_bands == 0; }
+
+    // 0 if outside, 1 if inside, -1 if on the boundary
+    int pointInPolygon(const IntPoint &pt, const Path &path) const;
+
+private:
+    int bandOf(cInt y) const;
+
+    cInt m_minY = 0;
+    cInt m_maxY = 0;
+    int m_bands = 0;
+    std::vector<int> m_bandStart;   // m_bands + 1 offsets into m_bandEdges
+    std::vector<int> m_bandEdges;   // index of the first vertex of each edge
+};
+
 QT_END_NAMESPACE
 
 #endif // QCLIPPERUTILS_P_H
@@ -41,7 +41,9 @@
 #include <QtCore/qmath.h>
 //#include <QtCore/qvariant.h>
 #include <QtCore/qdatastream.h>
+#include <QtCore/private/qsimd_p.h>
 #include <cmath>
+#include <cstring>
 
 QT_BEGIN_NAMESPACE
 
@@ -967,6 +969,77 @@ QRectF QDoubleMatrix4x4::mapRect(const QRectF& rect) const
     return QRectF(QPointF(xmin, ymin), QPointF(xmax, ymax));
 }
 
+/*
+    Maps count points given as consecutive x and y pairs in points, with z = 0,
+    and writes the x and y of the results to out, which may be the same array.
+    The results are those of map(QDoubleVector3D(x, y, 0)), computed several
+    points at a time where the processor supports it.
+*/
+void QDoubleMatrix4x4::map(const double *points, double *out, int count) const
+{
+    if (flagBits == Identity) {
+        if (out != points)
+            std::memmove(out, points, sizeof(double) * 2 * size_t(count));
+        return;
+    }
+
+    // Translation | Scale | Rotation2D leaves w at 1
+    const bool affine = flagBits < Rotation;
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128d m00 = _mm_set1_pd(m[0][0]), m10 = _mm_set1_pd(m[1][0]), m30 = _mm_set1_pd(m[3][0]);
+    const __m128d m01 = _mm_set1_pd(m[0][1]), m11 = _mm_set1_pd(m[1][1]), m31 = _mm_set1_pd(m[3][1]);
+    const __m128d m03 = _mm_set1_pd(m[0][3]), m13 = _mm_set1_pd(m[1][3]), m33 = _mm_set1_pd(m[3][3]);
+    for (; i + 2 <= count; i += 2) {
+        const __m128d p0 = _mm_loadu_pd(points + 2 * i);
+        const __m128d p1 = _mm_loadu_pd(points + 2 * i + 2);
+        const __m128d x = _mm_unpacklo_pd(p0, p1);
+        const __m128d y = _mm_unpackhi_pd(p0, p1);
+        __m128d rx = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, m00), _mm_mul_pd(y, m10)), m30);
+        __m128d ry = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, m01), _mm_mul_pd(y, m11)), m31);
+        if (!affine) {
+            const __m128d w = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, m03), _mm_mul_pd(y, m13)), m33);
+            rx = _mm_div_pd(rx, w);
+            ry = _mm_div_pd(ry, w);
+        }
+        _mm_storeu_pd(out + 2 * i, _mm_unpacklo_pd(rx, ry));
+        _mm_storeu_pd(out + 2 * i + 2, _mm_unpackhi_pd(rx, ry));
+    }
+#elif defined(__ARM_NEON) && defined(Q_PROCESSOR_ARM_64)
+    for (; i + 2 <= count; i += 2) {
+        const float64x2x2_t p = vld2q_f64(points + 2 * i);
+        float64x2x2_t r;
+        r.val[0] = vaddq_f64(vaddq_f64(vmulq_n_f64(p.val[0], m[0][0]), vmulq_n_f64(p.val[1], m[1][0])),
+                             vdupq_n_f64(m[3][0]));
+        r.val[1] = vaddq_f64(vaddq_f64(vmulq_n_f64(p.val[0], m[0][1]), vmulq_n_f64(p.val[1], m[1][1])),
+                             vdupq_n_f64(m[3][1]));
+        if (!affine) {
+            const float64x2_t w = vaddq_f64(vaddq_f64(vmulq_n_f64(p.val[0], m[0][3]),
+                                                      vmulq_n_f64(p.val[1], m[1][3])),
+                                            vdupq_n_f64(m[3][3]));
+            r.val[0] = vdivq_f64(r.val[0], w);
+            r.val[1] = vdivq_f64(r.val[1], w);
+        }
+        vst2q_f64(out + 2 * i, r);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const double x = points[2 * i];
+        const double y = points[2 * i + 1];
+        double rx = x * m[0][0] + y * m[1][0] + m[3][0];
+        double ry = x * m[0][1] + y * m[1][1] + m[3][1];
+        if (!affine) {
+            const double w = x * m[0][3] + y * m[1][3] + m[3][3];
+            rx /= w;
+            ry /= w;
+        }
+        out[2 * i] = rx;
+        out[2 * i + 1] = ry;
+    }
+}
+
 QDoubleMatrix4x4 QDoubleMatrix4x4::orthonormalInverse() const
 {
     QDoubleMatrix4x4 result(1);  // The '1' says not to load identity
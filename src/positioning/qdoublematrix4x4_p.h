@@ -149,6 +149,7 @@ public:
 
     QDoubleVector3D map(const QDoubleVector3D& point) const;
     QDoubleVector3D mapVector(const QDoubleVector3D& vector) const;
+    void map(const double *points, double *out, int count) const;
 
     QRect mapRect(const QRect& rect) const;
     QRectF mapRect(const QRectF& rect) const;
@@ -40,7 +40,9 @@
 #include "qgeoaddress.h"
 #include "qgeoaddress_p.h"
 
-#include <QtCore/QStringList>
+#include <QtCore/QMutex>
+
+#include <algorithm>
 
 #ifdef QGEOADDRESS_DEBUG
 #include <QDebug>
@@ -48,242 +50,401 @@
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+enum AddressField : quint8 {
+    Street,
+    District,
+    City,
+    DistrictOrCity,
+    State,
+    PostalCode,
+    Country,
+    EndOfFormat
+};
+
+enum AddressSeparator : quint8 {
+    Comma,
+    Space,
+    Dash,
+    NewLine
+};
+
 /*
-    Combines a  list of address parts into  a single line.
+    An element of an address followed by its separator. A format is a list of
+    them, with each line ending at the part separated by a NewLine, and the
+    list ending with EndOfFormat.
+*/
+struct AddressPart
+{
+    AddressField field;
+    AddressSeparator separator;
+};
 
-    The parts parameter contains both address elements such as city, state and so on
-    as well as separators such as spaces and commas.
+struct CountryFormat
+{
+    char countryCode[4];
+    const AddressPart *format;
+};
+
+const AddressPart defaultFormat[] = {
+    {Street, NewLine},
+    {PostalCode, Space}, {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart postalCommaCityFormat[] = {
+    {Street, NewLine},
+    {PostalCode, Comma}, {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart districtCityFormat[] = {
+    {Street, NewLine},
+    {District, Space}, {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart ausFormat[] = {
+    {Street, NewLine},
+    {DistrictOrCity, Space}, {State, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart bhrFormat[] = {
+    {Street, NewLine},
+    {District, Comma}, {City, Comma}, {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart braFormat[] = {
+    {Street, NewLine},
+    {District, Space}, {City, Dash}, {State, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart districtCityPostalFormat[] = {
+    {Street, NewLine},
+    {District, Space}, {City, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart northAmericaFormat[] = {
+    {Street, NewLine},
+    {City, Comma}, {State, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart chnFormat[] = {
+    {Street, Comma}, {City, NewLine},
+    {PostalCode, Space}, {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart chlFormat[] = {
+    {Street, NewLine},
+    {PostalCode, Space}, {District, Comma}, {City, Comma}, {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart cymFormat[] = {
+    {Street, NewLine},
+    {State, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart gbrFormat[] = {
+    {Street, NewLine},
+    {District, Comma}, {City, Comma}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart gibFormat[] = {
+    {Street, NewLine},
+    {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart hkgFormat[] = {
+    {Street, NewLine},
+    {District, NewLine},
+    {City, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart indFormat[] = {
+    {Street, NewLine},
+    {City, Space}, {PostalCode, Space}, {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart cityCommaPostalFormat[] = {
+    {Street, NewLine},
+    {City, Comma}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart irlFormat[] = {
+    {Street, NewLine},
+    {District, Comma}, {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart kwtFormat[] = {
+    {Street, NewLine},
+    {PostalCode, Comma}, {District, Comma}, {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart cityPostalFormat[] = {
+    {Street, NewLine},
+    {City, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart mexFormat[] = {
+    {Street, NewLine},
+    {District, NewLine},
+    {PostalCode, Space}, {City, Comma}, {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart mysFormat[] = {
+    {Street, NewLine},
+    {PostalCode, Space}, {City, NewLine},
+    {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart omnFormat[] = {
+    {Street, NewLine},
+    {District, Comma}, {PostalCode, Comma}, {City, Comma}, {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart priFormat[] = {
+    {Street, NewLine},
+    {District, Comma}, {City, Comma}, {State, Comma}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart qatFormat[] = {
+    {Street, NewLine},
+    {District, Space}, {City, Comma}, {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart sauFormat[] = {
+    {Street, Space}, {District, NewLine},
+    {City, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart twnFormat[] = {
+    {Street, Comma}, {District, Comma}, {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart thaFormat[] = {
+    {Street, NewLine},
+    {District, Comma}, {City, Space}, {PostalCode, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart turFormat[] = {
+    {Street, NewLine},
+    {PostalCode, Space}, {District, Comma}, {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart venFormat[] = {
+    {Street, NewLine},
+    {City, Space}, {PostalCode, Comma}, {State, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+const AddressPart zafFormat[] = {
+    {Street, NewLine},
+    {District, Comma}, {City, NewLine},
+    {Country, NewLine},
+    {EndOfFormat, NewLine}
+};
+
+// Sorted by country code. The countries not listed, like AND, AUT, FRA, GLP,
+// GUF, ITA, LUX, MCO, REU, RUS, SMR and VAT, use the default format.
+const CountryFormat countryFormats[] = {
+    {"ALB", postalCommaCityFormat},
+    {"ARE", districtCityFormat},
+    {"AUS", ausFormat},
+    {"BHR", bhrFormat},
+    {"BHS", districtCityFormat},
+    {"BRA", braFormat},
+    {"BRN", districtCityPostalFormat},
+    {"CAN", northAmericaFormat},
+    {"CHL", chlFormat},
+    {"CHN", chnFormat},
+    {"CYM", cymFormat},
+    {"GBR", gbrFormat},
+    {"GIB", gibFormat},
+    {"HKG", hkgFormat},
+    {"IDN", cityCommaPostalFormat},
+    {"IND", indFormat},
+    {"IRL", irlFormat},
+    {"JEY", cityCommaPostalFormat},
+    {"JOR", districtCityPostalFormat},
+    {"KWT", kwtFormat},
+    {"LBN", districtCityPostalFormat},
+    {"LVA", cityCommaPostalFormat},
+    {"MEX", mexFormat},
+    {"MLT", cityPostalFormat},
+    {"MTQ", postalCommaCityFormat},
+    {"MYS", mysFormat},
+    {"NZL", districtCityPostalFormat},
+    {"OMN", omnFormat},
+    {"PRI", priFormat},
+    {"QAT", qatFormat},
+    {"SAU", sauFormat},
+    {"SGP", cityPostalFormat},
+    {"THA", thaFormat},
+    {"TUR", turFormat},
+    {"TWN", twnFormat},
+    {"UKR", cityPostalFormat},
+    {"USA", northAmericaFormat},
+    {"VEN", venFormat},
+    {"VIR", northAmericaFormat},
+    {"ZAF", zafFormat}
+};
+
+const AddressPart *addressFormat(const QString &countryCode)
+{
+    const CountryFormat *end = countryFormats + sizeof(countryFormats) / sizeof(countryFormats[0]);
+    const CountryFormat *it = std::lower_bound(countryFormats, end, countryCode,
+                                               [](const CountryFormat &format, const QString &code) {
+        return QLatin1String(format.countryCode) < code;
+    });
+    if (it != end && QLatin1String(it->countryCode) == countryCode)
+        return it->format;
+    return defaultFormat;
+}
 
-    It is expected that an element is always followed by a separator and the last
-    sepator is usually a new line delimeter.
+const QString &addressField(const QGeoAddressPrivate &address, AddressField field)
+{
+    switch (field) {
+    case Street:
+        return address.sStreet;
+    case District:
+        return address.sDistrict;
+    case City:
+        return address.sCity;
+    case DistrictOrCity:
+        return address.sDistrict.isEmpty() ? address.sCity : address.sDistrict;
+    case State:
+        return address.sState;
+    case PostalCode:
+        return address.sPostalCode;
+    case Country:
+    case EndOfFormat:
+        break;
+    }
+    return address.sCountry;
+}
+
+/*
+    Appends to text the line of the address made of the parts from first up to
+    and including last, which is the one separated by a new line.
 
+    The separator following an element is left out when the element is
+    empty, and so is the separator before an empty last element.
     For example: Springfield, 8900
-    would have four parts
-    ["Springfield", ", ", "8900", "<br>"]
-
-    The addressLine takes care of putting in separators appropriately or leaving
-    them out depending on whether the adjacent elements are present or not.
-    For example if city were empty in the above scenario the returned string is "8900<br>"
-    If the postal code was empty, returned string is "Springfield<br>"
-    If both city and postal code were empty, the returned string is "".
-*/
-static QString addressLine(const QStringList &parts)
-{
-    QString line;
-    Q_ASSERT(parts.count() % 2 == 0);
-
-    //iterate until just before the last pair
-    QString penultimateSeparator;
-    for (int i = 0; i < parts.count() - 2; i += 2) {
-        if (!parts.at(i).isEmpty()) {
-            line.append(parts.at(i) + parts.at(i + 1));
-            penultimateSeparator = parts.at(i + 1);
+    are the parts {City, Comma}, {PostalCode, NewLine}.
+    If city were empty the line is "8900<br/>".
+    If the postal code was empty, the line is "Springfield<br/>".
+    If both city and postal code were empty, nothing is appended.
+*/
+void appendAddressLine(QString &text, const QGeoAddressPrivate &address,
+                       const AddressPart *first, const AddressPart *last)
+{
+    static const QLatin1String separators[] = {
+        QLatin1String(", "), QLatin1String(" "), QLatin1String("-"), QLatin1String("<br/>")
+    };
+
+    const int lineStart = text.length();
+    int penultimateSeparator = 0;
+    for (const AddressPart *part = first; part != last; ++part) {
+        const QString &value = addressField(address, part->field);
+        if (!value.isEmpty()) {
+            text += value;
+            text += separators[part->separator];
+            penultimateSeparator = separators[part->separator].size();
         }
     }
 
-    if (parts.at(parts.count() - 2).isEmpty()) {
-        line.chop(penultimateSeparator.length());
-
-        if (!line.isEmpty())
-            line.append(parts.at(parts.count() - 1));
+    const QString &value = addressField(address, last->field);
+    if (value.isEmpty()) {
+        text.chop(penultimateSeparator);
+        if (text.length() > lineStart)
+            text += separators[NewLine];
     } else {
-        line.append(parts.at(parts.count() - 2));
-        line.append(parts.at(parts.count() - 1));
+        text += value;
+        text += separators[NewLine];
     }
-
-    return line;
 }
 
+} // namespace
+
 /*
     Returns a single formatted string representing the \a address. Lines of the address
-    are delimited by \a newLine. By default lines are delimited by <br/>. The \l
-    {QGeoAddress::countryCode} {countryCode} of the \a address determines the format of
-    the resultant string.
+    are delimited by <br/>. The \l {QGeoAddress::countryCode} {countryCode} of the
+    \a address determines the format of the resultant string.
 */
-static QString formattedAddress(const QGeoAddress &address,
-                                const QString &newLine = QLatin1String("<br/>"))
+static QString formattedAddress(const QGeoAddressPrivate &address)
 {
-    const QString Comma(QStringLiteral(", "));
-    const QString Dash(QStringLiteral("-"));
-    const QString Space(QStringLiteral(" "));
-
     QString text;
-
-    if (address.countryCode() == QLatin1String("ALB")
-        || address.countryCode() == QLatin1String("MTQ")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Comma
-                                          << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("AND")
-               || address.countryCode() == QLatin1String("AUT")
-               || address.countryCode() == QLatin1String("FRA")
-               || address.countryCode() == QLatin1String("GLP")
-               || address.countryCode() == QLatin1String("GUF")
-               || address.countryCode() == QLatin1String("ITA")
-               || address.countryCode() == QLatin1String("LUX")
-               || address.countryCode() == QLatin1String("MCO")
-               || address.countryCode() == QLatin1String("REU")
-               || address.countryCode() == QLatin1String("RUS")
-               || address.countryCode() == QLatin1String("SMR")
-               || address.countryCode() == QLatin1String("VAT")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Space
-                                          << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("ARE")
-               || address.countryCode() == QLatin1String("BHS")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Space
-                                          << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("AUS")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << (address.district().isEmpty() ? address.city() : address.district())
-                                << Space << address.state() << Space << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("BHR")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Comma
-                                << address.city() << Comma << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("BRA")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Space
-                    << address.city() << Dash << address.state() << Space << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("BRN")
-               || address.countryCode() == QLatin1String("JOR")
-               || address.countryCode() == QLatin1String("LBN")
-               || address.countryCode() == QLatin1String("NZL")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Space
-                                << address.city() << Space << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("CAN")
-               || address.countryCode() == QLatin1String("USA")
-               || address.countryCode() == QLatin1String("VIR")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.city() << Comma << address.state() << Space
-                                              << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("CHN")) {
-        text += addressLine(QStringList() << address.street() << Comma << address.city() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Space << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("CHL")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Space
-                                << address.district() << Comma << address.city() << Comma
-                                << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("CYM")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.state() << Space
-                                << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("GBR")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Comma
-                                << address.city() << Comma << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("GIB")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("HKG")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << newLine);
-        text += addressLine(QStringList() << address.city() << newLine);
-    } else if (address.countryCode() == QLatin1String("IND")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.city() << Space << address.postalCode() << Space
-                                              << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("IDN")
-               || address.countryCode() == QLatin1String("JEY")
-               || address.countryCode() == QLatin1String("LVA")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.city() << Comma << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("IRL")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Comma << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("KWT")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Comma
-                            << address.district() << Comma << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("MLT")
-               || address.countryCode() == QLatin1String("SGP")
-               || address.countryCode() == QLatin1String("UKR")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.city() << Space << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("MEX")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Space << address.city() << Comma
-                                              << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("MYS")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Space << address.city() << newLine);
-        text += addressLine(QStringList() << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("OMN")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Comma
-                                << address.postalCode() << Comma
-                                << address.city() << Comma
-                                << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("PRI")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Comma << address.city() << Comma
-                                                 << address.state() << Comma << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("QAT")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Space << address.city() << Comma
-                                              << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("SAU")) {
-        text += addressLine(QStringList() << address.street() << Space << address.district() << newLine);
-        text += addressLine(QStringList() << address.city() << Space << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("TWN")) {
-        text += addressLine(QStringList() << address.street() << Comma
-                                << address.district() << Comma << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("THA")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Comma << address.city() << Space
-                                              << address.postalCode() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("TUR")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Space << address.district() << Comma
-                                              << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("VEN")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.city() << Space << address.postalCode() << Comma
-                                              << address.state() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else if (address.countryCode() == QLatin1String("ZAF")) {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.district() << Comma << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
-    } else {
-        text += addressLine(QStringList() << address.street() << newLine);
-        text += addressLine(QStringList() << address.postalCode() << Space << address.city() << newLine);
-        text += addressLine(QStringList() << address.country() << newLine);
+    const AddressPart *part = addressFormat(address.sCountryCode);
+    while (part->field != EndOfFormat) {
+        const AddressPart *last = part;
+        while (last->separator != NewLine)
+            ++last;
+        appendAddressLine(text, address, part, last);
+        part = last + 1;
     }
 
-    text.chop(newLine.length());
+    text.chop(int(sizeof("<br/>")) - 1);
     return text;
 }
 
+/*
+    Guards filling the formatted text of addresses, which copies sharing the
+    private may do concurrently from different threads.
+*/
+static QBasicMutex formattedTextMutex;
+
 QGeoAddressPrivate::QGeoAddressPrivate()
         : QSharedData(),
           m_autoGeneratedText(false)
@@ -303,12 +464,41 @@ QGeoAddressPrivate::QGeoAddressPrivate(const QGeoAddressPrivate &other)
         sText(other.sText),
         m_autoGeneratedText(false)
 {
+    // Once valid the formatted text does not change, until the private is detached
+    if (other.m_formattedTextValid.loadAcquire()) {
+        m_formattedText = other.m_formattedText;
+        m_formattedTextValid.storeRelaxed(1);
+    }
 }
 
 QGeoAddressPrivate::~QGeoAddressPrivate()
 {
 }
 
+/*
+    Returns the address formatted from its elements, built on the first call
+    and kept until an element changes.
+*/
+QString QGeoAddressPrivate::formattedText() const
+{
+    if (m_formattedTextValid.loadAcquire())
+        return m_formattedText;
+
+    const QString text = formattedAddress(*this);
+    QMutexLocker locker(&formattedTextMutex);
+    if (!m_formattedTextValid.loadRelaxed()) {
+        m_formattedText = text;
+        m_formattedTextValid.storeRelease(1);
+    }
+    return text;
+}
+
+void QGeoAddressPrivate::invalidateFormattedText()
+{
+    m_formattedTextValid.storeRelaxed(0);
+    m_formattedText.clear();
+}
+
 /*!
     \class QGeoAddress
     \inmodule QtPositioning
@@ -431,7 +621,7 @@ bool QGeoAddress::operator==(const QGeoAddress &other) const
 QString QGeoAddress::text() const
 {
     if (d->sText.isEmpty())
-        return formattedAddress(*this);
+        return d->formattedText();
     else
         return d->sText;
 }
@@ -462,6 +652,7 @@ QString QGeoAddress::country() const
 void QGeoAddress::setCountry(const QString &country)
 {
     d->sCountry = country;
+    d->invalidateFormattedText();
 }
 
 /*!
@@ -478,6 +669,7 @@ QString QGeoAddress::countryCode() const
 void QGeoAddress::setCountryCode(const QString &countryCode)
 {
     d->sCountryCode = countryCode;
+    d->invalidateFormattedText();
 }
 
 /*!
@@ -494,6 +686,7 @@ QString QGeoAddress::state() const
 void QGeoAddress::setState(const QString &state)
 {
     d->sState = state;
+    d->invalidateFormattedText();
 }
 
 /*!
@@ -526,6 +719,7 @@ QString QGeoAddress::city() const
 void QGeoAddress::setCity(const QString &city)
 {
     d->sCity = city;
+    d->invalidateFormattedText();
 }
 
 /*!
@@ -542,6 +736,7 @@ QString QGeoAddress::district() const
 void QGeoAddress::setDistrict(const QString &district)
 {
     d->sDistrict = district;
+    d->invalidateFormattedText();
 }
 
 /*!
@@ -568,6 +763,7 @@ QString QGeoAddress::street() const
 void QGeoAddress::setStreet(const QString &street)
 {
     d->sStreet = street;
+    d->invalidateFormattedText();
 }
 
 /*!
@@ -584,6 +780,7 @@ QString QGeoAddress::postalCode() const
 void QGeoAddress::setPostalCode(const QString &postalCode)
 {
     d->sPostalCode = postalCode;
+    d->invalidateFormattedText();
 }
 
 /*!
@@ -618,6 +815,7 @@ void QGeoAddress::clear()
     d->sStreet.clear();
     d->sPostalCode.clear();
     d->sText.clear();
+    d->invalidateFormattedText();
 }
 
 /*!
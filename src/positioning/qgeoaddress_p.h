@@ -53,6 +53,7 @@
 
 #include <QString>
 #include <QSharedData>
+#include <QAtomicInt>
 
 QT_BEGIN_NAMESPACE
 
@@ -63,6 +64,9 @@ public:
     QGeoAddressPrivate(const QGeoAddressPrivate &other);
     ~QGeoAddressPrivate();
 
+    QString formattedText() const;
+    void invalidateFormattedText(); // when an element of the formatted text changes
+
     QString sCountry; //!< country field
     QString sCountryCode; //!< country code field
     QString sState; //!< state field
@@ -73,6 +77,10 @@ public:
     QString sPostalCode; //!< postal code field
     QString sText;
     bool m_autoGeneratedText;
+
+private:
+    mutable QString m_formattedText;
+    mutable QAtomicInt m_formattedTextValid;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,531 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoareamonitorregions_p.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMetaMethod>
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+static QMetaMethod areaEnteredSignal()
+{
+    static QMetaMethod signal = QMetaMethod::fromSignal(&QGeoAreaMonitorSource::areaEntered);
+    return signal;
+}
+
+static QMetaMethod areaExitedSignal()
+{
+    static QMetaMethod signal = QMetaMethod::fromSignal(&QGeoAreaMonitorSource::areaExited);
+    return signal;
+}
+
+static bool isAcceptable(const QGeoAreaMonitorInfo &monitor)
+{
+    if (!monitor.isValid())
+        return false;
+
+    //reject an expiry in the past
+    if (monitor.expiration().isValid() &&
+            (monitor.expiration() < QDateTime::currentDateTime()))
+        return false;
+
+    //don't accept persistent monitor since we don't support it
+    return !monitor.isPersistent();
+}
+
+namespace {
+
+struct Candidate
+{
+    double distance; // to the boundary, negative inside
+    QString identifier;
+};
+
+bool candidateLessThan(const Candidate &c1, const Candidate &c2)
+{
+    return c1.distance < c2.distance
+            || (c1.distance == c2.distance && c1.identifier < c2.identifier);
+}
+
+} // namespace
+
+QGeoAreaMonitorRegions::QGeoAreaMonitorRegions(int maximumRegions, double maximumRadius)
+    : m_maximumRegions(qMax(0, maximumRegions)), m_maximumRadius(maximumRadius)
+{
+}
+
+bool QGeoAreaMonitorRegions::insert(const QString &identifier, const QGeoShape &area)
+{
+    if (m_registered.contains(identifier))
+        m_replaced.insert(identifier);
+
+    if (area.type() != QGeoShape::CircleType || !area.isValid()) {
+        m_regions.remove(identifier);
+        return false;
+    }
+
+    const QGeoCircle circle(area);
+    if (circle.radius() > m_maximumRadius || m_maximumRegions == 0) {
+        m_regions.remove(identifier);
+        return false;
+    }
+
+    m_regions.insert(identifier, { circle.center(), circle.radius(), false });
+    return true;
+}
+
+bool QGeoAreaMonitorRegions::remove(const QString &identifier)
+{
+    m_regions.remove(identifier);
+    m_replaced.remove(identifier);
+    return m_registered.remove(identifier);
+}
+
+void QGeoAreaMonitorRegions::reject(const QString &identifier)
+{
+    auto it = m_regions.find(identifier);
+    if (it != m_regions.end())
+        it->rejected = true;
+    m_replaced.remove(identifier);
+    m_registered.remove(identifier);
+}
+
+void QGeoAreaMonitorRegions::clear()
+{
+    m_regions.clear();
+    m_registered.clear();
+    m_replaced.clear();
+    m_position = QGeoCoordinate();
+    m_margin = 0;
+}
+
+bool QGeoAreaMonitorRegions::needsUpdate(const QGeoCoordinate &position) const
+{
+    if (!position.isValid() || m_margin == std::numeric_limits<double>::infinity())
+        return false;
+    if (!m_position.isValid())
+        return true;
+    return m_position.distanceTo(position) > m_margin;
+}
+
+void QGeoAreaMonitorRegions::update(const QGeoCoordinate &position,
+                                    QStringList *added, QStringList *removed)
+{
+    QVector<Candidate> candidates;
+    candidates.reserve(m_regions.size());
+    for (auto it = m_regions.cbegin(); it != m_regions.cend(); ++it) {
+        if (it->rejected)
+            continue;
+        const double distance = position.isValid()
+                ? position.distanceTo(it->center) - it->radius : 0.0;
+        candidates.append({ distance, it.key() });
+    }
+
+    m_position = position;
+    m_margin = std::numeric_limits<double>::infinity();
+    if (candidates.size() > m_maximumRegions) {
+        const auto nth = candidates.begin() + m_maximumRegions;
+        std::nth_element(candidates.begin(), nth, candidates.end(), candidateLessThan);
+
+        // Every boundary gets closer or farther by at most the distance moved
+        m_margin = 0;
+        if (position.isValid()) {
+            double farthest = -std::numeric_limits<double>::infinity();
+            for (auto it = candidates.cbegin(); it != nth; ++it)
+                farthest = qMax(farthest, it->distance);
+            double nearest = std::numeric_limits<double>::infinity();
+            for (auto it = nth; it != candidates.cend(); ++it)
+                nearest = qMin(nearest, it->distance);
+            m_margin = qMax(0.0, (nearest - farthest) / 2);
+        }
+        candidates.resize(m_maximumRegions);
+    }
+
+    QSet<QString> selected;
+    selected.reserve(candidates.size());
+    for (const Candidate &candidate : qAsConst(candidates))
+        selected.insert(candidate.identifier);
+
+    for (const QString &identifier : qAsConst(m_registered)) {
+        if (!selected.contains(identifier) || m_replaced.contains(identifier))
+            removed->append(identifier);
+    }
+    for (const QString &identifier : qAsConst(selected)) {
+        if (!m_registered.contains(identifier) || m_replaced.contains(identifier))
+            added->append(identifier);
+    }
+
+    m_registered = selected;
+    m_replaced.clear();
+}
+
+QGeoAreaMonitorRegionSource::QGeoAreaMonitorRegionSource(QObject *parent)
+    : QGeoAreaMonitorSource(parent), m_regions(0, 0)
+{
+    m_expiryTimer.setSingleShot(true);
+    connect(&m_expiryTimer, &QTimer::timeout, this, &QGeoAreaMonitorRegionSource::expire);
+}
+
+QGeoAreaMonitorRegionSource::~QGeoAreaMonitorRegionSource()
+{
+}
+
+void QGeoAreaMonitorRegionSource::setRegionLimits(int maximumRegions, double maximumRadius)
+{
+    Q_ASSERT(m_monitors.isEmpty());
+    m_regions = QGeoAreaMonitorRegions(maximumRegions, maximumRadius);
+}
+
+void QGeoAreaMonitorRegionSource::setPositionInfoSource(QGeoPositionInfoSource *source)
+{
+    m_positionSource = source;
+    if (m_polling) {
+        m_polling->setPositionInfoSource(source);
+        connectPositionSource();
+    }
+}
+
+QGeoPositionInfoSource *QGeoAreaMonitorRegionSource::positionInfoSource() const
+{
+    return m_polling ? m_polling->positionInfoSource() : m_positionSource.data();
+}
+
+QGeoAreaMonitorSource::Error QGeoAreaMonitorRegionSource::error() const
+{
+    return m_error;
+}
+
+void QGeoAreaMonitorRegionSource::setError(QGeoAreaMonitorSource::Error error)
+{
+    m_error = error;
+    emit QGeoAreaMonitorSource::error(error);
+}
+
+QGeoAreaMonitorSource::AreaMonitorFeatures QGeoAreaMonitorRegionSource::supportedAreaMonitorFeatures() const
+{
+    return {};
+}
+
+bool QGeoAreaMonitorRegionSource::startMonitoring(const QGeoAreaMonitorInfo &monitor)
+{
+    if (!isAcceptable(monitor))
+        return false;
+
+    return insertMonitor(monitor, -1);
+}
+
+bool QGeoAreaMonitorRegionSource::requestUpdate(const QGeoAreaMonitorInfo &monitor, const char *signal)
+{
+    if (!isAcceptable(monitor) || !signal)
+        return false;
+
+    const QByteArray sig = QMetaObject::normalizedSignature(signal + 1);
+    const int signalIndex = metaObject()->indexOfSignal(sig.constData());
+
+    //only accept area entered or exit signal
+    if (signalIndex != areaEnteredSignal().methodIndex() &&
+        signalIndex != areaExitedSignal().methodIndex())
+        return false;
+
+    return insertMonitor(monitor, signalIndex);
+}
+
+bool QGeoAreaMonitorRegionSource::stopMonitoring(const QGeoAreaMonitorInfo &monitor)
+{
+    if (!m_monitors.contains(monitor.identifier()))
+        return false;
+
+    removeMonitor(monitor.identifier());
+    updateRegions(lastKnownPosition().coordinate());
+    startExpiryTimer();
+    return true;
+}
+
+QList<QGeoAreaMonitorInfo> QGeoAreaMonitorRegionSource::activeMonitors() const
+{
+    QList<QGeoAreaMonitorInfo> results;
+    for (const Monitor &monitor : m_monitors)
+        results.append(monitor.info);
+    return results;
+}
+
+QList<QGeoAreaMonitorInfo> QGeoAreaMonitorRegionSource::activeMonitors(const QGeoShape &lookupArea) const
+{
+    QList<QGeoAreaMonitorInfo> results;
+    if (lookupArea.isEmpty())
+        return results;
+
+    for (const Monitor &monitor : m_monitors) {
+        if (lookupArea.contains(monitor.info.area().center()))
+            results.append(monitor.info);
+    }
+    return results;
+}
+
+void QGeoAreaMonitorRegionSource::regionEvent(const QString &identifier,
+                                              const QGeoPositionInfo &update, bool entered)
+{
+    if (!m_regions.isRegistered(identifier))
+        return;
+
+    processEvent(identifier, update, entered);
+
+    // The platform woke the application up, the position is a recent one
+    if (m_regions.needsUpdate(update.coordinate()))
+        updateRegions(update.coordinate());
+}
+
+void QGeoAreaMonitorRegionSource::regionFailed(const QString &identifier)
+{
+    if (!m_regions.isRegistered(identifier))
+        return;
+
+    // Over the limit of the platform, or not monitorable there
+    stopRegion(identifier);
+    m_regions.reject(identifier);
+    if (!startPolling(identifier))
+        removeMonitor(identifier);
+    updateRegions(lastKnownPosition().coordinate());
+}
+
+void QGeoAreaMonitorRegionSource::stopRegions()
+{
+    const QStringList registered = m_regions.registered();
+    for (const QString &identifier : registered)
+        stopRegion(identifier);
+    m_regions.clear();
+}
+
+bool QGeoAreaMonitorRegionSource::insertMonitor(const QGeoAreaMonitorInfo &monitor, int signalIndex)
+{
+    if (!enableRegions()) {
+        setError(QGeoAreaMonitorSource::AccessError);
+        return false;
+    }
+
+    const QString identifier = monitor.identifier();
+    m_monitors.insert(identifier, { monitor, signalIndex });
+    m_regions.insert(identifier, monitor.area());
+    updateRegions(lastKnownPosition().coordinate());
+
+    if (!m_regions.isRegistered(identifier) && !startPolling(identifier)) {
+        removeMonitor(identifier);
+        updateRegions(lastKnownPosition().coordinate());
+        return false;
+    }
+
+    startExpiryTimer();
+    return true;
+}
+
+void QGeoAreaMonitorRegionSource::removeMonitor(const QString &identifier)
+{
+    if (m_regions.remove(identifier))
+        stopRegion(identifier);
+    stopPolling(identifier);
+    m_monitors.remove(identifier);
+}
+
+void QGeoAreaMonitorRegionSource::processEvent(const QString &identifier,
+                                               const QGeoPositionInfo &update, bool entered)
+{
+    const auto it = m_monitors.constFind(identifier);
+    if (it == m_monitors.constEnd())
+        return;
+
+    const QGeoAreaMonitorInfo info = it->info;
+    if (it->signalIndex >= 0) {
+        const QMetaMethod signal = entered ? areaEnteredSignal() : areaExitedSignal();
+        if (it->signalIndex != signal.methodIndex())
+            return;
+        stopMonitoring(info);
+    }
+
+    if (entered)
+        emit areaEntered(info, update);
+    else
+        emit areaExited(info, update);
+}
+
+void QGeoAreaMonitorRegionSource::updateRegions(const QGeoCoordinate &position)
+{
+    QStringList added;
+    QStringList removed;
+    m_regions.update(position, &added, &removed);
+
+    for (const QString &identifier : qAsConst(removed)) {
+        stopRegion(identifier);
+        // farther than the registered ones now
+        if (m_monitors.contains(identifier) && !m_regions.isRegistered(identifier))
+            startPolling(identifier);
+    }
+
+    bool rejected = false;
+    for (const QString &identifier : qAsConst(added)) {
+        stopPolling(identifier);
+        if (!startRegion(identifier, QGeoCircle(m_monitors.value(identifier).info.area()))) {
+            m_regions.reject(identifier);
+            startPolling(identifier);
+            rejected = true;
+        }
+    }
+
+    // The next nearest take the places left
+    if (rejected)
+        updateRegions(position);
+}
+
+void QGeoAreaMonitorRegionSource::pollingAreaEntered(const QGeoAreaMonitorInfo &monitor,
+                                                     const QGeoPositionInfo &update)
+{
+    if (!m_regions.isRegistered(monitor.identifier()))
+        processEvent(monitor.identifier(), update, true);
+}
+
+void QGeoAreaMonitorRegionSource::pollingAreaExited(const QGeoAreaMonitorInfo &monitor,
+                                                    const QGeoPositionInfo &update)
+{
+    if (!m_regions.isRegistered(monitor.identifier()))
+        processEvent(monitor.identifier(), update, false);
+}
+
+void QGeoAreaMonitorRegionSource::pollingError(QGeoAreaMonitorSource::Error error)
+{
+    setError(error);
+}
+
+void QGeoAreaMonitorRegionSource::positionUpdated(const QGeoPositionInfo &update)
+{
+    if (m_regions.needsUpdate(update.coordinate()))
+        updateRegions(update.coordinate());
+}
+
+void QGeoAreaMonitorRegionSource::expire()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    QList<QGeoAreaMonitorInfo> expired;
+    for (const Monitor &monitor : qAsConst(m_monitors)) {
+        if (monitor.info.expiration().isValid() && monitor.info.expiration() <= now)
+            expired.append(monitor.info);
+    }
+
+    for (const QGeoAreaMonitorInfo &monitor : qAsConst(expired))
+        removeMonitor(monitor.identifier());
+    if (!expired.isEmpty())
+        updateRegions(lastKnownPosition().coordinate());
+    startExpiryTimer();
+
+    for (const QGeoAreaMonitorInfo &monitor : qAsConst(expired))
+        emit monitorExpired(monitor);
+}
+
+void QGeoAreaMonitorRegionSource::startExpiryTimer()
+{
+    QDateTime next;
+    for (const Monitor &monitor : qAsConst(m_monitors)) {
+        const QDateTime expiration = monitor.info.expiration();
+        if (expiration.isValid() && (!next.isValid() || expiration < next))
+            next = expiration;
+    }
+
+    if (!next.isValid()) {
+        m_expiryTimer.stop();
+        return;
+    }
+    const qint64 msec = QDateTime::currentDateTime().msecsTo(next);
+    m_expiryTimer.start(int(qBound<qint64>(0, msec, std::numeric_limits<int>::max())));
+}
+
+QGeoAreaMonitorSource *QGeoAreaMonitorRegionSource::pollingMonitor()
+{
+    if (!m_polling) {
+        m_polling = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), this);
+        if (!m_polling) {
+            qWarning("The positionpoll plugin is needed to monitor the areas the platform cannot");
+            return nullptr;
+        }
+
+        connect(m_polling, &QGeoAreaMonitorSource::areaEntered,
+                this, &QGeoAreaMonitorRegionSource::pollingAreaEntered);
+        connect(m_polling, &QGeoAreaMonitorSource::areaExited,
+                this, &QGeoAreaMonitorRegionSource::pollingAreaExited);
+        connect(m_polling, QOverload<QGeoAreaMonitorSource::Error>::of(&QGeoAreaMonitorSource::error),
+                this, &QGeoAreaMonitorRegionSource::pollingError);
+        if (m_positionSource)
+            m_polling->setPositionInfoSource(m_positionSource);
+        connectPositionSource();
+    }
+    return m_polling;
+}
+
+bool QGeoAreaMonitorRegionSource::startPolling(const QString &identifier)
+{
+    QGeoAreaMonitorSource *polling = pollingMonitor();
+    if (!polling)
+        return false;
+
+    // Expiry and single shots are handled here for all the monitors
+    QGeoAreaMonitorInfo info = m_monitors.value(identifier).info;
+    info.setExpiration(QDateTime());
+    return polling->startMonitoring(info);
+}
+
+void QGeoAreaMonitorRegionSource::stopPolling(const QString &identifier)
+{
+    if (m_polling)
+        m_polling->stopMonitoring(m_monitors.value(identifier).info);
+}
+
+void QGeoAreaMonitorRegionSource::connectPositionSource()
+{
+    // The positions polled for the other areas tell when the nearest
+    // circles change
+    QGeoPositionInfoSource *source = m_polling->positionInfoSource();
+    if (source) {
+        connect(source, &QGeoPositionInfoSource::positionUpdated,
+                this, &QGeoAreaMonitorRegionSource::positionUpdated, Qt::UniqueConnection);
+    }
+}
+
+QT_END_NAMESPACE
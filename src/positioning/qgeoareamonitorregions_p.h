@@ -0,0 +1,211 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOAREAMONITORREGIONS_P_H
+#define QGEOAREAMONITORREGIONS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/qgeoareamonitorsource.h>
+#include <QtPositioning/qgeocircle.h>
+#include <QtPositioning/qgeocoordinate.h>
+#include <QtPositioning/qgeopositioninfosource.h>
+#include <QtPositioning/qgeoshape.h>
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Splits the areas of a QGeoAreaMonitorSource backed by the geofencing of
+    the platform between the regions registered with the platform, which
+    monitors at most maximumRegions() circles up to maximumRadius() meters,
+    and the areas left to a polling monitor. Other shapes, larger circles and
+    the regions the platform refused are always left to polling.
+
+    When more circles qualify than can be registered, the ones whose boundary
+    is nearest to the position given to update() are. The selection can only
+    change once the position moved by half the gap between the farthest
+    registered and the nearest unregistered boundary, which needsUpdate()
+    tells.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoAreaMonitorRegions
+{
+public:
+    QGeoAreaMonitorRegions(int maximumRegions, double maximumRadius);
+
+    int maximumRegions() const { return m_maximumRegions; }
+    double maximumRadius() const { return m_maximumRadius; }
+
+    // Adds or replaces the area with the given identifier, returns false if
+    // it can only be polled. Takes effect with the next update(), which
+    // registers a replaced region again if it stays selected.
+    bool insert(const QString &identifier, const QGeoShape &area);
+    // Returns true if the area was registered, the caller unregisters it
+    bool remove(const QString &identifier);
+    // The platform refused to monitor the region, which is unregistered and
+    // stays with polling until inserted again
+    void reject(const QString &identifier);
+    void clear();
+
+    bool contains(const QString &identifier) const { return m_regions.contains(identifier); }
+    bool isRegistered(const QString &identifier) const { return m_registered.contains(identifier); }
+    QStringList registered() const { return m_registered.values(); }
+
+    bool needsUpdate(const QGeoCoordinate &position) const;
+    // Selects the regions to register from position, which may be invalid
+    // while none is known. The regions to register and to unregister on the
+    // platform are returned in added and removed, to be unregistered first.
+    void update(const QGeoCoordinate &position, QStringList *added, QStringList *removed);
+
+private:
+    struct Region
+    {
+        QGeoCoordinate center;
+        double radius;
+        bool rejected;
+    };
+
+    QHash<QString, Region> m_regions;
+    QSet<QString> m_registered;
+    QSet<QString> m_replaced; // registered, with another area since
+    QGeoCoordinate m_position; // of the last update
+    double m_margin = 0; // the distance from m_position that needs another update
+    int m_maximumRegions;
+    double m_maximumRadius;
+};
+
+/*
+    The base of the area monitors backed by the geofencing of a platform.
+    The circles selected by QGeoAreaMonitorRegions are registered with the
+    platform through startRegion(), the other areas are monitored by a
+    monitor of the positionpoll plugin, whose positions also tell when to
+    select the circles again. Expiry and single shot monitors are handled
+    here for both.
+
+    Subclasses report the events of their regions with regionEvent(), and
+    call stopRegions() when destroyed.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoAreaMonitorRegionSource : public QGeoAreaMonitorSource
+{
+    Q_OBJECT
+public:
+    explicit QGeoAreaMonitorRegionSource(QObject *parent = nullptr);
+    ~QGeoAreaMonitorRegionSource();
+
+    void setPositionInfoSource(QGeoPositionInfoSource *source) override;
+    QGeoPositionInfoSource *positionInfoSource() const override;
+
+    Error error() const override;
+    AreaMonitorFeatures supportedAreaMonitorFeatures() const override;
+
+    bool startMonitoring(const QGeoAreaMonitorInfo &monitor) override;
+    bool stopMonitoring(const QGeoAreaMonitorInfo &monitor) override;
+    bool requestUpdate(const QGeoAreaMonitorInfo &monitor, const char *signal) override;
+
+    QList<QGeoAreaMonitorInfo> activeMonitors() const override;
+    QList<QGeoAreaMonitorInfo> activeMonitors(const QGeoShape &lookupArea) const override;
+
+protected:
+    // Before any monitor is started
+    void setRegionLimits(int maximumRegions, double maximumRadius);
+
+    // Returns false if the platform cannot monitor, after asking for the
+    // permission if needed
+    virtual bool enableRegions() = 0;
+    virtual QGeoPositionInfo lastKnownPosition() const = 0;
+    // Returns false if the platform refused the region right away
+    virtual bool startRegion(const QString &identifier, const QGeoCircle &circle) = 0;
+    virtual void stopRegion(const QString &identifier) = 0;
+
+    void regionEvent(const QString &identifier, const QGeoPositionInfo &update, bool entered);
+    // The platform stopped monitoring the region, which is polled instead
+    void regionFailed(const QString &identifier);
+    void stopRegions();
+    void setError(QGeoAreaMonitorSource::Error error);
+
+private Q_SLOTS:
+    void pollingAreaEntered(const QGeoAreaMonitorInfo &monitor, const QGeoPositionInfo &update);
+    void pollingAreaExited(const QGeoAreaMonitorInfo &monitor, const QGeoPositionInfo &update);
+    void pollingError(QGeoAreaMonitorSource::Error error);
+    void positionUpdated(const QGeoPositionInfo &update);
+    void expire();
+
+private:
+    struct Monitor
+    {
+        QGeoAreaMonitorInfo info;
+        int signalIndex; // of the single shot signal, -1 if monitored until stopped
+    };
+
+    bool insertMonitor(const QGeoAreaMonitorInfo &monitor, int signalIndex);
+    void removeMonitor(const QString &identifier);
+    void processEvent(const QString &identifier, const QGeoPositionInfo &update, bool entered);
+    void updateRegions(const QGeoCoordinate &position);
+
+    QGeoAreaMonitorSource *pollingMonitor();
+    bool startPolling(const QString &identifier);
+    void stopPolling(const QString &identifier);
+    void connectPositionSource();
+    void startExpiryTimer();
+
+    QGeoAreaMonitorRegions m_regions;
+    QHash<QString, Monitor> m_monitors;
+    QGeoAreaMonitorSource *m_polling = nullptr;
+    QPointer<QGeoPositionInfoSource> m_positionSource;
+    QTimer m_expiryTimer;
+    QGeoAreaMonitorSource::Error m_error = QGeoAreaMonitorSource::NoError;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOAREAMONITORREGIONS_P_H
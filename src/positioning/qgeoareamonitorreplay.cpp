@@ -0,0 +1,278 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeoareamonitorreplay_p.h"
+#include "qgeopackedcoordinate_p.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+// Margin in degrees for the rounding of the bounding boxes of circles
+static const double BoundsMargin = 1e-6;
+
+static bool transitionLessThan(int position1, int monitor1, int position2, int monitor2)
+{
+    return position1 < position2 || (position1 == position2 && monitor1 < monitor2);
+}
+
+// Returns false if no coordinate between the given latitudes and longitudes
+// can be inside bounds.
+static bool mayContain(const QGeoRectangle &bounds, double minLatitude, double maxLatitude,
+                       double minLongitude, double maxLongitude, bool anyLongitude)
+{
+    if (!bounds.isValid())
+        return true;
+
+    if (bounds.bottomRight().latitude() > maxLatitude + BoundsMargin
+            || bounds.topLeft().latitude() < minLatitude - BoundsMargin)
+        return false;
+    if (anyLongitude)
+        return true;
+
+    const double west = bounds.topLeft().longitude() - BoundsMargin;
+    const double east = bounds.bottomRight().longitude() + BoundsMargin;
+    if (west > east) // crosses the antimeridian
+        return maxLongitude >= west || minLongitude <= east;
+    return maxLongitude >= west && minLongitude <= east;
+}
+
+bool QGeoAreaMonitorReplay::addMonitor(const QGeoAreaMonitorInfo &monitor, Trigger trigger)
+{
+    if (!monitor.isValid())
+        return false;
+
+    const QGeoFrozenShape area(monitor.area());
+    const Monitor entry { monitor, area, area.boundingGeoRectangle(), trigger };
+    const auto it = m_indexes.constFind(monitor.identifier());
+    if (it != m_indexes.constEnd()) {
+        m_monitors[*it] = entry;
+    } else {
+        m_indexes.insert(monitor.identifier(), m_monitors.size());
+        m_monitors.append(entry);
+    }
+    return true;
+}
+
+bool QGeoAreaMonitorReplay::removeMonitor(const QString &identifier)
+{
+    const auto found = m_indexes.find(identifier);
+    if (found == m_indexes.end())
+        return false;
+
+    const int index = *found;
+    m_indexes.erase(found);
+    m_monitors.removeAt(index);
+    for (auto it = m_indexes.begin(); it != m_indexes.end(); ++it) {
+        if (*it > index)
+            --*it;
+    }
+    return true;
+}
+
+void QGeoAreaMonitorReplay::clear()
+{
+    m_monitors.clear();
+    m_indexes.clear();
+}
+
+/*
+    Tests the positions of chunk against all monitors. Positions without a
+    valid coordinate are outside every area, as for a live monitor.
+*/
+void QGeoAreaMonitorReplay::evaluate(const QVector<QGeoPositionInfo> &track, Chunk *chunk) const
+{
+    QGeoPackedCoordinates coordinates(chunk->size);
+    QVector<bool> valid(chunk->size);
+    double minLatitude = std::numeric_limits<double>::max();
+    double maxLatitude = -std::numeric_limits<double>::max();
+    double minLongitude = std::numeric_limits<double>::max();
+    double maxLongitude = -std::numeric_limits<double>::max();
+    bool anyValid = false;
+    for (int i = 0; i < chunk->size; ++i) {
+        const QGeoCoordinate coordinate = track.at(chunk->first + i).coordinate();
+        coordinates[i] = QGeoPackedCoordinate::fromCoordinate(coordinate);
+        valid[i] = coordinate.isValid();
+        if (!valid.at(i))
+            continue;
+        anyValid = true;
+        minLatitude = qMin(minLatitude, coordinate.latitude());
+        maxLatitude = qMax(maxLatitude, coordinate.latitude());
+        minLongitude = qMin(minLongitude, coordinate.longitude());
+        maxLongitude = qMax(maxLongitude, coordinate.longitude());
+    }
+    // the longitudes of a track crossing the antimeridian are not filtered
+    const bool anyLongitude = maxLongitude - minLongitude > 180.0;
+
+    chunk->firstInside.fill(false, m_monitors.size());
+    chunk->transitions.clear();
+    if (!anyValid)
+        return;
+
+    QVector<uchar> mask((chunk->size + 7) / 8);
+    for (int m = 0; m < m_monitors.size(); ++m) {
+        const Monitor &monitor = m_monitors.at(m);
+        if (!mayContain(monitor.bounds, minLatitude, maxLatitude,
+                        minLongitude, maxLongitude, anyLongitude)) {
+            continue;
+        }
+
+        monitor.area.containsBatch(coordinates, mask.data());
+        bool previous = false;
+        for (int i = 0; i < chunk->size; ++i) {
+            const bool inside = valid.at(i) && (mask.at(i >> 3) & (1u << (i & 7)));
+            if (i == 0)
+                chunk->firstInside[m] = inside;
+            else if (inside != previous)
+                chunk->transitions.append(Transition { chunk->first + i, m });
+            previous = inside;
+        }
+    }
+
+    std::sort(chunk->transitions.begin(), chunk->transitions.end(),
+              [](const Transition &a, const Transition &b) {
+        return transitionLessThan(a.position, a.monitor, b.position, b.monitor);
+    });
+}
+
+QVector<QGeoAreaMonitorReplay::Event>
+QGeoAreaMonitorReplay::replay(const QVector<QGeoPositionInfo> &track) const
+{
+    QVector<Event> events;
+    if (track.isEmpty() || m_monitors.isEmpty())
+        return events;
+
+    QVector<Chunk> chunks;
+    for (int first = 0; first < track.size(); first += m_chunkSize)
+        chunks.append(Chunk { first, qMin(m_chunkSize, track.size() - first), {}, {} });
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int threads = pool->maxThreadCount();
+    QAtomicInt next(0);
+    auto work = [this, &track, &chunks, &next]() {
+        for (int i = next.fetchAndAddRelaxed(1); i < chunks.size(); i = next.fetchAndAddRelaxed(1))
+            evaluate(track, &chunks[i]);
+    };
+
+    // Only use threads that are free right away, this may itself run on a pool thread
+    QSemaphore done;
+    int helpers = 0;
+    for (int i = 1; i < qMin(threads, chunks.size()); ++i) {
+        QRunnable *task = QRunnable::create([&work, &done]() {
+            work();
+            done.release();
+        });
+        if (!pool->tryStart(task)) {
+            delete task;
+            break;
+        }
+        ++helpers;
+    }
+    work();
+    done.acquire(helpers);
+
+    // The first position of each track the monitors are expired at
+    QVector<Transition> expiries;
+    for (int m = 0; m < m_monitors.size(); ++m) {
+        const QDateTime expiration = m_monitors.at(m).info.expiration();
+        if (!expiration.isValid())
+            continue;
+        const auto it = std::partition_point(track.begin(), track.end(),
+                                             [&expiration](const QGeoPositionInfo &info) {
+            return info.timestamp() < expiration;
+        });
+        if (it != track.end())
+            expiries.append(Transition { int(it - track.begin()), m });
+    }
+    std::sort(expiries.begin(), expiries.end(), [](const Transition &a, const Transition &b) {
+        return transitionLessThan(a.position, a.monitor, b.position, b.monitor);
+    });
+
+    QVector<bool> inside(m_monitors.size(), false);
+    QVector<bool> active(m_monitors.size(), true);
+    int nextExpiry = 0;
+    auto expireUntil = [&](int position) {
+        for (; nextExpiry < expiries.size(); ++nextExpiry) {
+            const Transition &expiry = expiries.at(nextExpiry);
+            if (expiry.position > position)
+                break;
+            if (!active.at(expiry.monitor))
+                continue;
+            active[expiry.monitor] = false;
+            events.append(Event { MonitorExpired, m_monitors.at(expiry.monitor).info,
+                                  expiry.position });
+        }
+    };
+    auto toggle = [&](int m, int position) {
+        if (!active.at(m))
+            return;
+        const Monitor &monitor = m_monitors.at(m);
+        const bool entered = !inside.at(m);
+        inside[m] = entered;
+        events.append(Event { entered ? AreaEntered : AreaExited, monitor.info, position });
+        //the finishing singleshot event
+        if (monitor.trigger == (entered ? SingleShotEntered : SingleShotExited))
+            active[m] = false;
+    };
+
+    for (const Chunk &chunk : qAsConst(chunks)) {
+        // the first position of a chunk is compared with the end of the previous one
+        expireUntil(chunk.first);
+        for (int m = 0; m < m_monitors.size(); ++m) {
+            if (chunk.firstInside.at(m) != inside.at(m))
+                toggle(m, chunk.first);
+        }
+        for (const Transition &transition : chunk.transitions) {
+            expireUntil(transition.position);
+            toggle(transition.monitor, transition.position);
+        }
+    }
+    expireUntil(track.size() - 1);
+
+    return events;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOAREAMONITORREPLAY_P_H
+#define QGEOAREAMONITORREPLAY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qgeoshape_p.h>
+#include <QtPositioning/qgeoareamonitorinfo.h>
+#include <QtPositioning/qgeopositioninfo.h>
+#include <QtPositioning/qgeorectangle.h>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Evaluates a recorded track against a set of area monitors, returning the
+    events a live QGeoAreaMonitorSource polling the same positions would
+    have emitted: a monitor is entered at the first position inside its area,
+    single-shot monitors are removed after their event, and monitors expire
+    at the first position whose timestamp reaches their expiration.
+
+    The track is split into chunks whose area containment is tested on the
+    global thread pool. The state of each monitor is then carried across the
+    chunks in track order on the calling thread.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoAreaMonitorReplay
+{
+public:
+    enum Trigger { Continuous, SingleShotEntered, SingleShotExited };
+    enum EventType { AreaEntered, AreaExited, MonitorExpired };
+
+    struct Event
+    {
+        EventType type;
+        QGeoAreaMonitorInfo monitor;
+        int position; // index in the track
+    };
+
+    enum { DefaultChunkSize = 4096 };
+
+    // Adds or replaces the monitor with the identifier of monitor, returns
+    // false if it is not valid. Persistence only matters across restarts of
+    // a live source, so persistent monitors are replayed like the others.
+    bool addMonitor(const QGeoAreaMonitorInfo &monitor, Trigger trigger = Continuous);
+    bool removeMonitor(const QString &identifier);
+    void clear();
+    int monitorCount() const { return m_monitors.size(); }
+
+    int chunkSize() const { return m_chunkSize; }
+    void setChunkSize(int positions) { m_chunkSize = qMax(2, positions); }
+
+    // track is expected in chronological order. Events are ordered by
+    // position, then expiries before area events, then by monitor addition.
+    QVector<Event> replay(const QVector<QGeoPositionInfo> &track) const;
+
+private:
+    struct Monitor
+    {
+        QGeoAreaMonitorInfo info;
+        QGeoFrozenShape area;
+        QGeoRectangle bounds;
+        Trigger trigger;
+    };
+
+    // Index of a position whose containment in a monitor differs from the
+    // previous position of the same chunk
+    struct Transition
+    {
+        int position;
+        int monitor;
+    };
+
+    struct Chunk
+    {
+        int first;
+        int size;
+        QVector<bool> firstInside; // by monitor
+        QVector<Transition> transitions; // by position, then monitor
+    };
+
+    void evaluate(const QVector<QGeoPositionInfo> &track, Chunk *chunk) const;
+
+    QVector<Monitor> m_monitors;
+    QHash<QString, int> m_indexes; // by monitor identifier
+    int m_chunkSize = DefaultChunkSize;
+};
+
+Q_DECLARE_TYPEINFO(QGeoAreaMonitorReplay::Event, Q_MOVABLE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QGEOAREAMONITORREPLAY_P_H
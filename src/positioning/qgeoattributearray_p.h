@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOATTRIBUTEARRAY_P_H
+#define QGEOATTRIBUTEARRAY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QHash>
+#include <QList>
+#include <QtCore/qlogging.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Fixed size storage for the qreal attributes of QGeoPositionInfo and
+    QGeoSatelliteInfo. Attribute values 0 to Count - 1 are stored in place
+    with a presence mask, so copying, comparing and setting attributes never
+    allocates. Attributes outside of that range are ignored, with a warning
+    when they are inserted.
+*/
+template <typename Attribute, int Count>
+class QGeoAttributeArray
+{
+    Q_STATIC_ASSERT(Count > 0 && Count <= 32);
+
+public:
+    bool contains(Attribute attribute) const
+    {
+        return isValid(attribute) && (m_mask & bit(attribute));
+    }
+
+    qreal value(Attribute attribute, qreal defaultValue) const
+    {
+        return contains(attribute) ? m_values[int(attribute)] : defaultValue;
+    }
+
+    void insert(Attribute attribute, qreal value)
+    {
+        if (!isValid(attribute)) {
+            qWarning("QGeoAttributeArray: ignoring attribute %d, out of range", int(attribute));
+            return;
+        }
+        m_values[int(attribute)] = value;
+        m_mask |= bit(attribute);
+    }
+
+    void remove(Attribute attribute)
+    {
+        if (isValid(attribute))
+            m_mask &= ~bit(attribute);
+    }
+
+    void clear() { m_mask = 0; }
+    bool isEmpty() const { return m_mask == 0; }
+
+    // in ascending order
+    QList<Attribute> keys() const
+    {
+        QList<Attribute> result;
+        for (int i = 0; i < Count; ++i) {
+            if (m_mask & (1u << i))
+                result.append(Attribute(i));
+        }
+        return result;
+    }
+
+    // QDataStream keeps the QHash format of earlier versions
+    template <typename Key>
+    QHash<Key, qreal> toHash() const
+    {
+        QHash<Key, qreal> hash;
+        for (int i = 0; i < Count; ++i) {
+            if (m_mask & (1u << i))
+                hash.insert(Key(i), m_values[i]);
+        }
+        return hash;
+    }
+
+    template <typename Key>
+    void setHash(const QHash<Key, qreal> &hash)
+    {
+        clear();
+        for (auto it = hash.cbegin(); it != hash.cend(); ++it)
+            insert(Attribute(int(it.key())), it.value());
+    }
+
+    bool operator==(const QGeoAttributeArray &other) const
+    {
+        if (m_mask != other.m_mask)
+            return false;
+        for (int i = 0; i < Count; ++i) {
+            if ((m_mask & (1u << i)) && !(m_values[i] == other.m_values[i]))
+                return false;
+        }
+        return true;
+    }
+    bool operator!=(const QGeoAttributeArray &other) const { return !operator==(other); }
+
+private:
+    static bool isValid(Attribute attribute)
+    {
+        return int(attribute) >= 0 && int(attribute) < Count;
+    }
+    static quint32 bit(Attribute attribute) { return 1u << int(attribute); }
+
+    qreal m_values[Count] = {};
+    quint32 m_mask = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOATTRIBUTEARRAY_P_H
@@ -41,11 +41,13 @@
 #include "qgeocircle_p.h"
 
 #include "qgeocoordinate.h"
+#include "qgeocoordinate_p.h"
 #include "qnumeric.h"
 #include "qlocationutils_p.h"
 
 #include "qdoublevector2d_p.h"
 #include "qdoublevector3d_p.h"
+#include <QtCore/private/qsimd_p.h>
 #include <cmath>
 QT_BEGIN_NAMESPACE
 
@@ -254,6 +256,96 @@ bool QGeoCirclePrivate::contains(const QGeoCoordinate &coordinate) const
     return false;
 }
 
+void QGeoCirclePrivate::containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const
+{
+    const int count = coordinates.size();
+    memset(mask, 0, size_t(count + 7) / 8);
+    if (!isValid())
+        return;
+
+    const double centerLat = m_center.latitude();
+    const double centerLon = m_center.longitude();
+
+    // Conservative bounds, in degrees, on how far the latitude and longitude
+    // of a coordinate inside the circle can be from the center. The great
+    // circle distance is at least the latitude difference, and
+    // cos(lat1) * cos(lat2) * sin^2(dlon / 2) is a lower bound of the
+    // haversine term, with lat2 limited by the latitude bound. The margins
+    // cover rounding and the fuzzy comparison in contains().
+    const double metersPerDegree = QGeoCoordinatePrivate::distance(0.0, 0.0, 1.0, 0.0);
+    const double angle = qMax(0.0, double(m_radius)) / metersPerDegree;
+    double latTolerance = 360.0; // no filtering
+    double lonTolerance = 360.0;
+    if (angle < 90.0) {
+        latTolerance = angle * (1.0 + 1e-6) + 1e-9;
+        const double maxLat = qAbs(centerLat) + latTolerance;
+        if (maxLat < 90.0) {
+            double haversine = std::sin(qDegreesToRadians(angle) / 2.0);
+            haversine *= haversine;
+            const double cosLats = std::cos(qDegreesToRadians(centerLat))
+                    * std::cos(qDegreesToRadians(maxLat));
+            if (haversine < cosLats) {
+                lonTolerance = qRadiansToDegrees(2.0 * std::asin(std::sqrt(haversine / cosLats)))
+                        * (1.0 + 1e-6) + 1e-9;
+            }
+        }
+    }
+
+    // first pass: valid coordinates within the bounds
+    const QGeoPackedCoordinate *p = coordinates.data();
+    int i = 0;
+
+#ifdef __SSE2__
+    // Two coordinates per step. Comparisons are false for NaN, so invalid
+    // coordinates drop out.
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d vCenterLat = _mm_set1_pd(centerLat);
+    const __m128d vCenterLon = _mm_set1_pd(centerLon);
+    const __m128d vLatTolerance = _mm_set1_pd(latTolerance);
+    const __m128d vLonTolerance = _mm_set1_pd(lonTolerance);
+    const __m128d vMaxLat = _mm_set1_pd(90.0);
+    const __m128d vMaxLon = _mm_set1_pd(180.0);
+    const __m128d vFullTurn = _mm_set1_pd(360.0);
+
+    for (; i + 2 <= count; i += 2) {
+        const __m128d lat = _mm_set_pd(p[i + 1].latitude, p[i].latitude);
+        const __m128d lon = _mm_set_pd(p[i + 1].longitude, p[i].longitude);
+
+        const __m128d valid = _mm_and_pd(_mm_cmple_pd(_mm_andnot_pd(signMask, lat), vMaxLat),
+                                         _mm_cmple_pd(_mm_andnot_pd(signMask, lon), vMaxLon));
+        const __m128d dlat = _mm_andnot_pd(signMask, _mm_sub_pd(lat, vCenterLat));
+        __m128d dlon = _mm_andnot_pd(signMask, _mm_sub_pd(lon, vCenterLon));
+        dlon = _mm_min_pd(dlon, _mm_sub_pd(vFullTurn, dlon));
+
+        const __m128d candidate = _mm_and_pd(valid,
+                                             _mm_and_pd(_mm_cmple_pd(dlat, vLatTolerance),
+                                                        _mm_cmple_pd(dlon, vLonTolerance)));
+        mask[i >> 3] |= uchar(_mm_movemask_pd(candidate) << (i & 7));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const double lat = p[i].latitude;
+        const double lon = p[i].longitude;
+        if (!QLocationUtils::isValidLat(lat) || !QLocationUtils::isValidLong(lon))
+            continue;
+        double dlon = qAbs(lon - centerLon);
+        dlon = qMin(dlon, 360.0 - dlon);
+        if (qAbs(lat - centerLat) <= latTolerance && dlon <= lonTolerance)
+            mask[i >> 3] |= uchar(1u << (i & 7));
+    }
+
+    // second pass: the exact test of contains() on the candidates
+    for (i = 0; i < count; ++i) {
+        if (!(mask[i >> 3] & (1u << (i & 7))))
+            continue;
+        const qreal distance = QGeoCoordinatePrivate::distance(centerLat, centerLon,
+                                                               p[i].latitude, p[i].longitude);
+        if (!qFuzzyCompare(distance, m_radius) && distance > m_radius)
+            mask[i >> 3] &= uchar(~(1u << (i & 7)));
+    }
+}
+
 QGeoCoordinate QGeoCirclePrivate::center() const
 {
     return m_center;
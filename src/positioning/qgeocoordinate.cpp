@@ -66,9 +66,6 @@ struct CoordinateStreamOperators
 Q_GLOBAL_STATIC(CoordinateStreamOperators, initStreamOperators);
 
 
-static const double qgeocoordinate_EARTH_MEAN_RADIUS = 6371.0072;
-
-
 QGeoCoordinatePrivate::QGeoCoordinatePrivate():
     lat(qQNaN()),
     lng(qQNaN()),
@@ -443,19 +440,7 @@ qreal QGeoCoordinate::distanceTo(const QGeoCoordinate &other) const
         return 0;
     }
 
-    // Haversine formula
-    double dlat = qDegreesToRadians(other.d->lat - d->lat);
-    double dlon = qDegreesToRadians(other.d->lng - d->lng);
-    double haversine_dlat = sin(dlat / 2.0);
-    haversine_dlat *= haversine_dlat;
-    double haversine_dlon = sin(dlon / 2.0);
-    haversine_dlon *= haversine_dlon;
-    double y = haversine_dlat
-             + cos(qDegreesToRadians(d->lat))
-             * cos(qDegreesToRadians(other.d->lat))
-             * haversine_dlon;
-    double x = 2 * asin(sqrt(y));
-    return qreal(x * qgeocoordinate_EARTH_MEAN_RADIUS * 1000);
+    return qreal(QGeoCoordinatePrivate::distance(d->lat, d->lng, other.d->lat, other.d->lng));
 }
 
 /*!
@@ -489,6 +474,23 @@ qreal QGeoCoordinate::azimuthTo(const QGeoCoordinate &other) const
     return qreal((int(whole + 360) % 360) + fraction);
 }
 
+double QGeoCoordinatePrivate::distance(double fromLat, double fromLng, double toLat, double toLng)
+{
+    // Haversine formula
+    double dlat = qDegreesToRadians(toLat - fromLat);
+    double dlon = qDegreesToRadians(toLng - fromLng);
+    double haversine_dlat = sin(dlat / 2.0);
+    haversine_dlat *= haversine_dlat;
+    double haversine_dlon = sin(dlon / 2.0);
+    haversine_dlon *= haversine_dlon;
+    double y = haversine_dlat
+             + cos(qDegreesToRadians(fromLat))
+             * cos(qDegreesToRadians(toLat))
+             * haversine_dlon;
+    double x = 2 * asin(sqrt(y));
+    return x * qgeocoordinate_EARTH_MEAN_RADIUS * 1000;
+}
+
 void QGeoCoordinatePrivate::atDistanceAndAzimuth(const QGeoCoordinate &coord,
                                                  qreal distance, qreal azimuth,
                                                  double *lon, double *lat)
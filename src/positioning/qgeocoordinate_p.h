@@ -56,6 +56,8 @@
 
 QT_BEGIN_NAMESPACE
 
+static const double qgeocoordinate_EARTH_MEAN_RADIUS = 6371.0072;
+
 class QGeoCoordinatePrivate : public QSharedData
 {
 public:
@@ -70,6 +72,7 @@ public:
     static void atDistanceAndAzimuth(const QGeoCoordinate &coord,
                                      qreal distance, qreal azimuth,
                                      double *lon, double *lat);
+    static double distance(double fromLat, double fromLng, double toLat, double toLng);
     static const QGeoCoordinatePrivate *get(const QGeoCoordinate *c) {
            return c->d.constData();
     }
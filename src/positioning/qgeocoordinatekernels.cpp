@@ -0,0 +1,656 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeocoordinatekernels_p.h"
+#include "qgeocoordinate_p.h"
+
+#include <QtCore/qmath.h>
+#include <QtCore/qnumeric.h>
+#include <QtCore/private/qsimd_p.h>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// One type per build: a batch of doubles for the widest instruction set the
+// compiler targets, and the matching comparison mask.
+#if defined(__AVX2__)
+#  define QGEOCOORDINATEKERNELS_SIMD
+
+struct Mask { __m256d m; };
+
+struct Batch
+{
+    enum { Size = 4 };
+    __m256d v;
+
+    Batch(__m256d v) : v(v) {}
+    explicit Batch(double d) : v(_mm256_set1_pd(d)) {}
+
+    static Batch latitudes(const QGeoPackedCoordinate *p)
+    {
+        return _mm256_set_pd(p[3].latitude, p[2].latitude, p[1].latitude, p[0].latitude);
+    }
+    static Batch longitudes(const QGeoPackedCoordinate *p)
+    {
+        return _mm256_set_pd(p[3].longitude, p[2].longitude, p[1].longitude, p[0].longitude);
+    }
+    void store(double *out) const { _mm256_storeu_pd(out, v); }
+
+    // p holds Size pairs, a gets the first and b the second member of each
+    static void loadPairs(const double *p, Batch *a, Batch *b)
+    {
+        const __m256d v0 = _mm256_loadu_pd(p);
+        const __m256d v1 = _mm256_loadu_pd(p + 4);
+        const __m256d lo = _mm256_permute2f128_pd(v0, v1, 0x20);
+        const __m256d hi = _mm256_permute2f128_pd(v0, v1, 0x31);
+        a->v = _mm256_unpacklo_pd(lo, hi);
+        b->v = _mm256_unpackhi_pd(lo, hi);
+    }
+    static void storePairs(Batch a, Batch b, double *out)
+    {
+        const __m256d lo = _mm256_unpacklo_pd(a.v, b.v);
+        const __m256d hi = _mm256_unpackhi_pd(a.v, b.v);
+        _mm256_storeu_pd(out, _mm256_permute2f128_pd(lo, hi, 0x20));
+        _mm256_storeu_pd(out + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+    }
+};
+
+inline Batch operator+(Batch a, Batch b) { return _mm256_add_pd(a.v, b.v); }
+inline Batch operator-(Batch a, Batch b) { return _mm256_sub_pd(a.v, b.v); }
+inline Batch operator*(Batch a, Batch b) { return _mm256_mul_pd(a.v, b.v); }
+inline Batch operator/(Batch a, Batch b) { return _mm256_div_pd(a.v, b.v); }
+inline Batch operator-(Batch a) { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+inline Mask operator<(Batch a, Batch b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+inline Mask operator>(Batch a, Batch b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+inline Batch batchAbs(Batch a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+inline Batch batchSqrt(Batch a) { return _mm256_sqrt_pd(a.v); }
+inline Batch batchSelect(Mask m, Batch a, Batch b) { return _mm256_blendv_pd(b.v, a.v, m.m); }
+inline Batch batchFloor(Batch a) { return _mm256_floor_pd(a.v); }
+
+#elif defined(__SSE2__)
+#  define QGEOCOORDINATEKERNELS_SIMD
+
+struct Mask { __m128d m; };
+
+struct Batch
+{
+    enum { Size = 2 };
+    __m128d v;
+
+    Batch(__m128d v) : v(v) {}
+    explicit Batch(double d) : v(_mm_set1_pd(d)) {}
+
+    static Batch latitudes(const QGeoPackedCoordinate *p)
+    {
+        return _mm_set_pd(p[1].latitude, p[0].latitude);
+    }
+    static Batch longitudes(const QGeoPackedCoordinate *p)
+    {
+        return _mm_set_pd(p[1].longitude, p[0].longitude);
+    }
+    void store(double *out) const { _mm_storeu_pd(out, v); }
+
+    // p holds Size pairs, a gets the first and b the second member of each
+    static void loadPairs(const double *p, Batch *a, Batch *b)
+    {
+        const __m128d v0 = _mm_loadu_pd(p);
+        const __m128d v1 = _mm_loadu_pd(p + 2);
+        a->v = _mm_unpacklo_pd(v0, v1);
+        b->v = _mm_unpackhi_pd(v0, v1);
+    }
+    static void storePairs(Batch a, Batch b, double *out)
+    {
+        _mm_storeu_pd(out, _mm_unpacklo_pd(a.v, b.v));
+        _mm_storeu_pd(out + 2, _mm_unpackhi_pd(a.v, b.v));
+    }
+};
+
+inline Batch operator+(Batch a, Batch b) { return _mm_add_pd(a.v, b.v); }
+inline Batch operator-(Batch a, Batch b) { return _mm_sub_pd(a.v, b.v); }
+inline Batch operator*(Batch a, Batch b) { return _mm_mul_pd(a.v, b.v); }
+inline Batch operator/(Batch a, Batch b) { return _mm_div_pd(a.v, b.v); }
+inline Batch operator-(Batch a) { return _mm_xor_pd(a.v, _mm_set1_pd(-0.0)); }
+inline Mask operator<(Batch a, Batch b) { return { _mm_cmplt_pd(a.v, b.v) }; }
+inline Mask operator>(Batch a, Batch b) { return { _mm_cmpgt_pd(a.v, b.v) }; }
+inline Batch batchAbs(Batch a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+inline Batch batchSqrt(Batch a) { return _mm_sqrt_pd(a.v); }
+inline Batch batchSelect(Mask m, Batch a, Batch b)
+{
+    return _mm_or_pd(_mm_and_pd(m.m, a.v), _mm_andnot_pd(m.m, b.v));
+}
+#ifdef __SSE4_1__
+inline Batch batchFloor(Batch a) { return _mm_floor_pd(a.v); }
+#else
+// exact for |a| < 2^51, adding and removing 2^52 rounds to an integer
+inline Batch batchFloor(Batch a)
+{
+    const __m128d magic = _mm_set1_pd(4503599627370496.0);
+    const __m128d sign = _mm_and_pd(a.v, _mm_set1_pd(-0.0));
+    const __m128d m = _mm_or_pd(magic, sign);
+    const __m128d r = _mm_sub_pd(_mm_add_pd(a.v, m), m);
+    return _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, a.v), _mm_set1_pd(1.0)));
+}
+#endif
+
+#elif defined(__ARM_NEON) && defined(Q_PROCESSOR_ARM_64)
+#  define QGEOCOORDINATEKERNELS_SIMD
+
+struct Mask { uint64x2_t m; };
+
+struct Batch
+{
+    enum { Size = 2 };
+    float64x2_t v;
+
+    Batch(float64x2_t v) : v(v) {}
+    explicit Batch(double d) : v(vdupq_n_f64(d)) {}
+
+    static Batch latitudes(const QGeoPackedCoordinate *p)
+    {
+        return vsetq_lane_f64(p[1].latitude, vdupq_n_f64(p[0].latitude), 1);
+    }
+    static Batch longitudes(const QGeoPackedCoordinate *p)
+    {
+        return vsetq_lane_f64(p[1].longitude, vdupq_n_f64(p[0].longitude), 1);
+    }
+    void store(double *out) const { vst1q_f64(out, v); }
+
+    // p holds Size pairs, a gets the first and b the second member of each
+    static void loadPairs(const double *p, Batch *a, Batch *b)
+    {
+        const float64x2x2_t v = vld2q_f64(p);
+        a->v = v.val[0];
+        b->v = v.val[1];
+    }
+    static void storePairs(Batch a, Batch b, double *out)
+    {
+        float64x2x2_t v;
+        v.val[0] = a.v;
+        v.val[1] = b.v;
+        vst2q_f64(out, v);
+    }
+};
+
+inline Batch operator+(Batch a, Batch b) { return vaddq_f64(a.v, b.v); }
+inline Batch operator-(Batch a, Batch b) { return vsubq_f64(a.v, b.v); }
+inline Batch operator*(Batch a, Batch b) { return vmulq_f64(a.v, b.v); }
+inline Batch operator/(Batch a, Batch b) { return vdivq_f64(a.v, b.v); }
+inline Batch operator-(Batch a) { return vnegq_f64(a.v); }
+inline Mask operator<(Batch a, Batch b) { return { vcltq_f64(a.v, b.v) }; }
+inline Mask operator>(Batch a, Batch b) { return { vcgtq_f64(a.v, b.v) }; }
+inline Batch batchAbs(Batch a) { return vabsq_f64(a.v); }
+inline Batch batchSqrt(Batch a) { return vsqrtq_f64(a.v); }
+inline Batch batchSelect(Mask m, Batch a, Batch b) { return vbslq_f64(m.m, a.v, b.v); }
+inline Batch batchFloor(Batch a) { return vrndmq_f64(a.v); }
+
+#endif
+
+// the same operations on plain doubles, for the remainders and scalar builds
+inline double batchAbs(double a) { return std::fabs(a); }
+inline double batchSqrt(double a) { return std::sqrt(a); }
+inline double batchSelect(bool m, double a, double b) { return m ? a : b; }
+inline double batchFloor(double a) { return std::floor(a); }
+
+// pi and pi / 2 as two parts for accurate reduction
+const double piHi = 3.14159265358979311600e+00;
+const double piLo = 1.22464679914735317720e-16;
+const double halfPiHi = 1.57079632679489655800e+00;
+const double halfPiLo = 6.12323399573676603587e-17;
+const double tanEighthPi = 0.41421356237309503;
+
+// Taylor series coefficients, enough terms for double precision on the reduced ranges
+const double sinCoefficients[] = {
+    -0.16666666666666666, 0.008333333333333333, -0.0001984126984126984,
+    2.7557319223985893e-06, -2.505210838544172e-08, 1.6059043836821613e-10,
+    -7.647163731819816e-13, 2.8114572543455206e-15
+};
+const double cosCoefficients[] = {
+    -0.5, 0.041666666666666664, -0.001388888888888889, 2.48015873015873e-05,
+    -2.755731922398589e-07, 2.08767569878681e-09, -1.1470745597729725e-11,
+    4.779477332387385e-14, -1.5619206968586225e-16
+};
+const double asinCoefficients[] = {
+    0.16666666666666666, 0.075, 0.044642857142857144, 0.030381944444444444,
+    0.022372159090909092, 0.017352764423076924, 0.01396484375, 0.011551800896139705,
+    0.009761609529194078, 0.008390335809616815, 0.0073125258735988454,
+    0.006447210311889649, 0.005740037670841924
+};
+const double atanCoefficients[] = {
+    -0.3333333333333333, 0.2, -0.14285714285714285, 0.1111111111111111,
+    -0.09090909090909091, 0.07692307692307693, -0.06666666666666667,
+    0.058823529411764705, -0.05263157894736842, 0.047619047619047616,
+    -0.043478260869565216, 0.04
+};
+const double expCoefficients[] = {
+    0.5, 0.16666666666666666, 0.041666666666666664, 0.008333333333333333,
+    0.001388888888888889, 0.0001984126984126984, 2.48015873015873e-05,
+    2.7557319223985893e-06, 2.755731922398589e-07, 2.505210838544172e-08,
+    2.08767569878681e-09, 1.6059043836821613e-10, 1.1470745597729725e-11,
+    7.647163731819816e-13, 4.779477332387385e-14, 2.8114572543455206e-15
+};
+const double atanhCoefficients[] = {
+    0.3333333333333333, 0.2, 0.14285714285714285, 0.1111111111111111,
+    0.09090909090909091, 0.07692307692307693, 0.06666666666666667,
+    0.058823529411764705, 0.05263157894736842
+};
+
+// the change in longitude from one to another, across the antimeridian when that is shorter
+template <typename D>
+inline D longitudeStep(D from, D to)
+{
+    const D delta = to - from;
+    const D west = batchSelect(delta > D(180.0), delta - D(360.0), delta);
+    return batchSelect(west < D(-180.0), west + D(360.0), west);
+}
+
+template <typename D, int N>
+inline D horner(D z, const double (&c)[N])
+{
+    D r(c[N - 1]);
+    for (int i = N - 2; i >= 0; --i)
+        r = r * z + D(c[i]);
+    return r;
+}
+
+// sin and cos of x for |x| <= pi
+template <typename D>
+inline void sinCos(D x, D *s, D *c)
+{
+    const D ax = batchAbs(x);
+    const auto obtuse = ax > D(M_PI_2);
+    const D a = batchSelect(obtuse, (D(piHi) - ax) + D(piLo), ax);
+    const auto upper = a > D(M_PI_4);
+    const D r = batchSelect(upper, (D(halfPiHi) - a) + D(halfPiLo), a);
+
+    const D z = r * r;
+    const D sr = r + r * z * horner(z, sinCoefficients);
+    const D cr = D(1.0) + z * horner(z, cosCoefficients);
+
+    const D sa = batchSelect(upper, cr, sr);
+    const D ca = batchSelect(upper, sr, cr);
+    *s = batchSelect(x < D(0.0), -sa, sa);
+    *c = batchSelect(obtuse, -ca, ca);
+}
+
+template <typename D>
+inline D cosine(D x)
+{
+    D s(0.0), c(0.0);
+    sinCos(x, &s, &c);
+    return c;
+}
+
+// asin(s) for 0 <= s <= 1
+template <typename D>
+inline D arcSine(D s)
+{
+    // asin(s) = pi / 2 - 2 * asin(sqrt((1 - s) / 2)) brings s to [0, 0.5], then
+    // the half angle asin(a) = 2 * asin(a / sqrt(2 + 2 * sqrt(1 - a^2))) to [0, 0.26]
+    const auto large = s > D(0.5);
+    const D a = batchSelect(large, batchSqrt((D(1.0) - s) * D(0.5)), s);
+    const D h = a / batchSqrt(D(2.0) + D(2.0) * batchSqrt(D(1.0) - a * a));
+    const D z = h * h;
+    const D asinA = D(2.0) * (h + h * z * horner(z, asinCoefficients));
+    return batchSelect(large, (D(halfPiHi) - D(2.0) * asinA) + D(halfPiLo), asinA);
+}
+
+// atan2(y, x) including atan2(0, 0) = 0
+template <typename D>
+inline D arcTangent2(D y, D x)
+{
+    const D ay = batchAbs(y);
+    const D ax = batchAbs(x);
+    const auto steep = ay > ax;
+    const D num = batchSelect(steep, ax, ay);
+    const D den = batchSelect(steep, ay, ax);
+    const auto nonZero = den > D(0.0);
+    const D t = batchSelect(nonZero, num / batchSelect(nonZero, den, D(1.0)), D(0.0));
+
+    // atan(t) = pi / 4 + atan((t - 1) / (t + 1)) brings t to [0, tan(pi / 8)], then
+    // the half angle atan(u) = 2 * atan(u / (1 + sqrt(1 + u^2))) to [0, 0.2]
+    const auto above = t > D(tanEighthPi);
+    const D u = batchSelect(above, (t - D(1.0)) / (t + D(1.0)), t);
+    const D v = u / (D(1.0) + batchSqrt(D(1.0) + u * u));
+    const D z = v * v;
+    D angle = D(2.0) * (v + v * z * horner(z, atanCoefficients));
+
+    angle = batchSelect(above, angle + D(M_PI_4), angle);
+    angle = batchSelect(steep, D(M_PI_2) - angle, angle);
+    angle = batchSelect(x < D(0.0), D(M_PI) - angle, angle);
+    return batchSelect(y < D(0.0), -angle, angle);
+}
+
+// exp(x) for |x| <= pi
+template <typename D>
+inline D exponential(D x)
+{
+    // exp(x) = exp(x / 4)^4, with the series on [-pi / 4, pi / 4]
+    const D r = x * D(0.25);
+    D e = D(1.0) + r + r * r * horner(r, expCoefficients);
+    e = e * e;
+    return e * e;
+}
+
+// atanh(s) for |s| <= 0.999
+template <typename D>
+inline D arcTanh(D s)
+{
+    // the half argument atanh(s) = 2 * atanh(s / (1 + sqrt(1 - s^2))), five
+    // times, brings s to [-0.12, 0.12]
+    D h = s;
+    for (int i = 0; i < 5; ++i)
+        h = h / (D(1.0) + batchSqrt((D(1.0) - h) * (D(1.0) + h)));
+    const D z = h * h;
+    return D(32.0) * (h + h * z * horner(z, atanhCoefficients));
+}
+
+// QWebMercator::coordToMercator(), using ln(tan(pi / 4 + lat / 2)) = atanh(sin(lat))
+template <typename D>
+inline void toMercator(D lat, D lng, D *x, D *y)
+{
+    D sinLat(0.0), cosLat(0.0);
+    sinCos(lat * D(M_PI / 180.0), &sinLat, &cosLat);
+    // beyond 0.999 y is clamped anyway
+    sinLat = batchSelect(sinLat > D(0.999), D(0.999), sinLat);
+    sinLat = batchSelect(sinLat < D(-0.999), D(-0.999), sinLat);
+    D my = D(0.5) - arcTanh(sinLat) * D(0.5 / M_PI);
+    my = batchSelect(my < D(0.0), D(0.0), my);
+    *y = batchSelect(my > D(1.0), D(1.0), my);
+    *x = lng * D(1.0 / 360.0) + D(0.5);
+}
+
+// QWebMercator::mercatorToCoord()
+template <typename D>
+inline void fromMercator(D x, D y, D *lat, D *lng)
+{
+    D fy = batchSelect(y < D(0.0), D(0.0), y);
+    fy = batchSelect(fy > D(1.0), D(1.0), fy);
+    const D e = exponential(D(M_PI) * (D(1.0) - D(2.0) * fy));
+    D l = (D(2.0) * arcTangent2(e, D(1.0)) - D(M_PI_2)) * D(180.0 / M_PI);
+    l = batchSelect(fy > D(0.0), l, D(90.0));
+    *lat = batchSelect(fy < D(1.0), l, D(-90.0));
+    *lng = (x - batchFloor(x)) * D(360.0) - D(180.0);
+}
+
+// longitude difference in degrees, wrapped into [-180, 180]
+template <typename D>
+inline D wrappedDelta(D from, D to)
+{
+    D d = to - from;
+    d = batchSelect(d > D(180.0), d - D(360.0), d);
+    return batchSelect(d < D(-180.0), d + D(360.0), d);
+}
+
+// the haversine formula of QGeoCoordinatePrivate::distance(), from degrees and latitude cosines
+template <typename D>
+inline D haversine(D fromLat, D fromLng, D fromCosLat, D toLat, D toLng, D toCosLat)
+{
+    const D halfDegree(M_PI / 360.0);
+    D sinLat(0.0), cosLat(0.0), sinLng(0.0), cosLng(0.0);
+    sinCos((toLat - fromLat) * halfDegree, &sinLat, &cosLat);
+    sinCos(wrappedDelta(fromLng, toLng) * halfDegree, &sinLng, &cosLng);
+
+    D y = sinLat * sinLat + fromCosLat * toCosLat * (sinLng * sinLng);
+    y = batchSelect(y > D(1.0), D(1.0), y);
+    return D(2.0 * qgeocoordinate_EARTH_MEAN_RADIUS * 1000.0) * arcSine(batchSqrt(y));
+}
+
+template <typename D>
+inline D segmentDistance(D fromLat, D fromLng, D toLat, D toLng)
+{
+    const D degree(M_PI / 180.0);
+    return haversine(fromLat, fromLng, cosine(fromLat * degree),
+                     toLat, toLng, cosine(toLat * degree));
+}
+
+// the azimuth of QGeoCoordinate::azimuthTo() in radians, before normalization
+template <typename D>
+inline D azimuth(D fromSinLat, D fromCosLat, D fromLng, D toLat, D toLng)
+{
+    const D degree(M_PI / 180.0);
+    D sinLat(0.0), cosLat(0.0), sinLng(0.0), cosLng(0.0);
+    sinCos(toLat * degree, &sinLat, &cosLat);
+    sinCos(wrappedDelta(fromLng, toLng) * degree, &sinLng, &cosLng);
+
+    const D y = sinLng * cosLat;
+    const D x = fromCosLat * sinLat - fromSinLat * cosLat * cosLng;
+    return arcTangent2(y, x);
+}
+
+} // namespace
+
+void QGeoCoordinateKernels::consecutiveDistances(QGeoCoordinateSpan path, double *out)
+{
+    const int count = path.size() - 1;
+    const QGeoPackedCoordinate *p = path.data();
+    int i = 0;
+
+#ifdef QGEOCOORDINATEKERNELS_SIMD
+    for (; i + Batch::Size <= count; i += Batch::Size) {
+        segmentDistance(Batch::latitudes(p + i), Batch::longitudes(p + i),
+                        Batch::latitudes(p + i + 1), Batch::longitudes(p + i + 1)).store(out + i);
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = segmentDistance(p[i].latitude, p[i].longitude, p[i + 1].latitude, p[i + 1].longitude);
+}
+
+void QGeoCoordinateKernels::distancesFrom(const QGeoPackedCoordinate &origin,
+                                          QGeoCoordinateSpan coordinates, double *out)
+{
+    const int count = coordinates.size();
+    const QGeoPackedCoordinate *p = coordinates.data();
+    const double degree = M_PI / 180.0;
+    const double originCosLat = cosine(origin.latitude * degree);
+    int i = 0;
+
+#ifdef QGEOCOORDINATEKERNELS_SIMD
+    const Batch lat1(origin.latitude);
+    const Batch lng1(origin.longitude);
+    const Batch cosLat1(originCosLat);
+    for (; i + Batch::Size <= count; i += Batch::Size) {
+        const Batch lat2 = Batch::latitudes(p + i);
+        haversine(lat1, lng1, cosLat1, lat2, Batch::longitudes(p + i),
+                  cosine(lat2 * Batch(degree))).store(out + i);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = haversine(origin.latitude, origin.longitude, originCosLat,
+                           p[i].latitude, p[i].longitude, cosine(p[i].latitude * degree));
+    }
+}
+
+void QGeoCoordinateKernels::azimuthsFrom(const QGeoPackedCoordinate &origin,
+                                         QGeoCoordinateSpan coordinates, double *out)
+{
+    const int count = coordinates.size();
+    const QGeoPackedCoordinate *p = coordinates.data();
+    double originSinLat = 0.0;
+    double originCosLat = 0.0;
+    sinCos(origin.latitude * (M_PI / 180.0), &originSinLat, &originCosLat);
+    int i = 0;
+
+#ifdef QGEOCOORDINATEKERNELS_SIMD
+    const Batch sinLat1(originSinLat);
+    const Batch cosLat1(originCosLat);
+    const Batch lng1(origin.longitude);
+    for (; i + Batch::Size <= count; i += Batch::Size) {
+        azimuth(sinLat1, cosLat1, lng1,
+                Batch::latitudes(p + i), Batch::longitudes(p + i)).store(out + i);
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = azimuth(originSinLat, originCosLat, origin.longitude, p[i].latitude, p[i].longitude);
+
+    // same normalization as QGeoCoordinate::azimuthTo()
+    for (i = 0; i < count; ++i) {
+        const double degrees = qRadiansToDegrees(out[i]) + 360.0;
+        double whole;
+        const double fraction = std::modf(degrees, &whole);
+        out[i] = (int(whole + 360) % 360) + fraction;
+    }
+}
+
+void QGeoCoordinateKernels::toMercator(QGeoCoordinateSpan coordinates, double *out)
+{
+    const int count = coordinates.size();
+    const QGeoPackedCoordinate *p = coordinates.data();
+    int i = 0;
+
+#ifdef QGEOCOORDINATEKERNELS_SIMD
+    for (; i + Batch::Size <= count; i += Batch::Size) {
+        Batch x(0.0), y(0.0);
+        ::toMercator(Batch::latitudes(p + i), Batch::longitudes(p + i), &x, &y);
+        Batch::storePairs(x, y, out + 2 * i);
+    }
+#endif
+
+    for (; i < count; ++i)
+        ::toMercator(p[i].latitude, p[i].longitude, out + 2 * i, out + 2 * i + 1);
+}
+
+void QGeoCoordinateKernels::fromMercator(const double *mercator, int count, QGeoPackedCoordinate *out)
+{
+    int i = 0;
+
+#ifdef QGEOCOORDINATEKERNELS_SIMD
+    for (; i + Batch::Size <= count; i += Batch::Size) {
+        Batch x(0.0), y(0.0), lat(0.0), lng(0.0);
+        Batch::loadPairs(mercator + 2 * i, &x, &y);
+        ::fromMercator(x, y, &lat, &lng);
+        double lats[Batch::Size];
+        double lngs[Batch::Size];
+        lat.store(lats);
+        lng.store(lngs);
+        for (int j = 0; j < Batch::Size; ++j)
+            out[i + j] = { lats[j], lngs[j], 0.0 };
+    }
+#endif
+
+    for (; i < count; ++i) {
+        ::fromMercator(mercator[2 * i], mercator[2 * i + 1], &out[i].latitude, &out[i].longitude);
+        out[i].altitude = 0.0;
+    }
+}
+
+void QGeoCoordinateKernels::latitudeRange(QGeoCoordinateSpan coordinates, double *min, double *max)
+{
+    const int count = coordinates.size();
+    const QGeoPackedCoordinate *p = coordinates.data();
+    double lowest = qInf();
+    double highest = -qInf();
+    int i = 0;
+
+#ifdef QGEOCOORDINATEKERNELS_SIMD
+    if (count >= Batch::Size) {
+        Batch low(lowest), high(highest);
+        for (; i + Batch::Size <= count; i += Batch::Size) {
+            const Batch lat = Batch::latitudes(p + i);
+            low = batchSelect(lat < low, lat, low);
+            high = batchSelect(lat > high, lat, high);
+        }
+        double lows[Batch::Size];
+        double highs[Batch::Size];
+        low.store(lows);
+        high.store(highs);
+        for (int j = 0; j < Batch::Size; ++j) {
+            lowest = qMin(lowest, lows[j]);
+            highest = qMax(highest, highs[j]);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        lowest = qMin(lowest, p[i].latitude);
+        highest = qMax(highest, p[i].latitude);
+    }
+    *min = lowest;
+    *max = highest;
+}
+
+void QGeoCoordinateKernels::longitudeSteps(double longitude, QGeoCoordinateSpan coordinates,
+                                           double *out)
+{
+    const int count = coordinates.size();
+    const QGeoPackedCoordinate *p = coordinates.data();
+    if (count == 0)
+        return;
+
+    out[0] = longitudeStep(longitude, p[0].longitude);
+    int i = 1;
+
+#ifdef QGEOCOORDINATEKERNELS_SIMD
+    for (; i + Batch::Size <= count; i += Batch::Size)
+        longitudeStep(Batch::longitudes(p + i - 1), Batch::longitudes(p + i)).store(out + i);
+#endif
+
+    for (; i < count; ++i)
+        out[i] = longitudeStep(p[i - 1].longitude, p[i].longitude);
+}
+
+void QGeoCoordinateKernels::cumulativeLengths(QGeoCoordinateSpan path, double *out)
+{
+    if (path.isEmpty())
+        return;
+
+    out[0] = 0.0;
+    consecutiveDistances(path, out + 1);
+    for (int i = 1; i < path.size(); ++i)
+        out[i] += out[i - 1];
+}
+
+double QGeoCoordinateKernels::length(QGeoCoordinateSpan path)
+{
+    // chunks keep the batch alignment of consecutiveDistances(), so the sum
+    // matches cumulativeLengths() exactly
+    enum { ChunkSize = 64 };
+    double distances[ChunkSize];
+    double len = 0.0;
+    for (int from = 0; from + 1 < path.size(); from += ChunkSize) {
+        const QGeoCoordinateSpan chunk = path.mid(from, ChunkSize + 1);
+        consecutiveDistances(chunk, distances);
+        for (int i = 0; i < chunk.size() - 1; ++i)
+            len += distances[i];
+    }
+    return len;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOCOORDINATEKERNELS_P_H
+#define QGEOCOORDINATEKERNELS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qgeopackedcoordinate_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Array versions of QGeoCoordinate::distanceTo() and azimuthTo() and of the
+    QWebMercator conversions on packed coordinates. Several coordinates are
+    processed at once with AVX2, SSE2 or NEON when the build enables them, and
+    one at a time otherwise. The transcendental functions are evaluated with
+    polynomials, so results agree with the scalar functions to within a few
+    units in the last place rather than exactly. All coordinates have to be
+    valid.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoCoordinateKernels
+{
+public:
+    // out[i] is the distance in meters from path[i] to path[i + 1]; path.size() - 1 values
+    static void consecutiveDistances(QGeoCoordinateSpan path, double *out);
+    // out[i] is the distance in meters from origin to coordinates[i]
+    static void distancesFrom(const QGeoPackedCoordinate &origin, QGeoCoordinateSpan coordinates,
+                              double *out);
+    // out[i] is the azimuth in degrees from origin to coordinates[i]
+    static void azimuthsFrom(const QGeoPackedCoordinate &origin, QGeoCoordinateSpan coordinates,
+                             double *out);
+    // out[i] is the length in meters of the path up to path[i], so out[0] is 0; path.size() values
+    static void cumulativeLengths(QGeoCoordinateSpan path, double *out);
+    // the same as the last value of cumulativeLengths()
+    static double length(QGeoCoordinateSpan path);
+
+    // out[2 * i] and out[2 * i + 1] are the Web Mercator x and y of coordinates[i]
+    static void toMercator(QGeoCoordinateSpan coordinates, double *out);
+    // the inverse, for count pairs of x and y; altitudes are 0 as in QWebMercator
+    static void fromMercator(const double *mercator, int count, QGeoPackedCoordinate *out);
+
+    // the lowest and highest latitude of coordinates, infinities when there are none
+    static void latitudeRange(QGeoCoordinateSpan coordinates, double *min, double *max);
+    // out[i] is the change in longitude to coordinates[i] from the one before it, or from
+    // longitude for the first, taking the shorter way around; coordinates.size() values
+    static void longitudeSteps(double longitude, QGeoCoordinateSpan coordinates, double *out);
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOCOORDINATEKERNELS_P_H
@@ -0,0 +1,402 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeodeadreckoningsource_p.h"
+#include "qlocationutils_p.h"
+
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE
+
+static const double DefaultFixAccuracy = 10;     // meters, for fixes without HorizontalAccuracy
+static const double DefaultFixSpeedAccuracy = 1; // m/s
+static const double DefaultFixDirectionAccuracy = 5; // degrees
+static const double InitialVelocityVariance = 100;   // (m/s)^2, when starting without a speed
+static const double MinimumDirectionSpeed = 0.5;     // m/s, below which there is no direction
+
+static double normalizedHeading(double degrees)
+{
+    degrees = std::fmod(degrees, 360.0);
+    return degrees < 0 ? degrees + 360.0 : degrees;
+}
+
+void QGeoDeadReckoningSource::Axis::predict(double dt, double acceleration, double noise)
+{
+    position += velocity * dt + 0.5 * acceleration * dt * dt;
+    velocity += acceleration * dt;
+
+    const double dt2 = dt * dt;
+    pp += 2 * dt * pv + dt2 * vv + noise * dt2 * dt / 3;
+    pv += dt * vv + noise * dt2 / 2;
+    vv += noise * dt;
+}
+
+void QGeoDeadReckoningSource::Axis::updatePosition(double measured, double variance)
+{
+    const double s = pp + variance;
+    if (s <= 0)
+        return;
+    const double kp = pp / s;
+    const double kv = pv / s;
+    const double innovation = measured - position;
+    position += kp * innovation;
+    velocity += kv * innovation;
+    vv -= kv * pv;
+    pv *= 1 - kp;
+    pp *= 1 - kp;
+}
+
+void QGeoDeadReckoningSource::Axis::updateVelocity(double measured, double variance)
+{
+    const double s = vv + variance;
+    if (s <= 0)
+        return;
+    const double kp = pv / s;
+    const double kv = vv / s;
+    const double innovation = measured - velocity;
+    position += kp * innovation;
+    velocity += kv * innovation;
+    pp -= kp * pv;
+    pv *= 1 - kv;
+    vv *= 1 - kv;
+}
+
+QGeoDeadReckoningSource::QGeoDeadReckoningSource(QGeoPositionInfoSource *source,
+                                                 QObject *parent)
+    : QGeoPositionInfoSource(parent), m_source(source)
+{
+    m_clock.start();
+    connect(&m_timer, &QTimer::timeout, this, &QGeoDeadReckoningSource::tick);
+    if (!source)
+        return;
+
+    connect(source, &QGeoPositionInfoSource::positionUpdated,
+            this, &QGeoDeadReckoningSource::fixReceived);
+    connect(source, &QGeoPositionInfoSource::updateTimeout, this, [this]() {
+        // gaps are filled while updates run, only a requested update times out
+        if (m_requested && !m_timer.isActive()) {
+            m_requested = false;
+            emit updateTimeout();
+        }
+    });
+    connect(source, QOverload<QGeoPositionInfoSource::Error>::of(&QGeoPositionInfoSource::error),
+            this, QOverload<QGeoPositionInfoSource::Error>::of(&QGeoPositionInfoSource::error));
+    connect(source, &QGeoPositionInfoSource::supportedPositioningMethodsChanged,
+            this, &QGeoPositionInfoSource::supportedPositioningMethodsChanged);
+}
+
+QGeoDeadReckoningSource::~QGeoDeadReckoningSource()
+{
+}
+
+void QGeoDeadReckoningSource::setUpdateInterval(int msec)
+{
+    QGeoPositionInfoSource::setUpdateInterval(msec);
+    if (m_source)
+        m_source->setUpdateInterval(msec);
+    if (m_timer.isActive())
+        m_timer.start(interval());
+}
+
+QGeoPositionInfo QGeoDeadReckoningSource::lastKnownPosition(bool fromSatellitePositioningMethodsOnly) const
+{
+    if (m_lastPosition.isValid() || !m_source)
+        return m_lastPosition;
+    return m_source->lastKnownPosition(fromSatellitePositioningMethodsOnly);
+}
+
+QGeoPositionInfoSource::PositioningMethods QGeoDeadReckoningSource::supportedPositioningMethods() const
+{
+    return m_source ? m_source->supportedPositioningMethods() : NoPositioningMethods;
+}
+
+int QGeoDeadReckoningSource::minimumUpdateInterval() const
+{
+    // predictions do not wait for the source
+    return 1;
+}
+
+QGeoPositionInfoSource::Error QGeoDeadReckoningSource::error() const
+{
+    return m_source ? m_source->error() : ClosedError;
+}
+
+void QGeoDeadReckoningSource::startUpdates()
+{
+    if (m_timer.isActive())
+        return;
+    if (m_source)
+        m_source->startUpdates();
+    m_timer.start(interval());
+}
+
+void QGeoDeadReckoningSource::stopUpdates()
+{
+    m_timer.stop();
+    if (m_source)
+        m_source->stopUpdates();
+}
+
+void QGeoDeadReckoningSource::requestUpdate(int timeout)
+{
+    if (m_predicting) {
+        QTimer::singleShot(0, this, [this]() {
+            if (!m_predicting)
+                return;
+            predict();
+            m_lastPosition = estimate();
+            emit positionUpdated(m_lastPosition);
+        });
+        return;
+    }
+
+    if (!m_source) {
+        QTimer::singleShot(0, this, &QGeoDeadReckoningSource::updateTimeout);
+        return;
+    }
+    m_requested = true;
+    m_source->requestUpdate(timeout);
+}
+
+void QGeoDeadReckoningSource::feedSpeed(qreal metersPerSecond, qreal accuracy)
+{
+    predict();
+    m_speed = metersPerSecond;
+    m_speedVariance = accuracy * accuracy;
+    if (!m_predicting)
+        return;
+
+    if (!qIsNaN(m_heading)) {
+        feedVelocity(m_speed, m_speedVariance, m_heading, m_headingVariance);
+    } else if (qHypot(m_east.velocity, m_north.velocity) >= MinimumDirectionSpeed) {
+        const double direction = QLocationUtils::degrees(std::atan2(m_east.velocity,
+                                                                    m_north.velocity));
+        feedVelocity(m_speed, m_speedVariance, direction, 0);
+    }
+}
+
+void QGeoDeadReckoningSource::feedHeading(qreal degrees, qreal accuracy)
+{
+    predict();
+    m_heading = normalizedHeading(degrees);
+    m_headingVariance = accuracy * accuracy;
+    if (m_predicting && !qIsNaN(m_speed))
+        feedVelocity(m_speed, m_speedVariance, m_heading, m_headingVariance);
+}
+
+void QGeoDeadReckoningSource::feedTurnRate(qreal degreesPerSecond)
+{
+    predict();
+    m_turnRate = degreesPerSecond;
+}
+
+void QGeoDeadReckoningSource::feedAcceleration(qreal forward)
+{
+    predict();
+    m_acceleration = forward;
+}
+
+void QGeoDeadReckoningSource::fixReceived(const QGeoPositionInfo &fix)
+{
+    if (!fix.isValid())
+        return;
+
+    const double accuracy = fix.hasAttribute(QGeoPositionInfo::HorizontalAccuracy)
+            ? fix.attribute(QGeoPositionInfo::HorizontalAccuracy) : DefaultFixAccuracy;
+    const double variance = accuracy * accuracy;
+    const QGeoCoordinate coordinate = fix.coordinate();
+
+    if (!m_predicting) {
+        // nothing to go on before the first fix, or after a timeout
+        m_origin = coordinate;
+        m_east = Axis();
+        m_north = Axis();
+        m_east.pp = m_north.pp = variance;
+        m_east.vv = m_north.vv = InitialVelocityVariance;
+        m_stateTime = m_clock.elapsed();
+    } else {
+        predict();
+        const double radius = QLocationUtils::earthMeanRadius();
+        const double dLongitude = QLocationUtils::wrapLong(coordinate.longitude()
+                                                           - m_origin.longitude());
+        const double cosLatitude = qMax(1e-6,
+                                        std::cos(QLocationUtils::radians(m_origin.latitude())));
+        m_north.updatePosition(QLocationUtils::radians(coordinate.latitude() - m_origin.latitude())
+                               * radius, variance);
+        m_east.updatePosition(QLocationUtils::radians(dLongitude) * radius * cosLatitude, variance);
+    }
+
+    if (fix.hasAttribute(QGeoPositionInfo::GroundSpeed)) {
+        const double speed = fix.attribute(QGeoPositionInfo::GroundSpeed);
+        const double speedVariance = DefaultFixSpeedAccuracy * DefaultFixSpeedAccuracy;
+        if (fix.hasAttribute(QGeoPositionInfo::Direction)) {
+            feedVelocity(speed, speedVariance, fix.attribute(QGeoPositionInfo::Direction),
+                         DefaultFixDirectionAccuracy * DefaultFixDirectionAccuracy);
+        } else if (!qIsNaN(m_heading)) {
+            feedVelocity(speed, speedVariance, m_heading, m_headingVariance);
+        }
+    }
+
+    recenter();
+    m_fix = fix;
+    m_fixTime = m_stateTime;
+    m_predicting = true;
+
+    if (m_requested && !m_timer.isActive()) {
+        m_requested = false;
+        m_lastPosition = estimate();
+        emit positionUpdated(m_lastPosition);
+    }
+}
+
+/*
+    Advances the state to the current time.
+*/
+void QGeoDeadReckoningSource::predict()
+{
+    const qint64 now = m_clock.elapsed();
+    const double dt = (now - m_stateTime) / 1000.0;
+    m_stateTime = now;
+    if (!m_predicting || dt <= 0)
+        return;
+
+    // the gyroscope turns the heading and the velocity with it
+    const double turn = QLocationUtils::radians(m_turnRate * dt);
+    if (turn != 0) {
+        if (!qIsNaN(m_heading))
+            m_heading = normalizedHeading(m_heading + m_turnRate * dt);
+        const double east = m_east.velocity;
+        const double north = m_north.velocity;
+        m_east.velocity = east * std::cos(turn) + north * std::sin(turn);
+        m_north.velocity = north * std::cos(turn) - east * std::sin(turn);
+    }
+
+    double heading = m_heading;
+    if (qIsNaN(heading) && qHypot(m_east.velocity, m_north.velocity) >= MinimumDirectionSpeed)
+        heading = QLocationUtils::degrees(std::atan2(m_east.velocity, m_north.velocity));
+    double eastAcceleration = 0;
+    double northAcceleration = 0;
+    if (!qIsNaN(heading)) {
+        eastAcceleration = m_acceleration * std::sin(QLocationUtils::radians(heading));
+        northAcceleration = m_acceleration * std::cos(QLocationUtils::radians(heading));
+    }
+
+    m_east.predict(dt, eastAcceleration, m_accelerationNoise);
+    m_north.predict(dt, northAcceleration, m_accelerationNoise);
+}
+
+/*
+    Moves the origin of the east-north plane to the estimated position, which
+    keeps the plane approximation accurate as the device moves.
+*/
+void QGeoDeadReckoningSource::recenter()
+{
+    const double altitude = m_origin.altitude();
+    m_origin = estimate().coordinate();
+    m_origin.setAltitude(altitude);
+    m_east.position = 0;
+    m_north.position = 0;
+}
+
+void QGeoDeadReckoningSource::feedVelocity(double speed, double speedVariance, double heading,
+                                           double headingVariance)
+{
+    const double radians = QLocationUtils::radians(heading);
+    const double sine = std::sin(radians);
+    const double cosine = std::cos(radians);
+    // the error of the speed is along the track, the one of the heading across it
+    const double headingError = QLocationUtils::radians(std::sqrt(headingVariance));
+    const double acrossVariance = speed * speed * headingError * headingError;
+    m_east.updateVelocity(speed * sine,
+                          speedVariance * sine * sine + acrossVariance * cosine * cosine);
+    m_north.updateVelocity(speed * cosine,
+                           speedVariance * cosine * cosine + acrossVariance * sine * sine);
+}
+
+QGeoPositionInfo QGeoDeadReckoningSource::estimate() const
+{
+    const double radius = QLocationUtils::earthMeanRadius();
+    const double cosLatitude = qMax(1e-6, std::cos(QLocationUtils::radians(m_origin.latitude())));
+    QGeoCoordinate coordinate(
+            qBound(-90.0, m_origin.latitude()
+                   + QLocationUtils::degrees(m_north.position / radius), 90.0),
+            QLocationUtils::wrapLong(m_origin.longitude()
+                   + QLocationUtils::degrees(m_east.position / (radius * cosLatitude))));
+    if (m_fix.coordinate().type() == QGeoCoordinate::Coordinate3D)
+        coordinate.setAltitude(m_fix.coordinate().altitude());
+
+    QGeoPositionInfo position(coordinate, QDateTime::currentDateTimeUtc());
+    position.setAttribute(QGeoPositionInfo::HorizontalAccuracy,
+                          std::sqrt(m_east.pp + m_north.pp));
+    if (m_fix.hasAttribute(QGeoPositionInfo::VerticalAccuracy)) {
+        position.setAttribute(QGeoPositionInfo::VerticalAccuracy,
+                              m_fix.attribute(QGeoPositionInfo::VerticalAccuracy));
+    }
+    const double speed = qHypot(m_east.velocity, m_north.velocity);
+    position.setAttribute(QGeoPositionInfo::GroundSpeed, speed);
+    if (speed >= MinimumDirectionSpeed) {
+        position.setAttribute(QGeoPositionInfo::Direction, normalizedHeading(
+                QLocationUtils::degrees(std::atan2(m_east.velocity, m_north.velocity))));
+    }
+    return position;
+}
+
+void QGeoDeadReckoningSource::tick()
+{
+    if (!m_predicting)
+        return;
+
+    if (m_clock.elapsed() - m_fixTime > m_maximumPredictionTime) {
+        m_predicting = false;
+        emit updateTimeout();
+        return;
+    }
+
+    predict();
+    m_lastPosition = estimate();
+    emit positionUpdated(m_lastPosition);
+}
+
+int QGeoDeadReckoningSource::interval() const
+{
+    return updateInterval() > 0 ? updateInterval() : 1000;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEODEADRECKONINGSOURCE_P_H
+#define QGEODEADRECKONINGSOURCE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/qgeopositioninfosource.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/qnumeric.h>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Wraps a position source and fills its gaps by dead reckoning. The fixes
+    of the source, and the speed, heading, turn rate and acceleration fed in
+    from other sensors, update a Kalman filter with a constant velocity
+    model along each of the east and north axes. Positions predicted by the
+    filter are emitted every updateInterval, with a HorizontalAccuracy that
+    grows while there are no fixes.
+
+    Predictions stop with an updateTimeout() once there has been no fix for
+    maximumPredictionTime, and resume with the next fix.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoDeadReckoningSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+public:
+    // The source is not owned
+    explicit QGeoDeadReckoningSource(QGeoPositionInfoSource *source, QObject *parent = nullptr);
+    ~QGeoDeadReckoningSource();
+
+    QGeoPositionInfoSource *source() const { return m_source; }
+
+    void setMaximumPredictionTime(int msec) { m_maximumPredictionTime = qMax(0, msec); }
+    int maximumPredictionTime() const { return m_maximumPredictionTime; }
+
+    // The spectral density of the unknown accelerations, in m^2/s^3
+    void setAccelerationNoise(qreal noise) { m_accelerationNoise = qMax<qreal>(0, noise); }
+    qreal accelerationNoise() const { return m_accelerationNoise; }
+
+    void setUpdateInterval(int msec) override;
+    QGeoPositionInfo lastKnownPosition(bool fromSatellitePositioningMethodsOnly = false) const override;
+    PositioningMethods supportedPositioningMethods() const override;
+    int minimumUpdateInterval() const override;
+    Error error() const override;
+
+public Q_SLOTS:
+    void startUpdates() override;
+    void stopUpdates() override;
+    void requestUpdate(int timeout = 0) override;
+
+    // Accuracies are standard deviations, in m/s and degrees
+    void feedSpeed(qreal metersPerSecond, qreal accuracy = 0.5);
+    void feedHeading(qreal degrees, qreal accuracy = 5);
+    // Gyroscope input, positive clockwise; turns the heading between feedHeading() calls
+    void feedTurnRate(qreal degreesPerSecond);
+    // Accelerometer input along the heading, in m/s^2
+    void feedAcceleration(qreal forward);
+
+private:
+    // One axis of the local east-north plane
+    struct Axis
+    {
+        double position = 0;
+        double velocity = 0;
+        double pp = 0; // covariance of position and velocity
+        double pv = 0;
+        double vv = 0;
+
+        void predict(double dt, double acceleration, double noise);
+        void updatePosition(double measured, double variance);
+        void updateVelocity(double measured, double variance);
+    };
+
+    void fixReceived(const QGeoPositionInfo &fix);
+    void predict();
+    void recenter();
+    void feedVelocity(double speed, double speedVariance, double heading, double headingVariance);
+    QGeoPositionInfo estimate() const;
+    void tick();
+    int interval() const;
+
+    QPointer<QGeoPositionInfoSource> m_source;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    bool m_requested = false;
+
+    Axis m_east;
+    Axis m_north;
+    QGeoCoordinate m_origin; // of the east-north plane, invalid before the first fix
+    qint64 m_stateTime = 0;  // m_clock time of the state
+    qint64 m_fixTime = 0;    // m_clock time of the latest fix
+    QGeoPositionInfo m_fix;
+    bool m_predicting = false;
+
+    // from the sensors, NaN until fed
+    double m_speed = qQNaN();
+    double m_speedVariance = 0;
+    double m_heading = qQNaN(); // degrees
+    double m_headingVariance = 0;
+    double m_turnRate = 0;
+    double m_acceleration = 0;
+
+    int m_maximumPredictionTime = 30000;
+    qreal m_accelerationNoise = 0.5;
+    QGeoPositionInfo m_lastPosition;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEODEADRECKONINGSOURCE_P_H
@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOPACKEDCOORDINATE_P_H
+#define QGEOPACKEDCOORDINATE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/qgeocoordinate.h>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Plain value storage for the coordinates of QGeoPath and QGeoPolygon.
+    Unlike QGeoCoordinate, which holds a pointer to its own heap allocated
+    private, an array of these is a single contiguous block of doubles.
+    Only valid coordinates are stored, so conversions in both directions
+    are lossless.
+*/
+struct QGeoPackedCoordinate
+{
+    double latitude;
+    double longitude;
+    double altitude;
+
+    static QGeoPackedCoordinate fromCoordinate(const QGeoCoordinate &coordinate)
+    {
+        return { coordinate.latitude(), coordinate.longitude(), coordinate.altitude() };
+    }
+
+    QGeoCoordinate toCoordinate() const
+    {
+        return QGeoCoordinate(latitude, longitude, altitude);
+    }
+
+    // same semantics as QGeoCoordinate::operator==()
+    bool operator==(const QGeoPackedCoordinate &other) const
+    {
+        const bool latEqual = (qIsNaN(latitude) && qIsNaN(other.latitude))
+                || qFuzzyCompare(latitude, other.latitude);
+        const bool lngEqual = (!qIsNaN(latitude) && (latitude == 90.0 || latitude == -90.0))
+                || (qIsNaN(longitude) && qIsNaN(other.longitude))
+                || qFuzzyCompare(longitude, other.longitude);
+        const bool altEqual = (qIsNaN(altitude) && qIsNaN(other.altitude))
+                || qFuzzyCompare(altitude, other.altitude);
+        return latEqual && lngEqual && altEqual;
+    }
+    bool operator!=(const QGeoPackedCoordinate &other) const { return !operator==(other); }
+};
+Q_DECLARE_TYPEINFO(QGeoPackedCoordinate, Q_PRIMITIVE_TYPE);
+
+typedef QVector<QGeoPackedCoordinate> QGeoPackedCoordinates;
+
+/*
+    Non-owning view over contiguous packed coordinates, for code that
+    iterates over the vertices of a shape without going through
+    QList<QGeoCoordinate>. The view is invalidated by any change to the
+    underlying storage.
+*/
+class QGeoCoordinateSpan
+{
+public:
+    QGeoCoordinateSpan() = default;
+    QGeoCoordinateSpan(const QGeoPackedCoordinate *data, int size)
+        : m_data(data), m_size(size) {}
+    QGeoCoordinateSpan(const QGeoPackedCoordinates &coordinates)
+        : m_data(coordinates.constData()), m_size(coordinates.size()) {}
+
+    const QGeoPackedCoordinate *data() const { return m_data; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    const QGeoPackedCoordinate &at(int i) const { Q_ASSERT(i >= 0 && i < m_size); return m_data[i]; }
+    const QGeoPackedCoordinate &operator[](int i) const { return at(i); }
+    const QGeoPackedCoordinate &first() const { return at(0); }
+    const QGeoPackedCoordinate &last() const { return at(m_size - 1); }
+
+    const QGeoPackedCoordinate *begin() const { return m_data; }
+    const QGeoPackedCoordinate *end() const { return m_data + m_size; }
+
+    QGeoCoordinateSpan mid(int pos, int length = -1) const
+    {
+        pos = qBound(0, pos, m_size);
+        if (length < 0 || length > m_size - pos)
+            length = m_size - pos;
+        return QGeoCoordinateSpan(m_data + pos, length);
+    }
+
+private:
+    const QGeoPackedCoordinate *m_data = nullptr;
+    int m_size = 0;
+};
+
+inline QGeoPackedCoordinates qPackCoordinates(const QList<QGeoCoordinate> &coordinates)
+{
+    QGeoPackedCoordinates packed;
+    packed.reserve(coordinates.size());
+    for (const QGeoCoordinate &c : coordinates)
+        packed.append(QGeoPackedCoordinate::fromCoordinate(c));
+    return packed;
+}
+
+inline QList<QGeoCoordinate> qUnpackCoordinates(QGeoCoordinateSpan coordinates)
+{
+    QList<QGeoCoordinate> list;
+    list.reserve(coordinates.size());
+    for (const QGeoPackedCoordinate &c : coordinates)
+        list.append(c.toCoordinate());
+    return list;
+}
+
+QT_END_NAMESPACE
+
+#endif // QGEOPACKEDCOORDINATE_P_H
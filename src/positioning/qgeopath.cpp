@@ -42,12 +42,18 @@
 #include "qgeopath_p.h"
 
 #include "qgeocoordinate.h"
+#include "qgeocoordinate_p.h"
+#include "qgeocoordinatekernels_p.h"
 #include "qnumeric.h"
 #include "qlocationutils_p.h"
 #include "qwebmercator_p.h"
 
 #include "qdoublevector2d_p.h"
 #include "qdoublevector3d_p.h"
+
+#include <algorithm>
+#include <cmath>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -234,8 +240,9 @@ QVariantList QGeoPath::variantPath() const
 {
     Q_D(const QGeoPath);
     QVariantList p;
-    for (const auto &c: d->path())
-        p << QVariant::fromValue(c);
+    p.reserve(d->size());
+    for (const QGeoPackedCoordinate &c: d->vertices())
+        p << QVariant::fromValue(c.toCoordinate());
     return p;
 }
 
@@ -303,6 +310,47 @@ double QGeoPath::length(int indexFrom, int indexTo) const
     return d->length(indexFrom, indexTo);
 }
 
+/*!
+    Returns the coordinate lying \a distance meters along the path from its first element,
+    following the same shortest paths between adjacent points as \l length().
+
+    Distances less than zero give the first element and distances beyond the end of the path
+    give the last one. An invalid coordinate is returned if the path is empty.
+
+    \since 5.15
+    \sa length()
+*/
+QGeoCoordinate QGeoPath::coordinateAtDistance(double distance) const
+{
+    Q_D(const QGeoPath);
+    return d->coordinateAtDistance(distance);
+}
+
+/*!
+    Returns the point of the path closest to \a coordinate.
+
+    As for \l contains(), the segments of the path are taken as straight lines in the Web
+    Mercator projection. The segments are indexed the first time this is called after the path
+    has been modified, so that repeated queries on a long path take logarithmic time.
+
+    If \a segmentIndex is not null, it is set to the index of the first element of the
+    segment containing the returned point. If \a distanceAlongPath is not null, it is set to
+    the distance in meters from the first element of the path to the returned point, as
+    given by \l length().
+
+    An invalid coordinate is returned if the path is empty or \a coordinate is not valid;
+    \a segmentIndex is then set to -1 and \a distanceAlongPath to NaN.
+
+    \since 5.15
+    \sa coordinateAtDistance()
+*/
+QGeoCoordinate QGeoPath::closestPoint(const QGeoCoordinate &coordinate, int *segmentIndex,
+                                      double *distanceAlongPath) const
+{
+    Q_D(const QGeoPath);
+    return d->closestPoint(coordinate, segmentIndex, distanceAlongPath);
+}
+
 /*!
     Returns the number of elements in the path.
 
@@ -400,6 +448,90 @@ QString QGeoPath::toString() const
  *
 *******************************************************************************/
 
+void QGeoPathBounds::add(QGeoCoordinateSpan vertices)
+{
+    if (vertices.isEmpty())
+        return;
+
+    if (m_count == 0) {
+        const double longitude = vertices.first().longitude;
+        m_lastLongitude = m_x = m_minX = m_maxX = longitude;
+        m_westLongitude = m_eastLongitude = longitude;
+    }
+    double minLatitude, maxLatitude;
+    QGeoCoordinateKernels::latitudeRange(vertices, &minLatitude, &maxLatitude);
+    m_minLatitude = qMin(m_minLatitude, minLatitude);
+    m_maxLatitude = qMax(m_maxLatitude, maxLatitude);
+
+    // the steps are independent of each other, only their running sum is not
+    enum { ChunkSize = 64 };
+    double steps[ChunkSize];
+    double x = m_x;
+    double minX = m_minX;
+    double maxX = m_maxX;
+    for (int from = 0; from < vertices.size(); from += ChunkSize) {
+        const QGeoCoordinateSpan chunk = vertices.mid(from, ChunkSize);
+        QGeoCoordinateKernels::longitudeSteps(m_lastLongitude, chunk, steps);
+        for (int i = 0; i < chunk.size(); ++i) {
+            x += steps[i];
+            if (x < minX) {
+                minX = x;
+                m_westLongitude = chunk.at(i).longitude;
+            } else if (x > maxX) {
+                maxX = x;
+                m_eastLongitude = chunk.at(i).longitude;
+            }
+        }
+        m_lastLongitude = chunk.last().longitude;
+    }
+    m_x = x;
+    m_minX = minX;
+    m_maxX = maxX;
+    m_count += vertices.size();
+}
+
+void QGeoPathBounds::translate(double degreesLatitude, double degreesLongitude)
+{
+    if (isEmpty())
+        return;
+    m_minLatitude += degreesLatitude;
+    m_maxLatitude += degreesLatitude;
+    m_x += degreesLongitude;
+    m_minX += degreesLongitude;
+    m_maxX += degreesLongitude;
+    m_lastLongitude = QLocationUtils::wrapLong(m_lastLongitude + degreesLongitude);
+    m_westLongitude = QLocationUtils::wrapLong(m_westLongitude + degreesLongitude);
+    m_eastLongitude = QLocationUtils::wrapLong(m_eastLongitude + degreesLongitude);
+}
+
+QGeoRectangle QGeoPathBounds::rectangle() const
+{
+    if (isEmpty())
+        return QGeoRectangle();
+    return QGeoRectangle(QGeoCoordinate(m_maxLatitude, m_westLongitude),
+                         QGeoCoordinate(m_minLatitude, m_eastLongitude));
+}
+
+QGeoRectangle QGeoPathBounds::rectangle(QGeoCoordinateSpan vertices)
+{
+    QGeoPathBounds bounds;
+    bounds.add(vertices);
+    return bounds.rectangle();
+}
+
+static QGeoCoordinate qgeopath_interpolate(const QGeoPackedCoordinate &from,
+                                           const QGeoPackedCoordinate &to, double fraction)
+{
+    const QGeoCoordinate a = from.toCoordinate();
+    const QGeoCoordinate b = to.toCoordinate();
+    if (fraction <= 0.0)
+        return a;
+    if (fraction >= 1.0)
+        return b;
+    const double up = qIsNaN(b.altitude()) ? 0.0 : (b.altitude() - a.altitude()) * fraction;
+    return a.atDistanceAndAzimuth(a.distanceTo(b) * fraction, a.azimuthTo(b), up);
+}
+
 QGeoPathPrivate::QGeoPathPrivate()
 :   QGeoShapePrivate(QGeoShape::PathType)
 {
@@ -430,7 +562,7 @@ bool QGeoPathPrivate::isValid() const
 
 bool QGeoPathPrivate::isEmpty() const
 {
-    return path().isEmpty(); // this should perhaps return geometric emptiness, less than 2 points for line, or empty polygon for polygons
+    return m_path.isEmpty(); // this should perhaps return geometric emptiness, less than 2 points for line, or empty polygon for polygons
 }
 
 QGeoCoordinate QGeoPathPrivate::center() const
@@ -456,9 +588,103 @@ bool QGeoPathPrivate::operator==(const QGeoShapePrivate &other) const
     return m_width == otherPath.m_width && m_path == otherPath.m_path;
 }
 
+void QGeoPathPrivate::freeze()
+{
+    if (m_bboxDirty)
+        computeBoundingBox();
+    path();
+    updateSegmentIndex();
+}
+
 const QList<QGeoCoordinate> &QGeoPathPrivate::path() const
 {
-    return m_path;
+    QMutexLocker locker(&m_cacheMutex.mutex);
+    if (!m_pathCacheValid) {
+        m_pathCache = qUnpackCoordinates(m_path);
+        m_pathCacheValid = true;
+    }
+    return m_pathCache;
+}
+
+QList<QDoubleVector2D> QGeoPathPrivate::mercatorVertices() const
+{
+    QMutexLocker cacheLocker(&m_cacheMutex.mutex);
+    if (!m_mercator)
+        m_mercator = new QGeoPathMercatorCache;
+    QMutexLocker locker(&m_mercator->mutex);
+    if (!m_mercator->valid) {
+        m_mercator->vertices = QWebMercator::coordToMercator(vertices());
+        m_mercator->valid = true;
+    }
+    return m_mercator->vertices;
+}
+
+void QGeoPathPrivate::shareVertices(const QGeoPathPrivate &other)
+{
+    m_path = other.m_path;
+    invalidatePathCache();
+    QMutexLocker locker(&other.m_cacheMutex.mutex);
+    if (!other.m_mercator)
+        other.m_mercator = new QGeoPathMercatorCache;
+    m_mercator = other.m_mercator;
+    locker.unlock();
+    markDirty();
+}
+
+void QGeoPathPrivate::invalidateAppendedPathCache()
+{
+    m_pathCacheValid = false;
+    m_pathCache.clear();
+    // Projects the appended vertex only, unless the projection is shared or was never built
+    if (!m_mercator || m_mercator->ref.loadRelaxed() != 1 || !m_mercator->valid
+            || m_mercator->vertices.size() != m_path.size() - 1) {
+        invalidateMercatorCache();
+        return;
+    }
+    double mercator[2];
+    QWebMercator::coordToMercator(vertices().mid(m_path.size() - 1), mercator);
+    m_mercator->vertices.append(QDoubleVector2D(mercator[0], mercator[1]));
+}
+
+void QGeoPathPrivate::invalidateTailPathCache(int first)
+{
+    m_pathCacheValid = false;
+    m_pathCache.clear();
+    m_segmentIndex.clear();
+    if (!m_mercator)
+        return;
+
+    QGeoPathMercatorCache *cache = m_mercator.data();
+    QMutexLocker locker(&cache->mutex);
+    if (!cache->valid || cache->vertices.size() < first) {
+        locker.unlock();
+        invalidateMercatorCache();
+        return;
+    }
+    const QList<QDoubleVector2D> tail = QWebMercator::coordToMercator(vertices().mid(first));
+    if (cache->ref.loadRelaxed() == 1) {
+        cache->vertices.erase(cache->vertices.begin() + first, cache->vertices.end());
+        cache->vertices += tail;
+        return;
+    }
+    // the other copies keep the old projection
+    QGeoPathMercatorCache *detached = new QGeoPathMercatorCache;
+    detached->vertices = cache->vertices.mid(0, first) + tail;
+    detached->valid = true;
+    locker.unlock();
+    m_mercator = detached;
+}
+
+void QGeoPathPrivate::invalidateMercatorCache()
+{
+    if (!m_mercator)
+        return;
+    if (m_mercator->ref.loadRelaxed() == 1) {
+        m_mercator->vertices.clear();
+        m_mercator->valid = false;
+    } else {
+        m_mercator = new QGeoPathMercatorCache; // leaves the projection to the other copies
+    }
 }
 
 bool QGeoPathPrivate::lineContains(const QGeoCoordinate &coordinate) const
@@ -482,8 +708,10 @@ bool QGeoPathPrivate::lineContains(const QGeoCoordinate &coordinate) const
 
     if (!m_path.size())
         return false;
-    else if (m_path.size() == 1)
-        return (m_path[0].distanceTo(coordinate) <= lineRadius);
+
+    const QGeoCoordinate first = m_path.first().toCoordinate();
+    if (m_path.size() == 1)
+        return (first.distanceTo(coordinate) <= lineRadius);
 
     QDoubleVector2D p = QWebMercator::coordToMercator(coordinate);
     if (p.x() < m_leftBoundWrapped)
@@ -492,12 +720,12 @@ bool QGeoPathPrivate::lineContains(const QGeoCoordinate &coordinate) const
     QDoubleVector2D a;
     QDoubleVector2D b;
     if (m_path.size()) {
-        a = QWebMercator::coordToMercator(m_path[0]);
+        a = QWebMercator::coordToMercator(m_path[0].latitude, m_path[0].longitude);
         if (a.x() < m_leftBoundWrapped)
             a.setX(a.x() + m_leftBoundWrapped);  // unwrap X
     }
     for (int i = 1; i < m_path.size(); i++) {
-        b = QWebMercator::coordToMercator(m_path[i]);
+        b = QWebMercator::coordToMercator(m_path[i].latitude, m_path[i].longitude);
         if (b.x() < m_leftBoundWrapped)
             b.setX(b.x() + m_leftBoundWrapped);  // unwrap X
         if (b == a)
@@ -528,7 +756,7 @@ bool QGeoPathPrivate::lineContains(const QGeoCoordinate &coordinate) const
 
     // Last check if the coordinate is on the left of leftBoundMercator, but close enough to
     // m_path[0]
-    return (m_path[0].distanceTo(coordinate) <= lineRadius);
+    return (first.distanceTo(coordinate) <= lineRadius);
 }
 
 bool QGeoPathPrivate::contains(const QGeoCoordinate &coordinate) const
@@ -550,22 +778,87 @@ void QGeoPathPrivate::setWidth(const qreal &width)
 
 double QGeoPathPrivate::length(int indexFrom, int indexTo) const
 {
-    if (path().isEmpty())
+    if (m_path.isEmpty())
         return 0.0;
 
     bool wrap = indexTo == -1;
-    if (indexTo < 0 || indexTo >= path().size())
-        indexTo = path().size() - 1;
+    if (indexTo < 0 || indexTo >= m_path.size())
+        indexTo = m_path.size() - 1;
     double len = 0.0;
     // TODO: consider calculating the length of the actual rhumb line segments
     // instead of the shortest path from A to B.
-    for (int i = indexFrom; i < indexTo; i++)
-        len += m_path[i].distanceTo(m_path[i+1]);
+    if (indexFrom < indexTo)
+        len = QGeoCoordinateKernels::length(vertices().mid(indexFrom, indexTo - indexFrom + 1));
     if (wrap)
-        len += m_path.last().distanceTo(m_path.first());
+        len += QGeoCoordinatePrivate::distance(m_path.last().latitude, m_path.last().longitude,
+                                               m_path.first().latitude, m_path.first().longitude);
     return len;
 }
 
+QGeoCoordinate QGeoPathPrivate::coordinateAtDistance(double distance) const
+{
+    if (m_path.isEmpty() || qIsNaN(distance))
+        return QGeoCoordinate();
+    if (distance <= 0.0)
+        return m_path.first().toCoordinate();
+
+    double len = 0.0;
+    for (int i = 1; i < m_path.size(); i++) {
+        const QGeoPackedCoordinate &from = m_path.at(i - 1);
+        const QGeoPackedCoordinate &to = m_path.at(i);
+        const double segment = QGeoCoordinatePrivate::distance(from.latitude, from.longitude,
+                                                               to.latitude, to.longitude);
+        if (len + segment > distance)
+            return qgeopath_interpolate(from, to, (distance - len) / segment);
+        len += segment;
+    }
+    return m_path.last().toCoordinate();
+}
+
+void QGeoPathPrivate::updateSegmentIndex() const
+{
+    // Once complete, the index is only read until the path is modified
+    QMutexLocker locker(&m_cacheMutex.mutex);
+    for (int i = m_segmentIndex.size(); i < m_path.size(); ++i)
+        m_segmentIndex.append(QWebMercator::coordToMercator(m_path.at(i).latitude, m_path.at(i).longitude));
+}
+
+QGeoCoordinate QGeoPathPrivate::closestPoint(const QGeoCoordinate &coordinate, int *segmentIndex,
+                                             double *distanceAlongPath) const
+{
+    if (segmentIndex)
+        *segmentIndex = -1;
+    if (distanceAlongPath)
+        *distanceAlongPath = qQNaN();
+    if (m_path.isEmpty() || !coordinate.isValid())
+        return QGeoCoordinate();
+
+    updateSegmentIndex();
+
+    QGeoCoordinate closest = m_path.first().toCoordinate();
+    double fraction = 0.0;
+    const int segment = qMax(m_segmentIndex.closestSegment(QWebMercator::coordToMercator(coordinate),
+                                                           &fraction), 0);
+    if (m_path.size() > 1) {
+        const QDoubleVector2D &a = m_segmentIndex.point(segment);
+        const QDoubleVector2D &b = m_segmentIndex.point(segment + 1);
+        const QDoubleVector2D p = a + (b - a) * fraction;
+        closest = QWebMercator::mercatorToCoord(QDoubleVector2D(p.x() - std::floor(p.x()), p.y()));
+        const double altitudeFrom = m_path.at(segment).altitude;
+        closest.setAltitude(altitudeFrom + (m_path.at(segment + 1).altitude - altitudeFrom) * fraction);
+    }
+
+    if (segmentIndex)
+        *segmentIndex = segment;
+    if (distanceAlongPath) {
+        const QGeoPackedCoordinate &from = m_path.at(segment);
+        *distanceAlongPath = length(0, segment)
+                + QGeoCoordinatePrivate::distance(from.latitude, from.longitude,
+                                                  closest.latitude(), closest.longitude());
+    }
+    return closest;
+}
+
 int QGeoPathPrivate::size() const
 {
     return m_path.size();
@@ -576,30 +869,33 @@ QGeoCoordinate QGeoPathPrivate::coordinateAt(int index) const
     if (index < 0 || index >= m_path.size())
         return QGeoCoordinate();
 
-    return m_path.at(index);
+    return m_path.at(index).toCoordinate();
 }
 
 bool QGeoPathPrivate::containsCoordinate(const QGeoCoordinate &coordinate) const
 {
-    return m_path.indexOf(coordinate) > -1;
+    if (!coordinate.isValid())
+        return false;
+    return m_path.indexOf(QGeoPackedCoordinate::fromCoordinate(coordinate)) > -1;
 }
 
 void QGeoPathPrivate::translate(double degreesLatitude, double degreesLongitude)
 {
     // Need min/maxLati, so update bbox
-    QVector<double> m_deltaXs;
-    double m_minX, m_maxX, m_minLati, m_maxLati;
+    QGeoPathBounds bounds;
+    bounds.add(m_path);
     m_bboxDirty = false;
-    computeBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox);
+    m_bbox = bounds.rectangle();
 
     if (degreesLatitude > 0.0)
-        degreesLatitude = qMin(degreesLatitude, 90.0 - m_maxLati);
+        degreesLatitude = qMin(degreesLatitude, 90.0 - bounds.maxLatitude());
     else
-        degreesLatitude = qMax(degreesLatitude, -90.0 - m_minLati);
-    for (QGeoCoordinate &p: m_path) {
-        p.setLatitude(p.latitude() + degreesLatitude);
-        p.setLongitude(QLocationUtils::wrapLong(p.longitude() + degreesLongitude));
+        degreesLatitude = qMax(degreesLatitude, -90.0 - bounds.minLatitude());
+    for (QGeoPackedCoordinate &p: m_path) {
+        p.latitude += degreesLatitude;
+        p.longitude = QLocationUtils::wrapLong(p.longitude + degreesLongitude);
     }
+    invalidatePathCache();
     m_bbox.translate(degreesLatitude, degreesLongitude);
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
 }
@@ -616,13 +912,15 @@ void QGeoPathPrivate::setPath(const QList<QGeoCoordinate> &path)
     for (const QGeoCoordinate &c: path)
         if (!c.isValid())
             return;
-    m_path = path;
+    m_path = qPackCoordinates(path);
+    invalidatePathCache();
     markDirty();
 }
 
 void QGeoPathPrivate::clearPath()
 {
     m_path.clear();
+    invalidatePathCache();
     markDirty();
 }
 
@@ -630,7 +928,8 @@ void QGeoPathPrivate::addCoordinate(const QGeoCoordinate &coordinate)
 {
     if (!coordinate.isValid())
         return;
-    m_path.append(coordinate);
+    m_path.append(QGeoPackedCoordinate::fromCoordinate(coordinate));
+    invalidateAppendedPathCache();
     markDirty();
 }
 
@@ -638,7 +937,8 @@ void QGeoPathPrivate::insertCoordinate(int index, const QGeoCoordinate &coordina
 {
     if (index < 0 || index > m_path.size() || !coordinate.isValid())
         return;
-    m_path.insert(index, coordinate);
+    m_path.insert(index, QGeoPackedCoordinate::fromCoordinate(coordinate));
+    invalidatePathCache();
     markDirty();
 }
 
@@ -646,13 +946,16 @@ void QGeoPathPrivate::replaceCoordinate(int index, const QGeoCoordinate &coordin
 {
     if (index < 0 || index >= m_path.size() || !coordinate.isValid())
         return;
-    m_path[index] = coordinate;
+    m_path[index] = QGeoPackedCoordinate::fromCoordinate(coordinate);
+    invalidatePathCache();
     markDirty();
 }
 
 void QGeoPathPrivate::removeCoordinate(const QGeoCoordinate &coordinate)
 {
-    int index = m_path.lastIndexOf(coordinate);
+    if (!coordinate.isValid())
+        return;
+    int index = m_path.lastIndexOf(QGeoPackedCoordinate::fromCoordinate(coordinate));
     removeCoordinate(index);
 }
 
@@ -661,9 +964,35 @@ void QGeoPathPrivate::removeCoordinate(int index)
     if (index < 0 || index >= m_path.size())
         return;
     m_path.removeAt(index);
+    invalidatePathCache();
+    markDirty();
+}
+
+void QGeoPathPrivate::replaceTail(int first, const QList<QGeoCoordinate> &tail)
+{
+    for (const QGeoCoordinate &c: tail)
+        if (!c.isValid())
+            return;
+    first = qBound(0, first, m_path.size());
+    m_path.resize(first);
+    m_path += qPackCoordinates(tail);
+    invalidateTailPathCache(first);
     markDirty();
 }
 
+void QGeoPathPrivate::setPathSharingPrefix(QGeoShape &shape, const QList<QGeoCoordinate> &path)
+{
+    Q_ASSERT(shape.type() == QGeoShape::PathType);
+    const QGeoCoordinateSpan old = vertices(shape);
+    const int size = qMin(old.size(), path.size());
+    int first = 0;
+    while (first < size && old.at(first) == QGeoPackedCoordinate::fromCoordinate(path.at(first)))
+        ++first;
+    if (first == old.size() && first == path.size())
+        return;
+    static_cast<QGeoPathPrivate *>(get(shape))->replaceTail(first, path.mid(first));
+}
+
 void QGeoPathPrivate::markDirty()
 {
     m_bboxDirty = true;
@@ -671,10 +1000,8 @@ void QGeoPathPrivate::markDirty()
 
 void QGeoPathPrivate::computeBoundingBox()
 {
-    QVector<double> m_deltaXs;
-    double m_minX, m_maxX, m_minLati, m_maxLati;
     m_bboxDirty = false;
-    computeBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox);
+    m_bbox = QGeoPathBounds::rectangle(m_path);
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
 }
 
@@ -688,6 +1015,7 @@ QGeoPathPrivateEager::QGeoPathPrivateEager(const QList<QGeoCoordinate> &path, co
 :   QGeoPathPrivate(path, width)
 {
     m_bboxDirty = false; // never dirty on the eager version
+    markDirty(); // the base constructor could not reach the overrides
 }
 
 QGeoPathPrivateEager::~QGeoPathPrivateEager()
@@ -703,45 +1031,161 @@ QGeoShapePrivate *QGeoPathPrivateEager::clone() const
 void QGeoPathPrivateEager::markDirty()
 {
     computeBoundingBox();
+    updateLengths(0);
+}
+
+double QGeoPathPrivateEager::length(int indexFrom, int indexTo) const
+{
+    if (m_path.isEmpty())
+        return 0.0;
+    if (m_lengths.size() != m_path.size()) // this case should not happen
+        return QGeoPathPrivate::length(indexFrom, indexTo);
+
+    bool wrap = indexTo == -1;
+    if (indexTo < 0 || indexTo >= m_path.size())
+        indexTo = m_path.size() - 1;
+    indexFrom = qMax(indexFrom, 0);
+    double len = 0.0;
+    if (indexFrom < indexTo)
+        len = m_lengths.at(indexTo) - m_lengths.at(indexFrom);
+    if (wrap)
+        len += QGeoCoordinatePrivate::distance(m_path.last().latitude, m_path.last().longitude,
+                                               m_path.first().latitude, m_path.first().longitude);
+    return len;
+}
+
+QGeoCoordinate QGeoPathPrivateEager::coordinateAtDistance(double distance) const
+{
+    if (m_path.isEmpty() || qIsNaN(distance))
+        return QGeoCoordinate();
+    if (m_lengths.size() != m_path.size()) // this case should not happen
+        return QGeoPathPrivate::coordinateAtDistance(distance);
+    if (distance <= 0.0)
+        return m_path.first().toCoordinate();
+
+    // first vertex farther than distance, so the segment ending there contains it
+    const int i = int(std::upper_bound(m_lengths.cbegin(), m_lengths.cend(), distance)
+                      - m_lengths.cbegin());
+    if (i >= m_path.size())
+        return m_path.last().toCoordinate();
+    const double segment = m_lengths.at(i) - m_lengths.at(i - 1);
+    return qgeopath_interpolate(m_path.at(i - 1), m_path.at(i),
+                                (distance - m_lengths.at(i - 1)) / segment);
 }
 
 void QGeoPathPrivateEager::translate(double degreesLatitude, double degreesLongitude)
 {
     if (degreesLatitude > 0.0)
-        degreesLatitude = qMin(degreesLatitude, 90.0 - m_maxLati);
+        degreesLatitude = qMin(degreesLatitude, 90.0 - m_bounds.maxLatitude());
     else
-        degreesLatitude = qMax(degreesLatitude, -90.0 - m_minLati);
-    for (QGeoCoordinate &p: m_path) {
-        p.setLatitude(p.latitude() + degreesLatitude);
-        p.setLongitude(QLocationUtils::wrapLong(p.longitude() + degreesLongitude));
+        degreesLatitude = qMax(degreesLatitude, -90.0 - m_bounds.minLatitude());
+    for (QGeoPackedCoordinate &p: m_path) {
+        p.latitude += degreesLatitude;
+        p.longitude = QLocationUtils::wrapLong(p.longitude + degreesLongitude);
     }
+    invalidatePathCache();
     m_bbox.translate(degreesLatitude, degreesLongitude);
-    m_minLati += degreesLatitude;
-    m_maxLati += degreesLatitude;
+    m_bounds.translate(degreesLatitude, degreesLongitude);
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
+    if (degreesLatitude != 0.0) // distances do not change when moving east or west
+        updateLengths(0);
 }
 
 void QGeoPathPrivateEager::addCoordinate(const QGeoCoordinate &coordinate)
 {
     if (!coordinate.isValid())
         return;
-    m_path.append(coordinate);
+    m_path.append(QGeoPackedCoordinate::fromCoordinate(coordinate));
+    invalidateAppendedPathCache();
     //m_clipperDirty = true; // clipper not used in polylines
     updateBoundingBox();
+    updateLengths(m_path.size() - 1);
+}
+
+void QGeoPathPrivateEager::insertCoordinate(int index, const QGeoCoordinate &coordinate)
+{
+    if (index < 0 || index > m_path.size() || !coordinate.isValid())
+        return;
+    m_path.insert(index, QGeoPackedCoordinate::fromCoordinate(coordinate));
+    invalidatePathCache();
+    computeBoundingBox();
+    updateLengths(index);
+}
+
+void QGeoPathPrivateEager::replaceCoordinate(int index, const QGeoCoordinate &coordinate)
+{
+    if (index < 0 || index >= m_path.size() || !coordinate.isValid())
+        return;
+    m_path[index] = QGeoPackedCoordinate::fromCoordinate(coordinate);
+    invalidatePathCache();
+    computeBoundingBox();
+    updateLengths(index);
+}
+
+void QGeoPathPrivateEager::removeCoordinate(int index)
+{
+    if (index < 0 || index >= m_path.size())
+        return;
+    m_path.removeAt(index);
+    invalidatePathCache();
+    computeBoundingBox();
+    updateLengths(index);
+}
+
+void QGeoPathPrivateEager::replaceTail(int first, const QList<QGeoCoordinate> &tail)
+{
+    for (const QGeoCoordinate &c: tail)
+        if (!c.isValid())
+            return;
+    first = qBound(0, first, m_path.size());
+    m_path.resize(first);
+    m_path += qPackCoordinates(tail);
+    invalidateTailPathCache(first);
+    computeBoundingBox();
+    updateLengths(first);
 }
 
 void QGeoPathPrivateEager::QGeoPathPrivateEager::computeBoundingBox()
 {
-    computeBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox);
+    m_bounds.clear();
+    m_bounds.add(m_path);
+    m_bbox = m_bounds.rectangle();
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
 }
 
+// Extends the bounding box by the last vertex, just appended
 void QGeoPathPrivateEager::QGeoPathPrivateEager::updateBoundingBox()
 {
-    updateBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox);
+    if (m_bounds.count() != m_path.size() - 1) { // this case should not happen
+        computeBoundingBox();
+        return;
+    }
+    m_bounds.add(m_path.last());
+    m_bbox = m_bounds.rectangle();
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
 }
 
+// Recomputes m_lengths from element from onwards, keeping the distances before it
+void QGeoPathPrivateEager::updateLengths(int from)
+{
+    const int n = m_path.size();
+    if (m_lengths.size() < from)
+        from = m_lengths.size();
+    m_lengths.resize(n);
+    if (n == 0)
+        return;
+    m_lengths[0] = 0.0;
+    from = qMax(from, 1);
+    if (from >= n)
+        return;
+
+    const double base = m_lengths.at(from - 1);
+    double *lengths = m_lengths.data() + from - 1;
+    QGeoCoordinateKernels::cumulativeLengths(vertices().mid(from - 1), lengths);
+    for (int i = 0; i < n - from + 1; ++i)
+        lengths[i] += base;
+}
+
 QGeoPathEager::QGeoPathEager() : QGeoPath()
 {
     initPathConversions();
@@ -757,9 +1201,10 @@ QGeoPathEager::QGeoPathEager(const QList<QGeoCoordinate> &path, const qreal &wid
 QGeoPathEager::QGeoPathEager(const QGeoPath &other) : QGeoPath()
 {
     initPathConversions();
-    d_ptr = new QGeoPathPrivateEager;
-    setPath(other.path());
-    setWidth(other.width());
+    QGeoPathPrivateEager *d = new QGeoPathPrivateEager;
+    d->shareVertices(*static_cast<const QGeoPathPrivate *>(QGeoShapePrivate::get(other)));
+    d->setWidth(other.width());
+    d_ptr = d;
 }
 
 QGeoPathEager::QGeoPathEager(const QGeoShape &other) : QGeoPath()
@@ -773,6 +1218,61 @@ QGeoPathEager::QGeoPathEager(const QGeoShape &other) : QGeoPath()
 
 QGeoPathEager::~QGeoPathEager() {}
 
+QGeoPathSlice::QGeoPathSlice(const QGeoShape &shape, int first, int count)
+{
+    if (shape.type() != QGeoShape::PathType && shape.type() != QGeoShape::PolygonType)
+        return;
+    m_shape = shape;
+    const int size = QGeoPathPrivate::vertices(shape).size();
+    m_first = qBound(0, first, size);
+    m_count = (count < 0) ? size - m_first : qMin(count, size - m_first);
+}
+
+bool QGeoPathSlice::isWholeShape() const
+{
+    return m_count > 0 && m_first == 0 && m_count == QGeoPathPrivate::vertices(m_shape).size();
+}
+
+QGeoCoordinateSpan QGeoPathSlice::vertices() const
+{
+    if (!m_count)
+        return QGeoCoordinateSpan();
+    return QGeoPathPrivate::vertices(m_shape).mid(m_first, m_count);
+}
+
+double QGeoPathSlice::length() const
+{
+    if (m_count < 2)
+        return 0.0;
+    const QGeoPathPrivate *d = static_cast<const QGeoPathPrivate *>(QGeoShapePrivate::get(m_shape));
+    return d->length(m_first, m_first + m_count - 1); // from the lengths of an eager path
+}
+
+QGeoRectangle QGeoPathSlice::boundingGeoRectangle() const
+{
+    if (isWholeShape())
+        return m_shape.boundingGeoRectangle(); // cached
+    return QGeoPathBounds::rectangle(vertices());
+}
+
+QList<QDoubleVector2D> QGeoPathSlice::mercatorVertices() const
+{
+    if (!m_count)
+        return QList<QDoubleVector2D>();
+    const QList<QDoubleVector2D> projected = QGeoPathPrivate::mercatorVertices(m_shape);
+    if (isWholeShape())
+        return projected;
+    return projected.mid(m_first, m_count);
+}
+
+QGeoPath QGeoPathSlice::toPath() const
+{
+    if (m_shape.type() == QGeoShape::PathType && isWholeShape())
+        return QGeoPath(m_shape);
+    const qreal width = m_shape.type() == QGeoShape::PathType ? QGeoPath(m_shape).width() : 0.0;
+    return QGeoPath(qUnpackCoordinates(vertices()), width);
+}
+
 QT_END_NAMESPACE
 
 
@@ -55,126 +55,82 @@
 #include "qgeoshape_p.h"
 #include "qgeocoordinate.h"
 #include "qlocationutils_p.h"
+#include "qgeopackedcoordinate_p.h"
+#include "qgeosegmentindex_p.h"
+#include "qdoublevector2d_p.h"
 #include <QtPositioning/qgeopath.h>
 #include <QtCore/QVector>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedData>
 
 QT_BEGIN_NAMESPACE
 
-inline static void computeBBox( const QList<QGeoCoordinate> &m_path,
-                                QVector<double> &m_deltaXs,
-                                double &m_minX,
-                                double &m_maxX,
-                                double &m_minLati,
-                                double &m_maxLati,
-                                QGeoRectangle &m_bbox)
+/*
+    The bounding rectangle of a path, accumulated in one pass over its
+    vertices. Like QGeoPath, it connects consecutive vertices the shorter way
+    around, so the longitudes are unwrapped along the path and the rectangle
+    of a path crossing the antimeridian crosses it too, from the vertex
+    furthest west to the one furthest east along the path. Vertices can be
+    added while a path grows.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoPathBounds
 {
-    if (m_path.isEmpty()) {
-        m_deltaXs.clear();
-        m_minX = qInf();
-        m_maxX = -qInf();
-        m_minLati = qInf();
-        m_maxLati = -qInf();
-        m_bbox = QGeoRectangle();
-        return;
-    }
+public:
+    bool isEmpty() const { return m_count == 0; }
+    int count() const { return m_count; }
+    void clear() { *this = QGeoPathBounds(); }
 
-    m_minLati = m_maxLati = m_path.at(0).latitude();
-    int minId = 0;
-    int maxId = 0;
-    m_deltaXs.resize(m_path.size());
-    m_deltaXs[0] = m_minX = m_maxX = 0.0;
+    void add(QGeoCoordinateSpan vertices);
+    void add(const QGeoPackedCoordinate &vertex) { add(QGeoCoordinateSpan(&vertex, 1)); }
+    // as after moving all the vertices, longitudes wrapping around
+    void translate(double degreesLatitude, double degreesLongitude);
 
-    for (int i = 1; i < m_path.size(); i++) {
-        const QGeoCoordinate &geoFrom = m_path.at(i-1);
-        const QGeoCoordinate &geoTo   = m_path.at(i);
-        double longiFrom    = geoFrom.longitude();
-        double longiTo      = geoTo.longitude();
-        double deltaLongi = longiTo - longiFrom;
-        if (qAbs(deltaLongi) > 180.0) {
-            if (longiTo > 0.0)
-                longiTo -= 360.0;
-            else
-                longiTo += 360.0;
-            deltaLongi =  longiTo - longiFrom;
-        }
-        m_deltaXs[i] = m_deltaXs[i-1] + deltaLongi;
-        if (m_deltaXs[i] < m_minX) {
-            m_minX = m_deltaXs[i];
-            minId = i;
-        }
-        if (m_deltaXs[i] > m_maxX) {
-            m_maxX = m_deltaXs[i];
-            maxId = i;
-        }
-        if (geoTo.latitude() > m_maxLati)
-            m_maxLati = geoTo.latitude();
-        if (geoTo.latitude() < m_minLati)
-            m_minLati = geoTo.latitude();
-    }
+    double minLatitude() const { return m_minLatitude; }
+    double maxLatitude() const { return m_maxLatitude; }
+    QGeoRectangle rectangle() const;
+    static QGeoRectangle rectangle(QGeoCoordinateSpan vertices);
 
-    m_bbox = QGeoRectangle(QGeoCoordinate(m_maxLati, m_path.at(minId).longitude()),
-                           QGeoCoordinate(m_minLati, m_path.at(maxId).longitude()));
-}
+private:
+    int m_count = 0;
+    double m_minLatitude = qInf();
+    double m_maxLatitude = -qInf();
+    double m_lastLongitude = 0;
+    double m_x = 0;                 // m_lastLongitude unwrapped along the path
+    double m_minX = 0;
+    double m_maxX = 0;
+    double m_westLongitude = 0;     // of the vertex at m_minX
+    double m_eastLongitude = 0;     // of the vertex at m_maxX
+};
 
-inline static void updateBBox( const QList<QGeoCoordinate> &m_path,
-                                QVector<double> &m_deltaXs,
-                                double &m_minX,
-                                double &m_maxX,
-                                double &m_minLati,
-                                double &m_maxLati,
-                                QGeoRectangle &m_bbox)
+/*
+    The vertices of a path projected to Web Mercator, shared by the copies of
+    a path whose vertices were not changed since, so that the map items and
+    objects showing the same path project it once. Built on first use, and
+    left behind by a path when its vertices change.
+*/
+class QGeoPathMercatorCache : public QSharedData
 {
-    if (m_path.isEmpty()) {
-        m_deltaXs.clear();
-        m_minX = qInf();
-        m_maxX = -qInf();
-        m_minLati = qInf();
-        m_maxLati = -qInf();
-        m_bbox = QGeoRectangle();
-        return;
-    } else if (m_path.size() == 1) { // was 0  now is 1
-        m_deltaXs.resize(1);
-        m_deltaXs[0] = m_minX = m_maxX = 0.0;
-        m_minLati = m_maxLati = m_path.at(0).latitude();
-        m_bbox = QGeoRectangle(QGeoCoordinate(m_maxLati, m_path.at(0).longitude()),
-                               QGeoCoordinate(m_minLati, m_path.at(0).longitude()));
-        return;
-    } else if ( m_path.size() != m_deltaXs.size() + 1 ) {  // this case should not happen
-        computeBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox); // something went wrong
-        return;
-    }
+public:
+    QMutex mutex; // guards the lazy build, which any copy may start
+    QList<QDoubleVector2D> vertices;
+    bool valid = false;
+};
 
-    const QGeoCoordinate &geoFrom = m_path.at(m_path.size()-2);
-    const QGeoCoordinate &geoTo   = m_path.last();
-    double longiFrom    = geoFrom.longitude();
-    double longiTo      = geoTo.longitude();
-    double deltaLongi = longiTo - longiFrom;
-    if (qAbs(deltaLongi) > 180.0) {
-        if (longiTo > 0.0)
-            longiTo -= 360.0;
-        else
-            longiTo += 360.0;
-        deltaLongi =  longiTo - longiFrom;
-    }
+/*
+    Guards the caches a path builds on first use in its const functions:
+    copies of a path share its private data until one is modified, so they
+    may build them from several threads. Not copied with the path, each
+    private data having its own caches.
+*/
+class QGeoPathCacheMutex
+{
+public:
+    QGeoPathCacheMutex() = default;
+    QGeoPathCacheMutex(const QGeoPathCacheMutex &) {}
+    QGeoPathCacheMutex &operator=(const QGeoPathCacheMutex &) { return *this; }
 
-    m_deltaXs.push_back(m_deltaXs.last() + deltaLongi);
-    double currentMinLongi = m_bbox.topLeft().longitude();
-    double currentMaxLongi = m_bbox.bottomRight().longitude();
-    if (m_deltaXs.last() < m_minX) {
-        m_minX = m_deltaXs.last();
-        currentMinLongi = geoTo.longitude();
-    }
-    if (m_deltaXs.last() > m_maxX) {
-        m_maxX = m_deltaXs.last();
-        currentMaxLongi = geoTo.longitude();
-    }
-    if (geoTo.latitude() > m_maxLati)
-        m_maxLati = geoTo.latitude();
-    if (geoTo.latitude() < m_minLati)
-        m_minLati = geoTo.latitude();
-    m_bbox = QGeoRectangle(QGeoCoordinate(m_maxLati, currentMinLongi),
-                           QGeoCoordinate(m_minLati, currentMaxLongi));
-}
+    QMutex mutex;
+};
 
 // Lazy by default. Eager, within the module, used only in MapItems/MapObjectsQSG
 class Q_POSITIONING_PRIVATE_EXPORT QGeoPathPrivate : public QGeoShapePrivate
@@ -186,6 +142,7 @@ public:
 
 // QGeoShape API
     virtual QGeoShapePrivate *clone() const override;
+    virtual void freeze() override;
     virtual bool isValid() const override;
     virtual bool isEmpty() const override;
     virtual QGeoCoordinate center() const override;
@@ -197,9 +154,28 @@ public:
 
 // QGeoPathPrivate API
     virtual const QList<QGeoCoordinate> &path() const;
+    QGeoCoordinateSpan vertices() const { return m_path; }
+    // The vertices of a path, or the perimeter of a polygon, without building path()
+    static QGeoCoordinateSpan vertices(const QGeoShape &shape)
+    {
+        Q_ASSERT(shape.type() == QGeoShape::PathType || shape.type() == QGeoShape::PolygonType);
+        return static_cast<const QGeoPathPrivate *>(get(shape))->vertices();
+    }
+    // The vertices in Web Mercator, shared with the copies of the path
+    QList<QDoubleVector2D> mercatorVertices() const;
+    static QList<QDoubleVector2D> mercatorVertices(const QGeoShape &shape)
+    {
+        Q_ASSERT(shape.type() == QGeoShape::PathType || shape.type() == QGeoShape::PolygonType);
+        return static_cast<const QGeoPathPrivate *>(get(shape))->mercatorVertices();
+    }
+    // takes the vertices of other, and their projection, as setPath() would
+    void shareVertices(const QGeoPathPrivate &other);
     virtual bool lineContains(const QGeoCoordinate &coordinate) const;
     virtual qreal width() const;
     virtual double length(int indexFrom, int indexTo) const;
+    virtual QGeoCoordinate coordinateAtDistance(double distance) const;
+    QGeoCoordinate closestPoint(const QGeoCoordinate &coordinate, int *segmentIndex,
+                                double *distanceAlongPath) const;
     virtual int size() const;
     virtual QGeoCoordinate coordinateAt(int index) const;
     virtual bool containsCoordinate(const QGeoCoordinate &coordinate) const;
@@ -213,11 +189,36 @@ public:
     virtual void replaceCoordinate(int index, const QGeoCoordinate &coordinate);
     virtual void removeCoordinate(const QGeoCoordinate &coordinate);
     virtual void removeCoordinate(int index);
+    // keeps the vertices before first, and their projection, and replaces the others with tail
+    virtual void replaceTail(int first, const QList<QGeoCoordinate> &tail);
+    // Sets the vertices of the path to path, processing again only those
+    // after the vertices both start with, like a route recalculated from a
+    // point of it
+    static void setPathSharingPrefix(QGeoShape &shape, const QList<QGeoCoordinate> &path);
     virtual void computeBoundingBox();
     virtual void markDirty();
 
+    void updateSegmentIndex() const;
+    void invalidatePathCache()
+    {
+        m_pathCacheValid = false;
+        m_pathCache.clear();
+        m_segmentIndex.clear();
+        invalidateMercatorCache();
+    }
+    // appending a coordinate only adds a segment to the index, and a projected vertex
+    void invalidateAppendedPathCache();
+    // replacing the vertices from first onwards keeps the projection of those before
+    void invalidateTailPathCache(int first);
+    void invalidateMercatorCache();
+
 // data members
-    QList<QGeoCoordinate> m_path;
+    QGeoPackedCoordinates m_path;
+    mutable QList<QGeoCoordinate> m_pathCache; // built by path() only
+    mutable bool m_pathCacheValid = true;
+    mutable QGeoSegmentIndex m_segmentIndex; // built by closestPoint() only
+    mutable QExplicitlySharedDataPointer<QGeoPathMercatorCache> m_mercator; // built by mercatorVertices() only
+    mutable QGeoPathCacheMutex m_cacheMutex; // guards the three caches above while they are built
     qreal m_width = 0;
     QGeoRectangle m_bbox; // cached
     double m_leftBoundWrapped; // cached
@@ -237,18 +238,22 @@ public:
 
 // QGeoShapePrivate API
     virtual void markDirty() override;
+    virtual double length(int indexFrom, int indexTo) const override;
+    virtual QGeoCoordinate coordinateAtDistance(double distance) const override;
     virtual void addCoordinate(const QGeoCoordinate &coordinate) override;
+    virtual void insertCoordinate(int index, const QGeoCoordinate &coordinate) override;
+    virtual void replaceCoordinate(int index, const QGeoCoordinate &coordinate) override;
+    virtual void removeCoordinate(int index) override;
+    virtual void replaceTail(int first, const QList<QGeoCoordinate> &tail) override;
     virtual void computeBoundingBox() override;
 
 // *Eager API
     void updateBoundingBox();
+    void updateLengths(int from);
 
 // data members
-    QVector<double> m_deltaXs;      // longitude deltas from m_path[0]
-    double m_minX = 0;              // minimum value inside deltaXs
-    double m_maxX = 0;              // maximum value inside deltaXs
-    double m_minLati = 0;           // minimum latitude. paths do not wrap around through the poles
-    double m_maxLati = 0;           // minimum latitude. paths do not wrap around through the poles
+    QGeoPathBounds m_bounds;        // of m_path, extended as vertices are appended
+    QVector<double> m_lengths;      // distances in meters from m_path[0] along the path
 };
 
 // This is a mean of creating a QGeoPathPrivateEager and injecting it into QGeoPaths via operator=
@@ -264,6 +269,38 @@ public:
     ~QGeoPathEager();
 };
 
+/*
+    A range of the vertices of a path, or of the perimeter of a polygon,
+    sharing the vertices of the shape instead of copying them into a new
+    QGeoPath. Like QGeoPath::length(), consecutive vertices are connected the
+    shorter way around.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoPathSlice
+{
+public:
+    QGeoPathSlice() = default;
+    // clamped to the vertices of shape, a count of -1 reaching the last one
+    explicit QGeoPathSlice(const QGeoShape &shape, int first = 0, int count = -1);
+
+    const QGeoShape &shape() const { return m_shape; }
+    int first() const { return m_first; }
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+    bool isWholeShape() const;
+
+    QGeoCoordinateSpan vertices() const;
+    QGeoCoordinate coordinateAt(int index) const { return vertices().at(index).toCoordinate(); }
+    double length() const;
+    QGeoRectangle boundingGeoRectangle() const;
+    QList<QDoubleVector2D> mercatorVertices() const;
+    QGeoPath toPath() const;
+
+private:
+    QGeoShape m_shape;
+    int m_first = 0;
+    int m_count = 0;
+};
+
 QT_END_NAMESPACE
 
 #endif // QGEOPATH_P_H
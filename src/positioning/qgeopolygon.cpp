@@ -274,8 +274,9 @@ QVariantList QGeoPolygon::perimeter() const
 {
     Q_D(const QGeoPolygon);
     QVariantList p;
-    for (const auto &c: d->path())
-        p << QVariant::fromValue(c);
+    p.reserve(d->size());
+    for (const QGeoPackedCoordinate &c: d->vertices())
+        p << QVariant::fromValue(c.toCoordinate());
     return p;
 }
 
@@ -513,9 +514,19 @@ QGeoShapePrivate *QGeoPolygonPrivate::clone() const
     return new QGeoPolygonPrivate(*this);
 }
 
+void QGeoPolygonPrivate::freeze()
+{
+    // no closestPoint() on polygons, so no segment index either
+    if (m_bboxDirty)
+        computeBoundingBox();
+    path();
+    if (clipperPathOutdated())
+        updateClipperPath();
+}
+
 bool QGeoPolygonPrivate::isValid() const
 {
-    return path().size() > 2;
+    return m_path.size() > 2;
 }
 
 bool QGeoPolygonPrivate::contains(const QGeoCoordinate &coordinate) const
@@ -523,8 +534,9 @@ bool QGeoPolygonPrivate::contains(const QGeoCoordinate &coordinate) const
     return polygonContains(coordinate);
 }
 
-inline static void translatePoly(   QList<QGeoCoordinate> &m_path,
-                                    QList<QList<QGeoCoordinate>> &m_holesList,
+// Returns degreesLatitude, limited to keep the vertices within the poles
+inline static double translatePoly( QGeoPackedCoordinates &m_path,
+                                    QVector<QGeoPackedCoordinates> &m_holesList,
                                     QGeoRectangle &m_bbox,
                                     double degreesLatitude,
                                     double degreesLongitude,
@@ -535,31 +547,34 @@ inline static void translatePoly(   QList<QGeoCoordinate> &m_path,
         degreesLatitude = qMin(degreesLatitude, 90.0 - m_maxLati);
     else
         degreesLatitude = qMax(degreesLatitude, -90.0 - m_minLati);
-    for (QGeoCoordinate &p: m_path) {
-        p.setLatitude(p.latitude() + degreesLatitude);
-        p.setLongitude(QLocationUtils::wrapLong(p.longitude() + degreesLongitude));
+    for (QGeoPackedCoordinate &p: m_path) {
+        p.latitude += degreesLatitude;
+        p.longitude = QLocationUtils::wrapLong(p.longitude + degreesLongitude);
     }
     if (!m_holesList.isEmpty()){
-        for (QList<QGeoCoordinate> &hole: m_holesList){
-            for (QGeoCoordinate &holeVertex: hole){
-                holeVertex.setLatitude(holeVertex.latitude() + degreesLatitude);
-                holeVertex.setLongitude(QLocationUtils::wrapLong(holeVertex.longitude() + degreesLongitude));
+        for (QGeoPackedCoordinates &hole: m_holesList){
+            for (QGeoPackedCoordinate &holeVertex: hole){
+                holeVertex.latitude += degreesLatitude;
+                holeVertex.longitude = QLocationUtils::wrapLong(holeVertex.longitude + degreesLongitude);
             }
         }
     }
     m_bbox.translate(degreesLatitude, degreesLongitude);
+    return degreesLatitude;
 }
 
 void QGeoPolygonPrivate::translate(double degreesLatitude, double degreesLongitude)
 {
     // Need min/maxLati, so update bbox
-    QVector<double> m_deltaXs;
-    double m_minX, m_maxX, m_minLati, m_maxLati;
+    QGeoPathBounds bounds;
+    bounds.add(m_path);
     m_bboxDirty = false; // Updated in translatePoly
-    computeBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox);
-    translatePoly(m_path, m_holesList, m_bbox, degreesLatitude, degreesLongitude, m_maxLati, m_minLati);
+    m_bbox = bounds.rectangle();
+    translatePoly(m_path, m_holesList, m_bbox, degreesLatitude, degreesLongitude,
+                  bounds.maxLatitude(), bounds.minLatitude());
+    invalidatePathCache();
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
-    m_clipperDirty = true;
+    invalidateClipperRings();
 }
 
 bool QGeoPolygonPrivate::operator==(const QGeoShapePrivate &other) const
@@ -580,13 +595,12 @@ void QGeoPolygonPrivate::addHole(const QList<QGeoCoordinate> &holePath)
         if (!holeVertex.isValid())
             return;
 
-    m_holesList << holePath;
-    // ToDo: mark clipper dirty when hole caching gets added
+    m_holesList << qPackCoordinates(holePath); // converted by the next updateClipperPath()
 }
 
 const QList<QGeoCoordinate> QGeoPolygonPrivate::holePath(int index) const
 {
-    return m_holesList.at(index);
+    return qUnpackCoordinates(m_holesList.at(index));
 }
 
 void QGeoPolygonPrivate::removeHole(int index)
@@ -595,7 +609,8 @@ void QGeoPolygonPrivate::removeHole(int index)
         return;
 
     m_holesList.removeAt(index);
-    // ToDo: mark clipper dirty when hole caching gets added
+    if (index < m_clipperHoles.size())
+        m_clipperHoles.removeAt(index);
 }
 
 int QGeoPolygonPrivate::holesCount() const
@@ -603,51 +618,149 @@ int QGeoPolygonPrivate::holesCount() const
     return m_holesList.size();
 }
 
-bool QGeoPolygonPrivate::polygonContains(const QGeoCoordinate &coordinate) const
+static IntPoint qgeopolygon_toClipperPoint(const QGeoPackedCoordinate &c, double leftBoundWrapped)
 {
-    if (m_clipperDirty)
-        const_cast<QGeoPolygonPrivate *>(this)->updateClipperPath(); // this one updates bbox too if needed
+    QDoubleVector2D crd = QWebMercator::coordToMercator(c.latitude, c.longitude);
+    if (crd.x() < leftBoundWrapped)
+        crd.setX(crd.x() + 1.0);
+    return QClipperUtils::toIntPoint(crd);
+}
 
-    QDoubleVector2D coord = QWebMercator::coordToMercator(coordinate);
+static void qgeopolygon_buildClipperRing(QGeoCoordinateSpan ring, double leftBoundWrapped,
+                                         QtClipperLib::Path &path, QClipperPathIndex &index)
+{
+    path.clear();
+    path.reserve(size_t(ring.size()));
+    for (const QGeoPackedCoordinate &c : ring)
+        path.push_back(qgeopolygon_toClipperPoint(c, leftBoundWrapped));
+    if (ring.size() >= QClipperPathIndex::MinimumIndexedSize)
+        index.build(path);
+    else
+        index.clear();
+}
 
-    if (coord.x() < m_leftBoundWrapped)
+static bool qgeopolygon_ringContains(const QtClipperLib::Path &path, const QClipperPathIndex &index,
+                                     double leftBoundWrapped, QDoubleVector2D coord)
+{
+    if (coord.x() < leftBoundWrapped)
         coord.setX(coord.x() + 1.0);
 
-
     IntPoint intCoord = QClipperUtils::toIntPoint(coord);
-    if (!c2t::clip2tri::pointInPolygon(intCoord, m_clipperPath))
+    return index.pointInPolygon(intCoord, path) != 0;
+}
+
+static bool qgeopolygon_contains(const QGeoPolygonPrivate &d, const QDoubleVector2D &coord)
+{
+    if (!qgeopolygon_ringContains(d.m_clipperPath, d.m_clipperIndex, d.m_leftBoundWrapped, coord))
         return false;
 
     // else iterates the holes List checking whether the point is contained inside the holes
-    for (const QList<QGeoCoordinate> &holePath : qAsConst(m_holesList)) {
-        // ToDo: cache these
-        QGeoPolygon holePolygon;
-        holePolygon.setPath(holePath);
-        if (holePolygon.contains(coordinate))
+    for (const QGeoPolygonPrivate::ClipperRing &hole : d.m_clipperHoles) {
+        if (qgeopolygon_ringContains(hole.path, hole.index, hole.leftBoundWrapped, coord))
             return false;
     }
     return true;
 }
 
+bool QGeoPolygonPrivate::polygonContains(const QGeoCoordinate &coordinate) const
+{
+    if (clipperPathOutdated())
+        const_cast<QGeoPolygonPrivate *>(this)->updateClipperPath(); // this one updates bbox too if needed
+
+    return qgeopolygon_contains(*this, QWebMercator::coordToMercator(coordinate));
+}
+
+void QGeoPolygonPrivate::containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const
+{
+    memset(mask, 0, size_t(coordinates.size() + 7) / 8);
+    if (clipperPathOutdated())
+        const_cast<QGeoPolygonPrivate *>(this)->updateClipperPath();
+
+    for (int i = 0; i < coordinates.size(); ++i) {
+        const QGeoPackedCoordinate &c = coordinates.at(i);
+        if (!QLocationUtils::isValidLat(c.latitude) || !QLocationUtils::isValidLong(c.longitude))
+            continue;
+        if (qgeopolygon_contains(*this, QWebMercator::coordToMercator(c.latitude, c.longitude)))
+            mask[i >> 3] |= uchar(1u << (i & 7));
+    }
+}
+
 void QGeoPolygonPrivate::markDirty()
 {
     m_bboxDirty = m_clipperDirty = true;
 }
 
+void QGeoPolygonPrivate::replaceCoordinate(int index, const QGeoCoordinate &coordinate)
+{
+    if (index < 0 || index >= m_path.size() || !coordinate.isValid())
+        return;
+    m_path[index] = QGeoPackedCoordinate::fromCoordinate(coordinate);
+    invalidatePathCache();
+    m_bboxDirty = true;
+
+    // Only the moved vertex has to be converted again, unless there are so
+    // many that converting the whole ring is as cheap.
+    if (m_clipperDirty)
+        return;
+    if (m_clipperMovedVertices.size() > m_path.size() / 8) {
+        m_clipperDirty = true;
+        m_clipperMovedVertices.clear();
+    } else if (m_clipperMovedVertices.isEmpty() || m_clipperMovedVertices.last() != index) {
+        m_clipperMovedVertices.append(index);
+    }
+}
+
+bool QGeoPolygonPrivate::clipperPathOutdated() const
+{
+    if (m_clipperDirty || !m_clipperMovedVertices.isEmpty()
+            || m_clipperHoles.size() != m_holesList.size())
+        return true;
+    for (const ClipperRing &hole : m_clipperHoles) {
+        if (hole.dirty)
+            return true;
+    }
+    return false;
+}
+
+void QGeoPolygonPrivate::invalidateClipperRings()
+{
+    m_clipperDirty = true;
+    m_clipperMovedVertices.clear();
+    for (ClipperRing &hole : m_clipperHoles)
+        hole.dirty = true;
+}
+
 void QGeoPolygonPrivate::updateClipperPath()
 {
     if (m_bboxDirty)
         computeBoundingBox();
-    m_clipperDirty = false;
 
-    QList<QDoubleVector2D> preservedPath;
-    for (const QGeoCoordinate &c : m_path) {
-        QDoubleVector2D crd = QWebMercator::coordToMercator(c);
-        if (crd.x() < m_leftBoundWrapped)
-            crd.setX(crd.x() + 1.0);
-        preservedPath << crd;
+    // moving the western edge changes the unwrapping of every vertex
+    if (m_clipperDirty || m_clipperLeftBound != m_leftBoundWrapped
+            || m_clipperPath.size() != size_t(m_path.size())) {
+        qgeopolygon_buildClipperRing(m_path, m_leftBoundWrapped, m_clipperPath, m_clipperIndex);
+        m_clipperLeftBound = m_leftBoundWrapped;
+    } else if (!m_clipperMovedVertices.isEmpty()) {
+        for (int i : qAsConst(m_clipperMovedVertices))
+            m_clipperPath[size_t(i)] = qgeopolygon_toClipperPoint(m_path.at(i), m_leftBoundWrapped);
+        if (!m_clipperIndex.isEmpty())
+            m_clipperIndex.build(m_clipperPath);
+    }
+    m_clipperDirty = false;
+    m_clipperMovedVertices.clear();
+
+    // holes wrap around their own bounding box, as separate polygons would
+    m_clipperHoles.resize(m_holesList.size());
+    for (int i = 0; i < m_holesList.size(); ++i) {
+        ClipperRing &hole = m_clipperHoles[i];
+        if (!hole.dirty)
+            continue;
+
+        const QGeoRectangle bbox = QGeoPathBounds::rectangle(m_holesList.at(i));
+        hole.leftBoundWrapped = QWebMercator::coordToMercator(bbox.topLeft()).x();
+        qgeopolygon_buildClipperRing(m_holesList.at(i), hole.leftBoundWrapped, hole.path, hole.index);
+        hole.dirty = false;
     }
-    m_clipperPath = QClipperUtils::qListToPath(preservedPath);
 }
 
 QGeoPolygonPrivateEager::QGeoPolygonPrivateEager() : QGeoPolygonPrivate()
@@ -672,9 +785,12 @@ QGeoShapePrivate *QGeoPolygonPrivateEager::clone() const
 
 void QGeoPolygonPrivateEager::translate(double degreesLatitude, double degreesLongitude)
 {
-    translatePoly(m_path, m_holesList, m_bbox, degreesLatitude, degreesLongitude, m_maxLati, m_minLati);
+    degreesLatitude = translatePoly(m_path, m_holesList, m_bbox, degreesLatitude, degreesLongitude,
+                                    m_bounds.maxLatitude(), m_bounds.minLatitude());
+    m_bounds.translate(degreesLatitude, degreesLongitude);
+    invalidatePathCache();
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
-    m_clipperDirty = true;
+    invalidateClipperRings();
 }
 
 void QGeoPolygonPrivateEager::markDirty()
@@ -687,20 +803,38 @@ void QGeoPolygonPrivateEager::addCoordinate(const QGeoCoordinate &coordinate)
 {
     if (!coordinate.isValid())
         return;
-    m_path.append(coordinate);
+    m_path.append(QGeoPackedCoordinate::fromCoordinate(coordinate));
+    invalidatePathCache();
     m_clipperDirty = true;
     updateBoundingBox(); // do not markDirty as it uses computeBoundingBox instead
 }
 
+void QGeoPolygonPrivateEager::replaceCoordinate(int index, const QGeoCoordinate &coordinate)
+{
+    QGeoPolygonPrivate::replaceCoordinate(index, coordinate);
+    if (m_bboxDirty) {
+        m_bboxDirty = false; // never dirty on the eager version
+        computeBoundingBox();
+    }
+}
+
 void QGeoPolygonPrivateEager::computeBoundingBox()
 {
-    computeBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox);
+    m_bounds.clear();
+    m_bounds.add(m_path);
+    m_bbox = m_bounds.rectangle();
     m_leftBoundWrapped = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
 }
 
+// Extends the bounding box by the last vertex, just appended
 void QGeoPolygonPrivateEager::updateBoundingBox()
 {
-    updateBBox(m_path, m_deltaXs, m_minX, m_maxX, m_minLati, m_maxLati, m_bbox);
+    if (m_bounds.count() != m_path.size() - 1) { // this case should not happen
+        computeBoundingBox();
+        return;
+    }
+    m_bounds.add(m_path.last());
+    m_bbox = m_bounds.rectangle();
 }
 
 QGeoPolygonEager::QGeoPolygonEager() : QGeoPolygon()
@@ -719,8 +853,9 @@ QGeoPolygonEager::QGeoPolygonEager(const QGeoPolygon &other) : QGeoPolygon()
 {
     initPolygonConversions();
     // without being able to dynamic_cast the d_ptr, only way to be sure is to reconstruct a new QGeoPolygonPrivateEager
-    d_ptr = new QGeoPolygonPrivateEager;
-    setPath(other.path());
+    QGeoPolygonPrivateEager *d = new QGeoPolygonPrivateEager;
+    d->shareVertices(*static_cast<const QGeoPathPrivate *>(QGeoShapePrivate::get(other)));
+    d_ptr = d;
     for (int i = 0; i < other.holesCount(); i++)
         addHole(other.holePath(i));
 }
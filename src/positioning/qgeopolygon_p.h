@@ -66,27 +66,50 @@ public:
 
 // QGeoShape API
     virtual QGeoShapePrivate *clone() const override;
+    virtual void freeze() override;
     virtual bool isValid() const override;
     virtual bool contains(const QGeoCoordinate &coordinate) const override;
+    virtual void containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const override;
     virtual void translate(double degreesLatitude, double degreesLongitude) override;
     virtual bool operator==(const QGeoShapePrivate &other) const override;
 
 // QGeoPath API
     virtual void markDirty() override;
+    virtual void replaceCoordinate(int index, const QGeoCoordinate &coordinate) override;
 
 // QGeoPolygonPrivate API
     int holesCount() const;
     bool polygonContains(const QGeoCoordinate &coordinate) const;
     const QList<QGeoCoordinate> holePath(int index) const;
+    QGeoCoordinateSpan holeVertices(int index) const { return m_holesList.at(index); }
+    static QGeoCoordinateSpan holeVertices(const QGeoPolygon &polygon, int index)
+    {
+        return static_cast<const QGeoPolygonPrivate *>(get(polygon))->holeVertices(index);
+    }
 
     virtual void addHole(const QList<QGeoCoordinate> &holePath);
     virtual void removeHole(int index);
     virtual void updateClipperPath();
+    bool clipperPathOutdated() const;
+    void invalidateClipperRings();
+
+    // a ring converted for containment tests, the outer one or a hole
+    struct ClipperRing
+    {
+        QtClipperLib::Path path;
+        QClipperPathIndex index;
+        double leftBoundWrapped = 0;
+        bool dirty = true;
+    };
 
 // data members
-    bool m_clipperDirty = true;
-    QList<QList<QGeoCoordinate>> m_holesList;
+    bool m_clipperDirty = true;         // the outer ring has to be converted again
+    QVector<QGeoPackedCoordinates> m_holesList;
     QtClipperLib::Path m_clipperPath;
+    QClipperPathIndex m_clipperIndex;   // left empty for small paths
+    double m_clipperLeftBound = 0;      // m_leftBoundWrapped used for m_clipperPath
+    QVector<int> m_clipperMovedVertices; // replaced since m_clipperPath was converted
+    QVector<ClipperRing> m_clipperHoles; // one per hole, or fewer until updateClipperPath()
 };
 
 class Q_POSITIONING_PRIVATE_EXPORT QGeoPolygonPrivateEager : public QGeoPolygonPrivate
@@ -103,6 +126,7 @@ public:
 // QGeoPath API
     virtual void markDirty() override;
     virtual void addCoordinate(const QGeoCoordinate &coordinate) override;
+    virtual void replaceCoordinate(int index, const QGeoCoordinate &coordinate) override;
     virtual void computeBoundingBox() override;
 
 // QGeoPolygonPrivate API
@@ -111,11 +135,7 @@ public:
     void updateBoundingBox();
 
 // data members
-    QVector<double> m_deltaXs;      // longitude deltas from m_path[0]
-    double m_minX = 0;              // minimum value inside deltaXs
-    double m_maxX = 0;              // maximum value inside deltaXs
-    double m_minLati = 0;           // minimum latitude. paths do not wrap around through the poles
-    double m_maxLati = 0;           // minimum latitude. paths do not wrap around through the poles
+    QGeoPathBounds m_bounds;        // of m_path, extended as vertices are appended
 };
 
 // This is a mean of creating a QGeoPolygonPrivateEager and injecting it into QGeoPolygons via operator=
@@ -0,0 +1,276 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeopositionhistory_p.h"
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const int AttributeCount = QGeoPositionInfo::VerticalAccuracy + 1;
+
+} // namespace
+
+QGeoPositionHistory::QGeoPositionHistory(qint64 memoryLimit, int chunkSize)
+    : m_memoryLimit(qMax<qint64>(memoryLimit, 0))
+{
+    const qint64 fixes = m_memoryLimit / fixSize();
+    m_chunkSize = int(qMax<qint64>(1, qMin<qint64>(chunkSize, fixes / 2)));
+    m_maximumChunks = int(qBound<qint64>(1, fixes / m_chunkSize,
+                                          std::numeric_limits<int>::max() / m_chunkSize));
+}
+
+qint64 QGeoPositionHistory::memoryUsage() const
+{
+    return qint64(m_chunks.size()) * m_chunkSize * fixSize();
+}
+
+int QGeoPositionHistory::fixSize()
+{
+    return int(sizeof(QGeoPackedCoordinate) + sizeof(qint64) + sizeof(Attributes));
+}
+
+QDateTime QGeoPositionHistory::firstTimestamp() const
+{
+    return m_size ? timestampAt(0) : QDateTime();
+}
+
+QDateTime QGeoPositionHistory::lastTimestamp() const
+{
+    return m_size ? timestampAt(m_size - 1) : QDateTime();
+}
+
+bool QGeoPositionHistory::append(const QGeoPositionInfo &position)
+{
+    if (!position.isValid())
+        return false;
+    const qint64 msecs = position.timestamp().toMSecsSinceEpoch();
+    if (m_size && msecs < msecsAt(m_size - 1))
+        return false;
+
+    if (m_size % m_chunkSize == 0) {
+        // Vertex 0 of the next chunk repeats the last coordinate, for the
+        // slices of paths() to connect
+        QGeoCoordinate last;
+        if (m_size)
+            last = coordinateAt(m_size - 1);
+        if (m_chunks.size() < m_maximumChunks) {
+            m_chunks.append(Chunk());
+        } else {
+            m_head = (m_head + 1) % m_chunks.size();
+            m_size -= m_chunkSize;
+        }
+        Chunk &next = m_chunks[(m_head + m_size / m_chunkSize) % m_chunks.size()];
+        next.coordinates = QGeoPath();
+        next.timestamps.clear();
+        next.timestamps.reserve(m_chunkSize);
+        next.attributes.clear();
+        next.attributes.reserve(m_chunkSize);
+        next.lead = last.isValid() ? 1 : 0;
+        if (next.lead)
+            next.coordinates.addCoordinate(last);
+    }
+
+    Attributes attributes;
+    attributes.mask = 0;
+    for (int i = 0; i < AttributeCount; ++i) {
+        const QGeoPositionInfo::Attribute attribute = QGeoPositionInfo::Attribute(i);
+        if (position.hasAttribute(attribute)) {
+            attributes.values[i] = float(position.attribute(attribute));
+            attributes.mask |= 1 << i;
+        } else {
+            attributes.values[i] = 0;
+        }
+    }
+
+    Chunk &last = m_chunks[(m_head + m_size / m_chunkSize) % m_chunks.size()];
+    last.coordinates.addCoordinate(position.coordinate());
+    last.timestamps.append(msecs);
+    last.attributes.append(attributes);
+    ++m_size;
+    return true;
+}
+
+void QGeoPositionHistory::clear()
+{
+    m_chunks.clear();
+    m_head = 0;
+    m_size = 0;
+}
+
+QGeoPositionInfo QGeoPositionHistory::at(int index) const
+{
+    if (index < 0 || index >= m_size)
+        return QGeoPositionInfo();
+    QGeoPositionInfo position(coordinateAt(index), timestampAt(index));
+    const Attributes &attributes = chunk(index).attributes.at(index % m_chunkSize);
+    for (int i = 0; i < AttributeCount; ++i) {
+        if (attributes.mask & (1 << i))
+            position.setAttribute(QGeoPositionInfo::Attribute(i), attributes.values[i]);
+    }
+    return position;
+}
+
+QGeoCoordinate QGeoPositionHistory::coordinateAt(int index) const
+{
+    if (index < 0 || index >= m_size)
+        return QGeoCoordinate();
+    const Chunk &c = chunk(index);
+    return QGeoPathPrivate::vertices(c.coordinates).at(c.lead + index % m_chunkSize).toCoordinate();
+}
+
+QDateTime QGeoPositionHistory::timestampAt(int index) const
+{
+    if (index < 0 || index >= m_size)
+        return QDateTime();
+    return QDateTime::fromMSecsSinceEpoch(msecsAt(index), Qt::UTC);
+}
+
+int QGeoPositionHistory::lowerBound(const QDateTime &time) const
+{
+    return firstAfter(time.toMSecsSinceEpoch(), true);
+}
+
+int QGeoPositionHistory::upperBound(const QDateTime &time) const
+{
+    return firstAfter(time.toMSecsSinceEpoch(), false);
+}
+
+int QGeoPositionHistory::nearest(const QDateTime &time) const
+{
+    if (!m_size || !time.isValid())
+        return -1;
+    const qint64 msecs = time.toMSecsSinceEpoch();
+    const int next = firstAfter(msecs, true);
+    if (next == 0)
+        return 0;
+    if (next == m_size)
+        return m_size - 1;
+    return msecs - msecsAt(next - 1) <= msecsAt(next) - msecs ? next - 1 : next;
+}
+
+QList<QGeoPositionInfo> QGeoPositionHistory::range(const QDateTime &from, const QDateTime &to) const
+{
+    QList<QGeoPositionInfo> positions;
+    const int first = rangeBegin(from);
+    const int end = rangeEnd(to);
+    if (first < end)
+        positions.reserve(end - first);
+    for (int i = first; i < end; ++i)
+        positions.append(at(i));
+    return positions;
+}
+
+QVector<QGeoPathSlice> QGeoPositionHistory::paths(const QDateTime &from, const QDateTime &to) const
+{
+    const int first = rangeBegin(from);
+    return paths(first, qMax(0, rangeEnd(to) - first));
+}
+
+QVector<QGeoPathSlice> QGeoPositionHistory::paths(int first, int count) const
+{
+    QVector<QGeoPathSlice> slices;
+    first = qBound(0, first, m_size);
+    const int end = count < 0 ? m_size : first + qMin(count, m_size - first);
+    while (first < end) {
+        const Chunk &c = chunk(first);
+        const int offset = first % m_chunkSize;
+        const int n = qMin(end - first, m_chunkSize - offset);
+        // The slices after the first start from the last coordinate of the previous one
+        const int lead = (!slices.isEmpty() && c.lead) ? 1 : 0;
+        slices.append(QGeoPathSlice(c.coordinates, c.lead + offset - lead, n + lead));
+        first += n;
+    }
+    return slices;
+}
+
+QGeoPath QGeoPositionHistory::path(const QDateTime &from, const QDateTime &to) const
+{
+    QList<QGeoCoordinate> coordinates;
+    const int first = rangeBegin(from);
+    const int end = rangeEnd(to);
+    if (first < end)
+        coordinates.reserve(end - first);
+    for (int i = first; i < end; ++i)
+        coordinates.append(coordinateAt(i));
+    return QGeoPath(coordinates);
+}
+
+qint64 QGeoPositionHistory::msecsAt(int index) const
+{
+    return chunk(index).timestamps.at(index % m_chunkSize);
+}
+
+int QGeoPositionHistory::firstAfter(qint64 msecs, bool orEqual) const
+{
+    const auto before = [msecs, orEqual](qint64 timestamp) {
+        return orEqual ? timestamp < msecs : timestamp <= msecs;
+    };
+
+    // The chunk holding it, from the last timestamp of each, then within the chunk
+    int low = 0;
+    int high = (m_size + m_chunkSize - 1) / m_chunkSize;
+    while (low < high) {
+        const int mid = (low + high) / 2;
+        if (before(chunk(mid * m_chunkSize).timestamps.last()))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low * m_chunkSize >= m_size)
+        return m_size;
+    const QVector<qint64> &timestamps = chunk(low * m_chunkSize).timestamps;
+    const auto it = std::partition_point(timestamps.cbegin(), timestamps.cend(), before);
+    return low * m_chunkSize + int(it - timestamps.cbegin());
+}
+
+int QGeoPositionHistory::rangeBegin(const QDateTime &from) const
+{
+    return from.isValid() ? lowerBound(from) : 0;
+}
+
+int QGeoPositionHistory::rangeEnd(const QDateTime &to) const
+{
+    return to.isValid() ? upperBound(to) : m_size;
+}
+
+QT_END_NAMESPACE
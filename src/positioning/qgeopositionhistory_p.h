@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOPOSITIONHISTORY_P_H
+#define QGEOPOSITIONHISTORY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qgeopath_p.h>
+#include <QtPositioning/qgeopath.h>
+#include <QtPositioning/qgeopositioninfo.h>
+#include <QtCore/QDateTime>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The positions of the last while, in chronological order, using at most
+    memoryLimit() bytes. The positions are kept in chunks of chunkSize()
+    compact fixes, and when no chunk can be added within the limit the oldest
+    one is reused, dropping its positions at once.
+
+    A fix keeps the coordinate, the timestamp to the millisecond in UTC and
+    the attributes present as floats. Lookups by time are binary searches, and
+    the coordinates of a chunk are the vertices of a QGeoPath, which paths()
+    shares with the map instead of copying them. Appending to a chunk shared
+    that way copies its coordinates once.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoPositionHistory
+{
+public:
+    enum {
+        DefaultMemoryLimit = 4 * 1024 * 1024,
+        DefaultChunkSize = 1024
+    };
+
+    // The chunk size is reduced for the limit to hold two chunks
+    explicit QGeoPositionHistory(qint64 memoryLimit = DefaultMemoryLimit,
+                                 int chunkSize = DefaultChunkSize);
+
+    qint64 memoryLimit() const { return m_memoryLimit; }
+    int chunkSize() const { return m_chunkSize; }
+    // Of the chunks allocated, not counting the copies kept by the slices
+    // of paths()
+    qint64 memoryUsage() const;
+    static int fixSize();
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    QDateTime firstTimestamp() const;
+    QDateTime lastTimestamp() const;
+
+    // Returns false if the position is not valid, or older than the last one
+    bool append(const QGeoPositionInfo &position);
+    void clear();
+
+    // Index 0 is the oldest position kept
+    QGeoPositionInfo at(int index) const;
+    QGeoCoordinate coordinateAt(int index) const;
+    QDateTime timestampAt(int index) const;
+
+    // The index of the first position at or after time, size() if none
+    int lowerBound(const QDateTime &time) const;
+    // The index of the first position after time, size() if none
+    int upperBound(const QDateTime &time) const;
+    // The index of the position nearest to time, the earlier one on a tie,
+    // -1 if empty
+    int nearest(const QDateTime &time) const;
+
+    // The positions from from to to, both included. An invalid from or to
+    // leaves the range open on that side.
+    QList<QGeoPositionInfo> range(const QDateTime &from, const QDateTime &to) const;
+    // The coordinates of the same range as slices of the chunks, in order,
+    // sharing their vertices
+    QVector<QGeoPathSlice> paths(const QDateTime &from, const QDateTime &to) const;
+    // A count of -1 reaching the last position
+    QVector<QGeoPathSlice> paths(int first, int count = -1) const;
+    // The same range as a single path, copying the coordinates
+    QGeoPath path(const QDateTime &from, const QDateTime &to) const;
+
+private:
+    struct Attributes
+    {
+        float values[QGeoPositionInfo::VerticalAccuracy + 1];
+        quint8 mask; // of the attributes present
+    };
+
+    struct Chunk
+    {
+        QGeoPath coordinates;
+        QVector<qint64> timestamps; // in msecs since the epoch
+        QVector<Attributes> attributes;
+        int lead = 0; // 1 if vertex 0 is the last coordinate of the previous chunk
+    };
+
+    const Chunk &chunk(int index) const
+    {
+        return m_chunks.at((m_head + index / m_chunkSize) % m_chunks.size());
+    }
+    qint64 msecsAt(int index) const;
+    int firstAfter(qint64 msecs, bool orEqual) const;
+    int rangeBegin(const QDateTime &from) const;
+    int rangeEnd(const QDateTime &to) const;
+
+    QVector<Chunk> m_chunks; // a ring starting at m_head, the last one being filled
+    int m_head = 0;
+    int m_size = 0;
+    int m_chunkSize;
+    int m_maximumChunks;
+    qint64 m_memoryLimit;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOPOSITIONHISTORY_P_H
@@ -43,8 +43,6 @@
 #include <QDataStream>
 #include <QtCore/QtNumeric>
 
-#include <algorithm>
-
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -211,7 +209,7 @@ QGeoCoordinate QGeoPositionInfo::coordinate() const
 */
 void QGeoPositionInfo::setAttribute(Attribute attribute, qreal value)
 {
-    d->doubleAttribs[attribute] = value;
+    d->doubleAttribs.insert(attribute, value);
 }
 
 /*!
@@ -226,9 +224,7 @@ void QGeoPositionInfo::setAttribute(Attribute attribute, qreal value)
 */
 qreal QGeoPositionInfo::attribute(Attribute attribute) const
 {
-    if (d->doubleAttribs.contains(attribute))
-        return d->doubleAttribs[attribute];
-    return qQNaN();
+    return d->doubleAttribs.value(attribute, qQNaN());
 }
 
 /*!
@@ -256,8 +252,7 @@ QDebug operator<<(QDebug dbg, const QGeoPositionInfo &info)
     dbg.nospace() << ", "; // timestamp force dbg.space() -> reverting here
     dbg << info.d->coord;
 
-    QList<QGeoPositionInfo::Attribute> attribs = info.d->doubleAttribs.keys();
-    std::stable_sort(attribs.begin(), attribs.end()); // Output a sorted list from an unsorted hash.
+    const QList<QGeoPositionInfo::Attribute> attribs = info.d->doubleAttribs.keys();
     for (int i = 0; i < attribs.count(); ++i) {
         dbg << ", ";
         switch (attribs[i]) {
@@ -280,7 +275,7 @@ QDebug operator<<(QDebug dbg, const QGeoPositionInfo &info)
                 dbg << "VerticalAccuracy=";
                 break;
         }
-        dbg << info.d->doubleAttribs[attribs[i]];
+        dbg << info.d->doubleAttribs.value(attribs[i], qQNaN());
     }
     dbg << ')';
     return dbg;
@@ -329,7 +324,7 @@ QDataStream &operator<<(QDataStream &stream, const QGeoPositionInfo &info)
 {
     stream << info.d->timestamp;
     stream << info.d->coord;
-    stream << info.d->doubleAttribs;
+    stream << info.d->doubleAttribs.toHash<QGeoPositionInfo::Attribute>();
     return stream;
 }
 
@@ -347,7 +342,9 @@ QDataStream &operator>>(QDataStream &stream, QGeoPositionInfo &info)
 {
     stream >> info.d->timestamp;
     stream >> info.d->coord;
-    stream >> info.d->doubleAttribs;
+    QHash<QGeoPositionInfo::Attribute, qreal> attribs;
+    stream >> attribs;
+    info.d->doubleAttribs.setHash(attribs);
     return stream;
 }
 #endif
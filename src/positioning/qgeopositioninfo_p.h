@@ -51,8 +51,8 @@
 //
 
 #include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qgeoattributearray_p.h>
 #include "qgeopositioninfo.h"
-#include <QHash>
 #include <QDateTime>
 #include <QtPositioning/qgeocoordinate.h>
 
@@ -68,7 +68,7 @@ public:
 
     QDateTime timestamp;
     QGeoCoordinate coord;
-    QHash<QGeoPositionInfo::Attribute, qreal> doubleAttribs;
+    QGeoAttributeArray<QGeoPositionInfo::Attribute, QGeoPositionInfo::VerticalAccuracy + 1> doubleAttribs;
 
     static QGeoPositionInfoPrivate *get(const QGeoPositionInfo &info);
 };
@@ -45,9 +45,12 @@
 #include <QStringList>
 #include <QJsonObject>
 #include <QCryptographicHash>
+#include <QTimer>
+#include <QMutex>
 #include <QtCore/private/qfactoryloader_p.h>
 
 #include <algorithm>
+#include <cmath>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,6 +58,20 @@ Q_GLOBAL_STATIC_WITH_ARGS(QFactoryLoader, loader,
         ("org.qt-project.qt.position.sourcefactory/5.0",
          QLatin1String("/position")))
 
+namespace {
+// The plugin metadata, read once per process and shared by the position,
+// satellite and area monitor sources
+struct PluginRegistry
+{
+    QMutex mutex;
+    bool discovered = false;
+    QMultiHash<QString, QJsonObject> plugins;
+    QList<QJsonObject> sorted; // by priority
+};
+}
+
+Q_GLOBAL_STATIC(PluginRegistry, pluginRegistry)
+
 /*!
     \class QGeoPositionInfoSource
     \inmodule QtPositioning
@@ -103,6 +120,138 @@ Q_GLOBAL_STATIC_WITH_ARGS(QFactoryLoader, loader,
     \value AllPositioningMethods Satellite-based positioning methods as soon as available. Otherwise non-satellite based methods.
 */
 
+static bool qgeopositioninfosource_isSignificant(const QGeoPositionInfoSourcePrivate *d,
+                                                 const QGeoPositionInfo &last,
+                                                 const QGeoPositionInfo &update)
+{
+    if (d->coalescingDistance <= 0 && d->coalescingHeading <= 0)
+        return true;
+
+    if (d->coalescingDistance > 0) {
+        const QGeoCoordinate from = last.coordinate();
+        const QGeoCoordinate to = update.coordinate();
+        if (from.isValid() != to.isValid())
+            return true;
+        if (from.isValid() && from.distanceTo(to) >= d->coalescingDistance)
+            return true;
+    }
+
+    if (d->coalescingHeading > 0 && last.hasAttribute(QGeoPositionInfo::Direction)
+            && update.hasAttribute(QGeoPositionInfo::Direction)) {
+        const qreal delta = std::fmod(update.attribute(QGeoPositionInfo::Direction)
+                                      - last.attribute(QGeoPositionInfo::Direction) + 540.0, 360.0) - 180.0;
+        if (qAbs(delta) >= d->coalescingHeading)
+            return true;
+    }
+    return false;
+}
+
+void QGeoPositionInfoSourcePrivate::coalesce(QGeoPositionInfoSource *source, const QGeoPositionInfo &update)
+{
+    if (coalescingInterval <= 0 && coalescingDistance <= 0 && coalescingHeading <= 0) {
+        emit source->coalescedPositionUpdated(update);
+        return;
+    }
+
+    if (lastCoalesced.isValid() && !qgeopositioninfosource_isSignificant(this, lastCoalesced, update)) {
+        // back within the thresholds, a pending update would be outdated
+        pendingCoalesced = QGeoPositionInfo();
+        if (coalescingTimer)
+            coalescingTimer->stop();
+        return;
+    }
+
+    const qint64 elapsed = coalescingClock.isValid() ? coalescingClock.elapsed() : coalescingInterval;
+    if (elapsed < coalescingInterval) {
+        pendingCoalesced = update;
+        if (!coalescingTimer) {
+            coalescingTimer = new QTimer(source);
+            coalescingTimer->setSingleShot(true);
+            QObject::connect(coalescingTimer, &QTimer::timeout, source, [this, source]() {
+                emitCoalesced(source, pendingCoalesced);
+            });
+        }
+        if (!coalescingTimer->isActive())
+            coalescingTimer->start(int(coalescingInterval - elapsed));
+        return;
+    }
+    emitCoalesced(source, update);
+}
+
+void QGeoPositionInfoSourcePrivate::emitCoalesced(QGeoPositionInfoSource *source, const QGeoPositionInfo &update)
+{
+    lastCoalesced = update;
+    pendingCoalesced = QGeoPositionInfo();
+    if (coalescingTimer)
+        coalescingTimer->stop();
+    coalescingClock.start();
+    emit source->coalescedPositionUpdated(lastCoalesced);
+}
+
+void QGeoPositionInfoSourcePrivate::addToBatch(QGeoPositionInfoSource *source,
+                                               const QGeoPositionInfo &update)
+{
+    if (!isBatching())
+        return;
+    appendToBatch(source, QList<QGeoPositionInfo>() << update);
+}
+
+/*
+    Delivers the \a updates a backend received at once, in chronological
+    order. All of them are batched, the last one is also emitted with
+    positionUpdated() for consumers that only need the current position.
+*/
+void QGeoPositionInfoSourcePrivate::deliverPositions(QGeoPositionInfoSource *source,
+                                                     const QList<QGeoPositionInfo> &updates)
+{
+    if (updates.isEmpty())
+        return;
+    // the last one is batched when positionUpdated() is emitted
+    if (isBatching() && updates.size() > 1)
+        appendToBatch(source, updates.mid(0, updates.size() - 1));
+    emit source->positionUpdated(updates.last());
+}
+
+void QGeoPositionInfoSourcePrivate::appendToBatch(QGeoPositionInfoSource *source,
+                                                  const QList<QGeoPositionInfo> &updates)
+{
+    batch += updates;
+
+    while (batchSize > 1 && batch.size() >= batchSize) {
+        const QList<QGeoPositionInfo> full = batch.mid(0, batchSize);
+        batch.erase(batch.begin(), batch.begin() + batchSize);
+        emit source->batchedPositionsUpdated(full);
+    }
+
+    if (batch.isEmpty()) {
+        if (batchTimer)
+            batchTimer->stop();
+        return;
+    }
+    if (batchInterval > 0) {
+        if (!batchTimer) {
+            batchTimer = new QTimer(source);
+            batchTimer->setSingleShot(true);
+            QObject::connect(batchTimer, &QTimer::timeout, source,
+                             [this, source]() { flushBatch(source); });
+        }
+        if (!batchTimer->isActive())
+            batchTimer->start(batchInterval);
+    }
+}
+
+void QGeoPositionInfoSourcePrivate::flushBatch(QGeoPositionInfoSource *source)
+{
+    if (batchTimer)
+        batchTimer->stop();
+    if (batch.isEmpty())
+        return;
+
+    const QList<QGeoPositionInfo> updates = batch;
+    batch.clear();
+    emit source->batchedPositionsUpdated(updates);
+}
+
 QGeoPositionInfoSourcePrivate *QGeoPositionInfoSourcePrivate::get(const QGeoPositionInfoSource &source)
 {
     return source.d;
@@ -143,21 +292,6 @@ QVariant QGeoPositionInfoSourcePrivate::backendProperty(const QString &/*name*/)
     return QVariant();
 }
 
-QMultiHash<QString, QJsonObject> QGeoPositionInfoSourcePrivate::plugins(bool reload)
-{
-    static QMultiHash<QString, QJsonObject> plugins;
-    static bool alreadyDiscovered = false;
-
-    if (reload == true)
-        alreadyDiscovered = false;
-
-    if (!alreadyDiscovered) {
-        loadPluginMetadata(plugins);
-        alreadyDiscovered = true;
-    }
-    return plugins;
-}
-
 static bool pluginComparator(const QJsonObject &p1, const QJsonObject &p2)
 {
     const QString prio = QStringLiteral("Priority");
@@ -172,11 +306,29 @@ static bool pluginComparator(const QJsonObject &p1, const QJsonObject &p2)
     return (p1.value(prio).toDouble() > p2.value(prio).toDouble());
 }
 
+static PluginRegistry *discoveredPlugins(bool reload)
+{
+    PluginRegistry *registry = pluginRegistry();
+    if (reload || !registry->discovered) {
+        registry->plugins.clear();
+        QGeoPositionInfoSourcePrivate::loadPluginMetadata(registry->plugins);
+        registry->sorted = registry->plugins.values();
+        std::stable_sort(registry->sorted.begin(), registry->sorted.end(), pluginComparator);
+        registry->discovered = true;
+    }
+    return registry;
+}
+
+QMultiHash<QString, QJsonObject> QGeoPositionInfoSourcePrivate::plugins(bool reload)
+{
+    QMutexLocker locker(&pluginRegistry()->mutex);
+    return discoveredPlugins(reload)->plugins;
+}
+
 QList<QJsonObject> QGeoPositionInfoSourcePrivate::pluginsSorted()
 {
-    QList<QJsonObject> list = plugins().values();
-    std::stable_sort(list.begin(), list.end(), pluginComparator);
-    return list;
+    QMutexLocker locker(&pluginRegistry()->mutex);
+    return discoveredPlugins(false)->sorted;
 }
 
 void QGeoPositionInfoSourcePrivate::loadPluginMetadata(QMultiHash<QString, QJsonObject> &plugins)
@@ -207,6 +359,11 @@ QGeoPositionInfoSource::QGeoPositionInfoSource(QObject *parent)
     qRegisterMetaType<QGeoPositionInfo>();
     d->interval = 0;
     d->methods = {};
+    connect(this, &QGeoPositionInfoSource::positionUpdated, this,
+            [this](const QGeoPositionInfo &update) {
+        d->coalesce(this, update);
+        d->addToBatch(this, update);
+    });
 }
 
 /*!
@@ -292,6 +449,125 @@ int QGeoPositionInfoSource::updateInterval() const
     return d->interval;
 }
 
+/*!
+    \property QGeoPositionInfoSource::coalescingInterval
+    \brief This property holds the minimum interval in milliseconds between
+           two coalescedPositionUpdated() signals.
+
+    Updates arriving faster are not dropped: the newest of them is delivered
+    once the interval has passed. Unlike updateInterval, which is a hint
+    to the backend, this is enforced for every source.
+
+    The default value for this property is 0, no throttling.
+
+    \since 5.15
+    \sa coalescingDistance, coalescingHeading
+*/
+void QGeoPositionInfoSource::setCoalescingInterval(int msec)
+{
+    d->coalescingInterval = qMax(0, msec);
+}
+
+int QGeoPositionInfoSource::coalescingInterval() const
+{
+    return d->coalescingInterval;
+}
+
+/*!
+    \property QGeoPositionInfoSource::coalescingDistance
+    \brief This property holds the distance in meters the position has to
+           move from the last coalescedPositionUpdated() before it is emitted
+           again.
+
+    An update is significant if it exceeds either the distance or the
+    heading threshold. The default value for this property is 0, meaning
+    no distance threshold.
+
+    \since 5.15
+    \sa coalescingHeading
+*/
+void QGeoPositionInfoSource::setCoalescingDistance(qreal meters)
+{
+    d->coalescingDistance = qMax<qreal>(0, meters);
+}
+
+qreal QGeoPositionInfoSource::coalescingDistance() const
+{
+    return d->coalescingDistance;
+}
+
+/*!
+    \property QGeoPositionInfoSource::coalescingHeading
+    \brief This property holds the change in degrees of the
+           QGeoPositionInfo::Direction attribute from the last
+           coalescedPositionUpdated() that makes an update significant.
+
+    The default value for this property is 0, meaning no heading threshold.
+
+    \since 5.15
+    \sa coalescingDistance
+*/
+void QGeoPositionInfoSource::setCoalescingHeading(qreal degrees)
+{
+    d->coalescingHeading = qMax<qreal>(0, degrees);
+}
+
+qreal QGeoPositionInfoSource::coalescingHeading() const
+{
+    return d->coalescingHeading;
+}
+
+/*!
+    \property QGeoPositionInfoSource::batchInterval
+    \brief This property holds the longest time in milliseconds an update
+           waits before it is delivered with batchedPositionsUpdated().
+
+    Together with batchSize, this enables batched delivery for consumers
+    that record tracks and do not need a signal for every update. The timer
+    starts with the first update of a batch. Backends able to hold updates
+    back in hardware may use it as a hint; every source batches in software.
+
+    The default value for this property is 0. With it and a batchSize below
+    2, batchedPositionsUpdated() is not emitted. Changing the property
+    delivers the updates batched so far.
+
+    \since 5.15
+    \sa batchSize
+*/
+void QGeoPositionInfoSource::setBatchInterval(int msec)
+{
+    d->flushBatch(this);
+    d->batchInterval = qMax(0, msec);
+}
+
+int QGeoPositionInfoSource::batchInterval() const
+{
+    return d->batchInterval;
+}
+
+/*!
+    \property QGeoPositionInfoSource::batchSize
+    \brief This property holds the number of updates after which a batch is
+           delivered with batchedPositionsUpdated(), whether or not the
+           batchInterval has passed.
+
+    The default value for this property is 0, no limit. Changing the property
+    delivers the updates batched so far.
+
+    \since 5.15
+    \sa batchInterval
+*/
+void QGeoPositionInfoSource::setBatchSize(int updates)
+{
+    d->flushBatch(this);
+    d->batchSize = qMax(0, updates);
+}
+
+int QGeoPositionInfoSource::batchSize() const
+{
+    return d->batchSize;
+}
+
 /*!
     Sets the preferred positioning methods for this source to \a methods.
 
@@ -437,6 +713,11 @@ QGeoPositionInfoSource::QGeoPositionInfoSource(QGeoPositionInfoSourcePrivate &dd
     qRegisterMetaType<QGeoPositionInfo>();
     d->interval = 0;
     d->methods = NoPositioningMethods;
+    connect(this, &QGeoPositionInfoSource::positionUpdated, this,
+            [this](const QGeoPositionInfo &update) {
+        d->coalesce(this, update);
+        d->addToBatch(this, update);
+    });
 }
 
 /*!
@@ -566,6 +847,31 @@ QGeoPositionInfoSource::QGeoPositionInfoSource(QGeoPositionInfoSourcePrivate &dd
     The \a update value holds the value of the new update.
 */
 
+/*!
+    \fn void QGeoPositionInfoSource::coalescedPositionUpdated(const QGeoPositionInfo &update);
+
+    Emitted for the updates of positionUpdated() that pass the coalescingInterval,
+    coalescingDistance and coalescingHeading thresholds. Without thresholds, it
+    is emitted for every update. Consumers that redraw on every update can
+    connect to this signal to scale with the requested rate instead of the
+    rate of the positioning hardware. lastKnownPosition() is not affected.
+
+    \since 5.15
+*/
+
+/*!
+    \fn void QGeoPositionInfoSource::batchedPositionsUpdated(const QList<QGeoPositionInfo> &updates);
+
+    Emitted with the \a updates collected since the previous batch, in the
+    order they arrived, once the batchInterval has passed or batchSize of them
+    are available. Each update is part of exactly one batch. Updates a
+    platform held back and delivered at once are all included, though only
+    the last of them is emitted with positionUpdated().
+
+    \since 5.15
+    \sa batchInterval, batchSize
+*/
+
 /*!
     \fn void QGeoPositionInfoSource::updateTimeout();
 
@@ -53,6 +53,11 @@ class Q_POSITIONING_EXPORT QGeoPositionInfoSource : public QObject
     Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval)
     Q_PROPERTY(int minimumUpdateInterval READ minimumUpdateInterval)
     Q_PROPERTY(QString sourceName READ sourceName)
+    Q_PROPERTY(int coalescingInterval READ coalescingInterval WRITE setCoalescingInterval)
+    Q_PROPERTY(qreal coalescingDistance READ coalescingDistance WRITE setCoalescingDistance)
+    Q_PROPERTY(qreal coalescingHeading READ coalescingHeading WRITE setCoalescingHeading)
+    Q_PROPERTY(int batchInterval READ batchInterval WRITE setBatchInterval)
+    Q_PROPERTY(int batchSize READ batchSize WRITE setBatchSize)
 
 public:
     enum Error {
@@ -87,6 +92,18 @@ public:
 
     QString sourceName() const;
 
+    void setCoalescingInterval(int msec);
+    int coalescingInterval() const;
+    void setCoalescingDistance(qreal meters);
+    qreal coalescingDistance() const;
+    void setCoalescingHeading(qreal degrees);
+    qreal coalescingHeading() const;
+
+    void setBatchInterval(int msec);
+    int batchInterval() const;
+    void setBatchSize(int updates);
+    int batchSize() const;
+
     bool setBackendProperty(const QString &name, const QVariant &value);
     QVariant backendProperty(const QString &name) const;
 
@@ -108,6 +125,8 @@ Q_SIGNALS:
     void updateTimeout();
     void error(QGeoPositionInfoSource::Error);
     void supportedPositioningMethodsChanged();
+    void coalescedPositionUpdated(const QGeoPositionInfo &update);
+    void batchedPositionsUpdated(const QList<QGeoPositionInfo> &updates);
 
 protected:
     explicit QGeoPositionInfoSource(QGeoPositionInfoSourcePrivate &dd, QObject *parent);
@@ -58,9 +58,12 @@
 #include <QString>
 #include <QMultiHash>
 #include <QList>
+#include <QElapsedTimer>
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 class Q_POSITIONING_PRIVATE_EXPORT QGeoPositionInfoSourcePrivate
 {
 public:
@@ -74,6 +77,30 @@ public:
     QGeoPositionInfoSourceFactoryV2 *factoryV2 = nullptr;
     QString providerName;
 
+    // coalescedPositionUpdated() throttling
+    int coalescingInterval = 0;
+    qreal coalescingDistance = 0;
+    qreal coalescingHeading = 0;
+    QGeoPositionInfo lastCoalesced;
+    QGeoPositionInfo pendingCoalesced;
+    QElapsedTimer coalescingClock;
+    QTimer *coalescingTimer = nullptr;
+
+    void coalesce(QGeoPositionInfoSource *source, const QGeoPositionInfo &update);
+    void emitCoalesced(QGeoPositionInfoSource *source, const QGeoPositionInfo &update);
+
+    // batchedPositionsUpdated() accumulation
+    int batchInterval = 0;
+    int batchSize = 0;
+    QList<QGeoPositionInfo> batch;
+    QTimer *batchTimer = nullptr;
+
+    bool isBatching() const { return batchInterval > 0 || batchSize > 1; }
+    void addToBatch(QGeoPositionInfoSource *source, const QGeoPositionInfo &update);
+    void deliverPositions(QGeoPositionInfoSource *source, const QList<QGeoPositionInfo> &updates);
+    void appendToBatch(QGeoPositionInfoSource *source, const QList<QGeoPositionInfo> &updates);
+    void flushBatch(QGeoPositionInfoSource *source);
+
     void loadMeta();
     void loadPlugin();
     virtual bool setBackendProperty(const QString &name, const QVariant &value);
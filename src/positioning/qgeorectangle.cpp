@@ -46,6 +46,7 @@
 #include "qnumeric.h"
 #include "qlocationutils_p.h"
 #include <QList>
+#include <QtCore/private/qsimd_p.h>
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -604,19 +605,9 @@ double QGeoRectangle::height() const
     return d->topLeft.latitude() - d->bottomRight.latitude();
 }
 
-bool QGeoRectanglePrivate::contains(const QGeoCoordinate &coordinate) const
+static inline bool qgeorectangle_contains(double lat, double lon,
+                                          double top, double left, double bottom, double right)
 {
-    if (!isValid() || !coordinate.isValid())
-        return false;
-
-    double left = topLeft.longitude();
-    double right = bottomRight.longitude();
-    double top = topLeft.latitude();
-    double bottom = bottomRight.latitude();
-
-    double lon = coordinate.longitude();
-    double lat = coordinate.latitude();
-
     if (lat > top)
         return false;
     if (lat < bottom)
@@ -639,6 +630,74 @@ bool QGeoRectanglePrivate::contains(const QGeoCoordinate &coordinate) const
     return true;
 }
 
+bool QGeoRectanglePrivate::contains(const QGeoCoordinate &coordinate) const
+{
+    if (!isValid() || !coordinate.isValid())
+        return false;
+
+    return qgeorectangle_contains(coordinate.latitude(), coordinate.longitude(),
+                                  topLeft.latitude(), topLeft.longitude(),
+                                  bottomRight.latitude(), bottomRight.longitude());
+}
+
+void QGeoRectanglePrivate::containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const
+{
+    const int count = coordinates.size();
+    memset(mask, 0, size_t(count + 7) / 8);
+    if (!isValid())
+        return;
+
+    const double left = topLeft.longitude();
+    const double right = bottomRight.longitude();
+    const double top = topLeft.latitude();
+    const double bottom = bottomRight.latitude();
+    const QGeoPackedCoordinate *p = coordinates.data();
+    int i = 0;
+
+#ifdef __SSE2__
+    // Two coordinates per step. The comparisons are false for NaN and the
+    // latitude range lies within [-90, 90], so invalid coordinates drop out.
+    const __m128d vLeft = _mm_set1_pd(left);
+    const __m128d vRight = _mm_set1_pd(right);
+    const __m128d vTop = _mm_set1_pd(top);
+    const __m128d vBottom = _mm_set1_pd(bottom);
+    const __m128d vMinLon = _mm_set1_pd(-180.0);
+    const __m128d vMaxLon = _mm_set1_pd(180.0);
+    const __m128d vNorth = _mm_set1_pd(90.0);
+    const __m128d vSouth = _mm_set1_pd(-90.0);
+    const __m128d topIsNorth = _mm_cmpeq_pd(vTop, vNorth);
+    const __m128d bottomIsSouth = _mm_cmpeq_pd(vBottom, vSouth);
+    const bool wraps = left > right;
+
+    for (; i + 2 <= count; i += 2) {
+        const __m128d lat = _mm_set_pd(p[i + 1].latitude, p[i].latitude);
+        const __m128d lon = _mm_set_pd(p[i + 1].longitude, p[i].longitude);
+
+        const __m128d inLat = _mm_and_pd(_mm_cmple_pd(lat, vTop), _mm_cmpge_pd(lat, vBottom));
+        const __m128d validLon = _mm_and_pd(_mm_cmpge_pd(lon, vMinLon), _mm_cmple_pd(lon, vMaxLon));
+        const __m128d afterLeft = _mm_cmpge_pd(lon, vLeft);
+        const __m128d beforeRight = _mm_cmple_pd(lon, vRight);
+        const __m128d inLon = wraps ? _mm_or_pd(afterLeft, beforeRight)
+                                    : _mm_and_pd(afterLeft, beforeRight);
+        // a pole on the edge of the rectangle is inside at any longitude
+        const __m128d atPole = _mm_or_pd(_mm_and_pd(_mm_cmpeq_pd(lat, vNorth), topIsNorth),
+                                         _mm_and_pd(_mm_cmpeq_pd(lat, vSouth), bottomIsSouth));
+
+        const __m128d inside = _mm_and_pd(_mm_and_pd(inLat, validLon), _mm_or_pd(inLon, atPole));
+        mask[i >> 3] |= uchar(_mm_movemask_pd(inside) << (i & 7));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const double lat = p[i].latitude;
+        const double lon = p[i].longitude;
+        if (QLocationUtils::isValidLat(lat) && QLocationUtils::isValidLong(lon)
+                && qgeorectangle_contains(lat, lon, top, left, bottom, right)) {
+            mask[i >> 3] |= uchar(1u << (i & 7));
+        }
+    }
+}
+
 QGeoCoordinate QGeoRectanglePrivate::center() const
 {
     if (!isValid())
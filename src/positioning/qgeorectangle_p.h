@@ -67,6 +67,7 @@ public:
     bool isValid() const override;
     bool isEmpty() const override;
     bool contains(const QGeoCoordinate &coordinate) const override;
+    void containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const override;
 
     QGeoCoordinate center() const override;
 
@@ -198,7 +198,7 @@ int QGeoSatelliteInfo::signalStrength() const
 */
 void QGeoSatelliteInfo::setAttribute(Attribute attribute, qreal value)
 {
-    d->doubleAttribs[int(attribute)] = value;
+    d->doubleAttribs.insert(attribute, value);
 }
 
 /*!
@@ -210,9 +210,7 @@ void QGeoSatelliteInfo::setAttribute(Attribute attribute, qreal value)
 */
 qreal QGeoSatelliteInfo::attribute(Attribute attribute) const
 {
-    if (d->doubleAttribs.contains(int(attribute)))
-        return d->doubleAttribs[int(attribute)];
-    return -1;
+    return d->doubleAttribs.value(attribute, -1);
 }
 
 /*!
@@ -220,7 +218,7 @@ qreal QGeoSatelliteInfo::attribute(Attribute attribute) const
 */
 void QGeoSatelliteInfo::removeAttribute(Attribute attribute)
 {
-    d->doubleAttribs.remove(int(attribute));
+    d->doubleAttribs.remove(attribute);
 }
 
 /*!
@@ -228,7 +226,7 @@ void QGeoSatelliteInfo::removeAttribute(Attribute attribute)
 */
 bool QGeoSatelliteInfo::hasAttribute(Attribute attribute) const
 {
-    return d->doubleAttribs.contains(int(attribute));
+    return d->doubleAttribs.contains(attribute);
 }
 
 #ifndef QT_NO_DEBUG_STREAM
@@ -240,7 +238,7 @@ QDebug operator<<(QDebug dbg, const QGeoSatelliteInfo &info)
     dbg << ", signal-strength=" << info.d->signal;
 
 
-    QList<int> attribs = info.d->doubleAttribs.keys();
+    const QList<QGeoSatelliteInfo::Attribute> attribs = info.d->doubleAttribs.keys();
     for (int i = 0; i < attribs.count(); ++i) {
         dbg << ", ";
         switch (attribs[i]) {
@@ -251,7 +249,7 @@ QDebug operator<<(QDebug dbg, const QGeoSatelliteInfo &info)
                 dbg << "Azimuth=";
                 break;
         }
-        dbg << info.d->doubleAttribs[attribs[i]];
+        dbg << info.d->doubleAttribs.value(attribs[i], -1);
     }
     dbg << ')';
     return dbg;
@@ -272,7 +270,7 @@ QDebug operator<<(QDebug dbg, const QGeoSatelliteInfo &info)
 QDataStream &operator<<(QDataStream &stream, const QGeoSatelliteInfo &info)
 {
     stream << info.d->signal;
-    stream << info.d->doubleAttribs;
+    stream << info.d->doubleAttribs.toHash<int>();
     stream << info.d->satId;
     stream << int(info.d->system);
     return stream;
@@ -294,7 +292,9 @@ QDataStream &operator>>(QDataStream &stream, QGeoSatelliteInfo &info)
 {
     int system;
     stream >> info.d->signal;
-    stream >> info.d->doubleAttribs;
+    QHash<int, qreal> attribs;
+    stream >> attribs;
+    info.d->doubleAttribs.setHash(attribs);
     stream >> info.d->satId;
     stream >> system;
     info.d->system = (QGeoSatelliteInfo::SatelliteSystem)system;
@@ -41,8 +41,8 @@
 #define QGEOSATELLITEINFO_P_H
 
 #include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qgeoattributearray_p.h>
 #include <QtPositioning/qgeosatelliteinfo.h>
-#include <QHash>
 
 QT_BEGIN_NAMESPACE
 
@@ -59,7 +59,7 @@ public:
     int signal;
     int satId;
     QGeoSatelliteInfo::SatelliteSystem system;
-    QHash<int, qreal> doubleAttribs;
+    QGeoAttributeArray<QGeoSatelliteInfo::Attribute, QGeoSatelliteInfo::Azimuth + 1> doubleAttribs;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,181 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeosegmentindex_p.h"
+
+#include <QtCore/qmath.h>
+#include <algorithm>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+void QGeoSegmentIndex::Box::unite(const Box &other)
+{
+    minX = qMin(minX, other.minX);
+    minY = qMin(minY, other.minY);
+    maxX = qMax(maxX, other.maxX);
+    maxY = qMax(maxY, other.maxY);
+}
+
+double QGeoSegmentIndex::Box::distanceSquared(double x, double y) const
+{
+    const double dx = qMax(qMax(minX - x, x - maxX), 0.0);
+    const double dy = qMax(qMax(minY - y, y - maxY), 0.0);
+    return dx * dx + dy * dy;
+}
+
+void QGeoSegmentIndex::clear()
+{
+    m_points.clear();
+    m_levels.clear();
+}
+
+QGeoSegmentIndex::Box QGeoSegmentIndex::segmentBox(int segment) const
+{
+    const QDoubleVector2D &a = m_points.at(segment);
+    const QDoubleVector2D &b = m_points.at(segment + 1);
+    return Box { qMin(a.x(), b.x()), qMin(a.y(), b.y()), qMax(a.x(), b.x()), qMax(a.y(), b.y()) };
+}
+
+void QGeoSegmentIndex::append(const QDoubleVector2D &mercator)
+{
+    QDoubleVector2D p = mercator;
+    if (!m_points.isEmpty()) {
+        const double previous = m_points.last().x();
+        p.setX(p.x() - std::floor(p.x() - previous + 0.5));
+    }
+    m_points.append(p);
+    if (m_points.size() < 2)
+        return;
+
+    const Box box = segmentBox(m_points.size() - 2);
+    int node = m_points.size() - 2;
+    for (int level = 0; ; ++level) {
+        node /= NodeSize;
+        if (level == m_levels.size()) {
+            // new root, covering the whole level below
+            Box root = box;
+            if (level > 0) {
+                for (const Box &child : m_levels.at(level - 1))
+                    root.unite(child);
+            }
+            m_levels.append(QVector<Box>() << root);
+        } else if (node == m_levels.at(level).size()) {
+            m_levels[level].append(box);
+        } else {
+            m_levels[level][node].unite(box);
+        }
+        if (m_levels.at(level).size() == 1)
+            break;
+    }
+}
+
+void QGeoSegmentIndex::search(double x, double y, Closest *closest) const
+{
+    struct Entry
+    {
+        double distanceSquared;
+        int level;
+        int node;
+
+        bool operator<(const Entry &other) const
+        {
+            return distanceSquared > other.distanceSquared; // smallest first in the heap
+        }
+    };
+
+    const int top = m_levels.size() - 1;
+    std::vector<Entry> heap;
+    heap.push_back(Entry { m_levels.at(top).at(0).distanceSquared(x, y), top, 0 });
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        const Entry entry = heap.back();
+        heap.pop_back();
+        if (entry.distanceSquared >= closest->distanceSquared)
+            break;
+
+        const int first = entry.node * NodeSize;
+        if (entry.level == 0) {
+            const int last = qMin(first + int(NodeSize), m_points.size() - 1);
+            for (int segment = first; segment < last; ++segment) {
+                const QDoubleVector2D &a = m_points.at(segment);
+                const QDoubleVector2D &b = m_points.at(segment + 1);
+                const double dx = b.x() - a.x();
+                const double dy = b.y() - a.y();
+                const double lengthSquared = dx * dx + dy * dy;
+                double u = 0.0;
+                if (lengthSquared > 0.0)
+                    u = qBound(0.0, ((x - a.x()) * dx + (y - a.y()) * dy) / lengthSquared, 1.0);
+                const double ex = a.x() + u * dx - x;
+                const double ey = a.y() + u * dy - y;
+                const double d = ex * ex + ey * ey;
+                if (d < closest->distanceSquared)
+                    *closest = Closest { d, segment, u };
+            }
+        } else {
+            const QVector<Box> &children = m_levels.at(entry.level - 1);
+            const int last = qMin(first + int(NodeSize), children.size());
+            for (int child = first; child < last; ++child) {
+                const double d = children.at(child).distanceSquared(x, y);
+                if (d < closest->distanceSquared) {
+                    heap.push_back(Entry { d, entry.level - 1, child });
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+        }
+    }
+}
+
+int QGeoSegmentIndex::closestSegment(const QDoubleVector2D &mercator, double *fraction) const
+{
+    if (m_levels.isEmpty())
+        return -1;
+
+    // The unwrapped path can lie anywhere along x, so try every copy of the
+    // point within half a world of it.
+    const Box &root = m_levels.last().at(0);
+    Closest closest { qInf(), -1, 0.0 };
+    const double from = std::ceil(root.minX - 0.5 - mercator.x());
+    const double to = std::floor(root.maxX + 0.5 - mercator.x());
+    for (double shift = from; shift <= to; shift += 1.0)
+        search(mercator.x() + shift, mercator.y(), &closest);
+
+    if (fraction)
+        *fraction = closest.fraction;
+    return closest.segment;
+}
+
+QT_END_NAMESPACE
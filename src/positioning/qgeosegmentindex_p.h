@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOSEGMENTINDEX_P_H
+#define QGEOSEGMENTINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Bounding box hierarchy over the segments of a polyline in Web Mercator
+    space, answering closest segment queries in logarithmic time.
+
+    Consecutive segments of a path are close to each other, so the leaves
+    simply group NodeSize consecutive segments and every upper level groups
+    NodeSize consecutive nodes of the level below. Appending a point only
+    grows the boxes on the path to the root.
+
+    The x coordinates are unwrapped against the previous point, so that no
+    segment spans more than half the world, as for QGeoPath bounding boxes.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoSegmentIndex
+{
+public:
+    enum { NodeSize = 16 };
+
+    void clear();
+    void append(const QDoubleVector2D &mercator);
+
+    int size() const { return m_points.size(); }
+    const QDoubleVector2D &point(int index) const { return m_points.at(index); }
+
+    // Index of the segment from point(i) to point(i + 1) closest to mercator,
+    // or -1 with fewer than two points. fraction is the position of the
+    // closest point on that segment, between 0 and 1.
+    int closestSegment(const QDoubleVector2D &mercator, double *fraction) const;
+
+private:
+    struct Box
+    {
+        double minX, minY, maxX, maxY;
+
+        void unite(const Box &other);
+        double distanceSquared(double x, double y) const;
+    };
+
+    struct Closest
+    {
+        double distanceSquared;
+        int segment;
+        double fraction;
+    };
+
+    Box segmentBox(int segment) const;
+    void search(double x, double y, Closest *closest) const;
+
+    QVector<QDoubleVector2D> m_points;  // unwrapped
+    QVector<QVector<Box>> m_levels;     // m_levels[0] are the leaves, the last level is the root
+};
+
+Q_DECLARE_TYPEINFO(QGeoSegmentIndex, Q_MOVABLE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QGEOSEGMENTINDEX_P_H
@@ -44,6 +44,8 @@
 #include "qgeopath.h"
 #include "qgeopolygon.h"
 
+#include <QtCore/QBitArray>
+
 
 #ifndef QT_NO_DEBUG_STREAM
 #include <QtCore/QDebug>
@@ -69,6 +71,19 @@ bool QGeoShapePrivate::operator==(const QGeoShapePrivate &other) const
     return type == other.type;
 }
 
+void QGeoShapePrivate::freeze()
+{
+}
+
+void QGeoShapePrivate::containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const
+{
+    memset(mask, 0, size_t(coordinates.size() + 7) / 8);
+    for (int i = 0; i < coordinates.size(); ++i) {
+        if (contains(coordinates.at(i).toCoordinate()))
+            mask[i >> 3] |= uchar(1u << (i & 7));
+    }
+}
+
 /*!
     \class QGeoShape
     \inmodule QtPositioning
@@ -231,6 +246,29 @@ bool QGeoShape::contains(const QGeoCoordinate &coordinate) const
         return false;
 }
 
+/*!
+    Tests all of \a coordinates against this geo shape at once. Bit \e i of the
+    returned array is set if \a coordinates[i] is contained within the shape, as
+    reported by contains().
+
+    Rectangles, circles and polygons evaluate the whole list in one pass, which is
+    considerably faster than calling contains() for each coordinate.
+
+    \since 5.15
+*/
+QBitArray QGeoShape::contains(const QList<QGeoCoordinate> &coordinates) const
+{
+    Q_D(const QGeoShape);
+
+    if (!d)
+        return QBitArray(coordinates.size());
+
+    const QGeoPackedCoordinates packed = qPackCoordinates(coordinates);
+    QByteArray mask((packed.size() + 7) / 8, Qt::Uninitialized);
+    d->containsBatch(packed, reinterpret_cast<uchar *>(mask.data()));
+    return QBitArray::fromBits(mask.constData(), packed.size());
+}
+
 /*!
     Returns a QGeoRectangle representing the geographical bounding rectangle of the
     geo shape, that defines the latitudinal/longitudinal bounds of the geo shape.
@@ -449,6 +487,42 @@ QDataStream &operator>>(QDataStream &stream, QGeoShape &shape)
 }
 #endif
 
+QGeoFrozenShape::QGeoFrozenShape()
+{
+}
+
+QGeoFrozenShape::QGeoFrozenShape(const QGeoShape &shape)
+:   QGeoShape(shape)
+{
+    freeze();
+}
+
+QGeoFrozenShape::QGeoFrozenShape(QGeoShape &&shape)
+:   QGeoShape(shape)
+{
+    shape = QGeoShape();
+    freeze();
+}
+
+QGeoFrozenShape::~QGeoFrozenShape()
+{
+}
+
+void QGeoFrozenShape::freeze()
+{
+    // detaches unless this is the only owner, other copies may be read meanwhile
+    if (d_ptr)
+        d_ptr->freeze();
+}
+
+void QGeoFrozenShape::containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const
+{
+    if (d_ptr)
+        d_ptr.constData()->containsBatch(coordinates, mask);
+    else
+        memset(mask, 0, size_t(coordinates.size() + 7) / 8);
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qgeoshape.cpp"
@@ -40,11 +40,13 @@
 #ifndef QGEOSHAPE_H
 #define QGEOSHAPE_H
 
+#include <QtCore/QList>
 #include <QtCore/QSharedDataPointer>
 #include <QtPositioning/QGeoCoordinate>
 
 QT_BEGIN_NAMESPACE
 
+class QBitArray;
 class QDebug;
 class QGeoShapePrivate;
 class QGeoRectangle;
@@ -75,6 +77,7 @@ public:
     bool isValid() const;
     bool isEmpty() const;
     Q_INVOKABLE bool contains(const QGeoCoordinate &coordinate) const;
+    QBitArray contains(const QList<QGeoCoordinate> &coordinates) const;
     Q_INVOKABLE QGeoRectangle boundingGeoRectangle() const;
     Q_INVOKABLE QGeoCoordinate center() const;
 
@@ -94,6 +97,7 @@ protected:
 private:
     inline QGeoShapePrivate *d_func();
     inline const QGeoShapePrivate *d_func() const;
+    friend class QGeoShapePrivate;
 };
 
 Q_DECLARE_TYPEINFO(QGeoShape, Q_MOVABLE_TYPE);
@@ -54,6 +54,7 @@
 #include <QtCore/QSharedData>
 
 #include "qgeorectangle.h"
+#include "qgeopackedcoordinate_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -66,6 +67,9 @@ public:
     virtual bool isValid() const = 0;
     virtual bool isEmpty() const = 0;
     virtual bool contains(const QGeoCoordinate &coordinate) const = 0;
+    // Sets bit i of mask, least significant bit first within each byte, for
+    // every coordinates[i] inside the shape. mask holds (size + 7) / 8 bytes.
+    virtual void containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const;
 
     virtual QGeoCoordinate center() const = 0;
 
@@ -74,9 +78,14 @@ public:
     virtual void extendShape(const QGeoCoordinate &coordinate) = 0;
 
     virtual QGeoShapePrivate *clone() const = 0;
+    // Computes whatever the const API would otherwise build on first use.
+    virtual void freeze();
 
     virtual bool operator==(const QGeoShapePrivate &other) const;
 
+    static const QGeoShapePrivate *get(const QGeoShape &shape) { return shape.d_ptr.constData(); }
+    static QGeoShapePrivate *get(QGeoShape &shape) { return shape.d_ptr.data(); } // detaches
+
     QGeoShape::ShapeType type;
 };
 
@@ -88,6 +97,34 @@ Q_INLINE_TEMPLATE QGeoShapePrivate *QSharedDataPointer<QGeoShapePrivate>::clone(
     return d->clone();
 }
 
+// A shape with all its lazily built data computed up front. Only the const API
+// is exposed, so one snapshot can be read from several threads at once without
+// copying the coordinates for each of them.
+class Q_POSITIONING_PRIVATE_EXPORT QGeoFrozenShape : private QGeoShape
+{
+public:
+    QGeoFrozenShape();
+    explicit QGeoFrozenShape(const QGeoShape &shape);
+    explicit QGeoFrozenShape(QGeoShape &&shape); // avoids the copy if shape was the only owner
+    ~QGeoFrozenShape();
+
+    using QGeoShape::type;
+    using QGeoShape::isValid;
+    using QGeoShape::isEmpty;
+    using QGeoShape::contains;
+    using QGeoShape::boundingGeoRectangle;
+    using QGeoShape::center;
+    void containsBatch(QGeoCoordinateSpan coordinates, uchar *mask) const;
+
+    // shares the frozen data, modifying the result detaches it
+    QGeoShape shape() const { return *this; }
+
+private:
+    void freeze();
+};
+
+Q_DECLARE_TYPEINFO(QGeoFrozenShape, Q_MOVABLE_TYPE);
+
 QT_END_NAMESPACE
 
 #endif
@@ -0,0 +1,404 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeoshapeencoding_p.h"
+#include "qgeopath_p.h"
+#include "qgeopolygon_p.h"
+#include "qgeocircle.h"
+#include "qgeorectangle.h"
+
+#include <QtCore/qendian.h>
+#include <cmath>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+enum Flag {
+    HasAltitude = 0x1,
+    HasWidth = 0x2,
+    Invalid = 0x4   // a rectangle or circle without valid coordinates, nothing follows
+};
+
+const double AltitudeScale = 100.0; // centimeters
+const qint64 MaximumAltitude = Q_INT64_C(100000000000000000); // in AltitudeScale units
+
+const double Scales[QGeoShapeEncoding::MaximumPrecision + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+inline quint64 zigzag(qint64 value)
+{
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+inline qint64 unzigzag(quint64 value)
+{
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+// a decoded delta that keeps the value within limit, without overflowing
+inline bool addDelta(qint64 *value, quint64 encoded, qint64 limit)
+{
+    const qint64 delta = unzigzag(encoded);
+    if (delta > 2 * limit || delta < -2 * limit)
+        return false;
+    *value += delta;
+    return *value <= limit && *value >= -limit;
+}
+
+} // namespace
+
+void QGeoShapeEncoding::encodeVarint(quint64 value, QByteArray &out)
+{
+    char buffer[10];
+    int size = 0;
+    while (value >= 0x80) {
+        buffer[size++] = char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buffer[size++] = char(value);
+    out.append(buffer, size);
+}
+
+bool QGeoShapeEncoding::decodeVarint(const char *&data, const char *end, quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7) {
+        const uchar byte = uchar(*data++);
+        if (shift == 63 && byte > 1)
+            return false;
+        result |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+void QGeoShapeEncoding::encodeDouble(double value, QByteArray &out)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = qToLittleEndian(bits);
+    out.append(reinterpret_cast<const char *>(&bits), sizeof(bits));
+}
+
+bool QGeoShapeEncoding::decodeDouble(const char *&data, const char *end, double *value)
+{
+    if (end - data < qint64(sizeof(quint64)))
+        return false;
+    const quint64 bits = qFromLittleEndian<quint64>(data);
+    memcpy(value, &bits, sizeof(bits));
+    data += sizeof(bits);
+    return true;
+}
+
+bool QGeoShapeEncoding::decodeCount(const char *&data, const char *end, int minimumSize, int *count)
+{
+    quint64 value;
+    if (!decodeVarint(data, end, &value))
+        return false;
+    if (value > quint64(end - data) / quint64(qMax(minimumSize, 1)))
+        return false;
+    *count = int(value);
+    return true;
+}
+
+bool QGeoShapeEncoding::hasAltitude(QGeoCoordinateSpan coordinates)
+{
+    for (const QGeoPackedCoordinate &c : coordinates) {
+        if (!qIsNaN(c.altitude))
+            return true;
+    }
+    return false;
+}
+
+void QGeoShapeEncoding::encodeCoordinates(QGeoCoordinateSpan coordinates, int precision,
+                                          bool altitude, Delta *delta, QByteArray &out)
+{
+    Q_ASSERT(precision >= 0 && precision <= MaximumPrecision);
+    const double scale = Scales[precision];
+    for (const QGeoPackedCoordinate &c : coordinates) {
+        const qint64 latitude = qint64(std::llround(c.latitude * scale));
+        const qint64 longitude = qint64(std::llround(c.longitude * scale));
+        encodeVarint(zigzag(latitude - delta->latitude), out);
+        encodeVarint(zigzag(longitude - delta->longitude), out);
+        delta->latitude = latitude;
+        delta->longitude = longitude;
+        if (!altitude)
+            continue;
+
+        // 0 for no altitude, otherwise the delta from the last vertex with one plus 1
+        const double a = c.altitude * AltitudeScale;
+        if (!qIsFinite(a) || std::fabs(a) > double(MaximumAltitude)) {
+            encodeVarint(0, out);
+            continue;
+        }
+        const qint64 value = qint64(std::llround(a));
+        encodeVarint(zigzag(value - delta->altitude) + 1, out);
+        delta->altitude = value;
+    }
+}
+
+bool QGeoShapeEncoding::decodeCoordinates(const char *&data, const char *end, int count,
+                                          int precision, bool altitude, Delta *delta,
+                                          QGeoPackedCoordinate *out)
+{
+    if (precision < 0 || precision > MaximumPrecision)
+        return false;
+    const double scale = Scales[precision];
+    const qint64 maximumLatitude = 90 * qint64(scale);
+    const qint64 maximumLongitude = 180 * qint64(scale);
+    for (int i = 0; i < count; ++i) {
+        quint64 latitude, longitude;
+        if (!decodeVarint(data, end, &latitude) || !decodeVarint(data, end, &longitude))
+            return false;
+        if (!addDelta(&delta->latitude, latitude, maximumLatitude)
+                || !addDelta(&delta->longitude, longitude, maximumLongitude)) {
+            return false;
+        }
+        QGeoPackedCoordinate &c = out[i];
+        c.latitude = double(delta->latitude) / scale;
+        c.longitude = double(delta->longitude) / scale;
+        c.altitude = qQNaN();
+        if (!altitude)
+            continue;
+
+        quint64 value;
+        if (!decodeVarint(data, end, &value))
+            return false;
+        if (value == 0)
+            continue;
+        if (!addDelta(&delta->altitude, value - 1, MaximumAltitude))
+            return false;
+        c.altitude = double(delta->altitude) / AltitudeScale;
+    }
+    return true;
+}
+
+void QGeoShapeEncoding::encode(const QGeoShape &shape, QByteArray &out, int precision)
+{
+    precision = qBound(0, precision, int(MaximumPrecision));
+    const int header = out.size();
+    out.append(char(Version));
+    out.append(char(shape.type()));
+    out.append(char(0));
+    out.append(char(precision));
+    uchar flags = 0;
+
+    Delta delta;
+    switch (shape.type()) {
+    case QGeoShape::UnknownType:
+        break;
+    case QGeoShape::RectangleType: {
+        const QGeoRectangle rectangle(shape);
+        if (!rectangle.isValid()) {
+            flags |= Invalid;
+            break;
+        }
+        const QGeoPackedCoordinate corners[] = {
+            QGeoPackedCoordinate::fromCoordinate(rectangle.topLeft()),
+            QGeoPackedCoordinate::fromCoordinate(rectangle.bottomRight())
+        };
+        encodeCoordinates(QGeoCoordinateSpan(corners, 2), precision, false, &delta, out);
+        break;
+    }
+    case QGeoShape::CircleType: {
+        const QGeoCircle circle(shape);
+        if (!circle.isValid()) {
+            flags |= Invalid;
+            break;
+        }
+        const QGeoPackedCoordinate center = QGeoPackedCoordinate::fromCoordinate(circle.center());
+        const bool altitude = !qIsNaN(center.altitude);
+        if (altitude)
+            flags |= HasAltitude;
+        encodeCoordinates(QGeoCoordinateSpan(&center, 1), precision, altitude, &delta, out);
+        encodeDouble(circle.radius(), out);
+        break;
+    }
+    case QGeoShape::PathType: {
+        const QGeoCoordinateSpan vertices = QGeoPathPrivate::vertices(shape);
+        const bool altitude = hasAltitude(vertices);
+        const qreal width = QGeoPath(shape).width();
+        if (altitude)
+            flags |= HasAltitude;
+        if (width != 0)
+            flags |= HasWidth;
+        encodeVarint(quint64(vertices.size()), out);
+        encodeCoordinates(vertices, precision, altitude, &delta, out);
+        if (width != 0)
+            encodeDouble(width, out);
+        break;
+    }
+    case QGeoShape::PolygonType: {
+        const QGeoPolygon polygon(shape);
+        const int holes = polygon.holesCount();
+        bool altitude = hasAltitude(QGeoPathPrivate::vertices(polygon));
+        for (int i = 0; i < holes && !altitude; ++i)
+            altitude = hasAltitude(QGeoPolygonPrivate::holeVertices(polygon, i));
+        if (altitude)
+            flags |= HasAltitude;
+        // the rings follow each other, the deltas continue from one to the next
+        encodeVarint(quint64(1 + holes), out);
+        for (int i = 0; i <= holes; ++i) {
+            const QGeoCoordinateSpan ring = i ? QGeoPolygonPrivate::holeVertices(polygon, i - 1)
+                                              : QGeoPathPrivate::vertices(polygon);
+            encodeVarint(quint64(ring.size()), out);
+            encodeCoordinates(ring, precision, altitude, &delta, out);
+        }
+        break;
+    }
+    }
+    out[header + 2] = char(flags);
+}
+
+QByteArray QGeoShapeEncoding::encode(const QGeoShape &shape, int precision)
+{
+    QByteArray out;
+    encode(shape, out, precision);
+    return out;
+}
+
+bool QGeoShapeEncoding::decode(const char *data, qint64 size, QGeoShape *shape, qint64 *consumed)
+{
+    const char *it = data;
+    const char *end = data + size;
+    if (size < 4)
+        return false;
+    const int version = uchar(*it++);
+    const int type = uchar(*it++);
+    const uchar flags = uchar(*it++);
+    const int precision = uchar(*it++);
+    if (version < 1 || version > Version || precision > MaximumPrecision)
+        return false;
+    const bool altitude = flags & HasAltitude;
+    const int coordinateSize = altitude ? 3 : 2; // the least a coordinate takes
+
+    Delta delta;
+    switch (type) {
+    case QGeoShape::UnknownType:
+        *shape = QGeoShape();
+        break;
+    case QGeoShape::RectangleType: {
+        if (flags & Invalid) {
+            *shape = QGeoRectangle();
+            break;
+        }
+        QGeoPackedCoordinate corners[2];
+        if (!decodeCoordinates(it, end, 2, precision, false, &delta, corners))
+            return false;
+        *shape = QGeoRectangle(corners[0].toCoordinate(), corners[1].toCoordinate());
+        break;
+    }
+    case QGeoShape::CircleType: {
+        if (flags & Invalid) {
+            *shape = QGeoCircle();
+            break;
+        }
+        QGeoPackedCoordinate center;
+        double radius;
+        if (!decodeCoordinates(it, end, 1, precision, altitude, &delta, &center)
+                || !decodeDouble(it, end, &radius)) {
+            return false;
+        }
+        *shape = QGeoCircle(center.toCoordinate(), radius);
+        break;
+    }
+    case QGeoShape::PathType: {
+        int count;
+        if (!decodeCount(it, end, coordinateSize, &count))
+            return false;
+        QGeoPath path;
+        QGeoPathPrivate *d = static_cast<QGeoPathPrivate *>(QGeoShapePrivate::get(path));
+        d->m_path.resize(count);
+        if (!decodeCoordinates(it, end, count, precision, altitude, &delta, d->m_path.data()))
+            return false;
+        if (flags & HasWidth) {
+            double width;
+            if (!decodeDouble(it, end, &width))
+                return false;
+            d->setWidth(width);
+        }
+        d->invalidatePathCache();
+        d->markDirty();
+        *shape = path;
+        break;
+    }
+    case QGeoShape::PolygonType: {
+        int rings;
+        if (!decodeCount(it, end, 1, &rings) || rings < 1)
+            return false;
+        QGeoPolygon polygon;
+        QGeoPolygonPrivate *d = static_cast<QGeoPolygonPrivate *>(QGeoShapePrivate::get(polygon));
+        d->m_holesList.resize(rings - 1);
+        for (int i = 0; i < rings; ++i) {
+            QGeoPackedCoordinates &ring = i ? d->m_holesList[i - 1] : d->m_path;
+            int count;
+            if (!decodeCount(it, end, coordinateSize, &count))
+                return false;
+            ring.resize(count);
+            if (!decodeCoordinates(it, end, count, precision, altitude, &delta, ring.data()))
+                return false;
+        }
+        d->invalidatePathCache();
+        d->markDirty();
+        *shape = polygon;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    if (consumed)
+        *consumed = it - data;
+    return true;
+}
+
+bool QGeoShapeEncoding::decode(const QByteArray &data, QGeoShape *shape)
+{
+    qint64 consumed;
+    return decode(data.constData(), data.size(), shape, &consumed) && consumed == data.size();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOSHAPEENCODING_P_H
+#define QGEOSHAPEENCODING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qgeopackedcoordinate_p.h>
+#include <QtPositioning/qgeoshape.h>
+#include <QtCore/QByteArray>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    A compact, versioned binary encoding of shapes, for persisting many paths
+    and polygons. Unlike the QDataStream operators, which write every
+    coordinate as full precision doubles, coordinates are stored as fixed
+    point values with precision decimal digits, delta encoded from the
+    previous vertex and written as zigzag varints, like the polyline6 format
+    of OSRM. The default of 7 digits keeps positions to about a centimeter,
+    and altitudes are kept to a centimeter when any vertex has one.
+
+    A shape starts with the format version, the shape type, flags and the
+    precision, one byte each. Paths and polygons follow with the vertex count
+    of each ring, and the vertices. Decoding writes the vertices straight
+    into the packed storage of the QGeoPath or QGeoPolygon, without building
+    QGeoCoordinate objects.
+
+    The coordinate functions are shared with encodings of other types
+    holding paths, like routes.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoShapeEncoding
+{
+public:
+    enum {
+        Version = 1,
+        DefaultPrecision = 7,
+        MaximumPrecision = 9
+    };
+
+    // Appends the encoding of shape to out
+    static void encode(const QGeoShape &shape, QByteArray &out, int precision = DefaultPrecision);
+    static QByteArray encode(const QGeoShape &shape, int precision = DefaultPrecision);
+    // Decodes one shape from the start of data. Returns false for malformed
+    // data or a newer version, otherwise consumed is set to the bytes read.
+    static bool decode(const char *data, qint64 size, QGeoShape *shape, qint64 *consumed = nullptr);
+    static bool decode(const QByteArray &data, QGeoShape *shape);
+
+    // The previous vertex that coordinates are delta encoded from
+    struct Delta
+    {
+        qint64 latitude = 0;
+        qint64 longitude = 0;
+        qint64 altitude = 0;
+    };
+
+    static bool hasAltitude(QGeoCoordinateSpan coordinates);
+    static void encodeCoordinates(QGeoCoordinateSpan coordinates, int precision, bool altitude,
+                                  Delta *delta, QByteArray &out);
+    // Decodes count coordinates into out, advancing data. Returns false for
+    // malformed data or coordinates out of range.
+    static bool decodeCoordinates(const char *&data, const char *end, int count, int precision,
+                                  bool altitude, Delta *delta, QGeoPackedCoordinate *out);
+
+    static void encodeVarint(quint64 value, QByteArray &out);
+    static bool decodeVarint(const char *&data, const char *end, quint64 *value);
+    static void encodeDouble(double value, QByteArray &out);
+    static bool decodeDouble(const char *&data, const char *end, double *value);
+    // A count of items that take at least minimumSize bytes each, checked
+    // against the remaining data before anything is allocated for them
+    static bool decodeCount(const char *&data, const char *end, int minimumSize, int *count);
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOSHAPEENCODING_P_H
@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeostreamsimplifier_p.h"
+#include "qlocationutils_p.h"
+
+#include <QtCore/QtMath>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+QGeoStreamSimplifier::QGeoStreamSimplifier(double tolerance)
+    : m_tolerance(qMax(tolerance, 0.0))
+{
+}
+
+void QGeoStreamSimplifier::setTolerance(double tolerance)
+{
+    m_tolerance = qMax(tolerance, 0.0);
+    reset();
+}
+
+bool QGeoStreamSimplifier::add(const QGeoCoordinate &coordinate)
+{
+    if (!coordinate.isValid())
+        return false;
+    if (m_tolerance <= 0 || !m_anchor.isValid()) {
+        reset(coordinate);
+        return false;
+    }
+
+    double distance, direction;
+    project(coordinate, &distance, &direction);
+    if (!m_last.isValid()) {
+        m_last = coordinate;
+        narrow(distance, direction);
+        return false;
+    }
+
+    // The last vertex is dropped if it, and the ones dropped before it, are
+    // in the directions left and not beyond the new vertex
+    bool replaces = distance >= m_farthest - m_tolerance;
+    if (replaces && m_narrowed) {
+        const double relative = std::remainder(direction - m_reference, 2 * M_PI);
+        replaces = relative >= m_low && relative <= m_high;
+    }
+    if (!replaces) {
+        reset(m_last);
+        project(coordinate, &distance, &direction);
+    }
+    m_last = coordinate;
+    narrow(distance, direction);
+    return replaces;
+}
+
+void QGeoStreamSimplifier::reset(const QGeoCoordinate &anchor)
+{
+    m_anchor = anchor; // may be m_last
+    m_last = QGeoCoordinate();
+    m_metersPerDegreeLongitude = m_anchor.isValid()
+            ? qDegreesToRadians(QLocationUtils::earthMeanRadius())
+              * std::cos(qDegreesToRadians(m_anchor.latitude()))
+            : 0;
+    m_farthest = 0;
+    m_narrowed = false;
+}
+
+// In meters and radians, from the anchor on its tangent plane
+void QGeoStreamSimplifier::project(const QGeoCoordinate &coordinate, double *distance,
+                                   double *direction) const
+{
+    const double x = QLocationUtils::wrapLong(coordinate.longitude() - m_anchor.longitude())
+            * m_metersPerDegreeLongitude;
+    const double y = (coordinate.latitude() - m_anchor.latitude())
+            * qDegreesToRadians(QLocationUtils::earthMeanRadius());
+    *distance = std::hypot(x, y);
+    *direction = std::atan2(y, x);
+}
+
+// Any direction passes within tolerance of a vertex that near the anchor
+void QGeoStreamSimplifier::narrow(double distance, double direction)
+{
+    m_farthest = qMax(m_farthest, distance);
+    if (distance <= m_tolerance)
+        return;
+    const double halfWidth = std::asin(m_tolerance / distance);
+    if (!m_narrowed) {
+        m_reference = direction;
+        m_low = -halfWidth;
+        m_high = halfWidth;
+        m_narrowed = true;
+        return;
+    }
+    const double relative = std::remainder(direction - m_reference, 2 * M_PI);
+    m_low = qMax(m_low, relative - halfWidth);
+    m_high = qMin(m_high, relative + halfWidth);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOSTREAMSIMPLIFIER_P_H
+#define QGEOSTREAMSIMPLIFIER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/qgeocoordinate.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Simplifies a path as its vertices are appended, like a breadcrumb of the
+    positions received, instead of simplifying the whole path when drawing
+    it. The last vertex appended is replaced by the next one while the
+    vertices dropped since the last vertex kept stay within about
+    tolerance() meters of the segment from that vertex to the new one.
+
+    The check takes constant time: each vertex dropped narrows the range of
+    directions, seen from the last vertex kept, the next one can be in, and
+    the range is all that is kept of it.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoStreamSimplifier
+{
+public:
+    explicit QGeoStreamSimplifier(double tolerance = 0);
+
+    double tolerance() const { return m_tolerance; }
+    // Also restarts the path from no vertex
+    void setTolerance(double tolerance);
+
+    // Restarts the path from anchor, which is kept, or from no vertex
+    void reset(const QGeoCoordinate &anchor = QGeoCoordinate());
+    bool isEmpty() const { return !m_anchor.isValid(); }
+
+    // Returns true if coordinate replaces the last vertex appended, false
+    // if it follows it. A tolerance of 0 keeps every vertex.
+    bool add(const QGeoCoordinate &coordinate);
+
+private:
+    void project(const QGeoCoordinate &coordinate, double *distance, double *direction) const;
+    void narrow(double distance, double direction);
+
+    double m_tolerance;
+    QGeoCoordinate m_anchor; // the last vertex kept
+    QGeoCoordinate m_last; // the vertex after it, to be replaced, if any
+    double m_metersPerDegreeLongitude = 0; // at the anchor
+    double m_farthest = 0; // the distance from the anchor of the vertices dropped
+    double m_reference = 0; // the direction the range is relative to, in radians
+    double m_low = 0;
+    double m_high = 0;
+    bool m_narrowed = false; // the range is all directions until then
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOSTREAMSIMPLIFIER_P_H
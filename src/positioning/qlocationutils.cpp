@@ -46,6 +46,7 @@
 #include <QList>
 #include <QByteArray>
 #include <QDebug>
+#include <QtCore/private/qsimd_p.h>
 
 #include <math.h>
 
@@ -59,23 +60,101 @@ static double qlocationutils_nmeaDegreesToDecimal(double nmeaDegrees)
     return deg + (min / 60.0);
 }
 
+static inline bool qlocationutils_isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Returns the index of the first a or b in data from \a from, or size if there is none.
+static qint64 qlocationutils_indexOfEither(const char *data, qint64 from, qint64 size, char a, char b)
+{
+    qint64 i = from;
+#ifdef __SSE2__
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const uint mask = uint(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va),
+                                                               _mm_cmpeq_epi8(chunk, vb))));
+        if (mask)
+            return i + qCountTrailingZeroBits(mask);
+    }
+#endif
+    for (; i < size; ++i) {
+        if (data[i] == a || data[i] == b)
+            return i;
+    }
+    return size;
+}
+
+// XOR of all bytes, the NMEA checksum
+static uchar qlocationutils_xorBytes(const char *data, qint64 size)
+{
+    qint64 i = 0;
+    uchar result = 0;
+#ifdef __SSE2__
+    if (size >= 16) {
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 16 <= size; i += 16)
+            acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 2));
+        acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 1));
+        result = uchar(_mm_cvtsi128_si32(acc));
+    }
+#endif
+    for (; i < size; ++i)
+        result ^= uchar(data[i]);
+    return result;
+}
+
+static inline int qlocationutils_hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Parses up to 9 plain digits, which can neither overflow nor need locale handling.
+static bool qlocationutils_parseDigits(const char *data, int size, int *value)
+{
+    if (size <= 0 || size > 9)
+        return false;
+    int result = 0;
+    for (int i = 0; i < size; ++i) {
+        if (!qlocationutils_isDigit(data[i]))
+            return false;
+        result = result * 10 + (data[i] - '0');
+    }
+    *value = result;
+    return true;
+}
+
 static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo *info, double uere,
                                    bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtils::NmeaField parts[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(data, size, parts, QLocationUtils::MaxNmeaFields);
     QGeoCoordinate coord;
 
-    if (hasFix && parts.count() > 6 && parts[6].count() > 0)
-        *hasFix = parts[6].toInt() > 0;
+    if (hasFix && count > 6 && parts[6].size > 0) {
+        int fix = 0;
+        QLocationUtils::getNmeaInt(parts[6], &fix);
+        *hasFix = fix > 0;
+    }
 
-    if (parts.count() > 1 && parts[1].count() > 0) {
+    if (count > 1 && parts[1].size > 0) {
         QTime time;
         if (QLocationUtils::getNmeaTime(parts[1], &time))
             info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
     }
 
-    if (parts.count() > 5 && parts[3].count() == 1 && parts[5].count() == 1) {
+    if (count > 5 && parts[3].size == 1 && parts[5].size == 1) {
         double lat;
         double lng;
         if (QLocationUtils::getNmeaLatLong(parts[2], parts[3][0], parts[4], parts[5][0], &lat, &lng)) {
@@ -84,17 +163,15 @@ static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo
         }
     }
 
-    if (parts.count() > 8 && !parts[8].isEmpty()) {
-        bool hasHdop = false;
-        double hdop = parts[8].toDouble(&hasHdop);
-        if (hasHdop)
+    if (count > 8 && !parts[8].isEmpty()) {
+        double hdop;
+        if (QLocationUtils::getNmeaDouble(parts[8], &hdop))
             info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * hdop * uere);
     }
 
-    if (parts.count() > 9 && parts[9].count() > 0) {
-        bool hasAlt = false;
-        double alt = parts[9].toDouble(&hasAlt);
-        if (hasAlt)
+    if (count > 9 && parts[9].size > 0) {
+        double alt;
+        if (QLocationUtils::getNmeaDouble(parts[9], &alt))
             coord.setAltitude(alt);
     }
 
@@ -105,22 +182,24 @@ static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo
 static void qlocationutils_readGsa(const char *data, int size, QGeoPositionInfo *info, double uere,
                                    bool *hasFix)
 {
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
+    QLocationUtils::NmeaField parts[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(data, size, parts, QLocationUtils::MaxNmeaFields);
 
-    if (hasFix && parts.count() > 2 && !parts[2].isEmpty())
-        *hasFix = parts[2].toInt() > 0;
+    if (hasFix && count > 2 && !parts[2].isEmpty()) {
+        int fix = 0;
+        QLocationUtils::getNmeaInt(parts[2], &fix);
+        *hasFix = fix > 0;
+    }
 
-    if (parts.count() > 16 && !parts[16].isEmpty()) {
-        bool hasHdop = false;
-        double hdop = parts[16].toDouble(&hasHdop);
-        if (hasHdop)
+    if (count > 16 && !parts[16].isEmpty()) {
+        double hdop;
+        if (QLocationUtils::getNmeaDouble(parts[16], &hdop))
             info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * hdop * uere);
     }
 
-    if (parts.count() > 17 && !parts[17].isEmpty()) {
-        bool hasVdop = false;
-        double vdop = parts[17].toDouble(&hasVdop);
-        if (hasVdop)
+    if (count > 17 && !parts[17].isEmpty()) {
+        double vdop;
+        if (QLocationUtils::getNmeaDouble(parts[17], &vdop))
             info->setAttribute(QGeoPositionInfo::VerticalAccuracy, 2 * vdop * uere);
     }
 }
@@ -129,37 +208,36 @@ static void qlocationutils_readGsa(const char *data,
                                               int size,
                                               QList<int> &pnrsInUse)
 {
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
+    QLocationUtils::NmeaField parts[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(data, size, parts, QLocationUtils::MaxNmeaFields);
     pnrsInUse.clear();
-    if (parts.count() <= 2)
+    if (count <= 2)
         return;
-    bool ok;
-    for (int i = 3; i <= qMin(14, parts.size()); ++i) {
-        const QByteArray &pnrString = parts.at(i);
-        if (pnrString.isEmpty())
+    for (int i = 3; i <= qMin(14, count - 1); ++i) {
+        if (parts[i].isEmpty())
             continue;
-        int pnr = pnrString.toInt(&ok);
-        if (ok)
+        int pnr;
+        if (QLocationUtils::getNmeaInt(parts[i], &pnr))
             pnrsInUse.append(pnr);
     }
 }
 
 static void qlocationutils_readGll(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtils::NmeaField parts[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(data, size, parts, QLocationUtils::MaxNmeaFields);
     QGeoCoordinate coord;
 
-    if (hasFix && parts.count() > 6 && parts[6].count() > 0)
+    if (hasFix && count > 6 && parts[6].size > 0)
         *hasFix = (parts[6][0] == 'A');
 
-    if (parts.count() > 5 && parts[5].count() > 0) {
+    if (count > 5 && parts[5].size > 0) {
         QTime time;
         if (QLocationUtils::getNmeaTime(parts[5], &time))
             info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
     }
 
-    if (parts.count() > 4 && parts[2].count() == 1 && parts[4].count() == 1) {
+    if (count > 4 && parts[2].size == 1 && parts[4].size == 1) {
         double lat;
         double lng;
         if (QLocationUtils::getNmeaLatLong(parts[1], parts[2][0], parts[3], parts[4][0], &lat, &lng)) {
@@ -172,29 +250,43 @@ static void qlocationutils_readGll(const char *data, int size, QGeoPositionInfo
         info->setCoordinate(coord);
 }
 
+static QDate qlocationutils_readRmcDate(const QLocationUtils::NmeaField &field)
+{
+    int day;
+    int month;
+    int year;
+    if (qlocationutils_parseDigits(field.data, 2, &day)
+            && qlocationutils_parseDigits(field.data + 2, 2, &month)
+            && qlocationutils_parseDigits(field.data + 4, 2, &year)) {
+        // same as QDate::fromString(.., "ddMMyy"), which starts from 1900
+        return QDate(1900 + year, month, day);
+    }
+    return QDate::fromString(QString::fromLatin1(field.data, field.size), QStringLiteral("ddMMyy"));
+}
+
 static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtils::NmeaField parts[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(data, size, parts, QLocationUtils::MaxNmeaFields);
     QGeoCoordinate coord;
     QDate date;
     QTime time;
 
-    if (hasFix && parts.count() > 2 && parts[2].count() > 0)
+    if (hasFix && count > 2 && parts[2].size > 0)
         *hasFix = (parts[2][0] == 'A');
 
-    if (parts.count() > 9 && parts[9].count() == 6) {
-        date = QDate::fromString(QString::fromLatin1(parts[9]), QStringLiteral("ddMMyy"));
+    if (count > 9 && parts[9].size == 6) {
+        date = qlocationutils_readRmcDate(parts[9]);
         if (date.isValid())
             date = date.addYears(100);     // otherwise starts from 1900
         else
             date = QDate();
     }
 
-    if (parts.count() > 1 && parts[1].count() > 0)
+    if (count > 1 && parts[1].size > 0)
         QLocationUtils::getNmeaTime(parts[1], &time);
 
-    if (parts.count() > 6 && parts[4].count() == 1 && parts[6].count() == 1) {
+    if (count > 6 && parts[4].size == 1 && parts[6].size == 1) {
         double lat;
         double lng;
         if (QLocationUtils::getNmeaLatLong(parts[3], parts[4][0], parts[5], parts[6][0], &lat, &lng)) {
@@ -203,22 +295,18 @@ static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo
         }
     }
 
-    bool parsed = false;
     double value = 0.0;
-    if (parts.count() > 7 && parts[7].count() > 0) {
-        value = parts[7].toDouble(&parsed);
-        if (parsed)
+    if (count > 7 && parts[7].size > 0) {
+        if (QLocationUtils::getNmeaDouble(parts[7], &value))
             info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value * 1.852 / 3.6));    // knots -> m/s
     }
-    if (parts.count() > 8 && parts[8].count() > 0) {
-        value = parts[8].toDouble(&parsed);
-        if (parsed)
+    if (count > 8 && parts[8].size > 0) {
+        if (QLocationUtils::getNmeaDouble(parts[8], &value))
             info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
     }
-    if (parts.count() > 11 && parts[11].count() == 1
+    if (count > 11 && parts[11].size == 1
             && (parts[11][0] == 'E' || parts[11][0] == 'W')) {
-        value = parts[10].toDouble(&parsed);
-        if (parsed) {
+        if (QLocationUtils::getNmeaDouble(parts[10], &value)) {
             if (parts[11][0] == 'W')
                 value *= -1;
             info->setAttribute(QGeoPositionInfo::MagneticVariation, qreal(value));
@@ -236,19 +324,16 @@ static void qlocationutils_readVtg(const char *data, int size, QGeoPositionInfo
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtils::NmeaField parts[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(data, size, parts, QLocationUtils::MaxNmeaFields);
 
-    bool parsed = false;
     double value = 0.0;
-    if (parts.count() > 1 && parts[1].count() > 0) {
-        value = parts[1].toDouble(&parsed);
-        if (parsed)
+    if (count > 1 && parts[1].size > 0) {
+        if (QLocationUtils::getNmeaDouble(parts[1], &value))
             info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
     }
-    if (parts.count() > 7 && parts[7].count() > 0) {
-        value = parts[7].toDouble(&parsed);
-        if (parsed)
+    if (count > 7 && parts[7].size > 0) {
+        if (QLocationUtils::getNmeaDouble(parts[7], &value))
             info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value / 3.6));    // km/h -> m/s
     }
 }
@@ -258,20 +343,23 @@ static void qlocationutils_readZda(const char *data, int size, QGeoPositionInfo
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtils::NmeaField parts[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(data, size, parts, QLocationUtils::MaxNmeaFields);
     QDate date;
     QTime time;
 
-    if (parts.count() > 1 && parts[1].count() > 0)
+    if (count > 1 && parts[1].size > 0)
         QLocationUtils::getNmeaTime(parts[1], &time);
 
-    if (parts.count() > 4 && parts[2].count() > 0 && parts[3].count() > 0
-            && parts[4].count() == 4) {     // must be full 4-digit year
-        int day = parts[2].toUInt();
-        int month = parts[3].toUInt();
-        int year = parts[4].toUInt();
-        if (day > 0 && month > 0 && year > 0)
+    if (count > 4 && parts[2].size > 0 && parts[3].size > 0
+            && parts[4].size == 4) {     // must be full 4-digit year
+        uint day = 0;
+        uint month = 0;
+        uint year = 0;
+        QLocationUtils::getNmeaUInt(parts[2], &day);
+        QLocationUtils::getNmeaUInt(parts[3], &month);
+        QLocationUtils::getNmeaUInt(parts[4], &year);
+        if (int(day) > 0 && int(month) > 0 && int(year) > 0)
             date.setDate(year, month, day);
     }
 
@@ -283,28 +371,25 @@ QLocationUtils::NmeaSentence QLocationUtils::getNmeaSentenceType(const char *dat
     if (size < 6 || data[0] != '$' || !hasValidNmeaChecksum(data, size))
         return NmeaSentenceInvalid;
 
-    if (data[3] == 'G' && data[4] == 'G' && data[5] == 'A')
+    // the talker ID in data[1] and data[2] is ignored
+    switch ((uint(uchar(data[3])) << 16) | (uint(uchar(data[4])) << 8) | uint(uchar(data[5]))) {
+    case ('G' << 16) | ('G' << 8) | 'A':
         return NmeaSentenceGGA;
-
-    if (data[3] == 'G' && data[4] == 'S' && data[5] == 'A')
+    case ('G' << 16) | ('S' << 8) | 'A':
         return NmeaSentenceGSA;
-
-    if (data[3] == 'G' && data[4] == 'S' && data[5] == 'V')
+    case ('G' << 16) | ('S' << 8) | 'V':
         return NmeaSentenceGSV;
-
-    if (data[3] == 'G' && data[4] == 'L' && data[5] == 'L')
+    case ('G' << 16) | ('L' << 8) | 'L':
         return NmeaSentenceGLL;
-
-    if (data[3] == 'R' && data[4] == 'M' && data[5] == 'C')
+    case ('R' << 16) | ('M' << 8) | 'C':
         return NmeaSentenceRMC;
-
-    if (data[3] == 'V' && data[4] == 'T' && data[5] == 'G')
+    case ('V' << 16) | ('T' << 8) | 'G':
         return NmeaSentenceVTG;
-
-    if (data[3] == 'Z' && data[4] == 'D' && data[5] == 'A')
+    case ('Z' << 16) | ('D' << 8) | 'A':
         return NmeaSentenceZDA;
-
-    return NmeaSentenceInvalid;
+    default:
+        return NmeaSentenceInvalid;
+    }
 }
 
 bool QLocationUtils::getPosInfoFromNmea(const char *data, int size, QGeoPositionInfo *info,
@@ -361,27 +446,27 @@ QLocationUtils::GSVParseStatus QLocationUtils::getSatInfoFromNmea(const char *da
     if (nmeaType != NmeaSentenceGSV)
         return GSVNotParsed;
 
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
+    QLocationUtils::NmeaField parts[MaxNmeaFields];
+    const int count = splitNmeaFields(data, size, parts, MaxNmeaFields);
 
-    if (parts.count() <= 3) {
+    if (count <= 3) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
-    bool ok;
-    const int totalSentences = parts.at(1).toInt(&ok);
-    if (!ok) {
+    int totalSentences;
+    if (!getNmeaInt(parts[1], &totalSentences)) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
 
-    const int sentence = parts.at(2).toInt(&ok);
-    if (!ok) {
+    int sentence;
+    if (!getNmeaInt(parts[2], &sentence)) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
 
-    const int totalSats = parts.at(3).toInt(&ok);
-    if (!ok) {
+    int totalSats;
+    if (!getNmeaInt(parts[3], &totalSats)) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
@@ -391,17 +476,23 @@ QLocationUtils::GSVParseStatus QLocationUtils::getSatInfoFromNmea(const char *da
 
     const int numSatInSentence = qMin(sentence * 4, totalSats) - (sentence - 1) * 4;
 
+    // Missing trailing fields read as empty, i.e. unparsed.
+    const NmeaField missing = { data + size, 0 };
     int field = 4;
-    for (int i = 0; i < numSatInSentence; ++i) {
+    for (int i = 0; i < numSatInSentence; ++i, field += 4) {
         QGeoSatelliteInfo info;
-        const int prn = parts.at(field++).toInt(&ok);
-        info.setSatelliteIdentifier((ok) ? prn : 0);
-        const int elevation = parts.at(field++).toInt(&ok);
-        info.setAttribute(QGeoSatelliteInfo::Elevation, (ok) ? elevation : 0);
-        const int azimuth = parts.at(field++).toInt(&ok);
-        info.setAttribute(QGeoSatelliteInfo::Azimuth, (ok) ? azimuth : 0);
-        const int snr = parts.at(field++).toInt(&ok);
-        info.setSignalStrength((ok) ? snr : -1);
+        int prn;
+        const bool hasPrn = getNmeaInt(field < count ? parts[field] : missing, &prn);
+        info.setSatelliteIdentifier(hasPrn ? prn : 0);
+        int elevation;
+        const bool hasElevation = getNmeaInt(field + 1 < count ? parts[field + 1] : missing, &elevation);
+        info.setAttribute(QGeoSatelliteInfo::Elevation, hasElevation ? elevation : 0);
+        int azimuth;
+        const bool hasAzimuth = getNmeaInt(field + 2 < count ? parts[field + 2] : missing, &azimuth);
+        info.setAttribute(QGeoSatelliteInfo::Azimuth, hasAzimuth ? azimuth : 0);
+        int snr;
+        const bool hasSnr = getNmeaInt(field + 3 < count ? parts[field + 3] : missing, &snr);
+        info.setSignalStrength(hasSnr ? snr : -1);
         infos.append(info);
     }
 
@@ -433,49 +524,210 @@ bool QLocationUtils::getSatInUseFromNmea(const char *data, int size, QList<int>
 
 bool QLocationUtils::hasValidNmeaChecksum(const char *data, int size)
 {
-    int asteriskIndex = -1;
+    const int CSUM_LEN = 2;
+    const qint64 asteriskIndex = qlocationutils_indexOfEither(data, 0, size, '*', '*');
+    if (asteriskIndex + CSUM_LEN >= size)
+        return false;
+
+    // XOR byte value of all characters between '$' and '*'
+    const int result = asteriskIndex > 1 ? qlocationutils_xorBytes(data + 1, asteriskIndex - 1) : 0;
+    const int high = qlocationutils_hexDigit(data[asteriskIndex + 1]);
+    const int low = qlocationutils_hexDigit(data[asteriskIndex + 2]);
+    if (high < 0 || low < 0)
+        return false;
+    return high * 16 + low == result;
+}
+
+int QLocationUtils::splitNmeaSentences(const char *data, qint64 size, NmeaSentenceSpan *spans,
+                                       int maxSpans, qint64 *consumed)
+{
+    int count = 0;
+    qint64 pos = 0;
+    while (count < maxSpans && pos < size) {
+        const qint64 start = qlocationutils_indexOfEither(data, pos, size, '$', '$');
+        if (start == size) {
+            // only garbage left
+            pos = size;
+            break;
+        }
+        const qint64 end = qlocationutils_indexOfEither(data, start + 1, size, '\n', '$');
+        if (end - start >= MaxNmeaSentenceLength) {
+            pos = start + 1;
+            continue;
+        }
+        if (end == size) {
+            // incomplete, keep it for the next call
+            pos = start;
+            break;
+        }
+        if (data[end] == '$') {
+            // interrupted by the next sentence
+            pos = end;
+            continue;
+        }
+
+        NmeaSentenceSpan &span = spans[count++];
+        span.data = data + start;
+        span.size = int(end + 1 - start);
+        pos = end + 1;
+    }
+    if (consumed)
+        *consumed = pos;
+    return count;
+}
+
+int QLocationUtils::splitNmeaFields(const char *data, int size, NmeaField *fields, int maxFields)
+{
+    if (maxFields <= 0)
+        return 0;
+
+    int count = 0;
+    int start = 0;
     for (int i = 0; i < size; ++i) {
-        if (data[i] == '*') {
-            asteriskIndex = i;
+        if (data[i] != ',')
+            continue;
+        fields[count].data = data + start;
+        fields[count].size = i - start;
+        if (++count == maxFields)
+            return count;
+        start = i + 1;
+    }
+    fields[count].data = data + start;
+    fields[count].size = size - start;
+    return count + 1;
+}
+
+bool QLocationUtils::getNmeaInt(const NmeaField &field, int *value)
+{
+    const bool negative = field.size > 1 && field.data[0] == '-';
+    const int sign = (negative || (field.size > 1 && field.data[0] == '+')) ? 1 : 0;
+    int result;
+    if (qlocationutils_parseDigits(field.data + sign, field.size - sign, &result)) {
+        *value = negative ? -result : result;
+        return true;
+    }
+
+    // Whitespace, overlong numbers and the like
+    bool ok = false;
+    const int fallback = QByteArray(field.data, field.size).toInt(&ok);
+    if (ok)
+        *value = fallback;
+    return ok;
+}
+
+bool QLocationUtils::getNmeaUInt(const NmeaField &field, uint *value)
+{
+    const int sign = (field.size > 1 && field.data[0] == '+') ? 1 : 0;
+    int result;
+    if (qlocationutils_parseDigits(field.data + sign, field.size - sign, &result)) {
+        *value = uint(result);
+        return true;
+    }
+
+    bool ok = false;
+    const uint fallback = QByteArray(field.data, field.size).toUInt(&ok);
+    if (ok)
+        *value = fallback;
+    return ok;
+}
+
+bool QLocationUtils::getNmeaDouble(const NmeaField &field, double *value)
+{
+    // Plain decimals ([+-]digits[.digits]) with at most 15 significant digits
+    // and 22 decimals are exact as mantissa / 10^decimals, so a single
+    // division gives the correctly rounded result, same as strtod().
+    static const double powersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const int maxDecimals = int(sizeof(powersOf10) / sizeof(powersOf10[0])) - 1;
+
+    int i = 0;
+    bool negative = false;
+    if (field.size > 0 && (field.data[0] == '-' || field.data[0] == '+')) {
+        negative = field.data[0] == '-';
+        ++i;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int significantDigits = 0;
+    int decimals = -1;
+    bool plain = true;
+    for (; i < field.size; ++i) {
+        const char c = field.data[i];
+        if (qlocationutils_isDigit(c)) {
+            ++digits;
+            if (decimals >= 0)
+                ++decimals;
+            if (mantissa || c != '0')
+                ++significantDigits;
+            mantissa = mantissa * 10 + quint64(c - '0');
+            if (significantDigits > 15 || decimals > maxDecimals) {
+                plain = false;
+                break;
+            }
+        } else if (c == '.' && decimals < 0) {
+            decimals = 0;
+        } else {
+            plain = false;
             break;
         }
     }
 
-    const int CSUM_LEN = 2;
-    if (asteriskIndex < 0 || asteriskIndex + CSUM_LEN >= size)
-        return false;
+    if (plain && digits > 0) {
+        double result = double(mantissa);
+        if (decimals > 0)
+            result /= powersOf10[decimals];
+        *value = negative ? -result : result;
+        return true;
+    }
 
-    // XOR byte value of all characters between '$' and '*'
-    int result = 0;
-    for (int i = 1; i < asteriskIndex; ++i)
-        result ^= data[i];
-    /*
-        char calc[CSUM_LEN + 1];
-        ::snprintf(calc, CSUM_LEN + 1, "%02x", result);
-        return ::strncmp(calc, &data[asteriskIndex+1], 2) == 0;
-        */
-
-    QByteArray checkSumBytes(&data[asteriskIndex + 1], 2);
+    // Exponents, whitespace, nan/inf and overlong numbers
     bool ok = false;
-    int checksum = checkSumBytes.toInt(&ok,16);
-    return ok && checksum == result;
+    const double fallback = QByteArray(field.data, field.size).toDouble(&ok);
+    if (ok)
+        *value = fallback;
+    return ok;
 }
 
 bool QLocationUtils::getNmeaTime(const QByteArray &bytes, QTime *time)
 {
-    int dotIndex = bytes.indexOf('.');
-    QTime tempTime;
+    const NmeaField field = { bytes.constData(), bytes.size() };
+    return getNmeaTime(field, time);
+}
 
-    if (dotIndex < 0) {
-        tempTime = QTime::fromString(QString::fromLatin1(bytes.constData()),
-                                     QStringLiteral("hhmmss"));
+bool QLocationUtils::getNmeaTime(const NmeaField &field, QTime *time)
+{
+    int dotIndex = -1;
+    for (int i = 0; i < field.size; ++i) {
+        if (field.data[i] == '.') {
+            dotIndex = i;
+            break;
+        }
+    }
+    const int timeLen = dotIndex < 0 ? field.size : dotIndex;
+
+    QTime tempTime;
+    int hours;
+    int minutes;
+    int seconds;
+    if (timeLen == 6
+            && qlocationutils_parseDigits(field.data, 2, &hours)
+            && qlocationutils_parseDigits(field.data + 2, 2, &minutes)
+            && qlocationutils_parseDigits(field.data + 4, 2, &seconds)) {
+        // same as QTime::fromString(.., "hhmmss"), invalid values give an invalid time
+        tempTime = QTime(hours, minutes, seconds);
     } else {
-        tempTime = QTime::fromString(QString::fromLatin1(bytes.mid(0, dotIndex)),
+        tempTime = QTime::fromString(QString::fromLatin1(field.data, timeLen),
                                      QStringLiteral("hhmmss"));
-        bool hasMsecs = false;
-        int midLen = qMin(3, bytes.size() - dotIndex - 1);
-        int msecs = bytes.mid(dotIndex + 1, midLen).toUInt(&hasMsecs);
-        if (hasMsecs)
+    }
+
+    if (dotIndex >= 0) {
+        int midLen = qMin(3, field.size - dotIndex - 1);
+        const NmeaField msecsField = { field.data + dotIndex + 1, midLen };
+        uint msecs;
+        if (getNmeaUInt(msecsField, &msecs))
             tempTime = tempTime.addMSecs(msecs*(midLen == 3 ? 1 : midLen == 2 ? 10 : 100));
     }
 
@@ -487,17 +739,22 @@ bool QLocationUtils::getNmeaTime(const QByteArray &bytes, QTime *time)
 }
 
 bool QLocationUtils::getNmeaLatLong(const QByteArray &latString, char latDirection, const QByteArray &lngString, char lngDirection, double *lat, double *lng)
+{
+    const NmeaField latField = { latString.constData(), latString.size() };
+    const NmeaField lngField = { lngString.constData(), lngString.size() };
+    return getNmeaLatLong(latField, latDirection, lngField, lngDirection, lat, lng);
+}
+
+bool QLocationUtils::getNmeaLatLong(const NmeaField &latString, char latDirection, const NmeaField &lngString, char lngDirection, double *lat, double *lng)
 {
     if ((latDirection != 'N' && latDirection != 'S')
             || (lngDirection != 'E' && lngDirection != 'W')) {
         return false;
     }
 
-    bool hasLat = false;
-    bool hasLong = false;
-    double tempLat = latString.toDouble(&hasLat);
-    double tempLng = lngString.toDouble(&hasLong);
-    if (hasLat && hasLong) {
+    double tempLat;
+    double tempLng;
+    if (getNmeaDouble(latString, &tempLat) && getNmeaDouble(lngString, &tempLng)) {
         tempLat = qlocationutils_nmeaDegreesToDecimal(tempLat);
         if (latDirection == 'S')
             tempLat *= -1;
@@ -515,4 +772,3 @@ bool QLocationUtils::getNmeaLatLong(const QByteArray &latString, char latDirecti
 }
 
 QT_END_NAMESPACE
-
@@ -99,6 +99,32 @@ public:
         NmeaSentenceGSV  // Per-Satellite Info
     };
 
+    /*
+        A field of an NMEA sentence. Points into the sentence data, nothing is copied.
+    */
+    struct NmeaField
+    {
+        const char *data;
+        int size;
+
+        bool isEmpty() const { return size == 0; }
+        char operator[](int i) const { return data[i]; }
+    };
+
+    enum { MaxNmeaFields = 32 }; // NMEA sentences are at most 82 characters
+
+    /*
+        A complete sentence found by splitNmeaSentences(), from the '$' up to
+        and including the '\n'. Points into the buffer, nothing is copied.
+    */
+    struct NmeaSentenceSpan
+    {
+        const char *data;
+        int size;
+    };
+
+    enum { MaxNmeaSentenceLength = 1024 }; // longer lines are dropped as garbage
+
     inline static bool isValidLat(double lat) {
         return lat >= -90.0 && lat <= 90.0;
     }
@@ -318,10 +344,39 @@ public:
     */
     static bool hasValidNmeaChecksum(const char *data, int size);
 
+    /*
+        Finds the complete sentences in a buffer of NMEA data, scanning 16
+        bytes at a time where SSE2 is available. Checksums are left to the
+        parsers, which validate them anyway.
+        Writes at most maxSpans spans and returns their number. Data before a
+        '$', sentences interrupted by another '$' and overlong lines are
+        skipped. consumed is set to the number of bytes that were handled;
+        the rest starts an incomplete sentence and should be passed again
+        once more data has arrived.
+    */
+    static int splitNmeaSentences(const char *data, qint64 size, NmeaSentenceSpan *spans,
+                                  int maxSpans, qint64 *consumed);
+
+    /*
+        Splits an NMEA sentence at ',' into at most maxFields fields, like
+        QByteArray::split() but without allocating. Returns the number of fields.
+    */
+    static int splitNmeaFields(const char *data, int size, NmeaField *fields, int maxFields);
+
+    /*
+        Locale independent parsing of a whole field, giving the same results
+        as QByteArray::toInt(), toUInt() and toDouble() without allocating for
+        the plain numbers found in NMEA sentences.
+    */
+    static bool getNmeaInt(const NmeaField &field, int *value);
+    static bool getNmeaUInt(const NmeaField &field, uint *value);
+    static bool getNmeaDouble(const NmeaField &field, double *value);
+
     /*
         Returns time from a string in hhmmss or hhmmss.z+ format.
     */
     static bool getNmeaTime(const QByteArray &bytes, QTime *time);
+    static bool getNmeaTime(const NmeaField &field, QTime *time);
 
     /*
         Accepts for example ("2734.7964", 'S', "15306.0124", 'E') and returns the
@@ -333,6 +388,12 @@ public:
                                char lngDirection,
                                double *lat,
                                double *lon);
+    static bool getNmeaLatLong(const NmeaField &latString,
+                               char latDirection,
+                               const NmeaField &lngString,
+                               char lngDirection,
+                               double *lat,
+                               double *lon);
 };
 
 QT_END_NAMESPACE
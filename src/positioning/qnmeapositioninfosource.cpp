@@ -41,12 +41,17 @@
 #include "qnmeapositioninfosource_p.h"
 #include "qgeopositioninfo_p.h"
 #include "qlocationutils_p.h"
+#include <qtpositioning_tracepoints_p.h>
 
 #include <QIODevice>
+#include <QFileDevice>
 #include <QBasicTimer>
 #include <QTimerEvent>
 #include <QTimer>
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <string.h>
 #include <QDebug>
 #include <QtCore/QtNumeric>
 
@@ -55,6 +60,27 @@ QT_BEGIN_NAMESPACE
 
 #define USE_NMEA_PIMPL 0
 
+// The fix time carried by the trace points, to follow a fix from the bytes of
+// the device to QML: milliseconds since the epoch, or since the start of the
+// day while the date is not known yet, and -1 without a time.
+Q_DECL_UNUSED static qint64 qnmea_traceFixTime(const QGeoPositionInfo &info)
+{
+    const QDateTime timestamp = info.timestamp();
+    if (timestamp.isValid())
+        return timestamp.toMSecsSinceEpoch();
+    if (timestamp.time().isValid())
+        return timestamp.time().msecsSinceStartOfDay();
+    return -1;
+}
+
+// What QNmeaRealTimeReader did with a sentence, for the QNmeaRealTimeReader_sentence trace point
+enum QNmeaTraceDecision {
+    NmeaTraceNewFix,        // for a newer fix, the previous one was pushed
+    NmeaTraceMerged,        // into the fix of the same time
+    NmeaTraceDiscarded,     // out of order, or nothing new
+    NmeaTraceReplaced       // the fix had no time, and was overwritten
+};
+
 #if USE_NMEA_PIMPL
 class QGeoPositionInfoPrivateNmea : public QGeoPositionInfoPrivate
 {
@@ -162,6 +188,115 @@ static qint64 msecsTo(const QDateTime &from, const QDateTime &to)
     return from.msecsTo(to);
 }
 
+// Copies the position data without cloning the private, so the scratch
+// positions of forEachNmeaUpdate() are allocated only once.
+static void assignPosition(QGeoPositionInfo &dst, const QGeoPositionInfo &src)
+{
+    QGeoPositionInfoPrivate *dstPimpl = QGeoPositionInfoPrivate::get(dst);
+    const QGeoPositionInfoPrivate *srcPimpl = QGeoPositionInfoPrivate::get(src);
+    dstPimpl->timestamp = srcPimpl->timestamp;
+    dstPimpl->coord = srcPimpl->coord;
+    dstPimpl->doubleAttribs = srcPimpl->doubleAttribs;
+}
+
+static void resetPosition(QGeoPositionInfo &info)
+{
+    QGeoPositionInfoPrivate *pimpl = QGeoPositionInfoPrivate::get(info);
+    pimpl->timestamp = QDateTime();
+    pimpl->coord = QGeoCoordinate();
+    pimpl->doubleAttribs.clear();
+}
+
+/*
+    Groups the NMEA sentences in \a data into position updates the same way
+    QNmeaRealTimeReader does, and calls \a emitUpdate(update, hasFix, begin, end)
+    for each update newer than the previous one. \c begin and \c end are the
+    offsets of the sentences that make up the update.
+*/
+template <typename EmitUpdate>
+static void forEachNmeaUpdate(QNmeaPositionInfoSourcePrivate *proxy, const char *data, qint64 size,
+                              EmitUpdate emitUpdate)
+{
+    if (!data || size <= 0)
+        return;
+
+    QGeoPositionInfo update(*new QGeoPositionInfoPrivateNmea);
+    QGeoPositionInfo pos(*new QGeoPositionInfoPrivateNmea);
+    bool updateHasFix = false;
+    qint64 updateBegin = 0;
+    QDateTime lastPushedTS;
+
+    auto pushUpdate = [&](qint64 updateEnd) {
+        const bool newerTimestamp = update.timestamp() > lastPushedTS;
+        const bool invalidDate = !(update.timestamp().date().isValid() && lastPushedTS.date().isValid());
+        const bool newerTime = update.timestamp().time() > lastPushedTS.time();
+        if (newerTimestamp || (invalidDate && newerTime)) {
+            lastPushedTS = update.timestamp();
+            emitUpdate(update, updateHasFix, updateBegin, updateEnd);
+        }
+    };
+
+    auto handleSentence = [&](const char *line, qint64 lineSize) {
+        const qint64 lineBegin = line - data;
+
+        resetPosition(pos);
+        bool hasFix = false;
+        if (!proxy->parsePosInfoFromNmeaData(line, int(qMin<qint64>(lineSize, std::numeric_limits<int>::max())),
+                                             &pos, &hasFix)) {
+            return;
+        }
+
+        const QTime infoTime = update.timestamp().time();
+        const QDate infoDate = update.timestamp().date();
+        if (infoTime.isValid()) {
+            if (pos.timestamp().time().isValid()) {
+                const bool newerTime = infoTime < pos.timestamp().time();
+                const bool newerDate = (infoDate.isValid()
+                                        && pos.timestamp().date().isValid()
+                                        && infoDate < pos.timestamp().date());
+                if (newerTime || newerDate) {
+                    // Sentence of a newer update, flush the current one
+                    pushUpdate(lineBegin);
+                    propagateAttributes(pos, update, false);
+                    assignPosition(update, pos);
+                    updateHasFix = hasFix;
+                    updateBegin = lineBegin;
+                } else if (infoTime == pos.timestamp().time()) {
+                    mergePositions(update, pos, QByteArray());
+                    updateHasFix |= hasFix;
+                }
+                // else discard out of order outdated info.
+            } else {
+                mergePositions(update, pos, QByteArray());
+                updateHasFix |= hasFix;
+            }
+        } else {
+            propagateAttributes(pos, update);
+            assignPosition(update, pos);
+            updateHasFix |= hasFix;
+        }
+    };
+
+    // the framer drops what cannot be a sentence, the parsers check the rest
+    QLocationUtils::NmeaSentenceSpan spans[64];
+    qint64 offset = 0;
+    while (offset < size) {
+        qint64 consumed = 0;
+        const int count = QLocationUtils::splitNmeaSentences(data + offset, size - offset,
+                                                             spans, 64, &consumed);
+        for (int i = 0; i < count; ++i)
+            handleSentence(spans[i].data, spans[i].size);
+        if (count == 0) {
+            // an unterminated last sentence
+            if (consumed < size - offset)
+                handleSentence(data + offset + consumed, size - offset - consumed);
+            break;
+        }
+        offset += consumed;
+    }
+    pushUpdate(size);
+}
+
 QNmeaRealTimeReader::QNmeaRealTimeReader(QNmeaPositionInfoSourcePrivate *sourcePrivate)
         : QNmeaReader(sourcePrivate), m_update(*new QGeoPositionInfoPrivateNmea)
 {
@@ -187,6 +322,8 @@ QNmeaRealTimeReader::QNmeaRealTimeReader(QNmeaPositionInfoSourcePrivate *sourceP
 
 void QNmeaRealTimeReader::readAvailableData()
 {
+    int sentences = 0;
+    Q_UNUSED(sentences); // without trace points
     while (m_proxy->m_device->canReadLine()) {
         const QTime infoTime = m_update.timestamp().time(); // if update has been set, time must be valid.
         const QDate infoDate = m_update.timestamp().date(); // this one might not be valid, as some sentences do not contain it
@@ -207,6 +344,7 @@ void QNmeaRealTimeReader::readAvailableData()
 
         m_hasFix |= hasFix;
         m_updateParsed = true;
+        ++sentences;
 
         // Date may or may not be valid, as some packets do not have date.
         // If date isn't valid, match is performed on time only.
@@ -227,7 +365,7 @@ void QNmeaRealTimeReader::readAvailableData()
                     const bool invalidDate = !(updateDate.isValid() && lastPushedDate.isValid());
                     const bool newerTimeSinceLastPushed = m_update.timestamp().time() > m_lastPushedTS.time();
                     if ( newerTimestampSinceLastPushed || (invalidDate && newerTimeSinceLastPushed)) {
-                        m_proxy->notifyNewUpdate(&m_update, oldFix);
+                        pushUpdate(&m_update, oldFix);
                         m_lastPushedTS = m_update.timestamp();
                     }
                     m_timer.stop();
@@ -235,21 +373,29 @@ void QNmeaRealTimeReader::readAvailableData()
                     propagateAttributes(pos, m_update, false);
                     m_update = pos;
                     m_hasFix = hasFix;
+                    Q_TRACE(QNmeaRealTimeReader_sentence, qnmea_traceFixTime(m_update),
+                            NmeaTraceNewFix);
+                } else if (infoTime == pos.timestamp().time()
+                           && mergePositions(m_update, pos, QByteArray(buf, size))) {
+                    // timestamps match -- merged into m_update
+                    // Reset the timer only if new info has been received.
+                    // Else the source might be keep repeating outdated info until
+                    // new info become available.
+                    m_timer.stop();
+                    Q_TRACE(QNmeaRealTimeReader_sentence, qnmea_traceFixTime(m_update),
+                            NmeaTraceMerged);
                 } else {
-                    if (infoTime == pos.timestamp().time())
-                        // timestamps match -- merge into m_update
-                        if (mergePositions(m_update, pos, QByteArray(buf, size))) {
-                            // Reset the timer only if new info has been received.
-                            // Else the source might be keep repeating outdated info until
-                            // new info become available.
-                            m_timer.stop();
-                        }
-                    // else discard out of order outdated info.
+                    // discard out of order outdated info.
+                    Q_TRACE(QNmeaRealTimeReader_sentence, qnmea_traceFixTime(m_update),
+                            NmeaTraceDiscarded);
                 }
+            } else if (mergePositions(m_update, pos, QByteArray(buf, size))) {
+                // no timestamp available in parsed update-- merged into m_update
+                m_timer.stop();
+                Q_TRACE(QNmeaRealTimeReader_sentence, qnmea_traceFixTime(m_update), NmeaTraceMerged);
             } else {
-                // no timestamp available in parsed update-- merge into m_update
-                if (mergePositions(m_update, pos, QByteArray(buf, size)))
-                    m_timer.stop();
+                Q_TRACE(QNmeaRealTimeReader_sentence, qnmea_traceFixTime(m_update),
+                        NmeaTraceDiscarded);
             }
         } else {
             // there was no info with valid TS. Overwrite with whatever is parsed.
@@ -259,8 +405,10 @@ void QNmeaRealTimeReader::readAvailableData()
             propagateAttributes(pos, m_update);
             m_update = pos;
             m_timer.stop();
+            Q_TRACE(QNmeaRealTimeReader_sentence, qnmea_traceFixTime(m_update), NmeaTraceReplaced);
         }
     }
+    Q_TRACE(QNmeaRealTimeReader_readAvailableData_parsed, qnmea_traceFixTime(m_update), sentences);
 
     if (m_updateParsed) {
         if (m_pushDelay < 0)
@@ -277,12 +425,116 @@ void QNmeaRealTimeReader::notifyNewUpdate()
                             && m_lastPushedTS.date().isValid()
                             && m_update.timestamp().date() > m_lastPushedTS.date());
     if (newerTime || newerDate) {
-        m_proxy->notifyNewUpdate(&m_update, m_hasFix);
+        pushUpdate(&m_update, m_hasFix);
         m_lastPushedTS = m_update.timestamp();
     }
     m_timer.stop();
 }
 
+void QNmeaRealTimeReader::pushUpdate(QGeoPositionInfo *update, bool hasFix)
+{
+    m_proxy->notifyNewUpdate(update, hasFix);
+}
+
+
+//============================================================
+
+QNmeaThreadedReader::QNmeaThreadedReader(QNmeaPositionInfoSourcePrivate *sourcePrivate)
+        : QNmeaRealTimeReader(sourcePrivate)
+{
+    m_thread.setObjectName(QStringLiteral("QNmeaPositionInfoSource"));
+}
+
+QNmeaThreadedReader::~QNmeaThreadedReader()
+{
+    if (!m_thread.isRunning())
+        return;
+
+    // hand the device back before the worker thread goes away
+    QMetaObject::invokeMethod(this, [this]() {
+        m_timer.stop();
+        if (m_proxy->m_device)
+            m_proxy->m_device->moveToThread(m_ownerThread);
+        m_timer.moveToThread(m_ownerThread);
+        moveToThread(m_ownerThread);
+    }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/*
+    Moves the device, the push timer and the reader itself to the worker
+    thread. Fails if the device cannot be moved, i.e. if it has a parent or
+    does not live in the calling thread.
+*/
+bool QNmeaThreadedReader::start()
+{
+    QIODevice *device = m_proxy->m_device;
+    if (!device || device->parent() || device->thread() != QThread::currentThread())
+        return false;
+
+    m_ownerThread = QThread::currentThread();
+    moveToThread(&m_thread);
+    m_timer.moveToThread(&m_thread);
+    device->moveToThread(&m_thread);
+    connect(device, &QIODevice::readyRead, this, &QNmeaThreadedReader::readDevice);
+    m_thread.start();
+    return true;
+}
+
+void QNmeaThreadedReader::readAvailableData()
+{
+    // called from the owner thread, the device is only touched by the worker
+    QMetaObject::invokeMethod(this, &QNmeaThreadedReader::readDevice, Qt::QueuedConnection);
+}
+
+void QNmeaThreadedReader::skipBufferedData()
+{
+    QMetaObject::invokeMethod(this, [this]() {
+        QIODevice *device = m_proxy->m_device;
+        if (!device || !device->bytesAvailable())
+            return;
+        if (device->isSequential())
+            device->readAll();
+        else
+            device->seek(device->bytesAvailable());
+    }, Qt::BlockingQueuedConnection);
+}
+
+void QNmeaThreadedReader::readDevice()
+{
+    if (m_proxy->m_device)
+        QNmeaRealTimeReader::readAvailableData();
+}
+
+void QNmeaThreadedReader::pushUpdate(QGeoPositionInfo *update, bool hasFix)
+{
+    QMutexLocker locker(&m_queueMutex);
+    if (m_proxy->m_latestUpdateOnly)
+        m_queue.clear();
+    while (m_queue.size() >= m_proxy->m_updateQueueSize)
+        m_queue.dequeue(); // drop the oldest, the owner thread is lagging behind
+
+    QPendingGeoPositionInfo pending = { *update, hasFix };
+    m_queue.enqueue(pending);
+    if (!m_deliveryPending) {
+        m_deliveryPending = true;
+        QMetaObject::invokeMethod(m_proxy, [this]() { deliverUpdates(); }, Qt::QueuedConnection);
+    }
+}
+
+void QNmeaThreadedReader::deliverUpdates()
+{
+    QQueue<QPendingGeoPositionInfo> updates;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        updates.swap(m_queue);
+        m_deliveryPending = false;
+    }
+    for (QPendingGeoPositionInfo &pending : updates)
+        m_proxy->notifyNewUpdate(&pending.info, pending.hasFix);
+}
+
 
 //============================================================
 
@@ -304,9 +556,18 @@ void QNmeaSimulatedReader::readAvailableData()
     if (m_currTimerId > 0)     // we are already reading
         return;
 
+    if (m_mappedData)   // replaying a mapped file, see replayNext()
+        return;
+
     if (!m_hasValidDateTime) {      // first update
         Q_ASSERT(m_proxy->m_device && (m_proxy->m_device->openMode() & QIODevice::ReadOnly));
 
+        if (mapDevice()) {
+            m_hasValidDateTime = true;
+            replayNext();
+            return;
+        }
+
         if (!setFirstDateTime()) {
             //m_proxy->notifyReachedEndOfFile();
             qWarning("QNmeaPositionInfoSource: cannot find NMEA sentence with valid date & time");
@@ -451,7 +712,10 @@ void QNmeaSimulatedReader::timerEvent(QTimerEvent *event)
 {
     killTimer(event->timerId());
     m_currTimerId = -1;
-    simulatePendingUpdate();
+    if (m_mappedData)
+        replayNext();
+    else
+        simulatePendingUpdate();
 }
 
 void QNmeaSimulatedReader::processNextSentence()
@@ -469,7 +733,141 @@ void QNmeaSimulatedReader::processNextSentence()
     pending.info = info;
     pending.hasFix = hasFix;
     m_pendingUpdates.enqueue(pending);
-    m_currTimerId = startTimer(timeToNextUpdate);
+    m_currTimerId = startTimer(playbackInterval(timeToNextUpdate));
+}
+
+int QNmeaSimulatedReader::playbackInterval(qint64 msecs) const
+{
+    const qreal rate = m_proxy->m_playbackRate;
+    if (rate <= 0)
+        return 0; // as fast as possible
+    return int(qMin<qreal>(msecs / rate, std::numeric_limits<int>::max()));
+}
+
+static qint64 replayKey(const QDateTime &timestamp)
+{
+    if (timestamp.date().isValid())
+        return timestamp.toMSecsSinceEpoch();
+    return timestamp.time().msecsSinceStartOfDay();
+}
+
+/*
+    Maps a file device instead of reading it through m_pendingUpdates, and
+    indexes the updates in it in a first pass. Replaying and seeking then only
+    parse the sentences of a single update.
+*/
+bool QNmeaSimulatedReader::mapDevice()
+{
+    QFileDevice *file = qobject_cast<QFileDevice *>(m_proxy->m_device.data());
+    if (!file || file->isSequential())
+        return false;
+
+    const qint64 begin = file->pos();
+    const qint64 size = file->size();
+    if (begin >= size)
+        return false;
+    uchar *data = file->map(0, size);
+    if (!data)
+        return false;
+
+    const char *text = reinterpret_cast<const char *>(data);
+    QDate currentDate;
+    forEachNmeaUpdate(m_proxy, text + begin, size - begin,
+                      [&](const QGeoPositionInfo &update, bool, qint64 updateBegin, qint64 updateEnd) {
+        QDateTime timestamp = update.timestamp();
+        if (timestamp.date().isValid())
+            currentDate = timestamp.date();
+        else if (currentDate.isValid())
+            timestamp = QDateTime(currentDate, timestamp.time(), Qt::UTC);
+
+        const ReplayEntry entry = { begin + updateBegin, begin + updateEnd, replayKey(timestamp), timestamp };
+        m_replayIndex.append(entry);
+    });
+
+    if (m_replayIndex.isEmpty()) {
+        file->unmap(data);
+        return false;
+    }
+
+    m_mappedData = text;
+    if (m_proxy->m_playbackStart.isValid()) {
+        const qint64 key = replayKey(m_proxy->m_playbackStart);
+        const auto it = std::lower_bound(m_replayIndex.cbegin(), m_replayIndex.cend(), key,
+                                         [](const ReplayEntry &entry, qint64 k) { return entry.key < k; });
+        m_replayPosition = int(it - m_replayIndex.cbegin());
+        m_proxy->m_playbackStart = QDateTime();
+    }
+    return true;
+}
+
+void QNmeaSimulatedReader::replayNext()
+{
+    if (!m_proxy->m_device || !m_proxy->m_device->isOpen()) {
+        // the mapping goes away with the file
+        m_mappedData = nullptr;
+        m_replayIndex.clear();
+        return;
+    }
+
+    if (m_replayPosition >= m_replayIndex.size())
+        return;
+
+    // Schedule the next update first, slots connected to positionUpdated() may seek.
+    const ReplayEntry entry = m_replayIndex.at(m_replayPosition++);
+    if (m_replayPosition < m_replayIndex.size()) {
+        const qint64 msecs = msecsTo(entry.timestamp, m_replayIndex.at(m_replayPosition).timestamp);
+        m_currTimerId = startTimer(playbackInterval(qMax<qint64>(msecs, 0)));
+    }
+
+    QGeoPositionInfo info(*new QGeoPositionInfoPrivateNmea);
+    bool hasFix = false;
+    bool found = false;
+    forEachNmeaUpdate(m_proxy, m_mappedData + entry.begin, entry.end - entry.begin,
+                      [&](const QGeoPositionInfo &update, bool updateHasFix, qint64, qint64) {
+        if (found)
+            return;
+        info = update;
+        hasFix = updateHasFix;
+        found = true;
+    });
+
+    // carry over attributes like the sequential reading does
+    propagateAttributes(info, m_lastReplayed, false);
+    m_lastReplayed = info;
+    m_proxy->notifyNewUpdate(&info, hasFix);
+}
+
+bool QNmeaSimulatedReader::seek(const QDateTime &position)
+{
+    if (!m_hasValidDateTime) {
+        // not started yet, applied by mapDevice()
+        m_proxy->m_playbackStart = position;
+        return true;
+    }
+    if (!m_mappedData)
+        return false;
+
+    const qint64 key = replayKey(position);
+    const auto it = std::lower_bound(m_replayIndex.cbegin(), m_replayIndex.cend(), key,
+                                     [](const ReplayEntry &entry, qint64 k) { return entry.key < k; });
+    if (it == m_replayIndex.cend())
+        return false;
+
+    if (m_currTimerId > 0) {
+        killTimer(m_currTimerId);
+        m_currTimerId = -1;
+    }
+    m_replayPosition = int(it - m_replayIndex.cbegin());
+    m_lastReplayed = QGeoPositionInfo();
+    replayNext();
+    return true;
+}
+
+QDateTime QNmeaSimulatedReader::position() const
+{
+    if (!m_mappedData || m_replayPosition == 0)
+        return QDateTime();
+    return m_replayIndex.at(m_replayPosition - 1).timestamp;
 }
 
 
@@ -491,7 +889,8 @@ QNmeaPositionInfoSourcePrivate::QNmeaPositionInfoSourcePrivate(QNmeaPositionInfo
         m_verticalAccuracy(qQNaN()),
         m_noUpdateLastInterval(false),
         m_updateTimeoutSent(false),
-        m_connectedReadyRead(false)
+        m_connectedReadyRead(false),
+        m_readingInWorkerThread(false)
 {
 }
 
@@ -522,12 +921,15 @@ bool QNmeaPositionInfoSourcePrivate::openSourceDevice()
 
 void QNmeaPositionInfoSourcePrivate::sourceDataClosed()
 {
-    if (m_nmeaReader && m_device && m_device->bytesAvailable())
+    // the worker thread checks for remaining data itself
+    if (m_nmeaReader && m_device && (isReadingInWorkerThread() || m_device->bytesAvailable()))
         m_nmeaReader->readAvailableData();
 }
 
 void QNmeaPositionInfoSourcePrivate::readyRead()
 {
+    Q_TRACE(QNmeaPositionInfoSourcePrivate_readyRead_entry,
+            m_device ? m_device->bytesAvailable() : qint64(0));
     if (m_nmeaReader)
         m_nmeaReader->readAvailableData();
 }
@@ -540,10 +942,24 @@ bool QNmeaPositionInfoSourcePrivate::initialize()
     if (!openSourceDevice())
         return false;
 
-    if (m_updateMode == QNmeaPositionInfoSource::RealTimeMode)
+    if (m_updateMode == QNmeaPositionInfoSource::RealTimeMode) {
+        if (m_workerThread) {
+            QNmeaThreadedReader *reader = new QNmeaThreadedReader(this);
+            if (reader->start()) {
+                m_nmeaReader = reader;
+                // readyRead() is connected to the reader in the worker thread
+                m_connectedReadyRead = true;
+                m_readingInWorkerThread = true;
+                return true;
+            }
+            qWarning("QNmeaPositionInfoSource: cannot move the QIODevice data source to a worker thread, "
+                     "it must not have a parent");
+            delete reader;
+        }
         m_nmeaReader = new QNmeaRealTimeReader(this);
-    else
+    } else {
         m_nmeaReader = new QNmeaSimulatedReader(this);
+    }
 
     return true;
 }
@@ -568,6 +984,123 @@ bool QNmeaPositionInfoSourcePrivate::parsePosInfoFromNmeaData(const char *data,
     return m_source->parsePosInfoFromNmeaData(data, size, posInfo, hasFix);
 }
 
+QVector<QGeoPositionInfo> QNmeaPositionInfoSourcePrivate::parseNmeaData(const char *data, qint64 size)
+{
+    // Updates are completed like notifyNewUpdate() does, but with local state
+    // so that an ongoing stream from the device is not affected.
+    QVector<QGeoPositionInfo> positions;
+    QDate currentDate;
+    qreal horizontalAccuracy = qQNaN();
+    qreal verticalAccuracy = qQNaN();
+
+    forEachNmeaUpdate(this, data, size,
+                      [&](const QGeoPositionInfo &update, bool hasFix, qint64, qint64) {
+        QGeoPositionInfo info = update;
+        const QDate date = info.timestamp().date();
+        if (date.isValid())
+            currentDate = date;
+        else if (info.timestamp().time().isValid() && currentDate.isValid())
+            info.setTimestamp(QDateTime(currentDate, info.timestamp().time(), Qt::UTC));
+
+        if (info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy))
+            horizontalAccuracy = info.attribute(QGeoPositionInfo::HorizontalAccuracy);
+        else if (!qIsNaN(horizontalAccuracy))
+            info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, horizontalAccuracy);
+
+        if (info.hasAttribute(QGeoPositionInfo::VerticalAccuracy))
+            verticalAccuracy = info.attribute(QGeoPositionInfo::VerticalAccuracy);
+        else if (!qIsNaN(verticalAccuracy))
+            info.setAttribute(QGeoPositionInfo::VerticalAccuracy, verticalAccuracy);
+
+        if (hasFix && info.isValid())
+            positions.append(info);
+    });
+
+    return positions;
+}
+
+bool QNmeaPositionInfoSourcePrivate::setPlaybackPosition(const QDateTime &position)
+{
+    // QDateTime(QDate(), time) is invalid but still a usable time of day
+    if (m_updateMode != QNmeaPositionInfoSource::SimulationMode || !position.time().isValid())
+        return false;
+
+    if (!m_nmeaReader) {
+        // applied once the replay index has been built
+        m_playbackStart = position;
+        return true;
+    }
+    return static_cast<QNmeaSimulatedReader *>(m_nmeaReader)->seek(position);
+}
+
+bool QGeoPositionInfoSourcePrivateNmea::setBackendProperty(const QString &name, const QVariant &value)
+{
+    if (name == QLatin1String("nmea.playback_rate")) {
+        bool ok = false;
+        const qreal rate = value.toReal(&ok);
+        if (!ok || rate < 0)
+            return false;
+        nmea->m_playbackRate = rate;
+        return true;
+    }
+    if (name == QLatin1String("nmea.playback_position"))
+        return nmea->setPlaybackPosition(value.toDateTime());
+    if (name == QLatin1String("nmea.worker_thread")) {
+        // the reading thread is chosen when the device is opened
+        if (nmea->m_updateMode != QNmeaPositionInfoSource::RealTimeMode || nmea->isInitialized())
+            return false;
+        nmea->m_workerThread = value.toBool();
+        return true;
+    }
+    if (name == QLatin1String("nmea.update_queue_size")) {
+        bool ok = false;
+        const int size = value.toInt(&ok);
+        if (!ok || size < 1 || nmea->isInitialized())
+            return false;
+        nmea->m_updateQueueSize = size;
+        return true;
+    }
+    if (name == QLatin1String("nmea.latest_update_only")) {
+        if (nmea->isInitialized())
+            return false;
+        nmea->m_latestUpdateOnly = value.toBool();
+        return true;
+    }
+    return false;
+}
+
+QVariant QGeoPositionInfoSourcePrivateNmea::backendProperty(const QString &name) const
+{
+    if (name == QLatin1String("nmea.playback_rate"))
+        return nmea->m_playbackRate;
+    if (name == QLatin1String("nmea.playback_position"))
+        return nmea->playbackPosition();
+    if (name == QLatin1String("nmea.worker_thread"))
+        return nmea->m_workerThread;
+    if (name == QLatin1String("nmea.update_queue_size"))
+        return nmea->m_updateQueueSize;
+    if (name == QLatin1String("nmea.latest_update_only"))
+        return nmea->m_latestUpdateOnly;
+    return QVariant();
+}
+
+bool QNmeaPositionInfoSourcePrivate::isInitialized() const
+{
+    return m_nmeaReader != nullptr;
+}
+
+bool QNmeaPositionInfoSourcePrivate::isReadingInWorkerThread() const
+{
+    return m_readingInWorkerThread;
+}
+
+QDateTime QNmeaPositionInfoSourcePrivate::playbackPosition() const
+{
+    if (m_updateMode != QNmeaPositionInfoSource::SimulationMode || !m_nmeaReader)
+        return QDateTime();
+    return static_cast<QNmeaSimulatedReader *>(m_nmeaReader)->position();
+}
+
 void QNmeaPositionInfoSourcePrivate::startUpdates()
 {
     if (m_invokedStart)
@@ -584,7 +1117,9 @@ void QNmeaPositionInfoSourcePrivate::startUpdates()
     if (m_updateMode == QNmeaPositionInfoSource::RealTimeMode) {
         // skip over any buffered data - we only want the newest data.
         // Don't do this in requestUpdate. In that case bufferedData is good to have/use.
-        if (m_device->bytesAvailable()) {
+        if (m_readingInWorkerThread) {
+            static_cast<QNmeaThreadedReader *>(m_nmeaReader)->skipBufferedData();
+        } else if (m_device->bytesAvailable()) {
             if (m_device->isSequential())
                 m_device->readAll();
             else
@@ -672,6 +1207,7 @@ void QNmeaPositionInfoSourcePrivate::notifyNewUpdate(QGeoPositionInfo *update, b
     else if (!qIsNaN(m_verticalAccuracy))
         update->setAttribute(QGeoPositionInfo::VerticalAccuracy, m_verticalAccuracy);
 
+    Q_TRACE(QNmeaPositionInfoSourcePrivate_notifyNewUpdate, qnmea_traceFixTime(*update), hasFix);
     if (hasFix && update->isValid()) {
         if (m_requestTimer && m_requestTimer->isActive()) { // User called requestUpdate()
             m_requestTimer->stop();
@@ -721,6 +1257,7 @@ void QNmeaPositionInfoSourcePrivate::emitUpdated(const QGeoPositionInfo &update)
     // check for duplication already done in QNmeaRealTimeReader::notifyNewUpdate
     // and QNmeaRealTimeReader::readAvailableData
     m_lastUpdate = update;
+    Q_TRACE(QNmeaPositionInfoSourcePrivate_emitUpdated, qnmea_traceFixTime(update));
     emit m_source->positionUpdated(update);
 }
 
@@ -756,6 +1293,58 @@ void QNmeaPositionInfoSourcePrivate::emitUpdated(const QGeoPositionInfo &update)
     QNmeaPositionInfoSource supports reporting the accuracy of the horizontal and vertical position.
     To enable position accuracy reporting an estimate of the User Equivalent Range Error associated
     with the NMEA source must be set with setUserEquivalentRangeError().
+
+    In \l {SimulationMode}, replaying a QFile is controlled with the following
+    backend properties, see setBackendProperty():
+
+    \table
+    \header
+        \li Property
+        \li Description
+    \row
+        \li nmea.playback_rate
+        \li Speed of the replay relative to the recorded timestamps, 1.0 by
+            default. A rate of 0 replays the updates as fast as possible.
+    \row
+        \li nmea.playback_position
+        \li The QDateTime of the update replayed last. Setting it continues the
+            replay from the first update at or after the given time, also before
+            startUpdates() has been called.
+    \endtable
+
+    Files are memory-mapped and indexed by timestamp when the replay starts,
+    so seeking does not need to read the file again. Data appended to the file
+    after that is not replayed.
+
+    In \l {RealTimeMode}, the device can be read and parsed in a worker thread
+    so that NMEA bursts are not delayed by a busy owner thread. The following
+    backend properties must be set before startUpdates() or requestUpdate()
+    is called:
+
+    \table
+    \header
+        \li Property
+        \li Description
+    \row
+        \li nmea.worker_thread
+        \li If \c true, the device is moved to a worker thread when it is
+            opened. Only merged updates are delivered to the thread of the
+            source through queued connections. The device must not have a
+            parent, and must neither be used nor deleted by the application
+            while the source exists. Defaults to \c false.
+    \row
+        \li nmea.update_queue_size
+        \li The number of merged updates that are kept while the thread of
+            the source is busy, 16 by default. The oldest updates are dropped
+            first.
+    \row
+        \li nmea.latest_update_only
+        \li If \c true, only the newest merged update is kept for delivery.
+            Defaults to \c false.
+    \endtable
+
+    In the worker thread mode, parsePosInfoFromNmeaData() is called from the
+    worker thread.
 */
 
 
@@ -773,9 +1362,10 @@ void QNmeaPositionInfoSourcePrivate::emitUpdated(const QGeoPositionInfo &update)
     and \a updateMode.
 */
 QNmeaPositionInfoSource::QNmeaPositionInfoSource(UpdateMode updateMode, QObject *parent)
-        : QGeoPositionInfoSource(parent),
+        : QGeoPositionInfoSource(*new QGeoPositionInfoSourcePrivateNmea, parent),
         d(new QNmeaPositionInfoSourcePrivate(this, updateMode))
 {
+    static_cast<QGeoPositionInfoSourcePrivateNmea *>(QGeoPositionInfoSourcePrivate::get(*this))->nmea = d;
 }
 
 /*!
@@ -842,6 +1432,39 @@ bool QNmeaPositionInfoSource::parsePosInfoFromNmeaData(const char *data, int siz
                                               hasFix);
 }
 
+/*!
+    Parses \a size bytes of NMEA sentences from \a data in one go and returns
+    the resulting position updates, in the order they appear in the data.
+
+    Sentences are combined into position updates in the same way as in
+    \l RealTimeMode, and only valid updates with a fix are returned, like the
+    ones emitted by positionUpdated(). Unlike reading from the device, no
+    signals are emitted and no timers are involved, which makes this suitable
+    for processing recorded logs, for example a file mapped with QFile::map().
+
+    Each sentence is parsed with parsePosInfoFromNmeaData(), so subclasses
+    handling non-standard sentences are supported. The state of an ongoing
+    stream read from device() is not affected.
+
+    \since 5.15
+*/
+QVector<QGeoPositionInfo> QNmeaPositionInfoSource::parseNmeaData(const char *data, qint64 size)
+{
+    return d->parseNmeaData(data, size);
+}
+
+/*!
+    \overload
+
+    Parses the NMEA sentences in \a data.
+
+    \since 5.15
+*/
+QVector<QGeoPositionInfo> QNmeaPositionInfoSource::parseNmeaData(const QByteArray &data)
+{
+    return d->parseNmeaData(data.constData(), data.size());
+}
+
 /*!
     Returns the update mode.
 */
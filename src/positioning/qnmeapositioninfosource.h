@@ -40,6 +40,7 @@
 #define QNMEAPOSITIONINFOSOURCE_H
 
 #include <QtPositioning/QGeoPositionInfoSource>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -73,6 +74,8 @@ public:
     int minimumUpdateInterval() const;
     Error error() const;
 
+    QVector<QGeoPositionInfo> parseNmeaData(const char *data, qint64 size);
+    QVector<QGeoPositionInfo> parseNmeaData(const QByteArray &data);
 
 public Q_SLOTS:
     void startUpdates();
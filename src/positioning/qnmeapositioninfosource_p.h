@@ -52,10 +52,14 @@
 
 #include "qnmeapositioninfosource.h"
 #include "qgeopositioninfo.h"
+#include "qgeopositioninfosource_p.h"
 
 #include <QObject>
 #include <QQueue>
+#include <QVector>
 #include <QPointer>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
 #include <QtCore/qtimer.h>
 
 QT_BEGIN_NAMESPACE
@@ -90,12 +94,24 @@ public:
 
     void notifyNewUpdate(QGeoPositionInfo *update, bool fixStatus);
 
+    QVector<QGeoPositionInfo> parseNmeaData(const char *data, qint64 size);
+
+    bool setPlaybackPosition(const QDateTime &position);
+    QDateTime playbackPosition() const;
+    bool isInitialized() const;
+    bool isReadingInWorkerThread() const;
+
     QNmeaPositionInfoSource::UpdateMode m_updateMode;
     QPointer<QIODevice> m_device;
     QGeoPositionInfo m_lastUpdate;
     bool m_invokedStart;
     QGeoPositionInfoSource::Error m_positionError;
     double m_userEquivalentRangeError;
+    qreal m_playbackRate = 1.0;
+    QDateTime m_playbackStart;
+    bool m_workerThread = false;
+    bool m_latestUpdateOnly = false;
+    int m_updateQueueSize = 16;
 
 public Q_SLOTS:
     void readyRead();
@@ -125,6 +141,17 @@ private:
     bool m_noUpdateLastInterval;
     bool m_updateTimeoutSent;
     bool m_connectedReadyRead;
+    bool m_readingInWorkerThread;
+};
+
+
+class QGeoPositionInfoSourcePrivateNmea : public QGeoPositionInfoSourcePrivate
+{
+public:
+    bool setBackendProperty(const QString &name, const QVariant &value) override;
+    QVariant backendProperty(const QString &name) const override;
+
+    QNmeaPositionInfoSourcePrivate *nmea = nullptr;
 };
 
 
@@ -148,6 +175,7 @@ public:
     explicit QNmeaRealTimeReader(QNmeaPositionInfoSourcePrivate *sourcePrivate);
     virtual void readAvailableData();
     void notifyNewUpdate();
+    virtual void pushUpdate(QGeoPositionInfo *update, bool hasFix);
 
     // Data members
     QGeoPositionInfo m_update;
@@ -159,6 +187,36 @@ public:
 };
 
 
+// Reads and parses the device in a worker thread, see the nmea.worker_thread
+// backend property. Merged updates are queued for the owner thread of the source.
+class QNmeaThreadedReader : public QObject, public QNmeaRealTimeReader
+{
+    Q_OBJECT
+public:
+    explicit QNmeaThreadedReader(QNmeaPositionInfoSourcePrivate *sourcePrivate);
+    ~QNmeaThreadedReader();
+
+    bool start();
+    void readAvailableData() override;
+    void skipBufferedData();
+
+protected:
+    void pushUpdate(QGeoPositionInfo *update, bool hasFix) override;
+
+private Q_SLOTS:
+    void readDevice();
+
+private:
+    void deliverUpdates();
+
+    QThread m_thread;
+    QThread *m_ownerThread = nullptr;
+    QMutex m_queueMutex;
+    QQueue<QPendingGeoPositionInfo> m_queue;
+    bool m_deliveryPending = false;
+};
+
+
 class QNmeaSimulatedReader : public QObject, public QNmeaReader
 {
     Q_OBJECT
@@ -167,6 +225,9 @@ public:
     ~QNmeaSimulatedReader();
     virtual void readAvailableData();
 
+    bool seek(const QDateTime &position);
+    QDateTime position() const;
+
 protected:
     virtual void timerEvent(QTimerEvent *event);
 
@@ -176,11 +237,29 @@ private Q_SLOTS:
 private:
     bool setFirstDateTime();
     void processNextSentence();
+    int playbackInterval(qint64 msecs) const;
+
+    bool mapDevice();
+    void replayNext();
+
+    // An update of a memory-mapped file, see mapDevice()
+    struct ReplayEntry
+    {
+        qint64 begin;
+        qint64 end;
+        qint64 key; // msecs since epoch, or since midnight without a date
+        QDateTime timestamp;
+    };
 
     QQueue<QPendingGeoPositionInfo> m_pendingUpdates;
     QByteArray m_nextLine;
     int m_currTimerId;
     bool m_hasValidDateTime;
+
+    const char *m_mappedData = nullptr;
+    QVector<ReplayEntry> m_replayIndex;
+    int m_replayPosition = 0;
+    QGeoPositionInfo m_lastReplayed;
 };
 
 QT_END_NAMESPACE
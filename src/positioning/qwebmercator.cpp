@@ -45,16 +45,22 @@
 
 #include "qdoublevector2d_p.h"
 #include "qdoublevector3d_p.h"
+#include "qgeocoordinatekernels_p.h"
 
 QT_BEGIN_NAMESPACE
 
 QDoubleVector2D QWebMercator::coordToMercator(const QGeoCoordinate &coord)
+{
+    return coordToMercator(coord.latitude(), coord.longitude());
+}
+
+QDoubleVector2D QWebMercator::coordToMercator(double latitude, double longitude)
 {
     const double pi = M_PI;
 
-    double lon = coord.longitude() / 360.0 + 0.5;
+    double lon = longitude / 360.0 + 0.5;
 
-    double lat = coord.latitude();
+    double lat = latitude;
     lat = 0.5 - (std::log(std::tan((pi / 4.0) + (pi / 2.0) * lat / 180.0)) / pi) / 2.0;
     lat = qBound(0.0, lat, 1.0);
 
@@ -100,6 +106,47 @@ QGeoCoordinate QWebMercator::mercatorToCoord(const QDoubleVector2D &mercator)
     return QGeoCoordinate(lat, lng, 0.0);
 }
 
+// Converts the coordinates writing x and y of each one to consecutive elements
+// of mercator, which has to hold twice as many doubles as there are coordinates.
+void QWebMercator::coordToMercator(QGeoCoordinateSpan coordinates, double *mercator)
+{
+    QGeoCoordinateKernels::toMercator(coordinates, mercator);
+}
+
+QList<QDoubleVector2D> QWebMercator::coordToMercator(QGeoCoordinateSpan coordinates)
+{
+    QVector<double> buffer(2 * coordinates.size());
+    coordToMercator(coordinates, buffer.data());
+
+    QList<QDoubleVector2D> result;
+    result.reserve(coordinates.size());
+    for (int i = 0; i < coordinates.size(); ++i)
+        result.append(QDoubleVector2D(buffer.at(2 * i), buffer.at(2 * i + 1)));
+    return result;
+}
+
+QList<QDoubleVector2D> QWebMercator::coordToMercator(const QList<QGeoCoordinate> &coordinates)
+{
+    return coordToMercator(qPackCoordinates(coordinates));
+}
+
+// The inverse, for count pairs of x and y.
+void QWebMercator::mercatorToCoord(const double *mercator, int count, QGeoPackedCoordinate *coordinates)
+{
+    QGeoCoordinateKernels::fromMercator(mercator, count, coordinates);
+}
+
+QList<QGeoCoordinate> QWebMercator::mercatorToCoord(const QList<QDoubleVector2D> &mercator)
+{
+    QVector<double> buffer;
+    buffer.reserve(2 * mercator.size());
+    for (const QDoubleVector2D &p : mercator)
+        buffer << p.x() << p.y();
+    QGeoPackedCoordinates packed(mercator.size());
+    mercatorToCoord(buffer.constData(), mercator.size(), packed.data());
+    return qUnpackCoordinates(packed);
+}
+
 QGeoCoordinate QWebMercator::coordinateInterpolation(const QGeoCoordinate &from, const QGeoCoordinate &to, qreal progress)
 {
     QDoubleVector2D s = QWebMercator::coordToMercator(from);
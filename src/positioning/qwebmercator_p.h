@@ -53,6 +53,7 @@
 #include <qglobal.h>
 #include <QtCore/qvariant.h>
 #include "qpositioningglobal_p.h"
+#include "qgeopackedcoordinate_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -63,7 +64,13 @@ class Q_POSITIONING_PRIVATE_EXPORT QWebMercator
 {
 public:
     static QDoubleVector2D coordToMercator(const QGeoCoordinate &coord);
+    static QDoubleVector2D coordToMercator(double latitude, double longitude);
     static QGeoCoordinate mercatorToCoord(const QDoubleVector2D &mercator);
+    static void coordToMercator(QGeoCoordinateSpan coordinates, double *mercator);
+    static QList<QDoubleVector2D> coordToMercator(QGeoCoordinateSpan coordinates);
+    static QList<QDoubleVector2D> coordToMercator(const QList<QGeoCoordinate> &coordinates);
+    static void mercatorToCoord(const double *mercator, int count, QGeoPackedCoordinate *coordinates);
+    static QList<QGeoCoordinate> mercatorToCoord(const QList<QDoubleVector2D> &mercator);
     static QGeoCoordinate coordinateInterpolation(const QGeoCoordinate &from, const QGeoCoordinate &to, qreal progress);
 
 private:
@@ -7,4 +7,7 @@ INCLUDEPATH += $$PWD
 SOURCES += $$files(*.cpp)
 HEADERS += $$files(*.h)
 
+TRACEPOINT_PROVIDER = $$PWD/qtpositioningquick.tracepoints
+CONFIG += qt_tracepoints
+
 load(qt_module)
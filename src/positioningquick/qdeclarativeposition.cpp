@@ -106,7 +106,12 @@ QDeclarativePosition::~QDeclarativePosition()
 {
 }
 
-void QDeclarativePosition::setPosition(const QGeoPositionInfo &info)
+/*
+    Sets the position to \a info, and returns whether any of its properties
+    changed. If \a notify is false, the change signals of the properties are
+    left to the caller, which then emits one signal for the whole update.
+*/
+bool QDeclarativePosition::setPosition(const QGeoPositionInfo &info, bool notify)
 {
     // timestamp
     const QDateTime pTimestamp = m_info.timestamp();
@@ -159,6 +164,17 @@ void QDeclarativePosition::setPosition(const QGeoPositionInfo &info)
 
     m_info = info;
 
+    if (!notify) {
+        return emitTimestampChanged || emitCoordinateChanged || emitLatitudeValidChanged
+                || emitLongitudeValidChanged || emitAltitudeValidChanged
+                || emitDirectionChanged || emitDirectionValidChanged
+                || emitSpeedChanged || emitSpeedValidChanged
+                || emitVerticalSpeedChanged || emitVerticalSpeedValidChanged
+                || emitHorizontalAccuracyChanged || emitHorizontalAccuracyValidChanged
+                || emitVerticalAccuracyChanged || emitVerticalAccuracyValidChanged
+                || emitMagneticVariationChanged || emitMagneticVariationValidChanged;
+    }
+
     if (emitTimestampChanged)
         emit timestampChanged();
     if (emitCoordinateChanged)
@@ -193,6 +209,7 @@ void QDeclarativePosition::setPosition(const QGeoPositionInfo &info)
         emit magneticVariationChanged();
     if (emitMagneticVariationValidChanged)
         emit magneticVariationValidChanged();
+    return true;
 }
 
 const QGeoPositionInfo &QDeclarativePosition::position() const
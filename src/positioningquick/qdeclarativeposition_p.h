@@ -114,7 +114,7 @@ public:
     bool isMagneticVariationValid() const;
     double magneticVariation() const;
 
-    void setPosition(const QGeoPositionInfo &info);
+    bool setPosition(const QGeoPositionInfo &info, bool notify = true);
     const QGeoPositionInfo &position() const;
 
 Q_SIGNALS:
@@ -48,6 +48,7 @@
 #include <QFile>
 #include <QtNetwork/QTcpSocket>
 #include <QTimer>
+#include <qtpositioningquick_tracepoints_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -210,7 +211,7 @@ void QDeclarativePositionSource::tryAttach(const QString &newName, bool useFallb
     }
 
     if (m_positionSource) {
-        connect(m_positionSource, SIGNAL(positionUpdated(QGeoPositionInfo)),
+        connect(m_positionSource, SIGNAL(coalescedPositionUpdated(QGeoPositionInfo)),
                 this, SLOT(positionUpdateReceived(QGeoPositionInfo)));
         connect(m_positionSource, SIGNAL(error(QGeoPositionInfoSource::Error)),
                 this, SLOT(sourceErrorReceived(QGeoPositionInfoSource::Error)));
@@ -218,6 +219,8 @@ void QDeclarativePositionSource::tryAttach(const QString &newName, bool useFallb
                 this, SLOT(updateTimeoutReceived()));
 
         m_positionSource->setUpdateInterval(m_updateInterval);
+        // backends may deliver faster than requested
+        m_positionSource->setCoalescingInterval(m_positionSource->updateInterval());
         m_positionSource->setPreferredPositioningMethods(
             static_cast<QGeoPositionInfoSource::PositioningMethods>(int(m_preferredPositioningMethods)));
 
@@ -330,7 +333,7 @@ void QDeclarativePositionSource::setNmeaSource(const QUrl &nmeaSource)
             setSource(new QNmeaPositionInfoSource(QNmeaPositionInfoSource::SimulationMode));
             (qobject_cast<QNmeaPositionInfoSource *>(m_positionSource))->setUserEquivalentRangeError(2.5); // it is internally multiplied by 2 in qlocationutils_readGga
             (qobject_cast<QNmeaPositionInfoSource *>(m_positionSource))->setDevice(m_nmeaFile);
-            connect(m_positionSource, SIGNAL(positionUpdated(QGeoPositionInfo)),
+            connect(m_positionSource, SIGNAL(coalescedPositionUpdated(QGeoPositionInfo)),
                     this, SLOT(positionUpdateReceived(QGeoPositionInfo)));
             connect(m_positionSource, SIGNAL(error(QGeoPositionInfoSource::Error)),
                     this, SLOT(sourceErrorReceived(QGeoPositionInfoSource::Error)));
@@ -381,7 +384,7 @@ void QDeclarativePositionSource::socketConnected()
     setSource(new QNmeaPositionInfoSource(QNmeaPositionInfoSource::RealTimeMode));
     (qobject_cast<QNmeaPositionInfoSource *>(m_positionSource))->setDevice(m_nmeaSocket);
 
-    connect(m_positionSource, &QNmeaPositionInfoSource::positionUpdated,
+    connect(m_positionSource, &QNmeaPositionInfoSource::coalescedPositionUpdated,
             this, &QDeclarativePositionSource::positionUpdateReceived);
     connect(m_positionSource, SIGNAL(error(QGeoPositionInfoSource::Error)),
             this, SLOT(sourceErrorReceived(QGeoPositionInfoSource::Error)));
@@ -464,8 +467,12 @@ void QDeclarativePositionSource::onParameterInitialized()
 
 void QDeclarativePositionSource::setPosition(const QGeoPositionInfo &pi)
 {
-    m_position.setPosition(pi);
-    emit positionChanged();
+    if (!m_coalescePositionUpdates) {
+        m_position.setPosition(pi);
+        emit positionChanged();
+    } else if (m_position.setPosition(pi, false)) {
+        emit positionChanged();
+    }
 }
 
 void QDeclarativePositionSource::setSource(QGeoPositionInfoSource *source)
@@ -518,6 +525,7 @@ void QDeclarativePositionSource::setUpdateInterval(int updateInterval)
 
         if (previousUpdateInterval != updateInterval) {
             m_positionSource->setUpdateInterval(updateInterval);
+            m_positionSource->setCoalescingInterval(m_positionSource->updateInterval());
             if (previousUpdateInterval != m_positionSource->updateInterval())
                 emit updateIntervalChanged();
         }
@@ -554,6 +562,8 @@ QUrl QDeclarativePositionSource::nmeaSource() const
     \qmlproperty int PositionSource::updateInterval
 
     This property holds the desired interval between updates (milliseconds).
+    Updates are not delivered more often than this, also when the backend
+    provides them faster.
 
     \sa {QGeoPositionInfoSource::updateInterval()}
 */
@@ -754,6 +764,8 @@ QDeclarativePosition *QDeclarativePositionSource::position()
 
 void QDeclarativePositionSource::positionUpdateReceived(const QGeoPositionInfo &update)
 {
+    Q_TRACE(QDeclarativePositionSource_positionUpdateReceived,
+            update.timestamp().toMSecsSinceEpoch());
     setPosition(update);
 
     if (m_singleUpdate && m_active) {
@@ -810,6 +822,44 @@ QQmlListProperty<QDeclarativePluginParameter> QDeclarativePositionSource::parame
             parameter_clear);
 }
 
+/*!
+    \qmlproperty bool PositionSource::coalescePositionUpdates
+
+    This property holds whether the properties of \l position are updated
+    together, with a single \c positionChanged signal per update.
+
+    By default each property of \l position that changes with an update
+    emits its own change signal, so a binding reading several of them, such
+    as \c {position.coordinate} and \c {position.direction}, is evaluated
+    once for each of them. When this property is \c true, all properties
+    already hold their new values when \c positionChanged is emitted, and
+    bindings reading them through the \c position property of the
+    PositionSource are evaluated once per update. An update that changes
+    nothing emits no signal at all.
+
+    As the properties of the Position then emit no change signals of their
+    own, bindings should read them through the PositionSource, for example
+    \c {source.position.coordinate}, rather than through a Position kept
+    elsewhere.
+
+    The default value is \c false.
+
+    \since QtPositioning 5.15
+*/
+bool QDeclarativePositionSource::coalescePositionUpdates() const
+{
+    return m_coalescePositionUpdates;
+}
+
+void QDeclarativePositionSource::setCoalescePositionUpdates(bool coalesce)
+{
+    if (m_coalescePositionUpdates == coalesce)
+        return;
+
+    m_coalescePositionUpdates = coalesce;
+    emit coalescePositionUpdatesChanged();
+}
+
 /*!
     \internal
 */
@@ -78,6 +78,7 @@ class Q_POSITIONINGQUICK_PRIVATE_EXPORT QDeclarativePositionSource : public QObj
     Q_PROPERTY(SourceError sourceError READ sourceError NOTIFY sourceErrorChanged)
     Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
     Q_PROPERTY(QQmlListProperty<QDeclarativePluginParameter> parameters READ parameters REVISION 14)
+    Q_PROPERTY(bool coalescePositionUpdates READ coalescePositionUpdates WRITE setCoalescePositionUpdates NOTIFY coalescePositionUpdatesChanged REVISION 15)
     Q_ENUMS(PositioningMethod)
 
     Q_CLASSINFO("DefaultProperty", "parameters")
@@ -126,6 +127,8 @@ public:
     QGeoPositionInfoSource *positionSource() const;
     QQmlListProperty<QDeclarativePluginParameter> parameters();
     QVariantMap parameterMap() const;
+    bool coalescePositionUpdates() const;
+    void setCoalescePositionUpdates(bool coalesce);
 
     // Virtuals from QQmlParserStatus
     void classBegin() { }
@@ -150,6 +153,7 @@ Q_SIGNALS:
     void nameChanged();
     void validityChanged();
     void updateTimeout();
+    Q_REVISION(15) void coalescePositionUpdatesChanged();
 
 private Q_SLOTS:
     void positionUpdateReceived(const QGeoPositionInfo &update);
@@ -185,6 +189,7 @@ private:
     QList<QDeclarativePluginParameter *> m_parameters;
     bool m_componentComplete = false;
     bool m_parametersInitialized = false;
+    bool m_coalescePositionUpdates = false;
 };
 
 QT_END_NAMESPACE
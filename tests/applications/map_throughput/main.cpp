@@ -0,0 +1,455 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtCore/QtMath>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QSurfaceFormat>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtQml/QQmlContext>
+#include <QtQuick/QQuickView>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtLocation/private/qdeclarativegeomap_p.h>
+#include <QtLocation/private/qgeomapstatistics_p.h>
+#include <QtLocation/private/qgeotiledmap_p.h>
+#include <QtLocation/private/qgeotilerequestmanager_p.h>
+#include <algorithm>
+#include <cstdio>
+
+QT_USE_NAMESPACE
+
+/*
+    Drives a map with the tiles of the test geoservices plugin, thousands of
+    map items, a position indicator and a navigator fed by a high rate NMEA
+    stream, through scripted camera movements. For each script it reports
+    the p50 and p99 frame times, the time until the map is fully textured
+    again once the camera stops, the tile requests per second and the memory
+    high-water mark of the map stack, as text and in full as JSON. The test
+    plugin of tests/auto/geotestplugin must be built, it serves the tiles,
+    routes and navigation.
+
+    Beyond the report, the limits given on the command line are checked, and
+    the exit code is 1 when one is exceeded, so that CI can gate on it.
+*/
+
+namespace {
+
+const QGeoCoordinate origin(52.52, 13.40); // of map_throughput.qml
+const double routeRadius = 0.05; // degrees of latitude
+const double speed = 25; // m/s
+
+struct Options
+{
+    int items = 2000;
+    int positionRate = 50; // Hz
+    int tileLatency = 20; // ms
+    int scriptDuration = 5000; // ms
+    int settleTimeout = 30000; // ms
+    QString report = QStringLiteral("map_throughput.json");
+    double maxP99 = 0; // ms, 0 if not checked
+    double maxTextured = 0; // ms
+    double maxMemory = 0; // MB
+};
+
+// The coordinate of the route circle at angle a, counter clockwise from the east
+QGeoCoordinate routeCoordinate(double a)
+{
+    return QGeoCoordinate(origin.latitude() + routeRadius * qSin(a),
+                          origin.longitude() + routeRadius * qCos(a)
+                          / qCos(qDegreesToRadians(origin.latitude())));
+}
+
+QVariantList routePath()
+{
+    QVariantList path;
+    for (int i = 0; i <= 64; ++i)
+        path.append(QVariant::fromValue(routeCoordinate(2 * M_PI * i / 64)));
+    return path;
+}
+
+QByteArray nmeaAngle(double degrees, int degreeDigits)
+{
+    const double a = qAbs(degrees);
+    const int d = int(a);
+    return QByteArray::number(d).rightJustified(degreeDigits, '0')
+            + QByteArray::number((a - d) * 60, 'f', 4).rightJustified(7, '0');
+}
+
+// Streams RMC sentences along the route to every client, positionRate times a second
+class NmeaServer : public QObject
+{
+public:
+    explicit NmeaServer(int positionRate)
+    {
+        m_server.listen(QHostAddress::LocalHost);
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                m_clients.append(socket);
+            }
+        });
+        connect(&m_timer, &QTimer::timeout, this, &NmeaServer::sendPosition);
+        m_timer.setTimerType(Qt::PreciseTimer);
+        m_timer.start(qMax(1, 1000 / positionRate));
+        m_clock.start();
+    }
+
+    QUrl url() const
+    {
+        return QUrl(QStringLiteral("socket://127.0.0.1:%1").arg(m_server.serverPort()));
+    }
+
+private:
+    void sendPosition()
+    {
+        const double circumference = 2 * M_PI * routeRadius * 111000;
+        const double a = 2 * M_PI * speed * m_clock.elapsed() / 1000 / circumference;
+        const QGeoCoordinate c = routeCoordinate(a);
+        const double course = std::fmod(qRadiansToDegrees(qAtan2(-qSin(a), qCos(a))) + 360, 360);
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+
+        QByteArray sentence = "GPRMC," + now.time().toString(QStringLiteral("hhmmss.zzz")).toLatin1()
+                + ",A," + nmeaAngle(c.latitude(), 2) + (c.latitude() < 0 ? ",S," : ",N,")
+                + nmeaAngle(c.longitude(), 3) + (c.longitude() < 0 ? ",W," : ",E,")
+                + QByteArray::number(speed * 1.94384, 'f', 1) + ','
+                + QByteArray::number(course, 'f', 1) + ','
+                + now.date().toString(QStringLiteral("ddMMyy")).toLatin1() + ",,,A";
+        char checksum = 0;
+        for (char ch : qAsConst(sentence))
+            checksum ^= ch;
+        sentence = '$' + sentence + '*' + QByteArray::number(uchar(checksum), 16).rightJustified(2, '0').toUpper()
+                + "\r\n";
+
+        for (int i = m_clients.size() - 1; i >= 0; --i) {
+            if (m_clients.at(i))
+                m_clients.at(i)->write(sentence);
+            else
+                m_clients.removeAt(i);
+        }
+    }
+
+    QTcpServer m_server;
+    QVector<QPointer<QTcpSocket>> m_clients;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+};
+
+double percentile(const QVector<double> &sorted, double p)
+{
+    if (sorted.isEmpty())
+        return 0;
+    return sorted.at(qMin(sorted.size() - 1, int(sorted.size() * p)));
+}
+
+// Runs the scripts one after the other, a frame at a time
+class ThroughputRun : public QObject
+{
+public:
+    ThroughputRun(QQuickView *view, const Options &options)
+        : m_view(view), m_options(options)
+    {
+        m_map = qobject_cast<QDeclarativeGeoMap *>(view->rootObject());
+        connect(view, &QQuickWindow::frameSwapped, this, &ThroughputRun::frameSwapped);
+    }
+
+    bool isValid() const { return m_map; }
+
+    void start()
+    {
+        if (!m_map->mapReady()) {
+            connect(m_map, &QDeclarativeGeoMap::mapReadyChanged, this, &ThroughputRun::start,
+                    Qt::UniqueConnection);
+            return;
+        }
+        disconnect(m_map, &QDeclarativeGeoMap::mapReadyChanged, this, &ThroughputRun::start);
+        m_map->clearData(); // Tiles cached by the previous runs would not be requested
+        QGeoMapStatistics::enable();
+        m_clock.start();
+        m_positionUpdates = m_map->property("positionUpdates").toInt();
+        startScript();
+    }
+
+private:
+    enum State { Moving, Settling, Done };
+
+    void startScript()
+    {
+        QGeoMapStatistics::reset();
+        m_frameTimes.clear();
+        m_scriptStart = m_clock.nsecsElapsed();
+        m_lastSwap = -1;
+        m_tilesDone = false;
+        const QString script = scripts().at(m_script);
+        // The jump has no movement, only the tiles of the new place to load
+        if (script == QLatin1String("jump")) {
+            applyScript(1.0);
+            m_state = Settling;
+            m_settleStart = m_scriptStart;
+        } else {
+            applyScript(0.0);
+            m_state = Moving;
+        }
+        m_view->update();
+    }
+
+    static QStringList scripts()
+    {
+        return { QStringLiteral("pan"), QStringLiteral("zoom"), QStringLiteral("tilt"),
+                 QStringLiteral("rotate"), QStringLiteral("follow"), QStringLiteral("jump") };
+    }
+
+    void applyScript(double t)
+    {
+        QMetaObject::invokeMethod(m_map, "applyScript", Q_ARG(QVariant, scripts().at(m_script)),
+                                  Q_ARG(QVariant, t));
+    }
+
+    int pendingTileCount() const
+    {
+        QGeoTiledMap *tiledMap = qobject_cast<QGeoTiledMap *>(m_map->map());
+        if (!tiledMap || !tiledMap->requestManager())
+            return 0;
+        return tiledMap->requestManager()->pendingTileCount();
+    }
+
+    void frameSwapped()
+    {
+        if (m_state == Done || !m_clock.isValid())
+            return;
+        const qint64 now = m_clock.nsecsElapsed();
+        if (m_lastSwap >= 0)
+            m_frameTimes.append((now - m_lastSwap) / 1e6);
+        m_lastSwap = now;
+
+        if (m_state == Moving) {
+            const double t = (now - m_scriptStart) / 1e6 / m_options.scriptDuration;
+            if (t < 1.0) {
+                applyScript(t);
+            } else {
+                applyScript(1.0);
+                m_state = Settling;
+                m_settleStart = now;
+            }
+        } else if (m_tilesDone) {
+            // The frame after the last tile arrived is the first to show it
+            finishScript(now, (now - m_settleStart) / 1e6);
+            return;
+        } else if ((now - m_settleStart) / 1e6 > m_options.settleTimeout) {
+            finishScript(now, -1);
+            return;
+        }
+        m_tilesDone = m_state == Settling && pendingTileCount() == 0;
+        m_view->update();
+    }
+
+    void finishScript(qint64 now, double texturedTime)
+    {
+        const double seconds = (now - m_scriptStart) / 1e9;
+        const QVariantMap statistics = QGeoMapStatistics::snapshot();
+        const QVariantMap memory = QGeoMapStatistics::memoryReport();
+        const double tileRequests = statistics.value(QStringLiteral("cacheMisses")).toDouble();
+        const double peakBytes = memory.value(QStringLiteral("total")).toMap()
+                .value(QStringLiteral("peakBytes")).toDouble();
+
+        QVector<double> sorted = m_frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+
+        QJsonObject result;
+        result.insert(QStringLiteral("script"), scripts().at(m_script));
+        result.insert(QStringLiteral("frames"), sorted.size());
+        result.insert(QStringLiteral("frameTimeP50"), percentile(sorted, 0.5));
+        result.insert(QStringLiteral("frameTimeP99"), percentile(sorted, 0.99));
+        result.insert(QStringLiteral("frameTimeMax"), sorted.isEmpty() ? 0 : sorted.last());
+        if (texturedTime >= 0)
+            result.insert(QStringLiteral("timeToFullyTextured"), texturedTime);
+        else
+            result.insert(QStringLiteral("timeToFullyTextured"), QJsonValue::Null);
+        result.insert(QStringLiteral("tileRequests"), tileRequests);
+        result.insert(QStringLiteral("tileRequestsPerSecond"), tileRequests / seconds);
+        result.insert(QStringLiteral("memoryPeakBytes"), peakBytes);
+        result.insert(QStringLiteral("statistics"), QJsonObject::fromVariantMap(statistics));
+        result.insert(QStringLiteral("memory"), QJsonObject::fromVariantMap(memory));
+        m_results.append(result);
+
+        printf("%-8s frames %5d  p50 %7.2f ms  p99 %7.2f ms  textured %s  tiles/s %7.1f  peak %7.1f MB\n",
+               qPrintable(scripts().at(m_script)), sorted.size(),
+               percentile(sorted, 0.5), percentile(sorted, 0.99),
+               texturedTime >= 0 ? qPrintable(QStringLiteral("%1 ms").arg(texturedTime, 8, 'f', 1))
+                                 : "timed out",
+               tileRequests / seconds, peakBytes / (1024 * 1024));
+        fflush(stdout);
+
+        bool pass = texturedTime >= 0;
+        if (m_options.maxP99 > 0 && percentile(sorted, 0.99) > m_options.maxP99)
+            pass = false;
+        if (m_options.maxTextured > 0 && texturedTime > m_options.maxTextured)
+            pass = false;
+        if (m_options.maxMemory > 0 && peakBytes > m_options.maxMemory * 1024 * 1024)
+            pass = false;
+        if (!pass)
+            m_failures.append(scripts().at(m_script));
+
+        if (++m_script < scripts().size()) {
+            startScript();
+            return;
+        }
+        m_state = Done;
+        finish();
+    }
+
+    void finish()
+    {
+        QGeoMapStatistics::disable();
+        const double seconds = m_clock.elapsed() / 1000.0;
+        const int positionUpdates = m_map->property("positionUpdates").toInt() - m_positionUpdates;
+        QObject *navigator = m_map->property("navigator").value<QObject *>();
+
+        QJsonObject report;
+        report.insert(QStringLiteral("qtVersion"), QString::fromLatin1(qVersion()));
+        report.insert(QStringLiteral("sceneGraphBackend"), QQuickWindow::sceneGraphBackend());
+        report.insert(QStringLiteral("items"), m_options.items);
+        report.insert(QStringLiteral("tileLatency"), m_options.tileLatency);
+        report.insert(QStringLiteral("scriptDuration"), m_options.scriptDuration);
+        report.insert(QStringLiteral("positionUpdatesPerSecond"), positionUpdates / seconds);
+        report.insert(QStringLiteral("navigatorActive"), navigator && navigator->property("active").toBool());
+        report.insert(QStringLiteral("results"), m_results);
+        report.insert(QStringLiteral("failures"), QJsonArray::fromStringList(m_failures));
+
+        QFile file(m_options.report);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            file.write(QJsonDocument(report).toJson());
+        else
+            qWarning() << "Cannot write the report to" << m_options.report;
+
+        printf("position updates %.1f/s, navigator %s\n", positionUpdates / seconds,
+               report.value(QStringLiteral("navigatorActive")).toBool() ? "active" : "inactive");
+        if (!m_failures.isEmpty())
+            printf("FAIL: %s\n", qPrintable(m_failures.join(QLatin1String(", "))));
+        fflush(stdout);
+        QCoreApplication::exit(m_failures.isEmpty() ? 0 : 1);
+    }
+
+    QQuickView *m_view;
+    QDeclarativeGeoMap *m_map = nullptr;
+    Options m_options;
+    QElapsedTimer m_clock;
+    State m_state = Moving;
+    int m_script = 0;
+    qint64 m_scriptStart = 0;
+    qint64 m_settleStart = 0;
+    qint64 m_lastSwap = -1;
+    bool m_tilesDone = false;
+    int m_positionUpdates = 0;
+    QVector<double> m_frameTimes; // ms between the swaps
+    QJsonArray m_results;
+    QStringList m_failures;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Frames as fast as they can be rendered, unless a render loop is asked for
+    if (!qEnvironmentVariableIsSet("QSG_RENDER_LOOP"))
+        qputenv("QSG_RENDER_LOOP", "basic");
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setSwapInterval(0);
+    QSurfaceFormat::setDefaultFormat(format);
+
+    QGuiApplication app(argc, argv);
+    Options options;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Map tile and item throughput under scripted camera movements"));
+    parser.addHelpOption();
+    const QCommandLineOption itemsOption(QStringLiteral("items"),
+            QStringLiteral("Number of circles, with a tenth as many polylines."),
+            QStringLiteral("count"), QString::number(options.items));
+    const QCommandLineOption rateOption(QStringLiteral("position-rate"),
+            QStringLiteral("Position updates per second."),
+            QStringLiteral("hz"), QString::number(options.positionRate));
+    const QCommandLineOption latencyOption(QStringLiteral("tile-latency"),
+            QStringLiteral("Latency of the tile replies."),
+            QStringLiteral("ms"), QString::number(options.tileLatency));
+    const QCommandLineOption durationOption(QStringLiteral("duration"),
+            QStringLiteral("Duration of each camera script."),
+            QStringLiteral("ms"), QString::number(options.scriptDuration));
+    const QCommandLineOption reportOption(QStringLiteral("report"),
+            QStringLiteral("File to write the JSON report to."),
+            QStringLiteral("file"), options.report);
+    const QCommandLineOption maxP99Option(QStringLiteral("max-p99"),
+            QStringLiteral("Fail when the p99 frame time of a script exceeds this."),
+            QStringLiteral("ms"));
+    const QCommandLineOption maxTexturedOption(QStringLiteral("max-textured"),
+            QStringLiteral("Fail when the map takes longer than this to be fully textured."),
+            QStringLiteral("ms"));
+    const QCommandLineOption maxMemoryOption(QStringLiteral("max-memory"),
+            QStringLiteral("Fail when the map stack holds more than this."),
+            QStringLiteral("MB"));
+    parser.addOptions({ itemsOption, rateOption, latencyOption, durationOption, reportOption,
+                        maxP99Option, maxTexturedOption, maxMemoryOption });
+    parser.process(app);
+
+    options.items = parser.value(itemsOption).toInt();
+    options.positionRate = qMax(1, parser.value(rateOption).toInt());
+    options.tileLatency = parser.value(latencyOption).toInt();
+    options.scriptDuration = qMax(1, parser.value(durationOption).toInt());
+    options.report = parser.value(reportOption);
+    options.maxP99 = parser.value(maxP99Option).toDouble();
+    options.maxTextured = parser.value(maxTexturedOption).toDouble();
+    options.maxMemory = parser.value(maxMemoryOption).toDouble();
+
+    NmeaServer nmeaServer(options.positionRate);
+
+    QQuickView view;
+    view.rootContext()->setContextProperty(QStringLiteral("itemCount"), options.items);
+    view.rootContext()->setContextProperty(QStringLiteral("tileLatency"), options.tileLatency);
+    view.rootContext()->setContextProperty(QStringLiteral("nmeaUrl"), nmeaServer.url());
+    view.rootContext()->setContextProperty(QStringLiteral("routePath"), routePath());
+    view.setSource(QUrl(QStringLiteral("qrc:/map_throughput.qml")));
+
+    ThroughputRun run(&view, options);
+    if (view.status() != QQuickView::Ready || !run.isValid()) {
+        qWarning() << "Cannot load the map scene" << view.errors();
+        return 2;
+    }
+    view.show();
+    QTimer::singleShot(0, &run, &ThroughputRun::start);
+
+    return app.exec();
+}
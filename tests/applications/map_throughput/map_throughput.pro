@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = mapthroughput
+
+QT += location-private positioning-private network quick
+
+SOURCES += main.cpp
+RESOURCES += map_throughput.qrc
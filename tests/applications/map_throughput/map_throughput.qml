@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.12
+import QtPositioning 5.12
+import QtLocation 5.15
+import Qt.labs.location 1.0
+
+// The scene of map_throughput: tiles from the test plugin, items on a grid,
+// and a position indicator and a navigator following the NMEA stream of the
+// driver around a circular route
+Map {
+    id: map
+    width: 1024
+    height: 768
+    center: origin
+    zoomLevel: 12
+    copyrightsVisible: false
+    gesture.enabled: false
+
+    readonly property var origin: QtPositioning.coordinate(52.52, 13.40)
+    readonly property var farAway: QtPositioning.coordinate(48.14, 11.58)
+    property int positionUpdates: 0
+    readonly property alias navigator: navigator
+
+    plugin: Plugin {
+        id: testPlugin
+        name: "qmlgeo.test.plugin"
+        allowExperimental: true
+        PluginParameter { name: "finishRequestImmediately"; value: false }
+        PluginParameter { name: "tileLatency"; value: tileLatency }
+    }
+
+    function cell(index, count) {
+        var side = Math.ceil(Math.sqrt(count))
+        return {
+            latitude: origin.latitude + ((Math.floor(index / side) + 0.5) / side - 0.5) * 0.3,
+            longitude: origin.longitude + ((index % side + 0.5) / side - 0.5) * 0.5,
+            radius: 0.2 / side
+        }
+    }
+
+    function zigzag(index, count) {
+        var c = cell(index, count)
+        var path = []
+        for (var i = 0; i < 32; ++i) {
+            path.push(QtPositioning.coordinate(c.latitude + ((i % 2) ? 0.5 : -0.5) * c.radius,
+                                               c.longitude + (i / 31 - 0.5) * 4 * c.radius))
+        }
+        return path
+    }
+
+    function applyScript(script, t) {
+        var c = origin
+        var z = 12
+        var tiltAngle = 0
+        var b = 0
+        if (script === "pan")
+            c = QtPositioning.coordinate(origin.latitude + 0.1 * Math.sin(2 * Math.PI * t),
+                                         origin.longitude + 0.15 * (1 - Math.cos(2 * Math.PI * t)))
+        else if (script === "zoom")
+            z = 12 - 3 * Math.sin(Math.PI * t)
+        else if (script === "tilt")
+            tiltAngle = 60 * Math.sin(Math.PI * t)
+        else if (script === "rotate")
+            b = 360 * t
+        else if (script === "follow")
+            c = positionSource.position.coordinate
+        else if (script === "jump")
+            c = farAway
+        center = c
+        zoomLevel = z
+        tilt = tiltAngle
+        bearing = b
+    }
+
+    PositionSource {
+        id: positionSource
+        nmeaSource: nmeaUrl
+        active: true
+        onPositionChanged: ++map.positionUpdates
+    }
+
+    RouteQuery {
+        id: routeQuery
+        waypoints: routePath
+    }
+
+    RouteModel {
+        id: routeModel
+        plugin: testPlugin
+        query: routeQuery
+        autoUpdate: true
+    }
+
+    Navigator {
+        id: navigator
+        plugin: testPlugin
+        map: map
+        positionSource: positionSource
+        route: routeModel.status === RouteModel.Ready ? routeModel.get(0) : null
+        active: route !== null
+    }
+
+    MapRoute {
+        route: navigator.route
+        line.width: 6
+        line.color: "royalblue"
+    }
+
+    MapItemView {
+        model: itemCount
+        delegate: MapCircle {
+            readonly property var c: map.cell(index, itemCount)
+            color: "limegreen"
+            border.width: 1
+            border.color: "darkgreen"
+            center: QtPositioning.coordinate(c.latitude, c.longitude)
+            radius: c.radius * 0.3 * 111000
+        }
+    }
+
+    MapItemView {
+        model: Math.floor(itemCount / 10)
+        delegate: MapPolyline {
+            line.width: 2
+            line.color: "navy"
+            path: map.zigzag(index, Math.floor(itemCount / 10))
+        }
+    }
+
+    MapPositionIndicator {
+        id: indicator
+        positionSource: positionSource
+        interpolationDelay: 100
+    }
+}
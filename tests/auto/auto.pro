@@ -8,6 +8,7 @@ qtHaveModule(location) {
     SUBDIRS += qplace \
            qplaceattribute \
            qplacecategory \
+           qplacecategorycache \
            qplacecontactdetail \
            qplacecontentrequest \
            qplacedetailsreply \
@@ -30,11 +31,14 @@ qtHaveModule(location) {
     !android: {
         SUBDIRS += \
            qplacemanager \
+           qplacemanager_localplaces \
            qplacemanager_nokia \
            qplacemanager_unsupported \
-           placesplugin_unsupported
+           placesplugin_unsupported \
+           qdeclarativesearchresultmodel
 
         qplacemanager.depends = geotestplugin
+        qdeclarativesearchresultmodel.depends = geotestplugin
     }
 
     #misc tests
@@ -52,11 +56,35 @@ qtHaveModule(location) {
            qgeoroutereply \
            qgeorouterequest \
            qgeoroutesegment \
+           qgeoroutetracker \
            qgeoroutingmanagerplugins \
            qgeotilespec \
            qgeoroutexmlparser \
+           qgeorouteparserosrmv5 \
            maptype \
-           qgeocameratiles
+           qgeocameratiles \
+           qgeoasyncparse \
+           qgeomaptriangulationcache \
+           qgeoclipper \
+           qgeomappolylinestyles \
+           qgeomappolylinelod \
+           qgeosimplify \
+           qgeomappolylineorigin \
+           qgeomapitembatchlayer \
+           qgeoprojectionwrap \
+           qcache3q \
+           qgeomapspatialindex \
+           qgeomappathculler \
+           qgeofiletilecache \
+           geofiletilecacheesri \
+           qgeofiletilecacheosm \
+           qgeonetworkaccessmanagerosm \
+           qgeotilefetcherosm \
+           qgeotileproviderosm \
+           qgeorequestscheduler \
+           qmapheatmapobject \
+           qgeomapicontexturecache \
+           qgeolatestvaluemailbox
 
     # These use plugins
     !android: {
@@ -64,15 +92,24 @@ qtHaveModule(location) {
                          qgeoroutingmanager \
                          nokia_services \
                          qgeocodingmanager \
-                         qgeotiledmap
+                         qgeocodingmanager_localplaces \
+                         qgeotiledmap \
+                         qgeomappolygontriangulation \
+                         qgeomappolylineappend \
+                         qgeomapcirclepolar
 
         qgeoserviceprovider.depends = geotestplugin
         qgeotiledmap.depends = geotestplugin
+        qgeomappolygontriangulation.depends = geotestplugin
+        qgeomappolylineappend.depends = geotestplugin
+        qgeomapcirclepolar.depends = geotestplugin
     }
     qtHaveModule(quick):!android {
         SUBDIRS += declarative_geoshape \
-                   declarative_core
+                   declarative_core \
+                   qgeomapsnapshotrenderer
         declarative_core.depends = geotestplugin
+        qgeomapsnapshotrenderer.depends = geotestplugin
 
         !mac: {
             SUBDIRS += declarative_ui
@@ -90,9 +127,20 @@ SUBDIRS += \
            qgeopath \
            qgeopolygon \
            qgeocoordinate \
+           qwebmercator \
            qgeolocation \
+           qgeoattributearray \
            qgeopositioninfo \
            qgeosatelliteinfo \
+           qgeoshapeencoding \
+           qgeoareamonitorreplay \
+           qgeoareamonitorregions \
+           qgeopositionhistory \
+           qgeostreamsimplifier \
+           qgeodeadreckoningsource \
+           qgeopositioninfosource_synthetic \
+           qgeopositioninfosource_multiplexer \
+           qlocationutils \
            qgeojson
 
 !android: SUBDIRS += \
@@ -102,4 +150,6 @@ SUBDIRS += \
             qgeoareamonitor \
             qgeopositioninfosource \
             qgeosatelliteinfosource \
+            qnmeadispatcher \
+            qnmeasatellitetable \
             qnmeapositioninfosource
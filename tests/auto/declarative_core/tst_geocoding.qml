@@ -285,6 +285,13 @@ Item {
     SignalSpy {id: countSpy; target: testModel; signalName: "countChanged"}
     SignalSpy {id: testQuerySpy; target: testModel; signalName: "queryChanged"}
     SignalSpy {id: testStatusSpy; target: testModel; signalName: "statusChanged"}
+    Repeater {
+        id: testRoles
+        model: testModel
+        delegate: Item {
+            property string street: address.street
+        }
+    }
 
     GeocodeModel {id: slackModel; plugin: slackPlugin; }
     SignalSpy {id: locationsSlackSpy; target: slackModel; signalName: "locationsChanged"}
@@ -469,6 +476,9 @@ Item {
             compare (testQuerySpy.count, 1)
             compare (testStatusSpy.count, 2)
             compare (testModel.status, GeocodeModel.Ready)
+            // the roles other than locationData are served without Location objects
+            compare (testRoles.count, 2)
+            compare (testRoles.itemAt(0).street, "wellknown street")
             compare (testModel.get(0).address.street, "wellknown street")
             compare (testModel.get(0).address.city, "expected city")
         }
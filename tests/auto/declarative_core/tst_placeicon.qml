@@ -28,7 +28,7 @@
 
 import QtQuick 2.0
 import QtTest 1.0
-import QtLocation 5.3
+import QtLocation 5.15
 import "utils.js" as Utils
 
 TestCase {
@@ -62,6 +62,20 @@ TestCase {
         compare(u, "file:///home/user/icon.png");
     }
 
+    Icon {
+        id: qmlIconCached
+    }
+
+    function test_cachedUrl() {
+        qmlIconCached.parameters.singleUrl = "http://example.com/icon.png"
+        compare(qmlIconCached.cachedUrl(Qt.size(32, 32)),
+                "image://placeicons/aHR0cDovL2V4YW1wbGUuY29tL2ljb24ucG5n");
+
+        // local icons need no cache
+        qmlIconCached.parameters.singleUrl = "/home/user/icon.png"
+        compare(qmlIconCached.cachedUrl(Qt.size(32, 32)), "file:///home/user/icon.png");
+    }
+
     Plugin {
         id: testPlugin
         name: "qmlgeo.test.plugin"
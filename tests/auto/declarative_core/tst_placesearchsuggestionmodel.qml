@@ -28,7 +28,7 @@
 
 import QtQuick 2.0
 import QtTest 1.0
-import QtLocation 5.3
+import QtLocation 5.15
 import QtPositioning 5.2
 import "utils.js" as Utils
 
@@ -123,6 +123,50 @@ TestCase {
         compare(testModel.status, PlaceSearchSuggestionModel.Error);
     }
 
+    PlaceSearchSuggestionModel {
+        id: autoUpdateModel
+        plugin: testPlugin
+        autoUpdate: true
+        updateDelay: 50
+    }
+
+    SignalSpy { id: autoUpdateStatusSpy; target: autoUpdateModel; signalName: "statusChanged" }
+    SignalSpy { id: autoUpdateSuggestionsSpy; target: autoUpdateModel; signalName: "suggestionsChanged" }
+
+    function test_autoUpdate() {
+        compare(autoUpdateModel.status, PlaceSearchSuggestionModel.Null);
+
+        // only the last of quickly changing terms is queried
+        autoUpdateModel.searchTerm = "t";
+        autoUpdateModel.searchTerm = "te";
+        autoUpdateModel.searchTerm = "test";
+        compare(autoUpdateModel.status, PlaceSearchSuggestionModel.Null);
+
+        tryCompare(autoUpdateModel, "status", PlaceSearchSuggestionModel.Ready);
+        compare(autoUpdateStatusSpy.count, 2);
+        compare(autoUpdateSuggestionsSpy.count, 1);
+        compare(autoUpdateModel.suggestions, [ "test1", "test2", "test3" ]);
+
+        // changing the term cancels the query for the previous one
+        autoUpdateModel.update();
+        compare(autoUpdateModel.status, PlaceSearchSuggestionModel.Loading);
+        autoUpdateModel.searchTerm = "other";
+        compare(autoUpdateModel.status, PlaceSearchSuggestionModel.Ready);
+        tryCompare(autoUpdateSuggestionsSpy, "count", 2);
+        compare(autoUpdateModel.suggestions, []);
+
+        autoUpdateModel.searchTerm = "test";
+        tryCompare(autoUpdateSuggestionsSpy, "count", 3);
+        compare(autoUpdateModel.suggestions, [ "test1", "test2", "test3" ]);
+        compare(autoUpdateModel.status, PlaceSearchSuggestionModel.Ready);
+
+        autoUpdateModel.autoUpdate = false;
+        autoUpdateModel.searchTerm = "t";
+        wait(100);
+        compare(autoUpdateModel.status, PlaceSearchSuggestionModel.Ready);
+        compare(autoUpdateModel.suggestions, [ "test1", "test2", "test3" ]);
+    }
+
     SignalSpy { id: statusChangedSpyError; target: testModelError; signalName: "statusChanged" }
 
     function test_error() {
@@ -28,7 +28,7 @@
 
 import QtQuick 2.0
 import QtTest 1.0
-import QtPositioning 5.14
+import QtPositioning 5.15
 
 TestCase {
     id: testCase
@@ -126,6 +126,20 @@ TestCase {
     SignalSpy { id: directionValidSpyV1; target: testingSourceV1.position; signalName: "directionValidChanged" }
     SignalSpy { id: directionSpyV1; target: testingSourceV1.position; signalName: "directionChanged" }
 
+    PositionSource {
+        id: coalescingSource
+        name: "test.source.v1"
+        updateInterval: 1000
+        coalescePositionUpdates: true
+        property int evaluations: 0
+        property string summary: {
+            ++evaluations;
+            return position.coordinate.latitude + "," + position.direction + "," + position.speed;
+        }
+    }
+    SignalSpy { id: updateSpyCoalescing; target: coalescingSource; signalName: "positionChanged" }
+    SignalSpy { id: directionSpyCoalescing; target: coalescingSource.position; signalName: "directionChanged" }
+
     function test_updateInterval() {
         testingSource.updateInterval = 1000;
         compare(testingSource.updateInterval, 1000);
@@ -224,4 +238,28 @@ TestCase {
         verify(testingSourceWParams.position.speedValid)
         verify(testingSourceWParams.position.speed > 10000)
     }
+
+    function test_coalescedUpdates() {
+        updateSpyCoalescing.clear();
+        directionSpyCoalescing.clear();
+        verify(coalescingSource.coalescePositionUpdates);
+        var evaluations = coalescingSource.evaluations;
+
+        coalescingSource.active = true;
+
+        tryCompare(updateSpyCoalescing, "count", 1, 1500);
+        compare(coalescingSource.position.coordinate.latitude, 0.1);
+        fuzzyCompare(coalescingSource.position.direction, 45, 0.1)
+        compare(directionSpyCoalescing.count, 0)
+        compare(coalescingSource.evaluations, evaluations + 1);
+
+        tryCompare(updateSpyCoalescing, "count", 2, 1500);
+        compare(coalescingSource.position.coordinate.latitude, 0.2);
+        verify(coalescingSource.position.speedValid)
+        compare(directionSpyCoalescing.count, 0)
+        compare(coalescingSource.evaluations, evaluations + 2);
+        verify(coalescingSource.summary.indexOf("0.2,") === 0);
+
+        coalescingSource.active = false;
+    }
 }
@@ -28,7 +28,7 @@
 
 import QtQuick 2.0
 import QtTest 1.0
-import QtLocation 5.12
+import QtLocation 5.15
 import QtPositioning 5.12
 
 Item {
@@ -732,6 +732,25 @@ Item {
             compare (routeQuery.waypoints.length, 5)
             compare (routeModel.get(0).path.length, 5)
             compare (routeModel.get(0).path[0].latitude, routeQuery.waypoints[0].latitude)
+            compare (routeModel.get(0).pathLength(), 5)
+            compare (routeModel.get(0).coordinateAt(4).latitude, routeQuery.waypoints[4].latitude)
+            verify (!routeModel.get(0).coordinateAt(5).isValid)
+            // the path array is kept until the path changes
+            verify (routeModel.get(0).path === routeModel.get(0).path)
+            // shared by every reader, so it cannot be changed
+            var sharedPath = routeModel.get(0).path
+            verify (Object.isFrozen(sharedPath))
+            var pushed = true
+            try {
+                sharedPath.push(rcoordinate1)
+            } catch (e) {
+                pushed = false
+            }
+            verify (!pushed)
+            compare (routeModel.get(0).path.length, 5)
+            var copiedPath = sharedPath.slice()
+            copiedPath.push(rcoordinate1)
+            compare (copiedPath.length, 6)
             // test Route.equals
             var route1 = routeModel.get(0)
             var route2 = routeModelEquals.get(0)
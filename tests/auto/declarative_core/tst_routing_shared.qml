@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.12
+
+// Identical plugins share their service provider, while each RouteModel keeps
+// its own replies and measurement system
+Item {
+    Plugin {
+        id: sharedPlugin1
+        name: "qmlgeo.test.plugin"
+        allowExperimental: true
+        locales: [ "de_DE" ]
+        PluginParameter { name: "gc_finishRequestImmediately"; value: false }
+    }
+
+    Plugin {
+        id: sharedPlugin2
+        name: "qmlgeo.test.plugin"
+        allowExperimental: true
+        locales: [ "de_DE" ]
+        PluginParameter { name: "gc_finishRequestImmediately"; value: false }
+    }
+
+    RouteQuery {
+        id: twoWaypoints
+        waypoints: [ { latitude: 60, longitude: 60 }, { latitude: 61, longitude: 62 } ]
+    }
+
+    RouteQuery {
+        id: threeWaypoints
+        waypoints: [ { latitude: 50, longitude: 50 }, { latitude: 51, longitude: 52 },
+                     { latitude: 53, longitude: 54 } ]
+    }
+
+    RouteModel { id: model1; plugin: sharedPlugin1; query: twoWaypoints }
+    RouteModel { id: model2; plugin: sharedPlugin2; query: threeWaypoints }
+
+    SignalSpy { id: routes1Spy; target: model1; signalName: "routesChanged" }
+    SignalSpy { id: routes2Spy; target: model2; signalName: "routesChanged" }
+    SignalSpy { id: measurement2Spy; target: model2; signalName: "measurementSystemChanged" }
+
+    TestCase {
+        name: "SharedRouteModels"
+
+        function init() {
+            model1.reset()
+            model2.reset()
+            twoWaypoints.numberAlternativeRoutes = 1
+            threeWaypoints.numberAlternativeRoutes = 1
+            routes1Spy.clear()
+            routes2Spy.clear()
+        }
+
+        function test_replies() {
+            model1.update()
+            model2.update()
+            tryCompare(model1, "status", RouteModel.Ready)
+            tryCompare(model2, "status", RouteModel.Ready)
+            compare(model1.get(0).path.length, 2)
+            compare(model2.get(0).path.length, 3)
+            // the reply of the other model does not update the routes
+            wait(300)
+            compare(routes1Spy.count, 1)
+            compare(routes2Spy.count, 1)
+            compare(model1.get(0).path.length, 2)
+        }
+
+        function test_errors() {
+            // 'altroutes - 70' is the echoed error code
+            twoWaypoints.numberAlternativeRoutes = 72
+            model1.update()
+            model2.update()
+            tryCompare(model1, "status", RouteModel.Error)
+            tryCompare(model2, "status", RouteModel.Ready)
+            compare(model1.error, RouteModel.CommunicationError)
+            compare(model2.error, RouteModel.NoError)
+            compare(model2.count, 1)
+        }
+
+        function test_measurementSystem() {
+            compare(model1.measurementSystem, Locale.MetricSystem)
+            compare(model2.measurementSystem, Locale.MetricSystem)
+
+            measurement2Spy.clear()
+            model1.measurementSystem = Locale.ImperialSystem
+            compare(model1.measurementSystem, Locale.ImperialSystem)
+            compare(model2.measurementSystem, Locale.MetricSystem)
+            compare(measurement2Spy.count, 0)
+
+            model1.update()
+            model2.update()
+            tryCompare(model1, "status", RouteModel.Ready)
+            tryCompare(model2, "status", RouteModel.Ready)
+            compare(model1.get(0).extendedAttributes["tst_measurementSystem"], Locale.ImperialSystem)
+            compare(model2.get(0).extendedAttributes["tst_measurementSystem"], Locale.MetricSystem)
+
+            model1.measurementSystem = Locale.MetricSystem
+        }
+    }
+}
@@ -11,7 +11,7 @@ CONFIG -= app_bundle
 QT += location quick
 
 OTHER_FILES = *.qml
-TESTDATA = $$OTHER_FILES
+TESTDATA = $$OTHER_FILES marker_icons.png
 
 
 # Import path used by 'make check' since CI doesn't install test imports
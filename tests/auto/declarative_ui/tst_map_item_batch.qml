@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import QtLocation.Test 5.6
+
+Item {
+    id: masterItem
+    width: 200
+    height: 350
+
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: map
+        center: QtPositioning.coordinate(-30, 153)
+        plugin: testPlugin
+        anchors.fill: parent
+        zoomLevel: 9
+    }
+
+    Component {
+        id: circleComponent
+        MapCircle { radius: 100 }
+    }
+
+    Component {
+        id: groupComponent
+        MapItemGroup {
+            property alias inner: innerGroup
+            property alias innerCircle: innerCircle
+            MapCircle { center: QtPositioning.coordinate(-30, 153); radius: 100 }
+            MapCircle { center: QtPositioning.coordinate(-30.01, 153); radius: 100 }
+            MapItemGroup {
+                id: innerGroup
+                MapCircle { id: innerCircle; center: QtPositioning.coordinate(-30.02, 153); radius: 100 }
+            }
+        }
+    }
+
+    SignalSpy { id: mapItemsChangedSpy; target: map; signalName: "mapItemsChanged" }
+
+    TestCase {
+        name: "MapItemBatch"
+        when: windowShown && map.mapReady
+
+        function circles(count) {
+            var res = []
+            for (var i = 0; i < count; ++i) {
+                res.push(circleComponent.createObject(masterItem,
+                        { center: QtPositioning.coordinate(-30 + i * 0.001, 153) }))
+            }
+            return res
+        }
+
+        function test_add_remove() {
+            var items = circles(100)
+            mapItemsChangedSpy.clear()
+
+            map.addMapItems(items)
+            compare(map.mapItems.length, 100)
+            compare(mapItemsChangedSpy.count, 1)
+            for (var i = 0; i < items.length; ++i)
+                compare(items[i].parent, map)
+
+            // already on the map
+            map.addMapItems(items.slice(0, 10))
+            compare(map.mapItems.length, 100)
+            compare(mapItemsChangedSpy.count, 1)
+
+            // every other item, one of them twice
+            var odd = []
+            for (i = 1; i < items.length; i += 2)
+                odd.push(items[i])
+            odd.push(items[1])
+            map.removeMapItems(odd)
+            compare(map.mapItems.length, 50)
+            compare(mapItemsChangedSpy.count, 2)
+            for (i = 0; i < items.length; ++i)
+                compare(map.mapItems.indexOf(items[i]) >= 0, i % 2 == 0)
+
+            // single removals keep working after the batch
+            map.removeMapItem(items[0])
+            compare(map.mapItems.length, 49)
+            map.removeMapItem(items[0])
+            compare(map.mapItems.length, 49)
+
+            map.clearMapItems()
+            compare(map.mapItems.length, 0)
+            for (i = 0; i < items.length; ++i)
+                items[i].destroy()
+        }
+
+        function test_viewport_culling() {
+            // enough items for only those around the view to follow it
+            var near = circleComponent.createObject(masterItem,
+                    { center: QtPositioning.coordinate(-30, 153) })
+            var far = []
+            for (var i = 0; i < 99; ++i) {
+                far.push(circleComponent.createObject(masterItem,
+                        { center: QtPositioning.coordinate(10, 10 + i * 0.001) }))
+            }
+            map.center = QtPositioning.coordinate(-30, 153)
+            map.addMapItems(far)
+            map.addMapItem(near)
+            verify(LocationTestHelper.waitForPolished(map))
+
+            // the first update moves the far items out of the view, then they are left alone
+            map.center = QtPositioning.coordinate(-30.01, 153.01)
+            verify(LocationTestHelper.waitForPolished(map))
+            var farX = far[0].x
+            var nearX = near.x
+            map.center = QtPositioning.coordinate(-30.02, 153.02)
+            verify(LocationTestHelper.waitForPolished(map))
+            compare(far[0].x, farX)
+            verify(near.x !== nearX)
+
+            // and catch up once they are in view again
+            map.center = far[0].center
+            verify(LocationTestHelper.waitForPolished(map))
+            var point = map.fromCoordinate(far[0].center, false)
+            fuzzyCompare(far[0].x + far[0].width / 2, point.x, 2)
+            fuzzyCompare(far[0].y + far[0].height / 2, point.y, 2)
+
+            map.clearMapItems()
+            near.destroy()
+            for (i = 0; i < far.length; ++i)
+                far[i].destroy()
+        }
+
+        function test_nested_groups() {
+            var group = groupComponent.createObject(masterItem)
+            mapItemsChangedSpy.clear()
+            map.addMapItemGroup(group)
+            compare(map.mapItems.length, 3)
+            compare(mapItemsChangedSpy.count, 1)
+
+            // the groups tell their items of opacity changes down the nesting
+            var opacitySpy = Qt.createQmlObject("import QtTest 1.0; SignalSpy {}", masterItem)
+            opacitySpy.target = group.innerCircle
+            opacitySpy.signalName = "mapItemOpacityChanged"
+            group.opacity = 0.5
+            compare(opacitySpy.count, 1)
+            group.inner.opacity = 0.5
+            compare(opacitySpy.count, 2)
+
+            map.removeMapItemGroup(group)
+            compare(map.mapItems.length, 0)
+            compare(mapItemsChangedSpy.count, 2)
+
+            // destroying the group before its items is fine
+            group.destroy()
+            opacitySpy.destroy()
+            wait(0)
+        }
+
+        function test_destroyed_items() {
+            var items = circles(20)
+            map.addMapItems(items)
+            compare(map.mapItems.length, 20)
+
+            items[5].destroy()
+            items[12].destroy()
+            wait(0)
+            compare(map.mapItems.length, 18)
+
+            map.removeMapItems(items.slice(0, 10))
+            compare(map.mapItems.length, 10)
+            map.clearMapItems()
+            compare(map.mapItems.length, 0)
+        }
+    }
+}
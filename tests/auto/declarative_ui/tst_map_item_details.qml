@@ -433,6 +433,27 @@ Item {
             compare(polylineForSetpath.path[3], QtPositioning.coordinate(10, 175))
         }
 
+        function test_polyline_typed_array_path()
+        {
+            var originalPath = QtPositioning.shapeToPath(polylineForSetpath.geoShape)
+
+            polylineForSetpath.path = new Float64Array([20, -15, 20, -5, 10, -5])
+            verify(polylineForSetpath.path.length == 3)
+            compare(polylineForSetpath.path[0], QtPositioning.coordinate(20, -15))
+            compare(polylineForSetpath.path[2], QtPositioning.coordinate(10, -5))
+
+            polylineForSetpath.path = new Float64Array([25, 5, 15, 5]).buffer
+            verify(polylineForSetpath.path.length == 2)
+            compare(polylineForSetpath.path[1], QtPositioning.coordinate(15, 5))
+
+            // an odd number of values is not a path
+            polylineForSetpath.path = new Float64Array([25, 5, 15])
+            verify(polylineForSetpath.path.length == 0)
+
+            polylineForSetpath.setPath(originalPath)
+            verify(polylineForSetpath.path.length == 4)
+        }
+
     /*
 
      (0,0)   ---------------------------------------------------- (600,0)
@@ -572,6 +593,13 @@ Item {
             extMapPolygonDateline.path = path;
             point = map.fromCoordinate(extMapPolygonDateline.path[0])
             compare(point.x, map.width / 2.0)
+            // the array read is shared, a copy of it can be changed
+            verify(Object.isFrozen(extMapPolygonDateline.path))
+            verify(extMapPolygonDateline.path === extMapPolygonDateline.path)
+            path = extMapPolygonDateline.path.slice();
+            path.push(QtPositioning.coordinate(15, 175));
+            compare(extMapPolygonDateline.path.length, 4)
+            path.pop();
             path = extMapPolygonDateline.path;
             path[3].longitude = datelineCoordinate.longitude;
             extMapPolygonDateline.path = path;
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+// fitViewportToMapItems() from the bounding boxes kept by the spatial index of the map items,
+// and from the screen bounds when items are sized in pixels
+Item {
+    id: page
+    width: 256
+    height: 256
+    Plugin { id: testPlugin; name: "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: map
+        anchors.fill: parent
+        zoomLevel: 2
+        center: QtPositioning.coordinate(0, 0)
+        plugin: testPlugin
+
+        MapRectangle {
+            id: rect
+            color: "darkcyan"
+            topLeft: QtPositioning.coordinate(20, 20)
+            bottomRight: QtPositioning.coordinate(10, 30)
+        }
+        MapCircle {
+            id: circle
+            color: "darkmagenta"
+            center: QtPositioning.coordinate(-10, -20)
+            radius: 200000
+        }
+        MapPolyline {
+            id: polyline
+            line.width: 1
+            path: [
+                { latitude: 30, longitude: 40 },
+                { latitude: 25, longitude: 50 }
+            ]
+        }
+    }
+
+    MapQuickItem {
+        id: marker
+        coordinate: QtPositioning.coordinate(-20, 60)
+        sourceItem: Rectangle { width: 20; height: 20; color: "darkgreen" }
+    }
+
+    TestCase {
+        name: "MapItemsFitIndexed"
+        when: windowShown && map.mapReady
+
+        function init() {
+            map.removeMapItem(marker)
+            rect.topLeft = QtPositioning.coordinate(20, 20)
+            rect.bottomRight = QtPositioning.coordinate(10, 30)
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 2
+        }
+
+        function isVisible(coordinate) {
+            var p = map.fromCoordinate(coordinate, false)
+            return p.x >= -1 && p.x <= map.width + 1 && p.y >= -1 && p.y <= map.height + 1
+        }
+
+        function rectangleVisible() {
+            return isVisible(rect.topLeft) && isVisible(rect.bottomRight)
+        }
+
+        function circleVisible() {
+            return isVisible(circle.center.atDistanceAndAzimuth(circle.radius, 0))
+                    && isVisible(circle.center.atDistanceAndAzimuth(circle.radius, 90))
+                    && isVisible(circle.center.atDistanceAndAzimuth(circle.radius, 180))
+                    && isVisible(circle.center.atDistanceAndAzimuth(circle.radius, 270))
+        }
+
+        function polylineVisible() {
+            return isVisible(polyline.path[0]) && isVisible(polyline.path[1])
+        }
+
+        function test_all_items() {
+            map.zoomLevel = 6
+            map.center = QtPositioning.coordinate(60, -120)
+            verify(!rectangleVisible())
+            map.fitViewportToMapItems()
+            verify(rectangleVisible())
+            verify(circleVisible())
+            verify(polylineVisible())
+            compare(map.zoomLevel, Math.floor(map.zoomLevel))
+        }
+
+        function test_selection() {
+            map.fitViewportToMapItems()
+            var allZoom = map.zoomLevel
+
+            map.fitViewportToMapItems([rect])
+            verify(rectangleVisible())
+            verify(map.zoomLevel > allZoom)
+            verify(!circleVisible())
+            compare(map.zoomLevel, Math.floor(map.zoomLevel))
+
+            // the rectangle is in the middle of the map, within a pixel
+            var projectedTop = map.fromCoordinate(rect.topLeft, false)
+            var projectedBottom = map.fromCoordinate(rect.bottomRight, false)
+            fuzzyCompare((projectedTop.x + projectedBottom.x) / 2, map.width / 2, 1)
+            fuzzyCompare((projectedTop.y + projectedBottom.y) / 2, map.height / 2, 1)
+
+            map.fitViewportToMapItems([rect, polyline])
+            verify(rectangleVisible())
+            verify(polylineVisible())
+            verify(!circleVisible())
+        }
+
+        // the boxes follow the items
+        function test_moved_item() {
+            map.fitViewportToMapItems([rect])
+            rect.topLeft = QtPositioning.coordinate(-50, -60)
+            rect.bottomRight = QtPositioning.coordinate(-55, -50)
+            verify(!rectangleVisible())
+            map.fitViewportToMapItems([rect])
+            verify(rectangleVisible())
+            map.fitViewportToMapItems()
+            verify(rectangleVisible())
+            verify(circleVisible())
+            verify(polylineVisible())
+        }
+
+        // items sized in pixels are fitted from their screen bounds
+        function test_pixel_sized_items() {
+            map.addMapItem(marker)
+            map.center = QtPositioning.coordinate(60, -120)
+            map.fitViewportToMapItems()
+            verify(isVisible(marker.coordinate))
+            verify(rectangleVisible())
+            verify(circleVisible())
+
+            map.center = QtPositioning.coordinate(60, -120)
+            map.fitViewportToMapItems([marker, rect])
+            verify(isVisible(marker.coordinate))
+            verify(rectangleVisible())
+        }
+
+        // an empty selection fits all the items
+        function test_empty_selection() {
+            map.center = QtPositioning.coordinate(60, -120)
+            map.fitViewportToMapItems([])
+            verify(rectangleVisible())
+            verify(circleVisible())
+            verify(polylineVisible())
+        }
+    }
+}
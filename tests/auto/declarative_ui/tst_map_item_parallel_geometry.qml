@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+Item {
+    id: page
+    width: 300
+    height: 300
+
+    Plugin { id: testPlugin; name: "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: map
+        plugin: testPlugin
+        anchors.fill: parent
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+    }
+
+    Component {
+        id: polylineComponent
+        MapPolyline { line.width: 3 }
+    }
+    Component {
+        id: polygonComponent
+        MapPolygon { color: "red"; border.width: 2 }
+    }
+
+    TestCase {
+        name: "MapItemParallelGeometry"
+        when: windowShown && map.mapReady
+
+        readonly property int count: 24
+
+        // Paths of different shapes, some crossing the antimeridian
+        function path(i) {
+            var lat = (i % 6) * 10 - 30
+            var lon = Math.floor(i / 6) * 50 - 75 + (i % 3) * 5
+            return [ QtPositioning.coordinate(lat, lon),
+                     QtPositioning.coordinate(lat + 8, lon + 10 + i),
+                     QtPositioning.coordinate(lat + 2 + i % 4, lon + 20 + 2 * i) ]
+        }
+
+        function geometry(item) {
+            return [ item.x, item.y, item.width, item.height ].join(",")
+        }
+
+        function createItems() {
+            var items = []
+            for (var i = 0; i < count; ++i) {
+                var component = i % 2 ? polygonComponent : polylineComponent
+                items.push(component.createObject(page, { path: path(i) }))
+            }
+            return items
+        }
+
+        // Items polished in a pass of their own are prepared serially
+        function serialGeometries(items) {
+            var geometries = []
+            for (var i = 0; i < items.length; ++i) {
+                map.addMapItem(items[i])
+                waitForRendering(map)
+                geometries.push(geometry(items[i]))
+                map.removeMapItem(items[i])
+            }
+            return geometries
+        }
+
+        function test_parallelMatchesSerial_data() {
+            return [ { tag: "zoom 3", zoomLevel: 3 }, { tag: "zoom 4.5", zoomLevel: 4.5 } ]
+        }
+
+        // Many items polished at once are prepared on the thread pool, and
+        // get the same geometries.
+        function test_parallelMatchesSerial(data) {
+            map.zoomLevel = data.zoomLevel
+            var items = createItems()
+            var expected = serialGeometries(items)
+
+            for (var i = 0; i < count; ++i)
+                map.addMapItem(items[i])
+            waitForRendering(map)
+            for (i = 0; i < count; ++i)
+                compare(geometry(items[i]), expected[i], "item " + i)
+
+            // a camera change prepares all of them again
+            map.zoomLevel = 3.5
+            waitForRendering(map)
+            var moved = []
+            for (i = 0; i < count; ++i)
+                moved.push(geometry(items[i]))
+            map.clearMapItems()
+            var movedExpected = serialGeometries(items)
+            for (i = 0; i < count; ++i)
+                compare(moved[i], movedExpected[i], "item " + i + " after the camera change")
+
+            // a change of a path discards what was prepared for it
+            for (i = 0; i < count; ++i)
+                map.addMapItem(items[i])
+            waitForRendering(map)
+            items[0].path = path(2)
+            items[3].path = path(5)
+            waitForRendering(map)
+            compare(geometry(items[0]), movedExpected[2])
+            compare(geometry(items[3]), movedExpected[5])
+
+            map.clearMapItems()
+            for (i = 0; i < count; ++i)
+                items[i].destroy()
+        }
+    }
+}
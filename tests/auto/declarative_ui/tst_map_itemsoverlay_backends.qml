@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtQuick.Window 2.8
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+Item {
+    id: page
+    width: 200
+    height: 200
+
+    Plugin { id: itemsOverlay; name: "itemsoverlay" }
+    Plugin { id: testPlugin; name: "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: overlayMap
+        plugin: itemsOverlay
+        width: 100
+        height: 100
+        color: "transparent"
+        center: QtPositioning.coordinate(0, 0)
+    }
+
+    Map {
+        id: tiledMap
+        plugin: testPlugin
+        x: 100
+        width: 100
+        height: 100
+        center: QtPositioning.coordinate(0, 0)
+    }
+
+    Component {
+        id: circleComponent
+        MapCircle { center: QtPositioning.coordinate(0, 0); radius: 1000 }
+    }
+    Component {
+        id: rectangleComponent
+        MapRectangle {
+            topLeft: QtPositioning.coordinate(1, -1)
+            bottomRight: QtPositioning.coordinate(-1, 1)
+        }
+    }
+    Component {
+        id: polygonComponent
+        MapPolygon {
+            path: [ { latitude: 1, longitude: 0 }, { latitude: 0, longitude: 1 },
+                    { latitude: -1, longitude: 0 } ]
+        }
+    }
+    Component {
+        id: polylineComponent
+        MapPolyline {
+            path: [ { latitude: 1, longitude: 0 }, { latitude: 0, longitude: 1 } ]
+        }
+    }
+
+    TestCase {
+        name: "MapItemsOverlayBackends"
+        when: windowShown && overlayMap.mapReady && tiledMap.mapReady
+
+        function initTestCase() {
+            if (page.GraphicsInfo.api !== GraphicsInfo.OpenGL)
+                skip("The OpenGL map item backends need the OpenGL scene graph")
+        }
+
+        function test_defaultBackend_data() {
+            return [
+                { tag: "circle", component: circleComponent, preferred: MapCircle.OpenGL },
+                { tag: "rectangle", component: rectangleComponent, preferred: MapRectangle.OpenGL },
+                { tag: "polygon", component: polygonComponent, preferred: MapPolygon.OpenGL },
+                { tag: "polyline", component: polylineComponent, preferred: MapPolyline.OpenGLExtruded }
+            ]
+        }
+
+        // the Software backends are all 0
+        function test_defaultBackend(data) {
+            var item = data.component.createObject(page)
+            compare(item.backend, 0)
+
+            overlayMap.addMapItem(item)
+            compare(item.backend, data.preferred)
+
+            // back to the default once detached, and on other maps
+            overlayMap.removeMapItem(item)
+            compare(item.backend, 0)
+            tiledMap.addMapItem(item)
+            compare(item.backend, 0)
+            tiledMap.removeMapItem(item)
+
+            overlayMap.addMapItem(item)
+            compare(item.backend, data.preferred)
+            overlayMap.clearMapItems()
+            compare(item.backend, 0)
+            item.destroy()
+        }
+
+        function test_explicitBackend() {
+            var software = polylineComponent.createObject(page, { backend: MapPolyline.Software })
+            var lineStrip = polylineComponent.createObject(page, { backend: MapPolyline.OpenGLLineStrip })
+            overlayMap.addMapItem(software)
+            overlayMap.addMapItem(lineStrip)
+            compare(software.backend, MapPolyline.Software)
+            compare(lineStrip.backend, MapPolyline.OpenGLLineStrip)
+            overlayMap.clearMapItems()
+            compare(software.backend, MapPolyline.Software)
+            compare(lineStrip.backend, MapPolyline.OpenGLLineStrip)
+
+            // set while on the map, it sticks once detached
+            var circle = circleComponent.createObject(page)
+            overlayMap.addMapItem(circle)
+            compare(circle.backend, MapCircle.OpenGL)
+            circle.backend = MapCircle.OpenGL
+            overlayMap.removeMapItem(circle)
+            compare(circle.backend, MapCircle.OpenGL)
+
+            software.destroy()
+            lineStrip.destroy()
+            circle.destroy()
+        }
+    }
+}
@@ -0,0 +1,239 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import QtLocation.Test 5.5
+import QtQuick.Window 2.8
+import Qt.labs.location 1.0
+
+Item {
+    id: masterItem
+    width: 200
+    height: 350
+
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    // The frames rendered so far
+    property int frames: 0
+    Connections {
+        target: masterItem.Window.window
+        function onFrameSwapped() { ++masterItem.frames }
+    }
+
+    // Each delegate takes about 2 ms, more than the budget of a frame
+    function busy() {
+        var end = Date.now() + 2
+        while (Date.now() < end) {}
+    }
+
+    // The delegates created, in order
+    property var created: []
+
+    function record(row, coordinate, view) {
+        busy()
+        var p = view.fromCoordinate(coordinate, false)
+        var inset = 10
+        created.push({ row: row, frame: frames,
+                       inView: p.x >= inset && p.x <= view.width - inset
+                               && p.y >= inset && p.y <= view.height - inset,
+                       outOfView: p.x < -inset || p.x > view.width + inset
+                                  || p.y < -inset || p.y > view.height + inset })
+    }
+
+    // Rows from (-30, 153) onwards, each 0.2 degrees north and west of the previous one
+    TestModel {
+        id: testModel
+        datatype: 'coordinate'
+        datacount: 20
+        delay: 0
+    }
+
+    TestModel {
+        id: largeModel
+        datatype: 'coordinate'
+        datacount: 60
+        delay: 0
+    }
+
+    Map {
+        id: map
+
+        property int mapItemsLength: mapItems.length
+
+        center: QtPositioning.coordinate(-28, 151)
+        plugin: testPlugin
+        anchors.fill: parent
+        zoomLevel: 2
+
+        MapItemView {
+            id: budgetView
+            model: testModel
+            incubateDelegates: false
+            incubationBudget: 1
+            add: null
+            remove: null
+            delegate: Component {
+                MapCircle {
+                    radius: 100
+                    center: modeldata.coordinate
+                }
+            }
+        }
+
+        MapItemView {
+            id: spreadView
+            incubateDelegates: false
+            incubationBudget: 1
+            add: null
+            remove: null
+            delegate: Component {
+                MapCircle {
+                    radius: 100
+                    center: modeldata.coordinate
+                    Component.onCompleted: record(index, modeldata.coordinate, map)
+                }
+            }
+        }
+    }
+
+    Map {
+        id: objectMap
+        anchors.fill: parent
+        plugin: Plugin { name: "itemsoverlay" }
+        center: QtPositioning.coordinate(-24, 147)
+        zoomLevel: 4
+
+        MapObjectView {
+            id: objectView
+            incubationBudget: 1
+            delegate: MapCircleObject {
+                radius: 1000
+                center: modeldata.coordinate
+                Component.onCompleted: record(index, modeldata.coordinate, objectMap)
+            }
+        }
+    }
+
+    function createdFrames() {
+        var first = created[0].frame
+        return created[created.length - 1].frame - first
+    }
+
+    TestCase {
+        name: "MapItemViewIncubationBudget"
+        when: windowShown && map.mapReady
+
+        function test_budget() {
+            compare(budgetView.incubationBudget, 1)
+            tryCompare(map, "mapItemsLength", testModel.datacount)
+
+            // with culling, the rows coming into view get their delegates over the frames
+            budgetView.cullingMargin = 0
+            budgetView.cullingRole = "modeldata"
+            map.center = QtPositioning.coordinate(30, -30)
+            map.zoomLevel = 9
+            tryCompare(map, "mapItemsLength", 0)
+            map.center = QtPositioning.coordinate(-28, 151)
+            map.zoomLevel = 2
+            tryCompare(map, "mapItemsLength", testModel.datacount)
+
+            // removing the budget creates the missing ones at once
+            map.center = QtPositioning.coordinate(30, -30)
+            map.zoomLevel = 9
+            tryCompare(map, "mapItemsLength", 0)
+            budgetView.cullingRole = ""
+            budgetView.incubationBudget = -1
+            compare(budgetView.incubationBudget, 0)
+            tryCompare(map, "mapItemsLength", testModel.datacount)
+        }
+
+        function cleanup() {
+            spreadView.model = null
+            spreadView.cullingRole = ""
+            objectView.model = null
+            created = []
+        }
+
+        // the delegates of a model much larger than the budget are created over many frames
+        function test_frames() {
+            spreadView.model = largeModel
+            verify(created.length < largeModel.datacount)
+            tryVerify(function() { return created.length === largeModel.datacount }, 10000)
+            verify(createdFrames() >= 10)
+        }
+
+        // with culling, the rows in view come first, then the ones within the margin
+        function test_inViewFirst() {
+            // about 11 rows in view, around row 30
+            map.center = QtPositioning.coordinate(-24, 147)
+            map.zoomLevel = 7
+            spreadView.cullingMargin = 1
+            spreadView.cullingRole = "modeldata"
+            spreadView.model = largeModel
+            tryVerify(function() {
+                return created.filter(function(d) { return d.outOfView }).length > 3
+            }, 10000)
+            wait(200)
+
+            var lastInView = -1
+            var firstOutOfView = created.length
+            var inViewCount = 0
+            for (var i = 0; i < created.length; ++i) {
+                if (created[i].inView) {
+                    lastInView = i
+                    ++inViewCount
+                } else if (created[i].outOfView) {
+                    firstOutOfView = Math.min(firstOutOfView, i)
+                }
+            }
+            verify(inViewCount > 3)
+            verify(created.length < largeModel.datacount) // the rows beyond the margin are culled
+            verify(lastInView < firstOutOfView)
+            verify(createdFrames() >= 5)
+        }
+
+        // a MapObjectView requests the delegates over the frames as well
+        function test_objectView() {
+            compare(objectView.incubationBudget, 1)
+            objectView.model = largeModel
+            verify(created.length < largeModel.datacount)
+            tryVerify(function() { return created.length === largeModel.datacount }, 10000)
+            verify(createdFrames() >= 10)
+
+            // without a budget, all of them are requested at once
+            objectView.model = null
+            created = []
+            objectView.incubationBudget = 0
+            objectView.model = largeModel
+            tryVerify(function() { return created.length === largeModel.datacount }, 10000)
+            objectView.incubationBudget = 1
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import QtLocation.Test 5.5
+
+Item {
+    id: masterItem
+    width: 200
+    height: 350
+
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    // Rows from (-30, 153) onwards, each 0.2 degrees north and west of the previous one
+    TestModel {
+        id: testModel
+        datatype: 'coordinate'
+        datacount: 20
+        delay: 0
+    }
+
+    Map {
+        id: map
+
+        property int mapItemsLength: mapItems.length
+
+        center: QtPositioning.coordinate(-30, 153)
+        plugin: testPlugin
+        anchors.fill: parent
+        zoomLevel: 9
+
+        MapItemView {
+            id: culledView
+            model: testModel
+            incubateDelegates: false
+            add: null
+            remove: null
+            cullingRole: "modeldata"
+            cullingMargin: 0
+            delegate: Component {
+                MapCircle {
+                    radius: 100
+                    center: modeldata.coordinate
+                }
+            }
+        }
+    }
+
+    TestCase {
+        name: "MapItemViewCulling"
+        when: windowShown && map.mapReady
+
+        function test_culling() {
+            tryVerify(function() { return map.mapItemsLength > 0 })
+            verify(map.mapItemsLength < testModel.datacount)
+
+            // far from all the rows
+            map.center = QtPositioning.coordinate(30, -30)
+            tryCompare(map, "mapItemsLength", 0)
+
+            // every row visible
+            map.center = QtPositioning.coordinate(-28, 151)
+            map.zoomLevel = 2
+            tryCompare(map, "mapItemsLength", testModel.datacount)
+
+            // disabling culling instantiates everything
+            map.zoomLevel = 9
+            map.center = QtPositioning.coordinate(30, -30)
+            tryCompare(map, "mapItemsLength", 0)
+            culledView.cullingRole = ""
+            tryCompare(map, "mapItemsLength", testModel.datacount)
+            culledView.cullingRole = "modeldata"
+            tryCompare(map, "mapItemsLength", 0)
+        }
+    }
+}
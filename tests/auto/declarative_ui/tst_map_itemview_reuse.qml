@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+Item {
+    id: masterItem
+    width: 200
+    height: 350
+
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: map
+
+        center: QtPositioning.coordinate(12, 32)
+        plugin: testPlugin
+        anchors.fill: parent
+        zoomLevel: 2
+
+        MapItemView {
+            id: reusingView
+            incubateDelegates: false
+            reuseItems: true
+            identityRole: "vid"
+            model: ListModel {
+                id: vehicles
+                ListElement { vid: "a"; lat: 11; lon: 31 }
+                ListElement { vid: "b"; lat: 12; lon: 32 }
+                ListElement { vid: "c"; lat: 13; lon: 33 }
+            }
+            delegate: Component {
+                MapCircle {
+                    radius: 1500000
+                    center {
+                        latitude: lat
+                        longitude: lon
+                    }
+                }
+            }
+        }
+    }
+
+    TestCase {
+        name: "MapItemViewReuse"
+        when: windowShown && map.mapReady
+
+        function test_reuse() {
+            tryCompare(reusingView.mapItems, "length", 3)
+            var items = reusingView.mapItems
+
+            // rows keeping their identity keep their delegate
+            vehicles.move(0, 2, 1)
+            compare(reusingView.mapItems.length, 3)
+            compare(reusingView.mapItems[0], items[1])
+            compare(reusingView.mapItems[1], items[2])
+            compare(reusingView.mapItems[2], items[0])
+            compare(reusingView.mapItems[2].center, QtPositioning.coordinate(11, 31))
+
+            // delegates of removed rows serve the rows added afterwards
+            vehicles.clear()
+            compare(reusingView.mapItems.length, 0)
+            compare(map.mapItems.length, 0)
+            vehicles.append({ vid: "d", lat: 14, lon: 34 })
+            vehicles.append({ vid: "e", lat: 15, lon: 35 })
+            vehicles.append({ vid: "f", lat: 16, lon: 36 })
+            compare(reusingView.mapItems.length, 3)
+            compare(map.mapItems.length, 3)
+            for (var i = 0; i < 3; ++i)
+                verify(items.indexOf(reusingView.mapItems[i]) >= 0)
+            compare(reusingView.mapItems[0].center, QtPositioning.coordinate(14, 34))
+        }
+    }
+}
@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import QtLocation.Test 5.6
+import Qt.labs.location 1.0
+
+Item {
+    id: page
+    width: 200
+    height: 200
+
+    Plugin { id: testPlugin; name: "qmlgeo.test.plugin"; allowExperimental: true }
+
+    CoordinateTestModel { id: markerModel }
+
+    Map {
+        id: map
+        plugin: testPlugin
+        anchors.fill: parent
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 4
+
+        MapMarkerLayer {
+            id: layer
+            model: markerModel
+            clusterRadius: 30
+        }
+    }
+
+    TestCase {
+        name: "MapMarkerLayerClusters"
+        when: windowShown && map.mapReady
+
+        property var mercators: []
+        property int seed: 1
+
+        function random() {
+            seed = seed * 16807 % 2147483647
+            return seed / 2147483647
+        }
+
+        function mercator(coordinate) {
+            var lat = coordinate.latitude * Math.PI / 180
+            return Qt.point(coordinate.longitude / 360 + 0.5,
+                            0.5 - Math.log(Math.tan(Math.PI / 4 + lat / 2)) / (2 * Math.PI))
+        }
+
+        function cellOf(p, cellSize) {
+            return Math.floor(p.x / cellSize) + "," + Math.floor(p.y / cellSize)
+        }
+
+        // whether p lies too close to a cell edge of the zoom levels checked
+        // for the two mercator projections to agree on its cell
+        function nearEdge(p) {
+            for (var zoom = 0; zoom <= 20; ++zoom) {
+                var cellSize = layer.clusterRadius / (256 * Math.pow(2, zoom))
+                var fx = p.x / cellSize - Math.floor(p.x / cellSize)
+                var fy = p.y / cellSize - Math.floor(p.y / cellSize)
+                if (fx < 1e-6 || fx > 1 - 1e-6 || fy < 1e-6 || fy > 1 - 1e-6)
+                    return true
+            }
+            return false
+        }
+
+        function initTestCase() {
+            while (markerModel.count < 400) {
+                var coordinate = QtPositioning.coordinate(random() * 20 - 10, random() * 40 - 20)
+                var p = mercator(coordinate)
+                if (nearEdge(p))
+                    continue
+                mercators.push(p)
+                markerModel.append(coordinate)
+            }
+            compare(layer.count, 400)
+            tryVerify(function() { return layer.clusterCount < layer.count })
+        }
+
+        function test_membership_data() {
+            return [
+                { tag: "zoom 2", zoomLevel: 2 },
+                { tag: "zoom 4", zoomLevel: 4.5 },
+                { tag: "zoom 7", zoomLevel: 7 },
+                { tag: "zoom 11", zoomLevel: 11.9 }
+            ]
+        }
+
+        // every cluster holds exactly the markers of its grid cell, as found
+        // by comparing all of them
+        function test_membership(data) {
+            map.zoomLevel = data.zoomLevel
+            var cellSize = Math.min(1, layer.clusterRadius / (256 * Math.pow(2, Math.floor(data.zoomLevel))))
+            var cells = {}
+            for (var row = 0; row < mercators.length; ++row) {
+                var cell = cellOf(mercators[row], cellSize)
+                cells[cell] = (cells[cell] || 0) + 1
+            }
+
+            var seen = []
+            var clusters = 0
+            for (row = 0; row < mercators.length; ++row) {
+                var rows = layer.clusterMarkers(row)
+                if (rows.length === 0)
+                    continue
+                ++clusters
+                cell = cellOf(mercators[row], cellSize)
+                compare(rows.length, cells[cell], "cluster of row " + row)
+                compare(rows[0], row, "represented by its first marker")
+                for (var i = 0; i < rows.length; ++i) {
+                    compare(cellOf(mercators[rows[i]], cellSize), cell, "row " + rows[i] + " in the cluster of row " + row)
+                    verify(!seen[rows[i]], "row " + rows[i] + " in a single cluster")
+                    seen[rows[i]] = true
+                }
+            }
+            compare(clusters, Object.keys(cells).length)
+            compare(clusters, layer.clusterCount)
+        }
+    }
+}
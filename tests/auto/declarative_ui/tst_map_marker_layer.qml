@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import QtLocation.Test 5.6
+import Qt.labs.location 1.0
+
+Item {
+    id: page
+    width: 300
+    height: 300
+
+    Rectangle {
+        anchors.fill: parent
+        color: "white"
+    }
+
+    CoordinateTestModel { id: markerModel }
+
+    Map {
+        id: map
+        anchors.fill: parent
+        plugin: Plugin { name: "itemsoverlay" }
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 4
+        copyrightsVisible: false
+
+        // a red icon and a blue one, 16 pixels wide
+        MapMarkerLayer {
+            id: layer
+            model: markerModel
+            iconSource: Qt.resolvedUrl("marker_icons.png")
+            anchorPoint: Qt.point(8, 8)
+        }
+    }
+
+    SignalSpy { id: countSpy; target: layer; signalName: "countChanged" }
+
+    TestCase {
+        name: "MapMarkerLayer"
+        when: windowShown && map.mapReady
+
+        // the row of the marker drawn at coordinate
+        function markerAt(latitude, longitude) {
+            var p = map.fromCoordinate(QtPositioning.coordinate(latitude, longitude), false)
+            p = layer.mapFromItem(map, p.x, p.y)
+            return layer.markerAt(Qt.point(p.x, p.y))
+        }
+
+        function colorAt(latitude, longitude) {
+            var image = grabImage(map)
+            var p = map.fromCoordinate(QtPositioning.coordinate(latitude, longitude), false)
+            return image.pixel(Math.round(p.x), Math.round(p.y))
+        }
+
+        function verifyColor(latitude, longitude, color) {
+            tryVerify(function() { return Qt.colorEqual(colorAt(latitude, longitude), color) },
+                      5000, color + " at " + latitude + ", " + longitude)
+        }
+
+        function init() {
+            markerModel.clear()
+            layer.iconRole = "icon"
+            countSpy.clear()
+        }
+
+        function test_iconSize() {
+            compare(layer.iconSize, Qt.size(16, 16))
+        }
+
+        function test_insertRemove() {
+            markerModel.append(QtPositioning.coordinate(0, 0))
+            markerModel.append(QtPositioning.coordinate(4, 4))
+            compare(layer.count, 2)
+            compare(markerAt(0, 0), 0)
+            compare(markerAt(4, 4), 1)
+            compare(markerAt(-4, -4), -1)
+
+            // the rows after an inserted one move down
+            markerModel.insert(0, QtPositioning.coordinate(-4, -4))
+            compare(layer.count, 3)
+            compare(markerAt(-4, -4), 0)
+            compare(markerAt(0, 0), 1)
+            compare(markerAt(4, 4), 2)
+
+            // and up after a removed one
+            markerModel.remove(1)
+            compare(layer.count, 2)
+            compare(markerAt(-4, -4), 0)
+            compare(markerAt(0, 0), -1)
+            compare(markerAt(4, 4), 1)
+            verifyColor(0, 0, "white")
+            verifyColor(4, 4, "red")
+            verify(countSpy.count >= 4)
+        }
+
+        function test_dataChanged() {
+            markerModel.append(QtPositioning.coordinate(0, 0))
+            markerModel.append(QtPositioning.coordinate(4, 4))
+            compare(markerAt(0, 0), 0)
+            markerModel.setCoordinate(0, QtPositioning.coordinate(-4, 4))
+            compare(markerAt(0, 0), -1)
+            compare(markerAt(-4, 4), 0)
+            compare(markerAt(4, 4), 1)
+            verifyColor(-4, 4, "red")
+            verifyColor(0, 0, "white")
+
+            // an invalid coordinate hides the marker
+            markerModel.setCoordinate(1, QtPositioning.coordinate())
+            compare(layer.count, 2)
+            compare(markerAt(4, 4), -1)
+        }
+
+        // hits found through the grid index match those of testing every marker
+        function test_markerAtGrid() {
+            var coordinates = []
+            for (var i = 0; i < 20; ++i) {
+                for (var j = 0; j < 20; ++j) {
+                    var coordinate = QtPositioning.coordinate(-9.5 + i, -9.5 + j)
+                    coordinates.push(coordinate)
+                    markerModel.append(coordinate)
+                }
+            }
+            compare(layer.count, 400)
+            for (var row = 0; row < coordinates.length; row += 7)
+                compare(markerAt(coordinates[row].latitude, coordinates[row].longitude), row)
+            compare(markerAt(30, 30), -1)
+            compare(markerAt(-30, 0), -1)
+
+            // overlapping markers give the topmost one, the last row
+            markerModel.append(coordinates[42])
+            compare(markerAt(coordinates[42].latitude, coordinates[42].longitude), 400)
+
+            // the index follows the changes
+            markerModel.setCoordinate(0, QtPositioning.coordinate(30, 30))
+            compare(markerAt(30, 30), 0)
+            compare(markerAt(coordinates[0].latitude, coordinates[0].longitude), -1)
+            markerModel.remove(0)
+            compare(markerAt(30, 30), -1)
+            compare(markerAt(coordinates[1].latitude, coordinates[1].longitude), 0)
+        }
+
+        function test_iconRole() {
+            markerModel.append(QtPositioning.coordinate(0, 0), 0)
+            markerModel.append(QtPositioning.coordinate(4, 4), 1)
+            // out of range, the last icon
+            markerModel.append(QtPositioning.coordinate(-4, -4), 5)
+            verifyColor(0, 0, "red")
+            verifyColor(4, 4, "blue")
+            verifyColor(-4, -4, "blue")
+
+            markerModel.setIcon(0, 1)
+            verifyColor(0, 0, "blue")
+
+            // without the role, all markers have the first icon
+            layer.iconRole = "none"
+            verifyColor(0, 0, "red")
+            verifyColor(4, 4, "red")
+            layer.iconRole = "icon"
+            verifyColor(4, 4, "blue")
+        }
+    }
+}
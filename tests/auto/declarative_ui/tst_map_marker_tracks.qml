@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import QtLocation.Test 5.6
+import Qt.labs.location 1.0
+
+Item {
+    id: page
+    width: 200
+    height: 200
+
+    Plugin { id: testPlugin; name: "qmlgeo.test.plugin"; allowExperimental: true }
+
+    CoordinateTestModel { id: markerModel }
+
+    Map {
+        id: map
+        plugin: testPlugin
+        anchors.fill: parent
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 4
+
+        MapMarkerLayer {
+            id: layer
+            model: markerModel
+            iconSize: Qt.size(8, 8)
+            anchorPoint: Qt.point(4, 4)
+        }
+    }
+
+    TestCase {
+        name: "MapMarkerLayerTracks"
+        when: windowShown && map.mapReady
+
+        // the row of the marker drawn at coordinate
+        function markerAt(latitude, longitude) {
+            var p = map.fromCoordinate(QtPositioning.coordinate(latitude, longitude), false)
+            p = layer.mapFromItem(map, p.x, p.y)
+            return layer.markerAt(Qt.point(p.x, p.y))
+        }
+
+        function ago(msecs) {
+            return new Date(Date.now() - msecs)
+        }
+
+        function init() {
+            markerModel.clear()
+            markerModel.append(QtPositioning.coordinate(0, 0))
+            markerModel.append(QtPositioning.coordinate(4, 4))
+            layer.interpolationDelay = 0
+            layer.extrapolationTime = 0
+            compare(layer.count, 2)
+            tryCompare(layer, "clusterCount", 2)
+            compare(markerAt(0, 0), 0)
+        }
+
+        function test_settle() {
+            layer.addFix(0, QtPositioning.coordinate(-4, -4), ago(1500))
+            layer.addFix(0, QtPositioning.coordinate(-4, 4), ago(1000))
+            // blended back onto the trajectory within the time between the fixes
+            tryVerify(function() { return markerAt(-4, 4) === 0 }, 5000)
+            compare(markerAt(0, 0), -1)
+            compare(markerAt(4, 4), 1, "the markers not tracked stay at their rows")
+        }
+
+        function test_extrapolation() {
+            layer.extrapolationTime = 500
+            // 4 degrees per second for half a second after the last fix
+            layer.addFix(0, QtPositioning.coordinate(-4, -8), ago(2000))
+            layer.addFix(0, QtPositioning.coordinate(-4, -4), ago(1000))
+            tryVerify(function() { return markerAt(-4, -2) === 0 }, 5000)
+            compare(markerAt(-4, -4), -1)
+        }
+
+        function test_staleFix() {
+            layer.addFix(0, QtPositioning.coordinate(-4, 4), ago(1000))
+            tryVerify(function() { return markerAt(-4, 4) === 0 }, 5000)
+            layer.addFix(0, QtPositioning.coordinate(-4, -4), ago(2000))
+            wait(100)
+            compare(markerAt(-4, 4), 0)
+        }
+
+        function test_clearFixes() {
+            layer.addFix(1, QtPositioning.coordinate(-4, -4), ago(1000))
+            tryVerify(function() { return markerAt(-4, -4) === 1 }, 5000)
+            compare(markerAt(4, 4), -1)
+            layer.clearFixes()
+            tryVerify(function() { return markerAt(4, 4) === 1 }, 5000)
+            compare(markerAt(-4, -4), -1)
+        }
+
+        function test_modelReset() {
+            layer.addFix(0, QtPositioning.coordinate(-4, -4), ago(1000))
+            tryVerify(function() { return markerAt(-4, -4) === 0 }, 5000)
+            markerModel.clear()
+            markerModel.append(QtPositioning.coordinate(0, 0))
+            tryVerify(function() { return markerAt(0, 0) === 0 }, 5000)
+        }
+    }
+}
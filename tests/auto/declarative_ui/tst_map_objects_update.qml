@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import Qt.labs.location 1.0
+
+Item {
+    id: masterItem
+    width: 300
+    height: 300
+
+    Rectangle {
+        anchors.fill: parent
+        color: "white"
+    }
+
+    Map {
+        id: map
+        anchors.fill: parent
+        plugin: Plugin { name: "itemsoverlay" }
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 4
+        copyrightsVisible: false
+
+        MapObjectView {
+            id: objectView
+            MapCircleObject {
+                id: west
+                center: QtPositioning.coordinate(0, -10)
+                radius: 300000
+                color: "red"
+            }
+            MapCircleObject {
+                id: east
+                center: QtPositioning.coordinate(0, 10)
+                radius: 300000
+                color: "blue"
+            }
+        }
+    }
+
+    TestCase {
+        name: "MapObjectsNodeUpdates"
+        when: windowShown && map.mapReady
+
+        function colorAt(coordinate) {
+            var image = grabImage(map)
+            var p = map.fromCoordinate(coordinate, false)
+            return image.pixel(Math.round(p.x), Math.round(p.y))
+        }
+
+        function test_updates() {
+            tryVerify(function() { return Qt.colorEqual(colorAt(west.center), "red") })
+            verify(Qt.colorEqual(colorAt(east.center), "blue"))
+
+            // Only the changed object gets a new node, the other keeps its own
+            west.color = "lime"
+            tryVerify(function() { return Qt.colorEqual(colorAt(west.center), "lime") })
+            verify(Qt.colorEqual(colorAt(east.center), "blue"))
+
+            // A moved object leaves no node behind at its old place
+            var oldCenter = west.center
+            west.center = QtPositioning.coordinate(10, -10)
+            tryVerify(function() { return Qt.colorEqual(colorAt(west.center), "lime") })
+            verify(Qt.colorEqual(colorAt(oldCenter), "white"))
+            verify(Qt.colorEqual(colorAt(east.center), "blue"))
+
+            // Hiding and showing an object updates its node only
+            east.visible = false
+            tryVerify(function() { return Qt.colorEqual(colorAt(east.center), "white") })
+            verify(Qt.colorEqual(colorAt(west.center), "lime"))
+            east.visible = true
+            tryVerify(function() { return Qt.colorEqual(colorAt(east.center), "blue") })
+
+            // Camera changes still reach every node
+            map.center = QtPositioning.coordinate(0, 5)
+            tryVerify(function() { return Qt.colorEqual(colorAt(east.center), "blue") })
+            verify(Qt.colorEqual(colorAt(west.center), "lime"))
+        }
+    }
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+Item {
+    id: page
+    width: 300
+    height: 300
+
+    Rectangle {
+        anchors.fill: parent
+        color: "white"
+    }
+
+    Map {
+        id: map
+        anchors.fill: parent
+        plugin: Plugin { name: "itemsoverlay" }
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 4
+        copyrightsVisible: false
+
+        MapPolygon {
+            id: polygon
+            color: "red"
+            border.width: 0
+        }
+    }
+
+    TestCase {
+        name: "MapPolygonFill"
+        when: windowShown && map.mapReady
+
+        function coordinates(points) {
+            var path = []
+            for (var i = 0; i < points.length; ++i)
+                path.push(QtPositioning.coordinate(points[i][0], points[i][1]))
+            return path
+        }
+
+        // A U lying open to the north: simple, concave, well inside the projectable region
+        readonly property var uShape: [ [8, -10], [-8, -10], [-8, 10], [8, 10],
+                                        [8, 3], [0, 3], [0, -3], [8, -3] ]
+
+        function colorAt(lat, lon) {
+            var image = grabImage(map)
+            var p = map.fromCoordinate(QtPositioning.coordinate(lat, lon), false)
+            return image.pixel(Math.round(p.x), Math.round(p.y))
+        }
+
+        function verifyFilled(points, filled) {
+            for (var i = 0; i < points.length; ++i) {
+                var lat = points[i][0], lon = points[i][1]
+                tryVerify(function() { return Qt.colorEqual(colorAt(lat, lon), filled ? "red" : "white") },
+                          5000, (filled ? "filled at " : "empty at ") + lat + ", " + lon)
+            }
+        }
+
+        function init() {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 4
+        }
+
+        function cleanup() {
+            polygon.path = []
+        }
+
+        // Simple polygons are triangulated once per zoom level without clipping,
+        // and still fill their concave parts only
+        function test_concave() {
+            polygon.path = coordinates(uShape)
+            verifyFilled([[4, -6], [4, 6], [-4, 0], [-4, -8], [-4, 8]], true)
+            verifyFilled([[4, 0], [7, 0], [12, 0], [0, 12], [-10, 0]], false)
+
+            // panning reuses the triangles
+            map.center = QtPositioning.coordinate(2, 3)
+            verifyFilled([[4, -6], [4, 6], [-4, 0]], true)
+            verifyFilled([[4, 0], [7, 0]], false)
+
+            // another integer zoom level gets triangles of its own
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 5.5
+            verifyFilled([[3, -4], [3, 4], [-3, 0]], true)
+            verifyFilled([[3, 0], [1, 0]], false)
+        }
+
+        function test_pathChange() {
+            polygon.path = coordinates(uShape)
+            verifyFilled([[-4, 0]], true)
+            verifyFilled([[4, 0]], false)
+
+            // the same U open to the south
+            var flipped = []
+            for (var i = 0; i < uShape.length; ++i)
+                flipped.push([-uShape[i][0], uShape[i][1]])
+            polygon.path = coordinates(flipped)
+            verifyFilled([[4, 0], [-4, -6], [-4, 6]], true)
+            verifyFilled([[-4, 0], [-7, 0]], false)
+        }
+
+        // Many vertices closer together than a pixel are thinned out first
+        function test_denseRing() {
+            var points = []
+            for (var i = 0; i < 2000; ++i) {
+                var a = 2 * Math.PI * i / 2000
+                points.push([8 * Math.sin(a), 8 * Math.cos(a) + 0.05 * Math.sin(40 * a)])
+            }
+            polygon.path = coordinates(points)
+            verifyFilled([[0, 0], [6, 0], [0, -7], [-6, 3]], true)
+            verifyFilled([[0, 9], [9, 0], [-7, -7]], false)
+        }
+
+        // A self-intersecting ring is not simple, and takes the clipping path
+        function test_selfIntersecting() {
+            polygon.path = coordinates([ [8, -10], [-8, 10], [8, 10], [-8, -10] ])
+            verifyFilled([[0, 7], [0, -7]], true)
+            verifyFilled([[6, 0], [-6, 0], [0, 12]], false)
+        }
+
+        // A ring across the antimeridian does not stay in one wrap piece, and is clipped
+        function test_antimeridian() {
+            map.center = QtPositioning.coordinate(0, 180)
+            polygon.path = coordinates([ [5, 172], [5, -172], [-5, -172], [-5, 172] ])
+            verifyFilled([[0, 178], [0, -178], [3, 175], [-3, -175]], true)
+            verifyFilled([[0, 168], [0, -168], [7, 180]], false)
+        }
+    }
+}
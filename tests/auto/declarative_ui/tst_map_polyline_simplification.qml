@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+// The coordinates added to a MapPolyline with a simplification tolerance replace the last
+// one while they continue its line
+Item {
+    id: page
+    width: 100
+    height: 100
+
+    MapPolyline {
+        id: breadcrumb
+        path: [ { latitude: 0, longitude: 0 } ]
+    }
+
+    MapPolyline {
+        id: everyFix
+        path: [ { latitude: 0, longitude: 0 } ]
+    }
+
+    SignalSpy { id: toleranceSpy; target: breadcrumb; signalName: "simplificationToleranceChanged" }
+    SignalSpy { id: pathSpy; target: breadcrumb; signalName: "pathChanged" }
+
+    TestCase {
+        name: "MapPolylineSimplification"
+        when: windowShown
+
+        function lastCoordinate(polyline) {
+            return polyline.coordinateAt(polyline.pathLength() - 1)
+        }
+
+        function test_tolerance() {
+            compare(everyFix.simplificationTolerance, 0)
+            for (var i = 1; i <= 3; ++i)
+                everyFix.addCoordinate(QtPositioning.coordinate(0, i * 0.001))
+            compare(everyFix.pathLength(), 4)
+
+            breadcrumb.simplificationTolerance = 0
+            toleranceSpy.clear()
+            breadcrumb.simplificationTolerance = 10
+            compare(breadcrumb.simplificationTolerance, 10)
+            compare(toleranceSpy.count, 1)
+            breadcrumb.simplificationTolerance = 10
+            compare(toleranceSpy.count, 1)
+            breadcrumb.simplificationTolerance = -5
+            compare(breadcrumb.simplificationTolerance, 0)
+            compare(toleranceSpy.count, 2)
+        }
+
+        function test_addCoordinate() {
+            breadcrumb.path = [ { latitude: 0, longitude: 0 } ]
+            breadcrumb.simplificationTolerance = 10
+            pathSpy.clear()
+
+            // east along the equator, about 111 meters apart
+            for (var i = 1; i <= 3; ++i)
+                breadcrumb.addCoordinate(QtPositioning.coordinate(0, i * 0.001))
+            compare(breadcrumb.pathLength(), 2)
+            compare(lastCoordinate(breadcrumb), QtPositioning.coordinate(0, 0.003))
+            compare(pathSpy.count, 3)
+
+            // turning north
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0.001, 0.003))
+            compare(breadcrumb.pathLength(), 3)
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0.002, 0.003))
+            compare(breadcrumb.pathLength(), 3)
+            // about 5 meters off the line
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0.003, 0.00300005))
+            compare(breadcrumb.pathLength(), 3)
+            compare(lastCoordinate(breadcrumb), QtPositioning.coordinate(0.003, 0.00300005))
+            compare(breadcrumb.coordinateAt(1), QtPositioning.coordinate(0, 0.003))
+            // about 50 meters off
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0.004, 0.0025))
+            compare(breadcrumb.pathLength(), 4)
+            compare(pathSpy.count, 7)
+
+            // invalid coordinates are ignored
+            breadcrumb.addCoordinate(QtPositioning.coordinate())
+            compare(breadcrumb.pathLength(), 4)
+            compare(pathSpy.count, 7)
+        }
+
+        // the other changes of the path are kept as they are, and the coordinates added next
+        // continue from the last one
+        function test_otherChanges() {
+            breadcrumb.path = [ { latitude: 0, longitude: 0 }, { latitude: 0, longitude: 0.001 } ]
+            breadcrumb.simplificationTolerance = 10
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.002))
+            compare(breadcrumb.pathLength(), 3)
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.003))
+            compare(breadcrumb.pathLength(), 3)
+
+            breadcrumb.replaceCoordinate(0, QtPositioning.coordinate(0, -0.001))
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.004))
+            compare(breadcrumb.pathLength(), 4)
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.005))
+            compare(breadcrumb.pathLength(), 4)
+            compare(lastCoordinate(breadcrumb), QtPositioning.coordinate(0, 0.005))
+
+            breadcrumb.insertCoordinate(1, QtPositioning.coordinate(0.001, 0))
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.006))
+            compare(breadcrumb.pathLength(), 6)
+
+            breadcrumb.removeCoordinate(1)
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.007))
+            compare(breadcrumb.pathLength(), 6)
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.008))
+            compare(breadcrumb.pathLength(), 6)
+
+            // a new tolerance restarts from the last vertex too
+            breadcrumb.simplificationTolerance = 20
+            breadcrumb.addCoordinate(QtPositioning.coordinate(0, 0.009))
+            compare(breadcrumb.pathLength(), 7)
+        }
+    }
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+import Qt.labs.location 1.0
+
+Item {
+    id: page
+    width: 300
+    height: 300
+
+    Rectangle {
+        anchors.fill: parent
+        color: "white"
+    }
+
+    Map {
+        id: map
+        anchors.fill: parent
+        plugin: Plugin { name: "itemsoverlay" }
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 4
+        copyrightsVisible: false
+
+        MapPositionIndicator {
+            id: indicator
+            color: "red"
+        }
+    }
+
+    SignalSpy { id: colorSpy; target: indicator; signalName: "colorChanged" }
+    SignalSpy { id: radiusSpy; target: indicator; signalName: "radiusChanged" }
+    SignalSpy { id: delaySpy; target: indicator; signalName: "interpolationDelayChanged" }
+    SignalSpy { id: extrapolationSpy; target: indicator; signalName: "extrapolationTimeChanged" }
+
+    TestCase {
+        name: "MapPositionIndicator"
+        when: windowShown && map.mapReady
+
+        function colorAt(lat, lon) {
+            var image = grabImage(map)
+            var p = map.fromCoordinate(QtPositioning.coordinate(lat, lon), false)
+            return image.pixel(Math.round(p.x), Math.round(p.y))
+        }
+
+        function verifyShown(lat, lon, shown) {
+            tryVerify(function() { return Qt.colorEqual(colorAt(lat, lon), shown ? "red" : "white") },
+                      5000, (shown ? "shown at " : "hidden at ") + lat + ", " + lon)
+        }
+
+        function cleanup() {
+            indicator.clearFixes()
+            indicator.radius = 16
+            indicator.interpolationDelay = 0
+            indicator.extrapolationTime = 2000
+            colorSpy.clear()
+            radiusSpy.clear()
+            delaySpy.clear()
+            extrapolationSpy.clear()
+        }
+
+        function test_properties() {
+            compare(indicator.positionSource, null)
+            compare(indicator.radius, 16)
+            compare(indicator.interpolationDelay, 0)
+            compare(indicator.extrapolationTime, 2000)
+
+            indicator.color = "blue"
+            compare(colorSpy.count, 1)
+            indicator.color = "blue"
+            compare(colorSpy.count, 1)
+            indicator.color = "red"
+            compare(colorSpy.count, 2)
+
+            indicator.radius = 24
+            compare(radiusSpy.count, 1)
+            indicator.radius = 24
+            compare(radiusSpy.count, 1)
+
+            indicator.interpolationDelay = 500
+            compare(delaySpy.count, 1)
+
+            indicator.extrapolationTime = -10
+            compare(indicator.extrapolationTime, 0)
+            compare(extrapolationSpy.count, 1)
+        }
+
+        // No fix, no indicator: a fix shows it, clearFixes() hides it again
+        function test_fixes() {
+            verifyShown(0, 0, false)
+            indicator.addFix(QtPositioning.coordinate(0, 0))
+            verifyShown(0, 0, true)
+            indicator.clearFixes()
+            verifyShown(0, 0, false)
+
+            // with a heading, and invalid coordinates ignored
+            indicator.addFix(QtPositioning.coordinate(2, 3), 90)
+            indicator.addFix(QtPositioning.coordinate())
+            verifyShown(2, 3, true)
+            verifyShown(0, 0, false)
+        }
+
+        // Older fixes are ignored, and the indicator neither moves
+        // nor extrapolates without a later one
+        function test_timestamps() {
+            indicator.extrapolationTime = 0
+            var now = new Date()
+            indicator.addFix(QtPositioning.coordinate(0, 0), NaN, now)
+            verifyShown(0, 0, true)
+            indicator.addFix(QtPositioning.coordinate(4, 4), NaN, new Date(now.getTime() - 1000))
+            wait(200)
+            verifyShown(0, 0, true)
+            verifyShown(4, 4, false)
+        }
+
+        // The indicator keeps its screen size, and follows the map
+        function test_mapChanges() {
+            indicator.addFix(QtPositioning.coordinate(0, 0))
+            verifyShown(0, 0, true)
+            map.zoomLevel = 6
+            verifyShown(0, 0, true)
+            map.center = QtPositioning.coordinate(1, 1)
+            verifyShown(0, 0, true)
+            map.zoomLevel = 4
+            map.center = QtPositioning.coordinate(0, 0)
+        }
+    }
+}
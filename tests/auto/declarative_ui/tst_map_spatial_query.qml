@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+Item {
+    id: masterItem
+    width: 200
+    height: 350
+
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: map
+        center: QtPositioning.coordinate(-30, 153)
+        plugin: testPlugin
+        anchors.fill: parent
+        zoomLevel: 9
+
+        MapCircle { id: near; objectName: "near"; center: QtPositioning.coordinate(-30.01, 153.01); radius: 100 }
+        MapCircle { id: middle; objectName: "middle"; center: QtPositioning.coordinate(-30.1, 153.1); radius: 100 }
+        MapCircle { id: far; objectName: "far"; center: QtPositioning.coordinate(10, 10); radius: 100 }
+        MapPolyline {
+            id: line
+            objectName: "line"
+            path: [ QtPositioning.coordinate(-31.8, 152), QtPositioning.coordinate(-31.8, 154) ]
+        }
+    }
+
+    TestCase {
+        name: "MapSpatialQuery"
+        when: windowShown && map.mapReady
+
+        function names(items) {
+            var res = []
+            for (var i = 0; i < items.length; ++i)
+                res.push(items[i].objectName)
+            return res
+        }
+
+        function test_shape() {
+            var around = QtPositioning.circle(QtPositioning.coordinate(-30, 153), 20000)
+            compare(names(map.mapItemsInShape(around)), ["near", "middle"])
+
+            var box = QtPositioning.rectangle(QtPositioning.coordinate(-29, 152), QtPositioning.coordinate(-32, 155))
+            compare(names(map.mapItemsInShape(box)), ["middle", "near", "line"])
+
+            // geometry changes are followed
+            far.center = QtPositioning.coordinate(-30.05, 153.05)
+            compare(names(map.mapItemsInShape(around)), ["near", "far", "middle"])
+            far.center = QtPositioning.coordinate(10, 10)
+
+            map.removeMapItem(middle)
+            compare(names(map.mapItemsInShape(around)), ["near"])
+            map.addMapItem(middle)
+            compare(names(map.mapItemsInShape(around)), ["near", "middle"])
+        }
+
+        function test_rect() {
+            var found = names(map.mapItemsInRect(Qt.rect(0, 0, map.width, map.height)))
+            verify(found.indexOf("near") >= 0)
+            verify(found.indexOf("far") < 0)
+            compare(map.mapItemsInRect(Qt.rect(0, 0, 1, 1)).length, 0)
+        }
+    }
+}
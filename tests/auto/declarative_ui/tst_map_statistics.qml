@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtLocation 5.15
+import QtPositioning 5.5
+
+Item {
+    id: masterItem
+    width: 200
+    height: 350
+
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: map
+        center: QtPositioning.coordinate(-30, 153)
+        plugin: testPlugin
+        anchors.fill: parent
+        zoomLevel: 9
+
+        MapCircle { id: circle; center: QtPositioning.coordinate(-30.01, 153.01); radius: 1000 }
+    }
+
+    SignalSpy { id: enabledSpy; target: map; signalName: "statisticsEnabledChanged" }
+
+    TestCase {
+        name: "MapStatistics"
+        when: windowShown && map.mapReady
+
+        function test_statistics() {
+            compare(map.statisticsEnabled, false)
+            map.statisticsEnabled = true
+            compare(enabledSpy.count, 1)
+            map.resetStatistics()
+
+            circle.radius = 2000
+            map.zoomLevel = 10
+            tryVerify(function() { return map.statistics().itemPolish.count > 0 })
+
+            var stats = map.statistics()
+            verify(stats.itemPolish.totalTime >= stats.itemPolish.maxTime)
+            verify(stats.cameraTiles !== undefined)
+            verify(stats.sceneGraph !== undefined)
+            verify(stats.cacheMisses !== undefined)
+            verify(stats.textureCacheMinimum !== undefined)
+            verify(stats.textureCacheLimit >= stats.textureCacheMinimum)
+
+            map.resetStatistics()
+            compare(map.statistics().itemPolish.count, 0)
+            // the limits are current values, not measurements
+            compare(map.statistics().textureCacheLimit, stats.textureCacheLimit)
+
+            map.statisticsEnabled = false
+            compare(enabledSpy.count, 2)
+        }
+
+        function test_memoryReport() {
+            // counted whether statistics are enabled or not
+            compare(map.statisticsEnabled, false)
+            tryVerify(function() { return map.memoryReport().itemGeometry.bytes > 0 })
+
+            var report = map.memoryReport()
+            verify(report.tileMemoryCache !== undefined)
+            verify(report.sceneTextures !== undefined)
+            verify(report.routes !== undefined)
+            verify(report.itemGeometry.peakBytes >= report.itemGeometry.bytes)
+            verify(report.total.bytes >= report.itemGeometry.bytes)
+
+            var line = Qt.createQmlObject('import QtLocation 5.15; import QtPositioning 5.5; MapPolyline { line.width: 3 }',
+                                          map)
+            var path = []
+            for (var i = 0; i < 100; ++i)
+                path.push(QtPositioning.coordinate(-30 + i * 0.001, 153 + i * 0.001))
+            line.path = path
+            map.addMapItem(line)
+            tryVerify(function() { return map.memoryReport().itemGeometry.bytes > report.itemGeometry.bytes })
+
+            var grown = map.memoryReport().itemGeometry.bytes
+            map.removeMapItem(line)
+            line.destroy()
+            tryVerify(function() { return map.memoryReport().itemGeometry.bytes < grown })
+
+            map.resetStatistics()
+            report = map.memoryReport()
+            compare(report.itemGeometry.peakBytes, report.itemGeometry.bytes)
+        }
+    }
+}
@@ -31,9 +31,12 @@
 
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtPositioning/private/qdoublevector3d_p.h>
+#include <QtPositioning/private/qdoublematrix4x4_p.h>
 
 QT_USE_NAMESPACE
 
+Q_DECLARE_METATYPE(QDoubleMatrix4x4)
+
 class tst_doubleVectors : public QObject
 {
     Q_OBJECT
@@ -50,6 +53,10 @@ private Q_SLOTS:
     void basicFunctions3dTest();
     void unaryOperator3dTest();
     void binaryOperator3dTest();
+
+    // Matrix
+    void batchMapTest_data();
+    void batchMapTest();
 };
 
 // DoubleVector2D
@@ -288,6 +295,49 @@ void tst_doubleVectors::binaryOperator3dTest()
     QCOMPARE(v6 != v7, true);
 }
 
+void tst_doubleVectors::batchMapTest_data()
+{
+    QTest::addColumn<QDoubleMatrix4x4>("matrix");
+
+    QDoubleMatrix4x4 m;
+    QTest::newRow("identity") << m;
+    m.translate(3.5, -2.0);
+    m.scale(2.0, 0.5);
+    QTest::newRow("translation and scale") << m;
+    m.rotate(30.0, 0.0, 0.0, 1.0);
+    QTest::newRow("rotation2d") << m;
+    QDoubleMatrix4x4 p;
+    p.perspective(45.0, 1.5, 0.1, 100.0);
+    p.lookAt(QDoubleVector3D(0.5, -1.0, 2.0), QDoubleVector3D(0.5, 0.5, 0.0), QDoubleVector3D(0.0, 0.0, 1.0));
+    QTest::newRow("perspective") << p;
+}
+
+void tst_doubleVectors::batchMapTest()
+{
+    QFETCH(QDoubleMatrix4x4, matrix);
+
+    // an odd count to cover the remainder after the vectorised part
+    const int count = 7;
+    double points[2 * count];
+    for (int i = 0; i < count; ++i) {
+        points[2 * i] = 0.1 * i - 0.2;
+        points[2 * i + 1] = 0.3 - 0.07 * i * i;
+    }
+    double out[2 * count];
+    matrix.map(points, out, count);
+    for (int i = 0; i < count; ++i) {
+        const QDoubleVector3D expected = matrix.map(QDoubleVector3D(points[2 * i], points[2 * i + 1], 0.0));
+        // the vectorised code may round differently
+        QVERIFY(qAbs(out[2 * i] - expected.x()) <= 1e-12 * (1.0 + qAbs(expected.x())));
+        QVERIFY(qAbs(out[2 * i + 1] - expected.y()) <= 1e-12 * (1.0 + qAbs(expected.y())));
+    }
+
+    // in place
+    matrix.map(points, points, count);
+    for (int i = 0; i < 2 * count; ++i)
+        QCOMPARE(points[i], out[i]);
+}
+
 QTEST_APPLESS_MAIN(tst_doubleVectors)
 
 #include "tst_doublevectors.moc"
@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_geofiletilecacheesri
+
+plugin.path = ../../../src/plugins/geoservices/esri/
+INCLUDEPATH += $$plugin.path
+
+HEADERS += $$plugin.path/geofiletilecache_esri.h
+SOURCES += tst_geofiletilecacheesri.cpp \
+           $$plugin.path/geofiletilecache_esri.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,291 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/geoservices/esri
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtGui/QImage>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+#include "geofiletilecache_esri.h"
+
+QT_USE_NAMESPACE
+
+class tst_GeoFileTileCacheEsri : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void bundleV1();
+    void bundleV2();
+    void bundleOffsets();
+    void fallbackToDisk();
+    void damagedBundles();
+    void manyBundles();
+
+private:
+    typedef QMap<int, QByteArray> Tiles; // by row * 128 + column inside the bundle
+
+    static QString bundlePath(const QString &root, int mapId, int zoom, int row, int column);
+    static void writeBundleV1(const QString &path, const Tiles &tiles);
+    static void writeBundleV2(const QString &path, const Tiles &tiles);
+    static QByteArray png(const QColor &color);
+    static QColor colorOf(const QSharedPointer<QGeoTileTexture> &texture);
+
+    static QGeoTileSpec spec(int mapId, int zoom, int x, int y)
+    {
+        return QGeoTileSpec(QStringLiteral("esri"), mapId, zoom, x, y);
+    }
+};
+
+QString tst_GeoFileTileCacheEsri::bundlePath(const QString &root, int mapId, int zoom, int row, int column)
+{
+    const QString directory = QStringLiteral("%1/%2/L%3").arg(root).arg(mapId).arg(zoom, 2, 10, QLatin1Char('0'));
+    QDir().mkpath(directory);
+    return QStringLiteral("%1/R%2C%3").arg(directory)
+            .arg(row, 4, 16, QLatin1Char('0')).arg(column, 4, 16, QLatin1Char('0'));
+}
+
+// A .bundle of size prefixed tiles after a 60 byte header, and a .bundlx of
+// 5 byte offsets, column major. Missing tiles point to an empty entry.
+void tst_GeoFileTileCacheEsri::writeBundleV1(const QString &path, const Tiles &tiles)
+{
+    QByteArray data(60, '\0');
+    const qint64 empty = data.size();
+    data.append(4, '\0');
+
+    QByteArray index(16 + 5 * 128 * 128, '\0');
+    for (int column = 0; column < 128; ++column) {
+        for (int row = 0; row < 128; ++row) {
+            qint64 offset = empty;
+            const QByteArray tile = tiles.value(row * 128 + column);
+            if (!tile.isEmpty()) {
+                offset = data.size();
+                uchar size[4];
+                qToLittleEndian<quint32>(tile.size(), size);
+                data.append(reinterpret_cast<const char *>(size), 4);
+                data.append(tile);
+            }
+            uchar *record = reinterpret_cast<uchar *>(index.data()) + 16 + 5 * (column * 128 + row);
+            qToLittleEndian<quint32>(quint32(offset), record);
+            record[4] = uchar(offset >> 32);
+        }
+    }
+
+    QFile bundle(path + QLatin1String(".bundle"));
+    QVERIFY(bundle.open(QIODevice::WriteOnly));
+    bundle.write(data);
+    QFile bundlx(path + QLatin1String(".bundlx"));
+    QVERIFY(bundlx.open(QIODevice::WriteOnly));
+    bundlx.write(index);
+}
+
+// A .bundle with a 64 byte header, 8 byte records of offset and size, row
+// major, and the tiles after them
+void tst_GeoFileTileCacheEsri::writeBundleV2(const QString &path, const Tiles &tiles)
+{
+    QByteArray data(64 + 8 * 128 * 128, '\0');
+    qToLittleEndian<quint32>(3, reinterpret_cast<uchar *>(data.data()));
+    for (Tiles::const_iterator it = tiles.begin(); it != tiles.end(); ++it) {
+        const quint64 record = quint64(data.size()) | (quint64(it.value().size()) << 40);
+        qToLittleEndian<quint64>(record, reinterpret_cast<uchar *>(data.data()) + 64 + 8 * it.key());
+        data.append(it.value());
+    }
+
+    QFile bundle(path + QLatin1String(".bundle"));
+    QVERIFY(bundle.open(QIODevice::WriteOnly));
+    bundle.write(data);
+}
+
+QByteArray tst_GeoFileTileCacheEsri::png(const QColor &color)
+{
+    QImage image(8, 8, QImage::Format_RGB32);
+    image.fill(color);
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "png");
+    return bytes;
+}
+
+QColor tst_GeoFileTileCacheEsri::colorOf(const QSharedPointer<QGeoTileTexture> &texture)
+{
+    if (!texture || texture->image.isNull())
+        return QColor();
+    return QColor(texture->image.pixel(0, 0));
+}
+
+void tst_GeoFileTileCacheEsri::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    qRegisterMetaType<QGeoTileSpec>();
+}
+
+void tst_GeoFileTileCacheEsri::bundleV1()
+{
+    QTemporaryDir offline, cacheDir;
+    Tiles tiles;
+    tiles.insert(5 * 128 + 3, png(Qt::red));
+    tiles.insert(3 * 128 + 5, png(Qt::blue));
+    writeBundleV1(bundlePath(offline.path(), 1, 3, 0, 0), tiles);
+
+    GeoFileTileCacheEsri cache(offline.path(), cacheDir.path());
+    cache.init();
+    // x is the column and y the row
+    QCOMPARE(colorOf(cache.get(spec(1, 3, 3, 5))), QColor(Qt::red));
+    QCOMPARE(colorOf(cache.get(spec(1, 3, 5, 3))), QColor(Qt::blue));
+    QVERIFY(!cache.get(spec(1, 3, 4, 4)));
+    // another map or level has bundles of its own
+    QVERIFY(!cache.get(spec(2, 3, 3, 5)));
+    QVERIFY(!cache.get(spec(1, 4, 3, 5)));
+}
+
+void tst_GeoFileTileCacheEsri::bundleV2()
+{
+    QTemporaryDir offline, cacheDir;
+    Tiles tiles;
+    tiles.insert(5 * 128 + 3, png(Qt::green));
+    tiles.insert(127 * 128 + 127, png(Qt::yellow));
+    writeBundleV2(bundlePath(offline.path(), 2, 7, 0, 0), tiles);
+
+    GeoFileTileCacheEsri cache(offline.path(), cacheDir.path());
+    cache.init();
+    QCOMPARE(colorOf(cache.get(spec(2, 7, 3, 5))), QColor(Qt::green));
+    QCOMPARE(colorOf(cache.get(spec(2, 7, 127, 127))), QColor(Qt::yellow));
+    QVERIFY(!cache.get(spec(2, 7, 5, 3)));
+    QVERIFY(!cache.get(spec(1, 7, 3, 5)));
+}
+
+// Bundles are named after the row and column of their first tile, in hex
+void tst_GeoFileTileCacheEsri::bundleOffsets()
+{
+    QTemporaryDir offline, cacheDir;
+    Tiles v1, v2;
+    v1.insert(1 * 128 + 2, png(Qt::red));
+    v2.insert(3 * 128 + 4, png(Qt::blue));
+    writeBundleV1(bundlePath(offline.path(), 1, 10, 0, 0x80), v1);
+    writeBundleV2(bundlePath(offline.path(), 1, 10, 0x180, 0), v2);
+
+    GeoFileTileCacheEsri cache(offline.path(), cacheDir.path());
+    cache.init();
+    QCOMPARE(colorOf(cache.get(spec(1, 10, 128 + 2, 1))), QColor(Qt::red));
+    QCOMPARE(colorOf(cache.get(spec(1, 10, 4, 384 + 3))), QColor(Qt::blue));
+    QVERIFY(!cache.get(spec(1, 10, 2, 1)));
+    QVERIFY(!cache.get(spec(1, 10, 4, 3)));
+}
+
+// Tiles missing from the bundles come from the disk cache
+void tst_GeoFileTileCacheEsri::fallbackToDisk()
+{
+    QTemporaryDir offline, cacheDir;
+    Tiles tiles;
+    tiles.insert(0, png(Qt::red));
+    writeBundleV2(bundlePath(offline.path(), 1, 2, 0, 0), tiles);
+
+    {
+        GeoFileTileCacheEsri cache(offline.path(), cacheDir.path());
+        cache.init();
+        cache.insert(spec(1, 2, 1, 0), png(Qt::cyan), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    }
+
+    GeoFileTileCacheEsri cache(offline.path(), cacheDir.path());
+    cache.init();
+    QCOMPARE(colorOf(cache.get(spec(1, 2, 0, 0))), QColor(Qt::red));
+    QCOMPARE(colorOf(cache.get(spec(1, 2, 1, 0))), QColor(Qt::cyan));
+
+    // without offline data, only the disk cache is there
+    GeoFileTileCacheEsri online(QString(), cacheDir.path());
+    online.init();
+    QVERIFY(!online.get(spec(1, 2, 0, 0)));
+    QCOMPARE(colorOf(online.get(spec(1, 2, 1, 0))), QColor(Qt::cyan));
+}
+
+void tst_GeoFileTileCacheEsri::damagedBundles()
+{
+    QTemporaryDir offline, cacheDir;
+
+    // a version 2 bundle cut short in its index
+    QFile truncated(bundlePath(offline.path(), 1, 1, 0, 0) + QLatin1String(".bundle"));
+    QVERIFY(truncated.open(QIODevice::WriteOnly));
+    QByteArray header(64 + 8 * 16, '\0');
+    qToLittleEndian<quint32>(3, reinterpret_cast<uchar *>(header.data()));
+    truncated.write(header);
+    truncated.close();
+
+    // a record running past the end of its bundle
+    writeBundleV2(bundlePath(offline.path(), 1, 2, 0, 0), Tiles());
+    QFile beyond(bundlePath(offline.path(), 1, 2, 0, 0) + QLatin1String(".bundle"));
+    QVERIFY(beyond.open(QIODevice::ReadWrite));
+    uchar record[8];
+    qToLittleEndian<quint64>(quint64(beyond.size()) | (quint64(100) << 40), record);
+    beyond.seek(64);
+    beyond.write(reinterpret_cast<const char *>(record), 8);
+    beyond.close();
+
+    // a tile that is not an image
+    Tiles garbage;
+    garbage.insert(0, QByteArray("not an image"));
+    writeBundleV1(bundlePath(offline.path(), 1, 3, 0, 0), garbage);
+
+    GeoFileTileCacheEsri cache(offline.path(), cacheDir.path());
+    cache.init();
+    QVERIFY(!cache.get(spec(1, 1, 0, 0)));
+    QVERIFY(!cache.get(spec(1, 2, 0, 0)));
+    QVERIFY(!cache.get(spec(1, 3, 0, 0)));
+}
+
+// More bundles than are kept open at once
+void tst_GeoFileTileCacheEsri::manyBundles()
+{
+    QTemporaryDir offline, cacheDir;
+    const int count = 80;
+    for (int i = 0; i < count; ++i) {
+        Tiles tiles;
+        tiles.insert(0, png(QColor(i, 255 - i, 0)));
+        writeBundleV2(bundlePath(offline.path(), 1, 14, 0, i * 128), tiles);
+    }
+
+    GeoFileTileCacheEsri cache(offline.path(), cacheDir.path());
+    cache.init();
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < count; ++i) {
+            // emptied each time, so that the tile is read from its bundle again
+            cache.clearAll();
+            QCOMPARE(colorOf(cache.get(spec(1, 14, i * 128, 0))), QColor(i, 255 - i, 0));
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_GeoFileTileCacheEsri)
+
+#include "tst_geofiletilecacheesri.moc"
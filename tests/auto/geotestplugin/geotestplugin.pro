@@ -1,5 +1,5 @@
 TARGET = qtgeoservices_qmltestplugin
-QT += location-private positioning-private testlib
+QT += location-private positioning-private positioningquick-private testlib
 
 PLUGIN_TYPE = geoservices
 PLUGIN_CLASS_NAME = TestGeoServicePlugin
@@ -12,7 +12,8 @@ HEADERS += qgeocodingmanagerengine_test.h \
            qplacemanagerengine_test.h \
            qgeotiledmappingmanagerengine_test.h \
            qgeotiledmap_test.h \
-           qgeotilefetcher_test.h
+           qgeotilefetcher_test.h \
+           qnavigationmanagerengine_test.h
 
 SOURCES += qgeoserviceproviderplugin_test.cpp \
            qgeotiledmap_test.cpp
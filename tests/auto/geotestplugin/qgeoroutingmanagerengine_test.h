@@ -39,6 +39,7 @@
 #include <QDebug>
 #include <QTimer>
 #include <QTimerEvent>
+#include <QHash>
 
 QT_USE_NAMESPACE
 
@@ -79,26 +80,24 @@ public:
     void  callSetError ( Error error, const QString & errorString ) {setError(error, errorString);}
     void  callSetFinished ( bool finished ) {setFinished(finished);}
     void  callSetRoutes(const QList<QGeoRoute> &routes) {setRoutes(routes);}
+
+    // Set when the reply finishes
+    Error pendingError = NoError;
+    QString pendingErrorString;
 };
 
 class QGeoRoutingManagerEngineTest: public QGeoRoutingManagerEngine
 {
     Q_OBJECT
-    RouteReplyTest* routeReply_;
     bool finishRequestImmediately_;
-    int timerId_;
-    QGeoRouteReply::Error errorCode_;
-    QString errorString_;
+    QHash<int, RouteReplyTest *> pendingReplies_; // by timer
     bool alternateGeoRouteImplementation_;
 
 public:
     QGeoRoutingManagerEngineTest(const QVariantMap &parameters,
         QGeoServiceProvider::Error *error, QString *errorString) :
         QGeoRoutingManagerEngine(parameters),
-        routeReply_(0),
         finishRequestImmediately_(true),
-        timerId_(0),
-        errorCode_(QGeoRouteReply::NoError),
         alternateGeoRouteImplementation_(false)
     {
         Q_UNUSED(error);
@@ -138,30 +137,26 @@ public:
 
     virtual QGeoRouteReply* calculateRoute(const QGeoRouteRequest& request)
     {
-        routeReply_ = new RouteReplyTest();
-        connect(routeReply_, SIGNAL(aborted()), this, SLOT(requestAborted()));
+        RouteReplyTest *routeReply = new RouteReplyTest();
+        connect(routeReply, SIGNAL(aborted()), this, SLOT(requestAborted()));
 
         if (request.numberAlternativeRoutes() > 70) {
-            errorCode_ = (QGeoRouteReply::Error)(request.numberAlternativeRoutes() - 70);
-            errorString_ = "error";
-        } else {
-            errorCode_ = QGeoRouteReply::NoError;
-            errorString_ = "";
+            routeReply->pendingError = (QGeoRouteReply::Error)(request.numberAlternativeRoutes() - 70);
+            routeReply->pendingErrorString = "error";
         }
-        setRoutes(request, routeReply_);
+        setRoutes(request, routeReply);
         if (finishRequestImmediately_) {
-            if (errorCode_) {
-                routeReply_->callSetError(errorCode_, errorString_);
+            if (routeReply->pendingError) {
+                routeReply->callSetError(routeReply->pendingError, routeReply->pendingErrorString);
             } else {
-                routeReply_->callSetError(QGeoRouteReply::NoError, "no error");
-                routeReply_->callSetFinished(true);
+                routeReply->callSetError(QGeoRouteReply::NoError, "no error");
+                routeReply->callSetFinished(true);
             }
         } else {
-            // we only allow serialized requests in QML - previous must have been aborted or finished
-            Q_ASSERT(timerId_ == 0);
-            timerId_ = startTimer(200);
+            // the requests of the models sharing this engine may overlap
+            pendingReplies_.insert(startTimer(200), routeReply);
         }
-        return static_cast<QGeoRouteReply*>(routeReply_);
+        return static_cast<QGeoRouteReply*>(routeReply);
     }
 
     void setRoutes(const QGeoRouteRequest& request, RouteReplyTest* reply)
@@ -187,11 +182,11 @@ public:
                 }
             }
 
-            if (request.departureTime().isValid()) {
-                QVariantMap extendedAttributes = route.extendedAttributes();
+            QVariantMap extendedAttributes = route.extendedAttributes();
+            if (request.departureTime().isValid())
                 extendedAttributes["tst_departureTime"] = request.departureTime();
-                route.setExtendedAttributes(extendedAttributes);
-            }
+            extendedAttributes["tst_measurementSystem"] = int(measurementSystem());
+            route.setExtendedAttributes(extendedAttributes);
 
             routes.append(route);
         }
@@ -201,29 +196,26 @@ public:
 public Q_SLOTS:
     void requestAborted()
     {
-        if (timerId_) {
-            killTimer(timerId_);
-            timerId_ = 0;
+        const int timerId = pendingReplies_.key(static_cast<RouteReplyTest *>(sender()));
+        if (timerId) {
+            killTimer(timerId);
+            pendingReplies_.remove(timerId);
         }
-        errorCode_ = QGeoRouteReply::NoError;
-        errorString_ = "";
     }
 
 protected:
      void timerEvent(QTimerEvent *event)
      {
-         Q_UNUSED(event);
-         Q_ASSERT(timerId_ == event->timerId());
-         Q_ASSERT(routeReply_);
-         killTimer(timerId_);
-         timerId_ = 0;
-         if (errorCode_) {
-             routeReply_->callSetError(errorCode_, errorString_);
-             emit error(routeReply_, errorCode_, errorString_);
+         RouteReplyTest *routeReply = pendingReplies_.take(event->timerId());
+         Q_ASSERT(routeReply);
+         killTimer(event->timerId());
+         if (routeReply->pendingError) {
+             routeReply->callSetError(routeReply->pendingError, routeReply->pendingErrorString);
+             emit error(routeReply, routeReply->pendingError, routeReply->pendingErrorString);
          } else {
-             routeReply_->callSetError(QGeoRouteReply::NoError, "no error");
-             routeReply_->callSetFinished(true);
-             emit finished(routeReply_);
+             routeReply->callSetError(QGeoRouteReply::NoError, "no error");
+             routeReply->callSetFinished(true);
+             emit finished(routeReply);
          }
      }
 };
@@ -31,6 +31,7 @@
 #include "qgeoroutingmanagerengine_test.h"
 #include "qgeotiledmappingmanagerengine_test.h"
 #include "qplacemanagerengine_test.h"
+#include "qnavigationmanagerengine_test.h"
 
 #include <QtPlugin>
 
@@ -91,3 +92,12 @@ QPlaceManagerEngine* QGeoServiceProviderFactoryTest::createPlaceManagerEngine(
     Q_UNUSED(errorString);
     return new QPlaceManagerEngineTest(parameters);
 }
+
+QNavigationManagerEngine* QGeoServiceProviderFactoryTest::createNavigationManagerEngine(
+        const QVariantMap &parameters,
+        QGeoServiceProvider::Error *error, QString *errorString) const
+{
+    Q_UNUSED(error);
+    Q_UNUSED(errorString);
+    return new QNavigationManagerEngineTest(parameters);
+}
@@ -57,6 +57,9 @@ public:
     QPlaceManagerEngine* createPlaceManagerEngine(
                 const QVariantMap &parameters,
                 QGeoServiceProvider::Error *error, QString *errorString) const;
+    QNavigationManagerEngine* createNavigationManagerEngine(
+                const QVariantMap &parameters,
+                QGeoServiceProvider::Error *error, QString *errorString) const;
 };
 
 #endif
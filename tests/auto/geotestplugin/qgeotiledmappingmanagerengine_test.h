@@ -92,6 +92,10 @@ public:
         QGeoTileFetcherTest *fetcher = new QGeoTileFetcherTest(this);
         if (parameters.contains(QStringLiteral("finishRequestImmediately")))
             fetcher->setFinishRequestImmediately(parameters.value(QStringLiteral("finishRequestImmediately")).toBool());
+        if (parameters.contains(QStringLiteral("manualReplies")))
+            fetcher->setManualReplies(parameters.value(QStringLiteral("manualReplies")).toBool());
+        if (parameters.contains(QStringLiteral("tileLatency")))
+            fetcher->setTileLatency(parameters.value(QStringLiteral("tileLatency")).toInt());
         if (parameters.contains(QStringLiteral("tileSize"))) {
             int tileSize = parameters.value(QStringLiteral("tileSize")).toInt();
             setTileSize(QSize(tileSize, tileSize));
@@ -79,6 +79,7 @@ public:
     QGeoTiledMapReply* getTileImage(const QGeoTileSpec &spec)
     {
         TiledMapReplyTest* mappingReply =  new TiledMapReplyTest(spec, this);
+        requested_.append(spec);
 
         QImage im(256, 256, QImage::Format_RGB888);
         im.fill(QColor("lightgray"));
@@ -110,9 +111,21 @@ public:
         mappingReply->callSetMapImageData(bytes);
         mappingReply->callSetMapImageFormat("png");
 
-        if (finishRequestImmediately_) {
+        if (manualReplies_) {
+            // Left to finishReply()
+            pending_.append(mappingReply);
+            connect(mappingReply, &TiledMapReplyTest::aborted, this, [this, mappingReply]() {
+                pending_.removeOne(mappingReply);
+                aborted_.append(mappingReply->tileSpec());
+            });
+        } else if (finishRequestImmediately_) {
             updateRequest(mappingReply);
             return mappingReply;
+        } else if (tileLatency_ >= 0) {
+            // Each reply on its own, as from a server answering requests in parallel
+            QTimer::singleShot(tileLatency_, mappingReply, [this, mappingReply]() {
+                updateRequest(mappingReply);
+            });
         } else {
             if (m_queue.isEmpty())
                 timer_.start(500, this);
@@ -132,6 +145,44 @@ public:
         tileSize_ = tileSize;
     }
 
+    void setTileLatency(int msecs)
+    {
+        tileLatency_ = msecs;
+    }
+
+    void setManualReplies(bool enabled)
+    {
+        manualReplies_ = enabled;
+    }
+
+    // The tiles requested and aborted, in order, and the replies in flight with manual replies
+    const QList<QGeoTileSpec> &requestedTiles() const { return requested_; }
+    const QList<QGeoTileSpec> &abortedTiles() const { return aborted_; }
+    QList<QGeoTileSpec> pendingTiles() const
+    {
+        QList<QGeoTileSpec> tiles;
+        for (const TiledMapReplyTest *reply : pending_)
+            tiles.append(reply->tileSpec());
+        return tiles;
+    }
+    void clearRequestedTiles()
+    {
+        requested_.clear();
+        aborted_.clear();
+    }
+
+    bool finishReply(const QGeoTileSpec &spec)
+    {
+        for (TiledMapReplyTest *reply : qAsConst(pending_)) {
+            if (reply->tileSpec() == spec) {
+                pending_.removeOne(reply);
+                updateRequest(reply);
+                return true;
+            }
+        }
+        return false;
+    }
+
 public Q_SLOTS:
     void requestAborted()
     {
@@ -173,7 +224,12 @@ private:
     QGeoTiledMapReply::Error errorCode_;
     QString errorString_;
     QSize tileSize_;
+    int tileLatency_ = -1; // replies are finished one after the other when negative
     QList<TiledMapReplyTest*> m_queue;
+    bool manualReplies_ = false;
+    QList<TiledMapReplyTest *> pending_;
+    QList<QGeoTileSpec> requested_;
+    QList<QGeoTileSpec> aborted_;
 };
 
 #endif
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QNAVIGATIONMANAGERENGINE_TEST_H
+#define QNAVIGATIONMANAGERENGINE_TEST_H
+
+#include <QtLocation/private/qnavigationmanagerengine_p.h>
+#include <QtLocation/private/qdeclarativenavigator_p_p.h>
+#include <QtLocation/private/qgeoroutetracker_p.h>
+#include <QtPositioningQuick/private/qdeclarativeposition_p.h>
+#include <QtPositioningQuick/private/qdeclarativepositionsource_p.h>
+
+QT_USE_NAMESPACE
+
+// Follows the position source along the route with a QGeoRouteTracker
+class NavigatorTest : public QAbstractNavigator
+{
+    Q_OBJECT
+public:
+    NavigatorTest(const QSharedPointer<QDeclarativeNavigatorParams> &params)
+        : m_params(params), m_trackPosition(params->m_trackPositionSource),
+          m_autoRerouting(params->m_autoRerouting)
+    {
+    }
+
+    bool active() const override { return m_active; }
+    bool ready() const override { return !m_params->m_geoRoute.path().isEmpty(); }
+
+    double distanceToNextManeuver() const override { return m_tracker.distanceToNextManeuver(); }
+    int timeToNextManeuver() const override { return m_tracker.timeToNextManeuver(); }
+    int remainingTravelTime() const override { return m_tracker.remainingTravelTime(); }
+    double remainingTravelDistance() const override { return m_tracker.remainingTravelDistance(); }
+    int remainingTravelTimeToNextWaypoint() const override { return m_tracker.remainingTravelTimeToNextWaypoint(); }
+    double remainingTravelDistanceToNextWaypoint() const override { return m_tracker.remainingTravelDistanceToNextWaypoint(); }
+    double traveledDistance() const override { return m_tracker.traveledDistance(); }
+    int traveledTime() const override { return m_tracker.traveledTime(); }
+    QGeoRoute currentRoute() const override { return m_tracker.route(); }
+    int currentSegment() const override { return m_tracker.currentSegment(); }
+    QList<QGeoRoute> alternativeRoutes() const override { return QList<QGeoRoute>(); }
+
+    void setAutomaticReroutingEnabled(bool autoRerouting) override { m_autoRerouting = autoRerouting; }
+    bool automaticReroutingEnabled() const override { return m_autoRerouting; }
+    bool isOnRoute() override { return m_tracker.isOnRoute(); }
+    void recalculateRoutes() override {}
+
+public Q_SLOTS:
+    bool start() override
+    {
+        if (m_active || !ready())
+            return m_active;
+        m_tracker.setRoute(m_params->m_geoRoute);
+        if (m_params->m_positionSource) {
+            connect(m_params->m_positionSource, &QDeclarativePositionSource::positionChanged,
+                    this, &NavigatorTest::updatePosition);
+        }
+        m_active = true;
+        emit activeChanged(true);
+        emit currentRouteChanged();
+        return true;
+    }
+
+    bool stop() override
+    {
+        if (m_params->m_positionSource)
+            m_params->m_positionSource->disconnect(this);
+        if (m_active) {
+            m_active = false;
+            emit activeChanged(false);
+        }
+        return false;
+    }
+
+    void setTrackPosition(bool trackPosition) override
+    {
+        m_trackPosition = trackPosition;
+    }
+
+private:
+    void updatePosition()
+    {
+        if (!m_trackPosition || !m_params->m_positionSource)
+            return;
+        const int segment = m_tracker.currentSegment();
+        const bool onRoute = m_tracker.isOnRoute();
+        m_tracker.update(m_params->m_positionSource->position()->position().coordinate());
+        emit progressInformationChanged();
+        if (m_tracker.currentSegment() != segment)
+            emit currentSegmentChanged();
+        if (m_tracker.isOnRoute() != onRoute)
+            emit isOnRouteChanged();
+    }
+
+    QSharedPointer<QDeclarativeNavigatorParams> m_params;
+    QGeoRouteTracker m_tracker;
+    bool m_active = false;
+    bool m_trackPosition;
+    bool m_autoRerouting;
+};
+
+class QNavigationManagerEngineTest : public QNavigationManagerEngine
+{
+    Q_OBJECT
+public:
+    QNavigationManagerEngineTest(const QVariantMap &parameters)
+        : QNavigationManagerEngine(parameters)
+    {
+        engineInitialized();
+    }
+
+    QAbstractNavigator *createNavigator(const QSharedPointer<QDeclarativeNavigatorParams> &navigator) override
+    {
+        return new NavigatorTest(navigator);
+    }
+};
+
+#endif
@@ -44,6 +44,8 @@
 #include <QtLocation/QPlaceDetailsReply>
 #include <QtLocation/QPlaceEditorial>
 #include <QtLocation/QPlaceIdReply>
+#include <QtLocation/QPlaceMatchReply>
+#include <QtLocation/QPlaceMatchRequest>
 #include <QtLocation/QPlaceImage>
 #include <QtLocation/QPlaceSearchSuggestionReply>
 #include <QtLocation/QPlaceSearchReply>
@@ -52,6 +54,7 @@
 #include <QtLocation/QPlace>
 #include <QtLocation/QPlaceReview>
 #include <QtLocation/private/qplace_p.h>
+#include <QtLocation/private/qplacesearchrequest_p.h>
 #include <QtTest/QTest>
 
 QT_BEGIN_NAMESPACE
@@ -183,6 +186,8 @@ class PlaceSearchReply : public QPlaceSearchReply
 {
     Q_OBJECT
 
+    friend class QPlaceManagerEngineTest;
+
 public:
     PlaceSearchReply(const QList<QPlaceSearchResult> &results, QObject *parent = 0)
     :   QPlaceSearchReply(parent)
@@ -201,6 +206,23 @@ public:
     }
 };
 
+class MatchReply : public QPlaceMatchReply
+{
+    Q_OBJECT
+
+public:
+    MatchReply(const QList<QPlace> &places, QObject *parent = 0)
+    :   QPlaceMatchReply(parent)
+    {
+        setPlaces(places);
+    }
+
+    Q_INVOKABLE void emitFinished()
+    {
+        emit finished();
+    }
+};
+
 class SuggestionReply : public QPlaceSearchSuggestionReply
 {
     Q_OBJECT
@@ -231,6 +253,7 @@ public:
         : QPlaceManagerEngine(parameters)
     {
         m_locales << QLocale();
+        m_searchRepeat = qMax(1, parameters.value(QStringLiteral("repeatSearchResults"), 1).toInt());
         if (parameters.value(QStringLiteral("initializePlaceData"), false).toBool()) {
             QFile placeData(QFINDTESTDATA("place_data.json"));
             QVERIFY(placeData.exists());
@@ -382,7 +405,9 @@ public:
             reply->setError(QPlaceReply::PlaceDoesNotExistError, tr("Place does not exist"));
             QMetaObject::invokeMethod(reply, "emitError", Qt::QueuedConnection);
         } else {
-            reply->setPlace(m_places.value(placeId));
+            QPlace place = m_places.value(placeId);
+            place.setDetailsFetched(true);
+            reply->setPlace(place);
         }
 
         QMetaObject::invokeMethod(reply, "emitFinished", Qt::QueuedConnection);
@@ -499,7 +524,48 @@ public:
             }
         }
 
-        PlaceSearchReply *reply = new PlaceSearchReply(results, this);
+        // the same places again, so that a place can be in several pages
+        const QList<QPlaceSearchResult> once = results;
+        for (int i = 1; i < m_searchRepeat; ++i)
+            results.append(once);
+
+        // pages of limit results, counted by the request
+        const int page = QPlaceSearchRequestPrivate::get(query)->page;
+        const int offset = query.limit() > 0 ? qMin(page * query.limit(), results.count()) : 0;
+        const int end = query.limit() > 0 ? qMin(offset + query.limit(), results.count()) : results.count();
+
+        PlaceSearchReply *reply = new PlaceSearchReply(results.mid(offset, end - offset), this);
+        reply->setRequest(query);
+        if (page > 0) {
+            QPlaceSearchRequest previous = query;
+            QPlaceSearchRequestPrivate::get(previous)->related = true;
+            QPlaceSearchRequestPrivate::get(previous)->page = page - 1;
+            reply->setPreviousPageRequest(previous);
+        }
+        if (end < results.count()) {
+            QPlaceSearchRequest next = query;
+            QPlaceSearchRequestPrivate::get(next)->related = true;
+            QPlaceSearchRequestPrivate::get(next)->page = page + 1;
+            reply->setNextPageRequest(next);
+        }
+
+        QMetaObject::invokeMethod(reply, "emitFinished", Qt::QueuedConnection);
+
+        return reply;
+    }
+
+    // Favorites are the places of this manager with the ids of the results
+    QPlaceMatchReply *matchingPlaces(const QPlaceMatchRequest &request) override
+    {
+        QList<QPlace> places;
+        for (const QPlaceSearchResult &result : request.results()) {
+            if (result.type() == QPlaceSearchResult::PlaceResult)
+                places.append(m_places.value(QPlaceResult(result).place().placeId()));
+            else
+                places.append(QPlace());
+        }
+
+        MatchReply *reply = new MatchReply(places, this);
 
         QMetaObject::invokeMethod(reply, "emitFinished", Qt::QueuedConnection);
 
@@ -722,6 +788,7 @@ private:
     QHash<QString, QList<QPlaceReview> > m_placeReviews;
     QHash<QString, QList<QPlaceImage> > m_placeImages;
     QHash<QString, QList<QPlaceEditorial> > m_placeEditorials;
+    int m_searchRepeat;
 };
 
 #endif
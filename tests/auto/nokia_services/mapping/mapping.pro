@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_nokia_mapping
+
+QT += network location-private positioning-private testlib
+INCLUDEPATH += $$PWD/../../../../src/plugins/geoservices/nokia
+
+HEADERS += $$PWD/../../../../src/plugins/geoservices/nokia/qgeonetworkaccessmanager.h
+SOURCES += tst_mapping.cpp
@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qgeonetworkaccessmanager.h>
+
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+
+QT_USE_NAMESPACE
+
+// Copyrights for the whole world, and for Oslo from zoom level 10
+static const char copyrightsJson[] =
+        "{\"normal\": ["
+        "{\"minLevel\": 0, \"maxLevel\": 20, \"label\": \"World\", \"alt\": \"\"},"
+        "{\"minLevel\": 10, \"maxLevel\": 20, \"label\": \"Oslo and Akershus county\", \"alt\": \"\","
+        " \"boxes\": [[60.5, 10.0, 59.5, 11.5]]}"
+        "]}";
+
+class MockGeoNetworkReply : public QNetworkReply
+{
+public:
+    explicit MockGeoNetworkReply(const QByteArray &data, bool finished, QObject *parent = 0)
+        : QNetworkReply(parent), m_data(data)
+    {
+        setOpenMode(QIODevice::ReadOnly);
+        setFinished(finished);
+    }
+
+    void abort() override {}
+    qint64 bytesAvailable() const override { return m_data.size() + QNetworkReply::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override
+    {
+        const qint64 size = qMin<qint64>(maxlen, m_data.size());
+        if (size == 0)
+            return -1;
+        memcpy(data, m_data.constData(), size);
+        m_data.remove(0, size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray m_data;
+};
+
+// Answers the copyright and version requests, and the tile requests once given a tile
+class MockGeoNetworkAccessManager : public QGeoNetworkAccessManager
+{
+public:
+    explicit MockGeoNetworkAccessManager(QObject *parent = 0)
+        : QGeoNetworkAccessManager(parent) {}
+
+    QNetworkReply *get(const QNetworkRequest &request) override
+    {
+        const QString path = request.url().path();
+        if (path.contains(QLatin1String("/copyright/"))) {
+            ++copyrightRequests;
+            return new MockGeoNetworkReply(copyrights, true);
+        }
+        if (path.endsWith(QLatin1String("/version"))) {
+            ++versionRequests;
+            return new MockGeoNetworkReply(version, true);
+        }
+        if (!tile.isEmpty()) {
+            ++tileRequests;
+            // the tile replies of the plugin wait for finished()
+            QNetworkReply *reply = new MockGeoNetworkReply(tile, true);
+            QMetaObject::invokeMethod(reply, "finished", Qt::QueuedConnection);
+            return reply;
+        }
+        return new MockGeoNetworkReply(QByteArray(), false);
+    }
+
+    QNetworkReply *post(const QNetworkRequest &, const QByteArray &) override
+    {
+        return new MockGeoNetworkReply(QByteArray(), false);
+    }
+
+    QByteArray copyrights = copyrightsJson;
+    QByteArray version;
+    QByteArray tile;
+    int copyrightRequests = 0;
+    int versionRequests = 0;
+    int tileRequests = 0;
+};
+
+class tst_nokia_mapping : public QObject
+{
+    Q_OBJECT
+
+private:
+    QGeoServiceProvider *createProvider();
+    QGeoMap *createMap(QGeoServiceProvider *provider);
+    static QGeoCameraData camera(const QGeoCoordinate &center, double zoomLevel);
+    void saveMapVersion(int version, const QString &info);
+    QStringList tileFiles(int version) const;
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void copyrights();
+    void mapVersion();
+
+private:
+    QScopedPointer<QTemporaryDir> m_cacheDirectory;
+    MockGeoNetworkAccessManager *m_networkManager = nullptr;
+};
+
+QGeoServiceProvider *tst_nokia_mapping::createProvider()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("nam"), QVariant::fromValue<void *>(m_networkManager));
+    parameters.insert(QStringLiteral("here.app_id"), "stub");
+    parameters.insert(QStringLiteral("here.token"), "stub");
+    parameters.insert(QStringLiteral("here.mapping.cache.directory"), m_cacheDirectory->path());
+    return new QGeoServiceProvider(QStringLiteral("here"), parameters);
+}
+
+QGeoMap *tst_nokia_mapping::createMap(QGeoServiceProvider *provider)
+{
+    QGeoMappingManager *mappingManager = provider->mappingManager();
+    if (!mappingManager)
+        return nullptr;
+    QGeoMap *map = mappingManager->createMap(this);
+    map->setViewportSize(QSize(256, 256));
+    map->setActiveMapType(mappingManager->supportedMapTypes().first());
+    map->setCopyrightVisible(true);
+    return map;
+}
+
+QGeoCameraData tst_nokia_mapping::camera(const QGeoCoordinate &center, double zoomLevel)
+{
+    QGeoCameraData camera;
+    camera.setCenter(center);
+    camera.setZoomLevel(zoomLevel);
+    return camera;
+}
+
+// What an earlier run left in the cache directory
+void tst_nokia_mapping::saveMapVersion(int version, const QString &info)
+{
+    QJsonObject data;
+    data[QStringLiteral("info")] = info;
+    QJsonObject object;
+    object[QStringLiteral("version")] = version;
+    object[QStringLiteral("data")] = data;
+    QFile file(QDir(m_cacheDirectory->path()).filePath(QStringLiteral("here_version")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(object).toJson());
+}
+
+// The tiles in the cache directory with the given version, -1 for tiles stored without one
+QStringList tst_nokia_mapping::tileFiles(int version) const
+{
+    QStringList files;
+    const QStringList pngs = QDir(m_cacheDirectory->path()).entryList(QStringList() << QStringLiteral("*.png"), QDir::Files);
+    for (const QString &file : pngs) {
+        const QStringList fields = file.section(QLatin1Char('.'), 0, 0).split(QLatin1Char('-'));
+        const int fileVersion = fields.size() == 7 ? fields.at(5).toInt() : -1;
+        if (fileVersion == version)
+            files.append(file);
+    }
+    return files;
+}
+
+void tst_nokia_mapping::init()
+{
+    m_cacheDirectory.reset(new QTemporaryDir);
+    QVERIFY(m_cacheDirectory->isValid());
+    // deleted by the plugin
+    m_networkManager = new MockGeoNetworkAccessManager;
+}
+
+void tst_nokia_mapping::cleanup()
+{
+    m_networkManager = nullptr;
+    m_cacheDirectory.reset();
+}
+
+void tst_nokia_mapping::copyrights()
+{
+    QScopedPointer<QGeoServiceProvider> provider(createProvider());
+    QScopedPointer<QGeoMap> map(createMap(provider.data()));
+    QVERIFY(map);
+    QTRY_COMPARE(m_networkManager->copyrightRequests, 1);
+    QTest::qWait(10); // for the descriptors to be loaded
+
+    QSignalSpy spy(map.data(), SIGNAL(copyrightsChanged(QImage)));
+    map->setCameraData(camera(QGeoCoordinate(0, 0), 3));
+    // drawn outside of the scene update
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 1);
+    const QImage world = spy.last().at(0).value<QImage>();
+    QVERIFY(!world.isNull());
+
+    // The same copyrights are not drawn again
+    map->setCameraData(camera(QGeoCoordinate(0, 60), 3));
+    map->setCameraData(camera(QGeoCoordinate(40, -60), 4));
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 1);
+
+    map->setCameraData(camera(QGeoCoordinate(59.9, 10.7), 12));
+    QTRY_COMPARE(spy.count(), 2);
+    const QImage oslo = spy.last().at(0).value<QImage>();
+    QVERIFY(oslo.width() > world.width());
+
+    // Changes until control returns to the event loop are drawn once
+    map->setCameraData(camera(QGeoCoordinate(0, 0), 12));
+    map->setCameraData(camera(QGeoCoordinate(59.9, 10.7), 13));
+    map->setCameraData(camera(QGeoCoordinate(0, 0), 5));
+    QTRY_COMPARE(spy.count(), 3);
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.last().at(0).value<QImage>().size(), world.size());
+}
+
+void tst_nokia_mapping::mapVersion()
+{
+    saveMapVersion(3, QStringLiteral("a"));
+    m_networkManager->version = "info: a\n";
+    QImage image(256, 256, QImage::Format_RGB32);
+    image.fill(Qt::darkGreen);
+    QBuffer buffer(&m_networkManager->tile);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "png"));
+
+    // Maps created after the saved version was loaded request tiles of that version
+    {
+        QScopedPointer<QGeoServiceProvider> provider(createProvider());
+        QScopedPointer<QGeoMap> map(createMap(provider.data()));
+        QVERIFY(map);
+        QTRY_COMPARE(m_networkManager->versionRequests, 1);
+        map->setCameraData(camera(QGeoCoordinate(0, 0), 1));
+        QTRY_VERIFY(m_networkManager->tileRequests > 0);
+        QTRY_VERIFY(!tileFiles(3).isEmpty());
+        QVERIFY(tileFiles(-1).isEmpty());
+    }
+    const QStringList versionThree = tileFiles(3);
+
+    // A tile stored without a version, picked up by rescanning the directory
+    QDir directory(m_cacheDirectory->path());
+    QStringList fields = versionThree.first().split(QLatin1Char('-'));
+    fields.removeAt(5);
+    QVERIFY(QFile::copy(directory.filePath(versionThree.first()), directory.filePath(fields.join(QLatin1Char('-')))));
+    directory.remove(QStringLiteral("tiles.index"));
+
+    // Starting again with the same map data removes nothing
+    m_networkManager = new MockGeoNetworkAccessManager;
+    m_networkManager->version = "info: a\n";
+    {
+        QScopedPointer<QGeoServiceProvider> provider(createProvider());
+        QScopedPointer<QGeoMap> map(createMap(provider.data()));
+        QVERIFY(map);
+        QTRY_COMPARE(m_networkManager->versionRequests, 1);
+        QTest::qWait(500); // well past the stale tile batches
+        QCOMPARE(tileFiles(3), versionThree);
+        QCOMPARE(tileFiles(-1).size(), 1);
+    }
+
+    // New map data is a new version, whose tiles replace the others
+    m_networkManager = new MockGeoNetworkAccessManager;
+    m_networkManager->version = "info: b\n";
+    m_networkManager->tile = buffer.data();
+    {
+        QScopedPointer<QGeoServiceProvider> provider(createProvider());
+        QScopedPointer<QGeoMap> map(createMap(provider.data()));
+        QVERIFY(map);
+        QTRY_COMPARE(m_networkManager->versionRequests, 1);
+        QTest::qWait(10); // for the new version to be parsed
+        map->setCameraData(camera(QGeoCoordinate(0, 0), 1));
+        QTRY_VERIFY(!tileFiles(4).isEmpty());
+        QTRY_VERIFY(tileFiles(3).isEmpty());
+        QTRY_VERIFY(tileFiles(-1).isEmpty());
+    }
+}
+
+QTEST_MAIN(tst_nokia_mapping)
+
+#include "tst_mapping.moc"
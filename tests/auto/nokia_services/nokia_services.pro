@@ -1,2 +1,2 @@
 TEMPLATE = subdirs
-SUBDIRS += routing places_semiauto
+SUBDIRS += routing mapping places_semiauto
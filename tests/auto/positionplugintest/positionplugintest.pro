@@ -6,4 +6,4 @@ SOURCES += tst_positionplugin.cpp
 
 CONFIG -= app_bundle
 
-QT += positioning testlib
+QT += positioning-private testlib
@@ -34,6 +34,7 @@
 #include <QtPositioning/qgeosatelliteinfosource.h>
 #include <QtPositioning/qgeoareamonitorsource.h>
 #include <QtPositioning/qgeocoordinate.h>
+#include <QtPositioning/private/qgeopositioninfosource_p.h>
 
 QT_USE_NAMESPACE
 
@@ -47,6 +48,7 @@ private slots:
     void availableSources();
     void create();
     void getUpdates();
+    void reload();
 };
 
 void tst_PositionPlugin::initTestCase()
@@ -104,7 +106,26 @@ void tst_PositionPlugin::getUpdates()
     QCOMPARE(info.coordinate().longitude(), 0.1);
 }
 
+// Reloading replaces the plugin metadata instead of appending to it
+void tst_PositionPlugin::reload()
+{
+    const int positionSources = QGeoPositionInfoSource::availableSources().size();
+    const int satelliteSources = QGeoSatelliteInfoSource::availableSources().size();
+    const int areaMonitorSources = QGeoAreaMonitorSource::availableSources().size();
+    QVERIFY(QGeoPositionInfoSource::availableSources().contains("test.source"));
 
+    for (int i = 0; i < 2; ++i) {
+        QGeoPositionInfoSourcePrivate::plugins(true);
+        QCOMPARE(QGeoPositionInfoSource::availableSources().size(), positionSources);
+        QCOMPARE(QGeoSatelliteInfoSource::availableSources().size(), satelliteSources);
+        QCOMPARE(QGeoAreaMonitorSource::availableSources().size(), areaMonitorSources);
+        QCOMPARE(QGeoPositionInfoSourcePrivate::pluginsSorted().size(),
+                 QGeoPositionInfoSourcePrivate::plugins().size());
+    }
+
+    QScopedPointer<QGeoPositionInfoSource> src(QGeoPositionInfoSource::createSource("test.source", 0));
+    QVERIFY(src);
+}
 
 QTEST_GUILESS_MAIN(tst_PositionPlugin)
 #include "tst_positionplugin.moc"
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qcache3q
+
+SOURCES += tst_qcache3q.cpp
+
+QT += location-private testlib
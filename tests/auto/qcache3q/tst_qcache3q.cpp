@@ -0,0 +1,165 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtLocation/private/qcache3q_p.h>
+
+QT_USE_NAMESPACE
+
+typedef QCache3Q<int, QString> Cache;
+
+class tst_QCache3Q : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void hitsAndMisses();
+    void evictions();
+    void admissionFilter();
+    void reuseNodes();
+
+private:
+    static QSharedPointer<QString> value(int key);
+};
+
+QSharedPointer<QString> tst_QCache3Q::value(int key)
+{
+    return QSharedPointer<QString>(new QString(QString::number(key)));
+}
+
+void tst_QCache3Q::hitsAndMisses()
+{
+    Cache cache(10);
+    cache.setPromoteAt(1);
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(cache.insert(i, value(i)));
+
+    QCOMPARE(*cache.object(0), QStringLiteral("0"));
+    QVERIFY(cache.object(42).isNull());
+
+    QCache3QStatistics stats = cache.statistics();
+    QCOMPARE(stats.hits[0], quint64(1));
+    QCOMPARE(stats.hitCount(), quint64(1));
+    QCOMPARE(stats.misses, quint64(1));
+    QCOMPARE(stats.size[0], 3);
+    QCOMPARE(stats.cost[0], 3);
+
+    // popular enough to become a regular
+    cache.object(0);
+    stats = cache.statistics();
+    QCOMPARE(stats.hits[0], quint64(2));
+    QCOMPARE(stats.size[0], 2);
+    QCOMPARE(stats.size[1], 1);
+    cache.object(0);
+    QCOMPARE(cache.statistics().hits[1], quint64(1));
+
+    cache.resetStatistics();
+    stats = cache.statistics();
+    QCOMPARE(stats.hitCount(), quint64(0));
+    QCOMPARE(stats.misses, quint64(0));
+    QCOMPARE(stats.size[1], 1);
+}
+
+void tst_QCache3Q::evictions()
+{
+    Cache cache(3);
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(cache.insert(i, value(i)));
+
+    QCache3QStatistics stats = cache.statistics();
+    QCOMPARE(stats.evictionCount(), quint64(2));
+    QCOMPARE(stats.evictions[0], quint64(2));
+    QCOMPARE(cache.totalCost(), 3);
+
+    // the oldest newbie is a ghost now
+    QVERIFY(cache.object(0).isNull());
+    stats = cache.statistics();
+    QCOMPARE(stats.ghostHits, quint64(1));
+    QCOMPARE(stats.misses, quint64(1));
+}
+
+void tst_QCache3Q::admissionFilter()
+{
+    Cache cache(4);
+    cache.setAdmissionFilter(true);
+    QVERIFY(cache.admissionFilter());
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(cache.insert(i, value(i)));
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i)
+            QVERIFY(!cache.object(i).isNull());
+    }
+
+    // a key never requested before does not push out a popular one
+    QVERIFY(!cache.insert(100, value(100)));
+    QCOMPARE(cache.statistics().rejected, quint64(1));
+    QCOMPARE(cache.statistics().evictionCount(), quint64(0));
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(!cache.object(i).isNull());
+
+    // unless forced in
+    QVERIFY(cache.insert(101, value(101), 1, true));
+    QVERIFY(!cache.object(101).isNull());
+
+    // or once it became more popular than the victim
+    for (int round = 0; round < 8; ++round)
+        cache.object(100);
+    QVERIFY(cache.insert(100, value(100)));
+    QCOMPARE(*cache.object(100), QStringLiteral("100"));
+
+    // without the filter every insert fits
+    cache.setAdmissionFilter(false);
+    QVERIFY(cache.insert(200, value(200)));
+    QCOMPARE(cache.statistics().rejected, quint64(1));
+}
+
+void tst_QCache3Q::reuseNodes()
+{
+    Cache cache(4);
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i)
+            QVERIFY(cache.insert(i, value(round * 10 + i)));
+        for (int i = 0; i < 4; ++i)
+            QCOMPARE(*cache.object(i), QString::number(round * 10 + i));
+        for (int i = 0; i < 4; ++i)
+            cache.remove(i);
+        QCOMPARE(cache.totalCost(), 0);
+        QVERIFY(cache.keys().isEmpty());
+    }
+
+    // recycled nodes start out fresh
+    QVERIFY(cache.insert(7, value(7)));
+    QCOMPARE(cache.statistics().size[0], 1);
+    cache.clear();
+    QVERIFY(cache.object(7).isNull());
+}
+
+QTEST_APPLESS_MAIN(tst_QCache3Q)
+
+#include "tst_qcache3q.moc"
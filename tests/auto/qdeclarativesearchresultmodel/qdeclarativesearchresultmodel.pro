@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qdeclarativesearchresultmodel
+
+SOURCES += tst_qdeclarativesearchresultmodel.cpp
+
+QT += location-private positioning qml testlib
@@ -0,0 +1,429 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/declarativeplaces
+
+#include <QtTest/QtTest>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlComponent>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/QPlaceDetailsReply>
+#include <QtLocation/QPlaceManager>
+#include <QtLocation/private/qdeclarativegeoserviceprovider_p.h>
+#include <QtLocation/private/qdeclarativeplace_p.h>
+#include <QtLocation/private/qdeclarativesearchresultmodel_p.h>
+
+QT_USE_NAMESPACE
+
+// Counts the detail requests of a model from the replies it takes over, and how many of them
+// run at the same time.
+class DetailsCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DetailsCounter(QObject *model)
+    {
+        model->installEventFilter(this);
+    }
+
+    int requests = 0;
+    int maximumRunning = 0;
+
+    int running() const
+    {
+        return m_running.count();
+    }
+
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() != QEvent::ChildAdded)
+            return QObject::eventFilter(watched, event);
+
+        QPlaceDetailsReply *reply = qobject_cast<QPlaceDetailsReply *>(
+                    static_cast<QChildEvent *>(event)->child());
+        if (reply && !m_running.contains(reply)) {
+            ++requests;
+            m_running.insert(reply);
+            maximumRunning = qMax(maximumRunning, running());
+            // connected before the model, so the reply is done when the next one is sent
+            connect(reply, &QPlaceReply::finished, this, [this, reply]() { m_running.remove(reply); });
+            connect(reply, &QObject::destroyed, this, [this, reply]() { m_running.remove(reply); });
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    QSet<QObject *> m_running;
+};
+
+class tst_QDeclarativeSearchResultModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void detailsRequestsCapped_data();
+    void detailsRequestsCapped();
+    void cancelQueued();
+    void cancelRunning();
+    void detailsCached();
+    void duplicatePlaceIds();
+    void placeRemovedShiftsRows();
+    void favoritesOnSecondPage();
+    void placesMadeOnRead();
+
+private:
+    QDeclarativeSearchResultModel *model(int maximumDetailsRequests);
+    QDeclarativeSearchResultModel *pagedModel(const QByteArray &properties = QByteArray());
+    static void loadPages(QDeclarativeSearchResultModel *model);
+    static QStringList titles(const QDeclarativeSearchResultModel *model);
+    static QDeclarativePlace *place(const QDeclarativeSearchResultModel *model, int row);
+
+    QQmlEngine m_engine;
+};
+
+void tst_QDeclarativeSearchResultModel::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+}
+
+// A model holding the three places of the test data, all of which have an "e" in their name.
+QDeclarativeSearchResultModel *tst_QDeclarativeSearchResultModel::model(int maximumDetailsRequests)
+{
+    QQmlComponent component(&m_engine);
+    component.setData("import QtLocation 5.15\n"
+                      "PlaceSearchModel {\n"
+                      "    searchTerm: \"e\"\n"
+                      "    maximumDetailsRequests: " + QByteArray::number(maximumDetailsRequests) + "\n"
+                      "    plugin: Plugin { name: \"qmlgeo.test.plugin\"; allowExperimental: true\n"
+                      "        PluginParameter { name: \"initializePlaceData\"; value: true } }\n"
+                      "}", QUrl());
+    QDeclarativeSearchResultModel *model = qobject_cast<QDeclarativeSearchResultModel *>(component.create());
+    if (!model) {
+        qWarning() << component.errors();
+        return nullptr;
+    }
+    model->setParent(this);
+    model->update();
+    return model;
+}
+
+// The three places twice, in pages of two, so that a place is on two pages: a b, c a, b c.
+QDeclarativeSearchResultModel *tst_QDeclarativeSearchResultModel::pagedModel(const QByteArray &properties)
+{
+    QQmlComponent component(&m_engine);
+    component.setData("import QtLocation 5.15\n"
+                      "PlaceSearchModel {\n"
+                      "    searchTerm: \"e\"\n"
+                      "    limit: 2\n"
+                      "    incremental: true\n"
+                      "    plugin: Plugin { name: \"qmlgeo.test.plugin\"; allowExperimental: true\n"
+                      "        PluginParameter { name: \"initializePlaceData\"; value: true }\n"
+                      "        PluginParameter { name: \"repeatSearchResults\"; value: 2 } }\n"
+                      + properties +
+                      "}", QUrl());
+    QDeclarativeSearchResultModel *model = qobject_cast<QDeclarativeSearchResultModel *>(component.create());
+    if (!model) {
+        qWarning() << component.errors();
+        return nullptr;
+    }
+    model->setParent(this);
+    model->update();
+    return model;
+}
+
+void tst_QDeclarativeSearchResultModel::loadPages(QDeclarativeSearchResultModel *model)
+{
+    QTRY_COMPARE(model->status(), QDeclarativeSearchModelBase::Ready);
+    QCOMPARE(model->rowCount(), 2);
+    for (int rows = 4; rows <= 6; rows += 2) {
+        model->nextPage();
+        QTRY_COMPARE(model->status(), QDeclarativeSearchModelBase::Ready);
+        QCOMPARE(model->rowCount(), rows);
+    }
+    QVERIFY(!model->nextPagesAvailable());
+}
+
+QStringList tst_QDeclarativeSearchResultModel::titles(const QDeclarativeSearchResultModel *model)
+{
+    QStringList titles;
+    for (int row = 0; row < model->rowCount(); ++row)
+        titles.append(model->data(row, QStringLiteral("title")).toString());
+    return titles;
+}
+
+QDeclarativePlace *tst_QDeclarativeSearchResultModel::place(const QDeclarativeSearchResultModel *model, int row)
+{
+    return qobject_cast<QDeclarativePlace *>(model->data(row, QStringLiteral("place")).value<QObject *>());
+}
+
+void tst_QDeclarativeSearchResultModel::detailsRequestsCapped_data()
+{
+    QTest::addColumn<int>("maximum");
+    QTest::addColumn<int>("expectedRunning");
+
+    QTest::newRow("one") << 1 << 1;
+    QTest::newRow("two") << 2 << 2;
+    QTest::newRow("more than the rows") << 4 << 3;
+}
+
+void tst_QDeclarativeSearchResultModel::detailsRequestsCapped()
+{
+    QFETCH(int, maximum);
+    QFETCH(int, expectedRunning);
+
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(model(maximum));
+    QVERIFY(searchModel);
+    QTRY_COMPARE(searchModel->status(), QDeclarativeSearchModelBase::Ready);
+    QCOMPARE(searchModel->rowCount(), 3);
+    DetailsCounter counter(searchModel.data());
+
+    for (int i = 0; i < 3; ++i)
+        searchModel->fetchDetails(i);
+    QCOMPARE(counter.requests, expectedRunning);
+    QCOMPARE(counter.running(), expectedRunning);
+
+    // the queue drains one reply at a time, never above the cap
+    QTRY_COMPARE(counter.requests, 3);
+    QTRY_COMPARE(counter.running(), 0);
+    QCOMPARE(counter.maximumRunning, expectedRunning);
+}
+
+void tst_QDeclarativeSearchResultModel::cancelQueued()
+{
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(model(1));
+    QVERIFY(searchModel);
+    QTRY_COMPARE(searchModel->status(), QDeclarativeSearchModelBase::Ready);
+    DetailsCounter counter(searchModel.data());
+
+    searchModel->fetchDetails(0);
+    searchModel->fetchDetails(1);
+    searchModel->fetchDetails(1);
+    searchModel->fetchDetails(2);
+    QCOMPARE(counter.requests, 1);
+
+    // the queued row 1 is never sent
+    searchModel->cancelDetails(1);
+    QTRY_COMPARE(counter.requests, 2);
+    QTRY_COMPARE(counter.running(), 0);
+    QTest::qWait(50);
+    QCOMPARE(counter.requests, 2);
+
+    // out of range or not asked for
+    searchModel->cancelDetails(-1);
+    searchModel->cancelDetails(3);
+    searchModel->cancelDetails(1);
+    searchModel->fetchDetails(3);
+    QCOMPARE(counter.requests, 2);
+}
+
+void tst_QDeclarativeSearchResultModel::cancelRunning()
+{
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(model(1));
+    QVERIFY(searchModel);
+    QTRY_COMPARE(searchModel->status(), QDeclarativeSearchModelBase::Ready);
+    DetailsCounter counter(searchModel.data());
+
+    searchModel->fetchDetails(0);
+    searchModel->fetchDetails(1);
+    QCOMPARE(counter.requests, 1);
+
+    // aborting the running reply sends the queued one right away
+    searchModel->cancelDetails(0);
+    QCOMPARE(counter.requests, 2);
+    QTRY_COMPARE(counter.running(), 0);
+
+    // the aborted place was not kept, so it is fetched again
+    searchModel->fetchDetails(0);
+    QCOMPARE(counter.requests, 3);
+    QTRY_COMPARE(counter.running(), 0);
+}
+
+void tst_QDeclarativeSearchResultModel::detailsCached()
+{
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(model(4));
+    QVERIFY(searchModel);
+    QTRY_COMPARE(searchModel->status(), QDeclarativeSearchModelBase::Ready);
+    DetailsCounter counter(searchModel.data());
+
+    searchModel->fetchDetails(0);
+    searchModel->fetchDetails(1);
+    QTRY_COMPARE(counter.requests, 2);
+    QTRY_COMPARE(counter.running(), 0);
+
+    searchModel->fetchDetails(0);
+    searchModel->fetchDetails(1);
+    QCOMPARE(counter.requests, 2);
+
+    // the rows of a new search for the same places get the fetched details from the cache
+    searchModel->update();
+    QTRY_COMPARE(searchModel->status(), QDeclarativeSearchModelBase::Ready);
+    QCOMPARE(searchModel->rowCount(), 3);
+    for (int i = 0; i < 3; ++i)
+        searchModel->fetchDetails(i);
+    QCOMPARE(counter.requests, 3);
+    QTRY_COMPARE(counter.running(), 0);
+}
+
+void tst_QDeclarativeSearchResultModel::duplicatePlaceIds()
+{
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(pagedModel());
+    QVERIFY(searchModel);
+    loadPages(searchModel.data());
+    if (QTest::currentTestFailed())
+        return;
+    const QStringList rows = titles(searchModel.data());
+    QCOMPARE(rows.mid(3), rows.mid(0, 3));
+    QCOMPARE(QSet<QString>(rows.cbegin(), rows.cend()).count(), 3);
+    DetailsCounter counter(searchModel.data());
+
+    // the details fetched for the later row of a place reach it, not only the first row
+    searchModel->fetchDetails(3);
+    QTRY_COMPARE(counter.requests, 1);
+    QTRY_COMPARE(counter.running(), 0);
+    QVERIFY(place(searchModel.data(), 3)->detailsFetched());
+    QVERIFY(place(searchModel.data(), 0)->detailsFetched());
+    QCOMPARE(place(searchModel.data(), 0)->placeId(), place(searchModel.data(), 3)->placeId());
+    searchModel->fetchDetails(0);
+    QCOMPARE(counter.requests, 1);
+}
+
+void tst_QDeclarativeSearchResultModel::placeRemovedShiftsRows()
+{
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(pagedModel());
+    QVERIFY(searchModel);
+    loadPages(searchModel.data());
+    if (QTest::currentTestFailed())
+        return;
+    const QStringList rows = titles(searchModel.data());
+    const QString a = place(searchModel.data(), 0)->placeId();
+    const QString c = place(searchModel.data(), 2)->placeId();
+    QPlaceManager *manager = searchModel->plugin()->sharedGeoServiceProvider()->placeManager();
+    QVERIFY(manager);
+    QSignalSpy removedSpy(searchModel.data(), SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    // the first row of a place, then the row of the same place shifted by it
+    emit manager->placeRemoved(a);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.last().at(1).toInt(), 0);
+    QCOMPARE(titles(searchModel.data()), QStringList() << rows.at(1) << rows.at(2) << rows.at(0)
+                                                       << rows.at(1) << rows.at(2));
+    emit manager->placeRemoved(a);
+    QCOMPARE(removedSpy.last().at(1).toInt(), 2);
+    QCOMPARE(titles(searchModel.data()), QStringList() << rows.at(1) << rows.at(2)
+                                                       << rows.at(1) << rows.at(2));
+
+    // a place whose rows were shifted by the removal of others
+    emit manager->placeRemoved(c);
+    QCOMPARE(removedSpy.last().at(1).toInt(), 1);
+    emit manager->placeRemoved(c);
+    QCOMPARE(removedSpy.last().at(1).toInt(), 2);
+    QCOMPARE(titles(searchModel.data()), QStringList() << rows.at(1) << rows.at(1));
+    QCOMPARE(removedSpy.count(), 4);
+
+    // none left
+    emit manager->placeRemoved(a);
+    QCOMPARE(removedSpy.count(), 4);
+    QCOMPARE(searchModel->rowCount(), 2);
+    QCOMPARE(place(searchModel.data(), 0)->placeId(), place(searchModel.data(), 1)->placeId());
+    QVERIFY(place(searchModel.data(), 1)->placeId() != a);
+}
+
+void tst_QDeclarativeSearchResultModel::favoritesOnSecondPage()
+{
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(pagedModel(
+            "    favoritesPlugin: Plugin { name: \"qmlgeo.test.plugin\"; allowExperimental: true\n"
+            "        PluginParameter { name: \"initializePlaceData\"; value: true } }\n"));
+    QVERIFY(searchModel);
+    loadPages(searchModel.data());
+    if (QTest::currentTestFailed())
+        return;
+
+    // every row, of every page, has the favorite matched for it
+    for (int row = 0; row < searchModel->rowCount(); ++row) {
+        QDeclarativePlace *result = place(searchModel.data(), row);
+        QVERIFY(result);
+        QVERIFY2(result->favorite(), qPrintable(QStringLiteral("row %1 has no favorite").arg(row)));
+        QCOMPARE(result->favorite()->placeId(), result->placeId());
+        QCOMPARE(result->favorite()->plugin(), searchModel->favoritesPlugin());
+    }
+}
+
+void tst_QDeclarativeSearchResultModel::placesMadeOnRead()
+{
+    QScopedPointer<QDeclarativeSearchResultModel> searchModel(pagedModel());
+    QVERIFY(searchModel);
+    loadPages(searchModel.data());
+    if (QTest::currentTestFailed())
+        return;
+    auto places = [&searchModel]() {
+        return searchModel->findChildren<QDeclarativePlace *>(QString(), Qt::FindDirectChildrenOnly).count();
+    };
+
+    // not by the other roles
+    QCOMPARE(places(), 0);
+    const QStringList rows = titles(searchModel.data());
+    QCOMPARE(rows.count(), 6);
+    for (int row = 0; row < rows.count(); ++row)
+        searchModel->data(row, QStringLiteral("distance"));
+    QCOMPARE(places(), 0);
+
+    QDeclarativePlace *later = place(searchModel.data(), 3);
+    QVERIFY(later);
+    QCOMPARE(places(), 1);
+    QCOMPARE(place(searchModel.data(), 3), later);
+    QCOMPARE(places(), 1);
+
+    // an update refreshes the place made, without making the one of the first row
+    QPlaceManager *manager = searchModel->plugin()->sharedGeoServiceProvider()->placeManager();
+    QVERIFY(manager);
+    emit manager->placeUpdated(later->placeId());
+    QCOMPARE(later->status(), QDeclarativePlace::Fetching);
+    QCOMPARE(places(), 1);
+    QTRY_COMPARE(later->status(), QDeclarativePlace::Ready);
+    QVERIFY(later->detailsFetched());
+
+    // which is made when read
+    QDeclarativePlace *first = place(searchModel.data(), 0);
+    QCOMPARE(places(), 2);
+    QCOMPARE(first->placeId(), later->placeId());
+}
+
+QTEST_GUILESS_MAIN(tst_QDeclarativeSearchResultModel)
+
+#include "tst_qdeclarativesearchresultmodel.moc"
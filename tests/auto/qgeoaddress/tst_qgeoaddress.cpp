@@ -61,6 +61,7 @@ private Q_SLOTS:
 //    void suiteTest();
     void generatedText();
     void generatedText_data();
+    void generatedTextChanges();
     void operatorsTest();
     void emptyClearTest();
 };
@@ -499,6 +500,33 @@ void tst_QGeoAddress::generatedText_data()
 //    QVERIFY2(testObj.suite() == "testText", "Wrong value returned");
 //}
 
+void tst_QGeoAddress::generatedTextChanges()
+{
+    QGeoAddress address;
+    address.setStreet("street");
+    address.setCity("city");
+    address.setCountryCode("USA");
+    QCOMPARE(address.text(), QStringLiteral("street<br/>city"));
+
+    const QGeoAddress copy = address;
+    QCOMPARE(copy.text(), QStringLiteral("street<br/>city"));
+
+    address.setState("state");
+    QCOMPARE(address.text(), QStringLiteral("street<br/>city, state"));
+    QCOMPARE(copy.text(), QStringLiteral("street<br/>city"));
+
+    address.setCountryCode("CHN");
+    QCOMPARE(address.text(), QStringLiteral("street, city<br/>state"));
+
+    address.setText("explicit");
+    QCOMPARE(address.text(), QStringLiteral("explicit"));
+    address.setText(QString());
+    QCOMPARE(address.text(), QStringLiteral("street, city<br/>state"));
+
+    address.clear();
+    QCOMPARE(address.text(), QString());
+}
+
 void tst_QGeoAddress::operatorsTest()
 {
     QGeoAddress testObj;
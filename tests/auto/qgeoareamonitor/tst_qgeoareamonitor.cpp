@@ -69,6 +69,35 @@ void tst_qgeoareamonitorinfo_messageHandler(QtMsgType type,
     }
 }
 
+// A source emitting the positions it is given
+class ManualPositionSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+
+public:
+    explicit ManualPositionSource(QObject *parent = 0)
+        : QGeoPositionInfoSource(parent) {}
+
+    QGeoPositionInfo lastKnownPosition(bool = false) const override { return lastPosition; }
+    PositioningMethods supportedPositioningMethods() const override { return AllPositioningMethods; }
+    int minimumUpdateInterval() const override { return 0; }
+    Error error() const override { return NoError; }
+
+    void setPosition(const QGeoPositionInfo &info)
+    {
+        lastPosition = info;
+        emit positionUpdated(info);
+    }
+
+public slots:
+    void startUpdates() override {}
+    void stopUpdates() override {}
+    void requestUpdate(int = 5000) override {}
+
+private:
+    QGeoPositionInfo lastPosition;
+};
+
 class tst_QGeoAreaMonitorSource : public QObject
 {
     Q_OBJECT
@@ -709,6 +738,211 @@ private slots:
         delete obj2;
     }
 
+    void tst_adaptiveUpdateInterval()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+        QCOMPARE(obj->property("adaptiveUpdateInterval").toBool(), false);
+
+        LogFilePositionSource *source = new LogFilePositionSource(this);
+        source->setUpdateInterval(UPDATE_INTERVAL);
+        obj->setPositionInfoSource(source);
+
+        QVERIFY(obj->setProperty("adaptiveUpdateInterval", true));
+        QVERIFY(obj->setProperty("maximumUpdateInterval", 1000));
+        QCOMPARE(obj->property("adaptiveUpdateInterval").toBool(), true);
+        QCOMPARE(obj->property("maximumUpdateInterval").toInt(), 1000);
+
+        // a monitor far from the logged positions
+        QGeoAreaMonitorInfo farCircle("FarCircle");
+        farCircle.setArea(QGeoCircle(QGeoCoordinate(0, 0), 1000));
+        QVERIFY(obj->startMonitoring(farCircle));
+
+        QSignalSpy positionSpy(source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        QSignalSpy enteredSpy(obj, SIGNAL(areaEntered(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+        QTRY_VERIFY_WITH_TIMEOUT(positionSpy.count() > 0, 1000);
+        QTRY_COMPARE(source->updateInterval(), 1000);
+
+        // a boundary running along the logged positions brings it back down
+        QGeoAreaMonitorInfo nearRectangle("NearRectangle");
+        nearRectangle.setArea(QGeoRectangle(QGeoCoordinate(-27.0, 153.09),
+                                            QGeoCoordinate(-28.0, 153.2)));
+        QVERIFY(obj->startMonitoring(nearRectangle));
+        QTRY_VERIFY_WITH_TIMEOUT(enteredSpy.count() > 0, 3000);
+        QTRY_VERIFY(source->updateInterval() < 1000);
+
+        QVERIFY(obj->setProperty("adaptiveUpdateInterval", false));
+        QCOMPARE(source->updateInterval(), UPDATE_INTERVAL);
+
+        delete obj;
+    }
+
+    void tst_adaptiveUpdateIntervalAcrossCellEdge()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+
+        ManualPositionSource *source = new ManualPositionSource(this);
+        source->setUpdateInterval(1000);
+        obj->setPositionInfoSource(source);
+        QVERIFY(obj->setProperty("adaptiveUpdateInterval", true));
+        QVERIFY(obj->setProperty("maximumUpdateInterval", 60000));
+
+        QSignalSpy enteredSpy(obj, SIGNAL(areaEntered(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+        QGeoAreaMonitorInfo farCircle("FarCircle");
+        farCircle.setArea(QGeoCircle(QGeoCoordinate(-40, -100), 1000));
+        QVERIFY(obj->startMonitoring(farCircle));
+
+        // at 5 m/s the boundaries are looked for up to 600 m away, less
+        // than the width of a cell
+        QDateTime timestamp = QDateTime::currentDateTimeUtc();
+        QGeoPositionInfo info(QGeoCoordinate(10.0095, 20.005), timestamp);
+        info.setAttribute(QGeoPositionInfo::GroundSpeed, 5);
+        source->setPosition(info);
+        QTRY_COMPARE(source->updateInterval(), 60000);
+
+        // a fence in the next cell, about 180 m away across the edge of
+        // the cell of the position
+        QGeoAreaMonitorInfo edgeCircle("EdgeCircle");
+        edgeCircle.setArea(QGeoCircle(QGeoCoordinate(10.012, 20.005), 100));
+        QVERIFY(obj->startMonitoring(edgeCircle));
+
+        info.setTimestamp(timestamp.addSecs(1));
+        source->setPosition(info);
+        QTRY_VERIFY(source->updateInterval() < 30000);
+        QVERIFY(source->updateInterval() > 10000);
+        QCOMPARE(enteredSpy.count(), 0);
+
+        delete obj;
+    }
+
+    // Monitors covering up to 256 cells of the grid are looked up by the
+    // cell of the position, larger ones are tested on every position
+    void tst_expiryHeap()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+
+        ManualPositionSource *source = new ManualPositionSource(this);
+        obj->setPositionInfoSource(source);
+        QSignalSpy expirySpy(obj, SIGNAL(monitorExpired(QGeoAreaMonitorInfo)));
+
+        const QDateTime now = QDateTime::currentDateTime();
+        const QDateTime due = now.addMSecs(500);
+        auto monitor = [](const QString &name, const QDateTime &expiration) {
+            QGeoAreaMonitorInfo info(name);
+            info.setArea(QGeoCircle(QGeoCoordinate(1, 1), 100));
+            info.setExpiration(expiration);
+            return info;
+        };
+        auto expiredName = [&expirySpy](int i) {
+            return expirySpy.at(i).at(0).value<QGeoAreaMonitorInfo>().name();
+        };
+
+        // several on the same tick
+        for (const QString &name : { QStringLiteral("A"), QStringLiteral("B"), QStringLiteral("C") })
+            QVERIFY(obj->startMonitoring(monitor(name, due)));
+
+        // re-added with a later and an earlier expiry, leaving stale entries behind
+        QGeoAreaMonitorInfo later = monitor(QStringLiteral("Later"), due);
+        QVERIFY(obj->startMonitoring(later));
+        later.setExpiration(due.addMSecs(400));
+        QVERIFY(obj->startMonitoring(later));
+        QGeoAreaMonitorInfo earlier = monitor(QStringLiteral("Earlier"), due.addMSecs(800));
+        QVERIFY(obj->startMonitoring(earlier));
+        earlier.setExpiration(due.addMSecs(200));
+        QVERIFY(obj->startMonitoring(earlier));
+
+        // removed while its expiry is pending
+        const QGeoAreaMonitorInfo removed = monitor(QStringLiteral("Removed"), due);
+        QVERIFY(obj->startMonitoring(removed));
+        QVERIFY(obj->stopMonitoring(removed));
+
+        // beyond the range of the timer
+        const QGeoAreaMonitorInfo distant = monitor(QStringLiteral("Distant"),
+                                                    now.addMSecs(qint64(INT_MAX) + 60000));
+        QVERIFY(obj->startMonitoring(distant));
+        QCOMPARE(obj->activeMonitors().count(), 6);
+
+        QTRY_COMPARE(expirySpy.count(), 3);
+        QStringList names;
+        for (int i = 0; i < 3; ++i)
+            names.append(expiredName(i));
+        names.sort();
+        QCOMPARE(names, QStringList() << QStringLiteral("A") << QStringLiteral("B") << QStringLiteral("C"));
+
+        QTRY_COMPARE(expirySpy.count(), 4);
+        QCOMPARE(expiredName(3), earlier.name());
+        QCOMPARE(expirySpy.at(3).at(0).value<QGeoAreaMonitorInfo>().expiration(), earlier.expiration());
+
+        QTRY_COMPARE(expirySpy.count(), 5);
+        QCOMPARE(expiredName(4), later.name());
+        QCOMPARE(expirySpy.at(4).at(0).value<QGeoAreaMonitorInfo>().expiration(), later.expiration());
+
+        // the stale entries and the distant expiry do not fire
+        QTest::qWait(500);
+        QCOMPARE(expirySpy.count(), 5);
+        const QList<QGeoAreaMonitorInfo> active = obj->activeMonitors();
+        QCOMPARE(active.count(), 1);
+        QCOMPARE(active.first().identifier(), distant.identifier());
+
+        delete obj;
+    }
+
+    void tst_monitorGridCutoff()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+
+        ManualPositionSource *source = new ManualPositionSource(this);
+        obj->setPositionInfoSource(source);
+        QSignalSpy enteredSpy(obj, SIGNAL(areaEntered(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+        QSignalSpy exitedSpy(obj, SIGNAL(areaExited(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+
+        // 16 x 16 cells of 0.01 degrees, and 16 x 17
+        QGeoAreaMonitorInfo indexed("Indexed");
+        indexed.setArea(QGeoRectangle(QGeoCoordinate(10.155, 20.005), QGeoCoordinate(10.005, 20.155)));
+        QVERIFY(obj->startMonitoring(indexed));
+        QGeoAreaMonitorInfo large("Large");
+        large.setArea(QGeoRectangle(QGeoCoordinate(30.155, 40.005), QGeoCoordinate(30.005, 40.165)));
+        QVERIFY(obj->startMonitoring(large));
+
+        QDateTime timestamp = QDateTime::currentDateTimeUtc();
+        auto moveTo = [&](double latitude, double longitude) {
+            timestamp = timestamp.addSecs(1);
+            source->setPosition(QGeoPositionInfo(QGeoCoordinate(latitude, longitude), timestamp));
+        };
+
+        moveTo(0.0, 0.0);
+        QTest::qWait(50);
+        QCOMPARE(enteredSpy.count(), 0);
+
+        for (const QGeoAreaMonitorInfo &monitor : { indexed, large }) {
+            const QGeoRectangle area(monitor.area());
+            enteredSpy.clear();
+            exitedSpy.clear();
+
+            // in the last cell of the area
+            moveTo(area.bottomRight().latitude() + 0.001, area.bottomRight().longitude() - 0.001);
+            QTRY_COMPARE(enteredSpy.count(), 1);
+            QCOMPARE(enteredSpy.at(0).at(0).value<QGeoAreaMonitorInfo>().identifier(), monitor.identifier());
+
+            // then in its first one
+            moveTo(area.topLeft().latitude() - 0.001, area.topLeft().longitude() + 0.001);
+            QTest::qWait(50);
+            QCOMPARE(enteredSpy.count(), 1);
+            QCOMPARE(exitedSpy.count(), 0);
+
+            // and out, in a cell of the grid away from it
+            moveTo(area.center().latitude(), area.center().longitude() + 1.0);
+            QTRY_COMPARE(exitedSpy.count(), 1);
+            QCOMPARE(exitedSpy.at(0).at(0).value<QGeoAreaMonitorInfo>().identifier(), monitor.identifier());
+            QCOMPARE(enteredSpy.count(), 1);
+        }
+
+        delete obj;
+    }
+
     void debug_data()
     {
         QTest::addColumn<QGeoAreaMonitorInfo>("info");
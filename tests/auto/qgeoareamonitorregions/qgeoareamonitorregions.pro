@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoareamonitorregions
+
+SOURCES += tst_qgeoareamonitorregions.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,378 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/qgeoareamonitorinfo.h>
+#include <QtPositioning/qgeocircle.h>
+#include <QtPositioning/qgeorectangle.h>
+#include <QtPositioning/private/qgeoareamonitorregions_p.h>
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoAreaMonitorInfo)
+
+// A source emitting the positions it is given
+class ManualPositionSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+
+public:
+    explicit ManualPositionSource(QObject *parent = 0)
+        : QGeoPositionInfoSource(parent) {}
+
+    QGeoPositionInfo lastKnownPosition(bool = false) const override { return lastPosition; }
+    PositioningMethods supportedPositioningMethods() const override { return AllPositioningMethods; }
+    int minimumUpdateInterval() const override { return 0; }
+    Error error() const override { return NoError; }
+
+    void setPosition(const QGeoCoordinate &coordinate)
+    {
+        lastPosition = QGeoPositionInfo(coordinate, QDateTime::currentDateTime());
+        emit positionUpdated(lastPosition);
+    }
+
+public slots:
+    void startUpdates() override {}
+    void stopUpdates() override {}
+    void requestUpdate(int = 5000) override {}
+
+private:
+    QGeoPositionInfo lastPosition;
+};
+
+// The geofencing of a platform, which refuses the regions it is told to
+class PlatformRegionSource : public QGeoAreaMonitorRegionSource
+{
+    Q_OBJECT
+
+public:
+    PlatformRegionSource(int maximumRegions, double maximumRadius)
+    {
+        setRegionLimits(maximumRegions, maximumRadius);
+    }
+
+    ~PlatformRegionSource()
+    {
+        stopRegions();
+    }
+
+    using QGeoAreaMonitorRegionSource::regionEvent;
+    using QGeoAreaMonitorRegionSource::regionFailed;
+
+    // The names of the monitors registered with the platform, sorted
+    QString registered() const
+    {
+        QStringList names;
+        const QList<QGeoAreaMonitorInfo> monitors = activeMonitors();
+        for (const QGeoAreaMonitorInfo &monitor : monitors) {
+            if (platform.contains(monitor.identifier()))
+                names.append(monitor.name());
+        }
+        names.sort();
+        return names.join(QLatin1Char(' '));
+    }
+
+    bool enabled = true;
+    QGeoPositionInfo position;
+    QHash<QString, QGeoCircle> platform;
+    QSet<QString> refused;
+
+protected:
+    bool enableRegions() override { return enabled; }
+    QGeoPositionInfo lastKnownPosition() const override { return position; }
+
+    bool startRegion(const QString &identifier, const QGeoCircle &circle) override
+    {
+        if (refused.contains(identifier))
+            return false;
+        platform.insert(identifier, circle);
+        return true;
+    }
+
+    void stopRegion(const QString &identifier) override
+    {
+        platform.remove(identifier);
+    }
+};
+
+class tst_QGeoAreaMonitorRegions : public QObject
+{
+    Q_OBJECT
+
+private:
+    // circles of 100 meters along the equator, about 1112 meters apart
+    static QGeoCircle circle(int i)
+    {
+        return QGeoCircle(QGeoCoordinate(0, i * 0.01), 100);
+    }
+
+    static QString sorted(QStringList list)
+    {
+        list.sort();
+        return list.join(QLatin1Char(' '));
+    }
+
+    static QGeoAreaMonitorInfo monitor(const QString &name, const QGeoShape &area)
+    {
+        QGeoAreaMonitorInfo info(name);
+        info.setArea(area);
+        return info;
+    }
+
+    static QGeoPositionInfo at(const QGeoCoordinate &coordinate)
+    {
+        return QGeoPositionInfo(coordinate, QDateTime::currentDateTime());
+    }
+
+    static bool pollingAvailable()
+    {
+        return QGeoAreaMonitorSource::availableSources().contains(QStringLiteral("positionpoll"));
+    }
+
+private slots:
+    void initTestCase()
+    {
+#if QT_CONFIG(library)
+        // Set custom path since CI doesn't install plugins
+#ifdef Q_OS_WIN
+        QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                         QStringLiteral("/../../../../plugins"));
+#else
+        QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath()
+                                         + QStringLiteral("/../../../plugins"));
+#endif
+#endif
+        qRegisterMetaType<QGeoAreaMonitorInfo>();
+        qRegisterMetaType<QGeoPositionInfo>();
+        qRegisterMetaType<QGeoAreaMonitorSource::Error>();
+    }
+
+    void insert()
+    {
+        QGeoAreaMonitorRegions regions(20, 1000);
+        QVERIFY(regions.insert(QStringLiteral("circle"), circle(0)));
+        QVERIFY(!regions.insert(QStringLiteral("large"), QGeoCircle(QGeoCoordinate(0, 0), 2000)));
+        QVERIFY(!regions.insert(QStringLiteral("rectangle"),
+                                QGeoRectangle(QGeoCoordinate(1, 0), QGeoCoordinate(0, 1))));
+        QVERIFY(regions.contains(QStringLiteral("circle")));
+        QVERIFY(!regions.contains(QStringLiteral("large")));
+
+        QStringList added, removed;
+        regions.update(QGeoCoordinate(), &added, &removed);
+        QCOMPARE(sorted(added), QStringLiteral("circle"));
+        QVERIFY(removed.isEmpty());
+        QVERIFY(regions.isRegistered(QStringLiteral("circle")));
+
+        // all registered, moving does not change anything
+        QVERIFY(!regions.needsUpdate(QGeoCoordinate(10, 10)));
+
+        // a replaced region is registered again, one too large now is unregistered
+        added.clear();
+        QVERIFY(regions.insert(QStringLiteral("circle"), circle(1)));
+        regions.update(QGeoCoordinate(), &added, &removed);
+        QCOMPARE(sorted(removed), QStringLiteral("circle"));
+        QCOMPARE(sorted(added), QStringLiteral("circle"));
+
+        added.clear();
+        removed.clear();
+        QVERIFY(!regions.insert(QStringLiteral("circle"), QGeoCircle(QGeoCoordinate(0, 0), 5000)));
+        regions.update(QGeoCoordinate(), &added, &removed);
+        QCOMPARE(sorted(removed), QStringLiteral("circle"));
+        QVERIFY(added.isEmpty());
+        QVERIFY(!regions.isRegistered(QStringLiteral("circle")));
+    }
+
+    void nearest()
+    {
+        QGeoAreaMonitorRegions regions(3, 1000);
+        for (int i = 0; i < 6; ++i)
+            QVERIFY(regions.insert(QString::number(i), circle(i)));
+
+        QStringList added, removed;
+        regions.update(QGeoCoordinate(0, 0), &added, &removed);
+        QCOMPARE(sorted(added), QStringLiteral("0 1 2"));
+        QVERIFY(removed.isEmpty());
+
+        // the selection may only change after moving half the 1112 meters
+        // between the boundaries of 2 and 3
+        QVERIFY(!regions.needsUpdate(QGeoCoordinate(0, 0.004)));
+        QVERIFY(regions.needsUpdate(QGeoCoordinate(0, 0.006)));
+
+        added.clear();
+        regions.update(QGeoCoordinate(0, 0.031), &added, &removed);
+        QCOMPARE(sorted(added), QStringLiteral("3 4"));
+        QCOMPARE(sorted(removed), QStringLiteral("0 1"));
+        QCOMPARE(sorted(regions.registered()), QStringLiteral("2 3 4"));
+
+        // a removed region frees its place for the next nearest
+        QVERIFY(regions.remove(QStringLiteral("3")));
+        added.clear();
+        removed.clear();
+        regions.update(QGeoCoordinate(0, 0.031), &added, &removed);
+        QCOMPARE(sorted(added), QStringLiteral("5"));
+        QVERIFY(removed.isEmpty());
+
+        // so does a rejected one, which is not selected again
+        regions.reject(QStringLiteral("4"));
+        added.clear();
+        regions.update(QGeoCoordinate(0, 0.031), &added, &removed);
+        QCOMPARE(sorted(added), QStringLiteral("1"));
+        QCOMPARE(sorted(regions.registered()), QStringLiteral("1 2 5"));
+    }
+
+    // The events of the platform regions are the events of the monitors, single shots stop them
+    void sourceEvents()
+    {
+        PlatformRegionSource source(20, 1000);
+        source.position = at(QGeoCoordinate(0, 0));
+        QSignalSpy entered(&source, &QGeoAreaMonitorSource::areaEntered);
+        QSignalSpy exited(&source, &QGeoAreaMonitorSource::areaExited);
+
+        const QGeoAreaMonitorInfo first = monitor(QStringLiteral("0"), circle(0));
+        const QGeoAreaMonitorInfo second = monitor(QStringLiteral("1"), circle(1));
+        QVERIFY(source.startMonitoring(first));
+        QVERIFY(source.requestUpdate(second, SIGNAL(areaExited(QGeoAreaMonitorInfo,QGeoPositionInfo))));
+        QVERIFY(!source.requestUpdate(second, SIGNAL(monitorExpired(QGeoAreaMonitorInfo))));
+        QCOMPARE(source.registered(), QStringLiteral("0 1"));
+        QCOMPARE(source.platform.value(first.identifier()), circle(0));
+        QCOMPARE(source.activeMonitors().size(), 2);
+        QCOMPARE(source.activeMonitors(QGeoCircle(QGeoCoordinate(0, 0), 500)).size(), 1);
+
+        source.regionEvent(first.identifier(), at(circle(0).center()), true);
+        QCOMPARE(entered.count(), 1);
+        QCOMPARE(entered.first().at(0).value<QGeoAreaMonitorInfo>(), first);
+        source.regionEvent(first.identifier(), at(QGeoCoordinate(0, 0.005)), false);
+        QCOMPARE(exited.count(), 1);
+        QCOMPARE(source.registered(), QStringLiteral("0 1"));
+
+        // the single shot waits for an exit, then stops
+        source.regionEvent(second.identifier(), at(circle(1).center()), true);
+        QCOMPARE(entered.count(), 1);
+        source.regionEvent(second.identifier(), at(QGeoCoordinate(0, 0.005)), false);
+        QCOMPARE(exited.count(), 2);
+        QCOMPARE(exited.last().at(0).value<QGeoAreaMonitorInfo>(), second);
+        QCOMPARE(source.registered(), QStringLiteral("0"));
+        QCOMPARE(source.activeMonitors().size(), 1);
+        source.regionEvent(second.identifier(), at(QGeoCoordinate(0, 0.005)), false);
+        QCOMPARE(exited.count(), 2);
+
+        // not monitored
+        source.regionEvent(QStringLiteral("unknown"), at(circle(0).center()), true);
+        QCOMPARE(entered.count(), 1);
+
+        QVERIFY(source.stopMonitoring(first));
+        QVERIFY(!source.stopMonitoring(first));
+        QVERIFY(source.platform.isEmpty());
+        QVERIFY(source.activeMonitors().isEmpty());
+    }
+
+    void sourceExpiry()
+    {
+        PlatformRegionSource source(20, 1000);
+        QSignalSpy expired(&source, &QGeoAreaMonitorSource::monitorExpired);
+
+        QGeoAreaMonitorInfo expiring = monitor(QStringLiteral("0"), circle(0));
+        expiring.setExpiration(QDateTime::currentDateTime().addMSecs(100));
+        QVERIFY(source.startMonitoring(expiring));
+        QVERIFY(source.startMonitoring(monitor(QStringLiteral("1"), circle(1))));
+        QCOMPARE(source.registered(), QStringLiteral("0 1"));
+
+        QTRY_COMPARE(expired.count(), 1);
+        QCOMPARE(expired.first().at(0).value<QGeoAreaMonitorInfo>(), expiring);
+        QCOMPARE(source.registered(), QStringLiteral("1"));
+        QCOMPARE(source.activeMonitors().size(), 1);
+
+        // already expired
+        expiring.setExpiration(QDateTime::currentDateTime().addSecs(-1));
+        QVERIFY(!source.startMonitoring(expiring));
+    }
+
+    void sourceAccessError()
+    {
+        PlatformRegionSource source(20, 1000);
+        source.enabled = false;
+        QSignalSpy error(&source, QOverload<QGeoAreaMonitorSource::Error>::of(&QGeoAreaMonitorSource::error));
+        QVERIFY(!source.startMonitoring(monitor(QStringLiteral("0"), circle(0))));
+        QCOMPARE(source.error(), QGeoAreaMonitorSource::AccessError);
+        QCOMPARE(error.count(), 1);
+        QVERIFY(source.activeMonitors().isEmpty());
+        QVERIFY(source.platform.isEmpty());
+    }
+
+    // The areas the platform cannot take are polled, the positions polled select the nearest
+    // circles again
+    void sourcePolling()
+    {
+        if (!pollingAvailable())
+            QSKIP("The positionpoll plugin is not available");
+
+        ManualPositionSource positions;
+        PlatformRegionSource source(2, 1000);
+        source.setPositionInfoSource(&positions);
+        source.position = at(QGeoCoordinate(0, 0));
+
+        QList<QGeoAreaMonitorInfo> circles;
+        for (int i = 0; i < 4; ++i) {
+            circles.append(monitor(QString::number(i), circle(i)));
+            QVERIFY(source.startMonitoring(circles.last()));
+        }
+        const QGeoAreaMonitorInfo rectangle = monitor(QStringLiteral("rectangle"),
+                QGeoRectangle(QGeoCoordinate(1, 1), QGeoCoordinate(0.5, 1.5)));
+        const QGeoAreaMonitorInfo large = monitor(QStringLiteral("large"),
+                QGeoCircle(QGeoCoordinate(1, 1), 5000));
+        QVERIFY(source.startMonitoring(rectangle));
+        QVERIFY(source.startMonitoring(large));
+        QCOMPARE(source.registered(), QStringLiteral("0 1"));
+        QCOMPARE(source.activeMonitors().size(), 6);
+        QCOMPARE(source.positionInfoSource(), &positions);
+
+        // far enough for the nearest two to change
+        positions.setPosition(QGeoCoordinate(0, 0.031));
+        QCOMPARE(source.registered(), QStringLiteral("2 3"));
+        source.position = positions.lastKnownPosition();
+
+        // a region the platform stopped is polled, and the next nearest takes its place
+        source.regionFailed(circles.at(3).identifier());
+        QCOMPARE(source.registered(), QStringLiteral("1 2"));
+        QCOMPARE(source.activeMonitors().size(), 6);
+
+        // one refused right away too
+        source.refused.insert(circles.at(1).identifier());
+        QVERIFY(source.startMonitoring(circles.at(1)));
+        QCOMPARE(source.registered(), QStringLiteral("0 2"));
+
+        // the polled monitors report their own events
+        QSignalSpy entered(&source, &QGeoAreaMonitorSource::areaEntered);
+        positions.setPosition(QGeoCoordinate(0.75, 1.25));
+        QTRY_VERIFY(!entered.isEmpty());
+        QCOMPARE(entered.first().at(0).value<QGeoAreaMonitorInfo>(), rectangle);
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_QGeoAreaMonitorRegions)
+#include "tst_qgeoareamonitorregions.moc"
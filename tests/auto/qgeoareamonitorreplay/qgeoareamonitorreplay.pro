@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoareamonitorreplay
+
+SOURCES += tst_qgeoareamonitorreplay.cpp
+
+QT += positioning-private testlib
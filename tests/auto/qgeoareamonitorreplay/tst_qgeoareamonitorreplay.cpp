@@ -0,0 +1,183 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtPositioning/qgeocircle.h>
+#include <QtPositioning/qgeorectangle.h>
+#include <QtPositioning/private/qgeoareamonitorreplay_p.h>
+
+QT_USE_NAMESPACE
+
+typedef QGeoAreaMonitorReplay Replay;
+
+class tst_QGeoAreaMonitorReplay : public QObject
+{
+    Q_OBJECT
+
+private:
+    // positions northwards from the equator, one second and 0.01 degrees apart
+    static QVector<QGeoPositionInfo> track(int count)
+    {
+        const QDateTime start(QDate(2020, 1, 1), QTime(12, 0), Qt::UTC);
+        QVector<QGeoPositionInfo> positions;
+        for (int i = 0; i < count; ++i)
+            positions.append(QGeoPositionInfo(QGeoCoordinate(i * 0.01, 0), start.addSecs(i)));
+        return positions;
+    }
+
+    static QGeoAreaMonitorInfo monitor(const QString &name, const QGeoShape &area)
+    {
+        QGeoAreaMonitorInfo info(name);
+        info.setArea(area);
+        return info;
+    }
+
+    // positions 5 to 10
+    static QGeoRectangle rectangle()
+    {
+        return QGeoRectangle(QGeoCoordinate(0.105, -0.01), QGeoCoordinate(0.045, 0.01));
+    }
+
+    // positions 14 to 16
+    static QGeoCircle circle()
+    {
+        return QGeoCircle(QGeoCoordinate(0.15, 0), 1500);
+    }
+
+    static QString describe(const QVector<Replay::Event> &events)
+    {
+        QStringList list;
+        for (const Replay::Event &event : events) {
+            const char *type = event.type == Replay::AreaEntered ? "entered"
+                             : event.type == Replay::AreaExited ? "exited" : "expired";
+            list.append(QStringLiteral("%1 %2 %3").arg(event.monitor.name(),
+                                                      QLatin1String(type)).arg(event.position));
+        }
+        return list.join(QLatin1String(", "));
+    }
+
+private slots:
+    void enterAndExit_data()
+    {
+        QTest::addColumn<int>("chunkSize");
+        QTest::newRow("one chunk") << int(Replay::DefaultChunkSize);
+        QTest::newRow("chunks of 2") << 2;
+        QTest::newRow("chunks of 3") << 3;
+        QTest::newRow("chunks of 5") << 5;
+    }
+
+    void enterAndExit()
+    {
+        QFETCH(int, chunkSize);
+
+        Replay replay;
+        replay.setChunkSize(chunkSize);
+        QVERIFY(replay.addMonitor(monitor("rectangle", rectangle())));
+        QVERIFY(replay.addMonitor(monitor("circle", circle())));
+        QVERIFY(!replay.addMonitor(QGeoAreaMonitorInfo("invalid")));
+        QCOMPARE(replay.monitorCount(), 2);
+
+        QCOMPARE(describe(replay.replay(track(20))),
+                 QStringLiteral("rectangle entered 5, rectangle exited 11, "
+                                "circle entered 14, circle exited 17"));
+
+        // a track ending inside an area has no exit
+        QCOMPARE(describe(replay.replay(track(8))), QStringLiteral("rectangle entered 5"));
+    }
+
+    void singleShot()
+    {
+        Replay replay;
+        replay.setChunkSize(4);
+        QVERIFY(replay.addMonitor(monitor("entered", rectangle()), Replay::SingleShotEntered));
+        QVERIFY(replay.addMonitor(monitor("exited", circle()), Replay::SingleShotExited));
+
+        // back and forth through both areas
+        QVector<QGeoPositionInfo> positions = track(20);
+        QVector<QGeoPositionInfo> back = positions;
+        std::reverse(back.begin(), back.end());
+        positions += back;
+
+        QCOMPARE(describe(replay.replay(positions)),
+                 QStringLiteral("entered entered 5, exited entered 14, exited exited 17"));
+    }
+
+    void expiry()
+    {
+        const QVector<QGeoPositionInfo> positions = track(20);
+
+        Replay replay;
+        replay.setChunkSize(3);
+        QGeoAreaMonitorInfo expiring = monitor("rectangle", rectangle());
+        expiring.setExpiration(positions.at(8).timestamp().addMSecs(-500));
+        QVERIFY(replay.addMonitor(expiring));
+        QGeoAreaMonitorInfo expired = monitor("circle", circle());
+        expired.setExpiration(positions.first().timestamp().addSecs(-1));
+        QVERIFY(replay.addMonitor(expired));
+
+        QCOMPARE(describe(replay.replay(positions)),
+                 QStringLiteral("circle expired 0, rectangle entered 5, rectangle expired 8"));
+    }
+
+    void invalidPositions()
+    {
+        QVector<QGeoPositionInfo> positions = track(20);
+        positions[7].setCoordinate(QGeoCoordinate());
+
+        Replay replay;
+        QVERIFY(replay.addMonitor(monitor("rectangle", rectangle())));
+        QCOMPARE(describe(replay.replay(positions)),
+                 QStringLiteral("rectangle entered 5, rectangle exited 7, "
+                                "rectangle entered 8, rectangle exited 11"));
+    }
+
+    void replaceAndRemove()
+    {
+        Replay replay;
+        const QGeoAreaMonitorInfo area = monitor("area", rectangle());
+        QVERIFY(replay.addMonitor(area));
+        const QGeoAreaMonitorInfo other = monitor("other", rectangle());
+        QVERIFY(replay.addMonitor(other));
+
+        // same identifier
+        QGeoAreaMonitorInfo replaced = area;
+        replaced.setArea(circle());
+        QVERIFY(replay.addMonitor(replaced));
+        QCOMPARE(replay.monitorCount(), 2);
+
+        QVERIFY(replay.removeMonitor(other.identifier()));
+        QVERIFY(!replay.removeMonitor(other.identifier()));
+        QCOMPARE(replay.monitorCount(), 1);
+        QCOMPARE(describe(replay.replay(track(20))),
+                 QStringLiteral("area entered 14, area exited 17"));
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_QGeoAreaMonitorReplay)
+#include "tst_qgeoareamonitorreplay.moc"
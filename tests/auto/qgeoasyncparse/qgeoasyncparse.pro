@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qgeoasyncparse
+
+SOURCES += tst_qgeoasyncparse.cpp
+
+QT += location-private testlib
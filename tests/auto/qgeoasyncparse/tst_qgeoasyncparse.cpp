@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtLocation/private/qgeoasyncparse_p.h>
+#include <QtLocation/QGeoCodeReply>
+#include <QtTest/QtTest>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoAsyncParse : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parse();
+    void replyInThread();
+    void abortWhileParsing();
+    void destroyWhileParsing();
+};
+
+void tst_QGeoAsyncParse::parse()
+{
+    QGeoCodeReply reply;
+    const QThread *mainThread = QThread::currentThread();
+    const QThread *parseThread = nullptr;
+    int result = 0;
+    qParseReplyAsync(&reply, [&parseThread](const QGeoParseCancellation &) {
+        parseThread = QThread::currentThread();
+        return 42;
+    }, [&result, mainThread](int parsed) {
+        QCOMPARE(QThread::currentThread(), mainThread);
+        result = parsed;
+    });
+    QTRY_COMPARE(result, 42);
+    QVERIFY(parseThread != mainThread);
+}
+
+// The result goes to the thread the reply lives in, not to the main thread
+void tst_QGeoAsyncParse::replyInThread()
+{
+    QThread thread;
+    thread.start();
+    QObject context;
+    context.moveToThread(&thread);
+
+    QGeoCodeReply *reply = nullptr;
+    QAtomicPointer<QThread> doneThread;
+    QAtomicInt result;
+    QMetaObject::invokeMethod(&context, [&]() {
+        reply = new QGeoCodeReply;
+        qParseReplyAsync(reply, [](const QGeoParseCancellation &) {
+            return 42;
+        }, [&doneThread, &result](int parsed) {
+            result.storeRelease(parsed);
+            doneThread.storeRelease(QThread::currentThread());
+        });
+    }, Qt::BlockingQueuedConnection);
+
+    QTRY_VERIFY(doneThread.loadAcquire());
+    QCOMPARE(doneThread.loadAcquire(), &thread);
+    QCOMPARE(result.loadAcquire(), 42);
+
+    // and not at all once it is destroyed there
+    doneThread.storeRelease(nullptr);
+    QSemaphore proceed;
+    QMetaObject::invokeMethod(&context, [&]() {
+        qParseReplyAsync(reply, [&proceed](const QGeoParseCancellation &) {
+            proceed.acquire();
+            return 1;
+        }, [&doneThread](int) {
+            doneThread.storeRelease(QThread::currentThread());
+        });
+        delete reply;
+    }, Qt::BlockingQueuedConnection);
+    proceed.release();
+    QThreadPool::globalInstance()->waitForDone();
+    QTest::qWait(50);
+    QVERIFY(!doneThread.loadAcquire());
+
+    thread.quit();
+    QVERIFY(thread.wait());
+}
+
+void tst_QGeoAsyncParse::abortWhileParsing()
+{
+    QGeoCodeReply reply;
+    QSemaphore started;
+    QSemaphore proceed;
+    bool sawCancel = false;
+    bool done = false;
+    const QGeoParseCancellation cancellation =
+            qParseReplyAsync(&reply, [&](const QGeoParseCancellation &c) {
+        started.release();
+        proceed.acquire();
+        sawCancel = c.isCancelled();
+        return 1;
+    }, [&done](int) {
+        done = true;
+    });
+
+    started.acquire();
+    reply.abort();
+    QVERIFY(cancellation.isCancelled());
+    proceed.release();
+    QThreadPool::globalInstance()->waitForDone();
+    QCoreApplication::processEvents();
+
+    QVERIFY(sawCancel);
+    QVERIFY(!done);
+}
+
+void tst_QGeoAsyncParse::destroyWhileParsing()
+{
+    QGeoCodeReply *reply = new QGeoCodeReply;
+    QSemaphore proceed;
+    bool done = false;
+    const QGeoParseCancellation cancellation =
+            qParseReplyAsync(reply, [&proceed](const QGeoParseCancellation &) {
+        proceed.acquire();
+        return 1;
+    }, [&done](int) {
+        done = true;
+    });
+
+    delete reply;
+    QVERIFY(cancellation.isCancelled());
+    proceed.release();
+    QThreadPool::globalInstance()->waitForDone();
+    QCoreApplication::processEvents();
+
+    QVERIFY(!done);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoAsyncParse)
+#include "tst_qgeoasyncparse.moc"
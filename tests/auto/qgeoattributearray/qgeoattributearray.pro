@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoattributearray
+
+SOURCES += tst_qgeoattributearray.cpp
+
+QT += positioning positioning-private testlib
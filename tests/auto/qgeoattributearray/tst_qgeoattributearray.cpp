@@ -0,0 +1,245 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/positioning
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QGeoSatelliteInfo>
+#include <QtPositioning/private/qgeoattributearray_p.h>
+
+QT_USE_NAMESPACE
+
+enum TestAttribute { First, Second, Third, Last };
+typedef QGeoAttributeArray<TestAttribute, Last + 1> TestArray;
+
+class tst_QGeoAttributeArray : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertRemove();
+    void keys();
+    void compare();
+    void outOfRange();
+    void hash();
+    void dataStream_data();
+    void dataStream();
+    void satelliteDataStream();
+};
+
+void tst_QGeoAttributeArray::insertRemove()
+{
+    TestArray array;
+    QVERIFY(array.isEmpty());
+    QVERIFY(!array.contains(First));
+    QCOMPARE(array.value(First, -1.0), -1.0);
+
+    array.insert(Third, 3.5);
+    array.insert(First, 0.0);
+    QVERIFY(!array.isEmpty());
+    QVERIFY(array.contains(First));
+    QVERIFY(!array.contains(Second));
+    QCOMPARE(array.value(Third, -1.0), 3.5);
+    QCOMPARE(array.value(First, -1.0), 0.0);
+
+    array.insert(Third, 4.5);
+    QCOMPARE(array.value(Third, -1.0), 4.5);
+
+    array.remove(Third);
+    QVERIFY(!array.contains(Third));
+    QCOMPARE(array.value(Third, -1.0), -1.0);
+    array.remove(Second); // not there
+    QVERIFY(array.contains(First));
+
+    array.clear();
+    QVERIFY(array.isEmpty());
+    QVERIFY(!array.contains(First));
+}
+
+void tst_QGeoAttributeArray::keys()
+{
+    TestArray array;
+    QVERIFY(array.keys().isEmpty());
+    array.insert(Last, 1.0);
+    array.insert(First, 1.0);
+    array.insert(Third, 1.0);
+    QCOMPARE(array.keys(), QList<TestAttribute>({ First, Third, Last }));
+}
+
+// Values that are not set do not count, removed ones included
+void tst_QGeoAttributeArray::compare()
+{
+    TestArray a, b;
+    QVERIFY(a == b);
+    a.insert(Second, 2.0);
+    QVERIFY(a != b);
+    b.insert(Second, 2.5);
+    QVERIFY(a != b);
+    b.insert(Second, 2.0);
+    QVERIFY(a == b);
+
+    a.insert(Third, 3.0);
+    a.remove(Third);
+    QVERIFY(a == b);
+    b.insert(First, 1.0);
+    QVERIFY(a != b);
+
+    const TestArray copy = b;
+    QVERIFY(copy == b);
+}
+
+void tst_QGeoAttributeArray::outOfRange()
+{
+    TestArray array;
+    QTest::ignoreMessage(QtWarningMsg, "QGeoAttributeArray: ignoring attribute 4, out of range");
+    array.insert(TestAttribute(Last + 1), 1.0);
+    QTest::ignoreMessage(QtWarningMsg, "QGeoAttributeArray: ignoring attribute -1, out of range");
+    array.insert(TestAttribute(-1), 1.0);
+    QVERIFY(array.isEmpty());
+    QVERIFY(!array.contains(TestAttribute(Last + 1)));
+    QCOMPARE(array.value(TestAttribute(-1), 7.0), 7.0);
+    array.remove(TestAttribute(40));
+    QVERIFY(array.isEmpty());
+
+    // nor are they read from a hash
+    QHash<int, qreal> hash;
+    hash.insert(Second, 2.0);
+    hash.insert(9, 9.0);
+    QTest::ignoreMessage(QtWarningMsg, "QGeoAttributeArray: ignoring attribute 9, out of range");
+    array.setHash(hash);
+    QCOMPARE(array.keys(), QList<TestAttribute>({ Second }));
+}
+
+void tst_QGeoAttributeArray::hash()
+{
+    TestArray array;
+    QVERIFY(array.toHash<int>().isEmpty());
+    array.insert(First, 1.0);
+    array.insert(Last, -4.0);
+
+    const QHash<TestAttribute, qreal> hash = array.toHash<TestAttribute>();
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(First), 1.0);
+    QCOMPARE(hash.value(Last), -4.0);
+
+    // replaces what was there
+    TestArray other;
+    other.insert(Second, 2.0);
+    other.setHash(hash);
+    QVERIFY(other == array);
+    other.setHash(QHash<TestAttribute, qreal>());
+    QVERIFY(other.isEmpty());
+}
+
+void tst_QGeoAttributeArray::dataStream_data()
+{
+    QTest::addColumn<QList<int>>("attributes");
+
+    QTest::newRow("none") << QList<int>();
+    QTest::newRow("one") << QList<int>({ QGeoPositionInfo::Direction });
+    QTest::newRow("all") << QList<int>({ QGeoPositionInfo::Direction, QGeoPositionInfo::GroundSpeed,
+                                         QGeoPositionInfo::VerticalSpeed, QGeoPositionInfo::MagneticVariation,
+                                         QGeoPositionInfo::HorizontalAccuracy, QGeoPositionInfo::VerticalAccuracy });
+}
+
+// QGeoPositionInfo streams its attributes as the QHash of earlier versions
+void tst_QGeoAttributeArray::dataStream()
+{
+    QFETCH(QList<int>, attributes);
+
+    QGeoPositionInfo info(QGeoCoordinate(1.0, 2.0), QDateTime::fromMSecsSinceEpoch(1000, Qt::UTC));
+    QHash<QGeoPositionInfo::Attribute, qreal> expected;
+    for (int attribute : qAsConst(attributes)) {
+        info.setAttribute(QGeoPositionInfo::Attribute(attribute), attribute + 0.5);
+        expected.insert(QGeoPositionInfo::Attribute(attribute), attribute + 0.5);
+    }
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << info;
+    }
+
+    // as written before the array, a QHash after the coordinate
+    {
+        QDataStream in(data);
+        QDateTime timestamp;
+        QGeoCoordinate coordinate;
+        QHash<QGeoPositionInfo::Attribute, qreal> hash;
+        in >> timestamp >> coordinate >> hash;
+        QCOMPARE(in.status(), QDataStream::Ok);
+        QCOMPARE(hash, expected);
+    }
+
+    // and read back
+    QDataStream in(data);
+    QGeoPositionInfo read;
+    in >> read;
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QCOMPARE(read, info);
+    for (int attribute : qAsConst(attributes))
+        QCOMPARE(read.attribute(QGeoPositionInfo::Attribute(attribute)), attribute + 0.5);
+
+    // a stream of an earlier version reads the same
+    QByteArray legacy;
+    {
+        QDataStream out(&legacy, QIODevice::WriteOnly);
+        out << info.timestamp() << info.coordinate() << expected;
+    }
+    QDataStream legacyIn(legacy);
+    QGeoPositionInfo legacyRead;
+    legacyIn >> legacyRead;
+    QCOMPARE(legacyRead, info);
+}
+
+void tst_QGeoAttributeArray::satelliteDataStream()
+{
+    QGeoSatelliteInfo info;
+    info.setSatelliteSystem(QGeoSatelliteInfo::GPS);
+    info.setSatelliteIdentifier(12);
+    info.setSignalStrength(30);
+    info.setAttribute(QGeoSatelliteInfo::Azimuth, 180.0);
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << info;
+    }
+    QDataStream in(data);
+    QGeoSatelliteInfo read;
+    in >> read;
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QCOMPARE(read, info);
+    QVERIFY(!read.hasAttribute(QGeoSatelliteInfo::Elevation));
+    QCOMPARE(read.attribute(QGeoSatelliteInfo::Azimuth), 180.0);
+}
+
+QTEST_MAIN(tst_QGeoAttributeArray)
+
+#include "tst_qgeoattributearray.moc"
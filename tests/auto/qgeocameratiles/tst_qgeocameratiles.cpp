@@ -70,6 +70,8 @@ private slots:
     void tilesPositions();
     void tilesPositions_data();
     void test_tilted_frustum();
+    void tilesIncremental();
+    void tilesDistanceLOD();
 };
 
 void tst_QGeoCameraTiles::row(const PositionTestInfo &pti, int xOffset, int yOffset, int tileX, int tileY, int tileW, int tileH)
@@ -140,6 +142,101 @@ void tst_QGeoCameraTiles::test_tilted_frustum()
     QCOMPARE(ct.createTiles(), ctFull.createTiles());
 }
 
+void tst_QGeoCameraTiles::tilesIncremental()
+{
+    QGeoCameraData camera;
+    camera.setZoomLevel(4.0);
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(16);
+    ct.setScreenSize(QSize(64, 48));
+    ct.setCameraData(camera);
+
+    QSet<QGeoTileSpec> added;
+    QSet<QGeoTileSpec> removed;
+    QSet<QGeoTileSpec> tiles = ct.createTiles(&added, &removed);
+    QCOMPARE(added, tiles);
+    QVERIFY(removed.isEmpty());
+
+    // No change, no delta
+    ct.createTiles(&added, &removed);
+    QVERIFY(added.isEmpty());
+    QVERIFY(removed.isEmpty());
+
+    // Pan in small steps, comparing against a freshly computed footprint
+    for (int i = 1; i <= 40; ++i) {
+        QGeoCameraData moved = camera;
+        moved.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + i * 0.004, 0.5 - i * 0.002)));
+        ct.setCameraData(moved);
+
+        QGeoCameraTiles reference;
+        reference.setTileSize(16);
+        reference.setScreenSize(QSize(64, 48));
+        reference.setCameraData(moved);
+
+        const QSet<QGeoTileSpec> previous = tiles;
+        tiles = ct.createTiles(&added, &removed);
+        QCOMPARE(tiles, reference.createTiles());
+        QCOMPARE(added, tiles - previous);
+        QCOMPARE(removed, previous - tiles);
+    }
+
+    // Plain createTiles() calls in between must not lose changes
+    const QSet<QGeoTileSpec> previous = tiles;
+    QGeoCameraData zoomed = camera;
+    zoomed.setZoomLevel(5.0);
+    ct.setCameraData(zoomed);
+    ct.createTiles();
+    tiles = ct.createTiles(&added, &removed);
+    QCOMPARE(added, tiles - previous);
+    QCOMPARE(removed, previous - tiles);
+}
+
+void tst_QGeoCameraTiles::tilesDistanceLOD()
+{
+    QGeoCameraData camera;
+    camera.setZoomLevel(10.0);
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(256);
+    ct.setScreenSize(QSize(1024, 768));
+    ct.setCameraData(camera);
+    const QSet<QGeoTileSpec> straight = ct.createTiles();
+
+    // Without tilt, nothing is far enough to change
+    ct.setDistanceLOD(true);
+    QCOMPARE(ct.createTiles(), straight);
+
+    camera.setTilt(60.0);
+    ct.setDistanceLOD(false);
+    ct.setCameraData(camera);
+    const QSet<QGeoTileSpec> full = ct.createTiles();
+    ct.setDistanceLOD(true);
+    const QSet<QGeoTileSpec> lod = ct.createTiles();
+    QVERIFY(lod.size() < full.size());
+
+    // Every tile of the full set is covered by exactly one tile, itself or an ancestor
+    bool lowerZoom = false;
+    for (const QGeoTileSpec &tile : lod) {
+        QVERIFY(tile.zoom() <= 10 && tile.zoom() >= 6);
+        lowerZoom = lowerZoom || tile.zoom() < 10;
+    }
+    QVERIFY(lowerZoom);
+    for (const QGeoTileSpec &tile : full) {
+        int covering = 0;
+        for (int shift = 0; shift <= 4; ++shift) {
+            QGeoTileSpec ancestor = tile;
+            ancestor.setZoom(tile.zoom() - shift);
+            ancestor.setX(tile.x() >> shift);
+            ancestor.setY(tile.y() >> shift);
+            covering += lod.contains(ancestor) ? 1 : 0;
+        }
+        QCOMPARE(covering, 1);
+    }
+}
+
 void tst_QGeoCameraTiles::tilesPlugin()
 {
     QGeoCameraData camera;
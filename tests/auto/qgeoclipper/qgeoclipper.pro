@@ -0,0 +1,11 @@
+CONFIG += testcase
+TARGET = tst_qgeoclipper
+
+clipper.path = ../../../src/3rdparty/clipper
+INCLUDEPATH += $$clipper.path
+
+HEADERS += $$clipper.path/clipper.h
+SOURCES += tst_qgeoclipper.cpp \
+           $$clipper.path/clipper.cpp
+
+QT += testlib
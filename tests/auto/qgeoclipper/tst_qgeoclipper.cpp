@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtTest/QtTest>
+#include "clipper.h"
+#include <cmath>
+
+QT_USE_NAMESPACE
+
+using namespace QtClipperLib;
+
+Q_DECLARE_METATYPE(QtClipperLib::Path)
+Q_DECLARE_METATYPE(QtClipperLib::ClipType)
+
+class tst_QGeoClipper : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void reuseMatchesFresh_data();
+    void reuseMatchesFresh();
+    void repeatedExecute();
+    void largeExecution();
+
+private:
+    static Path circle(int vertices, cInt radius, cInt cx = 0, cInt cy = 0);
+    static Path star(int spikes, cInt outer, cInt inner);
+    static Paths clip(Clipper &clipper, const Path &subject, const Path &clipPath, ClipType type);
+    static double area(const Paths &paths);
+};
+
+Path tst_QGeoClipper::circle(int vertices, cInt radius, cInt cx, cInt cy)
+{
+    Path path;
+    for (int i = 0; i < vertices; ++i) {
+        const double a = 2 * M_PI * i / vertices;
+        path.push_back(IntPoint(cx + cInt(std::round(radius * std::cos(a))),
+                                cy + cInt(std::round(radius * std::sin(a)))));
+    }
+    return path;
+}
+
+// A self-intersecting star: every spike crosses its neighbours, so executions
+// produce many intersections and joins
+Path tst_QGeoClipper::star(int spikes, cInt outer, cInt inner)
+{
+    Path path;
+    for (int i = 0; i < spikes * 2; ++i) {
+        const double a = M_PI * i * 3 / spikes;
+        const cInt r = (i % 2) ? inner : outer;
+        path.push_back(IntPoint(cInt(std::round(r * std::cos(a))), cInt(std::round(r * std::sin(a)))));
+    }
+    return path;
+}
+
+Paths tst_QGeoClipper::clip(Clipper &clipper, const Path &subject, const Path &clipPath, ClipType type)
+{
+    clipper.Clear();
+    clipper.AddPath(subject, ptSubject, true);
+    clipper.AddPath(clipPath, ptClip, true);
+    Paths result;
+    if (!clipper.Execute(type, result, pftNonZero, pftNonZero))
+        return Paths();
+    return result;
+}
+
+double tst_QGeoClipper::area(const Paths &paths)
+{
+    double total = 0;
+    for (const Path &path : paths)
+        total += Area(path);
+    return total;
+}
+
+void tst_QGeoClipper::reuseMatchesFresh_data()
+{
+    QTest::addColumn<Path>("subject");
+    QTest::addColumn<Path>("clipPath");
+    QTest::addColumn<ClipType>("type");
+
+    QTest::newRow("circles intersection") << circle(64, 100000) << circle(64, 100000, 50000) << ctIntersection;
+    QTest::newRow("circles union") << circle(64, 100000) << circle(64, 100000, 50000) << ctUnion;
+    QTest::newRow("circles difference") << circle(64, 100000) << circle(64, 100000, 50000) << ctDifference;
+    QTest::newRow("circles xor") << circle(64, 100000) << circle(64, 100000, 50000) << ctXor;
+    QTest::newRow("hole") << circle(360, 1000000) << circle(90, 200000) << ctDifference;
+    QTest::newRow("star intersection") << star(37, 1000000, 300000) << circle(200, 600000) << ctIntersection;
+    QTest::newRow("star xor") << star(37, 1000000, 300000) << star(23, 800000, 500000) << ctXor;
+    QTest::newRow("disjoint") << circle(32, 1000) << circle(32, 1000, 100000) << ctIntersection;
+}
+
+void tst_QGeoClipper::reuseMatchesFresh()
+{
+    QFETCH(Path, subject);
+    QFETCH(Path, clipPath);
+    QFETCH(ClipType, type);
+
+    Clipper fresh;
+    const Paths expected = clip(fresh, subject, clipPath, type);
+
+    // One clipper warmed up by unrelated executions, whose nodes went back to
+    // its pools, must give the result of a brand new one
+    Clipper reused;
+    for (int round = 0; round < 3; ++round) {
+        clip(reused, star(41, 900000, 100000), circle(500, 700000, 10000), ctXor);
+        clip(reused, circle(7, 10), circle(7, 10, 5), ctUnion);
+        QCOMPARE(clip(reused, subject, clipPath, type), expected);
+    }
+}
+
+void tst_QGeoClipper::repeatedExecute()
+{
+    // Execute may run several times on the same input without a Clear()
+    const Path subject = star(29, 1000000, 400000);
+    const Path clipPath = circle(120, 700000, 150000);
+    const ClipType types[] = { ctIntersection, ctUnion, ctDifference, ctXor };
+
+    Clipper clipper;
+    clipper.AddPath(subject, ptSubject, true);
+    clipper.AddPath(clipPath, ptClip, true);
+    for (int round = 0; round < 2; ++round) {
+        for (ClipType type : types) {
+            Paths result;
+            QVERIFY(clipper.Execute(type, result, pftNonZero, pftNonZero));
+            Clipper fresh;
+            QCOMPARE(result, clip(fresh, subject, clipPath, type));
+        }
+    }
+}
+
+void tst_QGeoClipper::largeExecution()
+{
+    // Enough output points to take many blocks from the pools
+    const int vertices = 5000;
+    const cInt radius = 100000000;
+    Clipper clipper;
+    for (int round = 0; round < 3; ++round) {
+        const Paths ring = clip(clipper, circle(vertices, radius), circle(vertices, radius / 2), ctDifference);
+        QCOMPARE(int(ring.size()), 2);
+        QCOMPARE(int(ring[0].size() + ring[1].size()), 2 * vertices);
+        const double expected = M_PI * 0.75 * double(radius) * double(radius);
+        QVERIFY(std::abs(area(ring) - expected) < expected * 1e-4);
+
+        // A small execution right after still gets sane nodes
+        const Paths small = clip(clipper, circle(8, 1000), circle(8, 1000, 1000), ctIntersection);
+        QCOMPARE(int(small.size()), 1);
+        QVERIFY(area(small) > 0);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoClipper)
+
+#include "tst_qgeoclipper.moc"
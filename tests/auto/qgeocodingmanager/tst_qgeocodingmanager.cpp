@@ -178,6 +178,215 @@ void tst_QGeoCodingManager::reverseGeocode()
 
 }
 
+void tst_QGeoCodingManager::reverseGeocodeBatch()
+{
+    QList<QGeoCoordinate> coordinates;
+    coordinates << QGeoCoordinate(34.34, 56.65) << QGeoCoordinate(52.52, 13.40)
+                << QGeoCoordinate(-33.87, 151.21);
+
+    QGeoCodeBatchReply *reply = qgeocodingmanager->reverseGeocode(coordinates);
+    QSignalSpy itemFinished(reply, SIGNAL(itemFinished(int)));
+    QSignalSpy finished(reply, SIGNAL(finished()));
+    QVERIFY(!reply->isFinished());
+    QCOMPARE(reply->count(), coordinates.size());
+
+    QTRY_COMPARE(finished.count(), 1);
+    QCOMPARE(itemFinished.count(), coordinates.size());
+    QCOMPARE(reply->finishedCount(), coordinates.size());
+    QCOMPARE(reply->error(), QGeoCodeReply::NoError);
+    for (int i = 0; i < coordinates.size(); ++i) {
+        QVERIFY(reply->isItemFinished(i));
+        QCOMPARE(reply->itemError(i), QGeoCodeReply::NoError);
+    }
+
+    // One per coordinate and one for the batch
+    QCOMPARE(signalfinished->count(), coordinates.size() + 1);
+    QCOMPARE(signalerror->count(), 0);
 
-QTEST_GUILESS_MAIN(tst_QGeoCodingManager)
+    delete reply;
+}
+
+// An engine with a batch request answers the whole list
+void tst_QGeoCodingManager::engineReverseGeocodeBatch()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("gc_batch"), true);
+    QGeoServiceProvider provider(QStringLiteral("geocode.test.plugin"), parameters, true);
+    QGeoCodingManager *manager = provider.geocodingManager();
+    QVERIFY(manager);
+    QSignalSpy managerFinished(manager, SIGNAL(finished(QGeoCodeReply*)));
+
+    const QList<QGeoCoordinate> coordinates { QGeoCoordinate(34.34, 56.65), QGeoCoordinate(52.52, 13.40) };
+    QScopedPointer<QGeoCodeBatchReply> reply(manager->reverseGeocode(coordinates));
+    QVERIFY(reply);
+    QCOMPARE(reply->count(), coordinates.size());
+    QSignalSpy itemFinished(reply.data(), SIGNAL(itemFinished(int)));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(itemFinished.count(), coordinates.size());
+    QCOMPARE(reply->error(), QGeoCodeReply::NoError);
+    for (int i = 0; i < coordinates.size(); ++i) {
+        QCOMPARE(reply->itemLocations(i).size(), 1);
+        QCOMPARE(reply->itemLocations(i).first().address().text(), QStringLiteral("batch"));
+        QCOMPARE(reply->itemLocations(i).first().coordinate(), coordinates.at(i));
+    }
+
+    // None of the coordinates went through reverseGeocode()
+    QCOMPARE(managerFinished.count(), 0);
+}
+
+// Replies of this provider finish after 50 ms, with the number of requests
+// made to the engine so far as the address text
+static QGeoServiceProvider *cachingProvider(int ttl = 300)
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("geocode.test.plugin.geocoding.cache.size"), 10);
+    parameters.insert(QStringLiteral("geocode.test.plugin.geocoding.cache.ttl"), ttl);
+    parameters.insert(QStringLiteral("gc_delay"), 50);
+    return new QGeoServiceProvider(QStringLiteral("geocode.test.plugin"), parameters, true);
+}
+
+static QString requestNumber(QGeoCodeReply *reply)
+{
+    if (!QTest::qWaitFor([reply]() { return reply->isFinished(); }, 5000))
+        return QStringLiteral("unfinished");
+    if (reply->error() != QGeoCodeReply::NoError || reply->locations().isEmpty())
+        return QString();
+    return reply->locations().first().address().text();
+}
+
+static QString result(QGeoCodeReply *reply)
+{
+    QScopedPointer<QGeoCodeReply> owner(reply);
+    return requestNumber(reply);
+}
 
+void tst_QGeoCodingManager::cacheKey()
+{
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider());
+    QGeoCodingManager *manager = provider->geocodingManager();
+    QVERIFY(manager);
+
+    // Reverse geocoding requests in the same geohash cell share a result
+    const QGeoCoordinate coordinate(52.520008, 13.404954);
+    QCOMPARE(result(manager->reverseGeocode(coordinate)), QStringLiteral("1"));
+    QScopedPointer<QGeoCodeReply> cached(manager->reverseGeocode(QGeoCoordinate(52.520009, 13.404955)));
+    QVERIFY(cached->isFinished());
+    QCOMPARE(requestNumber(cached.data()), QStringLiteral("1"));
+    QCOMPARE(result(manager->reverseGeocode(QGeoCoordinate(52.521, 13.404954))), QStringLiteral("2"));
+
+    // Search strings and addresses match regardless of case and whitespace
+    QCOMPARE(result(manager->geocode(QStringLiteral("Berlin Mitte"), 10, 0)), QStringLiteral("3"));
+    QCOMPARE(result(manager->geocode(QStringLiteral("  berlin   MITTE "), 10, 0)), QStringLiteral("3"));
+    QCOMPARE(result(manager->geocode(QStringLiteral("Berlin Mitte"), 5, 0)), QStringLiteral("4"));
+    QGeoAddress address;
+    address.setCity(QStringLiteral("Berlin"));
+    QCOMPARE(result(manager->geocode(address)), QStringLiteral("5"));
+    address.setCity(QStringLiteral(" BERLIN"));
+    QCOMPARE(result(manager->geocode(address)), QStringLiteral("5"));
+    address.setStreet(QStringLiteral("Invalidenstrasse"));
+    QCOMPARE(result(manager->geocode(address)), QStringLiteral("6"));
+
+    // Bounds and the locale are part of the key
+    const QGeoRectangle bounds(QGeoCoordinate(53.0, 13.0), QGeoCoordinate(52.0, 14.0));
+    QCOMPARE(result(manager->reverseGeocode(coordinate, bounds)), QStringLiteral("7"));
+    manager->setLocale(QLocale(QLocale::French, QLocale::France));
+    QCOMPARE(result(manager->reverseGeocode(coordinate)), QStringLiteral("8"));
+}
+
+void tst_QGeoCodingManager::cacheExpiry()
+{
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider(1));
+    QGeoCodingManager *manager = provider->geocodingManager();
+    QVERIFY(manager);
+
+    const QGeoCoordinate coordinate(52.520008, 13.404954);
+    QCOMPARE(result(manager->reverseGeocode(coordinate)), QStringLiteral("1"));
+    QCOMPARE(result(manager->reverseGeocode(coordinate)), QStringLiteral("1"));
+    QTest::qWait(1100);
+    QCOMPARE(result(manager->reverseGeocode(coordinate)), QStringLiteral("2"));
+    QCOMPARE(result(manager->reverseGeocode(coordinate)), QStringLiteral("2"));
+}
+
+void tst_QGeoCodingManager::sharedRequest()
+{
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider());
+    QGeoCodingManager *manager = provider->geocodingManager();
+    QVERIFY(manager);
+    QSignalSpy finished(manager, SIGNAL(finished(QGeoCodeReply*)));
+
+    // An identical request made while one is in flight shares its result
+    const QGeoCoordinate coordinate(52.520008, 13.404954);
+    QScopedPointer<QGeoCodeReply> first(manager->reverseGeocode(coordinate));
+    QScopedPointer<QGeoCodeReply> second(manager->reverseGeocode(coordinate));
+    QVERIFY(!first->isFinished());
+    QVERIFY(!second->isFinished());
+    QSignalSpy secondFinished(second.data(), SIGNAL(finished()));
+
+    QCOMPARE(requestNumber(first.data()), QStringLiteral("1"));
+    QCOMPARE(requestNumber(second.data()), QStringLiteral("1"));
+    QCOMPARE(secondFinished.count(), 1);
+    QCOMPARE(second->error(), QGeoCodeReply::NoError);
+    QCOMPARE(second->locations(), first->locations());
+    QTRY_COMPARE(finished.count(), 2);
+
+    // Only one request reached the engine
+    QCOMPARE(result(manager->reverseGeocode(QGeoCoordinate(10.0, 10.0))), QStringLiteral("2"));
+}
+
+void tst_QGeoCodingManager::abortedSharedRequest()
+{
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider());
+    QGeoCodingManager *manager = provider->geocodingManager();
+    QVERIFY(manager);
+    QSignalSpy errors(manager, SIGNAL(error(QGeoCodeReply*,QGeoCodeReply::Error,QString)));
+
+    const QGeoCoordinate coordinate(52.520008, 13.404954);
+    QScopedPointer<QGeoCodeReply> first(manager->reverseGeocode(coordinate));
+    QScopedPointer<QGeoCodeReply> second(manager->reverseGeocode(coordinate));
+    QVERIFY(!second->isFinished());
+
+    // The request sharing the aborted one fails, instead of waiting forever
+    // or seeing an empty result
+    first->abort();
+    QTRY_VERIFY(second->isFinished());
+    QCOMPARE(second->error(), QGeoCodeReply::CommunicationError);
+    QVERIFY(second->locations().isEmpty());
+    QCOMPARE(errors.count(), 1);
+    QCOMPARE(errors.first().first().value<QGeoCodeReply *>(), second.data());
+
+    // Nothing was cached for it
+    QScopedPointer<QGeoCodeReply> third(manager->reverseGeocode(coordinate));
+    QVERIFY(!third->isFinished());
+    QCOMPARE(requestNumber(third.data()), QStringLiteral("2"));
+
+    // Nor when the request is deleted while it runs
+    QScopedPointer<QGeoCodeReply> other(manager->reverseGeocode(QGeoCoordinate(10.0, 10.0)));
+    QScopedPointer<QGeoCodeReply> sharing(manager->reverseGeocode(QGeoCoordinate(10.0, 10.0)));
+    other.reset();
+    QVERIFY(sharing->isFinished());
+    QCOMPARE(sharing->error(), QGeoCodeReply::CommunicationError);
+    QCOMPARE(result(manager->reverseGeocode(QGeoCoordinate(10.0, 10.0))), QStringLiteral("4"));
+}
+
+void tst_QGeoCodingManager::failedRequest()
+{
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider());
+    QGeoCodingManager *manager = provider->geocodingManager();
+    QVERIFY(manager);
+
+    QScopedPointer<QGeoCodeReply> first(manager->geocode(QStringLiteral("error"), 10, 0));
+    QScopedPointer<QGeoCodeReply> second(manager->geocode(QStringLiteral("error"), 10, 0));
+    QTRY_VERIFY(first->isFinished());
+    QTRY_VERIFY(second->isFinished());
+    QCOMPARE(first->error(), QGeoCodeReply::CommunicationError);
+    QCOMPARE(second->error(), QGeoCodeReply::CommunicationError);
+    QCOMPARE(second->errorString(), QStringLiteral("error"));
+
+    // Errors are not cached
+    QScopedPointer<QGeoCodeReply> again(manager->geocode(QStringLiteral("error"), 10, 0));
+    QVERIFY(!again->isFinished());
+    QTRY_VERIFY(again->isFinished());
+    QCOMPARE(result(manager->geocode(QStringLiteral("Berlin"), 10, 0)), QStringLiteral("4"));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoCodingManager)
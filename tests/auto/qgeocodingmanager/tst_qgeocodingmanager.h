@@ -38,6 +38,7 @@
 #include <qgeoserviceprovider.h>
 #include <qgeocodingmanager.h>
 #include <qgeocodereply.h>
+#include <qgeocodebatchreply.h>
 #include <QtPositioning/QGeoRectangle>
 #include <qgeoaddress.h>
 #include <qgeocoordinate.h>
@@ -60,6 +61,13 @@ private Q_SLOTS:
     void search();
     void geocode();
     void reverseGeocode();
+    void reverseGeocodeBatch();
+    void engineReverseGeocodeBatch();
+    void cacheKey();
+    void cacheExpiry();
+    void sharedRequest();
+    void abortedSharedRequest();
+    void failedRequest();
 
 private:
     QGeoServiceProvider *qgeoserviceprovider;
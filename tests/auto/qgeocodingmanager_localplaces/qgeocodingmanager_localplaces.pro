@@ -0,0 +1,13 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeocodingmanager_localplaces
+
+SOURCES += \
+    tst_qgeocodingmanager_localplaces.cpp
+
+OTHER_FILES += \
+    addresses.osm
+
+TESTDATA = $$OTHER_FILES
+
+QT += positioning testlib location
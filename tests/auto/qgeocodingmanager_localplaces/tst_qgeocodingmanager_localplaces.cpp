@@ -0,0 +1,247 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtLocation/QGeoCodeReply>
+#include <QtLocation/QGeoCodingManager>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtPositioning/QGeoAddress>
+#include <QtPositioning/QGeoRectangle>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoCodingManagerLocalPlaces : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void missingFiles();
+    void geocodeText_data();
+    void geocodeText();
+    void geocodeAddress();
+    void geocodeBounds();
+    void paging();
+    void reverseGeocode();
+    void reverseGeocodeBounds();
+    void indexFile();
+
+private:
+    QStringList streets(QGeoCodeReply *reply);
+
+    QGeoServiceProvider *m_provider = nullptr;
+    QGeoCodingManager *m_geocodingManager = nullptr;
+};
+
+void tst_QGeoCodingManagerLocalPlaces::initTestCase()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("localplaces.files"), QFINDTESTDATA("addresses.osm"));
+    m_provider = new QGeoServiceProvider(QStringLiteral("localplaces"), parameters);
+    QCOMPARE(m_provider->error(), QGeoServiceProvider::NoError);
+    m_geocodingManager = m_provider->geocodingManager();
+    QVERIFY(m_geocodingManager);
+}
+
+void tst_QGeoCodingManagerLocalPlaces::cleanupTestCase()
+{
+    delete m_provider;
+}
+
+void tst_QGeoCodingManagerLocalPlaces::missingFiles()
+{
+    QGeoServiceProvider provider(QStringLiteral("localplaces"));
+    QVERIFY(!provider.geocodingManager());
+    QCOMPARE(provider.error(), QGeoServiceProvider::MissingRequiredParameterError);
+
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("localplaces.geocoding.index"),
+                      QStringLiteral("does-not-exist.index"));
+    QGeoServiceProvider missingProvider(QStringLiteral("localplaces"), parameters);
+    QVERIFY(!missingProvider.geocodingManager());
+    QCOMPARE(missingProvider.error(), QGeoServiceProvider::ConnectionError);
+}
+
+void tst_QGeoCodingManagerLocalPlaces::geocodeText_data()
+{
+    QTest::addColumn<QString>("address");
+    QTest::addColumn<QStringList>("streets");
+
+    QTest::newRow("street") << QStringLiteral("karl johans gate")
+                            << (QStringList() << QStringLiteral("Karl Johans gate 1")
+                                              << QStringLiteral("Karl Johans gate 2")
+                                              << QStringLiteral("Karl Johans gate 3"));
+    QTest::newRow("house number") << QStringLiteral("Karl Johans gate 2, Oslo")
+                                  << (QStringList() << QStringLiteral("Karl Johans gate 2"));
+    QTest::newRow("postal code") << QStringLiteral("0154 OSLO")
+                                 << (QStringList() << QStringLiteral("Karl Johans gate 1")
+                                                   << QStringLiteral("Karl Johans gate 2"));
+    QTest::newRow("city") << QStringLiteral("bergen")
+                          << (QStringList() << QStringLiteral("Bryggen 1"));
+    QTest::newRow("no match") << QStringLiteral("Storgata 1") << QStringList();
+    QTest::newRow("empty") << QString() << QStringList();
+}
+
+void tst_QGeoCodingManagerLocalPlaces::geocodeText()
+{
+    QFETCH(QString, address);
+    QFETCH(QStringList, streets);
+
+    QCOMPARE(this->streets(m_geocodingManager->geocode(address)), streets);
+}
+
+void tst_QGeoCodingManagerLocalPlaces::geocodeAddress()
+{
+    QGeoAddress address;
+    address.setStreet(QStringLiteral("Storgata 10"));
+    address.setCity(QStringLiteral("Oslo"));
+    // the addresses have no country, so it does not restrict them
+    address.setCountry(QStringLiteral("Norway"));
+
+    QGeoCodeReply *reply = m_geocodingManager->geocode(address);
+    QSignalSpy finishedSpy(reply, &QGeoCodeReply::finished);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(reply->error(), QGeoCodeReply::NoError);
+    QCOMPARE(reply->locations().count(), 1);
+    const QGeoLocation location = reply->locations().first();
+    QCOMPARE(location.address().street(), QStringLiteral("Storgata 10"));
+    QCOMPARE(location.address().city(), QStringLiteral("Oslo"));
+    QCOMPARE(location.address().postalCode(), QStringLiteral("0184"));
+    QCOMPARE(location.coordinate(), QGeoCoordinate(59.92, 10.75));
+    delete reply;
+}
+
+void tst_QGeoCodingManagerLocalPlaces::geocodeBounds()
+{
+    const QGeoRectangle bounds(QGeoCoordinate(59.9135, 10.73), QGeoCoordinate(59.91, 10.745));
+    QCOMPARE(streets(m_geocodingManager->geocode(QStringLiteral("Karl Johans gate"), -1, 0,
+                                                 bounds)),
+             QStringList() << QStringLiteral("Karl Johans gate 1")
+                           << QStringLiteral("Karl Johans gate 2"));
+}
+
+void tst_QGeoCodingManagerLocalPlaces::paging()
+{
+    QStringList all;
+    for (int offset = 0; offset < 4; offset += 2) {
+        const QStringList page = streets(m_geocodingManager->geocode(QStringLiteral("oslo"), 2,
+                                                                     offset));
+        QVERIFY(page.count() <= 2);
+        all += page;
+    }
+    all.sort();
+    QCOMPARE(all, QStringList() << QStringLiteral("Karl Johans gate 1")
+                                << QStringLiteral("Karl Johans gate 2")
+                                << QStringLiteral("Karl Johans gate 3")
+                                << QStringLiteral("Storgata 10"));
+}
+
+void tst_QGeoCodingManagerLocalPlaces::reverseGeocode()
+{
+    QCOMPARE(streets(m_geocodingManager->reverseGeocode(QGeoCoordinate(59.91305, 10.7401))),
+             QStringList() << QStringLiteral("Karl Johans gate 1"));
+    QCOMPARE(streets(m_geocodingManager->reverseGeocode(QGeoCoordinate(60.39, 5.32))),
+             QStringList() << QStringLiteral("Bryggen 1"));
+
+    // farther than the default maximum distance from any address
+    QCOMPARE(streets(m_geocodingManager->reverseGeocode(QGeoCoordinate(59.0, 10.0))),
+             QStringList());
+}
+
+void tst_QGeoCodingManagerLocalPlaces::reverseGeocodeBounds()
+{
+    const QGeoRectangle bounds(QGeoCoordinate(59.92, 10.7405), QGeoCoordinate(59.91, 10.76));
+    QCOMPARE(streets(m_geocodingManager->reverseGeocode(QGeoCoordinate(59.9130, 10.7400),
+                                                        bounds)),
+             QStringList() << QStringLiteral("Karl Johans gate 2"));
+}
+
+void tst_QGeoCodingManagerLocalPlaces::indexFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString indexFile = dir.filePath(QStringLiteral("addresses.index"));
+
+    {
+        QVariantMap parameters;
+        parameters.insert(QStringLiteral("localplaces.geocoding.files"),
+                          QFINDTESTDATA("addresses.osm"));
+        parameters.insert(QStringLiteral("localplaces.geocoding.index"), indexFile);
+        QGeoServiceProvider provider(QStringLiteral("localplaces"), parameters);
+        QVERIFY(provider.geocodingManager());
+        QVERIFY(QFile::exists(indexFile));
+    }
+
+    // the index file is enough on its own
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("localplaces.geocoding.index"), indexFile);
+    QGeoServiceProvider provider(QStringLiteral("localplaces"), parameters);
+    QGeoCodingManager *manager = provider.geocodingManager();
+    QVERIFY(manager);
+    QCOMPARE(streets(manager->geocode(QStringLiteral("Bryggen"))),
+             QStringList() << QStringLiteral("Bryggen 1"));
+    QCOMPARE(streets(manager->reverseGeocode(QGeoCoordinate(59.92, 10.7501))),
+             QStringList() << QStringLiteral("Storgata 10"));
+
+    // a corrupt index is not used
+    QFile file(indexFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("not an index");
+    file.close();
+    QGeoServiceProvider corruptProvider(QStringLiteral("localplaces"), parameters);
+    QVERIFY(!corruptProvider.geocodingManager());
+    QCOMPARE(corruptProvider.error(), QGeoServiceProvider::ConnectionError);
+}
+
+/*
+    Returns the sorted streets of the locations of \a reply once it finishes,
+    and deletes it.
+*/
+QStringList tst_QGeoCodingManagerLocalPlaces::streets(QGeoCodeReply *reply)
+{
+    QSignalSpy finishedSpy(reply, &QGeoCodeReply::finished);
+    if (finishedSpy.isEmpty())
+        finishedSpy.wait(1000);
+    if (finishedSpy.count() != 1 || reply->error() != QGeoCodeReply::NoError) {
+        delete reply;
+        return QStringList() << QStringLiteral("geocoding failed");
+    }
+
+    QStringList result;
+    const QList<QGeoLocation> locations = reply->locations();
+    for (const QGeoLocation &location : locations)
+        result.append(location.address().street());
+    result.sort();
+    delete reply;
+    return result;
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoCodingManagerLocalPlaces)
+
+#include "tst_qgeocodingmanager_localplaces.moc"
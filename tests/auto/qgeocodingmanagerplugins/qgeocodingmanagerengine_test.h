@@ -35,7 +35,9 @@
 #include <qgeoaddress.h>
 #include <qgeolocation.h>
 #include <qgeocodereply.h>
+#include <qgeocodebatchreply.h>
 #include <QtPositioning/QGeoCoordinate>
+#include <QTimer>
 
 QT_USE_NAMESPACE
 
@@ -55,6 +57,28 @@ public:
 
 };
 
+// Finishes from the event loop with a location per coordinate, their address
+// text being "batch"
+class GeocodeBatchReplyTest : public QGeoCodeBatchReply
+{
+    Q_OBJECT
+public:
+    GeocodeBatchReplyTest(const QList<QGeoCoordinate> &coordinates, QObject *parent)
+        : QGeoCodeBatchReply(coordinates, parent)
+    {
+        QMetaObject::invokeMethod(this, [this]() {
+            for (int i = 0; i < count(); ++i) {
+                QGeoAddress address;
+                address.setText(QStringLiteral("batch"));
+                QGeoLocation location;
+                location.setCoordinate(this->coordinates().at(i));
+                location.setAddress(address);
+                setItemLocations(i, QList<QGeoLocation>() << location);
+            }
+        }, Qt::QueuedConnection);
+    }
+};
+
 class QGeoCodingManagerEngineTest: public QGeoCodingManagerEngine
 
 {
@@ -67,10 +91,25 @@ public:
         Q_UNUSED(error);
         Q_UNUSED(errorString);
         setLocale(QLocale(QLocale::German, QLocale::Germany));
+        if (parameters.contains("gc_delay"))
+            delay_ = parameters.value("gc_delay").toInt();
+        batch_ = parameters.value("gc_batch").toBool();
+    }
+
+    // Looked up by QGeoCodingManager, null leaves the coordinates to reverseGeocode()
+    Q_INVOKABLE QGeoCodeBatchReply *reverseGeocodeBatch(const QList<QGeoCoordinate> &coordinates,
+                                                        const QGeoShape &bounds)
+    {
+        Q_UNUSED(bounds);
+        if (!batch_)
+            return nullptr;
+        return new GeocodeBatchReplyTest(coordinates, this);
     }
 
     QGeoCodeReply* geocode(const QString &searchString, int limit, int offset, const QGeoShape &bounds)
     {
+        if (delay_ >= 0)
+            return delayedReply(QGeoCoordinate(), searchString);
         GeocodeReplyTest *geocodereply = new GeocodeReplyTest();
         geocodereply->callSetLimit(limit);
         geocodereply->callSetOffset(offset);
@@ -84,6 +123,8 @@ public:
 
     QGeoCodeReply* geocode (const QGeoAddress &address, const QGeoShape &bounds)
     {
+        if (delay_ >= 0)
+            return delayedReply(QGeoCoordinate(), address.city());
         GeocodeReplyTest *geocodereply = new GeocodeReplyTest();
         geocodereply->callSetViewport(bounds);
         geocodereply->callSetError(QGeoCodeReply::NoError,address.city());
@@ -95,6 +136,8 @@ public:
 
     QGeoCodeReply* reverseGeocode(const QGeoCoordinate &coordinate, const QGeoShape &bounds)
     {
+        if (delay_ >= 0)
+            return delayedReply(coordinate, coordinate.toString());
         GeocodeReplyTest *geocodereply = new GeocodeReplyTest();
         geocodereply->callSetViewport(bounds);
         geocodereply->callSetError(QGeoCodeReply::NoError,coordinate.toString());
@@ -102,6 +145,36 @@ public:
         emit(this->finished(geocodereply));
         return static_cast<QGeoCodeReply*>(geocodereply);
     }
+
+private:
+    // Finishes after delay_ milliseconds with a location whose address text
+    // is the number of requests made so far, or fails for the text "error"
+    QGeoCodeReply *delayedReply(const QGeoCoordinate &coordinate, const QString &text)
+    {
+        GeocodeReplyTest *geocodereply = new GeocodeReplyTest(this);
+        QGeoAddress address;
+        address.setText(QString::number(++requests_));
+        QGeoLocation location;
+        location.setCoordinate(coordinate);
+        location.setAddress(address);
+        QTimer::singleShot(delay_, geocodereply, [this, geocodereply, location, text]() {
+            if (geocodereply->isFinished())
+                return;
+            if (text == QLatin1String("error")) {
+                geocodereply->callSetError(QGeoCodeReply::CommunicationError, text);
+                emit this->error(geocodereply, geocodereply->error(), geocodereply->errorString());
+            } else {
+                geocodereply->callAddLocation(location);
+                geocodereply->callSetFinished(true);
+            }
+            emit this->finished(geocodereply);
+        });
+        return geocodereply;
+    }
+
+    int delay_ = -1;
+    bool batch_ = false;
+    int requests_ = 0;
 };
 
 #endif
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeodeadreckoningsource
+
+SOURCES += tst_qgeodeadreckoningsource.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,215 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtPositioning/private/qgeodeadreckoningsource_p.h>
+
+QT_USE_NAMESPACE
+
+// A source whose fixes are pushed by the test
+class FixSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+public:
+    explicit FixSource(QObject *parent = nullptr) : QGeoPositionInfoSource(parent) {}
+
+    void push(const QGeoPositionInfo &fix) { emit positionUpdated(fix); }
+
+    QGeoPositionInfo lastKnownPosition(bool) const override { return QGeoPositionInfo(); }
+    PositioningMethods supportedPositioningMethods() const override
+    {
+        return SatellitePositioningMethods;
+    }
+    int minimumUpdateInterval() const override { return 100; }
+    Error error() const override { return NoError; }
+
+public Q_SLOTS:
+    void startUpdates() override { running = true; }
+    void stopUpdates() override { running = false; }
+    void requestUpdate(int) override { ++requests; }
+
+public:
+    bool running = false;
+    int requests = 0;
+};
+
+class tst_QGeoDeadReckoningSource : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoPositionInfo fix(const QGeoCoordinate &coordinate, qreal accuracy,
+                                qreal speed = -1, qreal direction = -1)
+    {
+        QGeoPositionInfo info(coordinate, QDateTime::currentDateTimeUtc());
+        info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, accuracy);
+        if (speed >= 0)
+            info.setAttribute(QGeoPositionInfo::GroundSpeed, speed);
+        if (direction >= 0)
+            info.setAttribute(QGeoPositionInfo::Direction, direction);
+        return info;
+    }
+
+private slots:
+    void startStop()
+    {
+        FixSource fixes;
+        QGeoDeadReckoningSource source(&fixes);
+        QCOMPARE(source.source(), &fixes);
+        QCOMPARE(source.supportedPositioningMethods(),
+                 QGeoPositionInfoSource::SatellitePositioningMethods);
+
+        source.startUpdates();
+        QVERIFY(fixes.running);
+        source.stopUpdates();
+        QVERIFY(!fixes.running);
+    }
+
+    void noPredictionsBeforeFirstFix()
+    {
+        FixSource fixes;
+        QGeoDeadReckoningSource source(&fixes);
+        source.setUpdateInterval(20);
+        QSignalSpy spy(&source, &QGeoPositionInfoSource::positionUpdated);
+
+        source.startUpdates();
+        QTest::qWait(100);
+        QCOMPARE(spy.count(), 0);
+    }
+
+    void predictsDuringGap()
+    {
+        FixSource fixes;
+        QGeoDeadReckoningSource source(&fixes);
+        source.setUpdateInterval(20);
+        QSignalSpy spy(&source, &QGeoPositionInfoSource::positionUpdated);
+
+        source.startUpdates();
+        fixes.push(fix(QGeoCoordinate(0, 0), 1, 100, 90));
+        QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= 5, 2000);
+
+        // moving east at the speed of the fix, less and less accurately
+        qreal accuracy = 0;
+        double longitude = -1;
+        for (const QList<QVariant> &arguments : qAsConst(spy)) {
+            const QGeoPositionInfo position = arguments.at(0).value<QGeoPositionInfo>();
+            QVERIFY(position.coordinate().longitude() > longitude);
+            QVERIFY(position.attribute(QGeoPositionInfo::HorizontalAccuracy) > accuracy);
+            QCOMPARE(qRound(position.attribute(QGeoPositionInfo::Direction)), 90);
+            QVERIFY(qAbs(position.attribute(QGeoPositionInfo::GroundSpeed) - 100) < 2);
+            longitude = position.coordinate().longitude();
+            accuracy = position.attribute(QGeoPositionInfo::HorizontalAccuracy);
+        }
+        QCOMPARE(source.lastKnownPosition().coordinate().longitude(), longitude);
+    }
+
+    void fixCorrectsPrediction()
+    {
+        FixSource fixes;
+        QGeoDeadReckoningSource source(&fixes);
+        source.setUpdateInterval(20);
+        QSignalSpy spy(&source, &QGeoPositionInfoSource::positionUpdated);
+
+        source.startUpdates();
+        fixes.push(fix(QGeoCoordinate(10, 10), 50));
+        const QGeoCoordinate corrected(10.001, 10);
+        fixes.push(fix(corrected, 1));
+
+        spy.clear();
+        QTRY_VERIFY_WITH_TIMEOUT(!spy.isEmpty(), 2000);
+        const QGeoPositionInfo position = spy.last().at(0).value<QGeoPositionInfo>();
+        QVERIFY(position.coordinate().distanceTo(corrected) < 5);
+        QVERIFY(position.attribute(QGeoPositionInfo::HorizontalAccuracy) < 5);
+    }
+
+    void sensorsSteerPrediction()
+    {
+        FixSource fixes;
+        QGeoDeadReckoningSource source(&fixes);
+        source.setUpdateInterval(20);
+        QSignalSpy spy(&source, &QGeoPositionInfoSource::positionUpdated);
+
+        source.startUpdates();
+        fixes.push(fix(QGeoCoordinate(0, 0), 1));
+        source.feedHeading(0, 1);
+        source.feedSpeed(50, 0.1);
+
+        QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= 3, 2000);
+        const QGeoPositionInfo position = spy.last().at(0).value<QGeoPositionInfo>();
+        QVERIFY(position.coordinate().latitude() > 0);
+        QVERIFY(qAbs(position.coordinate().longitude()) < 1e-5);
+        QVERIFY(position.attribute(QGeoPositionInfo::GroundSpeed) > 45);
+    }
+
+    void timesOutAfterLongGap()
+    {
+        FixSource fixes;
+        QGeoDeadReckoningSource source(&fixes);
+        source.setUpdateInterval(20);
+        source.setMaximumPredictionTime(150);
+        QSignalSpy positions(&source, &QGeoPositionInfoSource::positionUpdated);
+        QSignalSpy timeouts(&source, &QGeoPositionInfoSource::updateTimeout);
+
+        source.startUpdates();
+        fixes.push(fix(QGeoCoordinate(0, 0), 1));
+        QTRY_COMPARE_WITH_TIMEOUT(timeouts.count(), 1, 2000);
+        QVERIFY(!positions.isEmpty());
+
+        positions.clear();
+        QTest::qWait(100);
+        QCOMPARE(positions.count(), 0);
+        QCOMPARE(timeouts.count(), 1);
+
+        // the next fix starts over
+        fixes.push(fix(QGeoCoordinate(1, 1), 1));
+        QTRY_VERIFY_WITH_TIMEOUT(!positions.isEmpty(), 2000);
+        const QGeoPositionInfo position = positions.last().at(0).value<QGeoPositionInfo>();
+        QVERIFY(position.coordinate().distanceTo(QGeoCoordinate(1, 1)) < 1);
+    }
+
+    void requestUpdate()
+    {
+        FixSource fixes;
+        QGeoDeadReckoningSource source(&fixes);
+        QSignalSpy spy(&source, &QGeoPositionInfoSource::positionUpdated);
+
+        source.requestUpdate(1000);
+        QCOMPARE(fixes.requests, 1);
+        fixes.push(fix(QGeoCoordinate(5, 5), 1));
+        QCOMPARE(spy.count(), 1);
+
+        // later requests are answered by prediction
+        source.requestUpdate(1000);
+        QCOMPARE(fixes.requests, 1);
+        QTRY_COMPARE(spy.count(), 2);
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_QGeoDeadReckoningSource)
+#include "tst_qgeodeadreckoningsource.moc"
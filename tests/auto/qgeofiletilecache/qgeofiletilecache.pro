@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeofiletilecache
+
+SOURCES += tst_qgeofiletilecache.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,954 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QDateTime>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QtEndian>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeopackedtilecache_p.h>
+#include <QtLocation/private/qgeotiledmapreply_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+class DecodingTileCache : public QGeoFileTileCache
+{
+public:
+    using QGeoFileTileCache::decodeTileImage;
+};
+
+class PackedTileCache : public QGeoPackedTileCache
+{
+public:
+    explicit PackedTileCache(const QString &directory) : QGeoPackedTileCache(directory) {}
+    using QGeoPackedTileCache::init;
+
+    // The tile data as stored, without decoding it
+    QByteArray payload(const QGeoTileSpec &spec)
+    {
+        const QSharedPointer<QGeoPackedTile> tile = diskCache_.object(spec);
+        return tile ? readPayload(*tile) : QByteArray();
+    }
+};
+
+class tst_QGeoFileTileCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void validatorsFromHeaders();
+    void revalidateExpiredTile();
+    void serveStaleTiles();
+    void failedRevalidation();
+    void readBeforeWrite();
+    void batchedRemovals();
+    void warmStart();
+    void asynchronousDecoding();
+    void decodeByFormat_data();
+    void decodeByFormat();
+    void opaqueTextureFormat();
+    void compressedTiles();
+    void tileIndexReplay();
+    void tileIndexFallback_data();
+    void tileIndexFallback();
+    void tileIndexRewriteThreshold_data();
+    void tileIndexRewriteThreshold();
+    void packRoundTrip();
+    void packRecoverIndex_data();
+    void packRecoverIndex();
+    void packCompaction();
+    void packClearMapId();
+
+private:
+    static QGeoTileSpec spec(int i)
+    {
+        return QGeoTileSpec(QStringLiteral("test"), 1, 10, i % 16, i / 16);
+    }
+
+    void storeExpiredTile(const QString &directory);
+    static QStringList tileFiles(const QString &directory)
+    {
+        return QDir(directory).entryList(QStringList() << QStringLiteral("*.png"), QDir::Files);
+    }
+
+    // A tiles.index as written by QGeoFileTileCache, see qgeofiletilecache.cpp
+    static QByteArray tileIndexHeader(quint32 magic = 0x49544751)
+    {
+        QByteArray header(16, Qt::Uninitialized);
+        qToLittleEndian<quint32>(magic, header.data());
+        qToLittleEndian<quint32>(3, header.data() + 4);
+        qToLittleEndian<qint64>(42, header.data() + 8);
+        return header;
+    }
+    QByteArray tileIndexRecord(bool insert, int i, qint64 expires = -1,
+                               const QByteArray &entityTag = QByteArray()) const
+    {
+        const QByteArray name = QFileInfo(QGeoFileTileCache::tileSpecToFilenameDefault(
+                spec(i), QStringLiteral("png"), QString())).fileName().toLatin1();
+        QByteArray record(28, '\0');
+        record[0] = char(insert ? 1 : 2);
+        record[1] = char(1);
+        qToLittleEndian<quint16>(quint16(name.size()), record.data() + 2);
+        qToLittleEndian<quint32>(quint32(m_png.size()), record.data() + 4);
+        qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), record.data() + 8);
+        qToLittleEndian<qint64>(expires, record.data() + 16);
+        qToLittleEndian<quint16>(quint16(entityTag.size()), record.data() + 24);
+        return record + name + entityTag;
+    }
+    // Stores the tiles as files, without going through a cache
+    void storeTileFiles(const QString &directory, int count) const
+    {
+        for (int i = 0; i < count; ++i) {
+            QFile file(QGeoFileTileCache::tileSpecToFilenameDefault(spec(i), QStringLiteral("png"), directory));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(m_png);
+        }
+    }
+    static void writeTileIndex(const QString &directory, const QByteArray &index)
+    {
+        QFile file(QDir(directory).filePath(QStringLiteral("tiles.index")));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(index);
+    }
+    // The tiles 0 to 3, of which 1 was removed since and 2 has expired
+    QByteArray tileIndexLog() const
+    {
+        return tileIndexHeader()
+                + tileIndexRecord(true, 0)
+                + tileIndexRecord(true, 1)
+                + tileIndexRecord(true, 2)
+                + tileIndexRecord(false, 1)
+                + tileIndexRecord(true, 3)
+                + tileIndexRecord(true, 2, QDateTime::currentMSecsSinceEpoch() - 1000, "\"e2\"");
+    }
+
+    // The size of the record of a tile of spec() in a pack, see qgeopackedtilecache.cpp
+    static qint64 packRecordSize(const QByteArray &bytes) { return 32 + 4 + 3 + bytes.size(); }
+    static QByteArray packPayload(int i, int size) { return QByteArray(size, char('a' + i % 26)); }
+
+    // A PKM file of a 256x256 texture of the given type, see qpkmhandler.cpp
+    static QByteArray pkmTile(quint16 type)
+    {
+        QByteArray header("PKM 20", 6);
+        header.resize(16);
+        qToBigEndian<quint16>(type, header.data() + 6);
+        for (int offset : { 8, 10, 12, 14 })
+            qToBigEndian<quint16>(256, header.data() + offset);
+        return header + QByteArray(64 * 64 * 8, '\x55'); // 8 bytes per 4x4 block
+    }
+
+    QByteArray m_png;
+};
+
+// Leaves spec(0) in the cache in directory, expired a second ago
+void tst_QGeoFileTileCache::storeExpiredTile(const QString &directory)
+{
+    QGeoFileTileCache cache(directory);
+    cache.init();
+    cache.insert(spec(0), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    QGeoTileValidators validators;
+    validators.entityTag = "\"v1\"";
+    validators.expires = QDateTime::currentMSecsSinceEpoch() - 1000;
+    cache.setTileValidators(spec(0), validators);
+}
+
+void tst_QGeoFileTileCache::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    qRegisterMetaType<QGeoTileSpec>();
+    qRegisterMetaType<QGeoTileValidators>();
+
+    QImage image(256, 256, QImage::Format_ARGB32);
+    image.fill(Qt::darkCyan);
+    QBuffer buffer(&m_png);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "png"));
+}
+
+void tst_QGeoFileTileCache::validatorsFromHeaders()
+{
+    typedef QList<QPair<QByteArray, QByteArray> > Headers;
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+
+    QGeoTileValidators validators = QGeoTileValidators::fromHttpHeaders(Headers()
+            << qMakePair(QByteArray("ETag"), QByteArray("\"abc\""))
+            << qMakePair(QByteArray("Last-Modified"), QByteArray("Wed, 21 Oct 2015 07:28:00 GMT"))
+            << qMakePair(QByteArray("Cache-Control"), QByteArray("public, max-age=60"))
+            << qMakePair(QByteArray("Expires"), QByteArray("Wed, 21 Oct 2015 07:28:00 +0000")));
+    QCOMPARE(validators.entityTag, QByteArray("\"abc\""));
+    QCOMPARE(validators.lastModified, QByteArray("Wed, 21 Oct 2015 07:28:00 GMT"));
+    QVERIFY(validators.canRevalidate());
+    // max-age wins over Expires
+    QVERIFY(validators.expires >= before + 60000);
+    QVERIFY(validators.expires <= QDateTime::currentMSecsSinceEpoch() + 60000);
+
+    validators = QGeoTileValidators::fromHttpHeaders(Headers()
+            << qMakePair(QByteArray("expires"), QByteArray("Wed, 21 Oct 2015 07:28:00 +0000")));
+    QCOMPARE(validators.expires, QDateTime(QDate(2015, 10, 21), QTime(7, 28), Qt::UTC).toMSecsSinceEpoch());
+    QVERIFY(!validators.canRevalidate());
+
+    // already expired
+    validators = QGeoTileValidators::fromHttpHeaders(Headers()
+            << qMakePair(QByteArray("Expires"), QByteArray("0")));
+    QVERIFY(validators.expires >= before);
+    QVERIFY(validators.expires <= QDateTime::currentMSecsSinceEpoch());
+    validators = QGeoTileValidators::fromHttpHeaders(Headers()
+            << qMakePair(QByteArray("Cache-Control"), QByteArray("max-age=3600, No-Cache")));
+    QVERIFY(validators.expires <= QDateTime::currentMSecsSinceEpoch());
+
+    validators = QGeoTileValidators::fromHttpHeaders(Headers());
+    QVERIFY(validators.isNull());
+}
+
+// An expired tile is revalidated once, and kept out of the maps until then
+void tst_QGeoFileTileCache::revalidateExpiredTile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    storeExpiredTile(dir.path());
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        cache.insert(spec(1), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    }
+
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        QSignalSpy expired(&cache, &QAbstractGeoTileCache::tileExpired);
+        QVERIFY(cache.contains(spec(0), QAbstractGeoTileCache::DiskCache));
+
+        QVERIFY(!cache.get(spec(0)));
+        QCOMPARE(expired.count(), 1);
+        QCOMPARE(expired.at(0).at(0).value<QGeoTileSpec>(), spec(0));
+        QCOMPARE(expired.at(0).at(1).value<QGeoTileValidators>().entityTag, QByteArray("\"v1\""));
+        QVERIFY(!cache.get(spec(0)));
+        QCOMPARE(expired.count(), 1);
+
+        // tiles without validators never expire
+        QVERIFY(cache.get(spec(1)));
+        QCOMPARE(expired.count(), 1);
+
+        // a 304 answer only brings a new lifetime
+        QGeoTileValidators notModified;
+        notModified.expires = QDateTime::currentMSecsSinceEpoch() + 3600 * 1000;
+        cache.setTileValidators(spec(0), notModified);
+        QVERIFY(cache.get(spec(0)));
+        QCOMPARE(expired.count(), 1);
+    }
+
+    // which is kept in the tile index
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+    QSignalSpy expired(&cache, &QAbstractGeoTileCache::tileExpired);
+    QVERIFY(cache.get(spec(0)));
+    QCOMPARE(expired.count(), 0);
+}
+
+void tst_QGeoFileTileCache::serveStaleTiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    storeExpiredTile(dir.path());
+
+    QGeoFileTileCache cache(dir.path());
+    cache.setServeStaleTiles(true);
+    QVERIFY(cache.serveStaleTiles());
+    cache.init();
+    QSignalSpy expired(&cache, &QAbstractGeoTileCache::tileExpired);
+
+    // served right away, and revalidated meanwhile
+    QSharedPointer<QGeoTileTexture> texture = cache.get(spec(0));
+    QVERIFY(texture);
+    QVERIFY(!texture->isNull());
+    QCOMPARE(expired.count(), 1);
+}
+
+// With the server out of reach, the expired tiles are good for the session
+void tst_QGeoFileTileCache::failedRevalidation()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    storeExpiredTile(dir.path());
+
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+    QSignalSpy expired(&cache, &QAbstractGeoTileCache::tileExpired);
+    QVERIFY(!cache.get(spec(0)));
+    QCOMPARE(expired.count(), 1);
+
+    cache.revalidationFailed(spec(0));
+    QVERIFY(cache.get(spec(0)));
+    QCOMPARE(expired.count(), 1);
+}
+
+// The tiles are readable as soon as inserted, and land on disk unchanged
+void tst_QGeoFileTileCache::readBeforeWrite()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filename = QGeoFileTileCache::tileSpecToFilenameDefault(spec(0), QStringLiteral("png"),
+                                                                         dir.path());
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        cache.insert(spec(0), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        QSharedPointer<QGeoTileTexture> texture = cache.get(spec(0));
+        QVERIFY(texture);
+        QCOMPARE(texture->image.size(), QSize(256, 256));
+        QTRY_VERIFY(QFileInfo(filename).size() == m_png.size());
+
+        cache.setAsynchronousDecoding(true);
+        cache.insert(spec(1), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+        texture = cache.get(spec(1));
+        QVERIFY(texture);
+        QTRY_COMPARE(decoded.count(), 1);
+        QCOMPARE(decoded.at(0).at(0).value<QGeoTileSpec>(), spec(1));
+        QVERIFY(decoded.at(0).at(1).toBool());
+    }
+
+    // the destructor waits for the writes still queued
+    for (int i = 0; i < 2; ++i) {
+        QFile file(QGeoFileTileCache::tileSpecToFilenameDefault(spec(i), QStringLiteral("png"), dir.path()));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), m_png);
+    }
+}
+
+// Evicted files go in batches behind the writes, unless written again meanwhile
+void tst_QGeoFileTileCache::batchedRemovals()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString rewritten = QFileInfo(QGeoFileTileCache::tileSpecToFilenameDefault(spec(3), QStringLiteral("png"),
+                                                                                   dir.path())).fileName();
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.setCostStrategyDisk(QAbstractGeoTileCache::Unitary);
+        cache.setMaxDiskUsage(2);
+        cache.init();
+        for (int i = 0; i < 4; ++i)
+            cache.insert(spec(i), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+
+        QStringList kept;
+        for (int i = 0; i < 4; ++i) {
+            if (cache.contains(spec(i), QAbstractGeoTileCache::DiskCache)) {
+                kept << QFileInfo(QGeoFileTileCache::tileSpecToFilenameDefault(spec(i), QStringLiteral("png"),
+                                                                             dir.path())).fileName();
+            }
+        }
+        QVERIFY(kept.size() <= 2);
+        std::sort(kept.begin(), kept.end());
+        QTRY_COMPARE(tileFiles(dir.path()), kept);
+
+        cache.clearMapId(1);
+        cache.insert(spec(3), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    }
+    QCOMPARE(tileFiles(dir.path()), QStringList() << rewritten);
+}
+
+// The tiles last in the texture cache are decoded again as soon as the next cache starts
+void tst_QGeoFileTileCache::warmStart()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString warmStartFile = QDir(dir.path()).filePath(QStringLiteral("textures.warmstart"));
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.setWarmStartTiles(2);
+        cache.init();
+        for (int i = 0; i < 4; ++i)
+            cache.insert(spec(i), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        QVERIFY(cache.get(spec(1)));
+        QVERIFY(cache.get(spec(3)));
+        QVERIFY(cache.contains(spec(3), QAbstractGeoTileCache::TextureCache));
+        QVERIFY(!cache.contains(spec(2), QAbstractGeoTileCache::TextureCache));
+    }
+
+    QFile file(warmStartFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QStringList names = QString::fromLatin1(file.readAll()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    file.close();
+    std::sort(names.begin(), names.end());
+    QStringList expected;
+    for (int i : { 1, 3 }) {
+        expected << QFileInfo(QGeoFileTileCache::tileSpecToFilenameDefault(spec(i), QStringLiteral("png"),
+                                                                         dir.path())).fileName();
+    }
+    std::sort(expected.begin(), expected.end());
+    QCOMPARE(names, expected);
+
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.setWarmStartTiles(2);
+        QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+        cache.init();
+        // before any map asks for them
+        QTRY_COMPARE(decoded.count(), 2);
+        for (const QList<QVariant> &args : qAsConst(decoded))
+            QVERIFY(args.at(1).toBool());
+        QVERIFY(cache.contains(spec(1), QAbstractGeoTileCache::TextureCache));
+        QVERIFY(cache.contains(spec(3), QAbstractGeoTileCache::TextureCache));
+        QVERIFY(!cache.contains(spec(0), QAbstractGeoTileCache::TextureCache));
+        QVERIFY(!cache.contains(spec(2), QAbstractGeoTileCache::TextureCache));
+    }
+
+    // no more than asked for
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.setWarmStartTiles(1);
+        QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+        cache.init();
+        QTRY_COMPARE(decoded.count(), 1);
+        QTest::qWait(50);
+        QCOMPARE(decoded.count(), 1);
+    }
+
+    // and nothing when disabled
+    {
+        QGeoFileTileCache cache(dir.path());
+        QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+        cache.init();
+        QTest::qWait(50);
+        QCOMPARE(decoded.count(), 0);
+        QVERIFY(!cache.contains(spec(1), QAbstractGeoTileCache::TextureCache));
+        QVERIFY(!cache.contains(spec(3), QAbstractGeoTileCache::TextureCache));
+    }
+}
+
+// Decodes are shared by the gets of a tile until it is decoded, and can be cancelled
+void tst_QGeoFileTileCache::asynchronousDecoding()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < 4; ++i)
+            cache.insert(spec(i), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    }
+
+    QGeoFileTileCache cache(dir.path());
+    cache.setAsynchronousDecoding(true);
+    cache.init();
+    QVERIFY(cache.asynchronousDecoding());
+    QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+
+    const QSharedPointer<QGeoTileTexture> pending = cache.get(spec(0));
+    QVERIFY(pending);
+    QVERIFY(pending->pending);
+    QCOMPARE(cache.get(spec(0)), pending);
+    QTRY_COMPARE(decoded.count(), 1);
+    QCOMPARE(decoded.at(0).at(0).value<QGeoTileSpec>(), spec(0));
+    QVERIFY(decoded.at(0).at(1).toBool());
+    const QSharedPointer<QGeoTileTexture> texture = cache.get(spec(0));
+    QVERIFY(texture);
+    QVERIFY(!texture->pending);
+    QCOMPARE(texture->image.size(), QSize(256, 256));
+    QTest::qWait(50);
+    QCOMPARE(decoded.count(), 1);
+
+    // a cancelled decode is not reported, the next get starts another one
+    decoded.clear();
+    const QSharedPointer<QGeoTileTexture> cancelled = cache.get(spec(1));
+    QVERIFY(cancelled && cancelled->pending);
+    cache.cancelDecoding(QSet<QGeoTileSpec>() << spec(1));
+    QTest::qWait(100);
+    QCOMPARE(decoded.count(), 0);
+    QVERIFY(!cache.contains(spec(1), QAbstractGeoTileCache::TextureCache));
+    const QSharedPointer<QGeoTileTexture> again = cache.get(spec(1));
+    QVERIFY(again && again->pending);
+    QVERIFY(again != cancelled);
+    QTRY_COMPARE(decoded.count(), 1);
+    QCOMPARE(decoded.at(0).at(0).value<QGeoTileSpec>(), spec(1));
+    QVERIFY(cache.contains(spec(1), QAbstractGeoTileCache::TextureCache));
+
+    // past the pending decodes allowed, tiles are decoded right away
+    decoded.clear();
+    cache.setMaxPendingDecodes(1);
+    const QSharedPointer<QGeoTileTexture> queued = cache.get(spec(2));
+    QVERIFY(queued && queued->pending);
+    const QSharedPointer<QGeoTileTexture> immediate = cache.get(spec(3));
+    QVERIFY(immediate);
+    QVERIFY(!immediate->pending);
+    QCOMPARE(immediate->image.size(), QSize(256, 256));
+    QTRY_COMPARE(decoded.count(), 1);
+    QCOMPARE(decoded.at(0).at(0).value<QGeoTileSpec>(), spec(2));
+
+    // turning it off drops the pending decodes
+    decoded.clear();
+    for (int i = 4; i < 6; ++i)
+        cache.insert(spec(i), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    QVERIFY(cache.get(spec(4))->pending);
+    cache.setAsynchronousDecoding(false);
+    QTest::qWait(100);
+    QCOMPARE(decoded.count(), 0);
+    const QSharedPointer<QGeoTileTexture> synchronous = cache.get(spec(5));
+    QVERIFY(synchronous && !synchronous->pending);
+}
+
+void tst_QGeoFileTileCache::decodeByFormat_data()
+{
+    QTest::addColumn<QByteArray>("bytes");
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<bool>("decoded");
+
+    QTest::newRow("png") << m_png << QStringLiteral("png") << true;
+    QTest::newRow("upper case") << m_png << QStringLiteral("PNG") << true;
+    QTest::newRow("no format") << m_png << QString() << true;
+    // probed when not in the format it is stored with
+    QTest::newRow("stored as jpg") << m_png << QStringLiteral("jpg") << true;
+    QTest::newRow("stored as unknown") << m_png << QStringLiteral("tile") << true;
+    QTest::newRow("stored as ktx") << m_png << QStringLiteral("ktx") << true;
+    QTest::newRow("not an image") << QByteArray("not an image") << QStringLiteral("png") << false;
+    QTest::newRow("empty") << QByteArray() << QStringLiteral("png") << false;
+}
+
+// The format a tile is stored with picks the decoder
+void tst_QGeoFileTileCache::decodeByFormat()
+{
+    QFETCH(QByteArray, bytes);
+    QFETCH(QString, format);
+    QFETCH(bool, decoded);
+
+    QImage image;
+    QTextureFileData compressed;
+    QCOMPARE(DecodingTileCache::decodeTileImage(bytes, &image, &compressed, QImage::Format_RGB32, format), decoded);
+    QVERIFY(!compressed.isValid());
+    if (decoded) {
+        QCOMPARE(image.size(), QSize(256, 256));
+        QCOMPARE(image.pixelColor(10, 10), QColor(Qt::darkCyan));
+    }
+}
+
+// Opaque tiles are kept in the format asked for, when it is one the cache supports
+void tst_QGeoFileTileCache::opaqueTextureFormat()
+{
+    QImage image(256, 256, QImage::Format_RGB32);
+    image.fill(Qt::darkCyan);
+    QByteArray opaquePng;
+    QBuffer buffer(&opaquePng);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "png"));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        QGeoFileTileCache cache(dir.path());
+        QCOMPARE(cache.opaqueTextureFormat(), QImage::Format_RGB32);
+        cache.setOpaqueTextureFormat(QImage::Format_RGB16);
+        QCOMPARE(cache.opaqueTextureFormat(), QImage::Format_RGB16);
+        cache.init();
+        cache.insert(spec(0), opaquePng, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        cache.insert(spec(1), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+
+        const QSharedPointer<QGeoTileTexture> opaque = cache.get(spec(0));
+        QVERIFY(opaque);
+        QCOMPARE(opaque->image.format(), QImage::Format_RGB16);
+        QCOMPARE(opaque->byteSize(), qsizetype(256 * 256 * 2));
+        QCOMPARE(cache.textureUsage(), 256 * 256 * 2);
+
+        // tiles with an alpha channel keep it
+        const QSharedPointer<QGeoTileTexture> transparent = cache.get(spec(1));
+        QVERIFY(transparent);
+        QCOMPARE(transparent->image.format(), QImage::Format_ARGB32_Premultiplied);
+        QCOMPARE(transparent->byteSize(), qsizetype(256 * 256 * 4));
+    }
+
+    // loaded from the disk in the same format
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.setOpaqueTextureFormat(QImage::Format_RGB16);
+        cache.init();
+        const QSharedPointer<QGeoTileTexture> opaque = cache.get(spec(0));
+        QVERIFY(opaque);
+        QCOMPARE(opaque->image.format(), QImage::Format_RGB16);
+    }
+
+    // formats the scene graph would convert at each upload fall back to the default
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.setOpaqueTextureFormat(QImage::Format_Indexed8);
+        QCOMPARE(cache.opaqueTextureFormat(), QImage::Format_RGB32);
+        cache.init();
+        const QSharedPointer<QGeoTileTexture> opaque = cache.get(spec(0));
+        QVERIFY(opaque);
+        QCOMPARE(opaque->image.format(), QImage::Format_RGB32);
+    }
+}
+
+// Tiles in a GPU compressed format are kept, on the disk and in memory, as they are
+void tst_QGeoFileTileCache::compressedTiles()
+{
+    const QByteArray etc2 = pkmTile(1);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        cache.insert(spec(0), etc2, QStringLiteral("pkm"), QAbstractGeoTileCache::DiskCache);
+        const QSharedPointer<QGeoTileTexture> texture = cache.get(spec(0));
+        QVERIFY(texture);
+        QVERIFY(texture->compressed.isValid());
+        QVERIFY(texture->image.isNull());
+        QVERIFY(!texture->isNull());
+        QCOMPARE(texture->compressed.size(), QSize(256, 256));
+        QCOMPARE(texture->byteSize(), qsizetype(64 * 64 * 8));
+        QCOMPARE(cache.textureUsage(), 64 * 64 * 8);
+    }
+
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.setAsynchronousDecoding(true);
+        cache.init();
+        QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+        QVERIFY(cache.get(spec(0)));
+        QTRY_COMPARE(decoded.count(), 1);
+        QVERIFY(decoded.at(0).at(1).toBool());
+        const QSharedPointer<QGeoTileTexture> texture = cache.get(spec(0));
+        QVERIFY(texture && !texture->pending);
+        QVERIFY(texture->compressed.isValid());
+        QCOMPARE(texture->compressed.dataLength(), 64 * 64 * 8);
+        QCOMPARE(texture->compressed.data(), etc2);
+    }
+
+    // a texture file of a format that cannot be uploaded is not taken for a tile
+    QImage image;
+    QTextureFileData compressed;
+    QVERIFY(!DecodingTileCache::decodeTileImage(pkmTile(2), &image, &compressed, QImage::Format_RGB32,
+                                                QStringLiteral("pkm")));
+    QVERIFY(image.isNull());
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        cache.insert(spec(1), pkmTile(7), QStringLiteral("pkm"), QAbstractGeoTileCache::DiskCache);
+        QVERIFY(!cache.get(spec(1)));
+        QVERIFY(!cache.contains(spec(1), QAbstractGeoTileCache::TextureCache));
+    }
+}
+
+// The index log is replayed instead of scanning the directory
+void tst_QGeoFileTileCache::tileIndexReplay()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    storeTileFiles(dir.path(), 5);
+    writeTileIndex(dir.path(), tileIndexLog());
+
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+    QSignalSpy expired(&cache, &QAbstractGeoTileCache::tileExpired);
+    QVERIFY(cache.contains(spec(0), QAbstractGeoTileCache::DiskCache));
+    QVERIFY(cache.contains(spec(2), QAbstractGeoTileCache::DiskCache));
+    QVERIFY(cache.contains(spec(3), QAbstractGeoTileCache::DiskCache));
+    // removed, and never added, though their files are there
+    QVERIFY(!cache.contains(spec(1), QAbstractGeoTileCache::DiskCache));
+    QVERIFY(!cache.contains(spec(4), QAbstractGeoTileCache::DiskCache));
+
+    // the last record of a tile wins, with its validators
+    QVERIFY(cache.get(spec(0)));
+    QVERIFY(!cache.get(spec(2)));
+    QCOMPARE(expired.count(), 1);
+    QCOMPARE(expired.at(0).at(1).value<QGeoTileValidators>().entityTag, QByteArray("\"e2\""));
+}
+
+void tst_QGeoFileTileCache::tileIndexFallback_data()
+{
+    QTest::addColumn<QByteArray>("index");
+
+    const QByteArray log = tileIndexLog();
+    // an application killed while appending
+    QTest::newRow("torn record") << log + tileIndexRecord(true, 4).left(20);
+    QTest::newRow("torn name") << log + tileIndexRecord(true, 4).left(30);
+    QTest::newRow("bad magic") << tileIndexHeader(0x12345678) + log.mid(16);
+    QTest::newRow("unknown record") << log + QByteArray(28, '\x07');
+    QTest::newRow("header only, cut") << log.left(6);
+}
+
+// A corrupt index falls back to scanning the directory, and is written again
+void tst_QGeoFileTileCache::tileIndexFallback()
+{
+    QFETCH(QByteArray, index);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    storeTileFiles(dir.path(), 5);
+    writeTileIndex(dir.path(), index);
+
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(cache.contains(spec(i), QAbstractGeoTileCache::DiskCache));
+
+    QFile file(QDir(dir.path()).filePath(QStringLiteral("tiles.index")));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray rewritten = file.readAll();
+    QVERIFY(rewritten.size() >= 16);
+    QCOMPARE(qFromLittleEndian<quint32>(rewritten.constData()), quint32(0x49544751));
+    QCOMPARE(qFromLittleEndian<quint32>(rewritten.constData() + 4), quint32(3));
+}
+
+void tst_QGeoFileTileCache::tileIndexRewriteThreshold_data()
+{
+    QTest::addColumn<int>("churn");
+    QTest::addColumn<bool>("rewritten");
+
+    // more than twice the records of the tiles left, plus 1024
+    QTest::newRow("below") << 500 << false;
+    QTest::newRow("above") << 520 << true;
+}
+
+// A log dominated by removals and re-insertions is compacted as it is loaded
+void tst_QGeoFileTileCache::tileIndexRewriteThreshold()
+{
+    QFETCH(int, churn);
+    QFETCH(bool, rewritten);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    storeTileFiles(dir.path(), 4);
+    // 4 + 2 * churn records for 4 tiles
+    QByteArray index = tileIndexHeader();
+    for (int i = 0; i < 4; ++i)
+        index += tileIndexRecord(true, i);
+    for (int i = 0; i < churn; ++i)
+        index += tileIndexRecord(false, 1) + tileIndexRecord(true, 1);
+    writeTileIndex(dir.path(), index);
+
+    const QString indexFile = QDir(dir.path()).filePath(QStringLiteral("tiles.index"));
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(cache.contains(spec(i), QAbstractGeoTileCache::DiskCache));
+    if (rewritten)
+        QCOMPARE(QFileInfo(indexFile).size(), qint64(16 + 4 * tileIndexRecord(true, 0).size()));
+    else
+        QCOMPARE(QFileInfo(indexFile).size(), qint64(index.size()));
+}
+
+// The tiles of a pack are found again by the next cache, through the index
+void tst_QGeoFileTileCache::packRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        PackedTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < 3; ++i)
+            cache.insert(spec(i), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        cache.insert(spec(3), packPayload(3, 100), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        // readable right away
+        QSharedPointer<QGeoTileTexture> texture = cache.get(spec(1));
+        QVERIFY(texture);
+        QCOMPARE(texture->image.size(), QSize(256, 256));
+        QCOMPARE(cache.payload(spec(3)), packPayload(3, 100));
+    }
+
+    // the destructor wrote the index, after the records
+    QFile pack(QDir(dir.path()).filePath(QStringLiteral("tiles.pack")));
+    QVERIFY(pack.open(QIODevice::ReadOnly));
+    const QByteArray header = pack.read(16);
+    const qint64 records = 3 * packRecordSize(m_png) + packRecordSize(packPayload(3, 100));
+    QCOMPARE(qFromLittleEndian<qint64>(header.constData() + 8), 16 + records);
+    QCOMPARE(pack.size(), 16 + records + 8 + 4 * 8);
+    pack.close();
+
+    PackedTileCache cache(dir.path());
+    cache.init();
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(cache.contains(spec(i), QAbstractGeoTileCache::DiskCache));
+        QCOMPARE(cache.payload(spec(i)), m_png);
+    }
+    QCOMPARE(cache.payload(spec(3)), packPayload(3, 100));
+    QSharedPointer<QGeoTileTexture> texture = cache.get(spec(2));
+    QVERIFY(texture);
+    QCOMPARE(texture->image.pixelColor(10, 10), QColor(Qt::darkCyan));
+    QVERIFY(!cache.contains(spec(4), QAbstractGeoTileCache::DiskCache));
+}
+
+void tst_QGeoFileTileCache::packRecoverIndex_data()
+{
+    QTest::addColumn<QString>("damage");
+    QTest::addColumn<int>("recovered");
+    QTest::addColumn<int>("keptIndexSize");
+
+    // a crash after inserting, before the index was written again: the old
+    // index is skipped over
+    QTest::newRow("no index") << QStringLiteral("no index") << 3 << 8 + 3 * 8;
+    QTest::newRow("corrupt index") << QStringLiteral("corrupt index") << 3 << 0;
+    // a crash while writing the last record
+    QTest::newRow("truncated record") << QStringLiteral("truncated record") << 2 << 0;
+}
+
+void tst_QGeoFileTileCache::packRecoverIndex()
+{
+    QFETCH(QString, damage);
+    QFETCH(int, recovered);
+    QFETCH(int, keptIndexSize);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        PackedTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < 3; ++i)
+            cache.insert(spec(i), packPayload(i, 1000), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    }
+
+    const QString packFile = QDir(dir.path()).filePath(QStringLiteral("tiles.pack"));
+    const qint64 recordSize = packRecordSize(packPayload(0, 1000));
+    QFile pack(packFile);
+    QVERIFY(pack.open(QIODevice::ReadWrite));
+    const qint64 indexOffset = qFromLittleEndian<qint64>(pack.read(16).constData() + 8);
+    QCOMPARE(indexOffset, 16 + 3 * recordSize);
+    if (damage == QLatin1String("no index")) {
+        QVERIFY(pack.seek(8));
+        pack.write(QByteArray(8, '\0'));
+    } else if (damage == QLatin1String("corrupt index")) {
+        QVERIFY(pack.seek(indexOffset));
+        pack.write("XXXX");
+    } else {
+        QVERIFY(pack.resize(16 + 2 * recordSize + 10));
+    }
+    pack.close();
+
+    {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("Tile pack index missing")));
+        PackedTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < 3; ++i) {
+            QCOMPARE(cache.contains(spec(i), QAbstractGeoTileCache::DiskCache), i < recovered);
+            if (i < recovered)
+                QCOMPARE(cache.payload(spec(i)), packPayload(i, 1000));
+        }
+        // the damaged tail is dropped, and new tiles go after the recovered ones
+        QCOMPARE(QFileInfo(packFile).size(), 16 + recovered * recordSize + keptIndexSize);
+        cache.insert(spec(5), packPayload(5, 1000), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        QCOMPARE(cache.payload(spec(5)), packPayload(5, 1000));
+    }
+
+    // and the rebuilt index is written for the next cache
+    PackedTileCache cache(dir.path());
+    cache.init();
+    for (int i = 0; i < recovered; ++i)
+        QCOMPARE(cache.payload(spec(i)), packPayload(i, 1000));
+    QCOMPARE(cache.payload(spec(5)), packPayload(5, 1000));
+}
+
+// Replaced tiles are dropped from the pack, the live ones are all kept
+void tst_QGeoFileTileCache::packCompaction()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const int size = 100 * 1024;
+    {
+        PackedTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < 4; ++i)
+            cache.insert(spec(i), packPayload(i, size), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        // more than a megabyte, and more than the live tiles, left behind
+        for (int round = 1; round <= 8; ++round) {
+            for (int i = 0; i < 2; ++i) {
+                cache.insert(spec(i), packPayload(i + round, size), QStringLiteral("png"),
+                             QAbstractGeoTileCache::DiskCache);
+            }
+        }
+    }
+    const QString packFile = QDir(dir.path()).filePath(QStringLiteral("tiles.pack"));
+    const qint64 recordSize = packRecordSize(packPayload(0, size));
+    QCOMPARE(QFileInfo(packFile).size(), 16 + 20 * recordSize + 8 + 4 * 8);
+
+    // compacted when opened
+    const qint64 compacted = 16 + 4 * recordSize + 8 + 4 * 8;
+    {
+        PackedTileCache cache(dir.path());
+        cache.init();
+        QCOMPARE(QFileInfo(packFile).size(), compacted);
+        QVERIFY(!QFileInfo::exists(packFile + QStringLiteral(".compact")));
+        for (int i = 0; i < 4; ++i) {
+            QVERIFY(cache.contains(spec(i), QAbstractGeoTileCache::DiskCache));
+            QCOMPARE(cache.payload(spec(i)), packPayload(i < 2 ? i + 8 : i, size));
+        }
+    }
+
+    // with its index valid
+    PackedTileCache cache(dir.path());
+    cache.init();
+    QCOMPARE(QFileInfo(packFile).size(), compacted);
+    for (int i = 0; i < 4; ++i)
+        QCOMPARE(cache.payload(spec(i)), packPayload(i < 2 ? i + 8 : i, size));
+}
+
+// Tiles dropped by clearMapId() stay out of the index of the next cache
+void tst_QGeoFileTileCache::packClearMapId()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const int size = 100 * 1024;
+    const QGeoTileSpec other(QStringLiteral("test"), 2, 10, 0, 0);
+    {
+        PackedTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < 12; ++i)
+            cache.insert(spec(i), packPayload(i, size), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        cache.insert(other, packPayload(20, size), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    }
+
+    // cleared by a cache that inserts nothing
+    {
+        PackedTileCache cache(dir.path());
+        cache.init();
+        QVERIFY(cache.contains(spec(0), QAbstractGeoTileCache::DiskCache));
+        cache.clearMapId(1);
+        QVERIFY(!cache.contains(spec(0), QAbstractGeoTileCache::DiskCache));
+        QVERIFY(cache.contains(other, QAbstractGeoTileCache::DiskCache));
+    }
+
+    const QString packFile = QDir(dir.path()).filePath(QStringLiteral("tiles.pack"));
+    const qint64 recordSize = packRecordSize(packPayload(0, size));
+    PackedTileCache cache(dir.path());
+    cache.init();
+    for (int i = 0; i < 12; ++i) {
+        QVERIFY(!cache.contains(spec(i), QAbstractGeoTileCache::DiskCache));
+        QVERIFY(!cache.get(spec(i)));
+    }
+    QCOMPARE(cache.payload(other), packPayload(20, size));
+    // the cleared records were dead space, compacted away
+    QCOMPARE(QFileInfo(packFile).size(), 16 + recordSize + 8 + 8);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoFileTileCache)
+
+#include "tst_qgeofiletilecache.moc"
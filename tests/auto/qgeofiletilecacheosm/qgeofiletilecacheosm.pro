@@ -0,0 +1,14 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeofiletilecacheosm
+
+plugin.path = ../../../src/plugins/geoservices/osm/
+
+SOURCES += tst_qgeofiletilecacheosm.cpp \
+           $$plugin.path/qgeofiletilecacheosm.cpp \
+           $$plugin.path/qgeotileproviderosm.cpp
+HEADERS += $$plugin.path/qgeofiletilecacheosm.h \
+           $$plugin.path/qgeotileproviderosm.h
+INCLUDEPATH += $$plugin.path
+
+QT += location location-private network concurrent testlib
@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/geoservices/osm
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+#include "qgeofiletilecacheosm.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoFileTileCacheOsm : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void offlineTiles();
+    void offlineDirectoryChanged();
+    void asynchronousDecoding();
+
+private:
+    static QGeoFileTileCacheOsm *cache(const QString &offlineDirectory, const QString &directory);
+    static void writeTile(const QString &directory, const QString &fileName, const QColor &color);
+    static QColor colorOf(const QSharedPointer<QGeoTileTexture> &texture);
+
+    static QGeoTileSpec spec(int mapId, int zoom, int x, int y)
+    {
+        return QGeoTileSpec(QStringLiteral("osm"), mapId, zoom, x, y);
+    }
+};
+
+// A cache of a single low dpi street map provider, of map id 1
+QGeoFileTileCacheOsm *tst_QGeoFileTileCacheOsm::cache(const QString &offlineDirectory, const QString &directory)
+{
+    QGeoTileProviderOsm *provider = new QGeoTileProviderOsm(nullptr,
+            QGeoMapType(QGeoMapType::StreetMap, QStringLiteral("street"), QString(), false, false, 1,
+                        QByteArrayLiteral("osm"), QGeoCameraCapabilities()),
+            QVector<TileProvider *>() << new TileProvider(QStringLiteral("http://localhost/%z/%x/%y.png"),
+                                                          QStringLiteral("png"), QString(), QString()),
+            QGeoCameraCapabilities());
+    QGeoFileTileCacheOsm *cache = new QGeoFileTileCacheOsm(QVector<QGeoTileProviderOsm *>() << provider,
+                                                           offlineDirectory, directory);
+    cache->init();
+    return cache;
+}
+
+void tst_QGeoFileTileCacheOsm::writeTile(const QString &directory, const QString &fileName, const QColor &color)
+{
+    QImage image(8, 8, QImage::Format_RGB32);
+    image.fill(color);
+    QVERIFY(image.save(QDir(directory).filePath(fileName)));
+}
+
+QColor tst_QGeoFileTileCacheOsm::colorOf(const QSharedPointer<QGeoTileTexture> &texture)
+{
+    if (!texture || texture->pending || texture->image.isNull())
+        return QColor();
+    return QColor(texture->image.pixel(0, 0));
+}
+
+void tst_QGeoFileTileCacheOsm::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    qRegisterMetaType<QGeoTileSpec>();
+}
+
+void tst_QGeoFileTileCacheOsm::offlineTiles()
+{
+    QTemporaryDir offline, cacheDir;
+    // plugin-dpi-mapId-zoom-x-y.format
+    writeTile(offline.path(), QStringLiteral("osm-l-1-3-2-1.png"), Qt::red);
+    writeTile(offline.path(), QStringLiteral("osm-l-1-3-4-1.bmp"), Qt::blue);
+    // the same tile in two formats, the first by name is used
+    writeTile(offline.path(), QStringLiteral("osm-l-1-4-0-0.png"), Qt::green);
+    writeTile(offline.path(), QStringLiteral("osm-l-1-4-0-0.bmp"), Qt::yellow);
+    // not tiles
+    QFile readme(QDir(offline.path()).filePath(QStringLiteral("README")));
+    QVERIFY(readme.open(QIODevice::WriteOnly));
+    readme.write("offline tiles");
+    readme.close();
+    QVERIFY(QDir(offline.path()).mkdir(QStringLiteral("osm-l-1-3-3-1.png")));
+
+    QScopedPointer<QGeoFileTileCacheOsm> tileCache(cache(offline.path(), cacheDir.path()));
+    QCOMPARE(colorOf(tileCache->get(spec(1, 3, 2, 1))), QColor(Qt::red));
+    QCOMPARE(colorOf(tileCache->get(spec(1, 3, 4, 1))), QColor(Qt::blue));
+    QCOMPARE(colorOf(tileCache->get(spec(1, 4, 0, 0))), QColor(Qt::yellow));
+
+    QVERIFY(!tileCache->get(spec(1, 3, 3, 1)));
+    QVERIFY(!tileCache->get(spec(1, 3, 2, 2)));
+    QVERIFY(!tileCache->get(spec(1, 4, 2, 1)));
+    // of no provider
+    QVERIFY(!tileCache->get(spec(2, 3, 2, 1)));
+}
+
+// The index follows the files copied into and removed from the offline directory
+void tst_QGeoFileTileCacheOsm::offlineDirectoryChanged()
+{
+    QTemporaryDir offline, cacheDir;
+    writeTile(offline.path(), QStringLiteral("osm-l-1-5-1-1.png"), Qt::red);
+    writeTile(offline.path(), QStringLiteral("osm-l-1-5-2-1.png"), Qt::blue);
+
+    QScopedPointer<QGeoFileTileCacheOsm> tileCache(cache(offline.path(), cacheDir.path()));
+    QCOMPARE(colorOf(tileCache->get(spec(1, 5, 1, 1))), QColor(Qt::red));
+    QVERIFY(!tileCache->get(spec(1, 5, 3, 1)));
+
+    QVERIFY(QFile::remove(QDir(offline.path()).filePath(QStringLiteral("osm-l-1-5-2-1.png"))));
+    writeTile(offline.path(), QStringLiteral("osm-l-1-5-3-1.png"), Qt::green);
+    QTRY_COMPARE(colorOf(tileCache->get(spec(1, 5, 3, 1))), QColor(Qt::green));
+    QVERIFY(!tileCache->get(spec(1, 5, 2, 1)));
+    // in the memory cache already
+    QCOMPARE(colorOf(tileCache->get(spec(1, 5, 1, 1))), QColor(Qt::red));
+}
+
+// Offline tiles are decoded off the calling thread, like the disk cache hits
+void tst_QGeoFileTileCacheOsm::asynchronousDecoding()
+{
+    QTemporaryDir offline, cacheDir;
+    writeTile(offline.path(), QStringLiteral("osm-l-1-6-1-2.png"), Qt::red);
+
+    QScopedPointer<QGeoFileTileCacheOsm> tileCache(cache(offline.path(), cacheDir.path()));
+    tileCache->setAsynchronousDecoding(true);
+    QSignalSpy decoded(tileCache.data(), &QAbstractGeoTileCache::tileDecoded);
+
+    QSharedPointer<QGeoTileTexture> pending = tileCache->get(spec(1, 6, 1, 2));
+    QVERIFY(pending);
+    QVERIFY(pending->pending);
+    // asked again while decoding
+    QCOMPARE(tileCache->get(spec(1, 6, 1, 2)), pending);
+
+    QTRY_COMPARE(decoded.count(), 1);
+    QCOMPARE(decoded.first().at(0).value<QGeoTileSpec>(), spec(1, 6, 1, 2));
+    QCOMPARE(decoded.first().at(1).toBool(), true);
+    QCOMPARE(colorOf(tileCache->get(spec(1, 6, 1, 2))), QColor(Qt::red));
+}
+
+QTEST_MAIN(tst_QGeoFileTileCacheOsm)
+
+#include "tst_qgeofiletilecacheosm.moc"
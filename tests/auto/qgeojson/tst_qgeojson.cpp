@@ -28,19 +28,51 @@
 
 #include <QtTest/QtTest>
 #include <QtPositioning/QGeoCoordinate>
+#include <QtCore/QBuffer>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QVariant>
 #include <QtCore/QList>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+#include <QtLocation/private/qgeobinaryfeatures_p.h>
 #include <QtLocation/private/qgeojson_p.h>
+#include <QtLocation/private/qgeojsonreader_p.h>
+#include <QtLocation/private/qgeojsonwriter_p.h>
+#include <QtLocation/private/qgeojsonviewportmodel_p.h>
 
 QT_USE_NAMESPACE
 
+// Keeps what is written to it, and the size of the largest write
+class WriteRecorder : public QBuffer
+{
+public:
+    qint64 largestWrite = 0;
+
+protected:
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        largestWrite = qMax(largestWrite, len);
+        return QBuffer::writeData(data, len);
+    }
+};
+
 class tst_QGeoJson : public QObject
 {
     Q_OBJECT
 
 private Q_SLOTS:
     void testGeojson();
+    void reader_data();
+    void reader();
+    void readFeatures();
+    void writer_data();
+    void writer();
+    void writeFeatures();
+    void writeLongPath();
+    void binaryFeatures();
+    void viewportModel();
 
 private:
     QString testDataDir;
@@ -85,5 +117,359 @@ void tst_QGeoJson::testGeojson()
     }
 }
 
+static void appendShapes(const QVariantMap &geometry, QList<QGeoShape> *shapes)
+{
+    const QVariant data = geometry.value(QStringLiteral("data"));
+    if (data.type() == QVariant::List) {
+        const QVariantList parts = data.toList();
+        for (const QVariant &part : parts)
+            appendShapes(part.toMap(), shapes);
+    } else {
+        shapes->append(data.value<QGeoShape>());
+    }
+}
+
+void tst_QGeoJson::reader_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("geometry") << QStringLiteral("04-polygon.json");
+    QTest::newRow("collection") << QStringLiteral("07-geometrycollection.json");
+    QTest::newRow("feature") << QStringLiteral("08-feature.json");
+    QTest::newRow("feature collection") << QStringLiteral("09-featurecollection.json");
+    QTest::newRow("countries") << QStringLiteral("10-countries.json");
+    QTest::newRow("full") << QStringLiteral("11-full.json");
+}
+
+void tst_QGeoJson::reader()
+{
+    QFETCH(QString, fileName);
+
+    QFile file(QFINDTESTDATA(fileName));
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+
+    QVariantList expected = QGeoJson::importGeoJson(QJsonDocument::fromJson(json));
+    QCOMPARE(expected.size(), 1);
+    if (expected.first().toMap().value(QStringLiteral("type")) == QStringLiteral("FeatureCollection"))
+        expected = expected.first().toMap().value(QStringLiteral("data")).toList();
+
+    // The file is memory mapped, the buffer is read in chunks
+    QVERIFY(file.seek(0));
+    QBuffer buffer;
+    buffer.setData(json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QIODevice *devices[] = { &file, &buffer };
+    for (QIODevice *device : devices) {
+        QGeoJsonReader reader(device);
+        for (const QVariant &item : qAsConst(expected)) {
+            QVERIFY2(reader.readNext(), qPrintable(reader.errorString()));
+            const QVariantMap map = item.toMap();
+            const QGeoJsonReader::Feature &feature = reader.feature();
+            QCOMPARE(feature.type, map.value(QStringLiteral("type")).toString());
+            QCOMPARE(feature.properties, map.value(QStringLiteral("properties")).toMap());
+            QCOMPARE(feature.id, map.value(QStringLiteral("id")));
+
+            // Compare the perimeters only: importGeoJson() carries the holes
+            // over between the polygons of a MultiPolygon.
+            QList<QGeoShape> shapes;
+            appendShapes(map, &shapes);
+            QCOMPARE(feature.shapes.size(), shapes.size());
+            for (int i = 0; i < shapes.size(); ++i) {
+                const QGeoShape &shape = feature.shapes.at(i);
+                QCOMPARE(shape.type(), shapes.at(i).type());
+                if (shape.type() == QGeoShape::CircleType)
+                    QCOMPARE(QGeoCircle(shape).center(), QGeoCircle(shapes.at(i)).center());
+                else if (shape.type() == QGeoShape::PathType)
+                    QCOMPARE(QGeoPath(shape).path(), QGeoPath(shapes.at(i)).path());
+                else if (shape.type() == QGeoShape::PolygonType)
+                    QCOMPARE(QGeoPolygon(shape).path(), QGeoPolygon(shapes.at(i)).path());
+            }
+        }
+        QVERIFY(!reader.readNext());
+        QVERIFY(reader.atEnd());
+        QVERIFY(!reader.hasError());
+        QCOMPARE(reader.featuresRead(), expected.size());
+    }
+
+    QGeoJsonReader truncated(json.left(json.size() / 2));
+    while (truncated.readNext()) { }
+    QVERIFY(truncated.hasError());
+}
+
+void tst_QGeoJson::readFeatures()
+{
+    QFile file(QFINDTESTDATA("10-countries.json"));
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+
+    QList<QGeoJsonReader::Feature> expected;
+    QGeoJsonReader reader(json);
+    while (reader.readNext())
+        expected.append(reader.feature());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(expected.size(), 180);
+
+    QBuffer buffer;
+    buffer.setData(json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QGeoJsonReader parallel(&buffer);
+    QList<QGeoJsonReader::Feature> features;
+    for (;;) {
+        const QList<QGeoJsonReader::Feature> batch = parallel.readFeatures(64);
+        QVERIFY(batch.size() <= 64);
+        if (batch.isEmpty())
+            break;
+        features += batch;
+    }
+    QVERIFY2(!parallel.hasError(), qPrintable(parallel.errorString()));
+    QVERIFY(parallel.atEnd());
+    QCOMPARE(parallel.featuresRead(), expected.size());
+
+    QCOMPARE(features.size(), expected.size());
+    for (int i = 0; i < features.size(); ++i) {
+        QCOMPARE(features.at(i).id, expected.at(i).id);
+        QCOMPARE(features.at(i).type, expected.at(i).type);
+        QCOMPARE(features.at(i).properties, expected.at(i).properties);
+        QCOMPARE(features.at(i).shapes, expected.at(i).shapes);
+    }
+
+    QGeoJsonReader all(json);
+    QCOMPARE(all.readFeatures().size(), expected.size());
+    QVERIFY(all.atEnd());
+
+    QGeoJsonReader invalid(QByteArray("{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\"},"
+                                      "{\"geometry\":{\"type\":\"Point\",\"coordinates\":[[1,2]]}}]}"));
+    QCOMPARE(invalid.readFeatures().size(), 1);
+    QVERIFY(invalid.hasError());
+}
+
+void tst_QGeoJson::writer_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("point") << QStringLiteral("01-point.json");
+    QTest::newRow("linestring") << QStringLiteral("02-linestring.json");
+    QTest::newRow("multipoint") << QStringLiteral("03-multipoint.json");
+    QTest::newRow("polygon") << QStringLiteral("04-polygon.json");
+    QTest::newRow("multilinestring") << QStringLiteral("05-multilinestring.json");
+    QTest::newRow("multipolygon") << QStringLiteral("06-multipolygon.json");
+    QTest::newRow("collection") << QStringLiteral("07-geometrycollection.json");
+    QTest::newRow("feature") << QStringLiteral("08-feature.json");
+    QTest::newRow("feature collection") << QStringLiteral("09-featurecollection.json");
+    QTest::newRow("countries") << QStringLiteral("10-countries.json");
+    QTest::newRow("full") << QStringLiteral("11-full.json");
+}
+
+void tst_QGeoJson::writer()
+{
+    QFETCH(QString, fileName);
+
+    QFile file(QFINDTESTDATA(fileName));
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QVariantList imported = QGeoJson::importGeoJson(QJsonDocument::fromJson(file.readAll()));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QGeoJsonWriter writer(&buffer);
+    QVERIFY2(writer.writeGeoJson(imported), qPrintable(writer.errorString()));
+
+    QJsonParseError error;
+    const QJsonDocument written = QJsonDocument::fromJson(buffer.data(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(written, QGeoJson::exportGeoJson(imported));
+}
+
+void tst_QGeoJson::writeFeatures()
+{
+    QFile file(QFINDTESTDATA("10-countries.json"));
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QGeoJsonWriter writer(&buffer);
+    writer.writeStartFeatureCollection();
+    QGeoJsonReader reader(json);
+    while (reader.readNext())
+        writer.writeFeature(reader.feature());
+    writer.writeEndFeatureCollection();
+    QVERIFY2(!writer.hasError(), qPrintable(writer.errorString()));
+    QCOMPARE(writer.featuresWritten(), reader.featuresRead());
+
+    QGeoJsonReader expected(json);
+    QGeoJsonReader written(buffer.data());
+    while (expected.readNext()) {
+        QVERIFY2(written.readNext(), qPrintable(written.errorString()));
+        QCOMPARE(written.feature().id, expected.feature().id);
+        QCOMPARE(written.feature().type, expected.feature().type);
+        QCOMPARE(written.feature().properties, expected.feature().properties);
+        QCOMPARE(written.feature().shapes, expected.feature().shapes);
+    }
+    QVERIFY(!written.readNext());
+    QVERIFY(!written.hasError());
+
+    // Only the coordinates are rounded, without trailing zeros
+    QVariantMap point;
+    point.insert(QStringLiteral("type"), QStringLiteral("Point"));
+    point.insert(QStringLiteral("data"), QVariant::fromValue(QGeoCircle(QGeoCoordinate(10.123456, 20.5))));
+    point.insert(QStringLiteral("properties"), QVariantMap{ { QStringLiteral("ratio"), 0.123456 } });
+    QBuffer rounded;
+    QVERIFY(rounded.open(QIODevice::WriteOnly));
+    QGeoJsonWriter roundedWriter(&rounded);
+    roundedWriter.setPrecision(2);
+    QVERIFY(roundedWriter.writeGeoJson(QVariantList{ point }));
+    QCOMPARE(rounded.data(), QByteArray("{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\","
+                                        "\"coordinates\":[20.5,10.12]},\"properties\":{\"ratio\":0.123456},"
+                                        "\"id\":null}"));
+
+    // A second root object would not be valid GeoJSON
+    roundedWriter.writeFeature(point);
+    QVERIFY(roundedWriter.hasError());
+}
+
+// The coordinates of a long path go to the device in chunks, not in a single write
+void tst_QGeoJson::writeLongPath()
+{
+    QList<QGeoCoordinate> track;
+    for (int i = 0; i < 100000; ++i)
+        track.append(QGeoCoordinate(45.0 + i * 1e-6, 7.0 + i * 1e-6, 300.5));
+    QVariantMap line;
+    line.insert(QStringLiteral("type"), QStringLiteral("LineString"));
+    line.insert(QStringLiteral("data"), QVariant::fromValue(QGeoPath(track)));
+
+    WriteRecorder device;
+    QVERIFY(device.open(QIODevice::WriteOnly));
+    QGeoJsonWriter writer(&device);
+    QVERIFY2(writer.writeGeoJson(QVariantList{ line }), qPrintable(writer.errorString()));
+    QVERIFY(device.data().size() > 1024 * 1024);
+    QVERIFY(device.largestWrite < 65 * 1024);
+
+    QJsonParseError error;
+    const QJsonDocument written = QJsonDocument::fromJson(device.data(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(written, QGeoJson::exportGeoJson(QVariantList{ line }));
+}
+
+void tst_QGeoJson::binaryFeatures()
+{
+    QFile file(QFINDTESTDATA("10-countries.json"));
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+
+    const QList<QGeoBinaryFeatures::Feature> expected = QGeoBinaryFeatures::fromGeoJson(QGeoJson::importGeoJson(document));
+    QCOMPARE(expected.size(), 180);
+    const QByteArray encoded = QGeoBinaryFeatures::encode(expected);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile binaryFile(dir.filePath(QStringLiteral("countries.bin")));
+    QVERIFY(binaryFile.open(QFile::WriteOnly));
+    QCOMPARE(binaryFile.write(encoded), qint64(encoded.size()));
+    binaryFile.close();
+
+    QGeoBinaryFeatures binary;
+    QVERIFY2(binary.open(binaryFile.fileName()), qPrintable(binary.errorString()));
+    QCOMPARE(binary.featureCount(), expected.size());
+
+    const QList<QGeoBinaryFeatures::Feature> features = binary.features();
+    QCOMPARE(features.size(), expected.size());
+    for (int i = 0; i < features.size(); ++i) {
+        QCOMPARE(features.at(i).id, expected.at(i).id);
+        QCOMPARE(features.at(i).type, expected.at(i).type);
+        QCOMPARE(features.at(i).properties, expected.at(i).properties);
+        QCOMPARE(features.at(i).shapes, expected.at(i).shapes);
+    }
+
+    // Round trip through QGeoJson
+    QCOMPARE(QGeoJson::exportGeoJson(QGeoBinaryFeatures::toGeoJson(features)), document);
+
+    // The index returns the same features as a linear scan
+    const QGeoRectangle viewports[] = {
+        QGeoRectangle(QGeoCoordinate(47.0, 6.0), QGeoCoordinate(36.0, 19.0)),
+        QGeoRectangle(QGeoCoordinate(10.0, -80.0), QGeoCoordinate(-60.0, -30.0)),
+        QGeoRectangle(QGeoCoordinate(70.0, 170.0), QGeoCoordinate(50.0, -170.0))
+    };
+    for (const QGeoRectangle &viewport : viewports) {
+        QVector<int> scanned;
+        for (int i = 0; i < expected.size(); ++i) {
+            for (const QGeoShape &shape : expected.at(i).shapes) {
+                if (shape.boundingGeoRectangle().intersects(viewport)) {
+                    scanned.append(i);
+                    break;
+                }
+            }
+        }
+        const QVector<int> indexed = binary.query(viewport);
+        QVERIFY(!indexed.isEmpty());
+        QVERIFY(indexed.size() < expected.size());
+        for (int index : scanned)
+            QVERIFY2(indexed.contains(index), qPrintable(expected.at(index).id.toString()));
+        QCOMPARE(binary.features(viewport).size(), indexed.size());
+    }
+    int russia = -1;
+    for (int i = 0; i < expected.size() && russia < 0; ++i) {
+        if (expected.at(i).id == QStringLiteral("RUS"))
+            russia = i;
+    }
+    QVERIFY(binary.query(viewports[2]).contains(russia));
+
+    QGeoBinaryFeatures truncated;
+    QVERIFY(!truncated.setData(encoded.left(64)));
+    QVERIFY(!truncated.isOpen());
+}
+
+static QStringList featureIds(const QGeoJsonViewportModel &model)
+{
+    QStringList ids;
+    for (int row = 0; row < model.rowCount(); ++row)
+        ids.append(model.index(row).data(QGeoJsonViewportModel::FeatureIdRole).toString());
+    return ids;
+}
+
+void tst_QGeoJson::viewportModel()
+{
+    QGeoJsonViewportModel model;
+    model.setZoomLevel(5.0);
+    model.setVisibleRegion(QGeoRectangle(QGeoCoordinate(47.0, 6.0), QGeoCoordinate(36.0, 19.0)));
+    model.setSource(QUrl::fromLocalFile(QFINDTESTDATA("10-countries.json")));
+    QCOMPARE(model.status(), QGeoJsonViewportModel::Loading);
+    QTRY_COMPARE(model.status(), QGeoJsonViewportModel::Ready);
+    QCOMPARE(model.featureCount(), 180);
+    QVERIFY(model.rowCount() > 0);
+    QVERIFY(model.rowCount() < model.featureCount());
+    QVERIFY(featureIds(model).contains(QStringLiteral("ITA")));
+    QCOMPARE(model.index(0).data(QGeoJsonViewportModel::ShapeRole).value<QGeoShape>().type(),
+             QGeoShape::PolygonType);
+
+    // A small pan stays within the margin
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    model.setVisibleRegion(QGeoRectangle(QGeoCoordinate(47.5, 6.5), QGeoCoordinate(36.5, 19.5)));
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+
+    model.setVisibleRegion(QGeoRectangle(QGeoCoordinate(0.0, -60.0), QGeoCoordinate(-20.0, -40.0)));
+    QVERIFY(removed.count() > 0);
+    QVERIFY(!featureIds(model).contains(QStringLiteral("ITA")));
+    QVERIFY(featureIds(model).contains(QStringLiteral("BRA")));
+
+    // Small countries are left out when zoomed out, with some hysteresis
+    model.setVisibleRegion(QGeoRectangle(QGeoCoordinate(90.0, -180.0), QGeoCoordinate(-90.0, 180.0)));
+    model.setZoomLevel(10.0);
+    const int zoomedIn = model.rowCount();
+    model.setZoomLevel(9.9);
+    QCOMPARE(model.rowCount(), zoomedIn);
+    model.setZoomLevel(0.0);
+    QVERIFY(model.rowCount() < zoomedIn);
+    QVERIFY(featureIds(model).contains(QStringLiteral("RUS")));
+
+    model.setSource(QUrl::fromLocalFile(QStringLiteral("does-not-exist.json")));
+    QTRY_COMPARE(model.status(), QGeoJsonViewportModel::Error);
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(!model.errorString().isEmpty());
+}
+
 QTEST_MAIN(tst_QGeoJson)
 #include "tst_qgeojson.moc"
@@ -0,0 +1,8 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeolatestvaluemailbox
+
+SOURCES += \
+    tst_qgeolatestvaluemailbox.cpp
+
+QT += location-private positioning-private quick-private testlib
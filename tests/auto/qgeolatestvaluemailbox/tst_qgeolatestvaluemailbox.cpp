@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/labs
+
+#include <QtTest/QtTest>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtLocation/private/qdeclarativegeomappositionindicator_p.h>
+
+QT_USE_NAMESPACE
+
+namespace {
+
+// Torn when check isn't -value
+struct Value
+{
+    int value = -1;
+    int check = 1;
+};
+
+}
+
+class tst_QGeoLatestValueMailbox : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void take();
+    void overwrite();
+    void wakeUp();
+    void threads();
+};
+
+void tst_QGeoLatestValueMailbox::take()
+{
+    QGeoLatestValueMailbox<int> mailbox;
+    int value = 0;
+    QVERIFY(!mailbox.take(&value));
+
+    mailbox.publish(1);
+    QVERIFY(mailbox.take(&value));
+    QCOMPARE(value, 1);
+    QVERIFY(!mailbox.take(&value));
+    QCOMPARE(value, 1);
+
+    mailbox.publish(2);
+    QVERIFY(mailbox.take(&value));
+    QCOMPARE(value, 2);
+    QVERIFY(!mailbox.take(&value));
+}
+
+void tst_QGeoLatestValueMailbox::overwrite()
+{
+    QGeoLatestValueMailbox<int> mailbox;
+    int value = 0;
+    for (int i = 1; i <= 5; ++i)
+        mailbox.publish(i);
+    QVERIFY(mailbox.take(&value));
+    QCOMPARE(value, 5);
+    QVERIFY(!mailbox.take(&value));
+
+    // The slot given back by the reader is written next
+    mailbox.publish(6);
+    mailbox.publish(7);
+    QVERIFY(mailbox.take(&value));
+    QCOMPARE(value, 7);
+    QVERIFY(!mailbox.take(&value));
+}
+
+void tst_QGeoLatestValueMailbox::wakeUp()
+{
+    QGeoLatestValueMailbox<int> mailbox;
+    int value = 0;
+
+    // The reader starts asleep
+    QVERIFY(!mailbox.publish(1));
+    QVERIFY(!mailbox.setAwake(true));
+    QVERIFY(mailbox.publish(2));
+    QVERIFY(mailbox.take(&value));
+    QCOMPARE(value, 2);
+
+    // Nothing came, so the reader sleeps and the next value wakes it
+    QVERIFY(!mailbox.setAwake(false));
+    QVERIFY(!mailbox.publish(3));
+    QVERIFY(!mailbox.publish(4));
+    QVERIFY(!mailbox.setAwake(true));
+    QVERIFY(mailbox.take(&value));
+    QCOMPARE(value, 4);
+
+    // A value came before going to sleep, so the reader stays awake
+    QVERIFY(mailbox.publish(5));
+    QVERIFY(mailbox.setAwake(false));
+    QVERIFY(mailbox.publish(6));
+    QVERIFY(mailbox.take(&value));
+    QCOMPARE(value, 6);
+    QVERIFY(!mailbox.setAwake(false));
+    QVERIFY(!mailbox.publish(7));
+}
+
+// The reader sleeps on a semaphore the writer releases whenever publish()
+// finds it asleep: it gets no torn nor older values, and is never left
+// asleep with a value to take.
+void tst_QGeoLatestValueMailbox::threads()
+{
+    const int count = 200000;
+    QGeoLatestValueMailbox<Value> mailbox;
+    QSemaphore wakeUps;
+    QAtomicInt torn { 0 };
+    QAtomicInt older { 0 };
+    QAtomicInt lost { 0 };
+    int last = -1;
+
+    QScopedPointer<QThread> reader(QThread::create([&]() {
+        mailbox.setAwake(true);
+        Value value;
+        while (last != count - 1) {
+            if (mailbox.take(&value)) {
+                if (value.check != -value.value)
+                    torn.ref();
+                if (value.value <= last)
+                    older.ref();
+                last = value.value;
+            } else if (!mailbox.setAwake(false)) {
+                if (!wakeUps.tryAcquire(1, 5000)) {
+                    lost.ref();
+                    return;
+                }
+                mailbox.setAwake(true);
+            }
+        }
+    }));
+    QScopedPointer<QThread> writer(QThread::create([&]() {
+        for (int i = 0; i < count; ++i) {
+            Value value;
+            value.value = i;
+            value.check = -i;
+            if (!mailbox.publish(value))
+                wakeUps.release();
+        }
+    }));
+
+    reader->start();
+    writer->start();
+    QVERIFY(writer->wait(60000));
+    QVERIFY(reader->wait(60000));
+    QCOMPARE(int(torn), 0);
+    QCOMPARE(int(older), 0);
+    QCOMPARE(int(lost), 0);
+    QCOMPARE(last, count - 1);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoLatestValueMailbox)
+
+#include "tst_qgeolatestvaluemailbox.moc"
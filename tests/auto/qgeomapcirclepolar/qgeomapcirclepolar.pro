@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomapcirclepolar
+
+SOURCES += tst_qgeomapcirclepolar.cpp
+
+QT += location-private positioning-private quick testlib
@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/declarativemaps
+
+#include <QtTest/QtTest>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qdeclarativecirclemapitem_p_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapCirclePolar : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void crossesPole_data();
+    void crossesPole();
+    void onePole_data();
+    void onePole();
+    void bothPoles();
+
+private:
+    bool polarPaths(const QGeoCoordinate &center, qreal radius, QList<QList<QDoubleVector2D>> &fill,
+                    QList<QDoubleVector2D> &border, QRectF &bounds, int *samples = nullptr);
+    void compareWithGeometries(const QList<QList<QDoubleVector2D>> &fill,
+                               const QList<QDoubleVector2D> &border, const QRectF &bounds);
+    static bool fuzzyCompare(double a, double b) { return qAbs(a - b) < 1e-9; }
+
+    QScopedPointer<QGeoServiceProvider> m_provider;
+    QGeoMap *m_map = nullptr;
+};
+
+void tst_QGeoMapCirclePolar::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    parameters["finishRequestImmediately"] = true;
+    m_provider.reset(new QGeoServiceProvider("qmlgeo.test.plugin", parameters));
+    m_provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = m_provider->mappingManager();
+    QVERIFY2(m_provider->error() == QGeoServiceProvider::NoError,
+             "Could not load plugin: " + m_provider->errorString().toLatin1());
+    m_map = mappingManager->createMap(this);
+    QVERIFY(m_map);
+    m_map->setViewportSize(QSize(256, 256));
+}
+
+// As QDeclarativeCircleMapItemPrivateOpenGL does in markSourceDirtyAndUpdate(), returns whether
+// the border is closed
+bool tst_QGeoMapCirclePolar::polarPaths(const QGeoCoordinate &center, qreal radius,
+                                        QList<QList<QDoubleVector2D>> &fill,
+                                        QList<QDoubleVector2D> &border, QRectF &bounds, int *samples)
+{
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_map->geoProjection());
+    QList<QGeoCoordinate> path;
+    QGeoCoordinate leftBound;
+    QDeclarativeCircleMapItemPrivate::calculatePeripheralPoints(path, center, radius,
+                                                                QDeclarativeCircleMapItemPrivate::CircleSamples,
+                                                                leftBound);
+    QList<QDoubleVector2D> circlePath;
+    for (const QGeoCoordinate &c : qAsConst(path))
+        circlePath << p.geoToMapProjection(c);
+    if (samples)
+        *samples = circlePath.size();
+    return QDeclarativeCircleMapItemPrivate::calculatePolarPaths(circlePath, center, radius,
+                                                                 fill, border, bounds);
+}
+
+// As QDeclarativeCircleMapItemPrivateOpenGL does in updatePolish() for a pole crossing circle
+void tst_QGeoMapCirclePolar::compareWithGeometries(const QList<QList<QDoubleVector2D>> &fill,
+                                                   const QList<QDoubleVector2D> &border,
+                                                   const QRectF &bounds)
+{
+    QGeoMapPolygonGeometryOpenGL fillGeometry;
+    fillGeometry.markSourceDirty();
+    fillGeometry.updateSourcePoints(*m_map, fill, bounds);
+    QVERIFY(!fillGeometry.m_screenIndices.isEmpty());
+    QCOMPARE(fillGeometry.m_screenIndices.size() % 3, 0);
+    QCOMPARE(fillGeometry.m_origin, QDoubleVector2D(bounds.topLeft()));
+    QCOMPARE(fillGeometry.m_wrappedPolygons.size(), 3);
+    QCOMPARE(fillGeometry.m_wrappedPolygons.at(1).wrappedBboxes,
+             QDeclarativeGeoMapItemUtils::rectanglePath(bounds));
+
+    // The fill is what the item is sized by when there is no border
+    fillGeometry.updateScreenPoints(*m_map);
+    QVERIFY(!fillGeometry.sourceBoundingBox().isEmpty());
+
+    QGeoMapPolylineGeometryOpenGL borderGeometry;
+    borderGeometry.markSourceDirty();
+    borderGeometry.updateSourcePoints(*m_map, border, bounds);
+    QCOMPARE(borderGeometry.m_screenVertices->size(), border.size());
+    for (int i = 0; i < border.size(); ++i) {
+        const QDoubleVector2D v = borderGeometry.m_screenVertices->at(i).toDoubleVector2D()
+                + borderGeometry.m_origin;
+        QVERIFY2(qAbs(v.x() - border.at(i).x()) < 1e-6 && qAbs(v.y() - border.at(i).y()) < 1e-6,
+                 qPrintable(QStringLiteral("vertex %1 is off").arg(i)));
+    }
+    QCOMPARE(borderGeometry.m_wrappedPolygons.size(), 3);
+    QCOMPARE(borderGeometry.m_wrappedPolygons.at(1).wrappedBboxes,
+             QDeclarativeGeoMapItemUtils::rectanglePath(bounds));
+}
+
+void tst_QGeoMapCirclePolar::crossesPole_data()
+{
+    QTest::addColumn<QGeoCoordinate>("center");
+    QTest::addColumn<qreal>("radius");
+    QTest::addColumn<bool>("crosses");
+
+    QTest::newRow("equator") << QGeoCoordinate(0, 0) << qreal(1000000) << false;
+    QTest::newRow("near north pole") << QGeoCoordinate(80, 10) << qreal(1000000) << false;
+    QTest::newRow("north pole") << QGeoCoordinate(80, 10) << qreal(2000000) << true;
+    QTest::newRow("south pole") << QGeoCoordinate(-80, 10) << qreal(2000000) << true;
+    QTest::newRow("both poles") << QGeoCoordinate(0, 0) << qreal(12000000) << true;
+}
+
+void tst_QGeoMapCirclePolar::crossesPole()
+{
+    QFETCH(QGeoCoordinate, center);
+    QFETCH(qreal, radius);
+    QFETCH(bool, crosses);
+    QCOMPARE(QDeclarativeCircleMapItemPrivate::crossEarthPole(center, radius), crosses);
+}
+
+void tst_QGeoMapCirclePolar::onePole_data()
+{
+    QTest::addColumn<QGeoCoordinate>("center");
+    QTest::addColumn<bool>("north");
+
+    QTest::newRow("north") << QGeoCoordinate(80, 10) << true;
+    QTest::newRow("south") << QGeoCoordinate(-80, 10) << false;
+    QTest::newRow("north, across the antimeridian") << QGeoCoordinate(75, 178) << true;
+}
+
+void tst_QGeoMapCirclePolar::onePole()
+{
+    QFETCH(QGeoCoordinate, center);
+    QFETCH(bool, north);
+    const qreal radius = 2000000;
+
+    QList<QList<QDoubleVector2D>> fill;
+    QList<QDoubleVector2D> border;
+    QRectF bounds;
+    int samples = 0;
+    // The perimeter goes once around the world, unrolled twice into an open strip
+    QVERIFY(!polarPaths(center, radius, fill, border, bounds, &samples));
+    QCOMPARE(border.size(), 2 * samples + 1);
+    QVERIFY(fuzzyCompare(border.last().x() - border.first().x(), 2.0));
+    QVERIFY(fuzzyCompare(border.last().y(), border.first().y()));
+
+    // Closed along the edge of the map on the side of the pole
+    QCOMPARE(fill.size(), 1);
+    QCOMPARE(fill.first().size(), border.size() + 2);
+    const double poleY = north ? 0.0 : 1.0;
+    QCOMPARE(fill.first().at(border.size()).y(), poleY);
+    QCOMPARE(fill.first().last().y(), poleY);
+
+    double minY = 1.0;
+    double maxY = 0.0;
+    for (const QDoubleVector2D &point : qAsConst(border)) {
+        QVERIFY(point.x() >= bounds.left() && point.x() <= bounds.right());
+        minY = qMin(minY, point.y());
+        maxY = qMax(maxY, point.y());
+    }
+    QVERIFY(fuzzyCompare(bounds.left(), border.first().x()));
+    QVERIFY(fuzzyCompare(bounds.width(), 2.0));
+    QVERIFY(bounds.left() >= 0.0 && bounds.left() < 1.0);
+    QCOMPARE(bounds.top(), north ? 0.0 : minY);
+    QCOMPARE(bounds.bottom(), north ? maxY : 1.0);
+
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(north ? 75 : -75, center.longitude()));
+    camera.setZoomLevel(2);
+    m_map->setCameraData(camera);
+    compareWithGeometries(fill, border, bounds);
+}
+
+void tst_QGeoMapCirclePolar::bothPoles()
+{
+    QList<QList<QDoubleVector2D>> fill;
+    QList<QDoubleVector2D> border;
+    QRectF bounds;
+    int samples = 0;
+    // The perimeter is a hole around the antipode, so the border stays a closed loop
+    QVERIFY(polarPaths(QGeoCoordinate(0, 0), 12000000, fill, border, bounds, &samples));
+    QCOMPARE(border.size(), samples);
+
+    // A band over two worlds, with the hole cut in each of them
+    QCOMPARE(fill.size(), 3);
+    QCOMPARE(fill.at(0), QDeclarativeGeoMapItemUtils::rectanglePath(bounds));
+    QCOMPARE(fill.at(1), border);
+    QCOMPARE(fill.at(2).size(), border.size());
+    for (int i = 0; i < border.size(); ++i) {
+        QVERIFY(fuzzyCompare(fill.at(2).at(i).x(), border.at(i).x() + 1.0));
+        QVERIFY(bounds.contains(border.at(i).toPointF()));
+    }
+
+    QVERIFY(bounds.left() >= 0.0 && bounds.left() < 1.0);
+    QVERIFY(fuzzyCompare(bounds.width(), 2.0));
+    QCOMPARE(bounds.top(), 0.0);
+    QCOMPARE(bounds.bottom(), 1.0);
+
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(0, 0));
+    camera.setZoomLevel(2);
+    m_map->setCameraData(camera);
+    compareWithGeometries(fill, border, bounds);
+}
+
+QTEST_MAIN(tst_QGeoMapCirclePolar)
+#include "tst_qgeomapcirclepolar.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomapicontexturecache
+
+SOURCES += tst_qgeomapicontexturecache.cpp
+
+QT += location-private quick testlib
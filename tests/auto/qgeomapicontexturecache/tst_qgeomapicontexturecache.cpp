@@ -0,0 +1,181 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/labs
+
+#include <QtTest/QtTest>
+#include <QtCore/QPointer>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGRendererInterface>
+#include <QtQuick/QSGTexture>
+#include <QtLocation/private/qgeomapicontexturecache_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapIconTextureCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void sharedTexture();
+    void unusedBound();
+    void releaseAfterInvalidate();
+
+private:
+    static QImage image(int i);
+
+    QScopedPointer<QQuickWindow> m_window;
+    QSharedPointer<QGeoMapIconTextureCache> m_cache;
+};
+
+void tst_QGeoMapIconTextureCache::initTestCase()
+{
+    // Textures in main memory, created in the thread of the window
+    QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+}
+
+void tst_QGeoMapIconTextureCache::init()
+{
+    m_window.reset(new QQuickWindow);
+    m_window->resize(64, 64);
+    m_window->show();
+    if (!QTest::qWaitFor([this]() { return m_window->isSceneGraphInitialized(); }))
+        QSKIP("No scene graph in this environment");
+    m_cache = QGeoMapIconTextureCache::forWindow(m_window.data());
+    QVERIFY(m_cache);
+    QCOMPARE(QGeoMapIconTextureCache::forWindow(m_window.data()), m_cache);
+}
+
+void tst_QGeoMapIconTextureCache::cleanup()
+{
+    m_cache.reset();
+    m_window.reset();
+}
+
+QImage tst_QGeoMapIconTextureCache::image(int i)
+{
+    QImage image(8, 8, QImage::Format_ARGB32_Premultiplied);
+    image.fill(QColor::fromRgb(QRgb(0xff000000 | i)));
+    return image;
+}
+
+// Icons with the same source share the image, hence the texture
+void tst_QGeoMapIconTextureCache::sharedTexture()
+{
+    const QImage first = image(1);
+    const QImage copy = first;
+    const QImage other = image(1); // same pixels, another image
+
+    QSGTexture *texture = m_cache->acquire(first);
+    QVERIFY(texture);
+    QCOMPARE(m_cache->acquire(copy), texture);
+    QSGTexture *otherTexture = m_cache->acquire(other);
+    QVERIFY(otherTexture);
+    QVERIFY(otherTexture != texture);
+    QVERIFY(!m_cache->acquire(QImage()));
+
+    // Kept while any of the icons hold it, and once released as well
+    QPointer<QSGTexture> guard(texture);
+    m_cache->release(texture);
+    QVERIFY(guard);
+    QCOMPARE(m_cache->acquire(first), texture);
+    m_cache->release(texture);
+    m_cache->release(texture);
+    QVERIFY(guard);
+    QCOMPARE(m_cache->acquire(copy), texture);
+    m_cache->release(texture);
+    m_cache->release(otherTexture);
+}
+
+// At most 64 released textures are kept, the least recently used are deleted
+void tst_QGeoMapIconTextureCache::unusedBound()
+{
+    const QImage held = image(1000);
+    QPointer<QSGTexture> heldTexture(m_cache->acquire(held));
+    QVERIFY(heldTexture);
+
+    QList<QImage> images;
+    QList<QPointer<QSGTexture>> textures;
+    for (int i = 0; i < 65; ++i) {
+        images << image(i);
+        QSGTexture *texture = m_cache->acquire(images.last());
+        QVERIFY(texture);
+        textures << texture;
+        m_cache->release(texture);
+    }
+    QVERIFY(!textures.at(0));
+    for (int i = 1; i < textures.size(); ++i)
+        QVERIFY2(textures.at(i), qPrintable(QStringLiteral("texture %1 was deleted").arg(i)));
+
+    // Acquiring a texture again makes it the most recently used one
+    QCOMPARE(m_cache->acquire(images.at(1)), textures.at(1).data());
+    m_cache->release(textures.at(1));
+    images << image(65);
+    m_cache->release(m_cache->acquire(images.last()));
+    QVERIFY(textures.at(1));
+    QVERIFY(!textures.at(2));
+    QVERIFY(textures.at(3));
+
+    // A texture in use is never deleted
+    QVERIFY(heldTexture);
+    m_cache->release(heldTexture);
+    QVERIFY(heldTexture);
+}
+
+// The textures go with the scene graph, the icons release them afterwards
+void tst_QGeoMapIconTextureCache::releaseAfterInvalidate()
+{
+    const QImage first = image(1);
+    QSGTexture *texture = m_cache->acquire(first);
+    QVERIFY(texture);
+    QPointer<QSGTexture> guard(texture);
+    const QImage second = image(2);
+    QPointer<QSGTexture> released(m_cache->acquire(second));
+    m_cache->release(released);
+    QVERIFY(released);
+
+    // As the render loop does when the graphics context goes away
+    emit m_window->sceneGraphInvalidated();
+    QVERIFY(!guard);
+    QVERIFY(!released);
+    m_cache->release(texture); // no-op
+
+    // A new scene graph gets new textures, counted from scratch
+    QSGTexture *recreated = m_cache->acquire(first);
+    QVERIFY(recreated);
+    QPointer<QSGTexture> recreatedGuard(recreated);
+    m_cache->release(recreated);
+    QVERIFY(recreatedGuard);
+}
+
+QTEST_MAIN(tst_QGeoMapIconTextureCache)
+
+#include "tst_qgeomapicontexturecache.moc"
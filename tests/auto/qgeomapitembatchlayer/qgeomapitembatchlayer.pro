@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomapitembatchlayer
+
+SOURCES += tst_qgeomapitembatchlayer.cpp
+
+QT += location-private positioning-private quick testlib
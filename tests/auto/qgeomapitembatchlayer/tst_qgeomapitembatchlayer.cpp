@@ -0,0 +1,342 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/declarativemaps
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qdeclarativegeomap_p.h>
+#include <QtLocation/private/qdeclarativepolygonmapitem_p.h>
+#include <QtLocation/private/qdeclarativepolygonmapitem_p_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+#include <QtLocation/private/qgeomapitembatchlayer_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapItemBatchLayer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void addFills();
+    void resizeFill();
+    void moveFill();
+    void removeFills();
+    void strokes();
+
+private:
+    QDeclarativePolygonMapItem *addItem();
+    void setFill(QGeoMapPolygonGeometryOpenGL &geometry, int vertexCount, float x = 0.0f, int wrapOffset = 1);
+    void setStroke(QGeoMapPolylineGeometryOpenGL &geometry, int vertexCount);
+    void verifyFills();
+
+    QDeclarativeGeoMap *m_quickMap = nullptr;
+    QGeoMapItemBatchLayer *m_layer = nullptr;
+    QList<QQuickItem *> m_items;
+    QGeoProjectionWebMercator m_projection;
+};
+
+void tst_QGeoMapItemBatchLayer::init()
+{
+    m_quickMap = new QDeclarativeGeoMap;
+    m_layer = new QGeoMapItemBatchLayer(m_quickMap, nullptr);
+
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(10.0, 10.0));
+    camera.setZoomLevel(10.0);
+    m_projection.setViewportSize(QSize(512, 512));
+    m_projection.setCameraData(camera);
+}
+
+void tst_QGeoMapItemBatchLayer::cleanup()
+{
+    qDeleteAll(m_items);
+    m_items.clear();
+    delete m_quickMap; // and the layer
+    m_quickMap = nullptr;
+    m_layer = nullptr;
+}
+
+QDeclarativePolygonMapItem *tst_QGeoMapItemBatchLayer::addItem()
+{
+    QDeclarativePolygonMapItem *item = new QDeclarativePolygonMapItem;
+    item->setAutoFadeIn(false);
+    m_items.append(item);
+    return item;
+}
+
+// A fan of vertexCount vertices, x apart, as triangulated
+void tst_QGeoMapItemBatchLayer::setFill(QGeoMapPolygonGeometryOpenGL &geometry, int vertexCount,
+                                        float x, int wrapOffset)
+{
+    geometry.m_origin = QDoubleVector2D(0.5, 0.5);
+    geometry.m_wrapOffset = wrapOffset;
+    geometry.m_screenVertices.clear();
+    geometry.m_screenIndices.clear();
+    for (int i = 0; i < vertexCount; ++i)
+        geometry.m_screenVertices.append(QDoubleVector2D(x * i, i % 2));
+    for (int i = 1; i + 1 < vertexCount; ++i)
+        geometry.m_screenIndices << 0 << quint32(i) << quint32(i + 1);
+    geometry.m_dataChanged = true;
+}
+
+// A zigzag, no vertex of which is dropped by the levels of detail
+void tst_QGeoMapItemBatchLayer::setStroke(QGeoMapPolylineGeometryOpenGL &geometry, int vertexCount)
+{
+    QList<QGeoCoordinate> path;
+    for (int i = 0; i < vertexCount; ++i)
+        path.append(QGeoCoordinate(10.0 + (i % 2) * 0.01, 10.0 + i * 0.01));
+    QList<QDoubleVector2D> mercator;
+    for (const QGeoCoordinate &c : qAsConst(path))
+        mercator.append(QWebMercator::coordToMercator(c));
+    geometry.updateSourcePoints(m_projection, mercator, QGeoPath(path).boundingGeoRectangle());
+}
+
+// The ranges of each batch tile its vertices and indices, and the indices of a range point into it
+void tst_QGeoMapItemBatchLayer::verifyFills()
+{
+    const QVector<QGeoMapItemBatchLayer::FillBatch> &batches = m_layer->fillBatches();
+    QVector<int> vertexCounts(batches.size()), indexCounts(batches.size());
+    for (const QGeoMapItemBatchLayer::Range &r : m_layer->fillRanges()) {
+        QVERIFY(r.batch >= 0 && r.batch < batches.size());
+        const QGeoMapItemBatchLayer::FillBatch &batch = batches.at(r.batch);
+        QVERIFY(r.vertexOffset + r.vertexCount <= batch.vertices.size());
+        QVERIFY(r.indexOffset + r.indexCount <= batch.indices.size());
+        for (int i = r.indexOffset; i < r.indexOffset + r.indexCount; ++i) {
+            QVERIFY(batch.indices.at(i) >= quint32(r.vertexOffset));
+            QVERIFY(batch.indices.at(i) < quint32(r.vertexOffset + r.vertexCount));
+        }
+        vertexCounts[r.batch] += r.vertexCount;
+        indexCounts[r.batch] += r.indexCount;
+    }
+    for (int i = 0; i < batches.size(); ++i) {
+        QCOMPARE(vertexCounts.at(i), batches.at(i).vertices.size());
+        QCOMPARE(indexCounts.at(i), batches.at(i).indices.size());
+    }
+}
+
+void tst_QGeoMapItemBatchLayer::addFills()
+{
+    QDeclarativePolygonMapItem *a = addItem();
+    QDeclarativePolygonMapItem *b = addItem();
+    QDeclarativePolygonMapItem *c = addItem();
+    QGeoMapPolygonGeometryOpenGL ga, gb, gc, gd;
+    setFill(ga, 4);
+    setFill(gb, 3);
+    setFill(gc, 5);
+
+    // one batch per color, the items one after the other
+    m_layer->updateFill(a, Qt::red, ga);
+    m_layer->updateFill(b, Qt::red, gb);
+    m_layer->updateFill(c, Qt::blue, gc);
+    QCOMPARE(m_layer->fillBatches().size(), 2);
+    QCOMPARE(m_layer->fillBatches().at(0).vertices.size(), 7);
+    QCOMPARE(m_layer->fillBatches().at(0).indices.size(), 9);
+    QCOMPARE(m_layer->fillBatches().at(1).vertices.size(), 5);
+    QCOMPARE(m_layer->fillRanges().value(a).vertexOffset, 0);
+    QCOMPARE(m_layer->fillRanges().value(b).vertexOffset, 4);
+    QCOMPARE(m_layer->fillRanges().value(b).indexOffset, 6);
+    QCOMPARE(m_layer->fillRanges().value(c).batch, 1);
+    QVERIFY(!ga.m_dataChanged);
+    verifyFills();
+
+    // the vertices are copied as they are, the origins being the same
+    const QGeoMapItemBatchLayer::FillBatch &batch = m_layer->fillBatches().at(0);
+    QCOMPARE(batch.origin, ga.m_origin);
+    for (int i = 0; i < gb.m_screenVertices.size(); ++i) {
+        QCOMPARE(batch.vertices.at(4 + i).x, gb.m_screenVertices.at(i).x);
+        QCOMPARE(batch.vertices.at(4 + i).y, gb.m_screenVertices.at(i).y);
+    }
+
+    // nothing is batched for a transparent or degenerate fill
+    QDeclarativePolygonMapItem *d = addItem();
+    m_layer->updateFill(d, Qt::transparent, ga);
+    setFill(gd, 2);
+    m_layer->updateFill(d, Qt::red, gd);
+    QVERIFY(!m_layer->fillRanges().contains(d));
+    QCOMPARE(m_layer->fillBatches().at(0).vertices.size(), 7);
+}
+
+void tst_QGeoMapItemBatchLayer::resizeFill()
+{
+    QDeclarativePolygonMapItem *a = addItem();
+    QDeclarativePolygonMapItem *b = addItem();
+    QDeclarativePolygonMapItem *c = addItem();
+    QGeoMapPolygonGeometryOpenGL ga, gb, gc;
+    setFill(ga, 4);
+    setFill(gb, 3);
+    setFill(gc, 5);
+    m_layer->updateFill(a, Qt::red, ga);
+    m_layer->updateFill(b, Qt::red, gb);
+    m_layer->updateFill(c, Qt::red, gc);
+    QCOMPARE(m_layer->fillRanges().value(c).vertexOffset, 7);
+
+    // same size: rewritten in place
+    setFill(gb, 3, 2.0f);
+    m_layer->updateFill(b, Qt::red, gb);
+    QCOMPARE(m_layer->fillRanges().value(b).vertexOffset, 4);
+    QCOMPARE(m_layer->fillBatches().at(0).vertices.at(6).x, 4.0f);
+    verifyFills();
+
+    // another size: moved to the end, the items after it moving down
+    setFill(gb, 6);
+    m_layer->updateFill(b, Qt::red, gb);
+    QCOMPARE(m_layer->fillBatches().size(), 1);
+    QCOMPARE(m_layer->fillBatches().at(0).vertices.size(), 15);
+    QCOMPARE(m_layer->fillBatches().at(0).indices.size(), 6 + 9 + 12);
+    QCOMPARE(m_layer->fillRanges().value(a).vertexOffset, 0);
+    QCOMPARE(m_layer->fillRanges().value(c).vertexOffset, 4);
+    QCOMPARE(m_layer->fillRanges().value(c).indexOffset, 6);
+    QCOMPARE(m_layer->fillRanges().value(b).vertexOffset, 9);
+    QCOMPARE(m_layer->fillRanges().value(b).vertexCount, 6);
+    QCOMPARE(m_layer->fillRanges().value(b).indexOffset, 15);
+    verifyFills();
+
+    // another color: moved to the batch of that color
+    m_layer->updateFill(a, Qt::green, ga);
+    QCOMPARE(m_layer->fillBatches().size(), 2);
+    QCOMPARE(m_layer->fillRanges().value(a).batch, 1);
+    QCOMPARE(m_layer->fillRanges().value(a).vertexOffset, 0);
+    QCOMPARE(m_layer->fillRanges().value(c).vertexOffset, 0);
+    QCOMPARE(m_layer->fillRanges().value(b).vertexOffset, 5);
+    QCOMPARE(m_layer->fillBatches().at(0).vertices.size(), 11);
+    verifyFills();
+}
+
+// A new wrap offset only shifts the vertices of the item
+void tst_QGeoMapItemBatchLayer::moveFill()
+{
+    QDeclarativePolygonMapItem *a = addItem();
+    QDeclarativePolygonMapItem *b = addItem();
+    QGeoMapPolygonGeometryOpenGL ga, gb;
+    setFill(ga, 4, 0.25f);
+    setFill(gb, 3);
+    m_layer->updateFill(a, Qt::red, ga);
+    m_layer->updateFill(b, Qt::red, gb);
+    const QVector<QDeclarativeGeoMapItemUtils::vec2> before = m_layer->fillBatches().at(0).vertices;
+
+    ga.m_wrapOffset = 2;
+    m_layer->updateFill(a, Qt::red, ga);
+    const QVector<QDeclarativeGeoMapItemUtils::vec2> &after = m_layer->fillBatches().at(0).vertices;
+    QCOMPARE(after.size(), before.size());
+    QCOMPARE(m_layer->fillRanges().value(a).wrapOffset, 1);
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(after.at(i).x, before.at(i).x + 1.0f);
+        QCOMPARE(after.at(i).y, before.at(i).y);
+    }
+    for (int i = 4; i < after.size(); ++i)
+        QCOMPARE(after.at(i).x, before.at(i).x);
+    verifyFills();
+}
+
+void tst_QGeoMapItemBatchLayer::removeFills()
+{
+    QDeclarativePolygonMapItem *a = addItem();
+    QDeclarativePolygonMapItem *b = addItem();
+    QDeclarativePolygonMapItem *c = addItem();
+    QGeoMapPolygonGeometryOpenGL ga, gb, gc;
+    setFill(ga, 4);
+    setFill(gb, 3);
+    setFill(gc, 5);
+    m_layer->updateFill(a, Qt::red, ga);
+    m_layer->updateFill(b, Qt::red, gb);
+    m_layer->updateFill(c, Qt::red, gc);
+
+    m_layer->removeItem(b);
+    QVERIFY(!m_layer->fillRanges().contains(b));
+    QCOMPARE(m_layer->fillBatches().at(0).vertices.size(), 9);
+    QCOMPARE(m_layer->fillBatches().at(0).indices.size(), 6 + 9);
+    QCOMPARE(m_layer->fillRanges().value(c).vertexOffset, 4);
+    QCOMPARE(m_layer->fillRanges().value(c).indexOffset, 6);
+    verifyFills();
+
+    // so does hiding it
+    a->setVisible(false);
+    m_layer->updateFill(a, Qt::red, ga);
+    QVERIFY(!m_layer->fillRanges().contains(a));
+    QCOMPARE(m_layer->fillRanges().value(c).vertexOffset, 0);
+    verifyFills();
+
+    m_layer->removeFill(c);
+    m_layer->removeFill(c);
+    QVERIFY(m_layer->fillRanges().isEmpty());
+    QCOMPARE(m_layer->fillBatches().at(0).vertices.size(), 0);
+    QCOMPARE(m_layer->fillBatches().at(0).indices.size(), 0);
+}
+
+void tst_QGeoMapItemBatchLayer::strokes()
+{
+    QDeclarativePolylineMapItem *a = new QDeclarativePolylineMapItem;
+    QDeclarativePolylineMapItem *b = new QDeclarativePolylineMapItem;
+    a->setAutoFadeIn(false);
+    b->setAutoFadeIn(false);
+    m_items << a << b;
+    QGeoMapPolylineGeometryOpenGL ga, gb;
+    setStroke(ga, 5);
+    setStroke(gb, 3);
+
+    // six vertices per segment
+    m_layer->updateStroke(a, Qt::red, 2.0f, Qt::FlatCap, ga, false, 0);
+    m_layer->updateStroke(b, Qt::red, 2.0f, Qt::FlatCap, gb, false, 0);
+    QCOMPARE(m_layer->strokeBatches().size(), 1);
+    QCOMPARE(m_layer->strokeRanges().value(a).vertexCount, 4 * 6);
+    QCOMPARE(m_layer->strokeRanges().value(b).vertexOffset, 4 * 6);
+    QCOMPARE(m_layer->strokeRanges().value(b).vertexCount, 2 * 6);
+    QCOMPARE(m_layer->strokeBatches().at(0).vertices.size(), 6 * 6);
+
+    // another width, cap or color is another batch
+    m_layer->updateStroke(b, Qt::red, 2.0f, Qt::SquareCap, gb, false, 0);
+    QCOMPARE(m_layer->strokeBatches().size(), 2);
+    QCOMPARE(m_layer->strokeRanges().value(b).batch, 1);
+    QCOMPARE(m_layer->strokeBatches().at(0).vertices.size(), 4 * 6);
+
+    // another size moves it to the end of its batch
+    m_layer->updateStroke(b, Qt::red, 2.0f, Qt::FlatCap, gb, false, 0);
+    setStroke(ga, 7);
+    m_layer->updateStroke(a, Qt::red, 2.0f, Qt::FlatCap, ga, false, 0);
+    QCOMPARE(m_layer->strokeRanges().value(b).vertexOffset, 0);
+    QCOMPARE(m_layer->strokeRanges().value(a).vertexOffset, 2 * 6);
+    QCOMPARE(m_layer->strokeRanges().value(a).vertexCount, 6 * 6);
+    QCOMPARE(m_layer->strokeBatches().at(0).vertices.size(), 8 * 6);
+
+    m_layer->removeItem(b);
+    QCOMPARE(m_layer->strokeRanges().value(a).vertexOffset, 0);
+    QCOMPARE(m_layer->strokeBatches().at(0).vertices.size(), 6 * 6);
+    m_layer->removeStroke(a);
+    QVERIFY(m_layer->strokeRanges().isEmpty());
+    QVERIFY(m_layer->strokeBatches().at(0).vertices.isEmpty());
+}
+
+QTEST_MAIN(tst_QGeoMapItemBatchLayer)
+
+#include "tst_qgeomapitembatchlayer.moc"
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qgeomappathculler
+
+SOURCES += tst_qgeomappathculler.cpp
+
+QT += location-private positioning-private testlib
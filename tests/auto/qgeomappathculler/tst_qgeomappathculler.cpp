@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtLocation/private/qgeomappathculler_p.h>
+#include <QtCore/qmath.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapPathCuller : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void allInside();
+    void collapseOutside();
+    void wrapping();
+    void rebuild();
+};
+
+static QList<QDoubleVector2D> ring(const QDoubleVector2D &center, double radius, int count)
+{
+    QList<QDoubleVector2D> points;
+    for (int i = 0; i < count; ++i) {
+        const double angle = 2.0 * M_PI * i / count;
+        points.append(center + QDoubleVector2D(radius * std::cos(angle), radius * std::sin(angle)));
+    }
+    return points;
+}
+
+static int noWrap(double)
+{
+    return 0;
+}
+
+static double noOffset(int)
+{
+    return 0.0;
+}
+
+void tst_QGeoMapPathCuller::allInside()
+{
+    const QList<QDoubleVector2D> path = ring(QDoubleVector2D(0.5, 0.5), 0.2, 10000);
+    QGeoMapPathCuller culler;
+    QVERIFY(!culler.isBuiltFor(path));
+    culler.build(path);
+    QVERIFY(culler.isBuiltFor(path));
+
+    QList<QDoubleVector2D> culled;
+    culler.cull(path, QRectF(0.0, 0.0, 1.0, 1.0), noWrap, noOffset, culled);
+    QCOMPARE(culled, path);
+}
+
+void tst_QGeoMapPathCuller::collapseOutside()
+{
+    const QList<QDoubleVector2D> path = ring(QDoubleVector2D(0.5, 0.5), 0.2, 100000);
+    QGeoMapPathCuller culler;
+    culler.build(path);
+
+    // Only the rightmost part of the ring crosses the rectangle
+    const QRectF clip(0.69, 0.49, 0.02, 0.02);
+    QList<QDoubleVector2D> culled;
+    culler.cull(path, clip, noWrap, noOffset, culled);
+    QVERIFY(culled.size() < 1000);
+
+    // Every point within the rectangle is kept, in order, and nothing is made up
+    QList<QDoubleVector2D> inside;
+    for (const QDoubleVector2D &point : path) {
+        if (clip.contains(point.toPointF()))
+            inside.append(point);
+    }
+    QVERIFY(!inside.isEmpty());
+    QList<QDoubleVector2D> culledInside;
+    for (const QDoubleVector2D &point : qAsConst(culled)) {
+        QVERIFY(path.contains(point));
+        if (clip.contains(point.toPointF()))
+            culledInside.append(point);
+    }
+    QCOMPARE(culledInside, inside);
+}
+
+void tst_QGeoMapPathCuller::wrapping()
+{
+    const QList<QDoubleVector2D> path = ring(QDoubleVector2D(0.5, 0.5), 0.2, 10000);
+    QGeoMapPathCuller culler;
+    culler.build(path);
+
+    // Points left of 0.5 move one map width to the right
+    auto piece = [](double x) { return x < 0.5 ? 1 : 0; };
+    auto offset = [](int piece) { return double(piece); };
+    QList<QDoubleVector2D> culled;
+    culler.cull(path, QRectF(1.2, 0.0, 0.2, 1.0), piece, offset, culled);
+
+    QVERIFY(!culled.isEmpty());
+    QVERIFY(culled.size() < path.size() / 2);
+    int inside = 0;
+    for (const QDoubleVector2D &point : qAsConst(culled)) {
+        if (point.x() >= 1.2)
+            ++inside;
+    }
+    QVERIFY(inside > 0);
+    for (const QDoubleVector2D &point : path) {
+        if (point.x() < 0.5 && point.x() + 1.0 <= 1.4)
+            QVERIFY(culled.contains(point + QDoubleVector2D(1.0, 0.0)));
+    }
+}
+
+void tst_QGeoMapPathCuller::rebuild()
+{
+    QList<QDoubleVector2D> path = ring(QDoubleVector2D(0.5, 0.5), 0.2, 100);
+    QGeoMapPathCuller culler;
+    culler.build(path);
+    path.append(QDoubleVector2D(0.5, 0.5));
+    QVERIFY(!culler.isBuiltFor(path));
+
+    QList<QDoubleVector2D> culled { QDoubleVector2D(0.1, 0.1) };
+    culler.cull(path, QRectF(0.0, 0.0, 1.0, 1.0), noWrap, noOffset, culled);
+    QVERIFY(culled.isEmpty());
+
+    culler.build(path);
+    culler.cull(path, QRectF(0.0, 0.0, 1.0, 1.0), noWrap, noOffset, culled);
+    QCOMPARE(culled, path);
+
+    culler.clear();
+    QVERIFY(!culler.isBuiltFor(path));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoMapPathCuller)
+
+#include "tst_qgeomappathculler.moc"
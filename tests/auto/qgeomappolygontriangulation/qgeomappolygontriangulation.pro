@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomappolygontriangulation
+
+SOURCES += tst_qgeomappolygontriangulation.cpp
+
+QT += location-private positioning-private quick testlib
@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/declarativemaps
+
+#include <QtTest/QtTest>
+#include <QtCore/QPointer>
+#include <QtCore/qmath.h>
+#include <QtCore/QThreadPool>
+#include <QtPositioning/QGeoPolygon>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qdeclarativepolygonmapitem_p_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapPolygonTriangulation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void supersededResult();
+    void deletedWhileRunning();
+
+private:
+    void setPolygon(QGeoMapPolygonGeometryOpenGL &geometry, const QGeoPolygon &polygon);
+    static QGeoPolygon circle(int points);
+    static QGeoPolygon triangle();
+
+    QScopedPointer<QGeoServiceProvider> m_provider;
+    QGeoMap *m_map = nullptr;
+};
+
+void tst_QGeoMapPolygonTriangulation::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    parameters["finishRequestImmediately"] = true;
+    m_provider.reset(new QGeoServiceProvider("qmlgeo.test.plugin", parameters));
+    m_provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = m_provider->mappingManager();
+    QVERIFY2(m_provider->error() == QGeoServiceProvider::NoError,
+             "Could not load plugin: " + m_provider->errorString().toLatin1());
+    m_map = mappingManager->createMap(this);
+    QVERIFY(m_map);
+    m_map->setViewportSize(QSize(256, 256));
+}
+
+// As QDeclarativePolygonMapItem does in updatePolish()
+void tst_QGeoMapPolygonTriangulation::setPolygon(QGeoMapPolygonGeometryOpenGL &geometry,
+                                                 const QGeoPolygon &polygon)
+{
+    geometry.markSourceDirty();
+    geometry.setPreserveGeometry(true, polygon.boundingGeoRectangle().topLeft());
+    geometry.updateSourcePoints(*m_map, polygon);
+}
+
+// Long enough to triangulate that the path changes before it is done
+QGeoPolygon tst_QGeoMapPolygonTriangulation::circle(int points)
+{
+    QList<QGeoCoordinate> path;
+    for (int i = 0; i < points; ++i) {
+        const double angle = 2.0 * M_PI * i / points;
+        path.append(QGeoCoordinate(10.0 * std::sin(angle), 10.0 * std::cos(angle)));
+    }
+    return QGeoPolygon(path);
+}
+
+QGeoPolygon tst_QGeoMapPolygonTriangulation::triangle()
+{
+    return QGeoPolygon(QList<QGeoCoordinate>() << QGeoCoordinate(0, 0)
+                       << QGeoCoordinate(0, 20) << QGeoCoordinate(20, 10));
+}
+
+// The result of a triangulation for a path changed since is dropped, even when it is the last done
+void tst_QGeoMapPolygonTriangulation::supersededResult()
+{
+    QGeoMapPolygonGeometryOpenGL expected;
+    setPolygon(expected, triangle());
+    QVERIFY(!expected.m_screenIndices.isEmpty());
+
+    int ready = 0;
+    QGeoMapPolygonGeometryOpenGL geometry;
+    geometry.setAsynchronous(true, [&ready]() { ++ready; });
+    setPolygon(geometry, circle(20000));
+    QVERIFY(geometry.isTriangulationPending());
+    QVERIFY(geometry.m_screenIndices.isEmpty()); // nothing to draw until it is done
+    setPolygon(geometry, triangle());
+    QTRY_COMPARE(ready, 2);
+
+    QVERIFY(geometry.takeTriangulation());
+    QVERIFY(!geometry.isTriangulationPending());
+    QCOMPARE(geometry.m_screenVertices.size(), expected.m_screenVertices.size());
+    QCOMPARE(geometry.m_screenIndices, expected.m_screenIndices);
+    QVERIFY(!geometry.takeTriangulation());
+
+    // the previous triangulation stays until the next one is taken
+    setPolygon(geometry, circle(20001));
+    QCOMPARE(geometry.m_screenIndices, expected.m_screenIndices);
+    QTRY_COMPARE(ready, 3);
+    QVERIFY(geometry.takeTriangulation());
+    QVERIFY(geometry.m_screenIndices.size() > expected.m_screenIndices.size());
+
+    // and a cleared path drops the one in flight
+    setPolygon(geometry, triangle());
+    geometry.discardTriangulation();
+    QTRY_COMPARE(ready, 4);
+    QVERIFY(!geometry.takeTriangulation());
+}
+
+// The item, and its geometry, can go while their triangulation runs
+void tst_QGeoMapPolygonTriangulation::deletedWhileRunning()
+{
+    int ready = 0;
+    QScopedPointer<QObject> item(new QObject);
+    QPointer<QObject> guard(item.data());
+    QScopedPointer<QGeoMapPolygonGeometryOpenGL> geometry(new QGeoMapPolygonGeometryOpenGL);
+    // as the callback of QDeclarativePolygonMapItem
+    geometry->setAsynchronous(true, [guard, &ready]() {
+        if (guard)
+            ++ready;
+    });
+    setPolygon(*geometry, circle(20000));
+    QVERIFY(geometry->isTriangulationPending());
+    geometry.reset();
+    item.reset();
+
+    QThreadPool::globalInstance()->waitForDone();
+    QTest::qWait(50);
+    QCOMPARE(ready, 0);
+}
+
+QTEST_MAIN(tst_QGeoMapPolygonTriangulation)
+#include "tst_qgeomappolygontriangulation.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomappolylineappend
+
+SOURCES += tst_qgeomappolylineappend.cpp
+
+QT += location-private positioning-private quick testlib
@@ -0,0 +1,257 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/declarativemaps
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPath>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapPolylineAppend : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void appendMatchesRebuild();
+    void reservedRoom();
+    void leftBoundMoved();
+    void appendWhileSimplifying();
+
+private:
+    bool update(QGeoMapPolylineGeometryOpenGL &geometry, const QGeoPath &path, bool appended);
+    void compareWithRebuild(const QGeoMapPolylineGeometryOpenGL &geometry, const QGeoPath &path);
+    static QList<QDoubleVector2D> mercator(const QGeoMapPolylineGeometryOpenGL &geometry, int lod = 0);
+    static QGeoPath zigzag(int count);
+    static void extend(QGeoPath &path, int count);
+
+    QScopedPointer<QGeoServiceProvider> m_provider;
+    QGeoMap *m_map = nullptr;
+};
+
+void tst_QGeoMapPolylineAppend::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    parameters["finishRequestImmediately"] = true;
+    m_provider.reset(new QGeoServiceProvider("qmlgeo.test.plugin", parameters));
+    m_provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = m_provider->mappingManager();
+    QVERIFY2(m_provider->error() == QGeoServiceProvider::NoError,
+             "Could not load plugin: " + m_provider->errorString().toLatin1());
+    m_map = mappingManager->createMap(this);
+    QVERIFY(m_map);
+    m_map->setViewportSize(QSize(256, 256));
+}
+
+// As QDeclarativePolylineMapItemPrivateOpenGLLineStrip does in updatePolish() and
+// updateMapItemPaintNode(), returns whether the points were appended
+bool tst_QGeoMapPolylineAppend::update(QGeoMapPolylineGeometryOpenGL &geometry,
+                                       const QGeoPath &path, bool appended)
+{
+    geometry.setPreserveGeometry(true, path.boundingGeoRectangle().topLeft());
+    const bool incremental = appended && !geometry.isSourceDirty()
+            && geometry.appendSourcePoints(*m_map, path);
+    if (!incremental)
+        geometry.markSourceDirty();
+    geometry.updateSourcePoints(*m_map, path);
+    geometry.setPreserveGeometry(false);
+    geometry.markClean();
+    return incremental;
+}
+
+void tst_QGeoMapPolylineAppend::compareWithRebuild(const QGeoMapPolylineGeometryOpenGL &geometry,
+                                                   const QGeoPath &path)
+{
+    QGeoMapPolylineGeometryOpenGL rebuilt;
+    QVERIFY(!update(rebuilt, path, false));
+
+    const QList<QDoubleVector2D> expected = mercator(rebuilt);
+    const QList<QDoubleVector2D> actual = mercator(geometry);
+    QCOMPARE(actual.size(), path.size());
+    QCOMPARE(actual.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QVERIFY2(qAbs(actual.at(i).x() - expected.at(i).x()) < 1e-9
+                 && qAbs(actual.at(i).y() - expected.at(i).y()) < 1e-9,
+                 qPrintable(QStringLiteral("vertex %1 is off").arg(i)));
+    }
+    QCOMPARE(geometry.m_wrappedPolygons.size(), rebuilt.m_wrappedPolygons.size());
+    for (int i = 0; i < rebuilt.m_wrappedPolygons.size(); ++i)
+        QCOMPARE(geometry.m_wrappedPolygons.at(i).wrappedBboxes, rebuilt.m_wrappedPolygons.at(i).wrappedBboxes);
+}
+
+QList<QDoubleVector2D> tst_QGeoMapPolylineAppend::mercator(const QGeoMapPolylineGeometryOpenGL &geometry, int lod)
+{
+    QList<QDoubleVector2D> vertices;
+    for (const auto &v : qAsConst(*geometry.m_verticesLOD.at(lod)))
+        vertices.append(v.toDoubleVector2D() + geometry.m_origin);
+    return vertices;
+}
+
+// Eastwards, so that appending keeps the left bound
+QGeoPath tst_QGeoMapPolylineAppend::zigzag(int count)
+{
+    QGeoPath path;
+    extend(path, count);
+    return path;
+}
+
+void tst_QGeoMapPolylineAppend::extend(QGeoPath &path, int count)
+{
+    for (int i = path.size(), end = path.size() + count; i < end; ++i)
+        path.addCoordinate(QGeoCoordinate(10.0 + (i % 2) * 0.001, 20.0 + i * 0.001));
+}
+
+void tst_QGeoMapPolylineAppend::appendMatchesRebuild()
+{
+    QGeoPath path = zigzag(200);
+    QGeoMapPolylineGeometryOpenGL geometry;
+    QVERIFY(!update(geometry, path, false));
+    QCOMPARE(geometry.m_sourcePathLength, 200);
+    // a simplified level of detail, extended along
+    geometry.selectLOD(4, geometry.m_origin.x(), false);
+    QTRY_COMPARE(geometry.m_tasksInFlight->loadAcquire(), 0);
+    QVERIFY(!geometry.m_verticesLOD.at(1)->isEmpty());
+    const QList<QDoubleVector2D> simplified = mercator(geometry, 1);
+
+    extend(path, 10);
+    QVERIFY(update(geometry, path, true));
+    QCOMPARE(geometry.m_sourcePathLength, 210);
+    QCOMPARE(geometry.m_unsimplifiedTail, 10);
+    QCOMPARE(geometry.m_appendedSinceFill, 10);
+    compareWithRebuild(geometry, path);
+
+    const QList<QDoubleVector2D> extended = mercator(geometry, 1);
+    QCOMPARE(extended.size(), simplified.size() + 10);
+    QCOMPARE(extended.mid(0, simplified.size()), simplified);
+    const QList<QDoubleVector2D> all = mercator(geometry);
+    QCOMPARE(extended.mid(simplified.size()), all.mid(200));
+
+    // nothing new is not an append
+    QVERIFY(!update(geometry, path, true));
+    compareWithRebuild(geometry, path);
+}
+
+// Past max(64, 1/8 of the vertices) unsimplified ones, the levels of detail are rebuilt
+void tst_QGeoMapPolylineAppend::reservedRoom()
+{
+    QGeoPath path = zigzag(200);
+    QGeoMapPolylineGeometryOpenGL geometry;
+    update(geometry, path, false);
+
+    extend(path, 40);
+    QVERIFY(update(geometry, path, true));
+    extend(path, 24);
+    QVERIFY(update(geometry, path, true));
+    QCOMPARE(geometry.m_unsimplifiedTail, 64);
+    compareWithRebuild(geometry, path);
+
+    extend(path, 1);
+    QVERIFY(!update(geometry, path, true));
+    QCOMPARE(geometry.m_unsimplifiedTail, 0);
+    QCOMPARE(geometry.m_appendedSinceFill, 0);
+    QCOMPARE(geometry.m_sourcePathLength, 265);
+    compareWithRebuild(geometry, path);
+
+    // and it can be appended to again
+    extend(path, 10);
+    QVERIFY(update(geometry, path, true));
+    compareWithRebuild(geometry, path);
+}
+
+// A coordinate west of the path moves the left bound, and the wrapping of every vertex
+void tst_QGeoMapPolylineAppend::leftBoundMoved()
+{
+    QGeoPath path = zigzag(200);
+    QGeoMapPolylineGeometryOpenGL geometry;
+    update(geometry, path, false);
+
+    path.addCoordinate(QGeoCoordinate(10.5, 19.5));
+    QVERIFY(!update(geometry, path, true));
+    QCOMPARE(geometry.origin(), path.boundingGeoRectangle().topLeft());
+    compareWithRebuild(geometry, path);
+
+    // east of it again
+    path.addCoordinate(QGeoCoordinate(10.5, 20.5));
+    QVERIFY(update(geometry, path, true));
+    compareWithRebuild(geometry, path);
+}
+
+// The tasks read the vertices appended to, so a running one makes the append a rebuild
+void tst_QGeoMapPolylineAppend::appendWhileSimplifying()
+{
+    QGeoPath path = zigzag(2000);
+    QGeoMapPolylineGeometryOpenGL geometry;
+    update(geometry, path, false);
+    geometry.selectLOD(10, geometry.m_origin.x(), false);
+    const QSharedPointer<QAtomicInt> tasks = geometry.m_tasksInFlight;
+    const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2>> output = geometry.m_verticesLOD.at(3);
+    QVERIFY(!output.isNull());
+
+    // as long as a task holds the level of detail
+    tasks->ref();
+    extend(path, 10);
+    QVERIFY(!update(geometry, path, true));
+    QVERIFY(geometry.m_tasksInFlight != tasks);
+    QVERIFY(geometry.m_verticesLOD.at(3).isNull());
+    compareWithRebuild(geometry, path);
+    tasks->deref();
+
+    // the task of the previous vertices completes into them
+    QTRY_COMPARE(tasks->loadAcquire(), 0);
+    QVERIFY(!output->isEmpty());
+    compareWithRebuild(geometry, path);
+
+    // once done, the simplified level is extended
+    geometry.selectLOD(10, geometry.m_origin.x(), false);
+    QTRY_COMPARE(geometry.m_tasksInFlight->loadAcquire(), 0);
+    const int simplified = geometry.m_verticesLOD.at(3)->size();
+    QVERIFY(simplified > 0);
+    extend(path, 10);
+    QVERIFY(update(geometry, path, true));
+    QCOMPARE(geometry.m_verticesLOD.at(3)->size(), simplified + 10);
+    compareWithRebuild(geometry, path);
+}
+
+QTEST_MAIN(tst_QGeoMapPolylineAppend)
+#include "tst_qgeomappolylineappend.moc"
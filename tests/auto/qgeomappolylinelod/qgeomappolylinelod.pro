@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomappolylinelod
+
+SOURCES += tst_qgeomappolylinelod.cpp
+
+QT += location-private positioning-private quick testlib
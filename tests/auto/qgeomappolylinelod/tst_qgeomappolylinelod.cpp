@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtTest/QtTest>
+#include <QtQuick/QSGGeometry>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+
+QT_USE_NAMESPACE
+
+typedef QDeclarativeGeoMapItemUtils::vec2 Vertex;
+
+class ExtrudedNode : public MapPolylineNodeOpenGLExtruded
+{
+public:
+    using MapPolylineNodeOpenGLExtruded::MaxFilledGeometries;
+
+    int keptGeometries() const { return m_filledGeometries.size(); }
+};
+
+class tst_QGeoMapPolylineLOD : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void switchBack();
+    void keptGeometriesCapped();
+    void dataChangeDropsKept();
+
+private:
+    static void setZigzag(QGeoMapPolylineGeometryOpenGL &geometry, int count);
+    static void update(ExtrudedNode &node, QGeoMapPolylineGeometryOpenGL &geometry, unsigned int zoom);
+    static void switchTo(ExtrudedNode &node, QGeoMapPolylineGeometryOpenGL &geometry, unsigned int zoom);
+};
+
+// Dense enough for every level of detail to be simplified differently
+void tst_QGeoMapPolylineLOD::setZigzag(QGeoMapPolylineGeometryOpenGL &geometry, int count)
+{
+    QVector<Vertex> v;
+    for (int i = 0; i < count; ++i)
+        v.append(Vertex(QDoubleVector2D(0.1 + i * 0.0002, 0.5 + (i % 2) * 0.0001)));
+    *geometry.m_verticesLOD[0] = v;
+    geometry.m_screenVertices = geometry.m_verticesLOD[0].data();
+    geometry.m_dataChanged = true;
+}
+
+void tst_QGeoMapPolylineLOD::update(ExtrudedNode &node, QGeoMapPolylineGeometryOpenGL &geometry,
+                                    unsigned int zoom)
+{
+    node.update(QColor(Qt::red), 2.0f, &geometry, QMatrix4x4(), QDoubleVector3D(),
+                Qt::FlatCap, false, zoom);
+}
+
+// A level above 1 is simplified on the thread pool: the first update starts it, the one after
+// it is done switches to it
+void tst_QGeoMapPolylineLOD::switchTo(ExtrudedNode &node, QGeoMapPolylineGeometryOpenGL &geometry,
+                                      unsigned int zoom)
+{
+    update(node, geometry, zoom);
+    QTRY_COMPARE(geometry.m_tasksInFlight->loadAcquire(), 0);
+    update(node, geometry, zoom);
+    QVERIFY(geometry.isLODActive(zoom));
+}
+
+void tst_QGeoMapPolylineLOD::switchBack()
+{
+    QGeoMapPolylineGeometryOpenGL geometry;
+    ExtrudedNode node;
+    setZigzag(geometry, 2000);
+    switchTo(node, geometry, 21);
+    QSGGeometry *full = node.geometry();
+    QCOMPARE(full->vertexCount(), 1999 * 6);
+    QCOMPARE(node.keptGeometries(), 0);
+
+    switchTo(node, geometry, 4);
+    QSGGeometry *simplified = node.geometry();
+    QVERIFY(simplified != full);
+    QVERIFY(simplified->vertexCount() < full->vertexCount());
+    QCOMPARE(node.keptGeometries(), 1);
+
+    // back and forth, without extruding again
+    switchTo(node, geometry, 21);
+    QCOMPARE(node.geometry(), full);
+    QCOMPARE(node.keptGeometries(), 1);
+    switchTo(node, geometry, 4);
+    QCOMPARE(node.geometry(), simplified);
+    QCOMPARE(node.keptGeometries(), 1);
+}
+
+void tst_QGeoMapPolylineLOD::keptGeometriesCapped()
+{
+    QGeoMapPolylineGeometryOpenGL geometry;
+    ExtrudedNode node;
+    setZigzag(geometry, 2000);
+    switchTo(node, geometry, 21);
+
+    const unsigned int zooms[] = { 4, 7, 10, 13, 16, 19 };
+    QSGGeometry *previous = nullptr;
+    for (unsigned int zoom : zooms) {
+        previous = node.geometry();
+        switchTo(node, geometry, zoom);
+        QVERIFY(node.keptGeometries() <= ExtrudedNode::MaxFilledGeometries);
+    }
+    QCOMPARE(node.keptGeometries(), int(ExtrudedNode::MaxFilledGeometries));
+
+    // the level left last is still kept, the first ones are not
+    QSGGeometry *last = node.geometry();
+    switchTo(node, geometry, 16);
+    QCOMPARE(node.geometry(), previous);
+    switchTo(node, geometry, 19);
+    QCOMPARE(node.geometry(), last);
+    QCOMPARE(node.keptGeometries(), 1);
+    // extruded again
+    switchTo(node, geometry, 4);
+    QVERIFY(node.geometry()->vertexCount() > 0);
+    QCOMPARE(node.keptGeometries(), int(ExtrudedNode::MaxFilledGeometries));
+}
+
+void tst_QGeoMapPolylineLOD::dataChangeDropsKept()
+{
+    QGeoMapPolylineGeometryOpenGL geometry;
+    ExtrudedNode node;
+    setZigzag(geometry, 2000);
+    switchTo(node, geometry, 21);
+    switchTo(node, geometry, 4);
+    switchTo(node, geometry, 7);
+    QVERIFY(node.keptGeometries() > 0);
+
+    setZigzag(geometry, 500);
+    update(node, geometry, 7);
+    QCOMPARE(node.keptGeometries(), 0);
+    QTRY_COMPARE(geometry.m_tasksInFlight->loadAcquire(), 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoMapPolylineLOD)
+
+#include "tst_qgeomappolylinelod.moc"
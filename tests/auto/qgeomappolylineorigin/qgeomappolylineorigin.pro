@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomappolylineorigin
+
+SOURCES += tst_qgeomappolylineorigin.cpp
+
+QT += location-private positioning-private quick testlib
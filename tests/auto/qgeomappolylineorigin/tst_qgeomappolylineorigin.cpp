@@ -0,0 +1,133 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+
+QT_USE_NAMESPACE
+
+class ExtrudedNode : public MapPolylineNodeOpenGLExtruded
+{
+public:
+    const MapPolylineMaterialExtruded &material() const { return fill_material_; }
+};
+
+class tst_QGeoMapPolylineOrigin : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void vertexPrecision();
+    void nodeCenter();
+
+private:
+    void setPath(QGeoMapPolylineGeometryOpenGL &geometry);
+
+    QGeoProjectionWebMercator m_projection;
+    QList<QGeoCoordinate> m_path;
+};
+
+// A street at zoom level 20, far from the origin of the mercator projection, where a float
+// holds a mercator coordinate to about 6e-8, or 16 pixels
+void tst_QGeoMapPolylineOrigin::initTestCase()
+{
+    for (int i = 0; i < 5; ++i)
+        m_path.append(QGeoCoordinate(60.0 + i * 0.00001, 170.0 + (i % 2) * 0.00001));
+
+    QGeoCameraData camera;
+    camera.setCenter(m_path.at(2));
+    camera.setZoomLevel(20.0);
+    m_projection.setViewportSize(QSize(512, 512));
+    m_projection.setCameraData(camera);
+}
+
+void tst_QGeoMapPolylineOrigin::setPath(QGeoMapPolylineGeometryOpenGL &geometry)
+{
+    const QGeoPath path(m_path);
+    QList<QDoubleVector2D> mercator;
+    for (const QGeoCoordinate &c : qAsConst(m_path))
+        mercator.append(QWebMercator::coordToMercator(c));
+    geometry.updateSourcePoints(m_projection, mercator, path.boundingGeoRectangle());
+}
+
+// The float vertices are relative to the top left of the bounding box, the sums in double
+// give the mercator coordinates back well below a pixel
+void tst_QGeoMapPolylineOrigin::vertexPrecision()
+{
+    QGeoMapPolylineGeometryOpenGL geometry;
+    setPath(geometry);
+    QCOMPARE(geometry.m_origin, geometry.m_bboxLeftBoundWrapped);
+    QCOMPARE(geometry.m_screenVertices->size(), m_path.size());
+
+    const double pixel = 1.0 / (256.0 * (1 << 20));
+    for (int i = 0; i < m_path.size(); ++i) {
+        const QDoubleVector2D expected = QWebMercator::coordToMercator(m_path.at(i));
+        const QDoubleVector2D vertex = geometry.m_screenVertices->at(i).toDoubleVector2D();
+        QVERIFY(qAbs(vertex.x()) < 100 * pixel);
+        QVERIFY(qAbs(vertex.y()) < 100 * pixel);
+        const QDoubleVector2D actual = vertex + geometry.m_origin;
+        QVERIFY2(qAbs(actual.x() - expected.x()) < pixel / 100 && qAbs(actual.y() - expected.y()) < pixel / 100,
+                 qPrintable(QStringLiteral("vertex %1 is off").arg(i)));
+    }
+}
+
+// The shader gets the camera center relative to the origin, computed in double
+void tst_QGeoMapPolylineOrigin::nodeCenter()
+{
+    QGeoMapPolylineGeometryOpenGL geometry;
+    setPath(geometry);
+
+    ExtrudedNode node;
+    const QDoubleVector3D center(m_projection.centerMercator());
+    node.update(QColor(Qt::red), 2.0f, &geometry, QMatrix4x4(), center, Qt::FlatCap, false, 20);
+    QCOMPARE(node.material().origin(), geometry.m_origin);
+    QCOMPARE(node.material().center(), center - QDoubleVector3D(geometry.m_origin));
+    QVERIFY(qAbs(node.material().center().x()) < 1e-5);
+
+    // panning changes the center only
+    const QVector<QDeclarativeGeoMapItemUtils::vec2> vertices = *geometry.m_screenVertices;
+    const QDoubleVector3D panned = center + QDoubleVector3D(0.001, 0.0, 0.0);
+    node.update(QColor(Qt::red), 2.0f, &geometry, QMatrix4x4(), panned, Qt::FlatCap, false, 20);
+    QCOMPARE(node.material().center(), panned - QDoubleVector3D(geometry.m_origin));
+    QCOMPARE(geometry.m_screenVertices->size(), vertices.size());
+    for (int i = 0; i < vertices.size(); ++i) {
+        QCOMPARE(geometry.m_screenVertices->at(i).x, vertices.at(i).x);
+        QCOMPARE(geometry.m_screenVertices->at(i).y, vertices.at(i).y);
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoMapPolylineOrigin)
+
+#include "tst_qgeomappolylineorigin.moc"
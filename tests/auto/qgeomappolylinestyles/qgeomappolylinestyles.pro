@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomappolylinestyles
+
+SOURCES += tst_qgeomappolylinestyles.cpp
+
+QT += location-private positioning-private quick testlib
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtTest/QtTest>
+#include <QtQuick/QSGGeometry>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+
+QT_USE_NAMESPACE
+
+typedef QDeclarativeGeoMapItemUtils::vec2 Vertex;
+typedef MapPolylineNodeOpenGLExtruded::MapPolylineEntry Entry;
+
+class tst_QGeoMapPolylineStyles : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void assign();
+    void screenVertexSources();
+    void styledEntries();
+
+private:
+    static QVector<Vertex> vertices(int count);
+    static QVector<Vertex> pick(const QVector<Vertex> &v, const QVector<int> &indices);
+    static void setLevel(QGeoMapPolylineGeometryOpenGL &geometry, int lod, const QVector<Vertex> &v);
+};
+
+QVector<Vertex> tst_QGeoMapPolylineStyles::vertices(int count)
+{
+    QVector<Vertex> v;
+    for (int i = 0; i < count; ++i)
+        v.append(Vertex(QDoubleVector2D(i * 0.001, (i % 3) * 0.0005)));
+    return v;
+}
+
+QVector<Vertex> tst_QGeoMapPolylineStyles::pick(const QVector<Vertex> &v, const QVector<int> &indices)
+{
+    QVector<Vertex> picked;
+    for (int i : indices)
+        picked.append(v.at(i));
+    return picked;
+}
+
+// Makes a simplified level of detail the one on screen
+void tst_QGeoMapPolylineStyles::setLevel(QGeoMapPolylineGeometryOpenGL &geometry, int lod,
+                                         const QVector<Vertex> &v)
+{
+    geometry.m_verticesLOD[lod] = QSharedPointer<QVector<Vertex> >(new QVector<Vertex>(v));
+    geometry.m_screenVertices = geometry.m_verticesLOD[lod].data();
+}
+
+void tst_QGeoMapPolylineStyles::assign()
+{
+    QVector<MapPolylineVertexStyle> styles;
+    const QColor translucent(255, 0, 0, 128);
+    QVERIFY(MapPolylineVertexStyle::assign(styles, 2, 3, translucent, 2.0));
+    QCOMPARE(styles.size(), 5);
+    QVERIFY(!styles.at(0).isStyled());
+    QVERIFY(!styles.at(1).isStyled());
+    for (int i = 2; i < 5; ++i) {
+        QVERIFY(styles.at(i).isStyled());
+        QCOMPARE(styles.at(i).width, 2.0f);
+        // not premultiplied
+        QCOMPARE(int(styles.at(i).color[0]), 255);
+        QCOMPARE(int(styles.at(i).color[1]), 0);
+        QCOMPARE(int(styles.at(i).color[2]), 0);
+        QCOMPARE(int(styles.at(i).color[3]), 128);
+    }
+
+    // the same style again changes nothing
+    QVERIFY(!MapPolylineVertexStyle::assign(styles, 3, 2, translucent, 2.0));
+
+    // clearing in the middle keeps the entries
+    QVERIFY(MapPolylineVertexStyle::assign(styles, 3, 1, QColor(), 0.0));
+    QCOMPARE(styles.size(), 5);
+    QVERIFY(!styles.at(3).isStyled());
+    QVERIFY(styles.at(4).isStyled());
+
+    // clearing at the end drops the trailing unstyled entries
+    QVERIFY(MapPolylineVertexStyle::assign(styles, 4, 1, QColor(), 0.0));
+    QCOMPARE(styles.size(), 3);
+    QVERIFY(styles.at(2).isStyled());
+
+    // nothing to clear past the end
+    QVERIFY(!MapPolylineVertexStyle::assign(styles, 10, 2, QColor(), 0.0));
+    QCOMPARE(styles.size(), 3);
+
+    QVERIFY(MapPolylineVertexStyle::assign(styles, 0, 3, QColor(), -1.0));
+    QVERIFY(styles.isEmpty());
+}
+
+void tst_QGeoMapPolylineStyles::screenVertexSources()
+{
+    QGeoMapPolylineGeometryOpenGL geometry;
+    const QVector<Vertex> full = vertices(10);
+    *geometry.m_verticesLOD[0] = full;
+
+    QCOMPARE(geometry.screenVertexSources(), QVector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+
+    // a simplified level without the significance it was made with
+    const QVector<int> kept = { 0, 3, 4, 9 };
+    setLevel(geometry, 2, pick(full, kept));
+    QCOMPARE(geometry.screenVertexSources(), kept);
+
+    // a significance that no longer matches the level
+    geometry.m_significance = QSharedPointer<QVector<quint8> >(new QVector<quint8>(10, 0));
+    QCOMPARE(geometry.screenVertexSources(), kept);
+    geometry.m_significance.reset();
+
+    // repeated vertices are matched in order
+    QVector<Vertex> repeated = full;
+    repeated.insert(5, full.at(4));
+    *geometry.m_verticesLOD[0] = repeated;
+    setLevel(geometry, 3, pick(repeated, { 0, 4, 5, 10 }));
+    QCOMPARE(geometry.screenVertexSources(), QVector<int>({ 0, 4, 5, 10 }));
+
+    // vertices that were not taken from level 0 have no source
+    *geometry.m_verticesLOD[0] = full;
+    QVector<Vertex> foreign = pick(full, kept);
+    foreign[2] = Vertex(QDoubleVector2D(1.0, 1.0));
+    setLevel(geometry, 2, foreign);
+    QVERIFY(geometry.screenVertexSources().isEmpty());
+}
+
+// The styles reach the segments of a simplified level through their source vertices
+void tst_QGeoMapPolylineStyles::styledEntries()
+{
+    QGeoMapPolylineGeometryOpenGL geometry;
+    const QVector<Vertex> full = vertices(10);
+    *geometry.m_verticesLOD[0] = full;
+    setLevel(geometry, 2, pick(full, { 0, 3, 4, 9 }));
+
+    QVector<MapPolylineVertexStyle> styles;
+    MapPolylineVertexStyle::assign(styles, 3, 1, QColor(Qt::blue), 3.0);
+    geometry.setVertexStyles(styles);
+    QVERIFY(geometry.stylesChanged());
+
+    QSGGeometry sgGeometry(Entry::attributes(), 0);
+    geometry.fillEntries(&sgGeometry, false, false);
+    QVERIFY(!geometry.stylesChanged());
+    QCOMPARE(sgGeometry.vertexCount(), 3 * 6);
+    const Entry *entries = static_cast<const Entry *>(sgGeometry.vertexData());
+    for (int segment = 0; segment < 3; ++segment) {
+        for (int i = segment * 6; i < segment * 6 + 6; ++i) {
+            if (segment == 1) {
+                QCOMPARE(entries[i].style.width, 3.0f);
+                QCOMPARE(int(entries[i].style.color[2]), 255);
+            } else {
+                QVERIFY(!entries[i].style.isStyled());
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoMapPolylineStyles)
+
+#include "tst_qgeomappolylinestyles.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomapsnapshotrenderer
+
+SOURCES += tst_qgeomapsnapshotrenderer.cpp
+
+QT += location-private positioning-private qml quick testlib
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/declarativemaps
+
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+#include <QtGui/QOpenGLContext>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtLocation/private/qgeomapsnapshotrenderer_p.h>
+#include <QtLocation/private/qdeclarativegeomap_p.h>
+#include <QtLocation/private/qdeclarativegeomapitembase_p.h>
+#include <QtLocation/private/qdeclarativegeoserviceprovider_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapSnapshotRenderer : public QObject
+{
+    Q_OBJECT
+
+private:
+    QObject *create(const QByteArray &qml);
+    QDeclarativeGeoServiceProvider *plugin(int tileLatency = -1);
+    static QGeoCameraData camera(double zoomLevel);
+
+private Q_SLOTS:
+    void initTestCase();
+    void render();
+    void invalidSize();
+    void timeout();
+
+private:
+    QQmlEngine m_engine;
+};
+
+void tst_QGeoMapSnapshotRenderer::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QOpenGLContext context;
+    if (!context.create())
+        QSKIP("The renderer needs OpenGL");
+}
+
+QObject *tst_QGeoMapSnapshotRenderer::create(const QByteArray &qml)
+{
+    QQmlComponent component(&m_engine);
+    component.setData(qml, QUrl());
+    QObject *object = component.create();
+    if (!object)
+        qWarning() << component.errors();
+    else
+        object->setParent(this);
+    return object;
+}
+
+QDeclarativeGeoServiceProvider *tst_QGeoMapSnapshotRenderer::plugin(int tileLatency)
+{
+    QByteArray parameter = tileLatency < 0
+            ? QByteArray("PluginParameter { name: \"finishRequestImmediately\"; value: true }")
+            : "PluginParameter { name: \"tileLatency\"; value: " + QByteArray::number(tileLatency) + " }";
+    return qobject_cast<QDeclarativeGeoServiceProvider *>(create(
+        "import QtLocation 5.15\n"
+        "Plugin { name: \"qmlgeo.test.plugin\"; allowExperimental: true\n"
+        "    PluginParameter { name: \"tileSize\"; value: 256 }\n"
+        "    " + parameter + " }"));
+}
+
+QGeoCameraData tst_QGeoMapSnapshotRenderer::camera(double zoomLevel)
+{
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(10, 20));
+    camera.setZoomLevel(zoomLevel);
+    return camera;
+}
+
+void tst_QGeoMapSnapshotRenderer::render()
+{
+    QDeclarativeGeoServiceProvider *provider = plugin();
+    QVERIFY(provider);
+    QGeoMapSnapshotRenderer renderer(provider);
+    QSignalSpy spy(&renderer, SIGNAL(finished(QImage,bool)));
+
+    QDeclarativeGeoMapItemBase *circle = qobject_cast<QDeclarativeGeoMapItemBase *>(create(
+        "import QtLocation 5.15\n"
+        "import QtPositioning 5.5\n"
+        "MapCircle { center: QtPositioning.coordinate(10, 20); radius: 500000; color: \"red\" }"));
+    QVERIFY(circle);
+
+    QVERIFY(renderer.render(camera(3), QSize(300, 200), { circle }));
+    QVERIFY(renderer.isBusy());
+    QVERIFY(!renderer.render(camera(3), QSize(300, 200)));
+
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 10000);
+    QVERIFY(!renderer.isBusy());
+    QImage image = spy.first().at(0).value<QImage>();
+    QCOMPARE(spy.first().at(1).toBool(), true);
+    QCOMPARE(image.size(), QSize(300, 200));
+    QCOMPARE(renderer.map()->zoomLevel(), 3.0);
+
+    // the circle is drawn at the center, and taken off the map again
+    const QColor center = image.pixelColor(150, 100);
+    QVERIFY(center.red() > 200 && center.green() < 50 && center.blue() < 50);
+    QVERIFY(renderer.map()->mapItems().isEmpty());
+    QVERIFY(!circle->quickMap());
+
+    // the renderer is reused for other sizes
+    spy.clear();
+    QVERIFY(renderer.render(camera(4), QSize(100, 120)));
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 10000);
+    QCOMPARE(spy.first().at(1).toBool(), true);
+    image = spy.first().at(0).value<QImage>();
+    QCOMPARE(image.size(), QSize(100, 120));
+    QVERIFY(image.pixelColor(50, 60) != center);
+
+    // several renderers side by side, sharing the engine of the plugin
+    QGeoMapSnapshotRenderer other(provider);
+    QSignalSpy otherSpy(&other, SIGNAL(finished(QImage,bool)));
+    spy.clear();
+    QVERIFY(renderer.render(camera(2), QSize(64, 64)));
+    QVERIFY(other.render(camera(5), QSize(64, 64)));
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 10000);
+    QTRY_COMPARE_WITH_TIMEOUT(otherSpy.count(), 1, 10000);
+    QCOMPARE(otherSpy.first().at(1).toBool(), true);
+    QCOMPARE(other.map()->zoomLevel(), 5.0);
+}
+
+void tst_QGeoMapSnapshotRenderer::invalidSize()
+{
+    QGeoMapSnapshotRenderer renderer(plugin());
+    QVERIFY(!renderer.render(camera(3), QSize()));
+    QVERIFY(!renderer.render(camera(3), QSize(0, 100)));
+    QVERIFY(!renderer.isBusy());
+}
+
+void tst_QGeoMapSnapshotRenderer::timeout()
+{
+    // tiles arriving long after the timeout
+    QGeoMapSnapshotRenderer renderer(plugin(60000));
+    renderer.setTimeout(300);
+    QCOMPARE(renderer.timeout(), 300);
+    QSignalSpy spy(&renderer, SIGNAL(finished(QImage,bool)));
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(renderer.render(camera(3), QSize(128, 128)));
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 10000);
+    QVERIFY(timer.elapsed() >= 300);
+    QCOMPARE(spy.first().at(1).toBool(), false);
+    QCOMPARE(spy.first().at(0).value<QImage>().size(), QSize(128, 128));
+    QVERIFY(!renderer.isBusy());
+}
+
+QTEST_MAIN(tst_QGeoMapSnapshotRenderer)
+
+#include "tst_qgeomapsnapshotrenderer.moc"
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qgeomapspatialindex
+
+SOURCES += tst_qgeomapspatialindex.cpp
+
+QT += location-private testlib
@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtLocation/private/qgeomapspatialindex_p.h>
+#include <QtLocation/private/qmapcircleobject_p.h>
+#include <QtLocation/private/qmappolylineobject_p.h>
+#include <QtPositioning/QGeoCircle>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapSpatialIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void candidates();
+    void geometryChanged();
+    void antimeridian();
+    void lineWidth();
+    void region();
+    void boundingBox();
+};
+
+static QMapCircleObject *circle(const QGeoCoordinate &center, qreal radius, QObject *parent)
+{
+    QMapCircleObject *c = new QMapCircleObject(parent);
+    c->setCenter(center);
+    c->setRadius(radius);
+    return c;
+}
+
+void tst_QGeoMapSpatialIndex::candidates()
+{
+    QObject parent;
+    QGeoMapSpatialIndex index;
+    QList<QMapCircleObject *> circles;
+    for (int i = 0; i < 100; ++i) {
+        circles.append(circle(QGeoCoordinate(-45 + i * 0.9, -90 + i * 1.8), 1000, &parent));
+        index.insert(circles.last());
+    }
+
+    const QList<QObject *> found = index.candidatesAt(QGeoCoordinate(-45 + 50 * 0.9, -90 + 50 * 1.8), 1);
+    QVERIFY(found.contains(circles.at(50)));
+    QVERIFY(found.size() < 5);
+    QVERIFY(index.candidatesAt(QGeoCoordinate(80, 170), 1).isEmpty());
+
+    // Large objects are always candidates, in insertion order
+    QMapCircleObject *large = circle(QGeoCoordinate(0, 0), 5000000, &parent);
+    index.insert(large);
+    index.insert(circles.at(0)); // already indexed
+    const QList<QObject *> withLarge = index.candidatesAt(circles.at(0)->geoShape().center(), 1);
+    QCOMPARE(withLarge.size(), 2);
+    QCOMPARE(withLarge.first(), circles.at(0));
+    QCOMPARE(withLarge.last(), large);
+
+    index.remove(circles.at(0));
+    QCOMPARE(index.candidatesAt(circles.at(0)->geoShape().center(), 1), QList<QObject *>() << large);
+    QCOMPARE(QGeoMapSpatialIndex::geoShape(large), large->geoShape());
+}
+
+void tst_QGeoMapSpatialIndex::geometryChanged()
+{
+    QObject parent;
+    QGeoMapSpatialIndex index;
+    QMapCircleObject *c = circle(QGeoCoordinate(10, 10), 1000, &parent);
+    index.insert(c);
+    QCOMPARE(index.candidatesAt(QGeoCoordinate(10, 10), 1).size(), 1);
+
+    c->setCenter(QGeoCoordinate(-30, 120));
+    index.markDirty(c);
+    QVERIFY(index.candidatesAt(QGeoCoordinate(10, 10), 1).isEmpty());
+    QCOMPARE(index.candidatesAt(QGeoCoordinate(-30, 120), 1).size(), 1);
+
+    index.remove(c);
+    index.markDirty(c); // not indexed anymore
+    QVERIFY(index.candidatesAt(QGeoCoordinate(-30, 120), 1).isEmpty());
+}
+
+void tst_QGeoMapSpatialIndex::antimeridian()
+{
+    QObject parent;
+    QGeoMapSpatialIndex index;
+    QMapPolylineObject *line = new QMapPolylineObject(&parent);
+    line->setPath(QVariantList() << QVariant::fromValue(QGeoCoordinate(0, 179))
+                                 << QVariant::fromValue(QGeoCoordinate(0, -179)));
+    index.insert(line);
+
+    QCOMPARE(index.candidatesAt(QGeoCoordinate(0, 179.5), 1).size(), 1);
+    QCOMPARE(index.candidatesAt(QGeoCoordinate(0, -179.5), 1).size(), 1);
+    QVERIFY(index.candidatesAt(QGeoCoordinate(0, 0), 1).isEmpty());
+}
+
+void tst_QGeoMapSpatialIndex::lineWidth()
+{
+    QObject parent;
+    QGeoMapSpatialIndex index;
+    QMapPolylineObject *line = new QMapPolylineObject(&parent);
+    line->setPath(QVariantList() << QVariant::fromValue(QGeoCoordinate(0, 0))
+                                 << QVariant::fromValue(QGeoCoordinate(0, 1)));
+    index.insert(line, 20);
+
+    // 5 km north of the line, in a different cell, found only with a thick enough stroke
+    const QGeoCoordinate tap = QGeoCoordinate(0, 0.5).atDistanceAndAzimuth(5000, 0);
+    QVERIFY(index.candidatesAt(tap, 1).isEmpty());
+    QCOMPARE(index.candidatesAt(tap, 1000), QList<QObject *>() << line);
+}
+
+void tst_QGeoMapSpatialIndex::region()
+{
+    QObject parent;
+    QGeoMapSpatialIndex index;
+    QMapCircleObject *inside = circle(QGeoCoordinate(10, 10), 1000, &parent);
+    QMapCircleObject *outside = circle(QGeoCoordinate(10, 30), 1000, &parent);
+    index.insert(inside);
+    index.insert(outside);
+
+    const QGeoRectangle box(QGeoCoordinate(15, 5), QGeoCoordinate(5, 15));
+    QCOMPARE(index.candidatesIn(box), QList<QObject *>() << inside);
+    QVERIFY(QGeoMapSpatialIndex::intersects(box, inside->geoShape().boundingGeoRectangle()));
+    QVERIFY(!QGeoMapSpatialIndex::intersects(box, outside->geoShape().boundingGeoRectangle()));
+
+    // Boxes of circles are larger than the circles
+    const QGeoCircle around(QGeoCoordinate(10, 10), 100000);
+    QVERIFY(QGeoMapSpatialIndex::intersects(around, inside->geoShape().boundingGeoRectangle()));
+    QVERIFY(!QGeoMapSpatialIndex::intersects(QGeoCircle(QGeoCoordinate(10, 11.5), 60000),
+                                             inside->geoShape().boundingGeoRectangle()));
+
+    // Across the antimeridian
+    QMapCircleObject *dateline = circle(QGeoCoordinate(0, 179.99), 10000, &parent);
+    index.insert(dateline);
+    QCOMPARE(index.candidatesIn(QGeoRectangle(QGeoCoordinate(1, 179), QGeoCoordinate(-1, -179))),
+             QList<QObject *>() << dateline);
+}
+
+void tst_QGeoMapSpatialIndex::boundingBox()
+{
+    QObject parent;
+    QGeoMapSpatialIndex index;
+    QVERIFY(!index.boundingGeoRectangle().isValid());
+
+    // Enough objects to grow the tree a few times
+    QList<QMapCircleObject *> circles;
+    for (int i = 0; i < 100; ++i) {
+        circles.append(circle(QGeoCoordinate(-45 + i * 0.9, -90 + i * 1.8), 1000, &parent));
+        index.insert(circles.last());
+    }
+    QGeoRectangle expected;
+    for (QMapCircleObject *c: qAsConst(circles))
+        expected = expected.isValid() ? expected.united(c->geoShape().boundingGeoRectangle())
+                                      : c->geoShape().boundingGeoRectangle();
+    QCOMPARE(index.boundingGeoRectangle(), expected);
+
+    QList<QObject *> selection;
+    selection << circles.at(10) << circles.at(20);
+    QCOMPARE(index.boundingGeoRectangle(selection),
+             circles.at(10)->geoShape().boundingGeoRectangle()
+             .united(circles.at(20)->geoShape().boundingGeoRectangle()));
+
+    // Moved and removed objects update the box
+    circles.last()->setCenter(QGeoCoordinate(0, 0));
+    index.markDirty(circles.last());
+    index.remove(circles.first());
+    QVERIFY(index.boundingGeoRectangle().bottomRight().longitude() < expected.bottomRight().longitude());
+    QVERIFY(index.boundingGeoRectangle().topLeft().longitude() > expected.topLeft().longitude());
+    QVERIFY(index.boundingGeoRectangle().contains(QGeoCoordinate(0, 0)));
+
+    // A freed slot is reused
+    QMapCircleObject *far = circle(QGeoCoordinate(60, 100), 1000, &parent);
+    index.insert(far);
+    QVERIFY(index.boundingGeoRectangle().contains(QGeoCoordinate(60, 100)));
+
+    index.clear();
+    QVERIFY(!index.boundingGeoRectangle().isValid());
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoMapSpatialIndex)
+
+#include "tst_qgeomapspatialindex.moc"
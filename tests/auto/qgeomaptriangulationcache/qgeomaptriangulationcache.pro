@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qgeomaptriangulationcache
+
+SOURCES += tst_qgeomaptriangulationcache.cpp
+
+QT += location-private testlib
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtLocation/private/qgeomaptriangulationcache_p.h>
+#include <cmath>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapTriangulationCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void triangulate();
+    void contentKeyed();
+    void persistent();
+    void damagedFile();
+
+private:
+    static QGeoMapTriangulationCache::Polygon circle(int vertices, double radius = 1.0);
+};
+
+QGeoMapTriangulationCache::Polygon tst_QGeoMapTriangulationCache::circle(int vertices, double radius)
+{
+    QGeoMapTriangulationCache::Polygon polygon(1);
+    for (int i = 0; i < vertices; ++i) {
+        const double a = 2 * M_PI * i / vertices;
+        polygon.front().push_back({{ radius * std::cos(a), radius * std::sin(a) }});
+    }
+    return polygon;
+}
+
+void tst_QGeoMapTriangulationCache::triangulate()
+{
+    QGeoMapTriangulationCache cache;
+    const QVector<quint32> indices = cache.triangulate(circle(16), false);
+    QCOMPARE(indices.size(), (16 - 2) * 3);
+    for (quint32 i : indices)
+        QVERIFY(i < 16);
+
+    // A square with a square hole
+    QGeoMapTriangulationCache::Polygon withHole(2);
+    withHole[0] = { {{ 0, 0 }}, {{ 4, 0 }}, {{ 4, 4 }}, {{ 0, 4 }} };
+    withHole[1] = { {{ 1, 1 }}, {{ 1, 3 }}, {{ 3, 3 }}, {{ 3, 1 }} };
+    QCOMPARE(cache.triangulate(withHole, false).size(), 8 * 3);
+}
+
+void tst_QGeoMapTriangulationCache::contentKeyed()
+{
+    QGeoMapTriangulationCache cache;
+    const QVector<quint32> a = cache.triangulate(circle(100), false);
+    QCOMPARE(cache.triangulate(circle(100), false), a);
+
+    // Same vertex count but another shape must not get the triangulation of the circle:
+    // for a valid one the triangle areas add up to the area of the star.
+    QGeoMapTriangulationCache::Polygon star = circle(100);
+    for (std::size_t i = 0; i < star.front().size(); i += 2) {
+        star.front()[i][0] *= 0.5;
+        star.front()[i][1] *= 0.5;
+    }
+    const auto &v = star.front();
+    const QVector<quint32> b = cache.triangulate(star, false);
+    QCOMPARE(b.size(), a.size());
+    auto area = [&v](quint32 i, quint32 j, quint32 k) {
+        return 0.5 * ((v[j][0] - v[i][0]) * (v[k][1] - v[i][1]) - (v[k][0] - v[i][0]) * (v[j][1] - v[i][1]));
+    };
+    double polygonArea = 0.0;
+    for (std::size_t i = 1; i + 1 < v.size(); ++i)
+        polygonArea += area(0, quint32(i), quint32(i + 1));
+    double trianglesArea = 0.0;
+    for (int i = 0; i < b.size(); i += 3)
+        trianglesArea += qAbs(area(b[i], b[i + 1], b[i + 2]));
+    QVERIFY(qAbs(trianglesArea - qAbs(polygonArea)) < 1e-9);
+}
+
+void tst_QGeoMapTriangulationCache::persistent()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QGeoMapTriangulationCache::Polygon polygon = circle(2000);
+
+    QVector<quint32> expected;
+    {
+        QGeoMapTriangulationCache cache;
+        cache.setDirectory(dir.path());
+        expected = cache.triangulate(polygon, true);
+        QVERIFY(!expected.isEmpty());
+        cache.triangulate(circle(8), true); // too small to be worth a file
+    }
+    QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 1);
+
+    QGeoMapTriangulationCache cache;
+    cache.setDirectory(dir.path());
+    QCOMPARE(cache.triangulate(polygon, true), expected);
+}
+
+void tst_QGeoMapTriangulationCache::damagedFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QGeoMapTriangulationCache::Polygon polygon = circle(1000);
+    {
+        QGeoMapTriangulationCache cache;
+        cache.setDirectory(dir.path());
+        cache.triangulate(polygon, true);
+    }
+    const QStringList files = QDir(dir.path()).entryList(QDir::Files);
+    QCOMPARE(files.size(), 1);
+    QFile file(QDir(dir.path()).filePath(files.first()));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.resize(file.size() / 2);
+    file.close();
+
+    QGeoMapTriangulationCache cache;
+    cache.setDirectory(dir.path());
+    QCOMPARE(cache.triangulate(polygon, true).size(), (1000 - 2) * 3);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoMapTriangulationCache)
+
+#include "tst_qgeomaptriangulationcache.moc"
@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeonetworkaccessmanagerosm
+
+plugin.path = ../../../src/plugins/geoservices/osm/
+
+SOURCES += tst_qgeonetworkaccessmanagerosm.cpp \
+           $$plugin.path/qgeonetworkaccessmanagerosm.cpp
+HEADERS += $$plugin.path/qgeonetworkaccessmanagerosm.h
+INCLUDEPATH += $$plugin.path
+
+QT += location location-private network testlib
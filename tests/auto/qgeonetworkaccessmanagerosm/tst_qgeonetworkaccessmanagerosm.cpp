@@ -0,0 +1,133 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeonetworkaccessmanagerosm.h"
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtNetwork/QNetworkDiskCache>
+#include <QtNetwork/QNetworkReply>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoNetworkAccessManagerOsm : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sharedInstance();
+    void perThread();
+    void http2();
+    void diskCache();
+};
+
+// one manager for the engines with the same network parameters
+void tst_QGeoNetworkAccessManagerOsm::sharedInstance()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.useragent"), QStringLiteral("test"));
+    QSharedPointer<QGeoNetworkAccessManagerOsm> manager = QGeoNetworkAccessManagerOsm::instance(parameters);
+    QVERIFY(manager);
+    QCOMPARE(QGeoNetworkAccessManagerOsm::instance(QVariantMap()), manager);
+
+    QVariantMap http2;
+    http2.insert(QStringLiteral("osm.network.http2"), true);
+    QSharedPointer<QGeoNetworkAccessManagerOsm> other = QGeoNetworkAccessManagerOsm::instance(http2);
+    QVERIFY(other != manager);
+    QCOMPARE(QGeoNetworkAccessManagerOsm::instance(http2), other);
+
+    // and a new one once they are all gone
+    QPointer<QGeoNetworkAccessManagerOsm> released = manager.data();
+    manager.reset();
+    manager = QGeoNetworkAccessManagerOsm::instance(QVariantMap());
+    QVERIFY(manager);
+    QTRY_VERIFY(!released);
+}
+
+void tst_QGeoNetworkAccessManagerOsm::perThread()
+{
+    QSharedPointer<QGeoNetworkAccessManagerOsm> manager = QGeoNetworkAccessManagerOsm::instance(QVariantMap());
+    QGeoNetworkAccessManagerOsm *threadManager = nullptr;
+    bool inThread = false;
+    QThread *thread = QThread::create([&threadManager, &inThread]() {
+        // like the managers of the tile fetchers
+        QSharedPointer<QGeoNetworkAccessManagerOsm> m = QGeoNetworkAccessManagerOsm::instance(QVariantMap());
+        threadManager = m.data();
+        inThread = m->thread() == QThread::currentThread();
+    });
+    thread->start();
+    QVERIFY(thread->wait(5000));
+    delete thread;
+    QVERIFY(threadManager);
+    QVERIFY(threadManager != manager.data());
+    QVERIFY(inThread);
+}
+
+// HTTP/2 is allowed on the requests that leave it open
+void tst_QGeoNetworkAccessManagerOsm::http2()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.network.http2"), true);
+    QSharedPointer<QGeoNetworkAccessManagerOsm> manager = QGeoNetworkAccessManagerOsm::instance(parameters);
+    QVERIFY(manager->isHttp2Allowed());
+    QVERIFY(!QGeoNetworkAccessManagerOsm::instance(QVariantMap())->isHttp2Allowed());
+
+    const QUrl url(QStringLiteral("data:,tile"));
+    QScopedPointer<QNetworkReply> reply(manager->get(QNetworkRequest(url)));
+    QCOMPARE(reply->request().attribute(QNetworkRequest::Http2AllowedAttribute).toBool(), true);
+
+    QNetworkRequest http1(url);
+    http1.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    reply.reset(manager->get(http1));
+    QCOMPARE(reply->request().attribute(QNetworkRequest::Http2AllowedAttribute).toBool(), false);
+
+    reply.reset(QGeoNetworkAccessManagerOsm::instance(QVariantMap())->get(QNetworkRequest(url)));
+    QVERIFY(!reply->request().attribute(QNetworkRequest::Http2AllowedAttribute).isValid());
+}
+
+void tst_QGeoNetworkAccessManagerOsm::diskCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.mapping.cache.directory"), dir.path());
+    QSharedPointer<QGeoNetworkAccessManagerOsm> manager = QGeoNetworkAccessManagerOsm::instance(parameters);
+    QVERIFY(!manager->cache());
+
+    parameters.insert(QStringLiteral("osm.network.cache.size"), 1024 * 1024);
+    manager = QGeoNetworkAccessManagerOsm::instance(parameters);
+    QNetworkDiskCache *cache = qobject_cast<QNetworkDiskCache *>(manager->cache());
+    QVERIFY(cache);
+    QCOMPARE(cache->maximumCacheSize(), qint64(1024 * 1024));
+    QCOMPARE(QDir(cache->cacheDirectory()).absolutePath(), QDir(dir.filePath(QStringLiteral("network"))).absolutePath());
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoNetworkAccessManagerOsm)
+
+#include "tst_qgeonetworkaccessmanagerosm.moc"
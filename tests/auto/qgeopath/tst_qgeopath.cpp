@@ -30,6 +30,9 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPath>
+#include <QtPositioning/private/qgeopath_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
 
 QT_USE_NAMESPACE
 
@@ -46,8 +49,13 @@ private slots:
     void type();
 
     void path();
+    void packedVertices();
     void width();
     void size();
+    void length();
+    void coordinateAtDistance();
+    void closestPoint();
+    void sharedCopiesAcrossThreads();
 
     void translate_data();
     void translate();
@@ -60,6 +68,10 @@ private slots:
 
     void boundingGeoRectangle_data();
     void boundingGeoRectangle();
+    void boundingGeoRectangleAntimeridian();
+    void mercatorVertices();
+    void setPathSharingPrefix();
+    void slice();
 
     void extendShape();
     void extendShape_data();
@@ -182,11 +194,58 @@ void tst_QGeoPath::path()
         QCOMPARE(p.path().contains(c), true);
     }
 
+    // path() has to follow edits made after it was last called
+    p.addCoordinate(QGeoCoordinate(4, 4, 100));
+    QCOMPARE(p.path().size(), 4);
+    QCOMPARE(p.path().last(), QGeoCoordinate(4, 4, 100));
+    QCOMPARE(p.path().last().type(), QGeoCoordinate::Coordinate3D);
+    QCOMPARE(p.path().first().type(), QGeoCoordinate::Coordinate2D);
+    p.replaceCoordinate(0, QGeoCoordinate(5, 5));
+    QCOMPARE(p.path().first(), QGeoCoordinate(5, 5));
+    p.insertCoordinate(1, QGeoCoordinate(6, 6));
+    QCOMPARE(p.path().at(1), QGeoCoordinate(6, 6));
+    QCOMPARE(p.coordinateAt(1), QGeoCoordinate(6, 6));
+    p.translate(1, 1);
+    QCOMPARE(p.path().first(), QGeoCoordinate(6, 6));
+    QCOMPARE(p.path().last(), QGeoCoordinate(5, 5, 100));
+
     p.clearPath();
     QCOMPARE(p.path().size(), 0);
     QVERIFY(p.boundingGeoRectangle().isEmpty());
 }
 
+void tst_QGeoPath::packedVertices()
+{
+    QGeoPath p;
+    QCOMPARE(QGeoPathPrivate::vertices(p).size(), 0);
+
+    p.setPath(QList<QGeoCoordinate>() << QGeoCoordinate(1, 1) << QGeoCoordinate(2, 2, 50)
+                                      << QGeoCoordinate(3, 0));
+    p.addCoordinate(QGeoCoordinate(4, 4, 100));
+    p.insertCoordinate(1, QGeoCoordinate(6, 6));
+    p.removeCoordinate(2);
+    p.translate(1, 1);
+
+    // the vertices QtLocation reads without path() are the ones path() gives
+    QGeoCoordinateSpan vertices = QGeoPathPrivate::vertices(p);
+    QCOMPARE(vertices.size(), p.size());
+    const QList<QGeoCoordinate> path = p.path();
+    for (int i = 0; i < vertices.size(); ++i) {
+        QCOMPARE(vertices.at(i).toCoordinate(), path.at(i));
+        QCOMPARE(vertices.at(i).toCoordinate().type(), path.at(i).type());
+    }
+
+    // a copy edited afterwards has vertices of its own
+    QGeoPath copy = p;
+    copy.replaceCoordinate(0, QGeoCoordinate(-10, -10));
+    QCOMPARE(QGeoPathPrivate::vertices(copy).at(0).toCoordinate(), QGeoCoordinate(-10, -10));
+    vertices = QGeoPathPrivate::vertices(p);
+    QCOMPARE(vertices.at(0).toCoordinate(), path.first());
+
+    p.clearPath();
+    QCOMPARE(QGeoPathPrivate::vertices(p).size(), 0);
+}
+
 void tst_QGeoPath::width()
 {
     QGeoPath p;
@@ -220,6 +279,139 @@ void tst_QGeoPath::size()
     QCOMPARE(p4.size(), coords.size() - 2);
 }
 
+void tst_QGeoPath::length()
+{
+    QList<QGeoCoordinate> coords;
+    for (int i = 0; i < 203; ++i)
+        coords.append(QGeoCoordinate(-60.0 + 0.31 * (i % 97), -179.0 + 1.73 * i, 0));
+
+    double expected = 0.0;
+    for (int i = 1; i < coords.size(); ++i)
+        expected += coords.at(i - 1).distanceTo(coords.at(i));
+
+    QGeoPath p(coords);
+    QVERIFY(qAbs(p.length(0, coords.size() - 1) - expected) <= expected * 1e-9);
+    // by default, the length includes the segment back to the first vertex
+    expected += coords.last().distanceTo(coords.first());
+    QVERIFY(qAbs(p.length() - expected) <= expected * 1e-9);
+    QVERIFY(qAbs(p.length(10, 150) - p.length(10, 90) - p.length(90, 150)) <= expected * 1e-9);
+    QCOMPARE(p.length(5, 5), 0.0);
+}
+
+void tst_QGeoPath::coordinateAtDistance()
+{
+    QList<QGeoCoordinate> coords;
+    coords << QGeoCoordinate(0, 0, 0) << QGeoCoordinate(0, 1, 100) << QGeoCoordinate(1, 1, 100)
+           << QGeoCoordinate(1, 1, 100) << QGeoCoordinate(2, 3, 0);
+
+    QGeoPath lazy(coords);
+    QGeoPathEager eager(coords);
+    QVERIFY(!QGeoPath().coordinateAtDistance(0).isValid());
+
+    for (const QGeoPath &p : { lazy, eager }) {
+        const double total = p.length(0, p.size() - 1);
+        QCOMPARE(p.coordinateAtDistance(-1), coords.first());
+        QCOMPARE(p.coordinateAtDistance(total + 1), coords.last());
+        QCOMPARE(p.coordinateAtDistance(p.length(0, 2)), coords.at(2));
+
+        const double half = p.length(0, 1) * 0.5;
+        const QGeoCoordinate mid = p.coordinateAtDistance(half);
+        QVERIFY(qAbs(mid.latitude()) < 1e-9);
+        QVERIFY(qAbs(mid.longitude() - 0.5) < 1e-9);
+        QVERIFY(qAbs(mid.altitude() - 50) < 1e-6);
+
+        const double d = p.length(0, 3) + 1000;
+        QVERIFY(qAbs(coords.at(3).distanceTo(p.coordinateAtDistance(d)) - 1000) < 1e-3);
+    }
+
+    // the cached lengths follow edits
+    eager.insertCoordinate(1, QGeoCoordinate(-1, 0.5));
+    eager.replaceCoordinate(4, QGeoCoordinate(1.5, 2));
+    eager.removeCoordinate(2);
+    eager.addCoordinate(QGeoCoordinate(3, 3));
+    eager.translate(1, 1);
+    lazy = QGeoPath(eager.path());
+    QVERIFY(qAbs(eager.length() - lazy.length()) < 1e-6);
+    QVERIFY(qAbs(eager.length(1, 4) - lazy.length(1, 4)) < 1e-6);
+    const double d = lazy.length(0, 2) * 1.01;
+    QVERIFY(eager.coordinateAtDistance(d).distanceTo(lazy.coordinateAtDistance(d)) < 1e-3);
+}
+
+void tst_QGeoPath::closestPoint()
+{
+    int segment = 0;
+    double along = 0;
+    QVERIFY(!QGeoPath().closestPoint(QGeoCoordinate(1, 1), &segment, &along).isValid());
+    QCOMPARE(segment, -1);
+    QVERIFY(qIsNaN(along));
+
+    // a long zigzag crossing the antimeridian
+    QList<QGeoCoordinate> coords;
+    for (int i = 0; i < 1000; ++i)
+        coords.append(QGeoCoordinate((i % 2) ? 0.5 : -0.5, QLocationUtils::wrapLong(170.0 + 0.05 * i)));
+    QGeoPathEager p(coords);
+
+    QGeoCoordinate closest = p.closestPoint(coords.at(0), &segment, &along);
+    QCOMPARE(closest, coords.at(0));
+    QCOMPARE(segment, 0);
+    QCOMPARE(along, 0.0);
+
+    const QGeoCoordinate midSegment(0.0, QLocationUtils::wrapLong(170.0 + 0.05 * 700.5));
+    closest = p.closestPoint(midSegment.atDistanceAndAzimuth(10, 90), &segment, &along);
+    QCOMPARE(segment, 700);
+    QVERIFY(closest.distanceTo(midSegment) < 20);
+    QVERIFY(qAbs(along - p.length(0, 700) - coords.at(700).distanceTo(closest)) < 1e-6);
+
+    // appended segments are found too
+    p.addCoordinate(QGeoCoordinate(10, 10));
+    closest = p.closestPoint(QGeoCoordinate(10, 10), &segment);
+    QCOMPARE(segment, 999);
+    QVERIFY(closest.distanceTo(QGeoCoordinate(10, 10)) < 1e-3);
+
+    // and removed ones are not
+    p.removeCoordinate(999);
+    p.closestPoint(QGeoCoordinate(10, 10), &segment);
+    QCOMPARE(segment, 998);
+}
+
+void tst_QGeoPath::sharedCopiesAcrossThreads()
+{
+    QList<QGeoCoordinate> coords;
+    for (int i = 0; i < 5000; ++i)
+        coords.append(QGeoCoordinate((i % 2) ? 0.5 : -0.5, -170.0 + 0.05 * i));
+    const QGeoPath path(coords);
+    const QGeoCoordinate target(0.0, -170.0 + 0.05 * 3000.5);
+
+    // the copies share the private data, whose caches are built on first use by any of them
+    int segments[4] = { -1, -1, -1, -1 };
+    bool samePaths[4] = { false, false, false, false };
+    QList<QThread *> threads;
+    for (int i = 0; i < 4; ++i) {
+        int *segment = &segments[i];
+        bool *samePath = &samePaths[i];
+        const QGeoPath copy = path;
+        threads.append(QThread::create([copy, coords, target, segment, samePath]() {
+            *samePath = copy.path() == coords;
+            copy.closestPoint(target, segment);
+            *samePath = *samePath && copy.path() == coords;
+        }));
+    }
+    for (QThread *thread : qAsConst(threads))
+        thread->start();
+    for (int i = 0; i < threads.size(); ++i) {
+        QVERIFY(threads.at(i)->wait());
+        delete threads.at(i);
+        QVERIFY(samePaths[i]);
+        QCOMPARE(segments[i], 3000);
+    }
+
+    // each point was indexed once
+    int segment = -1;
+    const QGeoCoordinate last = path.closestPoint(coords.last(), &segment);
+    QCOMPARE(segment, coords.size() - 2);
+    QVERIFY(last.distanceTo(coords.last()) < 1e-3);
+}
+
 void tst_QGeoPath::translate_data()
 {
     QTest::addColumn<QGeoCoordinate>("c1");
@@ -371,6 +563,138 @@ void tst_QGeoPath::boundingGeoRectangle()
     QCOMPARE(box.contains(probe), result);
 }
 
+void tst_QGeoPath::boundingGeoRectangleAntimeridian()
+{
+    // eastwards across the antimeridian and back, longer than a chunk of steps
+    QList<QGeoCoordinate> coords;
+    for (int i = 0; i < 150; ++i)
+        coords.append(QGeoCoordinate(-10.0 + 0.1 * i, QLocationUtils::wrapLong(170.0 + 0.2 * i)));
+    for (int i = 0; i < 50; ++i)
+        coords.append(QGeoCoordinate(5.0 - 0.3 * i, QLocationUtils::wrapLong(199.8 - 0.5 * i)));
+
+    const QGeoRectangle expected(QGeoCoordinate(5.0, 170.0),
+                                 QGeoCoordinate(-10.0, 199.8 - 360.0));
+    QCOMPARE(QGeoPath(coords).boundingGeoRectangle(), expected);
+    QCOMPARE(QGeoPathBounds::rectangle(qPackCoordinates(coords)), expected);
+
+    // appending one vertex at a time gives the same box
+    QGeoPathEager eager;
+    for (const QGeoCoordinate &c : qAsConst(coords))
+        eager.addCoordinate(c);
+    QCOMPARE(eager.boundingGeoRectangle(), expected);
+
+    // and it keeps up with a translation
+    eager.translate(1.0, 20.0);
+    eager.addCoordinate(QGeoCoordinate(0.0, -140.0));
+    QGeoPath moved(coords);
+    moved.translate(1.0, 20.0);
+    moved.addCoordinate(QGeoCoordinate(0.0, -140.0));
+    QCOMPARE(eager.boundingGeoRectangle(), moved.boundingGeoRectangle());
+    QCOMPARE(moved.boundingGeoRectangle().bottomRight().longitude(), -140.0);
+}
+
+static bool fuzzyCompare(const QList<QDoubleVector2D> &a, const QList<QDoubleVector2D> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (int i = 0; i < a.size(); ++i) {
+        if (!qFuzzyCompare(a.at(i).x(), b.at(i).x()) || !qFuzzyCompare(a.at(i).y(), b.at(i).y()))
+            return false;
+    }
+    return true;
+}
+
+void tst_QGeoPath::mercatorVertices()
+{
+    QList<QGeoCoordinate> coords;
+    coords << QGeoCoordinate(1, 1) << QGeoCoordinate(2, 170) << QGeoCoordinate(-3, -175);
+    const QGeoPath path(coords);
+    const QList<QDoubleVector2D> projected = QGeoPathPrivate::mercatorVertices(path);
+    QVERIFY(fuzzyCompare(projected, QWebMercator::coordToMercator(coords)));
+
+    // copies, eager ones included, share the projection
+    const QGeoPath copy = path;
+    QVERIFY(QGeoPathPrivate::mercatorVertices(copy).isSharedWith(projected));
+    QGeoPathEager eager(path);
+    QVERIFY(QGeoPathPrivate::mercatorVertices(eager).isSharedWith(projected));
+
+    // until their vertices change, leaving the projection of the others alone
+    eager.addCoordinate(QGeoCoordinate(4, 10));
+    QList<QGeoCoordinate> appended = coords;
+    appended << QGeoCoordinate(4, 10);
+    QVERIFY(fuzzyCompare(QGeoPathPrivate::mercatorVertices(eager), QWebMercator::coordToMercator(appended)));
+    QCOMPARE(QGeoPathPrivate::mercatorVertices(path), projected);
+
+    // an unshared projection follows appends and edits
+    eager.addCoordinate(QGeoCoordinate(5, 20));
+    appended << QGeoCoordinate(5, 20);
+    QVERIFY(fuzzyCompare(QGeoPathPrivate::mercatorVertices(eager), QWebMercator::coordToMercator(appended)));
+    eager.replaceCoordinate(0, QGeoCoordinate(-1, -1));
+    appended[0] = QGeoCoordinate(-1, -1);
+    QVERIFY(fuzzyCompare(QGeoPathPrivate::mercatorVertices(eager), QWebMercator::coordToMercator(appended)));
+}
+
+void tst_QGeoPath::setPathSharingPrefix()
+{
+    QList<QGeoCoordinate> coords;
+    coords << QGeoCoordinate(1, 1) << QGeoCoordinate(2, 2) << QGeoCoordinate(3, 3) << QGeoCoordinate(4, 4);
+    QGeoPathEager path(coords);
+    const QList<QDoubleVector2D> projected = QGeoPathPrivate::mercatorVertices(path);
+    const QGeoPath copy = path;
+
+    // a new tail after the first two vertices
+    QList<QGeoCoordinate> rerouted = coords.mid(0, 2);
+    rerouted << QGeoCoordinate(2, 5) << QGeoCoordinate(1, 6) << QGeoCoordinate(0, 7);
+    QGeoPathPrivate::setPathSharingPrefix(path, rerouted);
+    QCOMPARE(path.path(), rerouted);
+    QVERIFY(fuzzyCompare(QGeoPathPrivate::mercatorVertices(path), QWebMercator::coordToMercator(rerouted)));
+    QVERIFY(qAbs(path.length() - QGeoPath(rerouted).length()) < 1e-6);
+    QCOMPARE(path.boundingGeoRectangle(), QGeoPath(rerouted).boundingGeoRectangle());
+    // the copy keeps its vertices and projection
+    QCOMPARE(copy.path(), coords);
+    QCOMPARE(QGeoPathPrivate::mercatorVertices(copy), projected);
+
+    // a shorter path, and one with nothing in common
+    QGeoPathPrivate::setPathSharingPrefix(path, rerouted.mid(0, 3));
+    QCOMPARE(path.path(), rerouted.mid(0, 3));
+    QVERIFY(fuzzyCompare(QGeoPathPrivate::mercatorVertices(path), QWebMercator::coordToMercator(rerouted.mid(0, 3))));
+    QGeoPathPrivate::setPathSharingPrefix(path, coords.mid(2));
+    QCOMPARE(path.path(), coords.mid(2));
+    QVERIFY(fuzzyCompare(QGeoPathPrivate::mercatorVertices(path), QWebMercator::coordToMercator(coords.mid(2))));
+}
+
+void tst_QGeoPath::slice()
+{
+    QList<QGeoCoordinate> coords;
+    for (int i = 0; i < 10; ++i)
+        coords << QGeoCoordinate(i, QLocationUtils::wrapLong(175.0 + 2.0 * i));
+    const QGeoPathEager path(coords, 3.0);
+
+    const QGeoPathSlice whole(path);
+    QVERIFY(whole.isWholeShape());
+    QCOMPARE(whole.size(), coords.size());
+    QCOMPARE(whole.boundingGeoRectangle(), path.boundingGeoRectangle());
+    QCOMPARE(whole.length(), path.length(0, coords.size() - 1));
+    QCOMPARE(whole.toPath(), QGeoPath(path));
+
+    const QGeoPathSlice part(path, 2, 4);
+    QVERIFY(!part.isWholeShape());
+    QCOMPARE(part.first(), 2);
+    QCOMPARE(part.size(), 4);
+    QCOMPARE(part.coordinateAt(0), coords.at(2));
+    const QGeoPath copied(coords.mid(2, 4), 3.0);
+    QCOMPARE(part.toPath(), copied);
+    QCOMPARE(part.boundingGeoRectangle(), copied.boundingGeoRectangle());
+    QVERIFY(qFuzzyCompare(part.length(), copied.length(0, 3)));
+    QCOMPARE(part.mercatorVertices(), QGeoPathPrivate::mercatorVertices(path).mid(2, 4));
+
+    // clamped to the path
+    QCOMPARE(QGeoPathSlice(path, 8, 5).size(), 2);
+    QCOMPARE(QGeoPathSlice(path, 12).size(), 0);
+    QVERIFY(QGeoPathSlice(path, 12).mercatorVertices().isEmpty());
+    QCOMPARE(QGeoPathSlice(QGeoRectangle()).size(), 0);
+}
+
 void tst_QGeoPath::extendShape()
 {
     QFETCH(QGeoCoordinate, c1);
@@ -30,6 +30,7 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPolygon>
+#include <QtCore/qmath.h>
 
 QT_USE_NAMESPACE
 
@@ -56,6 +57,8 @@ private slots:
 
     void contains_data();
     void contains();
+    void containsLargePolygon();
+    void containsAfterEdit();
 
     void boundingGeoRectangle_data();
     void boundingGeoRectangle();
@@ -321,6 +324,90 @@ void tst_QGeoPolygon::contains()
     QCOMPARE(area.contains(probe), result);
 }
 
+void tst_QGeoPolygon::containsLargePolygon()
+{
+    // enough vertices for the edge index to be used on both rings
+    QList<QGeoCoordinate> star;
+    for (int i = 0; i < 200; ++i) {
+        const double angle = qDegreesToRadians(i * 360.0 / 200);
+        const double radius = (i % 2) ? 5.0 : 10.0;
+        star.append(QGeoCoordinate(radius * qSin(angle), radius * qCos(angle)));
+    }
+    QList<QGeoCoordinate> hole;
+    for (int i = 0; i < 64; ++i) {
+        const double angle = qDegreesToRadians(i * 360.0 / 64);
+        hole.append(QGeoCoordinate(2.0 * qSin(angle), 2.0 * qCos(angle)));
+    }
+
+    QGeoPolygon p(star);
+    QVERIFY(p.contains(QGeoCoordinate(0, 0)));
+    QVERIFY(p.contains(QGeoCoordinate(0, 3)));
+    QVERIFY(p.contains(QGeoCoordinate(-4.5, 0)));
+    QVERIFY(p.contains(star.at(0)));
+    QVERIFY(!p.contains(QGeoCoordinate(0, 12)));
+    QVERIFY(!p.contains(QGeoCoordinate(11, 0)));
+    QVERIFY(!p.contains(QGeoCoordinate(-20, -20)));
+
+    p.addHole(hole);
+    QVERIFY(!p.contains(QGeoCoordinate(0, 0)));
+    QVERIFY(!p.contains(QGeoCoordinate(1, -1)));
+    QVERIFY(p.contains(QGeoCoordinate(0, 3)));
+
+    p.translate(0, 20);
+    QVERIFY(!p.contains(QGeoCoordinate(0, 20)));
+    QVERIFY(p.contains(QGeoCoordinate(0, 23)));
+    QVERIFY(!p.contains(QGeoCoordinate(0, 3)));
+
+    p.removeHole(0);
+    QVERIFY(p.contains(QGeoCoordinate(0, 20)));
+}
+
+void tst_QGeoPolygon::containsAfterEdit()
+{
+    QList<QGeoCoordinate> star;
+    for (int i = 0; i < 200; ++i) {
+        const double angle = qDegreesToRadians(i * 360.0 / 200);
+        const double radius = (i % 2) ? 5.0 : 10.0;
+        star.append(QGeoCoordinate(radius * qSin(angle), radius * qCos(angle)));
+    }
+    QList<QGeoCoordinate> hole;
+    for (int i = 0; i < 64; ++i) {
+        const double angle = qDegreesToRadians(i * 360.0 / 64);
+        hole.append(QGeoCoordinate(2.0 * qSin(angle), 2.0 * qCos(angle)));
+    }
+
+    QGeoPolygon p(star);
+    QVERIFY(!p.contains(QGeoCoordinate(0, 12)));
+
+    // moving single vertices, the west-most one included
+    p.replaceCoordinate(0, QGeoCoordinate(0, 15));
+    QVERIFY(p.contains(QGeoCoordinate(0, 12)));
+    p.replaceCoordinate(50, QGeoCoordinate(15, 0));
+    QVERIFY(p.contains(QGeoCoordinate(11, 0)));
+    QVERIFY(p.contains(QGeoCoordinate(0, 12)));
+    p.replaceCoordinate(100, QGeoCoordinate(0, -15));
+    QVERIFY(p.contains(QGeoCoordinate(0, -12)));
+    QVERIFY(p.contains(QGeoCoordinate(0, 12)));
+    QCOMPARE(p.boundingGeoRectangle().topLeft().longitude(), -15.0);
+    p.replaceCoordinate(0, star.at(0));
+    QVERIFY(!p.contains(QGeoCoordinate(0, 12)));
+    QVERIFY(p.contains(QGeoCoordinate(11, 0)));
+
+    // holes are converted on their own
+    QList<QGeoCoordinate> otherHole = hole;
+    for (QGeoCoordinate &c : otherHole)
+        c.setLatitude(c.latitude() + 6);
+    p.addHole(hole);
+    QVERIFY(!p.contains(QGeoCoordinate(0, 0)));
+    p.addHole(otherHole);
+    QVERIFY(!p.contains(QGeoCoordinate(6, 0)));
+    p.removeHole(0);
+    QVERIFY(p.contains(QGeoCoordinate(0, 0)));
+    QVERIFY(!p.contains(QGeoCoordinate(6, 0)));
+    p.replaceCoordinate(1, star.at(1));
+    QVERIFY(!p.contains(QGeoCoordinate(6, 0)));
+}
+
 void tst_QGeoPolygon::boundingGeoRectangle_data()
 {
     QTest::addColumn<QGeoCoordinate>("c1");
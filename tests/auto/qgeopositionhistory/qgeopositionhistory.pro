@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeopositionhistory
+
+SOURCES += tst_qgeopositionhistory.cpp
+
+QT += positioning-private testlib
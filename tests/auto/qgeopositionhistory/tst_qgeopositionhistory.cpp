@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QtPositioning/private/qgeopositionhistory_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoPositionHistory : public QObject
+{
+    Q_OBJECT
+
+private:
+    // a position a second, going north with a ground speed of i
+    static QGeoPositionInfo position(int i)
+    {
+        QGeoPositionInfo info(QGeoCoordinate(i * 0.001, 0), time(i * 1000));
+        info.setAttribute(QGeoPositionInfo::GroundSpeed, i);
+        return info;
+    }
+
+    static QDateTime time(qint64 msecs)
+    {
+        return QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC);
+    }
+
+    // two chunks of four positions, holding positions 4 to 9
+    static void fill(QGeoPositionHistory &history)
+    {
+        for (int i = 0; i < 10; ++i)
+            QVERIFY(history.append(position(i)));
+    }
+
+private slots:
+    void append()
+    {
+        QGeoPositionHistory history(QGeoPositionHistory::fixSize() * 8, 16);
+        QCOMPARE(history.chunkSize(), 4);
+        fill(history);
+        QCOMPARE(history.size(), 6);
+        QVERIFY(history.memoryUsage() <= history.memoryLimit());
+        QCOMPARE(history.firstTimestamp(), time(4000));
+        QCOMPARE(history.lastTimestamp(), time(9000));
+
+        const QGeoPositionInfo first = history.at(0);
+        QCOMPARE(first.coordinate(), position(4).coordinate());
+        QCOMPARE(first.attribute(QGeoPositionInfo::GroundSpeed), 4.0);
+        QVERIFY(!first.hasAttribute(QGeoPositionInfo::Direction));
+        QCOMPARE(history.at(5).coordinate(), position(9).coordinate());
+        QVERIFY(!history.at(6).isValid());
+
+        // older and invalid positions are refused
+        QVERIFY(!history.append(position(8)));
+        QVERIFY(!history.append(QGeoPositionInfo()));
+        QCOMPARE(history.size(), 6);
+
+        history.clear();
+        QVERIFY(history.isEmpty());
+        QCOMPARE(history.memoryUsage(), qint64(0));
+        QCOMPARE(history.nearest(time(0)), -1);
+    }
+
+    void lookup()
+    {
+        QGeoPositionHistory history(QGeoPositionHistory::fixSize() * 8, 4);
+        fill(history);
+        QCOMPARE(history.lowerBound(time(5500)), 2);
+        QCOMPARE(history.lowerBound(time(6000)), 2);
+        QCOMPARE(history.upperBound(time(6000)), 3);
+        QCOMPARE(history.upperBound(time(9000)), 6);
+        QCOMPARE(history.nearest(time(6400)), 2);
+        QCOMPARE(history.nearest(time(6500)), 2);
+        QCOMPARE(history.nearest(time(6600)), 3);
+        QCOMPARE(history.nearest(time(0)), 0);
+        QCOMPARE(history.nearest(time(100000)), 5);
+
+        const QList<QGeoPositionInfo> positions = history.range(time(5000), time(7000));
+        QCOMPARE(positions.size(), 3);
+        QCOMPARE(positions.first().timestamp(), time(5000));
+        QCOMPARE(positions.last().timestamp(), time(7000));
+        QCOMPARE(history.range(QDateTime(), time(4500)).size(), 1);
+        QVERIFY(history.range(time(7000), time(5000)).isEmpty());
+    }
+
+    void paths()
+    {
+        QGeoPositionHistory history(QGeoPositionHistory::fixSize() * 8, 4);
+        fill(history);
+
+        // positions 5 to 8, across both chunks, the second slice starting
+        // from the last coordinate of the first
+        const QVector<QGeoPathSlice> slices = history.paths(time(5000), time(8000));
+        QCOMPARE(slices.size(), 2);
+        QCOMPARE(slices.at(0).size(), 3);
+        QCOMPARE(slices.at(0).coordinateAt(0), position(5).coordinate());
+        QCOMPARE(slices.at(1).size(), 2);
+        QCOMPARE(slices.at(1).coordinateAt(0), position(7).coordinate());
+        QCOMPARE(slices.at(1).coordinateAt(1), position(8).coordinate());
+        QCOMPARE(history.path(time(5000), time(8000)).size(), 4);
+
+        // the slices share the vertices of the chunks
+        QCOMPARE(history.paths(1, 3).at(0).vertices().data(), slices.at(0).vertices().data());
+
+        // appending to a shared chunk leaves the slices as they were
+        QVERIFY(history.append(position(10)));
+        QCOMPARE(slices.at(1).coordinateAt(1), position(8).coordinate());
+        QCOMPARE(history.paths(time(8000), QDateTime()).at(0).size(), 3);
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_QGeoPositionHistory)
+#include "tst_qgeopositionhistory.moc"
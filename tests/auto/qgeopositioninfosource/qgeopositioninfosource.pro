@@ -12,4 +12,4 @@ SOURCES += ../utils/qlocationtestutils.cpp \
 
 CONFIG -= app_bundle
 
-QT += positioning testlib
+QT += positioning positioning-private testlib
@@ -39,6 +39,7 @@
 #include <qnumeric.h>
 #include <QtPositioning/qgeopositioninfosource.h>
 #include <QtPositioning/qgeopositioninfo.h>
+#include <QtPositioning/private/qgeopositioninfosource_p.h>
 
 #include "testqgeopositioninfosource_p.h"
 #include "../utils/qlocationtestutils_p.h"
@@ -90,6 +91,14 @@ public:
 
     Error error() const { return QGeoPositionInfoSource::NoError; }
 
+    void pushUpdate(const QGeoPositionInfo &info) {
+        emit positionUpdated(info);
+    }
+
+    void pushUpdates(const QList<QGeoPositionInfo> &infos) {
+        QGeoPositionInfoSourcePrivate::get(*this)->deliverPositions(this, infos);
+    }
+
 private:
     PositioningMethods m_methods;
 };
@@ -200,6 +209,95 @@ void TestQGeoPositionInfoSource::updateInterval()
     QCOMPARE(s.updateInterval(), 0);
 }
 
+void TestQGeoPositionInfoSource::coalescedPositionUpdated()
+{
+    MyPositionSource s;
+    QSignalSpy spy(&s, SIGNAL(coalescedPositionUpdated(QGeoPositionInfo)));
+    const QDateTime dt(QDate(2020, 1, 2), QTime(10, 0, 0), Qt::UTC);
+    QGeoPositionInfo info(QGeoCoordinate(0, 0), dt);
+    info.setAttribute(QGeoPositionInfo::Direction, 0);
+
+    // without thresholds every update is passed on
+    s.pushUpdate(info);
+    s.pushUpdate(info);
+    QCOMPARE(spy.count(), 2);
+
+    s.setCoalescingDistance(100);
+    s.setCoalescingHeading(30);
+    spy.clear();
+    s.pushUpdate(info);
+    QCOMPARE(spy.count(), 1);
+    info.setCoordinate(QGeoCoordinate(0, 0.0001)); // about 11 m
+    info.setAttribute(QGeoPositionInfo::Direction, 350);
+    s.pushUpdate(info);
+    QCOMPARE(spy.count(), 1);
+    info.setAttribute(QGeoPositionInfo::Direction, 320);
+    s.pushUpdate(info);
+    QCOMPARE(spy.count(), 2);
+    info.setCoordinate(QGeoCoordinate(0, 0.002)); // about 220 m
+    s.pushUpdate(info);
+    QCOMPARE(spy.count(), 3);
+
+    // faster updates are coalesced into the newest one
+    s.setCoalescingDistance(0);
+    s.setCoalescingHeading(0);
+    s.setCoalescingInterval(200);
+    QCOMPARE(s.coalescingInterval(), 200);
+    spy.clear();
+    s.pushUpdate(QGeoPositionInfo(QGeoCoordinate(1, 1), dt.addSecs(1)));
+    s.pushUpdate(QGeoPositionInfo(QGeoCoordinate(2, 2), dt.addSecs(2)));
+    s.pushUpdate(QGeoPositionInfo(QGeoCoordinate(3, 3), dt.addSecs(3)));
+    QCOMPARE(spy.count(), 0); // within the interval of the previous one
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<QGeoPositionInfo>().timestamp(), dt.addSecs(3));
+}
+
+void TestQGeoPositionInfoSource::batchedPositionsUpdated()
+{
+    MyPositionSource s;
+    QSignalSpy spy(&s, SIGNAL(batchedPositionsUpdated(QList<QGeoPositionInfo>)));
+    const QDateTime dt(QDate(2020, 1, 2), QTime(10, 0, 0), Qt::UTC);
+    QList<QGeoPositionInfo> infos;
+    for (int i = 0; i < 5; ++i)
+        infos.append(QGeoPositionInfo(QGeoCoordinate(i, i), dt.addSecs(i)));
+
+    // not batching by default
+    QCOMPARE(s.batchInterval(), 0);
+    QCOMPARE(s.batchSize(), 0);
+    s.pushUpdate(infos.at(0));
+    QCOMPARE(spy.count(), 0);
+
+    s.setBatchSize(2);
+    QCOMPARE(s.batchSize(), 2);
+    for (const QGeoPositionInfo &info : qAsConst(infos))
+        s.pushUpdate(info);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(0).at(0).value<QList<QGeoPositionInfo>>(), infos.mid(0, 2));
+    QCOMPARE(spy.at(1).at(0).value<QList<QGeoPositionInfo>>(), infos.mid(2, 2));
+
+    // changing the settings delivers the rest
+    s.setBatchSize(0);
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(2).at(0).value<QList<QGeoPositionInfo>>(), infos.mid(4));
+
+    // batches of the backend are delivered once, with their last positionUpdated()
+    spy.clear();
+    s.setBatchInterval(100);
+    s.pushUpdates(infos.mid(0, 3));
+    s.pushUpdate(infos.at(3));
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<QList<QGeoPositionInfo>>(), infos.mid(0, 4));
+
+    // an update equal to the end of a backend batch is an update of its own
+    spy.clear();
+    s.pushUpdates(infos.mid(0, 2));
+    s.pushUpdate(infos.at(1));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<QList<QGeoPositionInfo>>(),
+             QList<QGeoPositionInfo>() << infos.at(0) << infos.at(1) << infos.at(1));
+}
+
 void TestQGeoPositionInfoSource::setPreferredPositioningMethods()
 {
     QFETCH(QGeoPositionInfoSource::PositioningMethod, supported);
@@ -77,6 +77,10 @@ private slots:
 
     void updateInterval();
 
+    void coalescedPositionUpdated();
+
+    void batchedPositionsUpdated();
+
     void setPreferredPositioningMethods();
     void setPreferredPositioningMethods_data();
 
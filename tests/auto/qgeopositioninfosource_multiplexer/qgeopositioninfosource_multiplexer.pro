@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeopositioninfosource_multiplexer
+
+plugin.path = ../../../src/plugins/position/multiplexer/
+
+SOURCES += tst_qgeopositioninfosource_multiplexer.cpp \
+           $$plugin.path/qgeopositioninfosource_multiplexer.cpp
+HEADERS += $$plugin.path/qgeopositioninfosource_multiplexer_p.h
+INCLUDEPATH += $$plugin.path
+
+QT += positioning testlib
@@ -0,0 +1,312 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/position/multiplexer
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPositionInfoSource>
+
+#include "qgeopositioninfosource_multiplexer_p.h"
+
+QT_USE_NAMESPACE
+
+// A source emitting the positions it is given, which tells whether it runs
+class ManualPositionSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+
+public:
+    explicit ManualPositionSource(QObject *parent = 0)
+        : QGeoPositionInfoSource(parent) {}
+
+    QGeoPositionInfo lastKnownPosition(bool = false) const override { return lastPosition; }
+    PositioningMethods supportedPositioningMethods() const override { return AllPositioningMethods; }
+    int minimumUpdateInterval() const override { return 0; }
+    Error error() const override { return NoError; }
+
+    void setPosition(const QGeoCoordinate &coordinate, qreal accuracy)
+    {
+        lastPosition = QGeoPositionInfo(coordinate, QDateTime::currentDateTime());
+        lastPosition.setAttribute(QGeoPositionInfo::HorizontalAccuracy, accuracy);
+        emit positionUpdated(lastPosition);
+    }
+
+    bool running = false;
+    int requests = 0;
+
+public slots:
+    void startUpdates() override { running = true; }
+    void stopUpdates() override { running = false; }
+    void requestUpdate(int = 5000) override { ++requests; }
+
+private:
+    QGeoPositionInfo lastPosition;
+};
+
+class tst_QGeoPositionInfoSourceMultiplexer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void select();
+    void fuse();
+    void powerSave();
+    void powerSaveDisabled();
+    void timeout();
+    void requestUpdate();
+
+private:
+    QGeoPositionInfoSourceMultiplexer *multiplexer(const QVariantMap &parameters);
+
+    static qreal accuracy(const QGeoPositionInfo &position)
+    {
+        return position.attribute(QGeoPositionInfo::HorizontalAccuracy);
+    }
+
+    ManualPositionSource *m_primary = nullptr;
+    ManualPositionSource *m_secondary = nullptr;
+};
+
+void tst_QGeoPositionInfoSourceMultiplexer::initTestCase()
+{
+    qRegisterMetaType<QGeoPositionInfo>();
+}
+
+QGeoPositionInfoSourceMultiplexer *tst_QGeoPositionInfoSourceMultiplexer::multiplexer(const QVariantMap &parameters)
+{
+    m_primary = new ManualPositionSource;
+    m_secondary = new ManualPositionSource;
+    return new QGeoPositionInfoSourceMultiplexer(QList<QGeoPositionInfoSource *>() << m_primary << m_secondary,
+                                                 parameters, this);
+}
+
+// A position is passed on when it arrives, unless another source has a better recent one
+void tst_QGeoPositionInfoSourceMultiplexer::select()
+{
+    QScopedPointer<QGeoPositionInfoSourceMultiplexer> source(multiplexer(QVariantMap()));
+    QCOMPARE(source->sourceCount(), 2);
+    QSignalSpy updated(source.data(), &QGeoPositionInfoSource::positionUpdated);
+
+    source->startUpdates();
+    QVERIFY(m_primary->running);
+    QVERIFY(m_secondary->running);
+
+    m_secondary->setPosition(QGeoCoordinate(1, 1), 50);
+    QCOMPARE(updated.count(), 1);
+    m_primary->setPosition(QGeoCoordinate(2, 2), 10);
+    QCOMPARE(updated.count(), 2);
+    QCOMPARE(updated.last().at(0).value<QGeoPositionInfo>().coordinate(), QGeoCoordinate(2, 2));
+
+    // worse than the primary
+    m_secondary->setPosition(QGeoCoordinate(1, 1), 50);
+    QCOMPARE(updated.count(), 2);
+    // now the primary is the worse one
+    m_primary->setPosition(QGeoCoordinate(2, 2), 200);
+    QCOMPARE(updated.count(), 2);
+    m_secondary->setPosition(QGeoCoordinate(3, 3), 40);
+    QCOMPARE(updated.count(), 3);
+    QCOMPARE(updated.last().at(0).value<QGeoPositionInfo>().coordinate(), QGeoCoordinate(3, 3));
+
+    // the best of the last positions
+    QCOMPARE(source->lastKnownPosition().coordinate(), QGeoCoordinate(3, 3));
+
+    source->stopUpdates();
+    QVERIFY(!m_primary->running);
+    QVERIFY(!m_secondary->running);
+    m_secondary->setPosition(QGeoCoordinate(3, 3), 40);
+    QCOMPARE(updated.count(), 3);
+}
+
+// Each position is moved to the weighted average of the recent positions
+void tst_QGeoPositionInfoSourceMultiplexer::fuse()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("multiplexer.mode"), QStringLiteral("fuse"));
+    parameters.insert(QStringLiteral("multiplexer.speed"), 0);
+    QScopedPointer<QGeoPositionInfoSourceMultiplexer> source(multiplexer(parameters));
+    QSignalSpy updated(source.data(), &QGeoPositionInfoSource::positionUpdated);
+    source->startUpdates();
+
+    // alone, as it is
+    m_primary->setPosition(QGeoCoordinate(0, 0), 10);
+    QCOMPARE(updated.count(), 1);
+    QCOMPARE(updated.last().at(0).value<QGeoPositionInfo>().coordinate(), QGeoCoordinate(0, 0));
+    QCOMPARE(accuracy(updated.last().at(0).value<QGeoPositionInfo>()), 10.0);
+
+    // equally accurate, in the middle
+    m_secondary->setPosition(QGeoCoordinate(0, 0.001), 10);
+    QCOMPARE(updated.count(), 2);
+    QGeoPositionInfo fused = updated.last().at(0).value<QGeoPositionInfo>();
+    QCOMPARE(fused.coordinate().latitude(), 0.0);
+    QVERIFY(qAbs(fused.coordinate().longitude() - 0.0005) < 1e-9);
+    QVERIFY(qAbs(accuracy(fused) - 10 / std::sqrt(2.0)) < 1e-6);
+
+    // four times the weight, a fifth of the way
+    m_primary->setPosition(QGeoCoordinate(0, 0), 5);
+    fused = updated.last().at(0).value<QGeoPositionInfo>();
+    QVERIFY(qAbs(fused.coordinate().longitude() - 0.0002) < 1e-9);
+
+    // across the antimeridian
+    m_primary->setPosition(QGeoCoordinate(0, 179.9995), 10);
+    m_secondary->setPosition(QGeoCoordinate(0, -179.9995), 10);
+    fused = updated.last().at(0).value<QGeoPositionInfo>();
+    QVERIFY(qAbs(qAbs(fused.coordinate().longitude()) - 180.0) < 1e-9);
+}
+
+// The secondary source is stopped while the primary is healthy, and started when it is not
+void tst_QGeoPositionInfoSourceMultiplexer::powerSave()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("multiplexer.max_age"), 300);
+    parameters.insert(QStringLiteral("multiplexer.healthy_accuracy"), 25);
+    QScopedPointer<QGeoPositionInfoSourceMultiplexer> source(multiplexer(parameters));
+    source->startUpdates();
+
+    // only once healthy for max_age
+    QElapsedTimer healthy;
+    healthy.start();
+    while (m_secondary->running && healthy.elapsed() < 2000) {
+        m_primary->setPosition(QGeoCoordinate(0, 0), 10);
+        QTest::qWait(50);
+    }
+    QVERIFY(!m_secondary->running);
+    QVERIFY(healthy.elapsed() >= 300);
+    QVERIFY(m_primary->running);
+
+    // inaccurate
+    m_primary->setPosition(QGeoCoordinate(0, 0), 100);
+    QVERIFY(m_secondary->running);
+
+    // quiet
+    healthy.restart();
+    while (m_secondary->running && healthy.elapsed() < 2000) {
+        m_primary->setPosition(QGeoCoordinate(0, 0), 10);
+        QTest::qWait(50);
+    }
+    QVERIFY(!m_secondary->running);
+    QTRY_VERIFY(m_secondary->running);
+
+    // timed out
+    healthy.restart();
+    while (m_secondary->running && healthy.elapsed() < 2000) {
+        m_primary->setPosition(QGeoCoordinate(0, 0), 10);
+        QTest::qWait(50);
+    }
+    QVERIFY(!m_secondary->running);
+    emit m_primary->updateTimeout();
+    QVERIFY(m_secondary->running);
+
+    // failed
+    healthy.restart();
+    while (m_secondary->running && healthy.elapsed() < 2000) {
+        m_primary->setPosition(QGeoCoordinate(0, 0), 10);
+        QTest::qWait(50);
+    }
+    QVERIFY(!m_secondary->running);
+    emit m_primary->QGeoPositionInfoSource::error(QGeoPositionInfoSource::ClosedError);
+    QVERIFY(m_secondary->running);
+    // the secondary still works, not an error of the stream
+    QCOMPARE(source->error(), QGeoPositionInfoSource::NoError);
+    emit m_secondary->QGeoPositionInfoSource::error(QGeoPositionInfoSource::ClosedError);
+    QCOMPARE(source->error(), QGeoPositionInfoSource::ClosedError);
+}
+
+void tst_QGeoPositionInfoSourceMultiplexer::powerSaveDisabled()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("multiplexer.max_age"), 100);
+    parameters.insert(QStringLiteral("multiplexer.power_save"), false);
+    QScopedPointer<QGeoPositionInfoSourceMultiplexer> source(multiplexer(parameters));
+    source->startUpdates();
+
+    for (int i = 0; i < 6; ++i) {
+        m_primary->setPosition(QGeoCoordinate(0, 0), 10);
+        QTest::qWait(50);
+    }
+    QVERIFY(m_secondary->running);
+}
+
+// The stream times out when no source has a recent position
+void tst_QGeoPositionInfoSourceMultiplexer::timeout()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("multiplexer.max_age"), 200);
+    QScopedPointer<QGeoPositionInfoSourceMultiplexer> source(multiplexer(parameters));
+    QSignalSpy timedOut(source.data(), &QGeoPositionInfoSource::updateTimeout);
+    source->startUpdates();
+
+    m_secondary->setPosition(QGeoCoordinate(0, 0), 10);
+    emit m_primary->updateTimeout();
+    QCOMPARE(timedOut.count(), 0);
+
+    QTest::qWait(300);
+    emit m_primary->updateTimeout();
+    QCOMPARE(timedOut.count(), 1);
+}
+
+// A single update is taken from the first accurate answer, or the best of them all
+void tst_QGeoPositionInfoSourceMultiplexer::requestUpdate()
+{
+    QScopedPointer<QGeoPositionInfoSourceMultiplexer> source(multiplexer(QVariantMap()));
+    QSignalSpy updated(source.data(), &QGeoPositionInfoSource::positionUpdated);
+
+    source->requestUpdate(1000);
+    QCOMPARE(m_primary->requests, 1);
+    QCOMPARE(m_secondary->requests, 1);
+    m_secondary->setPosition(QGeoCoordinate(1, 1), 5);
+    QCOMPARE(updated.count(), 1);
+    QCOMPARE(updated.last().at(0).value<QGeoPositionInfo>().coordinate(), QGeoCoordinate(1, 1));
+    m_primary->setPosition(QGeoCoordinate(2, 2), 5);
+    QCOMPARE(updated.count(), 1);
+
+    // inaccurate answers wait for the other source
+    source->requestUpdate(1000);
+    m_primary->setPosition(QGeoCoordinate(2, 2), 80);
+    QCOMPARE(updated.count(), 1);
+    m_secondary->setPosition(QGeoCoordinate(1, 1), 60);
+    QCOMPARE(updated.count(), 2);
+    QCOMPARE(updated.last().at(0).value<QGeoPositionInfo>().coordinate(), QGeoCoordinate(1, 1));
+
+    // no answer
+    source.reset(multiplexer(QVariantMap()));
+    QSignalSpy expired(source.data(), &QGeoPositionInfoSource::updateTimeout);
+    source->requestUpdate(1000);
+    emit m_primary->updateTimeout();
+    QCOMPARE(expired.count(), 0);
+    emit m_secondary->updateTimeout();
+    QCOMPARE(expired.count(), 1);
+
+    // or by the timer of the request
+    source->requestUpdate(100);
+    QTRY_COMPARE(expired.count(), 2);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoPositionInfoSourceMultiplexer)
+
+#include "tst_qgeopositioninfosource_multiplexer.moc"
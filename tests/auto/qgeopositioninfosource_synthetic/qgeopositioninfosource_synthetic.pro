@@ -0,0 +1,14 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeopositioninfosource_synthetic
+
+plugin.path = ../../../src/plugins/position/synthetic/
+
+INCLUDEPATH += $$plugin.path
+
+SOURCES += tst_qgeopositioninfosource_synthetic.cpp \
+           $$plugin.path/qgeopositioninfosource_synthetic.cpp
+
+HEADERS += $$plugin.path/qgeopositioninfosource_synthetic_p.h
+
+QT += positioning positioning-private testlib
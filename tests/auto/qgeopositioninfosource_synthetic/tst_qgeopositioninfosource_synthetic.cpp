@@ -0,0 +1,206 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/position/synthetic
+
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include "qgeopositioninfosource_synthetic_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoPositionInfoSourceSynthetic : public QObject
+{
+    Q_OBJECT
+
+private:
+    // A path of about 1112 m due east along the equator
+    static QVariantMap pathParameters()
+    {
+        QVariantMap parameters;
+        parameters.insert(QStringLiteral("synthetic.path"), QStringLiteral("0,0;0,0.01"));
+        parameters.insert(QStringLiteral("synthetic.accuracy"), 0);
+        return parameters;
+    }
+
+    static QGeoPositionInfo requestedPosition(QGeoPositionInfoSource &source)
+    {
+        QSignalSpy spy(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.requestUpdate();
+        if (!spy.wait(1000))
+            return QGeoPositionInfo();
+        return spy.first().at(0).value<QGeoPositionInfo>();
+    }
+
+private slots:
+    void initTestCase()
+    {
+        qRegisterMetaType<QGeoPositionInfo>();
+        qRegisterMetaType<QList<QGeoPositionInfo>>();
+    }
+
+    void hasParameters()
+    {
+        QVERIFY(!QGeoPositionInfoSourceSynthetic::hasParameters(QVariantMap()));
+        QVariantMap parameters;
+        parameters.insert(QStringLiteral("osm.useragent"), QStringLiteral("test"));
+        QVERIFY(!QGeoPositionInfoSourceSynthetic::hasParameters(parameters));
+        parameters.insert(QStringLiteral("synthetic.rate"), 100);
+        QVERIFY(QGeoPositionInfoSourceSynthetic::hasParameters(parameters));
+    }
+
+    void path()
+    {
+        QVariantMap parameters = pathParameters();
+        parameters.insert(QStringLiteral("synthetic.rate"), 1);
+        parameters.insert(QStringLiteral("synthetic.speed"), 500);
+        parameters.insert(QStringLiteral("synthetic.loop"), false);
+        QGeoPositionInfoSourceSynthetic source(parameters);
+        QSignalSpy timeoutSpy(&source, SIGNAL(updateTimeout()));
+
+        const QGeoCoordinate start(0, 0);
+        QGeoPositionInfo position = requestedPosition(source);
+        QVERIFY(position.isValid());
+        QVERIFY(position.coordinate().distanceTo(start) < 0.01);
+        QCOMPARE(position.attribute(QGeoPositionInfo::GroundSpeed), 500.0);
+        QVERIFY(qAbs(position.attribute(QGeoPositionInfo::Direction) - 90.0) < 0.01);
+        const QDateTime first = position.timestamp();
+
+        position = requestedPosition(source);
+        QVERIFY(qAbs(position.coordinate().distanceTo(start) - 500) < 0.01);
+        QCOMPARE(first.msecsTo(position.timestamp()), 1000);
+        position = requestedPosition(source);
+        QVERIFY(qAbs(position.coordinate().distanceTo(start) - 1000) < 0.01);
+        QCOMPARE(source.lastKnownPosition(), position);
+
+        // the end of the path
+        position = requestedPosition(source);
+        QVERIFY(position.coordinate().distanceTo(QGeoCoordinate(0, 0.01)) < 0.01);
+        QVERIFY(!requestedPosition(source).isValid());
+        QCOMPARE(timeoutSpy.count(), 1);
+    }
+
+    void loop()
+    {
+        QVariantMap parameters = pathParameters();
+        parameters.insert(QStringLiteral("synthetic.rate"), 1);
+        parameters.insert(QStringLiteral("synthetic.speed"), 700);
+        QGeoPositionInfoSourceSynthetic source(parameters);
+
+        const QGeoCoordinate start(0, 0);
+        const double length = start.distanceTo(QGeoCoordinate(0, 0.01));
+        requestedPosition(source);
+        requestedPosition(source);
+        const QGeoPositionInfo position = requestedPosition(source);
+        QVERIFY(qAbs(position.coordinate().distanceTo(start) - (1400 - length)) < 0.01);
+    }
+
+    void devices()
+    {
+        // the devices are spread along the path
+        QVariantMap parameters = pathParameters();
+        parameters.insert(QStringLiteral("synthetic.spacing"), 100);
+        parameters.insert(QStringLiteral("synthetic.device"), 3);
+        QGeoPositionInfoSourceSynthetic source(parameters);
+        const QGeoPositionInfo position = requestedPosition(source);
+        QVERIFY(qAbs(position.coordinate().distanceTo(QGeoCoordinate(0, 0)) - 300) < 0.01);
+    }
+
+    void deterministic()
+    {
+        QVariantMap parameters;
+        parameters.insert(QStringLiteral("synthetic.start"), QStringLiteral("60,10"));
+        parameters.insert(QStringLiteral("synthetic.seed"), 7);
+        parameters.insert(QStringLiteral("synthetic.rate"), 10);
+
+        QGeoPositionInfoSourceSynthetic first(parameters);
+        QGeoPositionInfoSourceSynthetic second(parameters);
+        parameters.insert(QStringLiteral("synthetic.device"), 1);
+        QGeoPositionInfoSourceSynthetic otherDevice(parameters);
+
+        bool differs = false;
+        for (int i = 0; i < 5; ++i) {
+            const QGeoPositionInfo position = requestedPosition(first);
+            QVERIFY(position.isValid());
+            QCOMPARE(requestedPosition(second).coordinate(), position.coordinate());
+            differs |= requestedPosition(otherDevice).coordinate() != position.coordinate();
+            // a walk of 1 m per position within the accuracy of 5 m
+            QVERIFY(position.coordinate().distanceTo(QGeoCoordinate(60, 10)) < 5 + 7.5);
+        }
+        QVERIFY(differs);
+    }
+
+    void highRate()
+    {
+        QVariantMap parameters = pathParameters();
+        parameters.insert(QStringLiteral("synthetic.rate"), 1000);
+        QGeoPositionInfoSourceSynthetic source(parameters);
+        QVERIFY(source.minimumUpdateInterval() <= 1);
+
+        QSignalSpy spy(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.startUpdates();
+        QTRY_VERIFY(spy.count() >= 200);
+        source.stopUpdates();
+        const int count = spy.count();
+        QTest::qWait(50);
+        QCOMPARE(spy.count(), count);
+
+        // the timestamps follow the rate rather than the timer
+        for (int i = 1; i < count; ++i) {
+            const QDateTime previous = spy.at(i - 1).at(0).value<QGeoPositionInfo>().timestamp();
+            QCOMPARE(previous.msecsTo(spy.at(i).at(0).value<QGeoPositionInfo>().timestamp()), 1);
+        }
+    }
+
+    void batch()
+    {
+        QVariantMap parameters = pathParameters();
+        parameters.insert(QStringLiteral("synthetic.rate"), 2000);
+        parameters.insert(QStringLiteral("synthetic.batch"), true);
+        QGeoPositionInfoSourceSynthetic source(parameters);
+
+        QSignalSpy batchSpy(&source, SIGNAL(batchedPositionsUpdated(QList<QGeoPositionInfo>)));
+        QSignalSpy spy(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.setBatchInterval(60000);
+        source.startUpdates();
+        QTRY_VERIFY(spy.count() > 1);
+        source.stopUpdates();
+        source.setBatchInterval(0); // delivers the batch
+        QCOMPARE(batchSpy.count(), 1);
+
+        // every due position is batched, only the last of each tick is emitted alone
+        const QList<QGeoPositionInfo> positions = batchSpy.first().at(0).value<QList<QGeoPositionInfo>>();
+        QVERIFY(positions.size() > spy.count());
+        for (const QList<QVariant> &arguments : qAsConst(spy))
+            QVERIFY(positions.contains(arguments.at(0).value<QGeoPositionInfo>()));
+        QCOMPARE(positions.last(), spy.last().at(0).value<QGeoPositionInfo>());
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_QGeoPositionInfoSourceSynthetic)
+#include "tst_qgeopositioninfosource_synthetic.moc"
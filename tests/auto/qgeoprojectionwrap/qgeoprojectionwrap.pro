@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoprojectionwrap
+
+SOURCES += tst_qgeoprojectionwrap.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtTest/QtTest>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoProjectionWrap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void wrapList_data();
+    void wrapList();
+    void wrapArray_data();
+    void wrapArray();
+    void notFinite();
+
+private:
+    void setCamera(double longitude);
+    QDoubleVector2D reference(const QDoubleVector2D &projection, bool unwrap, double unwrapBelowX) const;
+
+    QGeoProjectionWebMercator m_projection;
+    QList<QDoubleVector2D> m_path;
+};
+
+// Points all over the map, and a bit past its borders
+void tst_QGeoProjectionWrap::initTestCase()
+{
+    for (int i = -4; i <= 24; ++i)
+        m_path.append(QDoubleVector2D(i * 0.05, 0.3 + i * 0.01));
+    m_projection.setViewportSize(QSize(256, 256));
+}
+
+void tst_QGeoProjectionWrap::setCamera(double longitude)
+{
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(10.0, longitude));
+    camera.setZoomLevel(2.0);
+    m_projection.setCameraData(camera);
+}
+
+// What the map items did for each vertex before wrapMapProjections()
+QDoubleVector2D tst_QGeoProjectionWrap::reference(const QDoubleVector2D &projection, bool unwrap,
+                                                  double unwrapBelowX) const
+{
+    QDoubleVector2D wrapped = m_projection.wrapMapProjection(projection);
+    if (unwrap && wrapped.x() < unwrapBelowX) {
+        double distance = wrapped.x() - unwrapBelowX;
+        if (distance < 0.0)
+            distance += 1.0;
+        wrapped.setX(unwrapBelowX + distance);
+    }
+    return wrapped;
+}
+
+void tst_QGeoProjectionWrap::wrapList_data()
+{
+    QTest::addColumn<double>("longitude");
+    QTest::addColumn<bool>("unwrap");
+
+    // the camera left of, at and right of the middle of the map
+    QTest::newRow("west") << -120.0 << false;
+    QTest::newRow("west, unwrapped") << -120.0 << true;
+    QTest::newRow("middle") << 0.0 << false;
+    QTest::newRow("middle, unwrapped") << 0.0 << true;
+    QTest::newRow("east") << 120.0 << false;
+    QTest::newRow("east, unwrapped") << 120.0 << true;
+}
+
+void tst_QGeoProjectionWrap::wrapList()
+{
+    QFETCH(double, longitude);
+    QFETCH(bool, unwrap);
+    setCamera(longitude);
+    const double unwrapBelowX = m_projection.wrapMapProjection(m_path.at(8)).x();
+
+    // appended to what is there
+    QList<QDoubleVector2D> wrapped;
+    wrapped.append(QDoubleVector2D(-1.0, -1.0));
+    QVERIFY(m_projection.wrapMapProjections(m_path, wrapped, unwrap, unwrapBelowX));
+    QCOMPARE(wrapped.size(), m_path.size() + 1);
+    QCOMPARE(wrapped.first(), QDoubleVector2D(-1.0, -1.0));
+    for (int i = 0; i < m_path.size(); ++i) {
+        const QDoubleVector2D expected = reference(m_path.at(i), unwrap, unwrapBelowX);
+        QVERIFY2(wrapped.at(i + 1).x() == expected.x() && wrapped.at(i + 1).y() == expected.y(),
+                 qPrintable(QStringLiteral("point %1 at %2 instead of %3")
+                            .arg(i).arg(wrapped.at(i + 1).x()).arg(expected.x())));
+        if (unwrap)
+            QVERIFY(wrapped.at(i + 1).x() >= unwrapBelowX);
+    }
+}
+
+void tst_QGeoProjectionWrap::wrapArray_data()
+{
+    wrapList_data();
+}
+
+// Also in place
+void tst_QGeoProjectionWrap::wrapArray()
+{
+    QFETCH(double, longitude);
+    QFETCH(bool, unwrap);
+    setCamera(longitude);
+    const double unwrapBelowX = 0.3;
+
+    const QVector<QDoubleVector2D> path = m_path.toVector();
+    QVector<QDoubleVector2D> wrapped(path.size());
+    QVERIFY(m_projection.wrapMapProjections(path.constData(), wrapped.data(), path.size(), unwrap, unwrapBelowX));
+    QVector<QDoubleVector2D> inPlace = path;
+    QVERIFY(m_projection.wrapMapProjections(inPlace.constData(), inPlace.data(), inPlace.size(),
+                                            unwrap, unwrapBelowX));
+    for (int i = 0; i < path.size(); ++i) {
+        const QDoubleVector2D expected = reference(path.at(i), unwrap, unwrapBelowX);
+        QVERIFY(wrapped.at(i).x() == expected.x() && wrapped.at(i).y() == expected.y());
+        QVERIFY(inPlace.at(i).x() == expected.x() && inPlace.at(i).y() == expected.y());
+    }
+
+    QVERIFY(m_projection.wrapMapProjections(path.constData(), wrapped.data(), 0, unwrap, unwrapBelowX));
+}
+
+// A single projection that is not finite fails the whole path, wherever it is
+void tst_QGeoProjectionWrap::notFinite()
+{
+    setCamera(120.0);
+    const double values[] = { qQNaN(), qInf(), -qInf() };
+    for (double value : values) {
+        for (int i : { 0, 10, m_path.size() - 1 }) {
+            QList<QDoubleVector2D> path = m_path;
+            path[i].setY(value);
+            QList<QDoubleVector2D> wrapped;
+            QVERIFY(!m_projection.wrapMapProjections(path, wrapped));
+            QVERIFY(!m_projection.wrapMapProjections(path, wrapped, true, 0.3));
+
+            path = m_path;
+            path[i].setX(value);
+            QVector<QDoubleVector2D> array = path.toVector();
+            QVERIFY(!m_projection.wrapMapProjections(array.constData(), array.data(), array.size()));
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoProjectionWrap)
+
+#include "tst_qgeoprojectionwrap.moc"
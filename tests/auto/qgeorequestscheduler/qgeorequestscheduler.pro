@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeorequestscheduler
+
+SOURCES += tst_qgeorequestscheduler.cpp
+
+QT += location-private testlib
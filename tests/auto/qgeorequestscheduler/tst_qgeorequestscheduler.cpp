@@ -0,0 +1,282 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtLocation/private/qgeorequestscheduler_p.h>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+// Emits aborted() like the geoservice replies
+class Request : public QObject
+{
+    Q_OBJECT
+public:
+    void abort() { emit aborted(); }
+Q_SIGNALS:
+    void aborted();
+};
+
+class tst_QGeoRequestScheduler : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void unlimited();
+    void rateLimit();
+    void priority();
+    void coalescing();
+    void droppedRequests();
+    void notStarted();
+    void throttledResponse();
+    void configure();
+    void parseRetryAfter_data();
+    void parseRetryAfter();
+
+private:
+    void schedule(const QString &host, QObject *request, int id,
+                  QGeoRequestScheduler::Priority priority = QGeoRequestScheduler::NormalPriority,
+                  const QString &coalescingKey = QString());
+
+    QList<int> m_started;
+    QList<int> m_superseded;
+};
+
+// Hosts are not removed from the per thread scheduler, so every test uses its own
+void tst_QGeoRequestScheduler::schedule(const QString &host, QObject *request, int id,
+                                        QGeoRequestScheduler::Priority priority,
+                                        const QString &coalescingKey)
+{
+    QGeoRequestScheduler::instance()->schedule(host, request, [this, id]() {
+        m_started.append(id);
+        return true;
+    }, priority, coalescingKey, [this, id]() { m_superseded.append(id); });
+}
+
+void tst_QGeoRequestScheduler::unlimited()
+{
+    m_started.clear();
+    QObject request;
+    for (int i = 0; i < 5; ++i)
+        schedule(QStringLiteral("unlimited"), &request, i);
+    QCOMPARE(m_started, QList<int>({ 0, 1, 2, 3, 4 }));
+    QCOMPARE(QGeoRequestScheduler::instance()->pendingCount(QStringLiteral("unlimited")), 0);
+}
+
+void tst_QGeoRequestScheduler::rateLimit()
+{
+    m_started.clear();
+    const QString host = QStringLiteral("rate");
+    QGeoRequestScheduler *scheduler = QGeoRequestScheduler::instance();
+    scheduler->setRateLimit(host, 10, 2);
+
+    QObject request;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 5; ++i)
+        schedule(host, &request, i);
+
+    // The burst goes out at once, the others a tenth of a second apart
+    QCOMPARE(m_started, QList<int>({ 0, 1 }));
+    QCOMPARE(scheduler->pendingCount(host), 3);
+    QTRY_COMPARE(m_started.size(), 5);
+    QCOMPARE(m_started, QList<int>({ 0, 1, 2, 3, 4 }));
+    QVERIFY(timer.elapsed() >= 250);
+    QCOMPARE(scheduler->pendingCount(host), 0);
+}
+
+void tst_QGeoRequestScheduler::priority()
+{
+    m_started.clear();
+    const QString host = QStringLiteral("priority");
+    QGeoRequestScheduler::instance()->setRateLimit(host, 20, 1);
+
+    QObject request;
+    schedule(host, &request, 0);
+    schedule(host, &request, 1, QGeoRequestScheduler::BackgroundPriority);
+    schedule(host, &request, 2, QGeoRequestScheduler::NormalPriority);
+    schedule(host, &request, 3, QGeoRequestScheduler::InteractivePriority);
+    schedule(host, &request, 4, QGeoRequestScheduler::NormalPriority);
+    QCOMPARE(m_started, QList<int>({ 0 }));
+
+    // By priority, then in order
+    QTRY_COMPARE(m_started.size(), 5);
+    QCOMPARE(m_started, QList<int>({ 0, 3, 2, 4, 1 }));
+}
+
+void tst_QGeoRequestScheduler::coalescing()
+{
+    m_started.clear();
+    m_superseded.clear();
+    const QString host = QStringLiteral("coalescing");
+    QGeoRequestScheduler::instance()->setRateLimit(host, 20, 1);
+
+    QObject request;
+    schedule(host, &request, 0, QGeoRequestScheduler::InteractivePriority, QStringLiteral("search"));
+    schedule(host, &request, 1, QGeoRequestScheduler::InteractivePriority, QStringLiteral("search"));
+    schedule(host, &request, 2, QGeoRequestScheduler::NormalPriority, QStringLiteral("other"));
+    schedule(host, &request, 3, QGeoRequestScheduler::InteractivePriority, QStringLiteral("search"));
+
+    // The request started first is not superseded, only the queued one
+    QCOMPARE(m_superseded, QList<int>({ 1 }));
+    QTRY_COMPARE(m_started.size(), 3);
+    QCOMPARE(m_started, QList<int>({ 0, 3, 2 }));
+}
+
+void tst_QGeoRequestScheduler::droppedRequests()
+{
+    m_started.clear();
+    const QString host = QStringLiteral("dropped");
+    QGeoRequestScheduler *scheduler = QGeoRequestScheduler::instance();
+    scheduler->setRateLimit(host, 20, 1);
+
+    QObject first;
+    Request aborted;
+    QScopedPointer<QObject> destroyed(new QObject);
+    QObject last;
+    schedule(host, &first, 0);
+    schedule(host, &aborted, 1);
+    schedule(host, destroyed.data(), 2);
+    schedule(host, &last, 3);
+    QCOMPARE(scheduler->pendingCount(host), 3);
+
+    aborted.abort();
+    destroyed.reset();
+    QTRY_COMPARE(m_started.size(), 2);
+    QCOMPARE(m_started, QList<int>({ 0, 3 }));
+    QCOMPARE(scheduler->pendingCount(host), 0);
+}
+
+// A request not sending anything gives its token back
+void tst_QGeoRequestScheduler::notStarted()
+{
+    const QString host = QStringLiteral("not started");
+    QGeoRequestScheduler *scheduler = QGeoRequestScheduler::instance();
+    scheduler->setRateLimit(host, 0.1, 1);
+
+    QObject request;
+    int attempts = 0;
+    scheduler->schedule(host, &request, [&attempts]() {
+        ++attempts;
+        return false;
+    });
+    bool started = false;
+    scheduler->schedule(host, &request, [&started]() {
+        started = true;
+        return true;
+    });
+    QCOMPARE(attempts, 1);
+    QVERIFY(started);
+    QCOMPARE(scheduler->pendingCount(host), 0);
+}
+
+void tst_QGeoRequestScheduler::throttledResponse()
+{
+    m_started.clear();
+    const QString host = QStringLiteral("throttled");
+    QGeoRequestScheduler *scheduler = QGeoRequestScheduler::instance();
+
+    // Paused for the time of the Retry-After header
+    QObject request;
+    QElapsedTimer timer;
+    timer.start();
+    scheduler->reportResponse(host, 429, QByteArray("1"));
+    schedule(host, &request, 0);
+    QVERIFY(m_started.isEmpty());
+    QCOMPARE(scheduler->pendingCount(host), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(m_started.size(), 1, 5000);
+    QVERIFY(timer.elapsed() >= 900);
+
+    // Without a header, the pause starts at a second
+    timer.restart();
+    scheduler->reportResponse(host, 503, QByteArray());
+    schedule(host, &request, 1);
+    QCOMPARE(m_started.size(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(m_started.size(), 2, 5000);
+    QVERIFY(timer.elapsed() >= 900);
+
+    // Other responses don't pause the host
+    scheduler->reportResponse(host, 200, QByteArray());
+    scheduler->reportResponse(host, 404, QByteArray("10"));
+    schedule(host, &request, 2);
+    QCOMPARE(m_started.size(), 3);
+}
+
+void tst_QGeoRequestScheduler::configure()
+{
+    m_started.clear();
+    const QString host = QStringLiteral("configured");
+    QGeoRequestScheduler *scheduler = QGeoRequestScheduler::instance();
+
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("test.geocoding.rate_limit"), 0.5);
+    parameters.insert(QStringLiteral("test.geocoding.burst"), 2);
+    parameters.insert(QStringLiteral("test.routing.rate_limit"), 100);
+    scheduler->configure(host, parameters, QStringLiteral("test.geocoding."));
+
+    QObject request;
+    for (int i = 0; i < 3; ++i)
+        schedule(host, &request, i);
+    QCOMPARE(m_started, QList<int>({ 0, 1 }));
+    QCOMPARE(scheduler->pendingCount(host), 1);
+
+    // Without entries under the prefix, the limit stays
+    scheduler->configure(host, parameters, QStringLiteral("test.places."));
+    QCOMPARE(scheduler->pendingCount(host), 1);
+
+    // A zero rate removes the limit
+    parameters.insert(QStringLiteral("test.places.rate_limit"), 0);
+    scheduler->configure(host, parameters, QStringLiteral("test.places."));
+    QCOMPARE(m_started, QList<int>({ 0, 1, 2 }));
+}
+
+void tst_QGeoRequestScheduler::parseRetryAfter_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<qint64>("expected");
+
+    QTest::newRow("empty") << QByteArray() << qint64(-1);
+    QTest::newRow("seconds") << QByteArray(" 120 ") << qint64(120000);
+    QTest::newRow("negative") << QByteArray("-5") << qint64(0);
+    QTest::newRow("invalid") << QByteArray("soon") << qint64(-1);
+    QTest::newRow("past date") << QByteArray("Wed, 21 Oct 2015 07:28:00 GMT") << qint64(0);
+}
+
+void tst_QGeoRequestScheduler::parseRetryAfter()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(qint64, expected);
+    QCOMPARE(QGeoRequestScheduler::parseRetryAfter(value), expected);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRequestScheduler)
+
+#include "tst_qgeorequestscheduler.moc"
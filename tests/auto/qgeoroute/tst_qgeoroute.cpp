@@ -301,6 +301,70 @@ void tst_QGeoRoute::operators()
     delete qgeoroutecopy;
 }
 
+void tst_QGeoRoute::encoding()
+{
+    QList<QGeoCoordinate> path;
+    for (int i = 0; i < 20; ++i)
+        path << QGeoCoordinate(52.5 + 0.0001 * i, 13.4 - 0.0002 * i);
+    const QList<QGeoCoordinate> first = path.mid(0, 11);
+    const QList<QGeoCoordinate> second = path.mid(10);
+
+    QGeoManeuver maneuver;
+    maneuver.setInstructionText(QStringLiteral("Turn left"));
+    maneuver.setDirection(QGeoManeuver::DirectionLeft);
+    maneuver.setPosition(path.at(10));
+    maneuver.setTimeToNextInstruction(42);
+    maneuver.setDistanceToNextInstruction(420.5);
+    maneuver.setExtendedAttributes({ { QStringLiteral("street"), QStringLiteral("Unter den Linden") } });
+
+    QGeoRouteSegment segment1;
+    segment1.setPath(first);
+    segment1.setTravelTime(60);
+    segment1.setDistance(700.25);
+    segment1.setManeuver(maneuver);
+    QGeoRouteSegment segment2;
+    segment2.setPath(second);
+    segment2.setTravelTime(50);
+    segment2.setDistance(600.75);
+    segment1.setNextRouteSegment(segment2);
+
+    QGeoRoute route;
+    route.setRouteId(QStringLiteral("route 1"));
+    route.setTravelMode(QGeoRouteRequest::PedestrianTravel);
+    route.setTravelTime(110);
+    route.setDistance(1301.0);
+    route.setBounds(QGeoPath(path).boundingGeoRectangle());
+    route.setPath(path);
+    route.setFirstRouteSegment(segment1);
+    route.setExtendedAttributes({ { QStringLiteral("provider"), 3 } });
+
+    const QByteArray data = QGeoRouteEncoding::encode(route);
+    QGeoRoute decoded;
+    QVERIFY(QGeoRouteEncoding::decode(data, &decoded));
+    QCOMPARE(decoded.routeId(), route.routeId());
+    QCOMPARE(decoded.travelMode(), route.travelMode());
+    QCOMPARE(decoded.travelTime(), route.travelTime());
+    QCOMPARE(decoded.distance(), route.distance());
+    QCOMPARE(decoded.bounds(), route.bounds());
+    QCOMPARE(decoded.path(), route.path());
+    QCOMPARE(decoded.extendedAttributes(), route.extendedAttributes());
+
+    const QGeoRouteSegment s1 = decoded.firstRouteSegment();
+    QCOMPARE(s1.path(), first);
+    QCOMPARE(s1.travelTime(), 60);
+    QCOMPARE(s1.distance(), 700.25);
+    QCOMPARE(s1.maneuver(), maneuver);
+    const QGeoRouteSegment s2 = s1.nextRouteSegment();
+    QCOMPARE(s2.path(), second);
+    QCOMPARE(s2.distance(), 600.75);
+    QVERIFY(!s2.maneuver().isValid());
+    QVERIFY(!s2.nextRouteSegment().isValid());
+
+    // every truncation is rejected rather than read past the end
+    for (int size = 0; size < data.size(); ++size)
+        QVERIFY(!QGeoRouteEncoding::decode(data.left(size), &decoded));
+}
+
 
 
 QTEST_APPLESS_MAIN(tst_QGeoRoute);
@@ -35,9 +35,12 @@
 
 #include <qgeoroute.h>
 #include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoPath>
 #include <qgeocoordinate.h>
 #include <qgeorouterequest.h>
 #include <qgeoroutesegment.h>
+#include <qgeomaneuver.h>
+#include <QtLocation/private/qgeorouteencoding_p.h>
 
 
 QT_USE_NAMESPACE
@@ -70,6 +73,7 @@ private Q_SLOTS:
     void travelMode_data();
     void travelTime();
     void operators();
+    void encoding();
     //End Unit Test for QGeoRoute
 
 private:
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeorouteparserosrmv5
+
+SOURCES += tst_qgeorouteparserosrmv5.cpp
+
+QT += location-private positioning testlib
@@ -0,0 +1,312 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoRouteLeg>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+// Finishes with the routes parsed, as the route replies of the plugins do
+class AsyncRouteReply : public QGeoRouteReply
+{
+    Q_OBJECT
+public:
+    AsyncRouteReply() : QGeoRouteReply(QGeoRouteRequest()) {}
+
+    void parse(const QGeoRouteParser &parser, const QByteArray &json)
+    {
+        parser.parseReplyAsync(json, this, [this](QGeoRouteReply::Error error, const QString &errorString,
+                                                  const QList<QGeoRoute> &routes) {
+            ++callbacks;
+            if (error == QGeoRouteReply::NoError) {
+                setRoutes(routes);
+                setFinished(true);
+            } else {
+                setError(error, errorString);
+            }
+        });
+    }
+
+    int callbacks = 0;
+};
+
+typedef QVector<QPair<qint64, qint64> > MicroDegrees; // latitude, longitude
+
+class tst_QGeoRouteParserOsrmV5 : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodeGeometry_data();
+    void decodeGeometry();
+    void longGeometry();
+    void truncatedGeometry();
+    void routePathSlices();
+    void parseAsync();
+    void abortDuringParseAsync();
+
+private:
+    static QString encode(const MicroDegrees &points);
+    static QByteArray reply(const QVector<QVector<QString> > &legs);
+    static QList<QGeoCoordinate> coordinates(const MicroDegrees &points);
+    static QList<QGeoRoute> parse(const QByteArray &json);
+};
+
+static void encodeValue(qint64 value, QString &out)
+{
+    quint64 u = value < 0 ? ~(quint64(value) << 1) : quint64(value) << 1;
+    while (u >= 0x20) {
+        out += QChar(ushort((0x20 | (u & 0x1f)) + 63));
+        u >>= 5;
+    }
+    out += QChar(ushort(u + 63));
+}
+
+QString tst_QGeoRouteParserOsrmV5::encode(const MicroDegrees &points)
+{
+    QString out;
+    qint64 latitude = 0;
+    qint64 longitude = 0;
+    for (const auto &p : points) {
+        encodeValue(p.first - latitude, out);
+        encodeValue(p.second - longitude, out);
+        latitude = p.first;
+        longitude = p.second;
+    }
+    return out;
+}
+
+// A route of one step per geometry, in legs
+QByteArray tst_QGeoRouteParserOsrmV5::reply(const QVector<QVector<QString> > &legs)
+{
+    QJsonArray jsonLegs;
+    for (const QVector<QString> &geometries : legs) {
+        QJsonArray steps;
+        for (const QString &geometry : geometries) {
+            QJsonObject maneuver;
+            maneuver.insert(QStringLiteral("location"), QJsonArray { 0.0, 0.0 });
+            maneuver.insert(QStringLiteral("type"), QStringLiteral("continue"));
+            QJsonObject step;
+            step.insert(QStringLiteral("duration"), 10.0);
+            step.insert(QStringLiteral("distance"), 100.0);
+            step.insert(QStringLiteral("intersections"), QJsonArray());
+            step.insert(QStringLiteral("maneuver"), maneuver);
+            step.insert(QStringLiteral("geometry"), geometry);
+            steps.append(step);
+        }
+        QJsonObject leg;
+        leg.insert(QStringLiteral("distance"), 100.0 * geometries.size());
+        leg.insert(QStringLiteral("duration"), 10.0 * geometries.size());
+        leg.insert(QStringLiteral("steps"), steps);
+        jsonLegs.append(leg);
+    }
+    QJsonObject route;
+    route.insert(QStringLiteral("distance"), 1000.0);
+    route.insert(QStringLiteral("duration"), 100.0);
+    route.insert(QStringLiteral("legs"), jsonLegs);
+    QJsonObject json;
+    json.insert(QStringLiteral("code"), QStringLiteral("Ok"));
+    json.insert(QStringLiteral("routes"), QJsonArray { route });
+    return QJsonDocument(json).toJson(QJsonDocument::Compact);
+}
+
+QList<QGeoCoordinate> tst_QGeoRouteParserOsrmV5::coordinates(const MicroDegrees &points)
+{
+    QList<QGeoCoordinate> path;
+    for (const auto &p : points)
+        path.append(QGeoCoordinate(p.first / 1e6, p.second / 1e6));
+    return path;
+}
+
+QList<QGeoRoute> tst_QGeoRouteParserOsrmV5::parse(const QByteArray &json)
+{
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoRoute> routes;
+    QString errorString;
+    if (parser.parseReply(routes, errorString, json) != QGeoRouteReply::NoError)
+        qWarning() << errorString;
+    return routes;
+}
+
+void tst_QGeoRouteParserOsrmV5::decodeGeometry_data()
+{
+    QTest::addColumn<MicroDegrees>("points");
+    QTest::newRow("empty") << MicroDegrees();
+    QTest::newRow("origin") << (MicroDegrees() << qMakePair(0, 0));
+    QTest::newRow("berlin") << (MicroDegrees() << qMakePair(52520008, 13404954)
+                                << qMakePair(52516275, 13377704) << qMakePair(52516275, 13377705));
+    QTest::newRow("far apart") << (MicroDegrees() << qMakePair(-89999999, -179999999)
+                                   << qMakePair(89999999, 179999999) << qMakePair(-33868820, 151209296));
+}
+
+void tst_QGeoRouteParserOsrmV5::decodeGeometry()
+{
+    QFETCH(MicroDegrees, points);
+    const QList<QGeoRoute> routes = parse(reply({ { encode(points) } }));
+    QCOMPARE(routes.size(), 1);
+    QCOMPARE(routes.first().firstRouteSegment().path(), coordinates(points));
+    QCOMPARE(routes.first().path(), coordinates(points));
+}
+
+// the running sums stay exact along the route
+void tst_QGeoRouteParserOsrmV5::longGeometry()
+{
+    MicroDegrees points;
+    qint64 latitude = 10000000;
+    qint64 longitude = 20000000;
+    for (int i = 0; i < 20000; ++i) {
+        latitude += (i % 7) - 3;
+        longitude += (i % 11) - 4;
+        points << qMakePair(latitude, longitude);
+    }
+    const QList<QGeoRoute> routes = parse(reply({ { encode(points) } }));
+    QCOMPARE(routes.size(), 1);
+    const QList<QGeoCoordinate> path = routes.first().path();
+    QCOMPARE(path.size(), points.size());
+    QCOMPARE(path.last(), QGeoCoordinate(latitude / 1e6, longitude / 1e6));
+    QCOMPARE(path, coordinates(points));
+}
+
+// a point cut short is dropped
+void tst_QGeoRouteParserOsrmV5::truncatedGeometry()
+{
+    const MicroDegrees points = MicroDegrees() << qMakePair(52520008, 13404954)
+                                               << qMakePair(52516275, 13377704);
+    QString geometry = encode(points);
+    geometry.chop(1);
+    const QList<QGeoRoute> routes = parse(reply({ { geometry } }));
+    QCOMPARE(routes.size(), 1);
+    QCOMPARE(routes.first().path(), coordinates(points).mid(0, 1));
+}
+
+// legs and segments see their own ranges of the route path
+void tst_QGeoRouteParserOsrmV5::routePathSlices()
+{
+    QVector<QVector<MicroDegrees> > legs(2);
+    qint64 latitude = 48000000;
+    for (auto &leg : legs) {
+        for (int step = 0; step < 3; ++step) {
+            MicroDegrees points;
+            for (int i = 0; i <= step; ++i)
+                points << qMakePair(latitude++, qint64(11000000 + step));
+            leg << points;
+        }
+    }
+    QVector<QVector<QString> > geometries;
+    QList<QGeoCoordinate> routePath;
+    QVector<QList<QGeoCoordinate> > legPaths;
+    for (const auto &leg : legs) {
+        QVector<QString> steps;
+        QList<QGeoCoordinate> legPath;
+        for (const MicroDegrees &points : leg) {
+            steps << encode(points);
+            legPath << coordinates(points);
+        }
+        geometries << steps;
+        legPaths << legPath;
+        routePath << legPath;
+    }
+
+    const QList<QGeoRoute> routes = parse(reply(geometries));
+    QCOMPARE(routes.size(), 1);
+    const QGeoRoute route = routes.first();
+    QCOMPARE(route.path(), routePath);
+
+    const QList<QGeoRouteLeg> routeLegs = route.routeLegs();
+    QCOMPARE(routeLegs.size(), legs.size());
+    QGeoRouteSegment segment = route.firstRouteSegment();
+    for (int l = 0; l < routeLegs.size(); ++l) {
+        QCOMPARE(routeLegs.at(l).path(), legPaths.at(l));
+        QGeoRouteSegment legSegment = routeLegs.at(l).firstRouteSegment();
+        for (const MicroDegrees &points : legs.at(l)) {
+            QVERIFY(segment.isValid());
+            QCOMPARE(segment.path(), coordinates(points));
+            QCOMPARE(legSegment.path(), coordinates(points));
+            segment = segment.nextRouteSegment();
+            legSegment = legSegment.nextRouteSegment();
+        }
+    }
+    QVERIFY(!segment.isValid());
+
+    // setPath replaces the slice
+    QGeoRouteSegment first = route.firstRouteSegment();
+    const QList<QGeoCoordinate> replaced { QGeoCoordinate(1.0, 2.0), QGeoCoordinate(3.0, 4.0) };
+    first.setPath(replaced);
+    QCOMPARE(first.path(), replaced);
+    QCOMPARE(route.path(), routePath);
+}
+
+void tst_QGeoRouteParserOsrmV5::parseAsync()
+{
+    const MicroDegrees points = MicroDegrees() << qMakePair(52520008, 13404954)
+                                               << qMakePair(52516275, 13377704);
+    QGeoRouteParserOsrmV5 parser;
+    AsyncRouteReply routeReply;
+    QSignalSpy finishedSpy(&routeReply, &QGeoRouteReply::finished);
+    routeReply.parse(parser, reply({ { encode(points) } }));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(routeReply.callbacks, 1);
+    QCOMPARE(routeReply.routes().size(), 1);
+    QCOMPARE(routeReply.routes().first().path(), coordinates(points));
+}
+
+// an aborted reply does not finish with the routes parsed meanwhile
+void tst_QGeoRouteParserOsrmV5::abortDuringParseAsync()
+{
+    MicroDegrees points;
+    for (int i = 0; i < 200000; ++i)
+        points << qMakePair(qint64(10000000 + i % 1000), qint64(20000000 + i));
+    const QByteArray json = reply({ { encode(points) } });
+
+    QGeoRouteParserOsrmV5 parser;
+    AsyncRouteReply routeReply;
+    QSignalSpy finishedSpy(&routeReply, &QGeoRouteReply::finished);
+    QSignalSpy errorSpy(&routeReply, SIGNAL(error(QGeoRouteReply::Error,QString)));
+    routeReply.parse(parser, json);
+    routeReply.abort();
+
+    QVERIFY(QThreadPool::globalInstance()->waitForDone(30000));
+    QCoreApplication::processEvents();
+    QTest::qWait(50);
+    QCOMPARE(routeReply.callbacks, 0);
+    QCOMPARE(finishedSpy.count(), 0);
+    QCOMPARE(errorSpy.count(), 0);
+    QVERIFY(!routeReply.isFinished());
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteParserOsrmV5)
+
+#include "tst_qgeorouteparserosrmv5.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoroutetracker
+
+SOURCES += \
+    tst_qgeoroutetracker.cpp
+
+QT += positioning testlib location
+QT += location-private
@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtLocation/QGeoManeuver>
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoRouteRequest>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtLocation/private/qgeoroutetracker_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoRouteTracker : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void progress();
+    void offRoute();
+    void splice();
+
+private:
+    static QGeoRoute route();
+};
+
+// Two segments of 1000 m and 100 s along the equator, the second starting
+// with a maneuver.
+QGeoRoute tst_QGeoRouteTracker::route()
+{
+    QGeoRouteSegment first;
+    first.setPath({ QGeoCoordinate(0, 0), QGeoCoordinate(0, 0.005), QGeoCoordinate(0, 0.01) });
+    first.setDistance(1000);
+    first.setTravelTime(100);
+
+    QGeoManeuver maneuver;
+    maneuver.setPosition(QGeoCoordinate(0, 0.01));
+    QGeoRouteSegment second;
+    second.setPath({ QGeoCoordinate(0, 0.01), QGeoCoordinate(0, 0.02) });
+    second.setDistance(1000);
+    second.setTravelTime(100);
+    second.setManeuver(maneuver);
+    first.setNextRouteSegment(second);
+
+    QGeoRoute route;
+    route.setFirstRouteSegment(first);
+    route.setDistance(2000);
+    route.setTravelTime(200);
+    return route;
+}
+
+void tst_QGeoRouteTracker::progress()
+{
+    QGeoRouteTracker tracker(route());
+    QVERIFY(!tracker.hasMatch());
+    QVERIFY(tracker.isOnRoute());
+    QCOMPARE(tracker.remainingTravelDistance(), 2000.0);
+    QCOMPARE(tracker.distanceToNextManeuver(), 1000.0);
+
+    QVERIFY(tracker.update(QGeoCoordinate(0.0001, 0.0025)));
+    QVERIFY(tracker.hasMatch());
+    QCOMPARE(tracker.currentSegment(), 0);
+    QVERIFY(qAbs(tracker.traveledDistance() - 250) < 1);
+    QVERIFY(qAbs(tracker.remainingTravelDistance() - 1750) < 1);
+    QVERIFY(qAbs(tracker.distanceToNextManeuver() - 750) < 1);
+    QCOMPARE(tracker.traveledTime(), 25);
+    QCOMPARE(tracker.timeToNextManeuver(), 75);
+    QVERIFY(qAbs(tracker.distanceFromRoute() - 11.1) < 0.5);
+    QVERIFY(qAbs(tracker.matchedPosition().latitude()) < 1e-9);
+
+    QVERIFY(tracker.update(QGeoCoordinate(-0.0001, 0.015)));
+    QCOMPARE(tracker.currentSegment(), 1);
+    QCOMPARE(tracker.currentLeg(), 0);
+    QVERIFY(qAbs(tracker.traveledDistance() - 1500) < 1);
+    QVERIFY(qAbs(tracker.remainingTravelDistanceToNextWaypoint() - 500) < 1);
+    QCOMPARE(tracker.remainingTravelTime(), 50);
+
+    tracker.reset();
+    QVERIFY(!tracker.hasMatch());
+    QCOMPARE(tracker.traveledDistance(), 0.0);
+}
+
+void tst_QGeoRouteTracker::offRoute()
+{
+    QGeoRouteTracker tracker(route());
+    tracker.setOffRouteThreshold(20);
+
+    QVERIFY(tracker.update(QGeoCoordinate(0, 0.015)));
+    const double traveled = tracker.traveledDistance();
+
+    // 0.001 degrees are about 111 m
+    QVERIFY(!tracker.update(QGeoCoordinate(0.001, 0.016)));
+    QVERIFY(!tracker.isOnRoute());
+    QCOMPARE(tracker.traveledDistance(), traveled);
+
+    // Far behind the last match, found by searching the whole path
+    QVERIFY(tracker.update(QGeoCoordinate(0, 0.001)));
+    QVERIFY(tracker.isOnRoute());
+    QCOMPARE(tracker.currentSegment(), 0);
+    QVERIFY(qAbs(tracker.traveledDistance() - 100) < 1);
+}
+
+void tst_QGeoRouteTracker::splice()
+{
+    QGeoRouteTracker tracker(route());
+    QCOMPARE(tracker.splice(QGeoRoute()).distance(), QGeoRoute().distance());
+    QVERIFY(tracker.update(QGeoCoordinate(0, 0.015)));
+
+    const QGeoCoordinate position(0.001, 0.015);
+    const QGeoRouteRequest request = tracker.rerouteRequest(position);
+    QCOMPARE(request.waypoints(), QList<QGeoCoordinate>() << position << QGeoCoordinate(0, 0.02));
+
+    QGeoRouteSegment segment;
+    segment.setPath({ position, QGeoCoordinate(0.001, 0.03) });
+    segment.setDistance(1700);
+    segment.setTravelTime(170);
+    QGeoRoute remainder;
+    remainder.setFirstRouteSegment(segment);
+    remainder.setDistance(1700);
+    remainder.setTravelTime(170);
+
+    const QGeoRoute spliced = tracker.splice(remainder);
+    QVERIFY(qAbs(spliced.distance() - 3200) < 1);
+    QCOMPARE(spliced.travelTime(), 320);
+    QCOMPARE(spliced.path().size(), 7);
+    QCOMPARE(spliced.path().first(), QGeoCoordinate(0, 0));
+    QCOMPARE(spliced.path().last(), QGeoCoordinate(0.001, 0.03));
+
+    // The segments traveled, the current one ending at the matched position
+    QGeoRouteSegment first = spliced.firstRouteSegment();
+    QCOMPARE(first.path().size(), 3);
+    QCOMPARE(first.distance(), 1000.0);
+    QGeoRouteSegment second = first.nextRouteSegment();
+    QCOMPARE(second.path().last(), tracker.matchedPosition());
+    QVERIFY(qAbs(second.distance() - 500) < 1);
+    QVERIFY(second.maneuver().isValid());
+    QGeoRouteSegment third = second.nextRouteSegment();
+    QCOMPARE(third.path(), segment.path());
+    QVERIFY(!third.nextRouteSegment().isValid());
+    // the current route is left alone
+    QCOMPARE(tracker.route().firstRouteSegment().nextRouteSegment().nextRouteSegment().isValid(), false);
+
+    // Tracking the spliced route goes on from the traveled distance
+    QGeoRouteTracker next(spliced);
+    QVERIFY(next.update(QGeoCoordinate(0.001, 0.02)));
+    QCOMPARE(next.currentSegment(), 2);
+    QVERIFY(qAbs(next.remainingTravelDistance() - 1700 * 2 / 3.0) < 5);
+}
+
+QTEST_MAIN(tst_QGeoRouteTracker)
+#include "tst_qgeoroutetracker.moc"
@@ -30,6 +30,8 @@
 
 #include "tst_qgeoroutingmanager.h"
 
+#include <qgeorectangle.h>
+
 QT_USE_NAMESPACE
 
 
@@ -161,5 +163,144 @@ void tst_QGeoRoutingManager::update()
     delete reply;
 }
 
+void tst_QGeoRoutingManager::calculateMatrix()
+{
+    const QList<QGeoCoordinate> origins = { QGeoCoordinate(1, 0), QGeoCoordinate(2, 0), QGeoCoordinate(3, 0) };
+    const QList<QGeoCoordinate> destinations = { QGeoCoordinate(10, 0), QGeoCoordinate(20, 0), QGeoCoordinate(30, 0) };
+
+    // At most 2 origins and 4 coordinates a block, so 4 blocks
+    QSignalSpy finishedSpy(qgeoroutingmanager, SIGNAL(finished(QGeoRouteReply*)));
+    QGeoRouteMatrixReply *matrix = qgeoroutingmanager->calculateRouteMatrix(origins, destinations);
+    QTRY_VERIFY(matrix->isFinished());
+    QCOMPARE(matrix->error(), QGeoRouteReply::NoError);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(matrix->origins(), origins);
+    QCOMPARE(matrix->destinations(), destinations);
+    QCOMPARE(matrix->durations().size(), 9);
+    for (int i = 0; i < origins.size(); ++i) {
+        for (int j = 0; j < destinations.size(); ++j) {
+            QCOMPARE(matrix->duration(i, j), origins.at(i).latitude() + destinations.at(j).latitude());
+            QCOMPARE(matrix->distance(i, j), origins.at(i).latitude() - destinations.at(j).latitude());
+        }
+    }
+    QVERIFY(qIsNaN(matrix->duration(3, 0)));
+    delete matrix;
+
+    // A single block is the reply of the engine
+    matrix = qgeoroutingmanager->calculateRouteMatrix(origins.mid(0, 2), destinations.mid(0, 2));
+    QVERIFY(matrix->isFinished());
+    QCOMPARE(matrix->duration(1, 1), 22.0);
+    delete matrix;
+}
+
+static QGeoServiceProvider *cachingProvider(int size, int ttl = 300)
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("georoute.test.plugin.routing.cache.size"), size);
+    parameters.insert(QStringLiteral("georoute.test.plugin.routing.cache.ttl"), ttl);
+    return new QGeoServiceProvider(QStringLiteral("georoute.test.plugin"), parameters, true);
+}
+
+// The travel time of a route is the number of routes calculated by the engine
+// so far, so a cached route has the travel time of the first calculation
+static int calculatedRoute(QGeoRoutingManager *manager, const QGeoRouteRequest &request)
+{
+    QScopedPointer<QGeoRouteReply> reply(manager->calculateRoute(request));
+    if (!reply->isFinished() || reply->error() != QGeoRouteReply::NoError || reply->routes().isEmpty())
+        return -1;
+    return reply->routes().first().travelTime();
+}
+
+void tst_QGeoRoutingManager::routeCache()
+{
+    // Without the parameter every request reaches the engine
+    const QGeoRouteRequest request(QGeoCoordinate(12.12, 23.23), QGeoCoordinate(34.34, 89.32));
+    const int first = calculatedRoute(qgeoroutingmanager, request);
+    QVERIFY(first > 0);
+    QCOMPARE(calculatedRoute(qgeoroutingmanager, request), first + 1);
+
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider(2));
+    QGeoRoutingManager *manager = provider->routingManager();
+    QVERIFY(manager);
+
+    QCOMPARE(calculatedRoute(manager, request), 1);
+    QScopedPointer<QGeoRouteReply> cached(manager->calculateRoute(request));
+    QVERIFY(cached->isFinished());
+    QCOMPARE(cached->error(), QGeoRouteReply::NoError);
+    QCOMPARE(cached->request(), request);
+    QCOMPARE(cached->routes().size(), 1);
+    QCOMPARE(cached->routes().first().travelTime(), 1);
+    QCOMPARE(cached->routes().first().path(), request.waypoints());
+
+    // The least recently used entry goes first
+    const QGeoRouteRequest second(QGeoCoordinate(1.0, 2.0), QGeoCoordinate(3.0, 4.0));
+    const QGeoRouteRequest third(QGeoCoordinate(5.0, 6.0), QGeoCoordinate(7.0, 8.0));
+    QCOMPARE(calculatedRoute(manager, second), 2);
+    QCOMPARE(calculatedRoute(manager, request), 1);
+    QCOMPARE(calculatedRoute(manager, third), 3);
+    QCOMPARE(calculatedRoute(manager, request), 1);
+    QCOMPARE(calculatedRoute(manager, second), 4);
+}
+
+void tst_QGeoRoutingManager::routeCacheKey()
+{
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider(100));
+    QGeoRoutingManager *manager = provider->routingManager();
+    QVERIFY(manager);
+
+    const QDateTime departure(QDate(2020, 6, 1), QTime(12, 1), Qt::UTC);
+    QGeoRouteRequest request(QGeoCoordinate(12.12, 23.23), QGeoCoordinate(34.34, 89.32));
+    request.setDepartureTime(departure);
+    QCOMPARE(calculatedRoute(manager, request), 1);
+
+    // Waypoints within a meter and departures in the same quarter of an hour match
+    QGeoRouteRequest nearby(QGeoCoordinate(12.1200001, 23.2299999), QGeoCoordinate(34.34, 89.3200001));
+    nearby.setDepartureTime(departure.addSecs(10 * 60));
+    QCOMPARE(calculatedRoute(manager, nearby), 1);
+
+    QGeoRouteRequest moved(request);
+    moved.setWaypoints({ QGeoCoordinate(12.1201, 23.23), QGeoCoordinate(34.34, 89.32) });
+    QCOMPARE(calculatedRoute(manager, moved), 2);
+
+    QGeoRouteRequest later(request);
+    later.setDepartureTime(departure.addSecs(15 * 60));
+    QCOMPARE(calculatedRoute(manager, later), 3);
+
+    QGeoRouteRequest optimized(request);
+    optimized.setRouteOptimization(QGeoRouteRequest::ShortestRoute);
+    QCOMPARE(calculatedRoute(manager, optimized), 4);
+
+    QGeoRouteRequest avoiding(request);
+    avoiding.setFeatureWeight(QGeoRouteRequest::TollFeature, QGeoRouteRequest::AvoidFeatureWeight);
+    QCOMPARE(calculatedRoute(manager, avoiding), 5);
+
+    QGeoRouteRequest excluding(request);
+    excluding.setExcludeAreas({ QGeoRectangle(QGeoCoordinate(20.0, 30.0), QGeoCoordinate(19.0, 31.0)) });
+    QCOMPARE(calculatedRoute(manager, excluding), 6);
+
+    QGeoRouteRequest extra(request);
+    extra.setExtraParameters({ { QStringLiteral("test"), QVariantMap { { QStringLiteral("value"), 1 } } } });
+    QCOMPARE(calculatedRoute(manager, extra), 7);
+
+    // The locale changes the instructions
+    manager->setLocale(QLocale(QLocale::French, QLocale::France));
+    QCOMPARE(calculatedRoute(manager, request), 8);
+    QCOMPARE(calculatedRoute(manager, nearby), 8);
+}
+
+void tst_QGeoRoutingManager::routeCacheExpiry()
+{
+    QScopedPointer<QGeoServiceProvider> provider(cachingProvider(10, 1));
+    QGeoRoutingManager *manager = provider->routingManager();
+    QVERIFY(manager);
+
+    const QGeoRouteRequest request(QGeoCoordinate(12.12, 23.23), QGeoCoordinate(34.34, 89.32));
+    QCOMPARE(calculatedRoute(manager, request), 1);
+    QCOMPARE(calculatedRoute(manager, request), 1);
+    QTest::qWait(1100);
+    QCOMPARE(calculatedRoute(manager, request), 2);
+    QCOMPARE(calculatedRoute(manager, request), 2);
+}
+
 QTEST_MAIN(tst_QGeoRoutingManager)
 
@@ -37,6 +37,7 @@
 #include <qgeoroutingmanager.h>
 #include <qgeorouterequest.h>
 #include <qgeoroutereply.h>
+#include <qgeoroutematrixreply.h>
 #include <qgeocoordinate.h>
 #include <qgeoroute.h>
 
@@ -57,6 +58,10 @@ private Q_SLOTS:
     void version();
     void calculate();
     void update();
+    void calculateMatrix();
+    void routeCache();
+    void routeCacheKey();
+    void routeCacheExpiry();
 
 private:
     QGeoServiceProvider *qgeoserviceprovider;
@@ -34,9 +34,52 @@
 #include <qgeocoordinate.h>
 #include <qgeoroutereply.h>
 #include <qgeorouterequest.h>
+#include <qgeoroutematrixreply.h>
+#include <qgeoroute.h>
 
 QT_USE_NAMESPACE
 
+// Finishes at once with a route along the waypoints, its travel time telling
+// how many routes the engine calculated so far
+class QGeoRouteReplyTest : public QGeoRouteReply
+{
+    Q_OBJECT
+public:
+    QGeoRouteReplyTest(const QGeoRouteRequest &request, int count, QObject *parent)
+        : QGeoRouteReply(QGeoRouteReply::NoError, QStringLiteral("no error"), parent)
+    {
+        QGeoRoute route;
+        route.setRequest(request);
+        route.setPath(request.waypoints());
+        route.setTravelTime(count);
+        setRoutes(QList<QGeoRoute>() << route);
+    }
+};
+
+// Finishes at once, the duration being the sum of the latitudes of the origin
+// and destination, and the distance their difference
+class QGeoRouteMatrixReplyTest : public QGeoRouteMatrixReply
+{
+    Q_OBJECT
+public:
+    QGeoRouteMatrixReplyTest(const QList<QGeoCoordinate> &origins,
+                             const QList<QGeoCoordinate> &destinations,
+                             const QGeoRouteRequest &request, QObject *parent)
+        : QGeoRouteMatrixReply(origins, destinations, request, parent)
+    {
+        QVector<double> durations;
+        QVector<double> distances;
+        for (const QGeoCoordinate &origin : origins) {
+            for (const QGeoCoordinate &destination : destinations) {
+                durations.append(origin.latitude() + destination.latitude());
+                distances.append(origin.latitude() - destination.latitude());
+            }
+        }
+        setBlock(0, 0, origins.size(), durations, distances);
+        setFinished(true);
+    }
+};
+
 class QGeoRoutingManagerEngineTest: public QGeoRoutingManagerEngine
 
 {
@@ -54,12 +97,12 @@ public:
         setSupportedRouteOptimizations(QGeoRouteRequest::FastestRoute);
         setSupportedSegmentDetails(QGeoRouteRequest::BasicSegmentData);
         setSupportedManeuverDetails(QGeoRouteRequest::BasicManeuvers);
+        setRouteMatrixLimits(2, 0, 4);
     }
 
     QGeoRouteReply* calculateRoute(const QGeoRouteRequest& request)
     {
-        Q_UNUSED(request);
-        return new QGeoRouteReply(QGeoRouteReply::NoError,"no error");
+        return new QGeoRouteReplyTest(request, ++routeRequests, this);
     }
 
     QGeoRouteReply* updateRoute(const QGeoRoute &route, const QGeoCoordinate &position)
@@ -70,6 +113,18 @@ public:
 
     }
 
+    // Looked up by QGeoRoutingManager, called once per block
+    Q_INVOKABLE QGeoRouteMatrixReply *calculateRouteMatrix(const QList<QGeoCoordinate> &origins,
+                                                           const QList<QGeoCoordinate> &destinations,
+                                                           const QGeoRouteRequest &request)
+    {
+        ++matrixBlocks;
+        return new QGeoRouteMatrixReplyTest(origins, destinations, request, this);
+    }
+
+    int matrixBlocks = 0;
+    int routeRequests = 0;
+
 
 };
 
@@ -6,4 +6,4 @@ SOURCES += tst_qgeoserviceprovider.cpp
 
 CONFIG -= app_bundle
 
-QT += testlib location
+QT += testlib location-private
@@ -30,6 +30,7 @@
 #include <QDebug>
 #include <QTest>
 #include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeoserviceprovider_p.h>
 
 QT_USE_NAMESPACE
 
@@ -44,6 +45,7 @@ private slots:
     void tst_features();
     void tst_misc();
     void tst_nokiaRename();
+    void tst_reload();
 };
 
 void tst_QGeoServiceProvider::initTestCase()
@@ -227,6 +229,21 @@ void tst_QGeoServiceProvider::tst_nokiaRename()
 
 }
 
+// Reloading replaces the plugin metadata instead of appending to it
+void tst_QGeoServiceProvider::tst_reload()
+{
+    const QStringList provider = QGeoServiceProvider::availableServiceProviders();
+    QVERIFY(provider.contains(QStringLiteral("geocode.test.plugin")));
+
+    QGeoServiceProviderPrivate::plugins(true);
+    QCOMPARE(QGeoServiceProvider::availableServiceProviders().size(), provider.size());
+    QGeoServiceProviderPrivate::plugins(true);
+    QCOMPARE(QGeoServiceProvider::availableServiceProviders().size(), provider.size());
+
+    QGeoServiceProvider test(QStringLiteral("geocode.test.plugin"), QVariantMap(), true);
+    QCOMPARE(test.error(), QGeoServiceProvider::NoError);
+}
+
 QTEST_GUILESS_MAIN(tst_QGeoServiceProvider)
 
 #include "tst_qgeoserviceprovider.moc"
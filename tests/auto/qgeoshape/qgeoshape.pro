@@ -1,5 +1,5 @@
 load(testcase)
 TARGET = tst_qgeoshape
-QT += testlib positioning
+QT += testlib positioning-private
 SOURCES = \
     tst_qgeoshape.cpp
@@ -31,6 +31,11 @@
 #include <QtCore/QDebug>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qgeoshape_p.h>
+#include <QtCore/QBitArray>
+#include <QtCore/QThread>
 
 QString tst_qgeoshape_debug;
 
@@ -55,6 +60,10 @@ private slots:
     void debug_data();
     void debug();
     void conversions();
+    void batchContains_data();
+    void batchContains();
+    void frozenShape_data() { batchContains_data(); }
+    void frozenShape();
 };
 
 void tst_qgeoshape::testArea()
@@ -126,5 +135,93 @@ void tst_qgeoshape::conversions()
     QVERIFY(varCircle.canConvert<QGeoShape>());
 }
 
+void tst_qgeoshape::batchContains_data()
+{
+    QTest::addColumn<QGeoShape>("shape");
+
+    QList<QGeoCoordinate> polygon;
+    polygon << QGeoCoordinate(10, -20) << QGeoCoordinate(40, 0)
+            << QGeoCoordinate(10, 20) << QGeoCoordinate(-30, 0);
+
+    QTest::newRow("empty") << QGeoShape();
+    QTest::newRow("rectangle") << QGeoShape(QGeoRectangle(QGeoCoordinate(30, -40), QGeoCoordinate(-10, 60)));
+    QTest::newRow("rectangle across dateline")
+            << QGeoShape(QGeoRectangle(QGeoCoordinate(30, 170), QGeoCoordinate(-10, -170)));
+    QTest::newRow("rectangle touching pole")
+            << QGeoShape(QGeoRectangle(QGeoCoordinate(90, 0), QGeoCoordinate(70, 20)));
+    QTest::newRow("circle") << QGeoShape(QGeoCircle(QGeoCoordinate(10, 10), 1500000));
+    QTest::newRow("circle across dateline") << QGeoShape(QGeoCircle(QGeoCoordinate(-20, 178), 800000));
+    QTest::newRow("circle around pole") << QGeoShape(QGeoCircle(QGeoCoordinate(85, 0), 1000000));
+    QTest::newRow("large circle") << QGeoShape(QGeoCircle(QGeoCoordinate(0, 0), 15000000));
+    QTest::newRow("polygon") << QGeoShape(QGeoPolygon(polygon));
+    QTest::newRow("path") << QGeoShape(QGeoPath(polygon, 200000));
+}
+
+void tst_qgeoshape::batchContains()
+{
+    QFETCH(QGeoShape, shape);
+
+    QList<QGeoCoordinate> coordinates;
+    for (double lat = -90.0; lat <= 90.0; lat += 2.5) {
+        for (double lon = -180.0; lon <= 180.0; lon += 5.0)
+            coordinates << QGeoCoordinate(lat, lon);
+    }
+    coordinates << QGeoCoordinate() << QGeoCoordinate(10, 10);
+    QVERIFY(coordinates.size() % 2);
+
+    const QBitArray mask = shape.contains(coordinates);
+    QCOMPARE(mask.size(), coordinates.size());
+    int inside = 0;
+    for (int i = 0; i < coordinates.size(); ++i) {
+        QCOMPARE(mask.testBit(i), shape.contains(coordinates.at(i)));
+        inside += mask.testBit(i);
+    }
+    QCOMPARE(inside > 0, shape.isValid());
+
+    QVERIFY(shape.contains(QList<QGeoCoordinate>()).isEmpty());
+}
+
+void tst_qgeoshape::frozenShape()
+{
+    QFETCH(QGeoShape, shape);
+
+    QList<QGeoCoordinate> coordinates;
+    for (double lat = -90.0; lat <= 90.0; lat += 2.5) {
+        for (double lon = -180.0; lon <= 180.0; lon += 5.0)
+            coordinates << QGeoCoordinate(lat, lon);
+    }
+    const QBitArray expected = shape.contains(coordinates);
+    const QGeoPackedCoordinates packed = qPackCoordinates(coordinates);
+    const int maskSize = (packed.size() + 7) / 8;
+
+    const QGeoFrozenShape frozen(shape);
+    QCOMPARE(frozen.type(), shape.type());
+    QCOMPARE(frozen.isValid(), shape.isValid());
+    QCOMPARE(frozen.boundingGeoRectangle(), shape.boundingGeoRectangle());
+    QCOMPARE(frozen.shape(), shape);
+
+    // all threads read the same snapshot
+    QList<QByteArray> masks;
+    QList<QThread *> threads;
+    for (int i = 0; i < 4; ++i) {
+        masks.append(QByteArray(maskSize, '\xff'));
+        uchar *mask = reinterpret_cast<uchar *>(masks.last().data());
+        threads.append(QThread::create([&frozen, &packed, mask]() {
+            frozen.containsBatch(packed, mask);
+        }));
+        threads.last()->start();
+    }
+    for (int i = 0; i < threads.size(); ++i) {
+        QVERIFY(threads.at(i)->wait());
+        delete threads.at(i);
+        QCOMPARE(QBitArray::fromBits(masks.at(i).constData(), packed.size()), expected);
+    }
+
+    // modifying a copy leaves the snapshot alone
+    QGeoShape copy = frozen.shape();
+    copy.extendShape(QGeoCoordinate(80, 170));
+    QCOMPARE(frozen.shape(), shape);
+}
+
 QTEST_MAIN(tst_qgeoshape)
 #include "tst_qgeoshape.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoshapeencoding
+
+SOURCES += tst_qgeoshapeencoding.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/private/qgeoshapeencoding_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoShapeEncoding : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void precision();
+    void altitude();
+    void size();
+    void malformed_data();
+    void malformed();
+    void sequence();
+};
+
+static QList<QGeoCoordinate> track()
+{
+    QList<QGeoCoordinate> path;
+    for (int i = 0; i < 100; ++i)
+        path << QGeoCoordinate(59.91 + 0.0000123 * i, 10.75 - 0.0000234 * i);
+    return path;
+}
+
+void tst_QGeoShapeEncoding::roundTrip_data()
+{
+    QTest::addColumn<QGeoShape>("shape");
+
+    QGeoPolygon polygon({ QGeoCoordinate(10, 10), QGeoCoordinate(10, 20), QGeoCoordinate(20, 20),
+                          QGeoCoordinate(20, 10) });
+    polygon.addHole(QList<QGeoCoordinate> { QGeoCoordinate(12, 12), QGeoCoordinate(12, 14), QGeoCoordinate(14, 14) });
+    polygon.addHole(QList<QGeoCoordinate> { QGeoCoordinate(16, 16), QGeoCoordinate(16, 18), QGeoCoordinate(18, 18) });
+
+    QTest::newRow("unknown") << QGeoShape();
+    QTest::newRow("empty path") << QGeoShape(QGeoPath());
+    QTest::newRow("path") << QGeoShape(QGeoPath(track()));
+    QTest::newRow("path with width") << QGeoShape(QGeoPath(track(), 12.5));
+    QTest::newRow("dateline path") << QGeoShape(QGeoPath({ QGeoCoordinate(-90, 179.9999999),
+                                                           QGeoCoordinate(90, -180) }));
+    QTest::newRow("polygon") << QGeoShape(QGeoPolygon(track()));
+    QTest::newRow("polygon with holes") << QGeoShape(polygon);
+    QTest::newRow("rectangle") << QGeoShape(QGeoRectangle(QGeoCoordinate(60, 10), QGeoCoordinate(59, 11)));
+    QTest::newRow("invalid rectangle") << QGeoShape(QGeoRectangle());
+    QTest::newRow("circle") << QGeoShape(QGeoCircle(QGeoCoordinate(59.91, 10.75, 12), 1500.25));
+    QTest::newRow("invalid circle") << QGeoShape(QGeoCircle());
+}
+
+void tst_QGeoShapeEncoding::roundTrip()
+{
+    QFETCH(QGeoShape, shape);
+
+    const QByteArray data = QGeoShapeEncoding::encode(shape);
+    QGeoShape decoded;
+    QVERIFY(QGeoShapeEncoding::decode(data, &decoded));
+    QCOMPARE(decoded.type(), shape.type());
+    QCOMPARE(decoded.isValid(), shape.isValid());
+    // all the coordinates above have at most 7 decimals
+    QCOMPARE(decoded, shape);
+    if (shape.type() == QGeoShape::PathType)
+        QCOMPARE(QGeoPath(decoded).width(), QGeoPath(shape).width());
+    if (shape.type() == QGeoShape::PolygonType) {
+        const QGeoPolygon polygon(shape);
+        const QGeoPolygon decodedPolygon(decoded);
+        QCOMPARE(decodedPolygon.holesCount(), polygon.holesCount());
+        for (int i = 0; i < polygon.holesCount(); ++i)
+            QCOMPARE(decodedPolygon.holePath(i), polygon.holePath(i));
+        QCOMPARE(decodedPolygon.contains(QGeoCoordinate(13.5, 12.5)),
+                 polygon.contains(QGeoCoordinate(13.5, 12.5)));
+    }
+}
+
+void tst_QGeoShapeEncoding::precision()
+{
+    const QGeoPath path({ QGeoCoordinate(59.123456789, 10.987654321) });
+
+    QGeoShape decoded;
+    QVERIFY(QGeoShapeEncoding::decode(QGeoShapeEncoding::encode(path, 5), &decoded));
+    QCOMPARE(QGeoPath(decoded).coordinateAt(0), QGeoCoordinate(59.12346, 10.98765));
+    QVERIFY(QGeoShapeEncoding::decode(QGeoShapeEncoding::encode(path, 9), &decoded));
+    QCOMPARE(QGeoPath(decoded).coordinateAt(0), path.coordinateAt(0));
+}
+
+void tst_QGeoShapeEncoding::altitude()
+{
+    // vertices without an altitude keep none
+    const QGeoPath path({ QGeoCoordinate(1, 1, 100.25), QGeoCoordinate(2, 2), QGeoCoordinate(3, 3, -20) });
+    QGeoShape decoded;
+    QVERIFY(QGeoShapeEncoding::decode(QGeoShapeEncoding::encode(path), &decoded));
+    const QGeoPath decodedPath(decoded);
+    QCOMPARE(decodedPath.coordinateAt(0).altitude(), 100.25);
+    QVERIFY(qIsNaN(decodedPath.coordinateAt(1).altitude()));
+    QCOMPARE(decodedPath.coordinateAt(1).type(), QGeoCoordinate::Coordinate2D);
+    QCOMPARE(decodedPath.coordinateAt(2).altitude(), -20.0);
+}
+
+void tst_QGeoShapeEncoding::size()
+{
+    const QGeoPath path(track());
+    QByteArray stream;
+    {
+        QDataStream out(&stream, QIODevice::WriteOnly);
+        out << QGeoShape(path);
+    }
+    const QByteArray data = QGeoShapeEncoding::encode(path);
+    // two bytes per delta from the second vertex on, where doubles take 24 per vertex
+    QVERIFY(data.size() < 4 + 1 + 2 * 5 + 99 * 2 * 2);
+    QVERIFY(data.size() * 4 < stream.size());
+}
+
+void tst_QGeoShapeEncoding::malformed_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    const QByteArray path = QGeoShapeEncoding::encode(QGeoPath(track()));
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("header only") << path.left(4);
+    QTest::newRow("truncated") << path.left(path.size() - 1);
+    QTest::newRow("trailing data") << path + char(0);
+    QByteArray newer = path;
+    newer[0] = char(QGeoShapeEncoding::Version + 1);
+    QTest::newRow("newer version") << newer;
+    QByteArray precision = path;
+    precision[3] = char(QGeoShapeEncoding::MaximumPrecision + 1);
+    QTest::newRow("precision") << precision;
+    QByteArray type = path;
+    type[1] = char(42);
+    QTest::newRow("type") << type;
+
+    // a count larger than the data, which must not be allocated
+    QByteArray count = path.left(4);
+    QGeoShapeEncoding::encodeVarint(Q_UINT64_C(1) << 40, count);
+    QTest::newRow("count") << count;
+
+    // a latitude beyond 90 degrees
+    QByteArray range = path.left(4);
+    QGeoShapeEncoding::encodeVarint(1, range);
+    QGeoShapeEncoding::encodeVarint(2 * Q_UINT64_C(910000000), range);
+    QGeoShapeEncoding::encodeVarint(0, range);
+    QTest::newRow("range") << range;
+
+    QByteArray varint = path.left(4);
+    varint += QByteArray(11, char(0xff));
+    QTest::newRow("varint") << varint;
+}
+
+void tst_QGeoShapeEncoding::malformed()
+{
+    QFETCH(QByteArray, data);
+    QGeoShape shape;
+    QVERIFY(!QGeoShapeEncoding::decode(data, &shape));
+}
+
+void tst_QGeoShapeEncoding::sequence()
+{
+    // shapes appended to one buffer are read back one after the other
+    QByteArray data;
+    const QGeoPath path(track());
+    const QGeoCircle circle(QGeoCoordinate(1, 2), 3);
+    QGeoShapeEncoding::encode(path, data);
+    QGeoShapeEncoding::encode(circle, data);
+
+    QGeoShape shape;
+    qint64 consumed;
+    QVERIFY(QGeoShapeEncoding::decode(data.constData(), data.size(), &shape, &consumed));
+    QCOMPARE(shape, QGeoShape(path));
+    QVERIFY(QGeoShapeEncoding::decode(data.constData() + consumed, data.size() - consumed, &shape,
+                                      &consumed));
+    QCOMPARE(shape, QGeoShape(circle));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoShapeEncoding)
+
+#include "tst_qgeoshapeencoding.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeosimplify
+
+SOURCES += tst_qgeosimplify.cpp
+
+QT += location-private positioning-private quick testlib
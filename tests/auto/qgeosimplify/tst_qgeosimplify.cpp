@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeosimplify_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+
+QT_USE_NAMESPACE
+
+typedef QDeclarativeGeoMapItemUtils::vec2 Vertex;
+
+Q_DECLARE_METATYPE(QList<QDoubleVector2D>)
+
+class tst_QGeoSimplify : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void significanceMatchesSimplify_data();
+    void significanceMatchesSimplify();
+    void lodSignificanceMatchesSimplify();
+
+private:
+    static QList<QDoubleVector2D> track(const QGeoCoordinate &start, int size, double step);
+};
+
+// A random walk in mercator coordinates, with steps of about the given length
+QList<QDoubleVector2D> tst_QGeoSimplify::track(const QGeoCoordinate &start, int size, double step)
+{
+    QRandomGenerator rng(42);
+    QList<QDoubleVector2D> points;
+    QDoubleVector2D p = QWebMercator::coordToMercator(start);
+    double heading = 0.0;
+    for (int i = 0; i < size; ++i) {
+        heading += (rng.generateDouble() - 0.5) * 0.6;
+        p += QDoubleVector2D(std::cos(heading), std::sin(heading)) * step * (1.0 + rng.generateDouble());
+        points << p;
+    }
+    return points;
+}
+
+void tst_QGeoSimplify::significanceMatchesSimplify_data()
+{
+    QTest::addColumn<QList<QDoubleVector2D>>("points");
+    QTest::addColumn<double>("leftBound");
+
+    const QList<QDoubleVector2D> city = track(QGeoCoordinate(59.91, 10.75), 5000, 2e-8);
+    QTest::newRow("city") << city << city.first().x();
+    const QList<QDoubleVector2D> continent = track(QGeoCoordinate(45.0, 10.0), 5000, 2e-5);
+    QTest::newRow("continent") << continent << continent.first().x();
+    const QList<QDoubleVector2D> arctic = track(QGeoCoordinate(80.0, -40.0), 5000, 1e-6);
+    QTest::newRow("arctic") << arctic << arctic.first().x();
+
+    // Unwrapped across the antimeridian, x goes past 1
+    QList<QDoubleVector2D> antimeridian;
+    for (int i = 0; i < 2000; ++i)
+        antimeridian << QDoubleVector2D(0.99 + i * 0.00001, 0.4 + (i % 7) * 0.000003);
+    QTest::newRow("antimeridian") << antimeridian << 0.99;
+
+    QList<QDoubleVector2D> segment { QDoubleVector2D(0.1, 0.5), QDoubleVector2D(0.2, 0.5) };
+    QTest::newRow("two points") << segment << 0.1;
+}
+
+void tst_QGeoSimplify::significanceMatchesSimplify()
+{
+    QFETCH(QList<QDoubleVector2D>, points);
+    QFETCH(double, leftBound);
+
+    const QVector<quint8> significance = QGeoSimplify::zoomLevelSignificance(points, leftBound);
+    QCOMPARE(significance.size(), points.size());
+    QCOMPARE(significance.first(), quint8(0));
+    QCOMPARE(significance.last(), quint8(0));
+
+    for (int zoom = 0; zoom <= 24; ++zoom) {
+        const QList<QDoubleVector2D> expected = QGeoSimplify::geoSimplifyZL(points, leftBound, zoom);
+        const QList<QDoubleVector2D> filtered =
+                QGeoSimplify::filterByZoomLevel(points.toVector(), significance, zoom).toList();
+        if (filtered != expected)
+            QFAIL(qPrintable(QString("zoom %1: %2 points instead of %3")
+                             .arg(zoom).arg(filtered.size()).arg(expected.size())));
+    }
+}
+
+// The levels of detail are filtered by the significance of the vertices relative to m_origin,
+// which has to keep the same vertices as simplifying the absolute path
+void tst_QGeoSimplify::lodSignificanceMatchesSimplify()
+{
+    const QList<QDoubleVector2D> points = track(QGeoCoordinate(59.91, 10.75), 5000, 2e-7);
+    const double leftBound = points.first().x();
+
+    QGeoMapPolylineGeometryOpenGL geometry;
+    geometry.m_origin = points.first();
+    QVector<Vertex> vertices;
+    for (const QDoubleVector2D &p : points)
+        vertices << Vertex(p - geometry.m_origin);
+    *geometry.m_verticesLOD[0] = vertices;
+
+    // What the levels of detail actually get, back in absolute mercator
+    QList<QDoubleVector2D> absolute;
+    for (const Vertex &v : qAsConst(vertices))
+        absolute << v.toDoubleVector2D() + geometry.m_origin;
+
+    const QSharedPointer<const QVector<quint8>> significance = geometry.significance(leftBound);
+    QCOMPARE(significance->size(), vertices.size());
+    QCOMPARE(geometry.significance(leftBound), significance); // cached for the same left bound
+
+    for (unsigned int zoom = 0; zoom <= 20; ++zoom) {
+        const QList<QDoubleVector2D> expected = QGeoSimplify::geoSimplifyZL(absolute, leftBound, int(zoom));
+        QList<QDoubleVector2D> filtered;
+        for (const Vertex &v : QGeoMapItemLODGeometry::getSimplified(vertices, *significance, zoom))
+            filtered << v.toDoubleVector2D() + geometry.m_origin;
+        if (filtered != expected)
+            QFAIL(qPrintable(QString("zoom %1: %2 points instead of %3")
+                             .arg(zoom).arg(filtered.size()).arg(expected.size())));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoSimplify)
+
+#include "tst_qgeosimplify.moc"
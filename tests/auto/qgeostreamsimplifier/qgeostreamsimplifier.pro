@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeostreamsimplifier
+
+SOURCES += tst_qgeostreamsimplifier.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QtPositioning/private/qgeostreamsimplifier_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoStreamSimplifier : public QObject
+{
+    Q_OBJECT
+
+private:
+    // the path the simplifier builds from coordinates
+    static QList<QGeoCoordinate> simplify(double tolerance, const QList<QGeoCoordinate> &coordinates)
+    {
+        QGeoStreamSimplifier simplifier(tolerance);
+        QList<QGeoCoordinate> path;
+        for (const QGeoCoordinate &coordinate : coordinates) {
+            if (simplifier.add(coordinate))
+                path.last() = coordinate;
+            else
+                path.append(coordinate);
+        }
+        return path;
+    }
+
+private slots:
+    void straight()
+    {
+        // 1 km east in steps of about 111 meters, then north
+        QList<QGeoCoordinate> coordinates;
+        for (int i = 0; i <= 10; ++i)
+            coordinates.append(QGeoCoordinate(0, i * 0.001));
+        for (int i = 1; i <= 5; ++i)
+            coordinates.append(QGeoCoordinate(i * 0.001, 0.01));
+
+        const QList<QGeoCoordinate> path = simplify(5, coordinates);
+        QCOMPARE(path.size(), 3);
+        QCOMPARE(path.at(0), coordinates.first());
+        QCOMPARE(path.at(1), coordinates.at(10));
+        QCOMPARE(path.at(2), coordinates.last());
+
+        QCOMPARE(simplify(0, coordinates), coordinates);
+    }
+
+    void tolerance()
+    {
+        // zigzagging about 2 meters on both sides of the equator
+        QList<QGeoCoordinate> coordinates;
+        for (int i = 0; i <= 10; ++i)
+            coordinates.append(QGeoCoordinate((i % 2 ? 1 : -1) * 0.00002, i * 0.001));
+        QCOMPARE(simplify(5, coordinates).size(), 2);
+        QCOMPARE(simplify(1, coordinates).size(), coordinates.size());
+
+        // going back is not within the segment to the new vertex
+        const QList<QGeoCoordinate> back = { QGeoCoordinate(0, 0), QGeoCoordinate(0, 0.002),
+                                             QGeoCoordinate(0, 0.001) };
+        QCOMPARE(simplify(5, back), back);
+    }
+
+    void reset()
+    {
+        QGeoStreamSimplifier simplifier(5);
+        QVERIFY(simplifier.isEmpty());
+        simplifier.reset(QGeoCoordinate(0, 0));
+        QVERIFY(!simplifier.isEmpty());
+        // the anchor is kept, the vertex after it is not replaced
+        QVERIFY(!simplifier.add(QGeoCoordinate(0, 0.001)));
+        QVERIFY(simplifier.add(QGeoCoordinate(0, 0.002)));
+
+        simplifier.setTolerance(0);
+        QVERIFY(simplifier.isEmpty());
+        QVERIFY(!simplifier.add(QGeoCoordinate(0, 0.003)));
+        QVERIFY(!simplifier.add(QGeoCoordinate(0, 0.004)));
+        QVERIFY(!simplifier.add(QGeoCoordinate(0, 0.005)));
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_QGeoStreamSimplifier)
+#include "tst_qgeostreamsimplifier.moc"
@@ -30,6 +30,7 @@
 #include "qgeotilefetcher_test.h"
 #include "qgeotiledmappingmanagerengine_test.h"
 #include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
 #include <QtTest/QtTest>
 #include <QtTest/QSignalSpy>
 #include <QtPositioning/private/qwebmercator_p.h>
@@ -37,6 +38,10 @@
 #include <QtLocation/private/qgeotiledmap_p.h>
 #include <QtLocation/private/qgeomappingmanager_p.h>
 #include <QtLocation/private/qgeocameracapabilities_p.h>
+#include <QtLocation/private/qgeotiledownloadjob_p.h>
+#include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoCircle>
 
 QT_USE_NAMESPACE
 
@@ -53,6 +58,20 @@ public:
     QSet<QGeoTileSpec> m_tiles;
 };
 
+class SharedTileCache : public QGeoFileTileCache
+{
+public:
+    SharedTileCache(const QString &directory) : QGeoFileTileCache(directory)
+    {
+        setShared(true);
+    }
+
+    void initialize()
+    {
+        init();
+    }
+};
+
 class tst_QGeoTiledMap : public QObject
 {
     Q_OBJECT
@@ -63,11 +82,31 @@ public:
 
 private:
     void waitForFetch(int count);
+    QGeoServiceProvider *createManualProvider();
+    QGeoTiledMapTest *createMap(QGeoServiceProvider *provider, const QSize &viewportSize);
+    static void finishReplies(QGeoTileFetcherTest *fetcher);
+    static QGeoTileSpec tile(int x, int y, int zoom = 4)
+    {
+        return QGeoTileSpec(QStringLiteral("qmlgeo.test.plugin"), 1, zoom, x, y);
+    }
 
 private Q_SLOTS:
     void initTestCase();
     void fetchTiles();
     void fetchTiles_data();
+    void prefetchCorridor();
+    void framePacing();
+    void progressiveLoading();
+    void overlayMapTypes();
+    void downloadTiles();
+    void tilesForShape();
+    void memoryPressure();
+    void sharedCache();
+    void textureUsageSizing();
+    void fetchOrder();
+    void requestWindow();
+    void sharedRequests();
+    void predictivePrefetch();
 
 private:
     QScopedPointer<QGeoTiledMapTest> m_map;
@@ -196,6 +235,645 @@ void tst_QGeoTiledMap::fetchTiles_data()
     QTest::newRow("zoomLevel: 4.6 ,visible count: 4 : prefetch count: 4") << 4.6 << 4 << 4 + 4  + 4 << QGeoTiledMap::PrefetchTwoNeighbourLayers << 5;
 }
 
+void tst_QGeoTiledMap::prefetchCorridor()
+{
+    m_map->setPrefetchStyle(QGeoTiledMap::NoPrefetching);
+
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4.0);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setCameraData(camera);
+    waitForFetch(4);
+    const QSet<QGeoTileSpec> visible = m_tilesCounter->m_tiles;
+    QCOMPARE(visible.size(), 4);
+
+    // Along the parallel at 10 degrees north, which is in the row 7 of the
+    // 16 rows at zoom level 4, eastwards from the center of the map
+    const QList<QGeoCoordinate> path { QGeoCoordinate(10.0, 0.0), QGeoCoordinate(10.0, 170.0) };
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->prefetchCorridor(path, 1000.0);
+    waitForFetch(4 + 4 * 4);
+    const QSet<QGeoTileSpec> fetched = m_tilesCounter->m_tiles;
+    QVERIFY(fetched.contains(visible));
+
+    // The corridor covers a tile on each side of the path, from its start,
+    // and stops at four times the visible tiles
+    QSet<QPair<int, int> > corridor;
+    for (const QGeoTileSpec &tile : fetched - visible) {
+        QCOMPARE(tile.zoom(), 4);
+        QVERIFY(tile.y() >= 6 && tile.y() <= 8);
+        QVERIFY(tile.x() >= 7);
+        corridor.insert(qMakePair(tile.x(), tile.y()));
+    }
+    for (int x = 9; x <= 10; ++x) {
+        for (int y = 6; y <= 8; ++y)
+            QVERIFY(corridor.contains(qMakePair(x, y)));
+    }
+    QVERIFY(fetched.size() <= visible.size() * (1 + 4) + 3 * 3);
+    for (const auto &tile : corridor)
+        QVERIFY(tile.first < 14);
+
+    // An empty path clears the corridor
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->prefetchCorridor(QList<QGeoCoordinate>(), 1000.0);
+    waitForFetch(4);
+    QCOMPARE(m_tilesCounter->m_tiles, visible);
+
+    // Nothing is prefetched under memory pressure
+    QAbstractGeoTileCache *cache = m_map->m_engine->tileCache();
+    cache->setMemoryPressure(QAbstractGeoTileCache::ModerateMemoryPressure);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->prefetchCorridor(path, 1000.0);
+    waitForFetch(4 + 4 * 4);
+    QCOMPARE(m_tilesCounter->m_tiles, visible);
+    cache->setMemoryPressure(QAbstractGeoTileCache::NoMemoryPressure);
+
+    m_map->prefetchCorridor(QList<QGeoCoordinate>(), 0.0);
+    m_map->setPrefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers);
+}
+
+void tst_QGeoTiledMap::framePacing()
+{
+    m_map->setPrefetchStyle(QGeoTiledMap::NoPrefetching);
+
+    // While paced, the tiles are requested once per frame
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4.0);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setFramePacing(true);
+    m_map->setCameraData(camera);
+    QTest::qWait(300);
+    QVERIFY(m_tilesCounter->m_tiles.isEmpty());
+    m_map->prepareFrame();
+    waitForFetch(4);
+    QCOMPARE(m_tilesCounter->m_tiles.size(), 4);
+
+    // A slow frame, within the same tiles
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5001, 0.5)));
+    m_map->setCameraData(camera);
+    m_map->prepareFrame();
+
+    // A jump of a thousand pixels within a frame defers the visible tiles
+    // until the motion ends
+    m_tilesCounter->m_tiles.clear();
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.75, 0.5)));
+    m_map->setCameraData(camera);
+    m_map->prepareFrame();
+    QTest::qWait(300);
+    QVERIFY(m_tilesCounter->m_tiles.isEmpty());
+
+    m_map->setFramePacing(false);
+    waitForFetch(4);
+    QCOMPARE(m_tilesCounter->m_tiles.size(), 4);
+    for (const QGeoTileSpec &tile : qAsConst(m_tilesCounter->m_tiles)) {
+        QCOMPARE(tile.zoom(), 4);
+        QVERIFY(tile.x() >= 11 && tile.x() <= 12);
+    }
+
+    // Without pacing, camera changes update the tiles right away
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    m_map->setCameraData(camera);
+    waitForFetch(4);
+    QCOMPARE(m_tilesCounter->m_tiles.size(), 4);
+
+    m_map->setPrefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers);
+}
+
+// After a jump, the few tiles of a lower zoom level covering the view are
+// fetched along with the visible ones
+void tst_QGeoTiledMap::progressiveLoading()
+{
+    m_map->setPrefetchStyle(QGeoTiledMap::NoPrefetching);
+    m_map->setViewportSize(QSize(512, 512));
+
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4.0);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setCameraData(camera);
+    waitForFetch(9);
+    QTest::qWait(100);
+    const QSet<QGeoTileSpec> visible = m_tilesCounter->m_tiles;
+    QVERIFY(visible.size() > 4);
+    for (const QGeoTileSpec &tile : visible)
+        QCOMPARE(tile.zoom(), 4);
+
+    // four tiles to the west
+    m_map->setProgressiveLoading(true);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.25, 0.5)));
+    m_map->setCameraData(camera);
+    waitForFetch(visible.size() + 1);
+    QTest::qWait(100);
+
+    QSet<QGeoTileSpec> moved;
+    for (QGeoTileSpec tile : visible) {
+        tile.setX(tile.x() - 4);
+        moved.insert(tile);
+    }
+    QSet<QGeoTileSpec> current;
+    QSet<QGeoTileSpec> ancestors;
+    for (const QGeoTileSpec &tile : qAsConst(m_tilesCounter->m_tiles))
+        (tile.zoom() == 4 ? current : ancestors).insert(tile);
+    // the visible tiles are still all fetched
+    QCOMPARE(current, moved);
+    QVERIFY(!ancestors.isEmpty());
+    QVERIFY(ancestors.size() <= 4);
+    for (const QGeoTileSpec &ancestor : qAsConst(ancestors)) {
+        QVERIFY(ancestor.zoom() >= 0 && ancestor.zoom() < 4);
+        const int shift = 4 - ancestor.zoom();
+        bool covers = false;
+        for (const QGeoTileSpec &tile : qAsConst(moved))
+            covers |= (tile.x() >> shift) == ancestor.x() && (tile.y() >> shift) == ancestor.y();
+        QVERIFY(covers);
+    }
+
+    m_map->setProgressiveLoading(false);
+    m_map->setViewportSize(QSize(256, 256));
+    m_map->setPrefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers);
+}
+
+void tst_QGeoTiledMap::overlayMapTypes()
+{
+    m_map->setPrefetchStyle(QGeoTiledMap::NoPrefetching);
+    QVERIFY(m_map->capabilities() & QGeoMap::SupportsOverlayMapTypes);
+    const QList<QGeoMapType> types = m_map->m_engine->supportedMapTypes();
+    const QGeoMapType street = types.at(0);
+    const QGeoMapType satellite = types.at(1);
+    const QGeoMapType cycle = types.at(2);
+
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4.0);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setCameraData(camera);
+    waitForFetch(4);
+    const QSet<QGeoTileSpec> visible = m_tilesCounter->m_tiles;
+    QCOMPARE(visible.size(), 4);
+
+    // The tiles of the overlays are fetched at the positions of the visible
+    // ones, the active map type is not drawn over itself
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setOverlayMapTypes(QList<QGeoMapType>() << satellite << street << cycle);
+    QCOMPARE(m_map->overlayMapTypes().size(), 3);
+    waitForFetch(3 * 4);
+    QCOMPARE(m_tilesCounter->m_tiles.size(), 3 * 4);
+    for (const QGeoTileSpec &tile : visible) {
+        QGeoTileSpec overlay = tile;
+        for (int mapId : { street.mapId(), satellite.mapId(), cycle.mapId() }) {
+            overlay.setMapId(mapId);
+            QVERIFY(m_tilesCounter->m_tiles.contains(overlay));
+        }
+    }
+
+    // An overlay made active is drawn once
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setActiveMapType(satellite);
+    waitForFetch(3 * 4);
+    QCOMPARE(m_tilesCounter->m_tiles.size(), 3 * 4);
+    QSet<int> mapIds;
+    for (const QGeoTileSpec &tile : qAsConst(m_tilesCounter->m_tiles))
+        mapIds.insert(tile.mapId());
+    QCOMPARE(mapIds, QSet<int>({ street.mapId(), satellite.mapId(), cycle.mapId() }));
+
+    // Without overlays, only the active map type is fetched
+    m_map->setActiveMapType(street);
+    m_map->setOverlayMapTypes(QList<QGeoMapType>());
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    camera.setZoomLevel(3.0);
+    m_map->setCameraData(camera);
+    waitForFetch(4);
+    QTest::qWait(100);
+    QCOMPARE(m_tilesCounter->m_tiles.size(), 4);
+    for (const QGeoTileSpec &tile : qAsConst(m_tilesCounter->m_tiles))
+        QCOMPARE(tile.mapId(), street.mapId());
+
+    m_map->setPrefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers);
+}
+
+void tst_QGeoTiledMap::downloadTiles()
+{
+    QGeoTiledMappingManagerEngine *engine = m_map->m_engine;
+    const QGeoRectangle world(QGeoCoordinate(80.0, -180.0), QGeoCoordinate(-80.0, 180.0));
+
+    QScopedPointer<QGeoTileDownloadJob> job(engine->createTileDownloadJob(world, 0, 1));
+    QCOMPARE(job->totalTiles(), qint64(1 + 4));
+    QCOMPARE(job->state(), QGeoTileDownloadJob::Idle);
+    QSignalSpy finished(job.data(), &QGeoTileDownloadJob::finished);
+    job->setMaximumConcurrentRequests(2);
+    job->start();
+    QTRY_COMPARE(finished.count(), 1);
+    QCOMPARE(job->state(), QGeoTileDownloadJob::Finished);
+    QCOMPARE(job->processedTiles(), qint64(5));
+    QCOMPARE(job->fetchedTiles() + job->skippedTiles(), qint64(5));
+    QCOMPARE(job->failedTiles(), qint64(0));
+
+    // running the job again resumes it, everything is in the cache now
+    QScopedPointer<QGeoTileDownloadJob> again(engine->createTileDownloadJob(world, 0, 1));
+    again->start();
+    QCOMPARE(again->state(), QGeoTileDownloadJob::Finished);
+    QCOMPARE(again->skippedTiles(), qint64(5));
+    QCOMPARE(again->fetchedTiles(), qint64(0));
+
+    // zoom levels are bounded by the camera capabilities of the map type
+    QScopedPointer<QGeoTileDownloadJob> bounded(engine->createTileDownloadJob(world, -3, 42));
+    QCOMPARE(bounded->mapId(), 1);
+    QCOMPARE(bounded->minimumZoomLevel(), 0);
+    QCOMPARE(bounded->maximumZoomLevel(), 20);
+
+    QScopedPointer<QGeoTileDownloadJob> canceled(engine->createTileDownloadJob(world, 7, 8));
+    canceled->start();
+    canceled->cancel();
+    QCOMPARE(canceled->state(), QGeoTileDownloadJob::Canceled);
+}
+
+void tst_QGeoTiledMap::tilesForShape()
+{
+    // a circle around a corner shared by four tiles
+    const QGeoCircle corner(QGeoCoordinate(0.0, 0.0), 1000.0);
+    QCOMPARE(QGeoTileDownloadJob::tilesForShape(corner, 10, 1, QStringLiteral("test")).size(), 4);
+
+    // a circle smaller than a tile
+    const QGeoCircle small(QGeoCoordinate(0.1, 0.1), 100.0);
+    const QVector<QGeoTileSpec> tiles = QGeoTileDownloadJob::tilesForShape(small, 10, 1, QStringLiteral("test"));
+    QCOMPARE(tiles.size(), 1);
+    QCOMPARE(tiles.first().zoom(), 10);
+    QCOMPARE(tiles.first().x(), 512);
+    QCOMPARE(tiles.first().y(), 511);
+
+    // a rectangle crossing the dateline
+    const QGeoRectangle dateline(QGeoCoordinate(10.0, 170.0), QGeoCoordinate(-10.0, -170.0));
+    QCOMPARE(QGeoTileDownloadJob::tilesForShape(dateline, 2, 1, QStringLiteral("test")).size(), 2 * 2);
+}
+
+void tst_QGeoTiledMap::memoryPressure()
+{
+    QAbstractGeoTileCache *cache = m_map->m_engine->tileCache();
+    const int maxTextureUsage = cache->maxTextureUsage();
+    const int maxMemoryUsage = cache->maxMemoryUsage();
+    QVERIFY(maxTextureUsage > cache->minTextureUsage());
+
+    // the texture cache goes down to what the maps need first
+    cache->setMemoryPressure(QAbstractGeoTileCache::ModerateMemoryPressure);
+    QCOMPARE(cache->maxTextureUsage(), cache->minTextureUsage());
+    QVERIFY(cache->textureUsage() <= cache->minTextureUsage());
+    QCOMPARE(cache->maxMemoryUsage(), maxMemoryUsage);
+
+    cache->setMemoryPressure(QAbstractGeoTileCache::CriticalMemoryPressure);
+    QCOMPARE(cache->memoryUsage(), 0);
+    QCOMPARE(cache->maxMemoryUsage(), maxMemoryUsage);
+
+    cache->setMemoryPressure(QAbstractGeoTileCache::NoMemoryPressure);
+    QCOMPARE(cache->maxTextureUsage(), maxTextureUsage);
+}
+
+void tst_QGeoTiledMap::sharedCache()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QScopedPointer<SharedTileCache> owner(new SharedTileCache(directory.path()));
+    owner->initialize();
+    SharedTileCache other(directory.path());
+    other.initialize();
+    QVERIFY(owner->isDiskCacheOwner());
+    QVERIFY(!other.isDiskCacheOwner());
+
+    // a tile stored by one process becomes available to the other
+    const QGeoTileSpec spec(QStringLiteral("test"), 1, 3, 2, 1);
+    other.insert(spec, QByteArray("NoRetry"), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    QTRY_VERIFY(owner->contains(spec, QAbstractGeoTileCache::DiskCache));
+
+    // the remaining process takes over once the owner is gone
+    owner.reset();
+    QTRY_VERIFY(other.isDiskCacheOwner());
+    QVERIFY(other.contains(spec, QAbstractGeoTileCache::DiskCache));
+}
+
+// Each map keeps a share of the texture cache for the tiles it shows, sized by its viewport
+void tst_QGeoTiledMap::textureUsageSizing()
+{
+    QAbstractGeoTileCache *cache = m_map->m_engine->tileCache();
+    QGeoCameraData camera;
+    camera.setZoomLevel(4);
+    camera.setCenter(QGeoCoordinate(10, 10));
+    m_map->setCameraData(camera);
+    m_map->setViewportSize(QSize(256, 256));
+    const int base = cache->minTextureUsage();
+    QVERIFY(base > 0);
+    const qint64 tileCost = cache->costStrategyTexture() == QAbstractGeoTileCache::ByteSize ? 256 * 256 * 4 : 1;
+
+    // a screen of tiles with one more on each side, three times for the prefetched tiles
+    m_map->setViewportSize(QSize(512, 512));
+    QCOMPARE(qint64(cache->minTextureUsage()) - base, (4 * 4 - 3 * 3) * 3 * tileCost);
+    m_map->setViewportSize(QSize(256, 256));
+    QCOMPARE(cache->minTextureUsage(), base);
+
+    // given back by the maps that go
+    {
+        QScopedPointer<QGeoMap> other(m_map->m_engine->createMap());
+        other->setCameraData(camera);
+        other->setViewportSize(QSize(300, 200));
+        QCOMPARE(qint64(cache->minTextureUsage()) - base, (4 * 3) * 3 * tileCost);
+    }
+    QCOMPARE(cache->minTextureUsage(), base);
+
+    if (tileCost == 1)
+        return; // the shares of huge maps would only overflow in bytes
+
+    // huge maps stay within the range of the costs, and keep their shares
+    {
+        QGeoCameraData closer = camera;
+        closer.setZoomLevel(6); // no wrapping around at that size
+        QVector<QSharedPointer<QGeoMap> > huge;
+        for (int i = 0; i < 3; ++i) {
+            huge.append(QSharedPointer<QGeoMap>(m_map->m_engine->createMap()));
+            huge.last()->setCameraData(closer);
+            huge.last()->setViewportSize(QSize(10000, 10000));
+        }
+        QCOMPARE(cache->minTextureUsage(), std::numeric_limits<int>::max());
+        QVERIFY(cache->maxTextureUsage() > 0);
+        huge.last()->setViewportSize(QSize(256, 256));
+        huge.removeFirst();
+        huge.removeFirst();
+        QCOMPARE(qint64(cache->minTextureUsage()) - base, 3 * 3 * 3 * tileCost);
+    }
+    QCOMPARE(cache->minTextureUsage(), base);
+}
+
+// An engine of its own whose fetcher leaves the replies to finishReplies()
+QGeoServiceProvider *tst_QGeoTiledMap::createManualProvider()
+{
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    parameters["maxZoomLevel"] = 8;
+    parameters["manualReplies"] = true;
+    QGeoServiceProvider *provider = new QGeoServiceProvider("qmlgeo.test.plugin", parameters);
+    provider->setAllowExperimental(true);
+    return provider;
+}
+
+// Without a viewport size, the map requests no tiles
+QGeoTiledMapTest *tst_QGeoTiledMap::createMap(QGeoServiceProvider *provider, const QSize &viewportSize)
+{
+    QGeoTiledMapTest *map = static_cast<QGeoTiledMapTest *>(provider->mappingManager()->createMap(this));
+    map->setPrefetchStyle(QGeoTiledMap::NoPrefetching);
+    map->setActiveMapType(map->m_engine->supportedMapTypes().first());
+    map->clearData();
+    if (viewportSize.isValid())
+        map->setViewportSize(viewportSize);
+    return map;
+}
+
+// Finishes the replies in flight, and those requested next, until no more come
+void tst_QGeoTiledMap::finishReplies(QGeoTileFetcherTest *fetcher)
+{
+    while (QTest::qWaitFor([fetcher]() { return !fetcher->pendingTiles().isEmpty(); }, 200)) {
+        const QList<QGeoTileSpec> pending = fetcher->pendingTiles();
+        for (const QGeoTileSpec &spec : pending)
+            fetcher->finishReply(spec);
+    }
+}
+
+// Queued tiles are requested by priority, and the ones cancelled are not
+void tst_QGeoTiledMap::fetchOrder()
+{
+    QScopedPointer<QGeoServiceProvider> provider(createManualProvider());
+    QScopedPointer<QGeoTiledMapTest> map(createMap(provider.data(), QSize()));
+    QGeoTileFetcherTest *fetcher = static_cast<QGeoTileFetcherTest *>(map->m_engine->tileFetcher());
+    fetcher->setMaximumConcurrentRequests(1);
+
+    // the lowest priority first, tiles without one last
+    const QGeoTileSpec a = tile(1, 1), b = tile(2, 1), c = tile(3, 1), d = tile(4, 1);
+    QHash<QGeoTileSpec, double> priorities;
+    priorities.insert(a, 3.0);
+    priorities.insert(b, 1.0);
+    priorities.insert(c, 2.0);
+    fetcher->updateTileRequests(QSet<QGeoTileSpec>() << a << b << c << d, QSet<QGeoTileSpec>(), priorities);
+    QTRY_COMPARE(fetcher->pendingTiles(), QList<QGeoTileSpec>() << b);
+
+    // a queued tile moves up when given a lower priority
+    priorities.clear();
+    priorities.insert(d, 0.5);
+    fetcher->updateTileRequests(QSet<QGeoTileSpec>(), QSet<QGeoTileSpec>(), priorities);
+    QVERIFY(fetcher->finishReply(b));
+    QTRY_COMPARE(fetcher->pendingTiles(), QList<QGeoTileSpec>() << d);
+
+    // a queued tile that is cancelled is not requested
+    fetcher->updateTileRequests(QSet<QGeoTileSpec>(), QSet<QGeoTileSpec>() << c);
+    QVERIFY(fetcher->finishReply(d));
+    QTRY_COMPARE(fetcher->pendingTiles(), QList<QGeoTileSpec>() << a);
+
+    // and one in flight is aborted, without being reported
+    QSignalSpy finished(fetcher, &QGeoTileFetcher::tileFinished);
+    fetcher->updateTileRequests(QSet<QGeoTileSpec>(), QSet<QGeoTileSpec>() << a);
+    QCOMPARE(fetcher->abortedTiles(), QList<QGeoTileSpec>() << a);
+    QVERIFY(fetcher->pendingTiles().isEmpty());
+    QTest::qWait(50);
+    QCOMPARE(finished.count(), 0);
+    QCOMPARE(fetcher->requestedTiles(), QList<QGeoTileSpec>() << b << d << a);
+
+    // the tiles of a map come in view first, closest to the center of the view first
+    fetcher->clearRequestedTiles();
+    map->setPrefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers);
+    map->setViewportSize(QSize(512, 512));
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.51, 0.52)));
+    camera.setZoomLevel(4.0);
+    map->setCameraData(camera);
+    map->prefetchData();
+    finishReplies(fetcher);
+
+    const QList<QGeoTileSpec> requested = fetcher->requestedTiles();
+    QVERIFY(requested.size() > 9);
+    QCOMPARE(requested.first(), tile(8, 8));
+    // the visible tiles have the lowest priority class, so they all come before the prefetched ones
+    int visibleCount = 0;
+    while (visibleCount < requested.size() && map->tilePriority(requested.at(visibleCount)) < 16777216.0)
+        ++visibleCount;
+    QVERIFY(visibleCount > 0);
+    QVERIFY(visibleCount < requested.size());
+    for (int i = 1; i < requested.size(); ++i)
+        QVERIFY(map->tilePriority(requested.at(i - 1)) <= map->tilePriority(requested.at(i)));
+}
+
+// No more requests than the window allows are in flight at a time
+void tst_QGeoTiledMap::requestWindow()
+{
+    QScopedPointer<QGeoServiceProvider> provider(createManualProvider());
+    QScopedPointer<QGeoTiledMapTest> map(createMap(provider.data(), QSize()));
+    QGeoTileFetcherTest *fetcher = static_cast<QGeoTileFetcherTest *>(map->m_engine->tileFetcher());
+    QCOMPARE(fetcher->maximumConcurrentRequests(), 6);
+
+    QSet<QGeoTileSpec> tiles;
+    for (int i = 0; i < 10; ++i)
+        tiles.insert(tile(i, 2));
+    fetcher->setMaximumConcurrentRequests(3);
+    fetcher->updateTileRequests(tiles, QSet<QGeoTileSpec>());
+    QTRY_COMPARE(fetcher->pendingTiles().size(), 3);
+    QTest::qWait(50);
+    QCOMPARE(fetcher->pendingTiles().size(), 3);
+
+    // a reply that finishes frees its slot
+    QVERIFY(fetcher->finishReply(fetcher->pendingTiles().first()));
+    QTRY_COMPARE(fetcher->requestedTiles().size(), 4);
+    QCOMPARE(fetcher->pendingTiles().size(), 3);
+
+    // a wider window is filled with the next finished reply
+    fetcher->setMaximumConcurrentRequests(5);
+    QVERIFY(fetcher->finishReply(fetcher->pendingTiles().first()));
+    QTRY_COMPARE(fetcher->pendingTiles().size(), 5);
+    QCOMPARE(fetcher->requestedTiles().size(), 7);
+
+    fetcher->setMaximumConcurrentRequests(0);
+    QCOMPARE(fetcher->maximumConcurrentRequests(), 1);
+
+    finishReplies(fetcher);
+    QCOMPARE(fetcher->requestedTiles().size(), 10);
+    QCOMPARE(QSet<QGeoTileSpec>(fetcher->requestedTiles().cbegin(), fetcher->requestedTiles().cend()), tiles);
+}
+
+// A tile is requested once for all the maps of an engine, and only while a map wants it
+void tst_QGeoTiledMap::sharedRequests()
+{
+    QScopedPointer<QGeoServiceProvider> provider(createManualProvider());
+    QScopedPointer<QGeoTiledMapTest> map1(createMap(provider.data(), QSize()));
+    QScopedPointer<QGeoTiledMapTest> map2(createMap(provider.data(), QSize()));
+    QGeoTileFetcherTest *fetcher = static_cast<QGeoTileFetcherTest *>(map1->m_engine->tileFetcher());
+    fetcher->setMaximumConcurrentRequests(16);
+
+    // a tile in flight is not requested again
+    const QGeoTileSpec inFlight = tile(0, 0, 6);
+    fetcher->updateTileRequests(QSet<QGeoTileSpec>() << inFlight, QSet<QGeoTileSpec>());
+    QTRY_COMPARE(fetcher->pendingTiles(), QList<QGeoTileSpec>() << inFlight);
+    fetcher->updateTileRequests(QSet<QGeoTileSpec>() << inFlight, QSet<QGeoTileSpec>());
+    QTest::qWait(50);
+    QCOMPARE(fetcher->requestedTiles(), QList<QGeoTileSpec>() << inFlight);
+    finishReplies(fetcher);
+
+    // nor by a second map showing the same tiles
+    fetcher->clearRequestedTiles();
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4.0);
+    map1->setCameraData(camera);
+    map2->setCameraData(camera);
+    map1->setViewportSize(QSize(256, 256));
+    map2->setViewportSize(QSize(256, 256));
+    finishReplies(fetcher);
+    QList<QGeoTileSpec> requested = fetcher->requestedTiles();
+    QVERIFY(!requested.isEmpty());
+    QCOMPARE(QSet<QGeoTileSpec>(requested.cbegin(), requested.cend()).size(), requested.size());
+
+    // the tiles in flight for a destroyed map alone are aborted
+    fetcher->clearRequestedTiles();
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.25, 0.5)));
+    map1->setCameraData(camera);
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.75, 0.5)));
+    map2->setCameraData(camera);
+    QTRY_COMPARE(fetcher->pendingTiles().size(), fetcher->requestedTiles().size());
+    QTest::qWait(50);
+    QSet<QGeoTileSpec> map2Tiles;
+    for (const QGeoTileSpec &spec : fetcher->pendingTiles()) {
+        if (spec.x() >= 8)
+            map2Tiles.insert(spec);
+    }
+    QVERIFY(!map2Tiles.isEmpty());
+    QVERIFY(map2Tiles.size() < fetcher->pendingTiles().size());
+
+    map2.reset();
+    QTRY_COMPARE(fetcher->abortedTiles().size(), map2Tiles.size());
+    QCOMPARE(QSet<QGeoTileSpec>(fetcher->abortedTiles().cbegin(), fetcher->abortedTiles().cend()), map2Tiles);
+    for (const QGeoTileSpec &spec : fetcher->pendingTiles())
+        QVERIFY(spec.x() < 8);
+    finishReplies(fetcher);
+}
+
+// The tiles on the way to a camera target are fetched, and dropped when the camera comes to rest
+void tst_QGeoTiledMap::predictivePrefetch()
+{
+    QScopedPointer<QGeoServiceProvider> provider(createManualProvider());
+    QScopedPointer<QGeoTiledMapTest> map(createMap(provider.data(), QSize()));
+    QGeoTileFetcherTest *fetcher = static_cast<QGeoTileFetcherTest *>(map->m_engine->tileFetcher());
+    fetcher->setMaximumConcurrentRequests(16);
+    map->setPrefetchStyle(QGeoTiledMap::PrefetchPredictive);
+
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4.0);
+    map->setCameraData(camera);
+    map->setViewportSize(QSize(256, 256));
+    finishReplies(fetcher);
+    const QList<QGeoTileSpec> visibleList = fetcher->requestedTiles();
+    const QSet<QGeoTileSpec> visible(visibleList.cbegin(), visibleList.cend());
+    QVERIFY(!visible.isEmpty());
+
+    // at most as many tiles as are visible, none of them, on the way to the target
+    fetcher->clearRequestedTiles();
+    QGeoCameraData target = camera;
+    target.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.75, 0.5)));
+    map->prefetchTrajectory(target);
+    finishReplies(fetcher);
+    QList<QGeoTileSpec> requested = fetcher->requestedTiles();
+    QVERIFY(!requested.isEmpty());
+    QVERIFY(requested.size() <= visible.size());
+    for (const QGeoTileSpec &spec : qAsConst(requested)) {
+        QVERIFY(!visible.contains(spec));
+        QCOMPARE(spec.zoom(), 4);
+        QVERIFY(spec.x() > 8);
+    }
+
+    // the camera coming to rest cancels those still in flight
+    fetcher->clearRequestedTiles();
+    target.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.25, 0.5)));
+    map->prefetchTrajectory(target);
+    QTRY_VERIFY(!fetcher->pendingTiles().isEmpty());
+    QTest::qWait(50);
+    const QList<QGeoTileSpec> trajectoryList = fetcher->pendingTiles();
+    const QSet<QGeoTileSpec> trajectory(trajectoryList.cbegin(), trajectoryList.cend());
+    for (const QGeoTileSpec &spec : trajectory)
+        QVERIFY(spec.x() < 7);
+    map->prefetchData();
+    QTRY_COMPARE(fetcher->abortedTiles().size(), trajectory.size());
+    QCOMPARE(QSet<QGeoTileSpec>(fetcher->abortedTiles().cbegin(), fetcher->abortedTiles().cend()), trajectory);
+    finishReplies(fetcher);
+
+    // only the predictive style follows the trajectory
+    map->setPrefetchStyle(QGeoTiledMap::NoPrefetching);
+    finishReplies(fetcher);
+    fetcher->clearRequestedTiles();
+    target.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.75, 0.25)));
+    map->prefetchTrajectory(target);
+    QTest::qWait(50);
+    QVERIFY(fetcher->requestedTiles().isEmpty());
+}
+
 void tst_QGeoTiledMap::waitForFetch(int count)
 {
     int timeout = 0;
@@ -30,6 +30,7 @@
 
 #include "qgeotilespec_p.h"
 #include "qgeotiledmapscene_p.h"
+#include "qgeotiledmapscene_p_p.h"
 #include "qgeocameratiles_p.h"
 #include "qgeocameradata_p.h"
 #include "qabstractgeotilecache_p.h"
@@ -38,6 +39,7 @@
 #include <QtPositioning/private/qdoublevector2d_p.h>
 
 #include <qtest.h>
+#include <QSignalSpy>
 
 #include <QList>
 #include <QPair>
@@ -52,6 +54,14 @@ class tst_QGeoTiledMapScene : public QObject
     Q_OBJECT
 
     private:
+    static QSharedPointer<QGeoTileTexture> texture(const QGeoTileSpec &spec)
+    {
+        QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+        tt->spec = spec;
+        tt->image = QImage(256, 256, QImage::Format_RGB32);
+        return tt;
+    }
+
     void row(QString name, double screenX, double screenX2, double screenY, double cameraCenterX, double cameraCenterY,
              double zoom, int tileSize, int screenWidth, int screenHeight, double mercatorX, double mercatorY){
 
@@ -394,7 +404,348 @@ class tst_QGeoTiledMapScene : public QObject
             populateScreenMercatorData();
         }
 
+        void fallbackTiles()
+        {
+            QGeoCameraData camera;
+            camera.setZoomLevel(2);
+            camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+
+            QGeoTiledMapScene scene;
+            scene.setTileSize(256);
+            scene.setScreenSize(QSize(256, 256));
+            scene.setCameraData(camera);
+            const QGeoTileSpec parent(QStringLiteral("test"), 1, 2, 1, 1);
+            const QGeoTileSpec sibling(QStringLiteral("test"), 1, 2, 2, 1);
+            scene.setVisibleTiles(QSet<QGeoTileSpec>() << parent << sibling);
+
+            // the children of the loading tiles stand in for them
+            const QGeoTileSpec child(QStringLiteral("test"), 1, 3, 3, 2);
+            QVERIFY(scene.addFallbackTile(child, texture(child)));
+            QVERIFY(!scene.addFallbackTile(child, texture(child)));
+            QVERIFY(scene.texturedTiles().contains(child));
+
+            // but not of the tiles out of view
+            const QGeoTileSpec hidden(QStringLiteral("test"), 1, 3, 0, 0);
+            QVERIFY(!scene.addFallbackTile(hidden, texture(hidden)));
+            QVERIFY(!scene.texturedTiles().contains(hidden));
+
+            // until the tile itself arrives
+            scene.addTile(parent, texture(parent));
+            QCOMPARE(scene.texturedTiles(), QSet<QGeoTileSpec>() << parent);
+            const QGeoTileSpec otherChild(QStringLiteral("test"), 1, 3, 2, 3);
+            QVERIFY(!scene.addFallbackTile(otherChild, texture(otherChild)));
+
+            // and they go with the tiles they stand in for
+            const QGeoTileSpec siblingChild(QStringLiteral("test"), 1, 3, 4, 2);
+            QVERIFY(scene.addFallbackTile(siblingChild, texture(siblingChild)));
+            scene.setVisibleTiles(QSet<QGeoTileSpec>() << parent);
+            QCOMPARE(scene.texturedTiles(), QSet<QGeoTileSpec>() << parent);
+        }
+
+        // Progressive loading draws a tile of a lower zoom level in place of the
+        // visible tiles it covers
+        void ancestorTiles()
+        {
+            QGeoCameraData camera;
+            camera.setZoomLevel(3);
+            camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+
+            QGeoTiledMapScene scene;
+            scene.setTileSize(256);
+            scene.setScreenSize(QSize(512, 512));
+            scene.setCameraData(camera);
+            QSet<QGeoTileSpec> visible;
+            for (int x = 3; x <= 4; ++x) {
+                for (int y = 3; y <= 4; ++y)
+                    visible.insert(QGeoTileSpec(QStringLiteral("test"), 1, 3, x, y));
+            }
+            scene.setVisibleTiles(visible);
+            const QGeoTiledMapScenePrivate *d
+                    = static_cast<const QGeoTiledMapScenePrivate *>(QObjectPrivate::get(&scene));
+
+            // the tile covering the north west of the view stands in for the one tile there
+            const QGeoTileSpec northWest(QStringLiteral("test"), 1, 2, 1, 1);
+            const QSharedPointer<QGeoTileTexture> northWestTexture = texture(northWest);
+            QVERIFY(scene.addAncestorTile(northWest, northWestTexture));
+            const QGeoTileSpec covered(QStringLiteral("test"), 1, 3, 3, 3);
+            QCOMPARE(d->m_textures.value(covered), northWestTexture);
+            QCOMPARE(scene.texturedTiles(), QSet<QGeoTileSpec>() << northWest);
+            QVERIFY(!scene.addAncestorTile(northWest, northWestTexture));
+
+            // the whole world, for the tiles that have no texture yet
+            const QGeoTileSpec top(QStringLiteral("test"), 1, 0, 0, 0);
+            const QSharedPointer<QGeoTileTexture> topTexture = texture(top);
+            QVERIFY(scene.addAncestorTile(top, topTexture));
+            QCOMPARE(d->m_textures.value(covered), northWestTexture);
+            for (const QGeoTileSpec &tile : qAsConst(visible)) {
+                if (tile != covered)
+                    QCOMPARE(d->m_textures.value(tile), topTexture);
+            }
+
+            // but not for the tiles out of view, of the same zoom level or of another map
+            QVERIFY(!scene.addAncestorTile(QGeoTileSpec(QStringLiteral("test"), 1, 2, 3, 3), texture(top)));
+            QVERIFY(!scene.addAncestorTile(covered, texture(covered)));
+            QVERIFY(!scene.addAncestorTile(QGeoTileSpec(QStringLiteral("test"), 2, 0, 0, 0), texture(top)));
+
+            // the tiles themselves replace their stand-ins, which are still
+            // reported as missing so that they are requested
+            for (const QGeoTileSpec &tile : qAsConst(visible))
+                QVERIFY(!scene.texturedTiles().contains(tile));
+            const QSharedPointer<QGeoTileTexture> coveredTexture = texture(covered);
+            scene.addTile(covered, coveredTexture);
+            QCOMPARE(d->m_textures.value(covered), coveredTexture);
+            QCOMPARE(scene.texturedTiles(), QSet<QGeoTileSpec>() << covered << top);
+        }
+
+        // The tile rects stay the same while the camera moves around the origin they are relative to
+        void stableTileRects()
+        {
+            QQuickWindow window;
+            window.resize(64, 64);
+            window.show();
+            if (!QTest::qWaitFor([&window]() { return window.isSceneGraphInitialized(); }))
+                QSKIP("No scene graph in this environment");
+
+            QGeoCameraData camera;
+            camera.setZoomLevel(8);
+            camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+            QGeoCameraTiles ct;
+            ct.setTileSize(256);
+            ct.setScreenSize(QSize(512, 512));
+
+            QGeoTiledMapScene scene;
+            scene.setTileSize(256);
+            scene.setScreenSize(QSize(512, 512));
+            QGeoTiledMapScenePrivate *d = static_cast<QGeoTiledMapScenePrivate *>(QObjectPrivate::get(&scene));
+            auto moveCamera = [&](const QGeoCameraData &cameraData) {
+                ct.setCameraData(cameraData);
+                scene.setCameraData(cameraData);
+                scene.setVisibleTiles(ct.createTiles());
+            };
+            moveCamera(camera);
+            const int generation = d->m_geometryGeneration;
+            const int originX = d->m_originTileX;
+            const int originY = d->m_originTileY;
+            QCOMPARE(originX, d->m_minTileX);
+            QCOMPARE(originY, d->m_minTileY);
+
+            const QGeoTileSpec spec(QStringLiteral("test"), 1, 8, 128, 128);
+            QScopedPointer<QSGImageNode> node(window.createImageNode());
+            bool overzooming;
+            QVERIFY(d->buildGeometry(spec, node.data(), overzooming));
+            const QRectF rect = node->rect();
+
+            // panning by a tile and rotating keep the origin, and the rect of a tile still in view
+            camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + 1.0 / 256, 0.5)));
+            camera.setBearing(30.0);
+            moveCamera(camera);
+            QCOMPARE(d->m_geometryGeneration, generation);
+            QCOMPARE(d->m_originTileX, originX);
+            QCOMPARE(d->m_originTileY, originY);
+            QVERIFY(d->buildGeometry(spec, node.data(), overzooming));
+            QCOMPARE(node->rect(), rect);
+
+            // up to 64 tiles away
+            camera.setBearing(0.0);
+            camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + 58.0 / 256, 0.5 - 58.0 / 256)));
+            moveCamera(camera);
+            QCOMPARE(d->m_geometryGeneration, generation);
+            QCOMPARE(d->m_originTileX, originX);
+            QCOMPARE(d->m_originTileY, originY);
+
+            // beyond, the origin moves to the visible tiles and all the rects are rebuilt
+            camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + 70.0 / 256, 0.5)));
+            moveCamera(camera);
+            QCOMPARE(d->m_geometryGeneration, generation + 1);
+            QCOMPARE(d->m_originTileX, d->m_minTileX);
+            QCOMPARE(d->m_originTileY, d->m_minTileY);
+            const QGeoTileSpec farSpec(QStringLiteral("test"), 1, 8, 198, 128);
+            QVERIFY(d->buildGeometry(farSpec, node.data(), overzooming));
+            QVERIFY(qAbs(node->rect().x()) < 4 * 256);
+
+            // as they are when the zoom level changes
+            camera.setZoomLevel(9);
+            moveCamera(camera);
+            QCOMPARE(d->m_geometryGeneration, generation + 2);
+            QCOMPARE(d->m_originZoomLevel, 9);
+        }
+
+        // New tiles beyond the per frame upload budget wait for the next frames, the central ones first
+        void uploadBudget()
+        {
+            QQuickWindow window;
+            window.resize(64, 64);
+            window.show();
+            if (!QTest::qWaitFor([&window]() { return window.isSceneGraphInitialized(); }))
+                QSKIP("No scene graph in this environment");
+
+            const QDoubleVector2D center(8.5 / 16, 8.5 / 16); // 5 x 5 tiles in view
+            QGeoCameraData camera;
+            camera.setZoomLevel(4);
+            camera.setCenter(QWebMercator::mercatorToCoord(center));
+            QGeoCameraTiles ct;
+            ct.setTileSize(256);
+            ct.setScreenSize(QSize(1024, 1024));
+            ct.setCameraData(camera);
+            const QSet<QGeoTileSpec> tiles = ct.createTiles();
+            QVERIFY(tiles.size() > 16);
+            QVERIFY(tiles.size() <= 32);
+
+            QGeoTiledMapScene scene;
+            scene.setTileSize(256);
+            scene.setScreenSize(QSize(1024, 1024));
+            scene.setCameraData(camera);
+            scene.setVisibleTiles(tiles);
+            for (const QGeoTileSpec &spec : tiles)
+                scene.addTile(spec, texture(spec)); // 256 KB each
+            QSignalSpy pending(&scene, &QGeoTiledMapScene::tileUploadsPending);
+
+            // 4 MB in the first frame
+            QGeoTiledMapRootNode *root = static_cast<QGeoTiledMapRootNode *>(scene.updateSceneGraph(nullptr, &window));
+            QVERIFY(root);
+            QCOMPARE(root->textures.size(), 16);
+            QCOMPARE(pending.count(), 1);
+
+            const auto distance = [&center](const QGeoTileSpec &spec) {
+                const double side = 1 << spec.zoom();
+                const double dx = (spec.x() + 0.5) / side - center.x();
+                const double dy = (spec.y() + 0.5) / side - center.y();
+                return dx * dx + dy * dy;
+            };
+            double farthestUploaded = 0.0;
+            double closestLeft = 1.0;
+            for (const QGeoTileSpec &spec : tiles) {
+                if (root->textures.contains(spec))
+                    farthestUploaded = qMax(farthestUploaded, distance(spec));
+                else
+                    closestLeft = qMin(closestLeft, distance(spec));
+            }
+            QVERIFY(farthestUploaded <= closestLeft);
+
+            // the rest in the next one
+            QCOMPARE(scene.updateSceneGraph(root, &window), root);
+            QCOMPARE(root->textures.size(), tiles.size());
+            QCOMPARE(pending.count(), 1);
+            delete root;
+        }
+
+        // Two maps of a window showing the same tiles share their textures, until one goes away
+        void sharedTextures()
+        {
+            QQuickWindow window;
+            window.resize(64, 64);
+            window.show();
+            if (!QTest::qWaitFor([&window]() { return window.isSceneGraphInitialized(); }))
+                QSKIP("No scene graph in this environment");
+
+            QGeoCameraData camera;
+            camera.setZoomLevel(2);
+            camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+            QGeoCameraTiles ct;
+            ct.setTileSize(256);
+            ct.setScreenSize(QSize(512, 512));
+            ct.setCameraData(camera);
+            const QSet<QGeoTileSpec> tiles = ct.createTiles();
+
+            // the tiles come from the one cache of the engine
+            QHash<QGeoTileSpec, QSharedPointer<QGeoTileTexture>> cached;
+            for (const QGeoTileSpec &spec : tiles)
+                cached.insert(spec, texture(spec));
+            QGeoTiledMapScene scene1;
+            QGeoTiledMapScene scene2;
+            for (QGeoTiledMapScene *scene : { &scene1, &scene2 }) {
+                scene->setTileSize(256);
+                scene->setScreenSize(QSize(512, 512));
+                scene->setCameraData(camera);
+                scene->setVisibleTiles(tiles);
+                for (auto it = cached.cbegin(); it != cached.cend(); ++it)
+                    scene->addTile(it.key(), it.value());
+            }
+
+            QGeoTiledMapRootNode *root1 = static_cast<QGeoTiledMapRootNode *>(scene1.updateSceneGraph(nullptr, &window));
+            QGeoTiledMapRootNode *root2 = static_cast<QGeoTiledMapRootNode *>(scene2.updateSceneGraph(nullptr, &window));
+            QVERIFY(root1);
+            QVERIFY(root2);
+            const QSharedPointer<QGeoTiledMapTexturePool> pool = root1->texturePool;
+            QCOMPARE(root2->texturePool, pool);
+            QCOMPARE(root1->textures.size(), tiles.size());
+            QCOMPARE(root2->textures.size(), tiles.size());
+            for (const QGeoTileSpec &spec : tiles)
+                QCOMPARE(root2->textures.value(spec), root1->textures.value(spec));
+
+            // the textures stay with the map left
+            delete root1;
+            for (const QGeoTileSpec &spec : tiles) {
+                QSGTexture *t = pool->acquire(cached.value(spec));
+                QCOMPARE(t, root2->textures.value(spec));
+                pool->release(t);
+                QCOMPARE(t->textureSize(), QSize(256, 256));
+            }
+            QCOMPARE(scene2.updateSceneGraph(root2, &window), root2);
+            QCOMPARE(root2->textures.size(), tiles.size());
+
+            // and are released with it
+            delete root2;
+            for (const QGeoTileSpec &spec : tiles)
+                QVERIFY(!pool->acquire(cached.value(spec)));
+        }
+
+        // A map coming into a window that showed maps before uploads into the textures left
+        void textureRecycling()
+        {
+            QQuickWindow window;
+            window.resize(64, 64);
+            window.show();
+            if (!QTest::qWaitFor([&window]() { return window.isSceneGraphInitialized(); }))
+                QSKIP("No scene graph in this environment");
+
+            QSharedPointer<QGeoTiledMapTexturePool> pool = QGeoTiledMapTexturePool::forWindow(&window);
+            QCOMPARE(QGeoTiledMapTexturePool::forWindow(&window).data(), pool.data());
+
+            // the same tile is uploaded once
+            const QSharedPointer<QGeoTileTexture> first = texture(QGeoTileSpec(QStringLiteral("test"), 1, 2, 0, 0));
+            QSGTexture *uploaded = pool->upload(first, &window);
+            QVERIFY(uploaded);
+            QCOMPARE(pool->acquire(first), uploaded);
+            pool->release(uploaded);
+            QCOMPARE(pool->acquire(first), uploaded);
+            pool->release(uploaded);
+            pool->release(uploaded);
+            QVERIFY(!pool->acquire(first));
+
+            // a tile of the same size takes the texture of the one released
+            QSharedPointer<QGeoTileTexture> next = texture(QGeoTileSpec(QStringLiteral("test"), 1, 2, 1, 0));
+            next->image.fill(Qt::red);
+            QSGTexture *recycled = pool->upload(next, &window);
+            QCOMPARE(recycled, uploaded);
+            QCOMPARE(static_cast<QSGPlainTexture *>(recycled)->image(), next->image);
+
+            // one of another size does not
+            QSharedPointer<QGeoTileTexture> large = texture(QGeoTileSpec(QStringLiteral("test"), 1, 2, 2, 0));
+            large->image = QImage(512, 512, QImage::Format_RGB32);
+            pool->release(recycled);
+            QSGTexture *other = pool->upload(large, &window);
+            QVERIFY(other != recycled);
+            QCOMPARE(other->textureSize(), QSize(512, 512));
+            pool->release(other, false);
+
+            // a second map of the window finds the textures the first one left
+            QVector<QSGTexture *> textures;
+            for (int x = 0; x < 40; ++x)
+                textures.append(pool->upload(texture(QGeoTileSpec(QStringLiteral("test"), 1, 6, x, 0)), &window));
+            const QSharedPointer<QGeoTiledMapTexturePool> second = QGeoTiledMapTexturePool::forWindow(&window);
+            for (QSGTexture *t : qAsConst(textures))
+                pool->release(t);
+            pool.reset();
+            int reused = 0;
+            for (int x = 0; x < 40; ++x) {
+                QSGTexture *t = second->upload(texture(QGeoTileSpec(QStringLiteral("test"), 1, 6, x, 1)), &window);
+                if (textures.contains(t))
+                    ++reused;
+            }
+            QCOMPARE(reused, 32); // kept up to that many
+        }
 };
 
-QTEST_GUILESS_MAIN(tst_QGeoTiledMapScene)
+QTEST_MAIN(tst_QGeoTiledMapScene)
 #include "tst_qgeotiledmapscene.moc"
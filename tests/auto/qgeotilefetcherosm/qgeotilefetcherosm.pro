@@ -0,0 +1,18 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilefetcherosm
+
+plugin.path = ../../../src/plugins/geoservices/osm/
+
+SOURCES += tst_qgeotilefetcherosm.cpp \
+           $$plugin.path/qgeotilefetcherosm.cpp \
+           $$plugin.path/qgeotileproviderosm.cpp \
+           $$plugin.path/qgeomapreplyosm.cpp \
+           $$plugin.path/qgeonetworkaccessmanagerosm.cpp
+HEADERS += $$plugin.path/qgeotilefetcherosm.h \
+           $$plugin.path/qgeotileproviderosm.h \
+           $$plugin.path/qgeomapreplyosm.h \
+           $$plugin.path/qgeonetworkaccessmanagerosm.h
+INCLUDEPATH += $$plugin.path
+
+QT += location location-private positioning-private network testlib
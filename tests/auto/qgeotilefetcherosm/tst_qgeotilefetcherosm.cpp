@@ -0,0 +1,228 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/geoservices/osm
+
+#include "qgeotilefetcherosm.h"
+#include "qgeonetworkaccessmanagerosm.h"
+
+#include <QtTest/QtTest>
+#include <QtGui/QImageReader>
+#include <QtNetwork/QNetworkReply>
+#include <QtLocation/private/qgeomappingmanagerengine_p.h>
+#include <QtLocation/private/qgeotiledmappingmanagerengine_p.h>
+#include <QtLocation/private/qgeocameracapabilities_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+class TestMappingEngine : public QGeoMappingManagerEngine
+{
+public:
+    TestMappingEngine()
+    {
+        QGeoCameraCapabilities capabilities;
+        capabilities.setMinimumZoomLevel(0);
+        capabilities.setMaximumZoomLevel(19);
+        setCameraCapabilities(capabilities);
+    }
+
+    QGeoMap *createMap() override { return nullptr; }
+};
+
+// Runs the fetcher in a thread of its own
+class ThreadedMappingEngine : public QGeoTiledMappingManagerEngine
+{
+public:
+    ThreadedMappingEngine()
+    {
+        setCameraCapabilities(capabilities(19));
+        setThreadedTileFetching(true);
+    }
+
+    static QGeoCameraCapabilities capabilities(int maximumZoomLevel)
+    {
+        QGeoCameraCapabilities capabilities;
+        capabilities.setMinimumZoomLevel(0);
+        capabilities.setMaximumZoomLevel(maximumZoomLevel);
+        return capabilities;
+    }
+
+    void setMaximumZoomLevel(int maximumZoomLevel)
+    {
+        setSupportedMapTypes(QList<QGeoMapType>()
+                             << QGeoMapType(QGeoMapType::StreetMap, QStringLiteral("street"), QString(),
+                                            false, false, 1, QByteArrayLiteral("osm"),
+                                            capabilities(maximumZoomLevel)));
+    }
+
+    using QGeoTiledMappingManagerEngine::setTileFetcher;
+
+    QGeoMap *createMap() override { return nullptr; }
+
+protected:
+    // no maps nor cache to give the tiles to
+    void engineTileFinished(const QGeoTileSpec &, const QByteArray &, const QString &) override {}
+    void engineTileError(const QGeoTileSpec &, const QString &) override {}
+};
+
+class tst_QGeoTileFetcherOsm : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void negotiatedFormat();
+    void threadedFetching();
+
+private:
+    // A provider answering with urlTemplate, a data URL holding the tile coordinates
+    static QGeoTileProviderOsm *provider(const QString &urlTemplate, const QString &format)
+    {
+        return new QGeoTileProviderOsm(nullptr, QGeoMapType(),
+                                       QVector<TileProvider *>()
+                                       << new TileProvider(urlTemplate, format, QString(), QString()),
+                                       QGeoCameraCapabilities());
+    }
+};
+
+void tst_QGeoTileFetcherOsm::initTestCase()
+{
+    qRegisterMetaType<QGeoTileSpec>();
+}
+
+// The formats smaller than PNG and JPEG are offered when they can be decoded, and what the
+// server sent is the format of the tile
+void tst_QGeoTileFetcherOsm::negotiatedFormat()
+{
+    const QList<QByteArray> types = QImageReader::supportedMimeTypes();
+    QByteArray accept;
+    if (types.contains("image/avif"))
+        accept += "image/avif,";
+    if (types.contains("image/webp"))
+        accept += "image/webp,";
+    if (!accept.isEmpty())
+        accept += "image/*;q=0.8";
+
+    QScopedPointer<QGeoTileProviderOsm> png(provider(QStringLiteral("data:image/png,%z-%x-%y"),
+                                                     QStringLiteral("png")));
+    QScopedPointer<QGeoTileProviderOsm> webp(provider(QStringLiteral("data:image/webp,%z-%x-%y"),
+                                                      QStringLiteral("png")));
+    QScopedPointer<QGeoTileProviderOsm> ktx(provider(QStringLiteral("data:application/octet-stream,%z-%x-%y"),
+                                                     QStringLiteral("ktx")));
+
+    TestMappingEngine engine;
+    const QSharedPointer<QGeoNetworkAccessManagerOsm> nm = QGeoNetworkAccessManagerOsm::instance(QVariantMap());
+    QHash<QUrl, QByteArray> accepted;
+    connect(nm.data(), &QNetworkAccessManager::finished, this, [&accepted](QNetworkReply *reply) {
+        accepted.insert(reply->request().url(), reply->request().rawHeader("Accept"));
+    });
+    QGeoTileFetcherOsm fetcher(QVector<QGeoTileProviderOsm *>() << png.data() << webp.data() << ktx.data(),
+                               nm, &engine);
+    QSignalSpy finished(&fetcher, &QGeoTileFetcher::tileFinished);
+
+    const QGeoTileSpec pngTile(QStringLiteral("osm"), 1, 2, 1, 1);
+    const QGeoTileSpec webpTile(QStringLiteral("osm"), 2, 2, 1, 2);
+    const QGeoTileSpec ktxTile(QStringLiteral("osm"), 3, 2, 1, 3);
+    fetcher.updateTileRequests(QSet<QGeoTileSpec>() << pngTile << webpTile << ktxTile, QSet<QGeoTileSpec>());
+    QTRY_COMPARE(finished.count(), 3);
+
+    QHash<QGeoTileSpec, QString> formats;
+    for (const QList<QVariant> &args : qAsConst(finished))
+        formats.insert(args.at(0).value<QGeoTileSpec>(), args.at(2).toString());
+    QCOMPARE(formats.value(pngTile), QStringLiteral("png"));
+    QCOMPARE(formats.value(webpTile), QStringLiteral("webp"));
+    QCOMPARE(formats.value(ktxTile), QStringLiteral("ktx"));
+
+    QCOMPARE(accepted.size(), 3);
+    QCOMPARE(accepted.value(png->tileAddress(1, 1, 2)), accept);
+    QCOMPARE(accepted.value(webp->tileAddress(1, 2, 2)), accept);
+    // not for the texture files
+    QCOMPARE(accepted.value(ktx->tileAddress(1, 3, 2)), QByteArray());
+}
+
+// The fetcher thread reads copies of the providers and of the camera capabilities, which
+// change in the engine thread
+void tst_QGeoTileFetcherOsm::threadedFetching()
+{
+    const QByteArray definition = "{ \"UrlTemplate\" : \"data:image/png,%z-%x-%y\", "
+                                  "\"ImageFormat\" : \"png\", \"MapCopyRight\" : \"\", "
+                                  "\"DataCopyRight\" : \"\", \"MaximumZoomLevel\" : 8 }";
+    QNetworkAccessManager resolver;
+    const QUrl redirector(QStringLiteral("data:application/json;base64,")
+                          + QString::fromLatin1(definition.toBase64()));
+    QScopedPointer<QGeoTileProviderOsm> osm(new QGeoTileProviderOsm(&resolver, QGeoMapType(),
+                                                                    QVector<TileProvider *>()
+                                                                    << new TileProvider(redirector),
+                                                                    QGeoCameraCapabilities()));
+    QVERIFY(!osm->isResolved());
+
+    ThreadedMappingEngine engine;
+    engine.setMaximumZoomLevel(19);
+    QGeoTileFetcherOsm *fetcher = new QGeoTileFetcherOsm(QVector<QGeoTileProviderOsm *>() << osm.data(),
+                                                         QGeoNetworkAccessManagerOsm::instance(QVariantMap()),
+                                                         &engine);
+    engine.setTileFetcher(fetcher);
+    QVERIFY(fetcher->thread() != QThread::currentThread());
+
+    QSet<QGeoTileSpec> finished;
+    connect(fetcher, &QGeoTileFetcher::tileFinished, this,
+            [&finished](const QGeoTileSpec &spec) { finished.insert(spec); });
+    auto request = [fetcher](const QGeoTileSpec &spec) {
+        QMetaObject::invokeMethod(fetcher, [fetcher, spec]() {
+            fetcher->updateTileRequests(QSet<QGeoTileSpec>() << spec, QSet<QGeoTileSpec>());
+        });
+    };
+
+    // resolved in this thread, the fetcher learns about it through the copies of the provider
+    const QGeoTileSpec tile(QStringLiteral("osm"), 1, 5, 1, 1);
+    request(tile);
+    QTRY_VERIFY(osm->isResolved());
+    QTRY_VERIFY(finished.contains(tile));
+
+    // above the maximum zoom level of the provider
+    const QGeoTileSpec tooDeep(QStringLiteral("osm"), 1, 9, 1, 1);
+    const QGeoTileSpec shallow(QStringLiteral("osm"), 1, 2, 1, 1);
+    request(tooDeep);
+    request(shallow);
+    QTRY_VERIFY(finished.contains(shallow));
+    QVERIFY(!finished.contains(tooDeep));
+
+    // the fetcher gets the capabilities of the new map types
+    engine.setMaximumZoomLevel(4);
+    const QGeoTileSpec hidden(QStringLiteral("osm"), 1, 5, 2, 1);
+    const QGeoTileSpec shown(QStringLiteral("osm"), 1, 3, 2, 1);
+    request(hidden);
+    request(shown);
+    QTRY_VERIFY(finished.contains(shown));
+    QVERIFY(!finished.contains(hidden));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTileFetcherOsm)
+
+#include "tst_qgeotilefetcherosm.moc"
@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotileproviderosm
+
+plugin.path = ../../../src/plugins/geoservices/osm/
+
+SOURCES += tst_qgeotileproviderosm.cpp \
+           $$plugin.path/qgeotileproviderosm.cpp
+HEADERS += $$plugin.path/qgeotileproviderosm.h
+INCLUDEPATH += $$plugin.path
+
+QT += location location-private network testlib
@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotileproviderosm.h"
+
+#include <QtTest/QtTest>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtNetwork/QNetworkAccessManager>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileProviderOsm : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void storeResolvedDefinition();
+    void useStoredDefinition();
+    void expiredDefinition();
+    void withdrawnDefinition();
+
+private:
+    QGeoTileProviderOsm *createProvider();
+    void writeRepository(bool enabled = true);
+    void setResolved(const QDateTime &resolved);
+    QString storedDefinition() const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+    QNetworkAccessManager m_nm;
+};
+
+static const qint64 lifetime = 3600;
+
+void tst_QGeoTileProviderOsm::initTestCase()
+{
+    qRegisterMetaType<const QGeoTileProviderOsm *>();
+}
+
+void tst_QGeoTileProviderOsm::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void tst_QGeoTileProviderOsm::cleanup()
+{
+    m_dir.reset();
+}
+
+// A provider resolved from the repository file, keeping its information in the cache
+QGeoTileProviderOsm *tst_QGeoTileProviderOsm::createProvider()
+{
+    const QUrl repository = QUrl::fromLocalFile(m_dir->filePath(QStringLiteral("street")));
+    QGeoTileProviderOsm *provider = new QGeoTileProviderOsm(&m_nm, QGeoMapType(),
+                                                            QVector<TileProvider *>() << new TileProvider(repository),
+                                                            QGeoCameraCapabilities());
+    provider->setDefinitionCache(m_dir->filePath(QStringLiteral("resolved_providers")), lifetime);
+    return provider;
+}
+
+void tst_QGeoTileProviderOsm::writeRepository(bool enabled)
+{
+    QJsonObject json;
+    json.insert(QStringLiteral("Enabled"), enabled);
+    json.insert(QStringLiteral("UrlTemplate"), QStringLiteral("http://tiles.test/%z/%x/%y.png"));
+    json.insert(QStringLiteral("ImageFormat"), QStringLiteral("png"));
+    json.insert(QStringLiteral("MapCopyRight"), QStringLiteral("Test"));
+    json.insert(QStringLiteral("DataCopyRight"), QStringLiteral("Test contributors"));
+    QFile file(m_dir->filePath(QStringLiteral("street")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(json).toJson());
+}
+
+void tst_QGeoTileProviderOsm::setResolved(const QDateTime &resolved)
+{
+    QFile file(storedDefinition());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonObject stored = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+    stored.insert(QStringLiteral("Resolved"), resolved.toString(Qt::ISODate));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QJsonDocument(stored).toJson());
+}
+
+QString tst_QGeoTileProviderOsm::storedDefinition() const
+{
+    const QDir dir(m_dir->filePath(QStringLiteral("resolved_providers")));
+    const QStringList files = dir.entryList(QDir::Files);
+    return files.size() == 1 ? dir.filePath(files.first()) : QString();
+}
+
+void tst_QGeoTileProviderOsm::storeResolvedDefinition()
+{
+    writeRepository();
+    QScopedPointer<QGeoTileProviderOsm> provider(createProvider());
+    QVERIFY(!provider->isResolved());
+    QVERIFY(storedDefinition().isEmpty());
+
+    provider->resolveProvider();
+    QTRY_VERIFY(provider->isResolved());
+    QVERIFY(provider->isValid());
+    QCOMPARE(provider->tileAddress(1, 2, 3), QUrl(QStringLiteral("http://tiles.test/3/1/2.png")));
+    QVERIFY(!storedDefinition().isEmpty());
+}
+
+// resolved right away on the next run, without the repository
+void tst_QGeoTileProviderOsm::useStoredDefinition()
+{
+    writeRepository();
+    QScopedPointer<QGeoTileProviderOsm> provider(createProvider());
+    provider->resolveProvider();
+    QTRY_VERIFY(provider->isValid());
+
+    QVERIFY(QFile::remove(m_dir->filePath(QStringLiteral("street"))));
+    provider.reset(createProvider());
+    QVERIFY(provider->isResolved());
+    QVERIFY(provider->isValid());
+    QCOMPARE(provider->tileAddress(1, 2, 3), QUrl(QStringLiteral("http://tiles.test/3/1/2.png")));
+    QCOMPARE(provider->mapCopyRight(), QStringLiteral("Test"));
+
+    // the failed refresh keeps it for the next time
+    QTest::qWait(100);
+    QVERIFY(!storedDefinition().isEmpty());
+}
+
+// only used when the repository fails
+void tst_QGeoTileProviderOsm::expiredDefinition()
+{
+    writeRepository();
+    QScopedPointer<QGeoTileProviderOsm> provider(createProvider());
+    provider->resolveProvider();
+    QTRY_VERIFY(provider->isValid());
+    setResolved(QDateTime::currentDateTimeUtc().addSecs(-2 * lifetime));
+
+    QVERIFY(QFile::remove(m_dir->filePath(QStringLiteral("street"))));
+    provider.reset(createProvider());
+    QVERIFY(!provider->isResolved());
+    QSignalSpy finished(provider.data(), &QGeoTileProviderOsm::resolutionFinished);
+    provider->resolveProvider();
+    QTRY_COMPARE(finished.count(), 1);
+    QVERIFY(provider->isValid());
+    QCOMPARE(provider->tileAddress(1, 2, 3), QUrl(QStringLiteral("http://tiles.test/3/1/2.png")));
+}
+
+// a provider the repository disables is resolved again next time
+void tst_QGeoTileProviderOsm::withdrawnDefinition()
+{
+    writeRepository();
+    QScopedPointer<QGeoTileProviderOsm> provider(createProvider());
+    provider->resolveProvider();
+    QTRY_VERIFY(provider->isValid());
+
+    writeRepository(false);
+    provider.reset(createProvider());
+    // still serving this run
+    QVERIFY(provider->isValid());
+    QTRY_VERIFY(storedDefinition().isEmpty());
+    QCOMPARE(provider->tileAddress(1, 2, 3), QUrl(QStringLiteral("http://tiles.test/3/1/2.png")));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTileProviderOsm)
+
+#include "tst_qgeotileproviderosm.moc"
@@ -59,6 +59,7 @@ private Q_SLOTS:
     void lessThanOperatorTest();
     void qHashTest_data();
     void qHashTest();
+    void qHashDistributionTest();
 };
 
 tst_QGeoTileSpec::tst_QGeoTileSpec()
@@ -312,6 +313,24 @@ void tst_QGeoTileSpec::qHashTest()
     QVERIFY(hash2 != hash3);
 }
 
+void tst_QGeoTileSpec::qHashDistributionTest()
+{
+    // Neighbouring tiles, as found in a visible tile set, should not collide
+    QSet<unsigned int> hashes;
+    for (int x = 0; x < 64; ++x) {
+        for (int y = 0; y < 64; ++y)
+            hashes.insert(qHash(QGeoTileSpec(QStringLiteral("geo plugin"), 1, 6, x, y)));
+    }
+    QVERIFY(hashes.size() > 64 * 64 - 4);
+
+    QGeoTileSpec a(QStringLiteral("plugin a"), 1, 6, 10, 20);
+    QGeoTileSpec b(QStringLiteral("plugin b"), 1, 6, 10, 20);
+    QVERIFY(!(a == b));
+    QCOMPARE(a.plugin(), QStringLiteral("plugin a"));
+    QCOMPARE(b.plugin(), QStringLiteral("plugin b"));
+    QCOMPARE(QGeoTileSpec(QStringLiteral("plugin a"), 1, 6, 10, 20), a);
+}
+
 QTEST_APPLESS_MAIN(tst_QGeoTileSpec)
 
 #include "tst_qgeotilespec.moc"
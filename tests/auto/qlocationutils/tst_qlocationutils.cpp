@@ -0,0 +1,218 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+//TESTED_COMPONENT=src/positioning
+
+#include <QtTest/QtTest>
+#include <QtPositioning/private/qlocationutils_p.h>
+
+#include <cmath>
+
+QT_USE_NAMESPACE
+
+class tst_QLocationUtils : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void splitNmeaFields_data();
+    void splitNmeaFields();
+    void getNmeaDouble_data();
+    void getNmeaDouble();
+    void getNmeaInt_data();
+    void getNmeaInt();
+    void getNmeaTime_data();
+    void getNmeaTime();
+    void splitNmeaSentences();
+};
+
+void tst_QLocationUtils::splitNmeaFields_data()
+{
+    QTest::addColumn<QByteArray>("sentence");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("single") << QByteArray("$GPGGA");
+    QTest::newRow("empty fields") << QByteArray(",,,");
+    QTest::newRow("gga") << QByteArray("$GPGGA,060613.626,2734.7964,S,15306.0124,E,1,03,2.9,-19.0,M,36.9,M,,0000");
+}
+
+void tst_QLocationUtils::splitNmeaFields()
+{
+    QFETCH(QByteArray, sentence);
+
+    const QList<QByteArray> expected = sentence.split(',');
+    QLocationUtils::NmeaField fields[QLocationUtils::MaxNmeaFields];
+    const int count = QLocationUtils::splitNmeaFields(sentence.constData(), sentence.size(),
+                                                      fields, QLocationUtils::MaxNmeaFields);
+    QCOMPARE(count, expected.size());
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(QByteArray(fields[i].data, fields[i].size), expected.at(i));
+
+    // Fields past the maximum are dropped
+    QLocationUtils::NmeaField first[2];
+    QCOMPARE(QLocationUtils::splitNmeaFields(sentence.constData(), sentence.size(), first, 2),
+             qMin(2, expected.size()));
+}
+
+void tst_QLocationUtils::getNmeaDouble_data()
+{
+    QTest::addColumn<QByteArray>("field");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("integer") << QByteArray("36");
+    QTest::newRow("decimal") << QByteArray("2734.7964");
+    QTest::newRow("negative") << QByteArray("-19.0");
+    QTest::newRow("negative zero") << QByteArray("-0.0");
+    QTest::newRow("plus") << QByteArray("+2.9");
+    QTest::newRow("leading dot") << QByteArray(".5");
+    QTest::newRow("trailing dot") << QByteArray("5.");
+    QTest::newRow("dot") << QByteArray(".");
+    QTest::newRow("sign only") << QByteArray("-");
+    QTest::newRow("exponent") << QByteArray("1e3");
+    QTest::newRow("whitespace") << QByteArray(" 1.5");
+    QTest::newRow("long") << QByteArray("15306.012412345678901");
+    QTest::newRow("many decimals") << QByteArray("0.00000000000000000000000123");
+    QTest::newRow("two dots") << QByteArray("1.2.3");
+    QTest::newRow("checksum") << QByteArray("45*7A");
+}
+
+void tst_QLocationUtils::getNmeaDouble()
+{
+    QFETCH(QByteArray, field);
+
+    bool expectedOk = false;
+    const double expected = field.toDouble(&expectedOk);
+
+    const QLocationUtils::NmeaField nmeaField = { field.constData(), field.size() };
+    double value = 0.0;
+    QCOMPARE(QLocationUtils::getNmeaDouble(nmeaField, &value), expectedOk);
+    if (expectedOk) {
+        QCOMPARE(value, expected);
+        QCOMPARE(std::signbit(value), std::signbit(expected));
+    }
+}
+
+void tst_QLocationUtils::getNmeaInt_data()
+{
+    QTest::addColumn<QByteArray>("field");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("zero") << QByteArray("0");
+    QTest::newRow("padded") << QByteArray("07");
+    QTest::newRow("negative") << QByteArray("-12");
+    QTest::newRow("plus") << QByteArray("+12");
+    QTest::newRow("sign only") << QByteArray("-");
+    QTest::newRow("max") << QByteArray("2147483647");
+    QTest::newRow("overflow") << QByteArray("2147483648");
+    QTest::newRow("checksum") << QByteArray("45*7A");
+    QTest::newRow("decimal") << QByteArray("4.5");
+}
+
+void tst_QLocationUtils::getNmeaInt()
+{
+    QFETCH(QByteArray, field);
+
+    bool expectedOk = false;
+    const int expected = field.toInt(&expectedOk);
+
+    const QLocationUtils::NmeaField nmeaField = { field.constData(), field.size() };
+    int value = 0;
+    QCOMPARE(QLocationUtils::getNmeaInt(nmeaField, &value), expectedOk);
+    if (expectedOk)
+        QCOMPARE(value, expected);
+
+    bool expectedUIntOk = false;
+    const uint expectedUInt = field.toUInt(&expectedUIntOk);
+    uint uintValue = 0;
+    QCOMPARE(QLocationUtils::getNmeaUInt(nmeaField, &uintValue), expectedUIntOk);
+    if (expectedUIntOk)
+        QCOMPARE(uintValue, expectedUInt);
+}
+
+void tst_QLocationUtils::getNmeaTime_data()
+{
+    QTest::addColumn<QByteArray>("field");
+    QTest::addColumn<QTime>("expected");
+
+    QTest::newRow("plain") << QByteArray("060613") << QTime(6, 6, 13);
+    QTest::newRow("msecs") << QByteArray("060613.626") << QTime(6, 6, 13, 626);
+    QTest::newRow("centiseconds") << QByteArray("060613.62") << QTime(6, 6, 13, 620);
+    QTest::newRow("long fraction") << QByteArray("060613.62689") << QTime(6, 6, 13, 626);
+    QTest::newRow("invalid hour") << QByteArray("250613") << QTime();
+    QTest::newRow("short") << QByteArray("0606") << QTime();
+    QTest::newRow("letters") << QByteArray("06a613") << QTime();
+}
+
+void tst_QLocationUtils::getNmeaTime()
+{
+    QFETCH(QByteArray, field);
+    QFETCH(QTime, expected);
+
+    QTime time;
+    QCOMPARE(QLocationUtils::getNmeaTime(field, &time), expected.isValid());
+    if (expected.isValid())
+        QCOMPARE(time, expected);
+}
+
+void tst_QLocationUtils::splitNmeaSentences()
+{
+    const QByteArray gga("$GPGGA,060613.626,2734.7964,S,15306.0124,E,1,03,2.9,-19.0,M,36.9,M,,0000*58\r\n");
+    const QByteArray rmc("$GPRMC,060613.626,A,2734.7964,S,15306.0124,E,0.0,0.0,260110,,*12\r\n");
+    QByteArray badRmc = rmc;
+    badRmc[10] = '7';
+    const QByteArray data = "garbage" + gga + "$GPGSA,A,3," + badRmc + rmc + "$GPGGA,0606";
+
+    QLocationUtils::NmeaSentenceSpan spans[8];
+    qint64 consumed = 0;
+    QCOMPARE(QLocationUtils::splitNmeaSentences(data.constData(), data.size(), spans, 8, &consumed), 3);
+    QCOMPARE(QByteArray(spans[0].data, spans[0].size), gga);
+    QVERIFY(QLocationUtils::hasValidNmeaChecksum(spans[0].data, spans[0].size));
+    // the interrupted GSA is dropped, the bad checksum is left to the parsers
+    QCOMPARE(QByteArray(spans[1].data, spans[1].size), badRmc);
+    QVERIFY(!QLocationUtils::hasValidNmeaChecksum(spans[1].data, spans[1].size));
+    QCOMPARE(QByteArray(spans[2].data, spans[2].size), rmc);
+    // the incomplete sentence is left for the next call
+    QCOMPARE(data.mid(int(consumed)), QByteArray("$GPGGA,0606"));
+
+    // at most maxSpans are returned, the rest is not consumed
+    QCOMPARE(QLocationUtils::splitNmeaSentences(data.constData(), data.size(), spans, 1, &consumed), 1);
+    QCOMPARE(consumed, qint64(data.indexOf(gga) + gga.size()));
+
+    QCOMPARE(QLocationUtils::splitNmeaSentences("no sentence", 11, spans, 8, &consumed), 0);
+    QCOMPARE(consumed, qint64(11));
+
+    // overlong lines are dropped
+    const QByteArray overlong = '$' + QByteArray(QLocationUtils::MaxNmeaSentenceLength, 'x') + "\r\n" + gga;
+    QCOMPARE(QLocationUtils::splitNmeaSentences(overlong.constData(), overlong.size(), spans, 8, &consumed), 1);
+    QCOMPARE(QByteArray(spans[0].data, spans[0].size), gga);
+}
+
+QTEST_APPLESS_MAIN(tst_QLocationUtils)
+
+#include "tst_qlocationutils.moc"
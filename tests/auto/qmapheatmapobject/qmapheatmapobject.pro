@@ -0,0 +1,8 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qmapheatmapobject
+
+SOURCES += \
+    tst_qmapheatmapobject.cpp
+
+QT += location-private positioning qml testlib
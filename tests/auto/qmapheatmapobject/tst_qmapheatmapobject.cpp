@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/labs
+
+#include <QtTest/QtTest>
+#include <QtCore/QJsonDocument>
+#include <QtQml/QJSEngine>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoRectangle>
+#include <QtLocation/private/qmapheatmapobject_p.h>
+#include <QtLocation/private/qgeojson_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QMapHeatmapObject : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void coordinates();
+    void path();
+    void doubles();
+    void arrayBuffer();
+    void geoJson();
+    void properties();
+};
+
+// Invalid coordinates are not points
+void tst_QMapHeatmapObject::coordinates()
+{
+    QMapHeatmapObject heatmap;
+    QSignalSpy pointsChanged(&heatmap, &QMapHeatmapObject::pointsChanged);
+    QCOMPARE(heatmap.pointCount(), 0);
+
+    const QVariantList points { QVariant::fromValue(QGeoCoordinate(10.0, 20.0)),
+                                QVariant::fromValue(QGeoCoordinate()),
+                                QVariant::fromValue(QGeoCoordinate(-30.0, -40.0)),
+                                QVariant::fromValue(QGeoCoordinate(95.0, 0.0)) };
+    heatmap.setPoints(points);
+    QCOMPARE(pointsChanged.count(), 1);
+    QCOMPARE(heatmap.pointCount(), 2);
+    QCOMPARE(heatmap.points().toList(), points);
+    QCOMPARE(heatmap.geoShape().boundingGeoRectangle(),
+             QGeoRectangle(QGeoCoordinate(10.0, -40.0), QGeoCoordinate(-30.0, 20.0)));
+
+    heatmap.setPoints(QVariant());
+    QCOMPARE(pointsChanged.count(), 2);
+    QCOMPARE(heatmap.pointCount(), 0);
+    QVERIFY(!heatmap.geoShape().isValid());
+}
+
+// Each vertex is a point
+void tst_QMapHeatmapObject::path()
+{
+    QMapHeatmapObject heatmap;
+    const QGeoPath path({ QGeoCoordinate(0.0, 0.0), QGeoCoordinate(1.0, 1.0), QGeoCoordinate(2.0, 2.0) });
+    heatmap.setPoints(QVariant::fromValue(path));
+    QCOMPARE(heatmap.pointCount(), 3);
+
+    heatmap.setPoints(QVariantList { QVariant::fromValue(path), QVariant::fromValue(QGeoCoordinate(3.0, 3.0)) });
+    QCOMPARE(heatmap.pointCount(), 4);
+}
+
+// Pairs of latitudes and longitudes, the remaining bytes of an incomplete pair are ignored
+void tst_QMapHeatmapObject::doubles()
+{
+    const QVector<double> values { 10.0, 20.0, qQNaN(), 0.0, -10.0, 200.0, -5.0, -6.0, 45.0 };
+    const QByteArray data(reinterpret_cast<const char *>(values.constData()), values.size() * int(sizeof(double)));
+
+    QMapHeatmapObject heatmap;
+    heatmap.setPoints(data);
+    QCOMPARE(heatmap.pointCount(), 2);
+    QCOMPARE(heatmap.geoShape().boundingGeoRectangle(),
+             QGeoRectangle(QGeoCoordinate(10.0, -6.0), QGeoCoordinate(-5.0, 20.0)));
+}
+
+// As given from QML
+void tst_QMapHeatmapObject::arrayBuffer()
+{
+    QJSEngine engine;
+    const QJSValue buffer = engine.evaluate(QStringLiteral("new Float64Array([10, 20, 30, 40, 50, 60]).buffer"));
+    QVERIFY(!buffer.isError());
+
+    QMapHeatmapObject heatmap;
+    heatmap.setPoints(QVariant::fromValue(buffer));
+    QCOMPARE(heatmap.pointCount(), 3);
+
+    const QJSValue list = engine.evaluate(QStringLiteral("[ { latitude: 1, longitude: 2 } ]"));
+    heatmap.setPoints(QVariant::fromValue(list));
+    QCOMPARE(heatmap.pointCount(), 0); // objects are not coordinates
+}
+
+// Points and the vertices of lines, polygons are not points
+void tst_QMapHeatmapObject::geoJson()
+{
+    const QByteArray json =
+            "{ \"type\": \"FeatureCollection\", \"features\": ["
+            "  { \"type\": \"Feature\", \"properties\": {},"
+            "    \"geometry\": { \"type\": \"Point\", \"coordinates\": [ 20.0, 10.0 ] } },"
+            "  { \"type\": \"Feature\", \"properties\": {},"
+            "    \"geometry\": { \"type\": \"MultiPoint\", \"coordinates\": [ [ 1.0, 2.0 ], [ 3.0, 4.0 ] ] } },"
+            "  { \"type\": \"Feature\", \"properties\": {},"
+            "    \"geometry\": { \"type\": \"LineString\", \"coordinates\": [ [ 5.0, 6.0 ], [ 7.0, 8.0 ] ] } },"
+            "  { \"type\": \"Feature\", \"properties\": {},"
+            "    \"geometry\": { \"type\": \"Polygon\", \"coordinates\": [ [ [ 0.0, 0.0 ], [ 1.0, 0.0 ], [ 1.0, 1.0 ], [ 0.0, 0.0 ] ] ] } }"
+            "] }";
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QMapHeatmapObject heatmap;
+    heatmap.setPoints(QGeoJson::importGeoJson(document));
+    QCOMPARE(heatmap.pointCount(), 1 + 2 + 2);
+    QCOMPARE(heatmap.geoShape().boundingGeoRectangle(),
+             QGeoRectangle(QGeoCoordinate(10.0, 1.0), QGeoCoordinate(2.0, 20.0)));
+}
+
+void tst_QMapHeatmapObject::properties()
+{
+    QMapHeatmapObject heatmap;
+    QCOMPARE(heatmap.radius(), 20.0);
+    QCOMPARE(heatmap.maximumDensity(), 10.0);
+    QCOMPARE(heatmap.colors().size(), 6);
+
+    QSignalSpy radiusChanged(&heatmap, &QMapHeatmapObject::radiusChanged);
+    heatmap.setRadius(24.0);
+    heatmap.setRadius(24.0);
+    QCOMPARE(radiusChanged.count(), 1);
+    QCOMPARE(heatmap.radius(), 24.0);
+
+    // densities are positive
+    QSignalSpy densityChanged(&heatmap, &QMapHeatmapObject::maximumDensityChanged);
+    heatmap.setMaximumDensity(0.0);
+    heatmap.setMaximumDensity(-1.0);
+    heatmap.setMaximumDensity(qQNaN());
+    QCOMPARE(densityChanged.count(), 0);
+    heatmap.setMaximumDensity(20.0);
+    QCOMPARE(densityChanged.count(), 1);
+    QCOMPARE(heatmap.maximumDensity(), 20.0);
+
+    QSignalSpy colorsChanged(&heatmap, &QMapHeatmapObject::colorsChanged);
+    const QVariantList colors { QColor(Qt::transparent), QColor(Qt::red) };
+    heatmap.setColors(colors);
+    heatmap.setColors(colors);
+    QCOMPARE(colorsChanged.count(), 1);
+    QCOMPARE(heatmap.colors(), colors);
+}
+
+QTEST_GUILESS_MAIN(tst_QMapHeatmapObject)
+
+#include "tst_qmapheatmapobject.moc"
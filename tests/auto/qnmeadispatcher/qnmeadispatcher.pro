@@ -0,0 +1,14 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qnmeadispatcher
+
+plugin.path = ../../../src/plugins/position/serialnmea/
+
+SOURCES += tst_qnmeadispatcher.cpp \
+           $$plugin.path/qnmeadispatcher.cpp \
+           $$plugin.path/qubxdecoder.cpp
+HEADERS += $$plugin.path/qnmeadispatcher_p.h \
+           $$plugin.path/qubxdecoder_p.h
+INCLUDEPATH += $$plugin.path
+
+QT += positioning positioning-private testlib
@@ -0,0 +1,471 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtCore/qendian.h>
+#include "qnmeadispatcher_p.h"
+#include "qubxdecoder_p.h"
+
+QT_USE_NAMESPACE
+
+// A serial port stand-in, the test feeds it what the receiver would send
+class FeedDevice : public QIODevice
+{
+public:
+    FeedDevice() { open(QIODevice::ReadOnly); }
+
+    void feed(const QByteArray &data)
+    {
+        m_data += data;
+        emit readyRead();
+    }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return m_data.size() + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override
+    {
+        const qint64 n = qMin<qint64>(maxlen, m_data.size());
+        memcpy(data, m_data.constData(), size_t(n));
+        m_data.remove(0, int(n));
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray m_data;
+};
+
+static const QByteArray gga = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+static const QByteArray rmc = "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n";
+
+// A UBX frame of the payload, with its Fletcher checksum
+static QByteArray ubxFrame(quint16 message, const QByteArray &payload)
+{
+    QByteArray frame;
+    frame += char(QUbxDecoder::SyncChar1);
+    frame += char(QUbxDecoder::SyncChar2);
+    frame += char(message >> 8);
+    frame += char(message & 0xff);
+    frame += char(payload.size() & 0xff);
+    frame += char(payload.size() >> 8);
+    frame += payload;
+    uchar a = 0;
+    uchar b = 0;
+    for (int i = 2; i < frame.size(); ++i) {
+        a += uchar(frame.at(i));
+        b += a;
+    }
+    frame += char(a);
+    frame += char(b);
+    return frame;
+}
+
+template <typename T>
+static void ubxWrite(QByteArray &payload, int offset, T value)
+{
+    qToLittleEndian<T>(value, payload.data() + offset);
+}
+
+// A NAV-PVT payload at 59.91 N, 10.75 E
+static QByteArray navPvtPayload(const QDateTime &time, qint32 nano, uchar fixType = 3)
+{
+    QByteArray p(92, '\0');
+    ubxWrite<quint16>(p, 4, quint16(time.date().year()));
+    p[6] = char(time.date().month());
+    p[7] = char(time.date().day());
+    p[8] = char(time.time().hour());
+    p[9] = char(time.time().minute());
+    p[10] = char(time.time().second());
+    p[11] = char(0x03);                         // validDate, validTime
+    ubxWrite<qint32>(p, 16, nano);
+    p[20] = char(fixType);
+    p[21] = char(0x01);                         // gnssFixOK
+    ubxWrite<qint32>(p, 24, 107500000);         // lon
+    ubxWrite<qint32>(p, 28, 599100000);         // lat
+    ubxWrite<qint32>(p, 36, 23500);             // hMSL, mm
+    ubxWrite<quint32>(p, 40, 2500);             // hAcc, mm
+    ubxWrite<quint32>(p, 44, 4000);             // vAcc, mm
+    ubxWrite<qint32>(p, 56, -1500);             // velD, mm/s
+    ubxWrite<qint32>(p, 60, 12000);             // gSpeed, mm/s
+    ubxWrite<qint32>(p, 64, 9000000);           // headMot, 1e-5 degrees
+    return p;
+}
+
+struct NavSatBlock
+{
+    uchar gnssId;
+    uchar svId;
+    uchar cno;
+    qint8 elevation;
+    qint16 azimuth;
+    bool used;
+};
+
+static QByteArray navSatPayload(const QVector<NavSatBlock> &blocks)
+{
+    QByteArray p(8 + 12 * blocks.size(), '\0');
+    p[4] = char(1);                             // version
+    p[5] = char(blocks.size());
+    for (int i = 0; i < blocks.size(); ++i) {
+        const int offset = 8 + 12 * i;
+        p[offset] = char(blocks.at(i).gnssId);
+        p[offset + 1] = char(blocks.at(i).svId);
+        p[offset + 2] = char(blocks.at(i).cno);
+        p[offset + 3] = char(blocks.at(i).elevation);
+        ubxWrite<qint16>(p, offset + 4, blocks.at(i).azimuth);
+        ubxWrite<quint32>(p, offset + 8, blocks.at(i).used ? 0x08 : 0);
+    }
+    return p;
+}
+
+class tst_QNmeaDispatcher : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void sharedSentences();
+    void partialSentence();
+    void slowConsumerSkipsOverwritten();
+    void parseResultsPerUere();
+    void ubxChecksum();
+    void ubxResync();
+    void ubxNavPvt();
+    void ubxNavPvtAcrossMidnight();
+    void ubxNavSat();
+    void mixedUbxAndNmea();
+};
+
+void tst_QNmeaDispatcher::sharedSentences()
+{
+    FeedDevice device;
+    QNmeaDispatcher dispatcher(&device);
+    QNmeaDispatcherDevice first(&dispatcher);
+    QNmeaDispatcherDevice second(&dispatcher);
+    QSignalSpy firstReady(&first, &QIODevice::readyRead);
+    QSignalSpy secondReady(&second, &QIODevice::readyRead);
+
+    device.feed(gga + rmc);
+    QCOMPARE(dispatcher.writeSequence(), quint64(2));
+    QCOMPARE(firstReady.count(), 1);
+    QCOMPARE(secondReady.count(), 1);
+
+    const QByteArray line = first.readLine();
+    QCOMPARE(line, gga);
+    QCOMPARE(second.readLine(), gga);
+
+    // Both consumers get the same ring slot, parsed once
+    QNmeaDispatcher::Sentence *sentence = first.lastSentence(line.constData(), line.size());
+    QVERIFY(sentence);
+    QCOMPARE(second.lastSentence(line.constData(), line.size()), sentence);
+    QVERIFY(!sentence->positionParsed);
+
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QVERIFY(dispatcher.positionInfo(sentence, 1.0, &info, &hasFix));
+    QVERIFY(hasFix);
+    QVERIFY(sentence->positionParsed);
+    QCOMPARE(info.coordinate().altitude(), 545.4);
+
+    QGeoPositionInfo again;
+    QVERIFY(dispatcher.positionInfo(sentence, 1.0, &again, nullptr));
+    QCOMPARE(again, info);
+
+    QCOMPARE(first.readLine(), rmc);
+    QVERIFY(!first.canReadLine());
+    QVERIFY(second.canReadLine());
+}
+
+void tst_QNmeaDispatcher::partialSentence()
+{
+    FeedDevice device;
+    QNmeaDispatcher dispatcher(&device);
+    QNmeaDispatcherDevice consumer(&dispatcher);
+
+    device.feed(gga.left(20));
+    QCOMPARE(dispatcher.writeSequence(), quint64(0));
+    QVERIFY(!consumer.canReadLine());
+
+    // Garbage before the start of a sentence is dropped
+    device.feed(gga.mid(20) + "noise" + rmc);
+    QCOMPARE(dispatcher.writeSequence(), quint64(2));
+    QCOMPARE(consumer.readLine(), gga);
+    QCOMPARE(consumer.readLine(), rmc);
+}
+
+void tst_QNmeaDispatcher::slowConsumerSkipsOverwritten()
+{
+    FeedDevice device;
+    QNmeaDispatcher dispatcher(&device);
+    QNmeaDispatcherDevice consumer(&dispatcher);
+
+    QByteArray data;
+    for (int i = 0; i < 300; ++i)
+        data += "$GPTXT," + QByteArray::number(i) + "\r\n";
+    device.feed(data);
+
+    QCOMPARE(dispatcher.writeSequence(), quint64(300));
+    QCOMPARE(dispatcher.oldestSequence(), quint64(300 - 256));
+    QVERIFY(!dispatcher.sentence(0));
+    QCOMPARE(consumer.readLine(), QByteArray("$GPTXT,44\r\n"));
+
+    // A consumer created now starts at the newest sentences
+    QNmeaDispatcherDevice late(&dispatcher);
+    QVERIFY(!late.canReadLine());
+    device.feed(rmc);
+    QCOMPARE(late.readLine(), rmc);
+}
+
+void tst_QNmeaDispatcher::parseResultsPerUere()
+{
+    FeedDevice device;
+    QNmeaDispatcher dispatcher(&device);
+    QNmeaDispatcherDevice consumer(&dispatcher);
+    device.feed(gga);
+    const QByteArray line = consumer.readLine();
+    QNmeaDispatcher::Sentence *sentence = consumer.lastSentence(line.constData(), line.size());
+    QVERIFY(sentence);
+
+    // The accuracy follows the UERE of the asking source, hdop is 0.9
+    QGeoPositionInfo info;
+    QVERIFY(dispatcher.positionInfo(sentence, 1.0, &info, nullptr));
+    QVERIFY(qFuzzyCompare(info.attribute(QGeoPositionInfo::HorizontalAccuracy), 1.8));
+    QVERIFY(dispatcher.positionInfo(sentence, 2.0, &info, nullptr));
+    QVERIFY(qFuzzyCompare(info.attribute(QGeoPositionInfo::HorizontalAccuracy), 3.6));
+}
+
+void tst_QNmeaDispatcher::ubxChecksum()
+{
+    const QByteArray frame = ubxFrame(QUbxDecoder::NavPvt,
+                                      navPvtPayload(QDateTime(QDate(2020, 5, 1), QTime(12, 0), Qt::UTC), 0));
+    QCOMPARE(QUbxDecoder::frameSize(frame.constData(), frame.size()), frame.size());
+    QVERIFY(QUbxDecoder::isFrame(frame.constData(), frame.size()));
+    QCOMPARE(QUbxDecoder::message(frame.constData()), quint16(QUbxDecoder::NavPvt));
+
+    // more data is needed to tell
+    QCOMPARE(QUbxDecoder::frameSize(frame.constData(), 1), 0);
+    QCOMPARE(QUbxDecoder::frameSize(frame.constData(), QUbxDecoder::HeaderSize), 0);
+    QCOMPARE(QUbxDecoder::frameSize(frame.constData(), frame.size() - 1), 0);
+
+    // either checksum byte, or any byte they cover, being wrong fails it
+    for (int i : { 2, 3, 4, 30, frame.size() - 2, frame.size() - 1 }) {
+        QByteArray corrupt = frame;
+        corrupt[i] = char(corrupt.at(i) ^ 0x10);
+        QCOMPARE(QUbxDecoder::frameSize(corrupt.constData(), corrupt.size()), -1);
+    }
+
+    // no sync characters, or a length no receiver sends
+    QCOMPARE(QUbxDecoder::frameSize("$GPGGA", 6), -1);
+    QCOMPARE(QUbxDecoder::frameSize("\xb5$", 2), -1);
+    const QByteArray tooLong = ubxFrame(QUbxDecoder::NavSat, QByteArray(QUbxDecoder::MaxFrameSize, '\0'));
+    QCOMPARE(QUbxDecoder::frameSize(tooLong.constData(), tooLong.size()), -1);
+}
+
+void tst_QNmeaDispatcher::ubxResync()
+{
+    FeedDevice device;
+    QNmeaDispatcher dispatcher(&device);
+
+    const QByteArray pvt = ubxFrame(QUbxDecoder::NavPvt,
+                                    navPvtPayload(QDateTime(QDate(2020, 5, 1), QTime(12, 0), Qt::UTC), 0));
+    const QByteArray truncated = pvt.left(pvt.size() - 10);
+
+    // a frame cut short waits for more data
+    device.feed("garbage" + truncated);
+    QCOMPARE(dispatcher.writeSequence(), quint64(0));
+
+    // and is dropped when the data after it does not complete it
+    device.feed(pvt + gga);
+    QCOMPARE(dispatcher.writeSequence(), quint64(2));
+    QNmeaDispatcher::Sentence *sentence = dispatcher.sentence(0);
+    QVERIFY(sentence);
+    QCOMPARE(sentence->protocol, QNmeaDispatcher::UbxProtocol);
+    QCOMPARE(sentence->ubxMessage, quint16(QUbxDecoder::NavPvt));
+    QCOMPARE(sentence->data, pvt);
+    sentence = dispatcher.sentence(1);
+    QVERIFY(sentence);
+    QCOMPARE(sentence->protocol, QNmeaDispatcher::NmeaProtocol);
+    QCOMPARE(sentence->data, gga);
+
+    // a corrupt frame is skipped, the sentence after it is not, though the
+    // frame holds a '$' (velD) that is no sentence
+    QByteArray corrupt = pvt;
+    corrupt[40] = char(corrupt.at(40) ^ 0x01);
+    device.feed(corrupt + rmc);
+    QCOMPARE(dispatcher.writeSequence(), quint64(3));
+    QCOMPARE(dispatcher.sentence(2)->data, rmc);
+
+    // a binary frame interrupting a sentence ends it
+    device.feed(gga.left(30) + pvt + rmc);
+    QCOMPARE(dispatcher.writeSequence(), quint64(5));
+    QCOMPARE(dispatcher.sentence(3)->data, pvt);
+    QCOMPARE(dispatcher.sentence(4)->data, rmc);
+}
+
+void tst_QNmeaDispatcher::ubxNavPvt()
+{
+    const QDateTime time(QDate(2020, 5, 1), QTime(12, 30, 15), Qt::UTC);
+    QByteArray frame = ubxFrame(QUbxDecoder::NavPvt, navPvtPayload(time, -250000000));
+
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QVERIFY(QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, &hasFix));
+    QVERIFY(hasFix);
+    QCOMPARE(info.timestamp(), time.addMSecs(-250));
+    QCOMPARE(info.coordinate().latitude(), 59.91);
+    QCOMPARE(info.coordinate().longitude(), 10.75);
+    QCOMPARE(info.coordinate().altitude(), 23.5);
+    QCOMPARE(info.attribute(QGeoPositionInfo::HorizontalAccuracy), 2.5);
+    QCOMPARE(info.attribute(QGeoPositionInfo::VerticalAccuracy), 4.0);
+    QCOMPARE(info.attribute(QGeoPositionInfo::VerticalSpeed), 1.5);
+    QCOMPARE(info.attribute(QGeoPositionInfo::GroundSpeed), 12.0);
+    QCOMPARE(info.attribute(QGeoPositionInfo::Direction), 90.0);
+
+    // a 2D fix has no altitude
+    frame = ubxFrame(QUbxDecoder::NavPvt, navPvtPayload(time, 0, 2));
+    QVERIFY(QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, &hasFix));
+    QVERIFY(hasFix);
+    QCOMPARE(info.coordinate().type(), QGeoCoordinate::Coordinate2D);
+    QVERIFY(!info.hasAttribute(QGeoPositionInfo::VerticalAccuracy));
+
+    // no fix, the time alone
+    frame = ubxFrame(QUbxDecoder::NavPvt, navPvtPayload(time, 0, 0));
+    QVERIFY(QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, &hasFix));
+    QVERIFY(!hasFix);
+    QVERIFY(!info.coordinate().isValid());
+    QCOMPARE(info.timestamp(), time);
+
+    // other messages, and payloads too short, are not positions
+    frame = ubxFrame(QUbxDecoder::NavSat, navPvtPayload(time, 0));
+    QVERIFY(!QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, &hasFix));
+    frame = ubxFrame(QUbxDecoder::NavPvt, navPvtPayload(time, 0).left(84));
+    QVERIFY(!QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, &hasFix));
+}
+
+void tst_QNmeaDispatcher::ubxNavPvtAcrossMidnight()
+{
+    // the time rounded up to midnight is on the next day, the actual time on the day before
+    QByteArray frame = ubxFrame(QUbxDecoder::NavPvt,
+                                navPvtPayload(QDateTime(QDate(2020, 5, 2), QTime(0, 0), Qt::UTC),
+                                              -400000000));
+    QGeoPositionInfo info;
+    QVERIFY(QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, nullptr));
+    QCOMPARE(info.timestamp(), QDateTime(QDate(2020, 5, 1), QTime(23, 59, 59, 600), Qt::UTC));
+
+    // and the other way around
+    frame = ubxFrame(QUbxDecoder::NavPvt,
+                     navPvtPayload(QDateTime(QDate(2020, 12, 31), QTime(23, 59, 59), Qt::UTC),
+                                   999000000));
+    QVERIFY(QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, nullptr));
+    QCOMPARE(info.timestamp(), QDateTime(QDate(2020, 12, 31), QTime(23, 59, 59, 999), Qt::UTC));
+    frame = ubxFrame(QUbxDecoder::NavPvt,
+                     navPvtPayload(QDateTime(QDate(2020, 12, 31), QTime(23, 59, 59), Qt::UTC),
+                                   1000000000));
+    QVERIFY(QUbxDecoder::positionInfo(frame.constData(), frame.size(), &info, nullptr));
+    QCOMPARE(info.timestamp(), QDateTime(QDate(2021, 1, 1), QTime(0, 0), Qt::UTC));
+}
+
+void tst_QNmeaDispatcher::ubxNavSat()
+{
+    const QByteArray frame = ubxFrame(QUbxDecoder::NavSat, navSatPayload({
+        { 0, 5, 42, 30, 270, true },        // GPS
+        { 6, 3, 20, -5, 10, false },        // GLONASS
+        { 2, 11, 35, 60, 180, true },       // Galileo
+        { 4, 1, 10, 10, 10, true }          // IMES, not numbered
+    }));
+
+    QList<QGeoSatelliteInfo> inView;
+    QList<int> inUse;
+    QVERIFY(QUbxDecoder::satellites(frame.constData(), frame.size(), inView, inUse));
+    QCOMPARE(inView.size(), 3);
+    QCOMPARE(inView.at(0).satelliteSystem(), QGeoSatelliteInfo::GPS);
+    QCOMPARE(inView.at(0).satelliteIdentifier(), 5);
+    QCOMPARE(inView.at(0).signalStrength(), 42);
+    QCOMPARE(inView.at(0).attribute(QGeoSatelliteInfo::Elevation), 30.0);
+    QCOMPARE(inView.at(0).attribute(QGeoSatelliteInfo::Azimuth), 270.0);
+    QCOMPARE(inView.at(1).satelliteSystem(), QGeoSatelliteInfo::GLONASS);
+    QCOMPARE(inView.at(1).satelliteIdentifier(), 67);
+    QCOMPARE(inView.at(1).attribute(QGeoSatelliteInfo::Elevation), -5.0);
+    QCOMPARE(inView.at(2).satelliteSystem(), QGeoSatelliteInfo::Undefined);
+    QCOMPARE(inView.at(2).satelliteIdentifier(), 311);
+    QCOMPARE(inUse, QList<int>() << 5 << 311);
+
+    // a count the payload does not hold
+    QByteArray payload = navSatPayload({ { 0, 5, 42, 30, 270, true } });
+    payload[5] = char(2);
+    const QByteArray shortFrame = ubxFrame(QUbxDecoder::NavSat, payload);
+    QVERIFY(!QUbxDecoder::satellites(shortFrame.constData(), shortFrame.size(), inView, inUse));
+}
+
+void tst_QNmeaDispatcher::mixedUbxAndNmea()
+{
+    FeedDevice device;
+    QNmeaDispatcher dispatcher(&device);
+    QGeoPositionInfo info;
+    QList<QGeoSatelliteInfo> inView;
+    QList<int> inUse;
+
+    // NMEA alone is used
+    device.feed(gga);
+    QVERIFY(dispatcher.positionInfo(dispatcher.sentence(0), 1.0, &info, nullptr));
+    QCOMPARE(info.coordinate().altitude(), 545.4);
+
+    // once the receiver sends the binary solution, the sentences it replaces are ignored
+    const QDateTime time(QDate(2020, 5, 1), QTime(12, 30, 15), Qt::UTC);
+    const QByteArray pvt = ubxFrame(QUbxDecoder::NavPvt, navPvtPayload(time, 0));
+    const QByteArray sat = ubxFrame(QUbxDecoder::NavSat, navSatPayload({ { 0, 5, 42, 30, 270, true } }));
+    const QByteArray gsa = "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n";
+    device.feed(pvt + rmc + sat + gsa);
+    QCOMPARE(dispatcher.writeSequence(), quint64(5));
+
+    QNmeaDispatcher::Sentence *sentence = dispatcher.sentence(1);
+    QCOMPARE(sentence->protocol, QNmeaDispatcher::UbxProtocol);
+    QVERIFY(dispatcher.positionInfo(sentence, 1.0, &info, nullptr));
+    QCOMPARE(info.timestamp(), time);
+    QCOMPARE(info.coordinate().latitude(), 59.91);
+    QVERIFY(!dispatcher.satelliteUpdate(sentence, inView, inUse));
+
+    sentence = dispatcher.sentence(2);
+    QCOMPARE(sentence->data, rmc);
+    QVERIFY(!dispatcher.positionInfo(sentence, 1.0, &info, nullptr));
+
+    sentence = dispatcher.sentence(3);
+    QVERIFY(!dispatcher.positionInfo(sentence, 1.0, &info, nullptr));
+    QVERIFY(dispatcher.satelliteUpdate(sentence, inView, inUse));
+    QCOMPARE(inView.size(), 1);
+    QCOMPARE(inUse, QList<int>() << 5);
+
+    sentence = dispatcher.sentence(4);
+    QCOMPARE(sentence->type, QLocationUtils::NmeaSentenceGSA);
+    QVERIFY(!dispatcher.satellitesInUse(sentence, inUse));
+}
+
+QTEST_GUILESS_MAIN(tst_QNmeaDispatcher)
+#include "tst_qnmeadispatcher.moc"
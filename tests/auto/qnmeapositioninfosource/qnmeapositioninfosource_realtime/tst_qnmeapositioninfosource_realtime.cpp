@@ -29,6 +29,8 @@
 //TESTED_COMPONENT=src/location
 
 #include "tst_qnmeapositioninfosource.h"
+#include "qnmeapositioninfosourceproxyfactory.h"
+#include "../../utils/qlocationtestutils_p.h"
 
 class tst_QNmeaPositionInfoSource_RealTime : public tst_QNmeaPositionInfoSource
 {
@@ -37,8 +39,51 @@ class tst_QNmeaPositionInfoSource_RealTime : public tst_QNmeaPositionInfoSource
 public:
     tst_QNmeaPositionInfoSource_RealTime()
         : tst_QNmeaPositionInfoSource(QNmeaPositionInfoSource::RealTimeMode) {}
+
+private slots:
+    void sentenceDecisions();
 };
 
+// Each sentence starts a new fix, is merged into the current one or is
+// discarded, which are the decisions carried by the trace points
+void tst_QNmeaPositionInfoSource_RealTime::sentenceDecisions()
+{
+    QNmeaPositionInfoSource source(QNmeaPositionInfoSource::RealTimeMode);
+    source.setUserEquivalentRangeError(5.1);
+    QNmeaPositionInfoSourceProxyFactory factory;
+    QNmeaPositionInfoSourceProxy *proxy = static_cast<QNmeaPositionInfoSourceProxy*>(factory.createProxy(&source));
+
+    QSignalSpy spy(proxy->source(), SIGNAL(positionUpdated(QGeoPositionInfo)));
+    proxy->source()->startUpdates();
+
+    const QDateTime first(QDate(2020, 5, 17), QTime(10, 0, 0), Qt::UTC);
+    const QDateTime second = first.addSecs(1);
+    QByteArray bytes;
+    bytes += QLocationTestUtils::createRmcSentence(first).toLatin1();             // new fix
+    bytes += QLocationTestUtils::createGgaSentence(first.time()).toLatin1();      // merged, same time
+    bytes += QLocationTestUtils::createGsaSentence().toLatin1();                  // merged, no time
+    bytes += QLocationTestUtils::createGgaSentence(10, 20, first.time().addSecs(-1)).toLatin1(); // discarded
+    bytes += QLocationTestUtils::createRmcSentence(second).toLatin1();            // new fix
+    proxy->feedBytes(bytes);
+
+    QTRY_COMPARE(spy.count(), 2);
+    QTest::qWait(100);
+    QCOMPARE(spy.count(), 2);
+
+    const QGeoPositionInfo merged = spy.at(0).at(0).value<QGeoPositionInfo>();
+    QCOMPARE(merged.timestamp(), first);
+    // the coordinate and altitude of the GGA sentence, not of the outdated one
+    QVERIFY(qAbs(merged.coordinate().latitude() + 27.579476) < 1e-5);
+    QCOMPARE(merged.coordinate().altitude(), 49.4);
+    QVERIFY(merged.hasAttribute(QGeoPositionInfo::GroundSpeed));
+    QVERIFY(merged.hasAttribute(QGeoPositionInfo::VerticalAccuracy));
+    QVERIFY(qFuzzyCompare(merged.attribute(QGeoPositionInfo::VerticalAccuracy), 40.8));
+
+    const QGeoPositionInfo next = spy.at(1).at(0).value<QGeoPositionInfo>();
+    QCOMPARE(next.timestamp(), second);
+    QVERIFY(qAbs(next.coordinate().latitude() + 27.513935) < 1e-5);
+}
+
 #include "tst_qnmeapositioninfosource_realtime.moc"
 
 QTEST_GUILESS_MAIN(tst_QNmeaPositionInfoSource_RealTime);
@@ -34,6 +34,7 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
 #include <QtCore/QtNumeric>
 
 #ifdef Q_OS_WIN
@@ -103,6 +104,105 @@ void tst_QNmeaPositionInfoSource::userEquivalentRangeError()
     QVERIFY(qFuzzyCompare(source.userEquivalentRangeError(), 5.1));
 }
 
+void tst_QNmeaPositionInfoSource::parseNmeaData()
+{
+    QNmeaPositionInfoSource source(m_mode);
+    QVERIFY(source.parseNmeaData(QByteArray()).isEmpty());
+
+    const QDateTime dt(QDate(2020, 1, 2), QTime(10, 0, 0, 100), Qt::UTC);
+    QByteArray data;
+    data += QLocationTestUtils::createRmcSentence(dt).toLatin1();
+    data += QLocationTestUtils::createGgaSentence(dt.time()).toLatin1();
+    data += QLocationTestUtils::createRmcSentence(dt.addMSecs(100)).toLatin1();
+    data += "garbage\r\n";
+    data += QLocationTestUtils::createGgaSentence(dt.addMSecs(200).time()).toLatin1();
+    data += QLocationTestUtils::createRmcSentence(dt.addMSecs(50)).toLatin1(); // outdated
+
+    QSignalSpy spyUpdate(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+    const QVector<QGeoPositionInfo> positions = source.parseNmeaData(data);
+    QCOMPARE(spyUpdate.count(), 0);
+
+    QCOMPARE(positions.size(), 3);
+    QCOMPARE(positions.at(0).timestamp(), dt);
+    // merged from both sentences with the same time
+    QVERIFY(positions.at(0).hasAttribute(QGeoPositionInfo::GroundSpeed));
+    QCOMPARE(positions.at(0).coordinate().altitude(), 49.4);
+    QCOMPARE(positions.at(1).timestamp(), dt.addMSecs(100));
+    // date carried over from the previous update
+    QCOMPARE(positions.at(2).timestamp(), dt.addMSecs(200));
+}
+
+void tst_QNmeaPositionInfoSource::replayMappedFile()
+{
+    if (m_mode != QNmeaPositionInfoSource::SimulationMode)
+        QSKIP("Replay is only supported in simulation mode");
+
+    const QDateTime dt(QDate(2020, 1, 2), QTime(10, 0, 0), Qt::UTC);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int i = 0; i < 3; ++i)
+        file.write(QLocationTestUtils::createRmcSentence(dt.addSecs(i * 10)).toLatin1());
+    QVERIFY(file.seek(0));
+
+    QNmeaPositionInfoSource source(m_mode);
+    source.setDevice(&file);
+    QVERIFY(source.setBackendProperty(QStringLiteral("nmea.playback_rate"), 0.0));
+    QVERIFY(!source.setBackendProperty(QStringLiteral("nmea.playback_rate"), -1.0));
+    QCOMPARE(source.backendProperty(QStringLiteral("nmea.playback_rate")).toReal(), 0.0);
+    QVERIFY(source.setBackendProperty(QStringLiteral("nmea.playback_position"), dt.addSecs(5)));
+
+    QSignalSpy spyUpdate(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+    source.startUpdates();
+    // starts at the first update after the requested position, without waiting 10s
+    QTRY_COMPARE(spyUpdate.count(), 2);
+    QCOMPARE(spyUpdate.at(0).at(0).value<QGeoPositionInfo>().timestamp(), dt.addSecs(10));
+    QCOMPARE(spyUpdate.at(1).at(0).value<QGeoPositionInfo>().timestamp(), dt.addSecs(20));
+    QCOMPARE(source.backendProperty(QStringLiteral("nmea.playback_position")).toDateTime(),
+             dt.addSecs(20));
+
+    // seeking back replays again
+    spyUpdate.clear();
+    QVERIFY(source.setBackendProperty(QStringLiteral("nmea.playback_position"), dt));
+    QTRY_COMPARE(spyUpdate.count(), 3);
+    QCOMPARE(spyUpdate.at(0).at(0).value<QGeoPositionInfo>().timestamp(), dt);
+    QVERIFY(!source.setBackendProperty(QStringLiteral("nmea.playback_position"), dt.addSecs(30)));
+}
+
+void tst_QNmeaPositionInfoSource::readInWorkerThread()
+{
+    if (m_mode != QNmeaPositionInfoSource::RealTimeMode)
+        QSKIP("Worker threads are only supported in real time mode");
+
+    const QDateTime dt(QDate(2020, 1, 2), QTime(10, 0, 0), Qt::UTC);
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    {
+        QNmeaPositionInfoSource source(m_mode);
+        source.setDevice(&buffer);
+        QVERIFY(!source.setBackendProperty(QStringLiteral("nmea.update_queue_size"), 0));
+        QVERIFY(source.setBackendProperty(QStringLiteral("nmea.update_queue_size"), 4));
+        QVERIFY(source.setBackendProperty(QStringLiteral("nmea.worker_thread"), true));
+        QCOMPARE(source.backendProperty(QStringLiteral("nmea.worker_thread")).toBool(), true);
+
+        QSignalSpy spyUpdate(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.startUpdates();
+        QVERIFY(buffer.thread() != QThread::currentThread());
+        QVERIFY(!source.setBackendProperty(QStringLiteral("nmea.worker_thread"), false));
+
+        // the buffer may only be used from the worker thread now
+        QMetaObject::invokeMethod(&buffer, [&buffer, dt]() {
+            for (int i = 0; i < 3; ++i)
+                buffer.write(QLocationTestUtils::createRmcSentence(dt.addSecs(i)).toLatin1());
+            buffer.seek(0);
+        }, Qt::BlockingQueuedConnection);
+
+        QTRY_COMPARE(spyUpdate.count(), 3);
+        for (int i = 0; i < 3; ++i)
+            QCOMPARE(spyUpdate.at(i).at(0).value<QGeoPositionInfo>().timestamp(), dt.addSecs(i));
+    }
+    QCOMPARE(buffer.thread(), QThread::currentThread());
+}
+
 void tst_QNmeaPositionInfoSource::setUpdateInterval_delayedUpdate()
 {
     // If an update interval is set, and an update is not available at a
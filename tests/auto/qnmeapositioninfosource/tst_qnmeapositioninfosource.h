@@ -88,6 +88,12 @@ private slots:
 
     void userEquivalentRangeError();
 
+    void parseNmeaData();
+
+    void replayMappedFile();
+
+    void readInWorkerThread();
+
     void setUpdateInterval_delayedUpdate();
 
     void lastKnownPosition();
@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qnmeasatellitetable
+
+plugin.path = ../../../src/plugins/position/serialnmea/
+
+SOURCES += tst_qnmeasatellitetable.cpp \
+           $$plugin.path/qnmeasatellitetable.cpp
+HEADERS += $$plugin.path/qnmeasatellitetable_p.h
+INCLUDEPATH += $$plugin.path
+
+QT += positioning positioning-private testlib
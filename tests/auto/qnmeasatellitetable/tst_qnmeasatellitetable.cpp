@@ -0,0 +1,243 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoSatelliteInfo>
+#include "qnmeasatellitetable_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QNmeaSatelliteTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void firstUpdate();
+    void steadyUpdate();
+    void changedSatellite();
+    void changedUse();
+    void removal();
+    void duplicates();
+    void systems();
+    void clear();
+
+private:
+    static QGeoSatelliteInfo satellite(int number, int signal = 30,
+                                       QGeoSatelliteInfo::SatelliteSystem system = QGeoSatelliteInfo::GPS);
+    static QVector<int> numbers(const QNmeaSatelliteTable &table);
+};
+
+QGeoSatelliteInfo tst_QNmeaSatelliteTable::satellite(int number, int signal,
+                                                     QGeoSatelliteInfo::SatelliteSystem system)
+{
+    QGeoSatelliteInfo info;
+    info.setSatelliteSystem(system);
+    info.setSatelliteIdentifier(number);
+    info.setSignalStrength(signal);
+    info.setAttribute(QGeoSatelliteInfo::Elevation, 45.0);
+    return info;
+}
+
+QVector<int> tst_QNmeaSatelliteTable::numbers(const QNmeaSatelliteTable &table)
+{
+    QVector<int> result;
+    for (int i = 0; i < table.count(); ++i)
+        result.append(table.at(i).info.satelliteIdentifier());
+    return result;
+}
+
+void tst_QNmeaSatelliteTable::firstUpdate()
+{
+    QNmeaSatelliteTable table;
+    const QNmeaSatelliteTable::ChangeSet &changes =
+            table.update({ satellite(12), satellite(3), satellite(7) }, { satellite(7) });
+    QVERIFY(changes.inViewChanged);
+    QVERIFY(changes.inUseChanged);
+    QVERIFY(changes.removed.isEmpty());
+    QCOMPARE(changes.updated, QVector<int>({ 0, 1, 2 }));
+
+    // sorted by number
+    QCOMPARE(numbers(table), QVector<int>({ 3, 7, 12 }));
+    QCOMPARE(table.at(1).info, satellite(7));
+    QVERIFY(!table.at(0).inUse);
+    QVERIFY(table.at(1).inUse);
+    QVERIFY(!table.at(2).inUse);
+    QCOMPARE(table.indexOf(QNmeaSatelliteTable::key(satellite(12))), 2);
+    QCOMPARE(table.indexOf(QNmeaSatelliteTable::key(satellite(5))), -1);
+}
+
+void tst_QNmeaSatelliteTable::steadyUpdate()
+{
+    QNmeaSatelliteTable table;
+    table.update({ satellite(3), satellite(7) }, { satellite(7) });
+
+    // in another order, still nothing changed
+    const QNmeaSatelliteTable::ChangeSet &changes =
+            table.update({ satellite(7), satellite(3) }, { satellite(7) });
+    QVERIFY(changes.isEmpty());
+    QVERIFY(changes.updated.isEmpty());
+    QVERIFY(changes.removed.isEmpty());
+    QCOMPARE(numbers(table), QVector<int>({ 3, 7 }));
+    QVERIFY(!table.at(0).changed);
+}
+
+void tst_QNmeaSatelliteTable::changedSatellite()
+{
+    QNmeaSatelliteTable table;
+    table.update({ satellite(3), satellite(7) }, { satellite(7) });
+
+    // a satellite in view only
+    const QNmeaSatelliteTable::ChangeSet *changes =
+            &table.update({ satellite(3, 20), satellite(7) }, { satellite(7) });
+    QVERIFY(changes->inViewChanged);
+    QVERIFY(!changes->inUseChanged);
+    QCOMPARE(changes->updated, QVector<int>({ 0 }));
+    QCOMPARE(table.at(0).info.signalStrength(), 20);
+
+    // one in use too
+    changes = &table.update({ satellite(3, 20), satellite(7, 40) }, { satellite(7) });
+    QVERIFY(changes->inViewChanged);
+    QVERIFY(changes->inUseChanged);
+    QCOMPARE(changes->updated, QVector<int>({ 1 }));
+    QCOMPARE(table.at(1).info, satellite(7, 40));
+}
+
+void tst_QNmeaSatelliteTable::changedUse()
+{
+    QNmeaSatelliteTable table;
+    table.update({ satellite(3), satellite(7), satellite(12) }, { satellite(7) });
+
+    const QNmeaSatelliteTable::ChangeSet &changes =
+            table.update({ satellite(3), satellite(7), satellite(12) }, { satellite(3), satellite(12) });
+    QVERIFY(!changes.inViewChanged);
+    QVERIFY(changes.inUseChanged);
+    QCOMPARE(changes.updated, QVector<int>({ 0, 1, 2 }));
+    QVERIFY(table.at(0).inUse);
+    QVERIFY(!table.at(1).inUse);
+    QVERIFY(table.at(1).wasInUse);
+    QVERIFY(table.at(2).inUse);
+
+    // satellites in use but not in view are ignored
+    table.update({ satellite(3), satellite(7), satellite(12) }, { satellite(3), satellite(12), satellite(20) });
+    QCOMPARE(table.count(), 3);
+    QCOMPARE(table.indexOf(QNmeaSatelliteTable::key(satellite(20))), -1);
+}
+
+// The entries left are moved down over those removed, in order and with their state
+void tst_QNmeaSatelliteTable::removal()
+{
+    QNmeaSatelliteTable table;
+    table.update({ satellite(1), satellite(3, 10), satellite(5), satellite(7, 20), satellite(9, 25) },
+                 { satellite(5), satellite(9, 25) });
+
+    const QNmeaSatelliteTable::ChangeSet *changes =
+            &table.update({ satellite(3, 10), satellite(7, 20), satellite(9, 25) }, { satellite(9, 25) });
+    QVERIFY(changes->inViewChanged);
+    QVERIFY(changes->inUseChanged); // 5 was in use
+    QCOMPARE(changes->removed.size(), 2);
+    QCOMPARE(changes->removed.at(0), satellite(1));
+    QCOMPARE(changes->removed.at(1), satellite(5));
+    QVERIFY(changes->updated.isEmpty());
+
+    QCOMPARE(numbers(table), QVector<int>({ 3, 7, 9 }));
+    QCOMPARE(table.at(0).info, satellite(3, 10));
+    QCOMPARE(table.at(1).info, satellite(7, 20));
+    QCOMPARE(table.at(2).info, satellite(9, 25));
+    QCOMPARE(table.at(2).key, QNmeaSatelliteTable::key(satellite(9)));
+    QVERIFY(!table.at(0).inUse);
+    QVERIFY(!table.at(1).inUse);
+    QVERIFY(table.at(2).inUse);
+    QCOMPARE(table.indexOf(QNmeaSatelliteTable::key(satellite(7))), 1);
+    QCOMPARE(table.indexOf(QNmeaSatelliteTable::key(satellite(5))), -1);
+
+    // removing one not in use leaves the use unchanged, adding it back reuses the room
+    changes = &table.update({ satellite(7, 20), satellite(9, 25) }, { satellite(9, 25) });
+    QVERIFY(!changes->inUseChanged);
+    QCOMPARE(changes->removed.size(), 1);
+    QCOMPARE(changes->removed.at(0), satellite(3, 10));
+    changes = &table.update({ satellite(1), satellite(7, 20), satellite(9, 25) }, { satellite(9, 25) });
+    QVERIFY(changes->removed.isEmpty());
+    QCOMPARE(changes->updated, QVector<int>({ 0 }));
+    QCOMPARE(numbers(table), QVector<int>({ 1, 7, 9 }));
+    QVERIFY(table.at(2).inUse);
+
+    // and nothing in view empties the table
+    changes = &table.update({}, {});
+    QCOMPARE(changes->removed.size(), 3);
+    QVERIFY(changes->inUseChanged);
+    QCOMPARE(table.count(), 0);
+}
+
+// The first of several entries for a satellite wins
+void tst_QNmeaSatelliteTable::duplicates()
+{
+    QNmeaSatelliteTable table;
+    table.update({ satellite(3, 10), satellite(3, 40) }, {});
+    QCOMPARE(table.count(), 1);
+    QCOMPARE(table.at(0).info.signalStrength(), 10);
+
+    const QNmeaSatelliteTable::ChangeSet &changes = table.update({ satellite(3, 10), satellite(3, 40) }, {});
+    QVERIFY(changes.isEmpty());
+}
+
+// Satellites are told apart by system and number
+void tst_QNmeaSatelliteTable::systems()
+{
+    QNmeaSatelliteTable table;
+    table.update({ satellite(3, 30, QGeoSatelliteInfo::GLONASS), satellite(3), satellite(70, 30, QGeoSatelliteInfo::GLONASS) },
+                 { satellite(3, 30, QGeoSatelliteInfo::GLONASS) });
+    QCOMPARE(table.count(), 3);
+    QCOMPARE(table.at(0).info.satelliteSystem(), QGeoSatelliteInfo::GPS);
+    QCOMPARE(table.at(1).info, satellite(3, 30, QGeoSatelliteInfo::GLONASS));
+    QCOMPARE(table.at(2).info.satelliteIdentifier(), 70);
+    QVERIFY(!table.at(0).inUse);
+    QVERIFY(table.at(1).inUse);
+
+    table.update({ satellite(3, 30, QGeoSatelliteInfo::GLONASS), satellite(70, 30, QGeoSatelliteInfo::GLONASS) },
+                 { satellite(3, 30, QGeoSatelliteInfo::GLONASS) });
+    QCOMPARE(table.count(), 2);
+    QCOMPARE(table.indexOf(QNmeaSatelliteTable::key(satellite(3))), -1);
+    QCOMPARE(table.indexOf(QNmeaSatelliteTable::key(satellite(3, 0, QGeoSatelliteInfo::GLONASS))), 0);
+}
+
+void tst_QNmeaSatelliteTable::clear()
+{
+    QNmeaSatelliteTable table;
+    table.update({ satellite(3), satellite(7) }, { satellite(7) });
+    table.clear();
+    QCOMPARE(table.count(), 0);
+
+    // everything is new again
+    const QNmeaSatelliteTable::ChangeSet &changes = table.update({ satellite(3), satellite(7) }, { satellite(7) });
+    QCOMPARE(changes.updated, QVector<int>({ 0, 1 }));
+    QVERIFY(changes.inUseChanged);
+}
+
+QTEST_MAIN(tst_QNmeaSatelliteTable)
+
+#include "tst_qnmeasatellitetable.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qplacecategorycache
+
+SOURCES += tst_qplacecategorycache.cpp
+
+QT += location location-private testlib
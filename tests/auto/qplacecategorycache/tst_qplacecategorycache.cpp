@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QLocale>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <QtLocation/QPlaceIcon>
+#include <QtLocation/private/qplacecategorycache_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QPlaceCategoryCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void roundTrip();
+    void key();
+    void expiry();
+    void corruptFile();
+
+private:
+    void tree(QHash<QString, QPlaceCategory> &categories, QHash<QString, QStringList> &subcategories) const;
+
+    QScopedPointer<QTemporaryDir> m_directory;
+    const QList<QLocale> m_locales { QLocale(QLocale::German, QLocale::Germany),
+                                     QLocale(QLocale::English, QLocale::UnitedKingdom) };
+};
+
+void tst_QPlaceCategoryCache::init()
+{
+    m_directory.reset(new QTemporaryDir);
+    QVERIFY(m_directory->isValid());
+}
+
+// Two top level categories, one of them with a child
+void tst_QPlaceCategoryCache::tree(QHash<QString, QPlaceCategory> &categories,
+                                   QHash<QString, QStringList> &subcategories) const
+{
+    QPlaceCategory food;
+    food.setCategoryId(QStringLiteral("food"));
+    food.setName(QStringLiteral("Food"));
+    food.setVisibility(QLocation::PublicVisibility);
+    QPlaceIcon icon;
+    icon.setParameters({ { QPlaceIcon::SingleUrl, QUrl(QStringLiteral("http://example.com/food.png")) } });
+    food.setIcon(icon);
+
+    QPlaceCategory bakery;
+    bakery.setCategoryId(QStringLiteral("bakery"));
+    bakery.setName(QStringLiteral("Baeckerei"));
+
+    QPlaceCategory park;
+    park.setCategoryId(QStringLiteral("park"));
+    park.setName(QStringLiteral("Park"));
+
+    categories = { { food.categoryId(), food }, { bakery.categoryId(), bakery },
+                   { park.categoryId(), park } };
+    subcategories = { { QString(), { food.categoryId(), park.categoryId() } },
+                      { food.categoryId(), { bakery.categoryId() } } };
+}
+
+void tst_QPlaceCategoryCache::roundTrip()
+{
+    QHash<QString, QPlaceCategory> categories;
+    QHash<QString, QStringList> subcategories;
+    tree(categories, subcategories);
+
+    QPlaceCategoryCache cache(QStringLiteral("test"), m_locales);
+    cache.setDirectory(m_directory->path());
+    QVERIFY(cache.fileName().startsWith(m_directory->path() + QLatin1String("/test/")));
+    QVERIFY(!cache.load());
+    QVERIFY(cache.isExpired());
+
+    QVERIFY(cache.save(categories, subcategories));
+    QVERIFY(QFile::exists(cache.fileName()));
+    QVERIFY(!cache.isExpired());
+
+    QPlaceCategoryCache other(QStringLiteral("test"), m_locales);
+    other.setDirectory(m_directory->path());
+    QVERIFY(other.load());
+    QVERIFY(!other.isExpired());
+    QCOMPARE(other.timestamp(), cache.timestamp());
+    QCOMPARE(other.subcategories(), subcategories);
+    QCOMPARE(other.categories().size(), categories.size());
+    for (const QPlaceCategory &category : categories) {
+        const QPlaceCategory loaded = other.categories().value(category.categoryId());
+        QCOMPARE(loaded.name(), category.name());
+        QCOMPARE(loaded.visibility(), category.visibility());
+        QCOMPARE(loaded.icon().parameters(), category.icon().parameters());
+    }
+}
+
+// Trees are stored per provider and list of locales
+void tst_QPlaceCategoryCache::key()
+{
+    QHash<QString, QPlaceCategory> categories;
+    QHash<QString, QStringList> subcategories;
+    tree(categories, subcategories);
+
+    QPlaceCategoryCache cache(QStringLiteral("test"), m_locales);
+    cache.setDirectory(m_directory->path());
+    QVERIFY(cache.save(categories, subcategories));
+
+    QPlaceCategoryCache provider(QStringLiteral("other"), m_locales);
+    provider.setDirectory(m_directory->path());
+    QVERIFY(!provider.load());
+    QVERIFY(provider.categories().isEmpty());
+
+    QPlaceCategoryCache locales(QStringLiteral("test"), { QLocale(QLocale::German, QLocale::Germany) });
+    locales.setDirectory(m_directory->path());
+    QVERIFY(locales.fileName() != cache.fileName());
+    QVERIFY(!locales.load());
+
+    // A file written for another key is not used, even if it is in the place of this one
+    QVERIFY(QFile::copy(cache.fileName(), locales.fileName()));
+    QVERIFY(!locales.load());
+    QVERIFY(locales.categories().isEmpty());
+}
+
+void tst_QPlaceCategoryCache::expiry()
+{
+    QPlaceCategoryCache cache(QStringLiteral("test"), m_locales);
+    cache.setDirectory(m_directory->path());
+    QVERIFY(QDir().mkpath(m_directory->path() + QLatin1String("/test")));
+
+    // Written by hand, as save() stamps the current time
+    const auto write = [&](const QDateTime &timestamp) {
+        QFile file(cache.fileName());
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_15);
+        stream << quint32(0x43435051) << quint32(1) << QStringLiteral("test")
+               << QStringLiteral("de_DE-en_GB") << timestamp << qint32(0);
+    };
+
+    write(QDateTime::currentDateTimeUtc().addSecs(-2 * 60 * 60));
+    QVERIFY(cache.load());
+    QVERIFY(!cache.isExpired());
+
+    write(QDateTime::currentDateTimeUtc().addDays(-2));
+    QVERIFY(cache.load());
+    QVERIFY(cache.isExpired());
+}
+
+void tst_QPlaceCategoryCache::corruptFile()
+{
+    QHash<QString, QPlaceCategory> categories;
+    QHash<QString, QStringList> subcategories;
+    tree(categories, subcategories);
+
+    QPlaceCategoryCache cache(QStringLiteral("test"), m_locales);
+    cache.setDirectory(m_directory->path());
+    QVERIFY(cache.save(categories, subcategories));
+
+    QFile file(cache.fileName());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const QByteArray data = file.readAll();
+
+    // A truncated tree is dropped
+    QVERIFY(file.resize(data.size() - 4));
+    file.close();
+    QVERIFY(!cache.load());
+    QVERIFY(cache.categories().isEmpty());
+    QVERIFY(cache.subcategories().isEmpty());
+    QVERIFY(cache.isExpired());
+
+    // So is a file of another format version
+    QByteArray version = data;
+    version[7] = char(2);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(version);
+    file.close();
+    QVERIFY(!cache.load());
+
+    // Saving replaces it
+    QVERIFY(cache.save(categories, subcategories));
+    QVERIFY(cache.load());
+    QCOMPARE(cache.subcategories(), subcategories);
+}
+
+QTEST_GUILESS_MAIN(tst_QPlaceCategoryCache)
+
+#include "tst_qplacecategorycache.moc"
@@ -0,0 +1,14 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qplacemanager_localplaces
+
+SOURCES += \
+    tst_qplacemanager_localplaces.cpp
+
+OTHER_FILES += \
+    places.osm \
+    places.geojson
+
+TESTDATA = $$OTHER_FILES
+
+QT += positioning testlib location
@@ -0,0 +1,314 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/QPlaceManager>
+#include <QtLocation/QPlaceDetailsReply>
+#include <QtLocation/QPlaceResult>
+#include <QtLocation/QPlaceSearchReply>
+#include <QtLocation/QPlaceSearchRequest>
+#include <QtLocation/QPlaceSearchSuggestionReply>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoRectangle>
+
+QT_USE_NAMESPACE
+
+class tst_QPlaceManagerLocalPlaces : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void missingFiles();
+    void categories();
+    void searchTerm_data();
+    void searchTerm();
+    void searchArea();
+    void searchCategory();
+    void paging();
+    void suggestions();
+    void details();
+    void geoJson();
+
+private:
+    QStringList searchTitles(const QPlaceSearchRequest &request, QPlaceSearchReply **reply = nullptr);
+
+    QGeoServiceProvider *m_provider = nullptr;
+    QPlaceManager *m_placeManager = nullptr;
+};
+
+void tst_QPlaceManagerLocalPlaces::initTestCase()
+{
+    qRegisterMetaType<QPlaceReply *>();
+
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("localplaces.files"), QFINDTESTDATA("places.osm"));
+    m_provider = new QGeoServiceProvider(QStringLiteral("localplaces"), parameters);
+    QCOMPARE(m_provider->error(), QGeoServiceProvider::NoError);
+    m_placeManager = m_provider->placeManager();
+    QVERIFY(m_placeManager);
+}
+
+void tst_QPlaceManagerLocalPlaces::cleanupTestCase()
+{
+    delete m_provider;
+}
+
+void tst_QPlaceManagerLocalPlaces::missingFiles()
+{
+    QGeoServiceProvider provider(QStringLiteral("localplaces"));
+    QVERIFY(!provider.placeManager());
+    QCOMPARE(provider.error(), QGeoServiceProvider::MissingRequiredParameterError);
+
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("localplaces.files"), QStringLiteral("does-not-exist.osm"));
+    QGeoServiceProvider missingProvider(QStringLiteral("localplaces"), parameters);
+    QVERIFY(!missingProvider.placeManager());
+    QCOMPARE(missingProvider.error(), QGeoServiceProvider::ConnectionError);
+}
+
+void tst_QPlaceManagerLocalPlaces::categories()
+{
+    QPlaceReply *reply = m_placeManager->initializeCategories();
+    QSignalSpy finishedSpy(reply, &QPlaceReply::finished);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(reply->error(), QPlaceReply::NoError);
+    delete reply;
+
+    // the bench has no name, so it is no place
+    QCOMPARE(m_placeManager->childCategoryIds(),
+             QStringList() << QStringLiteral("books") << QStringLiteral("cafe")
+                           << QStringLiteral("pharmacy"));
+    QCOMPARE(m_placeManager->category(QStringLiteral("cafe")).name(), QStringLiteral("Cafe"));
+}
+
+void tst_QPlaceManagerLocalPlaces::searchTerm_data()
+{
+    QTest::addColumn<QString>("searchTerm");
+    QTest::addColumn<QStringList>("titles");
+
+    QTest::newRow("word") << QStringLiteral("central")
+                          << (QStringList() << QStringLiteral("Cafe Central") << QStringLiteral("Central Pharmacy"));
+    QTest::newRow("case") << QStringLiteral("CENTRAL PHARMACY")
+                          << (QStringList() << QStringLiteral("Central Pharmacy"));
+    QTest::newRow("prefix") << QStringLiteral("caf")
+                            << (QStringList() << QStringLiteral("Cafe Central") << QStringLiteral("Café Luna"));
+    QTest::newRow("words") << QStringLiteral("central caf")
+                           << (QStringList() << QStringLiteral("Cafe Central"));
+    QTest::newRow("not a prefix") << QStringLiteral("caf central") << QStringList();
+    QTest::newRow("no match") << QStringLiteral("museum") << QStringList();
+}
+
+void tst_QPlaceManagerLocalPlaces::searchTerm()
+{
+    QFETCH(QString, searchTerm);
+    QFETCH(QStringList, titles);
+
+    QPlaceSearchRequest request;
+    request.setSearchTerm(searchTerm);
+    QCOMPARE(searchTitles(request), titles);
+}
+
+void tst_QPlaceManagerLocalPlaces::searchArea()
+{
+    QPlaceSearchRequest request;
+    request.setSearchArea(QGeoCircle(QGeoCoordinate(59.9130, 10.7400), 2000));
+
+    QPlaceSearchReply *reply = nullptr;
+    QCOMPARE(searchTitles(request, &reply),
+             QStringList() << QStringLiteral("Cafe Central") << QStringLiteral("Central Pharmacy")
+                           << QStringLiteral("Café Luna"));
+    QCOMPARE(QPlaceResult(reply->results().first()).distance(), 0.0);
+    QVERIFY(QPlaceResult(reply->results().last()).distance() > 500);
+    delete reply;
+
+    // without a radius, the circle only orders the places
+    request.setSearchArea(QGeoCircle(QGeoCoordinate(59.9500, 10.8000)));
+    request.setSearchTerm(QStringLiteral("c"));
+    QCOMPARE(searchTitles(request),
+             QStringList() << QStringLiteral("Book Corner") << QStringLiteral("Café Luna")
+                           << QStringLiteral("Central Pharmacy") << QStringLiteral("Cafe Central"));
+}
+
+void tst_QPlaceManagerLocalPlaces::searchCategory()
+{
+    QPlaceCategory cafe;
+    cafe.setCategoryId(QStringLiteral("cafe"));
+
+    QPlaceSearchRequest request;
+    request.setCategory(cafe);
+    QCOMPARE(searchTitles(request),
+             QStringList() << QStringLiteral("Cafe Central") << QStringLiteral("Café Luna"));
+
+    request.setSearchTerm(QStringLiteral("central"));
+    QCOMPARE(searchTitles(request), QStringList() << QStringLiteral("Cafe Central"));
+}
+
+void tst_QPlaceManagerLocalPlaces::paging()
+{
+    QPlaceSearchRequest request;
+    request.setSearchTerm(QStringLiteral("central"));
+    request.setLimit(1);
+
+    QPlaceSearchReply *reply = nullptr;
+    QCOMPARE(searchTitles(request, &reply), QStringList() << QStringLiteral("Cafe Central"));
+    QCOMPARE(reply->previousPageRequest(), QPlaceSearchRequest());
+    const QPlaceSearchRequest next = reply->nextPageRequest();
+    QVERIFY(next != QPlaceSearchRequest());
+    delete reply;
+
+    QCOMPARE(searchTitles(next, &reply), QStringList() << QStringLiteral("Central Pharmacy"));
+    QVERIFY(reply->previousPageRequest() != QPlaceSearchRequest());
+    QCOMPARE(reply->nextPageRequest(), QPlaceSearchRequest());
+    delete reply;
+}
+
+void tst_QPlaceManagerLocalPlaces::suggestions()
+{
+    QPlaceSearchRequest request;
+    request.setSearchTerm(QStringLiteral("ce"));
+
+    QPlaceSearchSuggestionReply *reply = m_placeManager->searchSuggestions(request);
+    QSignalSpy finishedSpy(reply, &QPlaceReply::finished);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(reply->suggestions(),
+             QStringList() << QStringLiteral("Cafe Central") << QStringLiteral("Central Pharmacy"));
+    delete reply;
+}
+
+void tst_QPlaceManagerLocalPlaces::details()
+{
+    QPlaceDetailsReply *reply = m_placeManager->getPlaceDetails(QStringLiteral("node/1"));
+    QSignalSpy finishedSpy(reply, &QPlaceReply::finished);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(reply->error(), QPlaceReply::NoError);
+    const QPlace place = reply->place();
+    QCOMPARE(place.name(), QStringLiteral("Cafe Central"));
+    QCOMPARE(place.location().address().street(), QStringLiteral("Karl Johans gate 1"));
+    QCOMPARE(place.location().address().city(), QStringLiteral("Oslo"));
+    QCOMPARE(place.contactDetails(QPlaceContactDetail::Phone).first().value(),
+             QStringLiteral("+47 22 00 00 00"));
+    delete reply;
+
+    reply = m_placeManager->getPlaceDetails(QStringLiteral("node/5"));
+    QSignalSpy errorSpy(reply, SIGNAL(error(QPlaceReply::Error,QString)));
+    QTRY_COMPARE(errorSpy.count(), 1);
+    QCOMPARE(reply->error(), QPlaceReply::PlaceDoesNotExistError);
+    delete reply;
+}
+
+void tst_QPlaceManagerLocalPlaces::geoJson()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("localplaces.files"),
+                      QStringList() << QFINDTESTDATA("places.osm") << QFINDTESTDATA("places.geojson"));
+    QGeoServiceProvider provider(QStringLiteral("localplaces"), parameters);
+    QPlaceManager *placeManager = provider.placeManager();
+    if (!placeManager)
+        QSKIP("The localplaces plugin was built without GeoJSON support");
+    qSwap(m_placeManager, placeManager);
+
+    // Features of both files are indexed, by the OpenStreetMap keys and the
+    // category property
+    QPlaceReply *reply = m_placeManager->initializeCategories();
+    QTRY_VERIFY(reply->isFinished());
+    delete reply;
+    QCOMPARE(m_placeManager->childCategoryIds(),
+             QStringList() << QStringLiteral("books") << QStringLiteral("cafe")
+                           << QStringLiteral("food") << QStringLiteral("kiosk")
+                           << QStringLiteral("park") << QStringLiteral("pharmacy"));
+
+    QPlaceSearchRequest request;
+    request.setSearchTerm(QStringLiteral("harbour"));
+    QPlaceSearchReply *searchReply = nullptr;
+    QCOMPARE(searchTitles(request, &searchReply), QStringList() << QStringLiteral("Harbour Kiosk"));
+    const QPlace kiosk = QPlaceResult(searchReply->results().first()).place();
+    delete searchReply;
+    QCOMPARE(kiosk.placeId(), QStringLiteral("kiosk-1"));
+    QCOMPARE(kiosk.location().coordinate(), QGeoCoordinate(59.9080, 10.7300));
+    QCOMPARE(kiosk.location().address().street(), QStringLiteral("Akershusstranda 1"));
+
+    // Polygons are placed at their center, features without an id are numbered
+    QPlaceCategory park;
+    park.setCategoryId(QStringLiteral("park"));
+    request = QPlaceSearchRequest();
+    request.setCategory(park);
+    QCOMPARE(searchTitles(request, &searchReply), QStringList() << QStringLiteral("Palace Park"));
+    const QPlace palacePark = QPlaceResult(searchReply->results().first()).place();
+    delete searchReply;
+    QVERIFY(palacePark.placeId().startsWith(QLatin1String("feature/")));
+    QCOMPARE(palacePark.location().coordinate().latitude(), 59.9250);
+    QCOMPARE(palacePark.location().coordinate().longitude(), 10.7050);
+
+    // A rectangle only takes the places inside it
+    request = QPlaceSearchRequest();
+    request.setSearchArea(QGeoRectangle(QGeoCoordinate(59.9140, 10.7250), QGeoCoordinate(59.9000, 10.7450)));
+    QCOMPARE(searchTitles(request), QStringList() << QStringLiteral("Harbour Kiosk")
+                                                  << QStringLiteral("Cafe Central")
+                                                  << QStringLiteral("Central Pharmacy"));
+
+    qSwap(m_placeManager, placeManager);
+}
+
+/*
+    Returns the titles of the results of \a request, and the finished reply
+    in \a reply if given.
+*/
+QStringList tst_QPlaceManagerLocalPlaces::searchTitles(const QPlaceSearchRequest &request,
+                                                       QPlaceSearchReply **reply)
+{
+    QPlaceSearchReply *searchReply = m_placeManager->search(request);
+    QSignalSpy finishedSpy(searchReply, &QPlaceReply::finished);
+    QSignalSpy managerFinishedSpy(m_placeManager, &QPlaceManager::finished);
+    finishedSpy.wait(1000);
+    if (managerFinishedSpy.isEmpty())
+        managerFinishedSpy.wait(1000);
+    if (finishedSpy.count() != 1 || managerFinishedSpy.count() != 1
+            || searchReply->error() != QPlaceReply::NoError) {
+        delete searchReply;
+        return QStringList() << QStringLiteral("search failed");
+    }
+
+    QStringList titles;
+    const QList<QPlaceSearchResult> results = searchReply->results();
+    for (const QPlaceSearchResult &result : results)
+        titles.append(result.title());
+
+    if (reply)
+        *reply = searchReply;
+    else
+        delete searchReply;
+    return titles;
+}
+
+QTEST_GUILESS_MAIN(tst_QPlaceManagerLocalPlaces)
+
+#include "tst_qplacemanager_localplaces.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qwebmercator
+
+SOURCES += tst_qwebmercator.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qgeopackedcoordinate_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QWebMercator : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void batchMatchesScalar_data();
+    void batchMatchesScalar();
+    void roundTrip();
+    void listOverloads();
+
+private:
+    static QList<QGeoCoordinate> coordinates(int count);
+};
+
+// Deterministic, and away from the poles where Web Mercator is clamped
+QList<QGeoCoordinate> tst_QWebMercator::coordinates(int count)
+{
+    QRandomGenerator random(42);
+    QList<QGeoCoordinate> result;
+    for (int i = 0; i < count; ++i) {
+        result.append(QGeoCoordinate(random.bounded(170.0) - 85.0,
+                                     random.bounded(359.0) - 179.5));
+    }
+    return result;
+}
+
+void tst_QWebMercator::batchMatchesScalar_data()
+{
+    QTest::addColumn<int>("count");
+    // Counts that are not multiples of the vector width exercise the tails
+    QTest::newRow("empty") << 0;
+    QTest::newRow("one") << 1;
+    QTest::newRow("three") << 3;
+    QTest::newRow("seventeen") << 17;
+    QTest::newRow("thousand and one") << 1001;
+}
+
+void tst_QWebMercator::batchMatchesScalar()
+{
+    QFETCH(int, count);
+    const QGeoPackedCoordinates packed = qPackCoordinates(coordinates(count));
+    QVector<double> mercator(2 * count + 1, -1.0);
+    QWebMercator::coordToMercator(packed, mercator.data());
+
+    for (int i = 0; i < count; ++i) {
+        const QDoubleVector2D expected = QWebMercator::coordToMercator(packed.at(i).latitude,
+                                                                       packed.at(i).longitude);
+        QVERIFY2(qAbs(mercator.at(2 * i) - expected.x()) < 1e-12, qPrintable(QString::number(i)));
+        QVERIFY2(qAbs(mercator.at(2 * i + 1) - expected.y()) < 1e-12, qPrintable(QString::number(i)));
+    }
+    // Nothing is written past the pairs of the coordinates
+    QCOMPARE(mercator.last(), -1.0);
+}
+
+void tst_QWebMercator::roundTrip()
+{
+    const int count = 257;
+    const QGeoPackedCoordinates packed = qPackCoordinates(coordinates(count));
+    QVector<double> mercator(2 * count);
+    QWebMercator::coordToMercator(packed, mercator.data());
+    QGeoPackedCoordinates back(count);
+    QWebMercator::mercatorToCoord(mercator.constData(), count, back.data());
+
+    for (int i = 0; i < count; ++i) {
+        const QGeoCoordinate scalar = QWebMercator::mercatorToCoord(
+                    QDoubleVector2D(mercator.at(2 * i), mercator.at(2 * i + 1)));
+        QVERIFY(qAbs(back.at(i).latitude - packed.at(i).latitude) < 1e-9);
+        QVERIFY(qAbs(back.at(i).longitude - packed.at(i).longitude) < 1e-9);
+        QVERIFY(qAbs(back.at(i).latitude - scalar.latitude()) < 1e-9);
+        QVERIFY(qAbs(back.at(i).longitude - scalar.longitude()) < 1e-9);
+    }
+}
+
+void tst_QWebMercator::listOverloads()
+{
+    const QList<QGeoCoordinate> input = coordinates(9);
+    const QList<QDoubleVector2D> mercator = QWebMercator::coordToMercator(input);
+    QCOMPARE(mercator.size(), input.size());
+    for (int i = 0; i < input.size(); ++i) {
+        const QDoubleVector2D expected = QWebMercator::coordToMercator(input.at(i));
+        QVERIFY(qAbs(mercator.at(i).x() - expected.x()) < 1e-12);
+        QVERIFY(qAbs(mercator.at(i).y() - expected.y()) < 1e-12);
+    }
+
+    const QList<QGeoCoordinate> back = QWebMercator::mercatorToCoord(mercator);
+    QCOMPARE(back.size(), input.size());
+    for (int i = 0; i < input.size(); ++i) {
+        QVERIFY(qAbs(back.at(i).latitude() - input.at(i).latitude()) < 1e-9);
+        QVERIFY(qAbs(back.at(i).longitude() - input.at(i).longitude()) < 1e-9);
+        QCOMPARE(back.at(i).altitude(), 0.0);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QWebMercator)
+#include "tst_qwebmercator.moc"
@@ -0,0 +1,20 @@
+TEMPLATE = subdirs
+
+# Run with "make benchmark". Pass e.g. TESTARGS="-o result.xml,xml" or
+# "-csv" for machine-readable results.
+qtHaveModule(positioning) {
+    SUBDIRS += \
+        qgeocoordinate \
+        qgeoshapes \
+        qnmeapositioninfosource
+}
+
+qtHaveModule(location) {
+    SUBDIRS += \
+        qgeocameratiles \
+        qgeofiletilecache \
+        qgeosimplify \
+        qgeotilefetcher
+
+    qtHaveModule(quick): SUBDIRS += mapitems qgeotiledmapscene
+}
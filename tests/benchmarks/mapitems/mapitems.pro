@@ -0,0 +1,8 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_mapitems
+
+SOURCES += tst_bench_mapitems.cpp
+RESOURCES += mapitems.qrc
+
+QT += location-private positioning-private testlib quick
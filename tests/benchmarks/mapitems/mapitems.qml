@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.12
+import QtPositioning 5.12
+import QtLocation 5.15
+import Qt.labs.location 1.0
+
+// The map items of tst_bench_mapitems, laid out on a grid that fills the viewport
+Map {
+    id: map
+    width: 1024
+    height: 768
+    plugin: Plugin { name: "itemsoverlay" }
+    center: origin
+    zoomLevel: 9
+    copyrightsVisible: false
+    gesture.enabled: false
+
+    readonly property var origin: QtPositioning.coordinate(52.52, 13.40)
+    property string kind
+    property int backend: 0
+    property int count: 0
+    property int vertices: 16
+
+    function cell(index) {
+        var side = Math.ceil(Math.sqrt(count))
+        return {
+            latitude: origin.latitude + ((Math.floor(index / side) + 0.5) / side - 0.5) * 1.2,
+            longitude: origin.longitude + ((index % side + 0.5) / side - 0.5) * 2.0,
+            radius: 0.8 / side
+        }
+    }
+
+    // Star shaped, so that polygons are not convex
+    function ring(index) {
+        var c = cell(index)
+        var path = []
+        for (var i = 0; i < vertices; ++i) {
+            var angle = 2 * Math.PI * i / vertices
+            var r = c.radius * ((i % 2) ? 0.6 : 1.0)
+            path.push(QtPositioning.coordinate(c.latitude + 0.6 * r * Math.sin(angle),
+                                               c.longitude + r * Math.cos(angle)))
+        }
+        return path
+    }
+
+    function applyScript(script, t) {
+        var c = origin
+        var z = 9
+        var tiltAngle = 0
+        var b = 0
+        if (script === "pan")
+            c = QtPositioning.coordinate(origin.latitude + 0.3 * Math.sin(2 * Math.PI * t),
+                                         origin.longitude + 0.5 * (1 - Math.cos(2 * Math.PI * t)))
+        else if (script === "zoom")
+            z = 9 + 2 * Math.sin(Math.PI * t)
+        else if (script === "tilt")
+            tiltAngle = 60 * Math.sin(Math.PI * t)
+        else if (script === "rotate")
+            b = 360 * t
+        center = c
+        zoomLevel = z
+        tilt = tiltAngle
+        bearing = b
+    }
+
+    MapItemView {
+        model: map.kind === "polyline" ? map.count : 0
+        delegate: MapPolyline {
+            backend: map.backend
+            line.width: 3
+            line.color: "navy"
+            path: map.ring(index)
+        }
+    }
+    MapItemView {
+        model: map.kind === "polygon" ? map.count : 0
+        delegate: MapPolygon {
+            backend: map.backend
+            color: "orange"
+            border.width: 2
+            border.color: "brown"
+            path: map.ring(index)
+        }
+    }
+    MapItemView {
+        model: map.kind === "circle" ? map.count : 0
+        delegate: MapCircle {
+            backend: map.backend
+            color: "limegreen"
+            border.width: 2
+            border.color: "darkgreen"
+            center: QtPositioning.coordinate(map.cell(index).latitude, map.cell(index).longitude)
+            radius: map.cell(index).radius * 0.5 * 111000
+        }
+    }
+    MapItemView {
+        model: map.kind === "rectangle" ? map.count : 0
+        delegate: MapRectangle {
+            readonly property var c: map.cell(index)
+            backend: map.backend
+            color: "steelblue"
+            border.width: 2
+            border.color: "navy"
+            topLeft: QtPositioning.coordinate(c.latitude + 0.5 * c.radius, c.longitude - c.radius)
+            bottomRight: QtPositioning.coordinate(c.latitude - 0.5 * c.radius, c.longitude + c.radius)
+        }
+    }
+
+    MapObjectView {
+        model: map.kind === "polylineObject" ? map.count : 0
+        delegate: MapPolylineObject {
+            line.width: 3
+            line.color: "navy"
+            path: map.ring(index)
+        }
+    }
+    MapObjectView {
+        model: map.kind === "polygonObject" ? map.count : 0
+        delegate: MapPolygonObject {
+            color: "orange"
+            border.width: 2
+            border.color: "brown"
+            path: map.ring(index)
+        }
+    }
+    MapObjectView {
+        model: map.kind === "circleObject" ? map.count : 0
+        delegate: MapCircleObject {
+            color: "limegreen"
+            border.width: 2
+            border.color: "darkgreen"
+            center: QtPositioning.coordinate(map.cell(index).latitude, map.cell(index).longitude)
+            radius: map.cell(index).radius * 0.5 * 111000
+        }
+    }
+}
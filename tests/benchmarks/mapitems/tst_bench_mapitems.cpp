@@ -0,0 +1,315 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QSurfaceFormat>
+#if !defined(QT_NO_OPENGL) && !defined(QT_OPENGL_ES_2)
+#include <QtGui/QOpenGLTimerQuery>
+#endif
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickView>
+#include <QtLocation/private/qgeomapstatistics_p.h>
+#include <algorithm>
+
+QT_USE_NAMESPACE
+
+/*
+    Runs the map items of every type and backend through scripted camera
+    movements, at increasing numbers of items and vertices, and measures their
+    frames. The results are reported as testlib benchmark results, the median
+    frame time, and in full as JSON, to the file given by
+    QTLOCATION_BENCHMARK_REPORT or to tst_bench_mapitems.json.
+*/
+
+namespace {
+
+const int framesPerScript = 60;
+
+// Times the rendering of frames on the GPU, when the scene graph uses OpenGL
+// and timer queries are available. Each result is read when the next frame
+// starts, so that the CPU does not wait for it.
+class GpuTimer : public QObject
+{
+public:
+    explicit GpuTimer(QQuickWindow *window)
+    {
+#if !defined(QT_NO_OPENGL) && !defined(QT_OPENGL_ES_2)
+        connect(window, &QQuickWindow::beforeRendering, this, &GpuTimer::begin, Qt::DirectConnection);
+        connect(window, &QQuickWindow::afterRendering, this, &GpuTimer::end, Qt::DirectConnection);
+        connect(window, &QQuickWindow::sceneGraphInvalidated, this, &GpuTimer::release, Qt::DirectConnection);
+#else
+        Q_UNUSED(window);
+#endif
+    }
+
+    QVector<double> takeTimes()
+    {
+        QVector<double> times;
+        times.swap(m_times);
+        return times;
+    }
+
+private:
+#if !defined(QT_NO_OPENGL) && !defined(QT_OPENGL_ES_2)
+    void begin()
+    {
+        if (!m_query && !m_unsupported) {
+            m_query = new QOpenGLTimerQuery;
+            if (!QOpenGLContext::currentContext() || !m_query->create()) {
+                release();
+                m_unsupported = true;
+            }
+        }
+        if (!m_query)
+            return;
+        if (m_pending)
+            m_times.append(m_query->waitForResult() / 1e6);
+        m_query->begin();
+        m_pending = true;
+    }
+
+    void end()
+    {
+        if (m_query)
+            m_query->end();
+    }
+
+    void release()
+    {
+        delete m_query;
+        m_query = nullptr;
+        m_pending = false;
+    }
+
+    QOpenGLTimerQuery *m_query = nullptr;
+    bool m_pending = false;
+    bool m_unsupported = false;
+#endif
+    QVector<double> m_times; // ms
+};
+
+QJsonValue summary(QVector<double> values)
+{
+    if (values.isEmpty())
+        return QJsonValue::Null;
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (double v : qAsConst(values))
+        sum += v;
+    QJsonObject res;
+    res.insert(QStringLiteral("median"), values.at(values.size() / 2));
+    res.insert(QStringLiteral("p90"), values.at(values.size() * 9 / 10));
+    res.insert(QStringLiteral("max"), values.last());
+    res.insert(QStringLiteral("mean"), sum / values.size());
+    return res;
+}
+
+} // namespace
+
+class tst_bench_MapItems : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void cameraScript_data();
+    void cameraScript();
+
+private:
+    bool renderFrames(int frames);
+
+    QQuickView *m_view = nullptr;
+    QQuickItem *m_map = nullptr;
+    GpuTimer *m_gpuTimer = nullptr;
+    QJsonArray m_results;
+};
+
+void tst_bench_MapItems::initTestCase()
+{
+    // Polishing, synchronizing and rendering on the GUI thread, not waiting for vsync
+    qputenv("QSG_RENDER_LOOP", "basic");
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setSwapInterval(0);
+    QSurfaceFormat::setDefaultFormat(format);
+
+    m_view = new QQuickView;
+    m_gpuTimer = new GpuTimer(m_view);
+    m_view->setSource(QUrl(QStringLiteral("qrc:/mapitems.qml")));
+    QCOMPARE(m_view->status(), QQuickView::Ready);
+    m_map = m_view->rootObject();
+    QVERIFY(m_map);
+    m_view->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_view));
+    QTRY_VERIFY(m_map->property("mapReady").toBool());
+
+    QGeoMapStatistics::enable();
+}
+
+void tst_bench_MapItems::cleanupTestCase()
+{
+    QGeoMapStatistics::disable();
+
+    QJsonObject report;
+    report.insert(QStringLiteral("qtVersion"), QString::fromLatin1(qVersion()));
+    report.insert(QStringLiteral("sceneGraphBackend"), QQuickWindow::sceneGraphBackend());
+    report.insert(QStringLiteral("framesPerScript"), framesPerScript);
+    report.insert(QStringLiteral("results"), m_results);
+
+    QString fileName = QString::fromLocal8Bit(qgetenv("QTLOCATION_BENCHMARK_REPORT"));
+    if (fileName.isEmpty())
+        fileName = QStringLiteral("tst_bench_mapitems.json");
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        file.write(QJsonDocument(report).toJson());
+    else
+        qWarning() << "Cannot write the report to" << fileName;
+
+    delete m_view;
+}
+
+void tst_bench_MapItems::cameraScript_data()
+{
+    QTest::addColumn<QString>("kind");
+    QTest::addColumn<int>("backend"); // -1 for the map objects, which have none
+    QTest::addColumn<QString>("backendName");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("vertices");
+    QTest::addColumn<QString>("script");
+
+    struct Kind {
+        const char *name;
+        QVector<int> backends;
+        QVector<const char *> backendNames;
+        bool hasPath;
+    };
+    const QVector<Kind> kinds = {
+        { "polyline", { 0, 1, 2 }, { "Software", "OpenGLLineStrip", "OpenGLExtruded" }, true },
+        { "polygon", { 0, 1 }, { "Software", "OpenGL" }, true },
+        { "circle", { 0, 1 }, { "Software", "OpenGL" }, false },
+        { "rectangle", { 0, 1 }, { "Software", "OpenGL" }, false },
+        { "polylineObject", { -1 }, { "QSG" }, true },
+        { "polygonObject", { -1 }, { "QSG" }, true },
+        { "circleObject", { -1 }, { "QSG" }, false },
+    };
+    const char *scripts[] = { "pan", "zoom", "tilt", "rotate" };
+
+    for (const Kind &kind : kinds) {
+        for (int b = 0; b < kind.backends.size(); ++b) {
+            for (int count : { 10, 100, 1000 }) {
+                for (int vertices : kind.hasPath ? QVector<int>{ 16, 256 } : QVector<int>{ 0 }) {
+                    for (const char *script : scripts) {
+                        QByteArray name = QByteArray(kind.name) + ' ' + kind.backendNames.at(b)
+                                + ' ' + QByteArray::number(count);
+                        if (vertices)
+                            name += 'x' + QByteArray::number(vertices);
+                        name += ' ' + QByteArray(script);
+                        QTest::newRow(name.constData())
+                                << QString::fromLatin1(kind.name) << kind.backends.at(b)
+                                << QString::fromLatin1(kind.backendNames.at(b))
+                                << count << vertices << QString::fromLatin1(script);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool tst_bench_MapItems::renderFrames(int frames)
+{
+    QSignalSpy swapped(m_view, &QQuickWindow::frameSwapped);
+    for (int i = 0; i < frames; ++i) {
+        m_view->update();
+        if (!swapped.wait(5000))
+            return false;
+    }
+    return true;
+}
+
+void tst_bench_MapItems::cameraScript()
+{
+    QFETCH(QString, kind);
+    QFETCH(int, backend);
+    QFETCH(QString, backendName);
+    QFETCH(int, count);
+    QFETCH(int, vertices);
+    QFETCH(QString, script);
+
+    m_map->setProperty("count", 0);
+    m_map->setProperty("kind", kind);
+    m_map->setProperty("backend", qMax(0, backend));
+    if (vertices)
+        m_map->setProperty("vertices", vertices);
+    QMetaObject::invokeMethod(m_map, "applyScript", Q_ARG(QVariant, script), Q_ARG(QVariant, 0.0));
+    m_map->setProperty("count", count);
+    // Frames creating the geometries are not measured
+    QVERIFY(renderFrames(3));
+    m_gpuTimer->takeTimes();
+    QGeoMapStatistics::reset();
+
+    QVector<double> frameTimes;
+    QSignalSpy swapped(m_view, &QQuickWindow::frameSwapped);
+    QElapsedTimer timer;
+    for (int i = 1; i <= framesPerScript; ++i) {
+        timer.start();
+        QMetaObject::invokeMethod(m_map, "applyScript", Q_ARG(QVariant, script),
+                                  Q_ARG(QVariant, double(i) / framesPerScript));
+        m_view->update();
+        QVERIFY(swapped.wait(5000));
+        frameTimes.append(timer.nsecsElapsed() / 1e6);
+    }
+
+    const QVariantMap statistics = QGeoMapStatistics::snapshot();
+    const double polishTime = statistics.value(QStringLiteral("itemPolish")).toMap()
+            .value(QStringLiteral("totalTime")).toDouble();
+
+    QJsonObject result;
+    result.insert(QStringLiteral("kind"), kind);
+    result.insert(QStringLiteral("backend"), backendName);
+    result.insert(QStringLiteral("count"), count);
+    result.insert(QStringLiteral("vertices"), vertices);
+    result.insert(QStringLiteral("script"), script);
+    result.insert(QStringLiteral("frameTime"), summary(frameTimes));
+    result.insert(QStringLiteral("gpuTime"), summary(m_gpuTimer->takeTimes()));
+    result.insert(QStringLiteral("polishTimePerFrame"), polishTime / framesPerScript);
+    result.insert(QStringLiteral("statistics"), QJsonObject::fromVariantMap(statistics));
+    m_results.append(result);
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    QTest::setBenchmarkResult(frameTimes.at(frameTimes.size() / 2), QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_bench_MapItems)
+
+#include "tst_bench_mapitems.moc"
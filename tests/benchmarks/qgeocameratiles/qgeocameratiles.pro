@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeocameratiles
+
+SOURCES += tst_bench_qgeocameratiles.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeocameratiles_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_bench_QGeoCameraTiles : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void createTiles_data();
+    void createTiles();
+    void panTiles_data();
+    void panTiles();
+
+private:
+    void populateCameras();
+};
+
+void tst_bench_QGeoCameraTiles::populateCameras()
+{
+    QTest::addColumn<double>("zoom");
+    QTest::addColumn<double>("tilt");
+    QTest::addColumn<QSize>("size");
+
+    const double zooms[] = { 2.0, 10.5, 18.0 };
+    const double tilts[] = { 0.0, 45.0 };
+    const QSize sizes[] = { QSize(480, 800), QSize(1920, 1080) };
+
+    for (double zoom : zooms) {
+        for (double tilt : tilts) {
+            for (const QSize &size : sizes) {
+                const QByteArray name = "z" + QByteArray::number(zoom) + " t" + QByteArray::number(tilt)
+                        + " " + QByteArray::number(size.width()) + "x" + QByteArray::number(size.height());
+                QTest::newRow(name.constData()) << zoom << tilt << size;
+            }
+        }
+    }
+}
+
+void tst_bench_QGeoCameraTiles::createTiles_data()
+{
+    populateCameras();
+}
+
+// Full computation: frustum, footprint, clipping and rasterization
+void tst_bench_QGeoCameraTiles::createTiles()
+{
+    QFETCH(double, zoom);
+    QFETCH(double, tilt);
+    QFETCH(QSize, size);
+
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(52.52, 13.40));
+    camera.setZoomLevel(zoom);
+    camera.setTilt(tilt);
+
+    int count = 0;
+    QBENCHMARK {
+        QGeoCameraTiles ct;
+        ct.setTileSize(256);
+        ct.setScreenSize(size);
+        ct.setCameraData(camera);
+        count = ct.createTiles().size();
+    }
+    QVERIFY(count > 0);
+}
+
+void tst_bench_QGeoCameraTiles::panTiles_data()
+{
+    populateCameras();
+}
+
+// Continuous panning, as done every frame while dragging or flicking
+void tst_bench_QGeoCameraTiles::panTiles()
+{
+    QFETCH(double, zoom);
+    QFETCH(double, tilt);
+    QFETCH(QSize, size);
+
+    QGeoCameraData camera;
+    camera.setZoomLevel(zoom);
+    camera.setTilt(tilt);
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(256);
+    ct.setScreenSize(size);
+
+    // Move by about two pixels per frame
+    const double step = 2.0 / (256.0 * std::pow(2.0, zoom));
+    QDoubleVector2D center = QWebMercator::coordToMercator(QGeoCoordinate(52.52, 13.40));
+    QSet<QGeoTileSpec> added;
+    QSet<QGeoTileSpec> removed;
+
+    QBENCHMARK {
+        center.setX(center.x() + step);
+        camera.setCenter(QWebMercator::mercatorToCoord(center));
+        ct.setCameraData(camera);
+        ct.createTiles(&added, &removed);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QGeoCameraTiles)
+
+#include "tst_bench_qgeocameratiles.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeocoordinate
+
+SOURCES += tst_bench_qgeocoordinate.cpp
+
+QT += positioning-private testlib
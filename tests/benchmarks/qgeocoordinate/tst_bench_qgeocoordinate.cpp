@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/private/qwebmercator_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_bench_QGeoCoordinate : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void distanceTo();
+    void azimuthTo();
+    void atDistanceAndAzimuth();
+    void coordToMercator_data();
+    void coordToMercator();
+    void mercatorToCoord_data();
+    void mercatorToCoord();
+
+private:
+    static QList<QGeoCoordinate> coordinates(int size);
+};
+
+static const int Size = 10000;
+
+// Coordinates spread over the mercator range, the same for every run
+QList<QGeoCoordinate> tst_bench_QGeoCoordinate::coordinates(int size)
+{
+    QRandomGenerator rng(42);
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(size);
+    for (int i = 0; i < size; ++i)
+        coordinates << QGeoCoordinate(rng.bounded(170.0) - 85.0, rng.bounded(360.0) - 180.0);
+    return coordinates;
+}
+
+void tst_bench_QGeoCoordinate::distanceTo()
+{
+    const QList<QGeoCoordinate> points = coordinates(Size);
+    double total = 0.0;
+    QBENCHMARK {
+        total = 0.0;
+        for (int i = 1; i < points.size(); ++i)
+            total += points.at(i - 1).distanceTo(points.at(i));
+    }
+    QVERIFY(total > 0.0);
+}
+
+void tst_bench_QGeoCoordinate::azimuthTo()
+{
+    const QList<QGeoCoordinate> points = coordinates(Size);
+    double total = 0.0;
+    QBENCHMARK {
+        total = 0.0;
+        for (int i = 1; i < points.size(); ++i)
+            total += points.at(i - 1).azimuthTo(points.at(i));
+    }
+    QVERIFY(total > 0.0);
+}
+
+void tst_bench_QGeoCoordinate::atDistanceAndAzimuth()
+{
+    const QList<QGeoCoordinate> points = coordinates(Size);
+    QGeoCoordinate last;
+    QBENCHMARK {
+        for (int i = 0; i < points.size(); ++i)
+            last = points.at(i).atDistanceAndAzimuth(1000.0 + i, i % 360);
+    }
+    QVERIFY(last.isValid());
+}
+
+void tst_bench_QGeoCoordinate::coordToMercator_data()
+{
+    QTest::addColumn<bool>("list");
+    QTest::newRow("per coordinate") << false;
+    QTest::newRow("list") << true;
+}
+
+void tst_bench_QGeoCoordinate::coordToMercator()
+{
+    QFETCH(bool, list);
+    const QList<QGeoCoordinate> points = coordinates(Size);
+
+    QList<QDoubleVector2D> mercator;
+    if (list) {
+        QBENCHMARK {
+            mercator = QWebMercator::coordToMercator(points);
+        }
+    } else {
+        QBENCHMARK {
+            mercator.clear();
+            for (const QGeoCoordinate &c : points)
+                mercator << QWebMercator::coordToMercator(c);
+        }
+    }
+    QCOMPARE(mercator.size(), points.size());
+}
+
+void tst_bench_QGeoCoordinate::mercatorToCoord_data()
+{
+    coordToMercator_data();
+}
+
+void tst_bench_QGeoCoordinate::mercatorToCoord()
+{
+    QFETCH(bool, list);
+    const QList<QDoubleVector2D> mercator = QWebMercator::coordToMercator(coordinates(Size));
+
+    QList<QGeoCoordinate> points;
+    if (list) {
+        QBENCHMARK {
+            points = QWebMercator::mercatorToCoord(mercator);
+        }
+    } else {
+        QBENCHMARK {
+            points.clear();
+            for (const QDoubleVector2D &m : mercator)
+                points << QWebMercator::mercatorToCoord(m);
+        }
+    }
+    QCOMPARE(points.size(), mercator.size());
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QGeoCoordinate)
+
+#include "tst_bench_qgeocoordinate.moc"
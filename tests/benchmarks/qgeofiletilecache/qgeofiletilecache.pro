@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeofiletilecache
+
+SOURCES += tst_bench_qgeofiletilecache.cpp
+
+QT += location-private positioning-private testlib gui
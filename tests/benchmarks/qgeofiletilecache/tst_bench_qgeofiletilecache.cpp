@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+static const int tileCount = 256;
+
+class tst_bench_QGeoFileTileCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void insert_data();
+    void insert();
+    void getTexture();
+    void getFromDisk();
+    void evict();
+
+private:
+    static QGeoTileSpec spec(int i, int zoom = 10)
+    {
+        return QGeoTileSpec(QStringLiteral("bench"), 1, zoom, i % 16, i / 16);
+    }
+
+    QByteArray m_png;
+};
+
+void tst_bench_QGeoFileTileCache::initTestCase()
+{
+    QImage image(256, 256, QImage::Format_ARGB32);
+    image.fill(Qt::darkCyan);
+    QBuffer buffer(&m_png);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "png"));
+}
+
+void tst_bench_QGeoFileTileCache::insert_data()
+{
+    QTest::addColumn<int>("areas");
+    QTest::newRow("memory") << int(QAbstractGeoTileCache::MemoryCache);
+    QTest::newRow("disk") << int(QAbstractGeoTileCache::DiskCache);
+    QTest::newRow("all") << int(QAbstractGeoTileCache::AllCaches);
+}
+
+void tst_bench_QGeoFileTileCache::insert()
+{
+    QFETCH(int, areas);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+
+    int zoom = 0;
+    QBENCHMARK {
+        ++zoom; // fresh tiles on every iteration
+        for (int i = 0; i < tileCount; ++i)
+            cache.insert(spec(i, zoom), m_png, QStringLiteral("png"), QAbstractGeoTileCache::CacheAreas(areas));
+    }
+}
+
+// Hits in the texture cache, the common case while rendering
+void tst_bench_QGeoFileTileCache::getTexture()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+    for (int i = 0; i < tileCount; ++i)
+        cache.insert(spec(i), m_png, QStringLiteral("png"));
+    for (int i = 0; i < tileCount; ++i)
+        QVERIFY(cache.get(spec(i)));
+
+    QBENCHMARK {
+        for (int i = 0; i < tileCount; ++i)
+            cache.get(spec(i));
+    }
+}
+
+// Cold start: index loading plus reading and decoding every tile from disk
+void tst_bench_QGeoFileTileCache::getFromDisk()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < tileCount; ++i)
+            cache.insert(spec(i), m_png, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    }
+
+    QBENCHMARK {
+        QGeoFileTileCache cache(dir.path());
+        cache.init();
+        for (int i = 0; i < tileCount; ++i)
+            cache.get(spec(i));
+    }
+}
+
+// Inserting into full caches, every insert evicts a tile from each tier
+void tst_bench_QGeoFileTileCache::evict()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoFileTileCache cache(dir.path());
+    cache.init();
+    cache.setMaxDiskUsage(32 * m_png.size());
+    cache.setMaxMemoryUsage(32 * m_png.size());
+    for (int i = 0; i < tileCount; ++i)
+        cache.insert(spec(i, 1), m_png, QStringLiteral("png"));
+
+    int zoom = 1;
+    QBENCHMARK {
+        ++zoom;
+        for (int i = 0; i < tileCount; ++i)
+            cache.insert(spec(i, zoom), m_png, QStringLiteral("png"));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_bench_QGeoFileTileCache)
+
+#include "tst_bench_qgeofiletilecache.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeoshapes
+
+SOURCES += tst_bench_qgeoshapes.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/QGeoRectangle>
+
+#include <cmath>
+
+QT_USE_NAMESPACE
+
+class tst_bench_QGeoShapes : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pathLength_data();
+    void pathLength();
+    void pathContains_data();
+    void pathContains();
+    void polygonContains_data();
+    void polygonContains();
+    void rectangleUnited();
+    void rectangleIntersects();
+
+private:
+    static QList<QGeoCoordinate> track(int size);
+    static QList<QGeoCoordinate> ring(const QGeoCoordinate &center, double radius, int size);
+    static QList<QGeoCoordinate> probes(const QGeoRectangle &area, int size);
+    static QList<QGeoRectangle> rectangles(int size);
+};
+
+// A GPS-like random walk around Oslo
+QList<QGeoCoordinate> tst_bench_QGeoShapes::track(int size)
+{
+    QRandomGenerator rng(42);
+    QList<QGeoCoordinate> points;
+    points.reserve(size);
+    QGeoCoordinate p(59.91, 10.75);
+    double heading = 0.0;
+    for (int i = 0; i < size; ++i) {
+        heading += (rng.generateDouble() - 0.5) * 0.6;
+        p = p.atDistanceAndAzimuth(5.0 + 5.0 * rng.generateDouble(), heading * 180.0 / M_PI);
+        points << p;
+    }
+    return points;
+}
+
+// A star shaped ring, in degrees around the center
+QList<QGeoCoordinate> tst_bench_QGeoShapes::ring(const QGeoCoordinate &center, double radius, int size)
+{
+    QList<QGeoCoordinate> points;
+    points.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        const double angle = 2 * M_PI * i / size;
+        const double r = radius * (i % 2 ? 0.8 : 1.0);
+        points << QGeoCoordinate(center.latitude() + r * std::sin(angle),
+                                 center.longitude() + r * std::cos(angle));
+    }
+    return points;
+}
+
+QList<QGeoCoordinate> tst_bench_QGeoShapes::probes(const QGeoRectangle &area, int size)
+{
+    QRandomGenerator rng(7);
+    QList<QGeoCoordinate> points;
+    points.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        points << QGeoCoordinate(area.bottomLeft().latitude() + rng.bounded(area.height()),
+                                 area.bottomLeft().longitude() + rng.bounded(area.width()));
+    }
+    return points;
+}
+
+QList<QGeoRectangle> tst_bench_QGeoShapes::rectangles(int size)
+{
+    QRandomGenerator rng(42);
+    QList<QGeoRectangle> result;
+    result.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        // some of them crossing the dateline
+        const QGeoCoordinate center(rng.bounded(160.0) - 80.0, rng.bounded(360.0) - 180.0);
+        result << QGeoRectangle(center, 1.0 + rng.bounded(40.0), 1.0 + rng.bounded(20.0));
+    }
+    return result;
+}
+
+void tst_bench_QGeoShapes::pathLength_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("100 points") << 100;
+    QTest::newRow("10000 points") << 10000;
+}
+
+void tst_bench_QGeoShapes::pathLength()
+{
+    QFETCH(int, size);
+    const QGeoPath path(track(size));
+
+    double length = 0.0;
+    QBENCHMARK {
+        length = path.length();
+    }
+    QVERIFY(length > 0.0);
+}
+
+void tst_bench_QGeoShapes::pathContains_data()
+{
+    pathLength_data();
+}
+
+void tst_bench_QGeoShapes::pathContains()
+{
+    QFETCH(int, size);
+    const QGeoPath path(track(size), 20.0);
+    const QList<QGeoCoordinate> points = probes(path.boundingGeoRectangle(), 1000);
+
+    int inside = 0;
+    QBENCHMARK {
+        inside = 0;
+        for (const QGeoCoordinate &c : points)
+            inside += path.contains(c);
+    }
+    QVERIFY(inside < points.size());
+}
+
+void tst_bench_QGeoShapes::polygonContains_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("holes");
+    for (int size : { 64, 4096 }) {
+        for (int holes : { 0, 1, 16 })
+            QTest::addRow("%d points, %d holes", size, holes) << size << holes;
+    }
+}
+
+void tst_bench_QGeoShapes::polygonContains()
+{
+    QFETCH(int, size);
+    QFETCH(int, holes);
+    const QGeoCoordinate center(59.91, 10.75);
+    QGeoPolygon polygon(ring(center, 1.0, size));
+    // the holes on a circle inside the perimeter
+    for (int i = 0; i < holes; ++i) {
+        const double angle = 2 * M_PI * i / holes;
+        const QGeoCoordinate holeCenter(center.latitude() + 0.5 * std::sin(angle),
+                                        center.longitude() + 0.5 * std::cos(angle));
+        polygon.addHole(ring(holeCenter, 0.1, size / 4));
+    }
+    const QList<QGeoCoordinate> points = probes(polygon.boundingGeoRectangle(), 1000);
+
+    int inside = 0;
+    QBENCHMARK {
+        inside = 0;
+        for (const QGeoCoordinate &c : points)
+            inside += polygon.contains(c);
+    }
+    QVERIFY(inside > 0);
+    QVERIFY(inside < points.size());
+}
+
+void tst_bench_QGeoShapes::rectangleUnited()
+{
+    const QList<QGeoRectangle> input = rectangles(10000);
+    QGeoRectangle united;
+    QBENCHMARK {
+        united = input.first();
+        for (const QGeoRectangle &r : input)
+            united = united.united(r);
+    }
+    QVERIFY(united.isValid());
+}
+
+void tst_bench_QGeoShapes::rectangleIntersects()
+{
+    const QList<QGeoRectangle> input = rectangles(1000);
+    int intersections = 0;
+    QBENCHMARK {
+        intersections = 0;
+        for (int i = 1; i < input.size(); ++i)
+            intersections += input.at(i - 1).intersects(input.at(i));
+    }
+    QVERIFY(intersections > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QGeoShapes)
+
+#include "tst_bench_qgeoshapes.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeosimplify
+
+SOURCES += tst_bench_qgeosimplify.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeosimplify_p.h>
+
+QT_USE_NAMESPACE
+
+// The recursive implementation QGeoSimplify used to have, as the reference for the output
+class ReferenceSimplify : public QGeoSimplify
+{
+public:
+    static QList<QDoubleVector2D> simplify(const QList<QDoubleVector2D> &points,
+                                           double leftBound, double offsetTolerance)
+    {
+        QList<QDoubleVector2D> simplified { points.first() };
+        step(points, leftBound, 0, points.size() - 1, offsetTolerance, simplified);
+        simplified.append(points.last());
+        return simplified;
+    }
+
+    static QList<QGeoCoordinate> simplify(const QList<QGeoCoordinate> &points,
+                                          double leftBound, double offsetTolerance)
+    {
+        QList<QGeoCoordinate> simplified { points.first() };
+        step(points, leftBound, 0, points.size() - 1, offsetTolerance, simplified);
+        simplified.append(points.last());
+        return simplified;
+    }
+
+private:
+    template <typename T>
+    static void step(const QList<T> &points, double leftBound, int first, int last,
+                     double offsetTolerance, QList<T> &simplified)
+    {
+        double maxDistanceFound = offsetTolerance;
+        int index = 0;
+        for (int i = first + 1; i < last; i++) {
+            const double distance = getSegDist(points.at(i), points.at(first), points.at(last), leftBound);
+            if (distance > maxDistanceFound) {
+                index = i;
+                maxDistanceFound = distance;
+            }
+        }
+        if (index > 0) {
+            if (index - first > 1)
+                step(points, leftBound, first, index, offsetTolerance, simplified);
+            simplified.append(points.at(index));
+            if (last - index > 1)
+                step(points, leftBound, index, last, offsetTolerance, simplified);
+        }
+    }
+};
+
+class tst_bench_QGeoSimplify : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void simplifyMercator_data();
+    void simplifyMercator();
+    void simplifyCoordinates_data();
+    void simplifyCoordinates();
+    void simplifyZoomLevel_data();
+    void simplifyZoomLevel();
+
+private:
+    static QList<QDoubleVector2D> track(int size);
+};
+
+// A GPS-like random walk around Oslo, in mercator coordinates
+QList<QDoubleVector2D> tst_bench_QGeoSimplify::track(int size)
+{
+    QRandomGenerator rng(42);
+    QList<QDoubleVector2D> points;
+    points.reserve(size);
+    QDoubleVector2D p = QWebMercator::coordToMercator(QGeoCoordinate(59.91, 10.75));
+    double heading = 0.0;
+    for (int i = 0; i < size; ++i) {
+        heading += (rng.generateDouble() - 0.5) * 0.6;
+        const double step = 2e-8 * (1.0 + rng.generateDouble());
+        p += QDoubleVector2D(std::cos(heading), std::sin(heading)) * step;
+        points << p;
+    }
+    return points;
+}
+
+void tst_bench_QGeoSimplify::simplifyMercator_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("reference");
+    for (int size : { 10000, 200000 }) {
+        QTest::addRow("%d points, recursive", size) << size << true;
+        QTest::addRow("%d points", size) << size << false;
+    }
+}
+
+void tst_bench_QGeoSimplify::simplifyMercator()
+{
+    QFETCH(int, size);
+    QFETCH(bool, reference);
+    const QList<QDoubleVector2D> points = track(size);
+    const double leftBound = points.first().x();
+    const double tolerance = 2.0; // metres
+
+    QCOMPARE(QGeoSimplify::geoSimplify(points, leftBound, tolerance),
+             ReferenceSimplify::simplify(points, leftBound, tolerance));
+
+    QList<QDoubleVector2D> simplified;
+    if (reference) {
+        QBENCHMARK {
+            simplified = ReferenceSimplify::simplify(points, leftBound, tolerance);
+        }
+    } else {
+        QBENCHMARK {
+            simplified = QGeoSimplify::geoSimplify(points, leftBound, tolerance);
+        }
+    }
+    QVERIFY(simplified.size() < points.size());
+}
+
+void tst_bench_QGeoSimplify::simplifyCoordinates_data()
+{
+    simplifyMercator_data();
+}
+
+void tst_bench_QGeoSimplify::simplifyCoordinates()
+{
+    QFETCH(int, size);
+    QFETCH(bool, reference);
+    QList<QGeoCoordinate> points;
+    for (const QDoubleVector2D &p : track(size))
+        points << QWebMercator::mercatorToCoord(p);
+    const double leftBound = QWebMercator::coordToMercator(points.first()).x();
+    const double tolerance = 2.0; // metres
+
+    QCOMPARE(QGeoSimplify::geoSimplify(points, leftBound, tolerance),
+             ReferenceSimplify::simplify(points, leftBound, tolerance));
+
+    QList<QGeoCoordinate> simplified;
+    if (reference) {
+        QBENCHMARK {
+            simplified = ReferenceSimplify::simplify(points, leftBound, tolerance);
+        }
+    } else {
+        QBENCHMARK {
+            simplified = QGeoSimplify::geoSimplify(points, leftBound, tolerance);
+        }
+    }
+    QVERIFY(simplified.size() < points.size());
+}
+
+void tst_bench_QGeoSimplify::simplifyZoomLevel_data()
+{
+    QTest::addColumn<int>("zoomLevel");
+    QTest::addColumn<bool>("significance");
+    for (int zoomLevel : { 4, 10, 16 }) {
+        QTest::addRow("zoom %d", zoomLevel) << zoomLevel << false;
+        QTest::addRow("zoom %d, precomputed significance", zoomLevel) << zoomLevel << true;
+    }
+}
+
+void tst_bench_QGeoSimplify::simplifyZoomLevel()
+{
+    QFETCH(int, zoomLevel);
+    QFETCH(bool, significance);
+    const QList<QDoubleVector2D> points = track(200000);
+    const double leftBound = points.first().x();
+    const QVector<quint8> levels = QGeoSimplify::zoomLevelSignificance(points, leftBound);
+
+    const QList<QDoubleVector2D> expected = QGeoSimplify::geoSimplifyZL(points, leftBound, zoomLevel);
+    QCOMPARE(QGeoSimplify::filterByZoomLevel(points.toVector(), levels, zoomLevel).toList(), expected);
+
+    if (significance) {
+        const QVector<QDoubleVector2D> buffer = points.toVector();
+        QBENCHMARK {
+            QGeoSimplify::filterByZoomLevel(buffer, levels, zoomLevel);
+        }
+    } else {
+        QBENCHMARK {
+            QGeoSimplify::geoSimplifyZL(points, leftBound, zoomLevel);
+        }
+    }
+}
+
+QTEST_MAIN(tst_bench_QGeoSimplify)
+
+#include "tst_bench_qgeosimplify.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeotiledmapscene
+
+SOURCES += tst_bench_qgeotiledmapscene.cpp
+
+QT += location-private positioning-private testlib quick
@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGNode>
+#include <QtQuick/QSGRendererInterface>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeotiledmapscene_p.h>
+#include <QtLocation/private/qgeocameratiles_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qabstractgeotilecache_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_bench_QGeoTiledMapScene : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void updateSceneGraph_data();
+    void updateSceneGraph();
+
+private:
+    QQuickWindow *m_window = nullptr;
+};
+
+void tst_bench_QGeoTiledMapScene::initTestCase()
+{
+    // The software backend lets this run headless and on the GUI thread
+    QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+    m_window = new QQuickWindow;
+    m_window->resize(800, 480);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+    QTRY_VERIFY(m_window->isSceneGraphInitialized());
+}
+
+void tst_bench_QGeoTiledMapScene::cleanupTestCase()
+{
+    delete m_window;
+}
+
+void tst_bench_QGeoTiledMapScene::updateSceneGraph_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<double>("tilt");
+    QTest::newRow("480x800") << QSize(480, 800) << 0.0;
+    QTest::newRow("1920x1080") << QSize(1920, 1080) << 0.0;
+    QTest::newRow("1920x1080 tilted") << QSize(1920, 1080) << 45.0;
+}
+
+// Panning frame: camera moves, tiles and textures already in place
+void tst_bench_QGeoTiledMapScene::updateSceneGraph()
+{
+    QFETCH(QSize, size);
+    QFETCH(double, tilt);
+
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(52.52, 13.40));
+    camera.setZoomLevel(12.3);
+    camera.setTilt(tilt);
+
+    QGeoCameraTiles cameraTiles;
+    cameraTiles.setTileSize(256);
+    cameraTiles.setScreenSize(size);
+    cameraTiles.setCameraData(camera);
+    const QSet<QGeoTileSpec> tiles = cameraTiles.createTiles();
+
+    QGeoTiledMapScene scene;
+    scene.setTileSize(256);
+    scene.setScreenSize(size);
+    scene.setCameraData(camera);
+    scene.setVisibleTiles(tiles);
+
+    QImage image(256, 256, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::darkCyan);
+    for (const QGeoTileSpec &spec : tiles) {
+        QSharedPointer<QGeoTileTexture> texture(new QGeoTileTexture);
+        texture->spec = spec;
+        texture->image = image;
+        scene.addTile(spec, texture);
+    }
+
+    QSGNode *node = scene.updateSceneGraph(nullptr, m_window);
+    QVERIFY(node);
+
+    const double step = 2.0 / (256.0 * std::pow(2.0, camera.zoomLevel()));
+    QDoubleVector2D center = QWebMercator::coordToMercator(camera.center());
+    QBENCHMARK {
+        center.setX(center.x() + step);
+        camera.setCenter(QWebMercator::mercatorToCoord(center));
+        scene.setCameraData(camera);
+        node = scene.updateSceneGraph(node, m_window);
+    }
+    delete node;
+}
+
+QTEST_MAIN(tst_bench_QGeoTiledMapScene)
+
+#include "tst_bench_qgeotiledmapscene.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeotilefetcher
+
+SOURCES += tst_bench_qgeotilefetcher.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include <QtLocation/private/qgeotilefetcher_p.h>
+#include <QtLocation/private/qgeotiledmapreply_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+// Never dispatches: the event loop does not run, only queue bookkeeping is measured
+class BenchTileFetcher : public QGeoTileFetcher
+{
+    Q_OBJECT
+public:
+    BenchTileFetcher() : QGeoTileFetcher(nullptr) {}
+
+private:
+    QGeoTiledMapReply *getTileImage(const QGeoTileSpec &spec) override
+    {
+        Q_UNUSED(spec)
+        return nullptr;
+    }
+};
+
+class tst_bench_QGeoTileFetcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void enqueueCancel_data();
+    void enqueueCancel();
+    void panChurn();
+
+private:
+    static QSet<QGeoTileSpec> tileRect(int x0, int y0, int w, int h)
+    {
+        QSet<QGeoTileSpec> tiles;
+        for (int x = x0; x < x0 + w; ++x) {
+            for (int y = y0; y < y0 + h; ++y)
+                tiles.insert(QGeoTileSpec(QStringLiteral("bench"), 1, 12, x, y));
+        }
+        return tiles;
+    }
+
+    static QHash<QGeoTileSpec, double> priorities(const QSet<QGeoTileSpec> &tiles, int cx, int cy)
+    {
+        QHash<QGeoTileSpec, double> result;
+        for (const QGeoTileSpec &tile : tiles)
+            result.insert(tile, std::hypot(tile.x() - cx, tile.y() - cy));
+        return result;
+    }
+};
+
+void tst_bench_QGeoTileFetcher::enqueueCancel_data()
+{
+    QTest::addColumn<int>("side");
+    QTest::newRow("64 tiles") << 8;
+    QTest::newRow("400 tiles") << 20;
+    QTest::newRow("2500 tiles") << 50;
+}
+
+void tst_bench_QGeoTileFetcher::enqueueCancel()
+{
+    QFETCH(int, side);
+
+    BenchTileFetcher fetcher;
+    const QSet<QGeoTileSpec> tiles = tileRect(0, 0, side, side);
+    const QHash<QGeoTileSpec, double> prio = priorities(tiles, side / 2, side / 2);
+
+    QBENCHMARK {
+        fetcher.updateTileRequests(tiles, QSet<QGeoTileSpec>(), prio);
+        fetcher.updateTileRequests(QSet<QGeoTileSpec>(), tiles, QHash<QGeoTileSpec, double>());
+    }
+}
+
+// A pan moving the requested window by one column per update, re-prioritizing the rest
+void tst_bench_QGeoTileFetcher::panChurn()
+{
+    BenchTileFetcher fetcher;
+    const int w = 10;
+    const int h = 8;
+    QSet<QGeoTileSpec> current = tileRect(0, 0, w, h);
+    fetcher.updateTileRequests(current, QSet<QGeoTileSpec>(), priorities(current, w / 2, h / 2));
+
+    int x = 0;
+    QBENCHMARK {
+        ++x;
+        const QSet<QGeoTileSpec> next = tileRect(x, 0, w, h);
+        fetcher.updateTileRequests(next - current, current - next, priorities(next, x + w / 2, h / 2));
+        current = next;
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_bench_QGeoTileFetcher)
+
+#include "tst_bench_qgeotilefetcher.moc"
@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryFile>
+#include <QtPositioning/QNmeaPositionInfoSource>
+#include <QtPositioning/QGeoSatelliteInfo>
+#include <QtPositioning/private/qlocationutils_p.h>
+
+#include <cmath>
+
+QT_USE_NAMESPACE
+
+class tst_bench_QNmeaPositionInfoSource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parsePosition_data();
+    void parsePosition();
+    void parseSatellites();
+    void splitSentences_data();
+    void splitSentences();
+    void replayLog_data();
+    void replayLog();
+
+private:
+    static QByteArray sentence(const QByteArray &body);
+    static QByteArray degreesMinutes(double degrees, int width);
+    static QByteArray log(int seconds);
+};
+
+// Adds the '$', the checksum and the line break to the body of a sentence
+QByteArray tst_bench_QNmeaPositionInfoSource::sentence(const QByteArray &body)
+{
+    char sum = 0;
+    for (char c : body)
+        sum ^= c;
+    return '$' + body + '*' + QByteArray::number(uchar(sum), 16).rightJustified(2, '0').toUpper()
+            + "\r\n";
+}
+
+// The "dddmm.mmmmm" format of NMEA latitudes and longitudes
+QByteArray tst_bench_QNmeaPositionInfoSource::degreesMinutes(double degrees, int width)
+{
+    const int whole = int(degrees);
+    return QByteArray::number(whole).rightJustified(width, '0')
+            + QByteArray::number((degrees - whole) * 60, 'f', 5).rightJustified(8, '0');
+}
+
+/*
+    A recorded-like log of a drive with a 1 Hz receiver, each second having the
+    GGA, GSA, 3 GSV, RMC and VTG sentences of a common u-blox configuration.
+    The positions follow a fixed curve, so that every run parses the same data.
+*/
+QByteArray tst_bench_QNmeaPositionInfoSource::log(int seconds)
+{
+    const QDateTime start(QDate(2020, 6, 1), QTime(8, 0, 0), Qt::UTC);
+    QByteArray data;
+    for (int i = 0; i <= seconds; ++i) {
+        const QDateTime dt = start.addSecs(i);
+        const QByteArray time = dt.toString(QStringLiteral("hhmmss.zzz")).toLatin1();
+        const QByteArray date = dt.toString(QStringLiteral("ddMMyy")).toLatin1();
+        const double lat = 59.91 + 0.0002 * i;
+        const double lon = 10.75 + 0.0001 * i + 0.002 * std::sin(i * 0.01);
+        const QByteArray latNmea = degreesMinutes(lat, 2) + ",N";
+        const QByteArray lonNmea = degreesMinutes(lon, 3) + ",E";
+        const QByteArray course = QByteArray::number(std::fmod(i * 0.7, 360.0), 'f', 2);
+
+        if (i == seconds) {
+            // a last update, the replay of the one before completes when it is read
+            data += sentence("GPRMC," + time + ",A," + latNmea + ',' + lonNmea + ",12.5,"
+                             + course + ',' + date + ",,,A");
+            break;
+        }
+        data += sentence("GPGGA," + time + ',' + latNmea + ',' + lonNmea
+                         + ",1,09,0.92,112.4,M,39.2,M,,");
+        data += sentence("GPGSA,A,3,02,05,12,13,15,18,20,25,29,,,,1.61,0.92,1.32");
+        data += sentence("GPGSV,3,1,11,02,45,291,38,05,71,184,42,12,23,048,31,13,38,122,40");
+        data += sentence("GPGSV,3,2,11,15,09,350,22,18,55,227,44,20,31,083,36,25,66,010,45");
+        data += sentence("GPGSV,3,3,11,26,04,160,,29,19,269,30,31,02,312,");
+        data += sentence("GPRMC," + time + ",A," + latNmea + ',' + lonNmea + ",12.5,"
+                         + course + ',' + date + ",,,A");
+        data += sentence("GPVTG," + course + ",T,,M,12.5,N,23.2,K,A");
+    }
+    return data;
+}
+
+void tst_bench_QNmeaPositionInfoSource::parsePosition_data()
+{
+    QTest::addColumn<QByteArray>("nmea");
+    QTest::newRow("GGA") << sentence("GPGGA,080000.00,5954.60000,N,01045.00000,E,1,09,0.92,112.4,M,39.2,M,,");
+    QTest::newRow("GSA") << sentence("GPGSA,A,3,02,05,12,13,15,18,20,25,29,,,,1.61,0.92,1.32");
+    QTest::newRow("GLL") << sentence("GPGLL,5954.60000,N,01045.00000,E,080000.00,A,A");
+    QTest::newRow("RMC") << sentence("GPRMC,080000.00,A,5954.60000,N,01045.00000,E,12.5,0.70,010620,,,A");
+    QTest::newRow("VTG") << sentence("GPVTG,0.70,T,,M,12.5,N,23.2,K,A");
+    QTest::newRow("ZDA") << sentence("GPZDA,080000.00,01,06,2020,00,00");
+}
+
+void tst_bench_QNmeaPositionInfoSource::parsePosition()
+{
+    QFETCH(QByteArray, nmea);
+
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(nmea.constData(), nmea.size(), &info, 5.1, &hasFix));
+    QBENCHMARK {
+        QLocationUtils::getPosInfoFromNmea(nmea.constData(), nmea.size(), &info, 5.1, &hasFix);
+    }
+}
+
+void tst_bench_QNmeaPositionInfoSource::parseSatellites()
+{
+    const QByteArray nmea[] = {
+        sentence("GPGSV,3,1,11,02,45,291,38,05,71,184,42,12,23,048,31,13,38,122,40"),
+        sentence("GPGSV,3,2,11,15,09,350,22,18,55,227,44,20,31,083,36,25,66,010,45"),
+        sentence("GPGSV,3,3,11,26,04,160,,29,19,269,30,31,02,312,")
+    };
+
+    QList<QGeoSatelliteInfo> infos;
+    QBENCHMARK {
+        infos.clear();
+        for (const QByteArray &s : nmea)
+            QLocationUtils::getSatInfoFromNmea(s.constData(), s.size(), infos);
+    }
+    QCOMPARE(infos.size(), 11);
+}
+
+void tst_bench_QNmeaPositionInfoSource::splitSentences_data()
+{
+    QTest::addColumn<int>("seconds");
+    QTest::newRow("1 minute") << 60;
+    QTest::newRow("1 hour") << 3600;
+}
+
+void tst_bench_QNmeaPositionInfoSource::splitSentences()
+{
+    QFETCH(int, seconds);
+    const QByteArray data = log(seconds);
+
+    QVector<QLocationUtils::NmeaSentenceSpan> spans(7 * seconds + 1);
+    int count = 0;
+    qint64 consumed = 0;
+    QBENCHMARK {
+        count = QLocationUtils::splitNmeaSentences(data.constData(), data.size(), spans.data(),
+                                                   spans.size(), &consumed);
+    }
+    QCOMPARE(count, spans.size());
+    QCOMPARE(consumed, qint64(data.size()));
+}
+
+void tst_bench_QNmeaPositionInfoSource::replayLog_data()
+{
+    QTest::addColumn<int>("seconds");
+    QTest::addColumn<bool>("file");
+    for (int seconds : { 60, 3600 }) {
+        QTest::addRow("%d s, buffer", seconds) << seconds << false;
+        QTest::addRow("%d s, file", seconds) << seconds << true;
+    }
+}
+
+// The updates of a log replayed as fast as possible, through the sequential and the mapped readers
+void tst_bench_QNmeaPositionInfoSource::replayLog()
+{
+    QFETCH(int, seconds);
+    QFETCH(bool, file);
+    const QByteArray data = log(seconds);
+
+    QBuffer buffer;
+    buffer.setData(data);
+    QTemporaryFile temporaryFile;
+    QIODevice *device = &buffer;
+    if (file) {
+        QVERIFY(temporaryFile.open());
+        QCOMPARE(temporaryFile.write(data), qint64(data.size()));
+        temporaryFile.close();
+        device = &temporaryFile;
+    }
+
+    QBENCHMARK {
+        QVERIFY(device->open(QIODevice::ReadOnly));
+        int updates = 0;
+        {
+            QNmeaPositionInfoSource source(QNmeaPositionInfoSource::SimulationMode);
+            source.setDevice(device);
+            QVERIFY(source.setBackendProperty(QStringLiteral("nmea.playback_rate"), 0.0));
+            connect(&source, &QNmeaPositionInfoSource::positionUpdated,
+                    [&updates](const QGeoPositionInfo &) { ++updates; });
+            source.startUpdates();
+            QTRY_VERIFY_WITH_TIMEOUT(updates >= seconds, 60000);
+        }
+        device->close();
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_bench_QNmeaPositionInfoSource)
+
+#include "tst_bench_qnmeapositioninfosource.moc"
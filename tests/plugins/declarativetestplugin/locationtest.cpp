@@ -56,6 +56,7 @@ public:
             qmlRegisterType<QDeclarativePinchGenerator>(uri, 5, 5, "PinchGenerator");
             qmlRegisterType<QDeclarativeLocationTestModel>(uri, 5, 5, "TestModel");
             qmlRegisterSingletonType<TestHelper>(uri, 5, 6, "LocationTestHelper", helper_factory);
+            qmlRegisterType<QDeclarativeCoordinateTestModel>(uri, 5, 6, "CoordinateTestModel");
         } else {
             qWarning() << "Unsupported URI given to load location test QML plugin: " << QLatin1String(uri);
         }
@@ -242,4 +242,90 @@ QHash<int, QByteArray> QDeclarativeLocationTestModel::roleNames() const
     return roles;
 }
 
+QDeclarativeCoordinateTestModel::QDeclarativeCoordinateTestModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int QDeclarativeCoordinateTestModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : coordinates_.size();
+}
+
+QVariant QDeclarativeCoordinateTestModel::data(const QModelIndex &index, int role) const
+{
+    if (index.row() < 0 || index.row() >= coordinates_.size())
+        return QVariant();
+    if (role == CoordinateRole)
+        return QVariant::fromValue(coordinates_.at(index.row()));
+    if (role == IconRole)
+        return icons_.at(index.row());
+    return QVariant();
+}
+
+QHash<int, QByteArray> QDeclarativeCoordinateTestModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles.insert(CoordinateRole, "coordinate");
+    roles.insert(IconRole, "icon");
+    return roles;
+}
+
+int QDeclarativeCoordinateTestModel::count() const
+{
+    return coordinates_.size();
+}
+
+void QDeclarativeCoordinateTestModel::append(const QGeoCoordinate &coordinate, int icon)
+{
+    insert(coordinates_.size(), coordinate, icon);
+}
+
+void QDeclarativeCoordinateTestModel::insert(int row, const QGeoCoordinate &coordinate, int icon)
+{
+    if (row < 0 || row > coordinates_.size())
+        return;
+    beginInsertRows(QModelIndex(), row, row);
+    coordinates_.insert(row, coordinate);
+    icons_.insert(row, icon);
+    endInsertRows();
+    emit countChanged();
+}
+
+void QDeclarativeCoordinateTestModel::remove(int row)
+{
+    if (row < 0 || row >= coordinates_.size())
+        return;
+    beginRemoveRows(QModelIndex(), row, row);
+    coordinates_.removeAt(row);
+    icons_.removeAt(row);
+    endRemoveRows();
+    emit countChanged();
+}
+
+void QDeclarativeCoordinateTestModel::setCoordinate(int row, const QGeoCoordinate &coordinate)
+{
+    if (row < 0 || row >= coordinates_.size())
+        return;
+    coordinates_[row] = coordinate;
+    emit dataChanged(index(row), index(row), QVector<int>() << CoordinateRole);
+}
+
+void QDeclarativeCoordinateTestModel::setIcon(int row, int icon)
+{
+    if (row < 0 || row >= coordinates_.size())
+        return;
+    icons_[row] = icon;
+    emit dataChanged(index(row), index(row), QVector<int>() << IconRole);
+}
+
+void QDeclarativeCoordinateTestModel::clear()
+{
+    beginResetModel();
+    coordinates_.clear();
+    icons_.clear();
+    endResetModel();
+    emit countChanged();
+}
+
 QT_END_NAMESPACE
@@ -125,6 +125,41 @@ private:
     bool crazyMode_;
 };
 
+// A list of coordinates, and icons, for the views that read them from model roles
+class QDeclarativeCoordinateTestModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        CoordinateRole = Qt::UserRole + 500,
+        IconRole
+    };
+
+    explicit QDeclarativeCoordinateTestModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const;
+
+    Q_INVOKABLE void append(const QGeoCoordinate &coordinate, int icon = 0);
+    Q_INVOKABLE void insert(int row, const QGeoCoordinate &coordinate, int icon = 0);
+    Q_INVOKABLE void remove(int row);
+    Q_INVOKABLE void setCoordinate(int row, const QGeoCoordinate &coordinate);
+    Q_INVOKABLE void setIcon(int row, int icon);
+    Q_INVOKABLE void clear();
+
+signals:
+    void countChanged();
+
+private:
+    QList<QGeoCoordinate> coordinates_;
+    QList<int> icons_;
+};
+
 QT_END_NAMESPACE
 
 #endif